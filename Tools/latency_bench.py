@@ -0,0 +1,287 @@
+"""
+Round-Trip Latency Benchmark
+
+Measures the three numbers that decide how a host feels when it talks to a press, so
+firmware releases and network setups can be compared on the same footing:
+
+- Command round trip: '#<id> pause' and '#<id> resume' sent in turn to an idle press, each
+  timed to its ACK, its INFO ("No active operation to pause.") and its DONE.
+- Telemetry jitter: the gap between consecutive telemetry messages, and how far each gap
+  is from the median one (the telemetry period).
+- Discovery: DISCOVER_DEVICE to DISCOVERY_RESPONSE.
+
+Each is reported as percentiles (p50 to p99.9 and the maximum, in milliseconds). The press
+must be idle: the benchmark stops if a pause finds something to pause, and resumes it.
+
+Usage:
+
+    python Tools/latency_bench.py --udp 192.168.1.50
+    python Tools/latency_bench.py --usb COM5 --iterations 2000
+    python Tools/latency_bench.py --udp 192.168.1.50 --json release-1.4.json
+
+--usb needs pyserial. --json writes the results and the DISCOVERY_RESPONSE fields (FW=,
+...) to a file, so two runs can be compared later.
+"""
+
+import argparse
+import json
+import math
+import re
+import socket
+import sys
+import time
+from typing import Dict, List, Optional
+
+COMMAND_PORT = 8888             # LOCAL_PORT in config.h
+USB_BAUD = 115200               # ignored by the CDC port, needed by pyserial
+REPLY_TIMEOUT_S = 1.0
+PERCENTILES = (50.0, 90.0, 99.0, 99.9)
+
+ACK_PREFIX = 'PRESSBOI_ACK: #'
+INFO_PREFIX = 'PRESSBOI_INFO: #'
+DONE_PREFIX = 'PRESSBOI_DONE: #'
+ERROR_PREFIX = 'PRESSBOI_ERROR: #'
+TELEM_PREFIXES = ('PRESSBOI_TELEM: ', 'PRESSBOI_TELEMB: ')
+DISCOVERY_PREFIX = 'DISCOVERY_RESPONSE: '
+IDLE_INFO = 'No active operation to pause.'
+
+_CHUNK_RE = re.compile(r'CHUNK_(\d+)/(\d+):(.*)', re.S)
+
+
+class UdpLink:
+    """Commands to COMMAND_PORT; replies come back to the port named in PORT=."""
+
+    name = 'udp'
+
+    def __init__(self, host: str, port: int):
+        self.address = (host, port)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(('', 0))
+        self.local_port = self.sock.getsockname()[1]
+        self.lines: List[str] = []
+
+    def send(self, text: str) -> None:
+        self.sock.sendto(text.encode('ascii'), self.address)
+
+    def read_line(self, deadline: float) -> Optional[str]:
+        while not self.lines:
+            remaining = deadline - time.perf_counter()
+            if remaining <= 0:
+                return None
+            self.sock.settimeout(remaining)
+            try:
+                data = self.sock.recv(2048)
+            except socket.timeout:
+                return None
+            # A batching press (UDP=BATCH1) puts several messages in one datagram
+            self.lines.extend(line for line in data.decode('ascii', 'replace').split('\n') if line)
+        return self.lines.pop(0)
+
+    def close(self) -> None:
+        self.sock.close()
+
+
+class UsbLink:
+    """Newline-terminated text both ways, with CHUNK_i/n: lines joined back together."""
+
+    name = 'usb'
+
+    def __init__(self, port: str):
+        try:
+            import serial
+        except ImportError:
+            raise SystemExit('--usb needs pyserial (pip install pyserial)')
+        self.port = serial.Serial(port, USB_BAUD, timeout=0)
+        self.local_port = 0
+        self.buffer = b''
+        self.chunks: List[str] = []
+
+    def send(self, text: str) -> None:
+        self.port.write(text.encode('ascii') + b'\n')
+
+    def read_line(self, deadline: float) -> Optional[str]:
+        while True:
+            while b'\n' in self.buffer:
+                raw, self.buffer = self.buffer.split(b'\n', 1)
+                line = self._join(raw.decode('ascii', 'replace').rstrip('\r'))
+                if line:
+                    return line
+            remaining = deadline - time.perf_counter()
+            if remaining <= 0:
+                return None
+            self.port.timeout = remaining
+            self.buffer += self.port.read(max(1, self.port.in_waiting))
+
+    def _join(self, line: str) -> Optional[str]:
+        match = _CHUNK_RE.match(line)
+        if not match:
+            return line
+        index, total, text = int(match.group(1)), int(match.group(2)), match.group(3)
+        if index == 1:
+            self.chunks = []
+        self.chunks.append(text)
+        if index < total:
+            return None
+        # The message counts as arrived with its last chunk
+        return ''.join(self.chunks)
+
+    def close(self) -> None:
+        self.port.close()
+
+
+def percentiles(samples: List[float]) -> Dict[str, float]:
+    """Nearest-rank percentiles of millisecond samples."""
+    if not samples:
+        return {}
+    ordered = sorted(samples)
+    result = {'count': len(ordered), 'mean': sum(ordered) / len(ordered), 'min': ordered[0]}
+    for p in PERCENTILES:
+        rank = max(1, math.ceil(p / 100.0 * len(ordered)))
+        result[f"p{p:g}"] = ordered[rank - 1]
+    result['max'] = ordered[-1]
+    return result
+
+
+def discover(link, deadline: float) -> Optional[Dict[str, str]]:
+    link.send(f"DISCOVER_DEVICE PORT={link.local_port}")
+    while True:
+        line = link.read_line(deadline)
+        if line is None:
+            return None
+        if line.startswith(DISCOVERY_PREFIX):
+            return dict(re.findall(r'(\w+)=(\S+)', line[len(DISCOVERY_PREFIX):]))
+
+
+def bench_discovery(link, iterations: int) -> Dict[str, object]:
+    samples = []
+    lost = 0
+    for _ in range(iterations):
+        start = time.perf_counter()
+        if discover(link, start + REPLY_TIMEOUT_S) is None:
+            lost += 1
+            continue
+        samples.append((time.perf_counter() - start) * 1000.0)
+    return {'ms': percentiles(samples), 'lost': lost}
+
+
+def bench_round_trip(link, iterations: int) -> Dict[str, object]:
+    """
+    Returns:
+        Percentiles of the ACK, INFO and DONE times and the count of commands that lost one
+    """
+    ack, info, done = [], [], []
+    lost = 0
+    request_id = int(time.time()) % 1000000 * 100
+    for i in range(iterations):
+        request_id += 1
+        command = 'pause' if i % 2 == 0 else 'resume'
+        tag = f"{request_id} "
+        seen = set()
+        start = time.perf_counter()
+        deadline = start + REPLY_TIMEOUT_S
+        link.send(f"#{request_id} {command}")
+        while 'done' not in seen:
+            line = link.read_line(deadline)
+            if line is None:
+                lost += 1
+                break
+            elapsed = (time.perf_counter() - start) * 1000.0
+            if line.startswith(ACK_PREFIX) and line[len(ACK_PREFIX):].strip() == str(request_id):
+                seen.add('ack')
+                ack.append(elapsed)
+            elif line.startswith(INFO_PREFIX + tag) and 'info' not in seen:
+                seen.add('info')
+                info.append(elapsed)
+                text = line[len(INFO_PREFIX + tag):].strip()
+                if command == 'pause' and text != IDLE_INFO:
+                    link.send(f"#{request_id + 1} resume")
+                    raise SystemExit(f"the press is not idle ({text}); resumed it and stopped")
+            elif line.startswith(DONE_PREFIX + tag):
+                seen.add('done')
+                done.append(elapsed)
+            elif line.startswith(ERROR_PREFIX + tag):
+                raise SystemExit(f"{command} was refused: {line}")
+    return {'ack_ms': percentiles(ack), 'info_ms': percentiles(info), 'done_ms': percentiles(done), 'lost': lost}
+
+
+def bench_telemetry(link, duration_s: float) -> Dict[str, object]:
+    arrivals = []
+    deadline = time.perf_counter() + duration_s
+    while True:
+        line = link.read_line(deadline)
+        if line is None:
+            break
+        if line.startswith(TELEM_PREFIXES):
+            arrivals.append(time.perf_counter() * 1000.0)
+    intervals = [b - a for a, b in zip(arrivals, arrivals[1:])]
+    if not intervals:
+        return {'interval_ms': {}, 'jitter_ms': {}}
+    period = percentiles(intervals)['p50']
+    return {'interval_ms': percentiles(intervals), 'jitter_ms': percentiles([abs(x - period) for x in intervals])}
+
+
+def print_row(name: str, stats: Dict[str, float]) -> None:
+    if not stats:
+        print(f"  {name:<20} no samples")
+        return
+    columns = '  '.join(f"{key}={stats[key]:7.3f}" for key in ['mean'] + [f"p{p:g}" for p in PERCENTILES] + ['max'])
+    print(f"  {name:<20} n={stats['count']:<6} {columns}")
+
+
+def run(link, options) -> Dict[str, object]:
+    identity = discover(link, time.perf_counter() + REPLY_TIMEOUT_S * 5)
+    if identity is None:
+        raise SystemExit(f"no DISCOVERY_RESPONSE over {link.name}")
+    results = {'link': link.name, 'identity': identity}
+    print(f"{link.name}: {identity.get('DEVICE_ID', '?')} FW={identity.get('FW', '?')}")
+
+    results['round_trip'] = bench_round_trip(link, options.iterations)
+    print(f"command round trip (pause/resume, {results['round_trip']['lost']} lost), ms")
+    for key in ('ack_ms', 'info_ms', 'done_ms'):
+        print_row(key[:-3].upper(), results['round_trip'][key])
+
+    results['telemetry'] = bench_telemetry(link, options.telemetry_seconds)
+    print(f"telemetry over {options.telemetry_seconds:g} s, ms")
+    print_row('interval', results['telemetry']['interval_ms'])
+    print_row('jitter', results['telemetry']['jitter_ms'])
+
+    results['discovery'] = bench_discovery(link, options.discoveries)
+    print(f"discovery ({results['discovery']['lost']} lost), ms")
+    print_row('DISCOVERY_RESPONSE', results['discovery']['ms'])
+    return results
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Measure command, telemetry and discovery latency of a press.')
+    parser.add_argument('--udp', metavar='HOST', help='press IP address')
+    parser.add_argument('--usb', metavar='PORT', help='serial port of the press (COM5, /dev/ttyACM0)')
+    parser.add_argument('--port', type=int, default=COMMAND_PORT, help='press command port (default %(default)s)')
+    parser.add_argument('--iterations', type=int, default=2000, help='pause/resume commands (default %(default)s)')
+    parser.add_argument('--discoveries', type=int, default=500, help='DISCOVER_DEVICE round trips (default %(default)s)')
+    parser.add_argument('--telemetry-seconds', type=float, default=30.0, help='telemetry listening time (default %(default)s)')
+    parser.add_argument('--json', metavar='FILE', help='also write the results to FILE')
+    options = parser.parse_args()
+    if not options.udp and not options.usb:
+        parser.error('give --udp HOST, --usb PORT or both')
+
+    links = []
+    if options.udp:
+        links.append(UdpLink(options.udp, options.port))
+    if options.usb:
+        links.append(UsbLink(options.usb))
+    results = []
+    try:
+        for link in links:
+            results.append(run(link, options))
+    finally:
+        for link in links:
+            link.close()
+    if options.json:
+        with open(options.json, 'w') as f:
+            json.dump(results, f, indent=2)
+    lost = sum(r['round_trip']['lost'] + r['discovery']['lost'] for r in results)
+    return 1 if lost else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
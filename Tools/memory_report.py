@@ -0,0 +1,110 @@
+"""
+SRAM Memory Map Report
+
+Reads the linked firmware image (pressboi.elf) and prints where the 192 KB of SRAM goes:
+the .data and .bss totals, what is left between the heap and the top of RAM for the stack,
+and the largest static objects. It parses the ELF symbol table itself, so it runs on any
+machine with Python 3 and needs no ARM toolchain; names are demangled when c++filt is on
+the PATH.
+
+Usage:
+
+    python Tools/memory_report.py Release/pressboi.elf
+    python Tools/memory_report.py Release/pressboi.elf --top 40 --min-free 16384
+
+With --min-free the script exits 1 if the stack and heap would get less than that many
+bytes, so a build step can refuse an image the way the linker scripts' 8 KB ASSERT does.
+The running unit's side of the picture (heap taken, stack high-water mark) is dump_mem.
+"""
+
+import argparse
+import shutil
+import struct
+import subprocess
+import sys
+from typing import Dict, List, Tuple
+
+RAM_START = 0x20000000
+RAM_BYTES = 0x30000
+
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+
+
+def read_elf(path: str) -> Tuple[Dict[str, Tuple[int, int]], List[Tuple[str, int, int]]]:
+    """
+    Returns:
+        (section name -> (address, size), [(symbol, address, size)] of the data objects)
+    """
+    with open(path, 'rb') as f:
+        image = f.read()
+    if image[:4] != b'\x7fELF' or image[4] != 1 or image[5] != 1:
+        raise ValueError(f"{path} is not a little-endian 32-bit ELF file")
+    shoff, = struct.unpack_from('<I', image, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', image, 0x2E)
+    headers = [struct.unpack_from('<IIIIIIIIII', image, shoff + i * shentsize) for i in range(shnum)]
+
+    def string(table: int, offset: int) -> str:
+        start = headers[table][4] + offset
+        return image[start:image.index(b'\0', start)].decode('ascii', 'replace')
+
+    sections = {}
+    symbols = []
+    for header in headers:
+        name, kind, _, addr, offset, size, link, _, _, entsize = header
+        sections[string(shstrndx, name)] = (addr, size)
+        if kind != SHT_SYMTAB:
+            continue
+        for pos in range(offset, offset + size, entsize):
+            st_name, st_value, st_size, st_info, _, _ = struct.unpack_from('<IIIBBH', image, pos)
+            if (st_info & 0xF) == STT_OBJECT and st_size > 0 and RAM_START <= st_value < RAM_START + RAM_BYTES:
+                symbols.append((string(link, st_name), st_value, st_size))
+    return sections, symbols
+
+
+def demangle(names: List[str]) -> List[str]:
+    tool = shutil.which('c++filt') or shutil.which('arm-none-eabi-c++filt')
+    if tool is None:
+        return names
+    try:
+        result = subprocess.run([tool], input='\n'.join(names), capture_output=True, text=True, check=True)
+    except (OSError, subprocess.CalledProcessError):
+        return names
+    lines = result.stdout.splitlines()
+    return lines if len(lines) == len(names) else names
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Report the SRAM use of a linked firmware image.')
+    parser.add_argument('elf', help='pressboi.elf from the build output directory')
+    parser.add_argument('--top', type=int, default=25, help='largest static objects to list (default 25)')
+    parser.add_argument('--min-free', type=int, default=0, help='exit 1 if the stack and heap get fewer bytes')
+    options = parser.parse_args()
+
+    try:
+        sections, symbols = read_elf(options.elf)
+    except (OSError, ValueError) as error:
+        print(f"memory_report: {error}", file=sys.stderr)
+        return 1
+    data = sections.get('.data', (0, 0))[1]
+    bss = sections.get('.bss', (0, 0))[1]
+    heap_start = sum(sections.get('.bss', (RAM_START, 0)))
+    free = RAM_START + RAM_BYTES - heap_start
+
+    print(f"SRAM {RAM_BYTES} bytes: .data {data}, .bss {bss}, free for stack and heap {free} "
+          f"({100.0 * free / RAM_BYTES:.1f}%)")
+    symbols.sort(key=lambda symbol: symbol[2], reverse=True)
+    shown = symbols[:options.top]
+    names = demangle([symbol[0] for symbol in shown])
+    for name, (_, addr, size) in zip(names, shown):
+        print(f"  {size:7d}  0x{addr:08x}  {name}")
+
+    if options.min_free and free < options.min_free:
+        print(f"memory_report: {free} bytes left for the stack and heap, {options.min_free} required",
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,400 @@
+"""
+Telemetry Soak and Fan-In Load Test
+
+Holds a press (or definition/simulator.py) under the load that queue overflows, USB chunk
+timeouts and watchdog resets only show up under, for as long as it is left running:
+
+- The test registers as the GUI with binary telemetry (TELEM=BIN1) and sets the telemetry
+  rate to --rate-hz, busy and idle.
+- --subscribers extra sockets take subscribe_telemetry at the same rate and renew their
+  leases, so every frame fans out to several hosts.
+- Commands flood in at --command-hz whether or not earlier ones have been answered:
+  '#<id> pause' and '#<id> resume' in turn, which do nothing on an idle press.
+- With --usb the USB mirror is drained as well, and CHUNK_ sequences that break off are
+  counted.
+
+It records the ACK and DONE latency of every command, the ones refused or never answered,
+the TELEMB frame counter gaps each telemetry receiver sees, the PRESSBOI_COMMS queue and
+drop counters, PRESSBOI_RECOVERY (watchdog) reports and reboots (the device clock going
+backwards). Events are printed as they happen and a summary line every --report-s; the
+exit status is 1 if anything was lost.
+
+Usage:
+
+    python Tools/soak_test.py --udp 192.168.1.50 --hours 8
+    python Tools/soak_test.py --udp 127.0.0.1 --port 18888 --minutes 10 --json soak.json
+    python Tools/soak_test.py --udp 192.168.1.50 --usb COM5 --subscribers 4 --command-hz 200
+
+The press must be idle: the test stops if a pause finds something to pause.
+"""
+
+import argparse
+import base64
+import binascii
+import json
+import re
+import selectors
+import socket
+import struct
+import sys
+import threading
+import time
+from typing import Dict, List, Optional
+
+from latency_bench import COMMAND_PORT, USB_BAUD, percentiles
+
+TELEMETRY_SUBSCRIBERS_MAX = 4       # TELEMETRY_SUBSCRIBER_COUNT in config.h
+RATE_HZ_MAX = 500.0                 # set_telemetry / subscribe_telemetry limit
+LEASE_S = 30
+REPLY_TIMEOUT_S = 2.0
+DISCOVER_INTERVAL_S = 5.0
+REBOOT_BACKSTEP_US = 1000000        # device clock stepping back further than this is a boot
+
+TELEMB_PREFIX = 'PRESSBOI_TELEMB: '
+COMMS_PREFIX = 'PRESSBOI_COMMS: '
+RECOVERY_PREFIX = 'PRESSBOI_RECOVERY: '
+DISCOVERY_PREFIX = 'DISCOVERY_RESPONSE: '
+ACK_PREFIX = 'PRESSBOI_ACK: #'
+IDLE_INFO = 'No active operation to pause.'
+TELEMB_HEADER = struct.Struct('<BBHI')
+
+_REPLY_RE = re.compile(r'PRESSBOI_(INFO|DONE|ERROR): #(\d+) (.*)', re.S)
+_CHUNK_RE = re.compile(r'CHUNK_(\d+)/(\d+):')
+
+
+class Receiver:
+    """A telemetry receiver: the GUI socket or one subscriber."""
+
+    def __init__(self, name: str):
+        self.name = name
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(('', 0))
+        self.sock.setblocking(False)
+        self.port = self.sock.getsockname()[1]
+        self.frames = 0
+        self.gaps = 0
+        self.seq: Optional[int] = None
+        self.time_us: Optional[int] = None
+
+    def frame(self, text: str) -> Optional[int]:
+        """
+        Counts one TELEMB frame.
+
+        Returns:
+            Its device time, or None if it does not decode
+        """
+        try:
+            data = base64.b64decode(text, validate=True)
+        except (binascii.Error, ValueError):
+            return None
+        if len(data) < TELEMB_HEADER.size:
+            return None
+        _, _, seq, time_us = TELEMB_HEADER.unpack_from(data)
+        self.frames += 1
+        if self.seq is not None:
+            self.gaps += (seq - self.seq - 1) & 0xFFFF
+        self.seq = seq
+        return time_us
+
+
+class UsbDrain(threading.Thread):
+    """Reads the USB mirror so its ring never backs up, counting messages and broken chunks."""
+
+    def __init__(self, port: str):
+        super().__init__(daemon=True)
+        try:
+            import serial
+        except ImportError:
+            raise SystemExit('--usb needs pyserial (pip install pyserial)')
+        self.port = serial.Serial(port, USB_BAUD, timeout=0.2)
+        self.messages = 0
+        self.broken_chunks = 0
+        self.running = True
+
+    def run(self) -> None:
+        buffer = b''
+        expected = None     # (next index, total) of a chunked message in progress
+        while self.running:
+            buffer += self.port.read(max(1, self.port.in_waiting))
+            while b'\n' in buffer:
+                raw, buffer = buffer.split(b'\n', 1)
+                match = _CHUNK_RE.match(raw.decode('ascii', 'replace'))
+                if match is None:
+                    if expected is not None:
+                        self.broken_chunks += 1
+                        expected = None
+                    self.messages += 1
+                    continue
+                index, total = int(match.group(1)), int(match.group(2))
+                if index == 1:
+                    if expected is not None:
+                        self.broken_chunks += 1
+                    expected = (1, total)
+                elif expected is None or expected != (index, total):
+                    self.broken_chunks += 1
+                    expected = None
+                    continue
+                if index == total:
+                    self.messages += 1
+                    expected = None
+                else:
+                    expected = (index + 1, total)
+        self.port.close()
+
+
+class SoakTest:
+    def __init__(self, options):
+        self.options = options
+        self.address = (options.udp, options.port)
+        self.gui = Receiver('gui')
+        self.subscribers = [Receiver(f"sub{i + 1}") for i in range(options.subscribers)]
+        self.selector = selectors.DefaultSelector()
+        for receiver in [self.gui] + self.subscribers:
+            self.selector.register(receiver.sock, selectors.EVENT_READ, receiver)
+        self.usb = UsbDrain(options.usb) if options.usb else None
+
+        self.start = time.monotonic()
+        self.identity: Dict[str, str] = {}
+        self.request_id = int(time.time()) % 1000000 * 100
+        self.outstanding: Dict[int, list] = {}   # id -> [sent, ACK ms or -1, is a pause]
+        self.sent = 0
+        self.lost = 0
+        self.refused: Dict[str, int] = {}
+        self.ack_ms: List[float] = []
+        self.done_ms: List[float] = []
+        self.comms_first: Optional[Dict[str, int]] = None
+        self.comms_last: Optional[Dict[str, int]] = None
+        self.recoveries: List[str] = []
+        self.reboots = 0
+        self.device_us: Optional[int] = None
+        self.events: List[str] = []
+
+    def log(self, text: str) -> None:
+        stamp = time.monotonic() - self.start
+        line = f"[{stamp / 3600:05.2f} h] {text}"
+        self.events.append(line)
+        print(line, flush=True)
+
+    def send(self, receiver: Receiver, text: str) -> None:
+        try:
+            receiver.sock.sendto(text.encode('ascii'), self.address)
+        except OSError as error:
+            self.log(f"{receiver.name}: send failed ({error})")
+
+    def register(self) -> None:
+        self.send(self.gui, f"DISCOVER_DEVICE PORT={self.gui.port} TELEM=BIN1")
+
+    def subscribe(self) -> None:
+        rate = self.options.rate_hz
+        for sub in self.subscribers:
+            self.send(sub, f"subscribe_telemetry {sub.port} {rate:g} {LEASE_S}")
+
+    def flood(self) -> None:
+        self.request_id += 1
+        command = 'pause' if self.request_id % 2 else 'resume'
+        self.outstanding[self.request_id] = [time.perf_counter(), -1.0, command == 'pause']
+        self.sent += 1
+        self.send(self.gui, f"#{self.request_id} {command}")
+
+    def expire(self) -> None:
+        limit = time.perf_counter() - REPLY_TIMEOUT_S
+        for request_id in [r for r, entry in self.outstanding.items() if entry[0] < limit]:
+            del self.outstanding[request_id]
+            self.lost += 1
+
+    def line(self, receiver: Receiver, line: str) -> None:
+        if line.startswith(TELEMB_PREFIX):
+            time_us = receiver.frame(line[len(TELEMB_PREFIX):].strip())
+            if receiver is self.gui and time_us is not None:
+                if self.device_us is not None and time_us + REBOOT_BACKSTEP_US < self.device_us:
+                    self.reboots += 1
+                    self.log(f"device clock went back {self.device_us - time_us} us: the press rebooted")
+                self.device_us = time_us
+            return
+        if receiver is not self.gui:
+            return
+        if line.startswith(ACK_PREFIX):
+            entry = self.outstanding.get(int(line[len(ACK_PREFIX):].strip() or 0))
+            if entry is not None and entry[1] < 0:
+                entry[1] = (time.perf_counter() - entry[0]) * 1000.0
+                self.ack_ms.append(entry[1])
+            return
+        match = _REPLY_RE.match(line)
+        if match:
+            self.reply(match.group(1), int(match.group(2)), match.group(3).strip())
+        elif line.startswith(COMMS_PREFIX):
+            counters = {}
+            for part in line[len(COMMS_PREFIX):].strip().split(','):
+                key, _, value = part.partition(':')
+                if value.isdigit():
+                    counters[key] = int(value)
+            if self.comms_first is None:
+                self.comms_first = counters
+            elif self.comms_last is not None:
+                grown = [f"{k} +{v - self.comms_last.get(k, v)}" for k, v in counters.items()
+                         if k.endswith(('drops', 'skips', 'timeouts', 'errors', 'replaced')) and v > self.comms_last.get(k, v)]
+                if grown:
+                    self.log('comms: ' + ', '.join(grown))
+            self.comms_last = counters
+        elif line.startswith(RECOVERY_PREFIX):
+            self.recoveries.append(line[len(RECOVERY_PREFIX):].strip())
+            self.log(f"watchdog recovery: {self.recoveries[-1]}")
+        elif line.startswith(DISCOVERY_PREFIX) and not self.identity:
+            self.identity = dict(re.findall(r'(\w+)=(\S+)', line[len(DISCOVERY_PREFIX):]))
+
+    def reply(self, status: str, request_id: int, text: str) -> None:
+        entry = self.outstanding.get(request_id)
+        if entry is None:
+            return
+        if status == 'INFO':
+            if entry[2] and text != IDLE_INFO:
+                self.send(self.gui, f"#{self.request_id + 1} resume")
+                raise SystemExit(f"the press is not idle ({text}); resumed it and stopped")
+            return
+        del self.outstanding[request_id]
+        if status == 'ERROR':
+            self.refused[text] = self.refused.get(text, 0) + 1
+            if self.refused[text] == 1:
+                self.log(f"refused: {text}")
+            return
+        self.done_ms.append((time.perf_counter() - entry[0]) * 1000.0)
+
+    def poll(self, timeout: float) -> None:
+        for key, _ in self.selector.select(timeout):
+            receiver = key.data
+            while True:
+                try:
+                    data = receiver.sock.recv(4096)
+                except (BlockingIOError, ConnectionResetError):
+                    break
+                for line in data.decode('ascii', 'replace').split('\n'):
+                    if line:
+                        self.line(receiver, line)
+
+    def report(self, final: bool = False) -> None:
+        elapsed = time.monotonic() - self.start
+        done = percentiles(self.done_ms)
+        receivers = ' '.join(f"{r.name}={r.frames / elapsed:.0f}Hz/{r.gaps}gap" for r in [self.gui] + self.subscribers)
+        usb = f" usb={self.usb.messages}msg/{self.usb.broken_chunks}broken" if self.usb else ''
+        print(f"{'final' if final else 'status'}: {elapsed / 60:.1f} min, {self.sent} sent, {len(self.done_ms)} done, "
+              f"{sum(self.refused.values())} refused, {self.lost} lost, done p50/p99/max="
+              f"{done.get('p50', 0):.2f}/{done.get('p99', 0):.2f}/{done.get('max', 0):.2f} ms, {receivers}{usb}, "
+              f"{len(self.recoveries)} recoveries, {self.reboots} reboots", flush=True)
+
+    def run(self) -> Dict[str, object]:
+        if self.usb:
+            self.usb.start()
+        self.register()
+        deadline = time.monotonic() + 5.0
+        while not self.identity:
+            if time.monotonic() > deadline:
+                raise SystemExit(f"no DISCOVERY_RESPONSE from {self.address[0]}:{self.address[1]}")
+            self.poll(0.1)
+        print(f"{self.identity.get('DEVICE_ID', '?')} FW={self.identity.get('FW', '?')}: "
+              f"{self.options.rate_hz:g} Hz telemetry to {1 + len(self.subscribers)} receivers, "
+              f"{self.options.command_hz:g} commands/s for {self.options.duration_s / 60:g} min", flush=True)
+        rate = self.options.rate_hz
+        self.send(self.gui, f"set_telemetry {rate:g} {rate:g}")
+        self.subscribe()
+
+        end = self.start + self.options.duration_s
+        period = 1.0 / self.options.command_hz if self.options.command_hz > 0 else None
+        next_command = time.monotonic()
+        next_discover = time.monotonic() + DISCOVER_INTERVAL_S
+        next_lease = time.monotonic() + LEASE_S / 3.0
+        next_report = time.monotonic() + self.options.report_s
+        try:
+            while True:
+                now = time.monotonic()
+                if now >= end:
+                    break
+                if period is not None:
+                    # Catch up after a slow pass rather than drift; the flood keeps its rate
+                    while next_command <= now:
+                        self.flood()
+                        next_command += period
+                if now >= next_discover:
+                    # Re-registering also restores the rate and subscriptions after a reboot
+                    self.register()
+                    self.send(self.gui, f"set_telemetry {rate:g} {rate:g}")
+                    next_discover = now + DISCOVER_INTERVAL_S
+                if now >= next_lease:
+                    self.subscribe()
+                    next_lease = now + LEASE_S / 3.0
+                if now >= next_report:
+                    self.report()
+                    next_report = now + self.options.report_s
+                self.expire()
+                wake = min(end, next_discover, next_lease, next_report, next_command if period else end)
+                self.poll(max(0.0, wake - time.monotonic()))
+        except KeyboardInterrupt:
+            self.log('interrupted')
+        finally:
+            for sub in self.subscribers:
+                self.send(sub, f"unsubscribe_telemetry {sub.port}")
+            if self.usb:
+                self.usb.running = False
+        self.poll(REPLY_TIMEOUT_S)
+        self.lost += len(self.outstanding)
+        self.outstanding.clear()
+        self.report(final=True)
+        return self.results()
+
+    def results(self) -> Dict[str, object]:
+        comms = {}
+        if self.comms_first is not None and self.comms_last is not None:
+            comms = {k: v - self.comms_first.get(k, 0) for k, v in self.comms_last.items() if not k.endswith('peak')}
+            comms.update({k: v for k, v in self.comms_last.items() if k.endswith('peak')})
+        return {
+            'identity': self.identity,
+            'duration_s': time.monotonic() - self.start,
+            'options': {'rate_hz': self.options.rate_hz, 'subscribers': self.options.subscribers,
+                        'command_hz': self.options.command_hz, 'usb': bool(self.usb)},
+            'commands': {'sent': self.sent, 'done': len(self.done_ms), 'lost': self.lost, 'refused': self.refused,
+                         'ack_ms': percentiles(self.ack_ms), 'done_ms': percentiles(self.done_ms)},
+            'telemetry': {r.name: {'frames': r.frames, 'gaps': r.gaps} for r in [self.gui] + self.subscribers},
+            'usb': {'messages': self.usb.messages, 'broken_chunks': self.usb.broken_chunks} if self.usb else None,
+            'comms': comms,
+            'recoveries': self.recoveries,
+            'reboots': self.reboots,
+            'events': self.events,
+        }
+
+    def failed(self, results: Dict[str, object]) -> bool:
+        drops = sum(v for k, v in results['comms'].items() if k.endswith(('drops', 'timeouts')))
+        gaps = sum(t['gaps'] for t in results['telemetry'].values())
+        broken = results['usb']['broken_chunks'] if results['usb'] else 0
+        return bool(self.lost or drops or gaps or broken or self.recoveries or self.reboots)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Soak a press with telemetry fan-out and a command flood.')
+    parser.add_argument('--udp', metavar='HOST', required=True, help='press (or simulator) IP address')
+    parser.add_argument('--port', type=int, default=COMMAND_PORT, help='press command port (default %(default)s)')
+    parser.add_argument('--usb', metavar='PORT', help='also drain the USB mirror on this serial port')
+    parser.add_argument('--subscribers', type=int, default=TELEMETRY_SUBSCRIBERS_MAX,
+                        help='subscribe_telemetry receivers besides the GUI, 0-%(default)s')
+    parser.add_argument('--rate-hz', type=float, default=RATE_HZ_MAX, help='telemetry rate (default %(default)s)')
+    parser.add_argument('--command-hz', type=float, default=100.0, help='commands per second (default %(default)s)')
+    length = parser.add_mutually_exclusive_group()
+    length.add_argument('--hours', type=float, help='run time in hours')
+    length.add_argument('--minutes', type=float, help='run time in minutes (default 60)')
+    parser.add_argument('--report-s', type=float, default=60.0, help='seconds between status lines (default %(default)s)')
+    parser.add_argument('--json', metavar='FILE', help='also write the results to FILE')
+    options = parser.parse_args()
+    if not 0 <= options.subscribers <= TELEMETRY_SUBSCRIBERS_MAX:
+        parser.error(f"--subscribers must be 0-{TELEMETRY_SUBSCRIBERS_MAX}")
+    if not 0.5 <= options.rate_hz <= RATE_HZ_MAX:
+        parser.error(f"--rate-hz must be 0.5-{RATE_HZ_MAX:g}")
+    options.duration_s = options.hours * 3600.0 if options.hours else (options.minutes or 60.0) * 60.0
+
+    test = SoakTest(options)
+    results = test.run()
+    if options.json:
+        with open(options.json, 'w') as f:
+            json.dump(results, f, indent=2)
+    return 1 if test.failed(results) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
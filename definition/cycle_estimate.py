@@ -0,0 +1,267 @@
+"""
+Recipe Cycle-Time Estimate
+
+Host-side copy of the firmware's CycleEstimate (inc/cycle_estimate.h): plays a recipe
+through the move acceleration, the S-curve jerk, the 100 mm/s move ceiling, blending of
+same-direction moves, the adaptive rapid approach and the retract limits, and predicts
+each step's motion, dwell and retract time. A step is accel-bound when ramping costs more
+than the cruise would at its speed (or the speed is never reached), dwell-bound when a
+dwell or regulated hold outlasts its motion, and speed-bound otherwise. Press moves are
+timed to their target, so a step that stops on its force limit comes in under its estimate.
+
+Steps use the recipe_add syntax, so a script can size a recipe before uploading it:
+
+    steps = ['move 40 20', 'move 45 2 100 regulate 1000', 'dwell 500', 'retract']
+    estimate = estimate_recipe(steps, Limits(jerk_mmss3=2500.0))
+    print(estimate.total_ms, [step.bound for step in estimate.steps])
+
+    done = await press.run_recipe('bracket')
+    for phase, (measured, estimated) in estimate.compare(done.metrics()).items():
+        print(f"{phase}: {measured:.1f} / {estimated:.1f} ms")
+
+recipe_save reports the firmware's own estimate as INFO lines, and run_recipe reports the
+measured/estimated comparison just before its DONE; this module is for planning offline.
+"""
+
+import math
+from dataclasses import dataclass, field
+from typing import Dict, Iterable, List, Optional, Tuple
+
+MOVE_SPEED_MAX_MMS = 100.0              # MOVE_SPEED_MAX_MMS in config.h
+MOVE_DEFAULT_VELOCITY_MMS = 6.25        # MOVE_DEFAULT_VELOCITY_MMS in config.h
+MOVE_DEFAULT_ACCEL_MMSS = 62.5          # MOVE_DEFAULT_ACCEL_MMSS in config.h
+RETRACT_DEFAULT_SPEED_MMS = 25.0        # RETRACT_DEFAULT_SPEED_MMS in config.h
+FORCE_REGULATE_DWELL_MS_DEFAULT = 1000  # FORCE_REGULATE_DWELL_MS_DEFAULT in config.h
+MOTION_BLEND_ENABLED = True             # MOTION_BLEND_ENABLED in config.h
+
+BOUND_NONE = 'none'
+BOUND_SPEED = 'speed'
+BOUND_ACCEL = 'accel'
+BOUND_DWELL = 'dwell'
+
+
+@dataclass
+class Limits:
+    """Machine settings a run is estimated with (CycleEstimateLimits)."""
+    start_mm: float = 0.0                               # Where the run starts (firmware upload: the retract position)
+    retract_mm: float = 0.0                             # Retract position
+    accel_mmss: float = MOVE_DEFAULT_ACCEL_MMSS         # Move acceleration
+    jerk_mmss3: float = 0.0                             # set_motion_profile scurve jerk (0 = trapezoid)
+    retract_speed_mms: float = RETRACT_DEFAULT_SPEED_MMS  # set_retract speed
+    traverse_ceiling_mms: float = MOVE_SPEED_MAX_MMS    # Rapid traverse ceiling, when a rapid is allowed
+    traverse_accel_mmss: float = MOVE_DEFAULT_ACCEL_MMSS  # Acceleration of the retract after a "retract" action
+    adaptive: bool = True                               # load_cell mode: learned contacts get the rapid approach
+    learn_margin_mm: float = 0.0                        # recipe_learn margin (0 = off)
+    learn_rapid_mms: float = 0.0                        # recipe_learn rapid speed
+    contacts_mm: Dict[int, float] = field(default_factory=dict)  # Learned contact per step index
+
+
+@dataclass
+class Step:
+    """One recipe step (MotionSegment)."""
+    kind: str                   # move, dwell or retract
+    position_mm: float = 0.0
+    speed_mms: float = 0.0
+    force_kg: float = 0.0
+    force_action: str = 'hold'
+    dwell_ms: int = 0
+
+
+@dataclass
+class StepEstimate:
+    """Estimated time of one step (SegmentEstimate)."""
+    move_ms: float
+    dwell_ms: float
+    retract_ms: float
+    bound: str
+
+    @property
+    def total_ms(self) -> float:
+        return self.move_ms + self.dwell_ms + self.retract_ms
+
+
+@dataclass
+class Estimate:
+    """The whole run."""
+    steps: List[StepEstimate]
+
+    @property
+    def move_ms(self) -> float:
+        return sum(step.move_ms for step in self.steps)
+
+    @property
+    def dwell_ms(self) -> float:
+        return sum(step.dwell_ms for step in self.steps)
+
+    @property
+    def retract_ms(self) -> float:
+        return sum(step.retract_ms for step in self.steps)
+
+    @property
+    def total_ms(self) -> float:
+        return self.move_ms + self.dwell_ms + self.retract_ms
+
+    def compare(self, metrics: Dict[str, float]) -> Dict[str, Tuple[float, float]]:
+        """
+        Pairs the phase times of a run's DONE (Reply.metrics()) with the estimate.
+
+        Returns:
+            {'move', 'dwell', 'retract', 'cycle'}: (measured ms, estimated ms); move is
+            approach plus press, and cycle also holds the unestimated start phase
+        """
+        return {
+            'move': (metrics.get('approach_ms', 0.0) + metrics.get('press_ms', 0.0), self.move_ms),
+            'dwell': (metrics.get('dwell_ms', 0.0), self.dwell_ms),
+            'retract': (metrics.get('retract_ms', 0.0), self.retract_ms),
+            'cycle': (metrics.get('cycle_ms', 0.0), self.total_ms),
+        }
+
+
+def parse_step(text: str) -> Step:
+    """
+    Parses a step in the recipe_add syntax: 'move <pos> [speed] [force] [action] [hold_ms]',
+    'dwell <ms>' or 'retract [speed]'.
+    """
+    words = text.split()
+    if not words:
+        raise ValueError('empty step')
+    kind, args = words[0], words[1:]
+    if kind == 'move' and 1 <= len(args) <= 5:
+        return Step('move', float(args[0]),
+                    float(args[1]) if len(args) >= 2 else MOVE_DEFAULT_VELOCITY_MMS,
+                    float(args[2]) if len(args) >= 3 else 0.0,
+                    args[3] if len(args) >= 4 else 'hold',
+                    int(args[4]) if len(args) >= 5 else FORCE_REGULATE_DWELL_MS_DEFAULT)
+    if kind == 'dwell' and len(args) == 1:
+        return Step('dwell', dwell_ms=int(args[0]))
+    if kind == 'retract' and len(args) <= 1:
+        return Step('retract', speed_mms=float(args[0]) if args else 0.0)
+    raise ValueError(f"invalid step: {text!r}")
+
+
+def _scurve_accel(vel: float, accel_max: float, jerk_max: float) -> Tuple[float, float]:
+    """Accel phase of SCurveProfile::planAccel(): (duration, distance)."""
+    if vel * jerk_max >= accel_max * accel_max:
+        accel_time = vel / accel_max + accel_max / jerk_max
+    else:
+        accel_time = 2.0 * math.sqrt(vel / jerk_max)
+    return accel_time, 0.5 * vel * accel_time
+
+
+def _scurve_time(distance: float, vel_max: float, accel_max: float, jerk_max: float) -> Tuple[float, float]:
+    """SCurveProfile::plan(): (duration, peak velocity)."""
+    vel = vel_max
+    accel_time, accel_dist = _scurve_accel(vel, accel_max, jerk_max)
+    if 2.0 * accel_dist > distance:
+        low, high = 0.0, vel_max
+        for _ in range(24):
+            mid = 0.5 * (low + high)
+            if 2.0 * _scurve_accel(mid, accel_max, jerk_max)[1] > distance:
+                high = mid
+            else:
+                low = mid
+        vel = low
+        accel_time, accel_dist = _scurve_accel(vel, accel_max, jerk_max)
+    cruise_time = max(0.0, (distance - 2.0 * accel_dist) / vel) if vel > 0.0 else 0.0
+    return 2.0 * accel_time + cruise_time, vel
+
+
+def _ramp_time(distance: float, v0: float, vel: float, v1: float, accel: float) -> Tuple[float, bool]:
+    """Constant-acceleration time from v0 to v1 cruising at up to vel: (seconds, cruised)."""
+    up = (vel * vel - v0 * v0) / (2.0 * accel)
+    down = (vel * vel - v1 * v1) / (2.0 * accel)
+    if up + down <= distance:
+        return (vel - v0) / accel + (vel - v1) / accel + (distance - up - down) / vel, True
+    peak = math.sqrt(accel * distance + 0.5 * (v0 * v0 + v1 * v1))
+    if peak < max(v0, v1):
+        return 2.0 * distance / (v0 + v1), False
+    return (peak - v0) / accel + (peak - v1) / accel, False
+
+
+def _move_time(distance: float, vel: float, accel: float, jerk: float, v0: float, v1: float) -> Tuple[float, bool]:
+    if distance <= 0.0 or vel <= 0.0 or accel <= 0.0:
+        return 0.0, True
+    if jerk > 0.0 and v0 == 0.0 and v1 == 0.0:
+        duration, peak = _scurve_time(distance, vel, accel, jerk)
+        return duration, peak >= 0.999 * vel
+    return _ramp_time(distance, v0, vel, v1, accel)
+
+
+def estimate_recipe(steps: Iterable, limits: Optional[Limits] = None) -> Estimate:
+    """
+    Estimates a recipe the way CycleEstimate::plan() does.
+
+    Args:
+        steps: Step objects or recipe_add strings, in run order
+        limits: Machine settings (defaults: config.h defaults, trapezoidal moves)
+    """
+    limits = limits or Limits()
+    steps = [parse_step(step) if isinstance(step, str) else step for step in steps]
+    estimates = []
+    position = limits.start_mm
+    entry_mms = 0.0
+    for index, step in enumerate(steps):
+        move_s = retract_s = cruise_s = 0.0
+        dwell_ms = 0.0
+        cruised = True
+        exit_mms = 0.0
+        if step.kind == 'dwell':
+            dwell_ms = float(step.dwell_ms)
+        elif step.kind == 'retract':
+            speed = min(step.speed_mms if step.speed_mms > 0.0 else limits.retract_speed_mms, MOVE_SPEED_MAX_MMS)
+            distance = abs(limits.retract_mm - position)
+            retract_s, cruised = _move_time(distance, speed, limits.accel_mmss, limits.jerk_mmss3, 0.0, 0.0)
+            cruise_s = distance / speed if speed > 0.0 else 0.0
+            position = limits.retract_mm
+        else:
+            speed = min(step.speed_mms, MOVE_SPEED_MAX_MMS)
+            distance = abs(step.position_mm - position)
+            direction = 1.0 if step.position_mm >= position else -1.0
+            regulate = step.force_action == 'regulate'
+            retracts = step.force_action == 'retract'
+
+            rapid_mms = min(limits.learn_rapid_mms, limits.traverse_ceiling_mms)
+            contact_mm = limits.contacts_mm.get(index)
+            rapid = (limits.adaptive and entry_mms == 0.0 and speed > 0.0 and limits.learn_margin_mm > 0.0 and
+                     step.force_kg > 0.0 and not regulate and rapid_mms > speed and contact_mm is not None)
+            if rapid:
+                switch_mm = contact_mm - limits.learn_margin_mm * direction
+                rapid = (switch_mm - position) * direction > 0.0 and (step.position_mm - switch_mm) * direction > 0.0
+
+            if (MOTION_BLEND_ENABLED and index + 1 < len(steps) and limits.jerk_mmss3 <= 0.0 and not regulate and
+                    not retracts and not rapid and distance > 0.0):
+                following = steps[index + 1]
+                if (following.kind == 'move' and following.force_action != 'regulate' and
+                        (following.position_mm - step.position_mm) * direction > 0.0):
+                    exit_mms = min(speed, following.speed_mms, MOVE_SPEED_MAX_MMS)
+
+            if rapid:
+                rapid_mm = abs(switch_mm - position)
+                press_mm = distance - rapid_mm
+                rapid_s, rapid_cruised = _ramp_time(rapid_mm, 0.0, rapid_mms, speed, limits.accel_mmss)
+                press_s, press_cruised = _ramp_time(press_mm, speed, speed, 0.0, limits.accel_mmss)
+                move_s = rapid_s + press_s
+                cruised = rapid_cruised and press_cruised
+                cruise_s = rapid_mm / rapid_mms + press_mm / speed
+            else:
+                move_s, cruised = _move_time(distance, speed, limits.accel_mmss, limits.jerk_mmss3, entry_mms, exit_mms)
+                cruise_s = distance / speed if speed > 0.0 else 0.0
+            if regulate:
+                dwell_ms = float(step.dwell_ms)
+            position = step.position_mm
+            if retracts:
+                traverse_mms = min(limits.retract_speed_mms, limits.traverse_ceiling_mms)
+                distance = abs(limits.retract_mm - position)
+                retract_s = _ramp_time(distance, 0.0, traverse_mms, 0.0, limits.traverse_accel_mmss)[0] if distance > 0.0 else 0.0
+                position = limits.retract_mm
+
+        motion_s = retract_s if step.kind == 'retract' else move_s
+        if dwell_ms > (move_s + retract_s) * 1000.0:
+            bound = BOUND_DWELL
+        elif motion_s > 0.0:
+            bound = BOUND_ACCEL if (not cruised or motion_s - cruise_s > cruise_s) else BOUND_SPEED
+        else:
+            bound = BOUND_NONE
+        estimates.append(StepEstimate(move_s * 1000.0, dwell_ms, retract_s * 1000.0, bound))
+        entry_mms = exit_mms
+    return Estimate(estimates)
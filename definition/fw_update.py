@@ -0,0 +1,94 @@
+"""
+Network Firmware Update
+
+Streams a firmware image (Debug/pressboi.bin) to one or more presses over Ethernet with
+the fw_update command: 'fw_update begin <size> <crc>' over UDP, the raw image over TCP on
+FW_UPDATE_PORT, then 'fw_update apply' once the press has answered 'OK <crc>'. Presses are
+updated one after another; a press that fails is reported and the rest still run.
+
+Usage (from the repository root):
+
+    python definition/fw_update.py Debug/pressboi.bin 192.168.1.50 192.168.1.51
+    python definition/fw_update.py Debug/pressboi.bin 192.168.1.50 --stage-only
+"""
+
+import argparse
+import socket
+import sys
+import time
+import zlib
+from pathlib import Path
+
+COMMAND_PORT = 8888     # LOCAL_PORT in config.h
+FW_UPDATE_PORT = 8890   # FW_UPDATE_PORT in config.h
+CONNECT_TIMEOUT_S = 5.0
+REPLY_TIMEOUT_S = 60.0  # erase, stream and verify of a full staging area
+
+
+def send_command(host: str, text: str) -> None:
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.sendto(text.encode('ascii'), (host, COMMAND_PORT))
+
+
+def connect(host: str) -> socket.socket:
+    """The listener opens on the first fw_update begin, so retry until it is up."""
+    deadline = time.monotonic() + CONNECT_TIMEOUT_S
+    while True:
+        try:
+            return socket.create_connection((host, FW_UPDATE_PORT), timeout=CONNECT_TIMEOUT_S)
+        except OSError:
+            if time.monotonic() >= deadline:
+                raise
+            time.sleep(0.2)
+
+
+def stage(host: str, image: bytes) -> str:
+    """
+    Stages the image on one press.
+
+    Returns:
+        The press's reply line, 'OK <crc>' or 'ERROR <reason>'
+    """
+    crc = zlib.crc32(image) & 0xFFFFFFFF
+    send_command(host, f"fw_update begin {len(image)} {crc:08X}")
+    with connect(host) as sock:
+        # The press reads only as fast as it programs; sendall() blocks on its TCP window
+        sock.settimeout(REPLY_TIMEOUT_S)
+        sock.sendall(image)
+        reply = b''
+        while not reply.endswith(b'\n'):
+            chunk = sock.recv(64)
+            if not chunk:
+                break
+            reply += chunk
+    return reply.decode('ascii', 'replace').strip() or 'ERROR connection closed without a reply'
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Update press firmware over Ethernet.')
+    parser.add_argument('image', type=Path, help='raw application image (pressboi.bin)')
+    parser.add_argument('hosts', nargs='+', help='press IP addresses')
+    parser.add_argument('--stage-only', action='store_true', help='verify the staged image but do not apply it')
+    options = parser.parse_args()
+
+    image = options.image.read_bytes()
+    failed = 0
+    for host in options.hosts:
+        try:
+            reply = stage(host, image)
+        except OSError as error:
+            reply = f"ERROR {error}"
+        if not reply.startswith('OK'):
+            print(f"{host}: {reply}", file=sys.stderr)
+            failed += 1
+            continue
+        if options.stage_only:
+            print(f"{host}: staged ({reply})")
+            continue
+        send_command(host, 'fw_update apply')
+        print(f"{host}: staged ({reply}), applying and rebooting")
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
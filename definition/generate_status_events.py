@@ -0,0 +1,242 @@
+"""
+Status Event Generator
+
+Generates inc/status_event_ids.h and src/status_event_ids.cpp from status_events.json, the
+catalog of status messages the device posts as typed EventRecords instead of text. Each
+entry's id is its wire value and is never reused or renumbered: a host rendering records
+with an older catalog must not show another event's text. The generator refuses a catalog
+whose ids collide or whose text template does not match its argument schema, so the
+firmware's formatter and the host's str.format() always agree on a record.
+
+Usage (from the repository root):
+
+    python definition/generate_status_events.py
+    python definition/generate_status_events.py --check   # exit 1 if the outputs are stale
+"""
+
+import argparse
+import datetime
+import json
+import re
+import sys
+from pathlib import Path
+from typing import Any, Dict, List, Tuple
+
+DEFINITION_DIR = Path(__file__).parent
+REPO_DIR = DEFINITION_DIR.parent
+
+MAX_ARGS = 3            # EVENT_RECORD_MAX_ARGS in config.h
+MAX_ID = 255            # EventRecord.id is one byte
+STATUSES = ('INFO', 'ERROR', 'DONE', 'START')
+ARG_TYPES = ('int', 'float')
+
+# The only placeholders EventQueue::formatText() renders: {n} and {n:.Df}
+_PLACEHOLDER_RE = re.compile(r'\{(\d)(?::\.(\d)f)?\}')
+_ANY_BRACE_RE = re.compile(r'[{}]')
+
+
+def load_catalog(path: Path) -> List[Tuple[str, Dict[str, Any]]]:
+    """
+    Reads and checks status_events.json.
+
+    Returns:
+        (name, entry) pairs in id order
+
+    Raises:
+        ValueError: The catalog has a duplicate or out-of-range id, an unknown status or
+            argument type, or a template that does not match its arguments
+    """
+    with open(path, 'r', encoding='utf-8') as f:
+        catalog = json.load(f)
+    seen: Dict[int, str] = {}
+    for name, entry in catalog.items():
+        event_id = entry.get('id')
+        if not isinstance(event_id, int) or not 1 <= event_id <= MAX_ID:
+            raise ValueError(f"{name}: id must be an integer in 1..{MAX_ID}")
+        if event_id in seen:
+            raise ValueError(f"{name}: id {event_id} already used by {seen[event_id]}")
+        seen[event_id] = name
+        if entry.get('status') not in STATUSES:
+            raise ValueError(f"{name}: status must be one of {', '.join(STATUSES)}")
+        args = entry.get('args', [])
+        if len(args) > MAX_ARGS:
+            raise ValueError(f"{name}: at most {MAX_ARGS} args")
+        for arg in args:
+            if arg.get('type') not in ARG_TYPES:
+                raise ValueError(f"{name}: arg {arg.get('parameter')} type must be int or float")
+        check_template(name, entry['text'], args)
+    return sorted(catalog.items(), key=lambda item: item[1]['id'])
+
+
+def check_template(name: str, text: str, args: List[Dict[str, Any]]) -> None:
+    """Each argument is used, each placeholder names an argument, and its format fits its type."""
+    used = set()
+    for match in _PLACEHOLDER_RE.finditer(text):
+        index = int(match.group(1))
+        if index >= len(args):
+            raise ValueError(f"{name}: placeholder {match.group(0)} has no argument")
+        is_float = match.group(2) is not None
+        if is_float != (args[index]['type'] == 'float'):
+            raise ValueError(f"{name}: placeholder {match.group(0)} does not fit a {args[index]['type']} argument")
+        used.add(index)
+    if _ANY_BRACE_RE.search(_PLACEHOLDER_RE.sub('', text)):
+        raise ValueError(f"{name}: only {{n}} and {{n:.Df}} placeholders are supported")
+    if len(used) != len(args):
+        raise ValueError(f"{name}: every argument must appear in the text")
+
+
+def enum_name(name: str) -> str:
+    return 'STATUS_EVENT_' + name.upper()
+
+
+def c_string(text: str) -> str:
+    return '"' + text.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def arg_summary(args: List[Dict[str, Any]]) -> str:
+    if not args:
+        return ''
+    return ' (' + ', '.join(f"arg{i} = {arg['parameter']}" for i, arg in enumerate(args)) + ')'
+
+
+def generate_header(events: List[Tuple[str, Dict[str, Any]]], stamp: str) -> str:
+    count = events[-1][1]['id'] + 1
+    width = max(len(enum_name(name)) for name, _ in events) + len(' = 000,')
+    lines = [
+        '/**',
+        ' * @file status_event_ids.h',
+        ' * @brief Defines the IDs and argument schemas of the typed status events.',
+        ' * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY',
+        f' * Generated from status_events.json on {stamp}',
+        ' * ',
+        ' * One ID per status message the device posts as an EventRecord (see event_queue.h)',
+        ' * instead of formatting text. Text clients get the message rendered from the same',
+        ' * template the host uses for EVENT=BIN1 records.',
+        ' * To modify typed events, edit status_events.json and run generate_status_events.py.',
+        ' */',
+        '#pragma once',
+        '',
+        '#include <stdint.h>',
+        '#include "text_format.h"',
+        '',
+        '//' + '=' * 98,
+        '// Status Event Enum',
+        '//' + '=' * 98,
+        '',
+        '/**',
+        ' * @enum StatusEventId',
+        ' * @brief Enumerates all typed status events. Values are fixed by status_events.json and never reused.',
+        ' */',
+        'enum StatusEventId : uint8_t {',
+        f"    {'STATUS_EVENT_NONE = 0,':<{width}}  ///< Unused.",
+    ]
+    for index, (name, entry) in enumerate(events):
+        sep = ',' if index < len(events) - 1 else ''
+        decl = f"{enum_name(name)} = {entry['id']}{sep}"
+        doc = entry['description'].rstrip('.') + arg_summary(entry.get('args', []))
+        lines.append(f"    {decl:<{width}}  ///< {doc}")
+    lines += [
+        '};',
+        '',
+        f"#define {'STATUS_EVENT_COUNT':<{width - 4}}  {count}  ///< One past the highest ID",
+        '',
+        '//' + '=' * 98,
+        '// Status Event Formats',
+        '//' + '=' * 98,
+        '',
+        '/**',
+        ' * @struct StatusEventFormat',
+        ' * @brief Status prefix, text template and argument schema of one StatusEventId.',
+        ' * @details "{n}" in text is argument n as an integer, "{n:.Df}" argument n as a float',
+        ' * with D decimals.',
+        ' */',
+        'typedef struct {',
+        '    TextView    prefix;                         ///< STATUS_PREFIX_* of the event\'s status, with its length',
+        '    const char* text;                           ///< Text template, empty for unassigned IDs',
+        '    uint8_t     arg_count;                      ///< Arguments the event carries',
+        '    uint8_t     float_args;                     ///< Bit n set if argument n is a float',
+        '} StatusEventFormat;',
+        '',
+        '/**',
+        ' * @brief Looks up the format of an event.',
+        ' * @param id Event ID',
+        ' * @return The event\'s format; STATUS_EVENT_NONE\'s (empty text) for an unassigned or unknown ID',
+        ' */',
+        'const StatusEventFormat* status_event_format(uint8_t id);',
+        '',
+    ]
+    return '\n'.join(lines)
+
+
+def generate_source(events: List[Tuple[str, Dict[str, Any]]], stamp: str) -> str:
+    by_id = {entry['id']: (name, entry) for name, entry in events}
+    count = events[-1][1]['id'] + 1
+    lines = [
+        '/**',
+        ' * @file status_event_ids.cpp',
+        ' * @brief Status event format table for the Pressboi controller.',
+        ' * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY',
+        f' * Generated from status_events.json on {stamp}',
+        ' */',
+        '',
+        '#include "status_event_ids.h"',
+        '#include "events.h"',
+        '#include <stddef.h>',
+        '',
+        '// Format table indexed by StatusEventId',
+        'static constexpr StatusEventFormat STATUS_EVENT_TABLE[STATUS_EVENT_COUNT] = {',
+    ]
+    for event_id in range(count):
+        if event_id not in by_id:
+            lines.append('    { TEXT_VIEW(STATUS_PREFIX_INFO),  "", 0, 0x0 },')
+            continue
+        name, entry = by_id[event_id]
+        args = entry.get('args', [])
+        float_args = sum(1 << i for i, arg in enumerate(args) if arg['type'] == 'float')
+        prefix = f"TEXT_VIEW(STATUS_PREFIX_{entry['status']}),"
+        lines.append(f"    {{ {prefix:<31} {c_string(entry['text'])}, {len(args)}, 0x{float_args:x} }},  // {enum_name(name)}")
+    lines += [
+        '};',
+        '',
+        'const StatusEventFormat* status_event_format(uint8_t id) {',
+        '    return &STATUS_EVENT_TABLE[(id < STATUS_EVENT_COUNT) ? id : STATUS_EVENT_NONE];',
+        '}',
+        '',
+    ]
+    return '\n'.join(lines)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Generate the status event IDs and format table.')
+    parser.add_argument('--definition', type=Path, default=DEFINITION_DIR / 'status_events.json')
+    parser.add_argument('--header', type=Path, default=REPO_DIR / 'inc' / 'status_event_ids.h')
+    parser.add_argument('--source', type=Path, default=REPO_DIR / 'src' / 'status_event_ids.cpp')
+    parser.add_argument('--check', action='store_true', help='only report whether the outputs are up to date')
+    options = parser.parse_args()
+
+    try:
+        events = load_catalog(options.definition)
+    except ValueError as error:
+        print(f"status_events.json: {error}", file=sys.stderr)
+        return 1
+    stamp = datetime.datetime.now().strftime('%Y-%m-%d %H:%M:%S')
+    outputs = ((options.header, generate_header(events, stamp)), (options.source, generate_source(events, stamp)))
+
+    stale = []
+    for path, text in outputs:
+        old = path.read_text(encoding='utf-8') if path.exists() else ''
+        # The timestamp line alone does not make an output stale
+        if re.sub(r'Generated from .* on .*', '', old) == re.sub(r'Generated from .* on .*', '', text):
+            continue
+        stale.append(path)
+        if not options.check:
+            path.write_text(text, encoding='utf-8', newline='\n')
+    if options.check:
+        for path in stale:
+            print(f"{path} is out of date; run generate_status_events.py", file=sys.stderr)
+        return 1 if stale else 0
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -2,6 +2,8 @@ import tkinter as tk
 from tkinter import ttk
 import sys
 import os
+import math
+from collections import deque
 
 # Adjust path for standalone execution
 if __name__ == "__main__":
@@ -12,9 +14,16 @@ if __name__ == "__main__":
 
 from src import theme
 
+try:
+    from .telemetry_decoder import TelemetryDecoder
+except ImportError:
+    # Loaded by path from the device definition folder
+    sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+    from telemetry_decoder import TelemetryDecoder
+
 # --- GUI Helper Functions ---
 
-def draw_vertical_text(canvas, x, y, text, font, fill, anchor="center"):
+def draw_vertical_text(canvas, x, y, text, font, fill, anchor="center", tags=None):
     """Draw text vertically without using the angle parameter (for compatibility with older Tk)."""
     # Estimate character height based on font
     # Try to extract font size from font tuple or use default
@@ -34,7 +43,17 @@ def draw_vertical_text(canvas, x, y, text, font, fill, anchor="center"):
     # Draw each character vertically
     for i, char in enumerate(text):
         char_y = start_y + (i * char_height)
-        canvas.create_text(x, char_y, text=char, font=font, fill=fill, anchor="center")
+        canvas.create_text(x, char_y, text=char, font=font, fill=fill, anchor="center", tags=tags)
+
+def telemetry_number(decoder, key, var):
+    """Latest decoded value of a numeric field; parses the display variable only if the host has not fed the decoder."""
+    value = decoder.get(key)
+    if value is not None:
+        return value
+    text = var.get()
+    if text in ('---', ''):
+        return None
+    return float(str(text).split()[0])
 
 def make_homed_tracer(var, label_to_color):
     """Changes a label's color based on 'homed' status."""
@@ -116,13 +135,16 @@ def make_unit_stripper(source_var, dest_var, unit_to_strip):
         dest_var.set(value)
     return tracer
 
-def create_torque_widget(parent, torque_dv, height):
-    """Creates a vertical torque meter widget."""
+def create_torque_widget(parent, torque_dv, height, traces=None):
+    """Creates a vertical torque meter widget (its tracer held by traces, if given)."""
     torque_frame = ttk.Frame(parent, height=height, width=40, style='TFrame')
     torque_frame.pack_propagate(False)
     torque_sv = tk.StringVar()
     torque_frame.tracer = make_torque_tracer(torque_dv, torque_sv)
-    torque_dv.trace_add('write', torque_frame.tracer)
+    if traces is not None:
+        traces.trace(torque_dv, torque_frame.tracer)
+    else:
+        torque_dv.trace_add('write', torque_frame.tracer)
     pbar = ttk.Progressbar(torque_frame, variable=torque_dv, maximum=100, orient=tk.VERTICAL, style='Card.Vertical.TProgressbar')
     pbar.pack(fill=tk.BOTH, expand=True)
     label = ttk.Label(torque_frame, textvariable=torque_sv, font=theme.FONT_SMALL, anchor='center', style='Subtle.TLabel')
@@ -130,6 +152,117 @@ def create_torque_widget(parent, torque_dv, height):
     torque_frame.tracer()
     return torque_frame
 
+class VisibleTraces:
+    """
+    Variable traces and telemetry listeners of one panel, attached only while it is on screen.
+    
+    Tk sends <Unmap> only to the window actually unmapped (a notebook page, a packed frame),
+    not to the windows inside it, so the windows passed to watch() are watched as well and
+    the panel's winfo_viewable() decides. When the panel is shown every callback runs once
+    to catch up with the writes it missed while hidden.
+    """
+    
+    def __init__(self, panel, telemetry=None):
+        self.panel = panel
+        self.telemetry = telemetry
+        self.traces = []        # [variable, callback, trace id while attached]
+        self.listeners = []
+        self.show_callbacks = []
+        self.builder = None     # Builds the panel's content on its first showing
+        self.attached = False
+        self.pending = None     # after_idle id of a queued visibility check
+        panel.bind('<Map>', self.schedule, add='+')
+        panel.bind('<Visibility>', self.schedule, add='+')
+        panel.bind('<Unmap>', self.schedule, add='+')
+        panel.bind('<Destroy>', self.on_destroy, add='+')
+    
+    def watch(self, *widgets):
+        """Checks visibility whenever one of these (an ancestor of the panel) is shown or hidden."""
+        for widget in widgets:
+            widget.bind('<Map>', self.schedule, add='+')
+            widget.bind('<Unmap>', self.schedule, add='+')
+    
+    def build(self, builder):
+        """Calls builder() the first time the panel is on screen (now, if it already is)."""
+        self.builder = builder
+        self.schedule()
+    
+    def trace(self, var, callback):
+        entry = [var, callback, None]
+        self.traces.append(entry)
+        if self.attached:
+            entry[2] = var.trace_add('write', callback)
+    
+    def listen(self, callback):
+        self.listeners.append(callback)
+        if self.attached and self.telemetry is not None:
+            self.telemetry.add_listener(callback)
+    
+    def on_show(self, callback):
+        self.show_callbacks.append(callback)
+    
+    def schedule(self, event=None):
+        if self.pending is None:
+            try:
+                self.pending = self.panel.after_idle(self.update)
+            except tk.TclError:
+                pass
+    
+    def update(self):
+        self.pending = None
+        try:
+            visible = bool(self.panel.winfo_viewable())
+        except tk.TclError:
+            return
+        if visible and not self.attached:
+            if self.builder is not None:
+                builder, self.builder = self.builder, None
+                builder()
+            self.attach()
+        elif not visible and self.attached:
+            self.detach()
+    
+    def attach(self):
+        self.attached = True
+        callbacks = []
+        for entry in self.traces:
+            entry[2] = entry[0].trace_add('write', entry[1])
+            if entry[1] not in callbacks:
+                callbacks.append(entry[1])
+        if self.telemetry is not None:
+            for listener in self.listeners:
+                self.telemetry.add_listener(listener)
+        for callback in callbacks + self.show_callbacks:
+            try:
+                callback()
+            except tk.TclError:
+                pass
+    
+    def detach(self):
+        self.attached = False
+        for entry in self.traces:
+            if entry[2] is not None:
+                try:
+                    entry[0].trace_remove('write', entry[2])
+                except tk.TclError:
+                    pass
+                entry[2] = None
+        if self.telemetry is not None:
+            for listener in self.listeners:
+                self.telemetry.remove_listener(listener)
+    
+    def on_destroy(self, event):
+        if event.widget is self.panel:
+            if self.pending is not None:
+                try:
+                    self.panel.after_cancel(self.pending)
+                except tk.TclError:
+                    pass
+                self.pending = None
+            # The shared variables and decoder outlive the panel
+            self.detach()
+            self.builder = None
+
 def create_device_frame(parent, title, state_var, conn_var):
     """Creates the main bordered frame for a device panel."""
     outer_container = ttk.Frame(parent, style='CardBorder.TFrame', padding=1)
@@ -182,7 +315,7 @@ def get_required_variables():
 # --- Main GUI Creation Function ---
 
 def create_gui_components(parent, shared_gui_refs):
-    """Creates the PressBoi status panel with improved layout."""
+    """Creates the PressBoi status panel; its body is built the first time it is displayed."""
     
     # Initialize all required tkinter variables
     for var_name in get_required_variables():
@@ -192,6 +325,10 @@ def create_gui_components(parent, shared_gui_refs):
             else:
                 shared_gui_refs.setdefault(var_name, tk.StringVar(value='---'))
     
+    # Typed telemetry: the host feeds received lines to the decoder and publishes it to the
+    # variables above; handlers read numbers from it instead of parsing the display text
+    telemetry = shared_gui_refs.setdefault('pressboi_telemetry', TelemetryDecoder())
+    
     # Setup tracer to combine enabled states
     def update_enabled_combined(*args):
         try:
@@ -284,397 +421,449 @@ def create_gui_components(parent, shared_gui_refs):
             pressboi_conn_tracer()
         parent.after(100, delayed_update)
     
-    # === Single Container for ALL data ===
-    data_container = ttk.Frame(content_frame, style='Card.TFrame', padding=10)
-    data_container.pack(fill='both', expand=True, pady=(10, 5))
-    
-    # Torque bar on right side - height will match content
-    torque_widget = create_torque_widget(data_container, shared_gui_refs['pressboi_torque_avg_var'], 120)
-    torque_widget.pack(side=tk.RIGHT, padx=(20, 0))
-    
-    # Left side - all text data (no extra frame needed)
-    left_side = ttk.Frame(data_container, style='Card.TFrame')
-    left_side.pack(side=tk.LEFT, fill='both', expand=True)
-    
-    # Force row at top
-    force_row = ttk.Frame(left_side, style='Card.TFrame')
-    force_row.pack(fill='x', pady=(0, 3))
-    
-    ttk.Label(force_row, text="Force:", font=font_medium, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
-    force_value_label = ttk.Label(force_row, textvariable=shared_gui_refs['pressboi_force_var'], 
-                                   font=font_large, foreground=theme.PRIMARY_ACCENT, style='Subtle.TLabel', anchor='e')
-    force_value_label.pack(side=tk.LEFT)
-    
-    ttk.Label(force_row, text=" / ", font=font_medium, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel').pack(side=tk.LEFT)
-    ttk.Label(force_row, textvariable=shared_gui_refs['pressboi_force_limit_var'], 
-              font=font_medium, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
-    
-    # Force source indicator on new line
-    force_source_row = ttk.Frame(left_side, style='Card.TFrame')
-    force_source_row.pack(fill='x', pady=(0, 5))
+    # The body (values, torque bar, graph) is built the first time the panel is on screen,
+    # and its traces are attached only while it is
+    traces = VisibleTraces(content_frame, telemetry)
+    traces.watch(parent, outer_container)
     
-    force_source_label = ttk.Label(force_source_row, text="", font=font_small, 
-                                    foreground=theme.COMMENT_COLOR, style='Subtle.TLabel')
-    force_source_label.pack(side=tk.LEFT)
-    
-    def update_force_source(*args):
-        try:
-            source = shared_gui_refs['pressboi_force_source_var'].get()
-            if source == "load_cell":
-                force_source_label.config(text="[Load Cell]", foreground=theme.SUCCESS_GREEN)
-            elif source == "motor_torque":
-                force_source_label.config(text="[Motor Torque]", foreground=theme.WARNING_YELLOW)
-            else:
-                # Default to showing waiting for data
-                force_source_label.config(text="[---]", foreground=theme.COMMENT_COLOR)
-        except tk.TclError:
-            # Widget destroyed; ignore
-            pass
-        except Exception:
-            # Other error; try to update label
+    def build_body():
+        # === Single Container for ALL data ===
+        data_container = ttk.Frame(content_frame, style='Card.TFrame', padding=10)
+        data_container.pack(fill='both', expand=True, pady=(10, 5))
+        
+        # Torque bar on right side - height will match content
+        torque_widget = create_torque_widget(data_container, shared_gui_refs['pressboi_torque_avg_var'], 120, traces)
+        torque_widget.pack(side=tk.RIGHT, padx=(20, 0))
+        
+        # Left side - all text data (no extra frame needed)
+        left_side = ttk.Frame(data_container, style='Card.TFrame')
+        left_side.pack(side=tk.LEFT, fill='both', expand=True)
+        
+        # Force row at top
+        force_row = ttk.Frame(left_side, style='Card.TFrame')
+        force_row.pack(fill='x', pady=(0, 3))
+        
+        ttk.Label(force_row, text="Force:", font=font_medium, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
+        force_value_label = ttk.Label(force_row, textvariable=shared_gui_refs['pressboi_force_var'], 
+                                       font=font_large, foreground=theme.PRIMARY_ACCENT, style='Subtle.TLabel', anchor='e')
+        force_value_label.pack(side=tk.LEFT)
+        
+        ttk.Label(force_row, text=" / ", font=font_medium, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel').pack(side=tk.LEFT)
+        ttk.Label(force_row, textvariable=shared_gui_refs['pressboi_force_limit_var'], 
+                  font=font_medium, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
+        
+        # Force source indicator on new line
+        force_source_row = ttk.Frame(left_side, style='Card.TFrame')
+        force_source_row.pack(fill='x', pady=(0, 5))
+        
+        force_source_label = ttk.Label(force_source_row, text="", font=font_small, 
+                                        foreground=theme.COMMENT_COLOR, style='Subtle.TLabel')
+        force_source_label.pack(side=tk.LEFT)
+        
+        def update_force_source(*args):
             try:
-                force_source_label.config(text="[---]", foreground=theme.COMMENT_COLOR)
+                source = shared_gui_refs['pressboi_force_source_var'].get()
+                if source == "load_cell":
+                    force_source_label.config(text="[Load Cell]", foreground=theme.SUCCESS_GREEN)
+                elif source == "motor_torque":
+                    force_source_label.config(text="[Motor Torque]", foreground=theme.WARNING_YELLOW)
+                else:
+                    # Default to showing waiting for data
+                    force_source_label.config(text="[---]", foreground=theme.COMMENT_COLOR)
             except tk.TclError:
+                # Widget destroyed; ignore
                 pass
-    
-    shared_gui_refs['pressboi_force_source_var'].trace_add('write', update_force_source)
-    update_force_source()
-    
-    # Add force color tracer
-    force_tracer = make_force_tracer(shared_gui_refs['pressboi_force_var'], force_value_label)
-    shared_gui_refs['pressboi_force_var'].trace_add('write', force_tracer)
-    force_tracer()
-    
-    # Position info below force
-    pos_grid = ttk.Frame(left_side, style='Card.TFrame')
-    pos_grid.pack(fill='x')
-    pos_grid.grid_columnconfigure(1, weight=1)
-    
-    # Current and Target Position (inline, same size as force)
-    pos_row = ttk.Frame(pos_grid, style='Card.TFrame')
-    pos_row.grid(row=0, column=0, columnspan=4, sticky='w', pady=(0, 2))
-    
-    pos_label = ttk.Label(pos_row, text="Position:", font=font_medium, style='Subtle.TLabel')
-    pos_label.pack(side=tk.LEFT, padx=(0, 10))
-    
-    # Create display variables that strip " mm" from positions
-    current_pos_display = tk.StringVar(value='0.00')
-    current_stripper = make_unit_stripper(shared_gui_refs['pressboi_current_pos_var'], current_pos_display, ' mm')
-    shared_gui_refs['pressboi_current_pos_var'].trace_add('write', current_stripper)
-    current_stripper()
-    
-    current_pos_label = ttk.Label(pos_row, textvariable=current_pos_display, 
-                                   font=font_large, foreground=theme.SUCCESS_GREEN, style='Subtle.TLabel', anchor='e')
-    current_pos_label.pack(side=tk.LEFT)
-    
-    arrow_label = ttk.Label(pos_row, text=" → ", font=font_medium, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel')
-    arrow_label.pack(side=tk.LEFT)
-    
-    target_pos_display = tk.StringVar(value='0.00')
-    target_stripper = make_unit_stripper(shared_gui_refs['pressboi_target_pos_var'], target_pos_display, ' mm')
-    shared_gui_refs['pressboi_target_pos_var'].trace_add('write', target_stripper)
-    target_stripper()
-    
-    target_pos_label = ttk.Label(pos_row, textvariable=target_pos_display, 
-                                  font=font_large, foreground=theme.WARNING_YELLOW, style='Subtle.TLabel', anchor='e')
-    target_pos_label.pack(side=tk.LEFT)
-    
-    # Tracer to color position and target based on state
-    def position_color_tracer(*args):
-        try:
-            homed_state = shared_gui_refs['pressboi_homed_var'].get()
-            main_state = shared_gui_refs['pressboi_main_state_var'].get().upper()
-            
-            # If not homed, everything is red
-            if homed_state != 'homed':
-                pos_label.config(foreground=theme.ERROR_RED)
-                current_pos_label.config(foreground=theme.ERROR_RED)
-                target_pos_label.config(foreground=theme.ERROR_RED)
-                return
-            
-            # Parse current and target positions
-            current_str = current_pos_display.get()
-            target_str = target_pos_display.get()
-            current_pos = float(current_str) if current_str not in ['---', ''] else 0.0
-            target_pos = float(target_str) if target_str not in ['---', ''] else 0.0
-            
-            # Check if at target (within 0.5mm tolerance)
-            at_target = abs(current_pos - target_pos) < 0.5
-            
-            # Check if moving
-            is_moving = 'MOVING' in main_state or 'HOMING' in main_state
-            
-            # Color logic
-            pos_label.config(foreground=theme.FG_COLOR)
-            
-            if is_moving:
-                # While moving: current is blue, target is yellow
-                current_pos_label.config(foreground=theme.BUSY_BLUE)
-                target_pos_label.config(foreground=theme.WARNING_YELLOW)
-            elif at_target:
-                # At target: both are green
-                current_pos_label.config(foreground=theme.SUCCESS_GREEN)
-                target_pos_label.config(foreground=theme.SUCCESS_GREEN)
-            else:
-                # Not moving, not at target: current green, target yellow
-                current_pos_label.config(foreground=theme.SUCCESS_GREEN)
-                target_pos_label.config(foreground=theme.WARNING_YELLOW)
-        except:
-            pass
-    
-    # Attach tracer to all relevant variables
-    shared_gui_refs['pressboi_homed_var'].trace_add('write', position_color_tracer)
-    shared_gui_refs['pressboi_main_state_var'].trace_add('write', position_color_tracer)
-    shared_gui_refs['pressboi_current_pos_var'].trace_add('write', position_color_tracer)
-    shared_gui_refs['pressboi_target_pos_var'].trace_add('write', position_color_tracer)
-    position_color_tracer()
-    
-    # Retract Position
-    retract_row = ttk.Frame(pos_grid, style='Card.TFrame')
-    retract_row.grid(row=1, column=0, columnspan=4, sticky='w', pady=(0, 2))
-    
-    ttk.Label(retract_row, text="Retract Position:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
-    
-    # Create display variable that strips " mm" from retract position
-    retract_pos_display = tk.StringVar(value='0.00')
-    retract_stripper = make_unit_stripper(shared_gui_refs['pressboi_retract_pos_var'], retract_pos_display, ' mm')
-    shared_gui_refs['pressboi_retract_pos_var'].trace_add('write', retract_stripper)
-    retract_stripper()
-    
-    ttk.Label(retract_row, textvariable=retract_pos_display, 
-              font=font_small, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
-    
-    # Homed and Enabled Status (inline, no "Homed:" label)
-    status_row = ttk.Frame(pos_grid, style='Card.TFrame')
-    status_row.grid(row=2, column=0, columnspan=4, sticky='w', pady=(3, 2))
-    
-    homed_value_label = ttk.Label(status_row, textvariable=shared_gui_refs['pressboi_homed_var'], 
-                                   font=font_small, style='Subtle.TLabel')
-    homed_value_label.pack(side=tk.LEFT, padx=(0, 20))
-    homed_tracer = make_homed_tracer(shared_gui_refs['pressboi_homed_var'], homed_value_label)
-    shared_gui_refs['pressboi_homed_var'].trace_add('write', homed_tracer)
-    homed_tracer()
-    
-    # Joules display (energy expended during move)
-    joules_row = ttk.Frame(pos_grid, style='Card.TFrame')
-    joules_row.grid(row=3, column=0, columnspan=4, sticky='w', pady=(0, 2))
-    
-    ttk.Label(joules_row, text="Energy:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
-    
-    # Create display variable that strips " J" from joules
-    joules_display = tk.StringVar(value='0.000')
-    joules_stripper = make_unit_stripper(shared_gui_refs['pressboi_joules_var'], joules_display, ' J')
-    shared_gui_refs['pressboi_joules_var'].trace_add('write', joules_stripper)
-    joules_stripper()
-    
-    ttk.Label(joules_row, textvariable=joules_display, 
-              font=font_small, foreground=theme.PRIMARY_ACCENT, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
-    ttk.Label(joules_row, text=" J", font=font_small, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel').pack(side=tk.LEFT)
-    
-    # Endpoint display (position where last move ended)
-    endpoint_row = ttk.Frame(pos_grid, style='Card.TFrame')
-    endpoint_row.grid(row=4, column=0, columnspan=4, sticky='w', pady=(0, 2))
-    
-    ttk.Label(endpoint_row, text="Endpoint:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
-    
-    # Create display variable that strips " mm" from endpoint
-    endpoint_display = tk.StringVar(value='0.00')
-    endpoint_stripper = make_unit_stripper(shared_gui_refs['pressboi_endpoint_var'], endpoint_display, ' mm')
-    shared_gui_refs['pressboi_endpoint_var'].trace_add('write', endpoint_stripper)
-    endpoint_stripper()
-    
-    ttk.Label(endpoint_row, textvariable=endpoint_display, 
-              font=font_small, foreground=theme.PRIMARY_ACCENT, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
-    ttk.Label(endpoint_row, text=" mm", font=font_small, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel').pack(side=tk.LEFT)
-    
-    ttk.Label(status_row, text="Motors:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 5))
-    enabled_value_label = ttk.Label(status_row, textvariable=shared_gui_refs['pressboi_enabled_combined_var'], 
-                                     font=font_small, style='Subtle.TLabel')
-    enabled_value_label.pack(side=tk.LEFT)
-    enabled_tracer = make_state_tracer(shared_gui_refs['pressboi_enabled_combined_var'], enabled_value_label)
-    shared_gui_refs['pressboi_enabled_combined_var'].trace_add('write', enabled_tracer)
-    enabled_tracer()
-    
-    # === Force vs Position Graph ===
-    graph_container = ttk.Frame(content_frame, style='Card.TFrame', padding=10)
-    graph_container.pack(fill='both', expand=True, pady=(10, 0))
-    
-    # Graph title
-    ttk.Label(graph_container, text="Force vs Position", 
-              font=font_medium, foreground=theme.PRIMARY_ACCENT, 
-              style='Subtle.TLabel').pack(anchor='w', pady=(0, 5))
-    
-    # Create canvas for graph (smaller default width)
-    graph_canvas = tk.Canvas(graph_container, 
-                            width=300, height=180,
-                            bg=theme.WIDGET_BG,
-                            highlightthickness=1,
-                            highlightbackground=theme.COMMENT_COLOR)
-    graph_canvas.pack(fill='both', expand=True)
-    
-    # Store graph data (position, force) tuples
-    graph_data = []
-    max_points = 500  # Keep last 500 points
-    
-    def update_graph(*args):
-        """Updates the force vs position graph when position or force changes."""
-        try:
-            # Get current values
-            pos_str = shared_gui_refs['pressboi_current_pos_var'].get()
-            force_str = shared_gui_refs['pressboi_force_var'].get()
-            
-            # Parse values
-            pos = float(pos_str.split()[0]) if pos_str != '---' else None
-            force = float(force_str.split()[0]) if force_str != '---' else None
-            
-            if pos is not None and force is not None:
-                # Add new data point
-                graph_data.append((pos, force))
+            except Exception:
+                # Other error; try to update label
+                try:
+                    force_source_label.config(text="[---]", foreground=theme.COMMENT_COLOR)
+                except tk.TclError:
+                    pass
+        
+        traces.trace(shared_gui_refs['pressboi_force_source_var'], update_force_source)
+        
+        # Add force color tracer
+        force_tracer = make_force_tracer(shared_gui_refs['pressboi_force_var'], force_value_label)
+        traces.trace(shared_gui_refs['pressboi_force_var'], force_tracer)
+        
+        # Position info below force
+        pos_grid = ttk.Frame(left_side, style='Card.TFrame')
+        pos_grid.pack(fill='x')
+        pos_grid.grid_columnconfigure(1, weight=1)
+        
+        # Current and Target Position (inline, same size as force)
+        pos_row = ttk.Frame(pos_grid, style='Card.TFrame')
+        pos_row.grid(row=0, column=0, columnspan=4, sticky='w', pady=(0, 2))
+        
+        pos_label = ttk.Label(pos_row, text="Position:", font=font_medium, style='Subtle.TLabel')
+        pos_label.pack(side=tk.LEFT, padx=(0, 10))
+        
+        # Create display variables that strip " mm" from positions
+        current_pos_display = tk.StringVar(value='0.00')
+        current_stripper = make_unit_stripper(shared_gui_refs['pressboi_current_pos_var'], current_pos_display, ' mm')
+        traces.trace(shared_gui_refs['pressboi_current_pos_var'], current_stripper)
+        
+        current_pos_label = ttk.Label(pos_row, textvariable=current_pos_display, 
+                                       font=font_large, foreground=theme.SUCCESS_GREEN, style='Subtle.TLabel', anchor='e')
+        current_pos_label.pack(side=tk.LEFT)
+        
+        arrow_label = ttk.Label(pos_row, text=" → ", font=font_medium, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel')
+        arrow_label.pack(side=tk.LEFT)
+        
+        target_pos_display = tk.StringVar(value='0.00')
+        target_stripper = make_unit_stripper(shared_gui_refs['pressboi_target_pos_var'], target_pos_display, ' mm')
+        traces.trace(shared_gui_refs['pressboi_target_pos_var'], target_stripper)
+        
+        target_pos_label = ttk.Label(pos_row, textvariable=target_pos_display, 
+                                      font=font_large, foreground=theme.WARNING_YELLOW, style='Subtle.TLabel', anchor='e')
+        target_pos_label.pack(side=tk.LEFT)
+        
+        # Tracer to color position and target based on state
+        def position_color_tracer(*args):
+            try:
+                homed_state = shared_gui_refs['pressboi_homed_var'].get()
+                main_state = shared_gui_refs['pressboi_main_state_var'].get().upper()
                 
-                # Keep only last N points
-                if len(graph_data) > max_points:
-                    graph_data.pop(0)
+                # If not homed, everything is red
+                if homed_state != 'homed':
+                    pos_label.config(foreground=theme.ERROR_RED)
+                    current_pos_label.config(foreground=theme.ERROR_RED)
+                    target_pos_label.config(foreground=theme.ERROR_RED)
+                    return
                 
-                # Redraw graph
-                draw_graph()
-        except (ValueError, IndexError, AttributeError, tk.TclError):
-            # Invalid data or widget destroyed; skip update
-            pass
-    
-    def draw_graph():
-        """Draws the force vs position graph on the canvas."""
-        try:
-            graph_canvas.delete("all")
-            
-            if len(graph_data) < 2:
-                # Not enough data to draw
-                graph_canvas.create_text(200, 100, 
-                                        text="Waiting for data...",
-                                        fill=theme.COMMENT_COLOR,
-                                        font=font_small)
+                # Current and target positions
+                current_pos = telemetry_number(telemetry, 'current_pos', current_pos_display)
+                target_pos = telemetry_number(telemetry, 'target_pos', target_pos_display)
+                current_pos = current_pos if current_pos is not None else 0.0
+                target_pos = target_pos if target_pos is not None else 0.0
+                
+                # Check if at target (within 0.5mm tolerance)
+                at_target = abs(current_pos - target_pos) < 0.5
+                
+                # Check if moving
+                is_moving = 'MOVING' in main_state or 'HOMING' in main_state
+                
+                # Color logic
+                pos_label.config(foreground=theme.FG_COLOR)
+                
+                if is_moving:
+                    # While moving: current is blue, target is yellow
+                    current_pos_label.config(foreground=theme.BUSY_BLUE)
+                    target_pos_label.config(foreground=theme.WARNING_YELLOW)
+                elif at_target:
+                    # At target: both are green
+                    current_pos_label.config(foreground=theme.SUCCESS_GREEN)
+                    target_pos_label.config(foreground=theme.SUCCESS_GREEN)
+                else:
+                    # Not moving, not at target: current green, target yellow
+                    current_pos_label.config(foreground=theme.SUCCESS_GREEN)
+                    target_pos_label.config(foreground=theme.WARNING_YELLOW)
+            except:
+                pass
+        
+        # Attach tracer to all relevant variables
+        traces.trace(shared_gui_refs['pressboi_homed_var'], position_color_tracer)
+        traces.trace(shared_gui_refs['pressboi_main_state_var'], position_color_tracer)
+        traces.trace(shared_gui_refs['pressboi_current_pos_var'], position_color_tracer)
+        traces.trace(shared_gui_refs['pressboi_target_pos_var'], position_color_tracer)
+        
+        # Retract Position
+        retract_row = ttk.Frame(pos_grid, style='Card.TFrame')
+        retract_row.grid(row=1, column=0, columnspan=4, sticky='w', pady=(0, 2))
+        
+        ttk.Label(retract_row, text="Retract Position:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
+        
+        # Create display variable that strips " mm" from retract position
+        retract_pos_display = tk.StringVar(value='0.00')
+        retract_stripper = make_unit_stripper(shared_gui_refs['pressboi_retract_pos_var'], retract_pos_display, ' mm')
+        traces.trace(shared_gui_refs['pressboi_retract_pos_var'], retract_stripper)
+        
+        ttk.Label(retract_row, textvariable=retract_pos_display, 
+                  font=font_small, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
+        
+        # Homed and Enabled Status (inline, no "Homed:" label)
+        status_row = ttk.Frame(pos_grid, style='Card.TFrame')
+        status_row.grid(row=2, column=0, columnspan=4, sticky='w', pady=(3, 2))
+        
+        homed_value_label = ttk.Label(status_row, textvariable=shared_gui_refs['pressboi_homed_var'], 
+                                       font=font_small, style='Subtle.TLabel')
+        homed_value_label.pack(side=tk.LEFT, padx=(0, 20))
+        homed_tracer = make_homed_tracer(shared_gui_refs['pressboi_homed_var'], homed_value_label)
+        traces.trace(shared_gui_refs['pressboi_homed_var'], homed_tracer)
+        
+        # Joules display (energy expended during move)
+        joules_row = ttk.Frame(pos_grid, style='Card.TFrame')
+        joules_row.grid(row=3, column=0, columnspan=4, sticky='w', pady=(0, 2))
+        
+        ttk.Label(joules_row, text="Energy:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
+        
+        # Create display variable that strips " J" from joules
+        joules_display = tk.StringVar(value='0.000')
+        joules_stripper = make_unit_stripper(shared_gui_refs['pressboi_joules_var'], joules_display, ' J')
+        traces.trace(shared_gui_refs['pressboi_joules_var'], joules_stripper)
+        
+        ttk.Label(joules_row, textvariable=joules_display, 
+                  font=font_small, foreground=theme.PRIMARY_ACCENT, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
+        ttk.Label(joules_row, text=" J", font=font_small, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel').pack(side=tk.LEFT)
+        
+        # Endpoint display (position where last move ended)
+        endpoint_row = ttk.Frame(pos_grid, style='Card.TFrame')
+        endpoint_row.grid(row=4, column=0, columnspan=4, sticky='w', pady=(0, 2))
+        
+        ttk.Label(endpoint_row, text="Endpoint:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 10))
+        
+        # Create display variable that strips " mm" from endpoint
+        endpoint_display = tk.StringVar(value='0.00')
+        endpoint_stripper = make_unit_stripper(shared_gui_refs['pressboi_endpoint_var'], endpoint_display, ' mm')
+        traces.trace(shared_gui_refs['pressboi_endpoint_var'], endpoint_stripper)
+        
+        ttk.Label(endpoint_row, textvariable=endpoint_display, 
+                  font=font_small, foreground=theme.PRIMARY_ACCENT, style='Subtle.TLabel', anchor='e').pack(side=tk.LEFT)
+        ttk.Label(endpoint_row, text=" mm", font=font_small, foreground=theme.COMMENT_COLOR, style='Subtle.TLabel').pack(side=tk.LEFT)
+        
+        ttk.Label(status_row, text="Motors:", font=font_small, style='Subtle.TLabel').pack(side=tk.LEFT, padx=(0, 5))
+        enabled_value_label = ttk.Label(status_row, textvariable=shared_gui_refs['pressboi_enabled_combined_var'], 
+                                         font=font_small, style='Subtle.TLabel')
+        enabled_value_label.pack(side=tk.LEFT)
+        enabled_tracer = make_state_tracer(shared_gui_refs['pressboi_enabled_combined_var'], enabled_value_label)
+        traces.trace(shared_gui_refs['pressboi_enabled_combined_var'], enabled_tracer)
+        
+        # === Force vs Position Graph ===
+        graph_container = ttk.Frame(content_frame, style='Card.TFrame', padding=10)
+        graph_container.pack(fill='both', expand=True, pady=(10, 0))
+        
+        # Graph title
+        ttk.Label(graph_container, text="Force vs Position", 
+                  font=font_medium, foreground=theme.PRIMARY_ACCENT, 
+                  style='Subtle.TLabel').pack(anchor='w', pady=(0, 5))
+        
+        # Create canvas for graph (smaller default width)
+        graph_canvas = tk.Canvas(graph_container, 
+                                width=300, height=180,
+                                bg=theme.WIDGET_BG,
+                                highlightthickness=1,
+                                highlightbackground=theme.COMMENT_COLOR)
+        graph_canvas.pack(fill='both', expand=True)
+        
+        # Store graph data (position, force) tuples; the deque drops the oldest point itself
+        max_points = 500  # Keep last 500 points
+        graph_data = deque(maxlen=max_points)
+        
+        # Margins
+        margin_left = 50
+        margin_right = 20
+        margin_top = 20
+        margin_bottom = 40
+        
+        # Canvas items are created once and moved with coords(); the axes are redrawn only
+        # when the plotted range or the canvas size changes
+        graph_state = {
+            'pending': False,   # A redraw is already queued with after_idle
+            'layout': None,     # (width, height, pos bounds, force bounds) the axes were drawn for
+        }
+        waiting_text = graph_canvas.create_text(200, 100,
+                                                text="Waiting for data...",
+                                                fill=theme.COMMENT_COLOR,
+                                                font=font_small)
+        curve_line = graph_canvas.create_line(0, 0, 0, 0,
+                                              fill=theme.PRIMARY_ACCENT,
+                                              width=2, state='hidden')
+        latest_marker = graph_canvas.create_oval(0, 0, 0, 0,
+                                                 fill=theme.SUCCESS_GREEN,
+                                                 outline=theme.SUCCESS_GREEN,
+                                                 state='hidden')
+        
+        def nice_bounds(lo, hi):
+            """Rounds a data range outward to four 1-2-5 tick steps so small changes keep the axes."""
+            span = hi - lo
+            if span <= 0:
+                span = 1
+            # 10% padding, as before, then the smallest round step whose four intervals cover it
+            low_target = lo - span * 0.1
+            high_target = hi + span * 0.1
+            magnitude = 10 ** math.floor(math.log10((high_target - low_target) / 4))
+            for mult in (1, 2, 5, 10, 20, 50):
+                step = mult * magnitude
+                low = math.floor(low_target / step) * step
+                high = low + step * 4
+                if high >= high_target:
+                    break
+            return low, high, step
+        
+        def add_graph_point(pos, force):
+            if pos is not None and force is not None:
+                graph_data.append((pos, force))
+                schedule_draw()
+        
+        def on_telemetry_frame(frame):
+            """Adds one point per decoded frame that moved the position or changed the force."""
+            if ('current_pos' in frame or 'force_load_cell' in frame or
+                    'force_motor_torque' in frame or 'force_source' in frame):
+                add_graph_point(telemetry.get('current_pos'), telemetry.force())
+        
+        def update_graph(*args):
+            """Fallback for hosts that only set the display variables: parses their text."""
+            if telemetry.frames:
                 return
-            
-            # Get canvas dimensions
-            width = graph_canvas.winfo_width()
-            height = graph_canvas.winfo_height()
-            
-            # Use actual dimensions if available, otherwise use requested
-            if width <= 1:
-                width = 400
-            if height <= 1:
-                height = 200
-            
-            # Margins
-            margin_left = 50
-            margin_right = 20
-            margin_top = 20
-            margin_bottom = 40
-            
+            try:
+                pos_str = shared_gui_refs['pressboi_current_pos_var'].get()
+                force_str = shared_gui_refs['pressboi_force_var'].get()
+                pos = float(pos_str.split()[0]) if pos_str != '---' else None
+                force = float(force_str.split()[0]) if force_str != '---' else None
+                add_graph_point(pos, force)
+            except (ValueError, IndexError, AttributeError, tk.TclError):
+                # Invalid data or widget destroyed; skip update
+                pass
+        
+        def schedule_draw(*args):
+            """Coalesces every change since the last frame into one redraw when Tk is idle."""
+            if graph_state['pending']:
+                return
+            graph_state['pending'] = True
+            try:
+                graph_canvas.after_idle(draw_graph)
+            except tk.TclError:
+                graph_state['pending'] = False
+        
+        def draw_axes(width, height, pos_bounds, force_bounds):
+            """Redraws the axes, labels and tick values (tagged 'axes')."""
+            graph_canvas.delete('axes')
             plot_width = width - margin_left - margin_right
             plot_height = height - margin_top - margin_bottom
+            min_pos, max_pos, pos_step = pos_bounds
+            min_force, max_force, force_step = force_bounds
             
-            # Find data ranges
-            positions = [p for p, f in graph_data]
-            forces = [f for p, f in graph_data]
-            
-            min_pos = min(positions)
-            max_pos = max(positions)
-            min_force = min(forces)
-            max_force = max(forces)
-            
-            # Add some padding to ranges
-            pos_range = max_pos - min_pos if max_pos != min_pos else 1
-            force_range = max_force - min_force if max_force != min_force else 1
-            
-            min_pos -= pos_range * 0.1
-            max_pos += pos_range * 0.1
-            min_force -= force_range * 0.1
-            max_force += force_range * 0.1
-            
-            # Draw axes
             # Y-axis
             graph_canvas.create_line(margin_left, margin_top,
                                     margin_left, height - margin_bottom,
-                                    fill=theme.COMMENT_COLOR, width=2)
+                                    fill=theme.COMMENT_COLOR, width=2, tags='axes')
             # X-axis
             graph_canvas.create_line(margin_left, height - margin_bottom,
                                     width - margin_right, height - margin_bottom,
-                                    fill=theme.COMMENT_COLOR, width=2)
+                                    fill=theme.COMMENT_COLOR, width=2, tags='axes')
             
             # Draw axis labels
             graph_canvas.create_text(width // 2, height - 10,
                                     text="Position (mm)",
                                     fill=theme.FG_COLOR,
-                                    font=theme.FONT_SMALL)
+                                    font=theme.FONT_SMALL, tags='axes')
             # Use helper function instead of angle parameter for macOS compatibility
             draw_vertical_text(graph_canvas, 15, height // 2,
                               "Force (kg)",
                               theme.FONT_SMALL,
                               theme.FG_COLOR,
-                              anchor="center")
+                              anchor="center",
+                              tags='axes')
             
             # Draw scale labels
+            force_decimals = max(0, -math.floor(math.log10(force_step)))
+            pos_decimals = max(0, -math.floor(math.log10(pos_step)))
             # Y-axis ticks
             for i in range(5):
                 y = margin_top + (plot_height * i / 4)
-                force_val = max_force - (force_range * i / 4)
+                force_val = max_force - ((max_force - min_force) * i / 4)
                 graph_canvas.create_text(margin_left - 5, y,
-                                        text=f"{force_val:.0f}",
+                                        text=f"{force_val:.{force_decimals}f}",
                                         fill=theme.COMMENT_COLOR,
                                         font=theme.FONT_SMALL,
-                                        anchor='e')
+                                        anchor='e', tags='axes')
             
             # X-axis ticks
             for i in range(5):
                 x = margin_left + (plot_width * i / 4)
-                pos_val = min_pos + (pos_range * i / 4)
+                pos_val = min_pos + ((max_pos - min_pos) * i / 4)
                 graph_canvas.create_text(x, height - margin_bottom + 5,
-                                        text=f"{pos_val:.0f}",
+                                        text=f"{pos_val:.{pos_decimals}f}",
                                         fill=theme.COMMENT_COLOR,
                                         font=theme.FONT_SMALL,
-                                        anchor='n')
-            
-            # Plot the data points as a line
-            points = []
-            for pos, force in graph_data:
-                # Scale to canvas coordinates
-                x = margin_left + ((pos - min_pos) / pos_range) * plot_width
-                y = height - margin_bottom - ((force - min_force) / force_range) * plot_height
-                points.append((x, y))
-            
-            # Draw lines connecting points
-            for i in range(len(points) - 1):
-                x1, y1 = points[i]
-                x2, y2 = points[i + 1]
-                graph_canvas.create_line(x1, y1, x2, y2,
-                                        fill=theme.PRIMARY_ACCENT,
-                                        width=2)
-            
-            # Draw points
-            for x, y in points:
-                graph_canvas.create_oval(x-2, y-2, x+2, y+2,
-                                        fill=theme.SUCCESS_GREEN,
-                                        outline=theme.SUCCESS_GREEN)
-        except tk.TclError:
-            # Canvas was likely destroyed; ignore drawing
-            pass
-    
-    # Add button to clear graph data
-    button_frame = ttk.Frame(graph_container, style='Card.TFrame')
-    button_frame.pack(fill='x', pady=(5, 0))
-    
-    def clear_graph():
-        graph_data.clear()
-        draw_graph()
-    
-    ttk.Button(button_frame, text="Clear Graph", 
-              command=clear_graph).pack(side=tk.RIGHT)
-    
-    # Attach tracers to update graph when position or force changes
-    shared_gui_refs['pressboi_current_pos_var'].trace_add('write', update_graph)
-    shared_gui_refs['pressboi_force_var'].trace_add('write', update_graph)
-    
-    # Initial draw
-    graph_canvas.bind('<Configure>', lambda e: draw_graph())
+                                        anchor='n', tags='axes')
+            graph_canvas.tag_raise(curve_line)
+            graph_canvas.tag_raise(latest_marker)
+        
+        def draw_graph():
+            """Moves the curve to the current data; redraws the axes only if the range changed."""
+            graph_state['pending'] = False
+            try:
+                if len(graph_data) < 2:
+                    # Not enough data to draw
+                    graph_canvas.delete('axes')
+                    graph_state['layout'] = None
+                    graph_canvas.itemconfigure(curve_line, state='hidden')
+                    graph_canvas.itemconfigure(latest_marker, state='hidden')
+                    graph_canvas.coords(waiting_text,
+                                        max(graph_canvas.winfo_width(), 400) // 2,
+                                        max(graph_canvas.winfo_height(), 200) // 2)
+                    graph_canvas.itemconfigure(waiting_text, state='normal')
+                    return
+                graph_canvas.itemconfigure(waiting_text, state='hidden')
+                
+                # Get canvas dimensions
+                width = graph_canvas.winfo_width()
+                height = graph_canvas.winfo_height()
+                
+                # Use actual dimensions if available, otherwise use requested
+                if width <= 1:
+                    width = 400
+                if height <= 1:
+                    height = 200
+                
+                plot_width = width - margin_left - margin_right
+                plot_height = height - margin_top - margin_bottom
+                
+                # Find data ranges
+                positions = [p for p, f in graph_data]
+                forces = [f for p, f in graph_data]
+                pos_bounds = nice_bounds(min(positions), max(positions))
+                force_bounds = nice_bounds(min(forces), max(forces))
+                
+                layout = (width, height, pos_bounds, force_bounds)
+                if layout != graph_state['layout']:
+                    draw_axes(width, height, pos_bounds, force_bounds)
+                    graph_state['layout'] = layout
+                
+                # Scale to canvas coordinates and move the one line item
+                min_pos, max_pos, _ = pos_bounds
+                min_force, max_force, _ = force_bounds
+                x_scale = plot_width / (max_pos - min_pos)
+                y_scale = plot_height / (max_force - min_force)
+                x0 = margin_left - min_pos * x_scale
+                y0 = height - margin_bottom + min_force * y_scale
+                coords = []
+                for pos, force in graph_data:
+                    coords.append(x0 + pos * x_scale)
+                    coords.append(y0 - force * y_scale)
+                graph_canvas.coords(curve_line, coords)
+                graph_canvas.itemconfigure(curve_line, state='normal')
+                
+                # Mark the newest point
+                x, y = coords[-2], coords[-1]
+                graph_canvas.coords(latest_marker, x - 3, y - 3, x + 3, y + 3)
+                graph_canvas.itemconfigure(latest_marker, state='normal')
+            except tk.TclError:
+                # Canvas was likely destroyed; ignore drawing
+                pass
+        
+        # Add button to clear graph data
+        button_frame = ttk.Frame(graph_container, style='Card.TFrame')
+        button_frame.pack(fill='x', pady=(5, 0))
+        
+        def clear_graph():
+            graph_data.clear()
+            schedule_draw()
+        
+        ttk.Button(button_frame, text="Clear Graph", 
+                  command=clear_graph).pack(side=tk.RIGHT)
+        
+        # Decoded frames feed the graph; the variable traces cover hosts without the decoder.
+        # Points that arrive while the panel is hidden are not plotted.
+        traces.listen(on_telemetry_frame)
+        traces.trace(shared_gui_refs['pressboi_current_pos_var'], update_graph)
+        traces.trace(shared_gui_refs['pressboi_force_var'], update_graph)
+        
+        # Initial draw; a resize changes the layout, so the axes follow it
+        graph_canvas.bind('<Configure>', schedule_draw)
+        traces.on_show(schedule_draw)
+        
     
+    traces.build(build_body)
     return outer_container
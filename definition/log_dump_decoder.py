@@ -0,0 +1,169 @@
+"""
+Binary Log Dump Decoder
+
+"dump_error_log binary" sends the error log and the heartbeat log as LOGDUMP lines instead
+of one text line per entry. A dump is a few dozen lines, so it is over in a loop pass or
+two rather than the ~3000 lines of the text dump:
+
+    LOGDUMP:pressboi:HEADER:<uptime_ms>:<error_first_seq>:<errors>:<run_first_seq>:<runs>:<heartbeats>
+    LOGDUMP:pressboi:ERR:<first_seq>:<base64>   up to 3 error entries, consecutive from first_seq
+    LOGDUMP:pressboi:HB:<first_seq>:<base64>    up to 20 heartbeat runs, consecutive from first_seq
+
+An error entry is timestamp u32, level u8, length u8 and the message (no NUL); level 0xFF
+means it was overwritten while the dump ran. A heartbeat run is HeartbeatRun in
+inc/error_log.h: first and last timestamp u32, count u16, flags u8, usb_available u8, little
+endian. The dump ends with the usual DONE: dump_error_log.
+
+Typical use in the host's receive path:
+
+    dump = LogDump()
+    ...
+    if dump.feed(line):
+        continue
+    ...
+    # after DONE: dump_error_log
+    print('\\n'.join(dump.text_lines()))
+"""
+
+import base64
+import binascii
+import struct
+from typing import Iterator, List, NamedTuple, Optional
+
+LOGDUMP_PREFIX = 'LOGDUMP:pressboi:'
+
+ERROR_HEADER_STRUCT = struct.Struct('<IBB')
+RUN_STRUCT = struct.Struct('<IIHBB')
+assert RUN_STRUCT.size == 12
+
+LEVEL_OVERWRITTEN = 0xFF
+LEVEL_NAMES = ['DEBUG', 'INFO', 'WARN', 'ERROR', 'CRIT']
+
+HEARTBEAT_FLAG_USB_CONNECTED = 0x01
+HEARTBEAT_FLAG_NETWORK_ACTIVE = 0x02
+
+
+class LogDumpHeader(NamedTuple):
+    uptime_ms: int              # Device Milliseconds() when the dump started
+    error_first_seq: int        # Sequence number of the oldest error entry
+    errors: int                 # Error entries in the dump
+    run_first_seq: int          # Sequence number of the oldest heartbeat run
+    runs: int                   # Heartbeat runs in the dump
+    heartbeats: int             # Heartbeats in those runs
+
+
+class ErrorEntry(NamedTuple):
+    seq: int
+    timestamp_ms: Optional[int]  # None if overwritten while the dump ran
+    level: str                  # DEBUG, INFO, WARN, ERROR, CRIT ('???' if overwritten)
+    message: str
+
+
+class HeartbeatRun(NamedTuple):
+    seq: int
+    first_ms: int
+    last_ms: int
+    count: int
+    usb_connected: bool
+    network_active: bool
+    usb_available: int
+
+
+class Heartbeat(NamedTuple):
+    timestamp_ms: int
+    usb_connected: bool
+    network_active: bool
+    usb_available: int
+
+
+class LogDump:
+    """
+    Collects the LOGDUMP lines of one dump_error_log binary.
+    """
+
+    def __init__(self):
+        self.header: Optional[LogDumpHeader] = None
+        self.errors: List[ErrorEntry] = []
+        self.runs: List[HeartbeatRun] = []
+
+    def feed(self, line: str) -> bool:
+        """
+        Take one received line.
+
+        Returns:
+            True if the line was a LOGDUMP line (well-formed or not), False otherwise
+        """
+        if not line.startswith(LOGDUMP_PREFIX):
+            return False
+        kind, _, rest = line[len(LOGDUMP_PREFIX):].strip().partition(':')
+        try:
+            if kind == 'HEADER':
+                self.header = LogDumpHeader(*(int(field) for field in rest.split(':')))
+                self.errors = []
+                self.runs = []
+            elif kind in ('ERR', 'HB'):
+                first, _, payload = rest.partition(':')
+                data = base64.b64decode(payload, validate=True)
+                if kind == 'ERR':
+                    self._add_errors(int(first), data)
+                else:
+                    self._add_runs(int(first), data)
+        except (binascii.Error, ValueError, TypeError, struct.error):
+            pass
+        return True
+
+    def _add_errors(self, seq: int, data: bytes):
+        offset = 0
+        while offset + ERROR_HEADER_STRUCT.size <= len(data):
+            timestamp, level, length = ERROR_HEADER_STRUCT.unpack_from(data, offset)
+            offset += ERROR_HEADER_STRUCT.size
+            message = data[offset:offset + length].decode('ascii', errors='replace')
+            offset += length
+            if level == LEVEL_OVERWRITTEN:
+                self.errors.append(ErrorEntry(seq, None, '???', '(entry overwritten)'))
+            else:
+                name = LEVEL_NAMES[level] if level < len(LEVEL_NAMES) else '???'
+                self.errors.append(ErrorEntry(seq, timestamp, name, message))
+            seq += 1
+
+    def _add_runs(self, seq: int, data: bytes):
+        for fields in RUN_STRUCT.iter_unpack(data[:len(data) // RUN_STRUCT.size * RUN_STRUCT.size]):
+            first_ms, last_ms, count, flags, usb_available = fields
+            self.runs.append(HeartbeatRun(seq, first_ms, last_ms, count,
+                                          bool(flags & HEARTBEAT_FLAG_USB_CONNECTED),
+                                          bool(flags & HEARTBEAT_FLAG_NETWORK_ACTIVE), usb_available))
+            seq += 1
+
+    def heartbeats(self) -> Iterator[Heartbeat]:
+        """
+        The heartbeats of the runs, oldest first, with each run's timestamps spread evenly
+        between its first and last as the firmware's text dump does.
+        """
+        for run in self.runs:
+            for position in range(run.count):
+                timestamp = run.first_ms
+                if run.count > 1:
+                    timestamp += ((run.last_ms - run.first_ms) & 0xFFFFFFFF) * position // (run.count - 1)
+                yield Heartbeat(timestamp & 0xFFFFFFFF, run.usb_connected, run.network_active, run.usb_available)
+
+    def text_lines(self) -> List[str]:
+        """
+        The dump as the lines "dump_error_log" (text) would have sent, without the INFO prefix.
+        """
+        lines = [f"=== ERROR LOG: {len(self.errors)} entries ==="]
+        for entry in self.errors:
+            stamp = '?' if entry.timestamp_ms is None else entry.timestamp_ms
+            lines.append(f"[{stamp}] {entry.level}: {entry.message}")
+        lines.append("=== END ERROR LOG ===")
+        beats = list(self.heartbeats())
+        if beats:
+            span = (beats[-1].timestamp_ms - beats[0].timestamp_ms) & 0xFFFFFFFF
+            lines.append(f"=== HEARTBEAT LOG: {len(beats)} entries "
+                         f"({span // 3600000}h{span % 3600000 // 60000}m span) ===")
+        else:
+            lines.append("=== HEARTBEAT LOG: 0 entries ===")
+        for beat in beats:
+            lines.append(f"[{beat.timestamp_ms}] U:{int(beat.usb_connected)} "
+                         f"N:{int(beat.network_active)} A:{beat.usb_available}")
+        lines.append("=== END HEARTBEAT LOG ===")
+        return lines
@@ -207,17 +207,42 @@ def create_operator_view(parent, shared_gui_refs, view_id=None):
     print(f"[PRESSBOI OPERATOR_VIEW] create_operator_view called with view_id={view_id}")
     print(f"[PRESSBOI OPERATOR_VIEW] parent={parent}")
     
-    # Route to appropriate view creator based on view_id
-    if view_id == 'press_operator_view':
-        print(f"[PRESSBOI OPERATOR_VIEW] Creating press operator view")
-        create_press_operator_view(parent, shared_gui_refs)
-    elif view_id == 'injector_operator_view':
-        print(f"[PRESSBOI OPERATOR_VIEW] Creating injector operator view")
-        create_injector_operator_view(parent, shared_gui_refs)
-    else:
-        print(f"[PRESSBOI OPERATOR_VIEW] Creating generic operator view")
-        # Default/generic view
-        create_generic_operator_view(parent, shared_gui_refs)
+    def build():
+        # Route to appropriate view creator based on view_id
+        if view_id == 'press_operator_view':
+            print(f"[PRESSBOI OPERATOR_VIEW] Creating press operator view")
+            create_press_operator_view(parent, shared_gui_refs)
+        elif view_id == 'injector_operator_view':
+            print(f"[PRESSBOI OPERATOR_VIEW] Creating injector operator view")
+            create_injector_operator_view(parent, shared_gui_refs)
+        else:
+            print(f"[PRESSBOI OPERATOR_VIEW] Creating generic operator view")
+            # Default/generic view
+            create_generic_operator_view(parent, shared_gui_refs)
+    
+    # Views the operator never opens cost nothing: the content is built on first display
+    when_shown(parent, build)
+
+
+def when_shown(widget, callback):
+    """Calls callback() once, the first time widget is on screen (right away if it already is)."""
+    state = {'done': False}
+    
+    def check(event=None):
+        if state['done']:
+            return
+        try:
+            if not widget.winfo_viewable():
+                return
+        except tk.TclError:
+            return
+        state['done'] = True
+        callback()
+    
+    # <Visibility> also arrives when an ancestor (a notebook page) is shown
+    widget.bind('<Map>', check, add='+')
+    widget.bind('<Visibility>', check, add='+')
+    check()
 
 
 def create_press_operator_view(parent, shared_gui_refs):
@@ -477,12 +502,30 @@ def create_press_operator_view(parent, shared_gui_refs):
     
     # Hook into script runner to track PASS/FAIL status
     # Note: script_runner is created fresh each time a script runs, so we must
-    # get a fresh reference from shared_gui_refs each poll cycle
+    # get a fresh reference from shared_gui_refs on every update
     
     # Track previous script state to detect transitions
     prev_running = [False]
     prev_held = [False]
     
+    # Last value written to each label, so repeated events do not re-render unchanged text
+    shown = {}
+    
+    def show(var, label, text, color=None):
+        """Sets a label's text and color only when they change."""
+        if shown.get(str(var)) != text:
+            var.set(text)
+            shown[str(var)] = text
+        if color is not None and shown.get(str(label)) != color:
+            label.config(foreground=color)
+            shown[str(label)] = color
+    
+    def format_elapsed():
+        elapsed = time.time() - cycle_start_time[0]
+        mins = int(elapsed // 60)
+        secs = int(elapsed % 60)
+        return f'{mins:02d}:{secs:02d}'
+    
     def update_pass_fail():
         """Update PASS/FAIL indicator, cycle time, and status bar based on script state."""
         try:
@@ -508,46 +551,33 @@ def create_press_operator_view(parent, shared_gui_refs):
             if just_started:
                 # Script just started - record start time
                 cycle_start_time[0] = time.time()
-                cycle_time_var.set('00:00')
-                cycle_time_label.config(foreground=theme.BUSY_BLUE)
+                show(cycle_time_var, cycle_time_label, '00:00', theme.BUSY_BLUE)
             elif is_running and not is_held and cycle_start_time[0] is not None:
                 # Script is running - update elapsed time
-                elapsed = time.time() - cycle_start_time[0]
-                mins = int(elapsed // 60)
-                secs = int(elapsed % 60)
-                cycle_time_var.set(f'{mins:02d}:{secs:02d}')
+                show(cycle_time_var, cycle_time_label, format_elapsed())
             elif (just_stopped or just_held) and cycle_start_time[0] is not None:
                 # Script just finished or held - show final time
-                elapsed = time.time() - cycle_start_time[0]
-                mins = int(elapsed // 60)
-                secs = int(elapsed % 60)
-                cycle_time_var.set(f'{mins:02d}:{secs:02d}')
                 if had_errors or is_held:
-                    cycle_time_label.config(foreground=theme.ERROR_RED)
+                    show(cycle_time_var, cycle_time_label, format_elapsed(), theme.ERROR_RED)
                 else:
-                    cycle_time_label.config(foreground=theme.SUCCESS_GREEN)
+                    show(cycle_time_var, cycle_time_label, format_elapsed(), theme.SUCCESS_GREEN)
             
             if is_running and not is_held:
                 # Script is actively running
-                pass_fail_var.set('RUNNING')
-                pass_fail_label.config(foreground=theme.BUSY_BLUE)
+                show(pass_fail_var, pass_fail_label, 'RUNNING', theme.BUSY_BLUE)
             elif is_held or just_held:
                 # Script hit an error or warning
-                pass_fail_var.set('FAIL')
-                pass_fail_label.config(foreground=theme.ERROR_RED)
+                show(pass_fail_var, pass_fail_label, 'FAIL', theme.ERROR_RED)
             elif just_stopped:
                 # Script just finished
                 if had_errors:
-                    pass_fail_var.set('FAIL')
-                    pass_fail_label.config(foreground=theme.ERROR_RED)
+                    show(pass_fail_var, pass_fail_label, 'FAIL', theme.ERROR_RED)
                 else:
-                    pass_fail_var.set('PASS')
-                    pass_fail_label.config(foreground=theme.SUCCESS_GREEN)
+                    show(pass_fail_var, pass_fail_label, 'PASS', theme.SUCCESS_GREEN)
             elif not is_running and not is_held:
                 # Script is idle/reset - only change to READY if not showing PASS/FAIL
                 if pass_fail_var.get() not in ['PASS', 'FAIL']:
-                    pass_fail_var.set('READY')
-                    pass_fail_label.config(foreground=theme.COMMENT_COLOR)
+                    show(pass_fail_var, pass_fail_label, 'READY', theme.COMMENT_COLOR)
             
             # Update tracking
             prev_running[0] = is_running
@@ -560,11 +590,9 @@ def create_press_operator_view(parent, shared_gui_refs):
                 
                 # Check if reset was performed - clear FAIL, error message, and cycle time
                 if 'reset' in status_text.lower() and ('complete' in status_text.lower() or 'DONE' in status_text):
-                    pass_fail_var.set('READY')
-                    pass_fail_label.config(foreground=theme.COMMENT_COLOR)
-                    error_warning_var.set('')
-                    cycle_time_var.set('--:--')
-                    cycle_time_label.config(foreground=theme.PRIMARY_ACCENT)
+                    show(pass_fail_var, pass_fail_label, 'READY', theme.COMMENT_COLOR)
+                    show(error_warning_var, error_warning_label, '')
+                    show(cycle_time_var, cycle_time_label, '--:--', theme.PRIMARY_ACCENT)
                     cycle_start_time[0] = None
                 # Only show errors and warnings
                 elif '_ERROR:' in status_text or '_WARNING:' in status_text or 'ERROR:' in status_text or 'WARNING:' in status_text:
@@ -584,28 +612,100 @@ def create_press_operator_view(parent, shared_gui_refs):
                     elif 'WARNING:' in display_text:
                         idx = display_text.find('WARNING:')
                         display_text = display_text[idx + 8:].strip()
-                    error_warning_var.set(display_text)
-                    error_warning_label.config(foreground=theme.ERROR_RED)
+                    show(error_warning_var, error_warning_label, display_text, theme.ERROR_RED)
                 elif pass_fail_var.get() == 'READY':
                     # Clear the error/warning when back to READY state
-                    error_warning_var.set('')
-                    
+                    show(error_warning_var, error_warning_label, '')
+            
+            return is_running
         except Exception as e:
             print(f"[OPERATOR VIEW] Error updating PASS/FAIL: {e}")
-    
-    # Poll script state periodically (every 100ms)
-    def poll_state():
-        try:
-            update_pass_fail()
-        except Exception as e:
-            print(f"[OPERATOR VIEW] Polling error: {e}")
-        # Schedule next poll if parent still exists
-        if parent.winfo_exists():
-            parent.after(100, poll_state)
-    
-    # Start polling
-    print(f"[OPERATOR VIEW] Starting PASS/FAIL polling, initial value: {pass_fail_var.get()}")
-    poll_state()
+            return False
+    
+    # Updates are driven by the variables the host already writes: the status bar (script
+    # start/stop, errors, reset) and the device state from telemetry. A host that sets
+    # shared_gui_refs['script_state_var'] on every script transition gets exact PASS/FAIL
+    # timing. While the view is hidden its traces are detached and nothing is scheduled, and
+    # while no script is running nothing is scheduled either; while one runs, a 1 s tick keeps
+    # the cycle clock moving and catches a silent stop.
+    view = {
+        'visible': True,    # Until the first <Unmap>
+        'pending': None,    # after_idle id of a queued update
+        'tick': None,       # after id of the running-script clock tick
+    }
+    trace_ids = []
+    
+    def run_update():
+        view['pending'] = None
+        if not view['visible']:
+            return
+        running = update_pass_fail()
+        if running and view['tick'] is None:
+            view['tick'] = parent.after(1000, clock_tick)
+    
+    def clock_tick():
+        view['tick'] = None
+        run_update()
+    
+    def schedule_update(*args):
+        """Coalesces any burst of variable writes into one update when Tk is idle."""
+        if view['visible'] and view['pending'] is None:
+            try:
+                view['pending'] = parent.after_idle(run_update)
+            except tk.TclError:
+                pass
+    
+    def cancel_updates():
+        for key in ('pending', 'tick'):
+            if view[key] is not None:
+                try:
+                    parent.after_cancel(view[key])
+                except tk.TclError:
+                    pass
+                view[key] = None
+    
+    def attach_traces():
+        for key in ('status_var', 'script_state_var', 'pressboi_main_state_var'):
+            var = shared_gui_refs.get(key)
+            if var is not None:
+                trace_ids.append((var, var.trace_add('write', schedule_update)))
+    
+    def detach_traces():
+        # The traced variables outlive this view; drop our callbacks from them
+        for var, trace_id in trace_ids:
+            try:
+                var.trace_remove('write', trace_id)
+            except tk.TclError:
+                pass
+        trace_ids.clear()
+    
+    def on_map(event):
+        if event.widget is parent and not view['visible']:
+            view['visible'] = True
+            attach_traces()
+            schedule_update()
+    
+    def on_unmap(event):
+        if event.widget is parent and view['visible']:
+            view['visible'] = False
+            cancel_updates()
+            detach_traces()
+    
+    def on_destroy(event):
+        if event.widget is parent:
+            view['visible'] = False
+            cancel_updates()
+            detach_traces()
+    
+    attach_traces()
+    
+    parent.bind('<Map>', on_map, add='+')
+    parent.bind('<Unmap>', on_unmap, add='+')
+    parent.bind('<Destroy>', on_destroy, add='+')
+    
+    # Initial state
+    print(f"[OPERATOR VIEW] Tracking PASS/FAIL from {len(trace_ids)} variables, initial value: {pass_fail_var.get()}")
+    run_update()
     
     print(f"[PRESS OPERATOR VIEW] Content created directly in parent frame")
     print(f"[PRESS OPERATOR VIEW] Parent has {len(parent.winfo_children())} children")
@@ -0,0 +1,486 @@
+"""
+Async Pressboi Client
+
+asyncio client for the press's UDP text protocol, for automation scripts. One method per
+command is generated from commands.json when the module loads, with the parameters,
+optional defaults and enums the firmware takes, so a misspelt force action fails in the
+script rather than on the press. Telemetry (text or binary) and typed status events are
+decoded with the same telemetry.json and status_events.json the GUI uses.
+
+Every command goes out as "#<id> <command> <args>", and its request ID ties the reply to
+it: a Request is a future that resolves with the DONE text (or raises CommandError on
+ERROR) and collects the START and INFO lines in between. Sending does not wait for the
+previous reply, so commands are pipelined up to max_in_flight at a time; a command the
+press has not acknowledged within ack_timeout is sent again with the same ID, which the
+press acknowledges without running it twice.
+
+    async with PressboiClient('192.168.1.50') as press:
+        await press.home()
+        done = await press.move_abs(40.0, 5.0, 200.0, force_action='retract')
+        print(done.text, press.telemetry.get('endpoint'))
+
+        # Keep the motion queue topped up while it runs; returns queue_run's DONE
+        segments = [(10.0 + i, 20.0, 100.0, 'skip') for i in range(200)]
+        await press.run_queue(segments)
+
+The client registers itself as the press's GUI host with DISCOVER_DEVICE and repeats it
+every discover_interval seconds, which also keeps the telemetry clock in sync. Only one
+host receives a press's replies, so do not run the GUI against the same press at once.
+"""
+
+import asyncio
+import inspect
+import itertools
+import json
+import re
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, List, Optional, Sequence, Tuple, Union
+
+try:
+    from .status_event_decoder import StatusEventDecoder
+    from .telemetry_decoder import DISCOVERY_PREFIX, TelemetryDecoder
+except ImportError:
+    # Loaded by path from the device definition folder
+    from status_event_decoder import StatusEventDecoder
+    from telemetry_decoder import DISCOVERY_PREFIX, TelemetryDecoder
+
+COMMAND_PORT = 8888         # LOCAL_PORT in config.h
+MOTION_QUEUE_SIZE = 16      # MOTION_QUEUE_SIZE in config.h
+REQUEST_ID_MAX = 0x7FFFFFFF
+DEVICE_PREFIX = 'PRESSBOI_'
+ACK_PREFIX = 'PRESSBOI_ACK: #'
+
+_STATUS_RE = re.compile(r'PRESSBOI_(START|INFO|DONE|ERROR): (?:#(\d+) )?(.*)', re.S)
+_PENDING_RE = re.compile(r'(\d+) pending\)')
+
+EventListener = Callable[[str, str], None]
+
+
+class CommandError(Exception):
+    """The press answered a command with PRESSBOI_ERROR."""
+
+    def __init__(self, command: str, text: str):
+        super().__init__(f"{command}: {text}")
+        self.command = command
+        self.text = text
+
+
+class Reply:
+    """DONE of a command: its text (after the request ID) and the events that came before it."""
+
+    def __init__(self, text: str, events: List[Tuple[str, str]]):
+        self.text = text
+        self.events = events
+
+    def metrics(self) -> Dict[str, float]:
+        """key=value pairs of the DONE text as numbers (press metrics, cycle times)."""
+        values = {}
+        for word in self.text.split():
+            key, sep, value = word.partition('=')
+            if sep:
+                try:
+                    values[key] = float(value)
+                except ValueError:
+                    continue
+        return values
+
+    def __repr__(self) -> str:
+        return f"Reply({self.text!r})"
+
+
+class Request:
+    """
+    One command in flight. Awaiting it waits for the DONE (or raises on ERROR).
+    """
+
+    def __init__(self, request_id: int, command: str, text: str):
+        loop = asyncio.get_running_loop()
+        self.id = request_id
+        self.command = command
+        self.text = text
+        self.acked = loop.create_future()
+        self.result = loop.create_future()
+        self.events: List[Tuple[str, str]] = []
+        self.sends = 0
+        self._listeners: List[EventListener] = []
+
+    def add_listener(self, listener: EventListener) -> None:
+        """Call listener(status, text) for each START and INFO line of this command."""
+        self._listeners.append(listener)
+
+    def done(self) -> bool:
+        return self.result.done()
+
+    def __await__(self):
+        return self.result.__await__()
+
+    def _event(self, status: str, text: str) -> None:
+        self.events.append((status, text))
+        for listener in list(self._listeners):
+            listener(status, text)
+
+    def _finish(self, status: str, text: str) -> None:
+        if not self.acked.done():
+            # The reply proves receipt as well as an ACK does
+            self.acked.set_result(None)
+        if self.result.done():
+            return
+        if status == 'DONE':
+            self.result.set_result(Reply(text, self.events))
+        else:
+            self.result.set_exception(CommandError(self.command, text))
+
+    def _fail(self, error: BaseException) -> None:
+        for future in (self.acked, self.result):
+            if not future.done():
+                future.set_exception(error)
+        # Nobody may be waiting on the ACK; keep asyncio from reporting it as unretrieved
+        if self.acked.done() and not self.acked.cancelled():
+            self.acked.exception()
+
+
+def load_commands(definition_path: Optional[Union[str, Path]] = None) -> Dict[str, Any]:
+    """commands.json (default: the device definition next to this module)."""
+    if definition_path is None:
+        definition_path = Path(__file__).parent / 'commands.json'
+    with open(definition_path, 'r') as f:
+        return json.load(f)
+
+
+def format_command(name: str, spec: Dict[str, Any], args: Sequence[Any], kwargs: Dict[str, Any]) -> str:
+    """
+    Builds the text of a command from Python arguments, checked against its commands.json entry.
+
+    Optional parameters are positional on the wire, so one can only be given when every
+    optional parameter before it is (a documented default counts).
+
+    Raises:
+        TypeError: missing, unknown or out-of-order arguments
+        ValueError: a value of the wrong type or not in the parameter's enum
+    """
+    params = spec.get('params', [])
+    if len(args) > len(params):
+        raise TypeError(f"{name}() takes at most {len(params)} arguments ({len(args)} given)")
+    values: List[Any] = list(args) + [None] * (len(params) - len(args))
+    for key, value in kwargs.items():
+        index = next((i for i, param in enumerate(params) if param['parameter'] == key), None)
+        if index is None:
+            raise TypeError(f"{name}() got an unexpected argument '{key}'")
+        if index < len(args):
+            raise TypeError(f"{name}() got multiple values for argument '{key}'")
+        values[index] = value
+
+    # Trailing unset parameters are left off; a gap before a set one takes its default
+    last = max((i for i, value in enumerate(values) if value is not None), default=-1)
+    words = [name]
+    for index, param in enumerate(params[:last + 1]):
+        value = values[index]
+        if value is None:
+            value = param.get('default')
+            if value is None:
+                raise TypeError(f"{name}() missing argument '{param['parameter']}'")
+        words.append(_format_value(name, param, value))
+    for param in params[last + 1:]:
+        if not param.get('optional'):
+            raise TypeError(f"{name}() missing argument '{param['parameter']}'")
+    return ' '.join(words)
+
+
+def _format_value(name: str, param: Dict[str, Any], value: Any) -> str:
+    kind = param.get('type', 'string')
+    label = f"{name}() argument '{param['parameter']}'"
+    if kind == 'float':
+        if isinstance(value, bool) or not isinstance(value, (int, float)):
+            raise ValueError(f"{label} must be a number")
+        return repr(float(value))
+    if kind == 'int':
+        if isinstance(value, bool) or not isinstance(value, int):
+            raise ValueError(f"{label} must be an int")
+        return str(value)
+    text = str(value)
+    if param.get('enum') and text not in param['enum']:
+        raise ValueError(f"{label} must be one of {', '.join(param['enum'])}")
+    if not text or '\n' in text or (' ' in text and not param.get('rest')):
+        raise ValueError(f"{label} must be one word")
+    return text
+
+
+def _command_method(name: str, spec: Dict[str, Any]) -> Callable[..., Request]:
+    def method(self: 'PressboiClient', *args: Any, **kwargs: Any) -> Request:
+        return self.send(name, *args, **kwargs)
+
+    parameters = [inspect.Parameter('self', inspect.Parameter.POSITIONAL_OR_KEYWORD)]
+    lines = [spec.get('description', ''), '']
+    annotations = {'float': float, 'int': int, 'string': str}
+    for param in spec.get('params', []):
+        optional = param.get('optional', False)
+        parameters.append(inspect.Parameter(
+            param['parameter'], inspect.Parameter.POSITIONAL_OR_KEYWORD,
+            default=param.get('default') if optional else inspect.Parameter.empty,
+            annotation=annotations.get(param.get('type'), Any)))
+        unit = f" ({param['unit']})" if param.get('unit') else ''
+        choices = f" One of: {', '.join(param['enum'])}." if param.get('enum') else ''
+        lines.append(f"    {param['parameter']}{unit}: {param.get('help', '')}{choices}".rstrip())
+    method.__name__ = name
+    method.__qualname__ = f"PressboiClient.{name}"
+    method.__signature__ = inspect.Signature(parameters, return_annotation=Request)
+    method.__doc__ = '\n'.join(lines).strip()
+    return method
+
+
+class _Protocol(asyncio.DatagramProtocol):
+    def __init__(self, client: 'PressboiClient'):
+        self._client = client
+
+    def datagram_received(self, data: bytes, addr: Tuple[str, int]) -> None:
+        # UDP=BATCH1 datagrams carry several lines
+        for line in data.decode('ascii', 'replace').split('\n'):
+            line = line.strip('\r\x00 ')
+            if line:
+                self._client._line(line)
+
+    def error_received(self, exc: Exception) -> None:
+        # ICMP port unreachable and the like; the retransmit timer covers the loss
+        pass
+
+
+class PressboiClient:
+    """
+    One press on the network. Command methods are generated from commands.json.
+    """
+
+    def __init__(self, host: str, port: int = COMMAND_PORT, local_port: int = 0,
+                 binary_telemetry: bool = True, binary_events: bool = False,
+                 max_in_flight: int = 16, ack_timeout: float = 0.25, retries: int = 4,
+                 discover_interval: float = 5.0):
+        """
+        Args:
+            host: Press IP address
+            port: Press command port
+            local_port: Port replies and telemetry come back to (0 = any free port)
+            binary_telemetry: Ask for PRESSBOI_TELEMB frames (TELEM=BIN1)
+            binary_events: Ask for typed PRESSBOI_EVENTB records (EVENT=BIN1); they are
+                rendered back to text before matching
+            max_in_flight: Commands sent and not yet answered; keep it well below the
+                press's RX_QUEUE_SIZE (64)
+            ack_timeout: Seconds to wait for an ACK before sending a command again
+            retries: Sends after the first before a command fails with TimeoutError
+            discover_interval: Seconds between DISCOVER_DEVICE repeats (clock sync)
+        """
+        self.host = host
+        self.port = port
+        self.local_port = local_port
+        self.binary_telemetry = binary_telemetry
+        self.binary_events = binary_events
+        self.ack_timeout = ack_timeout
+        self.retries = retries
+        self.discover_interval = discover_interval
+        self.telemetry = TelemetryDecoder()
+        self.identity: Dict[str, str] = {}
+        self._events = StatusEventDecoder()
+        self._max_in_flight = max_in_flight
+        self._window: Optional[asyncio.Semaphore] = None
+        self._transport: Optional[asyncio.DatagramTransport] = None
+        self._requests: Dict[int, Request] = {}
+        self._ids = itertools.count(int(time.time() * 1000) % (REQUEST_ID_MAX // 2) + 1)
+        self._discovered: Optional[asyncio.Future] = None
+        self._discover_task: Optional[asyncio.Task] = None
+        self._line_listeners: List[Callable[[str], None]] = []
+
+    # --- Connection ----------------------------------------------------------------------
+
+    async def connect(self, timeout: float = 2.0) -> Dict[str, str]:
+        """
+        Opens the socket and discovers the press.
+
+        Returns:
+            The DISCOVERY_RESPONSE fields (DEVICE_ID, FW, TELEM, ...)
+        """
+        loop = asyncio.get_running_loop()
+        self._window = asyncio.Semaphore(self._max_in_flight)
+        self._transport, _ = await loop.create_datagram_endpoint(
+            lambda: _Protocol(self), local_addr=('0.0.0.0', self.local_port))
+        self.local_port = self._transport.get_extra_info('sockname')[1]
+        self._discovered = loop.create_future()
+        deadline = loop.time() + timeout
+        while not self._discovered.done():
+            self._discover()
+            try:
+                await asyncio.wait_for(asyncio.shield(self._discovered), min(0.5, max(deadline - loop.time(), 0.01)))
+            except asyncio.TimeoutError:
+                if loop.time() >= deadline:
+                    self.close()
+                    raise TimeoutError(f"no DISCOVERY_RESPONSE from {self.host}:{self.port}") from None
+        self._discover_task = loop.create_task(self._rediscover())
+        return self.identity
+
+    def close(self) -> None:
+        """Closes the socket; commands still in flight fail with ConnectionError."""
+        if self._discover_task is not None:
+            self._discover_task.cancel()
+            self._discover_task = None
+        if self._transport is not None:
+            self._transport.close()
+            self._transport = None
+        for request in list(self._requests.values()):
+            request._fail(ConnectionError('client closed'))
+        self._requests.clear()
+
+    async def __aenter__(self) -> 'PressboiClient':
+        await self.connect()
+        return self
+
+    async def __aexit__(self, *exc: Any) -> None:
+        self.close()
+
+    def _discover(self) -> None:
+        options = f"PORT={self.local_port}"
+        if self.binary_telemetry:
+            options += ' TELEM=BIN1'
+        if self.binary_events:
+            options += ' EVENT=BIN1'
+        options += f" UDP=BATCH1 SYNC={self.telemetry.clock.sync_token()}"
+        self._send_text(f"DISCOVER_DEVICE {options}")
+
+    async def _rediscover(self) -> None:
+        while True:
+            await asyncio.sleep(self.discover_interval)
+            self._discover()
+
+    def add_line_listener(self, listener: Callable[[str], None]) -> None:
+        """Call listener(line) for every line not tied to a request (untagged events, dumps)."""
+        self._line_listeners.append(listener)
+
+    # --- Commands ------------------------------------------------------------------------
+
+    def send(self, command: str, *args: Any, **kwargs: Any) -> Request:
+        """
+        Sends a command without waiting for earlier ones. The generated methods call this.
+
+        Returns:
+            The Request; await it for the DONE
+        """
+        spec = COMMANDS.get(command)
+        if spec is None:
+            raise ValueError(f"unknown command '{command}'")
+        return self.send_text(format_command(command, spec, args, kwargs))
+
+    def send_text(self, text: str) -> Request:
+        """Sends a command already in text form ("move_abs 10 5 100")."""
+        if self._transport is None or self._window is None:
+            raise ConnectionError('not connected')
+        request_id = next(self._ids)
+        if request_id > REQUEST_ID_MAX:
+            self._ids = itertools.count(1)
+            request_id = next(self._ids)
+        request = Request(request_id, text.split(' ', 1)[0], text)
+        self._requests[request_id] = request
+        asyncio.get_running_loop().create_task(self._run(request))
+        return request
+
+    async def _run(self, request: Request) -> None:
+        async with self._window:
+            try:
+                for attempt in range(self.retries + 1):
+                    if request.done():
+                        break
+                    self._send_text(f"#{request.id} {request.text}")
+                    request.sends += 1
+                    try:
+                        await asyncio.wait_for(asyncio.shield(request.acked), self.ack_timeout * (attempt + 1))
+                        break
+                    except asyncio.TimeoutError:
+                        continue
+                else:
+                    request._fail(TimeoutError(f"{request.command}: no ACK after {request.sends} sends"))
+                # The window slot is held until the press has answered
+                await asyncio.wait({request.result})
+            finally:
+                self._requests.pop(request.id, None)
+
+    def _send_text(self, text: str) -> None:
+        if self._transport is not None:
+            self._transport.sendto(text.encode('ascii'), (self.host, self.port))
+
+    async def run_queue(self, segments: Iterable[Sequence[Any]], depth: int = MOTION_QUEUE_SIZE) -> Reply:
+        """
+        Runs queue_move segments through the motion queue, adding more as it drains so a
+        list longer than the queue runs without a stop.
+
+        Args:
+            segments: queue_move arguments per segment (position, speed, force[, action[, dwell]])
+            depth: Segments to keep queued at most (the firmware's MOTION_QUEUE_SIZE)
+
+        Returns:
+            The DONE of queue_run
+        """
+        pending = iter(segments)
+        first = [self.queue_move(*segment) for segment in itertools.islice(pending, depth)]
+        if not first:
+            raise ValueError('no segments')
+        await asyncio.gather(*first)
+
+        queued = asyncio.Queue()
+        run = self.queue_run()
+
+        def on_event(status: str, text: str) -> None:
+            match = _PENDING_RE.search(text)
+            if match:
+                queued.put_nowait(int(match.group(1)))
+
+        run.add_listener(on_event)
+        exhausted = False
+        while not exhausted and not run.done():
+            getter = asyncio.ensure_future(queued.get())
+            await asyncio.wait({getter, run.result}, return_when=asyncio.FIRST_COMPLETED)
+            if not getter.done():
+                getter.cancel()
+                break
+            waiting = getter.result()
+            # Only the newest count matters
+            while not queued.empty():
+                waiting = queued.get_nowait()
+            batch = list(itertools.islice(pending, max(depth - waiting, 0)))
+            exhausted = len(batch) < max(depth - waiting, 0)
+            if batch:
+                await asyncio.gather(*(self.queue_move(*segment) for segment in batch))
+        return await run
+
+    # --- Receive -------------------------------------------------------------------------
+
+    def _line(self, line: str) -> None:
+        event = self._events.decode_line(line)
+        if event is not None:
+            line = event.text
+        if line.startswith(ACK_PREFIX):
+            digits = line[len(ACK_PREFIX):].strip()
+            request = self._requests.get(int(digits)) if digits.isdigit() else None
+            if request is not None and not request.acked.done():
+                request.acked.set_result(None)
+            return
+        if self.telemetry.feed_line(line) is not None:
+            return
+        if line.startswith(DISCOVERY_PREFIX):
+            self.identity = dict(re.findall(r'(\w+)=(\S+)', line[len(DISCOVERY_PREFIX):]))
+            if self._discovered is not None and not self._discovered.done():
+                self._discovered.set_result(None)
+            return
+        match = _STATUS_RE.match(line)
+        request = self._requests.get(int(match.group(2))) if match and match.group(2) else None
+        if request is None:
+            for listener in list(self._line_listeners):
+                listener(line)
+            return
+        status, text = match.group(1), match.group(3)
+        if status in ('DONE', 'ERROR'):
+            request._finish(status, text)
+        else:
+            request._event(status, text)
+
+
+COMMANDS = load_commands()
+
+for _name, _spec in COMMANDS.items():
+    if not hasattr(PressboiClient, _name):
+        setattr(PressboiClient, _name, _command_method(_name, _spec))
@@ -5,7 +5,16 @@ This module provides report generation functionality for press operations,
 generating beautiful interactive HTML reports with Plotly charts.
 """
 
-from .press_report import generate_press_report, PressReportGenerator
+from .press_report import (generate_press_report, generate_press_reports, generate_shift_summary,
+                           get_generator, PressReportGenerator)
+from .press_curves import CurveFileWriter, capture_to_press, decode_capture_lines, load_curve_file
+from .press_stream import PressStream, RunningPressMetrics
+from .press_spc import PressSpc, RunningStat
+from .telemetry_log import TelemetryLog, TelemetryLogWriter, convert_csv_log
+from .fleet_logger import FleetLogger
 
-__all__ = ['generate_press_report', 'PressReportGenerator']
+__all__ = ['generate_press_report', 'generate_press_reports', 'generate_shift_summary', 'get_generator',
+           'PressReportGenerator', 'CurveFileWriter', 'capture_to_press', 'decode_capture_lines', 'load_curve_file',
+           'PressStream', 'RunningPressMetrics', 'TelemetryLog', 'TelemetryLogWriter', 'convert_csv_log',
+           'FleetLogger', 'PressSpc', 'RunningStat']
 
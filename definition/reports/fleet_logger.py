@@ -0,0 +1,321 @@
+"""
+Fleet Telemetry Logger
+
+One host process that logs the telemetry of every press on the network, each press into
+its own columnar telemetry log (telemetry_log.py), in place of every operator app writing
+a CSV of its own. The logger takes a subscribe_telemetry lease on each press and renews it
+every lease_s / 3, so it runs beside whatever GUI or PLC owns the press and takes nothing
+from it; a press that reboots is picked up again by the next renewal.
+
+Frames, text or binary (a subscriber gets the encoding the GUI set), are decoded through
+telemetry.json by TelemetryDecoder, one per press, so every log has the same columns in
+the same units; a row is the press's latest value of every field, so delta frames keep the
+previous values as the GUI does. Subscribers get no
+clock-sync replies, so a frame's time is its t_us placed on the host clock by the earliest
+arrival seen: network and queue delays only ever make a frame late, so the smallest
+arrival-minus-device time is the offset, relaxed by CLOCK_RELAX_PPM for the crystal's drift.
+A device clock that steps back (a reboot) restarts the estimate.
+
+Receiving and writing are kept apart. The receive thread only decodes and queues rows; the
+writer thread takes them off in batches (every FLUSH_INTERVAL_S, or at BATCH_ROWS) and hands
+them to each press's TelemetryLogWriter, which writes a chunk as it fills and cuts one when
+a press starts or ends. A slow disk delays the writer, never the socket. stop() writes the
+rest and closes every log, which writes its index.
+
+DONE and ERROR events go to a press's GUI host only, not to subscribers, so the presses
+themselves come from MAIN_STATE in the logs (TelemetryLog.presses()). Where the logger also
+hears events (it is the GUI host of a press, or the host passes its lines to feed_line())
+they are kept next to the log, one JSON object per line in <name>.events.jsonl.
+
+Usage:
+
+    python definition/reports/fleet_logger.py --out logs/ line1=192.168.1.50 line2=192.168.1.51
+    python definition/reports/fleet_logger.py --out logs/ --rate-hz 50 192.168.1.52
+
+    logger = FleetLogger('logs/', {'line1': '192.168.1.50'}, rate_hz=100)
+    logger.start()
+    ...
+    logger.stop()
+    log = TelemetryLog('logs/line1.pbt')
+"""
+
+import argparse
+import json
+import queue
+import socket
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Tuple, Union
+
+try:
+    from .telemetry_log import TELEMETRY_LOG_SUFFIX, TelemetryLogWriter, load_schema
+except ImportError:
+    # Run as a script next to telemetry_log.py
+    from telemetry_log import TELEMETRY_LOG_SUFFIX, TelemetryLogWriter, load_schema
+
+try:
+    from ..telemetry_decoder import TelemetryDecoder
+except (ImportError, ValueError):
+    sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+    from telemetry_decoder import TelemetryDecoder
+
+COMMAND_PORT = 8888             # LOCAL_PORT in config.h
+TELEMETRY_RATE_HZ_MAX = 500.0   # subscribe_telemetry limit
+LEASE_S = 30
+FLUSH_INTERVAL_S = 1.0
+BATCH_ROWS = 2048
+QUEUE_ROWS = 200000             # Rows queued for the writer before new ones are dropped
+CLOCK_RELAX_PPM = 100.0
+REBOOT_BACKSTEP_S = 1.0
+EVENTS_SUFFIX = '.events.jsonl'
+EVENT_PREFIXES = ('PRESSBOI_DONE: ', 'PRESSBOI_ERROR: ')
+
+
+class PressFeed:
+    """Decoder and host-time estimate of one press."""
+
+    def __init__(self, name: str, address: str, definition_path: Optional[Path]):
+        self.name = name
+        self.address = address
+        self.decoder = TelemetryDecoder(definition_path)
+        self.offset: Optional[float] = None     # Host minus device seconds, earliest arrival
+        self.offset_at = 0.0                    # Device seconds of the last offset update
+        self.last_device_s: Optional[float] = None
+        self.frames = 0
+        self.events = 0
+        self.reboots = 0
+
+    def timestamp(self, arrival: float) -> float:
+        """Host time of the frame just decoded."""
+        device_us = self.decoder.device_time_us
+        if device_us is None:
+            return arrival
+        device_s = device_us * 1e-6
+        if self.last_device_s is not None and device_s + REBOOT_BACKSTEP_S < self.last_device_s:
+            self.reboots += 1
+            self.decoder.clock.reset()
+            device_s = self.decoder.clock.unwrap(device_us & 0xFFFFFFFF) * 1e-6
+            self.offset = None
+        self.last_device_s = device_s
+        candidate = arrival - device_s
+        if self.offset is None:
+            self.offset = candidate
+        else:
+            # Let the estimate follow a slow crystal; any earlier arrival tightens it at once
+            self.offset += (device_s - self.offset_at) * CLOCK_RELAX_PPM * 1e-6
+            self.offset = min(self.offset, candidate)
+        self.offset_at = device_s
+        return device_s + self.offset
+
+
+class FleetLogger:
+    """
+    Subscribes to a set of presses and logs each one's telemetry to <out>/<name>.pbt.
+    """
+
+    def __init__(self, out_dir: Union[str, Path], presses: Dict[str, str], rate_hz: float = 100.0,
+                 lease_s: int = LEASE_S, listen_port: int = 0, chunk_rows: Optional[int] = None,
+                 definition_path: Optional[Union[str, Path]] = None):
+        """
+        Args:
+            out_dir: Folder of the logs (created if missing); existing logs are appended to
+            presses: Log name to press address
+            rate_hz: Highest telemetry rate asked of each press, 0.5-500 Hz
+            lease_s: subscribe_telemetry lease, renewed every third of it
+            listen_port: Local UDP port the presses send to (0 = any free one)
+            chunk_rows: Rows per chunk (default: the telemetry_log default)
+            definition_path: telemetry.json (default: the device definition)
+        """
+        self.out_dir = Path(out_dir)
+        self.rate_hz = min(float(rate_hz), TELEMETRY_RATE_HZ_MAX)
+        self.lease_s = int(lease_s)
+        self.chunk_rows = chunk_rows
+        self.definition_path = Path(definition_path) if definition_path is not None else None
+        self.schema = load_schema(self.definition_path)
+        self.feeds: Dict[str, PressFeed] = {
+            address: PressFeed(name, address, self.definition_path) for name, address in presses.items()
+        }
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(('', listen_port))
+        self.sock.settimeout(0.2)
+        self.port = self.sock.getsockname()[1]
+        self.dropped = 0
+        self.written = 0
+        self._queue: 'queue.Queue[Tuple[str, Any]]' = queue.Queue(QUEUE_ROWS)
+        self._running = threading.Event()
+        self._threads: List[threading.Thread] = []
+
+    def start(self) -> None:
+        """Subscribes to every press and starts the receive and writer threads."""
+        self.out_dir.mkdir(parents=True, exist_ok=True)
+        self._running.set()
+        self._threads = [threading.Thread(target=self._receive_loop, name='fleet-rx', daemon=True),
+                         threading.Thread(target=self._write_loop, name='fleet-writer', daemon=True)]
+        for thread in self._threads:
+            thread.start()
+
+    def stop(self) -> None:
+        """Ends the subscriptions, writes what is queued and closes every log."""
+        for feed in self.feeds.values():
+            self._send(feed.address, f"unsubscribe_telemetry {self.port}")
+        self._running.clear()
+        for thread in self._threads:
+            thread.join()
+        self._threads = []
+        self.sock.close()
+
+    def _send(self, address: str, text: str) -> None:
+        try:
+            self.sock.sendto(text.encode('ascii'), (address, COMMAND_PORT))
+        except OSError:
+            # Unreachable for now; the next renewal tries again
+            pass
+
+    def _subscribe(self) -> None:
+        for feed in self.feeds.values():
+            self._send(feed.address, f"subscribe_telemetry {self.port} {self.rate_hz:g} {self.lease_s}")
+
+    def _receive_loop(self) -> None:
+        renew_s = max(1.0, self.lease_s / 3.0)
+        next_renew = 0.0
+        while self._running.is_set():
+            now = time.monotonic()
+            if now >= next_renew:
+                self._subscribe()
+                next_renew = now + renew_s
+            try:
+                data, (address, _) = self.sock.recvfrom(65536)
+            except socket.timeout:
+                continue
+            except OSError:
+                break
+            arrival = time.time()
+            feed = self.feeds.get(address)
+            if feed is None:
+                continue
+            for line in data.decode('ascii', errors='replace').split('\n'):
+                self.feed_line(feed.name, line.strip(), arrival)
+
+    def feed_line(self, name: str, line: str, arrival: Optional[float] = None) -> bool:
+        """
+        Take one line received from a press, from the logger's socket or from another host.
+
+        Returns:
+            True if it was telemetry or an event and has been queued for the log
+        """
+        feed = next((f for f in self.feeds.values() if f.name == name), None)
+        if feed is None or not line:
+            return False
+        arrival = time.time() if arrival is None else arrival
+        if line.startswith(EVENT_PREFIXES):
+            status, _, text = line[len('PRESSBOI_'):].partition(': ')
+            feed.events += 1
+            return self._put(('event', (name, {'time': arrival, 'status': status, 'text': text})))
+        frame = feed.decoder.feed_line(line)
+        if frame is None:
+            return False
+        feed.frames += 1
+        return self._put(('row', (name, feed.timestamp(arrival), dict(feed.decoder.values))))
+
+    def _put(self, item: Tuple[str, Any]) -> bool:
+        try:
+            self._queue.put_nowait(item)
+            return True
+        except queue.Full:
+            self.dropped += 1
+            return False
+
+    def _take_batch(self, timeout: float) -> List[Tuple[str, Any]]:
+        batch = []
+        deadline = time.monotonic() + timeout
+        while len(batch) < BATCH_ROWS:
+            remaining = deadline - time.monotonic()
+            try:
+                batch.append(self._queue.get(timeout=max(0.0, remaining)) if remaining > 0 else self._queue.get_nowait())
+            except queue.Empty:
+                break
+        return batch
+
+    def _write_loop(self) -> None:
+        writers: Dict[str, TelemetryLogWriter] = {}
+        events: Dict[str, Any] = {}
+        try:
+            while self._running.is_set() or not self._queue.empty():
+                batch = self._take_batch(FLUSH_INTERVAL_S if self._running.is_set() else 0.0)
+                for kind, payload in batch:
+                    if kind == 'row':
+                        name, timestamp, frame = payload
+                        writer = writers.get(name)
+                        if writer is None:
+                            writer = self._open_writer(name)
+                            writers[name] = writer
+                        writer.append(timestamp, frame)
+                        self.written += 1
+                    else:
+                        name, event = payload
+                        stream = events.get(name)
+                        if stream is None:
+                            stream = open(self.out_dir / f"{name}{EVENTS_SUFFIX}", 'a')
+                            events[name] = stream
+                        stream.write(json.dumps(event) + '\n')
+                for stream in events.values():
+                    stream.flush()
+        finally:
+            for writer in writers.values():
+                writer.close()
+            for stream in events.values():
+                stream.close()
+
+    def _open_writer(self, name: str) -> TelemetryLogWriter:
+        kwargs = {'schema': self.schema, 'definition_path': self.definition_path}
+        if self.chunk_rows is not None:
+            kwargs['chunk_rows'] = self.chunk_rows
+        return TelemetryLogWriter(self.out_dir / f"{name}{TELEMETRY_LOG_SUFFIX}", **kwargs)
+
+    def stats(self) -> str:
+        """One line per press: frames, events and reboots seen, plus the queue state."""
+        lines = [f"{feed.name} ({feed.address}): {feed.frames} frames, {feed.events} events, "
+                 f"{feed.decoder.lost_frames} lost, {feed.reboots} reboots" for feed in self.feeds.values()]
+        lines.append(f"queued {self._queue.qsize()}, written {self.written}, dropped {self.dropped}")
+        return '\n'.join(lines)
+
+
+def _parse_presses(specs: List[str]) -> Dict[str, str]:
+    presses = {}
+    for spec in specs:
+        name, sep, address = spec.partition('=')
+        if not sep:
+            name, address = spec.replace('.', '_'), spec
+        presses[name] = address
+    return presses
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Log the telemetry of several presses, one columnar log each.')
+    parser.add_argument('presses', nargs='+', help='press address, or name=address to name its log')
+    parser.add_argument('--out', default='fleet_logs', help='folder of the logs (default: %(default)s)')
+    parser.add_argument('--rate-hz', type=float, default=100.0, help='telemetry rate asked of each press (default: %(default)s)')
+    parser.add_argument('--port', type=int, default=0, help='local UDP port (default: any free one)')
+    parser.add_argument('--stats-s', type=float, default=60.0, help='print counters every N seconds, 0 = never')
+    options = parser.parse_args()
+
+    logger = FleetLogger(options.out, _parse_presses(options.presses), rate_hz=options.rate_hz,
+                         listen_port=options.port)
+    logger.start()
+    print(f"Logging {len(logger.feeds)} presses to {logger.out_dir} on UDP port {logger.port}; Ctrl+C to stop.")
+    try:
+        while True:
+            time.sleep(options.stats_s if options.stats_s > 0 else 3600.0)
+            if options.stats_s > 0:
+                print(logger.stats(), flush=True)
+    except KeyboardInterrupt:
+        pass
+    logger.stop()
+    print(logger.stats())
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
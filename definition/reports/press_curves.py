@@ -0,0 +1,411 @@
+"""
+Press Curve Files
+
+Binary per-sample press curves for reports, so a shift of presses never goes through CSV
+text. Two sources are handled:
+
+- dump_capture lines from the firmware (CAPTURE:pressboi:HEADER / DATA:<index>:<base64>),
+  whose varint records are decoded with numpy in one pass instead of byte by byte.
+- dump_curve lines (CURVE:pressboi:HEADER / DATA:<index>:<base64>), the force on a fixed
+  position grid. Point i lies at start_mm + i * step_mm, so two presses or a press and an
+  envelope on the same grid compare element by element.
+- Curve files (.pbc) holding many presses as fixed-size little-endian records. They are
+  opened with numpy.memmap, so loading a 1000-press file reads only its index, and each
+  press is a view of the file that is paged in when a metric touches it.
+
+Curve file layout (all little-endian):
+
+    header   32 bytes  magic 'PBCV', version u16, record size u16, press count u32,
+                       index offset u64, 12 reserved bytes
+    records  16 bytes  time_s f32, position_mm f32, force_kg f32, energy_j f32
+    index    24 bytes  first record u64, record count u32, flags u32, start time f64
+                       (Unix seconds, 0 = unknown); one entry per press, after the records
+
+The index is written last, so a writer streams presses to disk as they finish and a file
+cut short by a crash is rejected rather than misread.
+
+Typical use, one press appended per dump_capture:
+
+    with CurveFileWriter('shift.pbc') as writer:
+        writer.add_press(capture_to_press(decode_capture_lines(lines), kg_per_count))
+    presses = load_curve_file('shift.pbc')
+"""
+
+import base64
+import struct
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Dict, Iterable, List, Optional, Union
+
+try:
+    import numpy as np
+except ImportError:
+    raise ImportError(
+        "NumPy is required for press curve files. "
+        "Install it with: pip install numpy"
+    )
+
+CURVE_FILE_SUFFIX = '.pbc'
+CURVE_MAGIC = b'PBCV'
+CURVE_VERSION = 1
+
+CURVE_FLAG_ENERGY = 0x1         # energy_j holds logged joules, not just the integral
+CURVE_FLAG_MOTOR_TORQUE = 0x2   # force_kg came from motor torque, not the load cell
+
+HEADER_STRUCT = struct.Struct('<4sHHIQ12x')
+RECORD_DTYPE = np.dtype([
+    ('time_s', '<f4'),
+    ('position_mm', '<f4'),
+    ('force_kg', '<f4'),
+    ('energy_j', '<f4'),
+])
+INDEX_DTYPE = np.dtype([
+    ('first', '<u8'),
+    ('count', '<u4'),
+    ('flags', '<u4'),
+    ('start_epoch', '<f8'),
+])
+
+CAPTURE_PREFIX = 'CAPTURE:pressboi:'
+CURVE_PREFIX = 'CURVE:pressboi:'
+GRAVITY = 9.81
+
+
+def integrate_energy(positions: np.ndarray, forces: np.ndarray) -> np.ndarray:
+    """
+    Cumulative energy of a force-distance curve (trapezoidal, distance travelled either way).
+
+    Args:
+        positions: Positions in mm
+        forces: Forces in kg
+
+    Returns:
+        Energy in J at each sample (0 at the first)
+    """
+    positions = np.asarray(positions, dtype=np.float64)
+    forces = np.asarray(forces, dtype=np.float64)
+    energies = np.zeros(positions.shape, dtype=np.float64)
+    if positions.size > 1:
+        steps = np.abs(np.diff(positions)) / 1000.0 * (forces[1:] + forces[:-1]) * (GRAVITY / 2.0)
+        np.cumsum(steps, out=energies[1:])
+    return energies
+
+
+def decimate_min_max(values: np.ndarray, columns: int) -> np.ndarray:
+    """
+    Sample indices that keep the shape of a curve drawn `columns` pixels wide.
+
+    The samples are split into `columns` runs of consecutive samples, and the lowest and
+    highest value of each run are kept, in their original order. Peaks therefore survive
+    exactly, unlike a plain stride, and the result has at most 2 * columns + 2 points.
+
+    Args:
+        values: Curve values (forces), in sample order
+        columns: Pixel columns of the plot; 0 keeps every sample
+
+    Returns:
+        Increasing sample indices, always including the first and last sample
+    """
+    values = np.asarray(values, dtype=np.float64)
+    count = values.size
+    if columns <= 0 or count <= 2 * columns + 2:
+        return np.arange(count)
+    edges = np.linspace(0, count, columns + 1).astype(np.intp)
+    starts = edges[:-1]
+    # One row per run, padded to the longest run; the padding is masked out of argmin/argmax
+    longest = int(np.max(np.diff(edges)))
+    offsets = starts[:, None] + np.arange(longest)[None, :]
+    valid = offsets < edges[1:, None]
+    window = values[np.minimum(offsets, count - 1)]
+    lows = np.argmin(np.where(valid, window, np.inf), axis=1) + starts
+    highs = np.argmax(np.where(valid, window, -np.inf), axis=1) + starts
+    keep = np.concatenate(([0, count - 1], lows, highs))
+    return np.unique(keep)
+
+
+def _decode_varints(data: np.ndarray) -> np.ndarray:
+    """Decodes a uint8 array of concatenated unsigned LEB128 varints."""
+    ends = np.flatnonzero(data < 0x80)
+    if ends.size == 0:
+        return np.zeros(0, dtype=np.uint64)
+    data = data[:ends[-1] + 1]
+    starts = np.empty_like(ends)
+    starts[0] = 0
+    starts[1:] = ends[:-1] + 1
+    group = np.repeat(np.arange(ends.size), ends - starts + 1)
+    shift = ((np.arange(data.size) - starts[group]) * 7).astype(np.uint64)
+    return np.add.reduceat((data & 0x7F).astype(np.uint64) << shift, starts)
+
+
+def _unzigzag(values: np.ndarray) -> np.ndarray:
+    values = values.astype(np.int64)
+    return (values >> 1) ^ -(values & 1)
+
+
+def decode_capture_lines(lines: Iterable[str]) -> Dict[str, Any]:
+    """
+    Decodes the lines of one dump_capture (HEADER and DATA lines, any other lines ignored).
+
+    Args:
+        lines: Message lines as received; a PRESSBOI_ prefix or request ID is not expected
+
+    Returns:
+        Dictionary with numpy arrays time_us (from the first sample), pos_steps, raw and
+        torque_deci, plus steps_per_mm, keyframe and start_us (device Microseconds() of the
+        first sample, for DeviceClock.to_host(); None from firmware that does not send it)
+        from the HEADER line
+    """
+    header: Dict[str, str] = {}
+    chunks = []
+    for line in lines:
+        line = line.strip()
+        if not line.startswith(CAPTURE_PREFIX):
+            continue
+        body = line[len(CAPTURE_PREFIX):]
+        if body.startswith('HEADER:'):
+            for token in body[len('HEADER:'):].split():
+                key, _, value = token.partition('=')
+                header[key] = value
+        elif body.startswith('DATA:'):
+            _, first, payload = body.split(':', 2)
+            chunks.append((int(first), np.frombuffer(base64.b64decode(payload), dtype=np.uint8)))
+
+    if header.get('format', 'varint1') != 'varint1':
+        raise ValueError(f"Unsupported capture format: {header.get('format')}")
+    keyframe = int(header.get('keyframe', 32))
+    steps_per_mm = float(header.get('steps_per_mm', 0) or 0)
+    start_us = int(header['start_us']) if 'start_us' in header else None
+    empty = np.zeros(0, dtype=np.int64)
+    if not chunks:
+        return {'time_us': empty, 'pos_steps': empty, 'raw': empty, 'torque_deci': empty,
+                'steps_per_mm': steps_per_mm, 'keyframe': keyframe, 'start_us': start_us}
+
+    # Lines are whole keyframe blocks, so the sorted payloads are one record stream;
+    # each line's first index still places its samples if a line was lost
+    chunks.sort(key=lambda chunk: chunk[0])
+    data = np.concatenate([payload for _, payload in chunks])
+    values = _decode_varints(data)
+    line_ends = np.cumsum([payload.size for _, payload in chunks])
+    terminators = np.concatenate(([0], np.cumsum(data < 0x80)))
+    line_varints = np.diff(np.concatenate(([0], terminators[line_ends])))
+    line_samples = line_varints // 4
+    if np.any(line_varints % 4):
+        raise ValueError("Capture DATA line does not hold whole records")
+
+    fields = values[:int(line_samples.sum()) * 4].reshape(-1, 4)
+    line_first = np.array([first for first, _ in chunks], dtype=np.int64)
+    line_start = np.concatenate(([0], np.cumsum(line_samples)[:-1]))
+    index = np.repeat(line_first - line_start, line_samples) + np.arange(fields.shape[0])
+    is_keyframe = (index % keyframe) == 0
+
+    def absolute(column: np.ndarray) -> np.ndarray:
+        # Keyframes are absolute and the rest are deltas: a running sum restarted at each keyframe
+        total = np.cumsum(column)
+        block = np.cumsum(is_keyframe) - 1
+        base = (total - column)[is_keyframe]
+        return total - base[block] if base.size else total
+
+    return {
+        'time_us': np.cumsum(fields[:, 0].astype(np.int64)),
+        'pos_steps': absolute(_unzigzag(fields[:, 1])),
+        'raw': absolute(_unzigzag(fields[:, 2])),
+        'torque_deci': absolute(_unzigzag(fields[:, 3])),
+        'steps_per_mm': steps_per_mm,
+        'keyframe': keyframe,
+        'start_us': start_us,
+    }
+
+
+def decode_curve_lines(lines: Iterable[str]) -> Dict[str, Any]:
+    """
+    Decodes the lines of one dump_curve (HEADER and DATA lines, any other lines ignored).
+
+    Args:
+        lines: Message lines as received; a PRESSBOI_ prefix or request ID is not expected
+
+    Returns:
+        Dictionary with numpy arrays positions (mm from home) and forces (kg), plus
+        start_mm, step_mm (negative when the press moved towards home), dropped and
+        trigger (index of the first point of the press, -1 if none) from the HEADER line
+    """
+    header: Dict[str, str] = {}
+    chunks = []
+    for line in lines:
+        line = line.strip()
+        if not line.startswith(CURVE_PREFIX):
+            continue
+        body = line[len(CURVE_PREFIX):]
+        if body.startswith('HEADER:'):
+            for token in body[len('HEADER:'):].split():
+                key, _, value = token.partition('=')
+                header[key] = value
+        elif body.startswith('DATA:'):
+            _, first, payload = body.split(':', 2)
+            chunks.append((int(first), np.frombuffer(base64.b64decode(payload), dtype='<i2')))
+
+    if header.get('format', 'int16le') != 'int16le':
+        raise ValueError(f"Unsupported curve format: {header.get('format')}")
+    count = int(header.get('points', 0))
+    if chunks:
+        count = max(count, max(first + payload.size for first, payload in chunks))
+    # A lost line leaves its points NaN rather than shifting the rest along the grid
+    forces = np.full(count, np.nan)
+    for first, payload in chunks:
+        forces[first:first + payload.size] = payload / 10.0
+    start_mm = float(header.get('start_mm', 0.0))
+    step_mm = float(header.get('step_mm', 0.0))
+    return {
+        'positions': start_mm + step_mm * np.arange(count),
+        'forces': forces,
+        'start_mm': start_mm,
+        'step_mm': step_mm,
+        'dropped': int(header.get('dropped', 0)),
+        'trigger': int(header.get('trigger', -1)),
+    }
+
+
+def capture_to_press(capture: Dict[str, Any], kg_per_count: float, offset_kg: float = 0.0,
+                     steps_per_mm: Optional[float] = None, start_time: Optional[datetime] = None) -> Dict[str, Any]:
+    """
+    Converts a decoded capture to report data (the parse_csv_log() dictionary, as arrays).
+
+    Args:
+        capture: Result of decode_capture_lines()
+        kg_per_count: Load cell scale (force_scale from dump_nvm)
+        offset_kg: Load cell offset (force_offset from dump_nvm)
+        steps_per_mm: Overrides the HEADER value
+        start_time: When the press started, if known
+
+    Returns:
+        Dictionary with times, positions, forces and energies as numpy arrays
+    """
+    steps_per_mm = steps_per_mm or capture['steps_per_mm']
+    if not steps_per_mm:
+        raise ValueError("steps_per_mm unknown: no capture HEADER line and no override")
+    times = capture['time_us'] / 1.0e6
+    positions = capture['pos_steps'] / float(steps_per_mm)
+    forces = capture['raw'] * float(kg_per_count) + float(offset_kg)
+    return {
+        'times': times,
+        'positions': positions,
+        'forces': forces,
+        'energies': integrate_energy(positions, forces),
+        'start_time': start_time,
+        'end_time': None,
+        'has_energy_data': False,
+        'detected_force_mode': 'Load Cell',
+    }
+
+
+class CurveFileWriter:
+    """
+    Streams presses into a curve file; the index and header are written by close().
+
+    Usage:
+        with CurveFileWriter('shift.pbc') as writer:
+            writer.add_press(data)
+    """
+
+    def __init__(self, path: Union[str, Path]):
+        self.path = Path(path)
+        self._file = open(self.path, 'wb')
+        self._file.write(b'\0' * HEADER_STRUCT.size)
+        self._index: List[tuple] = []
+        self._records = 0
+
+    def add_press(self, data: Dict[str, Any], flags: Optional[int] = None) -> int:
+        """
+        Appends one press.
+
+        Args:
+            data: parse_csv_log() / capture_to_press() dictionary (lists or arrays)
+            flags: CURVE_FLAG_* bits; derived from data when None
+
+        Returns:
+            Index of the press in the file
+        """
+        count = min(len(data['times']), len(data['positions']), len(data['forces']))
+        records = np.zeros(count, dtype=RECORD_DTYPE)
+        records['time_s'] = np.asarray(data['times'][:count], dtype=np.float64)
+        records['position_mm'] = np.asarray(data['positions'][:count], dtype=np.float64)
+        records['force_kg'] = np.asarray(data['forces'][:count], dtype=np.float64)
+        energies = data.get('energies')
+        if energies is not None and len(energies) >= count and count > 0:
+            records['energy_j'] = np.asarray(energies[:count], dtype=np.float64)
+        else:
+            records['energy_j'] = integrate_energy(records['position_mm'], records['force_kg'])
+        if flags is None:
+            flags = CURVE_FLAG_ENERGY if data.get('has_energy_data') else 0
+            if data.get('detected_force_mode') == 'Motor Torque':
+                flags |= CURVE_FLAG_MOTOR_TORQUE
+        start = data.get('start_time')
+        self._file.write(records.tobytes())
+        self._index.append((self._records, count, flags, start.timestamp() if start else 0.0))
+        self._records += count
+        return len(self._index) - 1
+
+    def close(self) -> None:
+        if self._file.closed:
+            return
+        index_offset = HEADER_STRUCT.size + self._records * RECORD_DTYPE.itemsize
+        self._file.write(np.array(self._index, dtype=INDEX_DTYPE).tobytes())
+        self._file.seek(0)
+        self._file.write(HEADER_STRUCT.pack(CURVE_MAGIC, CURVE_VERSION, RECORD_DTYPE.itemsize,
+                                            len(self._index), index_offset))
+        self._file.close()
+
+    def __enter__(self) -> 'CurveFileWriter':
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+
+def load_curve_file(path: Union[str, Path]) -> List[Dict[str, Any]]:
+    """
+    Memory-maps a curve file.
+
+    Args:
+        path: Curve file (.pbc)
+
+    Returns:
+        One parse_csv_log()-shaped dictionary per press; times, positions, forces and
+        energies are read-only numpy views of the file
+    """
+    path = Path(path)
+    with open(path, 'rb') as f:
+        header = f.read(HEADER_STRUCT.size)
+    if len(header) < HEADER_STRUCT.size:
+        raise ValueError(f"Not a press curve file (too short): {path}")
+    magic, version, record_size, press_count, index_offset = HEADER_STRUCT.unpack(header)
+    if magic == b'\0' * 4:
+        raise ValueError(f"Press curve file is incomplete (writer not closed?): {path}")
+    if magic != CURVE_MAGIC or version != CURVE_VERSION or record_size != RECORD_DTYPE.itemsize:
+        raise ValueError(f"Not a version {CURVE_VERSION} press curve file: {path}")
+    if index_offset + press_count * INDEX_DTYPE.itemsize > path.stat().st_size:
+        raise ValueError(f"Press curve file is truncated: {path}")
+    if press_count == 0:
+        return []
+
+    record_count = (index_offset - HEADER_STRUCT.size) // RECORD_DTYPE.itemsize
+    if record_count > 0:
+        records = np.memmap(path, dtype=RECORD_DTYPE, mode='r', offset=HEADER_STRUCT.size, shape=(record_count,))
+    else:
+        records = np.zeros(0, dtype=RECORD_DTYPE)
+    index = np.fromfile(str(path), dtype=INDEX_DTYPE, count=press_count, offset=index_offset)
+
+    presses = []
+    for first, count, flags, start_epoch in index.tolist():
+        press = records[first:first + count]
+        start_time = datetime.fromtimestamp(start_epoch) if start_epoch else None
+        presses.append({
+            'times': press['time_s'],
+            'positions': press['position_mm'],
+            'forces': press['force_kg'],
+            'energies': press['energy_j'],
+            'start_time': start_time,
+            'end_time': None,
+            'has_energy_data': bool(flags & CURVE_FLAG_ENERGY),
+            'detected_force_mode': 'Motor Torque' if flags & CURVE_FLAG_MOTOR_TORQUE else 'Load Cell',
+        })
+    return presses
@@ -2,17 +2,19 @@
 Press Report Generator
 
 Generates beautiful interactive HTML reports for press operations using Plotly.
-Analyzes CSV log data and produces comprehensive reports with pass/fail determination.
+Analyzes CSV log data or binary press curve files (press_curves.py) and produces
+comprehensive reports with pass/fail determination.
 """
 
 import csv
 import json
+import multiprocessing
 import os
 import sys
 import time
 from datetime import datetime
 from pathlib import Path
-from typing import Dict, List, Optional, Any, Tuple
+from typing import Dict, Iterable, List, Optional, Any, Tuple, Union
 
 # Try to import jinja2, provide helpful error if not available
 try:
@@ -23,6 +25,98 @@ except ImportError:
         "Install it with: pip install jinja2"
     )
 
+try:
+    import numpy as np
+except ImportError:
+    raise ImportError(
+        "NumPy is required for report generation. "
+        "Install it with: pip install numpy"
+    )
+
+try:
+    from .press_curves import CURVE_FILE_SUFFIX, decimate_min_max, integrate_energy, load_curve_file
+except ImportError:
+    # Run as a script (CLI below)
+    from press_curves import CURVE_FILE_SUFFIX, decimate_min_max, integrate_energy, load_curve_file
+
+try:
+    from .telemetry_log import TELEMETRY_LOG_SUFFIX, TelemetryLog
+except ImportError:
+    from telemetry_log import TELEMETRY_LOG_SUFFIX, TelemetryLog
+
+try:
+    from .press_spc import BASELINE_PARTS, PressSpc
+except ImportError:
+    from press_spc import BASELINE_PARTS, PressSpc
+
+# Pixel columns the report chart is decimated to (at most two points per column); 0 = every sample
+REPORT_CHART_COLUMNS = 1000
+
+# Pre-rendered chart size (SVG user units) and plot margins, matching the Plotly layout
+SVG_WIDTH = 960
+SVG_HEIGHT = 450
+SVG_MARGIN = {'t': 20, 'r': 20, 'b': 60, 'l': 60}
+
+
+def render_curve_svg(positions: List[float], forces: List[float]) -> str:
+    """
+    Render a force curve as a static inline SVG for viewers without JavaScript (PDF converters,
+    print previews, offline viewers without the Plotly CDN). Pass already decimated points.
+    
+    Args:
+        positions: Positions in mm
+        forces: Forces in kg
+        
+    Returns:
+        SVG markup, or an empty string with fewer than two points
+    """
+    if len(positions) < 2:
+        return ''
+    left, top = SVG_MARGIN['l'], SVG_MARGIN['t']
+    plot_w = SVG_WIDTH - SVG_MARGIN['l'] - SVG_MARGIN['r']
+    plot_h = SVG_HEIGHT - SVG_MARGIN['t'] - SVG_MARGIN['b']
+    x_min, x_max = min(positions), max(positions)
+    y_min, y_max = min(0.0, min(forces)), max(forces) * 1.05
+    x_span = (x_max - x_min) or 1.0
+    y_span = (y_max - y_min) or 1.0
+    
+    def px(x):
+        return left + (x - x_min) / x_span * plot_w
+    
+    def py(y):
+        return top + plot_h - (y - y_min) / y_span * plot_h
+    
+    points = ' '.join(f"{px(x):.1f},{py(y):.1f}" for x, y in zip(positions, forces))
+    base = py(max(y_min, 0.0))
+    parts = [
+        f'<svg class="static-chart" xmlns="http://www.w3.org/2000/svg" viewBox="0 0 {SVG_WIDTH} {SVG_HEIGHT}" '
+        f'role="img" aria-label="Force vs position">',
+        f'<g stroke="#27272a" stroke-width="1">'
+    ]
+    for i in range(5):
+        gx = left + plot_w * i / 4
+        gy = top + plot_h * i / 4
+        parts.append(f'<line x1="{gx:.1f}" y1="{top}" x2="{gx:.1f}" y2="{top + plot_h}"/>')
+        parts.append(f'<line x1="{left}" y1="{gy:.1f}" x2="{left + plot_w}" y2="{gy:.1f}"/>')
+    parts.append('</g><g fill="#a1a1aa" font-family="Inter, sans-serif" font-size="11">')
+    for i in range(5):
+        gx = left + plot_w * i / 4
+        gy = top + plot_h * i / 4
+        parts.append(f'<text x="{gx:.1f}" y="{top + plot_h + 18}" text-anchor="middle">'
+                     f'{x_min + x_span * i / 4:.2f}</text>')
+        parts.append(f'<text x="{left - 8}" y="{gy + 4:.1f}" text-anchor="end">'
+                     f'{y_max - y_span * i / 4:.1f}</text>')
+    parts.append(f'<text x="{left + plot_w / 2:.1f}" y="{SVG_HEIGHT - 12}" text-anchor="middle" '
+                 f'font-size="13">Position (mm)</text>')
+    parts.append(f'<text transform="translate(16 {top + plot_h / 2:.1f}) rotate(-90)" text-anchor="middle" '
+                 f'font-size="13">Force (kg)</text></g>')
+    parts.append(f'<polygon fill="rgba(168, 85, 247, 0.15)" '
+                 f'points="{px(positions[0]):.1f},{base:.1f} {points} {px(positions[-1]):.1f},{base:.1f}"/>')
+    parts.append(f'<polyline fill="none" stroke="#22d3ee" stroke-width="2.5" points="{points}"/>')
+    parts.append('</svg>')
+    return ''.join(parts)
+
+
 class PressReportGenerator:
     """
     Generates HTML press operation reports from CSV log data.
@@ -53,6 +147,7 @@ class PressReportGenerator:
             loader=FileSystemLoader(str(self.template_dir)),
             autoescape=select_autoescape(['html', 'xml'])
         )
+        self._template = None
         
         # Load report definition
         definition_path = Path(__file__).parent / 'press_report.json'
@@ -62,6 +157,13 @@ class PressReportGenerator:
         else:
             self.definition = {}
     
+    @property
+    def template(self):
+        """The report template, compiled on first use and then reused for every report."""
+        if self._template is None:
+            self._template = self.env.get_template('press_report.html')
+        return self._template
+    
     def parse_csv_log(self, csv_path: str) -> Dict[str, Any]:
         """
         Parse a CSV log file and extract relevant data.
@@ -244,6 +346,47 @@ class PressReportGenerator:
             'detected_force_mode': detected_force_mode
         }
     
+    def load_curve_file(self, curve_path: str) -> List[Dict[str, Any]]:
+        """
+        Memory-map a binary press curve file (.pbc, see press_curves.py).
+        
+        Args:
+            curve_path: Path to the curve file
+            
+        Returns:
+            One dictionary per press, shaped like parse_csv_log() output with numpy
+            arrays in place of lists
+        """
+        return load_curve_file(curve_path)
+    
+    def fit_strain_polynomial(self, positions: np.ndarray, forces: np.ndarray,
+                              press_threshold: Optional[float] = None) -> Optional[Tuple[float, List[float]]]:
+        """
+        Fit the 4th order machine strain polynomial (force over deflection from contact).
+        
+        Only samples from the first one at or above the press threshold (default 5 kg) are
+        fitted, so noisy low-force data cannot pull the curve negative at the start.
+        
+        Args:
+            positions: Positions in mm, every sample of the press range
+            forces: Forces in kg
+            press_threshold: Contact force in kg
+            
+        Returns:
+            (contact position, [c0, c1, c2, c3, c4]), or None with too few samples to fit
+        """
+        threshold = press_threshold if press_threshold is not None else 5
+        above = forces >= threshold
+        fit_start = int(np.argmax(above)) if above.any() else 0
+        deflections = positions[fit_start:] - positions[fit_start]
+        if deflections.size < 5 or np.ptp(deflections) == 0:
+            return None
+        try:
+            coeffs = np.polyfit(deflections, forces[fit_start:], 4)
+        except (np.linalg.LinAlgError, ValueError):
+            return None
+        return (float(positions[fit_start]), [float(c) for c in coeffs[::-1]])
+    
     def calculate_metrics(self, data: Dict[str, Any], 
                           force_min: Optional[float] = None,
                           force_max: Optional[float] = None,
@@ -255,7 +398,7 @@ class PressReportGenerator:
         Calculate metrics from parsed log data.
         
         Args:
-            data: Parsed CSV data from parse_csv_log()
+            data: Parsed data from parse_csv_log() or load_curve_file() (lists or arrays)
             force_min: Minimum force threshold for pass
             force_max: Maximum force threshold for pass
             endpoint_min: Minimum endpoint threshold for pass
@@ -266,12 +409,12 @@ class PressReportGenerator:
         Returns:
             Dictionary of calculated metrics
         """
-        positions = data['positions']
-        forces = data['forces']
+        positions = np.asarray(data['positions'], dtype=np.float64)
+        forces = np.asarray(data['forces'], dtype=np.float64)
         energies = data['energies']
-        times = data['times']
+        times = np.asarray(data['times'], dtype=np.float64)
         
-        if not positions or not forces:
+        if positions.size == 0 or forces.size == 0:
             return {
                 'peak_force': 0,
                 'peak_force_position': 0,
@@ -282,28 +425,66 @@ class PressReportGenerator:
                 'data_points': 0
             }
         
-        # Find peak force and its position
-        peak_force = max(forces)
-        peak_idx = forces.index(peak_force)
-        peak_force_position = positions[peak_idx]
+        # Find peak force and its position (first occurrence)
+        peak_idx = int(np.argmax(forces))
+        peak_force = float(forces[peak_idx])
+        peak_force_position = float(positions[peak_idx])
         
         # Start and end positions
-        start_position = positions[0]
-        endpoint = positions[-1]
+        start_position = float(positions[0])
+        endpoint = float(positions[-1])
         
-        # Energy (use logged value if available, otherwise calculate)
-        if energies:
-            energy = energies[-1]  # Final accumulated energy
+        # Energy (use logged value if available, otherwise integrate force over distance)
+        if len(energies) > 0:
+            energy = float(energies[-1])  # Final accumulated energy
         else:
-            # Calculate energy as integral of force over distance (simplified)
-            energy = 0.0
-            for i in range(1, len(positions)):
-                dx = abs(positions[i] - positions[i-1]) / 1000.0  # mm to m
-                avg_force = (forces[i] + forces[i-1]) / 2 * 9.81  # kg to N
-                energy += avg_force * dx
+            count = min(positions.size, forces.size)
+            energy = float(integrate_energy(positions[:count], forces[:count])[-1])
         
         # Duration
-        duration = times[-1] - times[0] if times else 0
+        duration = float(times[-1] - times[0]) if times.size else 0
+        
+        summary = {
+            'peak_force': peak_force,
+            'peak_force_position': peak_force_position,
+            'start_position': start_position,
+            'endpoint': endpoint,
+            'energy': energy,
+            'duration': duration,
+            'data_points': int(positions.size)
+        }
+        return self.apply_thresholds(
+            summary,
+            force_min=force_min,
+            force_max=force_max,
+            endpoint_min=endpoint_min,
+            endpoint_max=endpoint_max,
+            energy_min=energy_min,
+            energy_max=energy_max
+        )
+    
+    def apply_thresholds(self, summary: Dict[str, Any],
+                         force_min: Optional[float] = None,
+                         force_max: Optional[float] = None,
+                         endpoint_min: Optional[float] = None,
+                         endpoint_max: Optional[float] = None,
+                         energy_min: Optional[float] = None,
+                         energy_max: Optional[float] = None) -> Dict[str, Any]:
+        """
+        Add pass/fail results and the energy bar scaling to a press summary.
+        
+        Args:
+            summary: peak_force, peak_force_position, start_position, endpoint, energy,
+                     duration and data_points, from calculate_metrics() or a PressStream
+            force_min/max, endpoint_min/max, energy_min/max: Thresholds for pass/fail
+            
+        Returns:
+            Dictionary of calculated metrics, as calculate_metrics() returns
+        """
+        peak_force = summary['peak_force']
+        endpoint = summary['endpoint']
+        energy = summary['energy']
+        duration = summary['duration']
         
         # Pass/fail calculations
         peak_force_pass = None
@@ -379,24 +560,19 @@ class PressReportGenerator:
         elif energy > 0:
             energy_percent = 50  # If no max, show as middle
         
-        return {
-            'peak_force': peak_force,
-            'peak_force_position': peak_force_position,
+        metrics = dict(summary)
+        metrics.update({
             'peak_force_pass': peak_force_pass,
-            'start_position': start_position,
-            'endpoint': endpoint,
             'endpoint_pass': endpoint_pass,
-            'energy': energy,
             'energy_pass': energy_pass,
             'energy_percent': energy_percent,
             'energy_min_percent': energy_min_percent,
             'energy_max_percent': energy_max_percent,
-            'duration': duration,
             'duration_str': f"{duration:.2f}s",
-            'data_points': len(positions),
             'overall_pass': overall_pass,
             'pass_fail_reason': pass_fail_reason
-        }
+        })
+        return metrics
     
     def generate_report(self,
                         csv_path: str,
@@ -417,12 +593,14 @@ class PressReportGenerator:
                         energy_max: Optional[float] = None,
                         press_startpoint: Optional[float] = None,
                         press_threshold: Optional[float] = None,
-                        telemetry_endpoint: Optional[float] = None) -> Tuple[bool, str, Optional[str]]:
+                        telemetry_endpoint: Optional[float] = None,
+                        press_index: int = -1,
+                        chart_columns: int = REPORT_CHART_COLUMNS) -> Tuple[bool, str, Optional[str]]:
         """
-        Generate a complete HTML report from a CSV log file.
+        Generate a complete HTML report from a CSV log file or one press of a curve file.
         
         Args:
-            csv_path: Path to the CSV log file
+            csv_path: Path to the CSV log file, a .pbc press curve file or a .pbt telemetry log
             output_path: Output path for the HTML report (auto-generated if None)
             serial_number: Serial number for the report
             device_name: Name of the device
@@ -435,195 +613,59 @@ class PressReportGenerator:
             force_min/max: Force thresholds for pass/fail
             endpoint_min/max: Endpoint thresholds for pass/fail
             energy_min/max: Energy thresholds for pass/fail
+            press_index: Press to report from a curve file or from a telemetry log that
+                         marks presses (default: the last one)
+            chart_columns: Pixel columns the chart is decimated to (0 = every sample);
+                           the metrics always use every sample
             
         Returns:
             Tuple of (success: bool, message: str, output_path: Optional[str])
         """
         try:
-            # Parse CSV data
-            data = self.parse_csv_log(csv_path)
+            # Parse CSV data, or map the chosen press of a curve file
+            if Path(csv_path).suffix.lower() == CURVE_FILE_SUFFIX:
+                presses = self.load_curve_file(csv_path)
+                if not presses:
+                    return (False, "No presses found in curve file", None)
+                data = presses[press_index]
+            elif Path(csv_path).suffix.lower() == TELEMETRY_LOG_SUFFIX:
+                log = TelemetryLog(csv_path)
+                # One press when the log marks them, otherwise the whole log
+                data = log.press_data(press_index) if log.presses() else log.to_report_data()
+            else:
+                data = self.parse_csv_log(csv_path)
             
-            if not data['positions']:
+            if len(data['positions']) == 0:
                 return (False, "No valid data found in CSV file", None)
             
-            # Calculate metrics
-            metrics = self.calculate_metrics(
+            # Generate output path if not provided
+            if output_path is None:
+                csv_name = Path(csv_path).stem
+                output_path = str(Path(csv_path).parent / f"{csv_name}_report.html")
+            
+            return self.render_report(
                 data,
+                output_path,
+                serial_number=serial_number,
+                device_name=device_name,
+                firmware_version=firmware_version,
+                force_mode=force_mode,
+                app_version=app_version,
+                job_number=job_number,
+                op_number=op_number,
+                title=title,
                 force_min=force_min,
                 force_max=force_max,
                 endpoint_min=endpoint_min,
                 endpoint_max=endpoint_max,
                 energy_min=energy_min,
-                energy_max=energy_max
+                energy_max=energy_max,
+                press_startpoint=press_startpoint,
+                press_threshold=press_threshold,
+                telemetry_endpoint=telemetry_endpoint,
+                chart_columns=chart_columns
             )
             
-            # Find the press range: from startpoint to endpoint (farthest position)
-            # If startpoint is provided, filter data from that point onwards
-            positions = data['positions']
-            forces = data['forces']
-            times = data['times']
-            energies = data['energies']
-            
-            # Find peak force index
-            peak_force = max(forces) if forces else 0
-            peak_idx = forces.index(peak_force) if forces else 0
-            
-            # Find endpoint index (farthest position traveled)
-            max_position = max(positions) if positions else 0
-            endpoint_idx = positions.index(max_position) if positions else 0
-            
-            # Find startpoint index (where position crosses press_startpoint)
-            start_idx = 0
-            if press_startpoint is not None and press_startpoint > 0:
-                for i, pos in enumerate(positions):
-                    if pos >= press_startpoint:
-                        start_idx = i
-                        break
-            
-            # Clip data from startpoint to endpoint (farthest position reached)
-            end_idx = max(endpoint_idx + 1, start_idx + 1)  # Include endpoint
-            
-            chart_positions = positions[start_idx:end_idx]
-            chart_forces = forces[start_idx:end_idx]
-            chart_times = times[start_idx:end_idx]
-            chart_energies = energies[start_idx:end_idx] if energies else []
-            
-            # Prepare chart data as JSON
-            chart_data = json.dumps({
-                'positions': chart_positions,
-                'forces': chart_forces,
-                'times': chart_times,
-                'energies': chart_energies,
-                'full_positions': positions,
-                'full_forces': forces
-            })
-            
-            # Prepare raw data for table
-            raw_data = []
-            for i in range(len(data['positions'])):
-                row = {
-                    'time': data['times'][i],
-                    'position': data['positions'][i],
-                    'force': data['forces'][i],
-                    'energy': data['energies'][i] if i < len(data['energies']) else 0
-                }
-                raw_data.append(row)
-            
-            # Prepare template context
-            now = datetime.now()
-            # Use detected force mode if not provided
-            effective_force_mode = force_mode
-            if force_mode in ('Unknown', 'N/A', None) and data.get('detected_force_mode'):
-                effective_force_mode = data['detected_force_mode']
-            
-            # Use telemetry endpoint if available, and recalculate pass/fail
-            print(f"[REPORT DEBUG] telemetry_endpoint={telemetry_endpoint}, metrics['endpoint']={metrics['endpoint']}")
-            final_endpoint = telemetry_endpoint if telemetry_endpoint is not None else metrics['endpoint']
-            print(f"[REPORT DEBUG] final_endpoint={final_endpoint}")
-            final_endpoint_pass = None
-            if endpoint_min is not None or endpoint_max is not None:
-                final_endpoint_pass = True
-                if endpoint_min is not None and final_endpoint < endpoint_min:
-                    final_endpoint_pass = False
-                if endpoint_max is not None and final_endpoint > endpoint_max:
-                    final_endpoint_pass = False
-            
-            # Recalculate overall pass with corrected endpoint
-            overall_pass = metrics['overall_pass']
-            pass_fail_reason = metrics['pass_fail_reason']
-            if final_endpoint_pass is not None and final_endpoint_pass != metrics['endpoint_pass']:
-                # Endpoint pass/fail changed, recalculate overall
-                checks = [
-                    (metrics['peak_force_pass'], "force"),
-                    (final_endpoint_pass, "endpoint"),
-                    (metrics['energy_pass'], "energy")
-                ]
-                defined_checks = [(p, n) for p, n in checks if p is not None]
-                if defined_checks:
-                    failed = [n for p, n in defined_checks if not p]
-                    if failed:
-                        overall_pass = False
-                        pass_fail_reason = f"Failed: {', '.join(failed)}"
-                    else:
-                        overall_pass = True
-                        pass_fail_reason = "All checks passed"
-            
-            context = {
-                'title': title,
-                'serial_number': serial_number,
-                'device_name': device_name,
-                'firmware_version': firmware_version,
-                'force_mode': effective_force_mode or 'N/A',
-                'app_version': app_version,
-                'job_number': job_number,
-                'op_number': op_number,
-                'date': data['start_time'].strftime("%Y-%m-%d") if data['start_time'] else now.strftime("%Y-%m-%d"),
-                'time': data['start_time'].strftime("%H:%M:%S") if data['start_time'] else now.strftime("%H:%M:%S"),
-                'duration': metrics['duration_str'],
-                'generation_timestamp': now.strftime("%Y-%m-%d %H:%M:%S"),
-                
-                # Metrics
-                'peak_force': metrics['peak_force'],
-                'peak_force_pass': metrics['peak_force_pass'],
-                'start_position': metrics['start_position'],
-                # Use telemetry endpoint if available (more accurate than CSV last position)
-                'endpoint': final_endpoint,
-                'endpoint_pass': final_endpoint_pass,
-                'energy': metrics['energy'],
-                'energy_pass': metrics['energy_pass'],
-                'energy_percent': metrics['energy_percent'],
-                'energy_min_percent': metrics['energy_min_percent'],
-                'energy_max_percent': metrics['energy_max_percent'],
-                'overall_pass': overall_pass,
-                'pass_fail_reason': pass_fail_reason,
-                'data_points': metrics['data_points'],
-                
-                # Thresholds
-                'force_min': force_min,
-                'force_max': force_max,
-                'endpoint_min': endpoint_min,
-                'endpoint_max': endpoint_max,
-                'energy_min': energy_min,
-                'energy_max': energy_max,
-                
-                # Press startpoint and threshold
-                'press_startpoint': press_startpoint,
-                'press_threshold': press_threshold,
-                
-                # Chart data
-                'chart_data': chart_data,
-                
-                # Raw data
-                'raw_data': raw_data,
-                'has_energy_data': data['has_energy_data']
-            }
-            
-            # Render template
-            template = self.env.get_template('press_report.html')
-            html_content = template.render(**context)
-            
-            # Generate output path if not provided
-            if output_path is None:
-                csv_name = Path(csv_path).stem
-                output_path = str(Path(csv_path).parent / f"{csv_name}_report.html")
-            
-            # Write output
-            try:
-                # Ensure output directory exists
-                output_dir = Path(output_path).parent
-                output_dir.mkdir(parents=True, exist_ok=True)
-                
-                with open(output_path, 'w', encoding='utf-8') as f:
-                    f.write(html_content)
-            except FileNotFoundError as e:
-                return (False, f"Cannot write report - output path not found: {output_path} - {e}", None)
-            except PermissionError as e:
-                return (False, f"Cannot write report - permission denied: {output_path} - {e}", None)
-            except OSError as e:
-                return (False, f"Cannot write report - OS error: {output_path} - {e}", None)
-            
-            return (True, f"Report generated successfully: {output_path}", output_path)
-            
         except FileNotFoundError as e:
             return (False, f"CSV file not found: {csv_path} - {e}", None)
         except PermissionError as e:
@@ -634,6 +676,299 @@ class PressReportGenerator:
             import traceback
             traceback.print_exc()
             return (False, f"Error generating report: {str(e)}", None)
+    
+    def render_report(self,
+                      data: Dict[str, Any],
+                      output_path: str,
+                      metrics: Optional[Dict[str, Any]] = None,
+                      serial_number: str = "N/A",
+                      device_name: str = "Pressboi",
+                      firmware_version: str = "Unknown",
+                      force_mode: str = "Unknown",
+                      app_version: str = "Unknown",
+                      job_number: str = "N/A",
+                      op_number: str = "N/A",
+                      title: str = "Press Operation Report",
+                      force_min: Optional[float] = None,
+                      force_max: Optional[float] = None,
+                      endpoint_min: Optional[float] = None,
+                      endpoint_max: Optional[float] = None,
+                      energy_min: Optional[float] = None,
+                      energy_max: Optional[float] = None,
+                      press_startpoint: Optional[float] = None,
+                      press_threshold: Optional[float] = None,
+                      telemetry_endpoint: Optional[float] = None,
+                      chart_columns: int = REPORT_CHART_COLUMNS) -> Tuple[bool, str, Optional[str]]:
+        """
+        Render and write the HTML report for press data that is already in memory.
+        
+        Args:
+            data: Press data shaped like parse_csv_log() output (lists or arrays)
+            output_path: Output path for the HTML report
+            metrics: Precomputed calculate_metrics() result (computed from data if None)
+            Other arguments as for generate_report()
+            
+        Returns:
+            Tuple of (success: bool, message: str, output_path: Optional[str])
+        """
+        # Calculate metrics, unless the caller accumulated them while the press ran
+        if metrics is None:
+            metrics = self.calculate_metrics(
+                data,
+                force_min=force_min,
+                force_max=force_max,
+                endpoint_min=endpoint_min,
+                endpoint_max=endpoint_max,
+                energy_min=energy_min,
+                energy_max=energy_max
+            )
+        
+        # Find the press range: from startpoint to endpoint (farthest position)
+        # If startpoint is provided, filter data from that point onwards
+        positions = np.asarray(data['positions'], dtype=np.float64)
+        forces = np.asarray(data['forces'], dtype=np.float64)
+        times = np.asarray(data['times'], dtype=np.float64)
+        energies = np.asarray(data['energies'], dtype=np.float64)
+        
+        # Find endpoint index (farthest position traveled)
+        endpoint_idx = int(np.argmax(positions))
+        
+        # Find startpoint index (where position crosses press_startpoint)
+        start_idx = 0
+        if press_startpoint is not None and press_startpoint > 0:
+            crossed = positions >= press_startpoint
+            if crossed.any():
+                start_idx = int(np.argmax(crossed))
+        
+        # Clip data from startpoint to endpoint (farthest position reached)
+        end_idx = max(endpoint_idx + 1, start_idx + 1)  # Include endpoint
+        
+        chart_positions = positions[start_idx:end_idx]
+        chart_forces = forces[start_idx:end_idx]
+        chart_times = times[start_idx:end_idx]
+        chart_energies = energies[start_idx:end_idx]
+        
+        # The strain fit uses every sample; only what is drawn is decimated
+        poly_fit = self.fit_strain_polynomial(chart_positions, chart_forces, press_threshold)
+        
+        # Decimate the drawn curves to a bounded number of points (min/max per pixel column)
+        pick = decimate_min_max(chart_forces, chart_columns)
+        full_pick = decimate_min_max(forces, chart_columns)
+        
+        def rounded(values, digits):
+            return np.round(values, digits).tolist()
+        
+        # Prepare chart data as JSON
+        chart_data = {
+            'positions': rounded(chart_positions[pick], 4),
+            'forces': rounded(chart_forces[pick], 3),
+            'times': rounded(chart_times[pick[pick < chart_times.size]], 4),
+            'energies': rounded(chart_energies[pick[pick < chart_energies.size]], 5),
+            'full_positions': rounded(positions[full_pick], 4),
+            'full_forces': rounded(forces[full_pick], 3)
+        }
+        if poly_fit is not None:
+            chart_data['poly_start'], chart_data['poly_coeffs'] = poly_fit
+        chart_svg = render_curve_svg(chart_data['positions'], chart_data['forces'])
+        chart_points = len(chart_data['full_positions'])
+        chart_data = json.dumps(chart_data)
+        
+        # Prepare template context
+        now = datetime.now()
+        # Use detected force mode if not provided
+        effective_force_mode = force_mode
+        if force_mode in ('Unknown', 'N/A', None) and data.get('detected_force_mode'):
+            effective_force_mode = data['detected_force_mode']
+        
+        # Use telemetry endpoint if available, and recalculate pass/fail
+        print(f"[REPORT DEBUG] telemetry_endpoint={telemetry_endpoint}, metrics['endpoint']={metrics['endpoint']}")
+        final_endpoint = telemetry_endpoint if telemetry_endpoint is not None else metrics['endpoint']
+        print(f"[REPORT DEBUG] final_endpoint={final_endpoint}")
+        final_endpoint_pass = None
+        if endpoint_min is not None or endpoint_max is not None:
+            final_endpoint_pass = True
+            if endpoint_min is not None and final_endpoint < endpoint_min:
+                final_endpoint_pass = False
+            if endpoint_max is not None and final_endpoint > endpoint_max:
+                final_endpoint_pass = False
+        
+        # Recalculate overall pass with corrected endpoint
+        overall_pass = metrics['overall_pass']
+        pass_fail_reason = metrics['pass_fail_reason']
+        if final_endpoint_pass is not None and final_endpoint_pass != metrics['endpoint_pass']:
+            # Endpoint pass/fail changed, recalculate overall
+            checks = [
+                (metrics['peak_force_pass'], "force"),
+                (final_endpoint_pass, "endpoint"),
+                (metrics['energy_pass'], "energy")
+            ]
+            defined_checks = [(p, n) for p, n in checks if p is not None]
+            if defined_checks:
+                failed = [n for p, n in defined_checks if not p]
+                if failed:
+                    overall_pass = False
+                    pass_fail_reason = f"Failed: {', '.join(failed)}"
+                else:
+                    overall_pass = True
+                    pass_fail_reason = "All checks passed"
+        
+        context = {
+            'title': title,
+            'serial_number': serial_number,
+            'device_name': device_name,
+            'firmware_version': firmware_version,
+            'force_mode': effective_force_mode or 'N/A',
+            'app_version': app_version,
+            'job_number': job_number,
+            'op_number': op_number,
+            'date': data['start_time'].strftime("%Y-%m-%d") if data['start_time'] else now.strftime("%Y-%m-%d"),
+            'time': data['start_time'].strftime("%H:%M:%S") if data['start_time'] else now.strftime("%H:%M:%S"),
+            'duration': metrics['duration_str'],
+            'generation_timestamp': now.strftime("%Y-%m-%d %H:%M:%S"),
+            
+            # Metrics
+            'peak_force': metrics['peak_force'],
+            'peak_force_pass': metrics['peak_force_pass'],
+            'start_position': metrics['start_position'],
+            # Use telemetry endpoint if available (more accurate than CSV last position)
+            'endpoint': final_endpoint,
+            'endpoint_pass': final_endpoint_pass,
+            'energy': metrics['energy'],
+            'energy_pass': metrics['energy_pass'],
+            'energy_percent': metrics['energy_percent'],
+            'energy_min_percent': metrics['energy_min_percent'],
+            'energy_max_percent': metrics['energy_max_percent'],
+            'overall_pass': overall_pass,
+            'pass_fail_reason': pass_fail_reason,
+            'data_points': metrics['data_points'],
+            
+            # Thresholds
+            'force_min': force_min,
+            'force_max': force_max,
+            'endpoint_min': endpoint_min,
+            'endpoint_max': endpoint_max,
+            'energy_min': energy_min,
+            'energy_max': energy_max,
+            
+            # Press startpoint and threshold
+            'press_startpoint': press_startpoint,
+            'press_threshold': press_threshold,
+            
+            # Chart data, and the same curve pre-rendered for viewers without JavaScript
+            'chart_data': chart_data,
+            'chart_svg': chart_svg,
+            'chart_points': chart_points,
+            'has_energy_data': data['has_energy_data']
+        }
+        
+        # Render template
+        html_content = self.template.render(**context)
+        
+        # Write output
+        try:
+            # Ensure output directory exists
+            output_dir = Path(output_path).parent
+            output_dir.mkdir(parents=True, exist_ok=True)
+            
+            with open(output_path, 'w', encoding='utf-8') as f:
+                f.write(html_content)
+        except FileNotFoundError as e:
+            return (False, f"Cannot write report - output path not found: {output_path} - {e}", None)
+        except PermissionError as e:
+            return (False, f"Cannot write report - permission denied: {output_path} - {e}", None)
+        except OSError as e:
+            return (False, f"Cannot write report - OS error: {output_path} - {e}", None)
+        
+        return (True, f"Report generated successfully: {output_path}", output_path)
+    
+    def generate_shift_summary(self,
+                               curve_path: str,
+                               output_path: Optional[str] = None,
+                               force_min: Optional[float] = None,
+                               force_max: Optional[float] = None,
+                               endpoint_min: Optional[float] = None,
+                               endpoint_max: Optional[float] = None,
+                               energy_min: Optional[float] = None,
+                               energy_max: Optional[float] = None,
+                               spc: Optional[PressSpc] = None,
+                               recipe: str = 'default') -> Tuple[bool, str, Optional[str]]:
+        """
+        Write a CSV summary with one row of metrics per press of a curve file.
+        
+        Args:
+            curve_path: Path to the .pbc press curve file (a shift of presses)
+            output_path: Output path for the CSV summary (auto-generated if None)
+            force_min/max, endpoint_min/max, energy_min/max: Thresholds for pass/fail
+            spc: Running SPC state every press is added to, under recipe
+            recipe: Recipe the presses ran
+            
+        Returns:
+            Tuple of (success: bool, message: str, output_path: Optional[str])
+        """
+        columns = ['press', 'date', 'time', 'peak_force', 'peak_force_position', 'start_position',
+                   'endpoint', 'energy', 'duration', 'data_points', 'overall_pass', 'pass_fail_reason']
+        try:
+            presses = self.load_curve_file(curve_path)
+            if output_path is None:
+                output_path = str(Path(curve_path).with_name(f"{Path(curve_path).stem}_summary.csv"))
+            Path(output_path).parent.mkdir(parents=True, exist_ok=True)
+            
+            passed = failed = 0
+            with open(output_path, 'w', newline='', encoding='utf-8') as f:
+                writer = csv.writer(f)
+                writer.writerow(columns)
+                for i, data in enumerate(presses):
+                    metrics = self.calculate_metrics(
+                        data,
+                        force_min=force_min,
+                        force_max=force_max,
+                        endpoint_min=endpoint_min,
+                        endpoint_max=endpoint_max,
+                        energy_min=energy_min,
+                        energy_max=energy_max
+                    )
+                    if spc is not None:
+                        spc.add(recipe, metrics, force_min=force_min, force_max=force_max,
+                                endpoint_min=endpoint_min, endpoint_max=endpoint_max,
+                                energy_min=energy_min, energy_max=energy_max)
+                    if metrics.get('overall_pass') is True:
+                        passed += 1
+                    elif metrics.get('overall_pass') is False:
+                        failed += 1
+                    start = data['start_time']
+                    writer.writerow([
+                        i,
+                        start.strftime("%Y-%m-%d") if start else '',
+                        start.strftime("%H:%M:%S") if start else '',
+                        f"{metrics['peak_force']:.3f}",
+                        f"{metrics['peak_force_position']:.3f}",
+                        f"{metrics['start_position']:.3f}",
+                        f"{metrics['endpoint']:.3f}",
+                        f"{metrics['energy']:.4f}",
+                        f"{metrics['duration']:.3f}",
+                        metrics['data_points'],
+                        '' if metrics.get('overall_pass') is None else int(metrics['overall_pass']),
+                        metrics.get('pass_fail_reason', '')
+                    ])
+        except (OSError, ValueError) as e:
+            return (False, f"Error generating shift summary: {curve_path} - {e}", None)
+        
+        return (True, f"Shift summary generated: {len(presses)} presses, {passed} passed, "
+                      f"{failed} failed: {output_path}", output_path)
+
+
+_shared_generator = None
+
+
+def get_generator() -> PressReportGenerator:
+    """
+    The generator shared by the module functions and PressStream, so the Jinja2
+    environment and the compiled template are built once per process, not per report.
+    """
+    global _shared_generator
+    if _shared_generator is None:
+        _shared_generator = PressReportGenerator()
+    return _shared_generator
 
 
 def generate_press_report(csv_path: str,
@@ -654,7 +989,9 @@ def generate_press_report(csv_path: str,
                           energy_max: Optional[float] = None,
                           press_startpoint: Optional[float] = None,
                           press_threshold: Optional[float] = None,
-                          telemetry_endpoint: Optional[float] = None) -> Tuple[bool, str, Optional[str]]:
+                          telemetry_endpoint: Optional[float] = None,
+                          press_index: int = -1,
+                          chart_columns: int = REPORT_CHART_COLUMNS) -> Tuple[bool, str, Optional[str]]:
     """
     Convenience function to generate a press report.
     
@@ -664,7 +1001,7 @@ def generate_press_report(csv_path: str,
     Returns:
         Tuple of (success: bool, message: str, output_path: Optional[str])
     """
-    generator = PressReportGenerator()
+    generator = get_generator()
     return generator.generate_report(
         csv_path=csv_path,
         output_path=output_path,
@@ -684,17 +1021,159 @@ def generate_press_report(csv_path: str,
         energy_max=energy_max,
         press_startpoint=press_startpoint,
         press_threshold=press_threshold,
-        telemetry_endpoint=telemetry_endpoint
+        telemetry_endpoint=telemetry_endpoint,
+        press_index=press_index,
+        chart_columns=chart_columns
     )
 
 
+def generate_shift_summary(curve_path: str,
+                           output_path: Optional[str] = None,
+                           force_min: Optional[float] = None,
+                           force_max: Optional[float] = None,
+                           endpoint_min: Optional[float] = None,
+                           endpoint_max: Optional[float] = None,
+                           energy_min: Optional[float] = None,
+                           energy_max: Optional[float] = None,
+                           spc: Optional[PressSpc] = None,
+                           recipe: str = 'default') -> Tuple[bool, str, Optional[str]]:
+    """
+    Convenience function to summarize every press of a curve file.
+    
+    See PressReportGenerator.generate_shift_summary() for full documentation.
+    
+    Returns:
+        Tuple of (success: bool, message: str, output_path: Optional[str])
+    """
+    generator = get_generator()
+    return generator.generate_shift_summary(
+        curve_path=curve_path,
+        output_path=output_path,
+        force_min=force_min,
+        force_max=force_max,
+        endpoint_min=endpoint_min,
+        endpoint_max=endpoint_max,
+        energy_min=energy_min,
+        energy_max=energy_max,
+        spc=spc,
+        recipe=recipe
+    )
+
+
+# Curve files and telemetry logs already mapped by this process, so the presses of one file
+# share one index read
+_batch_curves: Dict[str, List[Dict[str, Any]]] = {}
+_batch_logs: Dict[str, TelemetryLog] = {}
+
+
+def _init_batch_worker() -> None:
+    """Pool initializer: build the shared generator and compile the template once per worker."""
+    get_generator().template
+
+
+def _run_batch_job(job: Tuple[str, int, str, Dict[str, Any]]) -> Tuple[bool, str, Optional[str]]:
+    """Generate one report of a batch: (source path, press index or -1 for CSV, output path, args)."""
+    source, press_index, output_path, report_args = job
+    generator = get_generator()
+    if press_index < 0:
+        return generator.generate_report(csv_path=source, output_path=output_path, **report_args)
+    try:
+        if Path(source).suffix.lower() == TELEMETRY_LOG_SUFFIX:
+            log = _batch_logs.get(source)
+            if log is None:
+                log = _batch_logs[source] = TelemetryLog(source)
+            return generator.render_report(log.press_data(press_index), output_path, **report_args)
+        presses = _batch_curves.get(source)
+        if presses is None:
+            presses = _batch_curves[source] = generator.load_curve_file(source)
+        return generator.render_report(presses[press_index], output_path, **report_args)
+    except Exception as e:
+        return (False, f"Error generating report: {source} press {press_index} - {e}", None)
+
+
+def generate_press_reports(sources: Union[str, Path, Iterable[Union[str, Path]]],
+                           output_dir: Optional[str] = None,
+                           workers: Optional[int] = None,
+                           **report_args) -> List[Tuple[bool, str, Optional[str]]]:
+    """
+    Generate press reports for many parts, spread over a pool of worker processes.
+    
+    CSV logs give one report each, named like generate_press_report() names them. Curve
+    files (.pbc), and telemetry logs (.pbt) that mark presses, give one report per press,
+    <name>_press<N>_report.html; a log without presses gives one report. Each worker builds
+    one generator and compiles the template once, then reuses them for all its reports.
+    
+    Args:
+        sources: A directory (its .csv, .pbc and .pbt files) or a list of such paths
+        output_dir: Directory for the reports (default: next to each source)
+        workers: Worker processes (default: one per CPU; 1 generates in this process)
+        report_args: generate_press_report() arguments applied to every report
+                     (serial_number, title, thresholds, ...)
+        
+    Returns:
+        One (success: bool, message: str, output_path: Optional[str]) per report, in order
+    """
+    if isinstance(sources, (str, Path)) and Path(sources).is_dir():
+        paths = sorted(p for p in Path(sources).iterdir()
+                       if p.suffix.lower() in ('.csv', CURVE_FILE_SUFFIX, TELEMETRY_LOG_SUFFIX))
+    elif isinstance(sources, (str, Path)):
+        paths = [Path(sources)]
+    else:
+        paths = [Path(p) for p in sources]
+    for key in ('csv_path', 'output_path', 'press_index'):
+        report_args.pop(key, None)
+    
+    jobs = []
+    results = {}
+    for path in paths:
+        directory = Path(output_dir) if output_dir else path.parent
+        if path.suffix.lower() in (CURVE_FILE_SUFFIX, TELEMETRY_LOG_SUFFIX):
+            try:
+                if path.suffix.lower() == CURVE_FILE_SUFFIX:
+                    count = len(load_curve_file(path))
+                else:
+                    count = len(TelemetryLog(path).presses())
+            except (OSError, ValueError) as e:
+                results[len(jobs)] = (False, f"Cannot read press file: {path} - {e}", None)
+                jobs.append(None)
+                continue
+            if count == 0 and path.suffix.lower() == TELEMETRY_LOG_SUFFIX:
+                jobs.append((str(path), -1, str(directory / f"{path.stem}_report.html"), report_args))
+            for i in range(count):
+                jobs.append((str(path), i, str(directory / f"{path.stem}_press{i:04d}_report.html"), report_args))
+        else:
+            jobs.append((str(path), -1, str(directory / f"{path.stem}_report.html"), report_args))
+    
+    pending = [job for job in jobs if job is not None]
+    if workers is None:
+        workers = os.cpu_count() or 1
+    workers = max(1, min(workers, len(pending)))
+    if workers == 1:
+        done = [_run_batch_job(job) for job in pending]
+    else:
+        # Several reports per task, so a thousand small reports are not a thousand round trips
+        chunksize = max(1, len(pending) // (workers * 4))
+        with multiprocessing.Pool(workers, initializer=_init_batch_worker) as pool:
+            done = pool.map(_run_batch_job, pending, chunksize=chunksize)
+    
+    done_iter = iter(done)
+    return [results[i] if job is None else next(done_iter) for i, job in enumerate(jobs)]
+
+
 # CLI for testing
 if __name__ == '__main__':
     import argparse
     
     parser = argparse.ArgumentParser(description='Generate press operation report')
-    parser.add_argument('csv_file', help='Path to CSV log file')
-    parser.add_argument('-o', '--output', help='Output HTML file path')
+    parser.add_argument('csv_file', help='Path to CSV log file or .pbc press curve file')
+    parser.add_argument('-o', '--output', help='Output HTML file path (CSV with --shift, a directory with --batch)')
+    parser.add_argument('--shift', action='store_true', help='Summarize every press of a curve file as CSV')
+    parser.add_argument('--press', type=int, default=-1, help='Press of a curve file to report (default: last)')
+    parser.add_argument('--chart-columns', type=int, default=REPORT_CHART_COLUMNS,
+                        help='Chart resolution in pixel columns, 0 for every sample (default %d)' % REPORT_CHART_COLUMNS)
+    parser.add_argument('--batch', action='store_true',
+                        help='Report every CSV and curve file press in a directory (csv_file is the directory)')
+    parser.add_argument('-j', '--workers', type=int, help='Worker processes for --batch (default: one per CPU)')
     parser.add_argument('-s', '--serial', default='TEST-001', help='Serial number')
     parser.add_argument('--force-min', type=float, help='Minimum force threshold')
     parser.add_argument('--force-max', type=float, help='Maximum force threshold')
@@ -702,13 +1181,16 @@ if __name__ == '__main__':
     parser.add_argument('--endpoint-max', type=float, help='Maximum endpoint threshold')
     parser.add_argument('--energy-min', type=float, help='Minimum energy threshold')
     parser.add_argument('--energy-max', type=float, help='Maximum energy threshold')
+    parser.add_argument('--spc', help='SPC state file the --shift presses are added to')
+    parser.add_argument('--recipe', default='default', help='Recipe of the --shift presses in the SPC state')
+    parser.add_argument('--baseline', type=int, default=BASELINE_PARTS,
+                        help='Parts that set the SPC centre line and sigma of a new recipe (default: %(default)s)')
+    parser.add_argument('--rebaseline', action='store_true',
+                        help='Start a new SPC baseline for --recipe before adding the --shift presses')
     
     args = parser.parse_args()
     
-    success, message, output = generate_press_report(
-        csv_path=args.csv_file,
-        output_path=args.output,
-        serial_number=args.serial,
+    thresholds = dict(
         force_min=args.force_min,
         force_max=args.force_max,
         endpoint_min=args.endpoint_min,
@@ -716,6 +1198,33 @@ if __name__ == '__main__':
         energy_min=args.energy_min,
         energy_max=args.energy_max
     )
+    if args.batch:
+        results = generate_press_reports(args.csv_file, output_dir=args.output, workers=args.workers,
+                                         serial_number=args.serial, chart_columns=args.chart_columns,
+                                         **thresholds)
+        failures = [message for ok, message, _ in results if not ok]
+        for message in failures:
+            print(message)
+        print(f"Generated {len(results) - len(failures)} of {len(results)} reports")
+        sys.exit(0 if not failures else 1)
+    elif args.shift:
+        spc = PressSpc(args.spc, autosave=False, baseline_parts=args.baseline) if args.spc else None
+        if spc is not None and args.rebaseline:
+            spc.rebaseline(args.recipe)
+        success, message, output = generate_shift_summary(args.csv_file, args.output, spc=spc,
+                                                          recipe=args.recipe, **thresholds)
+        if spc is not None:
+            spc.save()
+            print('\n'.join(spc.format(args.recipe)))
+    else:
+        success, message, output = generate_press_report(
+            csv_path=args.csv_file,
+            output_path=args.output,
+            serial_number=args.serial,
+            press_index=args.press,
+            chart_columns=args.chart_columns,
+            **thresholds
+        )
     
     print(message)
     sys.exit(0 if success else 1)
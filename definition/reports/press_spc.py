@@ -0,0 +1,299 @@
+"""
+Press SPC
+
+Running statistical process control of the press metrics, per recipe: the peak force,
+endpoint and energy that generate_report() checks against its min/max thresholds. Each
+finished press updates the statistics in constant time (Welford's mean and variance, the
+EWMA chart value and its control limits), and the state is kept in a small JSON file, so
+a shift's Cp/Cpk and control chart are known as its last part comes off the press without
+reprocessing the day's logs.
+
+Capability is judged against the thresholds given with the latest part (Cp needs both,
+Cpk either), from the mean and standard deviation of every part.
+
+The EWMA chart runs in two phases. The first baseline_parts parts of a recipe (the
+baseline) only estimate the in-control mean and standard deviation; nothing is judged.
+When the baseline is full its mean and standard deviation are frozen as the centre line
+and sigma, and from then on only the EWMA statistic moves. A sustained shift therefore
+walks the EWMA off a fixed centre and out of its limits, instead of being averaged into
+the centre it is compared with. After a deliberate process change (new tooling, a new
+material lot) rebaseline() starts a new baseline phase; reset() forgets the recipe.
+A metric that did not vary during its baseline is not judged.
+
+    spc = PressSpc('spc_state.json')
+    result = spc.add('bearing_a', metrics, force_min=400, force_max=600)
+    if result['out_of_control']:
+        print('Drifting:', ', '.join(result['out_of_control']))
+    print(spc.summary('bearing_a'))
+"""
+
+import json
+import math
+import os
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Union
+
+SPC_STATE_VERSION = 2
+
+# Summary key, and the generate_report() threshold names that bound it
+SPC_METRICS = (
+    ('peak_force', 'force_min', 'force_max'),
+    ('endpoint', 'endpoint_min', 'endpoint_max'),
+    ('energy', 'energy_min', 'energy_max'),
+)
+
+EWMA_LAMBDA = 0.2   # Weight of the newest part
+EWMA_L = 3.0        # Control limit width in EWMA sigmas (about 560 parts between false alarms at EWMA_LAMBDA)
+BASELINE_PARTS = 20  # Parts that set the centre line and sigma before the chart is judged
+
+
+class RunningStat:
+    """Welford mean and variance plus the EWMA chart of one metric."""
+
+    def __init__(self, state: Optional[Dict[str, Any]] = None, baseline_parts: int = BASELINE_PARTS):
+        state = state or {}
+        self.count = int(state.get('count', 0))
+        self.mean = float(state.get('mean', 0.0))
+        self.m2 = float(state.get('m2', 0.0))
+        self.minimum = state.get('min')
+        self.maximum = state.get('max')
+        self.lsl = state.get('lsl')
+        self.usl = state.get('usl')
+        self.out_of_spec = int(state.get('out_of_spec', 0))
+        self.out_of_control = int(state.get('out_of_control', 0))
+        self.baseline_parts = max(2, int(state.get('baseline_parts', baseline_parts)))
+        if 'base_count' in state:
+            self.base_count = int(state['base_count'])
+            self.base_mean = float(state['base_mean'])
+            self.base_m2 = float(state['base_m2'])
+            self.ewma = state.get('ewma')
+            self.chart_count = int(state.get('chart_count', 0))
+        else:
+            # Version 1 state: its parts become the baseline and the chart starts again
+            self.base_count, self.base_mean, self.base_m2 = self.count, self.mean, self.m2
+            self.ewma = None
+            self.chart_count = 0
+            if self.baseline_complete:
+                self.ewma = self.base_mean
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {'count': self.count, 'mean': self.mean, 'm2': self.m2, 'min': self.minimum,
+                'max': self.maximum, 'lsl': self.lsl, 'usl': self.usl,
+                'out_of_spec': self.out_of_spec, 'out_of_control': self.out_of_control,
+                'baseline_parts': self.baseline_parts, 'base_count': self.base_count,
+                'base_mean': self.base_mean, 'base_m2': self.base_m2, 'ewma': self.ewma,
+                'chart_count': self.chart_count}
+
+    @property
+    def variance(self) -> float:
+        """Sample variance of every part (0 below two parts)."""
+        return self.m2 / (self.count - 1) if self.count > 1 else 0.0
+
+    @property
+    def std(self) -> float:
+        return math.sqrt(self.variance)
+
+    @property
+    def baseline_complete(self) -> bool:
+        """True once the centre line and sigma are frozen."""
+        return self.base_count >= self.baseline_parts
+
+    @property
+    def centre(self) -> Optional[float]:
+        """EWMA centre line (None during the baseline)."""
+        return self.base_mean if self.baseline_complete else None
+
+    @property
+    def sigma(self) -> Optional[float]:
+        """Baseline standard deviation the limits use (None during the baseline)."""
+        if not self.baseline_complete:
+            return None
+        return math.sqrt(self.base_m2 / (self.base_count - 1))
+
+    def ewma_limits(self, parts: Optional[int] = None) -> Optional[tuple]:
+        """
+        (lower, centre, upper) of the EWMA chart at chart part number parts (default: the
+        next one), None during the baseline or if the baseline did not vary.
+        """
+        sigma = self.sigma
+        if sigma is None or sigma <= 0.0:
+            return None
+        n = self.chart_count + 1 if parts is None else max(1, parts)
+        width = EWMA_L * sigma * math.sqrt(EWMA_LAMBDA / (2.0 - EWMA_LAMBDA) *
+                                           (1.0 - (1.0 - EWMA_LAMBDA) ** (2 * n)))
+        return (self.base_mean - width, self.base_mean, self.base_mean + width)
+
+    def rebaseline(self) -> None:
+        """Start a new baseline phase; the capability statistics are kept."""
+        self.base_count = 0
+        self.base_mean = 0.0
+        self.base_m2 = 0.0
+        self.ewma = None
+        self.chart_count = 0
+
+    def add(self, value: float, lsl: Optional[float] = None, usl: Optional[float] = None) -> Dict[str, Any]:
+        """
+        Add one part.
+
+        Returns:
+            Dictionary with the EWMA value, its limits (None during the baseline) and whether
+            the part is in spec and in control (None where that cannot be judged)
+        """
+        limits = None
+        in_control = None
+        if self.baseline_complete:
+            limits = self.ewma_limits()
+            self.chart_count += 1
+            self.ewma = EWMA_LAMBDA * value + (1.0 - EWMA_LAMBDA) * self.ewma
+            if limits is not None:
+                in_control = limits[0] <= self.ewma <= limits[2]
+                if not in_control:
+                    self.out_of_control += 1
+        else:
+            self.base_count += 1
+            delta = value - self.base_mean
+            self.base_mean += delta / self.base_count
+            self.base_m2 += delta * (value - self.base_mean)
+            if self.baseline_complete:
+                # The chart starts on its centre line
+                self.ewma = self.base_mean
+
+        self.count += 1
+        delta = value - self.mean
+        self.mean += delta / self.count
+        self.m2 += delta * (value - self.mean)
+        self.minimum = value if self.minimum is None else min(self.minimum, value)
+        self.maximum = value if self.maximum is None else max(self.maximum, value)
+
+        self.lsl, self.usl = lsl, usl
+        in_spec = None
+        if lsl is not None or usl is not None:
+            in_spec = (lsl is None or value >= lsl) and (usl is None or value <= usl)
+            if not in_spec:
+                self.out_of_spec += 1
+        return {'value': value, 'ewma': self.ewma, 'ewma_limits': limits, 'in_spec': in_spec,
+                'in_control': in_control}
+
+    def capability(self) -> Dict[str, Optional[float]]:
+        """Cp and Cpk against the latest thresholds (None if undefined or no spread yet)."""
+        std = self.std
+        cp = cpk = None
+        if std > 0.0:
+            if self.lsl is not None and self.usl is not None:
+                cp = (self.usl - self.lsl) / (6.0 * std)
+            sides = []
+            if self.usl is not None:
+                sides.append((self.usl - self.mean) / (3.0 * std))
+            if self.lsl is not None:
+                sides.append((self.mean - self.lsl) / (3.0 * std))
+            if sides:
+                cpk = min(sides)
+        return {'cp': cp, 'cpk': cpk}
+
+
+class PressSpc:
+    """
+    Running SPC state of every recipe, kept in a JSON file.
+    """
+
+    def __init__(self, path: Optional[Union[str, Path]] = None, autosave: bool = True,
+                 baseline_parts: int = BASELINE_PARTS):
+        """
+        Args:
+            path: State file; read if it exists (None keeps the state in memory only)
+            autosave: Write the state after every part
+            baseline_parts: Baseline length of metrics not in the state file yet (a metric
+                keeps the length it started with)
+        """
+        self.path = Path(path) if path is not None else None
+        self.autosave = autosave and self.path is not None
+        self.baseline_parts = baseline_parts
+        self.recipes: Dict[str, Dict[str, RunningStat]] = {}
+        if self.path is not None and self.path.exists():
+            with open(self.path, 'r', encoding='utf-8') as f:
+                state = json.load(f)
+            for recipe, metrics in state.get('recipes', {}).items():
+                self.recipes[recipe] = {key: RunningStat(stat, baseline_parts) for key, stat in metrics.items()}
+
+    def add(self, recipe: str, metrics: Dict[str, Any], **thresholds: Optional[float]) -> Dict[str, Any]:
+        """
+        Add one finished press.
+
+        Args:
+            recipe: Recipe (or part number) the press ran
+            metrics: calculate_metrics() output, or any dict with peak_force, endpoint and energy
+            thresholds: generate_report() thresholds (force_min, force_max, endpoint_min, ...)
+
+        Returns:
+            Dictionary of metric to RunningStat.add() result, plus 'out_of_control', the
+            metrics whose EWMA left its limits with this part
+        """
+        stats = self.recipes.setdefault(recipe, {})
+        results: Dict[str, Any] = {}
+        for key, low, high in SPC_METRICS:
+            value = metrics.get(key)
+            if value is None:
+                continue
+            stat = stats.setdefault(key, RunningStat(baseline_parts=self.baseline_parts))
+            results[key] = stat.add(float(value), thresholds.get(low), thresholds.get(high))
+        results['out_of_control'] = [key for key, _, _ in SPC_METRICS
+                                     if key in results and results[key]['in_control'] is False]
+        if self.autosave:
+            self.save()
+        return results
+
+    def summary(self, recipe: str) -> Dict[str, Dict[str, Any]]:
+        """Count, mean, standard deviation, range, Cp/Cpk and EWMA chart of each metric of a recipe."""
+        summary = {}
+        for key, stat in self.recipes.get(recipe, {}).items():
+            row = {'count': stat.count, 'mean': stat.mean, 'std': stat.std, 'min': stat.minimum,
+                   'max': stat.maximum, 'baseline': min(stat.base_count, stat.baseline_parts),
+                   'baseline_parts': stat.baseline_parts, 'centre': stat.centre, 'sigma': stat.sigma,
+                   'ewma': stat.ewma, 'ewma_limits': stat.ewma_limits(stat.chart_count),
+                   'out_of_spec': stat.out_of_spec, 'out_of_control': stat.out_of_control}
+            row.update(stat.capability())
+            summary[key] = row
+        return summary
+
+    def rebaseline(self, recipe: str) -> None:
+        """Start a new baseline phase for a recipe after a deliberate process change."""
+        for stat in self.recipes.get(recipe, {}).values():
+            stat.rebaseline()
+        if self.autosave:
+            self.save()
+
+    def reset(self, recipe: Optional[str] = None) -> None:
+        """Forget one recipe (a new setup or tooling change), or every recipe."""
+        if recipe is None:
+            self.recipes.clear()
+        else:
+            self.recipes.pop(recipe, None)
+        if self.autosave:
+            self.save()
+
+    def save(self) -> None:
+        """Write the state file (replaced whole, so a crash leaves the previous one)."""
+        if self.path is None:
+            return
+        state = {'version': SPC_STATE_VERSION,
+                 'recipes': {recipe: {key: stat.to_dict() for key, stat in metrics.items()}
+                             for recipe, metrics in self.recipes.items()}}
+        temp = self.path.with_name(self.path.name + '.tmp')
+        with open(temp, 'w', encoding='utf-8') as f:
+            json.dump(state, f, indent=1)
+        os.replace(temp, self.path)
+
+    def format(self, recipe: str) -> List[str]:
+        """One text line per metric, for a console or log."""
+        lines = []
+        for key, row in self.summary(recipe).items():
+            cp = '---' if row['cp'] is None else f"{row['cp']:.2f}"
+            cpk = '---' if row['cpk'] is None else f"{row['cpk']:.2f}"
+            if row['centre'] is None:
+                chart = f"baseline={row['baseline']}/{row['baseline_parts']}"
+            else:
+                chart = f"centre={row['centre']:.3f} sigma={row['sigma']:.3f} ewma={row['ewma']:.3f}"
+            lines.append(f"{recipe} {key}: n={row['count']} mean={row['mean']:.3f} std={row['std']:.3f} "
+                         f"Cp={cp} Cpk={cpk} {chart} out_of_spec={row['out_of_spec']} "
+                         f"out_of_control={row['out_of_control']}")
+        return lines
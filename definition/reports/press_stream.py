@@ -0,0 +1,295 @@
+"""
+Press Report Stream
+
+Builds press reports straight from the device's message stream instead of from a CSV log.
+Feed every line the host receives from the press (PRESSBOI_TELEM text telemetry and the
+PRESSBOI_DONE / PRESSBOI_ERROR events) to PressStream.feed_line(). While the press is BUSY
+each telemetry frame becomes one sample, and the peak force, start position, endpoint and
+energy are updated as the sample arrives. When the DONE of a press command (move_abs,
+move_inc, queue_run, run_recipe) comes in, the report is rendered from the already-compiled
+template and written, so it is ready the moment the press finishes: there is no CSV to
+close, reopen and parse.
+
+Samples collected during a home or retract are dropped when that command's DONE arrives.
+A press that ends with MAIN_STATE ERROR is still reported, from the samples up to the error.
+
+Typical use, with the thresholds of generate_press_report():
+
+    stream = PressStream('reports/', on_report=print, serial_number='SN-42', force_max=600)
+    for line in device_lines:
+        stream.feed_line(line)
+"""
+
+import re
+import time
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Callable, Dict, Optional, Tuple, Union
+
+try:
+    from .press_curves import GRAVITY
+    from .press_report import get_generator, PressReportGenerator
+    from .press_spc import PressSpc
+except ImportError:
+    # Run as a script next to press_report.py
+    from press_curves import GRAVITY
+    from press_report import get_generator, PressReportGenerator
+    from press_spc import PressSpc
+
+DEVICE_PREFIX = 'PRESSBOI_'
+TELEM_PREFIX = DEVICE_PREFIX + 'TELEM: '
+
+# Commands whose DONE ends a press; other commands' DONE (home, retract) discards the samples
+PRESS_COMMANDS = ('move_abs', 'move_inc', 'queue_run', 'run_recipe')
+
+_DONE_RE = re.compile(r'^' + DEVICE_PREFIX + r'DONE: (?:#\d+ )?(\S*)')
+
+ReportResult = Tuple[bool, str, Optional[str]]
+
+
+class RunningPressMetrics:
+    """
+    Press samples plus the calculate_metrics() summary, updated one sample at a time.
+    """
+
+    def __init__(self):
+        self.times = []
+        self.positions = []
+        self.forces = []
+        self.energies = []
+        self.peak_force = None
+        self.peak_force_position = 0.0
+        self.integrated_energy = 0.0
+        self.start_time = None
+        self.end_time = None
+
+    def __len__(self) -> int:
+        return len(self.positions)
+
+    def add(self, time_s: float, position: float, force: float, energy: Optional[float] = None) -> None:
+        """
+        Add one sample.
+
+        Args:
+            time_s: Seconds since the first sample
+            position: Position in mm
+            force: Force in kg
+            energy: Logged energy in J, if the device reports it
+        """
+        if self.positions:
+            # Trapezoid step, as integrate_energy() (distance travelled either way)
+            self.integrated_energy += (abs(position - self.positions[-1]) / 1000.0 *
+                                       (force + self.forces[-1]) * (GRAVITY / 2.0))
+        if self.peak_force is None or force > self.peak_force:
+            # First occurrence of the peak, as np.argmax()
+            self.peak_force = force
+            self.peak_force_position = position
+        self.times.append(time_s)
+        self.positions.append(position)
+        self.forces.append(force)
+        if energy is not None:
+            self.energies.append(energy)
+
+    def summary(self) -> Dict[str, Any]:
+        """The summary PressReportGenerator.apply_thresholds() takes."""
+        if not self.positions:
+            return {
+                'peak_force': 0,
+                'peak_force_position': 0,
+                'start_position': 0,
+                'endpoint': 0,
+                'energy': 0,
+                'duration': 0,
+                'data_points': 0
+            }
+        return {
+            'peak_force': self.peak_force,
+            'peak_force_position': self.peak_force_position,
+            'start_position': self.positions[0],
+            'endpoint': self.positions[-1],
+            'energy': self.energies[-1] if self.energies else self.integrated_energy,
+            'duration': self.times[-1] - self.times[0],
+            'data_points': len(self.positions)
+        }
+
+    def data(self, force_mode: Optional[str]) -> Dict[str, Any]:
+        """The samples, shaped like parse_csv_log() output."""
+        count = len(self.positions)
+        return {
+            'times': self.times,
+            'positions': self.positions,
+            'forces': self.forces,
+            'energies': self.energies[:count],
+            'start_time': self.start_time,
+            'end_time': self.end_time,
+            'has_energy_data': len(self.energies) > 0,
+            'detected_force_mode': force_mode
+        }
+
+
+class PressStream:
+    """
+    Turns the press telemetry and event stream into one HTML report per press.
+    """
+
+    def __init__(self,
+                 output_dir: Union[str, Path],
+                 generator: Optional[PressReportGenerator] = None,
+                 on_report: Optional[Callable[[ReportResult], None]] = None,
+                 spc: Optional[PressSpc] = None,
+                 recipe: str = 'default',
+                 **report_args):
+        """
+        Args:
+            output_dir: Directory the reports are written to
+            generator: Report generator to render with (default: the shared one)
+            on_report: Called with the (success, message, output_path) of each report
+            spc: Running SPC state each finished press is added to, under recipe
+            recipe: Recipe the presses run (change it with the recipe attribute)
+            report_args: generate_press_report() arguments applied to every report
+                         (serial_number, job_number, title, thresholds, ...)
+        """
+        self.output_dir = Path(output_dir)
+        self.generator = generator or get_generator()
+        self.on_report = on_report
+        self.report_args = report_args
+        self.spc = spc
+        self.recipe = recipe
+        self.last_spc: Optional[Dict[str, Any]] = None
+        self.telemetry = {}
+        self.press = None
+        self.first_sample_time = None
+        # Cleared when a press ends, so BUSY frames still in flight behind its DONE do not
+        # start the next press; set again by the first frame that is not BUSY
+        self.armed = True
+
+    def set_report_args(self, **report_args) -> None:
+        """Update report arguments (for example the serial number) for the next press."""
+        self.report_args.update(report_args)
+
+    def feed_line(self, line: str, now: Optional[float] = None) -> Optional[ReportResult]:
+        """
+        Handle one line received from the device; other devices' lines are ignored.
+
+        Args:
+            line: Received text line
+            now: Receive time (time.time()); defaults to now
+
+        Returns:
+            The report result if this line finished a press, otherwise None
+        """
+        if line.startswith(TELEM_PREFIX):
+            fields = {}
+            for part in line[len(TELEM_PREFIX):].strip().split(','):
+                key, sep, value = part.partition(':')
+                if sep:
+                    fields[key] = value
+            return self.feed_telemetry(fields, now)
+
+        match = _DONE_RE.match(line)
+        if match is None or self.press is None:
+            return None
+        command = match.group(1)
+        if command in PRESS_COMMANDS:
+            return self.finish()
+        if command in ('home', 'retract', 'reset', 'cancel'):
+            self.discard()
+        return None
+
+    def feed_telemetry(self, fields: Dict[str, str], now: Optional[float] = None) -> Optional[ReportResult]:
+        """
+        Handle one parsed telemetry frame (key to text value, as on the wire).
+
+        Args:
+            fields: Telemetry fields; a delta frame may carry only some of them
+            now: Receive time (time.time()); defaults to now
+
+        Returns:
+            The report result if this frame finished a press, otherwise None
+        """
+        self.telemetry.update(fields)
+        state = self.telemetry.get('MAIN_STATE')
+
+        if state != 'BUSY':
+            self.armed = True
+        if state == 'BUSY' and (self.press is not None or self.armed):
+            if now is None:
+                now = time.time()
+            if self.press is None:
+                self.press = RunningPressMetrics()
+                self.press.start_time = datetime.fromtimestamp(now)
+                self.first_sample_time = now
+            try:
+                position = float(self.telemetry['current_pos'])
+                force = float(self.telemetry[self._force_key()])
+                energy = self.telemetry.get('joules')
+                self.press.add(now - self.first_sample_time, position, force,
+                               float(energy) if energy is not None else None)
+                self.press.end_time = datetime.fromtimestamp(now)
+            except (KeyError, ValueError):
+                # Frame without a usable position or force; skip it
+                pass
+        elif state == 'ERROR' and self.press is not None:
+            # The move was stopped by a fault; report what was pressed
+            return self.finish()
+        return None
+
+    def finish(self) -> Optional[ReportResult]:
+        """
+        Render and write the report for the press in progress.
+
+        Returns:
+            (success, message, output_path), or None if no press was in progress
+        """
+        press = self.press
+        self.press = None
+        self.armed = False
+        if press is None:
+            return None
+        if len(press) == 0:
+            result = (False, "No valid data received for press", None)
+        else:
+            result = self._render(press)
+        if self.on_report is not None:
+            self.on_report(result)
+        return result
+
+    def discard(self) -> None:
+        """Drop the samples collected since the device went BUSY."""
+        self.press = None
+        self.armed = False
+
+    def _force_key(self) -> str:
+        if self.telemetry.get('force_source') == 'motor_torque':
+            return 'force_motor_torque'
+        return 'force_load_cell'
+
+    def _float_field(self, key: str) -> Optional[float]:
+        try:
+            return float(self.telemetry[key])
+        except (KeyError, ValueError):
+            return None
+
+    def _render(self, press: RunningPressMetrics) -> ReportResult:
+        args = dict(self.report_args)
+        for key in ('csv_path', 'output_path', 'press_index'):
+            args.pop(key, None)
+        thresholds = {key: args.get(key) for key in
+                      ('force_min', 'force_max', 'endpoint_min', 'endpoint_max', 'energy_min', 'energy_max')}
+        metrics = self.generator.apply_thresholds(press.summary(), **thresholds)
+        if self.spc is not None:
+            self.last_spc = self.spc.add(self.recipe, metrics, **thresholds)
+        force_mode = 'Motor Torque' if self._force_key() == 'force_motor_torque' else 'Load Cell'
+
+        # Press range and endpoint as the device reports them (telemetry_params in reports.json)
+        args.setdefault('press_startpoint', self._float_field('startpoint'))
+        args.setdefault('press_threshold', self._float_field('press_threshold'))
+        args.setdefault('telemetry_endpoint', self._float_field('endpoint'))
+
+        stamp = press.start_time.strftime("%Y%m%d_%H%M%S")
+        serial = str(args.get('serial_number', 'N/A')).replace('/', '_') or 'N_A'
+        output_path = str(self.output_dir / f"press_report_{serial}_{stamp}.html")
+        try:
+            return self.generator.render_report(press.data(force_mode), output_path, metrics=metrics, **args)
+        except Exception as e:
+            return (False, f"Error generating report: {e}", None)
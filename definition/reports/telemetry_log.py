@@ -0,0 +1,510 @@
+"""
+Telemetry Log Files
+
+Columnar, chunked, append-only telemetry logs (.pbt) for long-running production
+logging, in place of CSV rows. Each column is one telemetry.json field, stored in its
+native width: floats as f4, ints as i4, and strings with a value list (MAIN_STATE,
+force_source) as a u1 code into that list. A row takes 86 bytes, about half of its CSV
+text. The file is memory-mapped, and a time range reads only the chunks that overlap it.
+
+File layout (all little-endian):
+
+    header   32 bytes  magic 'PBTL', version u16, field count u16, schema length u32,
+                       chunk rows u32, 16 reserved bytes
+    schema   JSON      [[key, type, values], ...] in column order, padded to 8 bytes
+    chunks   32-byte chunk header (magic 'PBTC', row count u32, first and last time f8,
+                       flags u32, 4 reserved bytes), then the time column (f8 Unix seconds)
+                       and one column per field, each padded to 8 bytes
+    index    32 bytes  per chunk: offset u64, row count u32, flags u32, first and last time f8
+    trailer  16 bytes  index offset u64, chunk count u32, magic 'PBTI'
+
+The index is the sparse time index: one entry per chunk, in time order, so a time is found
+with a binary search over the chunk start times and only the chunks in range are touched.
+A press gets chunks of its own: the writer cuts a chunk when MAIN_STATE goes BUSY and again
+when it leaves BUSY, and flags the press chunks (CHUNK_FLAG_PRESS, with CHUNK_FLAG_PRESS_START
+on the first chunk of each press; a press longer than chunk_rows spans several chunks).
+presses() lists them from the index alone, and read_press() maps just that press.
+
+Chunks are written as they fill, and the index and trailer are rewritten by close(). A log
+is appended to by reopening it: the old index is cut off and written again after the new
+chunks. A log whose writer never closed (power loss) has no trailer; the reader then
+walks the chunk headers instead, so every completed chunk is still readable.
+
+Typical use:
+
+    with TelemetryLogWriter('line3.pbt') as log:
+        for timestamp, line in received:
+            log.append_line(line, timestamp)
+    log = TelemetryLog('line3.pbt')
+    week = log.read(['current_pos', 'force_load_cell'], start=t0, end=t0 + 7 * 86400)
+    bad_part = log.press_data(log.press_at(t_bad))
+"""
+
+import json
+import struct
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Sequence, Union
+
+try:
+    import numpy as np
+except ImportError:
+    raise ImportError(
+        "NumPy is required for telemetry log files. "
+        "Install it with: pip install numpy"
+    )
+
+TELEMETRY_LOG_SUFFIX = '.pbt'
+LOG_MAGIC = b'PBTL'
+LOG_VERSION = 1
+CHUNK_MAGIC = b'PBTC'
+TRAILER_MAGIC = b'PBTI'
+DEFAULT_CHUNK_ROWS = 4096
+
+HEADER_STRUCT = struct.Struct('<4sHHII16x')
+CHUNK_STRUCT = struct.Struct('<4sIddI4x')
+TRAILER_STRUCT = struct.Struct('<QI4s')
+INDEX_DTYPE = np.dtype([
+    ('offset', '<u8'),
+    ('rows', '<u4'),
+    ('flags', '<u4'),
+    ('first_time', '<f8'),
+    ('last_time', '<f8'),
+])
+
+CHUNK_FLAG_PRESS = 0x1          # Rows logged while MAIN_STATE was BUSY
+CHUNK_FLAG_PRESS_START = 0x2    # First chunk of a press
+
+TELEM_PREFIX = 'PRESSBOI_TELEM: '
+ENUM_UNKNOWN = 0xFF
+TIME_COLUMN = 'time'
+REPORT_FIELDS = ['current_pos', 'force_load_cell', 'force_motor_torque', 'force_source', 'joules']
+
+_COLUMN_DTYPES = {
+    'float': np.dtype('<f4'),
+    'int': np.dtype('<i4'),
+    'string': np.dtype('u1'),
+}
+
+
+def _padded(size: int) -> int:
+    return (size + 7) & ~7
+
+
+def load_schema(definition_path: Optional[Union[str, Path]] = None) -> List[list]:
+    """
+    Builds the column schema from telemetry.json.
+
+    Args:
+        definition_path: telemetry.json (default: the device definition next to reports/)
+
+    Returns:
+        [key, type, values] per field, in telemetry.json order; values is the string value
+        list (empty for numbers)
+    """
+    if definition_path is None:
+        definition_path = Path(__file__).parent.parent / 'telemetry.json'
+    with open(definition_path, 'r') as f:
+        definition = json.load(f)
+    schema = []
+    for key, field in definition.items():
+        kind = field.get('type', 'float')
+        values = list(field.get('values', []))
+        if kind == 'string' and not values:
+            raise ValueError(f"Telemetry field {key}: string fields need a value list to be logged")
+        if kind not in _COLUMN_DTYPES:
+            raise ValueError(f"Telemetry field {key}: unsupported type {kind}")
+        schema.append([key, kind, values])
+    return schema
+
+
+class TelemetryLogWriter:
+    """
+    Appends telemetry rows to a log file, a chunk at a time.
+
+    Delta frames are fine: a field missing from a row keeps its previous value (starting
+    from the telemetry.json default), as the GUI variables do.
+    """
+
+    def __init__(self, path: Union[str, Path], schema: Optional[List[list]] = None,
+                 chunk_rows: int = DEFAULT_CHUNK_ROWS, definition_path: Optional[Union[str, Path]] = None):
+        """
+        Args:
+            path: Log file; appended to if it exists
+            schema: Column schema (default: load_schema())
+            chunk_rows: Rows buffered per chunk
+            definition_path: telemetry.json for defaults and the schema
+        """
+        self.path = Path(path)
+        self.chunk_rows = max(1, int(chunk_rows))
+        self._index: List[tuple] = []
+        if self.path.exists() and self.path.stat().st_size > 0:
+            log = TelemetryLog(self.path)
+            self.schema = log.schema
+            self._index = [tuple(entry) for entry in log.index.tolist()]
+            end = log.data_end
+            del log
+            self._file = open(self.path, 'r+b')
+            self._file.truncate(end)
+            self._file.seek(end)
+        else:
+            self.schema = schema if schema is not None else load_schema(definition_path)
+            self._file = open(self.path, 'wb')
+            schema_bytes = json.dumps(self.schema).encode('utf-8')
+            self._file.write(HEADER_STRUCT.pack(LOG_MAGIC, LOG_VERSION, len(self.schema),
+                                                len(schema_bytes), self.chunk_rows))
+            self._file.write(schema_bytes.ljust(_padded(len(schema_bytes)), b'\0'))
+        self._codes = [{value: i for i, value in enumerate(values)} for _, _, values in self.schema]
+        self._last = self._defaults(definition_path)
+        self._times: List[float] = []
+        self._rows: List[List[Any]] = [[] for _ in self.schema]
+        # Press chunking follows MAIN_STATE, when the schema has it
+        self._state_column = next((i for i, (key, _, _) in enumerate(self.schema) if key == 'MAIN_STATE'), None)
+        self._busy_code = self._codes[self._state_column].get('BUSY') if self._state_column is not None else None
+        self._busy = False
+        self._chunk_flags = 0
+
+    def _defaults(self, definition_path) -> List[Any]:
+        try:
+            if definition_path is None:
+                definition_path = Path(__file__).parent.parent / 'telemetry.json'
+            with open(definition_path, 'r') as f:
+                definition = json.load(f)
+        except (OSError, ValueError):
+            definition = {}
+        defaults = []
+        for (key, kind, values), codes in zip(self.schema, self._codes):
+            default = definition.get(key, {}).get('default', 0)
+            defaults.append(self._encode(kind, codes, default))
+        return defaults
+
+    @staticmethod
+    def _encode(kind: str, codes: Dict[str, int], value: Any) -> Any:
+        if kind == 'string':
+            return codes.get(str(value), codes.get(str(value).upper(), ENUM_UNKNOWN))
+        if kind == 'int':
+            return int(float(value))
+        return float(value)
+
+    def append(self, timestamp: float, fields: Dict[str, Any]) -> None:
+        """
+        Appends one row.
+
+        Args:
+            timestamp: Unix time of the frame (seconds)
+            fields: Telemetry key to value (text from the wire or numbers)
+        """
+        if self._state_column is not None and 'MAIN_STATE' in fields:
+            busy = self._encode('string', self._codes[self._state_column], fields['MAIN_STATE']) == self._busy_code
+            if busy != self._busy:
+                # A press starts or ends: close the chunk before it
+                self.flush()
+                self._busy = busy
+                self._chunk_flags = (CHUNK_FLAG_PRESS | CHUNK_FLAG_PRESS_START) if busy else 0
+        for column, ((key, kind, _), codes) in enumerate(zip(self.schema, self._codes)):
+            if key in fields:
+                try:
+                    self._last[column] = self._encode(kind, codes, fields[key])
+                except (TypeError, ValueError):
+                    # Unparseable value: keep the previous one
+                    pass
+            self._rows[column].append(self._last[column])
+        self._times.append(float(timestamp))
+        if len(self._times) >= self.chunk_rows:
+            self.flush()
+
+    def append_line(self, line: str, timestamp: float) -> bool:
+        """
+        Appends a PRESSBOI_TELEM text line.
+
+        Returns:
+            False if the line is not text telemetry
+        """
+        if not line.startswith(TELEM_PREFIX):
+            return False
+        fields = {}
+        for part in line[len(TELEM_PREFIX):].strip().split(','):
+            key, sep, value = part.partition(':')
+            if sep:
+                fields[key] = value
+        self.append(timestamp, fields)
+        return True
+
+    def flush(self) -> None:
+        """Writes the buffered rows as one chunk."""
+        rows = len(self._times)
+        if rows == 0:
+            return
+        times = np.asarray(self._times, dtype='<f8')
+        offset = self._file.tell()
+        flags = self._chunk_flags
+        self._file.write(CHUNK_STRUCT.pack(CHUNK_MAGIC, rows, times[0], times[-1], flags))
+        self._file.write(times.tobytes())
+        for (_, kind, _), values in zip(self.schema, self._rows):
+            data = np.asarray(values, dtype=_COLUMN_DTYPES[kind]).tobytes()
+            self._file.write(data.ljust(_padded(len(data)), b'\0'))
+        self._index.append((offset, rows, flags, float(times[0]), float(times[-1])))
+        self._times = []
+        self._rows = [[] for _ in self.schema]
+        # A press that outgrows a chunk continues in the next one
+        self._chunk_flags &= ~CHUNK_FLAG_PRESS_START
+
+    def close(self) -> None:
+        if self._file.closed:
+            return
+        self.flush()
+        index_offset = self._file.tell()
+        self._file.write(np.array(self._index, dtype=INDEX_DTYPE).tobytes())
+        self._file.write(TRAILER_STRUCT.pack(index_offset, len(self._index), TRAILER_MAGIC))
+        self._file.close()
+
+    def __enter__(self) -> 'TelemetryLogWriter':
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+
+class TelemetryLog:
+    """
+    Reads a telemetry log; each column of a chunk is a read-only view of the mapped file.
+    """
+
+    def __init__(self, path: Union[str, Path]):
+        self.path = Path(path)
+        size = self.path.stat().st_size
+        with open(self.path, 'rb') as f:
+            header = f.read(HEADER_STRUCT.size)
+            if len(header) < HEADER_STRUCT.size:
+                raise ValueError(f"Not a telemetry log (too short): {self.path}")
+            magic, version, field_count, schema_length, self.chunk_rows = HEADER_STRUCT.unpack(header)
+            if magic != LOG_MAGIC or version != LOG_VERSION:
+                raise ValueError(f"Not a version {LOG_VERSION} telemetry log: {self.path}")
+            self.schema = json.loads(f.read(schema_length).decode('utf-8'))
+            if len(self.schema) != field_count:
+                raise ValueError(f"Telemetry log schema is damaged: {self.path}")
+            first_chunk = HEADER_STRUCT.size + _padded(schema_length)
+            f.seek(max(first_chunk, size - TRAILER_STRUCT.size))
+            trailer = f.read(TRAILER_STRUCT.size)
+        self.fields = [key for key, _, _ in self.schema]
+        self._columns = {key: i for i, key in enumerate(self.fields)}
+        self._map = np.memmap(self.path, dtype=np.uint8, mode='r') if size > 0 else np.zeros(0, np.uint8)
+
+        self.index = None
+        if len(trailer) == TRAILER_STRUCT.size:
+            index_offset, chunk_count, trailer_magic = TRAILER_STRUCT.unpack(trailer)
+            index_end = index_offset + chunk_count * INDEX_DTYPE.itemsize
+            if trailer_magic == TRAILER_MAGIC and index_end + TRAILER_STRUCT.size == size:
+                self.index = np.frombuffer(self._map[index_offset:index_end], dtype=INDEX_DTYPE)
+                self.data_end = index_offset
+        if self.index is None:
+            # Writer never closed: walk the chunk headers
+            self.index, self.data_end = self._scan(first_chunk, size)
+
+    def _chunk_bytes(self, rows: int) -> int:
+        total = CHUNK_STRUCT.size + _padded(rows * 8)
+        for _, kind, _ in self.schema:
+            total += _padded(rows * _COLUMN_DTYPES[kind].itemsize)
+        return total
+
+    def _scan(self, offset: int, size: int):
+        entries = []
+        while offset + CHUNK_STRUCT.size <= size:
+            magic, rows, first, last, flags = CHUNK_STRUCT.unpack(bytes(self._map[offset:offset + CHUNK_STRUCT.size]))
+            length = self._chunk_bytes(rows)
+            if magic != CHUNK_MAGIC or rows == 0 or offset + length > size:
+                break
+            entries.append((offset, rows, flags, first, last))
+            offset += length
+        return np.array(entries, dtype=INDEX_DTYPE), offset
+
+    def __len__(self) -> int:
+        return int(self.index['rows'].sum()) if len(self.index) else 0
+
+    @property
+    def start_time(self) -> Optional[float]:
+        return float(self.index['first_time'][0]) if len(self.index) else None
+
+    @property
+    def end_time(self) -> Optional[float]:
+        return float(self.index['last_time'][-1]) if len(self.index) else None
+
+    def _chunk_column(self, chunk: int, column: Optional[int]) -> np.ndarray:
+        offset, rows = int(self.index['offset'][chunk]), int(self.index['rows'][chunk])
+        position = offset + CHUNK_STRUCT.size
+        if column is None:
+            return np.frombuffer(self._map[position:position + rows * 8], dtype='<f8')
+        position += _padded(rows * 8)
+        for _, kind, _ in self.schema[:column]:
+            position += _padded(rows * _COLUMN_DTYPES[kind].itemsize)
+        dtype = _COLUMN_DTYPES[self.schema[column][1]]
+        return np.frombuffer(self._map[position:position + rows * dtype.itemsize], dtype=dtype)
+
+    def read(self, fields: Optional[Sequence[str]] = None, start: Optional[float] = None,
+             end: Optional[float] = None, decode: bool = True) -> Dict[str, np.ndarray]:
+        """
+        Reads columns over a time range.
+
+        Args:
+            fields: Telemetry keys (default: all)
+            start: First Unix time to include (default: start of log)
+            end: Last Unix time to include (default: end of log)
+            decode: Return string fields as their values (object arrays) rather than codes
+
+        Returns:
+            'time' plus one array per field; views of the file when the range lies in one chunk
+        """
+        # Chunks overlapping the range, by binary search over the sparse index
+        first = int(np.searchsorted(self.index['last_time'], start, 'left')) if start is not None else 0
+        last = int(np.searchsorted(self.index['first_time'], end, 'right')) if end is not None else len(self.index)
+
+        # Row range of each overlapping chunk (times are increasing within a chunk)
+        slices = []
+        for chunk in range(first, last):
+            times = self._chunk_column(chunk, None)
+            lo = int(np.searchsorted(times, start, 'left')) if start is not None else 0
+            hi = int(np.searchsorted(times, end, 'right')) if end is not None else times.size
+            if hi > lo:
+                slices.append((chunk, lo, hi))
+        return self._gather(fields, slices, decode)
+
+    def _gather(self, fields: Optional[Sequence[str]], slices: List[tuple], decode: bool) -> Dict[str, np.ndarray]:
+        fields = list(self.fields if fields is None else fields)
+        for key in fields:
+            if key not in self._columns:
+                raise KeyError(f"No telemetry field {key} in {self.path}")
+
+        def gather(column):
+            parts = [self._chunk_column(chunk, column)[lo:hi] for chunk, lo, hi in slices]
+            if not parts:
+                dtype = np.dtype('<f8') if column is None else _COLUMN_DTYPES[self.schema[column][1]]
+                return np.zeros(0, dtype=dtype)
+            return parts[0] if len(parts) == 1 else np.concatenate(parts)
+
+        result = {TIME_COLUMN: gather(None)}
+        for key in fields:
+            column = self._columns[key]
+            values = gather(column)
+            _, kind, names = self.schema[column]
+            if decode and kind == 'string':
+                lookup = np.array(list(names) + ['UNKNOWN'] * (256 - len(names)), dtype=object)
+                values = lookup[values]
+            result[key] = values
+        return result
+
+    def chunk_at(self, timestamp: float) -> int:
+        """
+        Finds the chunk holding a time.
+
+        Returns:
+            Index of the last chunk starting at or before the time (-1 if before the log)
+        """
+        return int(np.searchsorted(self.index['first_time'], timestamp, 'right')) - 1
+
+    def presses(self) -> List[Dict[str, Any]]:
+        """
+        Lists the presses from the index alone, without reading any rows.
+
+        Returns:
+            Per press: first chunk, chunk count, rows, start and end time (Unix seconds)
+        """
+        flags = self.index['flags']
+        starts = np.flatnonzero(flags & CHUNK_FLAG_PRESS_START)
+        result = []
+        for start in starts:
+            end = int(start) + 1
+            while end < len(flags) and flags[end] & CHUNK_FLAG_PRESS and not flags[end] & CHUNK_FLAG_PRESS_START:
+                end += 1
+            result.append({
+                'first_chunk': int(start),
+                'chunks': end - int(start),
+                'rows': int(self.index['rows'][start:end].sum()),
+                'start_time': float(self.index['first_time'][start]),
+                'end_time': float(self.index['last_time'][end - 1]),
+            })
+        return result
+
+    def press_at(self, timestamp: float) -> Optional[int]:
+        """
+        Finds the press running at a time, or the last one that started before it.
+
+        Returns:
+            Press number for press_data(), or None if no press started by then
+        """
+        starts = [press['start_time'] for press in self.presses()]
+        number = int(np.searchsorted(starts, timestamp, 'right')) - 1
+        return number if number >= 0 else None
+
+    def read_press(self, number: int, fields: Optional[Sequence[str]] = None,
+                   decode: bool = True) -> Dict[str, np.ndarray]:
+        """
+        Reads the rows of one press (negative numbers count from the end), as read() does.
+        """
+        press = self.presses()[number]
+        first = press['first_chunk']
+        slices = [(chunk, 0, int(self.index['rows'][chunk])) for chunk in range(first, first + press['chunks'])]
+        return self._gather(fields, slices, decode)
+
+    def press_data(self, number: int) -> Dict[str, Any]:
+        """Reads one press as press report data, as to_report_data() does for a time range."""
+        return self._report_data(self.read_press(number, REPORT_FIELDS))
+
+    def to_report_data(self, start: Optional[float] = None, end: Optional[float] = None) -> Dict[str, Any]:
+        """
+        Reads a time range as press report data (the parse_csv_log() dictionary, as arrays).
+
+        The force column follows force_source at the end of the range, as the CSV parser
+        picks force_load_cell over force_motor_torque.
+        """
+        return self._report_data(self.read(REPORT_FIELDS, start, end))
+
+    @staticmethod
+    def _report_data(columns: Dict[str, np.ndarray]) -> Dict[str, Any]:
+        times = columns[TIME_COLUMN]
+        motor = columns['force_source'].size and columns['force_source'][-1] == 'motor_torque'
+        return {
+            'times': times - times[0] if times.size else times,
+            'positions': columns['current_pos'].astype(np.float64),
+            'forces': columns['force_motor_torque' if motor else 'force_load_cell'].astype(np.float64),
+            'energies': columns['joules'].astype(np.float64),
+            'start_time': datetime.fromtimestamp(times[0]) if times.size else None,
+            'end_time': datetime.fromtimestamp(times[-1]) if times.size else None,
+            'has_energy_data': times.size > 0,
+            'detected_force_mode': 'Motor Torque' if motor else 'Load Cell',
+        }
+
+
+def convert_csv_log(csv_path: Union[str, Path], log_path: Union[str, Path],
+                    chunk_rows: int = DEFAULT_CHUNK_ROWS) -> int:
+    """
+    Converts a CSV data log (the parse_csv_log() input) to a telemetry log.
+
+    Columns are matched to telemetry keys by name, ignoring a 'pressboi.' prefix; the date
+    and time_ms columns give the row time, or elapsed_s from the file's modification time.
+
+    Returns:
+        Rows written
+    """
+    import csv
+
+    def row_time(row, fallback):
+        try:
+            return datetime.strptime(f"{row['date']} {row.get('time_ms', '00:00:00.000')}",
+                                     "%Y-%m-%d %H:%M:%S.%f").timestamp()
+        except (KeyError, ValueError, TypeError):
+            return fallback
+
+    base = Path(csv_path).stat().st_mtime
+    rows = 0
+    with open(csv_path, 'r', newline='') as f, TelemetryLogWriter(log_path, chunk_rows=chunk_rows) as log:
+        reader = csv.DictReader(f)
+        keys = {header: header.split('.')[-1] for header in (reader.fieldnames or [])}
+        for row in reader:
+            try:
+                elapsed = float(row.get('elapsed_s') or 0.0)
+            except ValueError:
+                elapsed = 0.0
+            fields = {key: row[header] for header, key in keys.items() if row.get(header) not in (None, '')}
+            log.append(row_time(row, base + elapsed), fields)
+            rows += 1
+    return rows
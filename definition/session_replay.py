@@ -0,0 +1,337 @@
+"""
+Recorded Session Replay
+
+Captures what a press sends the app during a real session and plays it back to the app
+later, faster if wanted, so gui.py, operator_view.py and the press report path can be
+benchmarked and profiled against production traffic without hardware.
+
+record sits between the app and one press. The app talks to this machine as if it were
+the press; every datagram is passed on, DISCOVER_DEVICE with its PORT= changed to the
+proxy's, and every line the press sends is written to the session file, stamped with the
+seconds since the recording started, before it is passed back:
+
+    python session_replay.py record 192.168.1.50 line3.pbs
+
+play then stands in for the press on the firmware port. It answers DISCOVER_DEVICE with
+the recorded identity and streams the recorded lines to the discovered host at 1x to 20x
+(or any) speed, keeping their relative timing:
+
+    python session_replay.py play line3.pbs --speed 10
+    python session_replay.py play line3.pbs --speed 1 --port 18888 --loop
+
+The emulated stream is the text one: binary telemetry and typed events in the recording
+are rendered as the PRESSBOI_TELEM and event lines a text client gets, and the discovery
+reply says TELEM=TEXT EVENT=TEXT UDP=SINGLE. The recorded ACKs and discovery replies
+answered the recorded app and are not replayed; commands the app sends now are only
+acknowledged ("#<id>" requests, so it does not resend them), not run. A SYNC= token is
+answered with the device clock of the telemetry being replayed, running at the replay
+speed.
+
+Session file: one message per line, "<seconds> <line>"; lines starting with '#' are
+comments, and '> ' after the time marks a line the app sent. read_session() yields the
+press's lines for an offline consumer:
+
+    stream = PressStream('reports/')
+    for seconds, line in read_session('line3.pbs'):
+        stream.feed_line(line)
+"""
+
+import argparse
+import base64
+import binascii
+import re
+import selectors
+import socket
+import struct
+import sys
+import time
+from datetime import datetime
+from pathlib import Path
+from typing import Iterator, Optional, Tuple, Union
+
+try:
+    from .simulator import LOCAL_PORT, MAX_PACKET_LENGTH, TELEM_FIELDS
+    from .status_event_decoder import StatusEventDecoder
+    from .telemetry_decoder import DISCOVERY_PREFIX, TELEM_BINARY_PREFIX, TelemetryDecoder
+except ImportError:
+    # Run as a script
+    from simulator import LOCAL_PORT, MAX_PACKET_LENGTH, TELEM_FIELDS
+    from status_event_decoder import StatusEventDecoder
+    from telemetry_decoder import DISCOVERY_PREFIX, TELEM_BINARY_PREFIX, TelemetryDecoder
+
+SESSION_HEADER = '# pressboi session v1'
+SENT_MARK = '> '
+DEVICE_PREFIX = 'PRESSBOI_'
+TELEM_PREFIX = DEVICE_PREFIX + 'TELEM: '
+ACK_PREFIX = DEVICE_PREFIX + 'ACK: '
+EVENTB_PREFIX = DEVICE_PREFIX + 'EVENTB: '
+TELEMB_HEADER = struct.Struct('<BBHI')
+
+# Discovery fields that describe the recorded link rather than the press
+_LINK_FIELDS = ('PORT', 'TELEM', 'EVENT', 'UDP', 'USB', 'BULK', 'SYNC', 'T_US')
+_TIME_RE = re.compile(r't_us:(\d+)')
+
+
+# --- Session file -----------------------------------------------------------------------------
+
+def read_session(path: Union[str, Path], text: bool = True) -> Iterator[Tuple[float, str]]:
+    """
+    Yields (seconds, line) for every line the press sent, in order.
+
+    Args:
+        text: Render binary telemetry and typed events as the text lines (as play does)
+    """
+    renderer = TextRenderer() if text else None
+    with open(path, 'r', encoding='ascii', errors='replace') as f:
+        for row in f:
+            if row.startswith('#'):
+                continue
+            stamp, _, line = row.rstrip('\n').partition(' ')
+            if not line or line.startswith(SENT_MARK):
+                continue
+            try:
+                seconds = float(stamp)
+            except ValueError:
+                continue
+            if renderer is not None:
+                line = renderer.render(line)
+                if line is None:
+                    continue
+            yield seconds, line
+
+
+class TextRenderer:
+    """Recorded lines to what a text client (TELEM=TEXT EVENT=TEXT) would have received."""
+
+    def __init__(self):
+        self.telemetry = TelemetryDecoder()
+        self.events = StatusEventDecoder()
+        self.device_us: Optional[int] = None
+
+    def render(self, line: str) -> Optional[str]:
+        """
+        Returns:
+            The text line, or None for a line that is not replayed
+        """
+        if line.startswith(TELEM_BINARY_PREFIX):
+            return self._telemetry_text(line)
+        if line.startswith(EVENTB_PREFIX):
+            event = self.events.decode_line(line)
+            return event.text if event is not None else None
+        if line.startswith(TELEM_PREFIX):
+            match = _TIME_RE.search(line)
+            if match:
+                self.device_us = int(match.group(1))
+            return line
+        if line.startswith((ACK_PREFIX, DISCOVERY_PREFIX)):
+            return None
+        return line
+
+    def _telemetry_text(self, line: str) -> Optional[str]:
+        try:
+            data = base64.b64decode(line[len(TELEM_BINARY_PREFIX):].strip(), validate=True)
+        except (binascii.Error, ValueError):
+            return None
+        frame = self.telemetry.feed_line(line)
+        if frame is None or len(data) < TELEMB_HEADER.size:
+            return None
+        self.device_us = TELEMB_HEADER.unpack_from(data)[3]
+        parts = [f"t_us:{self.device_us}"]
+        for key, kind, precision in TELEM_FIELDS:
+            if key not in frame:
+                continue
+            value = frame[key]
+            parts.append(f"{key}:{value:.{precision}f}" if kind == 'float' else f"{key}:{value}")
+        return TELEM_PREFIX + ','.join(parts)
+
+
+def _lines(data: bytes):
+    for line in data.decode('ascii', 'replace').split('\n'):
+        line = line.strip('\r\x00 ')
+        if line:
+            yield line
+
+
+# --- Record -----------------------------------------------------------------------------------
+
+def record(press: str, path: Path, port: int, press_port: int) -> int:
+    """Proxies the app on @p port to the press, writing the press's lines to @p path."""
+    app_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    app_sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    app_sock.bind(('', port))
+    press_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    press_sock.bind(('', 0))
+    proxy_port = press_sock.getsockname()[1]
+    selector = selectors.DefaultSelector()
+    selector.register(app_sock, selectors.EVENT_READ, 'app')
+    selector.register(press_sock, selectors.EVENT_READ, 'press')
+
+    app: Optional[Tuple[str, int]] = None
+    start = time.monotonic()
+    lines = 0
+    print(f"point the app at this machine's port {port}; recording {press}:{press_port} to {path}, Ctrl+C stops")
+    with open(path, 'w', encoding='ascii', errors='replace') as f:
+        f.write(f"{SESSION_HEADER} {press} {datetime.now().isoformat(timespec='seconds')}\n")
+        try:
+            while True:
+                for key, _ in selector.select(1.0):
+                    data, address = key.fileobj.recvfrom(MAX_PACKET_LENGTH)
+                    stamp = time.monotonic() - start
+                    if key.data == 'app':
+                        text = data.decode('ascii', 'replace')
+                        match = re.search(r'PORT=(\d+)', text)
+                        if text.startswith('DISCOVER_DEVICE') and match:
+                            # Replies are sent to the PORT= of the discovery, so they come here
+                            app = (address[0], int(match.group(1)))
+                            text = text[:match.start(1)] + str(proxy_port) + text[match.end(1):]
+                        for line in _lines(text.encode('ascii', 'replace')):
+                            f.write(f"{stamp:.6f} {SENT_MARK}{line}\n")
+                        press_sock.sendto(text.encode('ascii', 'replace'), (press, press_port))
+                        continue
+                    for line in _lines(data):
+                        f.write(f"{stamp:.6f} {line}\n")
+                        lines += 1
+                    if app is not None:
+                        app_sock.sendto(data, app)
+        except KeyboardInterrupt:
+            pass
+    print(f"{lines} lines over {time.monotonic() - start:.1f} s written to {path}")
+    return 0
+
+
+# --- Play -------------------------------------------------------------------------------------
+
+class Player:
+    """Stands in for the press on the firmware port and replays one session to the app."""
+
+    def __init__(self, path: Path, port: int, host: str, speed: float):
+        self.path = path
+        self.speed = speed
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.sock.bind((host, port))
+        self.sock.setblocking(False)
+        self.port = port
+        self.gui: Optional[Tuple[str, int]] = None
+        self.identity = self._identity()
+        self.device_us: Optional[int] = None
+        self.device_at = 0.0
+        self.sent = 0
+
+    def _identity(self) -> str:
+        """The recorded press's discovery fields, without the recorded link's."""
+        with open(self.path, 'r', encoding='ascii', errors='replace') as f:
+            for row in f:
+                index = row.find(DISCOVERY_PREFIX)
+                if index < 0 or row[index - len(SENT_MARK):index] == SENT_MARK:
+                    continue
+                fields = row[index + len(DISCOVERY_PREFIX):].split()
+                kept = [field for field in fields if field.partition('=')[0] not in _LINK_FIELDS]
+                if kept:
+                    return ' '.join(kept)
+        return 'DEVICE_ID=pressboi'
+
+    def clock_us(self) -> int:
+        """Device clock of the replay: the last telemetry time, advanced at the replay speed."""
+        if self.device_us is None:
+            return 0
+        return int(self.device_us + (time.monotonic() - self.device_at) * self.speed * 1e6) & 0xFFFFFFFF
+
+    def receive(self) -> None:
+        while True:
+            try:
+                data, address = self.sock.recvfrom(MAX_PACKET_LENGTH)
+            except (BlockingIOError, InterruptedError, ConnectionResetError):
+                return
+            for line in _lines(data):
+                match = re.match(r'#(\d+) +', line)
+                if line.startswith('DISCOVER_DEVICE'):
+                    self.discover(line, address)
+                elif match:
+                    port = self.gui[1] if self.gui is not None and self.gui[0] == address[0] else address[1]
+                    self.send(f"{ACK_PREFIX}#{match.group(1)}", (address[0], port))
+
+    def discover(self, line: str, address: Tuple[str, int]) -> None:
+        match = re.search(r'PORT=(\d+)', line)
+        if match is None:
+            return
+        if self.gui is None:
+            print(f"app at {address[0]}:{match.group(1)}, replaying at {self.speed:g}x")
+        self.gui = (address[0], int(match.group(1)))
+        reply = f"{DISCOVERY_PREFIX}{self.identity} PORT={self.port} TELEM=TEXT EVENT=TEXT UDP=SINGLE"
+        sync = re.search(r'SYNC=(\S+)', line)
+        if sync:
+            reply += f" SYNC={sync.group(1)} T_US={self.clock_us()}"
+        self.send(reply, self.gui)
+
+    def send(self, text: str, address: Optional[Tuple[str, int]] = None) -> None:
+        address = address or self.gui
+        if address is None:
+            return
+        try:
+            self.sock.sendto(text.encode('ascii', 'replace'), address)
+        except OSError:
+            pass
+
+    def run(self, loop: bool) -> int:
+        selector = selectors.DefaultSelector()
+        selector.register(self.sock, selectors.EVENT_READ)
+        print(f"waiting on port {self.port} for the app's DISCOVER_DEVICE")
+        while self.gui is None:
+            selector.select(1.0)
+            self.receive()
+        while True:
+            renderer = TextRenderer()
+            start = None
+            for seconds, line in read_session(self.path, text=False):
+                line = renderer.render(line)
+                if line is None:
+                    continue
+                if start is None:
+                    start = time.monotonic() - seconds / self.speed
+                due = start + seconds / self.speed
+                while True:
+                    wait = due - time.monotonic()
+                    if wait <= 0:
+                        break
+                    selector.select(wait)
+                    self.receive()
+                if renderer.device_us is not None and renderer.device_us != self.device_us:
+                    self.device_us = renderer.device_us
+                    self.device_at = time.monotonic()
+                self.send(line)
+                self.sent += 1
+            self.receive()
+            print(f"{self.sent} lines replayed")
+            if not loop:
+                return 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Record a press session, or replay one to the app.')
+    commands = parser.add_subparsers(dest='command', required=True)
+    rec = commands.add_parser('record', help='proxy the app to a press and record what the press sends')
+    rec.add_argument('press', help='press IP address')
+    rec.add_argument('session', type=Path, help='session file to write')
+    rec.add_argument('--port', type=int, default=LOCAL_PORT, help='port the app sends to (default %(default)s)')
+    rec.add_argument('--press-port', type=int, default=LOCAL_PORT, help='press command port (default %(default)s)')
+    play = commands.add_parser('play', help='stand in for the press and replay a session to the app')
+    play.add_argument('session', type=Path, help='session file to replay')
+    play.add_argument('--speed', type=float, default=1.0, help='replay speed, e.g. 1 to 20 (default %(default)s)')
+    play.add_argument('--port', type=int, default=LOCAL_PORT, help='port to answer on (default %(default)s)')
+    play.add_argument('--host', default='0.0.0.0', help='address to bind (default %(default)s)')
+    play.add_argument('--loop', action='store_true', help='start again at the end')
+    options = parser.parse_args()
+
+    if options.command == 'record':
+        return record(options.press, options.session, options.port, options.press_port)
+    if options.speed <= 0:
+        parser.error('--speed must be above 0')
+    try:
+        return Player(options.session, options.port, options.host, options.speed).run(options.loop)
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,131 +1,1051 @@
 """
 PressBoi Device Simulator
 Handles pressboi-specific command simulation and state updates.
+
+Two ways to use it:
+
+- As the GUI's simulator plugin: handle_command() and update_state() are called by the
+  DeviceSimulator framework, as before. Moves and homing now step a PressModel in real
+  time instead of sleeping, so positions, forces and joules follow the motion.
+
+- Standalone, as a device emulator that speaks the firmware's UDP protocol:
+
+      python simulator.py                      # one press on port 8888
+      python simulator.py --count 200          # 200 presses on ports 8888..9087
+      python simulator.py --contact 18 --stiffness 250 --tick-ms 2
+      python simulator.py --count 50 --ip 127.0.1.1 --skew-ppm 200 --stats-s 5
+
+  Each emulated press answers DISCOVER_DEVICE, acknowledges "#<id> " requests (and
+  drops retried IDs), accepts text commands and "cmdb <base64>" binary frames, sends
+  PRESSBOI_TELEM text or PRESSBOI_TELEMB binary telemetry at the set_telemetry and
+  set_telemetry_burst rates (plus subscribe_telemetry receivers), batches replies with UDP=BATCH1, and reports
+  counts commands dropped when more than RX_QUEUE_SIZE wait.
+  All presses share one thread and one time base, so a host can be load-tested
+  against hundreds of them from one process.
+
+  With --ip every press gets its own address (consecutive from the one given) on the
+  firmware port, as on a real plant network; one wildcard socket on that port receives
+  broadcast DISCOVER_DEVICE and hands it to every press, which answers from its own
+  address. Linux routes all of 127/8 to loopback; elsewhere add the addresses as
+  interface aliases first. Like real controllers, each press runs on its own crystal
+  (--skew-ppm) and starts its telemetry at a random phase, so a fleet does not send in
+  lockstep, and --jitter-ms adds loop-timing jitter to each telemetry period. --stats-s
+  prints the fleet's receive, telemetry and send rates for benchmarking the host.
+  --announce ADDR makes every press broadcast DISCOVERY_ANNOUNCE to ADDR on CLIENT_PORT
+  at the firmware's jittered period, for hosts that learn the fleet passively.
 """
-import time
+import argparse
+import base64
+import ipaddress
+import json
+import math
+import os
 import random
+import re
+import selectors
+import socket
+import struct
+import threading
+import time
+from collections import deque
+
+
+# Mirrors of the firmware constants (inc/config.h, inc/variables.h)
+FIRMWARE_VERSION = "1.14.1"
+LOCAL_PORT = 8888
+CLIENT_PORT = 6272
+ANNOUNCE_INTERVAL_MS = 5000
+ANNOUNCE_JITTER_MS = 2000
+BULK_TCP_PORT = 8889
+MAX_PACKET_LENGTH = 1024
+RX_QUEUE_SIZE = 64
+RX_DEDUP_HISTORY = 32
+TELEMETRY_INTERVAL_MS = 100
+TELEMETRY_RATE_HZ_MIN = 0.5
+TELEMETRY_RATE_HZ_MAX = 500.0
+TELEMETRY_PRESS_RATE_HZ_DEFAULT = 100.0
+TELEMETRY_PRESS_HOLD_MS_DEFAULT = 250
+TELEMETRY_PRESS_HOLD_MS_MAX = 10000
+TELEMETRY_SUBSCRIBER_COUNT = 4
+TELEMETRY_LEASE_S_DEFAULT = 30
+TELEMETRY_LEASE_S_MAX = 3600
+CLOCK_SYNC_TOKEN_MAX = 16
+TELEM_BINARY_VERSION = 7
+TELEM_BINARY_VALUE_UNKNOWN = 0xFF
+
+PREFIX = "PRESSBOI_"
+
+# Telemetry fields in telemetry.json order: (key, type, precision)
+TELEM_FIELDS = [
+    ("MAIN_STATE", "string", 0),
+    ("force_load_cell", "float", 2),
+    ("force_motor_torque", "float", 2),
+    ("force_limit", "float", 1),
+    ("force_source", "string", 0),
+    ("force_adc_raw", "int", 0),
+    ("joules", "float", 3),
+    ("enabled0", "int", 0),
+    ("enabled1", "int", 0),
+    ("current_pos", "float", 2),
+    ("retract_pos", "float", 2),
+    ("target_pos", "float", 2),
+    ("endpoint", "float", 2),
+    ("startpoint", "float", 2),
+    ("press_threshold", "float", 2),
+    ("torque_avg", "float", 1),
+    ("homed", "int", 0),
+    ("home_sensor_m0", "int", 0),
+    ("home_sensor_m1", "int", 0),
+    ("slow_loops", "int", 0),
+    ("loop_slack_ms", "int", 0),
+    ("force_rate_hz", "float", 1),
+    ("force_jitter_us", "int", 0),
+    ("force_errors", "int", 0),
+    ("force_stuck", "int", 0),
+    ("force_fused", "float", 2),
+    ("station_inputs", "int", 0),
+    ("motor_thermal", "float", 1),
+]
+TELEM_KEYS = [field[0] for field in TELEM_FIELDS]
+
+TELEM_VALUES_MAIN_STATE = ["STANDBY", "BUSY", "ERROR", "DISABLED", "CLEARING_ERRORS", "RESETTING",
+                           "RECOVERED", "UNKNOWN"]
+TELEM_VALUES_FORCE_SOURCE = ["motor_torque", "load_cell"]
+
+# TelemetryBinaryFrame: version, reserved, seq, time_us, 4-byte fields, then 1-byte fields
+TELEM_BINARY_FORMAT = "<BBHIfffiffffffffiifiifif8B"
+TELEM_BINARY_WIDE = ["force_load_cell", "force_motor_torque", "force_limit", "force_adc_raw", "joules",
+                     "current_pos", "retract_pos", "target_pos", "endpoint", "startpoint",
+                     "press_threshold", "torque_avg", "slow_loops", "loop_slack_ms", "force_rate_hz",
+                     "force_jitter_us", "force_errors", "force_fused", "station_inputs", "motor_thermal"]
+TELEM_BINARY_NARROW = ["MAIN_STATE", "force_source", "enabled0", "enabled1", "homed",
+                       "home_sensor_m0", "home_sensor_m1", "force_stuck"]
+assert struct.calcsize(TELEM_BINARY_FORMAT) == 96
+
+
+#==================================================================================================
+# Press Model
+#==================================================================================================
+
+class PressModel:
+    """
+    Time-stepped model of the press axis and the part under it.
+
+    Moves follow a trapezoidal velocity profile. Below the contact position the load
+    cell reads noise only; past it the part pushes back with force = stiffness * depth.
+    Joules integrate force over the distance travelled once the press threshold is
+    crossed, as the firmware does. A move ends at its target, or when the force limit
+    is reached, with the force_action deciding what happens next.
+    """
+
+    def __init__(self, contact_mm=20.0, stiffness_kg_per_mm=300.0, noise_kg=0.05,
+                 accel_mms2=500.0, homing_speed_mms=5.0, travel_mm=100.0):
+        self.contact_mm = contact_mm
+        self.stiffness = stiffness_kg_per_mm
+        self.noise_kg = noise_kg
+        self.accel = accel_mms2
+        self.homing_speed = homing_speed_mms
+        self.travel_mm = travel_mm
+        self.adc_counts_per_kg = 420.0
+
+        self.pos = contact_mm / 2.0
+        self.vel = 0.0
+        self.homed = False
+        self.enabled = True
+        self.retract_pos = 0.0
+        self.press_threshold = 2.0
+        self.force_source = "load_cell"
+
+        self.operation = None      # None, "home", "move", "retract"
+        self.name = None           # Command reported in DONE
+        self.paused = False
+        self.target = 0.0
+        self.speed = 0.0
+        self.force_limit = 1000.0
+        self.force_action = "hold"
+        self.endpoint = 0.0
+        self.startpoint = 0.0
+        self.joules = 0.0
+        self.force = 0.0
+        self.torque_avg = 0.0
+        self.thermal = 0.0
+        self.pressing = False
+        self.result = None         # (prefix, message) once an operation finishes
+
+    # --- Operations -------------------------------------------------------------------------
+
+    def start_home(self):
+        self.operation = "home"
+        self.name = "home"
+        self.target = 0.0
+        self.speed = self.homing_speed
+        self.force_limit = float("inf")
+        self.paused = False
+
+    def start_move(self, target, speed, force_limit, force_action="hold", operation="move", name=None):
+        self.operation = operation
+        self.name = name or operation
+        self.target = min(max(target, 0.0), self.travel_mm)
+        self.speed = max(speed, 0.01)
+        self.force_limit = force_limit
+        self.force_action = force_action
+        self.joules = 0.0
+        self.pressing = False
+        self.startpoint = 0.0
+        self.paused = False
+
+    def stop(self):
+        self.operation = None
+        self.vel = 0.0
+        self.paused = False
+
+    def is_busy(self):
+        return self.operation is not None
+
+    def is_pressing(self):
+        return self.operation not in (None, "home") and self.force >= self.press_threshold
+
+    # --- Physics ----------------------------------------------------------------------------
+
+    def part_force(self, pos):
+        depth = pos - self.contact_mm
+        return self.stiffness * depth if depth > 0.0 else 0.0
+
+    def step(self, dt):
+        """Advances the model by dt seconds."""
+        if self.operation is not None and self.enabled:
+            self._step_motion(dt)
+        self.force = self.part_force(self.pos) + random.gauss(0.0, self.noise_kg)
+        if self.operation is None and self.force < self.noise_kg * 3:
+            self.torque_avg = 0.0
+        else:
+            # Friction plus the torque the part reaction needs
+            self.torque_avg = 5.0 + abs(self.vel) * 0.5 + max(self.force, 0.0) * 0.04
+        # I2t model of the firmware (THERMAL_CONTINUOUS_TORQUE_PCT 50, 300 s time constant)
+        self.thermal += (100.0 * (self.torque_avg / 50.0) ** 2 - self.thermal) * min(dt / 300.0, 1.0)
+
+    def _step_motion(self, dt):
+        if self.paused:
+            self.vel = 0.0
+            return
+        distance = self.target - self.pos
+        direction = 1.0 if distance > 0 else -1.0
+        # Trapezoid: accelerate toward speed, brake so we reach the target at rest
+        stop_speed = math.sqrt(2.0 * self.accel * abs(distance))
+        desired = direction * min(self.speed, stop_speed)
+        max_dv = self.accel * dt
+        self.vel += max(-max_dv, min(max_dv, desired - self.vel))
+        prev = self.pos
+        self.pos += self.vel * dt
+        if (self.target - self.pos) * direction <= 0.0 or abs(distance) < 1e-4:
+            self.pos = self.target
+        moved = abs(self.pos - prev)
+
+        force = self.part_force(self.pos)
+        if force >= self.press_threshold:
+            if not self.pressing:
+                self.pressing = True
+                self.startpoint = self.pos
+            self.joules += force * moved * 0.00981
+        if self.operation in ("move", "retract") and force >= self.force_limit and self.vel > 0.0:
+            self._force_limit_reached()
+            return
+        if self.pos == self.target:
+            self._finish()
+
+    def _force_limit_reached(self):
+        self.endpoint = self.pos
+        action = self.force_action
+        if action == "retract":
+            self.start_move(self.retract_pos, self.speed, float("inf"), "hold", "retract", self.name)
+            self.result = (PREFIX + "INFO: ", "Force limit reached; retracting")
+            return
+        self.stop()
+        if action == "abort":
+            self.result = (PREFIX + "ERROR: ", "Force limit reached; move aborted")
+        else:
+            self.result = (PREFIX + "DONE: ", self.name)
+
+    def _finish(self):
+        operation = self.operation
+        self.stop()
+        if operation == "home":
+            self.homed = True
+            self.joules = 0.0
+        elif operation == "move":
+            self.endpoint = self.pos
+        self.result = (PREFIX + "DONE: ", self.name)
+
+    def take_result(self):
+        result, self.result = self.result, None
+        return result
+
+    # --- Telemetry --------------------------------------------------------------------------
+
+    def telemetry(self, main_state):
+        force = round(self.force, 2)
+        return {
+            "MAIN_STATE": main_state,
+            "force_load_cell": force if self.force_source == "load_cell" else 0.0,
+            "force_motor_torque": round(max(self.force, 0.0) * 1.03, 2),
+            "force_limit": self.force_limit if math.isfinite(self.force_limit) else 0.0,
+            "force_source": self.force_source,
+            "force_adc_raw": int(self.force * self.adc_counts_per_kg),
+            "joules": self.joules,
+            "enabled0": int(self.enabled),
+            "enabled1": int(self.enabled),
+            "current_pos": self.pos,
+            "retract_pos": self.retract_pos,
+            "target_pos": self.target,
+            "endpoint": self.endpoint,
+            "startpoint": self.startpoint,
+            "press_threshold": self.press_threshold,
+            "torque_avg": self.torque_avg,
+            "homed": int(self.homed),
+            "home_sensor_m0": int(self.pos <= 0.05),
+            "home_sensor_m1": int(self.pos <= 0.05),
+            "slow_loops": 0,
+            "loop_slack_ms": 250,
+            "force_rate_hz": 80.0,
+            "force_jitter_us": 0,
+            "force_errors": 0,
+            "force_stuck": 0,
+            "force_fused": force if self.force_source == "load_cell" else 0.0,
+            "station_inputs": 0,
+            "motor_thermal": self.thermal,
+        }
+
+
+def build_text_telemetry(values, time_us, fields=None):
+    parts = [f"t_us:{time_us & 0xFFFFFFFF}"]
+    for key, kind, precision in TELEM_FIELDS:
+        if fields is not None and key not in fields:
+            continue
+        value = values[key]
+        if kind == "float":
+            value = f"{value:.{precision}f}"
+        parts.append(f"{key}:{value}")
+    return PREFIX + "TELEM: " + ",".join(parts)
+
+
+def build_binary_telemetry(values, seq, time_us):
+    def narrow(key):
+        value = values[key]
+        if key == "MAIN_STATE":
+            values_list = TELEM_VALUES_MAIN_STATE
+        elif key == "force_source":
+            values_list = TELEM_VALUES_FORCE_SOURCE
+        else:
+            return int(value) & 0xFF
+        return values_list.index(value) if value in values_list else TELEM_BINARY_VALUE_UNKNOWN
+
+    int_keys = ("force_adc_raw", "slow_loops", "loop_slack_ms", "force_jitter_us", "force_errors")
+    wide = [int(values[key]) if key in int_keys else float(values[key])
+            for key in TELEM_BINARY_WIDE]
+    frame = struct.pack(TELEM_BINARY_FORMAT, TELEM_BINARY_VERSION, 0, seq & 0xFFFF, time_us & 0xFFFFFFFF, *wide,
+                        *[narrow(key) for key in TELEM_BINARY_NARROW])
+    return PREFIX + "TELEMB: " + base64.b64encode(frame).decode("ascii")
+
+
+#==================================================================================================
+# Binary Command Frames (command_args.h)
+#==================================================================================================
+
+_HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def _load_commands():
+    try:
+        with open(os.path.join(_HERE, "commands.json")) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {}
+
+
+def _load_command_ids():
+    """Command enum value -> command name, read from inc/commands.h when it is next to us."""
+    try:
+        with open(os.path.join(_HERE, "..", "inc", "commands.h")) as f:
+            header = f.read()
+    except OSError:
+        return {}
+    strings = dict(re.findall(r'#define\s+CMD_STR_(\w+)\s+"([^"]*)"', header))
+    body = re.search(r"typedef enum \{(.*?)\}\s*Command;", header, re.S)
+    if body is None:
+        return {}
+    names = re.findall(r"^\s*(CMD_\w+)\s*[,=]", body.group(1), re.M)
+    ids = {}
+    for value, name in enumerate(names):
+        text = strings.get(name[len("CMD_"):])
+        if text is not None:
+            ids[value] = text.strip()
+    return ids
+
+
+COMMANDS = _load_commands()
+COMMAND_IDS = _load_command_ids()
+
+
+def decode_command_frame(frame):
+    """Turns a binary command frame back into its text form, or None if it is malformed."""
+    if len(frame) < 2 or frame[0] not in COMMAND_IDS:
+        return None
+    name = COMMAND_IDS[frame[0]]
+    params = COMMANDS.get(name, {}).get("params", [])
+    count = frame[1]
+    if count > len(params):
+        return None
+    words = [name]
+    pos = 2
+    for param in params[:count]:
+        if param.get("rest"):
+            words.append(frame[pos:].decode("ascii", "replace"))
+            pos = len(frame)
+        elif param["type"] == "string":
+            if pos >= len(frame) or pos + 1 + frame[pos] > len(frame):
+                return None
+            words.append(frame[pos + 1:pos + 1 + frame[pos]].decode("ascii", "replace"))
+            pos += 1 + frame[pos]
+        else:
+            if pos + 4 > len(frame):
+                return None
+            kind = "<f" if param["type"] == "float" else "<i"
+            value = struct.unpack_from(kind, frame, pos)[0]
+            words.append(f"{value:g}" if kind == "<f" else str(value))
+            pos += 4
+    return " ".join(words) if pos == len(frame) else None
+
+
+#==================================================================================================
+# UDP Device Emulator
+#==================================================================================================
+
+class PressEmulator:
+    """One emulated press on its own UDP port, stepped by an EmulatorFarm."""
+
+    def __init__(self, port, model, host="0.0.0.0", dispatch_per_tick=8, skew=0.0, jitter_s=0.0, announce=None):
+        self.port = port
+        self.host = host
+        self.model = model
+        self.dispatch_per_tick = dispatch_per_tick
+        self.clock_scale = 1.0 + skew   # Telemetry periods as timed by this press's clock
+        self.boot = time.monotonic() - random.uniform(0.0, 3600.0)
+        self.jitter_s = jitter_s
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.sock.bind((host, port))
+        self.sock.setblocking(False)
+        self.announce = announce   # Broadcast address for DISCOVERY_ANNOUNCE, or None
+        if announce is not None:
+            self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_BROADCAST, 1)
+        # Like the firmware: the first announcement within one jitter span of network-up
+        self.next_announce = time.monotonic() + random.uniform(0.0, ANNOUNCE_JITTER_MS / 1000.0)
+
+        self.gui = None
+        self.binary = False
+        self.batching = False
+        self.main_state = "STANDBY"
+        self.rx = deque()
+        self.recent_ids = deque(maxlen=RX_DEDUP_HISTORY)
+        self.operation_id = 0
+        self.busy_interval = TELEMETRY_INTERVAL_MS / 1000.0
+        self.idle_interval = TELEMETRY_INTERVAL_MS / 1000.0
+        self.press_interval = round(1000.0 / TELEMETRY_PRESS_RATE_HZ_DEFAULT) / 1000.0
+        self.press_hold = TELEMETRY_PRESS_HOLD_MS_DEFAULT / 1000.0
+        self.press_last = None     # When the model last read pressing, while the burst rate applies
+        self.fields = None
+        self.last_telemetry = 0.0
+        self.subscribers = {}      # (ip, port) -> [interval_s, lease_end, last_sent]
+        self.seq = 0
+        self.outbox = {}           # address -> pending lines (one datagram per flush)
+        self.stats = {"rx": 0, "rx_dropped": 0, "tx": 0, "telemetry": 0}
+
+    # --- Receive ----------------------------------------------------------------------------
+
+    def receive(self):
+        while True:
+            try:
+                data, address = self.sock.recvfrom(MAX_PACKET_LENGTH)
+            except (BlockingIOError, InterruptedError):
+                return
+            except OSError:
+                return
+            for line in data.decode("ascii", "replace").split("\n"):
+                line = line.strip("\r\x00 ")
+                if line:
+                    self.receive_line(line, address)
+
+    def receive_line(self, line, address):
+        self.stats["rx"] += 1
+        request_id = 0
+        match = re.match(r"#(\d+) +", line)
+        if match and 0 < int(match.group(1)) <= 0x7FFFFFFF:
+            request_id = int(match.group(1))
+        if request_id and (request_id, address[0]) in self.recent_ids:
+            self.ack(request_id, address)
+            return
+        if len(self.rx) >= RX_QUEUE_SIZE:
+            # Counted only, as the firmware does (its PRESSBOI_COMMS frame carries rx_drops)
+            self.stats["rx_dropped"] += 1
+            return
+        self.rx.append((line, address))
+        if request_id:
+            self.recent_ids.append((request_id, address[0]))
+            self.ack(request_id, address)
+
+    def ack(self, request_id, address):
+        port = self.gui[1] if self.gui is not None and self.gui[0] == address[0] else address[1]
+        self.send(f"{PREFIX}ACK: #{request_id}", (address[0], port))
+
+    # --- Send -------------------------------------------------------------------------------
+
+    def send(self, text, address=None):
+        address = address or self.gui
+        if address is None:
+            return
+        self.outbox.setdefault(address, []).append(text)
+
+    def report(self, prefix, message, request_id=0):
+        tag = f"#{request_id} " if request_id else ""
+        self.send(f"{PREFIX}{prefix}: {tag}{message}")
+
+    def flush(self):
+        for address, lines in self.outbox.items():
+            datagram = ""
+            for line in lines:
+                if self.batching and datagram and len(datagram) + 1 + len(line) <= MAX_PACKET_LENGTH:
+                    datagram += "\n" + line
+                    continue
+                if datagram:
+                    self._sendto(datagram, address)
+                datagram = line
+            if datagram:
+                self._sendto(datagram, address)
+        self.outbox.clear()
+
+    def _sendto(self, datagram, address):
+        try:
+            self.sock.sendto(datagram.encode("ascii", "replace"), address)
+            self.stats["tx"] += 1
+        except OSError:
+            pass
+
+    # --- Loop pass --------------------------------------------------------------------------
+
+    def tick(self, now, dt):
+        self.receive()
+        self.dispatch()
+        self.model.step(dt)
+        result = self.model.take_result()
+        if result is not None:
+            prefix, message = result
+            tag = f"#{self.operation_id} " if self.operation_id else ""
+            self.send(f"{prefix}{tag}{message}")
+            if not self.model.is_busy():
+                self.operation_id = 0
+                if prefix.endswith("ERROR: "):
+                    self.main_state = "ERROR"
+        if self.main_state == "BUSY" and not self.model.is_busy():
+            self.main_state = "STANDBY"
+        self.telemetry(now)
+        self.announce_due(now)
+        self.flush()
+
+    def announce_due(self, now):
+        if self.announce is None or now < self.next_announce:
+            return
+        # A locally administered MAC unique to the address and port
+        mac = ((int(ipaddress.IPv4Address(self.host)) << 16) ^ self.port) & 0xFFFFFFFF
+        mac_text = ":".join(f"{byte:02X}" for byte in (0x02, 0x00) + tuple(mac.to_bytes(4, "big")))
+        self._sendto(f"DISCOVERY_ANNOUNCE: DEVICE_ID=pressboi PORT={self.port} FW={FIRMWARE_VERSION} "
+                     f"BULK={BULK_TCP_PORT} IP={self.host} MAC={mac_text}", (self.announce, CLIENT_PORT))
+        self.next_announce = now + (ANNOUNCE_INTERVAL_MS - ANNOUNCE_JITTER_MS / 2
+                                    + random.uniform(0.0, ANNOUNCE_JITTER_MS)) / 1000.0
+
+    def dispatch(self):
+        for _ in range(self.dispatch_per_tick):
+            if not self.rx:
+                return
+            line, address = self.rx.popleft()
+            request_id = 0
+            match = re.match(r"#(\d+) +(.*)", line)
+            if match:
+                request_id, line = int(match.group(1)), match.group(2)
+            busy_before = self.model.is_busy()
+            self.handle(line, address, request_id)
+            if self.model.is_busy() and not busy_before:
+                self.operation_id = request_id
+                self.main_state = "BUSY"
+                # Like the firmware, an operation ends the burst
+                return
+
+    def telemetry(self, now):
+        due = []
+        if self.gui is not None:
+            interval = self.busy_interval if self.model.is_busy() else self.idle_interval
+            if self.press_interval > 0.0:
+                if self.model.is_pressing():
+                    self.press_last = now
+                elif self.press_last is not None and now - self.press_last > self.press_hold * self.clock_scale:
+                    self.press_last = None
+                if self.press_last is not None:
+                    interval = min(interval, self.press_interval)
+            interval *= self.clock_scale
+            if now - self.last_telemetry >= interval:
+                self.last_telemetry = now
+                if self.jitter_s:
+                    self.last_telemetry += random.uniform(-self.jitter_s, self.jitter_s)
+                due.append(self.gui)
+            else:
+                # Subscribers get copies of the GUI's frames, not frames of their own
+                return
+        for address, entry in list(self.subscribers.items()):
+            interval, lease_end, last_sent = entry
+            if now >= lease_end:
+                del self.subscribers[address]
+            elif now - last_sent >= interval:
+                entry[2] = now
+                due.append(address)
+        if due:
+            self.send_telemetry(due)
+
+    def send_telemetry(self, addresses):
+        # Like the firmware, the frame is built once and copied to every receiver due, so
+        # the binary frame counter only skips when a receiver missed a frame
+        values = self.model.telemetry(self.main_state)
+        if self.binary:
+            text = build_binary_telemetry(values, self.seq, self.device_us())
+            self.seq += 1
+        else:
+            text = build_text_telemetry(values, self.device_us(), self.fields)
+        for address in addresses:
+            self.stats["telemetry"] += 1
+            self.send(text, address)
+
+    def device_us(self):
+        """Microseconds() of this press: its own boot time and clock error, wrapping at 32 bits."""
+        return int((time.monotonic() - self.boot) / self.clock_scale * 1e6) & 0xFFFFFFFF
+
+    # --- Commands ---------------------------------------------------------------------------
+
+    def handle(self, line, address, request_id):
+        if line.startswith("DISCOVER_DEVICE"):
+            self.discover(line, address)
+            return
+        words = line.split()
+        command = words[0].lower() if words else ""
+        args = words[1:]
+        if command == "cmdb":
+            try:
+                text = decode_command_frame(base64.b64decode(args[0], validate=True)) if args else None
+            except ValueError:
+                text = None
+            if text is None:
+                self.report("ERROR", "Invalid cmdb frame", request_id)
+                return
+            self.handle(text, address, request_id)
+            return
+
+        model = self.model
+        if model.is_busy() and command in ("home", "move_abs", "move_inc", "retract"):
+            self.report("ERROR", f"{command} rejected: an operation is already running", request_id)
+            return
+        try:
+            if command == "home":
+                model.start_home()
+                self.report("START", "HOME initiated (parallel mode).", request_id)
+            elif command in ("move_abs", "move_inc"):
+                if not model.homed:
+                    self.report("ERROR", "Must home before moving.", request_id)
+                    return
+                target = float(args[0]) + (model.pos if command == "move_inc" else 0.0)
+                action = args[3] if len(args) > 3 else "hold"
+                model.start_move(target, float(args[1]), float(args[2]), action, name=command)
+                self.report("START", f"{command} to {model.target:.3f} mm at {model.speed:.2f} mm/s initiated",
+                            request_id)
+            elif command == "retract":
+                speed = float(args[0]) if args else 25.0
+                model.start_move(model.retract_pos, speed, float("inf"), "hold", operation="retract")
+                self.report("START", f"retract to {model.retract_pos:.3f} mm at {speed:.2f} mm/s initiated",
+                            request_id)
+            elif command == "set_retract":
+                model.retract_pos = float(args[0])
+                self.report("DONE", "set_retract", request_id)
+            elif command == "set_press_threshold":
+                model.press_threshold = float(args[0])
+                self.report("DONE", "set_press_threshold", request_id)
+            elif command == "set_force_mode":
+                model.force_source = "motor_torque" if args[0] == "motor_torque" else "load_cell"
+                self.report("DONE", "set_force_mode", request_id)
+            elif command in ("pause", "resume"):
+                model.paused = command == "pause" and model.is_busy()
+                self.report("DONE", command, request_id)
+            elif command == "cancel":
+                model.stop()
+                self.report("DONE", "cancel", request_id)
+            elif command in ("enable", "disable"):
+                model.enabled = command == "enable"
+                if not model.enabled:
+                    model.stop()
+                self.main_state = "STANDBY" if model.enabled else "DISABLED"
+                self.report("DONE", command, request_id)
+            elif command == "reset":
+                model.stop()
+                self.main_state = "STANDBY" if model.enabled else "DISABLED"
+                self.report("DONE", "reset", request_id)
+            elif command == "set_telemetry":
+                self.set_telemetry(args, request_id)
+            elif command == "set_telemetry_burst":
+                self.set_telemetry_burst(args, request_id)
+            elif command == "subscribe_telemetry":
+                self.subscribe(args, address)
+            elif command == "unsubscribe_telemetry":
+                key = (address[0], int(args[0]))
+                if self.subscribers.pop(key, None) is not None:
+                    self.send(f"{PREFIX}DONE: unsubscribe_telemetry", key)
+                else:
+                    self.send(f"{PREFIX}ERROR: Not subscribed to telemetry", address)
+            elif command in COMMANDS:
+                self.report("INFO", f"{command} is not emulated", request_id)
+                self.report("DONE", command, request_id)
+            else:
+                self.report("ERROR", "Unknown command sent to Pressboi.", request_id)
+        except (IndexError, ValueError):
+            self.report("ERROR", f"Invalid parameters for {command}", request_id)
+
+    def discover(self, line, address):
+        match = re.search(r"PORT=(\d+)", line)
+        if match is None:
+            return
+        gui_port = int(match.group(1))
+        if self.gui is None:
+            # Power-up phase: the first frame goes out anywhere within one period
+            self.last_telemetry = time.monotonic() - random.uniform(0.0, self.idle_interval)
+        self.gui = (address[0], gui_port)
+        self.binary = "TELEM=BIN1" in line
+        self.batching = "UDP=BATCH1" in line
+        self.send(f"DISCOVERY_RESPONSE: DEVICE_ID=pressboi PORT={self.port} FW={FIRMWARE_VERSION} "
+                  f"TELEM={'BIN1' if self.binary else 'TEXT'} EVENT=TEXT UDP={'BATCH1' if self.batching else 'SINGLE'} "
+                  f"BULK={BULK_TCP_PORT}{self.sync_reply(line)}", self.gui)
+
+    def sync_reply(self, line):
+        match = re.search(r"SYNC=(\S+)", line)
+        if match is None:
+            return ""
+        return f" SYNC={match.group(1)[:CLOCK_SYNC_TOKEN_MAX]} T_US={self.device_us()}"
+
+    def set_telemetry(self, args, request_id):
+        busy_hz = float(args[0])
+        idle_hz = float(args[1]) if len(args) > 1 else busy_hz
+        fields = args[2] if len(args) > 2 else "all"
+        rates_ok = all(TELEMETRY_RATE_HZ_MIN <= hz <= TELEMETRY_RATE_HZ_MAX for hz in (busy_hz, idle_hz))
+        keys = None if fields == "all" else set(fields.split(","))
+        if not rates_ok or (keys is not None and not keys <= set(TELEM_KEYS)):
+            self.report("ERROR", "Invalid parameters for set_telemetry", request_id)
+            return
+        self.busy_interval = round(1000.0 / busy_hz) / 1000.0
+        self.idle_interval = round(1000.0 / idle_hz) / 1000.0
+        self.fields = keys
+        self.report("DONE", "set_telemetry", request_id)
+
+    def set_telemetry_burst(self, args, request_id):
+        press_hz = float(args[0])
+        hold_ms = int(args[1]) if len(args) > 1 else round(self.press_hold * 1000.0)
+        rate_ok = press_hz == 0.0 or TELEMETRY_RATE_HZ_MIN <= press_hz <= TELEMETRY_RATE_HZ_MAX
+        if not rate_ok or not 0 <= hold_ms <= TELEMETRY_PRESS_HOLD_MS_MAX:
+            self.report("ERROR", "Invalid parameters for set_telemetry_burst", request_id)
+            return
+        self.press_interval = round(1000.0 / press_hz) / 1000.0 if press_hz > 0.0 else 0.0
+        self.press_hold = hold_ms / 1000.0
+        self.press_last = None
+        self.report("DONE", "set_telemetry_burst", request_id)
+
+    def subscribe(self, args, address):
+        port = int(args[0])
+        rate_hz = float(args[1])
+        lease_s = int(args[2]) if len(args) > 2 else TELEMETRY_LEASE_S_DEFAULT
+        if not (1 <= port <= 65535 and TELEMETRY_RATE_HZ_MIN <= rate_hz <= TELEMETRY_RATE_HZ_MAX and
+                1 <= lease_s <= TELEMETRY_LEASE_S_MAX):
+            self.send(f"{PREFIX}ERROR: Invalid parameters for subscribe_telemetry. "
+                      "Use '<port> <rate_hz 0.5-500> [lease_s 1-3600]'", address)
+            return
+        key = (address[0], port)
+        if key not in self.subscribers and len(self.subscribers) >= TELEMETRY_SUBSCRIBER_COUNT:
+            self.send(f"{PREFIX}ERROR: Telemetry subscriber table full", key)
+            return
+        interval_ms = int(1000.0 / rate_hz + 0.5)
+        self.subscribers[key] = [interval_ms / 1000.0, time.monotonic() + lease_s, 0.0]
+        self.send(f"{PREFIX}INFO: Telemetry every {interval_ms} ms for {lease_s} s "
+                  f"({len(self.subscribers)} of {TELEMETRY_SUBSCRIBER_COUNT} subscribers)", key)
+        self.send(f"{PREFIX}DONE: subscribe_telemetry", key)
+
+    def close(self):
+        self.sock.close()
+
+
+class EmulatorFarm:
+    """Steps any number of PressEmulators from one thread on a fixed tick."""
+
+    def __init__(self, emulators, tick_s=0.002, discovery_port=None, stats_s=0.0):
+        self.emulators = emulators
+        self.tick_s = tick_s
+        self.selector = selectors.DefaultSelector()
+        for emulator in emulators:
+            self.selector.register(emulator.sock, selectors.EVENT_READ, emulator)
+        self.overruns = 0
+        self.stats_s = stats_s
+        self.discovery = None
+        if discovery_port is not None:
+            # Presses bound to their own addresses do not see broadcasts; this socket does
+            self.discovery = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+            self.discovery.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+            self.discovery.bind(("0.0.0.0", discovery_port))
+            self.discovery.setblocking(False)
+            self.selector.register(self.discovery, selectors.EVENT_READ, None)
+
+    def totals(self):
+        """Sum of the per-press counters."""
+        totals = {}
+        for emulator in self.emulators:
+            for key, value in emulator.stats.items():
+                totals[key] = totals.get(key, 0) + value
+        return totals
+
+    def receive_discovery(self):
+        while True:
+            try:
+                data, address = self.discovery.recvfrom(MAX_PACKET_LENGTH)
+            except OSError:
+                return
+            line = data.decode("ascii", "replace").strip("\r\n\x00 ")
+            if not line.startswith("DISCOVER_DEVICE"):
+                continue
+            # A probe sent to one press's own address reaches that press's socket instead
+            for emulator in self.emulators:
+                emulator.discover(line, address)
+
+    def report_stats(self, now, last_report, last_totals):
+        totals = self.totals()
+        elapsed = now - last_report
+        rates = ", ".join(f"{key} {(totals[key] - last_totals.get(key, 0)) / elapsed:.0f}/s"
+                          for key in ("rx", "telemetry", "tx"))
+        connected = sum(1 for emulator in self.emulators if emulator.gui is not None)
+        print(f"{connected}/{len(self.emulators)} discovered, {rates}, "
+              f"dropped {totals['rx_dropped']}, tick overruns {self.overruns}")
+        return totals
+
+    def run(self, stop_event=None):
+        last = time.monotonic()
+        next_tick = last
+        last_report = last
+        last_totals = self.totals()
+        while stop_event is None or not stop_event.is_set():
+            now = time.monotonic()
+            dt = now - last
+            last = now
+            if self.discovery is not None:
+                self.receive_discovery()
+            for emulator in self.emulators:
+                emulator.tick(now, dt)
+            if self.stats_s and now - last_report >= self.stats_s:
+                last_totals = self.report_stats(now, last_report, last_totals)
+                last_report = now
+            next_tick += self.tick_s
+            remaining = next_tick - time.monotonic()
+            if remaining > 0:
+                # Wake early for traffic; telemetry deadlines are checked every tick anyway
+                self.selector.select(remaining)
+            else:
+                self.overruns += 1
+                next_tick = time.monotonic()
+
+    def close(self):
+        self.selector.close()
+        if self.discovery is not None:
+            self.discovery.close()
+        for emulator in self.emulators:
+            emulator.close()
+
+
+#==================================================================================================
+# GUI Simulator Plugin
+#==================================================================================================
+
+_models = {}
+_model_lock = threading.Lock()
+
+
+def _model_for(device_sim):
+    """The PressModel behind a DeviceSimulator, seeded from its state on first use."""
+    with _model_lock:
+        model = _models.get(id(device_sim))
+        if model is None:
+            model = PressModel()
+            model.pos = float(device_sim.state.get('current_pos', model.pos))
+            model.retract_pos = float(device_sim.state.get('retract_pos', 0.0))
+            model.homed = bool(device_sim.state.get('homed', 0))
+            _models[id(device_sim)] = model
+        return model
 
 
 def handle_command(device_sim, command, args, gui_address):
     """
     Handle pressboi-specific commands.
-    
+
     Args:
         device_sim: Reference to the DeviceSimulator instance
         command: Command string (e.g., "pressboi.home")
         args: List of command arguments
         gui_address: Tuple of (ip, port) for GUI
-    
+
     Returns:
         True if command was handled, False to use default handler
     """
     # Normalize to lowercase for case-insensitive matching
     cmd_lower = command.lower()
-    
+    model = _model_for(device_sim)
+
     if cmd_lower == "pressboi.home":
         device_sim.set_state('MAIN_STATE', 'HOMING')
-        device_sim.command_queue.append((simulate_homing, (device_sim, 2.0, gui_address, command)))
+        model.start_home()
+        device_sim.command_queue.append((simulate_operation, (device_sim, gui_address, command)))
         return True
-    
-    elif cmd_lower == "pressboi.move":
+
+    elif cmd_lower in ("pressboi.move", "pressboi.move_abs", "pressboi.move_inc"):
         target = float(args[0]) if args else 0
+        if cmd_lower == "pressboi.move_inc":
+            target += model.pos
+        speed = float(args[1]) if len(args) > 1 else 6.25
+        force = float(args[2]) if len(args) > 2 else 1000.0
+        action = args[3] if len(args) > 3 else "hold"
         device_sim.set_state('MAIN_STATE', 'MOVING')
-        device_sim.command_queue.append((simulate_move, (device_sim, target, 2.0, gui_address, command)))
+        model.start_move(target, speed, force, action)
+        device_sim.command_queue.append((simulate_operation, (device_sim, gui_address, command)))
         return True
-    
+
     elif cmd_lower == "pressboi.set_retract":
         pos = float(args[0]) if args else 0
         device_sim.state['retract_pos'] = pos
+        model.retract_pos = pos
         return False  # Send generic DONE response
-    
+
+    elif cmd_lower == "pressboi.set_press_threshold":
+        model.press_threshold = float(args[0]) if args else model.press_threshold
+        return False
+
     elif cmd_lower == "pressboi.retract":
-        target = device_sim.state.get('retract_pos', 0.0)
         speed = float(args[0]) if args else 6.25  # Optional speed parameter
-        duration = abs(target - device_sim.state.get('current_pos', 0.0)) / speed if speed > 0 else 2.0
         device_sim.set_state('MAIN_STATE', 'MOVING')
-        device_sim.command_queue.append((simulate_move, (device_sim, target, duration, gui_address, command)))
+        model.start_move(model.retract_pos, speed, float("inf"), "hold", operation="retract")
+        device_sim.command_queue.append((simulate_operation, (device_sim, gui_address, command)))
         return True
-    
+
+    elif cmd_lower in ("pressboi.cancel", "pressboi.pause", "pressboi.resume"):
+        if cmd_lower == "pressboi.cancel":
+            model.stop()
+        else:
+            model.paused = cmd_lower == "pressboi.pause" and model.is_busy()
+        return False
+
     return False  # Command not handled, use default
 
 
-def simulate_homing(device_sim, duration, gui_address, command):
-    """Simulates pressboi homing process."""
-    print(f"[pressboi] simulate_homing started, will sleep for {duration}s")
-    time.sleep(duration)
-    if device_sim._stop_event.is_set():
-        print(f"[pressboi] simulate_homing aborted (stop event)")
-        return
-    
-    device_sim.state['current_pos'] = 0.0
-    device_sim.state['homed'] = 1
-    device_sim.state['force_load_cell'] = 0.0
-    device_sim.state['force_motor_torque'] = 0.0
-    device_sim.state['force_source'] = "load_cell"
-    device_sim.state['joules'] = 0.0  # Reset joules on home
-    device_sim.set_state('MAIN_STATE', 'STANDBY')
-    # Send generic DONE message that includes the original command for the script runner
-    print(f"[pressboi] Sending DONE: {command} to {gui_address}")
-    device_sim.sock.sendto(f"DONE: {command}".encode(), gui_address)
-    print(f"[pressboi] Homing complete")
-
-
-def simulate_move(device_sim, target, duration, gui_address, command):
-    """Simulates pressboi move process with force simulation."""
-    start_time = time.time()
-    start_pos = device_sim.state.get('current_pos', 0.0)
-    
-    # Reset joules at start of move
-    device_sim.state['joules'] = 0.0
-    prev_pos = start_pos
-    
-    while time.time() - start_time < duration:
-        elapsed = time.time() - start_time
-        progress = elapsed / duration
-        device_sim.state['current_pos'] = start_pos + (target - start_pos) * progress
-        current_pos = device_sim.state['current_pos']
-        
-        # Simulate both force values during move (in kg)
-        force_kg = random.uniform(50, 300)  # Simulate realistic pressing force
-        device_sim.state['force_load_cell'] = force_kg
-        device_sim.state['force_motor_torque'] = force_kg
-        device_sim.state['force_source'] = "load_cell"  # Default to load cell mode
-        # Simulate average torque
-        device_sim.state['torque_avg'] = random.uniform(20, 60)
-        
-        # Calculate joules: Energy = Force (N) × Distance (m)
-        # Force in kg → Newtons: kg × 9.81
-        # Distance in mm → meters: mm × 0.001
-        distance_mm = abs(current_pos - prev_pos)
-        device_sim.state['joules'] += force_kg * distance_mm * 0.00981
-        prev_pos = current_pos
-        
-        time.sleep(0.1)
+def simulate_operation(device_sim, gui_address, command, tick_s=0.01):
+    """Steps the model in real time until the operation started by command finishes."""
+    model = _model_for(device_sim)
+    last = time.monotonic()
+    while model.is_busy():
+        time.sleep(tick_s)
         if device_sim._stop_event.is_set():
+            print(f"[pressboi] {command} aborted (stop event)")
             return
-    
-    device_sim.state['current_pos'] = target
-    device_sim.state['force_load_cell'] = 0
-    device_sim.state['force_motor_torque'] = 0
-    device_sim.state['force_source'] = "load_cell"
-    device_sim.state['target_pos'] = target
-    device_sim.state['torque_avg'] = 0
-    # Joules persists after move completes, showing total energy expended
-    device_sim.set_state('MAIN_STATE', 'STANDBY')
+        now = time.monotonic()
+        model.step(now - last)
+        last = now
+        _publish(device_sim, model)
+    result = model.take_result()
+    _publish(device_sim, model)
+    device_sim.set_state('MAIN_STATE', 'ERROR' if result and result[0].endswith("ERROR: ") else 'STANDBY')
     # Send generic DONE message that includes the original command for the script runner
     device_sim.sock.sendto(f"DONE: {command}".encode(), gui_address)
-    print(f"[pressboi] Move complete to {target}, Energy expended: {device_sim.state['joules']:.1f} J")
+    print(f"[pressboi] {command} complete at {model.pos:.2f} mm, Energy expended: {model.joules:.3f} J")
+
+
+def _publish(device_sim, model):
+    values = model.telemetry(device_sim.state.get('MAIN_STATE', 'STANDBY'))
+    values.pop('MAIN_STATE')
+    device_sim.state.update(values)
 
 
 def update_state(device_sim):
     """
     Update pressboi dynamic state (called periodically).
-    
+
     Args:
         device_sim: Reference to the DeviceSimulator instance
     """
-    # Add any continuous state updates here
-    # e.g., temperature drift, sensor noise, etc.
-    pass
+    # Idle sensor noise; operations publish their own state while they run
+    model = _model_for(device_sim)
+    if not model.is_busy():
+        model.step(0.0)
+        _publish(device_sim, model)
+
+
+#==================================================================================================
+# Standalone Emulator
+#==================================================================================================
+
+def main():
+    parser = argparse.ArgumentParser(description="Emulate one or more Pressboi controllers over UDP.")
+    parser.add_argument("--count", type=int, default=1, help="number of presses (consecutive ports)")
+    parser.add_argument("--port", type=int, default=LOCAL_PORT, help="UDP port of the first press")
+    parser.add_argument("--host", default="0.0.0.0", help="address to bind")
+    parser.add_argument("--ip", help="give each press its own address, consecutive from this one, "
+                                     "all on --port (instead of consecutive ports on --host)")
+    parser.add_argument("--tick-ms", type=float, default=2.0, help="loop pass period in ms")
+    parser.add_argument("--dispatch", type=int, default=8, help="commands handled per loop pass")
+    parser.add_argument("--contact", type=float, default=20.0, help="part contact position in mm")
+    parser.add_argument("--stiffness", type=float, default=300.0, help="part stiffness in kg/mm")
+    parser.add_argument("--noise", type=float, default=0.05, help="load cell noise (1 sigma) in kg")
+    parser.add_argument("--spread", type=float, default=0.0,
+                        help="random +/- spread of contact (mm) and stiffness (fraction) between presses")
+    parser.add_argument("--skew-ppm", type=float, default=0.0,
+                        help="random +/- clock error of each press, in ppm of its telemetry periods")
+    parser.add_argument("--jitter-ms", type=float, default=0.0, help="random +/- jitter of each telemetry period")
+    parser.add_argument("--stats-s", type=float, default=0.0, help="print fleet traffic rates every N seconds")
+    parser.add_argument("--announce", metavar="ADDR",
+                        help="broadcast DISCOVERY_ANNOUNCE to ADDR:%d like the firmware (e.g. 255.255.255.255)" % CLIENT_PORT)
+    options = parser.parse_args()
+
+    emulators = []
+    for i in range(options.count):
+        contact = options.contact + random.uniform(-options.spread, options.spread)
+        stiffness = options.stiffness * (1.0 + random.uniform(-options.spread, options.spread) / 10.0)
+        model = PressModel(contact_mm=contact, stiffness_kg_per_mm=stiffness, noise_kg=options.noise)
+        skew = random.uniform(-options.skew_ppm, options.skew_ppm) * 1e-6
+        if options.ip:
+            host, port = str(ipaddress.IPv4Address(options.ip) + i), options.port
+        else:
+            host, port = options.host, options.port + i
+        emulators.append(PressEmulator(port, model, host, options.dispatch, skew, options.jitter_ms / 1000.0,
+                                       options.announce))
+    farm = EmulatorFarm(emulators, options.tick_ms / 1000.0,
+                        discovery_port=options.port if options.ip else None, stats_s=options.stats_s)
+    if options.ip:
+        print(f"Emulating {options.count} press(es) on {emulators[0].host}..{emulators[-1].host} UDP {options.port}")
+    else:
+        print(f"Emulating {options.count} press(es) on UDP {options.port}..{options.port + options.count - 1}")
+    try:
+        farm.run()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        rx = sum(e.stats["rx"] for e in emulators)
+        dropped = sum(e.stats["rx_dropped"] for e in emulators)
+        telemetry = sum(e.stats["telemetry"] for e in emulators)
+        print(f"rx {rx}, dropped {dropped}, telemetry {telemetry}, tick overruns {farm.overruns}")
+        farm.close()
 
 
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,90 @@
+"""
+Typed Status Event Decoder
+
+A host that sends EVENT=BIN1 in DISCOVER_DEVICE gets the control path's typed status events
+as "PRESSBOI_EVENTB: <base64>" records (EventRecord in inc/event_queue.h) instead of text.
+decode_line() renders a record into exactly the line a text client gets, from the same
+templates in status_events.json the firmware uses, so the rest of the receive path (script
+holds on ERROR, DONE matching) does not change. The record's fields stay available as a
+StatusEvent for consumers that want the numbers.
+
+Typical use in the host's receive path:
+
+    event = status_events.decode_line(line)
+    if event is not None:
+        line = event.text
+"""
+
+import base64
+import binascii
+import json
+import struct
+from pathlib import Path
+from typing import Any, Dict, List, NamedTuple, Optional, Union
+
+EVENTB_PREFIX = 'PRESSBOI_EVENTB: '
+DEVICE_PREFIX = 'PRESSBOI_'
+
+# EventRecord: id, reserved, seq, request_id, time_us, three 4-byte arguments
+RECORD_STRUCT = struct.Struct('<BBHII12s')
+assert RECORD_STRUCT.size == 24
+
+
+class StatusEvent(NamedTuple):
+    name: str                   # status_events.json key
+    status: str                 # INFO, ERROR, ...
+    seq: int                    # Post counter (gaps mean dropped events)
+    request_id: int             # 0 = none
+    time_us: int                # Device Microseconds() when posted
+    args: Dict[str, Union[int, float]]
+    text: str                   # The line a text client gets
+
+
+class StatusEventDecoder:
+    """
+    PRESSBOI_EVENTB records to StatusEvents, rendered with status_events.json.
+    """
+
+    def __init__(self, definition_path: Optional[Union[str, Path]] = None):
+        """
+        Args:
+            definition_path: status_events.json (default: the one next to this module)
+        """
+        if definition_path is None:
+            definition_path = Path(__file__).parent / 'status_events.json'
+        with open(definition_path, 'r') as f:
+            definition = json.load(f)
+        self._events: Dict[int, Dict[str, Any]] = {}
+        for name, event in definition.items():
+            self._events[event['id']] = dict(event, name=name)
+
+    def decode_line(self, line: str) -> Optional[StatusEvent]:
+        """
+        Decode one received line.
+
+        Returns:
+            The event, or None if the line is not a typed event record (or is garbled)
+        """
+        if not line.startswith(EVENTB_PREFIX):
+            return None
+        try:
+            record = base64.b64decode(line[len(EVENTB_PREFIX):].strip(), validate=True)
+        except (binascii.Error, ValueError):
+            return None
+        if len(record) != RECORD_STRUCT.size:
+            return None
+        event_id, _, seq, request_id, time_us, raw_args = RECORD_STRUCT.unpack(record)
+        event = self._events.get(event_id)
+        if event is None:
+            return None
+        values: List[Union[int, float]] = []
+        args: Dict[str, Union[int, float]] = {}
+        for index, arg in enumerate(event.get('args', [])):
+            code = '<f' if arg.get('type', 'int') == 'float' else '<i'
+            value = struct.unpack_from(code, raw_args, index * 4)[0]
+            values.append(value)
+            args[arg['parameter']] = value
+        body = event['text'].format(*values)
+        request = f"#{request_id} " if request_id else ''
+        text = f"{DEVICE_PREFIX}{event['status']}: {request}{body}"
+        return StatusEvent(event['name'], event['status'], seq, request_id, time_us, args, text)
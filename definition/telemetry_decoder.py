@@ -0,0 +1,394 @@
+"""
+Typed Telemetry Decoder
+
+Decodes PRESSBOI_TELEM text frames into typed values (float, int or the state string) using
+one converter per field generated from telemetry.json, so consumers get numbers straight off
+the wire instead of parsing them back out of "12.34 mm" display strings. Text is produced
+only at the widget boundary: publish() formats each changed field with its telemetry.json
+precision and unit and writes it to the field's gui_var, skipping fields whose text did not
+change.
+
+Listeners registered with add_listener() are called once per frame with the decoded fields
+of that frame (a delta frame carries only some of them); values holds the latest value of
+every field. The decoder does no locking: feed it from the thread that owns the listeners
+(the Tk main loop for GUI listeners).
+
+Every frame starts with t_us, the device's Microseconds() when it was sampled. It is kept
+out of the fields: frame_time is that instant on the host clock once the decoder's
+DeviceClock has seen a clock-sync reply, so curves from several presses line up without the
+network jitter of arrival times. To sync, add SYNC=<clock.sync_token()> to DISCOVER_DEVICE
+(repeat it every few seconds); feed_line() hands the reply to the clock.
+
+Binary frames (PRESSBOI_TELEMB, asked for with TELEM=BIN1 in DISCOVER_DEVICE) decode into
+the same typed values. Their TelemetryBinaryFrame layout is derived from telemetry.json the
+way the firmware generator lays it out: a version/seq/time header, then every float and
+unmapped int as 4 bytes in definition order, then the string fields (as an index into
+their values) and the mapped ints as 1 byte each. Gaps in the frame counter are counted in
+lost_frames.
+
+The low-rate PRESSBOI_COMMS frame (queue high-water marks and drop counters since boot,
+every COMMS_STATS_INTERVAL_MS) is kept apart from the fields, in comms.
+
+Typical use in the host's receive path:
+
+    decoder = shared_gui_refs['pressboi_telemetry']
+    if decoder.feed_line(line):
+        decoder.publish(shared_gui_refs)
+"""
+
+import base64
+import binascii
+import itertools
+import json
+import re
+import struct
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple, Union
+
+TELEM_PREFIX = 'PRESSBOI_TELEM: '
+TELEM_BINARY_PREFIX = 'PRESSBOI_TELEMB: '
+TELEM_BINARY_VALUE_UNKNOWN = 0xFF
+COMMS_PREFIX = 'PRESSBOI_COMMS: '
+TIME_KEY = 't_us'
+DISCOVERY_PREFIX = 'DISCOVERY_RESPONSE: '
+
+_SYNC_RE = re.compile(r'SYNC=(\S+) T_US=(\d+)')
+
+Listener = Callable[[Dict[str, Any]], None]
+
+
+def _int_converter(text: str) -> int:
+    # Tolerates "3.0", as some firmware builds print ints through the float path
+    try:
+        return int(text)
+    except ValueError:
+        return int(float(text))
+
+
+def _float_formatter(precision: int, suffix: str) -> Callable[[float], str]:
+    spec = f".{precision}f"
+
+    def format_value(value: float) -> str:
+        return f"{value:{spec}}{suffix}"
+    return format_value
+
+
+def _int_formatter(suffix: str, value_map: Dict[str, str]) -> Callable[[int], str]:
+    def format_value(value: int) -> str:
+        text = str(value)
+        return value_map.get(text, text + suffix)
+    return format_value
+
+
+def build_fields(definition: Dict[str, Any]) -> Dict[str, Tuple[Callable[[str], Any], Callable[[Any], str], Optional[str]]]:
+    """
+    Generates the per-field converter, formatter and GUI variable name from telemetry.json.
+
+    Args:
+        definition: Parsed telemetry.json
+
+    Returns:
+        Field key to (parse text -> value, format value -> display text, gui_var or None);
+        string fields (the states) pass through as text, and int fields with a map show
+        the mapped text ('homed', 'enabled')
+    """
+    fields = {}
+    for key, field in definition.items():
+        kind = field.get('type', 'float')
+        unit = field.get('unit')
+        suffix = f" {unit}" if unit else ''
+        if kind == 'float':
+            fields[key] = (float, _float_formatter(field.get('precision', 2), suffix), field.get('gui_var'))
+        elif kind == 'int':
+            fields[key] = (_int_converter, _int_formatter(suffix, field.get('map', {})), field.get('gui_var'))
+        else:
+            fields[key] = (str, str, field.get('gui_var'))
+    return fields
+
+
+def build_binary_layout(definition: Dict[str, Any]) -> Tuple[struct.Struct, List[Tuple[str, Optional[List[str]]]]]:
+    """
+    Generates the TelemetryBinaryFrame layout from telemetry.json.
+
+    Args:
+        definition: Parsed telemetry.json
+
+    Returns:
+        The frame struct, and per value after the header its field key and, for string
+        fields, the value list the byte indexes
+    """
+    wide: List[Tuple[str, str]] = []
+    narrow: List[Tuple[str, Optional[List[str]]]] = []
+    for key, field in definition.items():
+        kind = field.get('type', 'float')
+        if kind == 'float':
+            wide.append((key, 'f'))
+        elif kind == 'int' and not field.get('map'):
+            wide.append((key, 'i'))
+        else:
+            narrow.append((key, field.get('values') if kind == 'string' else None))
+    frame = struct.Struct('<BBHI' + ''.join(code for _, code in wide) + 'B' * len(narrow))
+    return frame, [(key, None) for key, _ in wide] + narrow
+
+
+class DeviceClock:
+    """
+    Maps one press's Microseconds() onto the host clock (time.time()).
+
+    Each sync is an NTP-style round trip: the host notes when it sent SYNC=<token>, the press
+    replies with its clock, and the reply's time is taken as the midpoint of the send and
+    receive times. Queueing on either side only ever makes a round trip longer, so the
+    fastest round trips of the last few are kept and a line is fitted through them; its slope
+    absorbs the press oscillator's ppm error, which would otherwise cost a millisecond every
+    few seconds. The 32-bit counter wraps every 71.6 minutes; unwrap() extends it, as long as
+    it is fed at least once per wrap.
+    """
+
+    WRAP = 1 << 32
+    WINDOW = 16          # Sync samples kept
+    BEST = 8             # Fastest of them fitted
+    MIN_FIT_SPAN_S = 10.0  # Device time the fitted samples must span before the rate is fitted
+
+    def __init__(self):
+        self._tokens = itertools.count(1)
+        self._pending: Dict[str, float] = {}
+        self.reset()
+
+    def reset(self) -> None:
+        """Forget the sync and the unwrap state (the press rebooted or another press answers)."""
+        self._last_raw: Optional[int] = None
+        self._last_us = 0
+        self._samples: List[Tuple[float, float, float]] = []  # (device s, host s, round trip s)
+        self._fit: Optional[Tuple[float, float, float]] = None  # (device s, host s, host s per device s)
+        self.round_trip: Optional[float] = None
+
+    @property
+    def synced(self) -> bool:
+        return self._fit is not None
+
+    def unwrap(self, raw_us: int) -> int:
+        """Device microseconds since boot from the 32-bit counter value."""
+        raw_us &= self.WRAP - 1
+        if self._last_raw is None:
+            self._last_raw, self._last_us = raw_us, raw_us
+            return raw_us
+        step = (raw_us - self._last_raw) % self.WRAP
+        if step >= self.WRAP // 2:
+            # Older than the latest value (a reordered datagram); not a wrap
+            return self._last_us - (self.WRAP - step)
+        self._last_raw = raw_us
+        self._last_us += step
+        return self._last_us
+
+    def sync_token(self, sent: Optional[float] = None) -> str:
+        """New token for SYNC= in DISCOVER_DEVICE; sent is its send time (default now)."""
+        token = f"{next(self._tokens) & 0xFFFFFFFF:x}"
+        if len(self._pending) >= self.WINDOW:
+            # Replies that never came
+            self._pending.pop(next(iter(self._pending)))
+        self._pending[token] = time.time() if sent is None else sent
+        return token
+
+    def feed_line(self, line: str, received: Optional[float] = None) -> bool:
+        """
+        Take a discovery reply carrying SYNC= and T_US=; other lines are ignored.
+
+        Returns:
+            True if the line was the reply to one of our tokens
+        """
+        if not line.startswith(DISCOVERY_PREFIX):
+            return False
+        match = _SYNC_RE.search(line)
+        if match is None:
+            return False
+        sent = self._pending.pop(match.group(1), None)
+        if sent is None:
+            return False
+        received = time.time() if received is None else received
+        device_s = self.unwrap(int(match.group(2))) * 1e-6
+        self._samples.append((device_s, (sent + received) / 2.0, received - sent))
+        del self._samples[:-self.WINDOW]
+        self._refit()
+        return True
+
+    def _refit(self) -> None:
+        best = sorted(self._samples, key=lambda sample: sample[2])[:self.BEST]
+        self.round_trip = best[0][2]
+        n = len(best)
+        mean_d = sum(sample[0] for sample in best) / n
+        mean_h = sum(sample[1] for sample in best) / n
+        span = max(sample[0] for sample in best) - min(sample[0] for sample in best)
+        rate = 1.0
+        if span >= self.MIN_FIT_SPAN_S:
+            var_d = sum((sample[0] - mean_d) ** 2 for sample in best)
+            rate = sum((sample[0] - mean_d) * (sample[1] - mean_h) for sample in best) / var_d
+        self._fit = (mean_d, mean_h, rate)
+
+    def to_host(self, raw_us: int) -> Optional[float]:
+        """Host time (time.time()) of a device Microseconds() value, or None before the first sync."""
+        if self._fit is None:
+            return None
+        mean_d, mean_h, rate = self._fit
+        return mean_h + (self.unwrap(raw_us) * 1e-6 - mean_d) * rate
+
+
+class TelemetryDecoder:
+    """
+    PRESSBOI_TELEM text frames to typed values, with the display formatting kept separate.
+    """
+
+    def __init__(self, definition_path: Optional[Union[str, Path]] = None):
+        """
+        Args:
+            definition_path: telemetry.json (default: the device definition next to this module)
+        """
+        if definition_path is None:
+            definition_path = Path(__file__).parent / 'telemetry.json'
+        with open(definition_path, 'r') as f:
+            definition = json.load(f)
+        self._fields = build_fields(definition)
+        self._binary, self._binary_keys = build_binary_layout(definition)
+        self._binary_seq: Optional[int] = None
+        self.lost_frames = 0
+        self.values: Dict[str, Any] = {}
+        self.frames = 0
+        self._listeners: List[Listener] = []
+        self._dirty = set()
+        self._shown: Dict[str, Any] = {}
+        self.clock = DeviceClock()
+        self.device_time_us: Optional[int] = None
+        self.frame_time: Optional[float] = None
+        self.comms: Dict[str, int] = {}
+
+    def add_listener(self, listener: Listener) -> None:
+        """Call listener(frame_values) for every decoded frame."""
+        self._listeners.append(listener)
+
+    def remove_listener(self, listener: Listener) -> None:
+        """Stop calling a listener; unknown listeners are ignored."""
+        if listener in self._listeners:
+            self._listeners.remove(listener)
+
+    def get(self, key: str, default: Any = None) -> Any:
+        """Latest decoded value of a field."""
+        return self.values.get(key, default)
+
+    def force(self) -> Optional[float]:
+        """Force in kg from the sensor named by force_source, as the status panel shows it."""
+        if self.values.get('force_source') == 'motor_torque':
+            return self.values.get('force_motor_torque')
+        return self.values.get('force_load_cell')
+
+    def feed_line(self, line: str) -> Optional[Dict[str, Any]]:
+        """
+        Decode one received line. A clock-sync reply goes to the clock; other lines that are
+        not telemetry (text or binary) are ignored.
+
+        Returns:
+            The fields of this frame (key to typed value), or None if the line is not telemetry
+        """
+        if line.startswith(COMMS_PREFIX):
+            for part in line[len(COMMS_PREFIX):].strip().split(','):
+                key, _, text = part.partition(':')
+                if text.isdigit():
+                    self.comms[key] = int(text)
+            return None
+        if line.startswith(TELEM_BINARY_PREFIX):
+            return self._feed_binary(line[len(TELEM_BINARY_PREFIX):].strip())
+        if not line.startswith(TELEM_PREFIX):
+            self.clock.feed_line(line)
+            return None
+        frame = {}
+        fields = self._fields
+        self.frame_time = None
+        for part in line[len(TELEM_PREFIX):].strip().split(','):
+            key, sep, text = part.partition(':')
+            if key == TIME_KEY:
+                if text.isdigit():
+                    self._set_time(int(text))
+                continue
+            field = fields.get(key)
+            if not sep or field is None:
+                continue
+            try:
+                frame[key] = field[0](text)
+            except ValueError:
+                # Garbled field; keep the previous value
+                continue
+        return self._accept(frame)
+
+    def _feed_binary(self, text: str) -> Optional[Dict[str, Any]]:
+        try:
+            data = base64.b64decode(text, validate=True)
+        except (binascii.Error, ValueError):
+            return None
+        if len(data) != self._binary.size:
+            # Another layout version than this telemetry.json describes
+            return None
+        _, _, seq, raw_us, *raw = self._binary.unpack(data)
+        if self._binary_seq is not None:
+            self.lost_frames += (seq - self._binary_seq - 1) & 0xFFFF
+        self._binary_seq = seq
+        self._set_time(raw_us)
+        frame = {}
+        for (key, values), value in zip(self._binary_keys, raw):
+            if values is not None:
+                if value == TELEM_BINARY_VALUE_UNKNOWN or value >= len(values):
+                    continue
+                value = values[value]
+            frame[key] = value
+        return self._accept(frame)
+
+    def _set_time(self, raw_us: int) -> None:
+        self.device_time_us = self.clock.unwrap(raw_us)
+        self.frame_time = self.clock.to_host(raw_us)
+
+    def _accept(self, frame: Dict[str, Any]) -> Dict[str, Any]:
+        self.values.update(frame)
+        self._dirty.update(frame)
+        self.frames += 1
+        for listener in list(self._listeners):
+            listener(frame)
+        return frame
+
+    def format(self, key: str, value: Any = None) -> str:
+        """Display text of a field ("12.34 mm"), from value or the latest value ('---' if none)."""
+        if value is None:
+            value = self.values.get(key)
+        field = self._fields.get(key)
+        if value is None or field is None:
+            return '---'
+        return field[1](value)
+
+    def publish(self, gui_refs: Dict[str, Any]) -> int:
+        """
+        Write the fields changed since the last publish() to their gui_var.
+
+        String variables get the formatted text; numeric variables (DoubleVar, IntVar) get the
+        number. A variable is only set when what it would show changed, so Tk traces run once
+        per real change rather than once per frame.
+
+        Returns:
+            Number of variables set
+        """
+        written = 0
+        for key in self._dirty:
+            parse, formatter, gui_var = self._fields[key]
+            var = gui_refs.get(gui_var) if gui_var else None
+            if var is None:
+                continue
+            value = self.values[key]
+            shown = value if isinstance(value, str) or _is_numeric_var(var) else formatter(value)
+            if self._shown.get(key) == shown:
+                continue
+            self._shown[key] = shown
+            var.set(shown)
+            written += 1
+        self._dirty.clear()
+        return written
+
+
+def _is_numeric_var(var: Any) -> bool:
+    """True for the Tk variables that hold numbers rather than display text."""
+    return type(var).__name__ in ('DoubleVar', 'IntVar', 'BooleanVar')
@@ -0,0 +1,28 @@
+/**
+ * @file base64.h
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Declares the base64 codec used to carry binary records in text messages.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Encodes bytes as standard (RFC 4648) padded base64.
+ * @param data Bytes to encode
+ * @param length Number of bytes
+ * @param out Output buffer, at least (length + 2) / 3 * 4 + 1 characters
+ * @return Characters written, excluding the terminating NUL
+ */
+size_t base64Encode(const uint8_t* data, size_t length, char* out);
+
+/**
+ * @brief Decodes standard (RFC 4648) base64, padded or not.
+ * @param text Base64 characters, ending at a NUL, space or line break
+ * @param out Output buffer
+ * @param capacity Size of @p out in bytes
+ * @return Bytes written, or 0 if the text is not valid base64 or does not fit
+ */
+size_t base64Decode(const char* text, uint8_t* out, size_t capacity);
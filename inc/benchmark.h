@@ -0,0 +1,86 @@
+/**
+ * @file benchmark.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the on-target micro-benchmark suite of the Benchmark build.
+ *
+ * @details With PRESSBOI_BENCHMARK set (the Benchmark configuration of pressboi.cppproj),
+ * dump_perf first times the hot paths with the DWT cycle counter and appends one
+ * "bench" line per function to its report: telemetry_build_message, parseCommand, the
+ * load-cell line decoder, one joule integration sample, the strain deflection lookup, the
+ * stiffness window fit and enqueueTx plus one TX pass. Each function runs BENCHMARK_CALLS times and reports the
+ * fastest and the mean call in cycles; the fastest is the number to compare between
+ * releases, since the control tick interrupt lands in some of the others.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+class CommsController;
+class MotorController;
+
+/**
+ * @enum BenchmarkId
+ * @brief Functions the suite times, in report order.
+ */
+enum BenchmarkId : uint8_t {
+    BENCH_TELEMETRY_BUILD = 0,  ///< telemetry_build_message() of the live telemetry
+    BENCH_PARSE_COMMAND,        ///< parseCommand() over a mix of command lines
+    BENCH_FORCE_DECODE,         ///< ForceSensor ASCII decoder, one sample line
+    BENCH_JOULE_SAMPLE,         ///< One strain-compensated joule integration sample
+    BENCH_DEFLECTION_LOOKUP,    ///< MachineStrainModel::deflectionFromForce()
+    BENCH_STIFFNESS_WINDOW,     ///< PressMetrics::add() of a new peak (the stiffness window fit)
+    BENCH_TX_SEND,              ///< enqueueTx() plus one TX queue pass
+    BENCH_COUNT
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief Timing of one function.
+ */
+struct BenchmarkResult {
+    uint32_t calls;         ///< Timed calls
+    uint32_t min_cycles;    ///< Fastest call
+    uint32_t mean_cycles;   ///< Mean call
+};
+
+/**
+ * @class BenchmarkSuite
+ * @brief Runs the timed loops and keeps the latest results.
+ */
+class BenchmarkSuite {
+public:
+    /**
+     * @brief Constructs the suite with no results.
+     */
+    BenchmarkSuite();
+
+    /**
+     * @brief Times every BenchmarkId. Call from the main loop with the press idle.
+     * @param comms Controller whose TX path is timed
+     * @param motor Controller whose joule integration is timed
+     */
+    void run(CommsController& comms, MotorController& motor);
+
+    /**
+     * @brief Gets the latest result of a function.
+     * @param id BenchmarkId
+     * @return Result (calls is 0 before the first run)
+     */
+    const BenchmarkResult& getResult(uint8_t id) const { return m_results[id]; }
+
+    /**
+     * @brief Gets the name of a function as shown in reports.
+     * @param id BenchmarkId
+     * @return Name
+     */
+    static const char* name(uint8_t id);
+
+private:
+    void finish(uint8_t id, uint32_t calls, uint32_t min_cycles, uint32_t total_cycles);
+
+    BenchmarkResult m_results[BENCH_COUNT];
+};
+
+extern BenchmarkSuite g_benchmarks;
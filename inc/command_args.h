@@ -0,0 +1,382 @@
+/**
+ * @file command_args.h
+ * @brief Typed command arguments and their text and binary decoders.
+ * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY
+ * Generated from commands.json on 2025-11-21 10:02:17
+ *
+ * Every command with params gets an argument struct whose fields follow the params in
+ * commands.json order. A command arrives either as text ("move_abs 10 5 200 hold") or as
+ * a binary frame carried by "cmdb <base64>"; both decode into the same CommandArgs, so a
+ * handler never parses its own arguments.
+ *
+ * Binary frame layout (little-endian):
+ *   [command u8][field count u8][field 0]...[field count - 1]
+ *   float  4 bytes IEEE-754
+ *   int    4 bytes two's complement
+ *   string length u8, then that many characters (no NUL)
+ *   rest   the remaining bytes of the frame (last field only)
+ * The command byte is the Command enum value from commands.h. Absent trailing fields
+ * (count below the number of params) are left for the handler to default.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "commands.h"
+
+#define COMMAND_ARG_STRING_LENGTH       32      ///< Buffer size of a string param (31 characters + NUL).
+#define COMMAND_ARG_MAX_FIELDS          5       ///< Most params of any command.
+#define COMMAND_FRAME_MAX_LENGTH        (MAX_MESSAGE_LENGTH / 4 * 3) ///< Largest binary frame a "cmdb" message can carry.
+
+//==================================================================================================
+// Argument Structs
+//==================================================================================================
+
+/** @brief reset [mode] */
+struct ResetArgs {
+    char mode[COMMAND_ARG_STRING_LENGTH];           ///< soft | full
+};
+
+/** @brief home [mode] */
+struct HomeArgs {
+    char mode[COMMAND_ARG_STRING_LENGTH];           ///< fast | full | hybrid
+};
+
+/** @brief move_abs <position> <speed> <force> [force_action] [dwell] */
+struct MoveAbsArgs {
+    float position;                                 ///< mm
+    float speed;                                    ///< mm/s
+    float force;                                    ///< kg
+    char force_action[COMMAND_ARG_STRING_LENGTH];   ///< retract | hold | skip | abort | regulate | seat
+    int32_t dwell;                                  ///< ms
+};
+
+/** @brief move_inc <distance> <speed> <force> [force_action] */
+struct MoveIncArgs {
+    float distance;                                 ///< mm
+    float speed;                                    ///< mm/s
+    float force;                                    ///< kg
+    char force_action[COMMAND_ARG_STRING_LENGTH];   ///< retract | hold | skip | seat
+};
+
+/** @brief queue_move <position> <speed> <force> [force_action] [dwell] */
+struct QueueMoveArgs {
+    float position;                                 ///< mm
+    float speed;                                    ///< mm/s
+    float force;                                    ///< kg
+    char force_action[COMMAND_ARG_STRING_LENGTH];   ///< retract | hold | skip | abort | regulate | seat
+    int32_t dwell;                                  ///< ms
+};
+
+/** @brief recipe_new <name> */
+struct RecipeNewArgs {
+    char name[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief recipe_add <step> [args...] */
+struct RecipeAddArgs {
+    char step[COMMAND_ARG_STRING_LENGTH];           ///< move | dwell | retract
+    const char* args;                               ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief recipe_learn <margin> [rapid_speed] */
+struct RecipeLearnArgs {
+    float margin;                                   ///< mm
+    float rapid_speed;                              ///< mm/s
+};
+
+/** @brief run_recipe <name> */
+struct RunRecipeArgs {
+    char name[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief recipe_envelope <action> [points] */
+struct RecipeEnvelopeArgs {
+    char action[COMMAND_ARG_STRING_LENGTH];         ///< begin | add | clear
+    const char* points;                             ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief recipe_zones <action> [band] */
+struct RecipeZonesArgs {
+    char action[COMMAND_ARG_STRING_LENGTH];         ///< add | clear
+    const char* band;                               ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief fit_strain_cal [mode] */
+struct FitStrainCalArgs {
+    char mode[COMMAND_ARG_STRING_LENGTH];           ///< apply | preview
+};
+
+/** @brief fw_update <action> [size] [crc] */
+struct FwUpdateArgs {
+    char action[COMMAND_ARG_STRING_LENGTH];         ///< begin | apply | cancel
+    int32_t size;                                   ///< Image bytes
+    char crc[COMMAND_ARG_STRING_LENGTH];            ///< CRC-32 in hex
+};
+
+/** @brief save_profile / select_profile / delete_profile <name> */
+struct ProfileNameArgs {
+    char name[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief restore_nvm <image> */
+struct RestoreNvmArgs {
+    const char* image;                              ///< Base64 image (rest of the command)
+};
+
+/** @brief force_replay <action> [points] */
+struct ForceReplayArgs {
+    char action[COMMAND_ARG_STRING_LENGTH];         ///< start | stop | capture | add | clear
+    const char* points;                             ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief set_force_mode <mode> */
+struct SetForceModeArgs {
+    char mode[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief set_retract <position> [speed] */
+struct SetRetractArgs {
+    float position;                                 ///< mm
+    float speed;                                    ///< mm/s
+};
+
+/** @brief retract [speed] */
+struct RetractArgs {
+    float speed;                                    ///< mm/s
+};
+
+/** @brief set_force_offset <offset> [channel] */
+struct SetForceOffsetArgs {
+    float offset;
+    char channel[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief set_force_scale <scale> [channel] */
+struct SetForceScaleArgs {
+    float scale;
+    char channel[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief set_strain_cal <x4> <x3> <x2> <x1> <c> */
+struct SetStrainCalArgs {
+    float x4;                                       ///< x^4
+    float x3;                                       ///< x^3
+    float x2;                                       ///< x^2
+    float x1;                                       ///< x
+    float c;                                        ///< C
+};
+
+/** @brief set_debug <level> */
+struct SetDebugArgs {
+    int32_t level;
+};
+
+/** @brief dump_error_log [format] */
+struct DumpErrorLogArgs {
+    char format[COMMAND_ARG_STRING_LENGTH];         ///< text | binary
+};
+
+/** @brief set_log_level [level] */
+struct SetLogLevelArgs {
+    char level[COMMAND_ARG_STRING_LENGTH];          ///< debug | info | warn | error | crit
+};
+
+/** @brief set_telemetry <busy_hz> [idle_hz] [fields] */
+struct SetTelemetryArgs {
+    float busy_hz;                                  ///< Hz
+    float idle_hz;                                  ///< Hz
+    char fields[256];
+};
+
+/** @brief set_telemetry_delta <keyframe_ms> */
+struct SetTelemetryDeltaArgs {
+    int32_t keyframe_ms;                            ///< ms
+};
+
+/** @brief set_telemetry_burst <press_hz> [hold_ms] */
+struct SetTelemetryBurstArgs {
+    float press_hz;                                 ///< Hz (0 = off)
+    int32_t hold_ms;                                ///< ms
+};
+
+/** @brief set_sync [role] [leader_ip] */
+struct SetSyncArgs {
+    char role[COMMAND_ARG_STRING_LENGTH];           ///< off | leader | follower
+    char leader_ip[COMMAND_ARG_STRING_LENGTH];      ///< Dotted address (follower)
+};
+
+/** @brief subscribe_telemetry <port> <rate_hz> [lease_s] */
+struct SubscribeTelemetryArgs {
+    int32_t port;
+    float rate_hz;                                  ///< Hz
+    int32_t lease_s;                                ///< s
+};
+
+/** @brief unsubscribe_telemetry <port> */
+struct UnsubscribeTelemetryArgs {
+    int32_t port;
+};
+
+/** @brief set_usb_route <route> */
+struct SetUsbRouteArgs {
+    char route[COMMAND_ARG_STRING_LENGTH];          ///< all | events | own
+};
+
+/** @brief cmdb <frame...> */
+struct CmdbArgs {
+    const char* frame;                              ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief set_polarity <polarity> */
+struct SetPolarityArgs {
+    char polarity[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief home_on_boot <enabled> */
+struct HomeOnBootArgs {
+    char enabled[COMMAND_ARG_STRING_LENGTH];
+};
+
+/** @brief set_press_threshold <threshold> */
+struct SetPressThresholdArgs {
+    float threshold;                                ///< kg
+};
+
+/** @brief set_motion_profile <profile> [jerk] */
+struct SetMotionProfileArgs {
+    char profile[COMMAND_ARG_STRING_LENGTH];
+    float jerk;                                     ///< mm/s^3
+};
+
+/** @brief set_encoder <counts_per_mm> [tolerance] */
+struct SetEncoderArgs {
+    float counts_per_mm;                            ///< counts/mm
+    float tolerance;                                ///< mm
+};
+
+/** @brief set_drive_geometry <pitch> <pulses_per_rev> */
+struct SetDriveGeometryArgs {
+    float pitch;                                    ///< mm/rev
+    int32_t pulses_per_rev;
+};
+
+/** @brief set_rapid_traverse <speed> [accel] */
+struct SetRapidTraverseArgs {
+    int32_t speed;                                  ///< mm/s
+    int32_t accel;                                  ///< mm/s^2
+};
+
+/** @brief set_torque_friction <points...> */
+struct SetTorqueFrictionArgs {
+    const char* points;                             ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief set_force_filter <median> [alpha] */
+struct SetForceFilterArgs {
+    int32_t median;
+    float alpha;
+};
+
+/** @brief set_force_table <points...> */
+struct SetForceTableArgs {
+    const char* points;                             ///< Rest of the command (NUL-terminated)
+};
+
+/** @brief set_force_latency <latency> */
+struct SetForceLatencyArgs {
+    int32_t latency;                                ///< us
+};
+
+/** @brief set_force_channel <channel> */
+struct SetForceChannelArgs {
+    char channel[COMMAND_ARG_STRING_LENGTH];
+};
+
+/**
+ * @struct CommandArgs
+ * @brief Decoded arguments of one command.
+ * @details Only the member matching the command is valid, and only its first @ref count
+ * fields were given; the rest are zero.
+ */
+struct CommandArgs {
+    uint8_t count;                                  ///< Number of params given, in params order.
+    union {
+        ResetArgs reset;
+        HomeArgs home;
+        MoveAbsArgs move_abs;
+        MoveIncArgs move_inc;
+        QueueMoveArgs queue_move;
+        RecipeNewArgs recipe_new;
+        RecipeAddArgs recipe_add;
+        RecipeLearnArgs recipe_learn;
+        RunRecipeArgs run_recipe;
+        RecipeEnvelopeArgs recipe_envelope;
+        RecipeZonesArgs recipe_zones;
+        SetForceModeArgs set_force_mode;
+        SetRetractArgs set_retract;
+        RetractArgs retract;
+        SetForceOffsetArgs set_force_offset;
+        SetForceScaleArgs set_force_scale;
+        SetStrainCalArgs set_strain_cal;
+        FitStrainCalArgs fit_strain_cal;
+        FwUpdateArgs fw_update;
+        SetDebugArgs set_debug;
+        SetLogLevelArgs set_log_level;
+        DumpErrorLogArgs dump_error_log;
+        SetTelemetryArgs set_telemetry;
+        SetTelemetryDeltaArgs set_telemetry_delta;
+        SetTelemetryBurstArgs set_telemetry_burst;
+        SetSyncArgs set_sync;
+        SubscribeTelemetryArgs subscribe_telemetry;
+        UnsubscribeTelemetryArgs unsubscribe_telemetry;
+        SetUsbRouteArgs set_usb_route;
+        CmdbArgs cmdb;
+        SetPolarityArgs set_polarity;
+        HomeOnBootArgs home_on_boot;
+        SetPressThresholdArgs set_press_threshold;
+        SetMotionProfileArgs set_motion_profile;
+        SetEncoderArgs set_encoder;
+        SetDriveGeometryArgs set_drive_geometry;
+        SetRapidTraverseArgs set_rapid_traverse;
+        SetTorqueFrictionArgs set_torque_friction;
+        SetForceFilterArgs set_force_filter;
+        SetForceTableArgs set_force_table;
+        SetForceLatencyArgs set_force_latency;
+        SetForceChannelArgs set_force_channel;
+        ProfileNameArgs profile;
+        RestoreNvmArgs restore_nvm;
+        ForceReplayArgs force_replay;
+    };
+};
+
+//==================================================================================================
+// Decoders
+//==================================================================================================
+
+/**
+ * @brief Parses the text arguments of a command (no sscanf).
+ * @details Tokens are separated by spaces or tabs. A float or int token must convert
+ * completely (finite floats, ints within int32), a string must fit its buffer, and no
+ * tokens may follow the last param. A rest param points into @p text. Commands without
+ * params accept any text. Also used for nested argument strings, such as a recipe_add
+ * "move" step parsed as move_abs.
+ * @param cmd Parsed command
+ * @param text Arguments after the command name, or NULL
+ * @param out Decoded arguments; zeroed first
+ * @return false if a given token is malformed or there are too many
+ */
+bool parseCommandArgs(Command cmd, const char* text, CommandArgs* out);
+
+/**
+ * @brief Decodes a binary command frame.
+ * @details A rest param points into @p frame, which is NUL-terminated in place for it.
+ * @param frame Frame bytes (see the layout above)
+ * @param length Frame length in bytes
+ * @param capacity Size of the @p frame buffer; must exceed @p length
+ * @param cmd Decoded command (never CMD_CMDB)
+ * @param out Decoded arguments; zeroed first
+ * @return false if the command is unknown or a field is malformed or truncated
+ */
+bool decodeCommandFrame(uint8_t* frame, size_t length, size_t capacity, Command* cmd, CommandArgs* out);
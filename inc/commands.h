@@ -19,7 +19,7 @@
  * @{
  */
 #define CMD_STR_DISCOVER_DEVICE                     "DISCOVER_DEVICE" ///< Generic command for any device to respond to.
-#define CMD_STR_RESET                               "reset" ///< Clear error states and reset system to standby.
+#define CMD_STR_RESET                               "reset" ///< Clear error states and reset system to standby. Optional mode: soft | full.
 #define CMD_STR_SET_FORCE_MODE                      "set_force_mode " ///< Sets the force sensing mode (persisted to NVM).
 #define CMD_STR_SET_RETRACT                         "set_retract " ///< Sets the retract position for the press.
 #define CMD_STR_RETRACT                             "retract" ///< Moves the press to the preset retract position with optional speed.
@@ -35,20 +35,66 @@
 #define CMD_STR_SET_STRAIN_CAL                      "set_strain_cal " ///< Set machine strain energy compensation coefficients (force vs distance polynomial) and save to NVM.
 #define CMD_STR_REBOOT_BOOTLOADER                   "reboot_bootloader" ///< Reboots the controller into ClearCore USB bootloader mode for firmware flashing.
 #define CMD_STR_DUMP_NVM                            "dump_nvm" ///< Dump Pressboi non-volatile memory contents to the GUI.
+#define CMD_STR_DUMP_CAPTURE                        "dump_capture" ///< Stream the per-sample curve of the last press to the GUI.
+#define CMD_STR_DUMP_CURVE                          "dump_curve" ///< Stream the fixed position-grid force curve of the last press to the GUI.
+#define CMD_STR_SET_DEBUG                           "set_debug " ///< Turns the binary debug-record channel on or off (not saved).
+#define CMD_STR_SET_LOG_LEVEL                       "set_log_level" ///< Sets or shows the lowest level kept in the error log (not saved).
+#define CMD_STR_SET_TELEMETRY                       "set_telemetry " ///< Sets the telemetry rate while busy and idle and the subscribed fields (not saved).
+#define CMD_STR_SET_TELEMETRY_DELTA                 "set_telemetry_delta " ///< Sends only changed telemetry fields, with a full keyframe every N ms (not saved).
+#define CMD_STR_SET_TELEMETRY_BURST                 "set_telemetry_burst " ///< Sets the telemetry rate while a move is past the press threshold (not saved).
+#define CMD_STR_SET_SYNC                            "set_sync" ///< Sets or shows the press sync role: off, leader, or follower of a leader's address (not saved).
+#define CMD_STR_SUBSCRIBE_TELEMETRY                 "subscribe_telemetry " ///< Adds or renews the sending host as an extra telemetry receiver, with its own rate and lease.
+#define CMD_STR_UNSUBSCRIBE_TELEMETRY               "unsubscribe_telemetry " ///< Removes the sending host from the telemetry receivers.
+#define CMD_STR_SET_USB_ROUTE                       "set_usb_route " ///< Selects which messages are mirrored to USB: all, events or own (not saved).
 #define CMD_STR_RESET_NVM                           "reset_nvm" ///< Restore Pressboi non-volatile memory to factory defaults.
-#define CMD_STR_DUMP_ERROR_LOG                      "dump_error_log" ///< Dump internal error log buffer for diagnostics.
+#define CMD_STR_DUMP_ERROR_LOG                      "dump_error_log" ///< Dump internal error log buffer for diagnostics (text, or binary LOGDUMP lines).
+#define CMD_STR_CMDB                                "cmdb " ///< Carries one command in the binary frame encoding (base64). @see command_args.h
 #define CMD_STR_SET_POLARITY                        "set_polarity " ///< Sets the coordinate system polarity (normal or inverted) and saves to NVM. Inverted flips home direction and all moves.
 #define CMD_STR_HOME_ON_BOOT                        "home_on_boot " ///< Sets whether the press should automatically home on startup and saves to NVM.
 #define CMD_STR_SET_PRESS_THRESHOLD                 "set_press_threshold " ///< Sets the force threshold (kg) for energy/startpoint recording and saves to NVM.
+#define CMD_STR_SET_FORCE_FILTER                    "set_force_filter " ///< Configures the load-cell filter used for force limits and saves to NVM.
+#define CMD_STR_SET_FORCE_CHANNEL                   "set_force_channel " ///< Selects which load cell(s) force limits use and saves to NVM.
+#define CMD_STR_SET_FORCE_LATENCY                   "set_force_latency " ///< Sets the force acquisition latency used to align force with position and saves to NVM.
+#define CMD_STR_SET_FORCE_TABLE                     "set_force_table " ///< Uploads a piecewise-linear load-cell calibration table and saves to NVM.
+#define CMD_STR_SET_MOTION_PROFILE                  "set_motion_profile " ///< Selects trapezoidal or jerk-limited S-curve press moves and saves to NVM.
+#define CMD_STR_SET_ENCODER                         "set_encoder " ///< Configures encoder position verification (counts/mm, tolerance) and saves to NVM.
+#define CMD_STR_SET_DRIVE_GEOMETRY                  "set_drive_geometry " ///< Saves the screw pitch and pulses per revolution to NVM, used from the next boot.
+#define CMD_STR_SET_RAPID_TRAVERSE                  "set_rapid_traverse " ///< Sets the speed and acceleration of force-free retracts and approaches and saves to NVM.
+#define CMD_STR_SET_TORQUE_FRICTION                 "set_torque_friction " ///< Uploads the speed-dependent friction table used in motor_torque mode and saves to NVM.
+#define CMD_STR_DUMP_PERF                           "dump_perf" ///< Dumps per-stage main-loop timing (min/max/mean, log2 histogram) and restarts the window.
+#define CMD_STR_DUMP_TRACE                          "dump_trace" ///< Streams the binary event trace ring as base64 TRACE DATA lines.
+#define CMD_STR_DUMP_CRASH                          "dump_crash" ///< Streams the crash snapshot the last watchdog reset or HardFault left.
+#define CMD_STR_SAVE_PROFILE                        "save_profile " ///< Saves the current calibration as a named profile.
+#define CMD_STR_SELECT_PROFILE                      "select_profile " ///< Applies a named calibration profile in one step.
+#define CMD_STR_DELETE_PROFILE                      "delete_profile " ///< Deletes a named calibration profile.
+#define CMD_STR_BACKUP_NVM                          "backup_nvm" ///< Sends the whole NVM user area as one CRC-checked binary image.
+#define CMD_STR_RESTORE_NVM                         "restore_nvm " ///< Writes a backup_nvm image to the NVM user area in one write.
+#define CMD_STR_FORCE_REPLAY                        "force_replay " ///< Feeds load cell A from a stored force-versus-position profile (HIL and host builds).
+#define CMD_STR_DUMP_MEM                            "dump_mem" ///< Dumps the SRAM sections, the stack high-water mark and the size of each static pool.
+#define CMD_STR_FIT_STRAIN_CAL                      "fit_strain_cal" ///< Fits the machine strain polynomial to the last press against a rigid block. Optional mode: apply | preview.
+#define CMD_STR_FW_UPDATE                           "fw_update " ///< Stages a firmware image streamed over TCP, then applies it: begin <size> <crc> | apply | cancel.
+#define CMD_STR_DUMP_CYCLE_TIMES                    "dump_cycle_times" ///< Dumps min/mean/max press cycle time per phase and restarts the statistics.
+#define CMD_STR_DUMP_PRODUCTION                     "dump_production" ///< Dumps the lifetime cycle, travel, energy, trip and peak-force counters.
+#define CMD_STR_RESET_PRODUCTION                    "reset_production" ///< Zeroes the production counters (after maintenance).
 /** @} */
 
 /**
  * @name Motion Commands
  * @{
  */
-#define CMD_STR_HOME                                "home" ///< Homes the press axis to its zero position.
+#define CMD_STR_HOME                                "home" ///< Homes the press axis to its zero position. Optional mode: fast | full.
 #define CMD_STR_MOVE_ABS                            "move_abs " ///< Moves the press to an absolute position with speed and force limits.
 #define CMD_STR_MOVE_INC                            "move_inc " ///< Moves the press by a relative distance with speed and force limits.
+#define CMD_STR_QUEUE_MOVE                          "queue_move " ///< Appends an absolute move segment to the motion queue.
+#define CMD_STR_QUEUE_RUN                           "queue_run" ///< Runs the queued motion segments back to back.
+#define CMD_STR_QUEUE_CLEAR                         "queue_clear" ///< Discards all pending motion queue segments.
+#define CMD_STR_RECIPE_NEW                          "recipe_new " ///< Starts a new named press recipe, discarding the one held in RAM.
+#define CMD_STR_RECIPE_ADD                          "recipe_add " ///< Appends a move, dwell or retract step to the recipe being edited.
+#define CMD_STR_RECIPE_LEARN                        "recipe_learn " ///< Sets the adaptive approach margin and rapid speed of the recipe being edited.
+#define CMD_STR_RECIPE_SAVE                         "recipe_save" ///< Saves the recipe being edited to NVM.
+#define CMD_STR_RUN_RECIPE                          "run_recipe " ///< Runs the stored press recipe on the device.
+#define CMD_STR_RECIPE_ENVELOPE                     "recipe_envelope " ///< Uploads the force-versus-position envelope recipe moves are checked against.
+#define CMD_STR_RECIPE_ZONES                        "recipe_zones " ///< Sets the position bands that cap recipe move speed, torque and force.
 /** @} */
 
 //==================================================================================================
@@ -85,16 +131,64 @@ typedef enum {
     CMD_SET_STRAIN_CAL,                                    ///< @see CMD_STR_SET_STRAIN_CAL
     CMD_REBOOT_BOOTLOADER,                                    ///< @see CMD_STR_REBOOT_BOOTLOADER
     CMD_DUMP_NVM,                                    ///< @see CMD_STR_DUMP_NVM
+    CMD_DUMP_CAPTURE,                                ///< @see CMD_STR_DUMP_CAPTURE
+    CMD_DUMP_CURVE,                                  ///< @see CMD_STR_DUMP_CURVE
+    CMD_SET_DEBUG,                                   ///< @see CMD_STR_SET_DEBUG
+    CMD_SET_LOG_LEVEL,                               ///< @see CMD_STR_SET_LOG_LEVEL
+    CMD_SET_TELEMETRY,                               ///< @see CMD_STR_SET_TELEMETRY
+    CMD_SET_TELEMETRY_DELTA,                         ///< @see CMD_STR_SET_TELEMETRY_DELTA
+    CMD_SET_TELEMETRY_BURST,                         ///< @see CMD_STR_SET_TELEMETRY_BURST
+    CMD_SET_SYNC,                                    ///< @see CMD_STR_SET_SYNC
+    CMD_SUBSCRIBE_TELEMETRY,                         ///< @see CMD_STR_SUBSCRIBE_TELEMETRY
+    CMD_UNSUBSCRIBE_TELEMETRY,                       ///< @see CMD_STR_UNSUBSCRIBE_TELEMETRY
+    CMD_SET_USB_ROUTE,                               ///< @see CMD_STR_SET_USB_ROUTE
     CMD_RESET_NVM,                                    ///< @see CMD_STR_RESET_NVM
     CMD_DUMP_ERROR_LOG,                                    ///< @see CMD_STR_DUMP_ERROR_LOG
+    CMD_CMDB,                                        ///< @see CMD_STR_CMDB
     CMD_SET_POLARITY,                                    ///< @see CMD_STR_SET_POLARITY
     CMD_HOME_ON_BOOT,                                    ///< @see CMD_STR_HOME_ON_BOOT
     CMD_SET_PRESS_THRESHOLD,                             ///< @see CMD_STR_SET_PRESS_THRESHOLD
+    CMD_SET_FORCE_FILTER,                                ///< @see CMD_STR_SET_FORCE_FILTER
+    CMD_SET_FORCE_TABLE,                                 ///< @see CMD_STR_SET_FORCE_TABLE
+    CMD_SET_FORCE_LATENCY,                               ///< @see CMD_STR_SET_FORCE_LATENCY
+    CMD_SET_FORCE_CHANNEL,                               ///< @see CMD_STR_SET_FORCE_CHANNEL
+    CMD_SET_MOTION_PROFILE,                              ///< @see CMD_STR_SET_MOTION_PROFILE
+    CMD_SET_ENCODER,                                     ///< @see CMD_STR_SET_ENCODER
+    CMD_SET_DRIVE_GEOMETRY,                              ///< @see CMD_STR_SET_DRIVE_GEOMETRY
+    CMD_SET_RAPID_TRAVERSE,                              ///< @see CMD_STR_SET_RAPID_TRAVERSE
+    CMD_SET_TORQUE_FRICTION,                             ///< @see CMD_STR_SET_TORQUE_FRICTION
+    CMD_DUMP_PERF,                                       ///< @see CMD_STR_DUMP_PERF
+    CMD_DUMP_TRACE,                                      ///< @see CMD_STR_DUMP_TRACE
+    CMD_DUMP_CRASH,                                      ///< @see CMD_STR_DUMP_CRASH
+    CMD_SAVE_PROFILE,                                    ///< @see CMD_STR_SAVE_PROFILE
+    CMD_SELECT_PROFILE,                                  ///< @see CMD_STR_SELECT_PROFILE
+    CMD_DELETE_PROFILE,                                  ///< @see CMD_STR_DELETE_PROFILE
+    CMD_BACKUP_NVM,                                      ///< @see CMD_STR_BACKUP_NVM
+    CMD_RESTORE_NVM,                                     ///< @see CMD_STR_RESTORE_NVM
+    CMD_FORCE_REPLAY,                                    ///< @see CMD_STR_FORCE_REPLAY
+    CMD_DUMP_MEM,                                        ///< @see CMD_STR_DUMP_MEM
+    CMD_FIT_STRAIN_CAL,                                  ///< @see CMD_STR_FIT_STRAIN_CAL
+    CMD_FW_UPDATE,                                       ///< @see CMD_STR_FW_UPDATE
+    CMD_DUMP_CYCLE_TIMES,                                ///< @see CMD_STR_DUMP_CYCLE_TIMES
+    CMD_DUMP_PRODUCTION,                                 ///< @see CMD_STR_DUMP_PRODUCTION
+    CMD_RESET_PRODUCTION,                                ///< @see CMD_STR_RESET_PRODUCTION
 
     // Motion Commands
     CMD_HOME,                                    ///< @see CMD_STR_HOME
     CMD_MOVE_ABS,                                    ///< @see CMD_STR_MOVE_ABS
-    CMD_MOVE_INC                                     ///< @see CMD_STR_MOVE_INC
+    CMD_MOVE_INC,                                    ///< @see CMD_STR_MOVE_INC
+    CMD_QUEUE_MOVE,                                  ///< @see CMD_STR_QUEUE_MOVE
+    CMD_QUEUE_RUN,                                   ///< @see CMD_STR_QUEUE_RUN
+    CMD_QUEUE_CLEAR,                                 ///< @see CMD_STR_QUEUE_CLEAR
+    CMD_RECIPE_NEW,                                  ///< @see CMD_STR_RECIPE_NEW
+    CMD_RECIPE_ADD,                                  ///< @see CMD_STR_RECIPE_ADD
+    CMD_RECIPE_LEARN,                                ///< @see CMD_STR_RECIPE_LEARN
+    CMD_RECIPE_SAVE,                                 ///< @see CMD_STR_RECIPE_SAVE
+    CMD_RUN_RECIPE,                                  ///< @see CMD_STR_RUN_RECIPE
+    CMD_RECIPE_ENVELOPE,                             ///< @see CMD_STR_RECIPE_ENVELOPE
+    CMD_RECIPE_ZONES,                                ///< @see CMD_STR_RECIPE_ZONES
+
+    CMD_COUNT                                        ///< Number of Command values (not a command).
 } Command;
 
 //==================================================================================================
@@ -114,4 +208,20 @@ Command parseCommand(const char* cmdStr);
  * @param cmd The parsed command enum
  * @return Pointer to the parameter substring, or NULL if no parameters
  */
-const char* getCommandParams(const char* cmdStr, Command cmd);
\ No newline at end of file
+const char* getCommandParams(const char* cmdStr, Command cmd);
+
+/**
+ * @brief Tells whether a command stops or holds motion, so it is dispatched ahead of the
+ * commands already queued (pause, cancel and reset).
+ * @param cmd The parsed command enum
+ * @return true for an urgent command
+ */
+bool isUrgentCommand(Command cmd);
+
+/**
+ * @brief Tells whether an urgent command also discards the commands queued before it, so
+ * nothing sent ahead of a stop runs after it (cancel and reset).
+ * @param cmd The parsed command enum
+ * @return true for a flushing command
+ */
+bool isFlushingCommand(Command cmd);
\ No newline at end of file
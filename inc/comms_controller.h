@@ -13,10 +13,13 @@
 #pragma once
 
 #include "ClearCore.h"
+#include "EthernetTcpServer.h"
 #include "EthernetUdp.h"
 #include "IpAddress.h"
 #include "config.h"
 #include "commands.h"
+#include "message_ring.h"
+#include "text_format.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -30,11 +33,69 @@ extern volatile uint32_t g_watchdogBreadcrumb;
 #define WD_BREADCRUMB_UDP_SEND          0x0B
 #endif
 
+/**
+ * @enum TxLane
+ * @brief Priority class of an outgoing message.
+ * @details processTxQueue() always sends from the highest non-empty lane, and each lane
+ * has its own storage, so a flood in one lane can never push out a message in another.
+ */
+enum TxLane {
+	TX_LANE_CONTROL = 0,    ///< Events and command replies (DONE, ERROR, INFO, discovery).
+	TX_LANE_TELEMETRY,      ///< Periodic telemetry: a single slot, a newer frame replaces an unsent one.
+	TX_LANE_BULK,           ///< Dump and debug lines, sent only when the other lanes are empty.
+	TX_LANE_COUNT
+};
+
+/**
+ * @enum UsbFraming
+ * @brief How outgoing messages are delimited on the USB serial stream.
+ */
+enum UsbFraming {
+	USB_FRAMING_LINES = 0,  ///< Newline-terminated text, split into "CHUNK_i/n:" lines above USB_CHUNK_SIZE.
+	USB_FRAMING_COBS,       ///< Each whole message COBS-encoded and terminated by a 0x00 byte (USB=COBS1).
+};
+
+/**
+ * @enum UsbRoute
+ * @brief Which outgoing messages are copied to the USB serial port (set_usb_route).
+ * @details Messages addressed to the USB host itself (127.0.0.1, such as its discovery
+ * reply), and messages sent while no network GUI is discovered, always go to USB.
+ */
+enum UsbRoute {
+	USB_ROUTE_ALL = 0,      ///< Mirror every message to USB (default).
+	USB_ROUTE_EVENTS,       ///< Mirror the control lane (events, replies); telemetry and bulk stay on the network.
+	USB_ROUTE_OWN,          ///< Only messages addressed to USB: a network-only station with a PC attached.
+};
+
+/**
+ * @enum NetworkState
+ * @brief Progress of the Ethernet bring-up, advanced from updateRx() without blocking.
+ */
+enum NetworkState {
+	NET_STATE_LINK_WAIT = 0,    ///< Waiting for the PHY link (no timeout; USB works meanwhile).
+	NET_STATE_DHCP,             ///< DHCP discover/request in flight.
+	NET_STATE_READY,            ///< Address assigned (DHCP or fallback); UDP and bulk TCP listening.
+};
+
+/**
+ * @struct TelemetrySubscriber
+ * @brief A network host getting copies of the telemetry frames (subscribe_telemetry).
+ */
+struct TelemetrySubscriber {
+	IpAddress ip;           ///< Host address.
+	uint16_t port;          ///< Host port (0 = free entry).
+	uint32_t interval_ms;   ///< Minimum time between frames sent to this host.
+	uint32_t next_due_ms;   ///< Milliseconds() at which the next frame may go out.
+	uint32_t renewed_ms;    ///< Milliseconds() of the last subscribe.
+	uint32_t lease_ms;      ///< The entry is dropped this long after renewed_ms.
+};
+
 /**
  * @struct Message
  * @brief Represents a single data packet for communication.
  * @details This structure encapsulates a message payload along with its sender's
- * network information. It is used in the transmit (TX) and receive (RX) queues.
+ * network information. dequeueRx() hands received messages out in this form; the queues
+ * themselves store only the bytes each message uses (see MessageRing).
  */
 struct Message {
 	char buffer[MAX_MESSAGE_LENGTH]; ///< The raw message payload as a C-style string.
@@ -42,6 +103,18 @@ struct Message {
 	uint16_t remotePort;             ///< The port number of the remote host.
 };
 
+/**
+ * @struct MessageView
+ * @brief A received message read in place from its RX queue slot.
+ * @details Filled by peekRx(); the text stays valid until consumeRx(). A handler may move
+ * @p buffer forward (past a request-ID token) but never writes through it.
+ */
+struct MessageView {
+	const char* buffer;              ///< NUL-terminated message text in the RX arena.
+	IpAddress remoteIp;              ///< The IP address of the sender.
+	uint16_t remotePort;             ///< The port number of the sender.
+};
+
 /**
  * @class CommsController
  * @brief Manages all communication tasks for the device.
@@ -72,9 +145,28 @@ class CommsController {
      * @details This method should be called repeatedly in the main application loop.
      * It polls for new UDP packets and processes the outgoing message queue,
      * ensuring timely communication without blocking other system tasks.
+     * Equivalent to updateRx() followed by an unbudgeted updateTx().
      */
 	void update();
 
+    /**
+     * @brief Receive half of update(): polls UDP, USB serial and the bulk TCP stream.
+     */
+	void updateRx();
+
+    /**
+     * @brief Transmit half of update(): drains the TX queue.
+     * @param budget_us Stop sending once this much time has gone, after at least one
+     *                  message (0 = up to the usual per-pass message limit)
+     */
+	void updateTx(uint32_t budget_us);
+
+    /**
+     * @brief Checks whether the network can carry traffic.
+     * @return true once the bring-up has finished and while the PHY link is up
+     */
+	bool isNetworkReady() const { return m_netState == NET_STATE_READY && EthernetMgr.PhyLinkActive(); }
+
 	// Queue Management
 	/**
      * @brief Enqueues a received message into the RX queue.
@@ -90,6 +182,16 @@ class CommsController {
      */
 	bool enqueueRx(const char* msg, const IpAddress& ip, uint16_t port);
 
+    /**
+     * @brief Enqueues a received message whose length is already known.
+     * @param msg The message text (need not be NUL-terminated at @p length).
+     * @param length Characters of @p msg, excluding any NUL.
+     * @param ip The IP address of the sender.
+     * @param port The port of the sender.
+     * @return false if the RX queue is full, in which case the message is dropped.
+     */
+	bool enqueueRx(const char* msg, size_t length, const IpAddress& ip, uint16_t port);
+
     /**
      * @brief Dequeues a message from the RX queue for processing.
      * @details The main application logic calls this function to retrieve the oldest
@@ -101,6 +203,30 @@ class CommsController {
      */
 	bool dequeueRx(Message& msg);
 
+    /**
+     * @brief Gets the oldest received message without copying it out of the RX queue.
+     * @details Urgent commands (pause, cancel, reset) come first, from their own queue, so
+     * a stop never waits behind the commands queued before it. Messages received meanwhile
+     * are queued behind it; the slot is kept until consumeRx(), so a command is parsed
+     * straight from the arena.
+     * @param[out] msg Points at the message text and sender.
+     * @return false if the RX queue is empty.
+     */
+	bool peekRx(MessageView& msg) const;
+
+    /**
+     * @brief Releases the message returned by peekRx().
+     */
+	void consumeRx();
+
+    /**
+     * @brief Gets the command a received line carries, past its request ID and through a
+     * "cmdb" frame's command byte.
+     * @param text Received line.
+     * @return The command, or CMD_UNKNOWN.
+     */
+	static Command classifyRx(const char* text);
+
     /**
      * @brief Enqueues a message into the TX queue to be sent.
      * @details This function is used by the application to send messages to a remote
@@ -109,11 +235,80 @@ class CommsController {
      * @param msg The raw message string to send.
      * @param ip The IP address of the destination.
      * @param port The port of the destination.
+     * @param lane Priority lane.
      * @return true if the message was successfully enqueued.
-     * @return false if the TX queue is full, in which case the message is dropped.
-     * @note If the queue is full, an error message is immediately sent back to the GUI.
+     * @return false if the lane is full, in which case the message is dropped.
+     * @note If the control lane is full, an error message is immediately sent back to the GUI.
+     * The telemetry and bulk lanes drop silently; their producers pace on getTxQueueFree().
+     */
+	bool enqueueTx(const char* msg, const IpAddress& ip, uint16_t port, TxLane lane = TX_LANE_CONTROL);
+	/**
+     * @brief Reserves space in the TX queue so a producer can format a message in place.
+     * @details Pair with commitTx(). Nothing is queued until the commit, and a reservation
+     * that is never committed is simply replaced by the next one. Main loop only.
+     * On the telemetry lane any frame still waiting to be sent is discarded first, so the
+     * host is never more than one frame behind.
+     * @param capacity Bytes the caller may write, including the terminating NUL
+     *                 (at most `MAX_MESSAGE_LENGTH`).
+     * @param lane Priority lane.
+     * @return Buffer of @p capacity bytes, or NULL if no slot or no contiguous space is free
+     *         (a full control lane sends the same overflow error as enqueueTx()).
+     */
+	char* reserveTx(size_t capacity, TxLane lane = TX_LANE_CONTROL);
+	/**
+     * @brief Queues the message written into the last reserveTx() buffer.
+     * @details The message goes to the lane it was reserved in. Only @p length + 1 bytes of
+     * the reservation are kept; the rest is returned to the arena.
+     * @param length Text length, excluding the NUL (clamped to the reserved capacity).
+     * @param ip The IP address of the destination.
+     * @param port The port of the destination.
+     */
+	void commitTx(size_t length, const IpAddress& ip, uint16_t port);
+
+	/**
+     * @brief Gets the number of free slots in a TX lane.
+     * @details Lets bulk senders pace themselves instead of overflowing the lane.
+     * @param lane Priority lane.
+     * @return Messages that can be enqueued before enqueueTx() starts dropping, counting
+     *         both free slots and free arena space at `TX_SLOT_BYTES_NOMINAL` per message.
+     */
+	int getTxQueueFree(TxLane lane = TX_LANE_CONTROL) const;
+
+	/**
+     * @brief Gets the number of messages waiting in a TX lane.
+     * @param lane Priority lane.
+     * @return Queued messages.
+     */
+	int getTxQueueCount(TxLane lane) const { return m_txQueue[lane].getCount(); }
+
+	/**
+     * @brief Gets the number of received messages waiting to be dispatched.
+     * @return Queued messages.
      */
-	bool enqueueTx(const char* msg, const IpAddress& ip, uint16_t port);
+	int getRxQueueCount() const { return m_rxQueue.getCount() + m_rxUrgentQueue.getCount(); }
+
+	/**
+	 * @brief Gets the number of command datagrams received since boot.
+	 * @return Datagrams.
+	 */
+	uint32_t getUdpRxDatagrams() const { return m_udpRxDatagrams; }
+	/**
+	 * @brief Gets the number of datagrams dropped because the pbuf queue was full.
+	 * @return Datagrams.
+	 */
+	uint32_t getUdpRxDropped() const { return m_udpRxDropped; }
+	/**
+	 * @brief Gets the most datagrams one receive poll has taken.
+	 * @return Datagrams.
+	 */
+	uint8_t getUdpRxMaxPerPass() const { return m_udpRxMaxPerPass; }
+
+	/**
+     * @brief Checks whether a lane still holds unsent messages.
+     * @param lane Priority lane.
+     * @return true if at least one message in @p lane has not been sent yet.
+     */
+	bool hasPendingTx(TxLane lane) const { return m_txQueue[lane].getCount() > 0; }
 	
 	/**
      * @brief A helper function to enqueue a formatted status or event message.
@@ -122,8 +317,22 @@ class CommsController {
      * message to the discovered GUI application.
      * @param statusType A string prefix indicating the message type (e.g., "INFO: ").
      * @param message The main content of the message.
+     * @param lane Priority lane. A dump's closing event goes on TX_LANE_BULK so it arrives
+     *             after the dump lines; if the bulk lane is full it falls back to the control
+     *             lane rather than being lost.
+     * @param requestId Request ID of the command the event answers; non-zero IDs are sent
+     *                  as "#<id> " in front of @p message.
+     */
+	void reportEvent(TextView statusType, TextView message, TxLane lane = TX_LANE_CONTROL,
+	                 uint32_t requestId = 0);
+
+	/**
+     * @brief reportEvent() with C strings; a literal prefix or message is measured at compile time.
      */
-	void reportEvent(const char* statusType, const char* message);
+	void reportEvent(const char* statusType, const char* message, TxLane lane = TX_LANE_CONTROL,
+	                 uint32_t requestId = 0) {
+		reportEvent(text_view(statusType), text_view(message), lane, requestId);
+	}
 
 	// Getters
 	/**
@@ -144,6 +353,12 @@ class CommsController {
      */
 	uint16_t getGuiPort() const { return m_guiPort; }
 
+    /**
+     * @brief Gets the identity fields the discovery reply and the announcement start with.
+     * @return "DEVICE_ID=... PORT=... FW=...", built once at construction
+     */
+	TextView getIdentity() const { return TextView{ m_identity, m_identityLength }; }
+
 	// Setters
 	/**
      * @brief Sets the discovery state of the GUI.
@@ -170,57 +385,452 @@ class CommsController {
 	 */
 	void notifyUsbHostActive();
 
+	/**
+	 * @brief Selects the USB framing, as negotiated in DISCOVER_DEVICE.
+	 * @details Applies to messages dequeued from now on; bytes already in the USB ring keep
+	 * the framing they were written with.
+	 * @param framing The new framing.
+	 */
+	void setUsbFraming(UsbFraming framing) { m_usbFraming = framing; }
+	/**
+	 * @brief Gets the USB framing in use.
+	 * @return The current framing.
+	 */
+	UsbFraming getUsbFraming() const { return m_usbFraming; }
+
+	/**
+	 * @brief Selects which messages are mirrored to USB; not saved.
+	 * @details On a network-only station a PC left on USB otherwise costs a framed USB copy of
+	 * every message, telemetry included, on top of the UDP send.
+	 * @param route The new routing policy.
+	 */
+	void setUsbRoute(UsbRoute route) { m_usbRoute = route; }
+	/**
+	 * @brief Gets the USB routing policy.
+	 * @return The current policy.
+	 */
+	UsbRoute getUsbRoute() const { return m_usbRoute; }
+
+	/**
+	 * @brief Turns UDP batching on or off, as negotiated in DISCOVER_DEVICE (UDP=BATCH1).
+	 * @details With batching on, each processTxQueue() pass sends up to TX_PASS_MAX_MESSAGES
+	 * messages, packing those for the same destination newline-separated into datagrams of
+	 * up to MAX_PACKET_LENGTH bytes. USB output is unchanged.
+	 * @param enabled true to batch, false for one message per datagram.
+	 */
+	void setUdpBatching(bool enabled) { m_udpBatching = enabled; }
+	/**
+	 * @brief Checks whether UDP batching is on.
+	 * @return true if messages are packed into shared datagrams.
+	 */
+	bool isUdpBatching() const { return m_udpBatching; }
+
+	/**
+	 * @brief Adds or renews a telemetry subscriber.
+	 * @details Every telemetry frame is serialized once into the telemetry lane; when it is
+	 * sent, each subscriber that is due gets a copy of the same bytes. A subscriber's rate
+	 * can therefore be at most the frame rate set by set_telemetry.
+	 * @param ip Host address.
+	 * @param port Host port.
+	 * @param interval_ms Minimum time between frames for this host.
+	 * @param lease_ms How long the subscription lasts without a renewal.
+	 * @return false if the table is full.
+	 */
+	bool subscribeTelemetry(const IpAddress& ip, uint16_t port, uint32_t interval_ms, uint32_t lease_ms);
+	/**
+	 * @brief Removes a telemetry subscriber.
+	 * @param ip Host address.
+	 * @param port Host port.
+	 * @return false if the host was not subscribed.
+	 */
+	bool unsubscribeTelemetry(const IpAddress& ip, uint16_t port);
+	/**
+	 * @brief Counts the active telemetry subscribers.
+	 * @return Entries in use, including ones whose lease ran out but are not yet swept.
+	 */
+	int getTelemetrySubscriberCount() const;
+
+    /**
+     * @brief Sends an ARP request for a host, so its address is resolved before the first
+     * datagram to it. Called for a newly discovered GUI and telemetry subscriber, and by the
+     * background refresh.
+     * @param ip Host address (off-subnet hosts resolve the gateway)
+     */
+	void resolveHost(const IpAddress& ip);
+
+	/**
+	 * @brief Parses a leading request-ID token ("#123 move_abs ...").
+	 * @param text Command text.
+	 * @param rest Receives the command after the token and its spaces (@p text if none).
+	 * @return The ID (1 to 2^31-1), or 0 if the command has none.
+	 */
+	static uint32_t parseRequestId(const char* text, const char** rest);
+
+	/**
+	 * @brief Checks whether a host is connected to the bulk TCP stream.
+	 * @return true while bulk-lane output goes to TCP instead of UDP.
+	 */
+	bool isBulkTcpConnected() { return m_bulkClient.Connected(); }
+
 	private:
 	/**
+	 * @struct UdpRxEntry
+	 * @brief A received datagram, still in its LwIP pbuf.
+	 */
+	struct UdpRxEntry {
+		struct pbuf* packet;    ///< Datagram payload (owned until freed by drainUdpRx()).
+		IpAddress remoteIp;     ///< Sender address.
+		uint16_t remotePort;    ///< Sender port.
+	};
+
+	/**
      * @brief Processes incoming UDP packets.
-     * @details Reads any available data from the UDP buffer and enqueues it
-     * into the RX queue for later processing.
+     * @details Hands Ethernet frames to LwIP until UDP_RX_BUDGET_US has gone, a frame brings
+     * no datagram, UDP_RX_MAX_FRAMES_PER_PASS frames were taken or the RX queue is short of
+     * room; the rest stays in the MAC's receive descriptors for the next poll. Each datagram
+     * is enqueued into the RX queue, one entry per newline-separated command.
      */
 	void processUdp();
 
+	/**
+	 * @brief LwIP receive callback on the command pcb: queues the datagram's pbuf.
+	 * @details Runs inside EthernetMgr.Refresh(), in the loop context. Replaces EthernetUdp's
+	 * callback, which holds a single datagram and drops it when the next one arrives in
+	 * the same poll.
+	 */
+	static void udpReceive(void* arg, struct udp_pcb* pcb, struct pbuf* p, const ip_addr_t* addr, u16_t port);
+
+	/**
+	 * @brief Splits the queued datagrams into commands and frees their pbufs.
+	 * @details Each datagram is copied once, from its pbuf into RX queue space, and its
+	 * commands are dispatched from there.
+	 * @return Datagrams taken.
+	 */
+	int drainUdpRx();
+
+	/**
+	 * @brief Enqueues each newline-separated command of a datagram.
+	 * @details While the datagram sits in an RX queue reservation (m_rxStage), its commands
+	 * are queued where they lie. An urgent command moves the rest of it to m_packetBuffer
+	 * first, as a cancel or reset clears the RX queue.
+	 * @param text Datagram text, NUL-terminated at @p length; the separators are overwritten.
+	 * @param length Characters of @p text.
+	 * @param ip Sender address.
+	 * @param port Sender port.
+	 */
+	void receiveUdpDatagram(char* text, size_t length, const IpAddress& ip, uint16_t port);
+
+	/**
+	 * @brief Queues one command of a datagram, in place if it is in the RX queue reservation.
+	 * @param line Command text, NUL-terminated at @p length.
+	 * @param length Characters of @p line.
+	 * @param ip Sender address.
+	 * @param port Sender port.
+	 * @return false if the RX queue is full, in which case the command is dropped.
+	 */
+	bool queueRxCommand(char* line, size_t length, const IpAddress& ip, uint16_t port);
+
     /**
      * @brief Processes incoming USB serial data.
-     * @details Reads characters from the USB serial port, buffers them until
-     * a newline is received, then enqueues the complete message into the RX queue.
+     * @details Takes up to USB_RX_MAX_BYTES_PER_PASS bytes out of the USB receive ring with
+     * CharGet(), USB_RX_CHUNK_SIZE at a time, stopping early while the RX queue is full, and
+     * enqueues each complete line into the RX queue.
      */
 	void processUsbSerial();
 
+	/**
+	 * @brief Splits received USB bytes into command lines.
+	 * @details Lines end at '\n' or '\r', found with memchr(); a line longer than
+	 * MAX_MESSAGE_LENGTH is reported and dropped up to its terminator.
+	 * @param data Received bytes.
+	 * @param length Number of bytes.
+	 */
+	void receiveUsbBytes(const char* data, int32_t length);
+
+	/**
+	 * @brief Enqueues the completed USB line in m_usbRxLine and starts the next one.
+	 */
+	void finishUsbLine();
+
+    /**
+     * @brief Services the bulk TCP stream on BULK_TCP_PORT.
+     * @details Accepts one host at a time (a newer one replaces it), drops it once it
+     * disconnects, and queues each newline-terminated line it sends as a command.
+     */
+	void processBulkTcp();
+    /**
+     * @brief Queues one command received over UDP, acknowledging it if it carries a request ID.
+     * @details A command with an ID is answered with "ACK: #<id>" as soon as it is queued, so
+     * the host can retry after tens of milliseconds instead of waiting for its reply. A retry
+     * of an ID seen recently from the same address is acknowledged again but not queued
+     * twice. Nothing is acknowledged when the RX queue is full, so the host retries.
+     * @param line Command text, NUL-terminated at @p length.
+     * @param length Characters of @p line.
+     * @param ip Sender address.
+     * @param port Sender port.
+     */
+	void receiveUdpCommand(char* line, size_t length, const IpAddress& ip, uint16_t port);
+    /**
+     * @brief Adds a bulk-lane line to the pending TCP write.
+     * @param text Line text.
+     * @param length Line length (a newline is added).
+     * @return false if the line does not fit until the stream drains; it stays queued.
+     */
+	bool bulkTcpWrite(const char* text, size_t length);
+    /**
+     * @brief Hands the pending TCP write to lwIP if the send window and queue have room.
+     * @details Never waits: EthernetTcpClient::Send() only spins when the send queue is
+     * half full, so nothing is written until it is below that.
+     * @return true if nothing is left pending.
+     */
+	bool flushBulkTcp();
+
     /**
      * @brief Processes the outgoing message queue.
-     * @details Dequeues one message from the TX queue (if available) and sends it
-     * over UDP to its destination.
+     * @details Dequeues one message from the TX queue (if available), sends it over UDP
+     * to its destination and queues its USB mirror. Never waits for USB space.
+     * @param budget_us See updateTx()
      */
-	void processTxQueue();
+	void processTxQueue(uint32_t budget_us);
 
     /**
      * @brief Configures and initializes the Ethernet hardware.
-     * @details This function handles the low-level setup of the Ethernet manager,
-     * including DHCP negotiation to obtain an IP address and starting the UDP listener.
+     * @details Only initializes lwIP and the MAC; link-up, DHCP and the listeners follow
+     * from serviceNetwork(), so setup never waits on the network.
      */
 	void setupEthernet();
 
+    /**
+     * @brief Advances the Ethernet bring-up by one non-blocking step.
+     * @details Waits for the PHY link, then runs DHCP for up to NETWORK_DHCP_TIMEOUT_MS
+     * while the loop keeps going, falling back to NETWORK_FALLBACK_IP if no lease arrives.
+     * Once an address is set, opens the UDP port and the bulk TCP listener.
+     */
+	void serviceNetwork();
+
+    /**
+     * @brief Opens the UDP port and the bulk TCP listener and reports the address.
+     * @param source How the address was obtained ("DHCP" or "fallback")
+     */
+	void openNetwork(const char* source);
+
+#if ANNOUNCE_ENABLED
+    /**
+     * @brief Builds the announcement for the address just assigned and schedules the first one.
+     */
+	void buildAnnounce();
+
+    /**
+     * @brief Broadcasts the announcement when it is due. Straight to the pcb: it neither
+     * waits behind the TX queue nor is copied to USB.
+     */
+	void serviceAnnounce();
+
+    /**
+     * @brief Draws the next announcement jitter.
+     * @return 0 .. ANNOUNCE_JITTER_MS - 1
+     */
+	uint32_t announceJitter();
+#endif
+
     /**
      * @brief Configures and initializes the USB serial port.
      * @details This function sets up the USB port to act as a CDC (serial) device,
      * which is useful for debugging purposes.
      */
 	void setupUsbSerial();
+    /**
+     * @brief Gets the USB bytes a message takes once framed in the current framing.
+     * @param length Message length, excluding the NUL.
+     * @return Upper bound on the bytes queueUsbText() writes.
+     */
+	size_t usbFramedLength(size_t length) const;
+    /**
+     * @brief Gets the free space in the USB transmit ring.
+     * @return Bytes that can be queued.
+     */
+	size_t usbTxFree() const;
+    /**
+     * @brief Copies bytes into the USB transmit ring (space must already be checked).
+     * @param data Bytes to copy.
+     * @param length Number of bytes.
+     */
+	void usbTxWrite(const char* data, size_t length);
+    /**
+     * @brief Frames a message for USB and queues it in the USB transmit ring.
+     * @details In USB_FRAMING_LINES, messages longer than USB_CHUNK_SIZE are split into
+     * "CHUNK_i/n:" lines; in USB_FRAMING_COBS the whole message is one COBS frame.
+     * @param text Message text.
+     * @param length Message length, excluding the NUL.
+     */
+	void queueUsbText(const char* text, size_t length);
+    /**
+     * @brief Hands queued USB bytes to the USB stack without waiting.
+     * @details Writes only as much as ConnectorUsb.AvailableForWrite() reports, so it never
+     * blocks; the USB stack moves it out as the endpoint frees up. Drops the ring when no
+     * host is reading.
+     */
+	void serviceUsbTx();
+    /**
+     * @brief Queues the PRESSBOI_COMMS frame of queue high-water marks and drop counters
+     * when it is due.
+     * @details On the bulk lane, to the GUI (and USB), every COMMS_STATS_INTERVAL_MS. An
+     * overflow only counts; nothing extra is sent on a link that is already saturated, and
+     * a frame that finds the bulk lane full is skipped (the counters are cumulative).
+     */
+	void serviceStats();
+    /**
+     * @brief Sends one datagram from the listening port without copying it.
+     * @details Goes straight to udp_sendto() on the pcb EthernetUdp bound to LOCAL_PORT,
+     * wrapping @p text in a preallocated PBUF_REF pbuf; the ethernet driver copies it into
+     * its DMA buffer, so the text only has to live until this returns. The lwIP destination
+     * is rebuilt only when it changes. Falls back to EthernetUdp when the pcb was not found.
+     * @param ip Destination address (already checked by the caller).
+     * @param port Destination port.
+     * @param text Datagram payload.
+     * @param length Payload length.
+     */
+	void sendUdp(const IpAddress& ip, uint16_t port, const char* text, uint16_t length);
+    /**
+     * @brief Appends a message to the pending UDP batch.
+     * @details Sends the batch first if it is bound elsewhere or the message (plus its
+     * newline separator) would push it past MAX_PACKET_LENGTH.
+     * @param ip Destination address.
+     * @param port Destination port.
+     * @param text Message text.
+     * @param length Message length.
+     */
+	void batchUdp(const IpAddress& ip, uint16_t port, const char* text, uint16_t length);
+    /**
+     * @brief Sends the pending UDP batch, if any.
+     */
+	void flushUdpBatch();
+    /**
+     * @brief Sends a datagram, through the batch when UDP batching is on.
+     * @param ip Destination address.
+     * @param port Destination port.
+     * @param text Message text.
+     * @param length Message length.
+     */
+	void sendUdpMessage(const IpAddress& ip, uint16_t port, const char* text, uint16_t length);
+    /**
+     * @brief Copies a telemetry frame to every subscriber that is due, dropping expired leases.
+     * @param msg The frame's slot (its own destination is skipped).
+     * @param text The frame text.
+     */
+	void fanOutTelemetry(const MessageSlot& msg, const char* text);
+    /**
+     * @brief Checks whether lwIP can send to a host without holding the datagram for ARP.
+     * @details Until an address resolves lwIP keeps only the newest datagram for it, so a
+     * telemetry frame sent then would replace the discovery reply or event already waiting.
+     * While unresolved, asks for the address (at most every UDP_ARP_RETRY_MS), in case
+     * nothing else is being sent to that host.
+     * @param ip Host address (off-subnet hosts are checked through the gateway)
+     * @return true if the next hop's MAC address is in the ARP table
+     */
+	bool udpPathResolved(const IpAddress& ip);
+    /**
+     * @brief Decides whether a message for an unresolved host waits in its lane.
+     * @details Each host is waited for once, for up to UDP_ARP_HOLD_MAX_MS from the first
+     * message held; a host that does not answer ARP in that time is sent to unheld until it
+     * resolves, so a departed GUI never throttles the queue.
+     * @param ip Host address
+     * @return true to leave the message queued for the next pass
+     */
+	bool holdForArp(const IpAddress& ip);
+    /**
+     * @brief Refreshes the ARP entry of the next registered host, round robin over the GUI
+     * and the subscriber slots, one every UDP_ARP_REFRESH_MS / (slots + 1).
+     */
+	void serviceArpRefresh();
 
+	NetworkState m_netState;    ///< Ethernet bring-up progress.
+	uint32_t m_netStateStart;   ///< Milliseconds() when m_netState was entered.
 	EthernetUdp m_udp;          ///< The underlying UDP communication object.
+	struct udp_pcb* m_udpPcb;   ///< LwIP pcb behind m_udp, used for sending (nullptr until found).
+	struct pbuf* m_udpTxRef;    ///< Reusable PBUF_REF pbuf pointed at each outgoing payload.
+	ip_addr_t m_udpDestIp;      ///< Destination of the last datagram, in lwIP form.
+	uint16_t m_udpDestPort;     ///< Port of the last datagram (0 = none yet).
+	bool m_udpBatching;         ///< Pack several messages per datagram (UDP=BATCH1).
+	char m_udpBatch[MAX_PACKET_LENGTH];  ///< Messages waiting to go out as one datagram.
+	uint16_t m_udpBatchLength;  ///< Bytes in m_udpBatch (0 = empty).
+	IpAddress m_udpBatchIp;     ///< Destination of the pending batch.
+	uint16_t m_udpBatchPort;    ///< Destination port of the pending batch.
+	TelemetrySubscriber m_telemetrySubscribers[TELEMETRY_SUBSCRIBER_COUNT]; ///< Extra telemetry hosts.
+	uint32_t m_arpRequestMs;    ///< Milliseconds() of the last ARP request udpPathResolved() sent.
+	IpAddress m_arpHoldIp;      ///< Host holdForArp() is waiting for (0.0.0.0 = none).
+	uint32_t m_arpHoldStartMs;  ///< Milliseconds() when the wait for m_arpHoldIp began.
+	uint32_t m_arpRefreshMs;    ///< Milliseconds() of the last background refresh.
+	uint8_t m_arpRefreshNext;   ///< Refresh slot: 0 = GUI, n = subscriber n - 1.
+	UdpRxEntry m_udpRx[UDP_RX_PBUF_QUEUE];  ///< Received datagrams, oldest at m_udpRxTail.
+	uint8_t m_udpRxTail;                    ///< Oldest queued datagram.
+	uint8_t m_udpRxCount;                   ///< Queued datagrams.
+	uint8_t m_udpRxMaxPerPass;              ///< Most datagrams one poll has taken.
+	uint32_t m_udpRxDatagrams;              ///< Datagrams received since boot.
+	uint32_t m_udpRxDropped;                ///< Datagrams dropped on a full m_udpRx.
+	uint32_t m_rxDropped;                   ///< Commands dropped on a full RX queue.
+	uint32_t m_rxUrgent;                    ///< Commands taken into the urgent queue.
+	uint32_t m_rxFlushed;                   ///< Queued commands discarded by a later cancel or reset.
+	uint32_t m_txDropped[TX_LANE_COUNT];    ///< Messages dropped on a full TX lane.
+	uint32_t m_telemetryReplaced;           ///< Telemetry frames replaced by a newer one before they were sent.
+	uint32_t m_usbSkipped;                  ///< Telemetry frames not mirrored to USB for lack of ring space.
+	uint32_t m_usbTimeouts;                 ///< Times the USB host stopped reading and was dropped.
+	uint32_t m_udpSendErrors;               ///< Datagrams the stack refused to send.
+	uint32_t m_statsMs;                     ///< Milliseconds() of the last PRESSBOI_COMMS frame.
+
+	uint32_t m_recentRequestAddr[RX_DEDUP_HISTORY]; ///< Sender address of each remembered request ID.
+	uint32_t m_recentRequestId[RX_DEDUP_HISTORY];   ///< Recently received network request IDs (0 = unused).
+	uint8_t m_recentRequestNext;                    ///< Entry the next request ID overwrites.
+
+	EthernetTcpServer m_bulkServer;             ///< Listener on BULK_TCP_PORT.
+	EthernetTcpClient m_bulkClient;             ///< Connected bulk host (not connected when none).
+	char m_bulkTxChunk[BULK_TCP_CHUNK_SIZE];    ///< Bulk lines waiting to go out in one TCP write.
+	uint16_t m_bulkTxLength;                    ///< Bytes in m_bulkTxChunk.
+	char m_bulkRxLine[MAX_MESSAGE_LENGTH];      ///< Command line being received over TCP.
+	uint16_t m_bulkRxLength;                    ///< Bytes in m_bulkRxLine.
+	char m_usbRxLine[MAX_MESSAGE_LENGTH];       ///< Command line being received over USB.
+	uint16_t m_usbRxLength;                     ///< Bytes in m_usbRxLine.
+	bool m_usbRxOverlong;                       ///< The USB line outgrew m_usbRxLine and is dropped up to its end.
+	uint32_t m_usbRxLastMs;                     ///< Milliseconds() of the previous USB command line.
 	IpAddress m_guiIp;          ///< The IP address of the remote GUI application.
 	uint16_t m_guiPort;         ///< The port number of the remote GUI application.
 	bool m_guiDiscovered;       ///< Flag indicating if a handshake with the GUI has occurred.
+	char m_identity[64];        ///< DEVICE_ID, PORT and FW fields shared by discovery replies and announcements.
+	uint16_t m_identityLength;  ///< Characters in m_identity.
+#if ANNOUNCE_ENABLED
+	char m_announce[ANNOUNCE_MAX_LENGTH]; ///< The announcement datagram (0 length until the network is up).
+	uint16_t m_announceLength;  ///< Characters in m_announce.
+	IpAddress m_announceIp;     ///< Directed broadcast address of the local subnet.
+	uint32_t m_announceDueMs;   ///< Milliseconds() at which the next announcement goes out.
+	uint32_t m_announceRandom;  ///< xorshift32 state for the jitter, seeded from the MAC address.
+#endif
 
 	unsigned char m_packetBuffer[MAX_PACKET_LENGTH]; ///< Buffer for reading raw UDP data.
 	
 	// Message Queues
-	Message m_rxQueue[RX_QUEUE_SIZE];   ///< The circular buffer for incoming messages.
-	volatile int m_rxQueueHead;         ///< Index of the next free slot in the RX queue.
-	volatile int m_rxQueueTail;         ///< Index of the next message to be read from the RX queue.
+	char m_rxArena[RX_ARENA_SIZE];          ///< Text of incoming messages.
+	MessageSlot m_rxSlots[RX_QUEUE_SIZE];   ///< Descriptors of incoming messages.
+	MessageRing m_rxQueue;                  ///< Incoming messages, oldest first.
+	char m_rxUrgentArena[RX_URGENT_ARENA_SIZE];         ///< Text of incoming urgent commands.
+	MessageSlot m_rxUrgentSlots[RX_URGENT_QUEUE_SIZE];  ///< Descriptors of incoming urgent commands.
+	MessageRing m_rxUrgentQueue;                        ///< Incoming urgent commands, oldest first; dispatched before m_rxQueue.
+	mutable bool m_rxPeekUrgent;                        ///< The last peekRx() came from m_rxUrgentQueue.
+	char* m_rxStage;                                    ///< RX queue reservation holding the datagram being split (NULL = none).
+
+	char m_txArena[TX_ARENA_SIZE];                      ///< Text of outgoing control-lane messages.
+	MessageSlot m_txSlots[TX_QUEUE_SIZE];               ///< Descriptors of outgoing control-lane messages.
+	char m_txTelemetryArena[TX_TELEMETRY_ARENA_SIZE];   ///< Text of outgoing telemetry frames.
+	MessageSlot m_txTelemetrySlots[TX_TELEMETRY_QUEUE_SIZE]; ///< Descriptors of outgoing telemetry frames.
+	char m_txBulkArena[TX_BULK_ARENA_SIZE];             ///< Text of outgoing bulk-lane messages.
+	MessageSlot m_txBulkSlots[TX_BULK_QUEUE_SIZE];      ///< Descriptors of outgoing bulk-lane messages.
+	MessageRing m_txQueue[TX_LANE_COUNT];               ///< Outgoing messages per lane, oldest first.
+	TxLane m_txReserveLane;                             ///< Lane of the outstanding reserveTx().
 
-	Message m_txQueue[TX_QUEUE_SIZE];   ///< The circular buffer for outgoing messages.
-	volatile int m_txQueueHead;         ///< Index of the next free slot in the TX queue.
-	volatile int m_txQueueTail;         ///< Index of the next message to be sent from the TX queue.
+	char m_usbTxRing[USB_TX_RING_SIZE];     ///< Framed USB output waiting for room in the USB stack.
+	uint16_t m_usbTxHead;                   ///< Next free index in m_usbTxRing.
+	uint16_t m_usbTxTail;                   ///< Next index of m_usbTxRing to hand to the USB stack.
+	UsbFraming m_usbFraming;                ///< Framing of new USB output.
+	UsbRoute m_usbRoute;                    ///< Which messages are mirrored to USB.
 
     // USB host health tracking
     uint32_t m_lastUsbHealthy;
@@ -10,7 +10,12 @@
  * controller modules. The parameters are organized into logical sections for clarity.
  */
 #pragma once
+// PRESSBOI_HOST: built on a PC (test/host, benchmarks) from the modules that use no ClearCore
+// symbols (commands, command_args, variables, text_format, base64, motion_profile,
+// machine_strain, press_energy). This file only names ClearCore objects inside macros those modules never expand.
+#if !defined(PRESSBOI_HOST)
 #include "ClearCore.h"
+#endif
 
 //==================================================================================================
 // Device Identity
@@ -33,10 +38,56 @@
 #define LOCAL_PORT                      8888      ///< The UDP port this device listens on for incoming commands.
 #define CLIENT_PORT                     6272      ///< The UDP port the GUI client listens on.
 #define MAX_PACKET_LENGTH               1024      ///< Maximum size in bytes for a single UDP packet. Must be large enough for the longest telemetry string.
-#define RX_QUEUE_SIZE                   32        ///< Number of incoming messages that can be buffered before processing.
-#define TX_QUEUE_SIZE                   32        ///< Number of outgoing messages that can be buffered before sending.
+#define RX_QUEUE_SIZE                   64        ///< Number of incoming messages that can be buffered before processing.
+#define TX_QUEUE_SIZE                   160       ///< Number of outgoing events and command replies (control lane) that can be buffered before sending.
+#define TX_TELEMETRY_QUEUE_SIZE         2         ///< Telemetry lane descriptors: one pending frame, which a newer frame replaces.
+#define TX_BULK_QUEUE_SIZE              160       ///< Number of dump and debug lines (bulk lane) that can be buffered before sending.
 #define MAX_MESSAGE_LENGTH              MAX_PACKET_LENGTH ///< Maximum size of a single message in the Rx/Tx queues.
-#define TELEMETRY_INTERVAL_MS			100       ///< How often (in milliseconds) telemetry data is published to the GUI.
+#define RX_ARENA_SIZE                   4096      ///< Bytes of queued RX text shared by all RX slots (each message takes its length + 1).
+#define RX_URGENT_QUEUE_SIZE            4         ///< pause, cancel and reset commands held apart from the RX queue and dispatched ahead of it.
+#define RX_URGENT_ARENA_SIZE            256       ///< Bytes of queued urgent-command text.
+#define TX_ARENA_SIZE                   16384     ///< Bytes of queued control-lane text (each message takes its length + 1).
+#define TX_TELEMETRY_ARENA_SIZE         MAX_MESSAGE_LENGTH ///< Bytes of telemetry-lane text (one full-size frame).
+#define TX_BULK_ARENA_SIZE              16384     ///< Bytes of queued bulk-lane text.
+#define USB_TX_RING_SIZE                4096      ///< Bytes of framed USB output buffered ahead of the USB stack (power of two).
+#define USB_TX_CONTROL_RESERVE          1024      ///< USB ring bytes telemetry and bulk lines leave free for events.
+#define USB_CHUNK_SIZE                  50        ///< Longer messages are split into "CHUNK_i/n:" lines of this many bytes on USB.
+#define USB_RX_CHUNK_SIZE               64        ///< USB bytes gathered with CharGet() before each line split.
+#define USB_RX_MAX_BYTES_PER_PASS       512       ///< Most USB bytes one receive poll takes; the rest stays in the USB ring for the next poll.
+#define USB_RX_LOG_COMMANDS             0         ///< 1 = write every USB command line to the error log (a TRACE_USB_RX record is always kept).
+#define RX_DEDUP_HISTORY                32        ///< Recent network request IDs remembered, so a retried command is acknowledged again but not run twice.
+#define UDP_RX_BUDGET_US                250       ///< A receive poll keeps taking Ethernet frames until this much time has gone (at least one per poll).
+#define UDP_RX_MAX_FRAMES_PER_PASS      16        ///< Most Ethernet frames one receive poll hands to LwIP.
+#define UDP_RX_PBUF_QUEUE               8         ///< Received datagrams held as LwIP pbufs until the poll splits them into commands.
+#define TX_PASS_MAX_MESSAGES            16        ///< Most queued messages one processTxQueue() pass sends when UDP batching or the bulk TCP stream is on.
+#define BULK_TCP_PORT                   8889      ///< TCP port a host can connect to for flow-controlled bulk-lane output and bulk command input.
+#define BULK_TCP_CHUNK_SIZE             1460      ///< Bulk lines are gathered into writes of up to this many bytes (one TCP_MSS).
+#define TX_SLOT_BYTES_NOMINAL           256       ///< Arena bytes getTxQueueFree() counts per message, so slot-based reserves also hold back space.
+#define EVENT_QUEUE_SIZE                16        ///< Typed status events (EventRecord) held until the TX task renders them (power of 2).
+#define EVENT_RECORD_MAX_ARGS           3         ///< Numeric arguments an EventRecord carries.
+#define TELEMETRY_INTERVAL_MS			100       ///< How often (in milliseconds) telemetry data is published to the GUI until set_telemetry changes it.
+#define TELEMETRY_RATE_HZ_MIN           0.5f      ///< Slowest rate accepted by set_telemetry.
+#define TELEMETRY_RATE_HZ_MAX           500.0f    ///< Fastest rate accepted by set_telemetry.
+#define TELEMETRY_KEYFRAME_MS_MAX       60000     ///< Longest keyframe period accepted by set_telemetry_delta.
+#define TELEMETRY_PRESS_RATE_HZ_DEFAULT 100.0f    ///< Burst rate while a move is loaded past the press threshold, until set_telemetry_burst changes it (0 = no burst).
+#define TELEMETRY_PRESS_HOLD_MS_DEFAULT 250       ///< The burst rate is kept this long after the force drops back, so the unload is sent at it too.
+#define TELEMETRY_PRESS_HOLD_MS_MAX     10000     ///< Longest hold accepted by set_telemetry_burst.
+#define TELEMETRY_SUBSCRIBER_COUNT      4         ///< Extra network hosts that can subscribe_telemetry alongside the discovered GUI.
+#define TELEMETRY_LEASE_S_DEFAULT       30        ///< Seconds a telemetry subscription lasts unless renewed.
+#define TELEMETRY_LEASE_S_MAX           3600      ///< Longest lease accepted by subscribe_telemetry.
+#define UDP_ARP_RETRY_MS                100       ///< While a host's MAC address is unresolved its telemetry frames skip UDP, and an ARP request goes out at most this often.
+#define UDP_ARP_HOLD_MAX_MS             100       ///< Control and bulk messages wait in their lane up to this long for a host's address to resolve, rather than replace each other in lwIP's one-datagram ARP queue.
+#define UDP_ARP_REFRESH_MS              60000     ///< The GUI and each telemetry subscriber get an ARP request this often, well inside lwIP's 5 min ARP_MAXAGE, so sparse traffic never meets an expired entry.
+#define CLOCK_SYNC_TOKEN_MAX            16        ///< Characters of a DISCOVER_DEVICE SYNC=<token> echoed back with the device clock (T_US=).
+#define ANNOUNCE_ENABLED                1         ///< 1 = broadcast a DISCOVERY_ANNOUNCE datagram to CLIENT_PORT on the local subnet, so hosts learn of the press without polling.
+#define ANNOUNCE_INTERVAL_MS            5000      ///< Mean time between announcements.
+#define ANNOUNCE_JITTER_MS              2000      ///< Each interval is drawn from ANNOUNCE_INTERVAL_MS +/- half this, and the first comes within this of network-up, so a fleet spreads out.
+#define ANNOUNCE_MAX_LENGTH             160       ///< Bytes of the announcement text, built once when the network comes up.
+#define COMMS_STATS_INTERVAL_MS         10000     ///< How often the queue high-water marks and drop counters go out as a PRESSBOI_COMMS frame (0 = never).
+#define NETWORK_DHCP_TIMEOUT_MS         10000     ///< DHCP runs in the background this long after link-up before the fallback address is used.
+#define NETWORK_FALLBACK_IP             IpAddress(192, 168, 1, 177) ///< Static address used when DHCP gets no lease.
+#define NETWORK_FALLBACK_NETMASK        IpAddress(255, 255, 255, 0) ///< Netmask of the fallback address.
+#define NETWORK_FALLBACK_GATEWAY        IpAddress(192, 168, 1, 1)   ///< Gateway of the fallback address.
 /** @} */
 
 //==================================================================================================
@@ -48,6 +99,7 @@
  */
 #define FIRMWARE_VERSION                "1.14.1"   ///< Pressboi firmware version
 #define STATUS_MESSAGE_BUFFER_SIZE      256       ///< Standard buffer size for composing status and error messages.
+#define CMD_DISPATCH_BUDGET_US          2000      ///< Time a pass keeps dispatching queued commands (at least one per pass).
 /** @} */
 
 //==================================================================================================
@@ -57,9 +109,13 @@
  * @name Core System Parameters and Unit Conversions
  * @{
  */
-#define PITCH_MM_PER_REV                5.0f      ///< Linear travel (in mm) of the press for one full motor revolution.
-#define PULSES_PER_REV                  800       ///< Number of step pulses required for one full motor revolution (dependent on microstepping settings).
-#define STEPS_PER_MM                    (PULSES_PER_REV / PITCH_MM_PER_REV)   ///< Calculated steps per millimeter for the press drive.
+#define PITCH_MM_PER_REV                5.0f      ///< Default linear travel (in mm) of the press for one full motor revolution (set_drive_geometry overrides).
+#define PULSES_PER_REV                  800       ///< Default step pulses per motor revolution, as set in the drives (set_drive_geometry overrides).
+#define DRIVE_PITCH_MIN_MM              0.5f      ///< Smallest pitch set_drive_geometry accepts.
+#define DRIVE_PITCH_MAX_MM              50.0f     ///< Largest pitch set_drive_geometry accepts.
+#define DRIVE_PULSES_PER_REV_MIN        200       ///< Fewest pulses per revolution set_drive_geometry accepts.
+#define DRIVE_PULSES_PER_REV_MAX        51200     ///< Most pulses per revolution set_drive_geometry accepts.
+#define DRIVE_GEOMETRY_MAGIC            0x44474D31 ///< Folded into the stored geometry's check word ("DGM1").
 #define MAX_HOMING_DURATION_MS          100000    ///< Maximum time (in milliseconds) a homing operation is allowed to run before timing out.
 /** @} */
 
@@ -71,25 +127,28 @@
  * @{
  */
 // --- Motors ---
-#define MOTOR_A                         ConnectorM0 ///< Primary press motor.
+// Larger frames gang three or four drives; set MOTOR_AXIS_COUNT per build (e.g. -DMOTOR_AXIS_COUNT=4)
+#define MOTOR_AXIS_MAX                  4           ///< Motor connectors on the ClearCore (M0-M3); capacity of the per-axis state.
+#ifndef MOTOR_AXIS_COUNT
+#define MOTOR_AXIS_COUNT                2           ///< Ganged press motors fitted, from M0 up.
+#endif
+#if MOTOR_AXIS_COUNT < 1 || MOTOR_AXIS_COUNT > MOTOR_AXIS_MAX
+#error "MOTOR_AXIS_COUNT must be 1 to MOTOR_AXIS_MAX"
+#endif
+#define MOTOR_A                         ConnectorM0 ///< Primary press motor (reference axis).
 #define MOTOR_B                         ConnectorM1 ///< Secondary, ganged press motor.
+#define MOTOR_C                         ConnectorM2 ///< Third ganged press motor (MOTOR_AXIS_COUNT >= 3).
+#define MOTOR_D                         ConnectorM3 ///< Fourth ganged press motor (MOTOR_AXIS_COUNT = 4).
 
 // --- Home Sensors (Hall Effect) ---
 // Sensor PN: 326161-0053
 #define HOME_SENSOR_M0                  ConnectorDI7 ///< Motor A (M0) home sensor on DI7.
 #define HOME_SENSOR_M1                  ConnectorDI6 ///< Motor B (M1) home sensor on DI6.
+#define HOME_SENSOR_M2                  ConnectorDI8 ///< Motor C (M2) home sensor on DI8.
+#define HOME_SENSOR_M3                  ConnectorA9  ///< Motor D (M3) home sensor on A9 (digital input mode).
 #define HOME_SENSOR_ACTIVE_STATE        true         ///< true = sensor outputs HIGH when triggered (active high).
 #define HOME_SENSOR_FILTER_MS           2            ///< Debounce filter length in milliseconds for home sensors.
-/** @} */
-
-//==================================================================================================
-// Sensor & Control Parameters
-//==================================================================================================
-/**
- * @name Sensor and Control Loop Parameters
- * @{
- */
-#define EWMA_ALPHA_TORQUE               0.2f      ///< Smoothing factor (alpha) for the EWMA filter on motor torque readings.
+#define HOME_SENSOR_LATCH_ENABLED       1            ///< 1 = latch the step position in the home sensor edge interrupts for the touch-off.
 /** @} */
 
 //==================================================================================================
@@ -107,8 +166,6 @@
 #define TORQUE_HLFB_AT_POSITION		-9999.0f  ///< Special value from ClearCore HLFB when a move is complete and the motor is at position.
 #define MOTOR_DEFAULT_VEL_MAX_MMS           156.25f   ///< Default maximum velocity for motors in mm/s.
 #define MOTOR_DEFAULT_ACCEL_MAX_MMSS        625.0f    ///< Default maximum acceleration for motors in mm/s^2.
-#define MOTOR_DEFAULT_VEL_MAX_SPS           (int)(MOTOR_DEFAULT_VEL_MAX_MMS * STEPS_PER_MM) ///< Default max velocity in steps/sec, derived from mm/s.
-#define MOTOR_DEFAULT_ACCEL_MAX_SPS2        (int)(MOTOR_DEFAULT_ACCEL_MAX_MMSS * STEPS_PER_MM) ///< Default max acceleration in steps/sec^2, derived from mm/s^2.
 /** @} */
 
 /**
@@ -133,11 +190,23 @@
 #define HOMING_STROKE_MM           500.0f    ///< Maximum travel distance (mm) during a homing sequence.
 #define HOMING_RAPID_VEL_MMS       5.0f      ///< Velocity (mm/s) for the initial high-speed search for the hard stop.
 #define HOMING_TOUCH_VEL_MMS       1.0f      ///< Velocity (mm/s) for the final, slow-speed precise touch-off.
+#define HOMING_LATCHED_TOUCH_VEL_MMS 5.0f    ///< Touch-off velocity (mm/s) when the sensor edge is latched by interrupt.
 #define HOMING_BACKOFF_VEL_MMS     1.0f      ///< Velocity (mm/s) for backing off the hard stop.
 #define HOMING_ACCEL_MMSS          100.0f    ///< Acceleration (mm/s^2) for all homing moves.
-#define HOMING_SEARCH_TORQUE_PERCENT 10.0f   ///< Torque limit (%) used to detect the hard stop.
+#define HOMING_SEARCH_TORQUE_PERCENT 10.0f   ///< Torque rise (%) over the cruise load that stops a hybrid homing approach at a hard stop.
 #define HOMING_BACKOFF_TORQUE_PERCENT 40.0f  ///< Higher torque limit (%) for the back-off move to prevent stalling.
 #define HOMING_BACKOFF_MM          1.0f      ///< Distance (mm) to back off from the hard stop.
+#define HOMING_PARALLEL_DEFAULT    1         ///< 1 = plain "home" runs each axis through its phases independently; 0 = lockstep gantry sequence.
+#define HOMING_VERIFY_VEL_MMS      10.0f     ///< Velocity (mm/s) for the positional approach when re-homing onto a trusted home.
+#define HOMING_VERIFY_MARGIN_MM    0.5f      ///< The trusted approach stops this far short of the last sensor trigger, then touches.
+#define HOMING_VERIFY_TOLERANCE_MM 0.25f     ///< A touch within this distance of the last trigger counts as verified.
+#define HOMING_HYBRID_VEL_MMS      40.0f     ///< Velocity (mm/s) of the "home hybrid" approach to the learned trigger point.
+#define HOMING_HYBRID_ACCEL_MMSS   250.0f    ///< Acceleration (mm/s^2) of the hybrid approach.
+#define HOMING_HYBRID_SLOW_MM      3.0f      ///< The hybrid approach hands over to the normal sequence this far short of the learned trigger point.
+#define HOMING_HYBRID_SETTLE_MS    20        ///< Cruise time (ms) before the hybrid approach takes its torque baseline.
+#define HOMING_RESTORE_ENABLED     1         ///< 1 = keep a trusted home in no-init RAM, so the first home after a reset is the verify touch.
+#define HOMING_RESTORE_MAGIC       0x484F4D45 ///< Marks a sealed home record ("HOME"); anything else is power-up garbage.
+#define HOMING_BOOT_ENABLE_TIMEOUT_MS 2000   ///< Home-on-boot waits this long (ms from setup) for both motors to report enabled before trying anyway.
 /** @} */
 
 /**
@@ -147,8 +216,322 @@
 #define MOVE_DEFAULT_TORQUE_PERCENT         30        ///< Default torque limit (%) for moves.
 #define MOVE_DEFAULT_VELOCITY_MMS           6.25f     ///< Default velocity (mm/s) for moves.
 #define MOVE_DEFAULT_ACCEL_MMSS             62.5f     ///< Default acceleration (mm/s^2) for moves.
-#define MOVE_DEFAULT_VELOCITY_SPS           (int)(MOVE_DEFAULT_VELOCITY_MMS * STEPS_PER_MM) ///< Default velocity in steps/sec.
-#define MOVE_DEFAULT_ACCEL_SPS2             (int)(MOVE_DEFAULT_ACCEL_MMSS * STEPS_PER_MM)   ///< Default acceleration in steps/sec^2.
+#define MOVE_SPEED_MAX_MMS                  100.0f    ///< Speed ceiling of every move except a rapid traverse.
+#define RAPID_VEL_MAX_MMS                   156       ///< Fastest accepted rapid traverse (whole mm/s, within MOTOR_DEFAULT_VEL_MAX_MMS).
+#define RAPID_ACCEL_MAX_MMSS                625       ///< Highest accepted rapid traverse acceleration (MOTOR_DEFAULT_ACCEL_MAX_MMSS).
+#define RAPID_ACCEL_DEFAULT_MMSS            250       ///< set_rapid_traverse acceleration when none is given.
+#define RAPID_ACCEL_UNIT_MMSS               5         ///< Resolution the rapid acceleration is stored at (one settings byte).
+#define RAPID_FORCE_GATE_KG                 2.0f      ///< A stroke runs as a rapid traverse only if the selected load cell reads below this; a rapid retract stops above it.
+#define MOTION_QUEUE_SIZE                   16        ///< Maximum segments held by the queue_move/queue_run motion queue.
+#define MOTION_BLEND_ENABLED                true      ///< Blend same-direction queued segments without stopping at the boundary.
+#define MOTION_BLEND_LOOKAHEAD_MS           10        ///< Extra travel time added to the stopping distance when deciding to blend.
+#define MOVE_CACHE_SIZE                     8         ///< Recent move_abs argument sets kept checked and compiled for reuse (0 disables the cache).
+#define RECIPE_MAX_STEPS                    12        ///< Steps in the stored recipe (12 bytes each in NVM).
+#define RECIPE_NAME_LENGTH                  12        ///< Recipe name buffer, including the terminator.
+#define RECIPE_ENVELOPE_MAX_BANDS           64        ///< Position bins of the recipe's force envelope (RAM only, 8 bytes each).
+#define RECIPE_ENVELOPE_STEP_MIN_MM         0.05f     ///< Narrowest accepted envelope bin.
+#define RECIPE_ZONE_MAX                     8         ///< Position bands of the recipe's speed/torque/force map (RAM only, 20 bytes each).
+#define MOTION_SCURVE_JERK_DEFAULT_MMSS3    2500.0f   ///< set_motion_profile scurve default jerk (25 ms jerk ramps at the default accel).
+#define MOTION_SCURVE_JERK_MIN_MMSS3        100.0f    ///< Smallest accepted jerk limit.
+#define MOTION_SCURVE_JERK_MAX_MMSS3        100000.0f ///< Largest accepted jerk limit.
+#define MOTION_SCURVE_MIN_MMS               0.05f     ///< Floor on the streamed velocity so the step generators never idle mid-profile.
+#define MOTION_SCURVE_SETTLE_MMS            2.0f      ///< Speed of the final positional correction onto the target.
+#define MOTION_SCURVE_TRACK_ACCEL_FACTOR    2.0f      ///< Step generator accel limit while streaming, relative to the profile accel.
+#define ADAPTIVE_APPROACH_MARGIN_MM_DEFAULT 2.0f      ///< recipe_learn default: switch to press speed this far short of the learned contact.
+#define ADAPTIVE_APPROACH_RAPID_MMS_DEFAULT 25.0f     ///< recipe_learn default: approach speed up to the switch point.
+#define ADAPTIVE_APPROACH_ALPHA             0.25f     ///< Weight of each new contact in the running estimate (earlier contacts are adopted outright).
+/** @} */
+
+/**
+ * @name Force Regulation
+ * @brief PI loop run from the control tick for moves with force_action "regulate" (load_cell mode only).
+ * @{
+ */
+#define FORCE_REGULATE_KP_MMS_PER_KG        0.05f     ///< Proportional gain: commanded speed (mm/s) per kg of force error.
+#define FORCE_REGULATE_KI_MMS_PER_KGS       0.2f      ///< Integral gain: mm/s per kg*s of accumulated force error.
+#define FORCE_REGULATE_MAX_DT_S             0.05f     ///< Longest sample gap integrated in one step (covers dropped frames).
+#define FORCE_REGULATE_TOLERANCE_KG         0.5f      ///< Absolute band around the target that counts as settled.
+#define FORCE_REGULATE_TOLERANCE_PCT        2.0f      ///< Relative band (% of target); the larger of the two bands is used.
+#define FORCE_REGULATE_OVERFORCE_FACTOR     1.5f      ///< Stop with an error if force overshoots the target by this factor.
+#define FORCE_REGULATE_DWELL_MS_DEFAULT     1000      ///< Time (ms) to hold the target force when no dwell is given.
+#define FORCE_REGULATE_SETTLE_TIMEOUT_MS    10000     ///< Error if the force has not settled this long after contact.
+/** @} */
+
+/**
+ * @name Press Capture
+ * @brief Per-sample force-displacement buffer pulled with dump_capture.
+ * @{
+ */
+#define PRESS_CAPTURE_MAX_SAMPLES           4096      ///< Samples kept per press.
+#define PRESS_CAPTURE_BUFFER_BYTES          24576     ///< Size of the delta-encoded record stream (typically 4-6 bytes per sample).
+#define PRESS_CAPTURE_KEYFRAME_INTERVAL     32        ///< Samples per keyframe block; every block starts with absolute values.
+#define PRESS_CAPTURE_LINE_BYTES            720       ///< Encoded bytes per dump_capture DATA line before base64 (960 characters).
+#define PRESS_CAPTURE_TX_RESERVE            8         ///< Bulk-lane TX slots left free for other dumps while streaming a capture.
+#define PRESS_CAPTURE_PRETRIGGER_SAMPLES    256       ///< Approach samples kept before the press threshold is crossed (0 = record the whole approach).
+#define PRESS_CAPTURE_COARSE_MM             0.5f      ///< Free approach samples are only kept this far apart (0 = keep every sample).
+#define PRESS_CAPTURE_DETAIL_FRACTION       0.25f     ///< Full rate from this fraction of the press threshold on, ahead of the trigger.
+#define PRESS_CAPTURE_DETAIL_SLOPE_KG_MM    1.0f      ///< Full rate once force rises this fast against travel over one coarse step.
+/** @} */
+
+/**
+ * @name Position Curve
+ * @brief Force on a fixed position grid, timestamped by the control tick and pulled with dump_curve.
+ * @{
+ */
+#define POSITION_CURVE_ENABLED              1         ///< 0 = no position grid; dump_capture still has the per-sample curve.
+#define POSITION_CURVE_STEP_MM              0.01f     ///< Grid interval, counted from machine home (at least one step).
+#define POSITION_CURVE_MAX_POINTS           4096      ///< Points kept per press (2 bytes each: 40.96 mm at 0.01 mm).
+#define POSITION_CURVE_PRETRIGGER_POINTS    200       ///< Approach points kept before the press threshold is crossed (0 = from the start of the move).
+#define POSITION_CURVE_RING_SIZE            256       ///< Grid crossings waiting for the sample after them (power of 2; 2.56 mm at 0.01 mm, ~60 mm/s at 40 ms latency).
+#define POSITION_CURVE_LINE_POINTS          360       ///< Points per dump_curve DATA line (960 base64 characters).
+#define POSITION_CURVE_CLOSE_MS             250       ///< After the press, wait this long at most for the samples acquired after the last crossings.
+#define POSITION_CURVE_SAMPLE_HISTORY       8         ///< Recent force samples kept, so a crossing the tick queues after a later sample (torque samples have no latency) still finds the pair around it.
+/** @} */
+
+/**
+ * @name Press Metrics
+ * @brief Per-press figures reported in the DONE event of a load-cell move.
+ * @{
+ */
+#define PRESS_METRICS_STIFFNESS_WINDOW      32        ///< Force/position samples in the least-squares stiffness window.
+/** @} */
+
+/**
+ * @name Seat Detection
+ * @brief force_action "seat": stop when the force/position slope jumps (load_cell mode).
+ * @{
+ */
+#define SEAT_DETECT_WINDOW                  16        ///< Samples in the streaming least-squares slope window.
+#define SEAT_STIFFNESS_RATIO                3.0f      ///< Seated once the slope reaches this multiple of the baseline.
+#define SEAT_BASELINE_ALPHA                 0.05f     ///< Smoothing of the running baseline slope (per sample).
+#define SEAT_MIN_STIFFNESS_KG_MM            5.0f      ///< Floor under the baseline so contact noise cannot trigger (kg/mm).
+/** @} */
+
+/**
+ * @name Debug Records
+ * @brief Binary diagnostic records turned on with set_debug and sent as DEBUG DATA lines.
+ * @{
+ */
+#define DEBUG_LOG_ENABLED                   1         ///< 0 compiles every debug record call site out.
+#define DEBUG_LOG_RECORDS                   256       ///< Records buffered between TX drains.
+#define DEBUG_LOG_RECORDS_PER_LINE          24        ///< Records per DATA line (672 bytes, 896 base64 characters).
+#define DEBUG_LOG_TX_RESERVE                8         ///< Bulk-lane TX slots left free for other dumps while draining.
+/** @} */
+
+/**
+ * @name Trace Log
+ * @brief Always-on binary event trace ring, read with dump_trace (see trace_log.h).
+ * @{
+ */
+#define TRACE_LOG_ENABLED                   1         ///< 0 compiles every TRACE() call site out.
+#define TRACE_LOG_RECORDS                   256       ///< Records kept (power of 2, 12 bytes each).
+#define TRACE_LOG_RECORDS_PER_LINE          16        ///< Records per TRACE DATA line (192 bytes, 256 base64 characters).
+/** @} */
+
+/**
+ * @name Error Log
+ * @brief Levels of the text diagnostic log read with dump_error_log (see error_log.h).
+ * @{
+ */
+#define ERROR_LOG_MIN_LEVEL                 LOG_INFO  ///< Lowest level compiled in; ERROR_LOG()/ERROR_LOGF() calls below it are removed with their arguments.
+#define ERROR_LOG_DEFAULT_LEVEL             LOG_INFO  ///< Runtime filter after boot (set_log_level), at or above ERROR_LOG_MIN_LEVEL.
+/** @} */
+
+/**
+ * @name SD Card Log
+ * @brief Error and heartbeat log lines appended to a raw block ring on the micro SD card (see sd_log.h).
+ * @{
+ */
+#define SD_LOG_ENABLED                      1         ///< 0 keeps the logs in RAM only.
+#define SD_LOG_BLOCK_SIZE                   512       ///< Card block size; one write per block.
+#define SD_LOG_START_BLOCK                  0         ///< First card block of the log ring (the card is used raw, not as a filesystem).
+#define SD_LOG_BLOCK_COUNT                  1048576   ///< Blocks in the log ring (512 MB, months of shifts).
+#define SD_LOG_MAGIC                        0x474C4250 ///< "PBLG" at the start of every log block.
+#define SD_LOG_FLUSH_MS                     5000      ///< A partly filled block is written (and later rewritten) at least this often.
+#define SD_LOG_FLUSH_LEVEL                  LOG_WARNING ///< Entries at or above this level are written on the next pass.
+#define SD_LOG_SLICE_BYTES                  64        ///< Block bytes clocked per step, so one step stays well under the task budget.
+#define SD_LOG_INIT_SPI_HZ                  400000    ///< SPI clock during card init.
+#define SD_LOG_SPI_HZ                       5000000   ///< SPI clock once initialized (SERCOM4 tops out at 5 MHz).
+#define SD_LOG_INIT_ATTEMPTS                10        ///< CMD0 attempts before the slot is treated as empty.
+#define SD_LOG_INIT_TIMEOUT_MS              1000      ///< Time allowed for ACMD41 to bring the card out of idle.
+#define SD_LOG_IO_TIMEOUT_MS                500       ///< Time allowed for a read token or a block write to finish.
+#define SD_LOG_RETRY_MS                     5000      ///< Wait before retrying init after no card or a failure.
+#define LOOP_TASK_SD_LOG_BUDGET_US          300       ///< Budget of the SD card task per pass.
+/** @} */
+
+/**
+ * @name Loop Profiler
+ * @brief Per-stage timing of the main loop, reported by dump_perf (see loop_profiler.h).
+ * @{
+ */
+#define LOOP_PROFILER_ENABLED               1         ///< 0 compiles the stage marks in loop() out.
+#define LOOP_PROFILER_BUCKETS               16        ///< log2 microsecond histogram buckets (the last one is >= 16.4 ms).
+/** @} */
+
+/**
+ * @name Memory Map
+ * @brief SRAM layout and stack high-water mark, reported by dump_mem (see memory_map.h).
+ * @{
+ */
+#define MEMORY_STACK_PAINT                  0xA5A5A5A5u ///< Word painted over the free stack at boot; the deepest overwritten word is the high-water mark.
+#define MEMORY_STACK_PAINT_MARGIN_BYTES     64        ///< Bytes below the stack pointer left unpainted (setup()'s own frame).
+#define MEMORY_HEAP_HEADROOM_BYTES          2048      ///< Bytes above the boot-time heap top left unpainted for later malloc (newlib's printf).
+#ifndef MEMORY_STACK_TASK_PEAKS
+#define MEMORY_STACK_TASK_PEAKS             1         ///< 1 measures each loop task's stack depth after it runs (dump_perf); 0 compiles it out.
+#endif
+#define MEMORY_STACK_GAP_BYTES              256       ///< Unbroken paint a task-depth scan must see before it stops (buffers a task declared but never wrote).
+/** @} */
+
+/**
+ * @name Benchmark Build
+ * @brief Cycle-timed hot-path suite appended to dump_perf (see benchmark.h). The Benchmark
+ * configuration of pressboi.cppproj defines PRESSBOI_BENCHMARK=1; Debug and Release leave it out.
+ * @{
+ */
+#ifndef PRESSBOI_BENCHMARK
+#define PRESSBOI_BENCHMARK                  0         ///< 1 compiles the benchmark suite in.
+#endif
+#define BENCHMARK_CALLS                     256       ///< Timed calls per function; the suite stays well inside WATCHDOG_TIMEOUT_MS.
+#define BENCHMARK_TX_CALLS                  8         ///< Timed enqueueTx + TX pass calls (each sends one short line to the GUI).
+/** @} */
+
+/**
+ * @name DSP Kernels
+ * @brief Block sums of the window estimators (see dsp_kernels.h).
+ * @{
+ */
+#ifndef PRESSBOI_DSP
+#if defined(PRESSBOI_HOST)
+#define PRESSBOI_DSP                        0         ///< Host builds have no CMSIS-DSP library.
+#else
+#define PRESSBOI_DSP                        1         ///< 1 runs the block sums on CMSIS-DSP (arm_cortexM4lf_math); 0 on scalar loops.
+#endif
+#endif
+/** @} */
+
+/**
+ * @name HIL Test Mode
+ * @brief Latency marker outputs for hardware-in-the-loop testing (see hil_test.h).
+ * @{
+ */
+#ifndef HIL_TEST_ENABLED
+#define HIL_TEST_ENABLED                    0         ///< 1 toggles the marker pins below; 0 compiles every HIL_MARK() call site out.
+#endif
+#define HIL_PIN_FORCE_CROSS                 ConnectorIO0 ///< Toggles when a force sample crosses the active force limit.
+#define HIL_PIN_STOP                        ConnectorIO1 ///< Toggles when the stop is issued to both motors (abortMove() or the receive-ISR trip).
+/** @} */
+
+/**
+ * @name Cycle I/O
+ * @brief Hardware cycle start of the stored recipe and its result outputs (see cycle_io.h).
+ * Keep the connectors clear of the home sensors and the HIL marker pins.
+ * @{
+ */
+#ifndef CYCLE_IO_ENABLED
+#define CYCLE_IO_ENABLED                    0         ///< 1 lets CYCLE_START_INPUT run the stored recipe; 0 compiles the cycle I/O out.
+#endif
+#define CYCLE_START_INPUT                   ConnectorA10 ///< Cycle start input (any DI, A-9..A-12 or IO point with an edge interrupt).
+#define CYCLE_START_ACTIVE_STATE            1         ///< Input state that requests a cycle (1 = high, 0 = low).
+#define CYCLE_START_FILTER_MS               2         ///< Debounce filter; the latched edge time is ahead of it.
+#define CYCLE_OUT_BUSY                      ConnectorIO2 ///< On while a started cycle runs.
+#define CYCLE_OUT_PASS                      ConnectorIO3 ///< On after a cycle that ran the recipe to its DONE.
+#define CYCLE_OUT_FAIL                      ConnectorIO4 ///< On after a cycle that ended on an error, or a start the press refused.
+/** @} */
+
+/**
+ * @name Station I/O
+ * @brief Fixture sensors on CCIO-8 expansion boards and the recipe interlock (see station_io.h).
+ * @{
+ */
+#ifndef STATION_IO_ENABLED
+#define STATION_IO_ENABLED                  0         ///< 1 reads the fixture sensors from a CCIO-8 chain on STATION_IO_PORT; 0 compiles the station I/O out.
+#endif
+#define STATION_IO_PORT                     ConnectorCOM1 ///< Port of the CCIO-8 chain (COM-1: load cell B is not set up with station I/O enabled).
+#define STATION_IO_MAX_BOARDS               3         ///< CCIO-8 boards read (8 inputs each, at most 3 so station_inputs stays positive).
+#define STATION_IO_INTERLOCK_MASK           0x07      ///< Inputs a recipe run needs (bit n = chain pin n), e.g. part present, clamp closed, guard closed.
+#define STATION_IO_INTERLOCK_STATE          0x07      ///< Required state of the STATION_IO_INTERLOCK_MASK inputs (1 = on).
+/** @} */
+
+/**
+ * @name Force Replay
+ * @brief Feeds load cell A from a stored force-versus-position profile instead of COM-0 (see force_replay.h).
+ * @{
+ */
+#ifndef FORCE_REPLAY_ENABLED
+#define FORCE_REPLAY_ENABLED                HIL_TEST_ENABLED ///< 1 compiles the force_replay command and the injection path in.
+#endif
+#define FORCE_REPLAY_MAX_POINTS             512       ///< Profile points kept (8 bytes each).
+#define FORCE_REPLAY_RATE_HZ                80        ///< Injected sample rate, as the HX711 at RATE=5V.
+/** @} */
+
+/**
+ * @name Diagnostic Dumps
+ * @brief dump_nvm and dump_error_log run in the background from the logging task.
+ * @{
+ */
+#define DUMP_LINES_PER_PASS                 4         ///< Most dump lines queued per loop pass.
+#define DUMP_TX_RESERVE                     8         ///< Bulk-lane TX slots left free for other output while dumping.
+#define LOG_DUMP_ERRORS_PER_LINE            3         ///< Error entries per LOGDUMP ERR line (at most 255 bytes, 340 base64 characters).
+#define LOG_DUMP_RUNS_PER_LINE              20        ///< Heartbeat runs per LOGDUMP HB line (240 bytes, 320 base64 characters).
+/** @} */
+
+/**
+ * @name Loop Scheduler
+ * @brief Priorities and time budgets of the main-loop tasks (see loop_scheduler.h).
+ * @{
+ */
+#define LOOP_SCHEDULER_MAX_TASKS            14        ///< Tasks that can be registered.
+#define LOOP_SCHEDULER_PASS_BUDGET_US       3000      ///< Non-critical tasks whose budget would end past this point in a pass wait for the next pass.
+#define LOOP_SCHEDULER_MAX_DEFERRALS        8         ///< Passes in a row a task can be deferred before it runs regardless.
+#define LOOP_TASK_COMMS_BUDGET_US           500       ///< Budget of the UDP/USB/TCP receive poll.
+#define LOOP_TASK_TX_BUDGET_US              1000      ///< TX draining stops sending once this much time has gone (at least one message per run).
+#define LOOP_TASK_TELEMETRY_BUDGET_US       500       ///< Budget of one telemetry publish.
+#define LOOP_TASK_LOGGING_BUDGET_US         500       ///< Budget of the capture dump and debug log drain.
+#define LOOP_TASK_IDLE_BUDGET_US            1000      ///< Budget of the idle-work task; it only starts in a pass with this much left.
+#define IDLE_WORK_QUEUE_SIZE                8         ///< Jobs the idle-work queue holds (see idle_work.h).
+#define LOOP_SLOW_PASS_US                   20000     ///< Soft deadline: longer passes are counted in slow_loops, well before WATCHDOG_TIMEOUT_MS resets.
+#define LOOP_SLOW_PASS_LOG_MS               10000     ///< At most one slow-pass warning in the error log per this interval.
+/** @} */
+
+/**
+ * @name Encoder Feedback
+ * @brief Optional quadrature encoder (ClearCore EncoderIn) compared against the commanded position every control tick.
+ * @{
+ */
+#define ENCODER_FEEDBACK_AXIS               0         ///< Motor the encoder follows (0 = M0 .. 3 = M3); ClearCore has one encoder input.
+#if ENCODER_FEEDBACK_AXIS >= MOTOR_AXIS_COUNT
+#error "ENCODER_FEEDBACK_AXIS must be one of the fitted motors"
+#endif
+#define ENCODER_TOLERANCE_MM_DEFAULT        0.5f      ///< set_encoder default: largest allowed actual-vs-commanded difference.
+#define ENCODER_TOLERANCE_MM_MIN            0.05f     ///< Smallest accepted tolerance (must cover servo following lag).
+#define ENCODER_TOLERANCE_MM_MAX            20.0f     ///< Largest accepted tolerance.
+#define ENCODER_COUNTS_PER_MM_MAX           100000.0f ///< Largest accepted encoder resolution (counts/mm, either sign).
+/** @} */
+
+/**
+ * @name Gantry Racking Correction
+ * @brief Follower axes (M1 ..) compared with M0 every control tick during lockstep moves after homing.
+ * @{
+ */
+#define RACKING_CORRECTION_ENABLED          1         ///< 1 trims and supervises the followers against M0 (MOTOR_AXIS_COUNT > 1); 0 compiles it out.
+#define RACKING_TORQUE_DEADBAND_PCT         3.0f      ///< Load torque difference left untrimmed (HLFB noise, motor-to-motor spread).
+#define RACKING_TRIM_GAIN_MMS_PER_PCT       0.05f     ///< Follower speed trim per % of load torque difference beyond the deadband.
+#define RACKING_TRIM_MAX_MMS                1.0f      ///< Largest speed trim of a follower, either way.
+#define RACKING_TRIM_SLEW_MMS               0.02f     ///< Largest change of a follower's trim per control tick.
+#define RACKING_TRIM_LEAD_MAX_MM            0.2f      ///< Commanded lead (or lag) on M0 at which a follower's trim stops growing.
+#define RACKING_FAULT_TORQUE_PCT            25.0f     ///< Load torque difference that faults once it lasts RACKING_FAULT_MS.
+#define RACKING_FAULT_MS                    50        ///< How long the torque difference must last to fault.
+#define RACKING_FAULT_MM                    1.0f      ///< Commanded position difference from the homed square that faults at once (> RACKING_TRIM_LEAD_MAX_MM).
+/** @} */
+
+/**
+ * @name Torque Friction Model
+ * @brief Speed-dependent friction torque removed from HLFB torque before it is read as force (motor_torque mode).
+ * @{
+ */
+#define TORQUE_FRICTION_MAX_POINTS          4         ///< Points in the set_torque_friction table (one NVM slot each).
+#define TORQUE_FRICTION_PCT_MAX             50.0f     ///< Largest accepted friction torque at any point (%, either sign).
+#define TORQUE_FRICTION_SPS_MAX             65535     ///< Largest table step rate (stored as 16 bits; 409 mm/s at 160 steps/mm).
 /** @} */
 
 /**
@@ -165,14 +548,109 @@
 #define MACHINE_STRAIN_COEFF_X2            -1585.3214f     ///< x^2 coefficient
 #define MACHINE_STRAIN_COEFF_X1             320.1528f      ///< x coefficient
 #define MACHINE_STRAIN_COEFF_C              -0.2376f       ///< Constant term
-#define MACHINE_STRAIN_MAX_DEFLECTION_MM     5.0f          ///< Max expected machine flex deflection used for inverse lookup (can expand to 4x this)
+#define MACHINE_STRAIN_MAX_DEFLECTION_MM     5.0f          ///< Max expected machine flex deflection used for inverse lookup
+#define MACHINE_STRAIN_TABLE_SIZE            256           ///< Entries in the force-to-deflection lookup table (evenly spaced in force)
+#define MACHINE_STRAIN_SCAN_STEPS            512           ///< Samples over 0..MACHINE_STRAIN_MAX_DEFLECTION_MM used to find where the fit stops rising
 #define MACHINE_STRAIN_CONTACT_FORCE_KG      3.0f          ///< Force threshold to declare contact and start flex compensation
+#define MACHINE_STRAIN_FIT_MIN_SAMPLES       20            ///< fit_strain_cal: loading-stroke samples above the press threshold needed for a fit
+#define MACHINE_STRAIN_FIT_MIN_SPAN_MM       0.05f         ///< fit_strain_cal: deflection the loading stroke must span
 #define RETRACT_DEFAULT_SPEED_MMS           25.0f          ///< Default retract speed when none specified
 #define FORCE_SENSOR_MIN_KG                 -10.0f    ///< Minimum valid force reading (kg). Below this triggers an error.
 #define FORCE_SENSOR_MAX_KG                 1200.0f   ///< Maximum expected force (kg).
 #define FORCE_SENSOR_MAX_SAFETY_FACTOR      1.2f      ///< Safety factor for maximum force (1.2x = 20% over max).
 #define FORCE_SENSOR_MAX_LIMIT_KG           (FORCE_SENSOR_MAX_KG * FORCE_SENSOR_MAX_SAFETY_FACTOR) ///< Calculated max limit (1440 kg).
 #define FORCE_SENSOR_TIMEOUT_MS             1000      ///< Time (ms) without readings before sensor is considered disconnected.
+#define FORCE_SENSOR_SETTLE_MS              100       ///< Bytes received this long (ms) after the COM port opens are discarded as line noise.
+#define FORCE_SENSOR_FRAME_SYNC             0xA5      ///< Sync byte that starts a binary force frame (never valid ASCII, so both formats can share COM-0).
+#define FORCE_SENSOR_FRAME_LENGTH           6         ///< Binary frame size: sync, sequence, 24-bit sample (big-endian), CRC8.
+#define FORCE_SENSOR_FRAME_SYNC_DUAL        0xA6      ///< Sync byte for dual-channel frames (fast + transducer-filtered sample).
+#define FORCE_SENSOR_FRAME_LENGTH_DUAL      9         ///< Dual frame size: sync, sequence, fast 24-bit sample, filtered 24-bit sample, CRC8.
+#define FORCE_SENSOR_FRAME_CRC_POLY         0x07      ///< CRC-8 polynomial (x^8 + x^2 + x + 1) over sequence and sample bytes.
+#define FORCE_LINK_NEGOTIATE_ENABLED        true      ///< Ask the transducer what baud and sample rates it supports, run the fastest the cable sustains, and step down when frame errors rise.
+#define FORCE_LINK_FRAME_SYNC               0xA7      ///< Sync byte of a link-control frame (both directions; never valid ASCII).
+#define FORCE_LINK_FRAME_LENGTH             8         ///< Link-control frame size: sync, type, 5 parameter bytes, CRC8 (fits the dual-frame buffer).
+#define FORCE_LINK_REPLY_MS                 200       ///< Wait for a transducer reply before asking again.
+#define FORCE_LINK_ATTEMPTS                 3         ///< Unanswered queries before the transducer is taken as fixed-rate (or a switch as lost).
+#define FORCE_LINK_RETRY_MS                 10000     ///< Time before a fixed-rate transducer is queried again, in case it was swapped.
+#define FORCE_LINK_PROBATION_MS             2000      ///< Error-free run a new baud needs before it is kept and the next one tried.
+#define FORCE_LINK_KEEPALIVE_MS             1000      ///< Keepalive period while negotiated (the transducer's own revert timer is 3 s).
+#define FORCE_LINK_REVERT_MS                3000      ///< Transducer returns to 115200 baud after this long without a control frame (must match hx711_arduino.ino).
+#define FORCE_LINK_MAX_ERRORS               3         ///< CRC, UART and sequence errors in one FORCE_HEALTH_WINDOW_MS window that step the baud down.
+#define FORCE_SENSOR_RX_ISR_ENABLED         true      ///< Drain COM ports from the control tick interrupt so main-loop stalls cannot overflow the 64-byte SERCOM buffer.
+#define FORCE_SENSOR_RX_RING_SIZE           64        ///< Decoded samples buffered between ISR and main loop (power of 2, ~800 ms at 80 Hz).
+#define FORCE_SENSOR_FAST_TRIP_ENABLED      true      ///< Compare each decoded sample to the active force limit in the receive ISR and stop both motors immediately.
+#ifndef FORCE_TRIP_PREDICT_ENABLED
+#define FORCE_TRIP_PREDICT_ENABLED          false     ///< Trip early when force extrapolated over the sample latency and stopping time would pass the limit (stiff parts at high approach speed).
+#endif
+#define FORCE_TRIP_PREDICT_FRACTION         0.5f      ///< Prediction only runs once the measured force is past this fraction of the limit, so contact noise cannot trip.
+#define FORCE_TRIP_PREDICT_ALPHA            0.5f      ///< EWMA factor of the force-rate estimate (1.0 = last two samples only).
+#define FORCE_TRIP_PREDICT_MAX_LEAD_US      100000    ///< Longest extrapolation (latency + half the stopping time) the prediction uses.
+#define FORCE_FUSION_ENABLED                true      ///< Estimate force every control tick from HLFB torque, bias-corrected by each load-cell sample (force_fused).
+#define FORCE_FUSION_TRIP_ENABLED           false     ///< Load-cell limits also trip on the fused force, ahead of the next load-cell sample.
+#define FORCE_FUSION_TORQUE_ALPHA           0.3f      ///< EWMA factor of the torque the fusion uses (~3 ms at 1 kHz; the shared torque filter is ~20 ms).
+#define FORCE_FUSION_BIAS_ALPHA             0.2f      ///< Per load-cell sample factor of the torque-to-cell bias (the crossover: ~60 ms at 80 Hz).
+#define FORCE_FUSION_HISTORY                128       ///< Ticks of torque force kept to line up with delayed load-cell samples (power of 2, covers FORCE_LATENCY_US_MAX).
+#define FORCE_FUSION_MIN_SAMPLES            8         ///< Load-cell samples the bias needs in a move before the fused force may trip.
+#define FORCE_FUSION_TRIP_FRACTION          0.7f      ///< The last load-cell sample must be past this fraction of the limit for a fused trip.
+#define FORCE_SENSOR_MAX_CHANNELS           2         ///< Load-cell channels: 0 = COM-0 (A), 1 = COM-1 (B).
+#define FORCE_SENSOR_FIXED_POINT            true      ///< Calibrate in integer micrograms (int64) instead of float; limits always compare in raw counts.
+#define FORCE_HEALTH_WINDOW_MS              1000      ///< Window the load-cell sample rate and inter-arrival jitter are measured over.
+#define FORCE_HEALTH_MIN_RATE_HZ            40.0f     ///< A connected load cell sampling slower than this is logged as degraded (the transducer runs at 80 Hz).
+#define FORCE_HEALTH_STUCK_SAMPLES          40        ///< Identical raw samples in a row before the reading counts as stuck (HX711 noise never repeats this long).
+#define FORCE_ZERO_TRACK_ENABLED            true      ///< Trim load-cell zero drift in RAM while the press sits retracted and idle (no NVM writes).
+#define FORCE_ZERO_TRACK_SETTLE_MS          2000      ///< Time retracted and idle before samples count, so the cell has unloaded after a cycle.
+#define FORCE_ZERO_TRACK_SAMPLES            80        ///< Filtered-channel samples averaged per correction (1 s at 80 Hz).
+#define FORCE_ZERO_TRACK_WINDOW_KG          2.0f      ///< An average further from zero than this is a real load, not drift, and is ignored.
+#define FORCE_ZERO_TRACK_SPREAD_KG          0.5f      ///< A batch whose samples span more than this is disturbed (hand on the tooling) and is ignored.
+#define FORCE_ZERO_TRACK_GAIN               0.25f     ///< Fraction of each batch's average corrected, so a single batch never jumps the zero.
+#define FORCE_ZERO_TRACK_LIMIT_KG           5.0f      ///< Largest trim on top of the stored offset; past it the cell needs set_force_zero.
+#define FORCE_ZERO_TRACK_RETRACT_TOL_MM     1.0f      ///< Distance below the retract position (or home) that still counts as retracted.
+#define FORCE_TABLE_MAX_POINTS              16        ///< Maximum points in the load-cell linearization table.
+#define FORCE_FILTER_MEDIAN_DEFAULT         1         ///< Default median window on the limit path (1 = off, 3 or 5 rejects single/double-sample spikes).
+#define FORCE_FILTER_MEDIAN_MAX             5         ///< Largest supported median window.
+#define FORCE_FILTER_ALPHA_DEFAULT          1.0f      ///< Default IIR factor: y += alpha * (x - y). 1.0 = off.
+#define FORCE_FILTER_ALPHA_MIN              0.01f     ///< Smallest accepted IIR factor.
+#define FORCE_LATENCY_US_DEFAULT            8000      ///< Default delay from force acquisition to sample arrival (half an 80 SPS conversion + frame + drain).
+#define FORCE_LATENCY_US_MAX                100000    ///< Largest accepted force latency (must fit in the position history).
+#define FORCE_POSITION_HISTORY_SIZE         128       ///< Commanded-position history entries used to align force samples (power of 2).
+#define FORCE_POSITION_HISTORY_MIN_US       1000      ///< Minimum spacing between history entries, so the history spans >= 128 ms.
+/** @} */
+
+/**
+ * @name Control Tick
+ * @brief Fixed-rate timer interrupt for the time-critical path (see control_tick.h).
+ * @{
+ */
+#define CONTROL_TICK_HZ                     1000      ///< Tick rate (Hz). 115200 baud fills the SERCOM buffer in ~5.5 ms.
+#define CONTROL_TICK_IRQ_PRIORITY           4         ///< NVIC priority (below SERCOM RX at 1, below ClearCore SysTick at 3).
+#define CONTROL_TICK_MAX_HOOKS              4         ///< Hooks that can be registered (two load cells, or load cell A and the station I/O, + motor controller + spare).
+#define CONTROL_TICK_TORQUE_ALPHA           0.05f     ///< EWMA factor for HLFB torque, advanced once per tick (~20 ms time constant at 1 kHz).
+#define HLFB_CARRIER                        MotorDriver::HLFB_CARRIER_482_HZ ///< HLFB carrier; must match the drives' HLFB output setting in MSP. 482 Hz is ClearCore's fastest.
+#define HLFB_HIGH_RATE_ENABLED              true      ///< Advance the torque filters once per new HLFB measurement (~2.1 ms at 482 Hz) instead of once per tick.
+#define HLFB_REPEAT_TICKS                   3         ///< Ticks of an unchanged HlfbPercent() taken as a repeated measurement (the 482 Hz period is ~2.1 ticks).
+#define HLFB_TORQUE_ALPHA                   0.3f      ///< Per-measurement EWMA factor for HLFB torque (~6 ms at 482 Hz, vs ~20 ms per tick).
+#define HLFB_FUSION_TORQUE_ALPHA            0.6f      ///< Per-measurement factor of the fusion's fast torque filter (replaces FORCE_FUSION_TORQUE_ALPHA).
+#define TORQUE_JOULES_ENABLED               true      ///< Integrate press energy from the torque-derived force in motor_torque mode.
+#define TORQUE_JOULES_TICK_DIVIDER          4         ///< Control ticks per torque-force energy sample (250 Hz at 1 kHz).
+#define TORQUE_JOULES_RING_SIZE             64        ///< Torque-force samples buffered between loop passes (power of 2).
+/** @} */
+
+/**
+ * @name Motor Thermal Model
+ * @brief I2t estimate of each motor's winding heat from HLFB torque (see motor_thermal.h).
+ * Presses run at the full torque limit and speed; new presses wait only while the model
+ * is over its limit.
+ * @{
+ */
+#ifndef THERMAL_MODEL_ENABLED
+#define THERMAL_MODEL_ENABLED               1         ///< Estimate motor heating and hold new presses while a motor is over THERMAL_LIMIT_PCT.
+#endif
+#define THERMAL_CONTINUOUS_TORQUE_PCT       50.0f     ///< HLFB torque (% of peak) the motor can hold indefinitely (its continuous rating); 100% thermal load.
+#define THERMAL_TIME_CONSTANT_S             300.0f    ///< Motor thermal time constant (s) of the winding-to-ambient heat flow.
+#define THERMAL_UPDATE_TICKS                100       ///< Control ticks averaged per model step (10 Hz at 1 kHz).
+#define THERMAL_WARN_PCT                    90.0f     ///< Thermal load (%) that reports a warning, once per excursion.
+#define THERMAL_LIMIT_PCT                   100.0f    ///< Thermal load (%) above which new presses are refused; a running press finishes.
+#define THERMAL_RESUME_PCT                  85.0f     ///< Thermal load (%) the hottest motor must cool below before presses are accepted again.
 /** @} */
 
 /**
@@ -182,6 +660,9 @@
 #define WATCHDOG_ENABLED                    true      ///< Enable/disable watchdog timer. When enabled, system must call safety check regularly or motors will be disabled.
 #define WATCHDOG_TIMEOUT_MS                 256       ///< Watchdog timeout period in milliseconds. System will reset if not fed within this time.
 #define WATCHDOG_RECOVERY_FLAG              0xDEADBEEF ///< Magic number written to backup register to indicate watchdog recovery.
+#define WATCHDOG_SUPERVISOR_MAX_CLIENTS     16        ///< Tasks that can check in with the watchdog supervisor (every loop task plus the control tick).
+#define WATCHDOG_TASK_DEADLINE_MS           100       ///< A loop task that has not run for its period plus this long stops the watchdog being fed.
+#define WATCHDOG_TICK_DEADLINE_MS           20        ///< The control tick interrupt must check in at least this often.
 
 // Breadcrumb codes to identify where the watchdog timeout occurred
 #define WD_BREADCRUMB_SAFETY_CHECK          0x01      ///< Watchdog timeout in safety check
@@ -227,9 +708,138 @@
 #define WD_BREADCRUMB_SETUP_WD_INIT         0xF5      ///< Watchdog timeout in initializeWatchdog()
 #define WD_BREADCRUMB_SETUP_USB             0xF6      ///< Watchdog timeout in setupUsbSerial()
 #define WD_BREADCRUMB_SETUP_ETHERNET        0xF7      ///< Watchdog timeout in setupEthernet()
-#define WD_BREADCRUMB_SETUP_DHCP            0xF8      ///< Watchdog timeout in DHCP
-#define WD_BREADCRUMB_SETUP_LINK_WAIT       0xF9      ///< Watchdog timeout waiting for ethernet link
+#define WD_BREADCRUMB_SETUP_DHCP            0xF8      ///< Watchdog timeout in the background DHCP step
+#define WD_BREADCRUMB_SETUP_LINK_WAIT       0xF9      ///< Watchdog timeout polling for the ethernet link
 #define WD_BREADCRUMB_UNKNOWN               0xFF      ///< Watchdog timeout in unknown location
 /** @} */
+
+/**
+ * @name Crash Snapshot
+ * @brief State captured into no-init RAM on a watchdog early warning or HardFault (see crash_snapshot.h).
+ * @{
+ */
+#define CRASH_SNAPSHOT_ENABLED              1         ///< 0 keeps only the breadcrumb across a watchdog reset.
+#define CRASH_SNAPSHOT_MAGIC                0x43525348 ///< Marks a sealed snapshot ("CRSH"); anything else is power-up garbage.
+#define CRASH_SNAPSHOT_TRACE_RECORDS        32        ///< Newest trace records kept in the snapshot (12 bytes each).
+/** @} */
+/** @} */
+
+//==================================================================================================
+// Non-Volatile Memory Layout
+//==================================================================================================
+/**
+ * @name NVM Slot Assignments
+ * @brief 4-byte slots in the ClearCore user NVM area (byte offset = slot * 4).
+ * @details Slots 63-65 held the jerk limit and encoder feedback before the settings block;
+ * its migration still reads them there, and the drive geometry's check word tells the two apart.
+ * @{
+ */
+#define NVM_SLOT_SETTINGS                   0         ///< Settings block (PressSettings, see settings.h) up to slot 21
+#define NVM_SLOT_COUNT                      22        ///< Slots of the settings block, shown raw by dump_nvm
+#define NVM_SLOT_RECIPE                     22        ///< Recipe header (magic + step count), then name, steps and approach settings up to slot 62
+#define NVM_SLOT_DRIVE_PULSES_PER_REV       63        ///< Drive geometry: step pulses per revolution (see drive_geometry.h)
+#define NVM_SLOT_DRIVE_PITCH                64        ///< Drive geometry: pitch in mm per revolution (float bits)
+#define NVM_SLOT_DRIVE_CHECK                65        ///< Drive geometry check word; anything else means the config.h defaults
+#define NVM_SLOT_TORQUE_FRICTION_COUNT      66        ///< Friction table point count (0/-1 = no friction model)
+#define NVM_SLOT_TORQUE_FRICTION_POINTS     67        ///< First of TORQUE_FRICTION_MAX_POINTS slots: step rate (low 16 bits), torque in 0.01 % (high 16 bits), up to slot 70
+#define NVM_SLOT_FORCE_TABLE_COUNT          71        ///< Linearization point count (0/-1 = no table); table sits at the top of the user area
+#define NVM_SLOT_FORCE_TABLE_POINTS         72        ///< First of FORCE_TABLE_MAX_POINTS (raw, kg float bits) slot pairs, up to slot 103
+#define NVM_USER_AREA_BYTES                 416       ///< Bytes 0-415 (slots 0-103) of the user page; the rest is reserved by Teknic.
+#define NVM_IMAGE_MAGIC                     0x494D564E ///< Marks a backup_nvm image ("NVMI").
+#define NVM_IMAGE_FORMAT                    1         ///< backup_nvm image layout version.
+/** @} */
+
+/**
+ * @name Settings Block
+ * @{
+ */
+#define SETTINGS_MAGIC                      0x5053    ///< Marks a settings block ("PS").
+#define SETTINGS_VERSION                    3         ///< PressSettings layout version; a block from an older version loads with the new fields at their defaults.
+#define SETTINGS_COMMIT_DELAY_MS            500       ///< Quiet time after the last settings change before the block is written, so a burst of set commands is one flash write.
+#define LOOP_TASK_SETTINGS_PERIOD_US        50000     ///< How often the settings task checks for pending flash work to queue as idle work.
+#define MOTOR_TORQUE_SCALE_DEFAULT          0.0335f   ///< Default motor torque calibration: Torque% per kg.
+#define MOTOR_TORQUE_OFFSET_DEFAULT         1.04f     ///< Default motor torque calibration: Torque% at zero force.
+#define PRESS_THRESHOLD_KG_DEFAULT          2.0f      ///< Default press threshold (kg).
+/** @} */
+
+/**
+ * @name NVM Journal
+ * @{
+ */
+#define NVM_JOURNAL_ENABLED                 1         ///< 1 = retract, press threshold, force offsets and production counters go to the flash journal; 0 = settings block only (counters in RAM).
+#define NVM_JOURNAL_ADDR                    0x0007C000 ///< Start of the journal: the top 16 KB of flash bank B, excluded from FLASH in both linker scripts.
+#define NVM_JOURNAL_BLOCK_SIZE              8192      ///< Main flash erase block (SAME53: 16 pages of 512 bytes).
+#define NVM_JOURNAL_BLOCKS                  2         ///< Erase blocks the journal rotates through.
+/** @} */
+
+/**
+ * @name Production Counters
+ * @brief Lifetime cycle, travel, energy, trip and peak-force counts (see production_counters.h).
+ * @{
+ */
+#define PRODUCTION_CHECKPOINT_CYCLES        20        ///< Cycles between journal checkpoints; a power loss forgets at most this many (minus one).
+#define PRODUCTION_PEAK_BUCKETS             8         ///< Peak-force histogram buckets; the last one is open-ended.
+#define PRODUCTION_PEAK_BUCKET_KG           125.0f    ///< Width of each peak-force bucket (kg).
+/** @} */
+
+/**
+ * @name Calibration Profiles
+ * @{
+ */
+#define PROFILE_FLASH_ADDR                  0x0007A000 ///< Erase block holding the profiles, just below the NVM journal; excluded from FLASH in both linker scripts.
+#define PROFILE_MAX_COUNT                   8         ///< Named calibration profiles stored.
+#define PROFILE_NAME_LENGTH                 16        ///< Profile name buffer (15 characters + NUL).
+#define PROFILE_MAGIC                       0x50524F46 ///< Marks a valid profile image ("PROF").
+/** @} */
+
+/**
+ * @name Network Firmware Update
+ * @brief Image streamed over TCP into flash bank B, then copied over the application (see fw_update.h).
+ * @{
+ */
+#ifndef FW_UPDATE_ENABLED
+#define FW_UPDATE_ENABLED                   1         ///< 1 compiles the fw_update command and its TCP listener in.
+#endif
+#define FW_UPDATE_PORT                      8890      ///< TCP port the image is streamed to after fw_update begin.
+#define FW_UPDATE_STAGING_ADDR              0x00040000 ///< Start of the staging area: flash bank B up to the calibration profiles.
+#define FW_UPDATE_MAX_BYTES                 (PROFILE_FLASH_ADDR - FW_UPDATE_STAGING_ADDR) ///< Largest image that can be staged (232 KB).
+#define FW_UPDATE_VERIFY_BYTES              256       ///< Staged bytes run through the CRC between budget checks.
+#define FW_UPDATE_STALL_MS                  15000     ///< The update fails when the stream makes no progress for this long.
+#define FW_UPDATE_APPLY_DELAY_MS            250       ///< Time left for the apply reply to go out before the copy starts.
+#define LOOP_TASK_FW_UPDATE_BUDGET_US       500       ///< Budget of the firmware update task per pass.
+/** @} */
+
+/**
+ * @name PLC Register Map
+ * @brief Fixed-layout status image and command mailbox on UDP, one datagram each way (see register_map.h).
+ * @{
+ */
+#ifndef REGISTER_MAP_ENABLED
+#define REGISTER_MAP_ENABLED                1         ///< 1 = answer RegisterRequest datagrams on REGISTER_MAP_PORT.
+#endif
+#define REGISTER_MAP_PORT                   8891      ///< UDP port of the register map.
+#define REGISTER_MAP_FRAME_BYTES            56        ///< Largest binary command frame the mailbox carries.
+#define REGISTER_MAP_REQUEST_ID_BASE        2000000000u ///< Request ID of a mailbox command, less its sequence number.
+/** @} */
+
+/**
+ * @name Press Sync
+ * @brief Leader/follower segment barrier of several presses on one job, over UDP (see press_sync.h).
+ * @{
+ */
+#ifndef PRESS_SYNC_ENABLED
+#define PRESS_SYNC_ENABLED                  1         ///< 1 compiles the set_sync command and its UDP port in.
+#endif
+#define PRESS_SYNC_PORT                     8892      ///< UDP port of the sync datagrams, the same on every press.
+#define PRESS_SYNC_MAX_PEERS                3         ///< Followers one leader keeps track of.
+#define PRESS_SYNC_PING_MS                  100       ///< Interval of a follower's clock pings (also its keepalive).
+#define PRESS_SYNC_RESEND_MS                5         ///< ARM, READY and GO are repeated at this interval until answered.
+#define PRESS_SYNC_LEAD_US                  10000     ///< A released segment starts this long after the leader's GO, so every follower has it.
+#define PRESS_SYNC_LINK_TIMEOUT_MS          500       ///< A run stops when the other side has been silent this long.
+#define PRESS_SYNC_BARRIER_TIMEOUT_MS       10000     ///< A run stops when a press has waited at a segment this long.
+#define PRESS_SYNC_CLOCK_WINDOW             8         ///< Clock samples the shortest round trip is picked from.
+#define PRESS_SYNC_CLOCK_MIN_SAMPLES        4         ///< Samples a follower needs before it can join a run.
+#define PRESS_SYNC_CLOCK_RTT_MAX_US         4000      ///< Pongs with a longer round trip are not used for the clock.
+#define LOOP_TASK_SYNC_BUDGET_US            200       ///< Budget of the press sync task per pass.
 /** @} */
 
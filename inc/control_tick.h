@@ -0,0 +1,102 @@
+/**
+ * @file control_tick.h
+ * @author Eldin Miller-Stead
+ * @date November 3, 2025
+ * @brief Defines the fixed-rate control tick driven by a SAME53 timer interrupt.
+ *
+ * @details TCC2 (unused by libClearCore) raises a periodic interrupt at CONTROL_TICK_HZ.
+ * Each tick runs the registered hooks in registration order: the load-cell receive
+ * path first, then the time-critical part of MotorController (HLFB reads, limit checks,
+ * stopping axes). Comms, telemetry and logging stay in the cooperative main loop, so
+ * limit reaction time no longer depends on how long a loop pass takes.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief Function run from the control tick interrupt.
+ * @param context Opaque pointer supplied to ControlTick::registerHook()
+ */
+typedef void (*ControlTickHook)(void* context);
+
+/**
+ * @class ControlTick
+ * @brief Owns the control tick timer and its hook list.
+ */
+class ControlTick {
+public:
+    /**
+     * @brief Constructs a stopped control tick with no hooks.
+     */
+    ControlTick();
+
+    /**
+     * @brief Configures TCC2 and enables its interrupt. Safe to call more than once.
+     */
+    void start();
+
+    /**
+     * @brief Adds a hook to run on every tick.
+     * @details Register from setup(), before or after start(). Hooks run in interrupt
+     * context at CONTROL_TICK_IRQ_PRIORITY and must be short and ISR-safe.
+     * @param hook Function to call
+     * @param context Passed through to @p hook
+     * @return false if CONTROL_TICK_MAX_HOOKS are already registered
+     */
+    bool registerHook(ControlTickHook hook, void* context);
+
+    /**
+     * @brief Checks whether the tick interrupt has been started.
+     * @return true once start() has run
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Blocks the tick interrupt so main-loop code can update shared state atomically.
+     */
+    void mask();
+
+    /**
+     * @brief Re-enables the tick interrupt after mask() (no-op before start()).
+     */
+    void unmask();
+
+    /**
+     * @brief Runs every registered hook. Called from the TCC2 interrupt handler.
+     */
+    void service();
+
+    /**
+     * @brief Gets the number of ticks serviced since start().
+     * @return Tick count (wraps)
+     */
+    uint32_t getTickCount() const { return m_tick_count; }
+
+    /**
+     * @brief Gets the time the current tick started. Call from a hook: the value is 64 bits
+     * and is only written by the tick itself.
+     * @return MonotonicUs() at the start of service()
+     */
+    uint64_t getTickTimeUs() const { return m_tick_time_us; }
+
+    /**
+     * @brief Gets the largest gap between two consecutive ticks since start(), a measure
+     * of how late higher-priority interrupts let the tick run.
+     * @return Microseconds (nominally 1000000 / CONTROL_TICK_HZ)
+     */
+    uint32_t getMaxTickGapUs() const { return m_max_tick_gap_us; }
+
+private:
+    ControlTickHook m_hooks[CONTROL_TICK_MAX_HOOKS];   ///< Registered hooks, run in order
+    void* m_contexts[CONTROL_TICK_MAX_HOOKS];          ///< Argument for each hook
+    volatile uint8_t m_hook_count;                     ///< Valid entries in m_hooks
+    volatile bool m_running;                           ///< True once TCC2 is configured
+    volatile uint32_t m_tick_count;                    ///< Ticks serviced
+    uint64_t m_tick_time_us;                           ///< MonotonicUs() when the current tick started
+    volatile uint32_t m_max_tick_gap_us;               ///< Longest interval between tick starts
+    uint8_t m_watchdog;                                ///< Watchdog supervisor client the tick checks in as
+};
+
+extern ControlTick g_controlTick;
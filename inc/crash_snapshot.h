@@ -0,0 +1,119 @@
+/**
+ * @file crash_snapshot.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the post-mortem crash snapshot kept in no-init RAM across a reset.
+ *
+ * @details The watchdog early-warning interrupt and the HardFault handler fill a
+ * CrashSnapshot just before the reset: the breadcrumb, the scheduler task that was running
+ * and for how long, the loop-stage timings of the current profiler window, the motor state
+ * and homing phase, the RX/TX queue depths, the newest trace records and, for a HardFault,
+ * the faulting PC and fault status registers. The snapshot lives in .noinit, so a reset
+ * leaves it alone; it is sealed with a magic number and a checksum last, so power-up RAM
+ * contents or a capture cut short never pass for a snapshot. On the next boot load() moves
+ * it into ordinary RAM and unseals the .noinit copy, the boot report summarizes it and
+ * dump_crash streams it in full.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "loop_profiler.h"
+#include "trace_log.h"
+
+/**
+ * @enum CrashCause
+ * @brief What captured the snapshot.
+ */
+enum CrashCause : uint8_t {
+    CRASH_CAUSE_NONE = 0,       ///< No snapshot
+    CRASH_CAUSE_WATCHDOG,       ///< Watchdog early warning (main loop blocked)
+    CRASH_CAUSE_HARDFAULT       ///< HardFault exception
+};
+
+/**
+ * @struct CrashSnapshot
+ * @brief State at the moment of the crash.
+ */
+struct CrashSnapshot {
+    uint32_t magic;                             ///< CRASH_SNAPSHOT_MAGIC once sealed
+    uint32_t checksum;                          ///< Sum of the words after this one
+    uint8_t cause;                              ///< CrashCause
+    uint8_t breadcrumb;                         ///< g_watchdogBreadcrumb (WD_BREADCRUMB_*)
+    uint8_t main_state;                         ///< Pressboi MainState
+    uint8_t motor_state;                        ///< MotorController state
+    uint8_t homing_phase;                       ///< MotorController homing phase
+    uint8_t running_task;                       ///< Scheduler task index running (0xFF = between tasks)
+    uint16_t rx_depth;                          ///< Messages in the RX queue
+    uint16_t tx_depth[3];                       ///< Messages in each TX lane (control, telemetry, bulk)
+    uint16_t trace_count;                       ///< Valid entries in trace
+    uint32_t uptime_ms;                         ///< Milliseconds() at the crash
+    uint32_t running_us;                        ///< How long the running task had been running
+    uint32_t pc;                                ///< Stacked PC (HardFault only)
+    uint32_t lr;                                ///< Stacked LR (HardFault only)
+    uint32_t cfsr;                              ///< SCB->CFSR (HardFault only)
+    uint32_t hfsr;                              ///< SCB->HFSR (HardFault only)
+    uint32_t stage_mean_us[LOOP_STAGE_COUNT];   ///< Mean pass time per LoopStage in the profiler window
+    uint32_t stage_max_us[LOOP_STAGE_COUNT];    ///< Longest pass per LoopStage in the profiler window
+    uint32_t trace_first_seq;                   ///< Sequence number of trace[0]
+    TraceRecord trace[CRASH_SNAPSHOT_TRACE_RECORDS]; ///< Newest trace records, oldest first
+};
+
+/**
+ * @class CrashSnapshotStore
+ * @brief Captures, seals and recovers the no-init CrashSnapshot.
+ */
+class CrashSnapshotStore {
+public:
+    /**
+     * @brief Constructs the store with no saved snapshot.
+     */
+    CrashSnapshotStore();
+
+    /**
+     * @brief Starts a capture: fills the parts that live in shared modules (uptime,
+     * scheduler task, stage timings, trace records) and zeroes the rest. Fault context.
+     * @param cause CrashCause
+     * @param breadcrumb Current watchdog breadcrumb
+     * @return The no-init snapshot, for the caller to fill in its own state before commit()
+     */
+    CrashSnapshot* begin(uint8_t cause, uint8_t breadcrumb);
+
+    /**
+     * @brief Seals the snapshot begun by begin(). Fault context.
+     */
+    void commit();
+
+    /**
+     * @brief Moves a sealed snapshot from no-init RAM into getSaved(). Call once, early in setup().
+     * @return true if the previous reset left a snapshot
+     */
+    bool load();
+
+    /**
+     * @brief Checks whether load() found a snapshot.
+     * @return true if getSaved() holds the previous crash
+     */
+    bool hasSaved() const { return m_hasSaved; }
+
+    /**
+     * @brief Gets the snapshot found by load().
+     * @return Snapshot (only meaningful when hasSaved())
+     */
+    const CrashSnapshot& getSaved() const { return m_saved; }
+
+    /**
+     * @brief Gets the name of a cause as shown in reports.
+     * @param cause CrashCause
+     * @return "watchdog", "hardfault" or "none"
+     */
+    static const char* causeName(uint8_t cause);
+
+private:
+    static uint32_t checksum(const CrashSnapshot& snapshot);
+
+    CrashSnapshot m_saved;      ///< Snapshot of the previous crash
+    bool m_hasSaved;            ///< load() found a snapshot
+};
+
+extern CrashSnapshotStore g_crashSnapshot;
@@ -0,0 +1,154 @@
+/**
+ * @file cycle_estimate.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the kinematic cycle-time estimate of the stored recipe.
+ *
+ * @details The estimate plays the recipe through the same limits MotorController applies
+ * to it: the move acceleration, the S-curve jerk when set_motion_profile has one, the
+ * 100 mm/s move ceiling, blending of same-direction moves, the adaptive rapid approach of
+ * steps with a learned contact, and the retract speed and traverse limits. Each step gets
+ * its motion, dwell and retract time, and a bound: accel when ramping costs more than the
+ * cruise would at the step's speed (or the speed is never reached), dwell when a dwell or
+ * regulated hold takes longer than the motion, speed otherwise. Press moves are timed to
+ * their target, so a step that stops on its force limit comes in under its estimate.
+ *
+ * recipe_save reports the estimate; run_recipe plans it again from where the press stands
+ * and, with the DONE of the run, reports it next to the measured phase breakdown of
+ * CycleTiming (approach and press against motion, dwell, retract and the whole cycle).
+ * definition/cycle_estimate.py is the host-side copy of the same model.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "cycle_timing.h"
+
+class RecipeStore;
+
+/**
+ * @enum CycleBound
+ * @brief What limits the time of a recipe step.
+ */
+enum CycleBound : uint8_t {
+    CYCLE_BOUND_NONE = 0,       ///< Nothing to do (already at the target)
+    CYCLE_BOUND_SPEED,          ///< Cruising at the step's speed takes most of the time
+    CYCLE_BOUND_ACCEL,          ///< Ramping costs more than the cruise, or the speed is never reached
+    CYCLE_BOUND_DWELL,          ///< A dwell or regulated hold takes longer than the motion
+    CYCLE_BOUND_COUNT
+};
+
+/**
+ * @struct CycleEstimateLimits
+ * @brief The machine settings a recipe run is estimated with.
+ */
+struct CycleEstimateLimits {
+    float start_mm;             ///< Position the run starts from (mm from home)
+    float retract_mm;           ///< Retract position (mm from home)
+    float accel_mmss;           ///< Move acceleration
+    float jerk_mmss3;           ///< S-curve jerk (0 = trapezoidal moves)
+    float retract_speed_mms;    ///< set_retract speed, for retracts that have none of their own
+    float traverse_ceiling_mms; ///< Speed ceiling of the adaptive rapid approach and of the retract after a "retract" force action
+    float traverse_accel_mmss;  ///< Acceleration of that retract
+    bool adaptive;              ///< Learned contacts are approached at the recipe's rapid speed (load_cell mode)
+};
+
+/**
+ * @struct SegmentEstimate
+ * @brief Estimated time of one recipe step.
+ */
+struct SegmentEstimate {
+    uint32_t move_us;           ///< Motion toward the step's target
+    uint32_t dwell_us;          ///< Dwell step or regulated hold
+    uint32_t retract_us;        ///< Retract step, or the retract of a "retract" force action
+    CycleBound bound;           ///< What limits the step
+};
+
+/**
+ * @class CycleEstimate
+ * @brief The estimate of the stored recipe, per step and in total. Main loop only.
+ */
+class CycleEstimate {
+public:
+    /**
+     * @brief Constructs an empty estimate.
+     */
+    CycleEstimate();
+
+    /**
+     * @brief Estimates every step of a recipe.
+     * @param recipe Recipe to play through (its learned contacts included)
+     * @param limits Machine settings to play it with
+     */
+    void plan(const RecipeStore& recipe, const CycleEstimateLimits& limits);
+
+    /**
+     * @brief Checks whether a recipe has been estimated.
+     * @return true if the last plan() had steps
+     */
+    bool isValid() const { return m_count > 0; }
+
+    /**
+     * @brief Gets the number of estimated steps.
+     * @return Step count
+     */
+    uint8_t getCount() const { return m_count; }
+
+    /**
+     * @brief Gets the estimate of one step.
+     * @param index Step index (below getCount())
+     * @return The step's estimate
+     */
+    const SegmentEstimate& getSegment(uint8_t index) const { return m_segments[index]; }
+
+    /**
+     * @brief Gets the estimated time of the whole run.
+     * @return Microseconds
+     */
+    uint32_t getTotalUs() const { return m_moveUs + m_dwellUs + m_retractUs; }
+
+    /**
+     * @brief Writes the totals as key=value pairs (e.g. "est_ms=2310.0 move_ms=... accel_steps=2").
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Characters written (as snprintf)
+     */
+    int format(char* buffer, size_t size) const;
+
+    /**
+     * @brief Writes the estimate of one step (e.g. "812.5 ms accel (move 812.5, dwell 0.0, retract 0.0)").
+     * @param index Step index (below getCount())
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Characters written (as snprintf)
+     */
+    int formatSegment(uint8_t index, char* buffer, size_t size) const;
+
+    /**
+     * @brief Writes the last finished cycle next to the estimate, measured/estimated per phase.
+     * @details Approach and press are compared with the motion time; the start phase has
+     * no estimate and only counts in the cycle total.
+     * @param timing Cycle timing holding the finished run
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Characters written (as snprintf)
+     */
+    int formatComparison(const CycleTiming& timing, char* buffer, size_t size) const;
+
+    /**
+     * @brief Gets the name of a bound as reported.
+     * @param bound CycleBound
+     * @return "speed", "accel", "dwell" or "none"
+     */
+    static const char* boundName(CycleBound bound);
+
+private:
+    SegmentEstimate m_segments[RECIPE_MAX_STEPS];   ///< Per step, in run order
+    uint8_t m_count;                                ///< Valid entries in m_segments
+    uint32_t m_moveUs;                              ///< Sum of the motion times
+    uint32_t m_dwellUs;                             ///< Sum of the dwell times
+    uint32_t m_retractUs;                           ///< Sum of the retract times
+};
+
+extern CycleEstimate g_cycleEstimate;
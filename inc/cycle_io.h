@@ -0,0 +1,81 @@
+/**
+ * @file cycle_io.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the hardware cycle-start input and the busy / pass / fail outputs.
+ *
+ * @details With CYCLE_IO_ENABLED 1 a PLC can cycle the press without a host: an active edge
+ * on CYCLE_START_INPUT runs the stored recipe, CYCLE_OUT_BUSY is on while it runs, and
+ * CYCLE_OUT_PASS or CYCLE_OUT_FAIL shows how it ended until the next start. An edge
+ * interrupt latches the time of the first raw edge; the input's filtered state must then
+ * confirm it, so a glitch shorter than CYCLE_START_FILTER_MS never starts a cycle, and the
+ * input has to read inactive again before the next edge counts. Without a free interrupt
+ * slot the filtered state is polled instead, which costs up to one loop pass of latency.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+#if CYCLE_IO_ENABLED
+
+/**
+ * @enum CycleOutput
+ * @brief What the cycle outputs show.
+ */
+enum CycleOutput : uint8_t {
+    CYCLE_OUTPUT_IDLE = 0,  ///< All outputs off (no cycle since boot)
+    CYCLE_OUTPUT_BUSY,      ///< A cycle is running
+    CYCLE_OUTPUT_PASS,      ///< The last cycle ran the recipe to its DONE
+    CYCLE_OUTPUT_FAIL       ///< The last cycle or start request failed
+};
+
+/**
+ * @class CycleIo
+ * @brief The cycle-start input with its latched edge time, and the result outputs.
+ */
+class CycleIo {
+public:
+    /**
+     * @brief Constructs the input disarmed until setup().
+     */
+    CycleIo();
+
+    /**
+     * @brief Configures the input and its edge interrupt, and turns the outputs off. Call
+     * once in setup().
+     */
+    void setup();
+
+    /**
+     * @brief Takes a start edge the filtered input has confirmed. Main loop only.
+     * @param edge_us Receives Microseconds() at the edge
+     * @return true once per press of the start input
+     */
+    bool takeStart(uint32_t* edge_us);
+
+    /**
+     * @brief Sets the outputs.
+     * @param output CycleOutput
+     */
+    void show(uint8_t output);
+
+    /**
+     * @brief Checks whether the start edge is latched by interrupt (not polled).
+     * @return true if the interrupt handler was installed
+     */
+    bool isLatched() const { return m_interruptAvailable; }
+
+private:
+    static void startIsr();
+    bool inputActive() const;
+
+    volatile bool m_edgeLatched;    ///< Set by the edge interrupt, cleared by takeStart()
+    volatile uint32_t m_edgeUs;     ///< Microseconds() of the latched edge
+    bool m_armed;                   ///< The input has read inactive since the last start
+    bool m_interruptAvailable;      ///< startIsr() is installed on the input
+};
+
+extern CycleIo g_cycleIo;
+
+#endif // CYCLE_IO_ENABLED
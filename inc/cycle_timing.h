@@ -0,0 +1,164 @@
+/**
+ * @file cycle_timing.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the per-phase cycle timing of press moves.
+ *
+ * @details A press cycle is timed from the Microseconds() clock in five phases: start
+ * (command dispatch until the step generator holds the move, bounded by MOVE_START_TIMEOUT_MS),
+ * approach (moving until the press threshold is crossed), press (contact until the force
+ * limit or the target), dwell (holding at the limit, a regulated hold or a queued dwell)
+ * and retract. Each transition books the time since the previous one to the phase that
+ * just ended, so a queue that dwells or approaches more than once adds the pieces up. The
+ * DONE event of the move carries the breakdown, and every finished cycle is folded into
+ * per-phase min/mean/max statistics that dump_cycle_times reports.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @enum CyclePhase
+ * @brief Phases of a press cycle, in the order they normally run.
+ */
+enum CyclePhase : uint8_t {
+    CYCLE_PHASE_START = 0,      ///< Command dispatch until the axis moves
+    CYCLE_PHASE_APPROACH,       ///< Moving, before the press threshold is crossed
+    CYCLE_PHASE_PRESS,          ///< Threshold crossed, until the limit or the target
+    CYCLE_PHASE_DWELL,          ///< Holding at the limit, regulating or in a queued dwell
+    CYCLE_PHASE_RETRACT,        ///< Returning to the retract position
+    CYCLE_PHASE_COUNT,
+    CYCLE_PHASE_TOTAL = CYCLE_PHASE_COUNT ///< Whole cycle (statistics only)
+};
+
+/**
+ * @struct CyclePhaseStats
+ * @brief Statistics of one phase over the finished cycles.
+ */
+struct CyclePhaseStats {
+    uint32_t count;             ///< Cycles the phase took part in
+    uint32_t min_us;            ///< Shortest
+    uint32_t max_us;            ///< Longest
+    uint64_t total_us;          ///< Sum, for the mean
+};
+
+/**
+ * @class CycleTiming
+ * @brief Times the phases of the current press cycle and keeps statistics. Main loop only.
+ */
+class CycleTiming {
+public:
+    /**
+     * @brief Constructs an idle timer with empty statistics.
+     */
+    CycleTiming();
+
+    /**
+     * @brief Starts timing a cycle in CYCLE_PHASE_START.
+     * @param now_us Microseconds() when the command was dispatched
+     */
+    void begin(uint32_t now_us);
+
+    /**
+     * @brief The axis is moving: approach, or press when contact was already made. A
+     * retract stays a retract.
+     * @param now_us Microseconds()
+     */
+    void motionStarted(uint32_t now_us);
+
+    /**
+     * @brief A queued segment after the first has started.
+     * @param now_us Microseconds()
+     * @param retracting true for a retract segment; a move segment after one approaches again
+     */
+    void segmentStarted(uint32_t now_us, bool retracting);
+
+    /**
+     * @brief The press threshold was crossed.
+     * @param now_us Microseconds()
+     */
+    void contact(uint32_t now_us);
+
+    /**
+     * @brief The axis holds at the force limit, a regulated target or a queued dwell.
+     * @param now_us Microseconds()
+     */
+    void dwell(uint32_t now_us);
+
+    /**
+     * @brief The retract has started.
+     * @param now_us Microseconds()
+     */
+    void retract(uint32_t now_us);
+
+    /**
+     * @brief Ends the cycle and folds it into the statistics.
+     * @param now_us Microseconds()
+     * @return false if no cycle was being timed
+     */
+    bool finish(uint32_t now_us);
+
+    /**
+     * @brief Drops the cycle being timed (the move failed or was cancelled).
+     */
+    void cancel() { m_active = false; }
+
+    /**
+     * @brief Checks whether a cycle is being timed.
+     * @return true between begin() and finish() or cancel()
+     */
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief Appends the last finished cycle as key=value pairs, for the DONE event.
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Characters written (as snprintf)
+     */
+    int format(char* buffer, size_t size) const;
+
+    /**
+     * @brief Gets a phase of the last finished cycle.
+     * @param phase CyclePhase, or CYCLE_PHASE_TOTAL for the whole cycle
+     * @return Microseconds (0 if the cycle never entered the phase)
+     */
+    uint32_t getLastUs(uint8_t phase) const { return m_lastUs[phase]; }
+
+    /**
+     * @brief Gets the statistics of a phase.
+     * @param phase CyclePhase, or CYCLE_PHASE_TOTAL for the whole cycle
+     * @return Statistics since the last resetStats()
+     */
+    const CyclePhaseStats& getStats(uint8_t phase) const { return m_stats[phase]; }
+
+    /**
+     * @brief Clears the statistics; a cycle being timed carries on.
+     */
+    void resetStats();
+
+    /**
+     * @brief Gets the name of a phase as shown by dump_cycle_times.
+     * @param phase CyclePhase, or CYCLE_PHASE_TOTAL
+     * @return Phase name
+     */
+    static const char* phaseName(uint8_t phase);
+
+private:
+    /**
+     * @brief Books the time since the last transition to the current phase and enters @p phase.
+     */
+    void enter(uint8_t phase, uint32_t now_us);
+
+    bool m_active;                                  ///< A cycle is being timed
+    bool m_contact;                                 ///< The threshold was crossed in this cycle
+    uint8_t m_phase;                                ///< Current CyclePhase
+    uint32_t m_beginUs;                             ///< Microseconds() of begin()
+    uint32_t m_markUs;                              ///< Microseconds() of the last transition
+    uint32_t m_phaseUs[CYCLE_PHASE_COUNT];          ///< Time booked to each phase this cycle
+    uint32_t m_lastUs[CYCLE_PHASE_COUNT + 1];       ///< Last finished cycle, with its total
+    CyclePhaseStats m_stats[CYCLE_PHASE_COUNT + 1]; ///< Per phase, then the whole cycle
+};
+
+extern CycleTiming g_cycleTiming;
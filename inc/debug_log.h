@@ -0,0 +1,113 @@
+/**
+ * @file debug_log.h
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Defines the gated binary debug-record channel.
+ *
+ * @details Diagnostic values from the hot paths are written as fixed-size binary records
+ * into a RAM ring instead of being formatted with snprintf and pushed through reportEvent.
+ * Pressboi drains the ring as base64 "DEBUG:pressboi:DATA:" lines whenever the TX queue has
+ * room, so records can be captured at full sample rate without crowding out telemetry.
+ * While the level is DEBUG_LEVEL_OFF (the default after boot) a call site costs one
+ * branch; with DEBUG_LOG_ENABLED 0 the call sites compile out entirely.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @enum DebugLevel
+ * @brief What set_debug turns on.
+ */
+enum DebugLevel : uint8_t {
+    DEBUG_LEVEL_OFF = 0,      ///< Nothing recorded
+    DEBUG_LEVEL_RECORDS = 1   ///< Hot-path debug records
+};
+
+/**
+ * @enum DebugRecordType
+ * @brief Meaning of the values in a DebugRecord.
+ */
+enum DebugRecordType : uint8_t {
+    DEBUG_RECORD_STRAIN_RATIO = 1   ///< force_kg, est_defl_mm, travel_mm, ratio, joules (integrateForceSample)
+};
+
+/**
+ * @struct DebugRecord
+ * @brief One debug record as sent on the wire (28 bytes, little endian).
+ */
+struct DebugRecord {
+    uint32_t time_us;       ///< Microseconds() when recorded
+    uint16_t seq;           ///< Sequence number (gaps mean records were dropped)
+    uint8_t type;           ///< DebugRecordType
+    uint8_t reserved;       ///< Zero
+    float values[5];        ///< Type-specific values
+};
+
+/**
+ * @class DebugLog
+ * @brief Ring buffer of DebugRecord plus the DATA line formatter. Main loop only.
+ */
+class DebugLog {
+public:
+    /**
+     * @brief Constructs an empty log at DEBUG_LEVEL_OFF.
+     */
+    DebugLog();
+
+    /**
+     * @brief Sets the debug level. Turning records on restarts the sequence and clears the ring.
+     * @param level DebugLevel
+     * @return false if @p level is out of range
+     */
+    bool setLevel(uint8_t level);
+
+    /**
+     * @brief Gets the debug level.
+     * @return DebugLevel
+     */
+    uint8_t getLevel() const { return m_level; }
+
+    /**
+     * @brief Checks whether records are being taken. Call sites test this first.
+     * @return true at DEBUG_LEVEL_RECORDS
+     */
+    bool isEnabled() const { return m_level >= DEBUG_LEVEL_RECORDS; }
+
+    /**
+     * @brief Appends a record; counted as dropped when the ring is full.
+     * @param type DebugRecordType
+     * @param v0 First value
+     * @param v1 Second value
+     * @param v2 Third value
+     * @param v3 Fourth value
+     * @param v4 Fifth value
+     */
+    void record(uint8_t type, float v0, float v1 = 0.0f, float v2 = 0.0f, float v3 = 0.0f, float v4 = 0.0f);
+
+    /**
+     * @brief Checks whether records are waiting to be sent.
+     * @return true if the ring is not empty
+     */
+    bool hasPending() const { return m_count > 0; }
+
+    /**
+     * @brief Removes up to DEBUG_LOG_RECORDS_PER_LINE records and formats them as one DATA line.
+     * @param buffer Output buffer (at least MAX_MESSAGE_LENGTH bytes)
+     * @param size Size of @p buffer
+     * @return Number of records formatted (0 if none were pending)
+     */
+    uint16_t formatLine(char* buffer, size_t size);
+
+private:
+    DebugRecord m_records[DEBUG_LOG_RECORDS]; ///< Ring of pending records
+    uint16_t m_head;           ///< Oldest pending record
+    uint16_t m_count;          ///< Pending records
+    uint16_t m_seq;            ///< Sequence number of the next record
+    uint32_t m_dropped;        ///< Records lost to a full ring since the level was set
+    uint8_t m_level;           ///< DebugLevel
+};
+
+extern DebugLog g_debugLog;
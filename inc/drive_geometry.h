@@ -0,0 +1,113 @@
+/**
+ * @file drive_geometry.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the drive geometry (screw pitch and step pulses per revolution) held in NVM.
+ *
+ * @details One firmware image serves every press variant: the pitch and the pulses per
+ * revolution each unit's drives are set up for are stored in NVM slots 63-65 and read once
+ * in setup(), before the motors are configured. load() precomputes the steps-per-mm and
+ * mm-per-step factors the conversions in units.h multiply by, so the motion path pays one
+ * float multiply per conversion whatever the geometry. A unit with no stored geometry runs
+ * the PITCH_MM_PER_REV / PULSES_PER_REV defaults from config.h.
+ *
+ * set_drive_geometry only writes NVM; the new geometry takes effect on the next boot, as
+ * every step position (home reference, retract position, capture, replay profile) would
+ * otherwise change meaning under a running controller.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @class DriveGeometry
+ * @brief Active drive geometry and its conversion factors. Main loop only.
+ */
+class DriveGeometry {
+public:
+    /**
+     * @brief Constructs the config.h default geometry.
+     */
+    DriveGeometry();
+
+    /**
+     * @brief Reads the stored geometry and makes it active. Call once in setup(), before
+     * anything converts between steps and mm.
+     * @return true if a stored geometry was found, false if the defaults are active
+     */
+    bool load();
+
+    /**
+     * @brief Checks a geometry and stages it for the next boot; commit() writes it from
+     * the idle flash job.
+     * @param pitch_mm_per_rev Press travel per motor revolution (DRIVE_PITCH_MIN_MM .. DRIVE_PITCH_MAX_MM)
+     * @param pulses_per_rev Step pulses per revolution (DRIVE_PULSES_PER_REV_MIN .. DRIVE_PULSES_PER_REV_MAX)
+     * @return false if a value is out of range (nothing staged)
+     */
+    bool save(float pitch_mm_per_rev, int32_t pulses_per_rev);
+
+    /**
+     * @brief Checks for a geometry saved since the last NVM write.
+     * @return true if commit() has work
+     */
+    bool isPending() const { return m_pending; }
+
+    /**
+     * @brief Writes the staged geometry to NVM, check word last.
+     * @return false if a write was refused (the geometry stays staged)
+     */
+    bool commit();
+
+    /**
+     * @brief Erases the stored geometry, so the next boot runs the defaults, and drops a
+     * staged one.
+     */
+    void erase();
+
+    /**
+     * @brief Gets the active pitch.
+     * @return mm per revolution
+     */
+    float getPitchMmPerRev() const { return m_pitchMmPerRev; }
+
+    /**
+     * @brief Gets the active pulses per revolution.
+     * @return Step pulses
+     */
+    int32_t getPulsesPerRev() const { return m_pulsesPerRev; }
+
+    /**
+     * @brief Gets the active steps per mm of press travel.
+     * @return Steps per mm
+     */
+    float stepsPerMm() const { return m_stepsPerMm; }
+
+    /**
+     * @brief Gets the active mm of press travel per step.
+     * @return mm per step
+     */
+    float mmPerStep() const { return m_mmPerStep; }
+
+    /**
+     * @brief Checks a geometry against the accepted ranges.
+     * @param pitch_mm_per_rev mm per revolution
+     * @param pulses_per_rev Step pulses per revolution
+     * @return true if both are in range
+     */
+    static bool isValid(float pitch_mm_per_rev, int32_t pulses_per_rev);
+
+private:
+    void apply(float pitch_mm_per_rev, int32_t pulses_per_rev);
+    static uint32_t checkWord(uint32_t pitch_bits, int32_t pulses_per_rev);
+
+    float m_pitchMmPerRev;      ///< mm per revolution
+    int32_t m_pulsesPerRev;     ///< Step pulses per revolution
+    float m_stepsPerMm;         ///< m_pulsesPerRev / m_pitchMmPerRev
+    float m_mmPerStep;          ///< m_pitchMmPerRev / m_pulsesPerRev
+    float m_savedPitchMmPerRev; ///< Geometry staged by save()
+    int32_t m_savedPulsesPerRev; ///< Geometry staged by save()
+    bool m_pending;             ///< Staged geometry not written to NVM yet
+};
+
+extern DriveGeometry g_driveGeometry;
@@ -0,0 +1,86 @@
+/**
+ * @file dsp_kernels.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the block sums the window estimators run on.
+ *
+ * @details With PRESSBOI_DSP set the kernels are the CMSIS-DSP ones from
+ * arm_cortexM4lf_math, which every configuration of pressboi.cppproj already links: they
+ * unroll by four and keep the accumulators in FPU registers, where the scalar loop reloads
+ * its sums each sample. Host builds (PRESSBOI_HOST) get the plain loops, which give the
+ * same sums up to float rounding order.
+ *
+ * Only block work belongs here. The per-sample filters of the control tick (the torque and
+ * fusion EWMAs, the seat detector's integer running sums) are O(1) per sample, and a
+ * one-sample arm_biquad or arm_fir call costs more in setup than the filter itself.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+#if PRESSBOI_DSP
+#include <sam.h>
+#ifndef ARM_MATH_CM4
+#define ARM_MATH_CM4
+#endif
+#include <arm_math.h>
+#endif
+
+/**
+ * @brief Sums a block.
+ * @param src Values
+ * @param count Values in src (at least 1)
+ * @return Sum
+ */
+inline float dsp_sum(const float* src, uint16_t count) {
+#if PRESSBOI_DSP
+    float32_t mean;
+    arm_mean_f32(const_cast<float32_t*>(src), count, &mean);
+    return mean * (float)count;
+#else
+    float sum = 0.0f;
+    for (uint16_t i = 0; i < count; i++) {
+        sum += src[i];
+    }
+    return sum;
+#endif
+}
+
+/**
+ * @brief Sums the products of two blocks.
+ * @param a First block
+ * @param b Second block (may be a)
+ * @param count Values in each block
+ * @return Dot product
+ */
+inline float dsp_dot(const float* a, const float* b, uint16_t count) {
+#if PRESSBOI_DSP
+    float32_t dot;
+    arm_dot_prod_f32(const_cast<float32_t*>(a), const_cast<float32_t*>(b), count, &dot);
+    return dot;
+#else
+    float dot = 0.0f;
+    for (uint16_t i = 0; i < count; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+#endif
+}
+
+/**
+ * @brief Adds a constant to each value of a block.
+ * @param src Values
+ * @param offset Added to each value
+ * @param dst Results (may be src)
+ * @param count Values in src
+ */
+inline void dsp_offset(const float* src, float offset, float* dst, uint16_t count) {
+#if PRESSBOI_DSP
+    arm_offset_f32(const_cast<float32_t*>(src), offset, dst, count);
+#else
+    for (uint16_t i = 0; i < count; i++) {
+        dst[i] = src[i] + offset;
+    }
+#endif
+}
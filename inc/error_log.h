@@ -9,16 +9,30 @@
  * network, which is crucial for diagnosing intermittent USB communication issues.
  * The log is designed to be lightweight and non-blocking to avoid interfering
  * with real-time operations or triggering the watchdog.
+ *
+ * Call sites use ERROR_LOG() and ERROR_LOGF(). A level below ERROR_LOG_MIN_LEVEL is
+ * compiled out, and one below the runtime level (set_log_level) returns before its
+ * arguments are evaluated or its format is run, so a DEBUG line in a hot path costs
+ * one compare when it is filtered and nothing when it is compiled out.
+ *
+ * ErrorLog::log() is safe from interrupts and from several producers at once: each entry
+ * claims its sequence number with one atomic add and publishes its slot with a stamp once
+ * written, so no producer ever waits or masks interrupts. Readers never block either; an
+ * entry being written or overwritten while it is read is reported as unavailable. The SD
+ * card copy is made later by serviceSdLog() in the SD log task, never from the producer.
+ * HeartbeatLog is main loop only.
  */
 #pragma once
 
 #include <stdint.h>
 #include <cstring>
+#include "config.h"
 
 // Log configuration
 #define ERROR_LOG_SIZE 100           ///< Maximum number of log entries (circular buffer)
 #define ERROR_LOG_MSG_LENGTH 80      ///< Maximum length of each log message
 #define HEARTBEAT_LOG_SIZE 2880      ///< 24 hours of heartbeats at 30-second intervals
+#define HEARTBEAT_LOG_RUNS 256       ///< Runs of identical heartbeats kept (status changes the log can hold)
 
 /**
  * @enum LogLevel
@@ -44,7 +58,7 @@ struct LogEntry {
 
 /**
  * @struct HeartbeatEntry
- * @brief Compact heartbeat status entry (only 8 bytes vs 88 bytes for LogEntry).
+ * @brief One heartbeat as returned by HeartbeatLog::getEntry().
  */
 struct HeartbeatEntry {
     uint32_t timestamp;      ///< Millisecond timestamp
@@ -54,9 +68,25 @@ struct HeartbeatEntry {
     uint8_t reserved;        ///< Reserved for future use
 };
 
+/**
+ * @struct HeartbeatRun
+ * @brief Consecutive heartbeats with the same status, stored as one 12-byte record.
+ */
+struct HeartbeatRun {
+    uint32_t firstTimestamp; ///< Millisecond timestamp of the first heartbeat in the run
+    uint32_t lastTimestamp;  ///< Millisecond timestamp of the last heartbeat in the run
+    uint16_t count;          ///< Heartbeats in the run (at least 1)
+    uint8_t flags;           ///< HEARTBEAT_FLAG_USB_CONNECTED | HEARTBEAT_FLAG_NETWORK_ACTIVE
+    uint8_t usbAvailable;    ///< Bytes available in USB TX buffer (0-255)
+};
+
+#define HEARTBEAT_FLAG_USB_CONNECTED  0x01  ///< HeartbeatRun::flags: USB host connected
+#define HEARTBEAT_FLAG_NETWORK_ACTIVE 0x02  ///< HeartbeatRun::flags: network link up
+
 /**
  * @class ErrorLog
  * @brief Manages a circular buffer of log entries for firmware diagnostics.
+ * @details Producers may run anywhere, including interrupts; readers run in the main loop.
  */
 class ErrorLog {
 public:
@@ -66,7 +96,7 @@ public:
     ErrorLog();
 
     /**
-     * @brief Adds a log entry to the circular buffer.
+     * @brief Adds a log entry to the circular buffer. Safe from interrupts.
      * @param level The severity level of the entry.
      * @param message The log message (will be truncated if too long).
      */
@@ -74,12 +104,49 @@ public:
 
     /**
      * @brief Adds a formatted log entry to the circular buffer.
+     * @details Formats on the caller's stack, then calls log(); from an interrupt, keep the
+     * format to integers and strings.
      * @param level The severity level of the entry.
      * @param format Printf-style format string.
      * @param ... Format arguments.
      */
     void logf(LogLevel level, const char* format, ...);
 
+    /**
+     * @brief Sets the lowest level kept from now on.
+     * @param level The new runtime level.
+     * @return false if @p level is below ERROR_LOG_MIN_LEVEL (compiled out) or not a level.
+     */
+    bool setLevel(LogLevel level);
+
+    /**
+     * @brief Gets the lowest level kept.
+     * @return The runtime level (ERROR_LOG_DEFAULT_LEVEL after boot).
+     */
+    LogLevel getLevel() const { return m_level; }
+
+    /**
+     * @brief Checks whether entries of a level are kept at the runtime level.
+     * @param level The severity level.
+     * @return true if @p level is at or above getLevel().
+     */
+    bool isEnabled(LogLevel level) const { return level >= m_level; }
+
+    /**
+     * @brief Parses a level name as used by set_log_level.
+     * @param name "debug", "info", "warn", "error" or "crit".
+     * @param[out] level Receives the level.
+     * @return false if @p name is not a level name.
+     */
+    static bool parseLevel(const char* name, LogLevel* level);
+
+    /**
+     * @brief Gets the short name of a level as used in dumps and the SD card log.
+     * @param level The severity level.
+     * @return "DEBUG", "INFO", "WARN", "ERROR", "CRIT" or "???".
+     */
+    static const char* levelName(LogLevel level);
+
     /**
      * @brief Gets the total number of log entries in the buffer.
      * @return The number of valid entries (up to ERROR_LOG_SIZE).
@@ -90,26 +157,63 @@ public:
      * @brief Gets a log entry by index (0 = oldest, getEntryCount()-1 = newest).
      * @param index The index of the entry to retrieve.
      * @param[out] entry Pointer to a LogEntry struct to populate.
-     * @return true if the entry was retrieved successfully, false if index out of range.
+     * @return true if the entry was retrieved successfully, false if index out of range
+     *         or the entry is being written or overwritten.
      */
     bool getEntry(int index, LogEntry* entry) const;
 
+    /**
+     * @brief Gets the sequence number the next entry will get.
+     * @return Entries claimed since boot.
+     */
+    uint32_t getSeq() const;
+
+    /**
+     * @brief Gets the sequence number of the oldest entry still held.
+     * @return Sequence number (equal to getSeq() when the log is empty).
+     */
+    uint32_t getOldestSeq() const;
+
+    /**
+     * @brief Gets a log entry by sequence number, so a reader keeps its place while new
+     * entries push old ones out.
+     * @param seq Sequence number, from getOldestSeq() up to getSeq() - 1.
+     * @param[out] entry Pointer to a LogEntry struct to populate.
+     * @return false if @p seq is no longer held, not yet written, or was overwritten
+     *         while it was copied.
+     */
+    bool getEntryAt(uint32_t seq, LogEntry* entry) const;
+
+    /**
+     * @brief Copies the entries written since the last call to the SD card log, in order.
+     * Called from the SD log task; does nothing without SD_LOG_ENABLED.
+     */
+    void serviceSdLog();
+
     /**
      * @brief Clears all log entries.
      */
     void clear();
 
 private:
-    LogEntry m_buffer[ERROR_LOG_SIZE];  ///< Circular buffer of log entries
-    int m_head;                          ///< Index of next write position
-    int m_count;                         ///< Number of valid entries in buffer
+    LogEntry m_buffer[ERROR_LOG_SIZE];          ///< Circular buffer of log entries
+    volatile uint32_t m_stamp[ERROR_LOG_SIZE];  ///< Sequence + 1 of the entry each slot holds; 0 while it is written
+    volatile uint32_t m_reserved;               ///< Sequence of the next entry (claimed atomically)
+    volatile uint32_t m_floor;                  ///< First sequence still listed (raised by clear())
+    uint32_t m_sdSeq;                           ///< Next sequence to copy to the SD card log
+    LogLevel m_level;                           ///< Lowest level kept
 };
 
 /**
  * @class HeartbeatLog
- * @brief Manages a compact circular buffer for system health heartbeats.
- * @details Uses only 8 bytes per entry (vs 88 for LogEntry) to store 24 hours of data.
- * At 30-second intervals, 2880 entries = 24 hours, using only ~23KB of RAM.
+ * @brief Manages a run-length encoded circular buffer for system health heartbeats.
+ * @details Nearly every heartbeat repeats the one before it ("USB connected, network
+ * active"), so a heartbeat with the same status as the newest run only extends that run.
+ * The log covers the last HEARTBEAT_LOG_SIZE heartbeats (24 hours at 30-second intervals)
+ * in HEARTBEAT_LOG_RUNS 12-byte runs, ~3KB instead of the ~23KB one 8-byte entry per
+ * heartbeat took. Heartbeats are evenly spaced, so getEntry() spreads a run's timestamps
+ * evenly between its first and last. If the status changes more than HEARTBEAT_LOG_RUNS
+ * times in 24 hours, the oldest runs are dropped and the log covers less time.
  */
 class HeartbeatLog {
 public:
@@ -134,24 +238,82 @@ public:
 
     /**
      * @brief Gets a heartbeat entry by index (0 = oldest, getEntryCount()-1 = newest).
+     * @details Reading the entries in order is O(1) per entry; other reads walk the runs.
      * @param index The index of the entry to retrieve.
      * @param[out] entry Pointer to a HeartbeatEntry struct to populate.
      * @return true if the entry was retrieved successfully, false if index out of range.
      */
     bool getEntry(int index, HeartbeatEntry* entry) const;
 
+    /**
+     * @brief Gets the number of runs in use.
+     * @return The number of runs (up to HEARTBEAT_LOG_RUNS).
+     */
+    int getRunCount() const { return m_runCount; }
+
+    /**
+     * @brief Gets the sequence number the next run will get.
+     * @return Runs started since boot (clear() does not reset it).
+     */
+    uint32_t getRunSeq() const { return m_nextRunSeq; }
+
+    /**
+     * @brief Gets the sequence number of the oldest run still held.
+     * @return Sequence number (equal to getRunSeq() when the log is empty).
+     */
+    uint32_t getOldestRunSeq() const { return m_nextRunSeq - (uint32_t)m_runCount; }
+
+    /**
+     * @brief Gets a run by sequence number, so a reader keeps its place while old runs are
+     * dropped. The newest run may still grow after it is read.
+     * @param seq Sequence number, from getOldestRunSeq() up to getRunSeq() - 1.
+     * @param[out] out Pointer to a HeartbeatRun struct to populate.
+     * @return false if @p seq is no longer held or not yet started.
+     */
+    bool getRunAt(uint32_t seq, HeartbeatRun* out) const;
+
     /**
      * @brief Clears all heartbeat entries.
      */
     void clear();
 
 private:
-    HeartbeatEntry m_buffer[HEARTBEAT_LOG_SIZE];  ///< Circular buffer (only 8 bytes per entry!)
-    int m_head;                                    ///< Index of next write position
-    int m_count;                                   ///< Number of valid entries in buffer
+    HeartbeatRun& run(int offset) { return m_runs[(m_firstRun + offset) % HEARTBEAT_LOG_RUNS]; }
+    const HeartbeatRun& run(int offset) const { return m_runs[(m_firstRun + offset) % HEARTBEAT_LOG_RUNS]; }
+    void dropOldest();
+
+    HeartbeatRun m_runs[HEARTBEAT_LOG_RUNS];  ///< Circular buffer of runs
+    int m_firstRun;                            ///< Buffer index of the oldest run
+    int m_runCount;                            ///< Number of runs in use
+    int m_count;                               ///< Number of heartbeats in all runs
+    mutable int m_cursorRun;                   ///< Run offset of the last getEntry() (-1 = none)
+    mutable int m_cursorStart;                 ///< Heartbeat index of that run's first heartbeat
+    uint32_t m_nextRunSeq;                     ///< Sequence number of the next run
 };
 
 // Global log instances
 extern ErrorLog g_errorLog;
 extern HeartbeatLog g_heartbeatLog;
 
+/**
+ * @brief Logs a message to g_errorLog if its level is compiled in and passes the runtime level.
+ * @details The level is tested first, so a filtered call never evaluates @p message, and a
+ * constant level below ERROR_LOG_MIN_LEVEL leaves no code at all.
+ */
+#define ERROR_LOG(level, message) \
+    do { \
+        if ((int)(level) >= (int)ERROR_LOG_MIN_LEVEL && g_errorLog.isEnabled(level)) { \
+            g_errorLog.log((level), (message)); \
+        } \
+    } while (0)
+
+/**
+ * @brief Logs a printf-style message to g_errorLog, with the same level tests as ERROR_LOG().
+ */
+#define ERROR_LOGF(level, ...) \
+    do { \
+        if ((int)(level) >= (int)ERROR_LOG_MIN_LEVEL && g_errorLog.isEnabled(level)) { \
+            g_errorLog.logf((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
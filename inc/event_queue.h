@@ -0,0 +1,123 @@
+/**
+ * @file event_queue.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the queue of typed status events.
+ *
+ * @details A status message from the control path used to be snprintf'd into a stack
+ * buffer, float arguments through newlib's software-double %f, before it was copied into
+ * the TX queue. A typed event is a 24-byte EventRecord instead: a StatusEventId, the
+ * request ID and up to three numeric arguments, posted with interrupts masked for a few
+ * stores, so the control tick and the receive ISRs can post too. Pressboi::serviceEvents()
+ * drains the queue into the TX arena: text clients get the message rendered from the ID's
+ * template with the integer-only appenders of text_format.h; a host that asked for
+ * EVENT=BIN1 gets the record itself as "PRESSBOI_EVENTB: <base64>" and renders it from
+ * definition/status_events.json. The IDs and the templates the firmware renders
+ * (status_event_ids.h / .cpp) are generated from that file by
+ * definition/generate_status_events.py, so both ends always format a record alike.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "status_event_ids.h"
+
+/**
+ * @union EventArg
+ * @brief One event argument; the template of the event says which member it is.
+ */
+union EventArg {
+    int32_t i;              ///< Integer argument ("{n}")
+    float f;                ///< Float argument ("{n:.Nf}")
+};
+
+/**
+ * @brief Makes a float event argument.
+ */
+inline EventArg eventArgF(float value) {
+    EventArg arg;
+    arg.f = value;
+    return arg;
+}
+
+/**
+ * @brief Makes an integer event argument.
+ */
+inline EventArg eventArgI(int32_t value) {
+    EventArg arg;
+    arg.i = value;
+    return arg;
+}
+
+/**
+ * @struct EventRecord
+ * @brief One typed event as queued and as sent on the wire (24 bytes, little endian).
+ */
+struct EventRecord {
+    uint8_t id;                         ///< StatusEventId
+    uint8_t reserved;                   ///< Zero
+    uint16_t seq;                       ///< Post counter, wraps (gaps mean dropped events)
+    uint32_t request_id;                ///< Request ID the event answers (0 = none)
+    uint32_t time_us;                   ///< Microseconds() when posted
+    EventArg args[EVENT_RECORD_MAX_ARGS]; ///< Arguments, unused ones zero
+};
+
+/**
+ * @class EventQueue
+ * @brief Ring of posted EventRecords. post() from any context; the rest main loop only.
+ */
+class EventQueue {
+public:
+    /**
+     * @brief Constructs an empty queue.
+     */
+    EventQueue();
+
+    /**
+     * @brief Queues an event.
+     * @param id Event
+     * @param request_id Request ID the event answers (0 = none)
+     * @param arg0 First argument
+     * @param arg1 Second argument
+     * @param arg2 Third argument
+     * @return false if the queue was full (the event is counted as dropped)
+     */
+    bool post(StatusEventId id, uint32_t request_id, EventArg arg0 = eventArgI(0),
+              EventArg arg1 = eventArgI(0), EventArg arg2 = eventArgI(0));
+
+    /**
+     * @brief Gets the oldest queued event without removing it.
+     * @return The record, or NULL if the queue is empty
+     */
+    const EventRecord* peek() const;
+
+    /**
+     * @brief Removes the event peek() returned.
+     */
+    void consume();
+
+    /**
+     * @brief Gets the number of events lost to a full queue.
+     * @return Dropped event count since boot
+     */
+    uint32_t getDropped() const { return m_dropped; }
+
+    /**
+     * @brief Renders an event as the status line a text client gets.
+     * @param rec Event
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Text length ("PRESSBOI_INFO: #12 Force limit (...) reached.")
+     */
+    static size_t formatText(const EventRecord& rec, char* buffer, size_t size);
+
+private:
+    EventRecord m_records[EVENT_QUEUE_SIZE];  ///< Ring storage
+    volatile uint16_t m_head;                 ///< Next slot post() writes
+    volatile uint16_t m_tail;                 ///< Oldest queued slot
+    uint16_t m_seq;                           ///< Next EventRecord::seq
+    volatile uint32_t m_dropped;              ///< Events lost to a full queue
+};
+
+extern EventQueue g_eventQueue;
@@ -29,6 +29,8 @@
 #define STATUS_PREFIX_ERROR                 "PRESSBOI_ERROR: "         ///< Prefix for messages indicating an error or fault.
 #define STATUS_PREFIX_RECOVERY              "PRESSBOI_RECOVERY: "      ///< Prefix for watchdog recovery notifications.
 #define STATUS_PREFIX_DISCOVERY             "DISCOVERY_RESPONSE: "     ///< Prefix for the device discovery response.
+#define STATUS_PREFIX_ANNOUNCE              "DISCOVERY_ANNOUNCE: "     ///< Prefix for the periodic broadcast announcement.
+#define STATUS_PREFIX_ACK                   "PRESSBOI_ACK: "           ///< Prefix for the receipt of a network command carrying a request ID.
 /** @} */
 
 /**
@@ -37,6 +39,8 @@
  * @{
  */
 #define TELEM_PREFIX                        "PRESSBOI_TELEM: "         ///< Prefix for all telemetry messages.
+#define TELEM_BINARY_PREFIX                 "PRESSBOI_TELEMB: "        ///< Prefix for base64 binary telemetry frames (TELEM=BIN1).
+#define TELEM_COMMS_PREFIX                  "PRESSBOI_COMMS: "         ///< Prefix for the low-rate queue and link counters (every COMMS_STATS_INTERVAL_MS).
 /** @} */
 
 /**
@@ -45,6 +49,7 @@
  * @{
  */
 #define EVENT_PREFIX                        "PRESSBOI_EVENT: "         ///< Prefix for all event messages.
+#define EVENT_BINARY_PREFIX                 "PRESSBOI_EVENTB: "        ///< Prefix for base64 typed event records (EVENT=BIN1, see event_queue.h).
 /** @} */
 
 //==================================================================================================
@@ -72,7 +77,7 @@
 typedef enum {
     EVENT_UNKNOWN,                        ///< Represents an unrecognized or invalid event.
 
-    EVENT_SCRIPT_HOLD                                    ///< @see EVENT_STR_SCRIPT_HOLD
+    EVENT_SCRIPT_HOLD = 1                                ///< @see EVENT_STR_SCRIPT_HOLD
 } Event;
 
 //==================================================================================================
@@ -0,0 +1,148 @@
+/**
+ * @file force_replay.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the force-versus-position profile that can stand in for load cell A.
+ *
+ * @details While replay runs, ForceSensor channel A takes its samples from a stored profile
+ * instead of COM-0: every FORCE_REPLAY_RATE_HZ period the receive path looks up the raw ADC
+ * value at the commanded axis position (PositionRefCommanded() relative to machine home,
+ * the same position PressCapture records) and pushes it through pushSample() exactly as a
+ * decoded frame. Force limits, the receive-ISR trip, joule integration, seat detection and
+ * the press capture then run on a real captured press curve with repeatable results,
+ * without a load cell or a part. The profile comes from the last press capture or from
+ * 'mm raw' pairs sent by the host, and holds the loading stroke only: points that do not
+ * advance past the previous one are skipped.
+ *
+ * The lookup and pacing use no ClearCore symbols, so the class also builds on a PC
+ * (PRESSBOI_HOST) to drive the same code paths from unit tests and benchmarks. Firmware
+ * built without FORCE_REPLAY_ENABLED leaves g_forceReplay and its profile out of RAM.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief Returns the commanded axis position relative to machine home.
+ * @param context Opaque pointer supplied to ForceReplay::setPositionSource()
+ * @return Position (steps)
+ */
+typedef int32_t (*ForceReplayPositionFn)(void* context);
+
+/**
+ * @class ForceReplay
+ * @brief Piecewise-linear raw ADC profile over axis position, plus the sample pacing.
+ *
+ * @details The profile may only be changed while replay is stopped; poll() runs in the
+ * control tick.
+ */
+class ForceReplay {
+public:
+    /**
+     * @brief Constructs an empty, stopped replay.
+     */
+    ForceReplay();
+
+    /**
+     * @brief Stops replay and discards the profile.
+     */
+    void clear();
+
+    /**
+     * @brief Appends a profile point. Ignored while replay runs.
+     * @param position_steps Axis position relative to machine home (steps)
+     * @param raw Raw tared ADC value at that position
+     * @return false if the profile is full; a point not past the previous one is skipped
+     */
+    bool append(int32_t position_steps, int32_t raw);
+
+    /**
+     * @brief PressCapture visitor that appends each captured sample.
+     * @param context ForceReplay to append to
+     */
+    static void captureVisitor(void* context, int32_t position_steps, int32_t raw);
+
+    /**
+     * @brief Sets where poll() reads the commanded position.
+     * @param fn Position callback (called from the control tick)
+     * @param context Argument for @p fn
+     */
+    void setPositionSource(ForceReplayPositionFn fn, void* context);
+
+    /**
+     * @brief Starts injecting samples.
+     * @param now_us Microseconds(); the first sample is due one period later
+     * @return false without a position source or at least two profile points
+     */
+    bool start(uint32_t now_us);
+
+    /**
+     * @brief Stops injecting samples; the profile is kept.
+     */
+    void stop();
+
+    /**
+     * @brief Produces the next sample when one is due.
+     * @param now_us Microseconds()
+     * @param raw Receives the raw ADC value at the commanded position
+     * @return true if a sample is due and @p raw was set
+     */
+    bool poll(uint32_t now_us, int32_t* raw);
+
+    /**
+     * @brief Interpolates the profile, holding the end values outside it.
+     * @param position_steps Axis position relative to machine home (steps)
+     * @return Raw ADC value (0 with an empty profile)
+     */
+    int32_t rawAt(int32_t position_steps) const;
+
+    /**
+     * @brief Checks whether samples are being injected.
+     * @return true between start() and stop()
+     */
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief Gets the number of profile points.
+     * @return Points
+     */
+    uint16_t getCount() const { return m_count; }
+
+    /**
+     * @brief Gets the number of points skipped for not advancing or not fitting.
+     * @return Skipped points since clear()
+     */
+    uint32_t getSkipped() const { return m_skipped; }
+
+    /**
+     * @brief Gets the number of samples injected since start().
+     * @return Samples
+     */
+    uint32_t getSamples() const { return m_samples; }
+
+    /**
+     * @brief Gets the first profile position.
+     * @return Position (steps), 0 with an empty profile
+     */
+    int32_t getFirstPosition() const { return (m_count > 0) ? m_positions[0] : 0; }
+
+    /**
+     * @brief Gets the last profile position.
+     * @return Position (steps), 0 with an empty profile
+     */
+    int32_t getLastPosition() const { return (m_count > 0) ? m_positions[m_count - 1] : 0; }
+
+private:
+    int32_t m_positions[FORCE_REPLAY_MAX_POINTS];   ///< Strictly increasing positions (steps)
+    int32_t m_raws[FORCE_REPLAY_MAX_POINTS];        ///< Raw ADC value at each position
+    uint16_t m_count;                               ///< Profile points
+    uint32_t m_skipped;                             ///< Points skipped since clear()
+    ForceReplayPositionFn m_positionFn;             ///< Commanded position source
+    void* m_positionContext;                        ///< Argument for m_positionFn
+    uint32_t m_nextSampleUs;                        ///< When the next sample is due
+    volatile uint32_t m_samples;                    ///< Samples injected since start()
+    volatile bool m_active;                         ///< Injecting samples
+};
+
+extern ForceReplay g_forceReplay;
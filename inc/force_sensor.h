@@ -4,8 +4,14 @@
  * @date November 3, 2025
  * @brief Defines the force sensor interface for reading HX711 data via Rugeduino.
  *
- * @details This class manages communication with a Rugeduino (Arduino Uno) connected to COM-0.
- * The Rugeduino reads the HX711 load cell amplifier and sends force readings via serial.
+ * @details This class manages communication with a Rugeduino (Arduino Uno) connected to COM-0 (or COM-1 for a second load cell).
+ * The Rugeduino reads the HX711 load cell amplifier and sends force readings via serial, either
+ * as ASCII lines or as fixed-size binary frames (sync, sequence, 24-bit sample, CRC8). Dual-channel
+ * frames carry a low-latency sample plus a sample decimated on the transducer; the fast channel
+ * feeds limit detection and the sample FIFO, the filtered channel feeds telemetry and calibration.
+ * The COM port is drained from the control tick interrupt (control_tick.h) into a timestamped sample FIFO so that long
+ * main-loop passes do not overflow the SERCOM receive buffer, and so that consumers can
+ * process every sample rather than only the latest value.
  */
 #pragma once
 
@@ -13,10 +19,59 @@
 #include "ClearCore.h"
 #include "SerialDriver.h"
 
+/**
+ * @struct ForceSample
+ * @brief One decoded transducer sample as captured by the COM-0 receive path.
+ */
+struct ForceSample {
+    uint64_t timestamp_us;  ///< MonotonicUs() when the frame/line completed
+    int32_t raw;            ///< Raw tared ADC value from the HX711 (fast channel)
+    int32_t counts;         ///< Filtered counts, sign-normalised so larger always means more force
+    float kg;               ///< Calibrated force at capture time (kg, fast channel)
+};
+
+/**
+ * @struct ForceSensorHealth
+ * @brief Receive-path health of one load cell, for telemetry and the error log.
+ * @details Rate and jitter cover the last complete FORCE_HEALTH_WINDOW_MS window; a
+ * sensor that has gone quiet for longer than a window reads 0 Hz. Counters run from boot.
+ */
+struct ForceSensorHealth {
+    float rate_hz;              ///< Samples per second
+    uint32_t jitter_us;         ///< Standard deviation of the time between samples
+    uint32_t max_gap_us;        ///< Longest time between samples in the window (or since the last one, once stale)
+    uint32_t parse_errors;      ///< ASCII lines voided by characters other than a number
+    uint32_t line_overflows;    ///< ASCII lines voided for running past 9 digits
+    uint32_t uart_overflows;    ///< Receive overruns and framing errors the COM port reported
+    uint32_t crc_errors;        ///< Binary frames with a bad CRC
+    uint32_t dropped_samples;   ///< Binary frames missing from the sequence
+    uint32_t ring_overruns;     ///< Samples lost to a full sample ring
+    uint32_t stuck_events;      ///< Times the raw value froze for FORCE_HEALTH_STUCK_SAMPLES samples
+    bool stuck;                 ///< The raw value is frozen now
+    uint32_t link_baud;         ///< COM port baud (115200 until the handshake raises it)
+    uint8_t link_rate_hz;       ///< Sample rate the transducer reported (0 = no handshake)
+};
+
+/**
+ * @brief Callback invoked from the receive ISR when an armed force trip fires.
+ * @param context Opaque pointer supplied to ForceSensor::armTrip()
+ */
+typedef void (*ForceTripHook)(void* context);
+
+/**
+ * @enum ForceChannelSelect
+ * @brief Which load cell(s) MotorController's force checks use.
+ */
+enum ForceChannelSelect {
+    FORCE_CHANNEL_A = 0,    ///< COM-0 load cell only
+    FORCE_CHANNEL_B = 1,    ///< COM-1 load cell only
+    FORCE_CHANNEL_SUM = 2   ///< A + B (two-cell fixtures, one cell per motor side)
+};
+
 /**
  * @class ForceSensor
- * @brief Manages force readings from HX711 via Rugeduino on COM-0.
- * 
+ * @brief Manages force readings from HX711 via Rugeduino on COM-0 or COM-1.
+ *
  * @details Communicates with Rugeduino (Arduino Uno) over UART (TTL mode) to receive
  * force readings from an HX711 load cell amplifier.
  */
@@ -24,82 +79,570 @@ class ForceSensor {
 public:
     /**
      * @brief Constructs a new ForceSensor object.
+     * @param channel 0 = COM-0 (original calibration slots), 1 = COM-1 (channel B slots)
      */
-    ForceSensor();
+    explicit ForceSensor(uint8_t channel = 0);
 
     /**
      * @brief Initializes the serial port for communication with Rugeduino.
-     * @details Configures COM-0 in TTL mode at 115200 baud.
+     * @details Configures the channel's COM port in TTL mode at 115200 baud (serviceLink()
+     * may negotiate a faster one) and starts the control tick. Returns without waiting for the port to settle: serviceRx() discards
+     * what arrives in the first FORCE_SENSOR_SETTLE_MS instead. Filter, latency and
+     * linearization settings are only persisted for channel 0; other channels keep the
+     * config.h defaults unless set at runtime.
      */
     void setup();
 
     /**
-     * @brief Updates force reading by parsing incoming serial data.
-     * @details Call this repeatedly in the main loop to process incoming data.
+     * @brief Gets the channel this sensor reads.
+     * @return 0 for COM-0, 1 for COM-1
+     */
+    uint8_t getChannel() const { return m_channel; }
+
+    /**
+     * @brief Discards every queued sample without copying it.
+     */
+    void flushSamples() { m_ring_tail = m_ring_head; }
+
+    /**
+     * @brief Polls the COM port when the receive interrupt is disabled.
+     * @details Call this repeatedly in the main loop. With FORCE_SENSOR_RX_ISR_ENABLED
+     * samples are captured in the background and this is a no-op.
      */
     void update();
 
+    /**
+     * @brief Drains every sample captured since the previous call, oldest first.
+     * @param out Destination array
+     * @param max_samples Capacity of @p out
+     * @return Number of samples written to @p out
+     */
+    uint16_t drainSamples(ForceSample* out, uint16_t max_samples);
+
+    /**
+     * @brief Drains the COM port and decodes complete frames into the sample ring.
+     * @details Called from the control tick interrupt (or from update() when
+     * FORCE_SENSOR_RX_ISR_ENABLED is false). Not for general use.
+     */
+    void serviceRx();
+
+    /**
+     * @brief Feeds bytes through the same frame and ASCII decoders serviceRx() uses.
+     * @details For the benchmark suite; decoded samples land in the sample ring as usual.
+     * @param data Bytes as they would arrive on the COM port
+     * @param length Number of bytes
+     */
+    void decodeBytes(const uint8_t* data, size_t length);
+
     /**
      * @brief Gets the most recent force reading.
      * @return Force in kilograms (kg)
      */
     float getForce() const { return m_force_kg; }
-    
+
+    /**
+     * @brief Gets the most recent force reading as sign-normalised counts.
+     * @return Counts comparable with kgToCounts()
+     */
+    int32_t getForceCounts() const { return m_force_counts; }
+
     /**
      * @brief Gets the raw ADC value from the HX711.
      * @return Raw 24-bit value
      */
     long getRawValue() const { return m_raw_value; }
-    
+
+    /**
+     * @brief Gets the most recent transducer-filtered force reading.
+     * @return Force in kg; equals getForce() when the transducer sends single-channel data
+     */
+    float getFilteredForce() const { return m_filtered_kg; }
+
+    /**
+     * @brief Gets the most recent transducer-filtered raw ADC value.
+     * @return Raw 24-bit value; equals getRawValue() for single-channel data
+     */
+    long getFilteredRawValue() const { return m_filtered_raw; }
+
+    /**
+     * @brief Gets the acquisition time of the most recent reading.
+     * @return Microseconds() timestamp captured when the sample arrived (the low word of
+     *         ForceSample::timestamp_us)
+     */
+    uint32_t getLastSampleTimeUs() const { return m_last_sample_time_us; }
+
     /**
      * @brief Checks if sensor is receiving data.
      * @return true if data received in last second
      */
     bool isConnected() const;
-    
+
+    /**
+     * @brief Gets the receive-path health: sample rate, jitter, error counters and stuck value.
+     * @param out Filled with a consistent snapshot (taken with the receive interrupt masked)
+     */
+    void getHealth(ForceSensorHealth* out) const;
+
+    /**
+     * @brief Gets the sum of every receive error counter in ForceSensorHealth.
+     * @return Parse, overflow, CRC, dropped and ring errors since boot
+     */
+    uint32_t getErrorCount() const;
+
+    /**
+     * @brief Checks if the port has settled since setup().
+     * @return true once FORCE_SENSOR_SETTLE_MS have passed and samples are decoded
+     */
+    bool isSettled() const { return !m_settling; }
+
     /**
      * @brief Sends tare command to Rugeduino to zero the scale.
      */
     void tare();
-    
+
     /**
      * @brief Set force sensor offset (kg) and save to NVM.
+     * @details Clears the zero-tracking trim; fold getZeroTrim() into @p offset_kg to keep it.
      * @param offset_kg Offset in kilograms to add to all readings
      */
     void setOffset(float offset_kg);
-    
+
+    /**
+     * @brief Advances automatic zero tracking. Main loop only, once per pass.
+     * @details While @p allowed, samples are taken once FORCE_ZERO_TRACK_SETTLE_MS have
+     * passed and averaged in batches of FORCE_ZERO_TRACK_SAMPLES filtered-channel readings.
+     * A quiet batch near zero moves the RAM trim by FORCE_ZERO_TRACK_GAIN of its average,
+     * up to FORCE_ZERO_TRACK_LIMIT_KG in total. The stored offset is never written.
+     * @param allowed The press is retracted and idle, so the cell should read zero
+     * @return true when a correction first reaches the trim limit
+     */
+    bool trackZero(bool allowed);
+
+    /**
+     * @brief Advances the baud and sample-rate handshake with the transducer. Main loop only.
+     * @details Link-control frames (FORCE_LINK_FRAME_SYNC) ask the transducer for its
+     * supported bauds and sample rates, then switch up one baud at a time, keeping each only
+     * after FORCE_LINK_PROBATION_MS without a frame error. FORCE_LINK_MAX_ERRORS errors in a
+     * health window step the baud down again and cap it there. A transducer that does not
+     * answer stays at 115200 baud and is asked again every FORCE_LINK_RETRY_MS. A lost
+     * switch drops back to the default baud and waits out the transducer's revert timer.
+     * Switches briefly interrupt the samples, so they only start while @p allowed.
+     * @param allowed The press is idle, so the samples may pause for a switch
+     * @return true when the baud or sample rate changed
+     */
+    bool serviceLink(bool allowed);
+
+    /**
+     * @brief Get the zero-tracking trim added on top of the offset.
+     * @return Trim in kilograms (0 after setup() and setOffset())
+     */
+    float getZeroTrim() const { return m_zero_trim_kg; }
+
     /**
      * @brief Set force sensor scale factor and save to NVM.
      * @param scale Multiplicative scale factor (default 1.0)
      */
     void setScale(float scale);
-    
+
     /**
      * @brief Get current offset value.
      * @return Offset in kilograms
      */
     float getOffset() const { return m_offset_kg; }
-    
+
     /**
      * @brief Get current scale value.
      * @return Scale factor
      */
     float getScale() const { return m_scale; }
 
+    /**
+     * @brief Configure the limit-path filter and save to NVM.
+     * @details A median spike rejector runs first, then a single-pole IIR. Applies to the
+     * fast channel (sample FIFO, force trip, getForce()); raw values stay unfiltered.
+     * @param median_window Median window in samples (1 = off, 3 or 5)
+     * @param alpha IIR factor in [FORCE_FILTER_ALPHA_MIN, 1.0] (1.0 = off)
+     * @return true if the parameters were valid and applied
+     */
+    bool setFilter(uint8_t median_window, float alpha);
+
+    /**
+     * @brief Get current median window.
+     * @return Window in samples (1 = off)
+     */
+    uint8_t getFilterMedian() const { return m_filter_median; }
+
+    /**
+     * @brief Get current IIR factor.
+     * @return Alpha (1.0 = off)
+     */
+    float getFilterAlpha() const { return m_filter_alpha; }
+
+    /**
+     * @brief Set the delay from force acquisition to sample arrival and save to NVM.
+     * @details Subtract from ForceSample::timestamp_us to get the acquisition time.
+     * @param latency_us Latency in microseconds (0 to FORCE_LATENCY_US_MAX)
+     * @return true if the value was in range and applied
+     */
+    bool setLatencyUs(uint32_t latency_us);
+
+    /**
+     * @brief Get the force acquisition latency.
+     * @return Latency in microseconds
+     */
+    uint32_t getLatencyUs() const { return m_latency_us; }
+
+    /**
+     * @brief Replaces scale+offset with a piecewise-linear table and stages it for NVM.
+     * @details Points must have strictly increasing raw values and monotonic kg values.
+     * The offset (set_force_zero) is still added on top; the scale is ignored while a
+     * table is loaded. Readings outside the table extrapolate along the end segments.
+     * The table takes effect at once; commitLinearization() writes it from the idle flash job.
+     * @param raw Raw ADC value of each point
+     * @param kg Force at each point
+     * @param count Number of points (2 to FORCE_TABLE_MAX_POINTS, or 0 to clear the table)
+     * @return true if the table was valid and applied
+     */
+    bool setLinearization(const int32_t* raw, const float* kg, uint8_t count);
+
+    /**
+     * @brief Checks for a table set since the last NVM write.
+     * @return true if commitLinearization() has work
+     */
+    bool isLinearizationPending() const { return m_lin_nvm_pending; }
+
+    /**
+     * @brief Writes the staged table to NVM: one block write of the points, then the count.
+     * @return false if a write was refused (the table stays staged)
+     */
+    bool commitLinearization();
+
+    /**
+     * @brief Erases the stored table so the next boot uses scale+offset, and drops a staged one.
+     */
+    void eraseLinearization();
+
+    /**
+     * @brief Get number of points in the linearization table.
+     * @return Point count (0 = linear scale+offset in use)
+     */
+    uint8_t getLinearizationCount() const { return m_lin_count; }
+
+    /**
+     * @brief Get one point of the linearization table.
+     * @param index Point index (0 to getLinearizationCount() - 1)
+     * @param raw Receives the raw ADC value
+     * @param kg Receives the force in kg
+     * @return false if @p index is out of range
+     */
+    bool getLinearizationPoint(uint8_t index, int32_t* raw, float* kg) const;
+
+    /**
+     * @brief Converts a force to the equivalent sign-normalised count threshold.
+     * @details Compare against ForceSample::counts with a single integer >=. The result is
+     * only valid for the calibration in effect when it was computed.
+     * @param kg Force in kilograms
+     * @return Smallest normalised count whose calibrated force is >= @p kg
+     */
+    int32_t kgToCounts(float kg) const;
+
+    /**
+     * @brief Get number of binary frames lost, inferred from sequence counter gaps.
+     * @return Dropped sample count since boot
+     */
+    uint32_t getDroppedSamples() const { return m_dropped_samples; }
+
+    /**
+     * @brief Get number of binary frames rejected for a bad CRC.
+     * @return CRC error count since boot
+     */
+    uint32_t getCrcErrors() const { return m_crc_errors; }
+
+    /**
+     * @brief Get number of decoded samples discarded because the sample ring was full.
+     * @return Ring overrun count since boot
+     */
+    uint32_t getRingOverruns() const { return m_ring_overruns; }
+
+    /**
+     * @brief Arms the sample-exact force trip.
+     * @details The first decoded sample at or above @p limit_counts disarms the trip, latches
+     * the sample force and calls @p hook from interrupt context. The hook must be short
+     * and ISR-safe (e.g. MoveStopDecel on the motors).
+     * With FORCE_TRIP_PREDICT_ENABLED and a non-zero @p lead_us, a sample at or above
+     * @p predict_counts also fires when the force rate extrapolated over @p lead_us reaches
+     * the limit.
+     * @param limit_counts Force limit as returned by kgToCounts()
+     * @param hook Function to call when the limit is crossed
+     * @param context Passed through to @p hook
+     * @param lead_us Time from acquisition to standstill the rate is extrapolated over (0 = exact trip only)
+     * @param predict_counts Counts (kgToCounts()) from which the prediction runs
+     */
+    void armTrip(int32_t limit_counts, ForceTripHook hook, void* context,
+                 uint32_t lead_us = 0, int32_t predict_counts = INT32_MAX);
+
+    /**
+     * @brief Moves the limit of an armed trip, keeping its force rate estimate.
+     * @details For a limit that changes during the move. Each count is a single store, so
+     * it is safe from the control tick; does nothing once the trip has fired.
+     * @param limit_counts New force limit (kgToCounts())
+     * @param predict_counts New counts from which the prediction runs
+     */
+    void setTripLimit(int32_t limit_counts, int32_t predict_counts = INT32_MAX);
+
+    /**
+     * @brief Disarms the force trip and clears any latched trip.
+     */
+    void disarmTrip();
+
+    /**
+     * @brief Checks whether the armed force trip has fired.
+     * @return true if a sample crossed the limit since armTrip()
+     */
+    bool tripFired() const { return m_trip_fired; }
+
+    /**
+     * @brief Gets the force of the sample that fired the trip.
+     * @return Force in kg (valid when tripFired() is true)
+     */
+    float getTripForce() const { return m_trip_force_kg; }
+
+    /**
+     * @brief Checks whether the trip fired on the extrapolated rather than the measured force.
+     * @return true if the latched trip was predictive (valid when tripFired() is true)
+     */
+    bool tripPredicted() const { return m_trip_predicted; }
+
+    /**
+     * @brief Gets the time from the arrival of the sample that fired the trip until the hook returned.
+     * @return Microseconds (valid when tripFired() is true)
+     */
+    uint32_t getTripLatencyUs() const { return m_trip_latency_us; }
+
 private:
     /**
-     * @brief Parses incoming serial data from Rugeduino.
+     * @brief Feeds one received byte through the ASCII line decoder.
+     * @param c Byte read from the COM port
      */
-    void parseSerialData();
+    void decodeAsciiByte(uint8_t c);
 
-    float m_force_kg;              ///< Current force reading in kg
-    long m_raw_value;              ///< Raw ADC value from HX711
-    uint32_t m_last_reading_time;  ///< Timestamp of last valid reading
-    char m_serial_buffer[64];      ///< Buffer for incoming serial data
-    uint8_t m_buffer_index;        ///< Current position in serial buffer
+    /**
+     * @brief Feeds one received byte through the binary frame decoder.
+     * @param c Byte read from the COM port
+     * @return true if the byte was consumed by the binary decoder
+     */
+    bool decodeFrameByte(uint8_t c);
+
+    /**
+     * @brief Calibrates a decoded sample, publishes it as the latest reading and queues it.
+     * @param raw_adc Raw tared ADC value from the HX711 (fast channel)
+     * @param filtered_raw Transducer-filtered raw value (same as @p raw_adc for single-channel data)
+     */
+    void pushSample(int32_t raw_adc, int32_t filtered_raw);
+
+    /**
+     * @brief Adds a sample's arrival to the rate and jitter window and the stuck-value check.
+     * @param now_us MonotonicUs() of the sample
+     * @param raw_adc Raw value of the sample
+     */
+    void recordHealth(uint64_t now_us, int32_t raw_adc);
+
+    /**
+     * @brief Runs a fast-channel sample through the median and IIR stages.
+     * @param raw_adc Unfiltered raw ADC value
+     * @return Filtered value in raw counts
+     */
+    int32_t filterSample(int32_t raw_adc);
+
+    /**
+     * @brief Sends one link-control frame to the transducer.
+     * @param type Link frame type (kLinkFrame* in force_sensor.cpp)
+     * @param p0 First parameter byte
+     * @param p1 Second parameter byte
+     */
+    void sendLinkFrame(uint8_t type, uint8_t p0 = 0, uint8_t p1 = 0);
+
+    /**
+     * @brief Asks the transducer to change baud and sample rate (LINK_SWITCH).
+     * @param baud Index into the link baud table
+     * @param rate Index into the link rate table
+     */
+    void requestLinkSwitch(uint8_t baud, uint8_t rate);
+
+    /**
+     * @brief Reprograms the COM port and discards input for FORCE_SENSOR_SETTLE_MS.
+     * @param baud Index into the link baud table
+     */
+    void setLinkBaud(uint8_t baud);
+
+    /**
+     * @brief CRC, UART and sequence errors since boot (what the link is judged by).
+     */
+    uint32_t linkErrorCount() const { return m_crc_errors + m_uart_overflows + m_dropped_samples; }
+
+    /**
+     * @brief Applies the calibration to a raw count value.
+     * @param raw Raw (or filtered) ADC counts
+     * @return Force in kg
+     */
+    float countsToKg(int32_t raw) const;
+
+    /**
+     * @brief Applies the calibration in integer micrograms.
+     * @param raw Raw (or filtered) ADC counts
+     * @return Force in micrograms, offset included
+     */
+    int64_t countsToUg(int32_t raw) const;
+
+    /**
+     * @brief Recomputes the integer calibration from m_scale/m_offset_kg.
+     * @details Masks the receive interrupt while the 64-bit offset is written.
+     */
+    void updateFixedCalibration();
+
+    /**
+     * @brief Validates a linearization table and swaps it in with the receive interrupt masked.
+     * @return false if the points are not usable (table left unchanged)
+     */
+    bool applyLinearization(const int32_t* raw, const float* kg, uint8_t count);
+
+    uint8_t m_channel;             ///< 0 = COM-0, 1 = COM-1
+    SerialDriver* m_port;          ///< UART the transducer is wired to
+    volatile float m_force_kg;     ///< Current force reading in kg
+    volatile int32_t m_force_counts; ///< Current force reading in normalised counts
+    volatile long m_raw_value;     ///< Raw ADC value from HX711
+    volatile float m_filtered_kg;  ///< Latest filtered-channel force in kg
+    volatile long m_filtered_raw;  ///< Latest filtered-channel raw ADC value
+    uint64_t m_last_reading_us;    ///< MonotonicUs() of the last valid reading (written by the receive ISR)
+    volatile bool m_settling;      ///< Discarding input until FORCE_SENSOR_SETTLE_MS after setup()
+    uint32_t m_setup_time;         ///< Milliseconds() when setup() opened the port
+    volatile uint32_t m_last_sample_time_us; ///< Acquisition timestamp of last valid reading (us)
     float m_offset_kg;             ///< Calibration offset in kg (loaded from NVM)
     float m_scale;                 ///< Calibration scale factor (loaded from NVM)
-    
-    void loadCalibrationFromNVM(); ///< Load calibration from non-volatile memory
-};
+    int32_t m_scale_ug;            ///< |scale| pre-converted to micrograms per count
+    int64_t m_offset_ug;           ///< Offset pre-converted to micrograms
+    int32_t m_count_sign;          ///< Sign of the scale (+1/-1); counts * sign grows with force
+
+    // Piecewise-linear calibration (replaces scale when m_lin_count >= 2)
+    uint8_t m_lin_count;           ///< Points in the table (0 = off)
+    int32_t m_lin_sign;            ///< +1 if kg rises with raw across the table, -1 if it falls
+    int32_t m_lin_step;            ///< Raw spacing when uniform (O(1) lookup), 0 = binary search
+    int32_t m_lin_raw[FORCE_TABLE_MAX_POINTS];      ///< Raw ADC value of each point
+    float m_lin_kg[FORCE_TABLE_MAX_POINTS];         ///< Force at each point (as uploaded)
+    int64_t m_lin_ug[FORCE_TABLE_MAX_POINTS];       ///< Force at each point in micrograms
+    int64_t m_lin_slope_q16[FORCE_TABLE_MAX_POINTS]; ///< Segment slope, micrograms per count in Q16.16
+    int32_t m_lin_nvm[FORCE_TABLE_MAX_POINTS * 2];  ///< Staged NVM image: raw, kg bits per point
+    uint8_t m_lin_nvm_count;       ///< Points in m_lin_nvm
+    bool m_lin_nvm_pending;        ///< m_lin_nvm not written to NVM yet
 
+    // Receive-path decoder state (owned by serviceRx)
+    int32_t m_ascii_value;         ///< ASCII digits accumulated for the current line
+    bool m_ascii_negative;         ///< Current ASCII line started with '-'
+    uint8_t m_ascii_digits;        ///< Digits seen on current ASCII line (0 = none yet)
+    bool m_ascii_done;             ///< Non-digit seen after digits; ignore rest of line
+    uint8_t m_frame[FORCE_SENSOR_FRAME_LENGTH_DUAL]; ///< Binary frame being assembled
+    uint8_t m_frame_index;         ///< Bytes received for current binary frame (0 = hunting for sync)
+    uint8_t m_frame_length;        ///< Expected length of the frame being assembled (set by sync byte)
+    uint8_t m_last_seq;            ///< Sequence number of last valid binary frame
+    bool m_seq_valid;              ///< True once a valid binary frame has set m_last_seq
+    volatile uint32_t m_dropped_samples; ///< Frames missed according to sequence gaps
+    volatile uint32_t m_crc_errors;      ///< Frames rejected for CRC mismatch
+    volatile uint32_t m_ring_overruns;   ///< Samples lost because the ring was full
+    volatile uint32_t m_parse_errors;    ///< ASCII lines voided by garbage before the number
+    volatile uint32_t m_line_overflows;  ///< ASCII lines voided for too many digits
+    volatile uint32_t m_uart_overflows;  ///< Overrun/framing errors from the COM port
+    volatile uint32_t m_sample_count;    ///< Samples decoded since boot
+    volatile uint8_t m_link_reply[FORCE_LINK_FRAME_LENGTH]; ///< Last link-control frame from the transducer
+    volatile uint8_t m_link_replies;     ///< Link-control frames received (m_link_reply is written first)
+
+    /**
+     * @enum LinkState
+     * @brief Step of the handshake serviceLink() is in.
+     */
+    enum LinkState {
+        LINK_START,         ///< Waiting for the port to settle before the first query
+        LINK_QUERY,         ///< Query sent, waiting for the capabilities
+        LINK_FIXED,         ///< No answer: fixed-rate transducer at 115200 baud
+        LINK_SWITCH,        ///< Switch requested, waiting for the acknowledgement
+        LINK_PROBATION,     ///< Running a new setting until it has proved error-free
+        LINK_STEADY,        ///< Running a proven setting
+        LINK_REVERT         ///< Back at 115200, waiting out the transducer's revert timer
+    };
+
+    // Link handshake (main loop only)
+    uint8_t m_link_state;          ///< LinkState
+    uint32_t m_link_since;         ///< Milliseconds() the current step (or window) started
+    uint32_t m_link_sent_ms;       ///< Milliseconds() of the last frame sent
+    uint8_t m_link_attempts;       ///< Frames sent in the current step
+    uint8_t m_link_seen;           ///< m_link_replies already handled
+    uint8_t m_link_baud_mask;      ///< Bauds the transducer supports (bit = table index)
+    uint8_t m_link_rate_mask;      ///< Sample rates the transducer supports (bit = table index)
+    uint8_t m_link_baud;           ///< Baud index the port runs at
+    uint8_t m_link_rate;           ///< Sample-rate index the transducer runs at
+    uint8_t m_link_target_baud;    ///< Baud index of the pending switch
+    uint8_t m_link_target_rate;    ///< Sample-rate index of the pending switch
+    uint8_t m_link_cap;            ///< Highest baud index still to be used (lowered by errors)
+    bool m_link_measuring;         ///< m_link_errors/m_link_samples hold the current window's start
+    uint32_t m_link_errors;        ///< linkErrorCount() at the window start
+    uint32_t m_link_samples;       ///< m_sample_count at the window start
+
+    // Receive health (written by serviceRx, read by getHealth)
+    uint64_t m_win_start_us;       ///< MonotonicUs() of the first sample of the current window
+    uint32_t m_win_gaps;           ///< Inter-arrival gaps in the current window
+    uint32_t m_win_gap_sum;        ///< Sum of those gaps (us)
+    uint64_t m_win_gap_sq_sum;     ///< Sum of their squares (us^2)
+    uint32_t m_win_max_gap;        ///< Longest gap in the current window (us)
+    uint32_t m_rate_mhz;           ///< Sample rate of the last complete window (mHz)
+    uint32_t m_jitter_us;          ///< Gap standard deviation of the last complete window
+    uint32_t m_max_gap_us;         ///< Longest gap of the last complete window
+    int32_t m_stuck_raw;           ///< Raw value the stuck-value run is counting
+    uint16_t m_stuck_run;          ///< Samples in a row equal to m_stuck_raw
+    uint32_t m_stuck_events;       ///< Runs that reached FORCE_HEALTH_STUCK_SAMPLES
+
+    // Automatic zero tracking (main loop only)
+    float m_zero_trim_kg;          ///< RAM trim on top of m_offset_kg
+    uint32_t m_zero_idle_since;    ///< Milliseconds() when tracking was last allowed after a pause
+    bool m_zero_allowed;           ///< trackZero() was allowed on the previous pass
+    bool m_zero_at_limit;          ///< The trim is clamped at FORCE_ZERO_TRACK_LIMIT_KG
+    uint32_t m_zero_last_us;       ///< m_last_sample_time_us of the last sample taken
+    uint16_t m_zero_count;         ///< Samples in the current batch
+    float m_zero_sum;              ///< Sum of the batch's filtered forces
+    float m_zero_min;              ///< Smallest force in the batch
+    float m_zero_max;              ///< Largest force in the batch
+
+    // Limit-path filter (configured from main loop, run from serviceRx)
+    volatile uint8_t m_filter_median; ///< Median window (1 = off)
+    volatile float m_filter_alpha; ///< IIR factor (1.0 = off)
+    volatile bool m_filter_reset;  ///< Set by setFilter(); serviceRx clears filter history
+    int32_t m_median_buf[FORCE_FILTER_MEDIAN_MAX]; ///< Most recent samples for the median
+    uint8_t m_median_count;        ///< Valid entries in m_median_buf
+    uint8_t m_median_index;        ///< Next slot to overwrite in m_median_buf
+    int64_t m_iir_state;           ///< IIR output (raw counts, Q16.16)
+    bool m_iir_valid;              ///< False until the IIR has been seeded
+    uint32_t m_latency_us;         ///< Acquisition-to-arrival delay of each sample (us)
+
+    // Sample-exact force trip (armed by MotorController, fired from serviceRx)
+    volatile bool m_trip_armed;    ///< Compare each sample against m_trip_limit_counts
+    volatile bool m_trip_fired;    ///< Latched when a sample crossed the limit
+    volatile int32_t m_trip_limit_counts; ///< Armed force limit (normalised counts)
+    volatile float m_trip_force_kg; ///< Force of the sample that fired the trip
+    volatile bool m_trip_predicted; ///< The trip fired on the extrapolated force
+    volatile uint32_t m_trip_latency_us; ///< Sample arrival until m_trip_hook returned
+    volatile uint32_t m_trip_lead_us; ///< Extrapolation time of the predictive trip (0 = off)
+    volatile int32_t m_trip_predict_counts; ///< Counts from which the prediction runs
+    float m_trip_rate;             ///< EWMA force rate while armed (counts per us)
+    int32_t m_trip_prev_counts;    ///< Counts of the previous sample while armed
+    uint32_t m_trip_prev_us;       ///< Arrival time of that sample (0 = none yet)
+    ForceTripHook m_trip_hook;     ///< Called from ISR context on trip
+    void* m_trip_context;          ///< Argument for m_trip_hook
+
+    // Single-producer (serviceRx) / single-consumer (drainSamples) sample FIFO
+    ForceSample m_ring[FORCE_SENSOR_RX_RING_SIZE]; ///< Samples awaiting drainSamples()
+    volatile uint16_t m_ring_head; ///< Next slot written by serviceRx
+    volatile uint16_t m_ring_tail; ///< Next slot read by drainSamples
+
+    void loadCalibrationFromNVM(); ///< Load this channel's calibration from the settings block
+    void loadFilterFromNVM();      ///< Load filter and latency settings from the settings block
+    void loadLinearizationFromNVM(); ///< Load the linearization table from non-volatile memory
+    static void rxTickHook(void* context); ///< Control tick hook that calls serviceRx()
+};
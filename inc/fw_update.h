@@ -0,0 +1,164 @@
+/**
+ * @file fw_update.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the network firmware update: a TCP-streamed image staged in flash bank B.
+ *
+ * @details fw_update begin <size> <crc> erases the staging area (FW_UPDATE_STAGING_ADDR up
+ * to the calibration profiles) one block per step and opens a listener on FW_UPDATE_PORT.
+ * The host then writes the raw application image (pressboi.bin) to that port. Received
+ * bytes fill one of two page buffers while the other waits for NVMCTRL, so the stream keeps
+ * flowing while the previous page programs; when both are full the task stops reading and
+ * TCP flow control holds the host. The code runs from bank A, so programming bank B never
+ * stalls it. Once the last page is in, the staged image is CRC-checked against @p crc in
+ * budgeted slices and its vector table is sanity-checked, and the uploader gets one line
+ * back ("OK <crc>" or "ERROR <reason>").
+ *
+ * fw_update apply switches over: with interrupts off, a routine running from RAM erases the
+ * application blocks, copies the staged pages over them and resets into the new firmware.
+ * The copy takes about a second and is the only window in which a power loss leaves no
+ * runnable application; the ClearCore bootloader below the application is never touched,
+ * so the UF2 route still recovers the press. Bank swapping (BKSWRST) is not used: bank B
+ * also holds the calibration profiles and the NVM journal, and the bootloader occupies
+ * bank A only.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+#if FW_UPDATE_ENABLED
+
+#include "ClearCore.h"
+#include "main_flash.h"
+
+/**
+ * @enum FwUpdateState
+ * @brief Progress of an update, in order.
+ */
+enum FwUpdateState : uint8_t {
+    FW_UPDATE_STATE_IDLE = 0,       ///< No update in progress
+    FW_UPDATE_STATE_ERASING,        ///< Erasing the staging blocks the image needs
+    FW_UPDATE_STATE_RECEIVING,      ///< Programming the stream into the staging area
+    FW_UPDATE_STATE_VERIFYING,      ///< Checking the staged image's CRC
+    FW_UPDATE_STATE_STAGED,         ///< Image verified; waiting for fw_update apply
+    FW_UPDATE_STATE_APPLYING,       ///< Switch-over due after FW_UPDATE_APPLY_DELAY_MS
+    FW_UPDATE_STATE_FAILED          ///< Stopped on an error; see getError()
+};
+
+/**
+ * @class FirmwareUpdate
+ * @brief Receives, stages, verifies and applies a firmware image. Main loop only.
+ */
+class FirmwareUpdate {
+public:
+    /**
+     * @brief Constructs an idle update.
+     */
+    FirmwareUpdate();
+
+    /**
+     * @brief Starts an update: erasing the staging area, then receiving on FW_UPDATE_PORT.
+     * The network must be up and the journal and profile stores idle.
+     * @param size Image bytes, 1 to FW_UPDATE_MAX_BYTES
+     * @param crc Expected CRC-32 (IEEE 802.3) of the image
+     * @param now_ms Milliseconds()
+     * @return false if the image cannot be staged (too large, or the running image reaches
+     * into the staging area)
+     */
+    bool begin(uint32_t size, uint32_t crc, uint32_t now_ms);
+
+    /**
+     * @brief Abandons the update. The staged bytes are left as they are; a later begin
+     * erases them again.
+     */
+    void cancel();
+
+    /**
+     * @brief Schedules the switch-over to the staged image.
+     * @param now_ms Milliseconds()
+     * @return false unless an image is staged
+     */
+    bool apply(uint32_t now_ms);
+
+    /**
+     * @brief Moves the update forward until @p budget_us is spent: one erase, page writes
+     * as NVMCTRL frees up, the TCP read, or a CRC slice. Called from its loop task.
+     * @param budget_us Time allowed
+     */
+    void service(uint32_t budget_us);
+
+    /**
+     * @brief Checks whether the switch-over is due.
+     * @param now_ms Milliseconds()
+     * @return true once FW_UPDATE_APPLY_DELAY_MS has passed since apply()
+     */
+    bool isApplyDue(uint32_t now_ms) const;
+
+    /**
+     * @brief Copies the staged image over the application and resets. Interrupts must be
+     * off and nothing else may use flash; the caller disables the drives and the watchdog.
+     */
+    [[noreturn]] void switchOver();
+
+    /**
+     * @brief Checks whether the update is programming flash, so the other stores must not
+     * start an NVMCTRL operation.
+     * @return true while erasing, receiving or applying
+     */
+    bool ownsFlash() const;
+
+    /**
+     * @brief Gets the update state.
+     * @return FwUpdateState
+     */
+    uint8_t getState() const { return m_state; }
+
+    /**
+     * @brief Gets why the update failed.
+     * @return Reason, empty unless FW_UPDATE_STATE_FAILED
+     */
+    const char* getError() const { return m_error; }
+
+    uint32_t getSize() const { return m_size; }              ///< Image bytes expected.
+    uint32_t getReceived() const { return m_received; }      ///< Image bytes received so far.
+    uint32_t getCrc() const { return m_expectedCrc; }        ///< CRC-32 the image must match.
+
+    /**
+     * @brief Gets the name of a state as shown in reports.
+     * @param state FwUpdateState
+     * @return State name
+     */
+    static const char* stateName(uint8_t state);
+
+private:
+    void fail(const char* reason);
+    void finishStream(const char* reply);
+    void acceptClient();
+    bool serviceProgram();
+    bool serviceReceive();
+    void serviceVerify(uint32_t start_us, uint32_t budget_us);
+
+    EthernetTcpServer m_server;                 ///< Listener on FW_UPDATE_PORT.
+    EthernetTcpClient m_client;                 ///< Host streaming the image.
+    uint32_t m_page[2][MAIN_FLASH_PAGE_WORDS];  ///< Receive / program double buffer.
+    uint16_t m_fillBytes;                       ///< Bytes received into m_page[m_fillPage].
+    uint8_t m_fillPage;                         ///< Page buffer being received into.
+    bool m_pagePending;                         ///< m_page[m_fillPage ^ 1] waits for NVMCTRL.
+    bool m_flashBusy;                           ///< A staging erase or write is in flight.
+    uint8_t m_state;                            ///< FwUpdateState
+    uint32_t m_size;                            ///< Image bytes expected.
+    uint32_t m_expectedCrc;                     ///< CRC-32 given to begin().
+    uint32_t m_received;                        ///< Image bytes taken off the stream.
+    uint32_t m_eraseAddress;                    ///< Next staging block to erase.
+    uint32_t m_writeAddress;                    ///< Staging address of the next page write.
+    uint32_t m_verifyOffset;                    ///< Staged bytes already run through the CRC.
+    uint32_t m_runningCrc;                      ///< CRC register over those bytes.
+    uint32_t m_progressMs;                      ///< Milliseconds() of the last erase, write or read.
+    uint32_t m_applyMs;                         ///< Milliseconds() of apply().
+    const char* m_error;                        ///< Reason of FW_UPDATE_STATE_FAILED.
+};
+
+extern FirmwareUpdate g_firmwareUpdate;
+
+#endif // FW_UPDATE_ENABLED
@@ -0,0 +1,46 @@
+/**
+ * @file hil_test.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the marker outputs used to measure force trip latency on a bench.
+ *
+ * @details With HIL_TEST_ENABLED 1, HIL_PIN_FORCE_CROSS changes state when the firmware sees
+ * a force sample at or above the active limit, and HIL_PIN_STOP changes state when the stop
+ * is issued to both motors. A scope or logic analyzer on the two pins, plus the COM-0 RX
+ * line, measures the frame-to-decision and decision-to-stop times end to end. The pins
+ * toggle rather than pulse so no edge is shorter than the analyzer can resolve and nothing
+ * waits in an ISR. transducer/force_replay.py replays recorded force profiles into COM-0
+ * for repeatable runs. With HIL_TEST_ENABLED 0 the HIL_MARK() call sites compile out.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @enum HilSignal
+ * @brief Marker outputs.
+ */
+enum HilSignal : uint8_t {
+    HIL_SIGNAL_FORCE_CROSS = 0,     ///< A force sample crossed the limit (HIL_PIN_FORCE_CROSS)
+    HIL_SIGNAL_STOP,                ///< The stop was issued to both motors (HIL_PIN_STOP)
+    HIL_SIGNAL_COUNT
+};
+
+#if HIL_TEST_ENABLED
+
+/**
+ * @brief Configures the marker pins as digital outputs, both low. Call once in setup().
+ */
+void hil_setup();
+
+/**
+ * @brief Toggles a marker pin. Safe from the receive ISR, the control tick and the main loop.
+ * @param signal HilSignal
+ */
+void hil_toggle(uint8_t signal);
+
+#define HIL_MARK(signal) hil_toggle(signal)
+#else
+#define HIL_MARK(signal) ((void)0)
+#endif
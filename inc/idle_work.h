@@ -0,0 +1,115 @@
+/**
+ * @file idle_work.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the idle-work queue for deferred main-loop jobs.
+ *
+ * @details Work that may stall the loop for milliseconds (a settings block write, journal
+ * compaction, a profile rewrite, later SD flushes and checkpoints) is posted here instead
+ * of being done where it arises. The "idle" loop task runs the queue only while Pressboi
+ * is in STATE_STANDBY with the motor idle, and at LOOP_PRIORITY_IDLE, which the scheduler
+ * defers whenever its budget no longer fits in the pass and never forces, so idle work
+ * only uses slack. Jobs are cooperative steps: each queued job runs at most once per pass
+ * until the budget is spent, and returns true to stay queued for another step. Once a move
+ * starts the queue holds still at the next step boundary and takes up where it left off
+ * after the press, so no flash erase or card transfer of a job starts during a press.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief One step of an idle job.
+ * @param context Opaque pointer supplied to IdleWork::post()
+ * @param budget_us Time the step should stay within
+ * @return true if the job has more to do and stays queued
+ */
+typedef bool (*IdleJobHook)(void* context, uint32_t budget_us);
+
+/**
+ * @struct IdleJob
+ * @brief One queued job.
+ */
+struct IdleJob {
+    const char* name;           ///< Name shown by dump_perf (not copied)
+    IdleJobHook hook;           ///< Step to run
+    void* context;              ///< Passed through to hook
+};
+
+/**
+ * @class IdleWork
+ * @brief FIFO of deferred jobs, run only while the press is idle. Main loop only.
+ */
+class IdleWork {
+public:
+    /**
+     * @brief Constructs an empty queue.
+     */
+    IdleWork();
+
+    /**
+     * @brief Queues a job. A job already queued (same hook and context) is not queued twice.
+     * @param name Name shown by dump_perf (not copied)
+     * @param hook Step to run
+     * @param context Passed through to @p hook
+     * @return false if IDLE_WORK_QUEUE_SIZE other jobs are queued
+     */
+    bool post(const char* name, IdleJobHook hook, void* context);
+
+    /**
+     * @brief Runs queued jobs, each at most one step, until the budget is spent.
+     * @param allowed The press is idle; false holds every job where it is
+     * @param budget_us Time to stay within (the first step always runs)
+     */
+    void service(bool allowed, uint32_t budget_us);
+
+    /**
+     * @brief Gets the number of queued jobs.
+     * @return Jobs waiting or part-done
+     */
+    uint8_t getQueued() const { return m_count; }
+
+    /**
+     * @brief Gets the number of job steps run since boot.
+     * @return Steps
+     */
+    uint32_t getSteps() const { return m_steps; }
+
+    /**
+     * @brief Gets how often queued work was held back by a press starting.
+     * @return Preemptions since boot
+     */
+    uint32_t getPreemptions() const { return m_preemptions; }
+
+    /**
+     * @brief Gets how many posts found the queue full.
+     * @return Rejected posts since boot
+     */
+    uint32_t getRejected() const { return m_rejected; }
+
+    /**
+     * @brief Gets the longest job step since boot.
+     * @return Microseconds
+     */
+    uint32_t getWorstStepUs() const { return m_worst_step_us; }
+
+    /**
+     * @brief Gets the job that took the longest step.
+     * @return Job name, or "none"
+     */
+    const char* getWorstStepName() const { return m_worst_step_name; }
+
+private:
+    IdleJob m_jobs[IDLE_WORK_QUEUE_SIZE];   ///< Ring of queued jobs
+    uint8_t m_head;                         ///< Index of the oldest job
+    uint8_t m_count;                        ///< Queued jobs
+    bool m_allowed;                         ///< The last service() was allowed to run
+    uint32_t m_steps;                       ///< Job steps since boot
+    uint32_t m_preemptions;                 ///< Times queued work was held back by a press
+    uint32_t m_rejected;                    ///< Posts refused because the queue was full
+    uint32_t m_worst_step_us;               ///< Longest step since boot
+    const char* m_worst_step_name;          ///< Job of that step
+};
+
+extern IdleWork g_idleWork;
@@ -0,0 +1,120 @@
+/**
+ * @file loop_profiler.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the main-loop stage profiler.
+ *
+ * @details LoopScheduler marks a stage boundary after every task it runs (see
+ * loop_scheduler.h). Each boundary reads the DWT cycle counter (kept running by libClearCore's
+ * SysTiming), so a mark costs a register read and a few adds. Every stage, plus the whole
+ * pass, keeps min/max/mean and a log2 histogram of its duration in microseconds, and
+ * dump_perf reports them. With LOOP_PROFILER_ENABLED 0 the marks compile out.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @enum LoopStage
+ * @brief Timed sections of Pressboi::loop(), one per scheduler task, in priority order.
+ */
+enum LoopStage : uint8_t {
+    LOOP_STAGE_SAFETY = 0,    ///< performSafetyCheck()
+    LOOP_STAGE_FORCE,         ///< Force sensor updates
+    LOOP_STAGE_STATE,         ///< updateState(), delayed auto-home and the recovery message
+    LOOP_STAGE_COMMS,         ///< Polling UDP, USB and the bulk TCP stream for commands
+    LOOP_STAGE_RX,            ///< Dequeue and dispatch commands
+    LOOP_STAGE_TX,            ///< Draining the TX queue
+    LOOP_STAGE_TELEMETRY,     ///< Telemetry publishing
+    LOOP_STAGE_LOGGING,       ///< Capture dump, debug log draining and the SD card log
+    LOOP_STAGE_TOTAL,         ///< Whole loop pass
+    LOOP_STAGE_COUNT
+};
+
+/**
+ * @struct LoopStageStats
+ * @brief Duration statistics of one stage.
+ * @details histogram[0] counts passes under 1 us and histogram[b] passes of
+ * [2^(b-1), 2^b) us; the last bucket also takes everything longer.
+ */
+struct LoopStageStats {
+    uint32_t count;                                 ///< Passes recorded
+    uint32_t min_cycles;                            ///< Shortest pass (CPU cycles)
+    uint32_t max_cycles;                            ///< Longest pass (CPU cycles)
+    uint64_t total_cycles;                          ///< Sum of all passes, for the mean
+    uint32_t histogram[LOOP_PROFILER_BUCKETS];      ///< log2 microsecond buckets
+};
+
+/**
+ * @class LoopProfiler
+ * @brief Times the stages of the main loop. Main loop only.
+ */
+class LoopProfiler {
+public:
+    /**
+     * @brief Constructs a profiler with empty statistics.
+     */
+    LoopProfiler();
+
+    /**
+     * @brief Starts a loop pass. Call first thing in loop().
+     */
+    void begin();
+
+    /**
+     * @brief Ends a stage: records the time since the previous boundary.
+     * @param stage Stage that just finished
+     */
+    void mark(LoopStage stage);
+
+    /**
+     * @brief Ends the loop pass and records its total duration.
+     */
+    void end();
+
+    /**
+     * @brief Clears all statistics. The pass in progress is not recorded, so a dump that
+     * resets does not show up as its own worst case.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the statistics of one stage.
+     * @param stage LoopStage
+     * @return Statistics (count 0 if nothing was recorded)
+     */
+    const LoopStageStats& getStats(LoopStage stage) const { return m_stats[stage]; }
+
+    /**
+     * @brief Gets the time since statistics were last cleared.
+     * @return Milliseconds
+     */
+    uint32_t getWindowMs() const;
+
+    /**
+     * @brief Gets the name of a stage as shown by dump_perf.
+     * @param stage LoopStage
+     * @return Lower-case stage name
+     */
+    static const char* stageName(LoopStage stage);
+
+    /**
+     * @brief Converts a cycle count to tenths of a microsecond.
+     * @param cycles CPU cycles
+     * @return Duration in 0.1 us
+     */
+    static uint32_t cyclesToTenthsUs(uint64_t cycles);
+
+private:
+    void clearStats();
+    void record(LoopStage stage, uint32_t cycles);
+
+    LoopStageStats m_stats[LOOP_STAGE_COUNT];   ///< Per-stage statistics
+    uint32_t m_pass_start;                      ///< Cycle counter at begin()
+    uint32_t m_stage_start;                     ///< Cycle counter at the last boundary
+    uint64_t m_window_start_us;                 ///< MonotonicUs() when statistics were cleared
+    bool m_skip_pass;                           ///< Discard the pass in progress (set by reset())
+};
+
+extern LoopProfiler g_loopProfiler;
@@ -0,0 +1,192 @@
+/**
+ * @file loop_scheduler.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the cooperative main-loop task scheduler.
+ *
+ * @details Each main-loop subsystem registers a task with a period, a priority and a time
+ * budget. Every pass the scheduler runs the due tasks highest priority first, and after each
+ * task it starts again from the top, so a high-priority task that fell due meanwhile goes
+ * before the remaining lower-priority work. Critical tasks always run. Other tasks are
+ * deferred to a later pass when their budget no longer fits in the pass
+ * (LOOP_SCHEDULER_PASS_BUDGET_US), so a burst of TX or logging work cannot push back the
+ * force and motion updates. A task deferred LOOP_SCHEDULER_MAX_DEFERRALS passes in a row
+ * runs anyway, except at LOOP_PRIORITY_IDLE, which waits for a pass with room for it. Tasks are cooperative: the budget is passed in, and a task that can split
+ * its work (TX draining, command dispatch) stops when the budget is spent.
+ *
+ * Each task is also a watchdog supervisor client (watchdog_supervisor.h), checked in when its
+ * hook returns, with a deadline of its period plus WATCHDOG_TASK_DEADLINE_MS. A deferred idle
+ * task checks in too: waiting for slack is what it is for.
+ *
+ * With MEMORY_STACK_TASK_PEAKS the scheduler also measures how deep each run took the
+ * painted stack (MemoryMap::takeTaskStackBytes()) and keeps every task's deepest run and
+ * the breadcrumb it left, so dump_perf names the task to blame when the headroom shrinks.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "loop_profiler.h"
+
+#define LOOP_SCHEDULER_NO_TASK 0xFF     ///< LoopScheduler::getRunningTask() between tasks
+
+/**
+ * @brief Function run as a main-loop task.
+ * @param context Opaque pointer supplied to LoopScheduler::registerTask()
+ * @param budget_us Time the task should stay within (0 = unbudgeted)
+ */
+typedef void (*LoopTaskHook)(void* context, uint32_t budget_us);
+
+/**
+ * @enum LoopTaskPriority
+ * @brief Task priorities, lowest first.
+ */
+enum LoopTaskPriority : uint8_t {
+    LOOP_PRIORITY_IDLE = 0,     ///< Deferred idle work (idle_work.h); runs only with slack in the pass
+    LOOP_PRIORITY_LOW,          ///< Logging and dumps
+    LOOP_PRIORITY_NORMAL,       ///< TX and telemetry
+    LOOP_PRIORITY_HIGH,         ///< Command intake
+    LOOP_PRIORITY_CRITICAL      ///< Safety, force and motion; never deferred
+};
+
+/**
+ * @struct LoopTask
+ * @brief One registered task and its counters.
+ */
+struct LoopTask {
+    const char* name;           ///< Name shown by dump_perf
+    LoopTaskHook hook;          ///< Function to run
+    void* context;              ///< Passed through to hook
+    uint32_t period_us;         ///< Minimum time between runs (0 = every pass)
+    uint32_t budget_us;         ///< Time budget per run (0 = unbudgeted)
+    uint32_t last_run_us;       ///< Microseconds() at the start of the last run
+    uint8_t priority;           ///< LoopTaskPriority
+    uint8_t stage;              ///< LoopStage the run time is profiled as
+    uint8_t deferrals;          ///< Passes in a row the task was due but deferred
+    uint32_t runs;              ///< Runs since the counters were cleared
+    uint32_t deferred;          ///< Deferrals since the counters were cleared
+    uint32_t overruns;          ///< Runs longer than budget_us since the counters were cleared
+    uint32_t stack_peak_bytes;  ///< Deepest stack of any run since boot (MEMORY_STACK_TASK_PEAKS)
+    uint32_t stack_breadcrumb;  ///< Breadcrumb that run left (WD_BREADCRUMB_*)
+    uint8_t watchdog;           ///< Watchdog supervisor client it checks in as after each run
+};
+
+/**
+ * @struct LoopSlowPass
+ * @brief A loop pass that went past the soft deadline, and the task that took longest in it.
+ */
+struct LoopSlowPass {
+    uint32_t time_ms;           ///< Milliseconds() at the end of the pass
+    uint32_t pass_us;           ///< Whole pass
+    uint32_t task_us;           ///< Run time of the slowest task in the pass
+    uint32_t breadcrumb;        ///< Breadcrumb the slowest task left (WD_BREADCRUMB_*)
+    uint8_t task;               ///< Index of the slowest task (LOOP_SCHEDULER_NO_TASK if none ran)
+};
+
+/**
+ * @class LoopScheduler
+ * @brief Runs the registered main-loop tasks by priority. Main loop only.
+ */
+class LoopScheduler {
+public:
+    /**
+     * @brief Constructs a scheduler with no tasks.
+     */
+    LoopScheduler();
+
+    /**
+     * @brief Adds a task. Tasks of equal priority run in registration order.
+     * @param name Name shown by dump_perf (not copied)
+     * @param hook Function to run
+     * @param context Passed through to @p hook
+     * @param priority LoopTaskPriority
+     * @param period_us Minimum time between runs (0 = every pass)
+     * @param budget_us Time budget per run (0 = unbudgeted)
+     * @param stage LoopStage the run time is profiled as
+     * @return false if LOOP_SCHEDULER_MAX_TASKS are already registered
+     */
+    bool registerTask(const char* name, LoopTaskHook hook, void* context, LoopTaskPriority priority,
+                      uint32_t period_us, uint32_t budget_us, LoopStage stage);
+
+    /**
+     * @brief Runs one loop pass: every due task at most once, highest priority first.
+     */
+    void run();
+
+    /**
+     * @brief Clears the run, deferral and overrun counters of every task. The stack peaks
+     * are high-water marks and stay.
+     */
+    void resetStats();
+
+    /**
+     * @brief Sets the soft deadline: passes longer than this count as slow.
+     * @param deadline_us Pass duration that counts as slow (0 = off)
+     * @param breadcrumb Watchdog breadcrumb read after each task to name where it spent its
+     *        time, or nullptr
+     */
+    void setSlowPassDeadline(uint32_t deadline_us, const volatile uint32_t* breadcrumb);
+
+    /**
+     * @brief Gets the number of slow passes since boot.
+     * @return Passes longer than the soft deadline
+     */
+    uint32_t getSlowPassCount() const { return m_slow_passes; }
+
+    /**
+     * @brief Gets the most recent slow pass.
+     * @return Slow pass (all zero until the first one)
+     */
+    const LoopSlowPass& getLastSlowPass() const { return m_last_slow; }
+
+    /**
+     * @brief Gets the longest pass since boot.
+     * @return Microseconds
+     */
+    uint32_t getWorstPassUs() const { return m_worst_pass_us; }
+
+    /**
+     * @brief Gets the longest pass since the previous call, and starts a new window.
+     * @return Microseconds
+     */
+    uint32_t takeWindowWorstPassUs();
+
+    /**
+     * @brief Gets the number of registered tasks.
+     * @return Task count
+     */
+    uint8_t getTaskCount() const { return m_task_count; }
+
+    /**
+     * @brief Gets a registered task, in run order.
+     * @param index 0 .. getTaskCount() - 1
+     * @return Task
+     */
+    const LoopTask& getTask(uint8_t index) const { return m_tasks[index]; }
+
+    /**
+     * @brief Gets the task whose hook is running, for the crash snapshot.
+     * @return Task index, or LOOP_SCHEDULER_NO_TASK between tasks
+     */
+    uint8_t getRunningTask() const { return m_running; }
+
+    /**
+     * @brief Gets when the running task started.
+     * @return Microseconds() at the start of the hook (meaningless between tasks)
+     */
+    uint32_t getRunningSinceUs() const { return m_running_since_us; }
+
+private:
+    LoopTask m_tasks[LOOP_SCHEDULER_MAX_TASKS];     ///< Tasks sorted by priority, highest first
+    uint8_t m_task_count;                           ///< Valid entries in m_tasks
+    volatile uint8_t m_running;                     ///< Index of the task in its hook, or LOOP_SCHEDULER_NO_TASK
+    volatile uint32_t m_running_since_us;           ///< Microseconds() when that hook was entered
+    uint32_t m_slow_deadline_us;                    ///< Soft deadline of a pass (0 = off)
+    const volatile uint32_t* m_breadcrumb;          ///< Breadcrumb sampled after each task, or nullptr
+    uint32_t m_slow_passes;                         ///< Passes past the soft deadline since boot
+    LoopSlowPass m_last_slow;                       ///< Most recent slow pass
+    uint32_t m_worst_pass_us;                       ///< Longest pass since boot
+    uint32_t m_window_worst_pass_us;                ///< Longest pass since takeWindowWorstPassUs()
+};
+
+extern LoopScheduler g_loopScheduler;
@@ -0,0 +1,126 @@
+/**
+ * @file machine_strain.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the machine-flex model used to take frame deflection out of the joule total.
+ *
+ * @details The frame's force-vs-deflection curve is a quartic fit. updateJoules() needs the
+ * inverse (deflection at a measured force) for every load-cell sample, so the inverse is
+ * tabulated once per coefficient change and each lookup is one interpolation. The model
+ * uses no ClearCore symbols and builds on a host with PRESSBOI_HOST defined.
+ *
+ * MachineStrainFit finds the coefficients on the device: fit_strain_cal feeds it the
+ * loading stroke of a press against a rigid block, so the whole stroke is frame flex. It
+ * keeps only the power and moment sums of the normal equations, so any number of samples
+ * costs the same 128 bytes, and solves the 5x5 system in double precision once.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @class MachineStrainModel
+ * @brief Strain polynomial [x^4, x^3, x^2, x, constant] (kg from mm) and its lookup-table inverse.
+ */
+class MachineStrainModel {
+public:
+    /**
+     * @brief Constructs the model with the MACHINE_STRAIN_COEFF_* defaults.
+     */
+    MachineStrainModel();
+
+    /**
+     * @brief Replaces the coefficients and rebuilds the inverse table.
+     * @param coeffs Five coefficients, highest power first
+     */
+    void setCoefficients(const float coeffs[5]);
+
+    /**
+     * @brief Gets the coefficients.
+     * @return Five coefficients, highest power first
+     */
+    const float* getCoefficients() const { return m_coeffs; }
+
+    /**
+     * @brief Evaluates the fit. Negative deflections and forces clamp to 0.
+     * @param deflection_mm Frame deflection
+     * @return Force in kg
+     */
+    float forceFromDeflection(float deflection_mm) const;
+
+    /**
+     * @brief Looks up the deflection at a force. Forces past the rising part of the fit
+     * clamp to its top.
+     * @param force_kg Measured force
+     * @return Deflection in mm (0 below the force at zero deflection)
+     */
+    float deflectionFromForce(float force_kg) const;
+
+private:
+    void rebuildTable();
+
+    float m_coeffs[5];                          ///< [x^4, x^3, x^2, x, constant]
+    float m_tableMm[MACHINE_STRAIN_TABLE_SIZE]; ///< Deflection (mm) at m_tableMinKg + i * m_tableStepKg.
+    float m_tableMinKg;                         ///< Force at deflection 0; smaller forces map to 0 mm.
+    float m_tableStepKg;                        ///< Force spacing of the entries (0 = no rising range, always 0 mm).
+};
+
+/**
+ * @class MachineStrainFit
+ * @brief Least-squares quartic of force over deflection, accumulated one sample at a time.
+ */
+class MachineStrainFit {
+public:
+    /**
+     * @brief Constructs an empty fit.
+     */
+    MachineStrainFit();
+
+    /**
+     * @brief Discards every sample.
+     */
+    void reset();
+
+    /**
+     * @brief Adds one sample.
+     * @param deflection_mm Frame deflection
+     * @param force_kg Force at that deflection
+     */
+    void add(float deflection_mm, float force_kg);
+
+    /**
+     * @brief Gets the number of samples added.
+     * @return Sample count
+     */
+    uint32_t getCount() const { return m_count; }
+
+    /**
+     * @brief Gets the largest deflection added.
+     * @return Deflection in mm
+     */
+    float getSpanMm() const { return m_spanMm; }
+
+    /**
+     * @brief Solves the normal equations.
+     * @param coeffs Receives five coefficients, highest power first (setCoefficients() order)
+     * @param rms_kg Receives the RMS force residual of the fit
+     * @return false with fewer than five samples or a singular system
+     */
+    bool solve(float coeffs[5], float* rms_kg) const;
+
+    /**
+     * @brief Checks that a fit rises with deflection over the whole span of the samples, so
+     * its inverse table covers every force that was measured.
+     * @param coeffs Five coefficients, highest power first
+     * @return true if the force increases at each of MACHINE_STRAIN_SCAN_STEPS points
+     */
+    bool risesOverSpan(const float coeffs[5]) const;
+
+private:
+    double m_powerSums[9];                      ///< Sum of x^k, k = 0..8
+    double m_momentSums[5];                     ///< Sum of x^k * F, k = 0..4
+    double m_forceSquares;                      ///< Sum of F^2, for the residual
+    uint32_t m_count;                           ///< Samples added
+    float m_spanMm;                             ///< Largest deflection added
+};
@@ -0,0 +1,45 @@
+/**
+ * @file main_flash.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Declares the non-blocking main flash operations used by the flash-backed stores.
+ *
+ * @details The NVM journal and the calibration profiles keep their data in erase blocks at
+ * the top of main flash, outside the application image. These calls only start an
+ * operation on NVMCTRL and return; the caller polls main_flash_ready() from its service()
+ * and checks main_flash_errors() once it is ready. NVMCTRL runs one operation at a time,
+ * so the settings task services one store at a time.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define MAIN_FLASH_PAGE_WORDS       128     ///< Words in one 512-byte flash page.
+#define MAIN_FLASH_QUAD_WORDS       4       ///< Words in one quad-word write.
+
+/**
+ * @brief Checks whether NVMCTRL can take a new operation.
+ * @return true when the last operation has finished
+ */
+bool main_flash_ready();
+
+/**
+ * @brief Gets the error flags of the last operation started here.
+ * @return NVMCTRL_INTFLAG ADDRE, PROGE, LOCKE and NVME bits (0 = success)
+ */
+uint16_t main_flash_errors();
+
+/**
+ * @brief Starts a quad-word or page write.
+ * @param address Flash address, aligned to the write size
+ * @param words Data to write, all within one page
+ * @param count MAIN_FLASH_QUAD_WORDS for a quad-word write; otherwise a page write, with
+ * words past @p count left erased
+ */
+void main_flash_start_write(uint32_t address, const uint32_t* words, uint16_t count);
+
+/**
+ * @brief Starts erasing the erase block that holds @p address.
+ * @param address Any address in the block
+ */
+void main_flash_start_erase(uint32_t address);
@@ -0,0 +1,103 @@
+/**
+ * @file memory_map.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the SRAM map and stack high-water mark reported by dump_mem.
+ *
+ * @details The linker places .data and .bss at the bottom of the 192 KB of SRAM; newlib's
+ * heap grows up from the end of .bss and the stack grows down from the top of RAM, with
+ * nothing but free RAM between them. paintStack() fills that gap with MEMORY_STACK_PAINT
+ * at boot, leaving MEMORY_HEAP_HEADROOM_BYTES above the heap for later malloc, and the
+ * deepest word that no longer holds the pattern is the stack's high-water mark. A stack
+ * that has ever reached the heap shows as no painted words left.
+ *
+ * takeTaskStackBytes() measures one loop task at a time: the scheduler calls it after each
+ * task, it scans down from the stack pointer for the deepest word the task wrote and then
+ * paints that span again, so the next task starts on clean paint. The scan stops after
+ * MEMORY_STACK_GAP_BYTES of unbroken paint; a task that leaves more than that unwritten
+ * above a deeper call reads shallow, but the peak over all tasks never does.
+ *
+ * The linker scripts also refuse to link an image that leaves less than 8 KB between the
+ * heap and the top of RAM; Tools/memory_report.py lists what the statics are spent on.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @class MemoryMap
+ * @brief Section sizes from the linker symbols and the painted-stack high-water mark.
+ */
+class MemoryMap {
+public:
+    /**
+     * @brief Constructs an unpainted map (every stack reading is 0).
+     */
+    MemoryMap();
+
+    /**
+     * @brief Paints the free RAM between the heap top and the stack pointer. Call first
+     * thing in setup(), while the stack is still shallow.
+     */
+    void paintStack();
+
+    /**
+     * @brief Gets the deepest the stack has been since paintStack(), including depths that
+     * takeTaskStackBytes() has painted over.
+     * @return Bytes below the top of RAM (0 if never painted)
+     */
+    uint32_t getStackPeakBytes() const;
+
+    /**
+     * @brief Gets the painted bytes the stack has never reached: the stack's real headroom.
+     * @return Bytes (0 if never painted, or if the stack has reached the heap)
+     */
+    uint32_t getStackUnusedBytes() const;
+
+    /**
+     * @brief Measures the stack the code run since the previous call reached, and paints
+     * it again. Main loop only, between tasks.
+     * @return Bytes below the top of RAM (0 if never painted)
+     */
+    uint32_t takeTaskStackBytes();
+
+    /**
+     * @brief Gets the stack in use at the caller.
+     * @return Bytes from the top of RAM to the stack pointer
+     */
+    static uint32_t getStackNowBytes();
+
+    /**
+     * @brief Gets the size of SRAM.
+     * @return Bytes
+     */
+    static uint32_t getRamBytes();
+
+    /**
+     * @brief Gets the size of the initialised statics.
+     * @return Bytes of .data
+     */
+    static uint32_t getDataBytes();
+
+    /**
+     * @brief Gets the size of the zeroed statics.
+     * @return Bytes of .bss
+     */
+    static uint32_t getBssBytes();
+
+    /**
+     * @brief Gets the heap newlib has taken so far (it never gives any back).
+     * @return Bytes
+     */
+    static uint32_t getHeapBytes();
+
+private:
+    const uint32_t* firstUsedWord() const;
+
+    uint32_t* m_paintStart;     ///< Lowest painted word
+    uint32_t* m_paintEnd;       ///< One past the highest painted word
+    uint32_t m_peakBytes;       ///< Deepest takeTaskStackBytes() reading (its paint is gone)
+};
+
+extern MemoryMap g_memoryMap;
@@ -0,0 +1,165 @@
+/**
+ * @file message_ring.h
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Defines the variable-length message queue used for the RX and TX paths.
+ *
+ * @details Message text is packed back to back in a byte arena, in queue order, and a
+ * ring of small descriptors records where each message starts, how long it is and who it
+ * is from or for. A message only costs its length plus the NUL, so the same RAM holds
+ * many more of the short events and commands that make up most traffic than fixed
+ * `MAX_MESSAGE_LENGTH` slots would. Every message is contiguous and NUL-terminated, so it
+ * can be handed straight to the UDP and USB senders. Main loop only.
+ */
+#pragma once
+
+#include "ClearCore.h"
+#include "IpAddress.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @struct MessageSlot
+ * @brief Describes one queued message.
+ */
+struct MessageSlot {
+	uint16_t offset;                 ///< Start of the NUL-terminated text in the arena.
+	uint16_t length;                 ///< Text length in bytes, excluding the NUL.
+	IpAddress remoteIp;              ///< The IP address of the remote host (sender or recipient).
+	uint16_t remotePort;             ///< The port number of the remote host.
+};
+
+/**
+ * @class MessageRing
+ * @brief FIFO of variable-length messages over caller-provided storage.
+ */
+class MessageRing {
+	public:
+	/**
+     * @brief Constructs an empty queue over the given storage.
+     * @param arena Text storage (at most 65535 bytes)
+     * @param arena_size Size of @p arena
+     * @param slots Descriptor storage
+     * @param slot_count Entries in @p slots; one is kept free, so up to slot_count - 1 messages queue
+     */
+	MessageRing(char* arena, uint16_t arena_size, MessageSlot* slots, uint16_t slot_count);
+
+	/**
+     * @brief Reserves contiguous space so a producer can format a message in place.
+     * @details Nothing is queued until commit(), and a reservation that is never committed
+     * is simply replaced by the next one.
+     * @param capacity Bytes the caller may write, including the terminating NUL
+     * @return Buffer of @p capacity bytes, or NULL if no slot or no contiguous space is free
+     */
+	char* reserve(size_t capacity);
+
+	/**
+     * @brief Queues the message written into the last reserve() buffer.
+     * @details Only @p length + 1 bytes of the reservation are kept.
+     * @param length Text length, excluding the NUL (clamped to the reserved capacity)
+     * @param ip The IP address of the remote host
+     * @param port The port of the remote host
+     */
+	void commit(size_t length, const IpAddress& ip, uint16_t port);
+
+	/**
+     * @brief Queues one piece of the last reserve() buffer and keeps the rest reserved.
+     * @details For a producer that fills the reservation with several messages at once (a
+     * datagram of newline-separated commands): each piece is queued where it lies, with no
+     * copy. Pieces must be committed in order; text skipped between them is given back as
+     * the queue drains. The next reserve() ends the reservation.
+     * @param text Start of the piece, inside the reservation and past the last piece
+     * @param length Piece length, excluding the NUL written at text[length]
+     * @param ip The IP address of the remote host
+     * @param port The port of the remote host
+     * @return false if no descriptor is free or the piece is not inside the reservation
+     */
+	bool commitPart(char* text, size_t length, const IpAddress& ip, uint16_t port);
+
+	/**
+     * @brief Copies a message in (reserve, copy and commit in one call).
+     * @param text Message text
+     * @param length Text length, excluding the NUL
+     * @param ip The IP address of the remote host
+     * @param port The port of the remote host
+     * @return false if there was no room, in which case nothing was queued
+     */
+	bool push(const char* text, size_t length, const IpAddress& ip, uint16_t port);
+
+	/**
+     * @brief Gets the oldest message.
+     * @return Descriptor, or NULL if the queue is empty
+     */
+	const MessageSlot* front() const;
+
+	/**
+     * @brief Gets the text of a queued message.
+     * @param slot Descriptor from front()
+     * @return NUL-terminated text, valid until pop()
+     */
+	const char* text(const MessageSlot& slot) const { return m_arena + slot.offset; }
+
+	/**
+     * @brief Releases the oldest message.
+     */
+	void pop();
+
+	/**
+     * @brief Drops every queued message.
+     */
+	void clear();
+
+	/**
+     * @brief Gets the number of queued messages.
+     * @return Message count
+     */
+	int getCount() const;
+
+	/**
+     * @brief Gets the most messages that have been queued at once since boot.
+     * @return High-water message count
+     */
+	uint16_t getPeakCount() const { return m_peakCount; }
+
+	/**
+     * @brief Estimates how many more messages will fit.
+     * @param bytes_per_message Arena bytes to count per message
+     * @return The smaller of the free slots and the free arena bytes / @p bytes_per_message
+     */
+	int getFree(uint16_t bytes_per_message) const;
+
+	/**
+     * @brief Gets the size of the outstanding reservation.
+     * @return Bytes reserved by the last reserve(), or 0 if none is outstanding
+     */
+	uint16_t getReservedCapacity() const { return m_reserveCapacity; }
+
+	private:
+	/**
+     * @brief Finds contiguous free space in the arena.
+     * @param need Bytes required, including the NUL
+     * @return Arena offset, or -1 if the space is not available
+     */
+	int findSpace(size_t need) const;
+
+	/**
+     * @brief Fills the next descriptor for text already in the arena.
+     * @param offset Arena offset of the text
+     * @param length Text length; the NUL is written at offset + length
+     * @param ip The IP address of the remote host
+     * @param port The port of the remote host
+     */
+	void queueAt(uint16_t offset, size_t length, const IpAddress& ip, uint16_t port);
+
+	char* m_arena;                  ///< Message text, allocated in queue order.
+	uint16_t m_arenaSize;           ///< Size of m_arena.
+	MessageSlot* m_slots;           ///< Circular buffer of descriptors.
+	uint16_t m_slotCount;           ///< Entries in m_slots.
+	volatile uint16_t m_head;       ///< Index of the next free descriptor.
+	volatile uint16_t m_tail;       ///< Index of the oldest message.
+	uint16_t m_arenaHead;           ///< Arena offset just past the newest message.
+	uint16_t m_reserveOffset;       ///< Arena offset of the outstanding reservation.
+	uint16_t m_reserveCapacity;     ///< Size of the outstanding reservation (0 = none).
+	uint16_t m_reserveNext;         ///< Arena offset where the next commitPart() piece may start.
+	uint16_t m_peakCount;           ///< Most messages queued at once.
+};
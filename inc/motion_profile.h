@@ -0,0 +1,82 @@
+/**
+ * @file motion_profile.h
+ * @author Eldin Miller-Stead
+ * @date November 5, 2025
+ * @brief Defines the jerk-limited (S-curve) velocity profile used for press moves.
+ *
+ * @details The ClearCore step generators only ramp at a constant acceleration. For
+ * S-curve moves MotorController plans the profile once in the main loop, then the control
+ * tick samples velocityAt() every tick and streams it to both step generators with
+ * MoveVelocity(). A final positional Move() lands the axes exactly on the target.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @class SCurveProfile
+ * @brief Symmetric seven-phase jerk-limited move (jerk up, constant accel, jerk down,
+ * cruise, and the mirror image to stop).
+ * @details Units are whatever the caller uses consistently (steps, steps/s, ...). The
+ * peak velocity and acceleration are lowered automatically for moves too short to reach them.
+ */
+class SCurveProfile {
+public:
+    /**
+     * @brief Constructs an empty (zero-length) profile.
+     */
+    SCurveProfile();
+
+    /**
+     * @brief Plans a profile from rest to rest.
+     * @param distance Move length (> 0)
+     * @param vel_max Velocity ceiling (> 0)
+     * @param accel_max Acceleration ceiling (> 0)
+     * @param jerk_max Jerk ceiling (> 0)
+     * @return false if any argument is not positive
+     */
+    bool plan(float distance, float vel_max, float accel_max, float jerk_max);
+
+    /**
+     * @brief Evaluates the planned velocity. Safe to call from interrupt context.
+     * @param t Seconds since the start of the move
+     * @return Velocity at @p t (0 before the start and after the end)
+     */
+    float velocityAt(float t) const;
+
+    /**
+     * @brief Gets the planned move time.
+     * @return Duration in seconds
+     */
+    float getDuration() const { return 2.0f * m_accel_time + m_cruise_time; }
+
+    /**
+     * @brief Gets the peak velocity actually reached.
+     * @return Cruise velocity
+     */
+    float getPeakVelocity() const { return m_vel; }
+
+private:
+    /**
+     * @brief Plans the accel phase for a cruise velocity.
+     * @param vel Cruise velocity
+     * @param accel_max Acceleration ceiling
+     * @param jerk_max Jerk ceiling
+     * @return Distance covered while accelerating from rest to @p vel
+     */
+    float planAccel(float vel, float accel_max, float jerk_max);
+
+    /**
+     * @brief Velocity during the accel phase.
+     * @param tau Seconds since the start of the phase (0 to m_accel_time)
+     * @return Velocity
+     */
+    float accelVelocity(float tau) const;
+
+    float m_jerk;        ///< Jerk ceiling
+    float m_accel;       ///< Peak acceleration reached
+    float m_vel;         ///< Cruise velocity
+    float m_jerk_time;   ///< Length of each jerk ramp
+    float m_accel_time;  ///< Length of the whole accel (and decel) phase
+    float m_cruise_time; ///< Length of the constant-velocity phase
+};
@@ -14,10 +14,17 @@
 #include "config.h"
 #include "comms_controller.h"
 #include "commands.h"
+#include "command_args.h"
 #include "variables.h"
+#include "force_sensor.h"
+#include "motion_profile.h"
+#include "machine_strain.h"
+#include "press_energy.h"
+#include "motor_thermal.h"
+#include "units.h"
+#include "event_queue.h"
 
 class Pressboi; // Forward declaration
-class ForceSensor; // Forward declaration
 
 /**
  * @enum HomingState
@@ -61,7 +68,9 @@ enum MoveState : uint8_t {
 	MOVE_TO_HOME,               ///< Moving to the previously established start position.
 	MOVE_TO_RETRACT,            ///< Moving to a retracted position relative to the start.
 	MOVE_CANCELLED,             ///< The move was cancelled by the user.
-	MOVE_COMPLETED              ///< The move finished successfully.
+	MOVE_COMPLETED,             ///< The move finished successfully.
+	MOVE_DWELL,                 ///< Holding position for a queued dwell segment.
+	MOVE_SYNC_WAIT              ///< Holding before a run_recipe segment until press sync releases it.
 };
 
 /**
@@ -77,12 +86,183 @@ enum EnableState : uint8_t {
 };
 
 
+/**
+ * @enum MotionSegmentType
+ * @brief Kinds of step the motion queue can run.
+ */
+enum MotionSegmentType : uint8_t {
+	SEGMENT_MOVE,               ///< Absolute move with the same parameters as MOVE_ABS.
+	SEGMENT_DWELL,              ///< Wait in place for dwell_ms.
+	SEGMENT_RETRACT             ///< Move to the stored retract position (speed_mms 0 = stored speed).
+};
+
+/**
+ * @enum ForceMode
+ * @brief Force sensing used for limits, energy and telemetry (NVM slot 4 holds the value).
+ */
+enum ForceMode : uint8_t {
+    FORCE_MODE_MOTOR_TORQUE = 0,  ///< "motor_torque": force estimated from HLFB torque
+    FORCE_MODE_LOAD_CELL = 1      ///< "load_cell": external load cell(s)
+};
+
+/**
+ * @enum ForceAction
+ * @brief What a move does when its force limit is reached. Recipes store the value, so new
+ * actions go at the end (before FORCE_ACTION_NONE).
+ */
+enum ForceAction : uint8_t {
+    FORCE_ACTION_HOLD = 0,    ///< "hold": pause and wait for resume/cancel
+    FORCE_ACTION_SKIP,        ///< "skip": end the move (or segment) where it is
+    FORCE_ACTION_RETRACT,     ///< "retract": retract on any completion, then DONE
+    FORCE_ACTION_ABORT,       ///< "abort": ERROR, then retract, only if the limit was hit
+    FORCE_ACTION_REGULATE,    ///< "regulate": close the loop on force instead of stopping
+    FORCE_ACTION_SEAT,        ///< "seat": end like skip on a stiffness jump
+    FORCE_ACTION_NONE         ///< No action left (cleared once a limit retract is under way)
+};
+
+/**
+ * @enum Polarity
+ * @brief Coordinate system direction (NVM slot 3 holds the value).
+ */
+enum Polarity : uint8_t {
+    POLARITY_NORMAL = 0,      ///< "normal"
+    POLARITY_INVERTED = 1     ///< "inverted": flips home direction and all moves
+};
+
+/**
+ * @struct PressStation
+ * @brief The hardware one MotorController drives: its ganged motors and their home sensors.
+ * @details Only the connectors come from the descriptor. The force sensor (through the
+ * Pressboi), g_settings, g_controlTick, the command dispatcher and the telemetry builder
+ * are still the single instances of the board, so the firmware builds one station.
+ */
+struct PressStation {
+    MotorDriver* motors[MOTOR_AXIS_MAX];     ///< Ganged motors, reference axis first.
+    DigitalIn* home_sensors[MOTOR_AXIS_MAX]; ///< Home sensor of each motor.
+    int axis_count;                          ///< Entries in use (1 .. MOTOR_AXIS_MAX).
+};
+
+/**
+ * @struct MotionSegment
+ * @brief One motion queue or recipe step.
+ */
+struct MotionSegment {
+	uint8_t type;           ///< MotionSegmentType.
+	uint32_t dwell_ms;      ///< Dwell time (SEGMENT_DWELL), or hold time of a "regulate" move.
+	float position_mm;      ///< Target position (mm from home).
+	float speed_mms;        ///< Move speed (mm/s).
+	float force_kg;         ///< Force limit (kg), 0 for the default torque ceiling; target force for "regulate".
+	ForceAction force_action; ///< Limit action.
+};
+
+/**
+ * @struct CompiledSegment
+ * @brief A motion queue segment checked against the force mode and converted to step space
+ * once, when the queue starts, so segment handoff does no unit conversion.
+ */
+struct CompiledSegment {
+    uint8_t type;             ///< MotionSegmentType.
+    ForceAction force_action; ///< Limit action (HOLD for retracts).
+    uint32_t dwell_ms;        ///< Dwell time (SEGMENT_DWELL), or hold time of a "regulate" move.
+    long target_steps;        ///< Absolute target; retracts resolve theirs when they start.
+    int32_t velocity_sps;     ///< Speed, capped at MOVE_SPEED_MAX_MMS; 0 for a retract at the retract speed.
+    float speed_mms;          ///< The same speed in mm/s (approach ceiling of "regulate").
+    float force_kg;           ///< Force limit or target (kg), in range for the force mode.
+};
+
+/**
+ * @struct MoveCacheEntry
+ * @brief A move_abs argument set already checked and compiled, with the state the
+ * compilation depended on. Reused only while that state is unchanged.
+ */
+struct MoveCacheEntry {
+    uint32_t key;               ///< moveCacheKey() of the arguments (0 = empty slot).
+    uint8_t count;              ///< Arguments given.
+    MoveAbsArgs args;           ///< The arguments, compared in full on a key match.
+    ForceMode force_mode;       ///< Force mode the move was checked against.
+    long home_reference_steps;  ///< m_machineHomeReferenceSteps the target was taken from.
+    float steps_per_mm;         ///< Drive geometry the steps were converted with.
+    bool speed_limited;         ///< compileSegment() capped the speed (its INFO is repeated on reuse).
+    CompiledSegment move;       ///< The compiled move.
+};
+
+/**
+ * @struct MoveStats
+ * @brief Runtime statistics of the press cycle being timed, reported with its DONE event.
+ */
+struct MoveStats {
+    uint32_t pass_us;           ///< Microseconds() of the cycle's last updateState() pass.
+    uint32_t loop_max_us;       ///< Longest time between two passes.
+    uint32_t age_max_us;        ///< Oldest newest-sample the load-cell limit was checked against.
+    uint32_t samples;           ///< Load-cell samples drained.
+    uint32_t dropped_base;      ///< droppedSampleCount() when the cycle started.
+    uint32_t trip_us;           ///< Crossing sample to the stop of the first force trip.
+    bool tripped;               ///< trip_us is valid.
+};
+
+/**
+ * @struct CompiledZone
+ * @brief A band of the recipe's limit map in step space, with the move's own limits folded
+ * in when the move starts, so the control tick only compares positions.
+ */
+struct CompiledZone {
+    long low_steps;           ///< Band edge at the lower commanded position.
+    long high_steps;          ///< Band edge at the higher commanded position.
+    int32_t velocity_sps;     ///< Speed in the band (the lower of the band's and the move's).
+    float torque_limit;       ///< Torque limit in the band (Torque%).
+    float force_kg;           ///< Force limit in the band (kg).
+    int32_t force_counts;     ///< The same limit in primary sensor counts.
+    int32_t trip_counts[2];   ///< Fast trip limit of the primary sensor, or of A and B on the summed channel.
+    int32_t predict_counts[2]; ///< Predictive trip start, per trip_counts entry.
+};
+
+/**
+ * @struct TorqueForceSample
+ * @brief One torque-derived force sample taken by the control tick for energy integration.
+ */
+struct TorqueForceSample {
+    uint32_t time_us;       ///< Microseconds() at the tick
+    long position_steps;    ///< Commanded position (steps from home)
+    float kg;               ///< Force from the motor torque model (kg)
+    float torque_pct;       ///< Smoothed torque of the reference motor (%)
+};
+
+/**
+ * @struct TelemetrySnapshot
+ * @brief The measured telemetry fields, all taken in one control tick.
+ */
+struct TelemetrySnapshot {
+    uint32_t time_us;           ///< Microseconds() at the tick
+    float position_mm;          ///< Commanded M0 position (mm from home)
+    float torque_avg;           ///< Smoothed torque averaged over the axes (%)
+    float force_motor_torque;   ///< Force from the motor torque model (kg)
+    float force_fused;          ///< Fused force (kg)
+    float force_load_cell;      ///< Transducer-filtered force of the selected channel (kg), 0 if disconnected
+    int32_t force_adc_raw;      ///< Transducer-filtered counts of the selected channel (A for the sum)
+    uint8_t home_sensor_m0;     ///< 1 if M0's home sensor is active
+    uint8_t home_sensor_m1;     ///< 1 if M1's home sensor is active
+};
+
+/**
+ * @struct AxisState
+ * @brief One motor's driver state as read at the start of a control tick.
+ */
+struct AxisState {
+    uint32_t status_reg;        ///< StatusReg().reg
+    int32_t position_steps;     ///< PositionRefCommanded()
+    int32_t velocity_sps;       ///< VelocityRefCommanded()
+    float hlfb_pct;             ///< HlfbPercent() (TORQUE_HLFB_AT_POSITION while at position)
+    bool hlfb_new;              ///< hlfb_pct is a new HLFB measurement (see axisSnapshotTick())
+};
+
 /**
  * @class MotorController
- * @brief Manages the dual-motor press system.
+ * @brief Manages the ganged-motor press system.
  *
- * @details This class orchestrates the two ganged motors (M0 and M1) to perform complex, 
- * multi-stage operations. Key responsibilities include:
+ * @details This class orchestrates the ganged motors (M0 up to M3, MOTOR_AXIS_COUNT of them)
+ * to perform complex, multi-stage operations. Per-axis state is kept as parallel arrays
+ * indexed by axis, so every per-axis check is one loop over the same index range. M0 is
+ * the reference axis: its commanded position is the press position. Key responsibilities include:
  * - A hierarchical state machine for managing overall state (e.g., STANDBY, HOMING, MOVING).
  * - Nested state machines for detailed processes like the multi-phase homing sequence.
  * - Torque-based sensing for detecting hard stops during homing and stall conditions.
@@ -93,16 +273,16 @@ class MotorController {
 public:
     /**
      * @brief Constructs a new MotorController object.
-     * @param motorA Pointer to the primary ClearCore motor driver (M0).
-     * @param motorB Pointer to the secondary (ganged) ClearCore motor driver (M1).
+     * @param station Motors and home sensors of the press this controller drives
      * @param controller Pointer to the main `Pressboi` controller, used for reporting events.
      */
-    MotorController(MotorDriver* motorA, MotorDriver* motorB, Pressboi* controller);
+    MotorController(const PressStation& station, Pressboi* controller);
 
     /**
      * @brief Initializes the motors and their configurations.
-     * @details Configures motor settings such as max velocity and acceleration, and enables
-     * the motor drivers. This should be called once at startup.
+     * @details Configures motor settings such as max velocity and acceleration, and requests
+     * the motor drivers enable. Does not wait for the drives to report enabled; callers that
+     * need them (home-on-boot) poll drivesEnabled(). This should be called once at startup.
      */
     void setup();
 
@@ -117,15 +297,18 @@ public:
     /**
      * @brief Handles user commands related to the motors.
      * @param cmd The `Command` enum representing the command to be executed.
-     * @param args A C-style string containing any arguments for the command (e.g., distance, volume).
+     * @param args Decoded arguments of the command, or NULL if they were malformed.
      */
-    void handleCommand(Command cmd, const char* args);
+    void handleCommand(Command cmd, const CommandArgs* args);
 
     /**
      * @brief Updates the telemetry data structure with current motor state.
+     * @details The measured fields come from the latest snapshot the control tick
+     * completed, so they all belong to one instant and reading them does no sensor work;
+     * time_us is that tick's time.
      * @param data Pointer to the TelemetryData structure to update
      */
-    void updateTelemetry(TelemetryData* data, ForceSensor* forceSensor);
+    void updateTelemetry(TelemetryData* data);
 
     /**
      * @brief Enables the motors and sets their default parameters (non-blocking).
@@ -179,12 +362,95 @@ public:
      */
     bool isBusy() const;
 
+    /**
+     * @brief Estimates the stored recipe with the current machine settings into g_cycleEstimate.
+     * @param from_position true to start from the commanded position (a run about to
+     * start), false from the retract position (an upload)
+     */
+    void estimateRecipe(bool from_position);
+
+    /**
+     * @brief Checks if the press is homed and parked at its retract position with nothing running.
+     * @return `true` when idle, enabled, free of faults and between home and the retract
+     *         position (home alone if none is set), give or take FORCE_ZERO_TRACK_RETRACT_TOL_MM.
+     */
+    bool isRetractedIdle() const;
+
+    /**
+     * @brief Checks if a move is pressing: running and loaded to the press threshold or more.
+     * @details Reads the load cell in load_cell mode and the torque model otherwise, the
+     * force the move's own limit is checked against.
+     * @return `true` while STATE_MOVING with the force at or above the press threshold.
+     */
+    bool isPressing() const;
+
+    /**
+     * @brief Gets the fused force estimate: HLFB torque for fast changes, the load cell for the level.
+     * @return Force in kg (0 while no move is sampling torque or before the first load-cell sample)
+     */
+    float getFusedForce() const { return m_fusedKg; }
+
+    /**
+     * @brief Gets how many run_recipe runs have ended with their DONE.
+     * @return Count since boot (wraps); compare before and after a run
+     */
+    uint32_t getRecipeDoneCount() const { return m_recipeDoneCount; }
+
+    /**
+     * @brief Checks if a run_recipe run owns the active move.
+     * @return `true` from run_recipe until its DONE or its stop.
+     */
+    bool isRecipeRunning() const;
+
+    /**
+     * @brief Checks if a move is paused (pause, or a "hold" force limit).
+     * @return `true` while MOVE_PAUSED.
+     */
+    bool isPaused() const { return m_state == STATE_MOVING && m_moveState == MOVE_PAUSED; }
+
+#if PRESS_SYNC_ENABLED
+    /**
+     * @brief Holds every run_recipe segment at its start until releaseSyncSegment() (see press_sync.h).
+     * @details Also keeps blending off, as a blended boundary has no stop to hold at.
+     * @param enabled true while press sync is on
+     */
+    void setSyncGate(bool enabled) { m_syncGate = enabled; }
+
+    /**
+     * @brief Gets the run_recipe segment held at its start.
+     * @return Segment number (1-based), or 0 if none is waiting
+     */
+    uint8_t getSyncWaitSegment() const;
+
+    /**
+     * @brief Starts the held segment once Microseconds() reaches @p at_us (at once if past).
+     * @param at_us Local start time
+     */
+    void releaseSyncSegment(uint32_t at_us);
+#endif
+
+    /**
+     * @brief Checks if both motor drives report enabled.
+     * @return `true` once the enable requested in setup() has taken effect on both motors.
+     */
+    bool drivesEnabled() const;
+
     /**
      * @brief Gets the current high-level state as a human-readable string.
      * @return A `const char*` representing the current state (e.g., "Homing", "Feeding").
      */
     const char* getState() const;
 
+    /**
+     * @brief Gets the raw state and homing phase, for the crash snapshot.
+     * @param[out] state Top-level state value
+     * @param[out] homingPhase Homing phase value
+     */
+    void getStateCodes(uint8_t* state, uint8_t* homingPhase) const {
+        *state = (uint8_t)m_state;
+        *homingPhase = (uint8_t)m_homingPhase;
+    }
+
     /**
      * @brief Pauses any active move operation (called by GUI hold event).
      */
@@ -199,6 +465,16 @@ public:
      * @brief Sets machine strain compensation coefficients and saves to NVM.
      */
     void setMachineStrainCoeffs(float coeff_x4, float coeff_x3, float coeff_x2, float coeff_x1, float coeff_c);
+
+    /**
+     * @brief Collects the machine strain samples of the last press capture.
+     * @details Deflection is measured from the first sample at the press threshold, and
+     * only samples that advance past the previous one count, so the retract and any dwell
+     * are left out. Forces come from the primary load cell's raw counts.
+     * @param fit Receives the samples (reset first)
+     * @return Highest force of the collected samples (kg)
+     */
+    float collectStrainFit(MachineStrainFit* fit) const;
     
     /**
      * @brief Cancels any active move operation (called by GUI reset event).
@@ -217,6 +493,27 @@ public:
      * @return The current force mode string
      */
     const char* getForceMode() const;
+
+    /**
+     * @brief Checks whether force limits and energy use the load cell(s).
+     * @return true in load_cell mode, false in motor_torque mode
+     */
+    bool isLoadCellMode() const { return m_force_mode == FORCE_MODE_LOAD_CELL; }
+
+    /**
+     * @brief Resolves a protocol force_action name.
+     * @param name "hold", "skip", "retract", "abort", "regulate" or "seat"
+     * @param action Receives the action
+     * @return false if @p name is not a force action
+     */
+    static bool parseForceAction(const char* name, ForceAction* action);
+
+    /**
+     * @brief Gets the protocol name of a force action.
+     * @param action Force action
+     * @return Name, or "none" for FORCE_ACTION_NONE
+     */
+    static const char* forceActionName(ForceAction action);
     
     /**
      * @brief Sets the calibration offset for the current force mode.
@@ -230,6 +527,13 @@ public:
      */
     void setForceCalibrationScale(float scale);
     
+    /**
+     * @brief Sets the motor torque calibration whatever the force mode (used by select_profile).
+     * @param scale Torque% per kg
+     * @param offset Torque% at zero force
+     */
+    void setTorqueCalibration(float scale, float offset);
+    
     /**
      * @brief Gets the calibration offset for the current force mode.
      * @return Current offset value
@@ -275,12 +579,151 @@ public:
      */
     bool setPressThreshold(float threshold_kg);
     
+    /**
+     * @brief Selects the velocity profile for press moves and saves it to NVM.
+     * @param jerk_mmss3 Jerk limit for S-curve moves, or 0 for trapezoidal moves
+     * @return false if @p jerk_mmss3 is non-zero and outside the accepted range
+     */
+    bool setMotionJerk(float jerk_mmss3);
+    
+    /**
+     * @brief Gets the S-curve jerk limit.
+     * @return Jerk in mm/s^3 (0 = trapezoidal)
+     */
+    float getMotionJerk() const { return m_motionJerkMmss3; }
+    
+    /**
+     * @brief Sets the rapid traverse limits for retracts and learned approaches and saves them to NVM.
+     * @details A non-working stroke may run up to @p vel_mms with @p accel_mmss instead of
+     * MOVE_SPEED_MAX_MMS and the move acceleration, but only if the selected load cell is
+     * connected and reads below RAPID_FORCE_GATE_KG when it starts. A rapid retract that
+     * sees more force than that on the way is stopped as a collision.
+     * @param vel_mms Speed ceiling (1 to RAPID_VEL_MAX_MMS), or 0 to turn rapid traverse off
+     * @param accel_mmss Acceleration (RAPID_ACCEL_UNIT_MMSS to RAPID_ACCEL_MAX_MMSS, rounded down to RAPID_ACCEL_UNIT_MMSS)
+     * @return false if a value is out of range
+     */
+    bool setRapidTraverse(int vel_mms, int accel_mmss);
+    
+    /**
+     * @brief Gets the rapid traverse speed ceiling.
+     * @return mm/s (0 = off)
+     */
+    int getRapidVelMms() const { return m_rapidVelMms; }
+    
+    /**
+     * @brief Gets the rapid traverse acceleration.
+     * @return mm/s^2
+     */
+    int getRapidAccelMmss() const { return m_rapidAccelMmss; }
+    
+    /**
+     * @brief Configures encoder position verification and saves it to NVM.
+     * @param counts_per_mm Encoder resolution (negative if it counts down as the press extends), or 0 to disable
+     * @param tolerance_mm Largest allowed difference between measured and commanded position
+     * @return false if either value is out of range
+     */
+    bool setEncoderFeedback(float counts_per_mm, float tolerance_mm);
+    
+    /**
+     * @brief Gets the encoder resolution.
+     * @return Counts per mm (0 = encoder verification off)
+     */
+    float getEncoderCountsPerMm() const { return m_encoderCountsPerMm; }
+    
+    /**
+     * @brief Gets the encoder position tolerance.
+     * @return Tolerance in mm
+     */
+    float getEncoderToleranceMm() const { return m_encoderToleranceMm; }
+    
+    /**
+     * @brief Sets the speed-dependent friction table for motor_torque mode and stages it for NVM.
+     * @details Each point is the extra HLFB torque measured with no load at that speed. It is
+     * interpolated at each motor's commanded step rate (held flat past the ends) and subtracted
+     * before torque is compared with a force-derived limit or converted to force.
+     * @param speed_mms Speeds in mm/s, strictly increasing, 0 to TORQUE_FRICTION_SPS_MAX steps/s
+     * @param torque_pct Friction torque (%) at each speed
+     * @param count 1 to TORQUE_FRICTION_MAX_POINTS, or 0 to clear the table
+     * @return false if the table is invalid (the previous table is kept)
+     */
+    bool setTorqueFriction(const float* speed_mms, const float* torque_pct, uint8_t count);
+
+    /**
+     * @brief Checks for a friction table set since the last NVM write.
+     * @return true if commitTorqueFriction() has work
+     */
+    bool isTorqueFrictionPending() const { return m_frictionNvmPending; }
+
+    /**
+     * @brief Writes the staged friction table to NVM: one block write of the points, then the count.
+     * @return false if a write was refused (the table stays staged)
+     */
+    bool commitTorqueFriction();
+
+    /**
+     * @brief Erases the stored friction table for the next boot, and drops a staged one.
+     */
+    void eraseTorqueFriction();
+    
+    /**
+     * @brief Gets the number of friction table points.
+     * @return 0 if no friction model is set
+     */
+    uint8_t getTorqueFrictionCount() const { return m_frictionCount; }
+    
+    /**
+     * @brief Gets one friction table point.
+     * @param index Point index
+     * @param speed_mms Receives the speed in mm/s
+     * @param torque_pct Receives the friction torque (%)
+     * @return false if @p index is out of range
+     */
+    bool getTorqueFrictionPoint(uint8_t index, float* speed_mms, float* torque_pct) const;
+    
     /**
      * @brief Gets the current press force threshold.
      * @return Press threshold in kg
      */
     float getPressThreshold() const { return m_press_threshold_kg; }
     
+    /**
+     * @brief Selects which load cell(s) the force checks use and saves to NVM.
+     * @param channel "a" (COM-0), "b" (COM-1) or "sum" (both)
+     * @return true if the selector was valid
+     */
+    bool setForceChannel(const char* channel);
+    
+    /**
+     * @brief Gets the current force channel selector.
+     * @return "a", "b" or "sum"
+     */
+    const char* getForceChannel() const;
+    
+    /**
+     * @brief Gets the load cell(s) the force checks use.
+     * @return The channel selector
+     */
+    ForceChannelSelect getForceChannelSelect() const { return m_forceChannel; }
+    
+    /**
+     * @brief Gets the summed force of both load cells.
+     * @return Channel A + channel B filtered force in kg
+     */
+    float getSummedForce() const;
+    
+    /**
+     * @brief Gets the force imbalance between the load cells (racked platen detection).
+     * @return Channel A - channel B filtered force in kg
+     */
+    float getDifferentialForce() const;
+    
+    /**
+     * @brief Checks whether one load-cell channel is receiving data.
+     * @param channel 0 = A (COM-0), 1 = B (COM-1)
+     * @return true if the channel had a reading in the last second
+     */
+    bool isForceChannelConnected(uint8_t channel) const;
+    
     /**
      * @brief Gets the position where press threshold was crossed.
      * @return Startpoint position in mm
@@ -288,16 +731,44 @@ public:
     float getPressStartpoint() const { return m_press_startpoint_mm; }
     
     /**
-     * @brief Gets the current state of Motor A (M0) home sensor.
+     * @brief Gets the current state of one axis' home sensor.
+     * @param axis 0 .. getAxisCount() - 1
      * @return true if sensor is triggered (active), false otherwise
      */
-    bool getHomeSensorStateM0() const;
+    bool getHomeSensorActive(int axis) const;
     
     /**
-     * @brief Gets the current state of Motor B (M1) home sensor.
-     * @return true if sensor is triggered (active), false otherwise
+     * @brief Gets the number of ganged motors driven.
+     * @return Axes (1 .. MOTOR_AXIS_MAX)
+     */
+    int getAxisCount() const { return m_axisCount; }
+    
+#if THERMAL_MODEL_ENABLED
+    /**
+     * @brief Gets the thermal load of the hottest motor.
+     * @param axis Receives that motor's index, if not NULL
+     * @return Percent of the continuous rating (see motor_thermal.h)
+     */
+    float getThermalLoadPct(int* axis = NULL) const;
+    
+    /**
+     * @brief Reports whether new presses are held until the motors cool.
+     * @return true between THERMAL_LIMIT_PCT and the fall below THERMAL_RESUME_PCT
+     */
+    bool isThermalHold() const { return m_thermalHold; }
+#endif
+    
+#if PRESSBOI_BENCHMARK
+    /**
+     * @brief Feeds a synthetic press through the joule integration, timing each sample.
+     * @details Idle only. The integration state is saved first and restored afterwards,
+     * so telemetry and the next move are unaffected.
+     * @param samples Samples to integrate
+     * @param min_cycles Receives the fastest sample
+     * @return Total cycles of all samples
      */
-    bool getHomeSensorStateM1() const;
+    uint32_t benchmarkJoules(uint16_t samples, uint32_t* min_cycles);
+#endif
 
 private:
     /**
@@ -307,37 +778,166 @@ private:
     void startMove(long steps, int velSps, int accelSps2);
     void startMoveAxis(int axis, long steps, int velSps, int accelSps2);
     void stopAxis(int axis);
+    void stopAllAxes();
+    bool allAxesSet(const bool* flags) const;
+    int countAxesSet(const bool* flags) const;
+    void appendAxisStatus(char* msg, size_t size) const;
+    void appendHomeSensorStates(char* msg, size_t size);
     bool isMoving();
     bool isAxisMoving(int axis);
-    float getSmoothedTorque(MotorDriver *motor, float *smoothedValue, bool *firstRead);
-    bool checkTorqueLimit();
+    bool homingMoveStarted(bool all_axes, const char* failure);
+    /** @brief Home-relative position of an absolute commanded step position. */
+    Millimeters homeRelative(long position_steps) const {
+        return toMillimeters(Steps(position_steps - m_machineHomeReferenceSteps));
+    }
+    /** @brief Absolute commanded step position of a home-relative position. */
+    long absoluteSteps(Millimeters position) const {
+        return m_machineHomeReferenceSteps + toSteps(position).value;
+    }
+    float getSmoothedTorque(int axis) const;
+    float getLoadTorque(int axis) const;
+    float torqueForceKg() const;
+    void torqueJoulesTick();
+    void forceFusionTick();
+#if STATION_IO_ENABLED
+    void interlockTick();
+#endif
+#if THERMAL_MODEL_ENABLED
+    void thermalTick();
+    void serviceThermal();
+#endif
+    void telemetrySnapshotTick();
+    void readTelemetrySnapshot(TelemetrySnapshot* out) const;
+    bool checkTorqueLimit(bool friction_compensated = false);
     bool checkForceSensorStatus(const char** errorMsg);
-    void handleLimitReached(const char* limit_type, float limit_value);
+    bool rapidTraverseAllowed();
+    float traverseCeilingMms();
+    int limitTraverse(float* speed_mms);
+    void handleLimitReached(StatusEventId limit_event, float arg0, float arg1 = 0.0f);
+    /**
+     * @enum MoveStartResult
+     * @brief Outcome of startCompiledMove().
+     */
+    typedef enum {
+        MOVE_START_FAILED,  ///< Validation failed; ERROR already reported.
+        MOVE_START_NOOP,    ///< Already at the target; nothing started.
+        MOVE_START_OK       ///< Move started.
+    } MoveStartResult;
+    bool compileMoveAbs(const CommandArgs& args, CompiledSegment* out, bool* speed_limited);
+#if MOVE_CACHE_SIZE > 0
+    bool findCachedMove(const CommandArgs& args, uint32_t key, CompiledSegment* out);
+    void cacheMove(const CommandArgs& args, uint32_t key, const CompiledSegment& move, bool speed_limited);
+#endif
+    bool compileSegment(const MotionSegment& segment, CompiledSegment* out);
+    MoveStartResult startCompiledMove(const CompiledSegment& move, const char* command_name,
+                                      bool continuing, bool blend);
+    bool compileMotionQueue(const char* command_name);
+    MoveStartResult startNextQueuedSegment(bool continuing, bool blend);
+    bool handoffQueuedSegment(bool blend);
+    void tryBlendQueuedSegment();
     void finalizeAndResetActiveMove(bool success);
     void fullyResetActiveMove();
+    void reportMoveDone(const char* command);
+    void beginMoveStats();
+    void updateMoveStats();
+    void recordTripLatency(uint32_t latency_us);
+    int formatMoveStats(char* buffer, size_t size) const;
+    uint32_t droppedSampleCount() const;
     void updateJoules();
-    void reportEvent(const char* statusType, const char* message);
+    void drainForceSamples();
+    void recordPositionHistory();
+    ForceSensor& primaryForceSensor() const;
+    uint32_t predictLeadUs() const;
+    float getSelectedForce() const;
+    long positionAtTimeSteps(uint32_t time_us) const;
+    void integrateForceSample(float force_kg, long current_pos_steps);
+    void armForceTrip(bool resuming = false);
+    void seatDetectSample(long position_steps, float force_kg);
+    bool captureDetail(long position_steps, float force_kg);
+    void envelopeSample(long position_steps, float force_kg);
+    void beginCapture();
+    static void forceTripHook(void* context);
+    void armTripRetract();
+    void issueTripRetract();
+    void startTripRetract();
+    static void controlTickHook(void* context);
+#if FORCE_REPLAY_ENABLED
+    static int32_t replayPositionHook(void* context);
+#endif
+    void controlTick();
+    void axisSnapshotTick();
+    MotorDriver::StatusRegMotor tickStatus(int axis) const { return MotorDriver::StatusRegMotor(m_tickAxis[axis].status_reg); }
+    void torqueSampleTick();
+    void forceRegulateTick();
+    bool serviceForceRegulation();
+    void planAdaptiveApproach(uint8_t step, float force_kg, bool regulate, long target_steps, long move_origin,
+                              long* first_steps, int* first_sps);
+    void armZones(bool resuming);
+    void compileZoneForce(CompiledZone* zone) const;
+    void zoneTick();
+    void serviceAdaptiveApproach();
+    void startProfiledMove(long steps, int velSps, int accelSps2);
+    void profileTick();
+    void configureEncoder(float counts_per_mm, float tolerance_mm);
+    bool applyTorqueFriction(const int32_t* sps, const float* torque_pct, uint8_t count);
+    float frictionTorqueAt(int32_t sps) const;
+    void alignEncoder();
+    void encoderCheckTick();
+    void serviceEncoderFault();
+#if RACKING_CORRECTION_ENABLED
+    void armRacking();
+    void rackingTick();
+    void serviceRackingFault();
+#endif
+#if HOMING_RESTORE_ENABLED
+    void loadHomeRecord();
+    void saveHomeRecord();
+    uint8_t homeSensorMask() const;
+#endif
+    void reportEvent(TextView statusType, TextView message);
+    void reportEvent(const char* statusType, const char* message) {
+        reportEvent(text_view(statusType), text_view(message));
+    }
+    void postEvent(StatusEventId id, EventArg arg0 = eventArgI(0), EventArg arg1 = eventArgI(0),
+                   EventArg arg2 = eventArgI(0));
     
     // Home sensor methods for gantry squaring
     void setupHomeSensors();
     bool isHomeSensorTriggered(int axis);
     bool getHomeSensorState(int axis);
+    void armHomeLatch(int axis);
+    long takeHomeLatch(int axis);
+    void latchHomeSensor(int axis);
+    template <int SLOT> static void homeSensorIsr();
+    void startAxisHomingMove(int axis, long steps, int velSps);
+    void startAxisHomingApproach(int axis);
+    bool startAxisHybridApproach(int axis);
+    void disarmHomingSpike(int axis);
+    void homingSpikeTick();
+    bool axisHomingMoveDone(int axis);
+    bool advanceAxisHoming(int axis);
     /** @} */
 
     /**
      * @name Private Command Handlers
      * @{
      */
-    void home();
-    void setRetract(const char* args);
-    void moveAbsolute(const char* args);
-    void moveIncremental(const char* args);
-    void retract(const char* args);
+    void home(const CommandArgs* args);
+    void setRetract(const CommandArgs* args);
+    void moveAbsolute(const CommandArgs* args);
+    void moveIncremental(const CommandArgs* args);
+    void retract(const CommandArgs* args);
+    void queueMove(const CommandArgs* args);
+    void queueRun();
+    void queueClear();
+    void runRecipe(const CommandArgs* args);
+    void startMotionQueue(const char* command_name);
     /** @} */
     
     Pressboi* m_controller;      ///< Pointer to the main `Pressboi` controller for event reporting.
-    MotorDriver* m_motorA;       ///< Pointer to the primary motor driver (M0).
-    MotorDriver* m_motorB;       ///< Pointer to the secondary, ganged motor driver (M1).
+    MotorDriver* m_motors[MOTOR_AXIS_MAX]; ///< Ganged motor drivers, reference axis (M0) first.
+    DigitalIn* m_homeSensors[MOTOR_AXIS_MAX]; ///< Home sensor of each motor.
+    int m_axisCount;             ///< Entries of m_motors in use.
 
     /**
      * @enum State
@@ -363,41 +963,90 @@ private:
         HOMING_PHASE_IDLE,              ///< Homing is not active.
         // Rapid approach - both axes move toward home, stop individually on sensor trigger
         RAPID_APPROACH_START,           ///< Starting rapid approach move toward home sensors.
-        RAPID_APPROACH_WAIT_TO_START,   ///< Waiting for rapid move to begin.
+        RAPID_APPROACH_WAIT_TO_START,   ///< Rapid move not yet taken up (fault after MOVE_START_TIMEOUT_MS).
         RAPID_APPROACH_MOVING,          ///< Executing rapid move, monitoring sensors independently.
         // Backoff - both axes back off together after sensor trigger
         BACKOFF_START,                  ///< Starting backoff move away from sensors.
-        BACKOFF_WAIT_TO_START,          ///< Waiting for backoff move to begin.
+        BACKOFF_WAIT_TO_START,          ///< Backoff move not yet taken up (fault after MOVE_START_TIMEOUT_MS).
         BACKOFF_MOVING,                 ///< Executing backoff move.
         // Slow approach - both axes move slowly, stop individually on sensor trigger
         SLOW_APPROACH_START,            ///< Starting slow approach for precision homing.
-        SLOW_APPROACH_WAIT_TO_START,    ///< Waiting for slow move to begin.
+        SLOW_APPROACH_WAIT_TO_START,    ///< Slow move not yet taken up (fault after MOVE_START_TIMEOUT_MS).
         SLOW_APPROACH_MOVING,           ///< Executing slow move, monitoring sensors independently.
         // Final backoff and set zero
         FINAL_BACKOFF_START,            ///< Starting final backoff to offset position.
-        FINAL_BACKOFF_WAIT_TO_START,    ///< Waiting for final backoff to begin.
+        FINAL_BACKOFF_WAIT_TO_START,    ///< Final backoff not yet taken up (fault after MOVE_START_TIMEOUT_MS).
         FINAL_BACKOFF_MOVING,           ///< Executing final backoff move.
+        // Parallel homing - each axis runs its own AxisHomingPhase sequence
+        PARALLEL_HOMING_START,          ///< Starting the first move of each axis.
+        PARALLEL_HOMING_MOVING,         ///< Advancing each axis until both reach the offset.
         SET_ZERO,                       ///< Setting the final position as the logical zero.
         HOMING_PHASE_ERROR              ///< Homing sequence failed.
     } HomingPhase;
     HomingPhase m_homingPhase; ///< The current phase of an active homing sequence.
+    State m_tracedState;       ///< m_state as of the last TRACE_MOTOR_STATE record.
+    HomingPhase m_tracedHomingPhase; ///< m_homingPhase as of the last TRACE_MOTOR_STATE record.
+
+    /**
+     * @enum AxisHomingPhase
+     * @brief Per-axis sub-states used by parallel homing.
+     * @details Neither axis waits for the other between phases; the sequence only joins
+     * at SET_ZERO. A trusted home starts at AXIS_HOMING_VERIFY_APPROACH instead of the
+     * full-stroke search and drops back to it if the sensor is not where it was. "home hybrid"
+     * puts AXIS_HOMING_HYBRID_APPROACH in front of either while a trigger point is learned.
+     */
+    typedef enum {
+        AXIS_HOMING_IDLE,               ///< Axis not homing.
+        AXIS_HOMING_HYBRID_APPROACH,    ///< Fast positional move to HOMING_HYBRID_SLOW_MM short of the learned trigger point.
+        AXIS_HOMING_VERIFY_APPROACH,    ///< Positional move to just short of the trusted trigger point.
+        AXIS_HOMING_RAPID,              ///< Full-stroke rapid search for the sensor.
+        AXIS_HOMING_RAPID_STOPPING,     ///< Decelerating after the rapid search found the sensor.
+        AXIS_HOMING_BACKOFF,            ///< Backing off the sensor before the touch.
+        AXIS_HOMING_TOUCH,              ///< Slow touch onto the sensor.
+        AXIS_HOMING_TOUCH_STOPPING,     ///< Decelerating after the touch found the sensor.
+        AXIS_HOMING_OFFSET,             ///< Moving to the offset position.
+        AXIS_HOMING_DONE                ///< At the offset, waiting for the other axis.
+    } AxisHomingPhase;
+    AxisHomingPhase m_axisHomingPhase[MOTOR_AXIS_MAX]; ///< Parallel homing phase of each axis.
 
     MoveState m_moveState;             ///< The current state of a move operation.
     bool m_homingDone;                 ///< Flag indicating if homing has been successfully completed.
     bool m_retractDone;                ///< Flag indicating if retract position has been set.
     bool m_pausedMessageSent;          ///< Flag to prevent spamming "paused" messages.
+    MoveState m_pausedMoveState;       ///< m_moveState when pause was requested, so a retract resumes as one.
+    bool m_pausedApproachRapid;        ///< The pause interrupted a rapid approach; resume continues it if the switch point is ahead.
     uint32_t m_homingStartTime;        ///< Timestamp (ms) when the homing sequence started, used for timeout.
+    uint32_t m_homingPhaseStartTime;   ///< Timestamp (ms) when the current lockstep homing move was issued.
     
     /**
      * @name Gantry Squaring Homing Variables
      * @brief Variables for independent axis tracking during gantry squaring homing.
      * @{
      */
-    bool m_axisAHomeSensorTriggered;   ///< M0 home sensor has been triggered in current phase.
-    bool m_axisBHomeSensorTriggered;   ///< M1 home sensor has been triggered in current phase.
-    bool m_axisAStopped;               ///< M0 has been stopped in current homing phase.
-    bool m_axisBStopped;               ///< M1 has been stopped in current homing phase.
+    bool m_axisHomeSensorTriggered[MOTOR_AXIS_MAX]; ///< Axis home sensor has been triggered in current phase.
+    bool m_axisStopped[MOTOR_AXIS_MAX]; ///< Axis has been stopped in current homing phase.
     bool m_homeSensorsInitialized;     ///< Flag indicating home sensors have been configured.
+    bool m_axisHomingMoveSeen[MOTOR_AXIS_MAX]; ///< The current parallel homing move of each axis has been seen running.
+    bool m_axisHomingVerify[MOTOR_AXIS_MAX]; ///< Axis is verifying a trusted home rather than searching.
+    bool m_homeTrusted;                ///< Every sensor was touched and the motors stayed enabled since.
+    long m_homeTriggerSteps[MOTOR_AXIS_MAX]; ///< Commanded position of each motor when its sensor triggered on the last touch.
+    bool m_homeLearned;                ///< m_homeTriggerSteps holds every axis' trigger point, and the position has not been lost since.
+    bool m_homingHybrid;               ///< The running home was started as "home hybrid".
+    volatile uint8_t m_homingSpikeAxes; ///< Axes on a hybrid approach the control tick watches for a torque spike (bit n = motor n).
+    uint8_t m_homingSpikeBaselineSet;  ///< Axes whose cruise torque baseline has been taken (ISR).
+    uint16_t m_homingSpikeSettleTicks[MOTOR_AXIS_MAX]; ///< Ticks each axis has cruised before its baseline (ISR).
+    float m_homingSpikeBaseline[MOTOR_AXIS_MAX]; ///< Friction-compensated cruise torque (%) of each axis (ISR).
+    volatile bool m_homingSpikeTripped; ///< Latched by the control tick when a hybrid approach hit something.
+    uint8_t m_homingSpikeAxis;         ///< Axis that tripped.
+    float m_homingSpikeRisePct;        ///< Torque rise (%) over the baseline that tripped.
+#if HOMING_RESTORE_ENABLED
+    bool m_homeRestored;               ///< A trusted home from before the reset is waiting for the next home to verify it.
+    uint8_t m_homeRestoredSensors;     ///< Home sensor bits (bit n = motor n active) the restored record was saved with.
+#endif
+    bool m_homeLatchAvailable;         ///< Sensor edge interrupts are registered for every axis.
+    int8_t m_homeLatchSlot[MOTOR_AXIS_MAX]; ///< Edge interrupt slot each axis' sensor claimed (-1 = none).
+    volatile bool m_homeLatchValid[MOTOR_AXIS_MAX]; ///< An active edge has been latched since the touch was armed (ISR).
+    volatile int32_t m_homeLatchSteps[MOTOR_AXIS_MAX]; ///< Commanded position at the latest active edge (ISR).
     /** @} */
     
     /**
@@ -411,26 +1060,172 @@ private:
     bool m_isEnabled;                  ///< Flag indicating if motors are currently enabled.
     float m_torqueLimit;               ///< Current torque limit (%) for detecting hard stops or stalls.
     float m_torqueOffset;              ///< User-configurable offset (%) for torque readings to account for bias.
-    char m_force_mode[16];             ///< Persistent force sensing mode: "motor_torque" or "load_cell" (stored in NVM)
+    ForceMode m_force_mode;            ///< Persistent force sensing mode (stored in NVM)
     float m_motor_torque_offset;       ///< Motor torque equation offset (stored in NVM, default 1.04)
     float m_motor_torque_scale;        ///< Motor torque equation scale (stored in NVM, default 0.0335)
-    char m_polarity[16];               ///< Coordinate system polarity: "normal" or "inverted" (stored in NVM)
+    Polarity m_polarity;               ///< Coordinate system polarity (stored in NVM)
     bool m_home_on_boot;               ///< Home on boot setting: true = auto-home, false = skip (stored in NVM, default true)
     float m_retract_position_mm;       ///< Retract position in mm (stored in NVM, default 0.0)
     float m_press_threshold_kg;        ///< Force threshold (kg) for energy/startpoint recording (stored in NVM, default 2.0)
-    float m_smoothedTorqueValue0, m_smoothedTorqueValue1; ///< Smoothed torque values for each motor.
-    bool m_firstTorqueReading0, m_firstTorqueReading1;   ///< Flags for initializing the torque smoothing EWMA filter.
+    ForceChannelSelect m_forceChannel; ///< Load cell(s) used by force checks (stored in NVM, default A)
+    volatile AxisState m_tickAxis[MOTOR_AXIS_MAX]; ///< Driver state of each motor, read once per control tick (owned by the ISR)
+    volatile bool m_tickTorqueArmed;   ///< Control tick compares HLFB torque against m_torqueLimit
+    volatile bool m_tickTorqueTripped; ///< Latched by the control tick when the torque limit was crossed
+    volatile float m_tickTorque[MOTOR_AXIS_MAX]; ///< EWMA of each motor's HLFB torque, advanced once per control tick (owned by the ISR)
+    volatile bool m_tickTorqueSeeded[MOTOR_AXIS_MAX]; ///< False until m_tickTorque has a reading for the current move
+    volatile bool m_tickTorqueReseed;  ///< Set from the main loop; the next tick restarts every torque filter
+    volatile float m_tickFriction[MOTOR_AXIS_MAX]; ///< Friction torque (%) at each motor's commanded speed, filtered like m_tickTorque
+    volatile float m_tickTorqueFast[MOTOR_AXIS_MAX]; ///< HLFB torque filtered with FORCE_FUSION_TORQUE_ALPHA for the fused force (owned by the ISR)
+#if HLFB_HIGH_RATE_ENABLED
+    float m_tickHlfbLast[MOTOR_AXIS_MAX]; ///< HlfbPercent() of the last new measurement (owned by the ISR)
+    uint8_t m_tickHlfbAge[MOTOR_AXIS_MAX]; ///< Ticks since m_tickHlfbLast was taken (owned by the ISR)
+#endif
+    float m_fusionHistory[FORCE_FUSION_HISTORY]; ///< Torque-model force of the last ticks, newest at m_fusionHead - 1 (owned by the ISR)
+    uint16_t m_fusionHead;             ///< Next m_fusionHistory slot to write
+    uint16_t m_fusionCount;            ///< Valid m_fusionHistory entries
+    uint32_t m_fusionLastSampleUs;     ///< Load-cell sample time the bias was last corrected with
+    uint16_t m_fusionSamples;          ///< Bias corrections since the torque filter was seeded
+    float m_fusionBias;                ///< Load cell minus torque-model force at the same instant (kg)
+    volatile float m_fusedKg;          ///< Latest fused force (kg), 0 when no estimate
+    volatile bool m_fusionTripArmed;   ///< Control tick compares m_fusedKg against the load-cell limit
+    volatile bool m_fusionTripped;     ///< Latched by the control tick when the fused force crossed the limit
+    volatile float m_fusionTripKg;     ///< Fused force that fired the trip
+    volatile uint32_t m_fusionTripLatencyUs; ///< Newest load-cell sample until the fusion trip's stop was issued
+    TelemetrySnapshot m_telemetrySnapshots[2]; ///< Written by the control tick, the other one than m_telemetryFront
+    volatile uint8_t m_telemetryFront; ///< Index of the latest completed snapshot
+    volatile uint32_t m_telemetrySeq;  ///< Snapshots completed (wraps)
+    uint8_t m_frictionCount;           ///< Friction table points (stored in NVM, 0 = no friction model)
+    int32_t m_frictionSps[TORQUE_FRICTION_MAX_POINTS];   ///< Table step rates, strictly increasing
+    float m_frictionPct[TORQUE_FRICTION_MAX_POINTS];     ///< Friction torque (%) at each step rate
+    float m_frictionSlope[TORQUE_FRICTION_MAX_POINTS];   ///< Torque (%) per step/s from each point to the next
+    int32_t m_frictionNvm[TORQUE_FRICTION_MAX_POINTS];   ///< Staged NVM image: centi-% << 16 | steps/s per point
+    uint8_t m_frictionNvmCount;        ///< Points in m_frictionNvm
+    bool m_frictionNvmPending;         ///< m_frictionNvm not written to NVM yet
+    /**
+     * @enum RegulateFault
+     * @brief Why the control tick ended a regulated move.
+     */
+    enum RegulateFault : uint8_t {
+        REGULATE_FAULT_NONE,       ///< Still regulating (or ended normally).
+        REGULATE_FAULT_OVERFORCE,  ///< Force overshot FORCE_REGULATE_OVERFORCE_FACTOR x target.
+        REGULATE_FAULT_OVERTRAVEL  ///< Reached the move's end position without holding the target.
+    };
+    bool m_forceRegulate;              ///< Active move uses force_action "regulate"
+    volatile bool m_regulateArmed;     ///< Control tick runs the force PI loop
+    volatile bool m_regulateVelocityMode; ///< Tick has taken over from the approach move with MoveVelocity()
+    volatile uint8_t m_regulateFault;  ///< RegulateFault latched by the tick
+    volatile float m_regulateErrorKg;  ///< Latest target - force, for settle detection in the main loop
+    float m_regulateIntegral;          ///< PI integral term in mm/s (owned by the ISR)
+    uint32_t m_regulateLastSampleUs;   ///< Load-cell sample the tick last acted on
+    int m_regulateDir;                 ///< +1 or -1: direction of increasing force
+    long m_regulateLimitSteps;         ///< Furthest position the regulator may drive to
+    float m_regulateMaxMms;            ///< Speed ceiling for the regulator (the move's speed)
+    uint32_t m_regulateDwellMs;        ///< Time to hold the target once settled
+    uint32_t m_regulateContactAt;      ///< Milliseconds() when velocity regulation began (0 = not yet)
+    uint32_t m_regulateSettledAt;      ///< Milliseconds() when the force first settled (0 = not yet)
+    bool m_seatArmed;                  ///< Active move uses force_action "seat"
+    bool m_seatDetected;               ///< Stiffness jump seen; handled in updateState()
+    int32_t m_seatWindowPos[SEAT_DETECT_WINDOW]; ///< Slope window positions, steps from m_seatOriginSteps
+    int32_t m_seatWindowForce[SEAT_DETECT_WINDOW]; ///< Slope window forces (0.01 kg)
+    uint16_t m_seatHead;               ///< Next window slot to overwrite
+    uint16_t m_seatCount;              ///< Filled window slots
+    long m_seatOriginSteps;            ///< Position of the first in-contact sample
+    bool m_envelopeArmed;              ///< Active move is a recipe move checked against the recipe envelope
+    bool m_envelopeTripped;            ///< A sample left the envelope and the axes were stopped; handled in updateState()
+    float m_envelopePositionMm;        ///< Position of the sample that left the envelope
+    float m_envelopeKg;                ///< Force of that sample
+    float m_envelopeBoundKg;           ///< Band edge it crossed
+#if THERMAL_MODEL_ENABLED
+    MotorThermalModel m_thermal[MOTOR_AXIS_MAX]; ///< I2t heat of each motor, fed by the control tick
+    bool m_thermalHold;                ///< New presses are refused until the hottest motor is below THERMAL_RESUME_PCT
+    bool m_thermalWarned;              ///< THERMAL_WARN_PCT was reported for the current excursion
+#endif
+#if STATION_IO_ENABLED
+    volatile bool m_interlockArmed;    ///< A recipe run is watched by the control tick for the station interlock
+    volatile bool m_interlockTripped;  ///< Latched by the control tick when the interlock opened and the axes were stopped
+    volatile uint32_t m_interlockInputs; ///< Station inputs of the tick that tripped
+    volatile uint32_t m_interlockFaults; ///< Interlock inputs out of state in that tick
+#endif
+    CompiledZone m_zones[RECIPE_ZONE_MAX]; ///< Recipe limit map of the active move
+    uint8_t m_zoneCount;               ///< Valid entries in m_zones
+    volatile bool m_zoneArmed;         ///< The control tick applies m_zones; cleared by any other command to the axes
+    bool m_zoneSpeedControl;           ///< Band speeds apply (trapezoidal move)
+    bool m_zoneForceControl;           ///< Band force limits apply (load-cell move with a force limit)
+    int m_zoneDir;                     ///< +1 or -1: travel direction of the move
+    int8_t m_zoneActive;               ///< Band whose limits are applied (-1 = none, -2 = none applied yet)
+    int32_t m_zoneSpeedSps;            ///< Speed the tick last issued (-1 = none yet)
+    CompiledZone m_zoneBase;           ///< The move's own limits, applied outside every band
+    int64_t m_seatSumX;                ///< Exact running sums over the window for the least-squares slope
+    int64_t m_seatSumY;
+    int64_t m_seatSumXX;
+    int64_t m_seatSumXY;
+    float m_seatBaselineKgMm;          ///< Smoothed slope since contact
+    uint16_t m_seatBaselineSamples;    ///< Slopes folded into the baseline
+    float m_seatStiffnessKgMm;         ///< Slope that triggered the seat
+    int8_t m_adaptiveStep;             ///< Recipe step whose contact point this move learns (-1 = none)
+    int m_adaptiveDir;                 ///< +1 or -1: travel direction of the learning move
+    bool m_approachRapid;              ///< Move is still on its rapid approach to m_approachSwitchSteps
+    long m_approachSwitchSteps;        ///< Learned contact minus the margin, where the press speed starts
+    int m_approachRapidSps;            ///< Rapid approach speed (steps/sec)
+    float m_motionJerkMmss3;           ///< S-curve jerk limit (stored in NVM, 0 = trapezoidal)
+    int m_rapidVelMms;                 ///< Rapid traverse ceiling (stored in NVM, 0 = off)
+    int m_rapidAccelMmss;              ///< Rapid traverse acceleration (stored in NVM)
+    int m_rapidAccelSps2;              ///< m_rapidAccelMmss in steps/sec^2
+    bool m_rapidActive;                ///< Current retract runs as a rapid traverse and is supervised for force
+    volatile bool m_tripRetractArmed;  ///< A limit trip reverses into the retract instead of stopping ("retract"/"abort" moves)
+    volatile bool m_tripRetractIssued; ///< Latched when the retract was started (by a trip ISR or startTripRetract())
+    long m_tripRetractTarget[MOTOR_AXIS_MAX]; ///< Retract position in each axis' own frame (absolute steps)
+    long m_tripRetractFromSteps;       ///< Reference axis commanded position when the retract was issued
+    int m_tripRetractSps;              ///< Retract speed (steps/sec)
+    int m_tripRetractAccelSps2;        ///< Retract acceleration (steps/sec^2)
+    float m_encoderCountsPerMm;        ///< Encoder resolution (stored in NVM, 0 = no encoder)
+    float m_encoderToleranceMm;        ///< Allowed measured-vs-commanded difference (stored in NVM)
+    float m_encoderCountsPerStep;      ///< |m_encoderCountsPerMm| per step of the active geometry, used by the control tick
+    float m_encoderToleranceCounts;    ///< m_encoderToleranceMm in encoder counts
+    int32_t m_encoderOffsetCounts;     ///< Encoder count that corresponds to commanded position 0
+    volatile bool m_encoderArmed;      ///< Control tick compares encoder and commanded position
+    volatile bool m_encoderTripped;    ///< Latched by the control tick when the difference exceeded the tolerance
+    volatile bool m_encoderQuadratureFault; ///< The trip was a quadrature error rather than a position difference
+    volatile float m_encoderErrorMm;   ///< Measured minus commanded position at the trip
+#if RACKING_CORRECTION_ENABLED
+    volatile bool m_rackingArmed;      ///< Control tick trims and supervises the followers against M0
+    volatile bool m_rackingTripped;    ///< Latched by the control tick on a racking fault
+    volatile uint8_t m_rackingAxis;    ///< Follower that faulted
+    volatile float m_rackingTorqueDiff; ///< Its load torque minus M0's at the trip (%)
+    volatile int32_t m_rackingImbalanceSteps; ///< Its commanded position minus M0's, relative to the square, at the trip
+    bool m_rackSquareSet;              ///< m_rackBaselineSteps holds the square of the current home
+    int32_t m_rackBaselineSteps[MOTOR_AXIS_MAX]; ///< Commanded position of each follower minus M0's at the first move after homing
+    volatile float m_rackTrimSps[MOTOR_AXIS_MAX]; ///< Speed trim of each follower (steps/sec, + = faster in the direction of travel; owned by the ISR)
+    int32_t m_rackAppliedSps[MOTOR_AXIS_MAX]; ///< Trim last given to the follower's step generator while M0 cruises (owned by the ISR)
+    uint16_t m_rackOverTicks;          ///< Consecutive ticks over RACKING_FAULT_TORQUE_PCT (owned by the ISR)
+    float m_rackGainSpsPerPct;         ///< RACKING_TRIM_GAIN_MMS_PER_PCT in steps/sec
+    float m_rackTrimMaxSps;            ///< RACKING_TRIM_MAX_MMS in steps/sec
+    float m_rackTrimSlewSps;           ///< RACKING_TRIM_SLEW_MMS in steps/sec
+    long m_rackLeadMaxSteps;           ///< RACKING_TRIM_LEAD_MAX_MM in steps
+    long m_rackFaultSteps;             ///< RACKING_FAULT_MM in steps
+#endif
+    SCurveProfile m_profile;           ///< Plan of the S-curve move being streamed
+    volatile bool m_profileActive;     ///< Control tick is streaming m_profile to the step generators
+    bool m_profiledMove;               ///< Active move was started as an S-curve (not blended)
+    uint32_t m_profileTicks;           ///< Control ticks since the S-curve move started (owned by the ISR)
+    int m_profileDir;                  ///< +1 or -1: direction of the S-curve move
+    long m_profileTarget[MOTOR_AXIS_MAX]; ///< Each motor's commanded position at the end of the S-curve move
+    int m_profileAccelSps2;            ///< Acceleration used for the final positional correction
     int32_t m_machineHomeReferenceSteps, m_retractReferenceSteps; ///< Stored step counts for home and retract positions.
     float m_cumulative_distance_mm;    ///< Cumulative distance traveled (mm) since the last home.
     int m_moveDefaultTorquePercent;    ///< Default torque (%) for moves.
     long m_moveDefaultVelocitySPS;     ///< Default velocity (steps/sec) for moves.
     long m_moveDefaultAccelSPS2;       ///< Default acceleration (steps/sec^2) for moves.
+    int m_motorVelMaxSps;              ///< Drive velocity limit (steps/sec), MOTOR_DEFAULT_VEL_MAX_MMS in the active geometry.
+    int m_motorAccelMaxSps2;           ///< Drive acceleration limit (steps/sec^2), MOTOR_DEFAULT_ACCEL_MAX_MMSS in the active geometry.
     long m_homingDistanceSteps;        ///< Max travel distance (steps) for a homing move.
     long m_homingBackoffSteps;         ///< Backoff distance (steps) for a homing move.
     int m_homingRapidSps;              ///< Rapid speed (steps/sec) for a homing move.
     int m_homingTouchSps;              ///< Slow touch-off speed (steps/sec) for a homing move.
     int m_homingBackoffSps;            ///< Backoff speed (steps/sec) for a homing move.
     int m_homingAccelSps2;             ///< Acceleration (steps/sec^2) for homing moves.
+    int m_homingHybridSps;             ///< Hybrid approach speed (steps/sec).
+    int m_homingHybridAccelSps2;       ///< Hybrid approach acceleration (steps/sec^2).
     const char* m_activeMoveCommand;   ///< Stores the original move command string for logging upon completion.
     const char* m_originalMoveCommand; ///< Stores the very first command before any retract substitution.
     
@@ -439,8 +1234,9 @@ private:
      * @{
      */
     float m_active_op_force_limit_kg;       ///< Target force limit (kg) for force-based moves.
-    char m_active_op_force_action[16];      ///< Action to take when force limit reached: "retract", "hold", "skip"
-    char m_active_op_force_mode[16];        ///< Limit mode: "force" (load cell) or "torque" (motor torque)
+    int32_t m_active_op_force_limit_counts; ///< m_active_op_force_limit_kg converted once to load-cell counts.
+    ForceAction m_active_op_force_action;   ///< Action to take when the force limit is reached
+    ForceMode m_active_op_force_mode;       ///< Force mode latched when the move started
     float m_active_op_total_distance_mm;    ///< Total distance traveled (mm) in current operation.
     float m_last_completed_distance_mm;     ///< Distance (mm) of the last completed move operation.
     long m_active_op_total_target_steps;    ///< Target distance in steps for the current operation.
@@ -452,25 +1248,56 @@ private:
     int m_active_op_accel_sps2;             ///< Acceleration (steps/sec^2) for the current operation.
     int m_active_op_torque_percent;         ///< Torque limit (%) for the current operation.
     uint32_t m_moveStartTime;               ///< Timestamp (ms) when a move operation started.
-    double m_joules;                        ///< Energy expended (Joules) during current move, integrated at 50Hz.
+    PressEnergy m_energy;                   ///< Energy expended (Joules) during the current press, one step per force sample.
     float m_endpoint_mm;                    ///< Actual position (mm) where last move ended (force trigger or completion).
     float m_press_startpoint_mm;            ///< Position (mm) where force threshold was crossed (press started).
-    double m_prev_position_mm;              ///< Previous position (mm) for joule integration calculations.
-    double m_machineStrainBaselinePosMm;    ///< Absolute position (mm) that defines zero deflection for strain compensation.
-    double m_prevMachineDeflectionMm;       ///< Estimated machine flex deflection (mm) at previous sample.
-    double m_prevTotalDeflectionMm;         ///< Cumulative machine deflection at previous sample.
-    double m_machineEnergyJ;                ///< Accumulated machine-flex energy (Joules) during current move.
-    bool m_machineStrainContactActive;     ///< Indicates whether force threshold has been reached and flex compensation is active.
     bool m_jouleIntegrationActive;          ///< Flag indicating whether joule integration is currently active.
     bool m_forceLimitTriggered;             ///< Tracks whether the current move has hit the force limit.
-    float m_machineStrainCoeffs[5];         ///< Machine strain compensation coefficients [x^4, x^3, x^2, x, constant].
-    float m_prevForceKg;                    ///< Previous force sample (kg) used for joule integration.
-    bool m_prevForceValid;                  ///< Indicates whether previous force sample is valid.
+    MachineStrainModel m_machineStrain;     ///< Machine strain fit and its force-to-deflection table.
+    bool m_captureDetail;                   ///< Capture runs at full rate for the rest of the press.
+    bool m_captureRefValid;                 ///< m_captureRefKg/m_captureRefSteps hold a sample of this press.
+    float m_captureRefKg;                   ///< Force at the start of the current coarse step (kg).
+    long m_captureRefSteps;                 ///< Position at the start of the current coarse step (steps from home).
+    ForceSample m_forceBatch[FORCE_SENSOR_RX_RING_SIZE]; ///< Load-cell samples drained this pass, oldest first.
+    TorqueForceSample m_torqueRing[TORQUE_JOULES_RING_SIZE]; ///< Torque-force samples queued by the control tick for updateJoules().
+    volatile uint16_t m_torqueRingHead;     ///< Next slot the control tick writes.
+    volatile uint16_t m_torqueRingTail;     ///< Next slot updateJoules() reads.
+    uint8_t m_torqueTickCount;              ///< Control ticks since the last torque-force sample (owned by the ISR).
+    uint16_t m_forceBatchCount;             ///< Number of valid entries in m_forceBatch.
+    float m_forceBatchPeakKg;               ///< Highest force seen since the previous pass (for limit checks).
+    int32_t m_forceBatchPeakCounts;         ///< m_forceBatchPeakKg in normalised counts (what the limit compares).
+    uint32_t m_forceBatchPeakUs;            ///< Arrival time of that sample (Microseconds() low word).
+    MoveStats m_moveStats;                  ///< Statistics of the cycle g_cycleTiming is timing.
+    uint32_t m_tripLeadUs;                  ///< Predictive trip extrapolation of the active move (0 = exact trip only).
+    float m_forceRateKgPerUs;               ///< EWMA force rate over the drained samples (predictive trip).
+    float m_forceRatePrevKg;                ///< Force of the last sample the rate was taken from.
+    uint64_t m_forceRatePrevUs;             ///< Arrival time of that sample (0 = none yet).
+    uint32_t m_posHistoryTimeUs[FORCE_POSITION_HISTORY_SIZE]; ///< Microseconds() of each commanded-position entry.
+    long m_posHistorySteps[FORCE_POSITION_HISTORY_SIZE];      ///< PositionRefCommanded() of each entry.
+    uint16_t m_posHistoryHead;              ///< Next entry to overwrite in the position history.
+    uint16_t m_posHistoryCount;             ///< Valid entries in the position history.
+    MotionSegment m_motionQueue[MOTION_QUEUE_SIZE]; ///< Pending queue_move segments (ring buffer).
+    CompiledSegment m_motionQueueCompiled[MOTION_QUEUE_SIZE]; ///< m_motionQueue compiled by compileMotionQueue(), same slots.
+    ForceMode m_motionQueueCompiledMode;    ///< Force mode m_motionQueueCompiled was checked against.
+#if MOVE_CACHE_SIZE > 0
+    MoveCacheEntry m_moveCache[MOVE_CACHE_SIZE]; ///< Recently compiled move_abs argument sets.
+    uint8_t m_moveCacheNext;                ///< Slot the next new argument set replaces (round robin).
+#endif
+    uint8_t m_motionQueueHead;              ///< Index of the next segment to run.
+    uint8_t m_motionQueueCount;             ///< Segments waiting in m_motionQueue.
+    uint16_t m_motionQueueSegment;          ///< Segments started by the current queue_run (1-based in messages).
+    bool m_motionQueueRunning;              ///< True while queue_run/run_recipe owns the active move.
+    const char* m_motionQueueCommand;       ///< Command reported in DONE for the running queue.
+    uint32_t m_recipeDoneCount;             ///< run_recipe DONEs sent since boot.
+#if PRESS_SYNC_ENABLED
+    bool m_syncGate;                        ///< Press sync holds run_recipe segments at their start.
+    bool m_syncContinuing;                  ///< The held segment hands off from a previous one.
+    bool m_syncReleased;                    ///< The next segment popped has been released.
+    bool m_syncReleasePending;              ///< releaseSyncSegment() set m_syncReleaseUs.
+    uint32_t m_syncReleaseUs;               ///< Microseconds() the held segment starts at.
+#endif
+    uint32_t m_dwellStartTime;              ///< Milliseconds() when the current dwell segment began.
+    uint32_t m_dwellDurationMs;             ///< Length of the current dwell segment.
     float m_retractSpeedMms;                ///< Stored retract speed to use when not overridden.
     /** @} */
-    
-    float evaluateMachineStrainForceFromDeflection(float deflection_mm) const;
-    float estimateMachineDeflectionFromForce(float force_kg) const;
-    
-    char m_telemetryBuffer[256]; ///< Buffer for the formatted telemetry string.
 };
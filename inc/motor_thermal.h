@@ -0,0 +1,55 @@
+/**
+ * @file motor_thermal.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the I2t thermal estimate of one press motor.
+ *
+ * @details Winding heat follows the square of torque and leaks away with the motor's thermal
+ * time constant, so the model is a first-order filter of (torque / continuous torque)^2:
+ * 100% is the temperature rise a motor settles at when held at THERMAL_CONTINUOUS_TORQUE_PCT
+ * forever, the most it may sustain. Short pushes far above the continuous rating are fine as
+ * long as the average is not, which a fixed torque or speed derate cannot tell apart.
+ *
+ * The control tick feeds the smoothed HLFB torque every tick; the square is averaged over
+ * THERMAL_UPDATE_TICKS ticks and the filter advanced once per block, since its per-tick step
+ * (about 3e-6 at 1 kHz and 300 s) would be lost in float rounding. The model uses no
+ * ClearCore symbols and builds on a host with PRESSBOI_HOST defined.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @class MotorThermalModel
+ * @brief Thermal load of one motor, in percent of its continuous rating.
+ */
+class MotorThermalModel {
+public:
+    /**
+     * @brief Constructs a cold model (0%).
+     */
+    MotorThermalModel();
+
+    /**
+     * @brief Forgets the heat (the drive was power-cycled and the motor has cooled).
+     */
+    void reset();
+
+    /**
+     * @brief Adds one control tick. Called from the control tick interrupt.
+     * @param torque_pct Smoothed HLFB torque (% of peak), 0 while the motor is idle
+     */
+    void tick(float torque_pct);
+
+    /**
+     * @brief Gets the thermal load. Safe to call from the main loop.
+     * @return Percent of the continuous rating (100 = THERMAL_LIMIT_PCT at the default)
+     */
+    float getLoadPct() const { return m_loadPct; }
+
+private:
+    volatile float m_loadPct;   ///< Filtered (torque / continuous)^2 x 100, written by the tick
+    float m_blockSum;           ///< Sum of the squared load over the current block
+    uint16_t m_blockTicks;      ///< Ticks in the current block
+};
@@ -0,0 +1,174 @@
+/**
+ * @file nvm_journal.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the wear-leveled flash journal for frequently adjusted settings.
+ *
+ * @details The retract position, press threshold and force zero offsets are adjusted many
+ * times a shift, and the production counters (production_counters.h) change every cycle. Rewriting the settings block for each change would erase the single NVM
+ * user page every time, so these values are appended instead as 16-byte records (one flash
+ * quad-word write each) to a journal of NVM_JOURNAL_BLOCKS erase blocks at the top of main
+ * flash, outside the FLASH region of the linker scripts. Boot replays the newest record per
+ * key over the settings block.
+ *
+ * Records go into the active block in order. The first quad-word of each block is a header
+ * record naming its generation, written after the block's contents, so a block whose
+ * compaction was cut short never becomes active. When the active block is full, the newest
+ * value of every key is copied into the next (erased) block, its header is written, and the
+ * old block is erased for later. Each block is therefore erased once per
+ * NVM_JOURNAL_BLOCK_SIZE / 16 records instead of once per change.
+ *
+ * Everything runs as a polled state machine from service(): a quad-word write or block
+ * erase is started and service() returns, and the next step waits for NVMCTRL to report
+ * ready. The journal sits at the top of flash bank B, so while the code runs from bank A
+ * the erase does not stall instruction fetches. put() only updates RAM, and changes made
+ * before the record is written coalesce into one record.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @enum NvmJournalKey
+ * @brief Values kept in the journal.
+ */
+enum NvmJournalKey : uint8_t {
+    NVM_JOURNAL_KEY_HEADER = 0,         ///< Block header (value = generation)
+    NVM_JOURNAL_KEY_RETRACT,            ///< Retract position (mm, float bits)
+    NVM_JOURNAL_KEY_PRESS_THRESHOLD,    ///< Press threshold (kg, float bits)
+    NVM_JOURNAL_KEY_FORCE_OFFSET_A,     ///< Channel A force offset (kg, float bits)
+    NVM_JOURNAL_KEY_FORCE_OFFSET_B,     ///< Channel B force offset (kg, float bits)
+    NVM_JOURNAL_KEY_LAST_SETTING = NVM_JOURNAL_KEY_FORCE_OFFSET_B, ///< Keys up to here replay over PressSettings
+    NVM_JOURNAL_KEY_PROD_CYCLES,        ///< Production: completed press cycles
+    NVM_JOURNAL_KEY_PROD_TRAVEL,        ///< Production: axis travel (whole mm)
+    NVM_JOURNAL_KEY_PROD_ENERGY,        ///< Production: press energy (whole J)
+    NVM_JOURNAL_KEY_PROD_TRIPS,         ///< Production: force-limit trips
+    NVM_JOURNAL_KEY_PROD_PEAK_HIST,     ///< Production: first of PRODUCTION_PEAK_BUCKETS peak-force bucket counts
+    NVM_JOURNAL_KEY_COUNT = NVM_JOURNAL_KEY_PROD_PEAK_HIST + PRODUCTION_PEAK_BUCKETS
+};
+
+/**
+ * @struct NvmJournalRecord
+ * @brief One journal record: a flash quad-word. Erased flash reads as all ones.
+ */
+struct NvmJournalRecord {
+    uint8_t key;            ///< NvmJournalKey (0xFF = erased)
+    uint8_t reserved[3];    ///< 0xFF
+    uint32_t seq;           ///< Record sequence number, increasing across blocks and boots
+    uint32_t value;         ///< Value bits
+    uint32_t crc;           ///< CRC-32 of the 12 bytes above
+};
+
+/**
+ * @enum NvmJournalState
+ * @brief What the journal is waiting on.
+ */
+enum NvmJournalState : uint8_t {
+    NVM_JOURNAL_STATE_IDLE = 0,     ///< Nothing in flight
+    NVM_JOURNAL_STATE_WRITING,      ///< A record write is in flight
+    NVM_JOURNAL_STATE_COMPACTING,   ///< Copying the newest values into the next block
+    NVM_JOURNAL_STATE_ERASING,      ///< A block erase is in flight
+    NVM_JOURNAL_STATE_FAILED        ///< Flash refused an operation; put() returns false
+};
+
+/**
+ * @class NvmJournal
+ * @brief Log-structured flash journal of NvmJournalKey values. Main loop only.
+ */
+class NvmJournal {
+public:
+    /**
+     * @brief Constructs an empty journal. load() finds the active block.
+     */
+    NvmJournal();
+
+    /**
+     * @brief Scans the journal blocks, keeps the newest value per key from the active
+     * block and schedules erasing any other block with contents. Call once in setup().
+     */
+    void load();
+
+    /**
+     * @brief Gets the newest value of a key.
+     * @param key NvmJournalKey
+     * @param value Receives the value bits
+     * @return false if the journal holds no record for @p key
+     */
+    bool get(NvmJournalKey key, uint32_t* value) const;
+
+    /**
+     * @brief Records a new value. Returns at once; service() writes it.
+     * @param key NvmJournalKey (not the header)
+     * @param value Value bits
+     * @return false if the journal has failed and the caller should persist the value another way
+     */
+    bool put(NvmJournalKey key, uint32_t value);
+
+    /**
+     * @brief Moves the write, compaction and erase work forward by at most one flash
+     * operation. Called from the settings loop task.
+     */
+    void service();
+
+    /**
+     * @brief Checks that no flash operation is in flight or pending.
+     * @return true when the NVM controller is free for the settings block commit
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief Gets the journal state.
+     * @return NvmJournalState
+     */
+    uint8_t getState() const { return m_state; }
+
+    /**
+     * @brief Gets the index of the block records are appended to.
+     * @return Block (0 .. NVM_JOURNAL_BLOCKS - 1)
+     */
+    uint8_t getActiveBlock() const { return m_active; }
+
+    /**
+     * @brief Gets how many record slots of the active block are used, header included.
+     * @return Used slots
+     */
+    uint16_t getUsedRecords() const { return m_next; }
+
+    /**
+     * @brief Gets the number of block erases since boot.
+     * @return Erases
+     */
+    uint32_t getErases() const { return m_erases; }
+
+    /**
+     * @brief Gets the name of a state as shown in reports.
+     * @param state NvmJournalState
+     * @return State name
+     */
+    static const char* stateName(uint8_t state);
+
+private:
+    static uint32_t blockAddress(uint8_t block);
+    static uint32_t recordCrc(const NvmJournalRecord& record);
+    bool checkFlashError();
+    void startWrite(uint8_t block, uint16_t slot, uint8_t key, uint32_t value);
+    void startErase(uint8_t block);
+    bool stepCompaction();
+
+    uint32_t m_value[NVM_JOURNAL_KEY_COUNT];   ///< Newest value per key (RAM copy)
+    uint32_t m_have;                        ///< Bit per key with a value
+    uint32_t m_pending;                     ///< Bit per key changed since its last record
+    uint8_t m_state;                        ///< NvmJournalState
+    uint8_t m_active;                       ///< Block records are appended to
+    uint16_t m_next;                        ///< Next free slot in the active block
+    uint32_t m_seq;                         ///< Sequence number of the next record
+    uint8_t m_erased;                       ///< Bit per block known to be erased
+    uint8_t m_stale;                        ///< Bit per block to erase when idle
+    uint8_t m_target;                       ///< Block being compacted into or erased
+    uint8_t m_copyKey;                      ///< Next key to copy during compaction
+    uint16_t m_copySlot;                    ///< Next slot in the target block during compaction
+    uint32_t m_erases;                      ///< Block erases since boot
+};
+
+extern NvmJournal g_nvmJournal;
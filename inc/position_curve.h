@@ -0,0 +1,191 @@
+/**
+ * @file position_curve.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the press curve sampled on a fixed position grid.
+ *
+ * @details The grid has a point every POSITION_CURVE_STEP_MM, counted from machine home.
+ * The control tick compares the commanded position against the step count of the next
+ * point in the direction of travel and, when a point is passed, queues the time the axis
+ * crossed it (interpolated inside the tick, so several points per tick are fine). The main
+ * loop holds each crossing until the load-cell samples on both sides of it have arrived and
+ * stores the force interpolated to that time, by acquisition time. The HX711 free-runs, so
+ * a conversion cannot be started at the point itself; the timestamp is taken there instead.
+ *
+ * Points are only taken while the axis advances: a reversal (a regulated hold, a retract)
+ * records nothing until the axis is past the furthest point again. The curve is therefore
+ * uniform in position whatever the speed, and its length is fixed by the stroke, so the
+ * host compares presses and envelopes index by index. Like PressCapture, the approach
+ * only runs through a ring of POSITION_CURVE_PRETRIGGER_POINTS points until the press
+ * threshold is crossed. dump_curve streams the points as base64 int16 tenths of a kg.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#if POSITION_CURVE_ENABLED
+
+/**
+ * @class PositionCurve
+ * @brief Grid crossing queue (control tick to main loop) plus the stored points.
+ */
+class PositionCurve {
+public:
+    /**
+     * @brief Constructs an empty, idle curve.
+     */
+    PositionCurve();
+
+    /**
+     * @brief Discards the previous curve and arms the grid at the current position. Main loop.
+     * @param position_steps Commanded position relative to home (steps)
+     * @param steps_per_mm Drive geometry the grid is converted with
+     */
+    void begin(int32_t position_steps, float steps_per_mm);
+
+    /**
+     * @brief Stops taking points and closes the curve once the last crossings are resolved.
+     * @details Called every pass after the press: the samples acquired after the last
+     * crossings arrive a latency later, and addSample() still takes them. The curve closes
+     * when no crossing is waiting or POSITION_CURVE_CLOSE_MS after the first call, dropping
+     * what is left. An untriggered pretrigger ring is kept, oldest first.
+     * @param now_us Microseconds()
+     */
+    void end(uint32_t now_us);
+
+    /**
+     * @brief Marks the press threshold crossing: later points are all stored. Only the
+     * first call of a press counts.
+     */
+    void trigger();
+
+    /**
+     * @brief Queues the grid points passed since the previous tick. Control tick only.
+     * @param now_us Microseconds() of this tick
+     * @param position_steps Commanded position relative to home (steps)
+     */
+    void tick(uint32_t now_us, int32_t position_steps);
+
+    /**
+     * @brief Resolves the queued crossings up to one force sample. Main loop only.
+     * @details A crossing is stored once a sample acquired at or after it is in, with the
+     * force interpolated between the two samples around it. The tick can queue a crossing
+     * up to a tick after it happened, behind samples already taken, so the last
+     * POSITION_CURVE_SAMPLE_HISTORY samples are kept to find that pair.
+     * @param acquired_us Microseconds() when the sample was acquired
+     * @param force_kg Calibrated force (kg)
+     */
+    void addSample(uint32_t acquired_us, float force_kg);
+
+    /**
+     * @brief Checks whether a press is being recorded.
+     * @return true from begin() until end() has closed the curve
+     */
+    bool isCapturing() const { return m_capturing; }
+
+    /**
+     * @brief Gets the number of stored points.
+     * @return Point count
+     */
+    uint16_t getCount() const { return m_count; }
+
+    /**
+     * @brief Gets the position of the first stored point.
+     * @return mm from home (0 while the curve is empty)
+     */
+    float getStartMm() const;
+
+    /**
+     * @brief Gets the signed grid interval between consecutive points.
+     * @return mm, negative when the press moved towards home
+     */
+    float getStepMm() const { return m_dir < 0 ? -POSITION_CURVE_STEP_MM : POSITION_CURVE_STEP_MM; }
+
+    /**
+     * @brief Gets the number of points lost to a full curve or a full crossing queue.
+     * @return Dropped point count
+     */
+    uint32_t getDropped() const { return m_dropped; }
+
+    /**
+     * @brief Gets the index of the first point at or past the press threshold.
+     * @return Point index, or -1 if the press never crossed the threshold
+     */
+    int32_t getTriggerIndex() const { return m_triggerIndex; }
+
+    /**
+     * @brief Formats stored points as one base64 dump_curve DATA line.
+     * @param first Index of the first point to format
+     * @param buffer Output buffer (at least MAX_MESSAGE_LENGTH bytes)
+     * @param size Size of @p buffer
+     * @return Number of points formatted (0 once @p first reaches the end)
+     */
+    uint16_t formatLine(uint16_t first, char* buffer, size_t size) const;
+
+private:
+    /**
+     * @brief Stores the force at the next grid point.
+     */
+    void store(int32_t index, float force_kg);
+
+    /**
+     * @brief Puts an untriggered pretrigger ring in order, oldest first, and keeps it.
+     */
+    void flushPretrigger();
+
+    /**
+     * @brief Interpolates the force at a crossing between the samples around it.
+     * @param time_us Crossing time
+     * @param acquired_us Acquisition time of the newest sample (not in the history yet)
+     * @param force_kg Force of the newest sample
+     * @return Force, or the oldest kept sample's if the crossing is older than all of them
+     */
+    float forceAt(uint32_t time_us, uint32_t acquired_us, float force_kg) const;
+
+    /**
+     * @struct Crossing
+     * @brief A grid point the tick saw the axis pass.
+     */
+    struct Crossing {
+        uint32_t time_us;       ///< Microseconds() the axis crossed the point
+        int32_t index;          ///< Grid index (point index times the interval = mm from home)
+    };
+
+    /**
+     * @struct Sample
+     * @brief A force sample kept for interpolation.
+     */
+    struct Sample {
+        uint32_t time_us;       ///< Acquisition time
+        float kg;               ///< Calibrated force
+    };
+
+    int16_t m_points[POSITION_CURVE_MAX_POINTS];    ///< Force at each point (0.1 kg), in grid order
+    Crossing m_ring[POSITION_CURVE_RING_SIZE];      ///< Crossings written by the tick
+    volatile uint16_t m_ringHead;   ///< Next slot the tick writes
+    volatile uint16_t m_ringTail;   ///< Next slot the main loop reads
+    volatile bool m_tickArmed;      ///< The tick compares positions against the grid
+    volatile int8_t m_dir;          ///< Direction the axis takes points in (0 = not moved yet)
+    float m_stepsPerPoint;          ///< POSITION_CURVE_STEP_MM in steps
+    int32_t m_tickNext;             ///< Grid index of the next point to pass (owned by the tick)
+    int32_t m_tickPrevSteps;        ///< Position at the previous tick
+    uint32_t m_tickPrevUs;          ///< Microseconds() of the previous tick
+    Sample m_samples[POSITION_CURVE_SAMPLE_HISTORY];    ///< Recent samples of this press
+    uint8_t m_sampleHead;           ///< Next m_samples slot (the oldest once full)
+    uint8_t m_sampleCount;          ///< Samples held
+    uint16_t m_count;               ///< Points stored (ahead of the trigger: held in the ring)
+    uint16_t m_pretriggerHead;      ///< Next ring slot ahead of the trigger (the oldest once full)
+    int32_t m_lastIndex;            ///< Grid index of the newest stored point
+    float m_lastKg;                 ///< Force of that point
+    uint32_t m_dropped;             ///< Points lost this press
+    int32_t m_triggerIndex;         ///< Index of the first point of the press, -1 if none
+    bool m_triggered;               ///< trigger() was called this press
+    bool m_capturing;               ///< Recording from begin() until end() closes the curve
+    uint32_t m_endUs;               ///< Microseconds() of the first end() call
+};
+
+extern PositionCurve g_positionCurve;
+
+#endif // POSITION_CURVE_ENABLED
@@ -0,0 +1,206 @@
+/**
+ * @file press_capture.h
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Defines the per-sample force-displacement capture buffer.
+ *
+ * @details Every load-cell sample integrated by MotorController::updateJoules() during a
+ * press is also appended here, together with the axis position at acquisition and the
+ * smoothed motor torque. The buffer is restarted at the beginning of each press (a queued
+ * or recipe cycle counts as one press) and kept after it ends, so the host can pull the
+ * full-resolution curve with dump_capture instead of relying on 10 Hz telemetry.
+ *
+ * Samples are stored as a byte stream of records, each four LEB128 varints:
+ * dt_us, then zigzag-encoded pos_steps, raw and torque_deci. Every
+ * PRESS_CAPTURE_KEYFRAME_INTERVAL-th sample (index 0, 32, 64, ...) is a keyframe holding
+ * absolute values; the others hold the change from the previous sample, which is usually
+ * one or two bytes per field. DATA lines carry whole keyframe blocks in base64, so each
+ * line decodes on its own even if another one is lost.
+ *
+ * With PRESS_CAPTURE_PRETRIGGER_SAMPLES, the approach only runs through a ring of that
+ * many unencoded samples. trigger() (the press threshold crossing) moves the ring into
+ * the stream, oldest first, and every later sample of the press is stored. The stream
+ * then holds the run-up to contact and everything after it, not the whole approach.
+ * A press that never reaches the threshold keeps the last ring's worth of samples.
+ *
+ * Until the caller flags a sample as detail (force rising ahead of the threshold), approach
+ * samples are only kept PRESS_CAPTURE_COARSE_MM of travel apart, so on a long stroke the
+ * buffer and the dump scale with the pressing, not the stroke length. dt_us still counts
+ * from the previous stored sample.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @brief Called by PressCapture::visit() for each stored sample, oldest first.
+ * @param context Opaque pointer supplied to visit()
+ * @param position_steps Axis position relative to home (steps)
+ * @param raw Raw tared ADC value
+ */
+typedef void (*PressCaptureVisitor)(void* context, int32_t position_steps, int32_t raw);
+
+/**
+ * @class PressCapture
+ * @brief Fixed-size RAM record stream plus the dump_capture formatter.
+ */
+class PressCapture {
+public:
+    /**
+     * @brief Constructs an empty, idle capture.
+     */
+    PressCapture();
+
+    /**
+     * @brief Discards the previous capture and starts recording.
+     */
+    void begin();
+
+    /**
+     * @brief Stops recording; the samples stay available for dump_capture.
+     * @details An untriggered pre-trigger ring is stored first.
+     */
+    void end();
+
+    /**
+     * @brief Marks the press threshold crossing: the pre-trigger ring is stored and all
+     * later samples go straight to the stream. Only the first call of a press counts.
+     */
+    void trigger();
+
+    /**
+     * @brief Gets the index of the sample that triggered the capture.
+     * @return Sample index, or -1 if the press never crossed the threshold
+     */
+    int32_t getTriggerIndex() const { return m_triggerIndex; }
+
+    /**
+     * @brief Appends a sample while recording. Once a record no longer fits (or
+     * PRESS_CAPTURE_MAX_SAMPLES is reached) this and all later samples are counted as dropped.
+     * @param time_us Microseconds() when the sample was acquired
+     * @param position_steps Axis position relative to home (steps)
+     * @param raw Raw tared ADC value
+     * @param torque_pct Smoothed motor torque (%)
+     * @param detail Keep the sample even if the axis has moved less than PRESS_CAPTURE_COARSE_MM
+     */
+    void add(uint32_t time_us, int32_t position_steps, int32_t raw, float torque_pct, bool detail = true);
+
+    /**
+     * @brief Checks whether a press is being recorded.
+     * @return true between begin() and end()
+     */
+    bool isCapturing() const { return m_capturing; }
+
+    /**
+     * @brief Gets the number of stored samples.
+     * @return Sample count
+     */
+    uint16_t getCount() const { return m_count; }
+
+    /**
+     * @brief Gets the size of the encoded stream.
+     * @return Bytes used in the buffer
+     */
+    uint16_t getBytes() const { return m_length; }
+
+    /**
+     * @brief Gets the number of samples that did not fit in the buffer.
+     * @return Dropped sample count
+     */
+    uint32_t getDropped() const { return m_dropped; }
+
+    /**
+     * @brief Gets the acquisition time of the first stored sample; the dt_us of each
+     * later sample counts from the one before it.
+     * @return Device Microseconds() (0 while the capture is empty)
+     */
+    uint32_t getFirstTimeUs() const { return m_firstTimeUs; }
+
+    /**
+     * @brief Formats whole keyframe blocks as one base64 dump_capture DATA line.
+     * @param first Index of the first sample to format (a multiple of PRESS_CAPTURE_KEYFRAME_INTERVAL)
+     * @param buffer Output buffer (at least MAX_MESSAGE_LENGTH bytes)
+     * @param size Size of @p buffer
+     * @return Number of samples formatted (0 once @p first reaches the end)
+     */
+    uint16_t formatLine(uint16_t first, char* buffer, size_t size) const;
+
+    /**
+     * @brief Decodes the stored samples in order and passes each one to @p visitor.
+     * @param visitor Called once per sample
+     * @param context Argument for @p visitor
+     * @return Number of samples visited
+     */
+    uint16_t visit(PressCaptureVisitor visitor, void* context) const;
+
+private:
+    /**
+     * @brief Encodes one sample onto the end of the stream.
+     */
+    void store(uint32_t time_us, int32_t position_steps, int32_t raw, int16_t torque_deci);
+
+    /**
+     * @brief Stores the pre-trigger ring, oldest first, and empties it.
+     */
+    void flushPretrigger();
+
+    /**
+     * @struct PretriggerSample
+     * @brief One approach sample waiting in the pre-trigger ring.
+     */
+    struct PretriggerSample {
+        uint32_t time_us;
+        int32_t position_steps;
+        int32_t raw;
+        int16_t torque_deci;
+    };
+
+    /**
+     * @brief Appends an unsigned LEB128 varint to the scratch record.
+     * @param record Scratch record
+     * @param len Bytes used in @p record, advanced past the varint
+     * @param value Value to encode
+     */
+    static void putVarint(uint8_t* record, uint8_t& len, uint32_t value);
+
+    /**
+     * @brief Reads an unsigned LEB128 varint from the stream.
+     * @param offset Byte offset of the varint, advanced past it
+     * @return Decoded value
+     */
+    uint32_t getVarint(uint16_t& offset) const;
+
+    /**
+     * @brief Byte offset where a keyframe block ends.
+     * @param block Keyframe block index
+     * @return Offset of the next block, or the stream length for the last one
+     */
+    uint16_t blockEnd(uint16_t block) const;
+
+    uint8_t m_buffer[PRESS_CAPTURE_BUFFER_BYTES];   ///< Encoded records in acquisition order
+    uint16_t m_keyframeOffsets[(PRESS_CAPTURE_MAX_SAMPLES + PRESS_CAPTURE_KEYFRAME_INTERVAL - 1) / PRESS_CAPTURE_KEYFRAME_INTERVAL]; ///< Byte offset of each keyframe
+    uint16_t m_length;         ///< Bytes used in m_buffer
+    uint16_t m_count;          ///< Stored samples
+    uint32_t m_dropped;        ///< Samples lost to a full buffer
+    uint32_t m_lastTimeUs;     ///< Acquisition time of the previous sample
+    uint32_t m_firstTimeUs;    ///< Acquisition time of sample 0
+    int32_t m_lastPosition;    ///< Position of the previous stored sample (steps)
+    int32_t m_lastRaw;         ///< Raw ADC value of the previous stored sample
+    int16_t m_lastTorque;      ///< Torque of the previous stored sample (0.1 %)
+    bool m_full;               ///< A record did not fit; stop storing until begin()
+    bool m_capturing;          ///< Recording between begin() and end()
+    bool m_triggered;          ///< trigger() was called this press (samples go to the stream)
+    int32_t m_triggerIndex;    ///< Index of the triggering sample, -1 if none
+    int32_t m_coarseSteps;     ///< PRESS_CAPTURE_COARSE_MM in steps, set by begin()
+    int32_t m_coarsePosition;  ///< Position of the last kept approach sample (steps)
+    bool m_coarseValid;        ///< m_coarsePosition holds a sample of this press
+#if PRESS_CAPTURE_PRETRIGGER_SAMPLES > 0
+    PretriggerSample m_pretrigger[PRESS_CAPTURE_PRETRIGGER_SAMPLES]; ///< Ring of the latest approach samples
+    uint16_t m_pretriggerHead; ///< Next ring slot to write
+    uint16_t m_pretriggerCount; ///< Valid ring entries
+#endif
+};
+
+extern PressCapture g_pressCapture;
@@ -0,0 +1,144 @@
+/**
+ * @file press_energy.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the per-sample joule integration of a press, with machine strain taken out.
+ *
+ * @details MotorController feeds every load-cell (or torque-derived) sample with the
+ * position it was acquired at. Below the press threshold a sample only moves the
+ * reference; the first sample at or above it sets the strain baseline, and each sample
+ * after that adds force x travel, less the share the MachineStrainModel puts down to frame
+ * flex. The class keeps no ClearCore symbols and builds on a host with PRESSBOI_HOST
+ * defined; what a contact or a limit means for the move is left to the caller.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "machine_strain.h"
+
+/**
+ * @struct CompensatedSum
+ * @brief Kahan-compensated float accumulator. The SAME53 FPU is single precision only;
+ * this keeps the running energy totals accurate without software double arithmetic.
+ */
+struct CompensatedSum {
+    float sum;   ///< Running total
+    float comp;  ///< Low-order bits lost from the total so far
+
+    /** @brief Clears the total. */
+    void reset() { sum = 0.0f; comp = 0.0f; }
+
+    /**
+     * @brief Adds a value to the total.
+     * @param value Increment
+     */
+    void add(float value) {
+        float y = value - comp;
+        float t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+    }
+};
+
+/**
+ * @enum PressEnergyStep
+ * @brief What PressEnergy::add() did with a sample.
+ */
+enum PressEnergyStep : uint8_t {
+    PRESS_ENERGY_HELD,      ///< Reference only: first sample, no travel, or below the press threshold
+    PRESS_ENERGY_CONTACT,   ///< First sample at the press threshold; the strain baseline is set here
+    PRESS_ENERGY_ADDED,     ///< Energy added
+    PRESS_ENERGY_LIMIT      ///< Energy added, and the raw force reached the limit (reference dropped)
+};
+
+/**
+ * @struct PressEnergyDetail
+ * @brief The strain split of one sample that added energy, for the debug log.
+ */
+struct PressEnergyDetail {
+    float force_kg;                 ///< Force after the 0 and limit clamps
+    float machine_deflection_mm;    ///< Frame deflection the model puts at that force
+    float total_deflection_mm;      ///< Travel since the strain baseline
+    float machine_ratio;            ///< Share of the increment put down to frame flex (0..1)
+};
+
+/**
+ * @class PressEnergy
+ * @brief Part and machine-flex energy of the current press, one step per sample.
+ */
+class PressEnergy {
+public:
+    /**
+     * @brief Constructs an integrator with no energy and no reference sample.
+     */
+    PressEnergy();
+
+    /**
+     * @brief Clears the part energy, for a new press cycle.
+     */
+    void resetTotal() { m_joules.reset(); }
+
+    /**
+     * @brief Starts a move at a position: travel counts from here and the press threshold
+     * has to be crossed again. The part energy and the reference force are kept, so a
+     * queued segment carries on the cycle's total.
+     * @param position_steps Axis position (steps from home)
+     */
+    void begin(long position_steps);
+
+    /**
+     * @brief Drops the reference sample; the next add() only takes its force and position.
+     */
+    void invalidate() { m_prevValid = false; }
+
+    /**
+     * @brief Forgets the contact and the machine-flex energy (strain model changed, move over).
+     */
+    void clearContact();
+
+    /**
+     * @brief Integrates one sample against the previous one.
+     * @details Travel stays in integer steps so it is exact; only the increment is
+     * converted to mm. Joules = kg x 9.81 x mm x 0.001, with the force the mean of the two
+     * samples, clamped to 0 and to @p limit_kg.
+     * @param force_kg Calibrated force (kg)
+     * @param position_steps Axis position at acquisition (steps from home)
+     * @param limit_kg Force limit of the move (<= 0 = none)
+     * @param threshold_kg Press threshold that starts strain compensation
+     * @param strain Machine flex model
+     * @param mm_per_step Drive geometry
+     * @param detail Receives the strain split when energy was added (NULL = not wanted)
+     * @return What the sample did
+     */
+    PressEnergyStep add(float force_kg, long position_steps, float limit_kg, float threshold_kg,
+                        const MachineStrainModel& strain, float mm_per_step, PressEnergyDetail* detail = NULL);
+
+    /**
+     * @brief Gets the part energy of the press.
+     * @return Joules, machine flex excluded
+     */
+    float getJoules() const { return m_joules.sum; }
+
+    /**
+     * @brief Gets the energy put down to frame flex since contact.
+     * @return Joules
+     */
+    float getMachineJoules() const { return m_machineJ.sum; }
+
+    /**
+     * @brief Checks whether the press threshold was crossed in this move.
+     * @return true once strain compensation is active
+     */
+    bool isContact() const { return m_contact; }
+
+private:
+    CompensatedSum m_joules;        ///< Part energy of the press
+    CompensatedSum m_machineJ;      ///< Frame-flex energy since contact
+    long m_prevSteps;               ///< Position of the reference sample (steps from home)
+    long m_baselineSteps;           ///< Position of zero frame deflection (steps from home)
+    float m_prevKg;                 ///< Clamped force of the reference sample
+    bool m_prevValid;               ///< m_prevKg/m_prevSteps hold a sample
+    bool m_contact;                 ///< Press threshold crossed; strain compensation active
+};
@@ -0,0 +1,88 @@
+/**
+ * @file press_metrics.h
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Defines the press metrics accumulated on the controller during a move.
+ *
+ * @details The same load-cell samples that feed the joule integration and the press
+ * capture are folded into a handful of running figures, so the DONE event of a press can
+ * carry the numbers line QA passes or fails a part on without post-processing the curve
+ * on the host (PressReportGenerator.calculate_metrics() computes the same set offline).
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @class PressMetrics
+ * @brief Running peak force, energy, stiffness and time above threshold for one press.
+ */
+class PressMetrics {
+public:
+    /**
+     * @brief Constructs an empty metrics set.
+     */
+    PressMetrics();
+
+    /**
+     * @brief Clears the metrics at the start of a press.
+     * @param threshold_kg Force above which the part counts as loaded (the press threshold)
+     */
+    void begin(float threshold_kg);
+
+    /**
+     * @brief Folds one load-cell sample into the metrics.
+     * @param time_us Microseconds() when the sample was acquired
+     * @param position_mm Axis position at acquisition (mm from home)
+     * @param force_kg Calibrated force (kg)
+     * @param energy_j Press energy integrated so far (J)
+     * @param limit_kg Active force limit (kg); energy is latched when it is first reached
+     */
+    void add(uint32_t time_us, float position_mm, float force_kg, float energy_j, float limit_kg);
+
+    /**
+     * @brief Checks whether any sample has been added since begin().
+     * @return true if the metrics describe a press
+     */
+    bool hasData() const { return m_samples > 0; }
+
+    /**
+     * @brief Gets the highest force seen since begin().
+     * @return Peak force (kg)
+     */
+    float getPeakKg() const { return m_peakKg; }
+
+    /**
+     * @brief Appends the metrics as key=value pairs, for the DONE event.
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Characters written (as snprintf)
+     */
+    int format(char* buffer, size_t size) const;
+
+private:
+    /**
+     * @brief Least-squares slope of force over position across the window.
+     * @return Stiffness (kg/mm, magnitude), 0 until the window is full
+     */
+    float windowSlope() const;
+
+    float m_thresholdKg;             ///< Force above which time is counted
+    float m_peakKg;                  ///< Highest force seen
+    float m_peakPositionMm;          ///< Position of the highest force
+    float m_peakStiffnessKgMm;       ///< Window stiffness leading up to the peak
+    float m_energyJ;                 ///< Energy until the force limit was first reached
+    bool m_limitReached;             ///< Force limit reached; m_energyJ is latched
+    uint32_t m_aboveUs;              ///< Time spent at or above the threshold
+    uint32_t m_lastTimeUs;           ///< Acquisition time of the previous sample
+    bool m_lastAbove;                ///< Previous sample was at or above the threshold
+    uint32_t m_samples;              ///< Samples since begin()
+    float m_windowPos[PRESS_METRICS_STIFFNESS_WINDOW]; ///< Recent positions (mm), ring buffer
+    float m_windowKg[PRESS_METRICS_STIFFNESS_WINDOW];  ///< Recent forces (kg), ring buffer
+    uint16_t m_windowHead;           ///< Next slot to write
+    uint16_t m_windowCount;          ///< Filled slots
+};
+
+extern PressMetrics g_pressMetrics;
@@ -0,0 +1,274 @@
+/**
+ * @file press_sync.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the leader/follower synchronization of several presses running one job.
+ *
+ * @details Presses that share a part run the same stored recipe in lockstep, coordinated
+ * over UDP on PRESS_SYNC_PORT with PressSyncMessage datagrams (little-endian, packed) and
+ * no host in the loop. One press is set_sync leader, the others set_sync follower with the
+ * leader's address:
+ *
+ *  - Clock: each follower sends PING every PRESS_SYNC_PING_MS and the leader answers PONG
+ *    with its Microseconds(). The follower takes the leader time as the midpoint of the
+ *    round trip, NTP style, and keeps the offset of the shortest round trip among the last
+ *    PRESS_SYNC_CLOCK_WINDOW samples. The pings also tell the leader which followers are up.
+ *  - Segment barrier: with sync on, every segment of a run_recipe run is held at its start
+ *    (MOVE_SYNC_WAIT) until it is released. A press at the barrier sends READY (followers)
+ *    or ARM (the leader) every PRESS_SYNC_RESEND_MS. Once the leader and every follower that
+ *    was up when the run started are at the same segment, the leader sends GO with a start
+ *    time PRESS_SYNC_LEAD_US ahead in its clock, and every press starts the segment when its
+ *    own clock gets there. The ARM of the first segment starts run_recipe on the followers,
+ *    so the leader's run (from a host, a PLC or the cycle input) runs the whole job.
+ *  - Cross-abort: a station whose run stops without its DONE (a force trip with "abort",
+ *    a "hold" pause, an envelope or interlock stop, a fault or a cancel), or that waits at
+ *    a barrier longer than PRESS_SYNC_BARRIER_TIMEOUT_MS, or that hears nothing from the other
+ *    side for PRESS_SYNC_LINK_TIMEOUT_MS during a run, sends ABORT. The leader passes it on
+ *    to every follower, and every press stops.
+ *
+ * Segments that end early (skip, seat, a force "retract") simply reach the next barrier
+ * sooner and wait there. Blending is off while sync is on, as a blended boundary has no stop
+ * to hold. A segment starts at main-loop resolution of the shared start time, plus the
+ * clock error (about half the round-trip asymmetry).
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#if PRESS_SYNC_ENABLED
+
+#include "IpAddress.h"
+#include "lwip/udp.h"
+
+#define PRESS_SYNC_MAGIC                0x4E595350  ///< First word of every sync datagram ("PSYN").
+#define PRESS_SYNC_VERSION              1           ///< PressSyncMessage layout version.
+
+/**
+ * @enum PressSyncRole
+ * @brief What this press is in a synchronized job.
+ */
+enum PressSyncRole : uint8_t {
+    PRESS_SYNC_OFF = 0,             ///< Runs on its own
+    PRESS_SYNC_LEADER,              ///< Releases the segments of every press
+    PRESS_SYNC_FOLLOWER             ///< Runs when the leader runs, segment by segment
+};
+
+/**
+ * @enum PressSyncType
+ * @brief PressSyncMessage.type.
+ */
+enum PressSyncType : uint8_t {
+    PRESS_SYNC_PING = 1,            ///< Follower to leader: time_us = follower clock (echoed)
+    PRESS_SYNC_PONG,                ///< Leader to follower: time_us = leader clock, echo_us = the ping's time_us
+    PRESS_SYNC_ARM,                 ///< Leader to followers: the leader waits at segment (segment 1 starts the run)
+    PRESS_SYNC_READY,               ///< Follower to leader: the follower waits at segment
+    PRESS_SYNC_GO,                  ///< Leader to followers: start segment at time_us (leader clock)
+    PRESS_SYNC_ABORT                ///< Either way: stop the run (reason = PressSyncReason)
+};
+
+/**
+ * @enum PressSyncReason
+ * @brief Why a synchronized run was aborted.
+ */
+enum PressSyncReason : uint8_t {
+    PRESS_SYNC_REASON_NONE = 0,     ///< No abort
+    PRESS_SYNC_REASON_STOPPED,      ///< A station's run stopped without its DONE
+    PRESS_SYNC_REASON_PAUSED,       ///< A station's move paused on a "hold" force limit
+    PRESS_SYNC_REASON_BARRIER,      ///< A station waited at a segment too long
+    PRESS_SYNC_REASON_LINK,         ///< The other side went silent during the run
+    PRESS_SYNC_REASON_CLOCK,        ///< A follower had no clock sync when the run started
+    PRESS_SYNC_REASON_REFUSED,      ///< A follower could not start its run
+    PRESS_SYNC_REASON_COUNT
+};
+
+/**
+ * @struct PressSyncMessage
+ * @brief Every sync datagram.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t     magic                         ; ///< PRESS_SYNC_MAGIC
+    uint8_t      version                       ; ///< PRESS_SYNC_VERSION
+    uint8_t      type                          ; ///< PressSyncType
+    uint16_t     run                           ; ///< Leader's run number (ARM, READY, GO, ABORT)
+    uint8_t      segment                       ; ///< Segment number, 1-based (ARM, READY, GO)
+    uint8_t      reason                        ; ///< PressSyncReason (ABORT)
+    uint16_t     reserved                      ; ///< Zero
+    uint32_t     time_us                       ; ///< See PressSyncType
+    uint32_t     echo_us                       ; ///< PONG: time_us of the ping answered
+} PressSyncMessage;
+
+/**
+ * @struct PressSyncStation
+ * @brief What the local press is doing, read each pass.
+ */
+struct PressSyncStation {
+    bool running;                   ///< A run_recipe run is in progress
+    uint8_t waiting;                ///< Segment (1-based) held at the barrier, 0 = none
+    bool paused;                    ///< The move is paused (a "hold" force limit)
+    uint32_t done_count;            ///< run_recipe DONEs since boot (MotorController::getRecipeDoneCount())
+};
+
+/**
+ * @enum PressSyncAction
+ * @brief What service() asks of the press.
+ */
+enum PressSyncAction : uint8_t {
+    PRESS_SYNC_ACTION_NONE = 0,     ///< Nothing to do
+    PRESS_SYNC_ACTION_RUN,          ///< Start run_recipe (a follower, at the first ARM)
+    PRESS_SYNC_ACTION_RELEASE,      ///< Start the waiting segment at the given local time
+    PRESS_SYNC_ACTION_ABORT         ///< Stop the run (see getAbortReason())
+};
+
+/**
+ * @struct PressSyncPeer
+ * @brief A follower as the leader sees it.
+ */
+struct PressSyncPeer {
+    uint32_t ip;                    ///< Address (0 = free slot)
+    uint32_t last_ms;               ///< Milliseconds() of its last datagram
+    uint16_t ready_run;             ///< Run of its last READY
+    uint8_t ready_segment;          ///< Segment of its last READY
+    bool in_run;                    ///< Up when the current run started, so the barrier waits for it
+};
+
+/**
+ * @class PressSync
+ * @brief The sync pcb, the clock estimate and the barrier state. Main loop only.
+ */
+class PressSync {
+public:
+    /**
+     * @brief Constructs the sync off and not yet listening.
+     */
+    PressSync();
+
+    /**
+     * @brief Binds PRESS_SYNC_PORT once the network is up; later calls do nothing.
+     * @return true if the port is bound
+     */
+    bool open();
+
+    /**
+     * @brief Sets the role. Ends any run in progress and forgets the peers and the clock.
+     * @param role PressSyncRole
+     * @param leader Leader's address (followers)
+     */
+    void configure(PressSyncRole role, const IpAddress& leader);
+
+    /**
+     * @brief Gets the role.
+     * @return PressSyncRole
+     */
+    PressSyncRole getRole() const { return m_role; }
+
+    /**
+     * @brief Moves the pings, barrier and abort handling forward.
+     * @param station What the press is doing
+     * @param release_us Receives the local start time with PRESS_SYNC_ACTION_RELEASE
+     * @return What the press should do
+     */
+    PressSyncAction service(const PressSyncStation& station, uint32_t* release_us);
+
+    /**
+     * @brief Gets why the last abort happened.
+     * @return PressSyncReason
+     */
+    PressSyncReason getAbortReason() const { return m_abortReason; }
+
+    /**
+     * @brief Gets where the last abort came from.
+     * @return Sender's address, or 0 if this press raised it
+     */
+    uint32_t getAbortFrom() const { return m_abortFrom; }
+
+    /**
+     * @brief Checks whether a follower has a usable estimate of the leader's clock.
+     * @return true once PRESS_SYNC_CLOCK_MIN_SAMPLES pongs came back under PRESS_SYNC_CLOCK_RTT_MAX_US
+     */
+    bool isClockSynced() const;
+
+    /**
+     * @brief Writes the role, peers, clock and counters (e.g. "role=follower leader=192.168.1.20 ...").
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return Characters written (as snprintf)
+     */
+    int formatStatus(char* buffer, size_t size) const;
+
+    /**
+     * @brief Gets the name of an abort reason as reported.
+     * @param reason PressSyncReason
+     * @return e.g. "barrier timeout"
+     */
+    static const char* reasonName(PressSyncReason reason);
+
+    /**
+     * @brief Gets the name of a role as set_sync takes it.
+     * @param role PressSyncRole
+     * @return "off", "leader" or "follower"
+     */
+    static const char* roleName(PressSyncRole role);
+
+    /**
+     * @brief Parses a dotted IPv4 address as set_sync takes it.
+     * @param text e.g. "192.168.1.20"
+     * @param ip Receives the address
+     * @return false if @p text is not an address, or is 0.0.0.0
+     */
+    static bool parseAddress(const char* text, IpAddress* ip);
+
+private:
+    static void receive(void* arg, struct udp_pcb* pcb, struct pbuf* p, const ip_addr_t* addr, u16_t port);
+    void accept(const PressSyncMessage& msg, uint32_t ip);
+    void send(uint32_t ip, uint8_t type, uint8_t segment, uint8_t reason, uint32_t time_us, uint32_t echo_us);
+    void sendFollowers(uint8_t type, uint8_t segment, uint8_t reason, uint32_t time_us);
+    PressSyncPeer* findPeer(uint32_t ip, bool add);
+    PressSyncAction raiseAbort(PressSyncReason reason);
+    void endRun();
+    PressSyncAction serviceLeader(const PressSyncStation& station, uint32_t now_ms, uint32_t* release_us);
+    PressSyncAction serviceFollower(const PressSyncStation& station, uint32_t now_ms, uint32_t* release_us);
+
+    struct udp_pcb* m_pcb;                              ///< Bound to PRESS_SYNC_PORT (nullptr until open()).
+    struct pbuf* m_txRef;                               ///< PBUF_REF pbuf pointed at m_tx for each send.
+    PressSyncMessage m_tx;                              ///< Datagram being sent.
+    PressSyncRole m_role;                               ///< Role set by set_sync
+    uint32_t m_leaderIp;                                ///< Followers: the leader's address
+    PressSyncPeer m_peers[PRESS_SYNC_MAX_PEERS];        ///< Leader: followers heard from
+
+    // Run
+    bool m_inRun;                                       ///< A synchronized run is in progress
+    uint16_t m_run;                                     ///< Run number (the leader's): the current one or the last
+    uint32_t m_runDoneCount;                            ///< station.done_count when the run started
+    uint8_t m_released;                                 ///< Last segment released
+    uint32_t m_goLeaderUs;                              ///< Start time of that segment (leader clock)
+    uint8_t m_goSegment;                                ///< Followers: segment of the last GO received (0 = none pending)
+    bool m_armPending;                                  ///< Followers: the ARM of a first segment arrived
+    uint16_t m_armRun;                                  ///< Its run number
+    bool m_expectRun;                                   ///< Followers: RUN was asked for in the last pass
+    uint8_t m_waitSegment;                              ///< Segment the barrier timer runs for
+    uint32_t m_waitSinceMs;                             ///< When the press reached that barrier
+    uint32_t m_lastSendMs;                              ///< Last ARM, READY or GO sent
+    uint32_t m_lastHeardMs;                             ///< Followers: last datagram from the leader
+    bool m_abortPending;                                ///< An ABORT arrived for the run
+    PressSyncReason m_abortReason;                      ///< Why the last abort happened (NONE again at each run start)
+    uint32_t m_abortFrom;                               ///< Where it came from (0 = here)
+
+    // Clock (followers)
+    uint32_t m_lastPingMs;                              ///< Last PING sent
+    int32_t m_clockOffsetUs[PRESS_SYNC_CLOCK_WINDOW];   ///< Leader minus local clock, per sample
+    uint32_t m_clockRttUs[PRESS_SYNC_CLOCK_WINDOW];     ///< Round trip of each sample
+    uint8_t m_clockHead;                                ///< Next sample slot
+    uint8_t m_clockCount;                               ///< Valid samples
+    int32_t m_offsetUs;                                 ///< Offset of the shortest round trip in the window
+    uint32_t m_bestRttUs;                               ///< That round trip
+
+    uint32_t m_runs;                                    ///< Synchronized runs started since boot
+    uint32_t m_aborts;                                  ///< Aborts, raised here or received, since boot
+    uint32_t m_dropped;                                 ///< Datagrams ignored (bad magic, version, size or sender)
+};
+
+extern PressSync g_pressSync;
+
+#endif // PRESS_SYNC_ENABLED
@@ -16,7 +16,10 @@
 #include "motor_controller.h"
 #include "force_sensor.h"
 #include "commands.h"
+#include "command_args.h"
 #include "error_log.h"
+#include "variables.h"
+#include "event_queue.h"
 
 /**
  * @enum MainState
@@ -51,6 +54,19 @@ enum ErrorState : uint8_t {
 	ERROR_MOTORS_DISABLED         ///< An operation was blocked because motors are disabled.
 };
 
+/**
+ * @enum DumpJob
+ * @brief Diagnostic dumps sent in the background, a few lines per loop pass.
+ */
+enum DumpJob : uint8_t {
+	DUMP_JOB_NONE,                ///< No dump running.
+	DUMP_JOB_NVM,                 ///< dump_nvm
+	DUMP_JOB_ERROR_LOG,           ///< dump_error_log (error log, then heartbeat log)
+	DUMP_JOB_TRACE,               ///< dump_trace
+	DUMP_JOB_CRASH,               ///< dump_crash
+	DUMP_JOB_LOG_BINARY           ///< dump_error_log binary (both rings as LOGDUMP lines)
+};
+
 /**
  * @class Pressboi
  * @brief The master controller for the Pressboi press system.
@@ -84,8 +100,54 @@ public:
      * @brief Public interface for sub-controllers to send status messages.
      * @param statusType The prefix for the message (e.g., "INFO: ").
      * @param message The content of the message to send.
+     * @param lane TX priority lane (see CommsController::reportEvent()).
+     */
+    void reportEvent(TextView statusType, TextView message, TxLane lane = TX_LANE_CONTROL);
+
+    /**
+     * @brief reportEvent() with C strings; a literal prefix or message is measured at compile time.
+     */
+    void reportEvent(const char* statusType, const char* message, TxLane lane = TX_LANE_CONTROL) {
+        reportEvent(text_view(statusType), text_view(message), lane);
+    }
+
+    /**
+     * @brief Queues a typed status event for the request being handled; rendered by serviceEvents().
+     * @details Cheap enough for the control path: no formatting, a few stores with interrupts masked.
+     * @param id Event
+     * @param arg0 First argument (see status_events.json)
+     * @param arg1 Second argument
+     * @param arg2 Third argument
+     */
+    void postEvent(StatusEventId id, EventArg arg0 = eventArgI(0), EventArg arg1 = eventArgI(0),
+                   EventArg arg2 = eventArgI(0));
+
+    /**
+     * @brief Queues one dump line on the bulk TX lane.
+     * @details Unlike reportEvent(..., TX_LANE_BULK) the line is dropped, not promoted to the
+     * control lane, when the bulk lane is full, so a long dump can never flood events.
+     * @param statusType The prefix for the message (e.g., "INFO: ").
+     * @param message The content of the message to send.
+     * @return false if the line was dropped (bulk lane full)
      */
-    void reportEvent(const char* statusType, const char* message);
+    bool reportBulkLine(TextView statusType, TextView message);
+
+    /**
+     * @brief reportBulkLine() with C strings; a literal prefix is measured at compile time.
+     */
+    bool reportBulkLine(const char* statusType, const char* message) {
+        return reportBulkLine(text_view(statusType), text_view(message));
+    }
+
+#if CRASH_SNAPSHOT_ENABLED
+    /**
+     * @brief Fills and seals the crash snapshot. Called from the watchdog early warning and
+     * the HardFault handler just before the reset.
+     * @param cause CrashCause
+     * @param frame HardFault exception stack frame, or NULL
+     */
+    void captureCrashSnapshot(uint8_t cause, const uint32_t* frame);
+#endif
 
 private:
     /**
@@ -102,17 +164,219 @@ private:
      */
     void updateState();
 
+    // --- Main Loop Tasks (run by g_loopScheduler) ---
+    /**
+     * @brief Registers the main-loop subsystems with g_loopScheduler. Called once from setup().
+     */
+    void registerLoopTasks();
+
+    /**
+     * @brief Logs a slow-loop warning for new slow passes, rate limited to LOOP_SLOW_PASS_LOG_MS.
+     */
+    void reportSlowPasses();
+
+    /**
+     * @brief Fills the force_rate_hz, force_jitter_us, force_errors and force_stuck telemetry
+     * fields from the selected load cell(s) and logs a warning when one turns degraded.
+     */
+    void updateForceHealth();
+
+    static void safetyTask(void* context, uint32_t budget_us);     ///< performSafetyCheck()
+    static void forceTask(void* context, uint32_t budget_us);      ///< Force sensor updates
+    static void stateTask(void* context, uint32_t budget_us);      ///< serviceState()
+    static void commsRxTask(void* context, uint32_t budget_us);    ///< CommsController::updateRx()
+    static void commandTask(void* context, uint32_t budget_us);    ///< serviceCommands()
+    static void commsTxTask(void* context, uint32_t budget_us);    ///< CommsController::updateTx()
+    static void telemetryTask(void* context, uint32_t budget_us);  ///< serviceTelemetry()
+    static void loggingTask(void* context, uint32_t budget_us);    ///< Capture dump and debug log drains
+    static void sdLogTask(void* context, uint32_t budget_us);      ///< SdLog::service()
+    static void settingsTask(void* context, uint32_t budget_us);   ///< Queues flashJob() when a store has work
+    static void idleTask(void* context, uint32_t budget_us);       ///< IdleWork::service()
+    static bool flashJob(void* context, uint32_t budget_us);       ///< Journal, profile and settings flash steps
+
+    /**
+     * @brief Checks for a force table, friction table, drive geometry or recipe saved since
+     * its last NVM write.
+     * @return true if commitNvmTable() has work
+     */
+    bool nvmTablesPending() const;
+
+    /**
+     * @brief Writes the first pending table to NVM, one user-page write per call.
+     * @return false if the write was refused (the table stays pending)
+     */
+    bool commitNvmTable();
+#if PRESS_SYNC_ENABLED
+    static void syncTask(void* context, uint32_t budget_us);       ///< serviceSync()
+
+    /**
+     * @brief Gives press sync what the motor is doing and carries out what it asks: start
+     * the recipe (followers), release the held segment, or stop the run.
+     */
+    void serviceSync();
+#endif
+#if FW_UPDATE_ENABLED
+    static void fwUpdateTask(void* context, uint32_t budget_us);   ///< FirmwareUpdate::service()
+
+    /**
+     * @brief Reports the firmware update's progress and runs the switch-over once apply
+     * is due.
+     */
+    void serviceFirmwareUpdate();
+#endif
+
+#if CYCLE_IO_ENABLED
+    /**
+     * @brief Starts the stored recipe on a cycle-start edge and shows how the cycle ended
+     * on the cycle outputs.
+     */
+    void serviceCycleIo();
+#endif
+
+#if REGISTER_MAP_ENABLED
+    /**
+     * @brief Copies the latest control-tick values into the register image, before the
+     * network is polled so a PLC read sees this pass.
+     */
+    void refreshRegisterImage();
+
+    /**
+     * @brief Binds the register port once the network is up and queues the mailbox command
+     * a PLC wrote as "#<id> cmdb <frame>".
+     */
+    void serviceRegisterMailbox();
+
+    /**
+     * @brief Folds a reply into the image's last result and its mailbox command's status.
+     * @param statusType STATUS_PREFIX_* the reply was sent with
+     */
+    void noteRegisterResult(TextView statusType);
+#endif
+
+    /**
+     * @brief Dequeues and dispatches received commands.
+     * @param budget_us Stop after this much time (at least one command is handled)
+     */
+    void serviceCommands(uint32_t budget_us);
+
+    /**
+     * @brief Runs the state machine, the delayed auto-home and the recovery message.
+     */
+    void serviceState();
+
+    /**
+     * @brief Publishes telemetry when its burst, busy or idle interval has passed.
+     * @details The burst interval applies while MotorController::isPressing() and for the
+     * set_telemetry_burst hold after it, so the loaded part of a press is sent at the high
+     * rate without the host switching rates around it.
+     */
+    void serviceTelemetry();
+
+    /**
+     * @brief Moves queued typed events into the TX queue, as text or (EVENT=BIN1) as records.
+     * @details Also run before every reportEvent(), so events keep their order with text messages.
+     */
+    void serviceEvents();
+
 	/**
 	 * @brief Master command handler; dispatches incoming commands to the correct sub-system.
 	 * @param msg The incoming message object containing the command to be executed.
 	 */
-    void dispatchCommand(const Message& msg);
+    void dispatchCommand(const MessageView& msg);
+
+    /**
+     * @brief Skips a leading request-ID token ("#123 move_abs ...") of a command.
+     * @param msg Received message; its text is advanced past the token and the spaces after it.
+     * @return The ID, or 0 if the command has none.
+     */
+    static uint32_t takeRequestId(MessageView& msg);
 
 	/**
 	 * @brief Aggregates telemetry data from all sub-controllers and sends it as a single packet.
 	 */
     void publishTelemetry();
 
+	/**
+	 * @brief Sends the next dump_capture or dump_curve line if one is pending and the TX queue has room.
+	 */
+    void serviceCaptureDump();
+
+	/**
+	 * @brief Sends pending set_debug records while the TX queue has room.
+	 */
+    void serviceDebugLog();
+
+    /**
+     * @brief Starts a background dump, unless one is already running (reports the error).
+     * @param job DumpJob to start
+     * @return true if the job was started
+     */
+    bool startDumpJob(DumpJob job);
+
+    /**
+     * @brief Gets the command name of a dump job, as used in its DONE and error replies.
+     * @param job DumpJob
+     * @return Command name, e.g. "dump_nvm"
+     */
+    static const char* dumpJobName(DumpJob job);
+
+	/**
+	 * @brief Sends the next lines of the running dump_nvm/dump_error_log/dump_trace job as TX room allows.
+	 */
+    void serviceDumpJob();
+
+    /**
+     * @brief Formats one line of dump_nvm.
+     * @param line Line index
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return false past the last line
+     */
+    bool formatNvmDumpLine(uint16_t line, char* buffer, size_t size);
+
+    /**
+     * @brief Formats one line of dump_error_log (error log, then heartbeat log).
+     * @param line Line index
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return false past the last line
+     */
+    bool formatErrorLogDumpLine(uint16_t line, char* buffer, size_t size);
+
+    /**
+     * @brief Formats one LOGDUMP line of dump_error_log binary (header, error entries, heartbeat runs).
+     * @param line Line index
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return false past the last line
+     */
+    bool formatLogBinaryDumpLine(uint16_t line, char* buffer, size_t size);
+
+    /**
+     * @brief Formats one TRACE DATA line of dump_trace.
+     * @param line Line index
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return false past the last line
+     */
+    bool formatTraceDumpLine(uint16_t line, char* buffer, size_t size);
+
+#if CRASH_SNAPSHOT_ENABLED
+    /**
+     * @brief Formats one line of dump_crash.
+     * @param line Line index
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     * @return false past the last line
+     */
+    bool formatCrashDumpLine(uint16_t line, char* buffer, size_t size);
+
+    /**
+     * @brief Reports a summary of the snapshot the previous reset left, if any. Called from setup().
+     */
+    void reportCrashSnapshot();
+#endif
+
     // --- System-Level Command Handlers ---
     /**
      * @brief Enables all motors and places the system in a ready state.
@@ -131,8 +395,9 @@ private:
 
     /**
      * @brief Resets any error states, clears motor faults, and returns the system to standby.
+     * @param full true to cycle the drives even when only controller state needs clearing
      */
-    void clearErrors();
+    void clearErrors(bool full = false);
 
     /**
      * @brief Resets all sub-controllers to their idle states and sets the main state to STANDBY.
@@ -148,6 +413,13 @@ private:
      */
     void handleWatchdogRecovery();
 
+    /**
+     * @brief Formats the RECOVERY message naming where the previous boot stopped.
+     * @param buffer Output buffer
+     * @param size Size of @p buffer
+     */
+    void formatRecoveryMessage(char* buffer, size_t size);
+
     /**
      * @brief Initializes the watchdog timer with early warning interrupt.
      * @details Configures the watchdog for a ~128ms timeout with early warning interrupt
@@ -170,7 +442,8 @@ private:
 public:
     // --- Component Ownership ---
     CommsController  m_comms;           ///< Manages all network and serial communication.
-    ForceSensor      m_forceSensor;     ///< Manages force readings from HX711 via Rugeduino.
+    ForceSensor      m_forceSensor;     ///< Manages force readings from HX711 via Rugeduino (channel A, COM-0).
+    ForceSensor      m_forceSensorB;    ///< Second load cell on COM-1 (channel B) for two-cell fixtures.
 
 private:
     MotorController  m_motor;           ///< Manages the dual-motor press system.
@@ -184,6 +457,49 @@ private:
     uint32_t m_faultGracePeriodEnd;     ///< Timestamp when fault detection grace period ends (after clearing faults).
     
     // Auto-homing delay on boot (to prevent watchdog timeout during startup)
-    bool m_homingPending;               ///< Flag indicating homing should be initiated after delay.
-    uint32_t m_homingDelayStart;        ///< Timestamp when homing delay started.
+    bool m_homingPending;               ///< Home-on-boot is waiting for the drives to enable.
+    uint32_t m_homingDelayStart;        ///< Milliseconds() at setup, for HOMING_BOOT_ENABLE_TIMEOUT_MS.
+    
+    int32_t m_captureDumpNext;          ///< Next capture sample to send for dump_capture (-1 = no dump running).
+    bool m_captureDumpCurve;            ///< The running capture dump is dump_curve.
+    bool m_telemetryBinary;             ///< Send binary telemetry frames (negotiated with TELEM=BIN1 in DISCOVER_DEVICE).
+    bool m_eventBinary;                 ///< Send typed events as records (negotiated with EVENT=BIN1 in DISCOVER_DEVICE).
+    uint16_t m_telemetrySeq;            ///< Sequence number of the next binary telemetry frame.
+    uint32_t m_telemetryBusyIntervalMs; ///< Telemetry period while STATE_BUSY (set_telemetry).
+    uint32_t m_telemetryIdleIntervalMs; ///< Telemetry period in every other state (set_telemetry).
+    uint32_t m_telemetryPressIntervalMs;///< Telemetry period while pressing (set_telemetry_burst; 0 = no burst).
+    uint32_t m_telemetryPressHoldMs;    ///< The burst period is kept this long after pressing ends.
+    uint32_t m_telemetryPressLastMs;    ///< Timestamp pressing was last seen at.
+    bool m_telemetryBurst;              ///< The burst period is in use.
+    uint32_t m_telemetryFields;         ///< TELEM_FIELD_BIT() mask of fields in the text telemetry line.
+    uint32_t m_telemetryKeyframeMs;     ///< Delta telemetry keyframe period (0 = every line is full).
+    uint32_t m_telemetryLastKeyframe;   ///< Timestamp of the last full telemetry line.
+    TelemetryData m_telemetrySent;      ///< Last value sent of each field, for delta telemetry.
+    uint32_t m_telemetryQueuedFields;   ///< Fields of the frame in the telemetry TX slot.
+    uint32_t m_slowPassesLogged;        ///< Slow-pass count as of the last slow-loop warning.
+    uint32_t m_slowPassLogTime;         ///< Milliseconds() of the last slow-loop warning.
+    bool m_forceDegraded;               ///< A selected load cell was slow or stuck at the last telemetry frame.
+    uint32_t m_eventRequestId;          ///< Request ID reportEvent() tags events with (0 = none).
+    uint32_t m_operationRequestId;      ///< Request ID of the command that started the running operation.
+    uint32_t m_captureDumpRequestId;    ///< Request ID of the running dump_capture or dump_curve.
+    uint8_t m_dumpJob;                  ///< DumpJob running in the background (DUMP_JOB_NONE = idle).
+    uint16_t m_dumpLine;                ///< Next line of the running dump job.
+    uint16_t m_dumpErrorCount;          ///< Error log entries when dump_error_log started.
+    uint32_t m_dumpErrorStart;          ///< Sequence number of the oldest of them.
+    uint16_t m_dumpHeartbeatCount;      ///< Heartbeat log entries when dump_error_log started.
+    uint32_t m_dumpRunStart;            ///< Oldest heartbeat run sequence number when dump_error_log binary started.
+    uint32_t m_dumpRunEnd;              ///< Heartbeat run sequence number when it started (not included).
+    uint32_t m_dumpRequestId;           ///< Request ID of the running dump job.
+    int32_t m_dumpNvmValues[NVM_SLOT_COUNT]; ///< NVM slots read when dump_nvm started.
+    uint32_t m_dumpTraceStart;          ///< Oldest trace sequence number when dump_trace started.
+    uint32_t m_dumpTraceEnd;            ///< Trace sequence number when dump_trace started (not included).
+    uint8_t m_commandFrame[COMMAND_FRAME_MAX_LENGTH]; ///< Decoded "cmdb" frame; its rest params point into it.
+#if CYCLE_IO_ENABLED
+    bool m_cycleActive;                 ///< A recipe started by the cycle-start input is running.
+    uint32_t m_cycleDoneCount;          ///< Recipe DONE count when that cycle started.
+#endif
+#if FW_UPDATE_ENABLED
+    uint8_t m_fwUpdateState;            ///< FwUpdateState last reported.
+    uint32_t m_fwUpdateRequestId;       ///< Request ID of the fw_update begin or apply in progress.
+#endif
 };
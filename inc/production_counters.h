@@ -0,0 +1,94 @@
+/**
+ * @file production_counters.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the lifetime production counters kept across reboots.
+ *
+ * @details Completed press cycles, axis travel, press energy, force-limit trips and a
+ * histogram of each cycle's peak force are counted in RAM and checkpointed to the NVM
+ * journal (nvm_journal.h) every PRODUCTION_CHECKPOINT_CYCLES cycles, one record per counter
+ * that changed. A checkpoint costs a few quad-word writes and the journal's wear leveling
+ * spreads the erases, so the counters outlive the press without a block erase per cycle.
+ * Travel and energy are stored in whole mm and J; the fraction stays in RAM. A power loss
+ * forgets the cycles since the last checkpoint. Unlike m_cumulative_distance_mm, which
+ * restarts with each home, the counters only restart with reset_production.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "nvm_journal.h"
+
+/**
+ * @class ProductionCounters
+ * @brief Lifetime counters with periodic journal checkpoints. Main loop only.
+ */
+class ProductionCounters {
+public:
+    /**
+     * @brief Constructs zeroed counters. load() restores the stored ones.
+     */
+    ProductionCounters();
+
+    /**
+     * @brief Restores the counters from the journal. Call after the journal is loaded.
+     */
+    void load();
+
+    /**
+     * @brief Counts a completed press cycle, and checkpoints every PRODUCTION_CHECKPOINT_CYCLES.
+     * @param energy_j Press energy of the cycle (J)
+     * @param peak_kg Peak force of the cycle (kg)
+     * @param has_peak false if no load-cell samples were taken (no histogram entry)
+     */
+    void addCycle(float energy_j, float peak_kg, bool has_peak);
+
+    /**
+     * @brief Adds the distance of a finished move.
+     * @param distance_mm Travel (mm)
+     */
+    void addTravel(float distance_mm);
+
+    /**
+     * @brief Counts a force limit reached during a move.
+     */
+    void addTrip() { m_trips++; }
+
+    /**
+     * @brief Puts every counter to the journal now.
+     */
+    void checkpoint();
+
+    /**
+     * @brief Zeroes the counters and checkpoints them.
+     */
+    void reset();
+
+    uint32_t getCycles() const { return m_cycles; }                  ///< Completed press cycles.
+    uint32_t getTrips() const { return m_trips; }                    ///< Force-limit trips.
+    uint32_t getCheckpointCycle() const { return m_checkpointCycles; } ///< Cycle count at the last checkpoint.
+    double getTravelMm() const { return (double)m_travelMm + m_travelFractionMm; } ///< Axis travel (mm).
+    double getEnergyJ() const { return (double)m_energyJ + m_energyFractionJ; }    ///< Press energy (J).
+
+    /**
+     * @brief Gets a peak-force histogram bucket.
+     * @param bucket 0 .. PRODUCTION_PEAK_BUCKETS - 1; bucket b holds peaks from
+     * b * PRODUCTION_PEAK_BUCKET_KG, the last one everything above
+     * @return Cycles
+     */
+    uint32_t getPeakBucket(uint8_t bucket) const { return m_peakHist[bucket]; }
+
+private:
+    static void put(NvmJournalKey key, uint32_t value);
+
+    uint32_t m_cycles;                              ///< Completed press cycles
+    uint32_t m_travelMm;                            ///< Whole mm of travel
+    float m_travelFractionMm;                       ///< Travel not yet a whole mm
+    uint32_t m_energyJ;                             ///< Whole J of press energy
+    float m_energyFractionJ;                        ///< Energy not yet a whole J
+    uint32_t m_trips;                               ///< Force-limit trips
+    uint32_t m_peakHist[PRODUCTION_PEAK_BUCKETS];   ///< Cycles per peak-force bucket
+    uint32_t m_checkpointCycles;                    ///< m_cycles at the last checkpoint
+};
+
+extern ProductionCounters g_productionCounters;
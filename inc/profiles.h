@@ -0,0 +1,151 @@
+/**
+ * @file profiles.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the named calibration profiles kept in main flash.
+ *
+ * @details Each part family needs its own strain coefficients, load cell scale and offset,
+ * motor torque calibration and press threshold. save_profile snapshots the current values
+ * from the settings block under a name, and select_profile puts them all back in one
+ * command, so a tooling changeover costs one settings commit instead of one per
+ * calibration command.
+ *
+ * Up to PROFILE_MAX_COUNT profiles are held in RAM and stored as one CRC-checked image in
+ * the erase block at PROFILE_FLASH_ADDR, just below the NVM journal. A change marks the
+ * image dirty; service() then erases the block and writes the image page by page, one
+ * flash operation per call, like the journal. A reset during that rewrite loses the
+ * stored profiles (the CRC fails on the next boot), not the active calibration, which
+ * lives in the settings block.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "settings.h"
+
+/**
+ * @struct CalibrationProfile
+ * @brief One named set of calibration values (little endian, as stored).
+ */
+struct CalibrationProfile {
+    char name[PROFILE_NAME_LENGTH];                         ///< NUL-terminated; empty = free slot
+    float strain_coeffs[5];                                 ///< Machine strain polynomial, x^4 first
+    float force_scale[FORCE_SENSOR_MAX_CHANNELS];           ///< Load cell scale per channel (kg per count)
+    float force_offset_kg[FORCE_SENSOR_MAX_CHANNELS];       ///< Load cell offset per channel (kg)
+    float torque_scale;                                     ///< Motor torque mode: Torque% per kg
+    float torque_offset;                                    ///< Motor torque mode: Torque% at zero force
+    float press_threshold_kg;                               ///< Force that counts as contact
+};
+
+/**
+ * @enum ProfileStoreState
+ * @brief What the store is waiting on.
+ */
+enum ProfileStoreState : uint8_t {
+    PROFILE_STATE_IDLE = 0,         ///< Nothing in flight
+    PROFILE_STATE_ERASING,          ///< Block erase in flight
+    PROFILE_STATE_WRITING,          ///< Page write in flight
+    PROFILE_STATE_FAILED            ///< Flash refused an operation; changes stay in RAM
+};
+
+/**
+ * @class ProfileStore
+ * @brief Holds the calibration profiles and writes them to flash. Main loop only.
+ */
+class ProfileStore {
+public:
+    /**
+     * @brief Constructs an empty store.
+     */
+    ProfileStore();
+
+    /**
+     * @brief Reads the stored profiles. Leaves the store empty if the image is missing or
+     * corrupt. Call once in setup().
+     */
+    void load();
+
+    /**
+     * @brief Saves the calibration values of @p settings under @p name, replacing a
+     * profile of that name or taking a free slot.
+     * @param name 1 to PROFILE_NAME_LENGTH - 1 characters
+     * @param settings Source of the values
+     * @return Slot used, or -1 if the name is invalid or every slot is taken
+     */
+    int8_t save(const char* name, const PressSettings& settings);
+
+    /**
+     * @brief Deletes a profile.
+     * @param name Profile name
+     * @return Slot freed, or -1 if there is no such profile
+     */
+    int8_t remove(const char* name);
+
+    /**
+     * @brief Looks up a profile.
+     * @param name Profile name
+     * @return Slot, or -1 if there is no such profile
+     */
+    int8_t find(const char* name) const;
+
+    /**
+     * @brief Gets the profile in a slot.
+     * @param slot 0 .. PROFILE_MAX_COUNT - 1
+     * @return Profile, or NULL if the slot is free or out of range
+     */
+    const CalibrationProfile* get(int8_t slot) const;
+
+    /**
+     * @brief Gets the number of stored profiles.
+     * @return Profiles in use
+     */
+    uint8_t getCount() const;
+
+    /**
+     * @brief Deletes every profile.
+     */
+    void clear();
+
+    /**
+     * @brief Moves a pending rewrite forward by at most one flash operation. Called from
+     * the settings loop task.
+     */
+    void service();
+
+    /**
+     * @brief Checks that no flash operation is in flight or pending.
+     * @return true when the NVM controller is free for other stores
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief Gets the store state.
+     * @return ProfileStoreState
+     */
+    uint8_t getState() const { return m_state; }
+
+    /**
+     * @brief Gets the name of a state as shown in reports.
+     * @param state ProfileStoreState
+     * @return State name
+     */
+    static const char* stateName(uint8_t state);
+
+private:
+    /**
+     * @struct Image
+     * @brief The profiles as stored in flash.
+     */
+    struct Image {
+        uint32_t magic;                                     ///< PROFILE_MAGIC
+        uint32_t crc;                                       ///< CRC-32 of the profiles
+        CalibrationProfile profiles[PROFILE_MAX_COUNT];     ///< Slots
+    };
+
+    Image m_image;                  ///< RAM copy of the stored image
+    bool m_dirty;                   ///< Changed since the last rewrite started
+    uint8_t m_state;                ///< ProfileStoreState
+    uint8_t m_page;                 ///< Page being written during a rewrite
+};
+
+extern ProfileStore g_profileStore;
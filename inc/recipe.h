@@ -0,0 +1,297 @@
+/**
+ * @file recipe.h
+ * @author Eldin Miller-Stead
+ * @date November 4, 2025
+ * @brief Defines the on-device press recipe store.
+ *
+ * @details A recipe is a named list of motion queue steps (moves, dwells and retracts)
+ * uploaded once with recipe_new / recipe_add / recipe_save and run with a single
+ * run_recipe command. The store holds one recipe in RAM and persists it to the NVM
+ * user area (slots NVM_SLOT_RECIPE onward), packed to 12 bytes per step.
+ *
+ * With recipe_learn enabled, the store also keeps a running estimate of where each move
+ * step makes contact (force threshold crossing). MotorController approaches at the rapid
+ * speed up to the learn margin short of that point, then continues at the step's speed.
+ * Estimates are RAM only and are relearned after a reboot or a new recipe.
+ *
+ * A recipe can also carry a golden-curve envelope: lower and upper force bands on a grid
+ * of equal position bins, uploaded with recipe_envelope. Each load-cell sample of a recipe
+ * move with a force limit is looked up by its bin, and a force outside the band stops the
+ * press and fails the part. The envelope is RAM only like the contact estimates; the host
+ * uploads it again after a reboot, and a new recipe clears it.
+ *
+ * Position bands uploaded with recipe_zones cap the speed, torque limit and force limit
+ * of recipe moves over part of the stroke, e.g. a slow and gentle band where the tool
+ * meets the part. MotorController compiles them to step boundaries when each move starts
+ * and its control tick applies the band the axis is in. They are RAM only as well.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "motor_controller.h"
+
+/**
+ * @struct RecipeZone
+ * @brief One band of the recipe's position-indexed limit map.
+ */
+struct RecipeZone {
+    float start_mm;     ///< Band start (mm from home)
+    float end_mm;       ///< Band end, above start_mm
+    float speed_mms;    ///< Speed ceiling in the band (0 = the step's speed)
+    float torque_pct;   ///< Motor torque ceiling in the band (0 = the move's limit)
+    float force_kg;     ///< Force limit ceiling in the band (0 = the step's limit)
+};
+
+// Upper half of the header slot; the step count sits in the low byte
+#define RECIPE_NVM_MAGIC        0x52430000
+#define RECIPE_NVM_MAGIC_MASK   0xFFFF0000
+
+/** Packed step as stored in NVM (12 bytes). */
+struct RecipeNvmStep {
+    int32_t value;          ///< Position (float bits) for moves, dwell time (ms) for dwells
+    int16_t speed_centi;    ///< Speed in 0.01 mm/s (0 = default / stored retract speed)
+    int16_t force_deci;     ///< Force limit in 0.1 kg
+    uint8_t type;           ///< MotionSegmentType
+    uint8_t action;         ///< ForceAction
+    uint16_t dwell_ms;      ///< Hold time (ms) of a "regulate" move, 0 otherwise
+};
+
+/** Whole recipe area as stored in NVM, starting at NVM_SLOT_RECIPE. */
+struct RecipeNvmImage {
+    int32_t header;                             ///< RECIPE_NVM_MAGIC | step count
+    char name[RECIPE_NAME_LENGTH];              ///< NUL-terminated name
+    RecipeNvmStep steps[RECIPE_MAX_STEPS];      ///< Steps in run order
+    int16_t learn_margin_centi;                 ///< Adaptive approach margin in 0.01 mm (<= 0 = off)
+    int16_t learn_rapid_centi;                  ///< Adaptive approach speed in 0.01 mm/s
+};
+
+/**
+ * @class RecipeStore
+ * @brief Holds the stored recipe and converts it to and from its NVM image.
+ */
+class RecipeStore {
+public:
+    /**
+     * @brief Constructs an empty, unnamed recipe store.
+     */
+    RecipeStore();
+
+    /**
+     * @brief Loads the recipe saved in NVM. Leaves the store empty if none is saved.
+     */
+    void load();
+
+    /**
+     * @brief Packs the current recipe for NVM; commit() writes it from the idle flash job.
+     * @return false if the store has no named recipe
+     */
+    bool save();
+
+    /**
+     * @brief Checks for a recipe saved since the last NVM write.
+     * @return true if commit() has work
+     */
+    bool isPending() const { return m_nvmPending; }
+
+    /**
+     * @brief Writes the recipe staged by save() to NVM in one block write.
+     * @return false if the write was refused (the recipe stays staged)
+     */
+    bool commit();
+
+    /**
+     * @brief Erases the NVM recipe header so no recipe is loaded on the next boot, and
+     * drops a staged one.
+     */
+    void erase();
+
+    /**
+     * @brief Starts a new recipe, discarding the steps held in RAM.
+     * @param name Recipe name (1 to RECIPE_NAME_LENGTH-1 characters)
+     * @return false if the name is empty or too long
+     */
+    bool begin(const char* name);
+
+    /**
+     * @brief Appends a step to the recipe being edited.
+     * @param step Move, dwell or retract step
+     * @return false if no recipe was started or RECIPE_MAX_STEPS are already stored
+     */
+    bool addStep(const MotionSegment& step);
+
+    /**
+     * @brief Checks whether @p name is the stored recipe.
+     * @param name Name to compare
+     * @return true on an exact match
+     */
+    bool matches(const char* name) const;
+
+    /**
+     * @brief Gets the recipe name.
+     * @return Name, or an empty string if no recipe is held
+     */
+    const char* getName() const { return m_name; }
+
+    /**
+     * @brief Gets the number of steps in the recipe.
+     * @return Step count
+     */
+    uint8_t getStepCount() const { return m_step_count; }
+
+    /**
+     * @brief Gets the recipe steps.
+     * @return Array of getStepCount() steps
+     */
+    const MotionSegment* getSteps() const { return m_steps; }
+
+    /**
+     * @brief Sets the adaptive approach parameters saved with the recipe.
+     * @param margin_mm Distance short of the learned contact to slow down (0 = learning off)
+     * @param rapid_mms Approach speed up to that point
+     * @return false if no recipe was started
+     */
+    bool setLearning(float margin_mm, float rapid_mms);
+
+    /**
+     * @brief Checks whether adaptive approach is enabled for this recipe.
+     * @return true if a learn margin is set
+     */
+    bool isLearning() const { return m_learn_margin_mm > 0.0f; }
+
+    /**
+     * @brief Gets the adaptive approach margin.
+     * @return Margin in mm (0 = learning off)
+     */
+    float getLearnMarginMm() const { return m_learn_margin_mm; }
+
+    /**
+     * @brief Gets the adaptive approach rapid speed.
+     * @return Speed in mm/s
+     */
+    float getLearnRapidMms() const { return m_learn_rapid_mms; }
+
+    /**
+     * @brief Gets the learned contact position of a step.
+     * @param step Step index (0-based)
+     * @param position_mm Receives the estimate
+     * @return false if the step has not made contact yet
+     */
+    bool getContactEstimate(uint8_t step, float* position_mm) const;
+
+    /**
+     * @brief Folds an observed contact position into a step's estimate.
+     * @details A contact earlier in the direction of travel than the estimate replaces it,
+     * so the next run never approaches too fast; later contacts move it by ADAPTIVE_APPROACH_ALPHA.
+     * @param step Step index (0-based)
+     * @param position_mm Position where the force threshold was crossed
+     * @param direction +1 if the step moves toward higher positions, -1 otherwise
+     * @return The updated estimate
+     */
+    float recordContact(uint8_t step, float position_mm, int direction);
+
+    /**
+     * @brief Starts a new envelope for the recipe, discarding the current bands.
+     * @param start_mm Position of the centre of the first bin
+     * @param step_mm Bin width (at least RECIPE_ENVELOPE_STEP_MIN_MM)
+     * @return false if no recipe was started or the step is too small
+     */
+    bool beginEnvelope(float start_mm, float step_mm);
+
+    /**
+     * @brief Appends the band of the next bin.
+     * @param lower_kg Lowest accepted force
+     * @param upper_kg Highest accepted force
+     * @return false if no envelope was started, it is full, or lower is above upper
+     */
+    bool addEnvelopeBand(float lower_kg, float upper_kg);
+
+    /**
+     * @brief Removes the envelope, so recipe moves are no longer checked.
+     */
+    void clearEnvelope();
+
+    /**
+     * @brief Checks whether the recipe has an envelope to check against.
+     * @return true if at least one band is set
+     */
+    bool hasEnvelope() const { return m_envelope_count > 0; }
+
+    /**
+     * @brief Gets the number of bands in the envelope.
+     * @return Band count
+     */
+    uint8_t getEnvelopeCount() const { return m_envelope_count; }
+
+    /**
+     * @brief Gets the centre of the first envelope bin.
+     * @return Position in mm
+     */
+    float getEnvelopeStartMm() const { return m_envelope_start_mm; }
+
+    /**
+     * @brief Gets the envelope bin width.
+     * @return Width in mm (0 if no envelope was started)
+     */
+    float getEnvelopeStepMm() const { return m_envelope_step_mm; }
+
+    /**
+     * @brief Looks up the band of the bin nearest a position.
+     * @param position_mm Axis position (mm from home)
+     * @param lower_kg Receives the lowest accepted force
+     * @param upper_kg Receives the highest accepted force
+     * @return false if the position lies outside the envelope
+     */
+    bool getEnvelopeBand(float position_mm, float* lower_kg, float* upper_kg) const;
+
+    /**
+     * @brief Adds a band to the recipe's position-indexed limit map, keeping the bands in position order.
+     * @param zone Band to add; a 0 speed, torque or force leaves that limit to the step
+     * @return false if no recipe was started, the map is full, the band is empty or
+     *         out of range, or it overlaps a band already set
+     */
+    bool addZone(const RecipeZone& zone);
+
+    /**
+     * @brief Removes every band of the limit map.
+     */
+    void clearZones() { m_zone_count = 0; }
+
+    /**
+     * @brief Gets the number of bands in the limit map.
+     * @return Band count
+     */
+    uint8_t getZoneCount() const { return m_zone_count; }
+
+    /**
+     * @brief Gets a band of the limit map.
+     * @param index Band index, in position order (below getZoneCount())
+     * @return The band
+     */
+    const RecipeZone& getZone(uint8_t index) const { return m_zones[index]; }
+
+private:
+    /**
+     * @brief Forgets every learned contact position.
+     */
+    void clearContacts();
+
+    char m_name[RECIPE_NAME_LENGTH];         ///< Recipe name (NUL terminated)
+    MotionSegment m_steps[RECIPE_MAX_STEPS]; ///< Steps in run order
+    uint8_t m_step_count;                    ///< Valid entries in m_steps
+    RecipeNvmImage m_nvmImage;               ///< Image staged by save()
+    bool m_nvmPending;                       ///< m_nvmImage not written to NVM yet
+    float m_learn_margin_mm;                 ///< Adaptive approach margin (0 = off), saved with the recipe
+    float m_learn_rapid_mms;                 ///< Adaptive approach speed, saved with the recipe
+    float m_contact_mm[RECIPE_MAX_STEPS];    ///< Learned contact position per step
+    bool m_contact_valid[RECIPE_MAX_STEPS];  ///< m_contact_mm holds an estimate
+    float m_envelope_start_mm;               ///< Centre of the first envelope bin
+    float m_envelope_step_mm;                ///< Envelope bin width (0 = no envelope started)
+    float m_envelope_lower_kg[RECIPE_ENVELOPE_MAX_BANDS]; ///< Lowest accepted force per bin
+    float m_envelope_upper_kg[RECIPE_ENVELOPE_MAX_BANDS]; ///< Highest accepted force per bin
+    uint8_t m_envelope_count;                ///< Valid bins
+    RecipeZone m_zones[RECIPE_ZONE_MAX];     ///< Limit map bands, by start position
+    uint8_t m_zone_count;                    ///< Valid entries in m_zones
+};
+
+extern RecipeStore g_recipeStore;
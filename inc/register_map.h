@@ -0,0 +1,169 @@
+/**
+ * @file register_map.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the PLC register map: a fixed-layout status image and command mailbox on UDP.
+ *
+ * @details A PLC sends one RegisterRequest datagram to REGISTER_MAP_PORT per cycle and gets
+ * the RegisterImage back in the same transaction, like a Modbus/TCP holding-register block
+ * (both structs are little-endian and packed). The image is refreshed once per main-loop
+ * pass, so answering a poll is a memcpy into the reply from the LwIP receive callback; the
+ * text protocol is not involved.
+ *
+ * The request's mailbox carries one binary command frame (the "cmdb" encoding of
+ * command_args.h) and a sequence number. A frame with a sequence number other than the last
+ * one accepted is queued as an ordinary command whose request ID is
+ * REGISTER_MAP_REQUEST_ID_BASE + the sequence number, so it is dispatched, acknowledged and
+ * logged like any other, and the image reports it QUEUED until its DONE or ERROR comes
+ * back. Resending the same sequence number (every cycle, as a PLC does) runs nothing. The
+ * PLC counts the sequence up from 1 and skips 0, which means "no command".
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+#if REGISTER_MAP_ENABLED
+
+#include "IpAddress.h"
+#include "lwip/udp.h"
+
+#define REGISTER_MAP_MAGIC              0x4D524250  ///< First word of requests and images ("PBRM").
+#define REGISTER_MAP_VERSION            1           ///< RegisterImage layout version.
+
+/**
+ * @enum RegisterFlag
+ * @brief Bits of RegisterImage.flags.
+ */
+enum RegisterFlag : uint8_t {
+    REGISTER_FLAG_ENABLED = 0x01,       ///< The drives are enabled
+    REGISTER_FLAG_HOMED = 0x02,         ///< The press has been homed
+    REGISTER_FLAG_BUSY = 0x04,          ///< A move or homing is running
+    REGISTER_FLAG_ERROR = 0x08,         ///< The press is in the ERROR or RECOVERED state
+    REGISTER_FLAG_FORCE_DEGRADED = 0x10 ///< A selected load cell is failing its health checks
+};
+
+/**
+ * @enum RegisterResult
+ * @brief Outcome codes of RegisterImage.result_status and mailbox_status.
+ */
+enum RegisterResult : uint8_t {
+    REGISTER_RESULT_NONE = 0,           ///< Nothing reported yet
+    REGISTER_RESULT_QUEUED,             ///< Mailbox only: accepted, waiting for its DONE or ERROR
+    REGISTER_RESULT_DONE,               ///< Ended with PRESSBOI_DONE
+    REGISTER_RESULT_ERROR,              ///< Ended with PRESSBOI_ERROR
+    REGISTER_RESULT_REJECTED            ///< Mailbox only: not queued (frame too long, or the RX queue full)
+};
+
+/**
+ * @struct RegisterRequest
+ * @brief Datagram a PLC sends to REGISTER_MAP_PORT. The header alone is a read-only poll.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t     magic                         ; ///< REGISTER_MAP_MAGIC
+    uint16_t     mailbox_seq                   ; ///< Command sequence number; 0 or the last one sent runs nothing
+    uint8_t      frame_length                  ; ///< Bytes of frame used (0 = no command)
+    uint8_t      reserved                      ; ///< Zero
+    uint8_t      frame[REGISTER_MAP_FRAME_BYTES]; ///< Binary command frame (see command_args.h)
+} RegisterRequest;
+
+#define REGISTER_REQUEST_HEADER_BYTES   8           ///< RegisterRequest without its frame.
+
+/**
+ * @struct RegisterImage
+ * @brief Datagram sent back for every request.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t     magic                         ; ///< REGISTER_MAP_MAGIC
+    uint16_t     version                       ; ///< REGISTER_MAP_VERSION
+    uint16_t     seq                           ; ///< Reply counter, wraps
+    uint32_t     time_us                       ; ///< Microseconds() of the control tick the values come from
+    // Status
+    uint8_t      main_state                    ; ///< MainState (pressboi.h): 0 STANDBY, 1 BUSY, 2 ERROR, 3 DISABLED, 4 CLEARING_ERRORS, 5 RESETTING, 6 RECOVERED
+    uint8_t      flags                         ; ///< RegisterFlag bits
+    uint16_t     reserved                      ; ///< Zero
+    // Position (mm from home)
+    float        current_pos                   ; ///< Current position of the press axis
+    float        target_pos                    ; ///< Target of the current (or last) move
+    float        retract_pos                   ; ///< Stored retract position (0 if none)
+    // Force (kg)
+    float        force                         ; ///< Force from the selected source
+    float        force_load_cell               ; ///< Force from the load cell
+    float        force_motor_torque            ; ///< Force calculated from motor torque
+    float        force_limit                   ; ///< Force limit of the current operation
+    // Last result
+    float        endpoint                      ; ///< Position where the last move ended
+    float        startpoint                    ; ///< Position where the press threshold was crossed
+    float        joules                        ; ///< Energy of the last (or current) move
+    uint16_t     result_count                  ; ///< Commands that have ended since boot, wraps
+    uint8_t      result_status                 ; ///< RegisterResult of the last command to end (DONE or ERROR)
+    uint8_t      reserved2                     ; ///< Zero
+    // Command mailbox
+    uint16_t     mailbox_seq                   ; ///< Sequence number of the last mailbox command accepted (0 = none)
+    uint8_t      mailbox_status                ; ///< RegisterResult of that command
+    uint8_t      mailbox_command               ; ///< Its Command (commands.h)
+} RegisterImage;
+
+/**
+ * @class RegisterMap
+ * @brief The register pcb, the image it answers with and the mailbox. Main loop only.
+ */
+class RegisterMap {
+public:
+    /**
+     * @brief Constructs the map with an empty image, not yet listening.
+     */
+    RegisterMap();
+
+    /**
+     * @brief Binds REGISTER_MAP_PORT once the network is up; later calls do nothing.
+     * @return true if the port is bound
+     */
+    bool open();
+
+    /**
+     * @brief Gets the image to refresh. Written by the owner before the network is polled.
+     * @return The image answered with
+     */
+    RegisterImage* image() { return &m_image; }
+
+    /**
+     * @brief Takes the mailbox command accepted since the last call.
+     * @param seq Receives its sequence number
+     * @param frame Receives the frame (REGISTER_MAP_FRAME_BYTES)
+     * @param length Receives the frame length
+     * @param ip Receives the sender's address
+     * @param port Receives the sender's port
+     * @return false if there is none
+     */
+    bool takeCommand(uint16_t* seq, uint8_t* frame, uint8_t* length, IpAddress* ip, uint16_t* port);
+
+    /**
+     * @brief Records how a mailbox command ended.
+     * @param seq Its sequence number; ignored unless it is still the latest accepted
+     * @param status RegisterResult
+     */
+    void finishCommand(uint16_t seq, uint8_t status);
+
+    uint32_t getPolls() const { return m_polls; }          ///< Requests answered since boot.
+    uint32_t getDropped() const { return m_dropped; }      ///< Requests ignored (bad magic or size).
+
+private:
+    static void receive(void* arg, struct udp_pcb* pcb, struct pbuf* p, const ip_addr_t* addr, u16_t port);
+    void accept(const RegisterRequest& request, const IpAddress& ip, uint16_t port);
+
+    struct udp_pcb* m_pcb;                          ///< Bound to REGISTER_MAP_PORT (nullptr until open()).
+    struct pbuf* m_txRef;                           ///< PBUF_REF pbuf pointed at m_image for each reply.
+    RegisterImage m_image;                          ///< Image answered with.
+    RegisterRequest m_request;                      ///< Request being handled.
+    uint8_t m_frame[REGISTER_MAP_FRAME_BYTES];      ///< Accepted command waiting for takeCommand().
+    uint8_t m_frameLength;                          ///< Bytes in m_frame; 0 = none waiting.
+    IpAddress m_frameIp;                            ///< Sender of the waiting command.
+    uint16_t m_framePort;                           ///< Its port.
+    uint32_t m_polls;                               ///< Requests answered.
+    uint32_t m_dropped;                             ///< Requests ignored.
+};
+
+extern RegisterMap g_registerMap;
+
+#endif // REGISTER_MAP_ENABLED
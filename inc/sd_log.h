@@ -0,0 +1,164 @@
+/**
+ * @file sd_log.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the micro SD card sink for the error and heartbeat logs.
+ *
+ * @details Every ErrorLog and HeartbeatLog entry is also appended as a text line to a
+ * 512-byte block buffer (error entries by ErrorLog::serviceSdLog() at the start of each
+ * SD task pass, as they may be logged from interrupts), and the buffer goes to the card
+ * as one block write. A block is
+ * written when it fills, every SD_LOG_FLUSH_MS while it is partly filled (the same block
+ * is rewritten as it grows), and straight away after an entry at SD_LOG_FLUSH_LEVEL or
+ * above. libClearCore's SdCardDriver only provides the SPI port (SERCOM4, no DMA), so the
+ * card protocol is driven here as a polled state machine: service() moves the init, the
+ * resume scan or the current block transfer forward until its budget is spent and never
+ * waits on the card. Lines that arrive while the card is absent or still busy with the
+ * previous block are counted as dropped rather than waited for.
+ *
+ * The card is used raw, without a filesystem: SD_LOG_BLOCK_COUNT blocks from
+ * SD_LOG_START_BLOCK form a ring of SdLogBlockHeader-tagged blocks. At start-up a binary
+ * search over the sequence numbers finds where the last session stopped, and writing
+ * continues from there. On the host, read the card raw, keep the blocks with the magic,
+ * sort them by sequence number and print their text.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+/**
+ * @struct SdLogBlockHeader
+ * @brief Start of every block written to the card (16 bytes, little endian).
+ */
+struct SdLogBlockHeader {
+    uint32_t magic;         ///< SD_LOG_MAGIC
+    uint32_t seq;           ///< Block sequence number, increasing across boots
+    uint32_t boot_seq;      ///< Sequence number of the first block of this boot
+    uint16_t used;          ///< Text bytes that follow the header
+    uint16_t reserved;      ///< Zero
+};
+
+/**
+ * @enum SdLogState
+ * @brief Card state, in initialization order.
+ */
+enum SdLogState : uint8_t {
+    SD_LOG_STATE_IDLE = 0,      ///< No card or a failure; init is retried after SD_LOG_RETRY_MS
+    SD_LOG_STATE_POWER_UP,      ///< Clocking the card into SPI mode
+    SD_LOG_STATE_RESET,         ///< CMD0
+    SD_LOG_STATE_IF_COND,       ///< CMD8 (v1 or v2 card)
+    SD_LOG_STATE_ACTIVATE,      ///< ACMD41 until the card leaves idle
+    SD_LOG_STATE_OCR,           ///< CMD58 (block or byte addressing)
+    SD_LOG_STATE_SCAN,          ///< Binary search for the end of the previous session
+    SD_LOG_STATE_READY          ///< Writing blocks
+};
+
+/**
+ * @class SdLog
+ * @brief Block-buffered raw SD card log. Main loop only.
+ */
+class SdLog {
+public:
+    /**
+     * @brief Constructs the sink with an empty buffer and no card.
+     */
+    SdLog();
+
+    /**
+     * @brief Starts card initialization. Returns at once; service() does the work.
+     */
+    void setup();
+
+    /**
+     * @brief Appends one line (a newline is added).
+     * @param text Line text
+     * @param length Characters in @p text
+     * @param urgent Write the block on the next service() instead of waiting for the timer
+     */
+    void append(const char* text, size_t length, bool urgent);
+
+    /**
+     * @brief Moves the card state machine forward. Called from its main-loop task.
+     * @param budget_us Stop once this much time has gone
+     */
+    void service(uint32_t budget_us);
+
+    /**
+     * @brief Gets the card state.
+     * @return SdLogState
+     */
+    uint8_t getState() const { return m_state; }
+
+    /**
+     * @brief Checks whether lines are currently reaching the card.
+     * @return true once the card is initialized and the resume point found
+     */
+    bool isReady() const { return m_state == SD_LOG_STATE_READY; }
+
+    /**
+     * @brief Gets the number of block writes completed since boot.
+     * @return Block writes
+     */
+    uint32_t getBlocksWritten() const { return m_blocks_written; }
+
+    /**
+     * @brief Gets the number of lines dropped because no block buffer was free.
+     * @return Dropped lines
+     */
+    uint32_t getDroppedLines() const { return m_dropped_lines; }
+
+    /**
+     * @brief Gets the number of card failures (init failures, rejected or timed-out transfers).
+     * @return Failures
+     */
+    uint32_t getErrors() const { return m_errors; }
+
+private:
+    bool step();
+    bool stepTransfer();
+    void handOff(bool close_block);
+    void startRead(uint32_t block);
+    void startWrite();
+    void onScanRead();
+    void fail(const char* reason);
+    uint8_t command(uint8_t cmd, uint32_t arg);
+    uint8_t transfer(uint8_t data);
+    void select();
+    void deselect();
+    uint32_t cardAddress(uint32_t block) const;
+
+    uint8_t m_fill[SD_LOG_BLOCK_SIZE];  ///< Block being filled (header written at hand-off)
+    uint8_t m_io[SD_LOG_BLOCK_SIZE];    ///< Block being written, or the block being read by the scan
+    uint16_t m_fill_used;               ///< Text bytes in m_fill
+    bool m_fill_dirty;                  ///< m_fill has text the card does not have yet
+    bool m_fill_placed;                 ///< m_fill already has a block and sequence number
+    bool m_flush_requested;             ///< An urgent line is waiting
+    bool m_write_pending;               ///< m_io holds a block to write
+    uint32_t m_fill_block;              ///< Ring index of m_fill (valid when placed)
+    uint32_t m_fill_seq;                ///< Sequence number of m_fill (valid when placed)
+    uint32_t m_write_block;             ///< Ring index of the block in m_io
+    uint32_t m_next_block;              ///< Ring index the next new block goes to
+    uint32_t m_next_seq;                ///< Sequence number of the next new block
+    uint32_t m_boot_seq;                ///< Sequence number of this boot's first block
+    uint32_t m_last_flush_ms;           ///< Milliseconds() of the last timed flush
+    uint8_t m_state;                    ///< SdLogState
+    uint8_t m_xfer;                     ///< Block transfer in progress (SdLogTransfer)
+    uint8_t m_attempts;                 ///< Retries of the current init command
+    bool m_block_addressing;            ///< SDHC/SDXC: addresses are block numbers, not bytes
+    bool m_v2_card;                     ///< The card answered CMD8
+    bool m_failure_reported;            ///< A failure has been logged since the card was last ready
+    uint32_t m_state_start_ms;          ///< Milliseconds() when m_state was entered
+    uint32_t m_xfer_start_ms;           ///< Milliseconds() when the transfer, or its wait, started
+    uint16_t m_xfer_pos;                ///< Bytes of the block transferred so far
+    uint32_t m_scan_block;              ///< Block the scan is reading
+    uint32_t m_scan_lo;                 ///< Lowest ring index not yet known to hold this ring pass
+    uint32_t m_scan_hi;                 ///< Lowest ring index known not to
+    uint32_t m_scan_base_seq;           ///< Sequence number of ring index 0
+    uint32_t m_blocks_written;          ///< Completed block writes since boot
+    uint32_t m_dropped_lines;           ///< Lines lost to a full buffer
+    uint32_t m_errors;                  ///< Card failures since boot
+};
+
+extern SdLog g_sdLog;
@@ -0,0 +1,212 @@
+/**
+ * @file settings.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the versioned settings block persisted to the NVM user area.
+ *
+ * @details All scalar settings (load cell calibration, motor torque calibration, strain
+ * coefficients, polarity, force mode, home on boot, retract position, press threshold,
+ * force filter and latency, force channel, jerk limit, encoder feedback and rapid traverse) live in one
+ * PressSettings struct held in RAM. Boot reads it with a single block read and checks the
+ * magic, version and CRC. Setters change the RAM copy through edit(), which only marks it
+ * dirty; service() writes the whole block once changes have stopped for
+ * SETTINGS_COMMIT_DELAY_MS, so a burst of configuration commands costs one flash page
+ * erase/write instead of one per command.
+ *
+ * The retract position, press threshold and force offsets change often and go through
+ * setJournaled() to the flash journal in nvm_journal.h instead; load() replays it over the
+ * block.
+ *
+ * The block occupies slots 0 .. NVM_SLOT_COUNT - 1, where the individually addressed
+ * settings used to be. A unit still holding that older layout (magic 0x50425231 in slot 7)
+ * is migrated on its first boot with this firmware. The recipe and the friction and force
+ * tables keep their own slots.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "nvm_journal.h"
+
+/**
+ * @struct PressSettings
+ * @brief Settings block as held in RAM and stored in NVM (little endian).
+ * @details New fields are appended with SETTINGS_VERSION bumped; a block saved by an older
+ * version loads with the new fields at their defaults. The block now fills all
+ * NVM_SLOT_COUNT slots, so the next field needs the recipe area moved up.
+ */
+struct PressSettings {
+    uint16_t magic;                                         ///< SETTINGS_MAGIC
+    uint8_t version;                                        ///< SETTINGS_VERSION of the firmware that saved it
+    uint8_t length;                                         ///< sizeof(PressSettings) of the firmware that saved it
+    uint32_t crc;                                           ///< CRC-32 of the length - 8 bytes after this field
+    float force_offset_kg[FORCE_SENSOR_MAX_CHANNELS];       ///< Load cell offset per channel (kg)
+    float force_scale[FORCE_SENSOR_MAX_CHANNELS];           ///< Load cell scale per channel (kg per count)
+    float torque_scale;                                     ///< Motor torque mode: Torque% per kg
+    float torque_offset;                                    ///< Motor torque mode: Torque% at zero force
+    float strain_coeffs[5];                                 ///< Machine strain polynomial, x^4 first
+    float retract_mm;                                       ///< Retract position as an offset from home
+    float press_threshold_kg;                               ///< Force that counts as contact
+    float filter_alpha;                                     ///< Limit-path IIR factor (1.0 = off)
+    float motion_jerk;                                      ///< S-curve jerk limit in mm/s^3 (0 = trapezoidal)
+    float encoder_counts_per_mm;                            ///< Encoder feedback scale (0 = no encoder)
+    float encoder_tolerance_mm;                             ///< Encoder position tolerance
+    uint32_t force_latency_us;                              ///< Force acquisition latency
+    uint8_t filter_median;                                  ///< Limit-path median window (1, 3 or 5)
+    uint8_t force_channel;                                  ///< ForceChannelSelect used by force limits
+    uint8_t polarity_inverted;                              ///< 1 = inverted coordinate system
+    uint8_t force_mode;                                     ///< 0 = motor torque, 1 = load cell
+    uint8_t home_on_boot;                                   ///< 1 = home after power-up
+    uint8_t active_profile;                                 ///< Calibration profile slot last selected, plus one (0 = none); since version 2
+    uint8_t rapid_vel_mms;                                  ///< Rapid traverse ceiling in mm/s (0 = off); since version 3
+    uint8_t rapid_accel_5mmss;                              ///< Rapid traverse acceleration in RAPID_ACCEL_UNIT_MMSS; since version 3
+};
+
+/**
+ * @enum SettingsSource
+ * @brief Where load() found the settings.
+ */
+enum SettingsSource : uint8_t {
+    SETTINGS_SOURCE_BLOCK = 0,      ///< Valid settings block
+    SETTINGS_SOURCE_LEGACY,         ///< Migrated from the pre-block slot layout
+    SETTINGS_SOURCE_DEFAULTS        ///< No valid block: config.h defaults
+};
+
+/**
+ * @struct NvmImageHeader
+ * @brief Header of the backup_nvm / restore_nvm image; NVM_USER_AREA_BYTES of user area follow.
+ */
+struct NvmImageHeader {
+    uint32_t magic;                 ///< NVM_IMAGE_MAGIC
+    uint8_t format;                 ///< NVM_IMAGE_FORMAT
+    uint8_t settings_version;       ///< SETTINGS_VERSION of the firmware that made the image (information only)
+    uint16_t length;                ///< Bytes of user area that follow
+    uint32_t crc;                   ///< CRC-32 of those bytes
+};
+
+#define NVM_IMAGE_BYTES     (sizeof(NvmImageHeader) + NVM_USER_AREA_BYTES)    ///< Size of a complete image.
+
+/**
+ * @class SettingsStore
+ * @brief Holds the settings block and commits it to NVM. Main loop only.
+ */
+class SettingsStore {
+public:
+    /**
+     * @brief Constructs a store holding the defaults.
+     */
+    SettingsStore();
+
+    /**
+     * @brief Reads the block from NVM, migrating or defaulting it if it is not valid, and
+     * replaces out-of-range values with their defaults. Call once in setup(), before anything
+     * reads get(). Anything migrated, defaulted or repaired is committed by the next service().
+     * @return Where the settings came from
+     */
+    SettingsSource load();
+
+    /**
+     * @brief Gets the settings.
+     * @return RAM copy, including changes not yet committed
+     */
+    const PressSettings& get() const { return m_settings; }
+
+    /**
+     * @brief Gets the settings for a change, and schedules a commit.
+     * @return RAM copy to modify
+     */
+    PressSettings& edit();
+
+    /**
+     * @brief Sets a frequently adjusted value through the NVM journal instead of the block,
+     * so changing it does not erase the user page. Falls back to edit() if the journal has
+     * failed or NVM_JOURNAL_ENABLED is 0.
+     * @param key Journaled setting
+     * @param value New value
+     */
+    void setJournaled(NvmJournalKey key, float value);
+
+    /**
+     * @brief Commits the block once changes have stopped for SETTINGS_COMMIT_DELAY_MS.
+     * @param allowed false defers the commit (e.g. while the press is moving)
+     */
+    void service(bool allowed);
+
+    /**
+     * @brief Writes the block to NVM now if it has uncommitted changes.
+     * @return false if the NVM write was refused
+     */
+    bool commit();
+
+    /**
+     * @brief Replaces every setting with its default and schedules a commit.
+     */
+    void resetDefaults();
+
+    /**
+     * @brief Builds the backup image of the whole NVM user area: settings block, recipe,
+     * friction and force tables.
+     * @param out NVM_IMAGE_BYTES bytes
+     */
+    void exportImage(uint8_t* out) const;
+
+    /**
+     * @brief Checks a backup image and writes it to the NVM user area in one write. The
+     * settings block is reloaded into RAM; the other subsystems pick up the image on the
+     * next boot.
+     * @param data Image from exportImage() (possibly of another unit)
+     * @param length Bytes in @p data
+     * @return false if the image is malformed or fails its CRC (nothing written) or the write failed
+     */
+    bool importImage(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Checks for changes not yet written to NVM.
+     * @return true if a commit is pending
+     */
+    bool isDirty() const { return m_dirty; }
+
+    /**
+     * @brief Gets where load() found the settings.
+     * @return SettingsSource
+     */
+    SettingsSource getSource() const { return m_source; }
+
+    /**
+     * @brief Gets the number of blocks written since boot.
+     * @return Commit count
+     */
+    uint32_t getCommitCount() const { return m_commits; }
+
+    /**
+     * @brief Gets the name of a source as shown in reports.
+     * @param source SettingsSource
+     * @return "block", "legacy" or "defaults"
+     */
+    static const char* sourceName(SettingsSource source);
+
+    /**
+     * @brief Computes a CRC-32 (IEEE 802.3, reflected), as stored with the block.
+     * @param data Bytes to check
+     * @param length Number of bytes
+     * @return CRC
+     */
+    static uint32_t crc32(const uint8_t* data, uint32_t length);
+
+private:
+    void readStored();
+    static void seal(PressSettings& settings);
+    static float* journalField(PressSettings& settings, NvmJournalKey key);
+    static void setDefaults(PressSettings& settings);
+    static bool sanitize(PressSettings& settings);
+    static void migrateLegacy(PressSettings& settings);
+
+    PressSettings m_settings;       ///< Current settings
+    bool m_dirty;                   ///< Changed since the last commit
+    uint32_t m_changedMs;           ///< Milliseconds() of the last edit()
+    uint32_t m_commits;             ///< Blocks written since boot
+    SettingsSource m_source;        ///< Result of load()
+};
+
+extern SettingsStore g_settings;
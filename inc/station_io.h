@@ -0,0 +1,79 @@
+/**
+ * @file station_io.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the fixture sensor inputs read from CCIO-8 expansion boards.
+ *
+ * @details With STATION_IO_ENABLED 1 the part-present, clamp and guard sensors of a fixture
+ * sit on a chain of CCIO-8 boards on STATION_IO_PORT. libClearCore's CcioBoardManager
+ * shifts the whole chain in one SPI transaction per refresh and filters every pin; this
+ * module takes that filtered state as a single 32-bit word in a control tick hook, so
+ * telemetry (station_inputs) and the recipe interlock see the same per-tick snapshot and
+ * no check ever reads a pin over the serial bus on its own.
+ *
+ * The interlock is the STATION_IO_INTERLOCK_MASK inputs in their STATION_IO_INTERLOCK_STATE.
+ * run_recipe refuses to start without it, and MotorController's tick stops the axes in
+ * the tick the snapshot shows it open. A broken CCIO-8 link counts as every interlock
+ * input open.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+#if STATION_IO_ENABLED
+
+/**
+ * @class StationIo
+ * @brief The CCIO-8 chain and its per-tick input snapshot.
+ */
+class StationIo {
+public:
+    /**
+     * @brief Constructs the station I/O with no boards until setup().
+     */
+    StationIo();
+
+    /**
+     * @brief Opens STATION_IO_PORT in CCIO-8 mode, discovers the boards and registers the
+     * snapshot hook. Call once in setup(), before the motor controller registers its hook.
+     */
+    void setup();
+
+    /**
+     * @brief Gets the inputs of the latest tick.
+     * @return Bit n = CCIO-8 pin n of the chain (board 1 pins 0-7 first); 0 while the link is down
+     */
+    uint32_t getInputs() const { return m_inputs; }
+
+    /**
+     * @brief Gets the interlock inputs of the latest tick that are not in their required state.
+     * @return Bits of STATION_IO_INTERLOCK_MASK; 0 = interlock made. Safe from interrupts.
+     */
+    uint32_t getInterlockFaults() const { return m_faults; }
+
+    /**
+     * @brief Gets the number of CCIO-8 boards found by setup().
+     * @return Board count (0 = none found)
+     */
+    uint8_t getBoardCount() const { return m_boards; }
+
+    /**
+     * @brief Checks whether the CCIO-8 link is up.
+     * @return false if no board was found or the link has broken since
+     */
+    bool isLinkUp() const { return m_linkUp; }
+
+private:
+    static void tickHook(void* context);
+    void tick();
+
+    volatile uint32_t m_inputs;     ///< Inputs of the latest tick
+    volatile uint32_t m_faults;     ///< Interlock inputs out of state in the latest tick
+    volatile bool m_linkUp;         ///< Link state of the latest tick
+    uint8_t m_boards;               ///< Boards found at setup
+};
+
+extern StationIo g_stationIo;
+
+#endif // STATION_IO_ENABLED
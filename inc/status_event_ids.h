@@ -0,0 +1,94 @@
+/**
+ * @file status_event_ids.h
+ * @brief Defines the IDs and argument schemas of the typed status events.
+ * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY
+ * Generated from status_events.json on 2026-10-14 17:10:12
+ * 
+ * One ID per status message the device posts as an EventRecord (see event_queue.h)
+ * instead of formatting text. Text clients get the message rendered from the same
+ * template the host uses for EVENT=BIN1 records.
+ * To modify typed events, edit status_events.json and run generate_status_events.py.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "text_format.h"
+
+//==================================================================================================
+// Status Event Enum
+//==================================================================================================
+
+/**
+ * @enum StatusEventId
+ * @brief Enumerates all typed status events. Values are fixed by status_events.json and never reused.
+ */
+enum StatusEventId : uint8_t {
+    STATUS_EVENT_NONE = 0,                           ///< Unused.
+    STATUS_EVENT_FORCE_LIMIT_REACHED = 1,            ///< A move stopped (or started its retract) at the force limit (arg0 = limit_kg, arg1 = actual_kg)
+    STATUS_EVENT_TORQUE_LIMIT_REACHED = 2,           ///< A motor_torque move stopped (or started its retract) at the torque limit (arg0 = torque_pct)
+    STATUS_EVENT_SEAT_REACHED = 3,                   ///< A force_action=seat move stopped on a stiffness jump (arg0 = stiffness_kg_mm, arg1 = baseline_kg_mm)
+    STATUS_EVENT_RAPID_RETRACT_COLLISION = 4,        ///< A rapid retract met force where no load was expected and stopped (arg0 = force_kg)
+    STATUS_EVENT_HOMING_TIMEOUT = 5,                 ///< Homing took longer than MAX_HOMING_DURATION_MS
+    STATUS_EVENT_HOMING_RAPID_START = 6,             ///< Lockstep homing started its rapid approach
+    STATUS_EVENT_HOMING_RAPID_MOVING = 7,            ///< Every axis is stepping in the rapid approach
+    STATUS_EVENT_HOMING_SENSOR_RAPID = 8,            ///< An axis stopped on its home sensor in the rapid approach (arg0 = axis)
+    STATUS_EVENT_HOMING_RAPID_TORQUE = 9,            ///< The backup torque limit stopped the rapid approach
+    STATUS_EVENT_HOMING_RAPID_COMPLETE = 10,         ///< Every axis stopped in the rapid approach, at least one on its sensor
+    STATUS_EVENT_HOMING_RAPID_NO_SENSOR = 11,        ///< The rapid approach ended with no sensor triggered
+    STATUS_EVENT_HOMING_RAPID_STOPPED = 12,          ///< The axes stopped in the rapid approach before every sensor triggered
+    STATUS_EVENT_HOMING_BACKOFF_START = 13,          ///< Lockstep homing started backing off the sensors
+    STATUS_EVENT_HOMING_BACKOFF_COMPLETE = 14,       ///< The backoff finished
+    STATUS_EVENT_HOMING_SLOW_START = 15,             ///< Lockstep homing started its slow approach
+    STATUS_EVENT_HOMING_SLOW_MOVING = 16,            ///< The slow approach is under way
+    STATUS_EVENT_HOMING_SENSOR_SLOW = 17,            ///< An axis stopped on its home sensor in the slow approach; its trigger position is latched (arg0 = axis)
+    STATUS_EVENT_HOMING_SLOW_TORQUE = 18,            ///< The backup torque limit stopped the slow approach
+    STATUS_EVENT_HOMING_SQUARED = 19,                ///< Every sensor triggered in the slow approach
+    STATUS_EVENT_HOMING_PARTIAL_SENSORS = 20,        ///< The slow approach ended with only some sensors triggered; homing carries on (arg0 = triggered, arg1 = axes)
+    STATUS_EVENT_HOMING_SLOW_NO_SENSOR = 21,         ///< The slow approach ended with no sensor triggered
+    STATUS_EVENT_HOMING_SLOW_STOPPED = 22,           ///< The axes stopped in the slow approach before every sensor triggered
+    STATUS_EVENT_HOMING_OFFSET_START = 23,           ///< The axes are moving to the home offset
+    STATUS_EVENT_HOMING_OFFSET_REACHED = 24,         ///< The axes reached the home offset
+    STATUS_EVENT_HOMING_VERIFY_START = 25,           ///< Parallel homing started a positional approach to the trusted home
+    STATUS_EVENT_HOMING_PARALLEL_START = 26,         ///< Parallel homing started its rapid approach
+    STATUS_EVENT_HOMING_PARALLEL_TORQUE = 27,        ///< The backup torque limit stopped parallel homing
+    STATUS_EVENT_HOMING_PARALLEL_DONE = 28,          ///< Every axis reached its home offset in parallel homing
+    STATUS_EVENT_HOMING_RETRACT_RECALCULATED = 29,   ///< The stored retract position was re-based on the new home (arg0 = retract_mm, arg1 = retract_steps, arg2 = home_steps)
+    STATUS_EVENT_HOMING_PHASE_ERROR = 30,            ///< The homing sequence reached its error phase
+    STATUS_EVENT_HOMING_PHASE_UNKNOWN = 31,          ///< The homing state machine was in an unknown phase
+    STATUS_EVENT_HOMING_SENSOR_EARLY = 32,           ///< A sensor triggered before the trusted position in a verification approach (arg0 = axis)
+    STATUS_EVENT_HOMING_AXIS_STOPPED = 33,           ///< An axis finished its parallel rapid approach without its sensor (arg0 = axis)
+    STATUS_EVENT_HOMING_HOME_VERIFIED = 34,          ///< A verification touch found the home within HOMING_VERIFY_TOLERANCE_MM (arg0 = axis, arg1 = shift_mm)
+    STATUS_EVENT_HOMING_HOME_MOVED = 35,             ///< A verification touch found the home further than HOMING_VERIFY_TOLERANCE_MM from the trusted one (arg0 = axis, arg1 = shift_mm)
+    STATUS_EVENT_HOMING_AXIS_NO_SENSOR = 36,         ///< An axis finished its parallel slow approach without its sensor (arg0 = axis)
+    STATUS_EVENT_HOMING_AXIS_FULL_SEARCH = 37,       ///< A verification approach did not find the sensor; the axis runs the full search (arg0 = axis)
+    STATUS_EVENT_ENVELOPE_LEFT = 38,                 ///< A recipe move left the recipe's force envelope and stopped; the part is rejected (arg0 = position_mm, arg1 = force_kg, arg2 = bound_kg)
+    STATUS_EVENT_INTERLOCK_OPEN = 39,                ///< The station interlock opened during a recipe run and the press was stopped (arg0 = inputs, arg1 = faults)
+    STATUS_EVENT_HOMING_HYBRID_START = 40,           ///< A hybrid home started the fast approach of an axis to just short of its learned trigger point (arg0 = axis, arg1 = distance)
+    STATUS_EVENT_HOMING_HYBRID_TORQUE = 41           ///< The torque spike check stopped a hybrid approach before the slow zone; the learned home is dropped (arg0 = axis, arg1 = rise)
+};
+
+#define STATUS_EVENT_COUNT                           42  ///< One past the highest ID
+
+//==================================================================================================
+// Status Event Formats
+//==================================================================================================
+
+/**
+ * @struct StatusEventFormat
+ * @brief Status prefix, text template and argument schema of one StatusEventId.
+ * @details "{n}" in text is argument n as an integer, "{n:.Df}" argument n as a float
+ * with D decimals.
+ */
+typedef struct {
+    TextView    prefix;                         ///< STATUS_PREFIX_* of the event's status, with its length
+    const char* text;                           ///< Text template, empty for unassigned IDs
+    uint8_t     arg_count;                      ///< Arguments the event carries
+    uint8_t     float_args;                     ///< Bit n set if argument n is a float
+} StatusEventFormat;
+
+/**
+ * @brief Looks up the format of an event.
+ * @param id Event ID
+ * @return The event's format; STATUS_EVENT_NONE's (empty text) for an unassigned or unknown ID
+ */
+const StatusEventFormat* status_event_format(uint8_t id);
@@ -0,0 +1,140 @@
+/**
+ * @file text_format.h
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Declares the small fixed-precision text formatter used for telemetry and events.
+ *
+ * @details newlib's snprintf parses the format string on every call and its %f path runs
+ * through double-precision software math on the Cortex-M4. These appenders format one value
+ * each with integer arithmetic only, so building a telemetry line is a handful of divisions per field.
+ *
+ * Every function writes at @p pos, always leaves @p buffer NUL-terminated, truncates
+ * rather than overflows, and returns the new position (at most @p size - 1).
+ *
+ * TextView carries a string with its length. TEXT_VIEW() takes the length of a literal at
+ * compile time, and text_view() folds to a constant wherever it is inlined with one, so
+ * prefixes, command names and telemetry keys are never measured at run time.
+ *
+ * text_vsnprintf() is a printf-compatible front end to the same integer formatting, for the
+ * conversions the firmware uses (d i u x X c s f and %%, with flags, width and precision).
+ * The Compact configuration links every snprintf() and vsnprintf() call to it with
+ * -Wl,--wrap and drops newlib's float printf (newlib-nano without _printf_float); set
+ * TEXT_FORMAT_WRAP_SNPRINTF to 1 in any build that links that way.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+
+#ifndef TEXT_FORMAT_WRAP_SNPRINTF
+#define TEXT_FORMAT_WRAP_SNPRINTF   0   ///< 1 = define __wrap_snprintf/__wrap_vsnprintf for -Wl,--wrap=snprintf,--wrap=vsnprintf
+#endif
+
+/**
+ * @struct TextView
+ * @brief A string and its length, not counting the NUL.
+ */
+struct TextView {
+    const char* text;   ///< Characters (NUL-terminated when made from a C string)
+    uint16_t len;       ///< Characters in text
+};
+
+/** @brief TextView of a string literal, its length taken at compile time. */
+#define TEXT_VIEW(literal)  TextView{ (literal), (uint16_t)(sizeof(literal) - 1) }
+
+/**
+ * @brief Makes a TextView of a C string.
+ * @details Inline so a literal argument's strlen() folds to a constant at the call site.
+ * @param str NUL-terminated string (NULL gives an empty view)
+ * @return View of @p str
+ */
+static inline TextView text_view(const char* str) {
+    return TextView{ (str != NULL) ? str : "", (uint16_t)((str != NULL) ? strlen(str) : 0) };
+}
+
+/**
+ * @brief Appends a string.
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @param pos Current length of the text in @p buffer
+ * @param str NUL-terminated string (NULL appends nothing)
+ * @return New length
+ */
+size_t append_str(char* buffer, size_t size, size_t pos, const char* str);
+
+/**
+ * @brief Appends a string of known length (one memcpy, no scan for the NUL).
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @param pos Current length of the text in @p buffer
+ * @param view String and its length
+ * @return New length
+ */
+size_t append_view(char* buffer, size_t size, size_t pos, TextView view);
+
+/**
+ * @brief Appends one character.
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @param pos Current length of the text in @p buffer
+ * @param c Character
+ * @return New length
+ */
+size_t append_char(char* buffer, size_t size, size_t pos, char c);
+
+/**
+ * @brief Appends a signed integer in decimal (same text as "%ld").
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @param pos Current length of the text in @p buffer
+ * @param value Value
+ * @return New length
+ */
+size_t append_int(char* buffer, size_t size, size_t pos, int32_t value);
+
+/**
+ * @brief Appends an unsigned integer in decimal (same text as "%lu").
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @param pos Current length of the text in @p buffer
+ * @param value Value
+ * @return New length
+ */
+size_t append_uint(char* buffer, size_t size, size_t pos, uint32_t value);
+
+/**
+ * @brief Appends a float with a fixed number of decimals (like "%.Nf").
+ * @details Rounds the exact binary value with integer math, so the text matches printf
+ * (including "-0.00" for small negatives). NaN and infinities are written as "nan", "inf"
+ * and "-inf"; magnitudes whose scaled value passes 64 bits (about 8.8e12 at 6 decimals)
+ * are written as "inf" too.
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @param pos Current length of the text in @p buffer
+ * @param value Value
+ * @param decimals Digits after the point, 0-8
+ * @return New length
+ */
+size_t append_fixed(char* buffer, size_t size, size_t pos, float value, uint8_t decimals);
+
+/**
+ * @brief Formats like vsnprintf() with the integer formatter.
+ * @details Supports the flags - + space 0 #, width and precision (both also as *), the
+ * length modifiers hh h l ll z, and the conversions d i u x X o c s f F p and %%. A float
+ * argument is narrowed back to float (it was one before the vararg promotion) and written
+ * by append_fixed(), so more than 8 decimals are written as zeros. Other conversions are
+ * copied as text.
+ * @param buffer Output buffer (may be NULL if @p size is 0)
+ * @param size Size of @p buffer
+ * @param format printf format
+ * @param args Arguments
+ * @return Length of the full text, as vsnprintf() returns (the written part is at most @p size - 1)
+ */
+int text_vsnprintf(char* buffer, size_t size, const char* format, va_list args);
+
+/**
+ * @brief Formats like snprintf() with the integer formatter (see text_vsnprintf()).
+ */
+int text_snprintf(char* buffer, size_t size, const char* format, ...) __attribute__((format(printf, 3, 4)));
@@ -0,0 +1,26 @@
+/**
+ * @file timebase.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Declares the 64-bit microsecond monotonic clock.
+ *
+ * @details libClearCore's Microseconds() is 32 bits and wraps every 71.6 minutes, and
+ * Milliseconds() is too coarse to place samples that arrive every 3 ms. MonotonicUs()
+ * extends Microseconds() to 64 bits by counting its wraps, so force-sample timestamps and
+ * the control tick time never wrap and subtract without wrap handling. It is ISR-safe and
+ * regular calls are guaranteed because the control tick reads it every tick. Short
+ * intervals measured with unsigned 32-bit Microseconds() differences stay correct across
+ * a wrap and are left as they are. Coarse timeouts (enable, homing, dwell) keep Milliseconds().
+ * The low 32 bits of MonotonicUs() are Microseconds(), so the two can be mixed.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Gets the time since boot.
+ * @details Must be called at least once per 71.6 minutes to see every wrap; the control
+ * tick does. Callable from any context; interrupts are masked for a few cycles.
+ * @return Microseconds since boot
+ */
+uint64_t MonotonicUs();
@@ -0,0 +1,41 @@
+/**
+ * @file trace_ids.h
+ * @brief Defines the event IDs of the binary trace ring.
+ * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY
+ * Generated from trace.json on 2025-11-21 10:12:40
+ * 
+ * One ID per trace point recorded with TRACE() (see trace_log.h). The host decodes
+ * dump_trace records with the same table, including the meaning of arg0 and arg1.
+ * To modify trace events, edit trace.json and regenerate this file.
+ */
+#pragma once
+
+#include <stdint.h>
+
+//==================================================================================================
+// Trace Event Enum
+//==================================================================================================
+
+/**
+ * @enum TraceEventId
+ * @brief Enumerates all trace events. Values are fixed by trace.json and never reused.
+ */
+enum TraceEventId : uint16_t {
+    TRACE_NONE = 0,                       ///< Unused (an erased record).
+    TRACE_BOOT = 1,                       ///< setup() started (arg0 = reset_cause, arg1 = breadcrumb)
+    TRACE_COMMAND = 2,                    ///< A command was dispatched from the RX queue (arg0 = command, arg1 = request_id)
+    TRACE_MOTOR_STATE = 3,                ///< MotorController top-level state or homing phase changed (arg0 = state, arg1 = homing_phase)
+    TRACE_MOVE_ABORT = 4,                 ///< abortMove() decelerated both axes to a stop (arg0 = state, arg1 = unused)
+    TRACE_TORQUE_TRIP = 5,                ///< Control tick stopped both axes on a torque-limit crossing (interrupt context) (arg0 = motor, arg1 = torque_deci)
+    TRACE_FORCE_TRIP = 6,                 ///< A force sample crossed the armed limit (interrupt context) (arg0 = channel, arg1 = counts)
+    TRACE_ENCODER_TRIP = 7,               ///< Encoder check stopped both axes (interrupt context) (arg0 = quadrature, arg1 = error_counts)
+    TRACE_QUEUE_OVERFLOW = 8,             ///< A message was dropped because its queue was full (arg0 = queue, arg1 = unused)
+    TRACE_NETWORK_STATE = 9,              ///< Ethernet bring-up state changed (arg0 = state, arg1 = ip)
+    TRACE_TASK_OVERRUN = 10,              ///< A main-loop task ran longer than its budget (arg0 = task, arg1 = elapsed_us)
+    TRACE_SLOW_PASS = 11,                 ///< A main-loop pass went past the LOOP_SLOW_PASS_US soft deadline (arg0 = task, arg1 = pass_us)
+    TRACE_USB_RX = 12,                    ///< A command line was received over USB (arg0 = length, arg1 = gap_ms)
+    TRACE_TRIP_RETRACT = 13,              ///< A limit trip reversed both axes into the retract (interrupt context, or main loop) (arg0 = state, arg1 = from_steps)
+    TRACE_FUSION_TRIP = 14,               ///< The fused load-cell/torque force crossed the armed limit (interrupt context) (arg0 = channel, arg1 = fused_deci)
+    TRACE_WATCHDOG_LATE = 15,             ///< A watchdog supervisor client missed its check-in deadline; feeding stopped (arg0 = client, arg1 = silence_ms)
+    TRACE_RACKING_TRIP = 16               ///< The racking check stopped the axes: a follower's load torque or commanded position left M0's by more than the fault limit (interrupt context) (arg0 = motor, arg1 = imbalance_steps)
+};
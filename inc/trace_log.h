@@ -0,0 +1,88 @@
+/**
+ * @file trace_log.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the always-on binary event trace ring.
+ *
+ * @details Each trace point stores a 12-byte TraceRecord (timestamp, TraceEventId, two
+ * integer arguments) into a RAM ring that overwrites its oldest record, so the ring always
+ * holds the last TRACE_LOG_RECORDS events. There is no formatting on the device: a record
+ * is a few stores with interrupts masked, so trace points are safe in the control tick and
+ * the force receive path as well as the main loop. dump_trace streams the ring as base64
+ * "TRACE:pressboi:DATA:" lines, and the host names the events and their arguments from
+ * definition/trace.json (trace_ids.h is generated from the same file). With
+ * TRACE_LOG_ENABLED 0 the TRACE() call sites compile out.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "trace_ids.h"
+
+/**
+ * @struct TraceRecord
+ * @brief One trace record as sent on the wire (12 bytes, little endian).
+ */
+struct TraceRecord {
+    uint32_t time_us;       ///< Microseconds() when recorded
+    uint16_t id;            ///< TraceEventId
+    int16_t arg0;           ///< Small argument (state, channel, index)
+    int32_t arg1;           ///< Wide argument (counts, steps, microseconds)
+};
+
+/**
+ * @class TraceLog
+ * @brief Overwriting ring of TraceRecord. record() may be called from any context.
+ */
+class TraceLog {
+public:
+    /**
+     * @brief Constructs an empty trace ring.
+     */
+    TraceLog();
+
+    /**
+     * @brief Appends a record, overwriting the oldest one when the ring is full.
+     * @param id TraceEventId
+     * @param arg0 Small argument
+     * @param arg1 Wide argument
+     */
+    void record(uint16_t id, int16_t arg0, int32_t arg1);
+
+    /**
+     * @brief Gets the sequence number the next record will get (records written since boot).
+     * @return Sequence number
+     */
+    uint32_t getSeq() const { return m_seq; }
+
+    /**
+     * @brief Copies records out of the ring, starting at a sequence number.
+     * @details Records already overwritten are skipped, so @p first_seq can be later than
+     * @p from_seq; the difference is the number of records lost.
+     * @param from_seq Sequence number of the first record wanted
+     * @param out Output records
+     * @param max_records Capacity of @p out
+     * @param[out] first_seq Sequence number of out[0]
+     * @return Records copied (0 once @p from_seq reaches getSeq())
+     */
+    uint16_t read(uint32_t from_seq, TraceRecord* out, uint16_t max_records, uint32_t* first_seq) const;
+
+    /**
+     * @brief Gets the sequence number of the oldest record still in the ring.
+     * @return Sequence number
+     */
+    uint32_t getOldestSeq() const;
+
+private:
+    TraceRecord m_records[TRACE_LOG_RECORDS];   ///< Ring indexed by sequence number
+    volatile uint32_t m_seq;                    ///< Sequence number of the next record
+};
+
+extern TraceLog g_traceLog;
+
+#if TRACE_LOG_ENABLED
+#define TRACE(id, arg0, arg1) g_traceLog.record((id), (int16_t)(arg0), (int32_t)(arg1))
+#else
+#define TRACE(id, arg0, arg1) ((void)0)
+#endif
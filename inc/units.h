@@ -0,0 +1,92 @@
+/**
+ * @file units.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the strong-typed step and millimetre units of the motion path.
+ *
+ * @details Steps, Millimeters, StepsPerSec and MmPerSec wrap one number each and convert
+ * into each other only through the functions below, so passing a step count where
+ * millimetres are expected no longer compiles. The scale factors are the ones g_driveGeometry
+ * precomputed at boot from the unit's pitch and pulses per revolution, so every conversion
+ * is a single single-precision multiply: no division, and no software-emulated double on
+ * the Cortex-M4.
+ *
+ * Conversions to steps truncate toward zero, as the (long) casts they replaced did. The wrappers are trivially copyable and cost nothing at run time; take
+ * .value where a ClearCore or member API wants the plain number.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "drive_geometry.h"
+
+/**
+ * @struct Steps
+ * @brief A position or distance in motor steps.
+ */
+struct Steps {
+    int32_t value;  ///< Steps
+
+    constexpr explicit Steps(int32_t steps) : value(steps) {}
+    constexpr Steps operator+(Steps other) const { return Steps(value + other.value); }
+    constexpr Steps operator-(Steps other) const { return Steps(value - other.value); }
+};
+
+/**
+ * @struct Millimeters
+ * @brief A position or distance in mm of press travel.
+ */
+struct Millimeters {
+    float value;    ///< mm
+
+    constexpr explicit Millimeters(float mm) : value(mm) {}
+    constexpr Millimeters operator+(Millimeters other) const { return Millimeters(value + other.value); }
+    constexpr Millimeters operator-(Millimeters other) const { return Millimeters(value - other.value); }
+};
+
+/**
+ * @struct StepsPerSec
+ * @brief A speed (or, per second again, an acceleration) in steps per second.
+ */
+struct StepsPerSec {
+    int32_t value;  ///< steps/s
+
+    constexpr explicit StepsPerSec(int32_t sps) : value(sps) {}
+};
+
+/**
+ * @struct MmPerSec
+ * @brief A speed (or, per second again, an acceleration) in mm per second.
+ */
+struct MmPerSec {
+    float value;    ///< mm/s
+
+    constexpr explicit MmPerSec(float mms) : value(mms) {}
+};
+
+/**
+ * @brief Converts a distance to steps, truncating toward zero.
+ */
+inline Steps toSteps(Millimeters mm) {
+    return Steps((int32_t)(mm.value * g_driveGeometry.stepsPerMm()));
+}
+
+/**
+ * @brief Converts a step count to mm.
+ */
+inline Millimeters toMillimeters(Steps steps) {
+    return Millimeters((float)steps.value * g_driveGeometry.mmPerStep());
+}
+
+/**
+ * @brief Converts a speed to steps per second, truncating toward zero.
+ */
+inline StepsPerSec toStepsPerSec(MmPerSec speed) {
+    return StepsPerSec((int32_t)(speed.value * g_driveGeometry.stepsPerMm()));
+}
+
+/**
+ * @brief Converts a step rate to mm per second.
+ */
+inline MmPerSec toMmPerSec(StepsPerSec speed) {
+    return MmPerSec((float)speed.value * g_driveGeometry.mmPerStep());
+}
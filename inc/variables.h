@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include "text_format.h"
 
 //==================================================================================================
 // Telemetry Field Keys
@@ -43,6 +44,87 @@
 #define TELEM_KEY_HOMED                          "homed"  ///< Indicates if press has been homed to zero position
 #define TELEM_KEY_HOME_SENSOR_M0                 "home_sensor_m0"  ///< Motor A (M0) home sensor state (DI7)
 #define TELEM_KEY_HOME_SENSOR_M1                 "home_sensor_m1"  ///< Motor B (M1) home sensor state (DI6)
+#define TELEM_KEY_SLOW_LOOPS                     "slow_loops"  ///< Main-loop passes since boot longer than the LOOP_SLOW_PASS_US soft deadline
+#define TELEM_KEY_LOOP_SLACK_MS                  "loop_slack_ms"  ///< Watchdog timeout minus the longest main-loop pass since the previous telemetry frame
+#define TELEM_KEY_FORCE_RATE_HZ                  "force_rate_hz"  ///< Load-cell samples per second over the last second (slowest selected channel)
+#define TELEM_KEY_FORCE_JITTER_US                "force_jitter_us"  ///< Standard deviation of the time between load-cell samples (worst selected channel)
+#define TELEM_KEY_FORCE_ERRORS                   "force_errors"  ///< Load-cell receive errors since boot (selected channels)
+#define TELEM_KEY_FORCE_STUCK                    "force_stuck"  ///< A selected load cell has sent the same raw value FORCE_HEALTH_STUCK_SAMPLES times in a row
+#define TELEM_KEY_FORCE_FUSED                    "force_fused"  ///< Force estimated every control tick from motor torque, with its level held to the load cell (0 outside moves)
+#define TELEM_KEY_STATION_INPUTS                 "station_inputs"  ///< Station inputs from the CCIO-8 chain, bit n = chain pin n (0 without station I/O or while the link is down)
+#define TELEM_KEY_MOTOR_THERMAL                  "motor_thermal"  ///< Motor thermal load (%) of the hottest motor from the I2t model; 100 = continuous rating, new presses wait above THERMAL_LIMIT_PCT
+#define TELEM_KEY_TIME_US                        "t_us"           ///< Frame header written first in every text frame, delta frames included
+/** @} */
+
+/**
+ * @enum TelemetryFieldId
+ * @brief Field IDs (telemetry.json order) used for set_telemetry subscriptions.
+ */
+typedef enum {
+    TELEM_FIELD_MAIN_STATE                   = 0,
+    TELEM_FIELD_FORCE_LOAD_CELL              = 1,
+    TELEM_FIELD_FORCE_MOTOR_TORQUE           = 2,
+    TELEM_FIELD_FORCE_LIMIT                  = 3,
+    TELEM_FIELD_FORCE_SOURCE                 = 4,
+    TELEM_FIELD_FORCE_ADC_RAW                = 5,
+    TELEM_FIELD_JOULES                       = 6,
+    TELEM_FIELD_ENABLED0                     = 7,
+    TELEM_FIELD_ENABLED1                     = 8,
+    TELEM_FIELD_CURRENT_POS                  = 9,
+    TELEM_FIELD_RETRACT_POS                  = 10,
+    TELEM_FIELD_TARGET_POS                   = 11,
+    TELEM_FIELD_ENDPOINT                     = 12,
+    TELEM_FIELD_STARTPOINT                   = 13,
+    TELEM_FIELD_PRESS_THRESHOLD              = 14,
+    TELEM_FIELD_TORQUE_AVG                   = 15,
+    TELEM_FIELD_HOMED                        = 16,
+    TELEM_FIELD_HOME_SENSOR_M0               = 17,
+    TELEM_FIELD_HOME_SENSOR_M1               = 18,
+    TELEM_FIELD_SLOW_LOOPS                   = 19,
+    TELEM_FIELD_LOOP_SLACK_MS                = 20,
+    TELEM_FIELD_FORCE_RATE_HZ                = 21,
+    TELEM_FIELD_FORCE_JITTER_US              = 22,
+    TELEM_FIELD_FORCE_ERRORS                 = 23,
+    TELEM_FIELD_FORCE_STUCK                  = 24,
+    TELEM_FIELD_FORCE_FUSED                  = 25,
+    TELEM_FIELD_STATION_INPUTS               = 26,
+    TELEM_FIELD_MOTOR_THERMAL                = 27,
+    TELEM_FIELD_COUNT                        = 28
+} TelemetryFieldId;
+
+#define TELEM_FIELD_BIT(id)                      (1UL << (id))  ///< Subscription mask bit of a TelemetryFieldId
+#define TELEM_FIELDS_ALL                         ((1UL << TELEM_FIELD_COUNT) - 1)  ///< Subscription mask with every field
+
+/**
+ * @name Delta Telemetry Deadbands
+ * @brief Smallest change of a float field that counts as changed (from its precision in telemetry.json).
+ * @{
+ */
+#define TELEM_DEADBAND_FORCE_LOAD_CELL            0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_FORCE_MOTOR_TORQUE         0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_FORCE_LIMIT                0.1f         ///< One unit in the last printed digit
+#define TELEM_DEADBAND_JOULES                     0.001f       ///< One unit in the last printed digit
+#define TELEM_DEADBAND_CURRENT_POS                0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_RETRACT_POS                0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_TARGET_POS                 0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_ENDPOINT                   0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_STARTPOINT                 0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_PRESS_THRESHOLD            0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_TORQUE_AVG                 0.1f         ///< One unit in the last printed digit
+#define TELEM_DEADBAND_FORCE_RATE_HZ              0.1f         ///< One unit in the last printed digit
+#define TELEM_DEADBAND_FORCE_FUSED                0.01f        ///< One unit in the last printed digit
+#define TELEM_DEADBAND_MOTOR_THERMAL              0.1f         ///< One unit in the last printed digit
+/** @} */
+
+/**
+ * @name Binary Telemetry Encoding
+ * @brief Packed alternative to the text message, selected with TELEM=BIN1 in DISCOVER_DEVICE.
+ * Format: "PRESSBOI_TELEMB: <base64 of TelemetryBinaryFrame>"
+ * @{
+ */
+#define TELEM_BINARY_VERSION                     7  ///< TelemetryBinaryFrame.version; bumped whenever the layout changes
+#define TELEM_BINARY_FRAME_SIZE                  96 ///< sizeof(TelemetryBinaryFrame)
+#define TELEM_BINARY_VALUE_UNKNOWN               0xFF ///< String field value not in its value list
 /** @} */
 
 //==================================================================================================
@@ -74,8 +156,87 @@ typedef struct {
     int32_t      homed                         ; ///< Indicates if press has been homed to zero position
     int32_t      home_sensor_m0                ; ///< Motor A (M0) home sensor state (DI7)
     int32_t      home_sensor_m1                ; ///< Motor B (M1) home sensor state (DI6)
+    int32_t      slow_loops                    ; ///< Main-loop passes since boot longer than the LOOP_SLOW_PASS_US soft deadline
+    int32_t      loop_slack_ms                 ; ///< Watchdog timeout minus the longest main-loop pass since the previous telemetry frame
+    float        force_rate_hz                 ; ///< Load-cell samples per second over the last second (slowest selected channel)
+    int32_t      force_jitter_us               ; ///< Standard deviation of the time between load-cell samples (worst selected channel)
+    int32_t      force_errors                  ; ///< Load-cell receive errors since boot (selected channels)
+    int32_t      force_stuck                   ; ///< A selected load cell has sent the same raw value FORCE_HEALTH_STUCK_SAMPLES times in a row
+    float        force_fused                   ; ///< Force estimated every control tick from motor torque, with its level held to the load cell (0 outside moves)
+    int32_t      station_inputs                ; ///< Station inputs from the CCIO-8 chain, bit n = chain pin n (0 without station I/O or while the link is down)
+    float        motor_thermal                 ; ///< Motor thermal load (%) of the hottest motor from the I2t model; 100 = continuous rating, new presses wait above THERMAL_LIMIT_PCT
+    uint32_t     time_us                       ; ///< Device Microseconds() when the frame was sampled; frame header, not a field (TELEM_KEY_TIME_US)
 } TelemetryData;
 
+/**
+ * @struct TelemetryBinaryFrame
+ * @brief Binary telemetry frame (little endian, no padding).
+ * @details 4-byte fields first, then 1-byte fields, each group in telemetry.json order.
+ * Floats are IEEE-754 single precision; mapped ints and string fields are one byte.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t      version                       ; ///< TELEM_BINARY_VERSION
+    uint8_t      reserved                      ; ///< Zero
+    uint16_t     seq                           ; ///< Frame counter, wraps (gaps mean lost frames)
+    uint32_t     time_us                       ; ///< TelemetryData.time_us (wraps every 71.6 minutes)
+    float        force_load_cell               ; ///< Force from load cell sensor
+    float        force_motor_torque            ; ///< Force calculated from motor torque
+    float        force_limit                   ; ///< Maximum force limit for current operation
+    int32_t      force_adc_raw                 ; ///< Raw ADC value from HX711 load cell amplifier (for calibration)
+    float        joules                        ; ///< Energy expended during current move (force Ã— distance integrated at 50Hz)
+    float        current_pos                   ; ///< Current position of press axis
+    float        retract_pos                   ; ///< Preset retract position for the press
+    float        target_pos                    ; ///< Target position for current move operation
+    float        endpoint                      ; ///< Actual position where last move ended (force trigger or completion)
+    float        startpoint                    ; ///< Position where press threshold was crossed (press started)
+    float        press_threshold               ; ///< Force threshold for energy/startpoint recording
+    float        torque_avg                    ; ///< Average motor torque percentage
+    int32_t      slow_loops                    ; ///< Main-loop passes since boot longer than the LOOP_SLOW_PASS_US soft deadline
+    int32_t      loop_slack_ms                 ; ///< Watchdog timeout minus the longest main-loop pass since the previous telemetry frame
+    float        force_rate_hz                 ; ///< Load-cell samples per second over the last second (slowest selected channel)
+    int32_t      force_jitter_us               ; ///< Standard deviation of the time between load-cell samples (worst selected channel)
+    int32_t      force_errors                  ; ///< Load-cell receive errors since boot (selected channels)
+    float        force_fused                   ; ///< Force estimated every control tick from motor torque, with its level held to the load cell (0 outside moves)
+    int32_t      station_inputs                ; ///< Station inputs from the CCIO-8 chain, bit n = chain pin n (0 without station I/O or while the link is down)
+    float        motor_thermal                 ; ///< Motor thermal load (%) of the hottest motor from the I2t model; 100 = continuous rating, new presses wait above THERMAL_LIMIT_PCT
+    uint8_t      MAIN_STATE                    ; ///< Overall press system state (index into TELEM_VALUES_MAIN_STATE, 0xFF = other)
+    uint8_t      force_source                  ; ///< Source of force reading: load_cell or motor_torque (index into TELEM_VALUES_FORCE_SOURCE, 0xFF = other)
+    uint8_t      enabled0                      ; ///< Power enable status for motor 1
+    uint8_t      enabled1                      ; ///< Power enable status for motor 2
+    uint8_t      homed                         ; ///< Indicates if press has been homed to zero position
+    uint8_t      home_sensor_m0                ; ///< Motor A (M0) home sensor state (DI7)
+    uint8_t      home_sensor_m1                ; ///< Motor B (M1) home sensor state (DI6)
+    uint8_t      force_stuck                   ; ///< A selected load cell has sent the same raw value FORCE_HEALTH_STUCK_SAMPLES times in a row
+} TelemetryBinaryFrame;
+
+/**
+ * @enum TelemetryFieldType
+ * @brief Value type of a telemetry field, as declared in telemetry.json.
+ */
+typedef enum {
+    TELEM_TYPE_STRING = 0,                       ///< const char* in TelemetryData, value-list index in the binary frame
+    TELEM_TYPE_FLOAT,                            ///< float, printed with the field's precision
+    TELEM_TYPE_INT                               ///< int32_t, 1 or 4 bytes in the binary frame
+} TelemetryFieldType;
+
+/**
+ * @struct TelemetryFieldInfo
+ * @brief Compile-time description of one telemetry field.
+ * @details The text message, delta detection, snapshot copies and the binary frame are
+ * all driven by one table of these, indexed by TelemetryFieldId.
+ */
+typedef struct {
+    TextView           key;                      ///< telemetry.json key (TELEM_KEY_*) and its length
+    uint8_t            type;                     ///< TelemetryFieldType
+    uint8_t            precision;                ///< Decimal places of a float field
+    uint16_t           offset;                   ///< offsetof(TelemetryData, field)
+    uint16_t           frame_offset;             ///< offsetof(TelemetryBinaryFrame, field)
+    uint8_t            frame_size;               ///< Bytes of the field in the binary frame (1 or 4)
+    float              deadband;                 ///< Smallest float change that counts as changed
+    const char* const* values;                   ///< Value list of a string field, NULL otherwise
+    uint8_t            value_count;              ///< Number of entries in values
+} TelemetryFieldInfo;
+
 //==================================================================================================
 // Telemetry Construction Functions
 //==================================================================================================
@@ -97,6 +258,54 @@ void telemetry_init(TelemetryData* data);
  */
 int telemetry_build_message(const TelemetryData* data, char* buffer, size_t buffer_size);
 
+/**
+ * @brief Build a telemetry message string with only the subscribed fields.
+ * @param data Pointer to TelemetryData structure containing current values
+ * @param fields Mask of TELEM_FIELD_BIT() values to include
+ * @param buffer Output buffer to write telemetry message
+ * @param buffer_size Size of output buffer
+ * @return Number of characters written (excluding null terminator)
+ */
+int telemetry_build_message_fields(const TelemetryData* data, uint32_t fields, char* buffer, size_t buffer_size);
+
+/**
+ * @brief Find the fields that differ between two snapshots.
+ * @param current Pointer to TelemetryData structure containing current values
+ * @param last Pointer to TelemetryData structure containing the last values sent
+ * @return TELEM_FIELD_BIT() mask of fields whose value changed (floats by at least their deadband)
+ */
+uint32_t telemetry_changed_fields(const TelemetryData* current, const TelemetryData* last);
+
+/**
+ * @brief Copy selected fields from one snapshot to another.
+ * @param dst Pointer to TelemetryData structure to update
+ * @param src Pointer to TelemetryData structure to copy from
+ * @param fields TELEM_FIELD_BIT() mask of fields to copy
+ */
+void telemetry_copy_fields(TelemetryData* dst, const TelemetryData* src, uint32_t fields);
+
+/**
+ * @brief Look up a field ID by its telemetry.json key.
+ * @param key Field key, e.g. "force_load_cell"
+ * @return TelemetryFieldId, or -1 if @p key is not a telemetry field
+ */
+int telemetry_field_id(const char* key);
+
+/**
+ * @brief Look up the description of a telemetry field.
+ * @param id TelemetryFieldId
+ * @return Field description, or NULL if @p id is out of range
+ */
+const TelemetryFieldInfo* telemetry_field_info(int id);
+
+/**
+ * @brief Pack the data structure into a binary telemetry frame.
+ * @param data Pointer to TelemetryData structure containing current values
+ * @param seq Frame counter to store in the frame
+ * @param frame Output frame
+ */
+void telemetry_build_frame(const TelemetryData* data, uint16_t seq, TelemetryBinaryFrame* frame);
+
 /**
  * @brief Send telemetry message via comms controller.
  * @param data Pointer to TelemetryData structure containing current values
@@ -0,0 +1,119 @@
+/**
+ * @file watchdog_supervisor.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Defines the watchdog supervisor: per-task check-in deadlines gating the hardware feed.
+ *
+ * @details Every main-loop task is a client: the scheduler checks it in each time its hook
+ * returns, with a deadline of its period plus WATCHDOG_TASK_DEADLINE_MS. The control tick
+ * checks in from its interrupt (WATCHDOG_TICK_DEADLINE_MS). The safety task asks service()
+ * before it feeds the WDT, and the feed happens only while every client is on time. A late
+ * client stops the feeding for good: the early warning disables the drives and the WDT
+ * resets the board within WATCHDOG_TIMEOUT_MS, as for a blocked loop. The late client's
+ * name, silence and deadline go into no-init RAM, so the recovery report after the reset
+ * names the task that stopped rather than wherever the loop happened to be.
+ *
+ * A client counts as late only if its last check-in also came before the previous
+ * service(), i.e. it missed a whole pass. One long pass delays every task at once; that is
+ * still the hardware watchdog's to judge, and it does not make the tasks late here.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+#if WATCHDOG_ENABLED
+
+#define WATCHDOG_CLIENT_NONE            0xFF        ///< No client (registration failed, or none late).
+#define WATCHDOG_CLIENT_NAME_LENGTH     12          ///< Characters of a late client's name kept across the reset, NUL included.
+
+/**
+ * @struct WatchdogClient
+ * @brief One supervised task.
+ */
+struct WatchdogClient {
+    const char* name;               ///< Name shown by dump_perf and the recovery report (not copied)
+    uint32_t deadline_ms;           ///< Longest silence allowed between check-ins
+    volatile uint32_t last_ms;      ///< Milliseconds() of the last check-in
+    uint32_t worst_ms;              ///< Longest silence service() has seen since boot
+};
+
+/**
+ * @struct WatchdogLateRecord
+ * @brief The client that stopped the feeding, as kept across the reset.
+ */
+struct WatchdogLateRecord {
+    uint32_t magic;                             ///< WATCHDOG_LATE_MAGIC when valid
+    uint32_t silence_ms;                        ///< How long it had been silent
+    uint32_t deadline_ms;                       ///< Its deadline
+    char name[WATCHDOG_CLIENT_NAME_LENGTH];     ///< Its name
+};
+
+/**
+ * @class WatchdogSupervisor
+ * @brief Client deadlines and the feed decision. Check-ins from anywhere; the rest main loop only.
+ */
+class WatchdogSupervisor {
+public:
+    /**
+     * @brief Constructs a supervisor with no clients, not yet armed.
+     */
+    WatchdogSupervisor();
+
+    /**
+     * @brief Takes the late-client record of the previous boot out of no-init RAM. Call once,
+     * early in setup().
+     */
+    void load();
+
+    /**
+     * @brief Adds a client.
+     * @param name Name shown in reports (not copied)
+     * @param deadline_ms Longest silence allowed between check-ins
+     * @return Client ID, or WATCHDOG_CLIENT_NONE if WATCHDOG_SUPERVISOR_MAX_CLIENTS are registered
+     */
+    uint8_t registerClient(const char* name, uint32_t deadline_ms);
+
+    /**
+     * @brief Records that a client is alive. Safe from interrupts; an unknown ID is ignored.
+     * @param client Client ID
+     */
+    void checkIn(uint8_t client);
+
+    /**
+     * @brief Starts supervising: every client counts as checked in now. Until then service()
+     * always allows the feed, so setup() can run long steps.
+     * @param now_ms Milliseconds()
+     */
+    void start(uint32_t now_ms);
+
+    /**
+     * @brief Checks every client's deadline. Called by the safety task before each feed.
+     * @param now_ms Milliseconds()
+     * @return true if the WDT may be fed; false from the first late client on
+     */
+    bool service(uint32_t now_ms);
+
+    uint8_t getClientCount() const { return m_count; }                          ///< Registered clients.
+    const WatchdogClient& getClient(uint8_t index) const { return m_clients[index]; } ///< A client, by ID.
+    uint8_t getLateClient() const { return m_late; }                            ///< Client that stopped the feed, or WATCHDOG_CLIENT_NONE.
+
+    /**
+     * @brief Gets the late client of the previous boot.
+     * @return The record, or nullptr if that boot did not end on a late client
+     */
+    const WatchdogLateRecord* getSavedLate() const { return m_hasSaved ? &m_saved : nullptr; }
+
+private:
+    WatchdogClient m_clients[WATCHDOG_SUPERVISOR_MAX_CLIENTS];  ///< Registered clients, by ID
+    volatile uint8_t m_count;                                   ///< Valid entries in m_clients
+    bool m_armed;                                               ///< start() has been called
+    uint32_t m_lastServiceMs;                                   ///< Milliseconds() of the previous service()
+    uint8_t m_late;                                             ///< First late client, or WATCHDOG_CLIENT_NONE
+    WatchdogLateRecord m_saved;                                 ///< Late client of the previous boot
+    bool m_hasSaved;                                            ///< m_saved is valid
+};
+
+extern WatchdogSupervisor g_watchdogSupervisor;
+
+#endif // WATCHDOG_ENABLED
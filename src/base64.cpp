@@ -0,0 +1,62 @@
+/**
+ * @file base64.cpp
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Implements the base64 codec used to carry binary records in text messages.
+ */
+
+#include "base64.h"
+
+static const char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t base64Encode(const uint8_t* data, size_t length, char* out) {
+    char* start = out;
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t chunk = (uint32_t)data[i] << 16;
+        if (i + 1 < length) chunk |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < length) chunk |= data[i + 2];
+        *out++ = kBase64[(chunk >> 18) & 0x3F];
+        *out++ = kBase64[(chunk >> 12) & 0x3F];
+        *out++ = (i + 1 < length) ? kBase64[(chunk >> 6) & 0x3F] : '=';
+        *out++ = (i + 2 < length) ? kBase64[chunk & 0x3F] : '=';
+    }
+    *out = '\0';
+    return (size_t)(out - start);
+}
+
+/** @brief Value of a base64 character, or -1. */
+static int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+size_t base64Decode(const char* text, uint8_t* out, size_t capacity) {
+    size_t written = 0;
+    uint32_t chunk = 0;
+    int bits = 0;
+    const char* p = text;
+    for (; *p != '\0' && *p != '=' && *p != ' ' && *p != '\r' && *p != '\n'; p++) {
+        int value = base64Value(*p);
+        if (value < 0) {
+            return 0;
+        }
+        chunk = (chunk << 6) | (uint32_t)value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (written >= capacity) {
+                return 0;
+            }
+            out[written++] = (uint8_t)(chunk >> bits);
+        }
+    }
+    // A lone trailing character cannot encode a whole byte
+    if (bits >= 6) {
+        return 0;
+    }
+    return written;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file benchmark.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the on-target micro-benchmark suite.
+ */
+
+#include "benchmark.h"
+
+#if PRESSBOI_BENCHMARK
+
+#include "commands.h"
+#include "comms_controller.h"
+#include "events.h"
+#include "force_sensor.h"
+#include "machine_strain.h"
+#include "motor_controller.h"
+#include "press_metrics.h"
+#include "variables.h"
+#include <sam.h>
+#include <string.h>
+
+extern TelemetryData g_telemetry;
+
+// Global benchmark suite instance
+BenchmarkSuite g_benchmarks;
+
+// Command lines in rough order of how often the GUI sends them
+static const char* const BENCH_COMMANDS[] = {
+    "move_abs 25.0 5.0 200 hold", "set_telemetry 50 10", "retract 25", "home", "pause",
+    "set_press_threshold 2.5", "dump_perf", "cmdb AQIAAA==", "no_such_command"
+};
+#define BENCH_COMMAND_COUNT     (sizeof(BENCH_COMMANDS) / sizeof(BENCH_COMMANDS[0]))
+
+// Times one call of an expression into min_cycles / total_cycles
+#define BENCH_TIME(expr) do { \
+        uint32_t start_ = DWT->CYCCNT; \
+        expr; \
+        uint32_t cycles_ = DWT->CYCCNT - start_; \
+        total_cycles += cycles_; \
+        if (cycles_ < min_cycles) min_cycles = cycles_; \
+    } while (0)
+
+BenchmarkSuite::BenchmarkSuite() {
+    memset(m_results, 0, sizeof(m_results));
+}
+
+void BenchmarkSuite::run(CommsController& comms, MotorController& motor) {
+    uint32_t min_cycles;
+    uint32_t total_cycles;
+    volatile int32_t sink = 0;
+
+    static char buffer[MAX_MESSAGE_LENGTH];
+    min_cycles = UINT32_MAX;
+    total_cycles = 0;
+    for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+        BENCH_TIME(sink += telemetry_build_message(&g_telemetry, buffer, sizeof(buffer)));
+    }
+    finish(BENCH_TELEMETRY_BUILD, BENCHMARK_CALLS, min_cycles, total_cycles);
+
+    min_cycles = UINT32_MAX;
+    total_cycles = 0;
+    for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+        BENCH_TIME(sink += parseCommand(BENCH_COMMANDS[i % BENCH_COMMAND_COUNT]));
+    }
+    finish(BENCH_PARSE_COMMAND, BENCHMARK_CALLS, min_cycles, total_cycles);
+
+    // A sensor of its own: the live channels keep their ring and latest reading
+    static ForceSensor sensor(0);
+    static const uint8_t line[] = "-123456\n";
+    min_cycles = UINT32_MAX;
+    total_cycles = 0;
+    for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+        BENCH_TIME(sensor.decodeBytes(line, sizeof(line) - 1));
+        sensor.flushSamples();
+    }
+    finish(BENCH_FORCE_DECODE, BENCHMARK_CALLS, min_cycles, total_cycles);
+
+    total_cycles = motor.benchmarkJoules(BENCHMARK_CALLS, &min_cycles);
+    finish(BENCH_JOULE_SAMPLE, BENCHMARK_CALLS, min_cycles, total_cycles);
+
+    static MachineStrainModel strain;
+    volatile float fsink = 0.0f;
+    min_cycles = UINT32_MAX;
+    total_cycles = 0;
+    for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+        float force_kg = 1000.0f * i / BENCHMARK_CALLS;
+        BENCH_TIME(fsink += strain.deflectionFromForce(force_kg));
+    }
+    finish(BENCH_DEFLECTION_LOOKUP, BENCHMARK_CALLS, min_cycles, total_cycles);
+
+    // Rising force makes every sample a new peak, so every add() fits the full window
+    static PressMetrics metrics;
+    metrics.begin(1.0f);
+    for (uint16_t i = 0; i < PRESS_METRICS_STIFFNESS_WINDOW; i++) {
+        metrics.add(i * 1000u, 0.01f * i, 2.0f * i, 0.0f, 0.0f);
+    }
+    min_cycles = UINT32_MAX;
+    total_cycles = 0;
+    for (uint32_t i = PRESS_METRICS_STIFFNESS_WINDOW; i < PRESS_METRICS_STIFFNESS_WINDOW + BENCHMARK_CALLS; i++) {
+        BENCH_TIME(metrics.add(i * 1000u, 0.01f * i, 2.0f * i, 0.0f, 0.0f));
+    }
+    finish(BENCH_STIFFNESS_WINDOW, BENCHMARK_CALLS, min_cycles, total_cycles);
+
+    // Goes out for real: the path includes the UDP send and the USB mirror
+    IpAddress ip = comms.isGuiDiscovered() ? comms.getGuiIp() : IpAddress(0, 0, 0, 0);
+    uint16_t port = comms.isGuiDiscovered() ? comms.getGuiPort() : 0;
+    min_cycles = UINT32_MAX;
+    total_cycles = 0;
+    for (uint32_t i = 0; i < BENCHMARK_TX_CALLS; i++) {
+        BENCH_TIME(comms.enqueueTx(STATUS_PREFIX_INFO "bench tx", ip, port); comms.updateTx(0));
+    }
+    finish(BENCH_TX_SEND, BENCHMARK_TX_CALLS, min_cycles, total_cycles);
+    (void)sink;
+    (void)fsink;
+}
+
+const char* BenchmarkSuite::name(uint8_t id) {
+    switch (id) {
+        case BENCH_TELEMETRY_BUILD:   return "telemetry_build_message";
+        case BENCH_PARSE_COMMAND:     return "parseCommand";
+        case BENCH_FORCE_DECODE:      return "force_decode_line";
+        case BENCH_JOULE_SAMPLE:      return "joule_sample";
+        case BENCH_DEFLECTION_LOOKUP: return "deflection_lookup";
+        case BENCH_STIFFNESS_WINDOW:  return "stiffness_window";
+        case BENCH_TX_SEND:           return "enqueue_tx_send";
+        default:                      return "unknown";
+    }
+}
+
+void BenchmarkSuite::finish(uint8_t id, uint32_t calls, uint32_t min_cycles, uint32_t total_cycles) {
+    m_results[id].calls = calls;
+    m_results[id].min_cycles = min_cycles;
+    m_results[id].mean_cycles = (calls > 0) ? total_cycles / calls : 0;
+}
+
+#endif // PRESSBOI_BENCHMARK
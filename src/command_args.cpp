@@ -0,0 +1,410 @@
+/**
+ * @file command_args.cpp
+ * @brief Typed command argument decoders for the Pressboi controller.
+ * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY
+ * Generated from commands.json on 2025-11-21 10:02:17
+ *
+ * The field tables below are generated from the params of each command. The text and
+ * binary decoders walk the same table, so both encodings validate identically.
+ */
+
+#include "command_args.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//==================================================================================================
+// Field Tables
+//==================================================================================================
+
+/** @brief Wire type of one param. */
+enum CommandArgType {
+    ARG_FLOAT,      ///< float
+    ARG_INT,        ///< int32_t
+    ARG_STRING,     ///< char[size], one token
+    ARG_REST        ///< const char*, the rest of the command
+};
+
+/** @brief Where one param lands in its argument struct. */
+struct CommandArgField {
+    uint8_t type;       ///< CommandArgType
+    uint16_t size;      ///< Field size in bytes (string buffer size for ARG_STRING)
+    uint16_t offset;    ///< offsetof() the field in its argument struct
+};
+
+#define ARG_FIELD(type, S, f)   { type, (uint16_t)sizeof(S::f), (uint16_t)offsetof(S, f) }
+
+static const CommandArgField kResetFields[] = {
+    ARG_FIELD(ARG_STRING, ResetArgs, mode),
+};
+static const CommandArgField kHomeFields[] = {
+    ARG_FIELD(ARG_STRING, HomeArgs, mode),
+};
+static const CommandArgField kMoveAbsFields[] = {
+    ARG_FIELD(ARG_FLOAT, MoveAbsArgs, position),
+    ARG_FIELD(ARG_FLOAT, MoveAbsArgs, speed),
+    ARG_FIELD(ARG_FLOAT, MoveAbsArgs, force),
+    ARG_FIELD(ARG_STRING, MoveAbsArgs, force_action),
+    ARG_FIELD(ARG_INT, MoveAbsArgs, dwell),
+};
+static const CommandArgField kMoveIncFields[] = {
+    ARG_FIELD(ARG_FLOAT, MoveIncArgs, distance),
+    ARG_FIELD(ARG_FLOAT, MoveIncArgs, speed),
+    ARG_FIELD(ARG_FLOAT, MoveIncArgs, force),
+    ARG_FIELD(ARG_STRING, MoveIncArgs, force_action),
+};
+static const CommandArgField kQueueMoveFields[] = {
+    ARG_FIELD(ARG_FLOAT, QueueMoveArgs, position),
+    ARG_FIELD(ARG_FLOAT, QueueMoveArgs, speed),
+    ARG_FIELD(ARG_FLOAT, QueueMoveArgs, force),
+    ARG_FIELD(ARG_STRING, QueueMoveArgs, force_action),
+    ARG_FIELD(ARG_INT, QueueMoveArgs, dwell),
+};
+static const CommandArgField kRecipeNewFields[] = {
+    ARG_FIELD(ARG_STRING, RecipeNewArgs, name),
+};
+static const CommandArgField kRecipeAddFields[] = {
+    ARG_FIELD(ARG_STRING, RecipeAddArgs, step),
+    ARG_FIELD(ARG_REST, RecipeAddArgs, args),
+};
+static const CommandArgField kRecipeLearnFields[] = {
+    ARG_FIELD(ARG_FLOAT, RecipeLearnArgs, margin),
+    ARG_FIELD(ARG_FLOAT, RecipeLearnArgs, rapid_speed),
+};
+static const CommandArgField kRunRecipeFields[] = {
+    ARG_FIELD(ARG_STRING, RunRecipeArgs, name),
+};
+static const CommandArgField kRecipeEnvelopeFields[] = {
+    ARG_FIELD(ARG_STRING, RecipeEnvelopeArgs, action),
+    ARG_FIELD(ARG_REST, RecipeEnvelopeArgs, points),
+};
+static const CommandArgField kRecipeZonesFields[] = {
+    ARG_FIELD(ARG_STRING, RecipeZonesArgs, action),
+    ARG_FIELD(ARG_REST, RecipeZonesArgs, band),
+};
+static const CommandArgField kFitStrainCalFields[] = {
+    ARG_FIELD(ARG_STRING, FitStrainCalArgs, mode),
+};
+static const CommandArgField kFwUpdateFields[] = {
+    ARG_FIELD(ARG_STRING, FwUpdateArgs, action),
+    ARG_FIELD(ARG_INT, FwUpdateArgs, size),
+    ARG_FIELD(ARG_STRING, FwUpdateArgs, crc),
+};
+static const CommandArgField kProfileNameFields[] = {
+    ARG_FIELD(ARG_STRING, ProfileNameArgs, name),
+};
+static const CommandArgField kRestoreNvmFields[] = {
+    ARG_FIELD(ARG_REST, RestoreNvmArgs, image),
+};
+static const CommandArgField kForceReplayFields[] = {
+    ARG_FIELD(ARG_STRING, ForceReplayArgs, action),
+    ARG_FIELD(ARG_REST, ForceReplayArgs, points),
+};
+static const CommandArgField kSetForceModeFields[] = {
+    ARG_FIELD(ARG_STRING, SetForceModeArgs, mode),
+};
+static const CommandArgField kSetRetractFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetRetractArgs, position),
+    ARG_FIELD(ARG_FLOAT, SetRetractArgs, speed),
+};
+static const CommandArgField kRetractFields[] = {
+    ARG_FIELD(ARG_FLOAT, RetractArgs, speed),
+};
+static const CommandArgField kSetForceOffsetFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetForceOffsetArgs, offset),
+    ARG_FIELD(ARG_STRING, SetForceOffsetArgs, channel),
+};
+static const CommandArgField kSetForceScaleFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetForceScaleArgs, scale),
+    ARG_FIELD(ARG_STRING, SetForceScaleArgs, channel),
+};
+static const CommandArgField kSetStrainCalFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetStrainCalArgs, x4),
+    ARG_FIELD(ARG_FLOAT, SetStrainCalArgs, x3),
+    ARG_FIELD(ARG_FLOAT, SetStrainCalArgs, x2),
+    ARG_FIELD(ARG_FLOAT, SetStrainCalArgs, x1),
+    ARG_FIELD(ARG_FLOAT, SetStrainCalArgs, c),
+};
+static const CommandArgField kSetDebugFields[] = {
+    ARG_FIELD(ARG_INT, SetDebugArgs, level),
+};
+static const CommandArgField kSetLogLevelFields[] = {
+    ARG_FIELD(ARG_STRING, SetLogLevelArgs, level),
+};
+static const CommandArgField kDumpErrorLogFields[] = {
+    ARG_FIELD(ARG_STRING, DumpErrorLogArgs, format),
+};
+static const CommandArgField kSetTelemetryFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetTelemetryArgs, busy_hz),
+    ARG_FIELD(ARG_FLOAT, SetTelemetryArgs, idle_hz),
+    ARG_FIELD(ARG_STRING, SetTelemetryArgs, fields),
+};
+static const CommandArgField kSetTelemetryDeltaFields[] = {
+    ARG_FIELD(ARG_INT, SetTelemetryDeltaArgs, keyframe_ms),
+};
+static const CommandArgField kSetTelemetryBurstFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetTelemetryBurstArgs, press_hz),
+    ARG_FIELD(ARG_INT, SetTelemetryBurstArgs, hold_ms),
+};
+static const CommandArgField kSetSyncFields[] = {
+    ARG_FIELD(ARG_STRING, SetSyncArgs, role),
+    ARG_FIELD(ARG_STRING, SetSyncArgs, leader_ip),
+};
+static const CommandArgField kSubscribeTelemetryFields[] = {
+    ARG_FIELD(ARG_INT, SubscribeTelemetryArgs, port),
+    ARG_FIELD(ARG_FLOAT, SubscribeTelemetryArgs, rate_hz),
+    ARG_FIELD(ARG_INT, SubscribeTelemetryArgs, lease_s),
+};
+static const CommandArgField kUnsubscribeTelemetryFields[] = {
+    ARG_FIELD(ARG_INT, UnsubscribeTelemetryArgs, port),
+};
+static const CommandArgField kSetUsbRouteFields[] = {
+    ARG_FIELD(ARG_STRING, SetUsbRouteArgs, route),
+};
+static const CommandArgField kCmdbFields[] = {
+    ARG_FIELD(ARG_REST, CmdbArgs, frame),
+};
+static const CommandArgField kSetPolarityFields[] = {
+    ARG_FIELD(ARG_STRING, SetPolarityArgs, polarity),
+};
+static const CommandArgField kHomeOnBootFields[] = {
+    ARG_FIELD(ARG_STRING, HomeOnBootArgs, enabled),
+};
+static const CommandArgField kSetPressThresholdFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetPressThresholdArgs, threshold),
+};
+static const CommandArgField kSetMotionProfileFields[] = {
+    ARG_FIELD(ARG_STRING, SetMotionProfileArgs, profile),
+    ARG_FIELD(ARG_FLOAT, SetMotionProfileArgs, jerk),
+};
+static const CommandArgField kSetEncoderFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetEncoderArgs, counts_per_mm),
+    ARG_FIELD(ARG_FLOAT, SetEncoderArgs, tolerance),
+};
+static const CommandArgField kSetDriveGeometryFields[] = {
+    ARG_FIELD(ARG_FLOAT, SetDriveGeometryArgs, pitch),
+    ARG_FIELD(ARG_INT, SetDriveGeometryArgs, pulses_per_rev),
+};
+static const CommandArgField kSetRapidTraverseFields[] = {
+    ARG_FIELD(ARG_INT, SetRapidTraverseArgs, speed),
+    ARG_FIELD(ARG_INT, SetRapidTraverseArgs, accel),
+};
+static const CommandArgField kSetTorqueFrictionFields[] = {
+    ARG_FIELD(ARG_REST, SetTorqueFrictionArgs, points),
+};
+static const CommandArgField kSetForceFilterFields[] = {
+    ARG_FIELD(ARG_INT, SetForceFilterArgs, median),
+    ARG_FIELD(ARG_FLOAT, SetForceFilterArgs, alpha),
+};
+static const CommandArgField kSetForceTableFields[] = {
+    ARG_FIELD(ARG_REST, SetForceTableArgs, points),
+};
+static const CommandArgField kSetForceLatencyFields[] = {
+    ARG_FIELD(ARG_INT, SetForceLatencyArgs, latency),
+};
+static const CommandArgField kSetForceChannelFields[] = {
+    ARG_FIELD(ARG_STRING, SetForceChannelArgs, channel),
+};
+
+#define ARG_FIELDS(cmd, table)  case cmd: *count = sizeof(table) / sizeof(table[0]); return table;
+
+/**
+ * @brief Looks up the field table of a command.
+ * @param cmd Command
+ * @param count Number of fields (0 for commands without params)
+ * @return Field table, or NULL for commands without params
+ */
+static const CommandArgField* commandArgFields(Command cmd, uint8_t* count) {
+    switch (cmd) {
+        ARG_FIELDS(CMD_RESET, kResetFields)
+        ARG_FIELDS(CMD_HOME, kHomeFields)
+        ARG_FIELDS(CMD_MOVE_ABS, kMoveAbsFields)
+        ARG_FIELDS(CMD_MOVE_INC, kMoveIncFields)
+        ARG_FIELDS(CMD_QUEUE_MOVE, kQueueMoveFields)
+        ARG_FIELDS(CMD_RECIPE_NEW, kRecipeNewFields)
+        ARG_FIELDS(CMD_RECIPE_ADD, kRecipeAddFields)
+        ARG_FIELDS(CMD_RECIPE_LEARN, kRecipeLearnFields)
+        ARG_FIELDS(CMD_RUN_RECIPE, kRunRecipeFields)
+        ARG_FIELDS(CMD_RECIPE_ENVELOPE, kRecipeEnvelopeFields)
+        ARG_FIELDS(CMD_RECIPE_ZONES, kRecipeZonesFields)
+        ARG_FIELDS(CMD_SET_FORCE_MODE, kSetForceModeFields)
+        ARG_FIELDS(CMD_SET_RETRACT, kSetRetractFields)
+        ARG_FIELDS(CMD_RETRACT, kRetractFields)
+        ARG_FIELDS(CMD_SET_FORCE_OFFSET, kSetForceOffsetFields)
+        ARG_FIELDS(CMD_SET_FORCE_SCALE, kSetForceScaleFields)
+        ARG_FIELDS(CMD_SET_STRAIN_CAL, kSetStrainCalFields)
+        ARG_FIELDS(CMD_FIT_STRAIN_CAL, kFitStrainCalFields)
+        ARG_FIELDS(CMD_FW_UPDATE, kFwUpdateFields)
+        ARG_FIELDS(CMD_SET_DEBUG, kSetDebugFields)
+        ARG_FIELDS(CMD_SET_LOG_LEVEL, kSetLogLevelFields)
+        ARG_FIELDS(CMD_DUMP_ERROR_LOG, kDumpErrorLogFields)
+        ARG_FIELDS(CMD_SET_TELEMETRY, kSetTelemetryFields)
+        ARG_FIELDS(CMD_SET_TELEMETRY_DELTA, kSetTelemetryDeltaFields)
+        ARG_FIELDS(CMD_SET_TELEMETRY_BURST, kSetTelemetryBurstFields)
+        ARG_FIELDS(CMD_SET_SYNC, kSetSyncFields)
+        ARG_FIELDS(CMD_SUBSCRIBE_TELEMETRY, kSubscribeTelemetryFields)
+        ARG_FIELDS(CMD_UNSUBSCRIBE_TELEMETRY, kUnsubscribeTelemetryFields)
+        ARG_FIELDS(CMD_SET_USB_ROUTE, kSetUsbRouteFields)
+        ARG_FIELDS(CMD_CMDB, kCmdbFields)
+        ARG_FIELDS(CMD_SET_POLARITY, kSetPolarityFields)
+        ARG_FIELDS(CMD_HOME_ON_BOOT, kHomeOnBootFields)
+        ARG_FIELDS(CMD_SET_PRESS_THRESHOLD, kSetPressThresholdFields)
+        ARG_FIELDS(CMD_SET_MOTION_PROFILE, kSetMotionProfileFields)
+        ARG_FIELDS(CMD_SET_ENCODER, kSetEncoderFields)
+        ARG_FIELDS(CMD_SET_DRIVE_GEOMETRY, kSetDriveGeometryFields)
+        ARG_FIELDS(CMD_SET_RAPID_TRAVERSE, kSetRapidTraverseFields)
+        ARG_FIELDS(CMD_SET_TORQUE_FRICTION, kSetTorqueFrictionFields)
+        ARG_FIELDS(CMD_SET_FORCE_FILTER, kSetForceFilterFields)
+        ARG_FIELDS(CMD_SET_FORCE_TABLE, kSetForceTableFields)
+        ARG_FIELDS(CMD_SET_FORCE_LATENCY, kSetForceLatencyFields)
+        ARG_FIELDS(CMD_SET_FORCE_CHANNEL, kSetForceChannelFields)
+        ARG_FIELDS(CMD_SAVE_PROFILE, kProfileNameFields)
+        ARG_FIELDS(CMD_SELECT_PROFILE, kProfileNameFields)
+        ARG_FIELDS(CMD_DELETE_PROFILE, kProfileNameFields)
+        ARG_FIELDS(CMD_RESTORE_NVM, kRestoreNvmFields)
+        ARG_FIELDS(CMD_FORCE_REPLAY, kForceReplayFields)
+        default:
+            *count = 0;
+            return NULL;
+    }
+}
+
+//==================================================================================================
+// Decoders
+//==================================================================================================
+
+/** @brief Start of the argument struct; every union member sits at the same address. */
+static inline uint8_t* argStorage(CommandArgs* args) {
+    return reinterpret_cast<uint8_t*>(&args->home);
+}
+
+static inline bool isArgSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+bool parseCommandArgs(Command cmd, const char* text, CommandArgs* out) {
+    memset(out, 0, sizeof(*out));
+    uint8_t fieldCount;
+    const CommandArgField* fields = commandArgFields(cmd, &fieldCount);
+    if (fields == NULL || text == NULL) {
+        return true;
+    }
+
+    uint8_t* base = argStorage(out);
+    const char* p = text;
+    for (uint8_t i = 0; i < fieldCount; i++) {
+        while (isArgSpace(*p)) p++;
+        if (*p == '\0') {
+            return true;
+        }
+        const CommandArgField& field = fields[i];
+        if (field.type == ARG_REST) {
+            memcpy(base + field.offset, &p, sizeof(p));
+            out->count++;
+            return true;
+        }
+
+        const char* end = p;
+        while (*end != '\0' && !isArgSpace(*end)) end++;
+        size_t len = (size_t)(end - p);
+        char* converted = NULL;
+        switch (field.type) {
+            case ARG_FLOAT: {
+                float value = strtof(p, &converted);
+                if (converted != end || !isfinite(value)) {
+                    return false;
+                }
+                memcpy(base + field.offset, &value, sizeof(value));
+                break;
+            }
+            case ARG_INT: {
+                // long is 32 bits on the SAME53, so overflow only shows in errno
+                errno = 0;
+                long value = strtol(p, &converted, 10);
+                if (converted != end || errno == ERANGE || value < INT32_MIN || value > INT32_MAX) {
+                    return false;
+                }
+                int32_t value32 = (int32_t)value;
+                memcpy(base + field.offset, &value32, sizeof(value32));
+                break;
+            }
+            default: {
+                if (len >= field.size) {
+                    return false;
+                }
+                memcpy(base + field.offset, p, len);
+                base[field.offset + len] = '\0';
+                break;
+            }
+        }
+        out->count++;
+        p = end;
+    }
+
+    while (isArgSpace(*p)) p++;
+    return *p == '\0';
+}
+
+bool decodeCommandFrame(uint8_t* frame, size_t length, size_t capacity, Command* cmd, CommandArgs* out) {
+    memset(out, 0, sizeof(*out));
+    if (length < 2 || length >= capacity || frame[0] == CMD_UNKNOWN || frame[0] == CMD_CMDB ||
+        frame[0] >= CMD_COUNT) {
+        return false;
+    }
+    *cmd = static_cast<Command>(frame[0]);
+    uint8_t fieldCount;
+    const CommandArgField* fields = commandArgFields(*cmd, &fieldCount);
+    uint8_t given = frame[1];
+    if (given > fieldCount) {
+        return false;
+    }
+
+    uint8_t* base = argStorage(out);
+    const uint8_t* p = frame + 2;
+    const uint8_t* end = frame + length;
+    for (uint8_t i = 0; i < given; i++) {
+        const CommandArgField& field = fields[i];
+        switch (field.type) {
+            case ARG_FLOAT:
+            case ARG_INT: {
+                // Little-endian on the wire and on the SAME53, so the bytes copy straight in
+                if (end - p < 4) {
+                    return false;
+                }
+                if (field.type == ARG_FLOAT) {
+                    float value;
+                    memcpy(&value, p, sizeof(value));
+                    if (!isfinite(value)) {
+                        return false;
+                    }
+                }
+                memcpy(base + field.offset, p, 4);
+                p += 4;
+                break;
+            }
+            case ARG_STRING: {
+                if (p >= end) {
+                    return false;
+                }
+                uint8_t len = *p++;
+                if (len >= field.size || end - p < len) {
+                    return false;
+                }
+                memcpy(base + field.offset, p, len);
+                base[field.offset + len] = '\0';
+                p += len;
+                break;
+            }
+            default: {
+                frame[length] = '\0';
+                const char* rest = reinterpret_cast<const char*>(p);
+                memcpy(base + field.offset, &rest, sizeof(rest));
+                p = end;
+                break;
+            }
+        }
+        out->count++;
+    }
+    return p == end;
+}
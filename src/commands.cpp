@@ -14,63 +14,340 @@
 // Command Parser Implementation
 //==================================================================================================
 
+/**
+ * @brief Compares a command's first token against a command string.
+ * @param cmdStr Command text (length of its first token already checked).
+ * @param name CMD_STR_* constant; a trailing space (arguments required) is not compared.
+ * @param nameLen sizeof(name) - 1.
+ */
+static inline bool commandTokenIs(const char* cmdStr, const char* name, size_t nameLen) {
+    if (name[nameLen - 1] == ' ') {
+        nameLen--;
+    }
+    return memcmp(cmdStr, name, nameLen) == 0;
+}
+
 Command parseCommand(const char* cmdStr) {
-    // IMPORTANT: Check longer commands BEFORE shorter ones that are prefixes!
-    // e.g., check "reset_nvm" before "reset", "set_retract" before "retract", etc.
-    
-    if (strncmp(cmdStr, CMD_STR_DISCOVER_DEVICE, strlen(CMD_STR_DISCOVER_DEVICE)) == 0) return CMD_DISCOVER_DEVICE;
-    if (strncmp(cmdStr, CMD_STR_REBOOT_BOOTLOADER, strlen(CMD_STR_REBOOT_BOOTLOADER)) == 0) return CMD_REBOOT_BOOTLOADER;
-    if (strncmp(cmdStr, CMD_STR_TEST_WATCHDOG, strlen(CMD_STR_TEST_WATCHDOG)) == 0) return CMD_TEST_WATCHDOG;
-    if (strncmp(cmdStr, CMD_STR_SET_FORCE_OFFSET, strlen(CMD_STR_SET_FORCE_OFFSET)) == 0) return CMD_SET_FORCE_OFFSET;
-    if (strncmp(cmdStr, CMD_STR_SET_FORCE_ZERO, strlen(CMD_STR_SET_FORCE_ZERO)) == 0) return CMD_SET_FORCE_ZERO;
-    if (strncmp(cmdStr, CMD_STR_SET_FORCE_SCALE, strlen(CMD_STR_SET_FORCE_SCALE)) == 0) return CMD_SET_FORCE_SCALE;
-    if (strncmp(cmdStr, CMD_STR_SET_FORCE_MODE, strlen(CMD_STR_SET_FORCE_MODE)) == 0) return CMD_SET_FORCE_MODE;
-    if (strncmp(cmdStr, CMD_STR_SET_STRAIN_CAL, strlen(CMD_STR_SET_STRAIN_CAL)) == 0) return CMD_SET_STRAIN_CAL;
-    if (strncmp(cmdStr, CMD_STR_SET_POLARITY, strlen(CMD_STR_SET_POLARITY)) == 0) return CMD_SET_POLARITY;
-    if (strncmp(cmdStr, CMD_STR_HOME_ON_BOOT, strlen(CMD_STR_HOME_ON_BOOT)) == 0) return CMD_HOME_ON_BOOT;
-    if (strncmp(cmdStr, CMD_STR_SET_PRESS_THRESHOLD, strlen(CMD_STR_SET_PRESS_THRESHOLD)) == 0) return CMD_SET_PRESS_THRESHOLD;
-    if (strncmp(cmdStr, CMD_STR_SET_RETRACT, strlen(CMD_STR_SET_RETRACT)) == 0) return CMD_SET_RETRACT;
-    if (strncmp(cmdStr, CMD_STR_DUMP_ERROR_LOG, strlen(CMD_STR_DUMP_ERROR_LOG)) == 0) return CMD_DUMP_ERROR_LOG;
-    if (strncmp(cmdStr, CMD_STR_RESET_NVM, strlen(CMD_STR_RESET_NVM)) == 0) return CMD_RESET_NVM;
-    if (strncmp(cmdStr, CMD_STR_DUMP_NVM, strlen(CMD_STR_DUMP_NVM)) == 0) return CMD_DUMP_NVM;
-    if (strncmp(cmdStr, CMD_STR_MOVE_ABS, strlen(CMD_STR_MOVE_ABS)) == 0) return CMD_MOVE_ABS;
-    if (strncmp(cmdStr, CMD_STR_MOVE_INC, strlen(CMD_STR_MOVE_INC)) == 0) return CMD_MOVE_INC;
-    if (strncmp(cmdStr, CMD_STR_RETRACT, strlen(CMD_STR_RETRACT)) == 0) return CMD_RETRACT;
-    if (strncmp(cmdStr, CMD_STR_RESET, strlen(CMD_STR_RESET)) == 0) return CMD_RESET;
-    if (strncmp(cmdStr, CMD_STR_HOME, strlen(CMD_STR_HOME)) == 0) return CMD_HOME;
-    if (strncmp(cmdStr, CMD_STR_PAUSE, strlen(CMD_STR_PAUSE)) == 0) return CMD_PAUSE;
-    if (strncmp(cmdStr, CMD_STR_RESUME, strlen(CMD_STR_RESUME)) == 0) return CMD_RESUME;
-    if (strncmp(cmdStr, CMD_STR_CANCEL, strlen(CMD_STR_CANCEL)) == 0) return CMD_CANCEL;
-    if (strncmp(cmdStr, CMD_STR_ENABLE, strlen(CMD_STR_ENABLE)) == 0) return CMD_ENABLE;
-    if (strncmp(cmdStr, CMD_STR_DISABLE, strlen(CMD_STR_DISABLE)) == 0) return CMD_DISABLE;
+    // Exact match on the first token: switch on its first character and length, then
+    // compare the few names left (no prefix ordering to keep right)
+    size_t len = strcspn(cmdStr, " ");
+    switch (cmdStr[0]) {
+        case 'D':
+            switch (len) {
+                case 15:
+                    if (commandTokenIs(cmdStr, CMD_STR_DISCOVER_DEVICE, sizeof(CMD_STR_DISCOVER_DEVICE) - 1)) return CMD_DISCOVER_DEVICE;
+                    break;
+            }
+            break;
+        case 'b':
+            switch (len) {
+                case 10:
+                    if (commandTokenIs(cmdStr, CMD_STR_BACKUP_NVM, sizeof(CMD_STR_BACKUP_NVM) - 1)) return CMD_BACKUP_NVM;
+                    break;
+            }
+            break;
+        case 'c':
+            switch (len) {
+                case 4:
+                    if (commandTokenIs(cmdStr, CMD_STR_CMDB, sizeof(CMD_STR_CMDB) - 1)) return CMD_CMDB;
+                    break;
+                case 6:
+                    if (commandTokenIs(cmdStr, CMD_STR_CANCEL, sizeof(CMD_STR_CANCEL) - 1)) return CMD_CANCEL;
+                    break;
+            }
+            break;
+        case 'd':
+            switch (len) {
+                case 7:
+                    if (commandTokenIs(cmdStr, CMD_STR_DISABLE, sizeof(CMD_STR_DISABLE) - 1)) return CMD_DISABLE;
+                    break;
+                case 8:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_NVM, sizeof(CMD_STR_DUMP_NVM) - 1)) return CMD_DUMP_NVM;
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_MEM, sizeof(CMD_STR_DUMP_MEM) - 1)) return CMD_DUMP_MEM;
+                    break;
+                case 9:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_PERF, sizeof(CMD_STR_DUMP_PERF) - 1)) return CMD_DUMP_PERF;
+                    break;
+                case 10:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_TRACE, sizeof(CMD_STR_DUMP_TRACE) - 1)) return CMD_DUMP_TRACE;
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_CRASH, sizeof(CMD_STR_DUMP_CRASH) - 1)) return CMD_DUMP_CRASH;
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_CURVE, sizeof(CMD_STR_DUMP_CURVE) - 1)) return CMD_DUMP_CURVE;
+                    break;
+                case 12:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_CAPTURE, sizeof(CMD_STR_DUMP_CAPTURE) - 1)) return CMD_DUMP_CAPTURE;
+                    break;
+                case 14:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_ERROR_LOG, sizeof(CMD_STR_DUMP_ERROR_LOG) - 1)) return CMD_DUMP_ERROR_LOG;
+                    if (commandTokenIs(cmdStr, CMD_STR_DELETE_PROFILE, sizeof(CMD_STR_DELETE_PROFILE) - 1)) return CMD_DELETE_PROFILE;
+                    break;
+                case 15:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_PRODUCTION, sizeof(CMD_STR_DUMP_PRODUCTION) - 1)) return CMD_DUMP_PRODUCTION;
+                    break;
+                case 16:
+                    if (commandTokenIs(cmdStr, CMD_STR_DUMP_CYCLE_TIMES, sizeof(CMD_STR_DUMP_CYCLE_TIMES) - 1)) return CMD_DUMP_CYCLE_TIMES;
+                    break;
+            }
+            break;
+        case 'e':
+            switch (len) {
+                case 6:
+                    if (commandTokenIs(cmdStr, CMD_STR_ENABLE, sizeof(CMD_STR_ENABLE) - 1)) return CMD_ENABLE;
+                    break;
+            }
+            break;
+        case 'f':
+            switch (len) {
+                case 9:
+                    if (commandTokenIs(cmdStr, CMD_STR_FW_UPDATE, sizeof(CMD_STR_FW_UPDATE) - 1)) return CMD_FW_UPDATE;
+                    break;
+                case 12:
+                    if (commandTokenIs(cmdStr, CMD_STR_FORCE_REPLAY, sizeof(CMD_STR_FORCE_REPLAY) - 1)) return CMD_FORCE_REPLAY;
+                    break;
+                case 14:
+                    if (commandTokenIs(cmdStr, CMD_STR_FIT_STRAIN_CAL, sizeof(CMD_STR_FIT_STRAIN_CAL) - 1)) return CMD_FIT_STRAIN_CAL;
+                    break;
+            }
+            break;
+        case 'h':
+            switch (len) {
+                case 4:
+                    if (commandTokenIs(cmdStr, CMD_STR_HOME, sizeof(CMD_STR_HOME) - 1)) return CMD_HOME;
+                    break;
+                case 12:
+                    if (commandTokenIs(cmdStr, CMD_STR_HOME_ON_BOOT, sizeof(CMD_STR_HOME_ON_BOOT) - 1)) return CMD_HOME_ON_BOOT;
+                    break;
+            }
+            break;
+        case 'm':
+            switch (len) {
+                case 8:
+                    if (commandTokenIs(cmdStr, CMD_STR_MOVE_ABS, sizeof(CMD_STR_MOVE_ABS) - 1)) return CMD_MOVE_ABS;
+                    if (commandTokenIs(cmdStr, CMD_STR_MOVE_INC, sizeof(CMD_STR_MOVE_INC) - 1)) return CMD_MOVE_INC;
+                    break;
+            }
+            break;
+        case 'p':
+            switch (len) {
+                case 5:
+                    if (commandTokenIs(cmdStr, CMD_STR_PAUSE, sizeof(CMD_STR_PAUSE) - 1)) return CMD_PAUSE;
+                    break;
+            }
+            break;
+        case 'q':
+            switch (len) {
+                case 9:
+                    if (commandTokenIs(cmdStr, CMD_STR_QUEUE_RUN, sizeof(CMD_STR_QUEUE_RUN) - 1)) return CMD_QUEUE_RUN;
+                    break;
+                case 10:
+                    if (commandTokenIs(cmdStr, CMD_STR_QUEUE_MOVE, sizeof(CMD_STR_QUEUE_MOVE) - 1)) return CMD_QUEUE_MOVE;
+                    break;
+                case 11:
+                    if (commandTokenIs(cmdStr, CMD_STR_QUEUE_CLEAR, sizeof(CMD_STR_QUEUE_CLEAR) - 1)) return CMD_QUEUE_CLEAR;
+                    break;
+            }
+            break;
+        case 'r':
+            switch (len) {
+                case 5:
+                    if (commandTokenIs(cmdStr, CMD_STR_RESET, sizeof(CMD_STR_RESET) - 1)) return CMD_RESET;
+                    break;
+                case 6:
+                    if (commandTokenIs(cmdStr, CMD_STR_RESUME, sizeof(CMD_STR_RESUME) - 1)) return CMD_RESUME;
+                    break;
+                case 7:
+                    if (commandTokenIs(cmdStr, CMD_STR_RETRACT, sizeof(CMD_STR_RETRACT) - 1)) return CMD_RETRACT;
+                    break;
+                case 9:
+                    if (commandTokenIs(cmdStr, CMD_STR_RESET_NVM, sizeof(CMD_STR_RESET_NVM) - 1)) return CMD_RESET_NVM;
+                    break;
+                case 10:
+                    if (commandTokenIs(cmdStr, CMD_STR_RECIPE_NEW, sizeof(CMD_STR_RECIPE_NEW) - 1)) return CMD_RECIPE_NEW;
+                    if (commandTokenIs(cmdStr, CMD_STR_RECIPE_ADD, sizeof(CMD_STR_RECIPE_ADD) - 1)) return CMD_RECIPE_ADD;
+                    if (commandTokenIs(cmdStr, CMD_STR_RUN_RECIPE, sizeof(CMD_STR_RUN_RECIPE) - 1)) return CMD_RUN_RECIPE;
+                    break;
+                case 11:
+                    if (commandTokenIs(cmdStr, CMD_STR_RECIPE_SAVE, sizeof(CMD_STR_RECIPE_SAVE) - 1)) return CMD_RECIPE_SAVE;
+                    if (commandTokenIs(cmdStr, CMD_STR_RESTORE_NVM, sizeof(CMD_STR_RESTORE_NVM) - 1)) return CMD_RESTORE_NVM;
+                    break;
+                case 12:
+                    if (commandTokenIs(cmdStr, CMD_STR_RECIPE_LEARN, sizeof(CMD_STR_RECIPE_LEARN) - 1)) return CMD_RECIPE_LEARN;
+                    if (commandTokenIs(cmdStr, CMD_STR_RECIPE_ZONES, sizeof(CMD_STR_RECIPE_ZONES) - 1)) return CMD_RECIPE_ZONES;
+                    break;
+                case 15:
+                    if (commandTokenIs(cmdStr, CMD_STR_RECIPE_ENVELOPE, sizeof(CMD_STR_RECIPE_ENVELOPE) - 1)) return CMD_RECIPE_ENVELOPE;
+                    break;
+                case 16:
+                    if (commandTokenIs(cmdStr, CMD_STR_RESET_PRODUCTION, sizeof(CMD_STR_RESET_PRODUCTION) - 1)) return CMD_RESET_PRODUCTION;
+                    break;
+                case 17:
+                    if (commandTokenIs(cmdStr, CMD_STR_REBOOT_BOOTLOADER, sizeof(CMD_STR_REBOOT_BOOTLOADER) - 1)) return CMD_REBOOT_BOOTLOADER;
+                    break;
+            }
+            break;
+        case 's':
+            switch (len) {
+                case 8:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_SYNC, sizeof(CMD_STR_SET_SYNC) - 1)) return CMD_SET_SYNC;
+                    break;
+                case 9:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_DEBUG, sizeof(CMD_STR_SET_DEBUG) - 1)) return CMD_SET_DEBUG;
+                    break;
+                case 11:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_ENCODER, sizeof(CMD_STR_SET_ENCODER) - 1)) return CMD_SET_ENCODER;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_RETRACT, sizeof(CMD_STR_SET_RETRACT) - 1)) return CMD_SET_RETRACT;
+                    break;
+                case 12:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_POLARITY, sizeof(CMD_STR_SET_POLARITY) - 1)) return CMD_SET_POLARITY;
+                    if (commandTokenIs(cmdStr, CMD_STR_SAVE_PROFILE, sizeof(CMD_STR_SAVE_PROFILE) - 1)) return CMD_SAVE_PROFILE;
+                    break;
+                case 13:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_TELEMETRY, sizeof(CMD_STR_SET_TELEMETRY) - 1)) return CMD_SET_TELEMETRY;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_LOG_LEVEL, sizeof(CMD_STR_SET_LOG_LEVEL) - 1)) return CMD_SET_LOG_LEVEL;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_USB_ROUTE, sizeof(CMD_STR_SET_USB_ROUTE) - 1)) return CMD_SET_USB_ROUTE;
+                    break;
+                case 14:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_ZERO, sizeof(CMD_STR_SET_FORCE_ZERO) - 1)) return CMD_SET_FORCE_ZERO;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_MODE, sizeof(CMD_STR_SET_FORCE_MODE) - 1)) return CMD_SET_FORCE_MODE;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_STRAIN_CAL, sizeof(CMD_STR_SET_STRAIN_CAL) - 1)) return CMD_SET_STRAIN_CAL;
+                    if (commandTokenIs(cmdStr, CMD_STR_SELECT_PROFILE, sizeof(CMD_STR_SELECT_PROFILE) - 1)) return CMD_SELECT_PROFILE;
+                    break;
+                case 15:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_SCALE, sizeof(CMD_STR_SET_FORCE_SCALE) - 1)) return CMD_SET_FORCE_SCALE;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_TABLE, sizeof(CMD_STR_SET_FORCE_TABLE) - 1)) return CMD_SET_FORCE_TABLE;
+                    break;
+                case 16:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_OFFSET, sizeof(CMD_STR_SET_FORCE_OFFSET) - 1)) return CMD_SET_FORCE_OFFSET;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_FILTER, sizeof(CMD_STR_SET_FORCE_FILTER) - 1)) return CMD_SET_FORCE_FILTER;
+                    break;
+                case 17:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_LATENCY, sizeof(CMD_STR_SET_FORCE_LATENCY) - 1)) return CMD_SET_FORCE_LATENCY;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_FORCE_CHANNEL, sizeof(CMD_STR_SET_FORCE_CHANNEL) - 1)) return CMD_SET_FORCE_CHANNEL;
+                    break;
+                case 18:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_MOTION_PROFILE, sizeof(CMD_STR_SET_MOTION_PROFILE) - 1)) return CMD_SET_MOTION_PROFILE;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_DRIVE_GEOMETRY, sizeof(CMD_STR_SET_DRIVE_GEOMETRY) - 1)) return CMD_SET_DRIVE_GEOMETRY;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_RAPID_TRAVERSE, sizeof(CMD_STR_SET_RAPID_TRAVERSE) - 1)) return CMD_SET_RAPID_TRAVERSE;
+                    break;
+                case 19:
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_TORQUE_FRICTION, sizeof(CMD_STR_SET_TORQUE_FRICTION) - 1)) return CMD_SET_TORQUE_FRICTION;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_PRESS_THRESHOLD, sizeof(CMD_STR_SET_PRESS_THRESHOLD) - 1)) return CMD_SET_PRESS_THRESHOLD;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_TELEMETRY_DELTA, sizeof(CMD_STR_SET_TELEMETRY_DELTA) - 1)) return CMD_SET_TELEMETRY_DELTA;
+                    if (commandTokenIs(cmdStr, CMD_STR_SET_TELEMETRY_BURST, sizeof(CMD_STR_SET_TELEMETRY_BURST) - 1)) return CMD_SET_TELEMETRY_BURST;
+                    if (commandTokenIs(cmdStr, CMD_STR_SUBSCRIBE_TELEMETRY, sizeof(CMD_STR_SUBSCRIBE_TELEMETRY) - 1)) return CMD_SUBSCRIBE_TELEMETRY;
+                    break;
+            }
+            break;
+        case 't':
+            switch (len) {
+                case 13:
+                    if (commandTokenIs(cmdStr, CMD_STR_TEST_WATCHDOG, sizeof(CMD_STR_TEST_WATCHDOG) - 1)) return CMD_TEST_WATCHDOG;
+                    break;
+            }
+            break;
+        case 'u':
+            switch (len) {
+                case 21:
+                    if (commandTokenIs(cmdStr, CMD_STR_UNSUBSCRIBE_TELEMETRY, sizeof(CMD_STR_UNSUBSCRIBE_TELEMETRY) - 1)) return CMD_UNSUBSCRIBE_TELEMETRY;
+                    break;
+            }
+            break;
+    }
     return CMD_UNKNOWN;
 }
 
 const char* getCommandParams(const char* cmdStr, Command cmd) {
     switch (cmd) {
         case CMD_MOVE_ABS:
-            return cmdStr + strlen(CMD_STR_MOVE_ABS);
+            return cmdStr + sizeof(CMD_STR_MOVE_ABS) - 1;
         case CMD_MOVE_INC:
-            return cmdStr + strlen(CMD_STR_MOVE_INC);
+            return cmdStr + sizeof(CMD_STR_MOVE_INC) - 1;
+        case CMD_QUEUE_MOVE:
+            return cmdStr + sizeof(CMD_STR_QUEUE_MOVE) - 1;
+        case CMD_RECIPE_NEW:
+            return cmdStr + sizeof(CMD_STR_RECIPE_NEW) - 1;
+        case CMD_RECIPE_ADD:
+            return cmdStr + sizeof(CMD_STR_RECIPE_ADD) - 1;
+        case CMD_RECIPE_LEARN:
+            return cmdStr + sizeof(CMD_STR_RECIPE_LEARN) - 1;
+        case CMD_RUN_RECIPE:
+            return cmdStr + sizeof(CMD_STR_RUN_RECIPE) - 1;
+        case CMD_RECIPE_ENVELOPE:
+            return cmdStr + sizeof(CMD_STR_RECIPE_ENVELOPE) - 1;
+        case CMD_RECIPE_ZONES:
+            return cmdStr + sizeof(CMD_STR_RECIPE_ZONES) - 1;
         case CMD_SET_FORCE_MODE:
-            return cmdStr + strlen(CMD_STR_SET_FORCE_MODE);
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_MODE) - 1;
         case CMD_SET_RETRACT:
-            return cmdStr + strlen(CMD_STR_SET_RETRACT);
+            return cmdStr + sizeof(CMD_STR_SET_RETRACT) - 1;
         case CMD_RETRACT:
-            return cmdStr + strlen(CMD_STR_RETRACT);
+            return cmdStr + sizeof(CMD_STR_RETRACT) - 1;
         case CMD_SET_FORCE_OFFSET:
-            return cmdStr + strlen(CMD_STR_SET_FORCE_OFFSET);
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_OFFSET) - 1;
         case CMD_SET_FORCE_SCALE:
-            return cmdStr + strlen(CMD_STR_SET_FORCE_SCALE);
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_SCALE) - 1;
         case CMD_SET_STRAIN_CAL:
-            return cmdStr + strlen(CMD_STR_SET_STRAIN_CAL);
+            return cmdStr + sizeof(CMD_STR_SET_STRAIN_CAL) - 1;
         case CMD_SET_POLARITY:
-            return cmdStr + strlen(CMD_STR_SET_POLARITY);
+            return cmdStr + sizeof(CMD_STR_SET_POLARITY) - 1;
         case CMD_HOME_ON_BOOT:
-            return cmdStr + strlen(CMD_STR_HOME_ON_BOOT);
+            return cmdStr + sizeof(CMD_STR_HOME_ON_BOOT) - 1;
         case CMD_SET_PRESS_THRESHOLD:
-            return cmdStr + strlen(CMD_STR_SET_PRESS_THRESHOLD);
+            return cmdStr + sizeof(CMD_STR_SET_PRESS_THRESHOLD) - 1;
+        case CMD_SET_FORCE_FILTER:
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_FILTER) - 1;
+        case CMD_SET_FORCE_TABLE:
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_TABLE) - 1;
+        case CMD_SET_FORCE_LATENCY:
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_LATENCY) - 1;
+        case CMD_SET_FORCE_CHANNEL:
+            return cmdStr + sizeof(CMD_STR_SET_FORCE_CHANNEL) - 1;
+        case CMD_SET_MOTION_PROFILE:
+            return cmdStr + sizeof(CMD_STR_SET_MOTION_PROFILE) - 1;
+        case CMD_SET_ENCODER:
+            return cmdStr + sizeof(CMD_STR_SET_ENCODER) - 1;
+        case CMD_SET_DRIVE_GEOMETRY:
+            return cmdStr + sizeof(CMD_STR_SET_DRIVE_GEOMETRY) - 1;
+        case CMD_SET_RAPID_TRAVERSE:
+            return cmdStr + sizeof(CMD_STR_SET_RAPID_TRAVERSE) - 1;
+        case CMD_SET_DEBUG:
+            return cmdStr + sizeof(CMD_STR_SET_DEBUG) - 1;
+        case CMD_SET_TELEMETRY:
+            return cmdStr + sizeof(CMD_STR_SET_TELEMETRY) - 1;
+        case CMD_SET_TELEMETRY_DELTA:
+            return cmdStr + sizeof(CMD_STR_SET_TELEMETRY_DELTA) - 1;
+        case CMD_SET_TELEMETRY_BURST:
+            return cmdStr + sizeof(CMD_STR_SET_TELEMETRY_BURST) - 1;
+        case CMD_SUBSCRIBE_TELEMETRY:
+            return cmdStr + sizeof(CMD_STR_SUBSCRIBE_TELEMETRY) - 1;
+        case CMD_UNSUBSCRIBE_TELEMETRY:
+            return cmdStr + sizeof(CMD_STR_UNSUBSCRIBE_TELEMETRY) - 1;
+        case CMD_SET_USB_ROUTE:
+            return cmdStr + sizeof(CMD_STR_SET_USB_ROUTE) - 1;
+        case CMD_SET_TORQUE_FRICTION:
+            return cmdStr + sizeof(CMD_STR_SET_TORQUE_FRICTION) - 1;
+        case CMD_SAVE_PROFILE:
+            return cmdStr + sizeof(CMD_STR_SAVE_PROFILE) - 1;
+        case CMD_SELECT_PROFILE:
+            return cmdStr + sizeof(CMD_STR_SELECT_PROFILE) - 1;
+        case CMD_DELETE_PROFILE:
+            return cmdStr + sizeof(CMD_STR_DELETE_PROFILE) - 1;
+        case CMD_RESTORE_NVM:
+            return cmdStr + sizeof(CMD_STR_RESTORE_NVM) - 1;
+        case CMD_FORCE_REPLAY:
+            return cmdStr + sizeof(CMD_STR_FORCE_REPLAY) - 1;
+        case CMD_FW_UPDATE:
+            return cmdStr + sizeof(CMD_STR_FW_UPDATE) - 1;
+        case CMD_CMDB:
+            return cmdStr + sizeof(CMD_STR_CMDB) - 1;
         default:
             return NULL;
     }
-}
\ No newline at end of file
+}
+
+bool isUrgentCommand(Command cmd) {
+    return cmd == CMD_PAUSE || cmd == CMD_CANCEL || cmd == CMD_RESET;
+}
+
+bool isFlushingCommand(Command cmd) {
+    return cmd == CMD_CANCEL || cmd == CMD_RESET;
+}
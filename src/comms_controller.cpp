@@ -10,24 +10,110 @@
  */
 #include "comms_controller.h"
 #include "config.h"    // For WATCHDOG_ENABLED and breadcrumb definitions
+#include "base64.h"
 #include "error_log.h"
+#include "events.h"
 #include "pressboi.h"  // For watchdog access
+#include "text_format.h"
+#include "trace_log.h"
+#include "lwip/dhcp.h"
+#include "lwip/etharp.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
 #include <sam.h>       // For WDT register access
 
-CommsController::CommsController() {
+static_assert(RX_ARENA_SIZE <= 0xFFFF && TX_ARENA_SIZE <= 0xFFFF && TX_BULK_ARENA_SIZE <= 0xFFFF,
+              "Message arena offsets are 16-bit");
+static_assert(RX_ARENA_SIZE >= MAX_MESSAGE_LENGTH && TX_ARENA_SIZE >= MAX_MESSAGE_LENGTH &&
+              TX_TELEMETRY_ARENA_SIZE >= MAX_MESSAGE_LENGTH && TX_BULK_ARENA_SIZE >= MAX_MESSAGE_LENGTH,
+              "Message arenas must hold the longest message");
+static_assert(UDP_RX_BUDGET_US < LOOP_TASK_COMMS_BUDGET_US, "UDP ingest must fit in the comms task budget");
+static_assert(UDP_RX_PBUF_QUEUE <= 0x80, "UDP receive queue indices are 8-bit");
+static_assert((USB_TX_RING_SIZE & (USB_TX_RING_SIZE - 1)) == 0 && USB_TX_RING_SIZE <= 0x8000,
+              "USB TX ring size must be a power of two with 16-bit indices");
+static_assert(MAX_MESSAGE_LENGTH * 2 + USB_TX_CONTROL_RESERVE < USB_TX_RING_SIZE,
+              "USB TX ring must hold a framed full-size message above the control reserve");
+
+// 127.0.0.1 as IpAddress stores it (network byte order), for the cheap destination check
+static const uint32_t UDP_LOOPBACK_ADDR = PP_HTONL(IPADDR_LOOPBACK);
+
+CommsController::CommsController()
+	: m_bulkServer(BULK_TCP_PORT),
+	  m_rxQueue(m_rxArena, RX_ARENA_SIZE, m_rxSlots, RX_QUEUE_SIZE),
+	  m_rxUrgentQueue(m_rxUrgentArena, RX_URGENT_ARENA_SIZE, m_rxUrgentSlots, RX_URGENT_QUEUE_SIZE),
+	  m_txQueue{ MessageRing(m_txArena, TX_ARENA_SIZE, m_txSlots, TX_QUEUE_SIZE),
+	             MessageRing(m_txTelemetryArena, TX_TELEMETRY_ARENA_SIZE, m_txTelemetrySlots, TX_TELEMETRY_QUEUE_SIZE),
+	             MessageRing(m_txBulkArena, TX_BULK_ARENA_SIZE, m_txBulkSlots, TX_BULK_QUEUE_SIZE) } {
 	m_guiDiscovered = false;
 	m_guiPort = 0;
-	
-	m_rxQueueHead = 0;
-	m_rxQueueTail = 0;
-	m_txQueueHead = 0;
-	m_txQueueTail = 0;
+	m_netState = NET_STATE_LINK_WAIT;
+	m_netStateStart = 0;
+	m_udpPcb = nullptr;
+	m_udpTxRef = nullptr;
+	ip_addr_set_zero(&m_udpDestIp);
+	m_udpDestPort = 0;
+	m_udpBatching = false;
+	m_udpBatchLength = 0;
+	m_udpBatchPort = 0;
+	memset(m_telemetrySubscribers, 0, sizeof(m_telemetrySubscribers));
+	m_arpRequestMs = 0;
+	m_arpHoldIp = IpAddress(0, 0, 0, 0);
+	m_arpHoldStartMs = 0;
+	m_arpRefreshMs = 0;
+	m_arpRefreshNext = 0;
+	for (int i = 0; i < UDP_RX_PBUF_QUEUE; i++) {
+		m_udpRx[i].packet = nullptr;
+		m_udpRx[i].remotePort = 0;
+	}
+	m_udpRxTail = 0;
+	m_udpRxCount = 0;
+	m_udpRxMaxPerPass = 0;
+	m_udpRxDatagrams = 0;
+	m_udpRxDropped = 0;
+	m_rxDropped = 0;
+	m_rxUrgent = 0;
+	m_rxFlushed = 0;
+	m_rxPeekUrgent = false;
+	m_rxStage = NULL;
+	memset(m_txDropped, 0, sizeof(m_txDropped));
+	m_telemetryReplaced = 0;
+	m_usbSkipped = 0;
+	m_usbTimeouts = 0;
+	m_udpSendErrors = 0;
+	m_statsMs = 0;
+	m_bulkTxLength = 0;
+	m_bulkRxLength = 0;
+	m_usbRxLength = 0;
+	m_usbRxOverlong = false;
+	m_usbRxLastMs = 0;
+	memset(m_recentRequestAddr, 0, sizeof(m_recentRequestAddr));
+	memset(m_recentRequestId, 0, sizeof(m_recentRequestId));
+	m_recentRequestNext = 0;
+	m_txReserveLane = TX_LANE_CONTROL;
+	m_usbTxHead = 0;
+	m_usbTxTail = 0;
+	m_usbFraming = USB_FRAMING_LINES;
+	m_usbRoute = USB_ROUTE_ALL;
+
+	// Fixed for the life of the firmware; the discovery reply copies it instead of formatting it
+	size_t identity = append_str(m_identity, sizeof(m_identity), 0, "DEVICE_ID=" DEVICE_NAME_LOWER " PORT=");
+	identity = append_uint(m_identity, sizeof(m_identity), identity, LOCAL_PORT);
+	identity = append_str(m_identity, sizeof(m_identity), identity, " FW=" FIRMWARE_VERSION);
+	m_identityLength = (uint16_t)identity;
+	#if ANNOUNCE_ENABLED
+	m_announce[0] = '\0';
+	m_announceLength = 0;
+	m_announceDueMs = 0;
+	m_announceRandom = 1;
+	#endif
 	
 	// USB host health tracking - start pessimistic (wait for first sign of host)
 	m_lastUsbHealthy = 0;
 	m_usbHostConnected = false;
 	
-	g_errorLog.log(LOG_INFO, "CommsController initialized");
+	ERROR_LOG(LOG_INFO, "CommsController initialized");
 }
 
 void CommsController::setup() {
@@ -44,98 +130,596 @@ void CommsController::setup() {
 }
 
 void CommsController::update() {
-	#if WATCHDOG_ENABLED
-	g_watchdogBreadcrumb = WD_BREADCRUMB_UDP_PROCESS;
-	#endif
-	processUdp();
+	updateRx();
+	updateTx(0);
+}
+
+void CommsController::updateRx() {
+	if (m_netState == NET_STATE_READY) {
+		#if WATCHDOG_ENABLED
+		g_watchdogBreadcrumb = WD_BREADCRUMB_UDP_PROCESS;
+		#endif
+		processUdp();
+	} else {
+		serviceNetwork();
+	}
 	
 	#if WATCHDOG_ENABLED
 	g_watchdogBreadcrumb = WD_BREADCRUMB_USB_PROCESS;
 	#endif
 	processUsbSerial();
-	
+	if (m_netState == NET_STATE_READY) {
+		processBulkTcp();
+	}
+}
+
+void CommsController::updateTx(uint32_t budget_us) {
 	#if WATCHDOG_ENABLED
 	g_watchdogBreadcrumb = WD_BREADCRUMB_TX_QUEUE;
 	#endif
-	processTxQueue();
+	processTxQueue(budget_us);
+	serviceStats();
+	if (isNetworkReady()) {
+		serviceArpRefresh();
+		#if ANNOUNCE_ENABLED
+		serviceAnnounce();
+		#endif
+	}
 }
 
 bool CommsController::enqueueRx(const char* msg, const IpAddress& ip, uint16_t port) {
+	return enqueueRx(msg, strnlen(msg, MAX_MESSAGE_LENGTH - 1), ip, port);
+}
+
+bool CommsController::enqueueRx(const char* msg, size_t length, const IpAddress& ip, uint16_t port) {
 	#if WATCHDOG_ENABLED
 	g_watchdogBreadcrumb = WD_BREADCRUMB_RX_ENQUEUE;
 	#endif
 	
-	int next_head = (m_rxQueueHead + 1) % RX_QUEUE_SIZE;
-	if (next_head == m_rxQueueTail) {
-		if(m_guiDiscovered && EthernetMgr.PhyLinkActive()) {
-			char errorMsg[128];
-			snprintf(errorMsg, sizeof(errorMsg), "%s_ERROR: RX QUEUE OVERFLOW - COMMAND DROPPED", DEVICE_NAME_UPPER);
-			m_udp.Connect(m_guiIp, m_guiPort);
-			m_udp.PacketWrite(errorMsg);
-			m_udp.PacketSend();
+	Command command = classifyRx(msg);
+	if (isUrgentCommand(command)) {
+		// Everything queued ahead of a cancel or reset was sent before the stop; none of it
+		// may start after it. Only the command task reads the queue, and never while this runs.
+		if (isFlushingCommand(command) && m_rxQueue.getCount() > 0) {
+			uint16_t flushed = (uint16_t)m_rxQueue.getCount();
+			m_rxQueue.clear();
+			m_rxFlushed += flushed;
+			ERROR_LOGF(LOG_WARNING, "RX: %u queued command(s) discarded by %s", (unsigned)flushed,
+			           command == CMD_CANCEL ? "cancel" : "reset");
+		}
+		if (m_rxUrgentQueue.push(msg, length, ip, port)) {
+			m_rxUrgent++;
+			return true;
 		}
+		// Urgent queue full (a burst of repeats): the RX queue, now empty for a flush, takes it
+	}
+	if (!m_rxQueue.push(msg, length, ip, port)) {
+		TRACE(TRACE_QUEUE_OVERFLOW, 0, 0);
+		m_rxDropped++;
 		return false;
 	}
-	strncpy(m_rxQueue[m_rxQueueHead].buffer, msg, MAX_MESSAGE_LENGTH);
-	m_rxQueue[m_rxQueueHead].buffer[MAX_MESSAGE_LENGTH - 1] = '\0';
-	m_rxQueue[m_rxQueueHead].remoteIp = ip;
-	m_rxQueue[m_rxQueueHead].remotePort = port;
-	m_rxQueueHead = next_head;
 	return true;
 }
 
+Command CommsController::classifyRx(const char* text) {
+	const char* command;
+	parseRequestId(text, &command);
+	Command cmd = parseCommand(command);
+	if (cmd == CMD_CMDB) {
+		// The first base64 quantum holds the frame's command byte
+		const char* frame = strchr(command, ' ');
+		char quantum[5];
+		uint8_t bytes[3];
+		size_t n = (frame != NULL) ? strnlen(frame + 1, 4) : 0;
+		memcpy(quantum, frame + 1, n);
+		quantum[n] = '\0';
+		cmd = (n == 4 && base64Decode(quantum, bytes, sizeof(bytes)) > 0 && bytes[0] < CMD_COUNT)
+		          ? static_cast<Command>(bytes[0]) : CMD_UNKNOWN;
+	}
+	return cmd;
+}
+
 bool CommsController::dequeueRx(Message& msg) {
-	if (m_rxQueueHead == m_rxQueueTail) {
+	MessageView view;
+	if (!peekRx(view)) {
 		return false;
 	}
-	msg = m_rxQueue[m_rxQueueTail];
-	m_rxQueueTail = (m_rxQueueTail + 1) % RX_QUEUE_SIZE;
+	memcpy(msg.buffer, view.buffer, strlen(view.buffer) + 1);
+	msg.remoteIp = view.remoteIp;
+	msg.remotePort = view.remotePort;
+	consumeRx();
 	return true;
 }
 
-bool CommsController::enqueueTx(const char* msg, const IpAddress& ip, uint16_t port) {
-	int next_head = (m_txQueueHead + 1) % TX_QUEUE_SIZE;
-	if (next_head == m_txQueueTail) {
-		if(m_guiDiscovered && EthernetMgr.PhyLinkActive()) {
-			char errorMsg[128];
-			snprintf(errorMsg, sizeof(errorMsg), "%s_ERROR: TX QUEUE OVERFLOW - MESSAGE DROPPED", DEVICE_NAME_UPPER);
-			m_udp.Connect(m_guiIp, m_guiPort);
-			m_udp.PacketWrite(errorMsg);
-			m_udp.PacketSend();
+bool CommsController::peekRx(MessageView& msg) const {
+	const MessageRing& queue = (m_rxUrgentQueue.getCount() > 0) ? m_rxUrgentQueue : m_rxQueue;
+	const MessageSlot* slot = queue.front();
+	if (slot == NULL) {
+		return false;
+	}
+	m_rxPeekUrgent = (&queue == &m_rxUrgentQueue);
+	msg.buffer = queue.text(*slot);
+	msg.remoteIp = slot->remoteIp;
+	msg.remotePort = slot->remotePort;
+	return true;
+}
+
+void CommsController::consumeRx() {
+	if (m_rxPeekUrgent) {
+		m_rxUrgentQueue.pop();
+	} else {
+		m_rxQueue.pop();
+	}
+	m_rxPeekUrgent = false;
+}
+
+int CommsController::getTxQueueFree(TxLane lane) const {
+	return m_txQueue[lane].getFree(TX_SLOT_BYTES_NOMINAL);
+}
+
+char* CommsController::reserveTx(size_t capacity, TxLane lane) {
+	if (capacity > MAX_MESSAGE_LENGTH) {
+		capacity = MAX_MESSAGE_LENGTH;
+	}
+	m_txReserveLane = lane;
+	if (lane == TX_LANE_TELEMETRY) {
+		// Latest value wins: an unsent frame is stale once a newer one is being built
+		if (m_txQueue[lane].getCount() > 0) {
+			m_telemetryReplaced++;
 		}
+		m_txQueue[lane].clear();
+	}
+	char* space = m_txQueue[lane].reserve(capacity);
+	// A full bulk lane only makes its producer wait (or promote the line), so it is not a drop
+	if (space == NULL && lane != TX_LANE_BULK) {
+		TRACE(TRACE_QUEUE_OVERFLOW, 1, 0);
+		m_txDropped[lane]++;
+	}
+	return space;
+}
+
+void CommsController::commitTx(size_t length, const IpAddress& ip, uint16_t port) {
+	m_txQueue[m_txReserveLane].commit(length, ip, port);
+}
+
+bool CommsController::enqueueTx(const char* msg, const IpAddress& ip, uint16_t port, TxLane lane) {
+	size_t length = strnlen(msg, MAX_MESSAGE_LENGTH - 1);
+	if (!m_txQueue[lane].push(msg, length, ip, port)) {
+		if (lane == TX_LANE_CONTROL) {
+			TRACE(TRACE_QUEUE_OVERFLOW, 1, 0);
+		}
+		m_txDropped[lane]++;
 		return false;
 	}
-	strncpy(m_txQueue[m_txQueueHead].buffer, msg, MAX_MESSAGE_LENGTH);
-	m_txQueue[m_txQueueHead].buffer[MAX_MESSAGE_LENGTH - 1] = '\0';
-	m_txQueue[m_txQueueHead].remoteIp = ip;
-	m_txQueue[m_txQueueHead].remotePort = port;
-	m_txQueueHead = next_head;
 	return true;
 }
 
+void CommsController::serviceStats() {
+	uint32_t now = Milliseconds();
+	if (COMMS_STATS_INTERVAL_MS == 0 || now - m_statsMs < COMMS_STATS_INTERVAL_MS) {
+		return;
+	}
+	m_statsMs = now;
+	char* line = reserveTx(STATUS_MESSAGE_BUFFER_SIZE, TX_LANE_BULK);
+	if (line == NULL) {
+		return;
+	}
+	// Format: PRESSBOI_COMMS: rx_peak:<n>,rx_drops:<n>,...  (counts since boot)
+	size_t len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, 0, TELEM_COMMS_PREFIX "rx_peak:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_rxQueue.getPeakCount());
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",rx_drops:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_rxDropped);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",udp_rx_drops:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_udpRxDropped);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",ctl_peak:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_txQueue[TX_LANE_CONTROL].getPeakCount());
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",ctl_drops:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_txDropped[TX_LANE_CONTROL]);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",tlm_replaced:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_telemetryReplaced);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",tlm_drops:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_txDropped[TX_LANE_TELEMETRY]);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",bulk_peak:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_txQueue[TX_LANE_BULK].getPeakCount());
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",bulk_drops:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_txDropped[TX_LANE_BULK]);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",usb_skips:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_usbSkipped);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",usb_timeouts:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_usbTimeouts);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",udp_errors:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_udpSendErrors);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",rx_urgent:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_rxUrgent);
+	len = append_str(line, STATUS_MESSAGE_BUFFER_SIZE, len, ",rx_flushed:");
+	len = append_uint(line, STATUS_MESSAGE_BUFFER_SIZE, len, m_rxFlushed);
+	IpAddress targetIp = m_guiDiscovered ? m_guiIp : IpAddress(0, 0, 0, 0);
+	uint16_t targetPort = m_guiDiscovered ? m_guiPort : 0;
+	commitTx(len, targetIp, targetPort);
+}
+
+void CommsController::sendUdp(const IpAddress& ip, uint16_t port, const char* text, uint16_t length) {
+	// The driver may still hold the pbuf if a send ever had to queue it; allocate a fresh
+	// one then rather than repointing it under lwIP's feet
+	if (m_udpPcb == nullptr || m_udpTxRef == nullptr || m_udpTxRef->ref != 1) {
+		m_udp.Connect(ip, port);
+		m_udp.PacketWrite(reinterpret_cast<const uint8_t*>(text), length);
+		if (!m_udp.PacketSend()) {
+			m_udpSendErrors++;
+		}
+		return;
+	}
+	uint32_t addr = uint32_t(ip);
+	if (port != m_udpDestPort || ip4_addr_get_u32(ip_2_ip4(&m_udpDestIp)) != addr) {
+		ip_addr_set_ip4_u32(&m_udpDestIp, addr);
+		m_udpDestPort = port;
+	}
+	m_udpTxRef->payload = const_cast<char*>(text);
+	m_udpTxRef->len = length;
+	m_udpTxRef->tot_len = length;
+	if (udp_sendto(m_udpPcb, m_udpTxRef, &m_udpDestIp, m_udpDestPort) != ERR_OK) {
+		m_udpSendErrors++;
+	}
+}
+
+void CommsController::batchUdp(const IpAddress& ip, uint16_t port, const char* text, uint16_t length) {
+	if (m_udpBatchLength > 0 &&
+	    (port != m_udpBatchPort || uint32_t(ip) != uint32_t(m_udpBatchIp) ||
+	     m_udpBatchLength + 1 + length > MAX_PACKET_LENGTH)) {
+		flushUdpBatch();
+	}
+	if (m_udpBatchLength > 0) {
+		m_udpBatch[m_udpBatchLength++] = '\n';
+	} else {
+		m_udpBatchIp = ip;
+		m_udpBatchPort = port;
+	}
+	memcpy(m_udpBatch + m_udpBatchLength, text, length);
+	m_udpBatchLength += length;
+}
+
+void CommsController::flushUdpBatch() {
+	if (m_udpBatchLength > 0) {
+		sendUdp(m_udpBatchIp, m_udpBatchPort, m_udpBatch, m_udpBatchLength);
+		m_udpBatchLength = 0;
+	}
+}
+
+void CommsController::sendUdpMessage(const IpAddress& ip, uint16_t port, const char* text, uint16_t length) {
+	if (m_udpBatching) {
+		batchUdp(ip, port, text, length);
+	} else {
+		sendUdp(ip, port, text, length);
+	}
+}
+
+bool CommsController::subscribeTelemetry(const IpAddress& ip, uint16_t port, uint32_t interval_ms, uint32_t lease_ms) {
+	TelemetrySubscriber* entry = NULL;
+	for (int i = 0; i < TELEMETRY_SUBSCRIBER_COUNT; i++) {
+		TelemetrySubscriber& sub = m_telemetrySubscribers[i];
+		if (sub.port == port && uint32_t(sub.ip) == uint32_t(ip)) {
+			entry = &sub;
+			break;
+		}
+		if (sub.port == 0 && entry == NULL) {
+			entry = &sub;
+		}
+	}
+	if (entry == NULL) {
+		return false;
+	}
+	uint32_t now = Milliseconds();
+	entry->ip = ip;
+	entry->port = port;
+	entry->interval_ms = interval_ms;
+	entry->next_due_ms = now;
+	entry->renewed_ms = now;
+	entry->lease_ms = lease_ms;
+	resolveHost(ip);
+	return true;
+}
+
+bool CommsController::unsubscribeTelemetry(const IpAddress& ip, uint16_t port) {
+	for (int i = 0; i < TELEMETRY_SUBSCRIBER_COUNT; i++) {
+		TelemetrySubscriber& sub = m_telemetrySubscribers[i];
+		if (sub.port != 0 && sub.port == port && uint32_t(sub.ip) == uint32_t(ip)) {
+			sub.port = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+int CommsController::getTelemetrySubscriberCount() const {
+	int count = 0;
+	for (int i = 0; i < TELEMETRY_SUBSCRIBER_COUNT; i++) {
+		if (m_telemetrySubscribers[i].port != 0) {
+			count++;
+		}
+	}
+	return count;
+}
+
+// The address whose MAC a datagram to ip goes to: ip itself on the local subnet, else the gateway
+static void nextHop(struct netif* netif, const IpAddress& ip, ip4_addr_t* hop) {
+	ip4_addr_set_u32(hop, uint32_t(ip));
+	if (!ip4_addr_netcmp(hop, netif_ip4_addr(netif), netif_ip4_netmask(netif))) {
+		ip4_addr_copy(*hop, *netif_ip4_gw(netif));
+	}
+}
+
+void CommsController::resolveHost(const IpAddress& ip) {
+	struct netif* netif = netif_default;
+	if (!isNetworkReady() || netif == nullptr || uint32_t(ip) == 0 || uint32_t(ip) == UDP_LOOPBACK_ADDR) {
+		return;
+	}
+	ip4_addr_t hop;
+	nextHop(netif, ip, &hop);
+	// A reply renews a stable entry as well as creating a new one
+	etharp_request(netif, &hop);
+}
+
+bool CommsController::holdForArp(const IpAddress& ip) {
+	uint32_t now = Milliseconds();
+	if (uint32_t(ip) != uint32_t(m_arpHoldIp)) {
+		m_arpHoldIp = ip;
+		m_arpHoldStartMs = now;
+	}
+	return now - m_arpHoldStartMs < UDP_ARP_HOLD_MAX_MS;
+}
+
+void CommsController::serviceArpRefresh() {
+	uint32_t now = Milliseconds();
+	if (now - m_arpRefreshMs < UDP_ARP_REFRESH_MS / (TELEMETRY_SUBSCRIBER_COUNT + 1)) {
+		return;
+	}
+	m_arpRefreshMs = now;
+	uint8_t slot = m_arpRefreshNext;
+	m_arpRefreshNext = (uint8_t)((slot + 1) % (TELEMETRY_SUBSCRIBER_COUNT + 1));
+	if (slot == 0) {
+		if (m_guiDiscovered) {
+			resolveHost(m_guiIp);
+		}
+	} else if (m_telemetrySubscribers[slot - 1].port != 0) {
+		resolveHost(m_telemetrySubscribers[slot - 1].ip);
+	}
+}
+
+bool CommsController::udpPathResolved(const IpAddress& ip) {
+	struct netif* netif = netif_default;
+	if (netif == nullptr) {
+		return false;
+	}
+	ip4_addr_t hop;
+	nextHop(netif, ip, &hop);
+	struct eth_addr* mac;
+	const ip4_addr_t* found;
+	if (etharp_find_addr(netif, &hop, &mac, &found) >= 0) {
+		return true;
+	}
+	uint32_t now = Milliseconds();
+	if (now - m_arpRequestMs >= UDP_ARP_RETRY_MS) {
+		m_arpRequestMs = now;
+		// No packet: whatever lwIP is already holding for this host stays queued
+		etharp_query(netif, &hop, NULL);
+	}
+	return false;
+}
+
+void CommsController::fanOutTelemetry(const MessageSlot& msg, const char* text) {
+	uint32_t now = Milliseconds();
+	uint32_t frameAddr = uint32_t(msg.remoteIp);
+	for (int i = 0; i < TELEMETRY_SUBSCRIBER_COUNT; i++) {
+		TelemetrySubscriber& sub = m_telemetrySubscribers[i];
+		if (sub.port == 0) {
+			continue;
+		}
+		if (now - sub.renewed_ms > sub.lease_ms) {
+			sub.port = 0;
+			continue;
+		}
+		// The discovered GUI already got this frame
+		if (sub.port == msg.remotePort && uint32_t(sub.ip) == frameAddr) {
+			continue;
+		}
+		if ((int32_t)(now - sub.next_due_ms) < 0 || !udpPathResolved(sub.ip)) {
+			continue;
+		}
+		sendUdpMessage(sub.ip, sub.port, text, msg.length);
+		// Keep the phase so a rate equal to the frame rate never skips frames on jitter,
+		// but don't try to catch up after a gap
+		sub.next_due_ms += sub.interval_ms;
+		if ((int32_t)(now - sub.next_due_ms) >= 0) {
+			sub.next_due_ms = now + sub.interval_ms;
+		}
+	}
+}
+
 void CommsController::processUdp() {
-	// Limit UDP packets processed per call to prevent watchdog timeout
-	// PacketParse() internally calls EthernetMgr.Refresh() which processes network packets
-	// If more packets arrive than we can process, they'll be handled next loop iteration
-	// Reduced to 1 to be extremely conservative - even 3 was causing timeouts on USB reconnection
-	const int MAX_UDP_PACKETS_PER_CALL = 1;
-	int packetsProcessed = 0;
+	if (m_udpPcb == nullptr) {
+		// No pcb of our own to receive on: one datagram per poll through EthernetUdp, whose
+		// PacketParse() runs EthernetMgr.Refresh()
+		if (m_udp.PacketParse()) {
+			#if WATCHDOG_ENABLED
+			g_watchdogBreadcrumb = WD_BREADCRUMB_UDP_PACKET_READ;
+			#endif
+			IpAddress remoteIp = m_udp.RemoteIp();
+			uint16_t remotePort = m_udp.RemotePort();
+			int32_t bytesRead = m_udp.PacketRead(m_packetBuffer, MAX_PACKET_LENGTH - 1);
+			if (bytesRead > 0) {
+				m_packetBuffer[bytesRead] = '\0';
+				receiveUdpDatagram((char*)m_packetBuffer, (size_t)bytesRead, remoteIp, remotePort);
+			}
+		}
+		return;
+	}
 	
-	while (packetsProcessed < MAX_UDP_PACKETS_PER_CALL && m_udp.PacketParse()) {
+	// Refresh() hands one frame to LwIP; a burst is taken frame by frame until the budget
+	// is spent. A frame without a datagram (ARP, TCP, nothing pending) ends the poll, so an
+	// idle link costs one Refresh() as before.
+	uint32_t start = Microseconds();
+	int taken = 0;
+	for (int frames = 0; frames < UDP_RX_MAX_FRAMES_PER_PASS; frames++) {
+		if (frames > 0 && (Microseconds() - start >= UDP_RX_BUDGET_US ||
+		                   m_rxQueue.getFree(TX_SLOT_BYTES_NOMINAL) == 0)) {
+			break;
+		}
+		EthernetMgr.Refresh();
+		int datagrams = drainUdpRx();
+		if (datagrams == 0) {
+			break;
+		}
+		taken += datagrams;
+	}
+	if (taken > m_udpRxMaxPerPass) {
+		m_udpRxMaxPerPass = (uint8_t)((taken > 0xFF) ? 0xFF : taken);
+	}
+}
+
+void CommsController::udpReceive(void* arg, struct udp_pcb* pcb, struct pbuf* p, const ip_addr_t* addr, u16_t port) {
+	(void)pcb;
+	CommsController* self = static_cast<CommsController*>(arg);
+	if (self->m_udpRxCount >= UDP_RX_PBUF_QUEUE) {
+		// Only when one frame brings more datagrams than the queue holds; the host's retry
+		// recovers them
+		self->m_udpRxDropped++;
+		pbuf_free(p);
+		return;
+	}
+	UdpRxEntry& entry = self->m_udpRx[(self->m_udpRxTail + self->m_udpRxCount) % UDP_RX_PBUF_QUEUE];
+	entry.packet = p;
+	entry.remoteIp = IpAddress(ip4_addr_get_u32(ip_2_ip4(addr)));
+	entry.remotePort = port;
+	self->m_udpRxCount++;
+	self->m_udpRxDatagrams++;
+}
+
+int CommsController::drainUdpRx() {
+	int taken = 0;
+	while (m_udpRxCount > 0) {
 		#if WATCHDOG_ENABLED
 		g_watchdogBreadcrumb = WD_BREADCRUMB_UDP_PACKET_READ;
 		#endif
-		IpAddress remoteIp = m_udp.RemoteIp();
-		uint16_t remotePort = m_udp.RemotePort();
-		int32_t bytesRead = m_udp.PacketRead(m_packetBuffer, MAX_PACKET_LENGTH - 1);
-		if (bytesRead > 0) {
-			m_packetBuffer[bytesRead] = '\0';
-			if (!enqueueRx((char*)m_packetBuffer, remoteIp, remotePort)) {
-				// Error handled in enqueueRx
-			}
+		UdpRxEntry& entry = m_udpRx[m_udpRxTail];
+		// The datagram goes straight from the pbuf into RX queue space, where its commands
+		// stay until dispatched; m_packetBuffer only when the queue has no room for it.
+		// pbuf_copy_partial() walks a chained pbuf; longer datagrams are cut as PacketRead() does.
+		u16_t size = (entry.packet->tot_len < MAX_PACKET_LENGTH - 1) ? entry.packet->tot_len : MAX_PACKET_LENGTH - 1;
+		m_rxStage = m_rxQueue.reserve((size_t)size + 1);
+		char* text = (m_rxStage != NULL) ? m_rxStage : (char*)m_packetBuffer;
+		u16_t length = pbuf_copy_partial(entry.packet, text, size, 0);
+		pbuf_free(entry.packet);
+		entry.packet = nullptr;
+		m_udpRxTail = (uint8_t)((m_udpRxTail + 1) % UDP_RX_PBUF_QUEUE);
+		m_udpRxCount--;
+		taken++;
+		if (length > 0) {
+			text[length] = '\0';
+			receiveUdpDatagram(text, length, entry.remoteIp, entry.remotePort);
+		}
+		m_rxStage = NULL;
+	}
+	return taken;
+}
+
+void CommsController::receiveUdpDatagram(char* text, size_t length, const IpAddress& ip, uint16_t port) {
+	// A datagram may carry several newline-separated commands; each is queued on its own
+	// (overflow is reported by enqueueRx)
+	char* line = text;
+	char* end = text + length;
+	while (line < end) {
+		// First terminator: '\r' is only searched for ahead of the first '\n'
+		char* stop = (char*)memchr(line, '\n', end - line);
+		char* cr = (char*)memchr(line, '\r', ((stop != NULL) ? stop : end) - line);
+		if (cr != NULL) {
+			stop = cr;
 		}
-		packetsProcessed++;
+		size_t span = ((stop != NULL) ? stop : end) - line;
+		char separator = line[span];
+		line[span] = '\0';
+		if (m_rxStage != NULL && span > 0 && isUrgentCommand(classifyRx(line))) {
+			// A cancel or reset clears the RX queue whose space holds this datagram: the rest
+			// of it is split from m_packetBuffer instead
+			line[span] = separator;
+			size_t rest = end - line;
+			memcpy(m_packetBuffer, line, rest);
+			m_packetBuffer[rest] = '\0';
+			m_rxStage = NULL;
+			line = (char*)m_packetBuffer;
+			end = line + rest;
+			continue;
+		}
+		if (span > 0) {
+			receiveUdpCommand(line, span, ip, port);
+		}
+		if (stop == NULL) {
+			break;
+		}
+		line = stop + 1;
+	}
+}
+
+bool CommsController::queueRxCommand(char* line, size_t length, const IpAddress& ip, uint16_t port) {
+	if (m_rxStage == NULL) {
+		return enqueueRx(line, length, ip, port);
+	}
+	// Already in RX queue space: queued where it lies
+	if (!m_rxQueue.commitPart(line, length, ip, port)) {
+		TRACE(TRACE_QUEUE_OVERFLOW, 0, 0);
+		m_rxDropped++;
+		return false;
+	}
+	return true;
+}
+
+uint32_t CommsController::parseRequestId(const char* text, const char** rest) {
+	*rest = text;
+	if (text[0] != '#') {
+		return 0;
+	}
+	char* end;
+	unsigned long id = strtoul(text + 1, &end, 10);
+	if (end == text + 1 || *end != ' ' || id == 0 || id > 0x7FFFFFFFUL) {
+		return 0;
+	}
+	while (*end == ' ') {
+		end++;
 	}
+	*rest = end;
+	return (uint32_t)id;
+}
+
+void CommsController::receiveUdpCommand(char* line, size_t length, const IpAddress& ip, uint16_t port) {
+	const char* command;
+	uint32_t id = parseRequestId(line, &command);
+	if (id == 0) {
+		queueRxCommand(line, length, ip, port);
+		return;
+	}
+	uint32_t addr = uint32_t(ip);
+	bool duplicate = false;
+	for (int i = 0; i < RX_DEDUP_HISTORY; i++) {
+		if (m_recentRequestId[i] == id && m_recentRequestAddr[i] == addr) {
+			duplicate = true;
+			break;
+		}
+	}
+	if (!duplicate) {
+		if (!queueRxCommand(line, length, ip, port)) {
+			return;
+		}
+		m_recentRequestId[m_recentRequestNext] = id;
+		m_recentRequestAddr[m_recentRequestNext] = addr;
+		m_recentRequestNext = (uint8_t)((m_recentRequestNext + 1) % RX_DEDUP_HISTORY);
+	}
+	
+	// Acknowledge where the replies will go: the GUI's listening port if it is the sender
+	uint16_t ackPort = (m_guiDiscovered && addr == uint32_t(m_guiIp)) ? m_guiPort : port;
+	char ack[32];
+	size_t len = append_str(ack, sizeof(ack), 0, STATUS_PREFIX_ACK);
+	len = append_char(ack, sizeof(ack), len, '#');
+	append_int(ack, sizeof(ack), len, (int32_t)id);
+	enqueueTx(ack, ip, ackPort);
 }
 
 void CommsController::processUsbSerial() {
@@ -143,78 +727,112 @@ void CommsController::processUsbSerial() {
 	g_watchdogBreadcrumb = WD_BREADCRUMB_USB_AVAILABLE;
 	#endif
 	
-	static char usbBuffer[MAX_MESSAGE_LENGTH];
-	static int usbBufferIndex = 0;
 	static bool usbFirstData = false;  // Track if we've seen first data
 	
-	// Limit characters processed per call to prevent watchdog timeout (256ms)
-	int charsProcessed = 0;
-	const int MAX_CHARS_PER_CALL = 32;
-	
 	// Log when we first see data after startup
 	int available = ConnectorUsb.AvailableForRead();
 	if (available > 0 && !usbFirstData) {
-		g_errorLog.logf(LOG_INFO, "USB: First data seen (%d bytes)", available);
+		ERROR_LOGF(LOG_INFO, "USB: First data seen (%d bytes)", available);
 		usbFirstData = true;
 	}
 	
 	// Periodic debug log if we keep getting data
 	static uint32_t lastDataLog = 0;
 	if (available > 0 && (Milliseconds() - lastDataLog > 5000)) {
-		g_errorLog.logf(LOG_DEBUG, "USB: %d bytes available", available);
+		ERROR_LOGF(LOG_DEBUG, "USB: %d bytes available", available);
 		lastDataLog = Milliseconds();
 	}
 	
-	while (ConnectorUsb.AvailableForRead() > 0 && charsProcessed < MAX_CHARS_PER_CALL) {
-		char c = ConnectorUsb.CharGet();
-		charsProcessed++;
-		
-		// Handle newline as message terminator
-		if (c == '\n' || c == '\r') {
-			if (usbBufferIndex > 0) {
-				usbBuffer[usbBufferIndex] = '\0';
-				
-				// Track last receive time
-				static uint32_t lastRxTime = Milliseconds();
-				uint32_t now = Milliseconds();
-				uint32_t timeSinceLastRx = now - lastRxTime;
-				
-				// Log if it's been a while since last command
-				if (timeSinceLastRx > 10000) {  // More than 10 seconds
-					g_errorLog.logf(LOG_WARNING, "USB RX after %lu ms gap: %s", timeSinceLastRx, usbBuffer);
-				} else {
-					g_errorLog.logf(LOG_INFO, "USB RX: %s", usbBuffer);
-				}
-				lastRxTime = now;
-				
-				// Mark USB host as active when we receive a command
-				notifyUsbHostActive();
-				
-				// Enqueue as if from local host (use dummy IP)
-				IpAddress dummyIp(127, 0, 0, 1);
-				if (!enqueueRx(usbBuffer, dummyIp, CLIENT_PORT)) {
-					g_errorLog.log(LOG_ERROR, "USB RX queue overflow");
-					// Error handled in enqueueRx
-				}
-				usbBufferIndex = 0;
+	// Bytes left in the USB ring hold off the host (the CDC endpoint stops accepting), so a
+	// full RX queue ends the poll instead of dropping commands
+	int32_t taken = 0;
+	while (taken < USB_RX_MAX_BYTES_PER_PASS && m_rxQueue.getFree(TX_SLOT_BYTES_NOMINAL) > 0) {
+		// libClearCore has no bulk read; a chunk's worth of CharGet() calls is bounded the same way
+		char chunk[USB_RX_CHUNK_SIZE];
+		int32_t count = 0;
+		while (count < (int32_t)sizeof(chunk)) {
+			int16_t c = ConnectorUsb.CharGet();
+			if (c < 0) {
+				break;
 			}
+			chunk[count++] = (char)c;
+		}
+		if (count == 0) {
+			break;
+		}
+		receiveUsbBytes(chunk, count);
+		taken += count;
+	}
+}
+
+void CommsController::receiveUsbBytes(const char* data, int32_t length) {
+	const char* end = data + length;
+	while (data < end) {
+		// First terminator: '\r' is only searched for ahead of the first '\n'
+		const char* stop = (const char*)memchr(data, '\n', end - data);
+		const char* cr = (const char*)memchr(data, '\r', ((stop != NULL) ? stop : end) - data);
+		if (cr != NULL) {
+			stop = cr;
 		}
-		// Add character to buffer
-		else if (usbBufferIndex < MAX_MESSAGE_LENGTH - 1) {
-			usbBuffer[usbBufferIndex++] = c;
+		size_t span = ((stop != NULL) ? stop : end) - data;
+		if (!m_usbRxOverlong) {
+			if (m_usbRxLength + span < MAX_MESSAGE_LENGTH) {
+				memcpy(m_usbRxLine + m_usbRxLength, data, span);
+				m_usbRxLength = (uint16_t)(m_usbRxLength + span);
+			} else {
+				m_usbRxOverlong = true;
+				m_usbRxLength = 0;
+				char errorMsg[128];
+				snprintf(errorMsg, sizeof(errorMsg), "%s_ERROR: USB command too long\n", DEVICE_NAME_UPPER);
+				ConnectorUsb.Send(errorMsg);
+				ERROR_LOG(LOG_ERROR, "USB command too long - discarded");
+			}
 		}
-		// Buffer overflow protection - discard message
-		else {
-			usbBufferIndex = 0;
-			char errorMsg[128];
-			snprintf(errorMsg, sizeof(errorMsg), "%s_ERROR: USB command too long\n", DEVICE_NAME_UPPER);
-			ConnectorUsb.Send(errorMsg);
-			g_errorLog.log(LOG_ERROR, "USB command too long - discarded");
+		if (stop == NULL) {
+			break;
 		}
+		finishUsbLine();
+		data = stop + 1;
 	}
 }
 
-void CommsController::processTxQueue() {
+void CommsController::finishUsbLine() {
+	if (m_usbRxOverlong) {
+		m_usbRxOverlong = false;
+		return;
+	}
+	if (m_usbRxLength == 0) {
+		return;
+	}
+	m_usbRxLine[m_usbRxLength] = '\0';
+	
+	uint32_t now = Milliseconds();
+	uint32_t timeSinceLastRx = (m_usbRxLastMs != 0) ? now - m_usbRxLastMs : 0;
+	m_usbRxLastMs = now;
+	TRACE(TRACE_USB_RX, m_usbRxLength, timeSinceLastRx);
+	// Log if it's been a while since last command
+	if (timeSinceLastRx > 10000) {  // More than 10 seconds
+		ERROR_LOGF(LOG_WARNING, "USB RX after %lu ms gap: %s", timeSinceLastRx, m_usbRxLine);
+	}
+	#if USB_RX_LOG_COMMANDS
+	else {
+		ERROR_LOGF(LOG_INFO, "USB RX: %s", m_usbRxLine);
+	}
+	#endif
+	
+	// Mark USB host as active when we receive a command
+	notifyUsbHostActive();
+	
+	// Enqueue as if from local host (use dummy IP)
+	IpAddress dummyIp(127, 0, 0, 1);
+	if (!enqueueRx(m_usbRxLine, m_usbRxLength, dummyIp, CLIENT_PORT)) {
+		ERROR_LOG(LOG_ERROR, "USB RX queue overflow");
+		// Error handled in enqueueRx
+	}
+	m_usbRxLength = 0;
+}
+
+void CommsController::processTxQueue(uint32_t budget_us) {
 	#if WATCHDOG_ENABLED
 	g_watchdogBreadcrumb = WD_BREADCRUMB_PROCESS_TX_QUEUE;
 	#endif
@@ -232,13 +850,13 @@ void CommsController::processTxQueue() {
 	uint32_t now = Milliseconds();
 	int usbAvail = ConnectorUsb.AvailableForWrite();
 	
-	// Heartbeat log - compact 8-byte entries tracking USB and network status
+	// Heartbeat log - run-length encoded USB and network status
 	static uint32_t lastHeartbeat = 0;
 	if (now - lastHeartbeat > 30000) {  // Every 30 seconds
 		// Check network status
 		bool networkActive = EthernetMgr.PhyLinkActive();
 		
-		// Log compact heartbeat (only 8 bytes per entry!)
+		// Log heartbeat (extends the current run when nothing changed)
 		// Clamp usbAvail to 0-255 to fit in uint8_t
 		uint8_t usbAvailClamped = (usbAvail > 255) ? 255 : (uint8_t)usbAvail;
 		g_heartbeatLog.log(m_usbHostConnected, networkActive, usbAvailClamped);
@@ -255,7 +873,7 @@ void CommsController::processTxQueue() {
 			#endif
 			
 			m_usbHostConnected = true;
-			g_errorLog.logf(LOG_INFO, "USB host reconnected (buffer space: %d)", usbAvail);
+			ERROR_LOGF(LOG_INFO, "USB host reconnected (buffer space: %d)", usbAvail);
 			// Send recovery message only if buffer has enough space (avoid blocking)
 			if (usbAvail > 40) {
 				#if WATCHDOG_ENABLED
@@ -277,7 +895,8 @@ void CommsController::processTxQueue() {
 		if (m_usbHostConnected && (now - m_lastUsbHealthy) > 3000) {
 			// Buffer full for 3+ seconds - host disconnected or stopped reading
 			m_usbHostConnected = false;
-			g_errorLog.logf(LOG_WARNING, "USB host disconnected (buffer full for 3s, space: %d)", usbAvail);
+			m_usbTimeouts++;
+			ERROR_LOGF(LOG_WARNING, "USB host disconnected (buffer full for 3s, space: %d)", usbAvail);
 			// Stop sending to prevent buffer deadlock
 		}
 		
@@ -288,7 +907,7 @@ void CommsController::processTxQueue() {
 			static uint32_t lastUsbResetAttempt = 0;
 			if (now - lastUsbResetAttempt > 5000) {  // Retry every 5 seconds
 				lastUsbResetAttempt = now;
-				g_errorLog.logf(LOG_WARNING, "USB stuck for %lu ms - attempting recovery", now - m_lastUsbHealthy);
+				ERROR_LOGF(LOG_WARNING, "USB stuck for %lu ms - attempting recovery", now - m_lastUsbHealthy);
 				
 				// Set breadcrumb for USB recovery operations
 				#if WATCHDOG_ENABLED
@@ -316,20 +935,86 @@ void CommsController::processTxQueue() {
 				// Reset state
 				m_lastUsbHealthy = now;
 				
-				g_errorLog.log(LOG_INFO, "USB recovery attempted - port reopened");
+				ERROR_LOG(LOG_INFO, "USB recovery attempted - port reopened");
 			}
 		}
 	}
 	
-	// Process one message per call - this is fine since watchdog is fed every loop iteration
-	if (m_txQueueHead != m_txQueueTail) {
+	// Hand queued USB bytes to the stack first so this pass sees the space they free
+	serviceUsbTx();
+	
+	// One message per call - this is fine since watchdog is fed every loop iteration. With UDP
+	// batching or a bulk TCP host, up to TX_PASS_MAX_MESSAGES go out per call.
+	// Highest non-empty lane first: bulk only goes out when control and telemetry are idle
+	bool bulkTcp = m_bulkClient.Connected();
+	int budget = (m_udpBatching || bulkTcp) ? TX_PASS_MAX_MESSAGES : 1;
+	uint32_t start = Microseconds();
+	for (int sent = 0; sent < budget; sent++) {
+		if (budget_us > 0 && sent > 0 && Microseconds() - start >= budget_us) {
+			break;
+		}
+		int lane = 0;
+		while (lane < TX_LANE_COUNT - 1 && m_txQueue[lane].front() == NULL) {
+			lane++;
+		}
+		const MessageSlot* slot = m_txQueue[lane].front();
+		if (slot == NULL) {
+			break;
+		}
 		#if WATCHDOG_ENABLED
 		g_watchdogBreadcrumb = WD_BREADCRUMB_TX_QUEUE_DEQUEUE;
 		#endif
 		
-		Message msg = m_txQueue[m_txQueueTail];
-		m_txQueueTail = (m_txQueueTail + 1) % TX_QUEUE_SIZE;
+		// Sent straight out of the arena (or copied into the batch); the slot is released once
+		// both sends are done
+		const MessageSlot& msg = *slot;
+		const char* text = m_txQueue[lane].text(msg);
+		
+		// Mirror to USB only if a host is connected and reading, and the routing policy wants
+		// this lane; messages for the USB host, or for no one on the network, always qualify.
+		// If the USB ring is short of space a telemetry frame just skips USB (a newer one
+		// follows); events and dump lines stay queued until the ring drains, without blocking
+		// the loop. Bulk and telemetry leave USB_TX_CONTROL_RESERVE free so events are never
+		// stuck behind them.
+		uint32_t remoteAddr = uint32_t(msg.remoteIp);
+		bool toUsb = m_usbHostConnected;
+		if (toUsb && m_usbRoute != USB_ROUTE_ALL && remoteAddr != 0 && remoteAddr != UDP_LOOPBACK_ADDR) {
+			toUsb = (m_usbRoute == USB_ROUTE_EVENTS && lane == TX_LANE_CONTROL);
+		}
+		if (toUsb) {
+			size_t framed = usbFramedLength(msg.length);
+			size_t reserve = (lane == TX_LANE_CONTROL) ? 0 : USB_TX_CONTROL_RESERVE;
+			if (framed + reserve > usbTxFree()) {
+				if (lane != TX_LANE_TELEMETRY) {
+					break;
+				}
+				toUsb = false;
+				m_usbSkipped++;
+			}
+		}
 		
+		// An event or bulk line for a host whose address is still resolving waits in its lane
+		// (see holdForArp()): lwIP keeps only the newest datagram per unresolved host, so
+		// sending them on would lose all but the last
+		bool viaTcp = bulkTcp && lane == TX_LANE_BULK;
+		bool toNetwork = isNetworkReady() && !viaTcp && remoteAddr != 0 && remoteAddr != UDP_LOOPBACK_ADDR;
+		bool resolved = toNetwork && udpPathResolved(msg.remoteIp);
+		if (toNetwork && !resolved && lane != TX_LANE_TELEMETRY && holdForArp(msg.remoteIp)) {
+			break;
+		}
+		if (resolved && remoteAddr == uint32_t(m_arpHoldIp)) {
+			m_arpHoldIp = IpAddress(0, 0, 0, 0);
+		}
+		
+		// Bulk lines go to the TCP stream instead of UDP while a host is connected there;
+		// when its window is full they wait in the lane (nothing is dropped)
+		bool sentTcp = false;
+		if (viaTcp) {
+			if (!bulkTcpWrite(text, msg.length)) {
+				break;
+			}
+			sentTcp = true;
+		}
 		
 		// Send over UDP if ethernet link is up AND we have a valid network GUI IP
 		#if WATCHDOG_ENABLED
@@ -337,94 +1022,207 @@ void CommsController::processTxQueue() {
 		#endif
 		
 		// Check if we have a valid network IP (not localhost, not 0.0.0.0)
-		IpAddress localhost(127, 0, 0, 1);
-		IpAddress zeroIp(0, 0, 0, 0);
-		bool isLocalhost = (msg.remoteIp == localhost);
-		bool isZero = (msg.remoteIp == zeroIp);
-		bool hasValidNetworkIp = !isLocalhost && !isZero;
+		bool hasValidNetworkIp = !sentTcp && (remoteAddr != 0 && remoteAddr != UDP_LOOPBACK_ADDR);
 		
-		if (EthernetMgr.PhyLinkActive() && hasValidNetworkIp) {
-			m_udp.Connect(msg.remoteIp, msg.remotePort);
-			m_udp.PacketWrite(msg.buffer);
-			m_udp.PacketSend();
+		if (isNetworkReady()) {
+			// A telemetry frame skips the network until the host's address resolves (see
+			// udpPathResolved()); USB still gets it, and the next frame tries again
+			if (hasValidNetworkIp && (lane != TX_LANE_TELEMETRY || resolved)) {
+				sendUdpMessage(msg.remoteIp, msg.remotePort, text, msg.length);
+			}
+			if (lane == TX_LANE_TELEMETRY) {
+				fanOutTelemetry(msg, text);
+			}
 		}
 		// Note: If ethernet link is down or no valid network IP, UDP send is skipped
 		// This prevents watchdog timeouts from blocking UDP sends
 		
-		// Mirror to USB serial (if USB host is connected and reading)
-		// Only send to USB if a host is connected and reading
 		#if WATCHDOG_ENABLED
 		g_watchdogBreadcrumb = WD_BREADCRUMB_TX_QUEUE_USB;
 		#endif
-	if (m_usbHostConnected) {
-		const int CHUNK_SIZE = 50;
-		int msgLen = strlen(msg.buffer);
-		
-		if (msgLen <= CHUNK_SIZE) {
-			// Small message - send directly if buffer available
-			if (usbAvail >= msgLen + 1) {
-				ConnectorUsb.Send(msg.buffer);
-				ConnectorUsb.Send("\n");
+		if (toUsb) {
+			queueUsbText(text, msg.length);
+			serviceUsbTx();
+		}
+		m_txQueue[lane].pop();
+	}
+	flushUdpBatch();
+	if (bulkTcp) {
+		flushBulkTcp();
+	}
+}
+
+void CommsController::processBulkTcp() {
+	if (!m_bulkClient.Connected()) {
+		if (m_bulkTxLength > 0 || m_bulkRxLength > 0) {
+			ERROR_LOG(LOG_INFO, "Bulk TCP host disconnected");
+		}
+		m_bulkClient.Close();
+		m_bulkTxLength = 0;
+		m_bulkRxLength = 0;
+	}
+	EthernetTcpClient incoming = m_bulkServer.Accept();
+	if (incoming.Connected()) {
+		// One bulk host at a time; the newest connection wins
+		m_bulkClient.Close();
+		m_bulkClient = incoming;
+		m_bulkTxLength = 0;
+		m_bulkRxLength = 0;
+		ERROR_LOG(LOG_INFO, "Bulk TCP host connected");
+	}
+	if (!m_bulkClient.Connected()) {
+		return;
+	}
+	
+	// Bulk input (recipe and table uploads) becomes ordinary commands from the host's address
+	uint8_t chunk[64];
+	int16_t count = m_bulkClient.Read(chunk, sizeof(chunk));
+	for (int16_t i = 0; i < count; i++) {
+		char c = (char)chunk[i];
+		if (c == '\n' || c == '\r') {
+			if (m_bulkRxLength > 0) {
+				m_bulkRxLine[m_bulkRxLength] = '\0';
+				enqueueRx(m_bulkRxLine, m_bulkRxLength, m_bulkClient.RemoteIp(), m_bulkClient.RemotePort());
+				m_bulkRxLength = 0;
 			}
-			// If buffer full, just drop the message silently
-		} else {
-			// Large message - send in chunks with continuation markers
-			// Format: "MSG_PART_1/3: first_50_chars"
-			int totalChunks = (msgLen + CHUNK_SIZE - 1) / CHUNK_SIZE;
-			
-			// Hard limit on total time spent in this loop to prevent watchdog timeout
-			// Even if each chunk timeout is small, we need an overall limit
-			const uint32_t MAX_TOTAL_CHUNK_TIME_MS = 100;  // Max 100ms total for all chunks
-			const uint32_t CHUNK_TIMEOUT_MS = 3;  // Per-chunk timeout
-			uint32_t chunkLoopStart = Milliseconds();
-			
-			for (int chunk = 0; chunk < totalChunks; chunk++) {
-				// Check overall time limit - abort if taking too long
-				if (Milliseconds() - chunkLoopStart > MAX_TOTAL_CHUNK_TIME_MS) {
-					// Taking too long - abort remaining chunks to prevent watchdog
-					break;
-				}
-				int offset = chunk * CHUNK_SIZE;
-				int chunkLen = (msgLen - offset > CHUNK_SIZE) ? CHUNK_SIZE : (msgLen - offset);
-				
-				char chunkMsg[80];
-				snprintf(chunkMsg, sizeof(chunkMsg), "CHUNK_%d/%d:", chunk + 1, totalChunks);
-				int headerLen = strlen(chunkMsg);
-				
-				// Add chunk data
-				strncat(chunkMsg, msg.buffer + offset, chunkLen);
-				chunkMsg[headerLen + chunkLen] = '\0';
-				
-				// Wait for buffer space (with shorter timeout to prevent watchdog)
-				uint32_t startWait = Milliseconds();
-				while (ConnectorUsb.AvailableForWrite() < (int)strlen(chunkMsg) + 1) {
-					if (Milliseconds() - startWait > CHUNK_TIMEOUT_MS) {
-						// Timeout - skip this chunk to prevent blocking
-						break;
-					}
-				}
-				
-				if (ConnectorUsb.AvailableForWrite() >= (int)strlen(chunkMsg) + 1) {
-					ConnectorUsb.Send(chunkMsg);
-					ConnectorUsb.Send("\n");
-				}
+		} else if (m_bulkRxLength < MAX_MESSAGE_LENGTH - 1) {
+			m_bulkRxLine[m_bulkRxLength++] = c;
+		}
+	}
+}
+
+bool CommsController::bulkTcpWrite(const char* text, size_t length) {
+	if (m_bulkTxLength + length + 1 > BULK_TCP_CHUNK_SIZE && !flushBulkTcp()) {
+		return false;
+	}
+	if (length + 1 > BULK_TCP_CHUNK_SIZE) {
+		length = BULK_TCP_CHUNK_SIZE - 1;
+	}
+	memcpy(m_bulkTxChunk + m_bulkTxLength, text, length);
+	m_bulkTxLength += length;
+	m_bulkTxChunk[m_bulkTxLength++] = '\n';
+	return true;
+}
+
+bool CommsController::flushBulkTcp() {
+	if (m_bulkTxLength == 0) {
+		return true;
+	}
+	volatile const EthernetTcp::TcpData* state = m_bulkClient.ConnectionState();
+	if (state == nullptr || state->pcb == nullptr || state->state != ESTABLISHED) {
+		return false;
+	}
+	struct tcp_pcb* pcb = state->pcb;
+	if (tcp_sndbuf(pcb) < m_bulkTxLength || pcb->snd_queuelen + 1 >= (TCP_SND_QUEUELEN >> 1)) {
+		return false;
+	}
+	m_bulkClient.Send(reinterpret_cast<const uint8_t*>(m_bulkTxChunk), m_bulkTxLength);
+	m_bulkTxLength = 0;
+	return true;
+}
+
+size_t CommsController::usbFramedLength(size_t length) const {
+	if (m_usbFraming == USB_FRAMING_COBS) {
+		// One code byte per 254 data bytes (plus the first), then the 0x00 delimiter
+		return length + length / 254 + 2;
+	}
+	if (length <= USB_CHUNK_SIZE) {
+		return length + 1;
+	}
+	// "CHUNK_<i>/<n>:" per chunk, counting <i> at the width of <n>
+	size_t chunks = (length + USB_CHUNK_SIZE - 1) / USB_CHUNK_SIZE;
+	size_t digits = 1;
+	for (size_t n = chunks; n >= 10; n /= 10) {
+		digits++;
+	}
+	return length + chunks * ((sizeof("CHUNK_") - 1) + 2 * digits + 2 + 1);
+}
+
+size_t CommsController::usbTxFree() const {
+	return USB_TX_RING_SIZE - 1 - (size_t)((m_usbTxHead - m_usbTxTail) & (USB_TX_RING_SIZE - 1));
+}
+
+void CommsController::usbTxWrite(const char* data, size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		m_usbTxRing[m_usbTxHead] = data[i];
+		m_usbTxHead = (m_usbTxHead + 1) & (USB_TX_RING_SIZE - 1);
+	}
+}
+
+void CommsController::queueUsbText(const char* text, size_t length) {
+	if (m_usbFraming == USB_FRAMING_COBS) {
+		// COBS: each code byte gives the distance to the next zero (0xFF = 254 data bytes,
+		// no zero); the frame itself contains no zeros, so 0x00 always ends it
+		uint16_t codeIndex = m_usbTxHead;
+		uint8_t code = 1;
+		usbTxWrite("", 1);
+		for (size_t i = 0; i < length; i++) {
+			if (text[i] != '\0') {
+				usbTxWrite(text + i, 1);
+				code++;
+			}
+			if (text[i] == '\0' || code == 0xFF) {
+				m_usbTxRing[codeIndex] = (char)code;
+				codeIndex = m_usbTxHead;
+				code = 1;
+				usbTxWrite("", 1);
 			}
 		}
+		m_usbTxRing[codeIndex] = (char)code;
+		usbTxWrite("", 1);
+		return;
 	}
-	// If USB unhealthy or buffer full, message is silently dropped to prevent blocking
-	// USB will auto-recover when buffer has space again (host reconnects)
+	if (length <= USB_CHUNK_SIZE) {
+		usbTxWrite(text, length);
+		usbTxWrite("\n", 1);
+		return;
+	}
+	// Large message - split with continuation markers, format: "CHUNK_1/3:first_50_chars"
+	int totalChunks = (int)((length + USB_CHUNK_SIZE - 1) / USB_CHUNK_SIZE);
+	for (int chunk = 0; chunk < totalChunks; chunk++) {
+		size_t offset = (size_t)chunk * USB_CHUNK_SIZE;
+		size_t chunkLen = (length - offset > USB_CHUNK_SIZE) ? USB_CHUNK_SIZE : (length - offset);
+		char chunkHeader[24];
+		size_t headerLen = append_str(chunkHeader, sizeof(chunkHeader), 0, "CHUNK_");
+		headerLen = append_int(chunkHeader, sizeof(chunkHeader), headerLen, chunk + 1);
+		headerLen = append_char(chunkHeader, sizeof(chunkHeader), headerLen, '/');
+		headerLen = append_int(chunkHeader, sizeof(chunkHeader), headerLen, totalChunks);
+		headerLen = append_char(chunkHeader, sizeof(chunkHeader), headerLen, ':');
+		usbTxWrite(chunkHeader, headerLen);
+		usbTxWrite(text + offset, chunkLen);
+		usbTxWrite("\n", 1);
 	}
 }
 
-void CommsController::reportEvent(const char* statusType, const char* message) {
+void CommsController::serviceUsbTx() {
+	if (m_usbTxHead == m_usbTxTail) {
+		return;
+	}
+	if (!m_usbHostConnected) {
+		// Nobody is reading; stale bytes would only arrive after a reconnect
+		m_usbTxTail = m_usbTxHead;
+		return;
+	}
+	// Never more than the stack has room for, so SendChar() never spins
+	int avail = ConnectorUsb.AvailableForWrite();
+	while (avail > 0 && m_usbTxHead != m_usbTxTail) {
+		uint16_t end = (m_usbTxHead > m_usbTxTail) ? m_usbTxHead : USB_TX_RING_SIZE;
+		int run = end - m_usbTxTail;
+		if (run > avail) {
+			run = avail;
+		}
+		ConnectorUsb.Send(m_usbTxRing + m_usbTxTail, run);
+		m_usbTxTail = (m_usbTxTail + run) & (USB_TX_RING_SIZE - 1);
+		avail -= run;
+	}
+}
+
+void CommsController::reportEvent(TextView statusType, TextView message, TxLane lane, uint32_t requestId) {
 	#if WATCHDOG_ENABLED
 	uint32_t savedBreadcrumb = g_watchdogBreadcrumb;
 	g_watchdogBreadcrumb = 0x10; // reportEvent start
 	#endif
 	
-	char fullMsg[MAX_MESSAGE_LENGTH];
-	snprintf(fullMsg, sizeof(fullMsg), "%s%s", statusType, message);
-	
 	// Always queue messages for TX - they will be sent to both network (if GUI discovered) and USB
 	// If GUI not discovered, use dummy IP - processTxQueue will still mirror to USB
 	IpAddress targetIp = m_guiDiscovered ? m_guiIp : IpAddress(0, 0, 0, 0);
@@ -433,7 +1231,23 @@ void CommsController::reportEvent(const char* statusType, const char* message) {
 	#if WATCHDOG_ENABLED
 	g_watchdogBreadcrumb = 0x11; // enqueueTx call
 	#endif
-	enqueueTx(fullMsg, targetIp, targetPort);
+	// Formatted straight into the TX arena
+	size_t need = statusType.len + message.len + 1 + (requestId != 0 ? 12 : 0);
+	char* fullMsg = reserveTx(need, lane);
+	if (fullMsg == NULL && lane == TX_LANE_BULK) {
+		fullMsg = reserveTx(need, TX_LANE_CONTROL);
+	}
+	if (fullMsg != NULL) {
+		size_t capacity = m_txQueue[m_txReserveLane].getReservedCapacity();
+		size_t fullLen = append_view(fullMsg, capacity, 0, statusType);
+		if (requestId != 0) {
+			fullLen = append_char(fullMsg, capacity, fullLen, '#');
+			fullLen = append_int(fullMsg, capacity, fullLen, (int32_t)requestId);
+			fullLen = append_char(fullMsg, capacity, fullLen, ' ');
+		}
+		fullLen = append_view(fullMsg, capacity, fullLen, message);
+		commitTx(fullLen, targetIp, targetPort);
+	}
 	
 	#if WATCHDOG_ENABLED
 	g_watchdogBreadcrumb = savedBreadcrumb; // restore
@@ -444,23 +1258,24 @@ void CommsController::notifyUsbHostActive() {
 	// Called when a command is received over USB
 	// Immediately mark the host as connected and reset the health timer
 	if (!m_usbHostConnected) {
-		g_errorLog.log(LOG_INFO, "USB host detected via command");
+		ERROR_LOG(LOG_INFO, "USB host detected via command");
 		
 		// Clear TX queue - any messages queued while host was disconnected are stale
 		// This prevents the USB buffer from being flooded with old telemetry
-		int oldQueueSize = (m_txQueueHead >= m_txQueueTail) ? 
-			(m_txQueueHead - m_txQueueTail) : 
-			(TX_QUEUE_SIZE - m_txQueueTail + m_txQueueHead);
-		m_txQueueHead = 0;
-		m_txQueueTail = 0;
+		int oldQueueSize = 0;
+		for (int lane = 0; lane < TX_LANE_COUNT; lane++) {
+			oldQueueSize += m_txQueue[lane].getCount();
+			m_txQueue[lane].clear();
+		}
+		m_usbTxTail = m_usbTxHead;
 		
 		if (oldQueueSize > 0) {
-			g_errorLog.logf(LOG_INFO, "Cleared %d stale TX messages", oldQueueSize);
+			ERROR_LOGF(LOG_INFO, "Cleared %d stale TX messages", oldQueueSize);
 		}
 		
 		// Clear USB input buffer to remove any stale data
 		ConnectorUsb.FlushInput();
-		g_errorLog.log(LOG_DEBUG, "Flushed USB input buffer");
+		ERROR_LOG(LOG_DEBUG, "Flushed USB input buffer");
 		
 		// Queue a message to indicate USB host was detected (don't send directly to avoid blocking)
 		char msg[80];
@@ -480,52 +1295,159 @@ void CommsController::setupUsbSerial(void) {
 	// USB setup is non-blocking - the connector will become available when ready
 	// No need to wait here, as the main loop will handle USB when available
 	
-	g_errorLog.log(LOG_INFO, "USB serial port opened");
+	ERROR_LOG(LOG_INFO, "USB serial port opened");
 	
 	// Send a startup message after a delay to confirm USB is working
 	// (Will be sent in the main loop once USB is ready)
 }
 
 void CommsController::setupEthernet() {
-    #if WATCHDOG_ENABLED
-    extern volatile uint32_t g_watchdogBreadcrumb;
-    #endif
-    
     EthernetMgr.Setup();
+    m_netState = NET_STATE_LINK_WAIT;
+    m_netStateStart = Milliseconds();
+}
 
-    // Start DHCP but don't hang if it fails - the system can still function via USB
+// Static address used when no DHCP lease arrives (DhcpBegin() was never called, so the
+// EthernetManager setters apply)
+static void applyFallbackAddress() {
+    EthernetMgr.LocalIp(NETWORK_FALLBACK_IP);
+    EthernetMgr.NetmaskIp(NETWORK_FALLBACK_NETMASK);
+    EthernetMgr.GatewayIp(NETWORK_FALLBACK_GATEWAY);
+}
+
+void CommsController::serviceNetwork() {
     #if WATCHDOG_ENABLED
-    g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_DHCP;
+    extern volatile uint32_t g_watchdogBreadcrumb;
     #endif
-    if (!EthernetMgr.DhcpBegin()) {
-        g_errorLog.log(LOG_WARNING, "DHCP failed - network unavailable");
-        // DHCP failed - continue anyway, network features won't work but USB will
-        return;
-    }
-
-    // Wait for link with timeout (watchdog not yet enabled at this point)
+    
+    // lwIP timers (DHCP retransmits) and received frames run from Refresh(); while
+    // bring-up is in progress nothing else calls it
     #if WATCHDOG_ENABLED
-    g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_LINK_WAIT;
+    g_watchdogBreadcrumb = WD_BREADCRUMB_NETWORK_REFRESH;
     #endif
-    uint32_t link_timeout = 2000;  // 2 second timeout (plenty of time for link to come up)
-    uint32_t link_start = Milliseconds();
-    while (!EthernetMgr.PhyLinkActive()) {
-        if (Milliseconds() - link_start > link_timeout) {
-            g_errorLog.log(LOG_WARNING, "Ethernet link timeout - network unavailable");
-            // Link didn't come up - continue anyway, USB will still work
-            // Network may become available later
+    EthernetMgr.Refresh();
+    
+    uint32_t now = Milliseconds();
+    struct netif* netif = netif_default;
+    switch (m_netState) {
+        case NET_STATE_LINK_WAIT:
+            #if WATCHDOG_ENABLED
+            g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_LINK_WAIT;
+            #endif
+            if (!EthernetMgr.PhyLinkActive() || netif == nullptr) {
+                return;
+            }
+            ERROR_LOGF(LOG_INFO, "Ethernet link up after %lu ms", (unsigned long)(now - m_netStateStart));
+            #if WATCHDOG_ENABLED
+            g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_DHCP;
+            #endif
+            if (dhcp_start(netif) != ERR_OK) {
+                ERROR_LOG(LOG_WARNING, "DHCP start failed - using fallback address");
+                applyFallbackAddress();
+                openNetwork("fallback");
+                return;
+            }
+            m_netState = NET_STATE_DHCP;
+            m_netStateStart = now;
+            TRACE(TRACE_NETWORK_STATE, NET_STATE_DHCP, 0);
+            return;
+            
+        case NET_STATE_DHCP:
+            #if WATCHDOG_ENABLED
+            g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_DHCP;
+            #endif
+            if (dhcp_supplied_address(netif)) {
+                openNetwork("DHCP");
+                return;
+            }
+            if (now - m_netStateStart > NETWORK_DHCP_TIMEOUT_MS) {
+                ERROR_LOG(LOG_WARNING, "DHCP timeout - using fallback address");
+                dhcp_release_and_stop(netif);
+                applyFallbackAddress();
+                openNetwork("fallback");
+            }
+            return;
+            
+        default:
             return;
-        }
-        Delay_ms(10);  // Short delay between checks
     }
+}
 
+void CommsController::openNetwork(const char* source) {
     m_udp.Begin(LOCAL_PORT);
-    g_errorLog.logf(LOG_INFO, "Network ready on port %d", LOCAL_PORT);
+    // Send from the same pcb (so replies keep coming from LOCAL_PORT) without EthernetUdp's
+    // per-packet Connect/copy and the three Refresh() calls it makes around every send
+    for (struct udp_pcb* pcb = udp_pcbs; pcb != nullptr; pcb = pcb->next) {
+        if (pcb->local_port == LOCAL_PORT) {
+            m_udpPcb = pcb;
+            break;
+        }
+    }
+    if (m_udpPcb != nullptr) {
+        // Receive on it too, into a queue of pbufs rather than EthernetUdp's single slot
+        udp_recv(m_udpPcb, udpReceive, this);
+    }
+    m_udpTxRef = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+    m_bulkServer.Begin();
+    m_netState = NET_STATE_READY;
+    m_netStateStart = Milliseconds();
+    
+    IpAddress ip = EthernetMgr.LocalIp();
+    TRACE(TRACE_NETWORK_STATE, NET_STATE_READY, uint32_t(ip));
+    const char* ipText = ip.StringValue();
+    ERROR_LOGF(LOG_INFO, "Network ready (%s %s) on port %d", source, ipText, LOCAL_PORT);
+    
+    #if ANNOUNCE_ENABLED
+    buildAnnounce();
+    #endif
     
     // Send status message over USB to confirm network is ready
     char infoMsg[128];
-    snprintf(infoMsg, sizeof(infoMsg), "%s_INFO: Network ready, listening on port %d\n", DEVICE_NAME_UPPER, LOCAL_PORT);
+    snprintf(infoMsg, sizeof(infoMsg), "%s_INFO: Network ready (%s %s), listening on port %d\n", DEVICE_NAME_UPPER,
+             source, ipText, LOCAL_PORT);
     ConnectorUsb.Send(infoMsg);
 }
 
+#if ANNOUNCE_ENABLED
+/**
+ * @details The text is the identity plus the bulk port, address and MAC, so a host that
+ * only listens on CLIENT_PORT can list the press and send it DISCOVER_DEVICE directly. A
+ * fleet powered up together would announce in step on a fixed period; the jitter is
+ * seeded from the MAC, so every press draws a different sequence.
+ */
+void CommsController::buildAnnounce() {
+    IpAddress ip = EthernetMgr.LocalIp();
+    const uint8_t* mac = EthernetMgr.MacAddress();
+    int length = snprintf(m_announce, sizeof(m_announce), "%s%.*s BULK=%d IP=%s MAC=%02X:%02X:%02X:%02X:%02X:%02X",
+                          STATUS_PREFIX_ANNOUNCE, (int)m_identityLength, m_identity, BULK_TCP_PORT, ip.StringValue(),
+                          mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    m_announceLength = (length > 0 && length < (int)sizeof(m_announce)) ? (uint16_t)length : 0;
+    // Both in network byte order, so the host bits are set whatever the CPU's byte order
+    m_announceIp = IpAddress(uint32_t(ip) | ~uint32_t(EthernetMgr.NetmaskIp()));
+
+    m_announceRandom = ((uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5]) ^ Microseconds();
+    if (m_announceRandom == 0) {
+        m_announceRandom = 1;
+    }
+    m_announceDueMs = Milliseconds() + announceJitter();
+}
+
+void CommsController::serviceAnnounce() {
+    uint32_t now = Milliseconds();
+    if (m_announceLength == 0 || (int32_t)(now - m_announceDueMs) < 0) {
+        return;
+    }
+    sendUdp(m_announceIp, CLIENT_PORT, m_announce, m_announceLength);
+    m_announceDueMs = now + ANNOUNCE_INTERVAL_MS - ANNOUNCE_JITTER_MS / 2 + announceJitter();
+}
+
+uint32_t CommsController::announceJitter() {
+    m_announceRandom ^= m_announceRandom << 13;
+    m_announceRandom ^= m_announceRandom >> 17;
+    m_announceRandom ^= m_announceRandom << 5;
+    return m_announceRandom % ANNOUNCE_JITTER_MS;
+}
+#endif
+
 // parseCommand is now in commands.cpp as a global function
+
@@ -0,0 +1,114 @@
+/**
+ * @file control_tick.cpp
+ * @author Eldin Miller-Stead
+ * @date November 3, 2025
+ * @brief Implements the fixed-rate control tick.
+ */
+
+#include "control_tick.h"
+#include "ClearCore.h"
+#include "SysUtils.h"
+#include "timebase.h"
+#include "watchdog_supervisor.h"
+
+// Global control tick instance
+ControlTick g_controlTick;
+
+ControlTick::ControlTick() {
+    for (uint8_t i = 0; i < CONTROL_TICK_MAX_HOOKS; i++) {
+        m_hooks[i] = nullptr;
+        m_contexts[i] = nullptr;
+    }
+    m_hook_count = 0;
+    m_running = false;
+    m_tick_count = 0;
+    m_tick_time_us = 0;
+    m_max_tick_gap_us = 0;
+    #if WATCHDOG_ENABLED
+    m_watchdog = WATCHDOG_CLIENT_NONE;
+    #endif
+}
+
+/**
+ * @details TCC2 is unused by libClearCore and shares the 120 MHz GCLK0 setup with TCC3.
+ */
+void ControlTick::start() {
+    if (m_running) {
+        return;
+    }
+    CLOCK_ENABLE(APBCMASK, TCC2_);
+
+    TCC2->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(TCC2, TCC_SYNCBUSY_ENABLE);
+    TCC2->CTRLA.bit.SWRST = 1;
+    while (TCC2->CTRLA.bit.SWRST) {
+        continue;
+    }
+
+    // 120 MHz / 16 = 7.5 MHz; 7500 counts per period at 1 kHz fits in 16 bits
+    uint32_t period = (CPU_CLK / 16 + CONTROL_TICK_HZ / 2) / CONTROL_TICK_HZ;
+    TCC2->CTRLA.bit.PRESCALER = TCC_CTRLA_PRESCALER_DIV16_Val;
+    TCC2->PER.reg = period - 1;
+
+    TCC2->INTENSET.bit.OVF = 1;
+    TCC2->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(TCC2, TCC_SYNCBUSY_ENABLE);
+
+    #if WATCHDOG_ENABLED
+    m_watchdog = g_watchdogSupervisor.registerClient("tick", WATCHDOG_TICK_DEADLINE_MS);
+    #endif
+    m_running = true;
+    NVIC_SetPriority(TCC2_0_IRQn, CONTROL_TICK_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TCC2_0_IRQn);
+}
+
+bool ControlTick::registerHook(ControlTickHook hook, void* context) {
+    if (m_hook_count >= CONTROL_TICK_MAX_HOOKS) {
+        return false;
+    }
+    // Context first, count last - the ISR only reads entries below m_hook_count
+    mask();
+    m_hooks[m_hook_count] = hook;
+    m_contexts[m_hook_count] = context;
+    m_hook_count++;
+    unmask();
+    return true;
+}
+
+void ControlTick::mask() {
+    NVIC_DisableIRQ(TCC2_0_IRQn);
+}
+
+void ControlTick::unmask() {
+    if (m_running) {
+        NVIC_EnableIRQ(TCC2_0_IRQn);
+    }
+}
+
+void ControlTick::service() {
+    uint64_t now_us = MonotonicUs();
+    if (m_tick_count > 0) {
+        uint32_t gap_us = (uint32_t)(now_us - m_tick_time_us);
+        if (gap_us > m_max_tick_gap_us) {
+            m_max_tick_gap_us = gap_us;
+        }
+    }
+    m_tick_time_us = now_us;
+    m_tick_count++;
+    uint8_t count = m_hook_count;
+    for (uint8_t i = 0; i < count; i++) {
+        m_hooks[i](m_contexts[i]);
+    }
+    #if WATCHDOG_ENABLED
+    g_watchdogSupervisor.checkIn(m_watchdog);
+    #endif
+}
+
+/**
+ * @brief Control tick timer interrupt.
+ */
+extern "C" void TCC2_0_Handler(void) {
+    g_controlTick.service();
+    // Acknowledge the interrupt
+    TCC2->INTFLAG.reg = TCC_INTFLAG_MASK;
+}
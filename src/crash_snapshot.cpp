@@ -0,0 +1,93 @@
+/**
+ * @file crash_snapshot.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the post-mortem crash snapshot kept in no-init RAM across a reset.
+ */
+
+#include "crash_snapshot.h"
+#include "loop_scheduler.h"
+#include "ClearCore.h"
+#include <string.h>
+
+static_assert(sizeof(CrashSnapshot) % 4 == 0, "Crash snapshot must be whole words for the checksum");
+
+// Survives a reset; holds garbage after power-up until the magic and checksum say otherwise
+__attribute__((section(".noinit"))) static CrashSnapshot s_noinitSnapshot;
+
+// Global crash snapshot store
+CrashSnapshotStore g_crashSnapshot;
+
+CrashSnapshotStore::CrashSnapshotStore() {
+    memset(&m_saved, 0, sizeof(m_saved));
+    m_hasSaved = false;
+}
+
+/**
+ * @details Only reads memory and registers, so it is safe in the watchdog early warning
+ * and the HardFault handler whatever the main loop was doing.
+ */
+CrashSnapshot* CrashSnapshotStore::begin(uint8_t cause, uint8_t breadcrumb) {
+    CrashSnapshot* s = &s_noinitSnapshot;
+    memset(s, 0, sizeof(*s));
+    s->cause = cause;
+    s->breadcrumb = breadcrumb;
+    s->uptime_ms = Milliseconds();
+
+    s->running_task = g_loopScheduler.getRunningTask();
+    if (s->running_task != LOOP_SCHEDULER_NO_TASK) {
+        s->running_us = Microseconds() - g_loopScheduler.getRunningSinceUs();
+    }
+
+    #if LOOP_PROFILER_ENABLED
+    for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+        const LoopStageStats& stats = g_loopProfiler.getStats(static_cast<LoopStage>(i));
+        if (stats.count > 0) {
+            s->stage_mean_us[i] = LoopProfiler::cyclesToTenthsUs(stats.total_cycles / stats.count) / 10;
+        }
+        s->stage_max_us[i] = LoopProfiler::cyclesToTenthsUs(stats.max_cycles) / 10;
+    }
+    #endif
+
+    #if TRACE_LOG_ENABLED
+    uint32_t seq = g_traceLog.getSeq();
+    uint32_t from = (seq > CRASH_SNAPSHOT_TRACE_RECORDS) ? seq - CRASH_SNAPSHOT_TRACE_RECORDS : 0;
+    s->trace_count = g_traceLog.read(from, s->trace, CRASH_SNAPSHOT_TRACE_RECORDS, &s->trace_first_seq);
+    #endif
+    return s;
+}
+
+void CrashSnapshotStore::commit() {
+    s_noinitSnapshot.checksum = checksum(s_noinitSnapshot);
+    s_noinitSnapshot.magic = CRASH_SNAPSHOT_MAGIC;
+}
+
+bool CrashSnapshotStore::load() {
+    m_hasSaved = s_noinitSnapshot.magic == CRASH_SNAPSHOT_MAGIC &&
+                 s_noinitSnapshot.checksum == checksum(s_noinitSnapshot) &&
+                 s_noinitSnapshot.trace_count <= CRASH_SNAPSHOT_TRACE_RECORDS;
+    if (m_hasSaved) {
+        m_saved = s_noinitSnapshot;
+    }
+    // Report a crash once: a later reset without a new capture must not find it again
+    s_noinitSnapshot.magic = 0;
+    return m_hasSaved;
+}
+
+const char* CrashSnapshotStore::causeName(uint8_t cause) {
+    switch (cause) {
+        case CRASH_CAUSE_WATCHDOG:  return "watchdog";
+        case CRASH_CAUSE_HARDFAULT: return "hardfault";
+        default:                    return "none";
+    }
+}
+
+uint32_t CrashSnapshotStore::checksum(const CrashSnapshot& snapshot) {
+    // Rotate-and-add, so swapped or zeroed words do not cancel out
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(&snapshot);
+    uint32_t sum = 0x5A5A5A5A;
+    for (size_t i = 2; i < sizeof(snapshot) / 4; i++) {
+        sum = ((sum << 5) | (sum >> 27)) + words[i];
+    }
+    return sum;
+}
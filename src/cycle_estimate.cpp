@@ -0,0 +1,212 @@
+/**
+ * @file cycle_estimate.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the kinematic cycle-time estimate of the stored recipe.
+ */
+
+#include "cycle_estimate.h"
+#include "motion_profile.h"
+#include "recipe.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Global cycle estimate instance
+CycleEstimate g_cycleEstimate;
+
+static const char* const kBoundNames[CYCLE_BOUND_COUNT] = {
+    "none", "speed", "accel", "dwell"
+};
+
+/**
+ * @brief Time to cover a distance at a constant acceleration, entering at @p v0, leaving
+ * at @p v1 and cruising at up to @p vel in between.
+ * @param cruised Cleared if the move never reaches @p vel
+ * @return Seconds
+ */
+static float rampTime(float distance, float v0, float vel, float v1, float accel, bool* cruised) {
+    float up = (vel * vel - v0 * v0) / (2.0f * accel);
+    float down = (vel * vel - v1 * v1) / (2.0f * accel);
+    if (up + down <= distance) {
+        return (vel - v0) / accel + (vel - v1) / accel + (distance - up - down) / vel;
+    }
+    *cruised = false;
+    float peak = sqrtf(accel * distance + 0.5f * (v0 * v0 + v1 * v1));
+    float floor_mms = (v0 > v1) ? v0 : v1;
+    if (peak < floor_mms) {
+        // Too short even to change between the two speeds; it passes at their mean
+        return 2.0f * distance / (v0 + v1);
+    }
+    return (peak - v0) / accel + (peak - v1) / accel;
+}
+
+/**
+ * @brief Time of one move as MotorController runs it: an S-curve from rest to rest when a
+ * jerk is set, a trapezoid otherwise (and for blended moves, which are never profiled).
+ * @param cruised Cleared if the move never reaches @p vel
+ * @return Seconds
+ */
+static float moveTime(float distance, float vel, float accel, float jerk, float v0, float v1, bool* cruised) {
+    if (distance <= 0.0f || vel <= 0.0f || accel <= 0.0f) {
+        return 0.0f;
+    }
+    if (jerk > 0.0f && v0 == 0.0f && v1 == 0.0f) {
+        SCurveProfile profile;
+        if (profile.plan(distance, vel, accel, jerk)) {
+            if (profile.getPeakVelocity() < 0.999f * vel) {
+                *cruised = false;
+            }
+            return profile.getDuration();
+        }
+    }
+    return rampTime(distance, v0, vel, v1, accel, cruised);
+}
+
+static uint32_t toUs(float seconds) {
+    return (uint32_t)(seconds * 1000000.0f + 0.5f);
+}
+
+CycleEstimate::CycleEstimate() {
+    memset(m_segments, 0, sizeof(m_segments));
+    m_count = 0;
+    m_moveUs = 0;
+    m_dwellUs = 0;
+    m_retractUs = 0;
+}
+
+/**
+ * @details Steps are played in order from limits.start_mm, each from where the previous
+ * one left the axis. A move ends at its target, or at the retract position if its force
+ * action is "retract". Two moves in the same direction blend at the lower of their speeds
+ * when MOTION_BLEND_ENABLED and no jerk is set, as tryBlendQueuedSegment() does.
+ */
+void CycleEstimate::plan(const RecipeStore& recipe, const CycleEstimateLimits& limits) {
+    const MotionSegment* steps = recipe.getSteps();
+    m_count = recipe.getStepCount();
+    m_moveUs = 0;
+    m_dwellUs = 0;
+    m_retractUs = 0;
+
+    float position = limits.start_mm;
+    float entry_mms = 0.0f;     // Speed the step is entered at (0 unless blended)
+    for (uint8_t i = 0; i < m_count; i++) {
+        const MotionSegment& step = steps[i];
+        SegmentEstimate& est = m_segments[i];
+        memset(&est, 0, sizeof(est));
+        float move_s = 0.0f;
+        float retract_s = 0.0f;
+        float cruise_s = 0.0f;
+        bool cruised = true;
+        float exit_mms = 0.0f;
+
+        if (step.type == SEGMENT_DWELL) {
+            est.dwell_us = step.dwell_ms * 1000UL;
+        } else if (step.type == SEGMENT_RETRACT) {
+            float speed = (step.speed_mms > 0.0f) ? step.speed_mms : limits.retract_speed_mms;
+            speed = fminf(speed, MOVE_SPEED_MAX_MMS);
+            float distance = fabsf(limits.retract_mm - position);
+            retract_s = moveTime(distance, speed, limits.accel_mmss, limits.jerk_mmss3, 0.0f, 0.0f, &cruised);
+            cruise_s = (speed > 0.0f) ? distance / speed : 0.0f;
+            position = limits.retract_mm;
+        } else {
+            float speed = fminf(step.speed_mms, MOVE_SPEED_MAX_MMS);
+            float distance = fabsf(step.position_mm - position);
+            float direction = (step.position_mm >= position) ? 1.0f : -1.0f;
+            bool regulate = (step.force_action == FORCE_ACTION_REGULATE);
+            bool retracts = (step.force_action == FORCE_ACTION_RETRACT);
+
+            // Same switch point as MotorController::planAdaptiveApproach()
+            float rapid_mms = fminf(recipe.getLearnRapidMms(), limits.traverse_ceiling_mms);
+            float contact_mm = 0.0f;
+            float switch_mm = 0.0f;
+            bool rapid = limits.adaptive && entry_mms == 0.0f && speed > 0.0f && recipe.isLearning() && step.force_kg > 0.0f &&
+                         !regulate && rapid_mms > speed && recipe.getContactEstimate(i, &contact_mm);
+            if (rapid) {
+                switch_mm = contact_mm - recipe.getLearnMarginMm() * direction;
+                rapid = (switch_mm - position) * direction > 0.0f && (step.position_mm - switch_mm) * direction > 0.0f;
+            }
+
+#if MOTION_BLEND_ENABLED
+            if (i + 1 < m_count && limits.jerk_mmss3 <= 0.0f && !regulate && !retracts && !rapid && distance > 0.0f) {
+                const MotionSegment& next = steps[i + 1];
+                if (next.type == SEGMENT_MOVE && next.force_action != FORCE_ACTION_REGULATE &&
+                    (next.position_mm - step.position_mm) * direction > 0.0f) {
+                    exit_mms = fminf(speed, fminf(next.speed_mms, MOVE_SPEED_MAX_MMS));
+                }
+            }
+#endif
+            if (rapid) {
+                // At the rapid speed to the switch point, then on at the step's speed
+                float rapid_mm = fabsf(switch_mm - position);
+                float press_mm = distance - rapid_mm;
+                move_s = rampTime(rapid_mm, 0.0f, rapid_mms, speed, limits.accel_mmss, &cruised) +
+                         rampTime(press_mm, speed, speed, 0.0f, limits.accel_mmss, &cruised);
+                cruise_s = rapid_mm / rapid_mms + press_mm / speed;
+            } else {
+                move_s = moveTime(distance, speed, limits.accel_mmss, limits.jerk_mmss3, entry_mms, exit_mms, &cruised);
+                cruise_s = (speed > 0.0f) ? distance / speed : 0.0f;
+            }
+            if (regulate) {
+                est.dwell_us = step.dwell_ms * 1000UL;
+            }
+            position = step.position_mm;
+            if (retracts) {
+                float traverse_mms = fminf(limits.retract_speed_mms, limits.traverse_ceiling_mms);
+                bool traverse_cruised = true;
+                retract_s = rampTime(fabsf(limits.retract_mm - position), 0.0f, traverse_mms, 0.0f,
+                                     limits.traverse_accel_mmss, &traverse_cruised);
+                position = limits.retract_mm;
+            }
+        }
+
+        est.move_us = toUs(move_s);
+        est.retract_us = toUs(retract_s);
+        // Judged on the step's own motion; the retract of a "retract" action is the retract's
+        float motion_s = (step.type == SEGMENT_RETRACT) ? retract_s : move_s;
+        if (est.dwell_us > est.move_us + est.retract_us) {
+            est.bound = CYCLE_BOUND_DWELL;
+        } else if (motion_s > 0.0f) {
+            // Ramping costs more than the cruise would take at the step's speed
+            est.bound = (!cruised || motion_s - cruise_s > cruise_s) ? CYCLE_BOUND_ACCEL : CYCLE_BOUND_SPEED;
+        }
+        m_moveUs += est.move_us;
+        m_dwellUs += est.dwell_us;
+        m_retractUs += est.retract_us;
+        entry_mms = exit_mms;
+    }
+}
+
+int CycleEstimate::format(char* buffer, size_t size) const {
+    uint8_t bounds[CYCLE_BOUND_COUNT] = {0, 0, 0, 0};
+    for (uint8_t i = 0; i < m_count; i++) {
+        bounds[m_segments[i].bound]++;
+    }
+    return snprintf(buffer, size, "est_ms=%.1f move_ms=%.1f dwell_ms=%.1f retract_ms=%.1f speed_steps=%u accel_steps=%u dwell_steps=%u",
+                    getTotalUs() / 1000.0f, m_moveUs / 1000.0f, m_dwellUs / 1000.0f, m_retractUs / 1000.0f,
+                    (unsigned)bounds[CYCLE_BOUND_SPEED], (unsigned)bounds[CYCLE_BOUND_ACCEL],
+                    (unsigned)bounds[CYCLE_BOUND_DWELL]);
+}
+
+int CycleEstimate::formatSegment(uint8_t index, char* buffer, size_t size) const {
+    const SegmentEstimate& est = m_segments[index];
+    return snprintf(buffer, size, "%.1f ms %s (move %.1f, dwell %.1f, retract %.1f)",
+                    (est.move_us + est.dwell_us + est.retract_us) / 1000.0f, boundName(est.bound),
+                    est.move_us / 1000.0f, est.dwell_us / 1000.0f, est.retract_us / 1000.0f);
+}
+
+int CycleEstimate::formatComparison(const CycleTiming& timing, char* buffer, size_t size) const {
+    uint32_t motion_us = timing.getLastUs(CYCLE_PHASE_APPROACH) + timing.getLastUs(CYCLE_PHASE_PRESS);
+    uint32_t cycle_us = timing.getLastUs(CYCLE_PHASE_TOTAL);
+    uint32_t total_us = getTotalUs();
+    float error_pct = (total_us > 0) ? 100.0f * ((float)cycle_us - (float)total_us) / (float)total_us : 0.0f;
+    return snprintf(buffer, size, "measured/estimated ms: move %.1f/%.1f dwell %.1f/%.1f retract %.1f/%.1f cycle %.1f/%.1f (%+.1f%%)",
+                    motion_us / 1000.0f, m_moveUs / 1000.0f,
+                    timing.getLastUs(CYCLE_PHASE_DWELL) / 1000.0f, m_dwellUs / 1000.0f,
+                    timing.getLastUs(CYCLE_PHASE_RETRACT) / 1000.0f, m_retractUs / 1000.0f,
+                    cycle_us / 1000.0f, total_us / 1000.0f, error_pct);
+}
+
+const char* CycleEstimate::boundName(CycleBound bound) {
+    return (bound < CYCLE_BOUND_COUNT) ? kBoundNames[bound] : "unknown";
+}
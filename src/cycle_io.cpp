@@ -0,0 +1,97 @@
+/**
+ * @file cycle_io.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the hardware cycle-start input and the busy / pass / fail outputs.
+ */
+
+#include "cycle_io.h"
+
+#if CYCLE_IO_ENABLED
+
+#include "ClearCore.h"
+
+// Global cycle I/O instance
+CycleIo g_cycleIo;
+
+CycleIo::CycleIo() {
+    m_edgeLatched = false;
+    m_edgeUs = 0;
+    m_armed = false;
+    m_interruptAvailable = false;
+}
+
+void CycleIo::setup() {
+    // Filter in 200 us samples, as for the home sensors
+    CYCLE_START_INPUT.Mode(Connector::INPUT_DIGITAL);
+    CYCLE_START_INPUT.FilterLength(CYCLE_START_FILTER_MS * 5);
+    CYCLE_OUT_BUSY.Mode(Connector::OUTPUT_DIGITAL);
+    CYCLE_OUT_PASS.Mode(Connector::OUTPUT_DIGITAL);
+    CYCLE_OUT_FAIL.Mode(Connector::OUTPUT_DIGITAL);
+    show(CYCLE_OUTPUT_IDLE);
+
+    // An input held active through boot must be released before it can start a cycle
+    m_armed = false;
+    InputManager::InterruptTrigger edge = CYCLE_START_ACTIVE_STATE ? InputManager::RISING : InputManager::FALLING;
+    m_interruptAvailable = CYCLE_START_INPUT.InterruptHandlerSet(&CycleIo::startIsr, edge);
+    if (m_interruptAvailable) {
+        InputMgr.InterruptsEnabled(true);
+    }
+}
+
+/**
+ * @details Sees the raw pin, so contact bounce can fire it several times; only the first
+ * edge after takeStart() is kept.
+ */
+void CycleIo::startIsr() {
+    if (!g_cycleIo.m_edgeLatched) {
+        g_cycleIo.m_edgeUs = Microseconds();
+        g_cycleIo.m_edgeLatched = true;
+    }
+}
+
+bool CycleIo::inputActive() const {
+    return CYCLE_START_INPUT.State() == (CYCLE_START_ACTIVE_STATE ? 1 : 0);
+}
+
+bool CycleIo::takeStart(uint32_t* edge_us) {
+    bool active = inputActive();
+    if (!active) {
+        m_armed = true;
+    }
+    if (!m_interruptAvailable) {
+        if (!active || !m_armed) {
+            return false;
+        }
+        m_armed = false;
+        *edge_us = Microseconds();
+        return true;
+    }
+
+    if (!m_edgeLatched) {
+        return false;
+    }
+    uint32_t latched_us = m_edgeUs;
+    if (active && m_armed) {
+        m_armed = false;
+        m_edgeLatched = false;
+        *edge_us = latched_us;
+        return true;
+    }
+    if (active) {
+        // Bounce while the input is still held from the last start
+        m_edgeLatched = false;
+    } else if (Microseconds() - latched_us > 2u * CYCLE_START_FILTER_MS * 1000u) {
+        // A glitch the filter never passed
+        m_edgeLatched = false;
+    }
+    return false;
+}
+
+void CycleIo::show(uint8_t output) {
+    CYCLE_OUT_BUSY.State(output == CYCLE_OUTPUT_BUSY);
+    CYCLE_OUT_PASS.State(output == CYCLE_OUTPUT_PASS);
+    CYCLE_OUT_FAIL.State(output == CYCLE_OUTPUT_FAIL);
+}
+
+#endif // CYCLE_IO_ENABLED
@@ -0,0 +1,123 @@
+/**
+ * @file cycle_timing.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the per-phase cycle timing of press moves.
+ */
+
+#include "cycle_timing.h"
+#include <stdio.h>
+#include <string.h>
+
+// Global cycle timing instance
+CycleTiming g_cycleTiming;
+
+static const char* const kPhaseNames[CYCLE_PHASE_COUNT + 1] = {
+    "start", "approach", "press", "dwell", "retract", "cycle"
+};
+
+CycleTiming::CycleTiming() {
+    m_active = false;
+    m_contact = false;
+    m_phase = CYCLE_PHASE_START;
+    m_beginUs = 0;
+    m_markUs = 0;
+    memset(m_phaseUs, 0, sizeof(m_phaseUs));
+    memset(m_lastUs, 0, sizeof(m_lastUs));
+    resetStats();
+}
+
+void CycleTiming::begin(uint32_t now_us) {
+    m_active = true;
+    m_contact = false;
+    m_phase = CYCLE_PHASE_START;
+    m_beginUs = now_us;
+    m_markUs = now_us;
+    memset(m_phaseUs, 0, sizeof(m_phaseUs));
+}
+
+void CycleTiming::enter(uint8_t phase, uint32_t now_us) {
+    if (!m_active || phase == m_phase) {
+        return;
+    }
+    m_phaseUs[m_phase] += now_us - m_markUs;
+    m_markUs = now_us;
+    m_phase = phase;
+}
+
+void CycleTiming::motionStarted(uint32_t now_us) {
+    if (m_phase == CYCLE_PHASE_RETRACT) {
+        return;
+    }
+    // A resume after a hold at the limit, or the next queued segment, carries on pressing
+    enter(m_contact ? CYCLE_PHASE_PRESS : CYCLE_PHASE_APPROACH, now_us);
+}
+
+void CycleTiming::segmentStarted(uint32_t now_us, bool retracting) {
+    if (retracting) {
+        enter(CYCLE_PHASE_RETRACT, now_us);
+    } else if (m_active && m_phase == CYCLE_PHASE_RETRACT) {
+        m_contact = false;
+        enter(CYCLE_PHASE_APPROACH, now_us);
+    }
+}
+
+void CycleTiming::contact(uint32_t now_us) {
+    if (!m_active) {
+        return;
+    }
+    m_contact = true;
+    if (m_phase == CYCLE_PHASE_APPROACH) {
+        enter(CYCLE_PHASE_PRESS, now_us);
+    }
+}
+
+void CycleTiming::dwell(uint32_t now_us) {
+    enter(CYCLE_PHASE_DWELL, now_us);
+}
+
+void CycleTiming::retract(uint32_t now_us) {
+    enter(CYCLE_PHASE_RETRACT, now_us);
+}
+
+bool CycleTiming::finish(uint32_t now_us) {
+    if (!m_active) {
+        return false;
+    }
+    m_phaseUs[m_phase] += now_us - m_markUs;
+    m_active = false;
+
+    for (uint8_t i = 0; i <= CYCLE_PHASE_COUNT; i++) {
+        uint32_t us = (i < CYCLE_PHASE_COUNT) ? m_phaseUs[i] : now_us - m_beginUs;
+        m_lastUs[i] = us;
+        // A phase the cycle never entered (no dwell, no retract) stays out of its mean
+        if (us == 0 && i != CYCLE_PHASE_TOTAL) {
+            continue;
+        }
+        CyclePhaseStats& stats = m_stats[i];
+        if (stats.count == 0 || us < stats.min_us) {
+            stats.min_us = us;
+        }
+        if (us > stats.max_us) {
+            stats.max_us = us;
+        }
+        stats.total_us += us;
+        stats.count++;
+    }
+    return true;
+}
+
+int CycleTiming::format(char* buffer, size_t size) const {
+    return snprintf(buffer, size, "start_ms=%.1f approach_ms=%.1f press_ms=%.1f dwell_ms=%.1f retract_ms=%.1f cycle_ms=%.1f",
+                    m_lastUs[CYCLE_PHASE_START] / 1000.0f, m_lastUs[CYCLE_PHASE_APPROACH] / 1000.0f,
+                    m_lastUs[CYCLE_PHASE_PRESS] / 1000.0f, m_lastUs[CYCLE_PHASE_DWELL] / 1000.0f,
+                    m_lastUs[CYCLE_PHASE_RETRACT] / 1000.0f, m_lastUs[CYCLE_PHASE_TOTAL] / 1000.0f);
+}
+
+void CycleTiming::resetStats() {
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+const char* CycleTiming::phaseName(uint8_t phase) {
+    return (phase <= CYCLE_PHASE_COUNT) ? kPhaseNames[phase] : "unknown";
+}
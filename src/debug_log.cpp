@@ -0,0 +1,86 @@
+/**
+ * @file debug_log.cpp
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Implements the gated binary debug-record channel.
+ */
+
+#include "debug_log.h"
+#include "base64.h"
+#include "ClearCore.h"
+#include <stdio.h>
+#include <string.h>
+
+static_assert(sizeof(DebugRecord) == 28, "Debug record must pack to 28 bytes");
+static_assert(48 + (DEBUG_LOG_RECORDS_PER_LINE * sizeof(DebugRecord) + 2) / 3 * 4 < MAX_MESSAGE_LENGTH,
+              "A DATA line must fit in one message");
+
+// Global debug log instance
+DebugLog g_debugLog;
+
+DebugLog::DebugLog() {
+    m_head = 0;
+    m_count = 0;
+    m_seq = 0;
+    m_dropped = 0;
+    m_level = DEBUG_LEVEL_OFF;
+}
+
+bool DebugLog::setLevel(uint8_t level) {
+    if (level > DEBUG_LEVEL_RECORDS) {
+        return false;
+    }
+    if (level != DEBUG_LEVEL_OFF && m_level == DEBUG_LEVEL_OFF) {
+        m_head = 0;
+        m_count = 0;
+        m_seq = 0;
+        m_dropped = 0;
+    }
+    m_level = level;
+    return true;
+}
+
+void DebugLog::record(uint8_t type, float v0, float v1, float v2, float v3, float v4) {
+    if (!isEnabled()) {
+        return;
+    }
+    uint16_t seq = m_seq++;
+    if (m_count >= DEBUG_LOG_RECORDS) {
+        m_dropped++;
+        return;
+    }
+    DebugRecord& rec = m_records[(m_head + m_count) % DEBUG_LOG_RECORDS];
+    rec.time_us = Microseconds();
+    rec.seq = seq;
+    rec.type = type;
+    rec.reserved = 0;
+    rec.values[0] = v0;
+    rec.values[1] = v1;
+    rec.values[2] = v2;
+    rec.values[3] = v3;
+    rec.values[4] = v4;
+    m_count++;
+}
+
+uint16_t DebugLog::formatLine(char* buffer, size_t size) {
+    if (m_count == 0) {
+        return 0;
+    }
+    // Records are contiguous up to the end of the ring; the rest goes in the next line
+    uint16_t n = m_count;
+    if (n > DEBUG_LOG_RECORDS_PER_LINE) {
+        n = DEBUG_LOG_RECORDS_PER_LINE;
+    }
+    if (n > DEBUG_LOG_RECORDS - m_head) {
+        n = DEBUG_LOG_RECORDS - m_head;
+    }
+    const DebugRecord& first = m_records[m_head];
+    int len = snprintf(buffer, size, "DEBUG:pressboi:DATA:%u:%lu:", (unsigned)first.seq, (unsigned long)m_dropped);
+    if (len < 0 || (size_t)len + (n * sizeof(DebugRecord) + 2) / 3 * 4 >= size) {
+        return 0;
+    }
+    base64Encode(reinterpret_cast<const uint8_t*>(&first), n * sizeof(DebugRecord), buffer + len);
+    m_head = (m_head + n) % DEBUG_LOG_RECORDS;
+    m_count -= n;
+    return n;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file drive_geometry.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the drive geometry held in NVM.
+ */
+
+#include "drive_geometry.h"
+#include "NvmManager.h"
+#include <string.h>
+
+using ClearCore::NvmManager;
+
+static_assert(PITCH_MM_PER_REV >= DRIVE_PITCH_MIN_MM && PITCH_MM_PER_REV <= DRIVE_PITCH_MAX_MM &&
+              PULSES_PER_REV >= DRIVE_PULSES_PER_REV_MIN && PULSES_PER_REV <= DRIVE_PULSES_PER_REV_MAX,
+              "Default drive geometry must be within the set_drive_geometry ranges");
+
+// Global drive geometry instance
+DriveGeometry g_driveGeometry;
+
+DriveGeometry::DriveGeometry() {
+    apply(PITCH_MM_PER_REV, PULSES_PER_REV);
+    m_savedPitchMmPerRev = PITCH_MM_PER_REV;
+    m_savedPulsesPerRev = PULSES_PER_REV;
+    m_pending = false;
+}
+
+bool DriveGeometry::isValid(float pitch_mm_per_rev, int32_t pulses_per_rev) {
+    return pitch_mm_per_rev >= DRIVE_PITCH_MIN_MM && pitch_mm_per_rev <= DRIVE_PITCH_MAX_MM &&
+           pulses_per_rev >= DRIVE_PULSES_PER_REV_MIN && pulses_per_rev <= DRIVE_PULSES_PER_REV_MAX;
+}
+
+void DriveGeometry::apply(float pitch_mm_per_rev, int32_t pulses_per_rev) {
+    m_pitchMmPerRev = pitch_mm_per_rev;
+    m_pulsesPerRev = pulses_per_rev;
+    m_stepsPerMm = (float)pulses_per_rev / pitch_mm_per_rev;
+    m_mmPerStep = pitch_mm_per_rev / (float)pulses_per_rev;
+}
+
+uint32_t DriveGeometry::checkWord(uint32_t pitch_bits, int32_t pulses_per_rev) {
+    return DRIVE_GEOMETRY_MAGIC ^ pitch_bits ^ (uint32_t)pulses_per_rev;
+}
+
+/**
+ * @details The check word tells a stored geometry apart from erased slots and from the jerk
+ * limit and encoder values units older than the settings block kept in the same slots.
+ */
+bool DriveGeometry::load() {
+    NvmManager &nvmMgr = NvmManager::Instance();
+    int32_t pulses = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_DRIVE_PULSES_PER_REV * 4));
+    uint32_t pitch_bits = (uint32_t)nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_DRIVE_PITCH * 4));
+    uint32_t check = (uint32_t)nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_DRIVE_CHECK * 4));
+    float pitch;
+    memcpy(&pitch, &pitch_bits, sizeof(pitch));
+    if (check != checkWord(pitch_bits, pulses) || !isValid(pitch, pulses)) {
+        apply(PITCH_MM_PER_REV, PULSES_PER_REV);
+        return false;
+    }
+    apply(pitch, pulses);
+    return true;
+}
+
+bool DriveGeometry::save(float pitch_mm_per_rev, int32_t pulses_per_rev) {
+    if (!isValid(pitch_mm_per_rev, pulses_per_rev)) {
+        return false;
+    }
+    m_savedPitchMmPerRev = pitch_mm_per_rev;
+    m_savedPulsesPerRev = pulses_per_rev;
+    m_pending = true;
+    return true;
+}
+
+bool DriveGeometry::commit() {
+    if (!m_pending) {
+        return true;
+    }
+    uint32_t pitch_bits;
+    memcpy(&pitch_bits, &m_savedPitchMmPerRev, sizeof(pitch_bits));
+    // Check word last, so an interrupted write loads as the defaults rather than half a geometry
+    NvmManager &nvmMgr = NvmManager::Instance();
+    int32_t pair[2] = { m_savedPulsesPerRev, (int32_t)pitch_bits };
+    static_assert(NVM_SLOT_DRIVE_PITCH == NVM_SLOT_DRIVE_PULSES_PER_REV + 1, "Pulses and pitch are written as one block");
+    if (!nvmMgr.BlockWrite(static_cast<NvmManager::NvmLocations>(NVM_SLOT_DRIVE_PULSES_PER_REV * 4),
+                           sizeof(pair), reinterpret_cast<const uint8_t*>(pair)) ||
+        !nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_DRIVE_CHECK * 4),
+                      (int32_t)checkWord(pitch_bits, m_savedPulsesPerRev))) {
+        return false;
+    }
+    m_pending = false;
+    return true;
+}
+
+void DriveGeometry::erase() {
+    m_pending = false;
+    NvmManager::Instance().Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_DRIVE_CHECK * 4), -1);
+}
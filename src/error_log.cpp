@@ -6,39 +6,60 @@
  */
 
 #include "error_log.h"
+#include "sd_log.h"
 #include "ClearCore.h"
+#include "atomic_utils.h"
 #include <cstdarg>
 #include <cstdio>
 
+static_assert(ERROR_LOG_DEFAULT_LEVEL >= ERROR_LOG_MIN_LEVEL, "The boot log level must be compiled in");
+
 // Global log instances
 ErrorLog g_errorLog;
 HeartbeatLog g_heartbeatLog;
 
 ErrorLog::ErrorLog() {
-    m_head = 0;
-    m_count = 0;
+    memset(m_buffer, 0, sizeof(m_buffer));
+    for (int i = 0; i < ERROR_LOG_SIZE; i++) {
+        m_stamp[i] = 0;
+    }
+    m_reserved = 0;
+    m_floor = 0;
+    m_sdSeq = 0;
+    m_level = ERROR_LOG_DEFAULT_LEVEL;
 }
 
+/**
+ * @details Claims the next sequence number with one atomic add (LDREX/STREX), so a producer
+ * that interrupts another gets the following slot instead of sharing it. The slot's stamp
+ * is cleared before the entry is written and set to the sequence + 1 after, so a reader
+ * can tell a finished entry from one in progress. Slots are reused only ERROR_LOG_SIZE
+ * entries later, which no set of nested producers comes near.
+ */
 void ErrorLog::log(LogLevel level, const char* message) {
-    // Get timestamp
-    uint32_t timestamp = Milliseconds();
-    
-    // Add entry at head position
-    m_buffer[m_head].timestamp = timestamp;
-    m_buffer[m_head].level = level;
-    strncpy(m_buffer[m_head].message, message, ERROR_LOG_MSG_LENGTH - 1);
-    m_buffer[m_head].message[ERROR_LOG_MSG_LENGTH - 1] = '\0';
-    
-    // Advance head (circular)
-    m_head = (m_head + 1) % ERROR_LOG_SIZE;
-    
-    // Update count (saturate at ERROR_LOG_SIZE)
-    if (m_count < ERROR_LOG_SIZE) {
-        m_count++;
+    // Calls that bypass ERROR_LOG() (e.g. a level chosen at run time) are filtered here
+    if (level < m_level) {
+        return;
     }
+    uint32_t timestamp = Milliseconds();
+    uint32_t seq = atomic_fetch_add(&m_reserved, 1u);
+    uint32_t slot = seq % ERROR_LOG_SIZE;
+
+    // Unpublish the slot before overwriting it
+    atomic_store_n(&m_stamp[slot], 0u);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    LogEntry& entry = m_buffer[slot];
+    entry.timestamp = timestamp;
+    entry.level = level;
+    strncpy(entry.message, message, ERROR_LOG_MSG_LENGTH - 1);
+    entry.message[ERROR_LOG_MSG_LENGTH - 1] = '\0';
+    atomic_store_n(&m_stamp[slot], seq + 1);
 }
 
 void ErrorLog::logf(LogLevel level, const char* format, ...) {
+    if (level < m_level) {
+        return;
+    }
     char buffer[ERROR_LOG_MSG_LENGTH];
     
     va_list args;
@@ -49,32 +70,99 @@ void ErrorLog::logf(LogLevel level, const char* format, ...) {
     log(level, buffer);
 }
 
+bool ErrorLog::setLevel(LogLevel level) {
+    if (level < ERROR_LOG_MIN_LEVEL || level > LOG_CRITICAL) {
+        return false;
+    }
+    m_level = level;
+    return true;
+}
+
+bool ErrorLog::parseLevel(const char* name, LogLevel* level) {
+    static const char* const kNames[] = {"debug", "info", "warn", "error", "crit"};
+    for (uint8_t i = 0; i < sizeof(kNames) / sizeof(kNames[0]); i++) {
+        if (strcmp(name, kNames[i]) == 0) {
+            *level = (LogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ErrorLog::levelName(LogLevel level) {
+    switch (level) {
+        case LOG_DEBUG:    return "DEBUG";
+        case LOG_INFO:     return "INFO";
+        case LOG_WARNING:  return "WARN";
+        case LOG_ERROR:    return "ERROR";
+        case LOG_CRITICAL: return "CRIT";
+        default:           return "???";
+    }
+}
+
 int ErrorLog::getEntryCount() const {
-    return m_count;
+    return (int)(getSeq() - getOldestSeq());
 }
 
 bool ErrorLog::getEntry(int index, LogEntry* entry) const {
-    if (index < 0 || index >= m_count) {
+    if (index < 0 || index >= getEntryCount()) {
         return false;
     }
-    
-    // Calculate actual buffer position
-    // If buffer is not full, oldest entry is at index 0
-    // If buffer is full, oldest entry is at m_head
-    int bufferIndex;
-    if (m_count < ERROR_LOG_SIZE) {
-        bufferIndex = index;
-    } else {
-        bufferIndex = (m_head + index) % ERROR_LOG_SIZE;
+    return getEntryAt(getOldestSeq() + (uint32_t)index, entry);
+}
+
+uint32_t ErrorLog::getSeq() const {
+    return atomic_load_n(&m_reserved);
+}
+
+uint32_t ErrorLog::getOldestSeq() const {
+    uint32_t seq = getSeq();
+    uint32_t oldest = (seq > ERROR_LOG_SIZE) ? seq - ERROR_LOG_SIZE : 0;
+    uint32_t floor = atomic_load_n(&m_floor);
+    return (floor > oldest) ? floor : oldest;
+}
+
+/**
+ * @details Copies the slot between two reads of its stamp: a producer that started on the
+ * slot meanwhile has changed the stamp, and the torn copy is dropped rather than waited on.
+ */
+bool ErrorLog::getEntryAt(uint32_t seq, LogEntry* entry) const {
+    if (seq < getOldestSeq() || seq >= getSeq()) {
+        return false;
     }
-    
-    *entry = m_buffer[bufferIndex];
-    return true;
+    uint32_t slot = seq % ERROR_LOG_SIZE;
+    if (atomic_load_n(&m_stamp[slot]) != seq + 1) {
+        return false;
+    }
+    *entry = m_buffer[slot];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return atomic_load_n(&m_stamp[slot]) == seq + 1;
+}
+
+void ErrorLog::serviceSdLog() {
+#if SD_LOG_ENABLED
+    uint32_t oldest = getOldestSeq();
+    if (m_sdSeq < oldest) {
+        m_sdSeq = oldest;
+    }
+    LogEntry entry;
+    // An entry an interrupted producer is still writing stops the copy until the next pass
+    while (m_sdSeq < getSeq() && getEntryAt(m_sdSeq, &entry)) {
+        // Same format as dump_error_log
+        char line[ERROR_LOG_MSG_LENGTH + 24];
+        int length = snprintf(line, sizeof(line), "[%lu] %s: %s", (unsigned long)entry.timestamp,
+                              levelName(entry.level), entry.message);
+        if (length > 0) {
+            g_sdLog.append(line, (size_t)length < sizeof(line) ? (size_t)length : sizeof(line) - 1,
+                           entry.level >= SD_LOG_FLUSH_LEVEL);
+        }
+        m_sdSeq++;
+    }
+#endif
 }
 
 void ErrorLog::clear() {
-    m_head = 0;
-    m_count = 0;
+    atomic_store_n(&m_floor, getSeq());
 }
 
 //==================================================================================================
@@ -82,25 +170,70 @@ void ErrorLog::clear() {
 //==================================================================================================
 
 HeartbeatLog::HeartbeatLog() {
-    m_head = 0;
-    m_count = 0;
+    m_nextRunSeq = 0;
+    clear();
 }
 
 void HeartbeatLog::log(bool usbConnected, bool networkActive, uint8_t usbAvailable) {
-    // Add compact entry at head position (only 8 bytes!)
-    m_buffer[m_head].timestamp = Milliseconds();
-    m_buffer[m_head].usbConnected = usbConnected ? 1 : 0;
-    m_buffer[m_head].networkActive = networkActive ? 1 : 0;
-    m_buffer[m_head].usbAvailable = usbAvailable;
-    m_buffer[m_head].reserved = 0;
+    uint32_t timestamp = Milliseconds();
+    uint8_t flags = (usbConnected ? HEARTBEAT_FLAG_USB_CONNECTED : 0) |
+                    (networkActive ? HEARTBEAT_FLAG_NETWORK_ACTIVE : 0);
+    
+    // Same status as the newest run: just extend it
+    HeartbeatRun* newest = (m_runCount > 0) ? &run(m_runCount - 1) : NULL;
+    if (newest != NULL && newest->flags == flags && newest->usbAvailable == usbAvailable &&
+        newest->count < UINT16_MAX) {
+        newest->lastTimestamp = timestamp;
+        newest->count++;
+    } else {
+        if (m_runCount == HEARTBEAT_LOG_RUNS) {
+            // Out of runs: the whole oldest run goes
+            m_count -= run(0).count;
+            m_firstRun = (m_firstRun + 1) % HEARTBEAT_LOG_RUNS;
+            m_runCount--;
+        }
+        HeartbeatRun& added = run(m_runCount);
+        added.firstTimestamp = timestamp;
+        added.lastTimestamp = timestamp;
+        added.count = 1;
+        added.flags = flags;
+        added.usbAvailable = usbAvailable;
+        m_runCount++;
+        m_nextRunSeq++;
+    }
+    m_count++;
     
-    // Advance head (circular)
-    m_head = (m_head + 1) % HEARTBEAT_LOG_SIZE;
+    // Keep 24 hours of heartbeats
+    if (m_count > HEARTBEAT_LOG_SIZE) {
+        dropOldest();
+    }
+    m_cursorRun = -1;
     
-    // Update count (saturate at HEARTBEAT_LOG_SIZE)
-    if (m_count < HEARTBEAT_LOG_SIZE) {
-        m_count++;
+#if SD_LOG_ENABLED
+    // dump_error_log's heartbeat format, tagged so it reads apart from the error entries
+    char line[40];
+    int length = snprintf(line, sizeof(line), "[%lu] HB U:%d N:%d A:%d", (unsigned long)timestamp,
+                          usbConnected ? 1 : 0, networkActive ? 1 : 0, usbAvailable);
+    if (length > 0) {
+        g_sdLog.append(line, (size_t)length, false);
+    }
+#endif
+}
+
+/**
+ * @details Removes the oldest heartbeat. Its run now starts at what was its second
+ * heartbeat, whose timestamp getEntry() would have interpolated the same way.
+ */
+void HeartbeatLog::dropOldest() {
+    HeartbeatRun& oldest = run(0);
+    if (oldest.count > 1) {
+        oldest.firstTimestamp += (oldest.lastTimestamp - oldest.firstTimestamp) / (oldest.count - 1);
+        oldest.count--;
+    } else {
+        m_firstRun = (m_firstRun + 1) % HEARTBEAT_LOG_RUNS;
+        m_runCount--;
     }
+    m_count--;
 }
 
 int HeartbeatLog::getEntryCount() const {
@@ -112,20 +245,47 @@ bool HeartbeatLog::getEntry(int index, HeartbeatEntry* entry) const {
         return false;
     }
     
-    // Calculate actual buffer position
-    int bufferIndex;
-    if (m_count < HEARTBEAT_LOG_SIZE) {
-        bufferIndex = index;
-    } else {
-        bufferIndex = (m_head + index) % HEARTBEAT_LOG_SIZE;
+    // Find the run holding the heartbeat, starting from the last lookup when it is not past it
+    int runOffset = 0;
+    int runStart = 0;
+    if (m_cursorRun >= 0 && index >= m_cursorStart) {
+        runOffset = m_cursorRun;
+        runStart = m_cursorStart;
+    }
+    while (index >= runStart + run(runOffset).count) {
+        runStart += run(runOffset).count;
+        runOffset++;
     }
+    m_cursorRun = runOffset;
+    m_cursorStart = runStart;
     
-    *entry = m_buffer[bufferIndex];
+    const HeartbeatRun& found = run(runOffset);
+    uint32_t position = (uint32_t)(index - runStart);
+    entry->timestamp = found.firstTimestamp;
+    if (found.count > 1) {
+        entry->timestamp += (uint32_t)((uint64_t)(found.lastTimestamp - found.firstTimestamp) * position /
+                                       (found.count - 1));
+    }
+    entry->usbConnected = (found.flags & HEARTBEAT_FLAG_USB_CONNECTED) ? 1 : 0;
+    entry->networkActive = (found.flags & HEARTBEAT_FLAG_NETWORK_ACTIVE) ? 1 : 0;
+    entry->usbAvailable = found.usbAvailable;
+    entry->reserved = 0;
+    return true;
+}
+
+bool HeartbeatLog::getRunAt(uint32_t seq, HeartbeatRun* out) const {
+    if (seq < getOldestRunSeq() || seq >= m_nextRunSeq) {
+        return false;
+    }
+    *out = run((int)(seq - getOldestRunSeq()));
     return true;
 }
 
 void HeartbeatLog::clear() {
-    m_head = 0;
+    m_firstRun = 0;
+    m_runCount = 0;
     m_count = 0;
+    m_cursorRun = -1;
+    m_cursorStart = 0;
 }
 
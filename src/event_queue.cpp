@@ -0,0 +1,88 @@
+/**
+ * @file event_queue.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the queue of typed status events.
+ */
+
+#include "event_queue.h"
+#include "text_format.h"
+#include "ClearCore.h"
+#include <sam.h>
+
+static_assert(sizeof(EventRecord) == 24, "Event record must pack to 24 bytes");
+static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE must be a power of 2");
+
+// Global event queue instance
+EventQueue g_eventQueue;
+
+EventQueue::EventQueue() {
+    m_head = 0;
+    m_tail = 0;
+    m_seq = 0;
+    m_dropped = 0;
+}
+
+/**
+ * @details Interrupts are masked only for the slot claim and the stores, so an event posted
+ * from the control tick cannot tear one being posted by the main loop.
+ */
+bool EventQueue::post(StatusEventId id, uint32_t request_id, EventArg arg0, EventArg arg1, EventArg arg2) {
+    uint32_t time_us = Microseconds();
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint16_t next = (uint16_t)((m_head + 1) & (EVENT_QUEUE_SIZE - 1));
+    if (next == m_tail) {
+        m_dropped = m_dropped + 1;
+        __set_PRIMASK(primask);
+        return false;
+    }
+    EventRecord& rec = m_records[m_head];
+    rec.id = id;
+    rec.reserved = 0;
+    rec.seq = m_seq++;
+    rec.request_id = request_id;
+    rec.time_us = time_us;
+    rec.args[0] = arg0;
+    rec.args[1] = arg1;
+    rec.args[2] = arg2;
+    m_head = next;
+    __set_PRIMASK(primask);
+    return true;
+}
+
+const EventRecord* EventQueue::peek() const {
+    return (m_tail == m_head) ? NULL : &m_records[m_tail];
+}
+
+void EventQueue::consume() {
+    if (m_tail != m_head) {
+        m_tail = (uint16_t)((m_tail + 1) & (EVENT_QUEUE_SIZE - 1));
+    }
+}
+
+size_t EventQueue::formatText(const EventRecord& rec, char* buffer, size_t size) {
+    const StatusEventFormat* format = status_event_format(rec.id);
+    size_t pos = append_view(buffer, size, 0, format->prefix);
+    if (rec.request_id != 0) {
+        pos = append_char(buffer, size, pos, '#');
+        pos = append_int(buffer, size, pos, (int32_t)rec.request_id);
+        pos = append_char(buffer, size, pos, ' ');
+    }
+    for (const char* p = format->text; *p != '\0'; p++) {
+        if (*p != '{' || p[1] < '0' || p[1] >= '0' + EVENT_RECORD_MAX_ARGS) {
+            pos = append_char(buffer, size, pos, *p);
+            continue;
+        }
+        const EventArg& arg = rec.args[p[1] - '0'];
+        p += 2;
+        if (p[0] == ':' && p[1] == '.' && p[2] >= '0' && p[2] <= '9' && p[3] == 'f') {
+            pos = append_fixed(buffer, size, pos, arg.f, (uint8_t)(p[2] - '0'));
+            p += 4;
+        } else {
+            pos = append_int(buffer, size, pos, arg.i);
+        }
+        // p is on the closing brace; the loop steps past it
+    }
+    return pos;
+}
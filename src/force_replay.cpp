@@ -0,0 +1,121 @@
+/**
+ * @file force_replay.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the force-versus-position profile that can stand in for load cell A.
+ */
+
+#include "force_replay.h"
+
+#if FORCE_REPLAY_ENABLED || defined(PRESSBOI_HOST)
+
+#define FORCE_REPLAY_PERIOD_US  (1000000UL / FORCE_REPLAY_RATE_HZ)
+
+static_assert(FORCE_REPLAY_MAX_POINTS >= 2 && FORCE_REPLAY_MAX_POINTS <= 0xFFFF, "Replay index is 16 bits");
+
+// Global force replay instance
+ForceReplay g_forceReplay;
+
+ForceReplay::ForceReplay() {
+    m_count = 0;
+    m_skipped = 0;
+    m_positionFn = nullptr;
+    m_positionContext = nullptr;
+    m_nextSampleUs = 0;
+    m_samples = 0;
+    m_active = false;
+}
+
+void ForceReplay::clear() {
+    m_active = false;
+    m_count = 0;
+    m_skipped = 0;
+}
+
+bool ForceReplay::append(int32_t position_steps, int32_t raw) {
+    if (m_active) {
+        return false;
+    }
+    if (m_count > 0 && position_steps <= m_positions[m_count - 1]) {
+        // Holds, dwells and the retract: keep only the loading stroke
+        m_skipped++;
+        return true;
+    }
+    if (m_count >= FORCE_REPLAY_MAX_POINTS) {
+        m_skipped++;
+        return false;
+    }
+    m_positions[m_count] = position_steps;
+    m_raws[m_count] = raw;
+    m_count++;
+    return true;
+}
+
+void ForceReplay::captureVisitor(void* context, int32_t position_steps, int32_t raw) {
+    static_cast<ForceReplay*>(context)->append(position_steps, raw);
+}
+
+void ForceReplay::setPositionSource(ForceReplayPositionFn fn, void* context) {
+    m_positionFn = fn;
+    m_positionContext = context;
+}
+
+bool ForceReplay::start(uint32_t now_us) {
+    if (m_positionFn == nullptr || m_count < 2) {
+        return false;
+    }
+    m_nextSampleUs = now_us + FORCE_REPLAY_PERIOD_US;
+    m_samples = 0;
+    m_active = true;
+    return true;
+}
+
+void ForceReplay::stop() {
+    m_active = false;
+}
+
+/**
+ * @details Due times advance by whole periods, so the sample count over a move depends only
+ * on its duration, not on when the control tick happened to run.
+ */
+bool ForceReplay::poll(uint32_t now_us, int32_t* raw) {
+    if (!m_active || (int32_t)(now_us - m_nextSampleUs) < 0) {
+        return false;
+    }
+    m_nextSampleUs += FORCE_REPLAY_PERIOD_US;
+    if ((int32_t)(now_us - m_nextSampleUs) >= 0) {
+        // More than a period behind (a masked tick): resynchronize instead of bursting
+        m_nextSampleUs = now_us + FORCE_REPLAY_PERIOD_US;
+    }
+    *raw = rawAt(m_positionFn(m_positionContext));
+    m_samples++;
+    return true;
+}
+
+int32_t ForceReplay::rawAt(int32_t position_steps) const {
+    if (m_count == 0) {
+        return 0;
+    }
+    if (position_steps <= m_positions[0]) {
+        return m_raws[0];
+    }
+    if (position_steps >= m_positions[m_count - 1]) {
+        return m_raws[m_count - 1];
+    }
+    // Last point at or below the position
+    uint16_t lo = 0;
+    uint16_t hi = (uint16_t)(m_count - 1);
+    while (hi - lo > 1) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (m_positions[mid] <= position_steps) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    int64_t span = (int64_t)m_positions[hi] - m_positions[lo];
+    int64_t delta = (int64_t)m_raws[hi] - m_raws[lo];
+    return m_raws[lo] + (int32_t)((delta * ((int64_t)position_steps - m_positions[lo])) / span);
+}
+
+#endif // FORCE_REPLAY_ENABLED || PRESSBOI_HOST
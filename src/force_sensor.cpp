@@ -6,79 +6,708 @@
  */
 
 #include "force_sensor.h"
+#include "settings.h"
 #include "NvmManager.h"
+#include "control_tick.h"
+#include "trace_log.h"
+#include "hil_test.h"
+#include "force_replay.h"
+#include "timebase.h"
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 using namespace ClearCore;
 
-// NVM locations for force sensor calibration (8 bytes starting at user area)
-#define NVM_LOC_FORCE_OFFSET    NvmManager::NVM_LOC_USER_START      // 4 bytes
-#define NVM_LOC_FORCE_SCALE     (NvmManager::NVM_LOC_USER_START + 4) // 4 bytes
-
-ForceSensor::ForceSensor() {
+ForceSensor::ForceSensor(uint8_t channel) {
+    m_channel = (channel < FORCE_SENSOR_MAX_CHANNELS) ? channel : 0;
+    m_port = (m_channel == 0) ? &ConnectorCOM0 : &ConnectorCOM1;
     m_force_kg = 0.0f;
+    m_force_counts = 0;
     m_raw_value = 0;
-    m_last_reading_time = 0;
-    m_buffer_index = 0;
+    m_filtered_kg = 0.0f;
+    m_filtered_raw = 0;
+    m_last_reading_us = 0;
+    m_settling = true;
+    m_setup_time = 0;
+    m_last_sample_time_us = 0;
     m_offset_kg = FORCE_SENSOR_OFFSET_KG;  // Default from config
     m_scale = FORCE_SENSOR_SCALE_FACTOR;  // Default scale from config
-    memset(m_serial_buffer, 0, sizeof(m_serial_buffer));
+    m_scale_ug = 0;
+    m_offset_ug = 0;
+    m_count_sign = 1;
+    m_lin_count = 0;
+    m_lin_nvm_count = 0;
+    m_lin_nvm_pending = false;
+    m_lin_sign = 1;
+    m_lin_step = 0;
+    memset(m_lin_raw, 0, sizeof(m_lin_raw));
+    memset(m_lin_kg, 0, sizeof(m_lin_kg));
+    memset(m_lin_ug, 0, sizeof(m_lin_ug));
+    memset(m_lin_slope_q16, 0, sizeof(m_lin_slope_q16));
+    m_ascii_value = 0;
+    m_ascii_negative = false;
+    m_ascii_digits = 0;
+    m_ascii_done = false;
+    memset(m_frame, 0, sizeof(m_frame));
+    m_frame_index = 0;
+    m_frame_length = FORCE_SENSOR_FRAME_LENGTH;
+    m_last_seq = 0;
+    m_seq_valid = false;
+    m_dropped_samples = 0;
+    m_crc_errors = 0;
+    m_ring_overruns = 0;
+    m_parse_errors = 0;
+    m_line_overflows = 0;
+    m_uart_overflows = 0;
+    m_sample_count = 0;
+    memset((void*)m_link_reply, 0, sizeof(m_link_reply));
+    m_link_replies = 0;
+    m_link_state = LINK_START;
+    m_link_since = 0;
+    m_link_sent_ms = 0;
+    m_link_attempts = 0;
+    m_link_seen = 0;
+    m_link_baud_mask = 1;
+    m_link_rate_mask = 0;
+    m_link_baud = 0;
+    m_link_rate = 0;
+    m_link_target_baud = 0;
+    m_link_target_rate = 0;
+    m_link_cap = 0xFF;
+    m_link_measuring = false;
+    m_link_errors = 0;
+    m_link_samples = 0;
+    m_win_start_us = 0;
+    m_win_gaps = 0;
+    m_win_gap_sum = 0;
+    m_win_gap_sq_sum = 0;
+    m_win_max_gap = 0;
+    m_rate_mhz = 0;
+    m_jitter_us = 0;
+    m_max_gap_us = 0;
+    m_stuck_raw = 0;
+    m_stuck_run = 0;
+    m_stuck_events = 0;
+    m_zero_trim_kg = 0.0f;
+    m_zero_idle_since = 0;
+    m_zero_allowed = false;
+    m_zero_at_limit = false;
+    m_zero_last_us = 0;
+    m_zero_count = 0;
+    m_zero_sum = 0.0f;
+    m_zero_min = 0.0f;
+    m_zero_max = 0.0f;
+    m_filter_median = FORCE_FILTER_MEDIAN_DEFAULT;
+    m_filter_alpha = FORCE_FILTER_ALPHA_DEFAULT;
+    m_filter_reset = true;
+    memset(m_median_buf, 0, sizeof(m_median_buf));
+    m_median_count = 0;
+    m_median_index = 0;
+    m_iir_state = 0;
+    m_iir_valid = false;
+    m_latency_us = FORCE_LATENCY_US_DEFAULT;
+    m_trip_armed = false;
+    m_trip_fired = false;
+    m_trip_limit_counts = 0;
+    m_trip_force_kg = 0.0f;
+    m_trip_predicted = false;
+    m_trip_latency_us = 0;
+    m_trip_lead_us = 0;
+    m_trip_predict_counts = INT32_MAX;
+    m_trip_rate = 0.0f;
+    m_trip_prev_counts = 0;
+    m_trip_prev_us = 0;
+    m_trip_hook = nullptr;
+    m_trip_context = nullptr;
+    m_ring_head = 0;
+    m_ring_tail = 0;
+    updateFixedCalibration();
+}
+
+// CRC-8 (poly FORCE_SENSOR_FRAME_CRC_POLY, init 0) - must match hx711_arduino.ino
+static uint8_t frameCrc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ FORCE_SENSOR_FRAME_CRC_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Link-control frames: [0xA7][type][p0..p4][crc8 over type and params] - must match hx711_arduino.ino
+static const uint8_t kLinkFrameQuery = 0x01;        ///< -> capabilities, please
+static const uint8_t kLinkFrameSet = 0x02;          ///< -> p0 baud index, p1 rate index
+static const uint8_t kLinkFrameKeepalive = 0x03;    ///< -> still here (p0/p1 echo the setting)
+static const uint8_t kLinkFrameCaps = 0x81;         ///< <- p0 version, p1 baud mask, p2 rate mask, p3/p4 current indices
+static const uint8_t kLinkFrameAck = 0x82;          ///< <- p0/p1 the setting about to be applied
+
+// Bauds exact (or within 2%) on both the SERCOM and a 16 MHz AVR; index 0 is the default
+static const uint32_t kLinkBauds[] = { 115200, 250000, 500000, 1000000 };
+static const uint8_t kLinkBaudCount = sizeof(kLinkBauds) / sizeof(kLinkBauds[0]);
+// HX711 conversion rates (RATE pin low / high)
+static const uint8_t kLinkRatesHz[] = { 10, 80 };
+static const uint8_t kLinkRateCount = sizeof(kLinkRatesHz) / sizeof(kLinkRatesHz[0]);
+
+/** @brief Highest table index at or below @p index whose bit is set in @p mask (0 if none). */
+static uint8_t linkIndexAtOrBelow(uint8_t mask, uint8_t index) {
+    for (int i = index; i > 0; i--) {
+        if (mask & (1u << i)) {
+            return (uint8_t)i;
+        }
+    }
+    return 0;
 }
 
 void ForceSensor::setup() {
-    // Configure COM-0 for TTL UART communication
-    ConnectorCOM0.Mode(Connector::TTL);
-    ConnectorCOM0.Speed(115200);  // Match Rugeduino baud rate
-    ConnectorCOM0.PortOpen();
+    // Configure the COM port for TTL UART communication
+    m_port->Mode(Connector::TTL);
+    m_port->Speed(115200);  // Match Rugeduino baud rate
+    m_port->PortOpen();
+    m_setup_time = Milliseconds();
+    m_settling = true;
     
     // Load calibration from NVM
     loadCalibrationFromNVM();
+    if (m_channel == 0) {
+        loadFilterFromNVM();
+        loadLinearizationFromNVM();
+    }
+    updateFixedCalibration();
     
-    // Wait for port to stabilize
-    Delay_ms(100);
+#if FORCE_SENSOR_RX_ISR_ENABLED
+    // libClearCore's UART path is interrupt-driven into a 64-byte buffer (its DMA channels
+    // are SPI-only), so empty that buffer at the control tick rate independent of loop timing
+    g_controlTick.registerHook(&ForceSensor::rxTickHook, this);
+    g_controlTick.start();
+#endif
+}
+
+/**
+ * @brief Control tick hook: drains this channel's COM port.
+ */
+void ForceSensor::rxTickHook(void* context) {
+    static_cast<ForceSensor*>(context)->serviceRx();
 }
 
 void ForceSensor::update() {
-    // Read any available data from COM-0
-    int c;
-    while ((c = ConnectorCOM0.CharGet()) != -1) {
-        // Process character
-        if (c == '\n' || c == '\r') {
-            // End of line - parse the accumulated data
-            if (m_buffer_index > 0) {
-                m_serial_buffer[m_buffer_index] = '\0';
-                parseSerialData();
-                m_buffer_index = 0;
-            }
-        } else if (m_buffer_index < sizeof(m_serial_buffer) - 1) {
-            // Add character to buffer
-            m_serial_buffer[m_buffer_index++] = (char)c;
-        } else {
-            // Buffer overflow - reset
-            m_buffer_index = 0;
+#if !FORCE_SENSOR_RX_ISR_ENABLED
+    serviceRx();
+#endif
+}
+
+uint16_t ForceSensor::drainSamples(ForceSample* out, uint16_t max_samples) {
+    uint16_t count = 0;
+    uint16_t tail = m_ring_tail;
+    uint16_t head = m_ring_head;
+    while (tail != head && count < max_samples) {
+        out[count++] = m_ring[tail];
+        tail = (uint16_t)((tail + 1) & (FORCE_SENSOR_RX_RING_SIZE - 1));
+    }
+    // Publish the new tail only after the copies so the producer never overwrites them
+    m_ring_tail = tail;
+    return count;
+}
+
+void ForceSensor::serviceRx() {
+    // Read any available data from this channel's port
+    int16_t c;
+#if FORCE_REPLAY_ENABLED
+    if (m_channel == 0 && g_forceReplay.isActive()) {
+        // A stored profile stands in for the transducer; whatever COM-0 receives is dropped
+        while (m_port->CharGet() != -1) {
+        }
+        int32_t raw;
+        if (g_forceReplay.poll(Microseconds(), &raw)) {
+            pushSample(raw, raw);
+        }
+        return;
+    }
+#endif
+    if (m_settling) {
+        // The port is still settling after PortOpen(); drop what it picks up meanwhile
+        while (m_port->CharGet() != -1) {
+        }
+        m_port->ErrorStatusAccum();
+        if (Milliseconds() - m_setup_time < FORCE_SENSOR_SETTLE_MS) {
+            return;
+        }
+        // After a baud change the decoders may hold half a frame of the old rate
+        m_frame_index = 0;
+        m_seq_valid = false;
+        m_settling = false;
+    }
+    // The port drops bytes it had no room for without telling the decoders; its
+    // clear-on-read error status is the only trace of an overrun or a framing error
+    if (m_port->ErrorStatusAccum()) {
+        m_uart_overflows++;
+    }
+    while ((c = m_port->CharGet()) != -1) {
+        // Binary frames take priority; anything else falls through to the ASCII line parser
+        if (!decodeFrameByte((uint8_t)c)) {
+            decodeAsciiByte((uint8_t)c);
+        }
+    }
+}
+
+void ForceSensor::decodeBytes(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (!decodeFrameByte(data[i])) {
+            decodeAsciiByte(data[i]);
         }
     }
 }
 
-void ForceSensor::parseSerialData() {
+void ForceSensor::decodeAsciiByte(uint8_t c) {
     // Expected format from Rugeduino: "123456" (raw tared ADC value as integer)
-    long raw_adc = 0;
+    if (c == '\n' || c == '\r') {
+        // End of line - emit whatever digits were accumulated
+        if (m_ascii_digits > 0) {
+            int32_t value = m_ascii_negative ? -m_ascii_value : m_ascii_value;
+            pushSample(value, value);
+        }
+        m_ascii_value = 0;
+        m_ascii_negative = false;
+        m_ascii_digits = 0;
+        m_ascii_done = false;
+        return;
+    }
+    if (m_ascii_done) {
+        return;
+    }
+    if (c >= '0' && c <= '9') {
+        // 24-bit samples never exceed 8 digits; anything longer is line noise
+        if (m_ascii_digits < 9) {
+            m_ascii_value = m_ascii_value * 10 + (c - '0');
+            m_ascii_digits++;
+        } else {
+            m_ascii_digits = 0;
+            m_ascii_done = true;
+            m_line_overflows++;
+        }
+    } else if (m_ascii_digits == 0 && c == '-' && !m_ascii_negative) {
+        m_ascii_negative = true;
+    } else if (m_ascii_digits == 0 && (c == ' ' || c == '\t') && !m_ascii_negative) {
+        // Leading whitespace
+    } else {
+        // Trailing text after the number is ignored; garbage before it voids the line
+        if (m_ascii_digits == 0) {
+            m_parse_errors++;
+        }
+        m_ascii_done = true;
+    }
+}
+
+// Sign-extend a 24-bit big-endian sample
+static int32_t decodeSample24(const uint8_t* p) {
+    int32_t raw = ((int32_t)p[0] << 16) | ((int32_t)p[1] << 8) | (int32_t)p[2];
+    if (raw & 0x800000) {
+        raw |= (int32_t)0xFF000000;
+    }
+    return raw;
+}
+
+bool ForceSensor::decodeFrameByte(uint8_t c) {
+    if (m_frame_index == 0) {
+        // Hunting for sync - 0xA5/0xA6/0xA7 are never part of an ASCII line
+        if (c == FORCE_SENSOR_FRAME_SYNC) {
+            m_frame_length = FORCE_SENSOR_FRAME_LENGTH;
+        } else if (c == FORCE_SENSOR_FRAME_SYNC_DUAL) {
+            m_frame_length = FORCE_SENSOR_FRAME_LENGTH_DUAL;
+        } else if (c == FORCE_LINK_FRAME_SYNC) {
+            m_frame_length = FORCE_LINK_FRAME_LENGTH;
+        } else {
+            return false;
+        }
+        m_frame[m_frame_index++] = c;
+        // Discard any partial ASCII line
+        m_ascii_value = 0;
+        m_ascii_negative = false;
+        m_ascii_digits = 0;
+        m_ascii_done = false;
+        return true;
+    }
+    
+    m_frame[m_frame_index++] = c;
+    if (m_frame_index < m_frame_length) {
+        return true;
+    }
+    m_frame_index = 0;
+    
+    // Frame layout: [sync][seq][s2][s1][s0]([f2][f1][f0])[crc] - CRC covers everything between
+    if (frameCrc8(&m_frame[1], m_frame_length - 2) != m_frame[m_frame_length - 1]) {
+        m_crc_errors++;
+        return true;
+    }
     
-    if (sscanf(m_serial_buffer, "%ld", &raw_adc) == 1) {
-        // Store raw value
-        m_raw_value = raw_adc;
+    if (m_frame[0] == FORCE_LINK_FRAME_SYNC) {
+        // Handshake reply for serviceLink(), not a sample
+        for (uint8_t i = 0; i < FORCE_LINK_FRAME_LENGTH; i++) {
+            m_link_reply[i] = m_frame[i];
+        }
+        m_link_replies++;
+        return true;
+    }
+    
+    uint8_t seq = m_frame[1];
+    if (m_seq_valid) {
+        uint8_t gap = (uint8_t)(seq - m_last_seq - 1);
+        m_dropped_samples += gap;
+    }
+    m_last_seq = seq;
+    m_seq_valid = true;
+    
+    int32_t raw = decodeSample24(&m_frame[2]);
+    int32_t filtered = (m_frame_length == FORCE_SENSOR_FRAME_LENGTH_DUAL) ? decodeSample24(&m_frame[5]) : raw;
+    pushSample(raw, filtered);
+    return true;
+}
+
+void ForceSensor::pushSample(int32_t raw_adc, int32_t filtered_raw) {
+    uint64_t now_us = MonotonicUs();
+    recordHealth(now_us, raw_adc);
+    
+    // Apply calibration equation: kg = (raw_adc × scale) + offset
+    m_sample_count++;
+    int32_t filtered_counts = filterSample(raw_adc);
+    int32_t counts = filtered_counts * m_count_sign;
+    float kg = countsToKg(filtered_counts);
+    
+    // Latest-value snapshot for telemetry and status checks
+    m_raw_value = raw_adc;
+    m_force_kg = kg;
+    m_force_counts = counts;
+    m_filtered_raw = filtered_raw;
+    m_filtered_kg = countsToKg(filtered_raw);
+    m_last_reading_us = now_us;
+    m_last_sample_time_us = (uint32_t)now_us;
+    
+#if FORCE_SENSOR_FAST_TRIP_ENABLED
+    // Stop right here on the sample that crosses the limit, not on the next loop pass
+    bool predicted = false;
+#if FORCE_TRIP_PREDICT_ENABLED
+    if (m_trip_armed && m_trip_lead_us > 0) {
+        // Force still rises for the sample latency and while the axes decelerate
+        uint32_t arrival_us = (uint32_t)now_us;
+        if (m_trip_prev_us != 0 && arrival_us != m_trip_prev_us) {
+            float rate = (float)(counts - m_trip_prev_counts) / (float)(arrival_us - m_trip_prev_us);
+            m_trip_rate += FORCE_TRIP_PREDICT_ALPHA * (rate - m_trip_rate);
+        }
+        m_trip_prev_counts = counts;
+        m_trip_prev_us = arrival_us;
+        if (counts >= m_trip_predict_counts && m_trip_rate > 0.0f) {
+            predicted = (float)counts + m_trip_rate * (float)m_trip_lead_us >= (float)m_trip_limit_counts;
+        }
+    }
+#endif
+    if (m_trip_armed && (counts >= m_trip_limit_counts || predicted)) {
+        m_trip_armed = false;
+        m_trip_force_kg = kg;
+        m_trip_predicted = (counts < m_trip_limit_counts);
+        m_trip_fired = true;
+        TRACE(TRACE_FORCE_TRIP, m_channel, counts);
+        HIL_MARK(HIL_SIGNAL_FORCE_CROSS);
+        if (m_trip_hook) {
+            m_trip_hook(m_trip_context);
+        }
+        m_trip_latency_us = (uint32_t)(MonotonicUs() - now_us);
+    }
+#endif
+    
+    uint16_t next = (uint16_t)((m_ring_head + 1) & (FORCE_SENSOR_RX_RING_SIZE - 1));
+    if (next == m_ring_tail) {
+        m_ring_overruns++;
+        return;
+    }
+    m_ring[m_ring_head].timestamp_us = now_us;
+    m_ring[m_ring_head].raw = raw_adc;
+    m_ring[m_ring_head].counts = counts;
+    m_ring[m_ring_head].kg = kg;
+    m_ring_head = next;
+}
+
+/**
+ * @details Runs before m_last_reading_us moves on, so the gap to the previous sample is
+ * still at hand. Once per window (a 64-bit divide and a square root) the window's rate,
+ * jitter and longest gap are published and the sums start again.
+ */
+void ForceSensor::recordHealth(uint64_t now_us, int32_t raw_adc) {
+    // HX711 noise moves the low bits on every conversion; a frozen value is a dead path
+    if (raw_adc == m_stuck_raw) {
+        if (m_stuck_run < FORCE_HEALTH_STUCK_SAMPLES) {
+            m_stuck_run++;
+            if (m_stuck_run == FORCE_HEALTH_STUCK_SAMPLES) {
+                m_stuck_events++;
+            }
+        }
+    } else {
+        m_stuck_raw = raw_adc;
+        m_stuck_run = 1;
+    }
+
+    if (m_last_reading_us == 0) {
+        m_win_start_us = now_us;
+        return;
+    }
+    uint64_t since = now_us - m_last_reading_us;
+    // Clamped so the squares cannot overflow after a long silence
+    uint32_t gap = (since > 0xFFFFFFu) ? 0xFFFFFFu : (uint32_t)since;
+    m_win_gaps++;
+    m_win_gap_sum += gap;
+    m_win_gap_sq_sum += (uint64_t)gap * gap;
+    if (gap > m_win_max_gap) {
+        m_win_max_gap = gap;
+    }
+
+    uint64_t elapsed = now_us - m_win_start_us;
+    if (elapsed < (uint64_t)FORCE_HEALTH_WINDOW_MS * 1000u) {
+        return;
+    }
+    uint32_t n = m_win_gaps;
+    m_rate_mhz = (uint32_t)((uint64_t)n * 1000000000ull / elapsed);
+    // n^2 * variance, exact in integers: n * sum(x^2) - (sum x)^2
+    uint64_t sum = m_win_gap_sum;
+    uint64_t spread = m_win_gap_sq_sum * n - sum * sum;
+    m_jitter_us = (uint32_t)(sqrtf((float)spread) / (float)n);
+    m_max_gap_us = m_win_max_gap;
+    m_win_start_us = now_us;
+    m_win_gaps = 0;
+    m_win_gap_sum = 0;
+    m_win_gap_sq_sum = 0;
+    m_win_max_gap = 0;
+}
+
+float ForceSensor::countsToKg(int32_t raw) const {
+#if FORCE_SENSOR_FIXED_POINT
+    return (float)countsToUg(raw) * 1.0e-9f;
+#else
+    if (m_lin_count >= 2) {
+        return (float)countsToUg(raw) * 1.0e-9f;
+    }
+    return (raw * m_scale) + m_offset_kg + m_zero_trim_kg;
+#endif
+}
+
+int64_t ForceSensor::countsToUg(int32_t raw) const {
+    uint8_t n = m_lin_count;
+    if (n < 2) {
+        return (int64_t)(raw * m_count_sign) * m_scale_ug + m_offset_ug;
+    }
+    
+    // Find the segment: direct index for uniform spacing, binary search otherwise
+    uint8_t seg = 0;
+    if (m_lin_step > 0) {
+        int32_t d = raw - m_lin_raw[0];
+        if (d > 0) {
+            int32_t idx = d / m_lin_step;
+            seg = (idx > n - 2) ? (uint8_t)(n - 2) : (uint8_t)idx;
+        }
+    } else {
+        uint8_t lo = 0;
+        uint8_t hi = (uint8_t)(n - 2);
+        while (lo < hi) {
+            uint8_t mid = (uint8_t)((lo + hi + 1) / 2);
+            if (m_lin_raw[mid] <= raw) {
+                lo = mid;
+            } else {
+                hi = (uint8_t)(mid - 1);
+            }
+        }
+        seg = lo;
+    }
+    
+    // End segments extrapolate beyond the table
+    int64_t dx = (int64_t)raw - m_lin_raw[seg];
+    return m_lin_ug[seg] + ((dx * m_lin_slope_q16[seg]) >> 16) + m_offset_ug;
+}
+
+int32_t ForceSensor::kgToCounts(float kg) const {
+    if (m_lin_count >= 2) {
+        // Smallest normalised count reaching kg (the table is monotonic in normalised counts)
+        int64_t target_ug = (int64_t)((double)kg * 1.0e9);
+        int32_t lo = -(1 << 23);
+        int32_t hi = (1 << 23);
+        if (countsToUg(hi * m_count_sign) < target_ug) {
+            return INT32_MAX;
+        }
+        while (lo < hi) {
+            int32_t mid = lo + (hi - lo) / 2;
+            if (countsToUg(mid * m_count_sign) >= target_ug) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+    if (m_scale_ug <= 0) {
+        return INT32_MAX;
+    }
+    // Smallest n with n * scale_ug + offset_ug >= kg_ug (ceiling division)
+    int64_t delta_ug = (int64_t)((double)kg * 1.0e9) - m_offset_ug;
+    int64_t n = delta_ug / m_scale_ug;
+    if (n * m_scale_ug < delta_ug) {
+        n++;
+    }
+    if (n > INT32_MAX) return INT32_MAX;
+    if (n < INT32_MIN) return INT32_MIN;
+    return (int32_t)n;
+}
+
+void ForceSensor::updateFixedCalibration() {
+    float abs_scale = (m_scale < 0.0f) ? -m_scale : m_scale;
+    int32_t scale_ug = (int32_t)((double)abs_scale * 1.0e9 + 0.5);
+    int64_t offset_ug = (int64_t)((double)(m_offset_kg + m_zero_trim_kg) * 1.0e9);
+    int32_t sign = (m_lin_count >= 2) ? m_lin_sign : ((m_scale < 0.0f) ? -1 : 1);
+    
+    g_controlTick.mask();
+    m_scale_ug = scale_ug;
+    m_offset_ug = offset_ug;
+    m_count_sign = sign;
+    g_controlTick.unmask();
+}
+
+int32_t ForceSensor::filterSample(int32_t raw_adc) {
+    if (m_filter_reset) {
+        m_filter_reset = false;
+        m_median_count = 0;
+        m_median_index = 0;
+        m_iir_valid = false;
+    }
+    
+    // Median stage - rejects spikes shorter than half the window
+    int32_t value = raw_adc;
+    uint8_t window = m_filter_median;
+    if (window > 1) {
+        m_median_buf[m_median_index] = raw_adc;
+        m_median_index = (uint8_t)((m_median_index + 1) % window);
+        if (m_median_count < window) {
+            m_median_count++;
+        }
         
-        // Apply calibration equation: kg = (raw_adc × scale) + offset
-        m_force_kg = (raw_adc * m_scale) + m_offset_kg;
-        m_last_reading_time = Milliseconds();
+        // Insertion sort of at most 5 values
+        int32_t sorted[FORCE_FILTER_MEDIAN_MAX];
+        uint8_t n = m_median_count;
+        for (uint8_t i = 0; i < n; i++) {
+            int32_t v = m_median_buf[i];
+            int8_t j = (int8_t)i - 1;
+            while (j >= 0 && sorted[j] > v) {
+                sorted[j + 1] = sorted[j];
+                j--;
+            }
+            sorted[j + 1] = v;
+        }
+        value = sorted[n / 2];
+    }
+    
+    // IIR stage in Q16.16 so the output is bit-exact across units
+    float alpha = m_filter_alpha;
+    if (alpha < 1.0f) {
+        int64_t alpha_q16 = (int64_t)(alpha * 65536.0f + 0.5f);
+        int64_t x_q16 = (int64_t)value << 16;
+        if (!m_iir_valid) {
+            m_iir_state = x_q16;
+            m_iir_valid = true;
+        } else {
+            m_iir_state += (alpha_q16 * (x_q16 - m_iir_state)) >> 16;
+        }
+        value = (int32_t)((m_iir_state + 0x8000) >> 16);
+    }
+    return value;
+}
+
+bool ForceSensor::setFilter(uint8_t median_window, float alpha) {
+    if (median_window != 1 && median_window != 3 && median_window != 5) {
+        return false;
+    }
+    if (!(alpha >= FORCE_FILTER_ALPHA_MIN && alpha <= 1.0f)) {
+        return false;
+    }
+    m_filter_median = median_window;
+    m_filter_alpha = alpha;
+    m_filter_reset = true;
+    if (m_channel != 0) {
+        return true;  // Only channel 0 owns the stored filter settings
     }
+    
+    PressSettings& settings = g_settings.edit();
+    settings.filter_median = median_window;
+    settings.filter_alpha = alpha;
+    return true;
+}
+
+void ForceSensor::armTrip(int32_t limit_counts, ForceTripHook hook, void* context,
+                          uint32_t lead_us, int32_t predict_counts) {
+    // Fully configure before arming - serviceRx may run between any two statements
+    m_trip_armed = false;
+    m_trip_limit_counts = limit_counts;
+    m_trip_lead_us = lead_us;
+    m_trip_predict_counts = predict_counts;
+    m_trip_rate = 0.0f;
+    m_trip_prev_us = 0;
+    m_trip_predicted = false;
+    m_trip_hook = hook;
+    m_trip_context = context;
+    m_trip_fired = false;
+    m_trip_armed = true;
+}
+
+void ForceSensor::setTripLimit(int32_t limit_counts, int32_t predict_counts) {
+    if (!m_trip_armed) {
+        return;
+    }
+    m_trip_limit_counts = limit_counts;
+    m_trip_predict_counts = predict_counts;
+}
+
+void ForceSensor::disarmTrip() {
+    m_trip_armed = false;
+    m_trip_fired = false;
+    m_trip_predicted = false;
 }
 
 bool ForceSensor::isConnected() const {
-    // Consider connected if we received data in the last second
-    return (Milliseconds() - m_last_reading_time) < 1000;
+    // Consider connected if we received data in the last FORCE_SENSOR_TIMEOUT_MS.
+    // Snapshot first, with the tick masked: the receive ISR writes the 64-bit time in two halves.
+    g_controlTick.mask();
+    uint64_t last = m_last_reading_us;
+    g_controlTick.unmask();
+    return last != 0 && MonotonicUs() - last < (uint64_t)FORCE_SENSOR_TIMEOUT_MS * 1000u;
+}
+
+void ForceSensor::getHealth(ForceSensorHealth* out) const {
+    g_controlTick.mask();
+    uint64_t last = m_last_reading_us;
+    out->rate_hz = (float)m_rate_mhz * 0.001f;
+    out->jitter_us = m_jitter_us;
+    out->max_gap_us = m_max_gap_us;
+    out->parse_errors = m_parse_errors;
+    out->line_overflows = m_line_overflows;
+    out->uart_overflows = m_uart_overflows;
+    out->crc_errors = m_crc_errors;
+    out->dropped_samples = m_dropped_samples;
+    out->ring_overruns = m_ring_overruns;
+    out->stuck_events = m_stuck_events;
+    out->stuck = m_stuck_run >= FORCE_HEALTH_STUCK_SAMPLES;
+    g_controlTick.unmask();
+    out->link_baud = kLinkBauds[m_link_baud];
+    out->link_rate_hz = (m_link_rate_mask != 0) ? kLinkRatesHz[m_link_rate] : 0;
+
+    // No sample closes the window of a sensor that went quiet; age it here instead
+    uint64_t since = (last != 0) ? MonotonicUs() - last : 0;
+    if (last == 0 || since > (uint64_t)FORCE_HEALTH_WINDOW_MS * 1000u) {
+        out->rate_hz = 0.0f;
+        out->jitter_us = 0;
+        out->max_gap_us = (since > UINT32_MAX) ? UINT32_MAX : (uint32_t)since;
+    }
+}
+
+uint32_t ForceSensor::getErrorCount() const {
+    return m_parse_errors + m_line_overflows + m_uart_overflows + m_crc_errors + m_dropped_samples + m_ring_overruns;
 }
 
 void ForceSensor::tare() {
@@ -87,71 +716,459 @@ void ForceSensor::tare() {
 
 void ForceSensor::setOffset(float offset_kg) {
     m_offset_kg = offset_kg;
-    // Store as int32 (reinterpret float bits as int32)
-    int32_t offset_bits;
-    memcpy(&offset_bits, &offset_kg, sizeof(float));
-    
-    // Access NvmMgr from ClearCore namespace
-    NvmManager &nvmMgr = NvmManager::Instance();
-    nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_OFFSET), offset_bits);
+    m_zero_trim_kg = 0.0f;
+    m_zero_at_limit = false;
+    m_zero_count = 0;
+    updateFixedCalibration();
+    g_settings.setJournaled(m_channel ? NVM_JOURNAL_KEY_FORCE_OFFSET_B : NVM_JOURNAL_KEY_FORCE_OFFSET_A, offset_kg);
+}
+
+void ForceSensor::sendLinkFrame(uint8_t type, uint8_t p0, uint8_t p1) {
+    uint8_t frame[FORCE_LINK_FRAME_LENGTH] = { FORCE_LINK_FRAME_SYNC, type, p0, p1, 0, 0, 0, 0 };
+    frame[FORCE_LINK_FRAME_LENGTH - 1] = frameCrc8(&frame[1], FORCE_LINK_FRAME_LENGTH - 2);
+    for (uint8_t i = 0; i < FORCE_LINK_FRAME_LENGTH; i++) {
+        m_port->SendChar(frame[i]);
+    }
+    m_link_sent_ms = Milliseconds();
+}
+
+void ForceSensor::requestLinkSwitch(uint8_t baud, uint8_t rate) {
+    m_link_target_baud = baud;
+    m_link_target_rate = rate;
+    m_link_state = LINK_SWITCH;
+    m_link_attempts = 1;
+    sendLinkFrame(kLinkFrameSet, baud, rate);
+}
+
+void ForceSensor::setLinkBaud(uint8_t baud) {
+    if (baud == m_link_baud) {
+        return;
+    }
+    m_port->Speed(kLinkBauds[baud]);
+    m_link_baud = baud;
+    // What arrives while both ends change over is noise; serviceRx() drops it and resynchronizes
+    m_setup_time = Milliseconds();
+    m_settling = true;
+}
+
+/**
+ * @details The transducer acknowledges a switch at the old baud and changes over once the
+ * acknowledgement has gone out; it returns to 115200 baud by itself after
+ * FORCE_LINK_REVERT_MS without a control frame, so a switch that is lost either way ends
+ * with both ends back at the default. Error windows restart after every change, and the
+ * cap only comes back up when a proven setting goes silent (transducer restarted or unplugged).
+ */
+bool ForceSensor::serviceLink(bool allowed) {
+#if FORCE_LINK_NEGOTIATE_ENABLED
+#if FORCE_REPLAY_ENABLED
+    if (m_channel == 0 && g_forceReplay.isActive()) {
+        return false;
+    }
+#endif
+    if (m_settling) {
+        return false;
+    }
+    uint32_t now = Milliseconds();
+
+    uint8_t reply[FORCE_LINK_FRAME_LENGTH];
+    bool replied = false;
+    if (m_link_replies != m_link_seen) {
+        g_controlTick.mask();
+        for (uint8_t i = 0; i < FORCE_LINK_FRAME_LENGTH; i++) {
+            reply[i] = m_link_reply[i];
+        }
+        m_link_seen = m_link_replies;
+        g_controlTick.unmask();
+        replied = true;
+    }
+
+    bool changed = false;
+    switch (m_link_state) {
+        case LINK_START:
+            // Wait for the transducer's first sample: it ignores us while it boots
+            if (isConnected()) {
+                m_link_state = LINK_QUERY;
+                m_link_attempts = 1;
+                sendLinkFrame(kLinkFrameQuery);
+            }
+            break;
+
+        case LINK_QUERY:
+            if (replied && reply[1] == kLinkFrameCaps) {
+                m_link_baud_mask = (uint8_t)((reply[3] & ((1u << kLinkBaudCount) - 1)) | 1u);
+                m_link_rate_mask = (uint8_t)(reply[4] & ((1u << kLinkRateCount) - 1));
+                m_link_rate = (reply[6] < kLinkRateCount) ? reply[6] : 0;
+                m_link_rate_mask |= (uint8_t)(1u << m_link_rate);
+                m_link_target_rate = linkIndexAtOrBelow(m_link_rate_mask, kLinkRateCount - 1);
+                uint8_t fastest = linkIndexAtOrBelow(m_link_baud_mask, kLinkBaudCount - 1);
+                if (m_link_cap > fastest) {
+                    m_link_cap = fastest;
+                }
+                m_link_state = LINK_STEADY;
+                m_link_measuring = false;
+                changed = true;
+            } else if (now - m_link_sent_ms >= FORCE_LINK_REPLY_MS) {
+                if (m_link_attempts >= FORCE_LINK_ATTEMPTS) {
+                    m_link_state = LINK_FIXED;
+                    m_link_since = now;
+                } else {
+                    m_link_attempts++;
+                    sendLinkFrame(kLinkFrameQuery);
+                }
+            }
+            break;
+
+        case LINK_FIXED:
+            if (now - m_link_since >= FORCE_LINK_RETRY_MS) {
+                m_link_state = LINK_START;
+            }
+            break;
+
+        case LINK_SWITCH:
+            if (replied && reply[1] == kLinkFrameAck && reply[2] == m_link_target_baud &&
+                reply[3] == m_link_target_rate) {
+                setLinkBaud(m_link_target_baud);
+                m_link_rate = m_link_target_rate;
+                m_link_state = LINK_PROBATION;
+                m_link_measuring = false;
+                // Confirm at the new baud straight away
+                m_link_sent_ms = now - FORCE_LINK_KEEPALIVE_MS;
+                changed = true;
+            } else if (now - m_link_sent_ms >= FORCE_LINK_REPLY_MS) {
+                if (m_link_attempts < FORCE_LINK_ATTEMPTS) {
+                    m_link_attempts++;
+                    sendLinkFrame(kLinkFrameSet, m_link_target_baud, m_link_target_rate);
+                    break;
+                }
+                // Unknown whether the transducer switched: meet it at the default
+                if (m_link_cap > m_link_baud) {
+                    m_link_cap = m_link_baud;
+                }
+                changed = (m_link_baud != 0);
+                setLinkBaud(0);
+                m_link_rate_mask = 0;
+                m_link_state = LINK_REVERT;
+                m_link_since = now;
+            }
+            break;
+
+        case LINK_PROBATION:
+        case LINK_STEADY: {
+            if (!isConnected()) {
+                // A silent new setting failed; a silent proven one is a restarted or unplugged transducer
+                if (m_link_state == LINK_PROBATION && m_link_baud > 0) {
+                    m_link_cap = (uint8_t)(m_link_baud - 1);
+                } else {
+                    m_link_cap = 0xFF;
+                }
+                changed = (m_link_baud != 0);
+                setLinkBaud(0);
+                m_link_rate_mask = 0;
+                m_link_state = changed ? LINK_REVERT : LINK_START;
+                m_link_since = now;
+                break;
+            }
+            if (now - m_link_sent_ms >= FORCE_LINK_KEEPALIVE_MS) {
+                sendLinkFrame(kLinkFrameKeepalive, m_link_baud, m_link_rate);
+            }
+            if (!m_link_measuring) {
+                if (!m_seq_valid) {
+                    // Still hunting for the first frame after a change: a false sync is not a link error
+                    break;
+                }
+                m_link_since = now;
+                m_link_errors = linkErrorCount();
+                m_link_samples = m_sample_count;
+                m_link_measuring = true;
+                break;
+            }
+            uint32_t errors = linkErrorCount() - m_link_errors;
+
+            if (m_link_state == LINK_PROBATION) {
+                uint32_t expected = (uint32_t)kLinkRatesHz[m_link_rate] * FORCE_LINK_PROBATION_MS / 2000u;
+                bool failed = errors > 0;
+                if (!failed && now - m_link_since < FORCE_LINK_PROBATION_MS) {
+                    break;
+                }
+                if (!failed && m_sample_count - m_link_samples < expected) {
+                    // Fewer than half the samples the rate promises
+                    failed = true;
+                }
+                if (failed) {
+                    if (m_link_baud > 0) {
+                        m_link_cap = (uint8_t)(m_link_baud - 1);
+                    } else {
+                        m_link_target_rate = m_link_rate;
+                    }
+                }
+                // Stepping back down waits in LINK_STEADY until the press is idle again
+                m_link_state = LINK_STEADY;
+                m_link_measuring = false;
+                break;
+            }
+
+            if (now - m_link_since >= FORCE_HEALTH_WINDOW_MS) {
+                if (errors >= FORCE_LINK_MAX_ERRORS && m_link_baud > 0 && m_link_cap >= m_link_baud) {
+                    m_link_cap = (uint8_t)(m_link_baud - 1);
+                }
+                m_link_measuring = false;
+            }
+            if (!allowed) {
+                break;
+            }
+            if (m_link_baud > m_link_cap) {
+                requestLinkSwitch(linkIndexAtOrBelow(m_link_baud_mask, m_link_cap), m_link_rate);
+            } else if (m_link_rate != m_link_target_rate) {
+                requestLinkSwitch(m_link_baud, m_link_target_rate);
+            } else if (m_link_baud < m_link_cap) {
+                uint8_t next = linkIndexAtOrBelow(m_link_baud_mask, m_link_cap);
+                for (uint8_t i = (uint8_t)(m_link_baud + 1); i <= m_link_cap && i < kLinkBaudCount; i++) {
+                    if (m_link_baud_mask & (1u << i)) {
+                        next = i;
+                        break;
+                    }
+                }
+                if (next > m_link_baud) {
+                    requestLinkSwitch(next, m_link_rate);
+                } else {
+                    m_link_cap = m_link_baud;
+                }
+            }
+            break;
+        }
+
+        case LINK_REVERT:
+            if (now - m_link_since >= FORCE_LINK_REVERT_MS + FORCE_LINK_REPLY_MS) {
+                m_link_state = LINK_START;
+            }
+            break;
+    }
+    return changed;
+#else
+    (void)allowed;
+    return false;
+#endif
+}
+
+/**
+ * @details A sample is taken when getLastSampleTimeUs() has moved, so each reading counts
+ * once however fast the loop runs. The filtered channel already reads out the trim, so the
+ * average is the drift still left; correcting a fraction of it per batch makes the trim a
+ * slow low-pass of the idle reading that noise and a single odd batch barely move.
+ */
+bool ForceSensor::trackZero(bool allowed) {
+#if FORCE_ZERO_TRACK_ENABLED
+    uint32_t now = Milliseconds();
+    if (!allowed) {
+        m_zero_allowed = false;
+        m_zero_count = 0;
+        return false;
+    }
+    if (!m_zero_allowed) {
+        m_zero_allowed = true;
+        m_zero_idle_since = now;
+        m_zero_count = 0;
+    }
+    if (now - m_zero_idle_since < FORCE_ZERO_TRACK_SETTLE_MS || m_settling || !isConnected()) {
+        return false;
+    }
+    uint32_t sample_us = m_last_sample_time_us;
+    if (sample_us == m_zero_last_us) {
+        return false;
+    }
+    m_zero_last_us = sample_us;
+
+    float kg = m_filtered_kg;
+    if (m_zero_count == 0) {
+        m_zero_sum = 0.0f;
+        m_zero_min = kg;
+        m_zero_max = kg;
+    }
+    m_zero_sum += kg;
+    m_zero_min = (kg < m_zero_min) ? kg : m_zero_min;
+    m_zero_max = (kg > m_zero_max) ? kg : m_zero_max;
+    if (++m_zero_count < FORCE_ZERO_TRACK_SAMPLES) {
+        return false;
+    }
+    m_zero_count = 0;
+
+    float mean = m_zero_sum / (float)FORCE_ZERO_TRACK_SAMPLES;
+    if (fabsf(mean) > FORCE_ZERO_TRACK_WINDOW_KG || m_zero_max - m_zero_min > FORCE_ZERO_TRACK_SPREAD_KG) {
+        return false;
+    }
+    float trim = m_zero_trim_kg - mean * FORCE_ZERO_TRACK_GAIN;
+    bool at_limit = false;
+    if (trim > FORCE_ZERO_TRACK_LIMIT_KG) {
+        trim = FORCE_ZERO_TRACK_LIMIT_KG;
+        at_limit = true;
+    } else if (trim < -FORCE_ZERO_TRACK_LIMIT_KG) {
+        trim = -FORCE_ZERO_TRACK_LIMIT_KG;
+        at_limit = true;
+    }
+    m_zero_trim_kg = trim;
+    updateFixedCalibration();
+
+    bool reached = at_limit && !m_zero_at_limit;
+    m_zero_at_limit = at_limit;
+    return reached;
+#else
+    (void)allowed;
+    return false;
+#endif
 }
 
 void ForceSensor::setScale(float scale) {
     m_scale = scale;
-    // Store as int32 (reinterpret float bits as int32)
-    int32_t scale_bits;
-    memcpy(&scale_bits, &scale, sizeof(float));
-    
-    // Access NvmMgr from ClearCore namespace
-    NvmManager &nvmMgr = NvmManager::Instance();
-    nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_SCALE), scale_bits);
+    updateFixedCalibration();
+    g_settings.edit().force_scale[m_channel] = scale;
 }
 
+// Values were range-checked by SettingsStore::load()
 void ForceSensor::loadCalibrationFromNVM() {
-    // Access NvmMgr from ClearCore namespace
-    NvmManager &nvmMgr = NvmManager::Instance();
+    const PressSettings& settings = g_settings.get();
+    m_offset_kg = settings.force_offset_kg[m_channel];
+    m_scale = settings.force_scale[m_channel];
+}
+
+void ForceSensor::loadFilterFromNVM() {
+    const PressSettings& settings = g_settings.get();
+    m_filter_median = settings.filter_median;
+    m_filter_alpha = settings.filter_alpha;
+    m_filter_reset = true;
+    m_latency_us = settings.force_latency_us;
+}
+
+bool ForceSensor::setLatencyUs(uint32_t latency_us) {
+    if (latency_us > FORCE_LATENCY_US_MAX) {
+        return false;
+    }
+    m_latency_us = latency_us;
+    if (m_channel != 0) {
+        return true;
+    }
+    g_settings.edit().force_latency_us = latency_us;
+    return true;
+}
+
+bool ForceSensor::getLinearizationPoint(uint8_t index, int32_t* raw, float* kg) const {
+    if (index >= m_lin_count) {
+        return false;
+    }
+    *raw = m_lin_raw[index];
+    *kg = m_lin_kg[index];
+    return true;
+}
+
+bool ForceSensor::applyLinearization(const int32_t* raw, const float* kg, uint8_t count) {
+    int32_t step = 0;
+    int32_t sign = 1;
+    int64_t ug[FORCE_TABLE_MAX_POINTS];
+    int64_t slope_q16[FORCE_TABLE_MAX_POINTS];
     
-    // Load offset
-    int32_t offset_bits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_OFFSET));
-    // Check if NVM contains valid data (non-zero and not 0xFFFFFFFF which is erased flash)
-    if (offset_bits != 0 && offset_bits != -1) {
-        float temp_offset;
-        memcpy(&temp_offset, &offset_bits, sizeof(float));
-        // Validate offset is in reasonable range (-50 to +50 kg)
-        if (temp_offset > -50.0f && temp_offset < 50.0f) {
-            m_offset_kg = temp_offset;
-        } else {
-            // Invalid - write default to NVM
-            int32_t default_bits;
-            memcpy(&default_bits, &m_offset_kg, sizeof(float));
-            nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_OFFSET), default_bits);
+    if (count != 0) {
+        if (count < 2 || count > FORCE_TABLE_MAX_POINTS) {
+            return false;
         }
-    } else {
-        // Empty NVM - initialize with default from config.h
-        int32_t default_bits;
-        memcpy(&default_bits, &m_offset_kg, sizeof(float));
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_OFFSET), default_bits);
-    }
-    
-    // Load scale
-    int32_t scale_bits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_SCALE));
-    if (scale_bits != 0 && scale_bits != -1) {
-        float temp_scale;
-        memcpy(&temp_scale, &scale_bits, sizeof(float));
-        // Validate scale is in reasonable range (-0.01 to +0.01, excluding very small values)
-        if ((temp_scale > -0.01f && temp_scale < -0.00001f) || (temp_scale > 0.00001f && temp_scale < 0.01f)) {
-            m_scale = temp_scale;
-        } else {
-            // Invalid - write default to NVM
-            int32_t default_bits;
-            memcpy(&default_bits, &m_scale, sizeof(float));
-            nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_SCALE), default_bits);
+        if (kg[count - 1] == kg[0]) {
+            return false;
         }
-    } else {
-        // Empty NVM - initialize with default from config.h
-        int32_t default_bits;
-        memcpy(&default_bits, &m_scale, sizeof(float));
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_LOC_FORCE_SCALE), default_bits);
+        sign = (kg[count - 1] > kg[0]) ? 1 : -1;
+        step = raw[1] - raw[0];
+        for (uint8_t i = 0; i < count; i++) {
+            ug[i] = (int64_t)((double)kg[i] * 1.0e9);
+        }
+        for (uint8_t i = 0; i + 1 < count; i++) {
+            // Raw strictly increasing, kg monotonic in one direction
+            if (raw[i + 1] <= raw[i]) {
+                return false;
+            }
+            if ((sign > 0 && kg[i + 1] < kg[i]) || (sign < 0 && kg[i + 1] > kg[i])) {
+                return false;
+            }
+            int32_t dx = raw[i + 1] - raw[i];
+            if (dx != step) {
+                step = 0;
+            }
+            slope_q16[i] = ((ug[i + 1] - ug[i]) * 65536) / dx;
+        }
+        slope_q16[count - 1] = slope_q16[count - 2];
+    }
+    
+    // ISR must never see a half-written table
+    g_controlTick.mask();
+    for (uint8_t i = 0; i < count; i++) {
+        m_lin_raw[i] = raw[i];
+        m_lin_kg[i] = kg[i];
+        m_lin_ug[i] = ug[i];
+        m_lin_slope_q16[i] = slope_q16[i];
+    }
+    m_lin_step = step;
+    m_lin_sign = sign;
+    m_lin_count = count;
+    g_controlTick.unmask();
+    updateFixedCalibration();
+    return true;
+}
+
+bool ForceSensor::setLinearization(const int32_t* raw, const float* kg, uint8_t count) {
+    if (!applyLinearization(raw, kg, count)) {
+        return false;
+    }
+    if (m_channel != 0) {
+        return true;  // Table slots belong to channel 0
+    }
+    
+    // Staged only: a write from here would erase the user page in command dispatch
+    for (uint8_t i = 0; i < count; i++) {
+        m_lin_nvm[i * 2] = raw[i];
+        memcpy(&m_lin_nvm[i * 2 + 1], &kg[i], sizeof(float));
     }
+    m_lin_nvm_count = count;
+    m_lin_nvm_pending = true;
+    return true;
 }
 
+bool ForceSensor::commitLinearization() {
+    if (!m_lin_nvm_pending) {
+        return true;
+    }
+    NvmManager &nvmMgr = NvmManager::Instance();
+    if (m_lin_nvm_count > 0 &&
+        !nvmMgr.BlockWrite(static_cast<NvmManager::NvmLocations>(NVM_SLOT_FORCE_TABLE_POINTS * 4),
+                           m_lin_nvm_count * 2 * sizeof(int32_t), reinterpret_cast<const uint8_t*>(m_lin_nvm))) {
+        return false;
+    }
+    // Count last, so an interrupted upload never loads a partial table
+    if (!nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_FORCE_TABLE_COUNT * 4), m_lin_nvm_count)) {
+        return false;
+    }
+    m_lin_nvm_pending = false;
+    return true;
+}
+
+void ForceSensor::eraseLinearization() {
+    m_lin_nvm_pending = false;
+    // Erasing the count is enough to drop the table
+    NvmManager::Instance().Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_FORCE_TABLE_COUNT * 4), -1);
+}
+
+void ForceSensor::loadLinearizationFromNVM() {
+    NvmManager &nvmMgr = NvmManager::Instance();
+    
+    // Erased (-1) or zero count means no table: linear scale+offset
+    int32_t count = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_FORCE_TABLE_COUNT * 4));
+    if (count < 2 || count > FORCE_TABLE_MAX_POINTS) {
+        return;
+    }
+    
+    int32_t raw[FORCE_TABLE_MAX_POINTS];
+    float kg[FORCE_TABLE_MAX_POINTS];
+    for (int32_t i = 0; i < count; i++) {
+        int slot = NVM_SLOT_FORCE_TABLE_POINTS + i * 2;
+        raw[i] = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(slot * 4));
+        int32_t kg_bits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>((slot + 1) * 4));
+        memcpy(&kg[i], &kg_bits, sizeof(float));
+    }
+    // A corrupt table is ignored rather than half-applied
+    applyLinearization(raw, kg, (uint8_t)count);
+}
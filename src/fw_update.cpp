@@ -0,0 +1,361 @@
+/**
+ * @file fw_update.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the network firmware update.
+ */
+
+#include "fw_update.h"
+
+#if FW_UPDATE_ENABLED
+
+#include <sam.h>
+#include <stdio.h>
+#include <string.h>
+
+// Linker script symbols (flash_with_bootloader.ld / flash_without_bootloader.ld)
+extern uint32_t __text_start__;
+extern uint32_t __etext;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+
+static const uint32_t kPageBytes = MAIN_FLASH_PAGE_WORDS * 4u;
+static const uint32_t kBlockBytes = 8192u;      // SAME53 erase block: 16 pages
+
+static_assert((FW_UPDATE_STAGING_ADDR % kBlockBytes) == 0, "Staging area must start on an erase block");
+static_assert(FW_UPDATE_STAGING_ADDR + FW_UPDATE_MAX_BYTES <= PROFILE_FLASH_ADDR, "Staging area overlaps the calibration profiles");
+
+// Global firmware update instance
+FirmwareUpdate g_firmwareUpdate;
+
+static uint32_t roundUp(uint32_t value, uint32_t unit) {
+    return (value + unit - 1u) / unit * unit;
+}
+
+// CRC-32 (IEEE, reflected) register update, as SettingsStore::crc32() without the final invert
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return crc;
+}
+
+FirmwareUpdate::FirmwareUpdate()
+    : m_server(FW_UPDATE_PORT) {
+    memset(m_page, 0xFF, sizeof(m_page));
+    m_fillBytes = 0;
+    m_fillPage = 0;
+    m_pagePending = false;
+    m_flashBusy = false;
+    m_state = FW_UPDATE_STATE_IDLE;
+    m_size = 0;
+    m_expectedCrc = 0;
+    m_received = 0;
+    m_eraseAddress = FW_UPDATE_STAGING_ADDR;
+    m_writeAddress = FW_UPDATE_STAGING_ADDR;
+    m_verifyOffset = 0;
+    m_runningCrc = 0xFFFFFFFF;
+    m_progressMs = 0;
+    m_applyMs = 0;
+    m_error = "";
+}
+
+/**
+ * @details The image is copied to where the running one starts, so it must be linked with
+ * the same script; the vector table check in serviceVerify() catches one that is not.
+ */
+bool FirmwareUpdate::begin(uint32_t size, uint32_t crc, uint32_t now_ms) {
+    uint32_t base = (uint32_t)&__text_start__;
+    uint32_t running_end = (uint32_t)&__etext + ((uint32_t)&__data_end__ - (uint32_t)&__data_start__);
+    if (size == 0 || size > FW_UPDATE_MAX_BYTES || base + size > FW_UPDATE_STAGING_ADDR ||
+        running_end > FW_UPDATE_STAGING_ADDR || (base % kBlockBytes) != 0) {
+        return false;
+    }
+    cancel();
+    m_server.Begin();   // Listens from the first update on; later calls do nothing
+    m_size = size;
+    m_expectedCrc = crc;
+    m_eraseAddress = FW_UPDATE_STAGING_ADDR;
+    m_writeAddress = FW_UPDATE_STAGING_ADDR;
+    m_progressMs = now_ms;
+    m_error = "";
+    m_state = FW_UPDATE_STATE_ERASING;
+    return true;
+}
+
+void FirmwareUpdate::cancel() {
+    m_client.Close();
+    m_fillBytes = 0;
+    m_fillPage = 0;
+    m_pagePending = false;
+    m_received = 0;
+    m_verifyOffset = 0;
+    m_runningCrc = 0xFFFFFFFF;
+    // An erase or write in flight runs to its end; the next operation waits for it
+    m_flashBusy = false;
+    m_state = FW_UPDATE_STATE_IDLE;
+}
+
+bool FirmwareUpdate::apply(uint32_t now_ms) {
+    if (m_state != FW_UPDATE_STATE_STAGED) {
+        return false;
+    }
+    m_applyMs = now_ms;
+    m_state = FW_UPDATE_STATE_APPLYING;
+    return true;
+}
+
+bool FirmwareUpdate::isApplyDue(uint32_t now_ms) const {
+    return m_state == FW_UPDATE_STATE_APPLYING && now_ms - m_applyMs >= FW_UPDATE_APPLY_DELAY_MS;
+}
+
+bool FirmwareUpdate::ownsFlash() const {
+    return m_state == FW_UPDATE_STATE_ERASING || m_state == FW_UPDATE_STATE_RECEIVING ||
+           m_state == FW_UPDATE_STATE_APPLYING;
+}
+
+void FirmwareUpdate::service(uint32_t budget_us) {
+    if (m_state != FW_UPDATE_STATE_ERASING && m_state != FW_UPDATE_STATE_RECEIVING &&
+        m_state != FW_UPDATE_STATE_VERIFYING) {
+        return;
+    }
+    uint32_t start_us = Microseconds();
+    if (m_state == FW_UPDATE_STATE_VERIFYING) {
+        serviceVerify(start_us, budget_us);
+        return;
+    }
+    acceptClient();
+    bool progressed = true;
+    while (progressed && (m_state == FW_UPDATE_STATE_ERASING || m_state == FW_UPDATE_STATE_RECEIVING) &&
+           Microseconds() - start_us < budget_us) {
+        progressed = serviceProgram();
+        if (m_state == FW_UPDATE_STATE_RECEIVING) {
+            progressed = serviceReceive() || progressed;
+        }
+    }
+    if (m_state == FW_UPDATE_STATE_RECEIVING && m_received == m_size && m_fillBytes == 0 &&
+        !m_pagePending && !m_flashBusy) {
+        m_verifyOffset = 0;
+        m_runningCrc = 0xFFFFFFFF;
+        m_state = FW_UPDATE_STATE_VERIFYING;
+    } else if ((m_state == FW_UPDATE_STATE_ERASING || m_state == FW_UPDATE_STATE_RECEIVING) &&
+               Milliseconds() - m_progressMs > FW_UPDATE_STALL_MS) {
+        fail("stream stalled");
+    }
+}
+
+// One stream per update: a connection after the first byte, or beside another, is refused
+void FirmwareUpdate::acceptClient() {
+    EthernetTcpClient incoming = m_server.Accept();
+    if (!incoming.Connected()) {
+        return;
+    }
+    if (m_received > 0 || m_client.Connected()) {
+        incoming.Close();
+        return;
+    }
+    m_client.Close();
+    m_client = incoming;
+    m_progressMs = Milliseconds();
+}
+
+/**
+ * @details Starts at most one NVMCTRL operation: the next staging erase, then the page
+ * waiting in the double buffer. main_flash_start_write() copies the page into NVMCTRL's
+ * page buffer, so the RAM buffer is free again as soon as the write starts.
+ * @return true if an operation finished or started
+ */
+bool FirmwareUpdate::serviceProgram() {
+    bool progressed = false;
+    if (m_flashBusy) {
+        if (!main_flash_ready()) {
+            return false;
+        }
+        m_flashBusy = false;
+        if (main_flash_errors() != 0) {
+            fail("flash refused a staging erase or write");
+            return false;
+        }
+        m_progressMs = Milliseconds();
+        progressed = true;
+    }
+    if (!main_flash_ready()) {
+        return progressed;
+    }
+    if (m_state == FW_UPDATE_STATE_ERASING) {
+        if (m_eraseAddress >= FW_UPDATE_STAGING_ADDR + roundUp(m_size, kBlockBytes)) {
+            m_state = FW_UPDATE_STATE_RECEIVING;
+            return true;
+        }
+        main_flash_start_erase(m_eraseAddress);
+        m_eraseAddress += kBlockBytes;
+        m_flashBusy = true;
+        return true;
+    }
+    if (m_pagePending) {
+        main_flash_start_write(m_writeAddress, m_page[m_fillPage ^ 1], MAIN_FLASH_PAGE_WORDS);
+        m_writeAddress += kPageBytes;
+        m_pagePending = false;
+        m_flashBusy = true;
+        progressed = true;
+    }
+    return progressed;
+}
+
+/**
+ * @details A full page (or the padded last one) is handed to serviceProgram() when the
+ * other buffer is free. With both buffers full nothing is read, and the host waits on the
+ * TCP window.
+ * @return true if bytes were read or a page was handed over
+ */
+bool FirmwareUpdate::serviceReceive() {
+    uint8_t* fill = reinterpret_cast<uint8_t*>(m_page[m_fillPage]);
+    bool progressed = false;
+    if (m_fillBytes == kPageBytes || (m_fillBytes > 0 && m_received == m_size)) {
+        if (m_pagePending) {
+            return false;
+        }
+        memset(fill + m_fillBytes, 0xFF, kPageBytes - m_fillBytes);
+        m_pagePending = true;
+        m_fillPage ^= 1;
+        m_fillBytes = 0;
+        fill = reinterpret_cast<uint8_t*>(m_page[m_fillPage]);
+        progressed = true;
+    }
+    if (m_received == m_size) {
+        return progressed;
+    }
+    uint32_t want = kPageBytes - m_fillBytes;
+    if (want > m_size - m_received) {
+        want = m_size - m_received;
+    }
+    int16_t count = m_client.Read(fill + m_fillBytes, want);
+    if (count > 0) {
+        m_fillBytes += (uint16_t)count;
+        m_received += (uint32_t)count;
+        m_progressMs = Milliseconds();
+        return true;
+    }
+    // Bytes the host sent before closing are still read above
+    if (m_received > 0 && !m_client.Connected()) {
+        fail("connection closed before the whole image arrived");
+    }
+    return progressed;
+}
+
+/**
+ * @details Reads the image back from the staging area, so a page that programmed wrong
+ * fails the check as surely as a corrupt stream. Once the CRC matches, the staged vector
+ * table must hold a stack pointer in SRAM and a Thumb reset handler inside the image at
+ * the running image's vector table offset.
+ */
+void FirmwareUpdate::serviceVerify(uint32_t start_us, uint32_t budget_us) {
+    const uint8_t* staged = reinterpret_cast<const uint8_t*>(FW_UPDATE_STAGING_ADDR);
+    while (m_verifyOffset < m_size && Microseconds() - start_us < budget_us) {
+        uint32_t length = m_size - m_verifyOffset;
+        if (length > FW_UPDATE_VERIFY_BYTES) {
+            length = FW_UPDATE_VERIFY_BYTES;
+        }
+        m_runningCrc = crc32Update(m_runningCrc, staged + m_verifyOffset, length);
+        m_verifyOffset += length;
+    }
+    if (m_verifyOffset < m_size) {
+        return;
+    }
+    if (~m_runningCrc != m_expectedCrc) {
+        fail("CRC mismatch");
+        return;
+    }
+    uint32_t base = (uint32_t)&__text_start__;
+    uint32_t vector_offset = SCB->VTOR - base;
+    if (vector_offset + 8u > m_size) {
+        fail("image has no vector table");
+        return;
+    }
+    const uint32_t* vectors = reinterpret_cast<const uint32_t*>(FW_UPDATE_STAGING_ADDR + vector_offset);
+    uint32_t reset = vectors[1] & ~1u;
+    if (vectors[0] <= HSRAM_ADDR || vectors[0] > HSRAM_ADDR + HSRAM_SIZE || (vectors[1] & 1u) == 0 ||
+        reset < base || reset >= base + m_size) {
+        fail("vector table does not fit this press");
+        return;
+    }
+    char reply[24];
+    snprintf(reply, sizeof(reply), "OK %08lX\n", (unsigned long)m_expectedCrc);
+    finishStream(reply);
+    m_state = FW_UPDATE_STATE_STAGED;
+}
+
+void FirmwareUpdate::fail(const char* reason) {
+    m_error = reason;
+    m_state = FW_UPDATE_STATE_FAILED;
+    char reply[64];
+    snprintf(reply, sizeof(reply), "ERROR %s\n", reason);
+    finishStream(reply);
+}
+
+// Tells the uploader how the update ended and closes its connection
+void FirmwareUpdate::finishStream(const char* reply) {
+    if (m_client.Connected()) {
+        m_client.Send(reinterpret_cast<const uint8_t*>(reply), (uint32_t)strlen(reply));
+    }
+    m_client.Close();
+}
+
+/**
+ * @details Runs from RAM (.data is copied there at start-up) with interrupts off: once the
+ * first application block is erased nothing in flash may execute, so it drives NVMCTRL
+ * itself instead of calling main_flash.cpp, copies through volatile pointers so the
+ * compiler cannot turn the loop into a memcpy() call, and resets through AIRCR directly.
+ */
+__attribute__((section(".data.fw_update_copy"), noinline, long_call, noreturn))
+static void copyStagedImage(uint32_t base, uint32_t pages) {
+    volatile const uint32_t* src = reinterpret_cast<volatile const uint32_t*>(FW_UPDATE_STAGING_ADDR);
+    NVMCTRL->CTRLA.bit.WMODE = NVMCTRL_CTRLA_WMODE_MAN;
+    for (uint32_t page = 0; page < pages; page++) {
+        uint32_t address = base + page * kPageBytes;
+        if ((address & (kBlockBytes - 1u)) == 0) {
+            NVMCTRL->ADDR.reg = address;
+            NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | NVMCTRL_CTRLB_CMD_EB;
+            while (!NVMCTRL->STATUS.bit.READY);
+        }
+        if (NVMCTRL->STATUS.bit.LOAD) {
+            NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | NVMCTRL_CTRLB_CMD_PBC;
+            while (!NVMCTRL->STATUS.bit.READY);
+        }
+        volatile uint32_t* dst = reinterpret_cast<volatile uint32_t*>(address);
+        for (uint32_t i = 0; i < MAIN_FLASH_PAGE_WORDS; i++) {
+            dst[i] = src[page * MAIN_FLASH_PAGE_WORDS + i];
+        }
+        NVMCTRL->ADDR.reg = address;
+        NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | NVMCTRL_CTRLB_CMD_WP;
+        while (!NVMCTRL->STATUS.bit.READY);
+    }
+    __DSB();
+    SCB->AIRCR = (0x5FAUL << SCB_AIRCR_VECTKEY_Pos) | SCB_AIRCR_SYSRESETREQ_Msk;
+    __DSB();
+    while (true);
+}
+
+void FirmwareUpdate::switchOver() {
+    // Whatever the stores or the last staging write started must finish first
+    while (!main_flash_ready());
+    copyStagedImage((uint32_t)&__text_start__, roundUp(m_size, kPageBytes) / kPageBytes);
+}
+
+const char* FirmwareUpdate::stateName(uint8_t state) {
+    switch (state) {
+        case FW_UPDATE_STATE_IDLE: return "idle";
+        case FW_UPDATE_STATE_ERASING: return "erasing";
+        case FW_UPDATE_STATE_RECEIVING: return "receiving";
+        case FW_UPDATE_STATE_VERIFYING: return "verifying";
+        case FW_UPDATE_STATE_STAGED: return "staged";
+        case FW_UPDATE_STATE_APPLYING: return "applying";
+        case FW_UPDATE_STATE_FAILED: return "failed";
+        default: return "unknown";
+    }
+}
+
+#endif // FW_UPDATE_ENABLED
@@ -0,0 +1,41 @@
+/**
+ * @file hil_test.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the marker outputs used to measure force trip latency on a bench.
+ */
+
+#include "hil_test.h"
+#include "ClearCore.h"
+#include <sam.h>
+
+#if HIL_TEST_ENABLED
+
+static DigitalInOut* const s_hilPins[HIL_SIGNAL_COUNT] = { &HIL_PIN_FORCE_CROSS, &HIL_PIN_STOP };
+static volatile bool s_hilLevel[HIL_SIGNAL_COUNT];
+
+void hil_setup() {
+    for (uint8_t i = 0; i < HIL_SIGNAL_COUNT; i++) {
+        s_hilLevel[i] = false;
+        s_hilPins[i]->Mode(Connector::OUTPUT_DIGITAL);
+        s_hilPins[i]->State(false);
+    }
+}
+
+/**
+ * @details The stop marker is toggled from both the receive ISR and the main loop, so the
+ * level flip and the pin write happen with interrupts masked.
+ */
+void hil_toggle(uint8_t signal) {
+    if (signal >= HIL_SIGNAL_COUNT) {
+        return;
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool level = !s_hilLevel[signal];
+    s_hilLevel[signal] = level;
+    s_hilPins[signal]->State(level);
+    __set_PRIMASK(primask);
+}
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file idle_work.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the idle-work queue.
+ */
+
+#include "idle_work.h"
+#include "ClearCore.h"
+#include <string.h>
+
+// Global idle-work queue instance
+IdleWork g_idleWork;
+
+IdleWork::IdleWork() {
+    memset(m_jobs, 0, sizeof(m_jobs));
+    m_head = 0;
+    m_count = 0;
+    m_allowed = false;
+    m_steps = 0;
+    m_preemptions = 0;
+    m_rejected = 0;
+    m_worst_step_us = 0;
+    m_worst_step_name = "none";
+}
+
+bool IdleWork::post(const char* name, IdleJobHook hook, void* context) {
+    for (uint8_t i = 0; i < m_count; i++) {
+        const IdleJob& job = m_jobs[(m_head + i) % IDLE_WORK_QUEUE_SIZE];
+        if (job.hook == hook && job.context == context) {
+            return true;
+        }
+    }
+    if (m_count >= IDLE_WORK_QUEUE_SIZE || hook == nullptr) {
+        m_rejected++;
+        return false;
+    }
+    IdleJob& job = m_jobs[(m_head + m_count) % IDLE_WORK_QUEUE_SIZE];
+    job.name = name;
+    job.hook = hook;
+    job.context = context;
+    m_count++;
+    return true;
+}
+
+void IdleWork::service(bool allowed, uint32_t budget_us) {
+    if (!allowed) {
+        if (m_allowed && m_count > 0) {
+            m_preemptions++;
+        }
+        m_allowed = false;
+        return;
+    }
+    m_allowed = true;
+
+    // Each job queued at the start gets one step; a job that has more to do goes to the back
+    uint32_t start = Microseconds();
+    uint8_t jobs = m_count;
+    for (uint8_t i = 0; i < jobs; i++) {
+        uint32_t now = Microseconds();
+        uint32_t spent = now - start;
+        if (i > 0 && spent >= budget_us) {
+            break;
+        }
+        IdleJob job = m_jobs[m_head];
+        m_head = (uint8_t)((m_head + 1) % IDLE_WORK_QUEUE_SIZE);
+        m_count--;
+        bool more = job.hook(job.context, (spent < budget_us) ? budget_us - spent : 0);
+        uint32_t elapsed = Microseconds() - now;
+        m_steps++;
+        if (elapsed > m_worst_step_us) {
+            m_worst_step_us = elapsed;
+            m_worst_step_name = job.name;
+        }
+        if (more) {
+            post(job.name, job.hook, job.context);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file loop_profiler.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the main-loop stage profiler.
+ */
+
+#include "loop_profiler.h"
+#include "ClearCore.h"
+#include "SysTiming.h"
+#include "timebase.h"
+#include <sam.h>
+#include <string.h>
+
+// Global loop profiler instance
+LoopProfiler g_loopProfiler;
+
+// DWT->CYCCNT wraps every ~35 s at 120 MHz, far longer than any stage
+static inline uint32_t cycleCount() {
+    return DWT->CYCCNT;
+}
+
+LoopProfiler::LoopProfiler() {
+    clearStats();
+    m_pass_start = 0;
+    m_stage_start = 0;
+    m_window_start_us = 0;
+    m_skip_pass = true;
+}
+
+void LoopProfiler::begin() {
+    m_pass_start = cycleCount();
+    m_stage_start = m_pass_start;
+    m_skip_pass = false;
+}
+
+void LoopProfiler::mark(LoopStage stage) {
+    uint32_t now = cycleCount();
+    if (!m_skip_pass) {
+        record(stage, now - m_stage_start);
+    }
+    m_stage_start = now;
+}
+
+void LoopProfiler::end() {
+    if (!m_skip_pass) {
+        record(LOOP_STAGE_TOTAL, cycleCount() - m_pass_start);
+    }
+}
+
+void LoopProfiler::reset() {
+    clearStats();
+    m_window_start_us = MonotonicUs();
+    m_skip_pass = true;
+}
+
+uint32_t LoopProfiler::getWindowMs() const {
+    return (uint32_t)((MonotonicUs() - m_window_start_us) / 1000u);
+}
+
+const char* LoopProfiler::stageName(LoopStage stage) {
+    switch (stage) {
+        case LOOP_STAGE_SAFETY:    return "safety";
+        case LOOP_STAGE_FORCE:     return "force";
+        case LOOP_STAGE_STATE:     return "state";
+        case LOOP_STAGE_COMMS:     return "comms";
+        case LOOP_STAGE_RX:        return "rx";
+        case LOOP_STAGE_TX:        return "tx";
+        case LOOP_STAGE_TELEMETRY: return "telemetry";
+        case LOOP_STAGE_LOGGING:   return "logging";
+        case LOOP_STAGE_TOTAL:     return "total";
+        default:                   return "unknown";
+    }
+}
+
+uint32_t LoopProfiler::cyclesToTenthsUs(uint64_t cycles) {
+    return (uint32_t)(cycles * 10 / CYCLES_PER_MICROSECOND);
+}
+
+void LoopProfiler::clearStats() {
+    memset(m_stats, 0, sizeof(m_stats));
+    for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+        m_stats[i].min_cycles = UINT32_MAX;
+    }
+}
+
+void LoopProfiler::record(LoopStage stage, uint32_t cycles) {
+    LoopStageStats& stats = m_stats[stage];
+    stats.count++;
+    stats.total_cycles += cycles;
+    if (cycles < stats.min_cycles) {
+        stats.min_cycles = cycles;
+    }
+    if (cycles > stats.max_cycles) {
+        stats.max_cycles = cycles;
+    }
+
+    // Bucket b >= 1 holds [2^(b-1), 2^b) us, i.e. b is the bit length of the microseconds
+    uint32_t us = cycles / CYCLES_PER_MICROSECOND;
+    uint32_t bucket = (us == 0) ? 0 : (uint32_t)(32 - __builtin_clz(us));
+    if (bucket >= LOOP_PROFILER_BUCKETS) {
+        bucket = LOOP_PROFILER_BUCKETS - 1;
+    }
+    stats.histogram[bucket]++;
+}
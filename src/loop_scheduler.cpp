@@ -0,0 +1,169 @@
+/**
+ * @file loop_scheduler.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the cooperative main-loop task scheduler.
+ */
+
+#include "loop_scheduler.h"
+#include "memory_map.h"
+#include "trace_log.h"
+#include "watchdog_supervisor.h"
+#include "ClearCore.h"
+#include <string.h>
+
+// Global loop scheduler instance
+LoopScheduler g_loopScheduler;
+
+LoopScheduler::LoopScheduler() {
+    memset(m_tasks, 0, sizeof(m_tasks));
+    m_task_count = 0;
+    m_running = LOOP_SCHEDULER_NO_TASK;
+    m_running_since_us = 0;
+    m_slow_deadline_us = 0;
+    m_breadcrumb = nullptr;
+    m_slow_passes = 0;
+    memset(&m_last_slow, 0, sizeof(m_last_slow));
+    m_last_slow.task = LOOP_SCHEDULER_NO_TASK;
+    m_worst_pass_us = 0;
+    m_window_worst_pass_us = 0;
+}
+
+bool LoopScheduler::registerTask(const char* name, LoopTaskHook hook, void* context, LoopTaskPriority priority,
+                                 uint32_t period_us, uint32_t budget_us, LoopStage stage) {
+    if (m_task_count >= LOOP_SCHEDULER_MAX_TASKS || hook == nullptr) {
+        return false;
+    }
+
+    // Insert after every task of the same or higher priority
+    uint8_t index = 0;
+    while (index < m_task_count && m_tasks[index].priority >= priority) {
+        index++;
+    }
+    for (uint8_t i = m_task_count; i > index; i--) {
+        m_tasks[i] = m_tasks[i - 1];
+    }
+
+    LoopTask& task = m_tasks[index];
+    memset(&task, 0, sizeof(task));
+    task.name = name;
+    task.hook = hook;
+    task.context = context;
+    task.period_us = period_us;
+    task.budget_us = budget_us;
+    task.last_run_us = Microseconds() - period_us;  // Due on the first pass
+    task.priority = priority;
+    task.stage = stage;
+    #if WATCHDOG_ENABLED
+    task.watchdog = g_watchdogSupervisor.registerClient(name, period_us / 1000 + WATCHDOG_TASK_DEADLINE_MS);
+    #endif
+    m_task_count++;
+    return true;
+}
+
+void LoopScheduler::run() {
+    bool done[LOOP_SCHEDULER_MAX_TASKS] = {};
+    uint32_t passStart = Microseconds();
+    uint8_t slowestTask = LOOP_SCHEDULER_NO_TASK;
+    uint32_t slowestUs = 0;
+    uint32_t slowestBreadcrumb = 0;
+
+    uint8_t i = 0;
+    while (i < m_task_count) {
+        LoopTask& task = m_tasks[i];
+        uint32_t now = Microseconds();
+        if (done[i] || now - task.last_run_us < task.period_us) {
+            i++;
+            continue;
+        }
+
+        // Defer work that no longer fits in the pass, unless it has waited too long already
+        done[i] = true;
+        bool idle = (task.priority == LOOP_PRIORITY_IDLE);
+        if (task.priority < LOOP_PRIORITY_CRITICAL && (idle || task.deferrals < LOOP_SCHEDULER_MAX_DEFERRALS) &&
+            (now - passStart) + task.budget_us > LOOP_SCHEDULER_PASS_BUDGET_US) {
+            if (task.deferrals < UINT8_MAX) {
+                task.deferrals++;
+            }
+            task.deferred++;
+            #if WATCHDOG_ENABLED
+            if (idle) {
+                g_watchdogSupervisor.checkIn(task.watchdog);
+            }
+            #endif
+            i++;
+            continue;
+        }
+
+        m_running_since_us = now;
+        m_running = i;
+        task.hook(task.context, task.budget_us);
+        m_running = LOOP_SCHEDULER_NO_TASK;
+        uint32_t elapsed = Microseconds() - now;
+        task.last_run_us = now;
+        task.deferrals = 0;
+        task.runs++;
+        #if WATCHDOG_ENABLED
+        g_watchdogSupervisor.checkIn(task.watchdog);
+        #endif
+        if (task.budget_us > 0 && elapsed > task.budget_us) {
+            task.overruns++;
+            TRACE(TRACE_TASK_OVERRUN, i, elapsed);
+        }
+        uint32_t breadcrumb = (m_breadcrumb != nullptr) ? *m_breadcrumb : 0;
+        if (slowestTask == LOOP_SCHEDULER_NO_TASK || elapsed > slowestUs) {
+            slowestTask = i;
+            slowestUs = elapsed;
+            slowestBreadcrumb = breadcrumb;
+        }
+        #if MEMORY_STACK_TASK_PEAKS
+        uint32_t stackBytes = g_memoryMap.takeTaskStackBytes();
+        if (stackBytes > task.stack_peak_bytes) {
+            task.stack_peak_bytes = stackBytes;
+            task.stack_breadcrumb = breadcrumb;
+        }
+        #endif
+        #if LOOP_PROFILER_ENABLED
+        g_loopProfiler.mark(static_cast<LoopStage>(task.stage));
+        #endif
+
+        // A higher-priority task may have fallen due meanwhile
+        i = 0;
+    }
+
+    uint32_t passUs = Microseconds() - passStart;
+    if (passUs > m_worst_pass_us) {
+        m_worst_pass_us = passUs;
+    }
+    if (passUs > m_window_worst_pass_us) {
+        m_window_worst_pass_us = passUs;
+    }
+    if (m_slow_deadline_us > 0 && passUs > m_slow_deadline_us) {
+        m_slow_passes++;
+        m_last_slow.time_ms = Milliseconds();
+        m_last_slow.pass_us = passUs;
+        m_last_slow.task_us = slowestUs;
+        m_last_slow.breadcrumb = slowestBreadcrumb;
+        m_last_slow.task = slowestTask;
+        TRACE(TRACE_SLOW_PASS, slowestTask, passUs);
+    }
+}
+
+void LoopScheduler::setSlowPassDeadline(uint32_t deadline_us, const volatile uint32_t* breadcrumb) {
+    m_slow_deadline_us = deadline_us;
+    m_breadcrumb = breadcrumb;
+}
+
+uint32_t LoopScheduler::takeWindowWorstPassUs() {
+    uint32_t worst = m_window_worst_pass_us;
+    m_window_worst_pass_us = 0;
+    return worst;
+}
+
+void LoopScheduler::resetStats() {
+    for (uint8_t i = 0; i < m_task_count; i++) {
+        m_tasks[i].runs = 0;
+        m_tasks[i].deferred = 0;
+        m_tasks[i].overruns = 0;
+    }
+}
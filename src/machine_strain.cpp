@@ -0,0 +1,204 @@
+/**
+ * @file machine_strain.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the machine-flex model and its force-to-deflection table.
+ */
+
+#include "machine_strain.h"
+#include <string.h>
+#include <math.h>
+
+MachineStrainModel::MachineStrainModel() {
+    const float defaults[5] = {
+        MACHINE_STRAIN_COEFF_X4, MACHINE_STRAIN_COEFF_X3, MACHINE_STRAIN_COEFF_X2,
+        MACHINE_STRAIN_COEFF_X1, MACHINE_STRAIN_COEFF_C
+    };
+    setCoefficients(defaults);
+}
+
+void MachineStrainModel::setCoefficients(const float coeffs[5]) {
+    memcpy(m_coeffs, coeffs, sizeof(m_coeffs));
+    rebuildTable();
+}
+
+float MachineStrainModel::forceFromDeflection(float deflection_mm) const {
+    float x = deflection_mm;
+    if (x < 0.0f) {
+        x = 0.0f;
+    }
+
+    float force = (((m_coeffs[0] * x + m_coeffs[1]) * x + m_coeffs[2]) * x + m_coeffs[3]) * x + m_coeffs[4];
+    if (force < 0.0f) {
+        force = 0.0f;
+    }
+    return force;
+}
+
+float MachineStrainModel::deflectionFromForce(float force_kg) const {
+    if (force_kg <= m_tableMinKg || m_tableStepKg <= 0.0f) {
+        return 0.0f;
+    }
+
+    float pos = (force_kg - m_tableMinKg) / m_tableStepKg;
+    if (pos >= (float)(MACHINE_STRAIN_TABLE_SIZE - 1)) {
+        return m_tableMm[MACHINE_STRAIN_TABLE_SIZE - 1];
+    }
+    int i = (int)pos;
+    float frac = pos - (float)i;
+    return m_tableMm[i] + frac * (m_tableMm[i + 1] - m_tableMm[i]);
+}
+
+/**
+ * @details The fit is only meaningful while force rises with deflection, so the table
+ * covers 0 up to the first point where the polynomial stops rising (at most
+ * MACHINE_STRAIN_MAX_DEFLECTION_MM). Each entry is solved once by bisection on that
+ * monotonic range; forces past the top clamp to its deflection.
+ */
+void MachineStrainModel::rebuildTable() {
+    m_tableMinKg = forceFromDeflection(0.0f);
+    m_tableStepKg = 0.0f;
+    memset(m_tableMm, 0, sizeof(m_tableMm));
+
+    const float scan_step = MACHINE_STRAIN_MAX_DEFLECTION_MM / MACHINE_STRAIN_SCAN_STEPS;
+    float top_mm = 0.0f;
+    float top_kg = m_tableMinKg;
+    for (int i = 1; i <= MACHINE_STRAIN_SCAN_STEPS; ++i) {
+        float x = i * scan_step;
+        float f = forceFromDeflection(x);
+        if (f <= top_kg) {
+            break;
+        }
+        top_mm = x;
+        top_kg = f;
+    }
+    if (top_kg <= m_tableMinKg) {
+        return;  // No rising range: no flex compensation
+    }
+
+    m_tableStepKg = (top_kg - m_tableMinKg) / (MACHINE_STRAIN_TABLE_SIZE - 1);
+    for (int i = 1; i < MACHINE_STRAIN_TABLE_SIZE; ++i) {
+        float force_kg = m_tableMinKg + i * m_tableStepKg;
+        float low = 0.0f;
+        float high = top_mm;
+        for (int iter = 0; iter < 24; ++iter) {
+            float mid = 0.5f * (low + high);
+            if (forceFromDeflection(mid) < force_kg) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        m_tableMm[i] = high;
+    }
+}
+
+MachineStrainFit::MachineStrainFit() {
+    reset();
+}
+
+void MachineStrainFit::reset() {
+    memset(m_powerSums, 0, sizeof(m_powerSums));
+    memset(m_momentSums, 0, sizeof(m_momentSums));
+    m_forceSquares = 0.0;
+    m_count = 0;
+    m_spanMm = 0.0f;
+}
+
+void MachineStrainFit::add(float deflection_mm, float force_kg) {
+    double x = deflection_mm;
+    double f = force_kg;
+    double power = 1.0;
+    for (int k = 0; k < 9; ++k) {
+        m_powerSums[k] += power;
+        if (k < 5) {
+            m_momentSums[k] += power * f;
+        }
+        power *= x;
+    }
+    m_forceSquares += f * f;
+    m_count++;
+    if (deflection_mm > m_spanMm) {
+        m_spanMm = deflection_mm;
+    }
+}
+
+/**
+ * @details Gaussian elimination with partial pivoting on the 5x5 normal matrix. Rows and
+ * columns run from x^4 down to the constant, so the solution is already in
+ * setCoefficients() order. The residual comes from the sums alone:
+ * SSE = sum(F^2) - 2 c.b + c.A.c.
+ */
+bool MachineStrainFit::solve(float coeffs[5], float* rms_kg) const {
+    if (m_count < 5) {
+        return false;
+    }
+    double a[5][6];
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            a[i][j] = m_powerSums[8 - i - j];
+        }
+        a[i][5] = m_momentSums[4 - i];
+    }
+
+    for (int col = 0; col < 5; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < 5; ++row) {
+            if (fabs(a[row][col]) > fabs(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        // Relative to the diagonal it came from, so the test does not depend on units
+        if (!(fabs(a[pivot][col]) > 1e-12 * fabs(m_powerSums[8 - 2 * col]))) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int j = 0; j < 6; ++j) {
+                double t = a[col][j];
+                a[col][j] = a[pivot][j];
+                a[pivot][j] = t;
+            }
+        }
+        for (int row = col + 1; row < 5; ++row) {
+            double factor = a[row][col] / a[col][col];
+            for (int j = col; j < 6; ++j) {
+                a[row][j] -= factor * a[col][j];
+            }
+        }
+    }
+
+    double c[5];
+    for (int i = 4; i >= 0; --i) {
+        double sum = a[i][5];
+        for (int j = i + 1; j < 5; ++j) {
+            sum -= a[i][j] * c[j];
+        }
+        c[i] = sum / a[i][i];
+    }
+
+    double sse = m_forceSquares;
+    for (int i = 0; i < 5; ++i) {
+        sse -= 2.0 * c[i] * m_momentSums[4 - i];
+        for (int j = 0; j < 5; ++j) {
+            sse += c[i] * c[j] * m_powerSums[8 - i - j];
+        }
+    }
+    for (int i = 0; i < 5; ++i) {
+        coeffs[i] = (float)c[i];
+    }
+    *rms_kg = (float)sqrt((sse > 0.0) ? sse / m_count : 0.0);
+    return true;
+}
+
+bool MachineStrainFit::risesOverSpan(const float coeffs[5]) const {
+    float previous = coeffs[4];
+    for (int i = 1; i <= MACHINE_STRAIN_SCAN_STEPS; ++i) {
+        float x = m_spanMm * i / MACHINE_STRAIN_SCAN_STEPS;
+        float force = (((coeffs[0] * x + coeffs[1]) * x + coeffs[2]) * x + coeffs[3]) * x + coeffs[4];
+        if (force <= previous) {
+            return false;
+        }
+        previous = force;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file main_flash.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the non-blocking main flash operations.
+ */
+
+#include "main_flash.h"
+#include <sam.h>
+
+#define MAIN_FLASH_ERRORS       (NVMCTRL_INTFLAG_ADDRE | NVMCTRL_INTFLAG_PROGE | NVMCTRL_INTFLAG_LOCKE | NVMCTRL_INTFLAG_NVME)
+
+bool main_flash_ready() {
+    return NVMCTRL->STATUS.bit.READY;
+}
+
+// The flags are cleared when each operation starts, so any set now belong to the last one
+uint16_t main_flash_errors() {
+    return NVMCTRL->INTFLAG.reg & MAIN_FLASH_ERRORS;
+}
+
+/**
+ * @details Manual write mode: the words go into the page buffer through their flash
+ * addresses, then WQW or WP commits them. Anything an interrupted caller left in the page
+ * buffer is cleared first.
+ */
+void main_flash_start_write(uint32_t address, const uint32_t* words, uint16_t count) {
+    NVMCTRL->CTRLA.bit.WMODE = NVMCTRL_CTRLA_WMODE_MAN;
+    NVMCTRL->INTFLAG.reg = MAIN_FLASH_ERRORS;
+    if (NVMCTRL->STATUS.bit.LOAD) {
+        NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | NVMCTRL_CTRLB_CMD_PBC;
+        while (!NVMCTRL->STATUS.bit.READY);     // Page buffer clear takes a few cycles
+    }
+    volatile uint32_t* dst = reinterpret_cast<volatile uint32_t*>(address);
+    for (uint16_t i = 0; i < count; i++) {
+        dst[i] = words[i];
+    }
+    NVMCTRL->ADDR.reg = address;
+    NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY |
+                         ((count == MAIN_FLASH_QUAD_WORDS) ? NVMCTRL_CTRLB_CMD_WQW : NVMCTRL_CTRLB_CMD_WP);
+}
+
+void main_flash_start_erase(uint32_t address) {
+    NVMCTRL->INTFLAG.reg = MAIN_FLASH_ERRORS;
+    NVMCTRL->ADDR.reg = address;
+    NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | NVMCTRL_CTRLB_CMD_EB;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file memory_map.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the SRAM map and painted-stack high-water mark.
+ */
+
+#include "memory_map.h"
+#include <malloc.h>
+#include <sam.h>
+
+// Linker script symbols (flash_with_bootloader.ld / flash_without_bootloader.ld)
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+extern uint32_t __end__;
+extern uint32_t __StackTop;
+
+#define MEMORY_RAM_START    0x20000000u
+
+// Global memory map instance
+MemoryMap g_memoryMap;
+
+MemoryMap::MemoryMap() {
+    m_paintStart = nullptr;
+    m_paintEnd = nullptr;
+    m_peakBytes = 0;
+}
+
+static uint32_t heapTop() {
+    return (uint32_t)&__end__ + MemoryMap::getHeapBytes();
+}
+
+static const uint32_t* heapEndWord() {
+    return reinterpret_cast<const uint32_t*>((heapTop() + 3u) & ~3u);
+}
+
+/**
+ * @details Runs before the control tick and the network start, so only the reset
+ * handler's and setup()'s frames sit above the stack pointer.
+ */
+void MemoryMap::paintStack() {
+    uint32_t bottom = (heapTop() + MEMORY_HEAP_HEADROOM_BYTES + 3u) & ~3u;
+    uint32_t top = (__get_MSP() - MEMORY_STACK_PAINT_MARGIN_BYTES) & ~3u;
+    if (top <= bottom) {
+        return;
+    }
+    m_paintStart = reinterpret_cast<uint32_t*>(bottom);
+    m_paintEnd = reinterpret_cast<uint32_t*>(top);
+    for (volatile uint32_t* word = m_paintStart; word < m_paintEnd; word++) {
+        *word = MEMORY_STACK_PAINT;
+    }
+}
+
+/**
+ * @details Scans up from the lower of the paint and the current heap top, so heap the
+ * program took after the paint is not mistaken for stack.
+ */
+const uint32_t* MemoryMap::firstUsedWord() const {
+    const uint32_t* word = m_paintStart;
+    const uint32_t* heap_end = heapEndWord();
+    if (heap_end > word) {
+        word = heap_end;
+    }
+    while (word < m_paintEnd && *word == MEMORY_STACK_PAINT) {
+        word++;
+    }
+    return word;
+}
+
+uint32_t MemoryMap::getStackPeakBytes() const {
+    if (m_paintStart == nullptr) {
+        return 0;
+    }
+    // Nothing below the paint-time stack pointer touched reads as the paint end
+    const uint32_t* word = firstUsedWord();
+    uint32_t bytes = (uint32_t)&__StackTop - (uint32_t)((word < m_paintEnd) ? word : m_paintEnd);
+    return (bytes > m_peakBytes) ? bytes : m_peakBytes;
+}
+
+uint32_t MemoryMap::getStackUnusedBytes() const {
+    if (m_paintStart == nullptr) {
+        return 0;
+    }
+    const uint32_t* heap_end = heapEndWord();
+    const uint32_t* floor = (heap_end > m_paintStart) ? heap_end : m_paintStart;
+    uint32_t deepest = (uint32_t)&__StackTop - getStackPeakBytes();
+    return (deepest > (uint32_t)floor) ? deepest - (uint32_t)floor : 0;
+}
+
+/**
+ * @details Costs a read per word the task used plus MEMORY_STACK_GAP_BYTES / 4, and a
+ * write per word it used. An interrupt that lands during the scan only adds its own frame
+ * to the reading, which is stack the task really has to leave room for.
+ */
+uint32_t MemoryMap::takeTaskStackBytes() {
+    if (m_paintStart == nullptr) {
+        return 0;
+    }
+    uint32_t* top = reinterpret_cast<uint32_t*>((__get_MSP() - MEMORY_STACK_PAINT_MARGIN_BYTES) & ~3u);
+    if (top > m_paintEnd) {
+        top = m_paintEnd;
+    }
+    const uint32_t* heap_end = heapEndWord();
+    const uint32_t* floor = (heap_end > m_paintStart) ? heap_end : m_paintStart;
+
+    // Walk down until a gap of unbroken paint; the last written word above it is the depth
+    uint32_t* deepest = top;
+    uint32_t painted = 0;
+    for (uint32_t* word = top; word > floor && painted < MEMORY_STACK_GAP_BYTES / 4u; ) {
+        word--;
+        if (*word == MEMORY_STACK_PAINT) {
+            painted++;
+        } else {
+            deepest = word;
+            painted = 0;
+        }
+    }
+    for (volatile uint32_t* word = deepest; word < top; word++) {
+        *word = MEMORY_STACK_PAINT;
+    }
+
+    uint32_t bytes = (uint32_t)&__StackTop - (uint32_t)deepest;
+    if (bytes > m_peakBytes) {
+        m_peakBytes = bytes;
+    }
+    return bytes;
+}
+
+uint32_t MemoryMap::getStackNowBytes() {
+    return (uint32_t)&__StackTop - __get_MSP();
+}
+
+uint32_t MemoryMap::getRamBytes() {
+    return (uint32_t)&__StackTop - MEMORY_RAM_START;
+}
+
+uint32_t MemoryMap::getDataBytes() {
+    return (uint32_t)&__data_end__ - (uint32_t)&__data_start__;
+}
+
+uint32_t MemoryMap::getBssBytes() {
+    return (uint32_t)&__bss_end__ - (uint32_t)&__bss_start__;
+}
+
+uint32_t MemoryMap::getHeapBytes() {
+    // arena is what newlib has taken with sbrk() from __end__ up
+    return (uint32_t)mallinfo().arena;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file message_ring.cpp
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Implements the variable-length message queue used for the RX and TX paths.
+ */
+
+#include "message_ring.h"
+#include <string.h>
+
+MessageRing::MessageRing(char* arena, uint16_t arena_size, MessageSlot* slots, uint16_t slot_count) {
+	m_arena = arena;
+	m_arenaSize = arena_size;
+	m_slots = slots;
+	m_slotCount = slot_count;
+	m_head = 0;
+	m_tail = 0;
+	m_arenaHead = 0;
+	m_reserveOffset = 0;
+	m_reserveCapacity = 0;
+	m_reserveNext = 0;
+	m_peakCount = 0;
+}
+
+int MessageRing::findSpace(size_t need) const {
+	if (m_head == m_tail) {
+		// Empty: start over at the front so the whole arena is contiguous
+		return (need <= m_arenaSize) ? 0 : -1;
+	}
+	size_t tail = m_slots[m_tail].offset;
+	size_t head = m_arenaHead;
+	if (head > tail) {
+		// Live text is [tail, head): free space at the end, then at the front
+		if (m_arenaSize - head >= need) {
+			return (int)head;
+		}
+		return (tail >= need) ? 0 : -1;
+	}
+	// Wrapped: live text is [tail, end) and [0, head), the gap between is free
+	return (tail - head >= need) ? (int)head : -1;
+}
+
+char* MessageRing::reserve(size_t capacity) {
+	m_reserveCapacity = 0;
+	if (capacity == 0 || capacity > m_arenaSize) {
+		return NULL;
+	}
+	uint16_t next_head = (uint16_t)((m_head + 1) % m_slotCount);
+	int offset = (next_head == m_tail) ? -1 : findSpace(capacity);
+	if (offset < 0) {
+		return NULL;
+	}
+	m_reserveOffset = (uint16_t)offset;
+	m_reserveCapacity = (uint16_t)capacity;
+	m_reserveNext = (uint16_t)offset;
+	return m_arena + offset;
+}
+
+void MessageRing::commit(size_t length, const IpAddress& ip, uint16_t port) {
+	if (m_reserveCapacity == 0) {
+		return;
+	}
+	if (length >= m_reserveCapacity) {
+		length = m_reserveCapacity - 1;
+	}
+	m_reserveCapacity = 0;
+	queueAt(m_reserveOffset, length, ip, port);
+}
+
+bool MessageRing::commitPart(char* text, size_t length, const IpAddress& ip, uint16_t port) {
+	if (m_reserveCapacity == 0 || (uint16_t)((m_head + 1) % m_slotCount) == m_tail) {
+		return false;
+	}
+	if (text < m_arena + m_reserveNext || (size_t)(text - m_arena) + length >= (size_t)m_reserveOffset + m_reserveCapacity) {
+		return false;
+	}
+	queueAt((uint16_t)(text - m_arena), length, ip, port);
+	m_reserveNext = m_arenaHead;
+	return true;
+}
+
+void MessageRing::queueAt(uint16_t offset, size_t length, const IpAddress& ip, uint16_t port) {
+	m_arena[offset + length] = '\0';
+	MessageSlot& slot = m_slots[m_head];
+	slot.offset = offset;
+	slot.length = (uint16_t)length;
+	slot.remoteIp = ip;
+	slot.remotePort = port;
+	m_arenaHead = (uint16_t)(offset + length + 1);
+	m_head = (uint16_t)((m_head + 1) % m_slotCount);
+	uint16_t count = (uint16_t)getCount();
+	if (count > m_peakCount) {
+		m_peakCount = count;
+	}
+}
+
+bool MessageRing::push(const char* text, size_t length, const IpAddress& ip, uint16_t port) {
+	char* space = reserve(length + 1);
+	if (space == NULL) {
+		return false;
+	}
+	memcpy(space, text, length);
+	commit(length, ip, port);
+	return true;
+}
+
+const MessageSlot* MessageRing::front() const {
+	return (m_head == m_tail) ? NULL : &m_slots[m_tail];
+}
+
+void MessageRing::pop() {
+	if (m_head != m_tail) {
+		m_tail = (uint16_t)((m_tail + 1) % m_slotCount);
+	}
+}
+
+void MessageRing::clear() {
+	m_head = 0;
+	m_tail = 0;
+	m_arenaHead = 0;
+	m_reserveCapacity = 0;
+}
+
+int MessageRing::getCount() const {
+	return (m_head - m_tail + m_slotCount) % m_slotCount;
+}
+
+int MessageRing::getFree(uint16_t bytes_per_message) const {
+	int used = getCount();
+	int slots = m_slotCount - 1 - used;
+	if (used == 0) {
+		int by_arena = m_arenaSize / bytes_per_message;
+		return (by_arena < slots) ? by_arena : slots;
+	}
+	int tail = m_slots[m_tail].offset;
+	int bytes = (m_arenaHead > tail) ? (m_arenaSize - m_arenaHead + tail) : (tail - m_arenaHead);
+	int by_arena = bytes / bytes_per_message;
+	return (by_arena < slots) ? by_arena : slots;
+}
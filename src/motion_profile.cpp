@@ -0,0 +1,89 @@
+/**
+ * @file motion_profile.cpp
+ * @author Eldin Miller-Stead
+ * @date November 5, 2025
+ * @brief Implements the jerk-limited (S-curve) velocity profile.
+ */
+
+#include "motion_profile.h"
+#include <cmath>
+
+SCurveProfile::SCurveProfile() {
+    m_jerk = 0.0f;
+    m_accel = 0.0f;
+    m_vel = 0.0f;
+    m_jerk_time = 0.0f;
+    m_accel_time = 0.0f;
+    m_cruise_time = 0.0f;
+}
+
+bool SCurveProfile::plan(float distance, float vel_max, float accel_max, float jerk_max) {
+    if (distance <= 0.0f || vel_max <= 0.0f || accel_max <= 0.0f || jerk_max <= 0.0f) {
+        return false;
+    }
+    m_jerk = jerk_max;
+
+    float accel_dist = planAccel(vel_max, accel_max, jerk_max);
+    if (2.0f * accel_dist > distance) {
+        // Too short to reach vel_max: the accel distance grows with the cruise velocity,
+        // so bisect for the velocity whose accel + decel exactly covers the move
+        float low = 0.0f;
+        float high = vel_max;
+        for (int i = 0; i < 24; i++) {
+            float mid = 0.5f * (low + high);
+            if (2.0f * planAccel(mid, accel_max, jerk_max) > distance) {
+                high = mid;
+            } else {
+                low = mid;
+            }
+        }
+        accel_dist = planAccel(low, accel_max, jerk_max);
+    }
+    m_cruise_time = (m_vel > 0.0f) ? (distance - 2.0f * accel_dist) / m_vel : 0.0f;
+    if (m_cruise_time < 0.0f) {
+        m_cruise_time = 0.0f;
+    }
+    return true;
+}
+
+float SCurveProfile::planAccel(float vel, float accel_max, float jerk_max) {
+    m_vel = vel;
+    if (vel * jerk_max >= accel_max * accel_max) {
+        // Reaches accel_max: jerk up, constant accel, jerk down
+        m_accel = accel_max;
+        m_jerk_time = accel_max / jerk_max;
+        m_accel_time = vel / accel_max + m_jerk_time;
+    } else {
+        // Jerk up straight into jerk down
+        m_jerk_time = std::sqrt(vel / jerk_max);
+        m_accel = jerk_max * m_jerk_time;
+        m_accel_time = 2.0f * m_jerk_time;
+    }
+    // The phase is point-symmetric about its midpoint, so the mean velocity is vel / 2
+    return 0.5f * vel * m_accel_time;
+}
+
+float SCurveProfile::accelVelocity(float tau) const {
+    if (tau < m_jerk_time) {
+        return 0.5f * m_jerk * tau * tau;
+    }
+    if (tau < m_accel_time - m_jerk_time) {
+        return 0.5f * m_jerk * m_jerk_time * m_jerk_time + m_accel * (tau - m_jerk_time);
+    }
+    float to_end = m_accel_time - tau;
+    return m_vel - 0.5f * m_jerk * to_end * to_end;
+}
+
+float SCurveProfile::velocityAt(float t) const {
+    float duration = getDuration();
+    if (t <= 0.0f || t >= duration) {
+        return 0.0f;
+    }
+    if (t < m_accel_time) {
+        return accelVelocity(t);
+    }
+    if (t <= m_accel_time + m_cruise_time) {
+        return m_vel;
+    }
+    return accelVelocity(duration - t);
+}
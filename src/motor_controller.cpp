@@ -2,7 +2,7 @@
  * @file motor_controller.cpp
  * @author Eldin Miller-Stead
  * @date November 3, 2025
- * @brief Implements the controller for the dual-motor press system.
+ * @brief Implements the controller for the ganged-motor press system.
  *
  * @details This file provides the concrete implementation for the `MotorController` class.
  * It contains the logic for the hierarchical state machines that manage homing
@@ -14,15 +14,79 @@
 // --- Includes ---
 //==================================================================================================
 #include "motor_controller.h"
+#include "recipe.h"
+#include "press_capture.h"
+#include "position_curve.h"
+#include "press_metrics.h"
+#include "cycle_timing.h"
+#include "cycle_estimate.h"
+#include "production_counters.h"
+#include "debug_log.h"
 #include "pressboi.h" // Include full header for Pressboi
 #include "events.h"
 #include "error_log.h"
+#include "control_tick.h"
+#include "trace_log.h"
+#include "hil_test.h"
+#include "force_replay.h"
+#include "settings.h"
+#include "station_io.h"
 #include "NvmManager.h"
+#include <sam.h>  // DWT cycle counter (benchmark build)
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 
+// Sensor edge interrupts take no context, so each one reaches its controller and axis
+// through a slot; slots are claimed in setupHomeSensors(), one per sensor on the board
+static MotorController* s_homeLatchOwner[MOTOR_AXIS_MAX] = {};
+static int8_t s_homeLatchAxis[MOTOR_AXIS_MAX] = {};
+static int s_homeLatchSlotsUsed = 0;
+
+// Protocol names of ForceAction, indexed by value
+static const char* const kForceActionNames[FORCE_ACTION_NONE] = {
+    "hold", "skip", "retract", "abort", "regulate", "seat"
+};
+
+// run_recipe's command name; its moves are told apart from queue_run's by this pointer
+static const char kRunRecipeCommand[] = "run_recipe";
+
+#if HOMING_RESTORE_ENABLED
+/**
+ * @struct HomeRecord
+ * @brief A trusted home as it stood in the last main loop pass before a reset.
+ */
+struct HomeRecord {
+    uint32_t magic;                             ///< HOMING_RESTORE_MAGIC once sealed
+    uint32_t checksum;                          ///< Sum of the words after this one
+    int32_t home_reference_steps;               ///< m_machineHomeReferenceSteps
+    int32_t position_steps[MOTOR_AXIS_MAX];     ///< PositionRefCommanded() of each motor
+    int32_t trigger_steps[MOTOR_AXIS_MAX];      ///< m_homeTriggerSteps of each motor
+    uint8_t axis_count;                         ///< Motors the record covers
+    uint8_t sensors;                            ///< Bit n set if motor n's home sensor was active
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(HomeRecord) % 4 == 0, "Home record must be whole words for the checksum");
+
+// Survives a reset; holds garbage after power-up until the magic and checksum say otherwise
+__attribute__((section(".noinit"))) static HomeRecord s_noinitHome;
+
+// Rotate-and-add as for the crash snapshot, so swapped or zeroed words do not cancel out
+static uint32_t homeRecordChecksum(const HomeRecord& record) {
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(&record);
+    uint32_t sum = 0x5A5A5A5A;
+    for (size_t i = 2; i < sizeof(record) / 4; i++) {
+        sum = ((sum << 5) | (sum >> 27)) + words[i];
+    }
+    return sum;
+}
+#endif
+
+static_assert(NVM_SLOT_TORQUE_FRICTION_POINTS + TORQUE_FRICTION_MAX_POINTS <= NVM_SLOT_FORCE_TABLE_COUNT,
+              "Friction table overlaps the force table");
+
 //==================================================================================================
 // --- Class Implementation ---
 //==================================================================================================
@@ -30,30 +94,104 @@
 /**
  * @brief Constructs the MotorController controller.
  */
-MotorController::MotorController(MotorDriver* motorA, MotorDriver* motorB, Pressboi* controller) {
-    m_motorA = motorA;
-    m_motorB = motorB;
+MotorController::MotorController(const PressStation& station, Pressboi* controller) {
+    int axis_count = station.axis_count;
+    m_axisCount = (axis_count < 1) ? 1 : (axis_count > MOTOR_AXIS_MAX) ? MOTOR_AXIS_MAX : axis_count;
+    for (int i = 0; i < MOTOR_AXIS_MAX; i++) {
+        m_motors[i] = (i < m_axisCount) ? station.motors[i] : nullptr;
+        m_homeSensors[i] = (i < m_axisCount) ? station.home_sensors[i] : nullptr;
+        m_homeLatchSlot[i] = -1;
+    }
     m_controller = controller;
 
     // Initialize state machine
     m_state = STATE_STANDBY;
     m_homingState = HOMING_NONE;
     m_homingPhase = HOMING_PHASE_IDLE;
+    m_tracedState = m_state;
+    m_tracedHomingPhase = m_homingPhase;
     m_moveState = MOVE_STANDBY;
 
     m_homingDone = false;
     m_retractDone = false;
     m_originalMoveCommand = nullptr;
     m_homingStartTime = 0;
+    m_homingPhaseStartTime = 0;
     m_isEnabled = true;
     m_pausedMessageSent = false;
+    m_pausedMoveState = MOVE_NONE;
+    m_pausedApproachRapid = false;
     
     // Initialize gantry squaring homing variables
-    m_axisAHomeSensorTriggered = false;
-    m_axisBHomeSensorTriggered = false;
-    m_axisAStopped = false;
-    m_axisBStopped = false;
     m_homeSensorsInitialized = false;
+    m_homeTrusted = false;
+    m_homeLearned = false;
+    m_homingHybrid = false;
+    m_homingSpikeAxes = 0;
+    m_homingSpikeBaselineSet = 0;
+    m_homingSpikeTripped = false;
+    m_homingSpikeAxis = 0;
+    m_homingSpikeRisePct = 0.0f;
+#if HOMING_RESTORE_ENABLED
+    m_homeRestored = false;
+    m_homeRestoredSensors = 0;
+#endif
+    for (int i = 0; i < MOTOR_AXIS_MAX; i++) {
+        m_axisHomeSensorTriggered[i] = false;
+        m_axisStopped[i] = false;
+        m_axisHomingPhase[i] = AXIS_HOMING_IDLE;
+        m_axisHomingMoveSeen[i] = false;
+        m_axisHomingVerify[i] = false;
+        m_homeTriggerSteps[i] = 0;
+        m_homingSpikeSettleTicks[i] = 0;
+        m_homingSpikeBaseline[i] = 0.0f;
+        m_homeLatchValid[i] = false;
+        m_homeLatchSteps[i] = 0;
+        m_tickTorque[i] = 0.0f;
+        m_tickTorqueSeeded[i] = false;
+        m_tickFriction[i] = 0.0f;
+        m_tickTorqueFast[i] = 0.0f;
+        m_tickAxis[i].status_reg = 0;
+        m_tickAxis[i].position_steps = 0;
+        m_tickAxis[i].velocity_sps = 0;
+        m_tickAxis[i].hlfb_pct = 0.0f;
+        m_tickAxis[i].hlfb_new = false;
+#if HLFB_HIGH_RATE_ENABLED
+        m_tickHlfbLast[i] = 0.0f;
+        m_tickHlfbAge[i] = 0;
+#endif
+        m_tripRetractTarget[i] = 0;
+        m_profileTarget[i] = 0;
+    }
+    m_homeLatchAvailable = false;
+    m_encoderCountsPerMm = 0.0f;
+    m_encoderToleranceMm = ENCODER_TOLERANCE_MM_DEFAULT;
+    m_encoderCountsPerStep = 0.0f;
+    m_encoderToleranceCounts = 0.0f;
+    m_encoderOffsetCounts = 0;
+    m_encoderArmed = false;
+    m_encoderTripped = false;
+    m_encoderQuadratureFault = false;
+    m_encoderErrorMm = 0.0f;
+#if RACKING_CORRECTION_ENABLED
+    m_rackingArmed = false;
+    m_rackingTripped = false;
+    m_rackingAxis = 0;
+    m_rackingTorqueDiff = 0.0f;
+    m_rackingImbalanceSteps = 0;
+    m_rackSquareSet = false;
+    for (int i = 0; i < MOTOR_AXIS_MAX; i++) {
+        m_rackBaselineSteps[i] = 0;
+        m_rackTrimSps[i] = 0.0f;
+        m_rackAppliedSps[i] = 0;
+    }
+    m_rackOverTicks = 0;
+    m_rackGainSpsPerPct = 0.0f;
+    m_rackTrimMaxSps = 0.0f;
+    m_rackTrimSlewSps = 0.0f;
+    m_rackLeadMaxSteps = 0;
+    m_rackFaultSteps = 0;
+#endif
     
     // Initialize non-blocking enable state
     m_enableState = ENABLE_IDLE;
@@ -63,44 +201,152 @@ MotorController::MotorController(MotorDriver* motorA, MotorDriver* motorB, Press
     m_torqueLimit = DEFAULT_TORQUE_LIMIT;
     m_torqueOffset = DEFAULT_TORQUE_OFFSET;
     m_moveDefaultTorquePercent = MOVE_DEFAULT_TORQUE_PERCENT;
-    m_moveDefaultVelocitySPS = MOVE_DEFAULT_VELOCITY_SPS;
-    m_moveDefaultAccelSPS2 = MOVE_DEFAULT_ACCEL_SPS2;
+    // Step rates depend on the drive geometry, which is only known once setup() runs
+    m_moveDefaultVelocitySPS = 0;
+    m_moveDefaultAccelSPS2 = 0;
+    m_motorVelMaxSps = 0;
+    m_motorAccelMaxSps2 = 0;
 
-    m_smoothedTorqueValue0 = 0.0f;
-    m_smoothedTorqueValue1 = 0.0f;
-    m_firstTorqueReading0 = true;
-    m_firstTorqueReading1 = true;
     m_machineHomeReferenceSteps = 0;
     m_retractReferenceSteps = LONG_MIN;  // Use LONG_MIN as sentinel for "not set"
     m_cumulative_distance_mm = 0.0f;
     m_moveStartTime = 0;
     m_active_op_target_position_steps = 0;
-    m_joules = 0.0;
     m_endpoint_mm = 0.0f;
     m_press_startpoint_mm = 0.0f;
-    m_prev_position_mm = 0.0;
-    m_machineStrainBaselinePosMm = 0.0;
-    m_prevMachineDeflectionMm = 0.0;
-    m_prevTotalDeflectionMm = 0.0;
-    m_machineEnergyJ = 0.0;
-    m_machineStrainContactActive = false;
     m_jouleIntegrationActive = false;
     m_forceLimitTriggered = false;
-    m_prevForceValid = false;
-    
-    // Default machine strain compensation coefficients (x^3, x^2, x, constant)
-    m_machineStrainCoeffs[0] = MACHINE_STRAIN_COEFF_X4;
-    m_machineStrainCoeffs[1] = MACHINE_STRAIN_COEFF_X3;
-    m_machineStrainCoeffs[2] = MACHINE_STRAIN_COEFF_X2;
-    m_machineStrainCoeffs[3] = MACHINE_STRAIN_COEFF_X1;
-    m_machineStrainCoeffs[4] = MACHINE_STRAIN_COEFF_C;
+    m_envelopeArmed = false;
+    m_envelopeTripped = false;
+    m_envelopePositionMm = 0.0f;
+    m_envelopeKg = 0.0f;
+    m_envelopeBoundKg = 0.0f;
+#if THERMAL_MODEL_ENABLED
+    m_thermalHold = false;
+    m_thermalWarned = false;
+#endif
+#if STATION_IO_ENABLED
+    m_interlockArmed = false;
+    m_interlockTripped = false;
+    m_interlockInputs = 0;
+    m_interlockFaults = 0;
+#endif
+    memset(m_zones, 0, sizeof(m_zones));
+    memset(&m_zoneBase, 0, sizeof(m_zoneBase));
+    m_zoneCount = 0;
+    m_zoneArmed = false;
+    m_zoneSpeedControl = false;
+    m_zoneForceControl = false;
+    m_zoneDir = 1;
+    m_zoneActive = -1;
+    m_zoneSpeedSps = -1;
+    m_captureDetail = false;
+    m_captureRefValid = false;
+    m_captureRefKg = 0.0f;
+    m_captureRefSteps = 0;
+    m_seatArmed = false;
+    m_seatDetected = false;
+    m_forceBatchCount = 0;
+    memset(m_posHistoryTimeUs, 0, sizeof(m_posHistoryTimeUs));
+    memset(m_posHistorySteps, 0, sizeof(m_posHistorySteps));
+    m_posHistoryHead = 0;
+    m_posHistoryCount = 0;
+    memset(m_motionQueue, 0, sizeof(m_motionQueue));
+    memset(m_motionQueueCompiled, 0, sizeof(m_motionQueueCompiled));
+    m_motionQueueCompiledMode = FORCE_MODE_LOAD_CELL;
+#if MOVE_CACHE_SIZE > 0
+    memset(m_moveCache, 0, sizeof(m_moveCache));
+    m_moveCacheNext = 0;
+#endif
+    m_motionQueueHead = 0;
+    m_motionQueueCount = 0;
+    m_motionQueueSegment = 0;
+    m_motionQueueRunning = false;
+    m_motionQueueCommand = "queue_run";
+    m_recipeDoneCount = 0;
+#if PRESS_SYNC_ENABLED
+    m_syncGate = false;
+    m_syncContinuing = false;
+    m_syncReleased = false;
+    m_syncReleasePending = false;
+    m_syncReleaseUs = 0;
+#endif
+    m_dwellStartTime = 0;
+    m_dwellDurationMs = 0;
+    m_forceBatchPeakKg = 0.0f;
+    m_forceBatchPeakCounts = 0;
+    m_forceBatchPeakUs = 0;
+    memset(&m_moveStats, 0, sizeof(m_moveStats));
+    memset(m_torqueRing, 0, sizeof(m_torqueRing));
+    m_torqueRingHead = 0;
+    m_torqueRingTail = 0;
+    m_torqueTickCount = 0;
+    m_tripLeadUs = 0;
+    m_forceRateKgPerUs = 0.0f;
+    m_forceRatePrevKg = 0.0f;
+    m_forceRatePrevUs = 0;
+    m_forceChannel = FORCE_CHANNEL_A;
+    m_tickTorqueArmed = false;
+    m_tickTorqueTripped = false;
+    m_tickTorqueReseed = false;
+    memset(m_fusionHistory, 0, sizeof(m_fusionHistory));
+    m_fusionHead = 0;
+    m_fusionCount = 0;
+    m_fusionLastSampleUs = 0;
+    m_fusionSamples = 0;
+    m_fusionBias = 0.0f;
+    m_fusedKg = 0.0f;
+    m_fusionTripArmed = false;
+    m_fusionTripped = false;
+    m_fusionTripKg = 0.0f;
+    m_fusionTripLatencyUs = 0;
+    memset(m_telemetrySnapshots, 0, sizeof(m_telemetrySnapshots));
+    m_telemetryFront = 0;
+    m_telemetrySeq = 0;
+    m_frictionCount = 0;
+    m_frictionNvmCount = 0;
+    m_frictionNvmPending = false;
+    m_forceRegulate = false;
+    m_regulateArmed = false;
+    m_regulateVelocityMode = false;
+    m_regulateFault = REGULATE_FAULT_NONE;
+    m_regulateErrorKg = 0.0f;
+    m_regulateIntegral = 0.0f;
+    m_regulateLastSampleUs = 0;
+    m_regulateDir = 1;
+    m_regulateLimitSteps = 0;
+    m_regulateMaxMms = 0.0f;
+    m_regulateDwellMs = 0;
+    m_regulateContactAt = 0;
+    m_regulateSettledAt = 0;
+    m_adaptiveStep = -1;
+    m_adaptiveDir = 1;
+    m_approachRapid = false;
+    m_approachSwitchSteps = 0;
+    m_approachRapidSps = 0;
+    m_motionJerkMmss3 = 0.0f;
+    m_rapidVelMms = 0;
+    m_rapidAccelMmss = 0;
+    m_rapidAccelSps2 = 0;
+    m_rapidActive = false;
+    m_tripRetractArmed = false;
+    m_tripRetractIssued = false;
+    m_tripRetractFromSteps = 0;
+    m_tripRetractSps = 0;
+    m_tripRetractAccelSps2 = 0;
+    m_profileActive = false;
+    m_profiledMove = false;
+    m_profileTicks = 0;
+    m_profileDir = 1;
+    m_profileAccelSps2 = 0;
+    m_active_op_force_limit_counts = INT32_MAX;
     
     // Default to load_cell mode (will be overwritten by NVM in setup)
-    strcpy(m_force_mode, "load_cell");
+    m_force_mode = FORCE_MODE_LOAD_CELL;
     
     // Default motor torque calibration: Torque% = 0.0335 * kg + 1.04
-    m_motor_torque_scale = 0.0335f;
-    m_motor_torque_offset = 1.04f;
+    m_motor_torque_scale = MOTOR_TORQUE_SCALE_DEFAULT;
+    m_motor_torque_offset = MOTOR_TORQUE_OFFSET_DEFAULT;
 
     m_retractSpeedMms = RETRACT_DEFAULT_SPEED_MMS;
     m_home_on_boot = true;  // Default to true (will be overwritten by NVM in setup)
@@ -114,262 +360,190 @@ MotorController::MotorController(MotorDriver* motorA, MotorDriver* motorB, Press
  * @brief Performs one-time setup and configuration of the motors.
  */
 void MotorController::setup() {
-    m_motorA->HlfbMode(MotorDriver::HLFB_MODE_HAS_BIPOLAR_PWM);
-    m_motorA->HlfbCarrier(MotorDriver::HLFB_CARRIER_482_HZ);
-    m_motorA->VelMax(MOTOR_DEFAULT_VEL_MAX_SPS);
-    m_motorA->AccelMax(MOTOR_DEFAULT_ACCEL_MAX_SPS2);
-
-    m_motorB->HlfbMode(MotorDriver::HLFB_MODE_HAS_BIPOLAR_PWM);
-    m_motorB->HlfbCarrier(MotorDriver::HLFB_CARRIER_482_HZ);
-    m_motorB->VelMax(MOTOR_DEFAULT_VEL_MAX_SPS);
-    m_motorB->AccelMax(MOTOR_DEFAULT_ACCEL_MAX_SPS2);
-
-    m_motorA->EnableRequest(true);
-    m_motorB->EnableRequest(true);
-    
-    // Wait for motors to report as enabled (up to 2 seconds)
-    // This is critical - without this check, auto-homing may start before motors are ready
-    uint32_t enableTimeout = Milliseconds() + 2000;
-    while (Milliseconds() < enableTimeout) {
-        if (m_motorA->StatusReg().bit.Enabled && m_motorB->StatusReg().bit.Enabled) {
-            break;
-        }
+    // g_driveGeometry.load() has run: the mm/s defaults become step rates once, here
+    m_moveDefaultVelocitySPS = toStepsPerSec(MmPerSec(MOVE_DEFAULT_VELOCITY_MMS)).value;
+    m_moveDefaultAccelSPS2 = toStepsPerSec(MmPerSec(MOVE_DEFAULT_ACCEL_MMSS)).value;
+    m_motorVelMaxSps = toStepsPerSec(MmPerSec(MOTOR_DEFAULT_VEL_MAX_MMS)).value;
+    m_motorAccelMaxSps2 = toStepsPerSec(MmPerSec(MOTOR_DEFAULT_ACCEL_MAX_MMSS)).value;
+    m_profileAccelSps2 = m_moveDefaultAccelSPS2;
+
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->HlfbMode(MotorDriver::HLFB_MODE_HAS_BIPOLAR_PWM);
+        m_motors[i]->HlfbCarrier(HLFB_CARRIER);
+        m_motors[i]->VelMax(m_motorVelMaxSps);
+        m_motors[i]->AccelMax(m_motorAccelMaxSps2);
     }
-    
-    // Log warning if motors didn't enable in time
-    if (!m_motorA->StatusReg().bit.Enabled || !m_motorB->StatusReg().bit.Enabled) {
-        g_errorLog.logf(LOG_WARNING, "Motor enable timeout. M0=%d, M1=%d",
-                 m_motorA->StatusReg().bit.Enabled ? 1 : 0,
-                 m_motorB->StatusReg().bit.Enabled ? 1 : 0);
+
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->EnableRequest(true);
     }
     
-    // Initialize home sensors for gantry squaring homing
-    setupHomeSensors();
+    // Time-critical limit checks run from the fixed-rate control tick
+    g_controlTick.registerHook(&MotorController::controlTickHook, this);
+    g_controlTick.start();
+#if FORCE_REPLAY_ENABLED
+    g_forceReplay.setPositionSource(&MotorController::replayPositionHook, this);
+#endif
     
-    // Check for first boot and initialize NVM with defaults
-    NvmManager &nvmMgr = NvmManager::Instance();
-    const int32_t NVM_MAGIC_NUMBER = 0x50425231; // "PBR1" = PressBoi Release 1
-    int32_t magicValue = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(7 * 4));  // Byte offset 28
+    // The drives finish enabling while the rest of setup runs; home-on-boot waits for
+    // drivesEnabled() in the main loop
     
-    if (magicValue != NVM_MAGIC_NUMBER) {
-        // First boot detected - initialize all NVM locations with defaults
-        
-        // Location 3 (byte 12): Polarity (0 = normal, 1 = inverted)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(3 * 4), 0);
-        
-        // Location 4 (byte 16): Force mode (1 = load_cell default)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(4 * 4), 1);
-        
-        // Location 5 (byte 20): Motor torque scale (0.0335 × 100000)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(5 * 4), (int32_t)(0.0335f * 100000.0f));
-        
-        // Location 6 (byte 24): Motor torque offset (1.04 × 10000)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(6 * 4), (int32_t)(1.04f * 10000.0f));
-        
-        // Locations 8-12 (bytes 32-48): Machine strain compensation coefficients (floats)
-        for (int i = 0; i < 5; ++i) {
-            int32_t coeffBits;
-            memcpy(&coeffBits, &m_machineStrainCoeffs[i], sizeof(float));
-            nvmMgr.Int32(static_cast<NvmManager::NvmLocations>((8 + i) * 4), coeffBits);
-        }
-        
-        // Location 13 (byte 52): Home on boot (1 = true, 0 = false, default = true)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(13 * 4), 1);
-        
-        // Location 14 (byte 56): Retract position (float as bits, default = 0.0)
-        int32_t retractBits = 0;
-        float defaultRetract = 0.0f;
-        memcpy(&retractBits, &defaultRetract, sizeof(float));
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(14 * 4), retractBits);
-        
-        // Write magic number to indicate NVM is initialized (byte 28)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(7 * 4), NVM_MAGIC_NUMBER);
-    }
+    // Initialize home sensors for gantry squaring homing
+    setupHomeSensors();
+#if HOMING_RESTORE_ENABLED
+    loadHomeRecord();
+#endif
     
-    // Load polarity from NVM (0 = normal, 1 = inverted)
-    int32_t polarityValue = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(3 * 4));  // Byte offset 12
-    bool isInverted = (polarityValue == 1);
-    if (isInverted) {
-        strcpy(m_polarity, "inverted");
-    } else {
-        strcpy(m_polarity, "normal"); // Default if NVM empty or set to 0
-    }
+    // Persisted settings were loaded and range-checked by SettingsStore::load()
+    const PressSettings& settings = g_settings.get();
+    bool isInverted = (settings.polarity_inverted == 1);
+    m_polarity = isInverted ? POLARITY_INVERTED : POLARITY_NORMAL;
     
     // Apply polarity to motors
-    m_motorA->PolarityInvertSDDirection(isInverted);
-    m_motorB->PolarityInvertSDDirection(isInverted);
-    
-    // Load force mode from NVM (0 = motor_torque, 1 = load_cell)
-    int32_t forceModeValue = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(4 * 4));  // Byte offset 16
-    if (forceModeValue == 0) {
-        strcpy(m_force_mode, "motor_torque");
-    } else {
-        strcpy(m_force_mode, "load_cell"); // Default if NVM empty or set to 1
-    }
-    
-    // Load motor torque calibration from NVM
-    // NVM locations 5 and 6 store scale and offset as fixed-point (value * 100000 and * 10000)
-    int32_t scaleValue = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(5 * 4));   // Byte offset 20
-    int32_t offsetValue = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(6 * 4));  // Byte offset 24
-    
-    // Validate scale: should be in reasonable range (0.01 to 0.1) → stored as 1000 to 10000
-    if (scaleValue > 0 && scaleValue < 20000 && scaleValue != -1) {
-        m_motor_torque_scale = (float)scaleValue / 100000.0f; // Stored as value * 100000
-    } else {
-        // Invalid NVM - initialize with default
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(5 * 4), (int32_t)(0.0335f * 100000.0f));
-    }
-    
-    // Validate offset: should be in reasonable range (-10 to +10) → stored as -100000 to 100000
-    if (offsetValue > -100000 && offsetValue < 100000 && offsetValue != 0 && offsetValue != -1) {
-        m_motor_torque_offset = (float)offsetValue / 10000.0f; // Stored as value * 10000
-    } else {
-        // Invalid NVM - initialize with default
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(6 * 4), (int32_t)(1.04f * 10000.0f));
-    }
-    
-    // Load machine strain compensation coefficients (locations 8-12, bytes 32-48)
-    for (int i = 0; i < 5; ++i) {
-        int32_t coeffBits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>((8 + i) * 4));
-        if (coeffBits != 0 && coeffBits != -1) {
-            float tempCoeff;
-            memcpy(&tempCoeff, &coeffBits, sizeof(float));
-            if (tempCoeff > -5e9f && tempCoeff < 5e9f && std::fabs(tempCoeff) < 1e4f) {
-                m_machineStrainCoeffs[i] = tempCoeff;
-                continue;
-            }
-        }
-        // Invalid or empty - write default value
-        float defaultCoeff;
-        switch (i) {
-            case 0: defaultCoeff = MACHINE_STRAIN_COEFF_X4; break;
-            case 1: defaultCoeff = MACHINE_STRAIN_COEFF_X3; break;
-            case 2: defaultCoeff = MACHINE_STRAIN_COEFF_X2; break;
-            case 3: defaultCoeff = MACHINE_STRAIN_COEFF_X1; break;
-            default: defaultCoeff = MACHINE_STRAIN_COEFF_C; break;
-        }
-        m_machineStrainCoeffs[i] = defaultCoeff;
-        int32_t defaultBits;
-        memcpy(&defaultBits, &defaultCoeff, sizeof(float));
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>((8 + i) * 4), defaultBits);
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->PolarityInvertSDDirection(isInverted);
     }
     
-    // Load home on boot setting (location 13, byte 52)
-    int32_t homeOnBootValue = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(13 * 4));
-    if (homeOnBootValue == 0) {
-        m_home_on_boot = false;
-    } else {
-        m_home_on_boot = true; // Default to true if not set or set to 1
-    }
+    m_force_mode = (settings.force_mode == 0) ? FORCE_MODE_MOTOR_TORQUE : FORCE_MODE_LOAD_CELL;
+    m_motor_torque_scale = settings.torque_scale;
+    m_motor_torque_offset = settings.torque_offset;
+    m_machineStrain.setCoefficients(settings.strain_coeffs);
+    m_home_on_boot = (settings.home_on_boot != 0);
     
-    // Load retract position (location 14, byte 56)
-    // This is stored as an OFFSET from home (mm), not an absolute position
-    // It will be converted to steps AFTER homing when m_machineHomeReferenceSteps is known
-    int32_t retractBits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(14 * 4));
-    if (retractBits != 0 && retractBits != -1) {
-        float tempRetract;
-        memcpy(&tempRetract, &retractBits, sizeof(float));
-        // Validate retract position is in reasonable range (-100mm to +100mm)
-        if (tempRetract >= -100.0f && tempRetract <= 100.0f) {
-            m_retract_position_mm = tempRetract;
-            // Don't set m_retractReferenceSteps yet - leave it as LONG_MIN
-            // It will be calculated after homing based on m_retract_position_mm
-        }
+    // Retract position is an OFFSET from home (mm); it is converted to steps after homing,
+    // when m_machineHomeReferenceSteps is known, so m_retractReferenceSteps stays LONG_MIN
+    m_retract_position_mm = settings.retract_mm;
+    m_press_threshold_kg = settings.press_threshold_kg;
+    m_forceChannel = static_cast<ForceChannelSelect>(settings.force_channel);
+    m_motionJerkMmss3 = settings.motion_jerk;
+    m_rapidVelMms = settings.rapid_vel_mms;
+    m_rapidAccelMmss = settings.rapid_accel_5mmss * RAPID_ACCEL_UNIT_MMSS;
+    m_rapidAccelSps2 = toStepsPerSec(MmPerSec((float)m_rapidAccelMmss)).value;
+    if (settings.encoder_counts_per_mm != 0.0f) {
+        configureEncoder(settings.encoder_counts_per_mm, settings.encoder_tolerance_mm);
     }
     
-    // Load press threshold (location 15, byte 60) - default 2.0 kg
-    m_press_threshold_kg = 2.0f;  // Default
-    int32_t thresholdBits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(15 * 4));
-    if (thresholdBits != 0 && thresholdBits != -1) {
-        float tempThreshold;
-        memcpy(&tempThreshold, &thresholdBits, sizeof(float));
-        // Validate threshold is in reasonable range (0.1 to 50.0 kg)
-        if (tempThreshold >= 0.1f && tempThreshold <= 50.0f) {
-            m_press_threshold_kg = tempThreshold;
+    // Load torque friction table (locations 66-70) - default none
+    NvmManager &nvmMgr = NvmManager::Instance();
+    int32_t frictionCount = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_TORQUE_FRICTION_COUNT * 4));
+    if (frictionCount >= 1 && frictionCount <= TORQUE_FRICTION_MAX_POINTS) {
+        int32_t sps[TORQUE_FRICTION_MAX_POINTS];
+        float pct[TORQUE_FRICTION_MAX_POINTS];
+        for (int32_t i = 0; i < frictionCount; i++) {
+            uint32_t packed = (uint32_t)nvmMgr.Int32(static_cast<NvmManager::NvmLocations>((NVM_SLOT_TORQUE_FRICTION_POINTS + i) * 4));
+            sps[i] = (int32_t)(packed & 0xFFFF);
+            pct[i] = (int16_t)(packed >> 16) / 100.0f;
         }
+        // A corrupt table is ignored rather than half-applied
+        applyTorqueFriction(sps, pct, (uint8_t)frictionCount);
     }
 }
 
-float MotorController::evaluateMachineStrainForceFromDeflection(float deflection_mm) const {
-    float x = deflection_mm;
-    if (x < 0.0f) {
-        x = 0.0f;
-    }
-
-    float force = (((m_machineStrainCoeffs[0] * x + m_machineStrainCoeffs[1]) * x + m_machineStrainCoeffs[2]) * x + m_machineStrainCoeffs[3]) * x + m_machineStrainCoeffs[4];
-    if (force < 0.0f) {
-        force = 0.0f;
-    }
-    return force;
-}
-
-float MotorController::estimateMachineDeflectionFromForce(float force_kg) const {
-    if (force_kg <= 0.0f) {
-        return 0.0f;
-    }
-
-    float min_force = evaluateMachineStrainForceFromDeflection(0.0f);
-    if (force_kg <= min_force) {
-        return 0.0f;
-    }
+/** Walk state of collectStrainFit() over the press capture. */
+struct StrainFitContext {
+    const ForceSensor* sensor;  ///< Sensor whose raw counts the capture holds
+    float threshold_kg;         ///< Force that marks zero deflection
+    float steps_per_mm;         ///< Drive geometry
+    bool contact;               ///< The threshold has been crossed
+    int32_t contact_steps;      ///< Position of the crossing
+    float last_mm;              ///< Deflection of the previous sample kept
+    float peak_kg;              ///< Highest force kept
+    MachineStrainFit* fit;      ///< Fit being filled
+};
 
-    float low = 0.0f;
-    float high = MACHINE_STRAIN_MAX_DEFLECTION_MM;
-
-    // Expand high bound until polynomial exceeds target force or we hit a safety ceiling
-    const float MAX_DEFLECTION = MACHINE_STRAIN_MAX_DEFLECTION_MM * 4.0f;
-    int expansion_iterations = 0;
-    const int MAX_EXPANSION_ITERATIONS = 20;  // Safety limit
-    while (evaluateMachineStrainForceFromDeflection(high) < force_kg && high < MAX_DEFLECTION && expansion_iterations < MAX_EXPANSION_ITERATIONS) {
-        high *= 1.5f;
-        expansion_iterations++;
-        if (high > MAX_DEFLECTION) {
-            high = MAX_DEFLECTION;
-            break;
+static void strainFitVisitor(void* context, int32_t position_steps, int32_t raw) {
+    StrainFitContext* walk = static_cast<StrainFitContext*>(context);
+    float force_kg = walk->sensor->countsToKg(raw);
+    if (!walk->contact) {
+        if (force_kg < walk->threshold_kg) {
+            return;
         }
+        walk->contact = true;
+        walk->contact_steps = position_steps;
+        walk->last_mm = -1.0f;
     }
-
-    // Binary search for deflection producing the given force
-    for (int i = 0; i < 20; ++i) {
-        float mid = 0.5f * (low + high);
-        float f_mid = evaluateMachineStrainForceFromDeflection(mid);
-        if (f_mid < force_kg) {
-            low = mid;
-        } else {
-            high = mid;
-        }
+    float deflection_mm = fabsf((float)(position_steps - walk->contact_steps)) / walk->steps_per_mm;
+    if (deflection_mm <= walk->last_mm) {
+        return;
+    }
+    walk->last_mm = deflection_mm;
+    walk->fit->add(deflection_mm, force_kg);
+    if (force_kg > walk->peak_kg) {
+        walk->peak_kg = force_kg;
     }
+}
 
-    return high;
+float MotorController::collectStrainFit(MachineStrainFit* fit) const {
+    StrainFitContext walk = {};
+    walk.sensor = &primaryForceSensor();
+    walk.threshold_kg = m_press_threshold_kg;
+    walk.steps_per_mm = g_driveGeometry.stepsPerMm();
+    walk.fit = fit;
+    fit->reset();
+    g_pressCapture.visit(&strainFitVisitor, &walk);
+    return walk.peak_kg;
 }
 
 void MotorController::setMachineStrainCoeffs(float coeff_x4, float coeff_x3, float coeff_x2, float coeff_x1, float coeff_c) {
-    m_machineStrainCoeffs[0] = coeff_x4;
-    m_machineStrainCoeffs[1] = coeff_x3;
-    m_machineStrainCoeffs[2] = coeff_x2;
-    m_machineStrainCoeffs[3] = coeff_x1;
-    m_machineStrainCoeffs[4] = coeff_c;
-    m_prevForceValid = false;
-    m_prevTotalDeflectionMm = 0.0;
-    m_prevMachineDeflectionMm = 0.0;
-    m_machineEnergyJ = 0.0;
-    m_machineStrainContactActive = false;
+    const float coeffs[5] = { coeff_x4, coeff_x3, coeff_x2, coeff_x1, coeff_c };
+    m_machineStrain.setCoefficients(coeffs);
+    m_energy.invalidate();
+    m_energy.clearContact();
     
-    NvmManager &nvmMgr = NvmManager::Instance();
-    for (int i = 0; i < 5; ++i) {
-        int32_t bits;
-        memcpy(&bits, &m_machineStrainCoeffs[i], sizeof(float));
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>((8 + i) * 4), bits);
-    }
+    PressSettings& settings = g_settings.edit();
+    memcpy(settings.strain_coeffs, coeffs, sizeof(settings.strain_coeffs));
 }
 
 /**
  * @brief The main update loop for the motor controller's state machines.
  */
 void MotorController::updateState() {
-    // Update joule integration for active moves (50Hz)
+    // Pull every load-cell sample captured since the last pass
+    drainForceSamples();
+    updateMoveStats();
+    recordPositionHistory();
+    
+    // Update joule integration for active moves (once per load-cell sample)
     updateJoules();
     
+    serviceEncoderFault();
+#if RACKING_CORRECTION_ENABLED
+    serviceRackingFault();
+#endif
+#if THERMAL_MODEL_ENABLED
+    serviceThermal();
+#endif
+#if HOMING_RESTORE_ENABLED
+    saveHomeRecord();
+#endif
+    
+    // The capture spans the whole press, including queued segments and dwells
+    if (g_pressCapture.isCapturing() && m_state != STATE_MOVING) {
+        g_pressCapture.end();
+    }
+#if POSITION_CURVE_ENABLED
+    if (g_positionCurve.isCapturing() && m_state != STATE_MOVING) {
+        g_positionCurve.end(Microseconds());
+    }
+#endif
+    
+    // A queue that left STATE_MOVING other than by running dry (error, cancel, limit retract/abort) is dropped
+    if (m_motionQueueRunning && m_state != STATE_MOVING) {
+        m_motionQueueRunning = false;
+        if (m_motionQueueCount > 0) {
+            m_motionQueueCount = 0;
+            m_motionQueueHead = 0;
+            reportEvent(STATUS_PREFIX_INFO, "Motion queue stopped. Remaining segments discarded.");
+        }
+    }
+    
+    // One record per state or homing phase change, wherever in this file it was made
+    if (m_state != m_tracedState || m_homingPhase != m_tracedHomingPhase) {
+        m_tracedState = m_state;
+        m_tracedHomingPhase = m_homingPhase;
+        TRACE(TRACE_MOTOR_STATE, m_state, m_homingPhase);
+    }
+    
     switch (m_state) {
         case STATE_STANDBY:
         // Do nothing while in standby
@@ -382,7 +556,7 @@ void MotorController::updateState() {
             // Check for homing timeout
             if (Milliseconds() - m_homingStartTime > MAX_HOMING_DURATION_MS) {
                 abortMove();
-                reportEvent(STATUS_PREFIX_ERROR, "Homing failed: Timeout exceeded.");
+                postEvent(STATUS_EVENT_HOMING_TIMEOUT);
                 m_state = STATE_STANDBY;
                 m_homingPhase = HOMING_PHASE_IDLE;
                 break;
@@ -393,13 +567,13 @@ void MotorController::updateState() {
                 // RAPID APPROACH - Both axes move toward home, stop individually on sensor
                 //==============================================================================
                 case RAPID_APPROACH_START: {
-                    reportEvent(STATUS_PREFIX_INFO, "Homing: Starting rapid approach (gantry squaring).");
+                    postEvent(STATUS_EVENT_HOMING_RAPID_START);
                     
                     // Reset axis tracking flags
-                    m_axisAStopped = false;
-                    m_axisBStopped = false;
-                    m_axisAHomeSensorTriggered = false;
-                    m_axisBHomeSensorTriggered = false;
+                    for (int i = 0; i < m_axisCount; i++) {
+                        m_axisStopped[i] = false;
+                        m_axisHomeSensorTriggered[i] = false;
+                    }
                     
                     // Set torque limit as backup safety
                     m_torqueLimit = HOMING_BACKOFF_TORQUE_PERCENT;
@@ -410,75 +584,58 @@ void MotorController::updateState() {
                         rapid_search_steps = -rapid_search_steps;
                     }
                     
-                    // Start both motors moving together
+                    // Start all motors moving together
                     startMove(rapid_search_steps, m_homingRapidSps, m_homingAccelSps2);
+                    m_homingPhaseStartTime = Milliseconds();
                     m_homingPhase = RAPID_APPROACH_WAIT_TO_START;
-                    break;
+                    // Fall through - the step generators hold the move as soon as Move() returns
                 }
                 
                 case RAPID_APPROACH_WAIT_TO_START: {
-                    // CRITICAL: Verify BOTH motors are moving before proceeding
+                    // CRITICAL: Verify ALL motors are moving before proceeding
                     // Using isMoving() alone would pass if only ONE motor started
-                    bool m0_moving = m_motorA->StatusReg().bit.StepsActive;
-                    bool m1_moving = m_motorB->StatusReg().bit.StepsActive;
-                    
-                    if (m0_moving && m1_moving) {
+                    if (homingMoveStarted(true, "Homing failed: Not all motors started.")) {
                         m_homingPhase = RAPID_APPROACH_MOVING;
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: Rapid approach moving, monitoring sensors.");
-                    } else if (Milliseconds() - m_homingStartTime > 500) {
-                        abortMove();
-                        char errorMsg[200];
-                        snprintf(errorMsg, sizeof(errorMsg), 
-                            "Homing failed: Not all motors started. M0_moving=%d M1_moving=%d M0_status=0x%04X M1_status=0x%04X",
-                            m0_moving ? 1 : 0, m1_moving ? 1 : 0,
-                            (unsigned int)m_motorA->StatusReg().reg, (unsigned int)m_motorB->StatusReg().reg);
-                        reportEvent(STATUS_PREFIX_ERROR, errorMsg);
-                        m_state = STATE_STANDBY;
-                        m_homingPhase = HOMING_PHASE_IDLE;
+                        postEvent(STATUS_EVENT_HOMING_RAPID_MOVING);
                     }
                     break;
                 }
                 
                 case RAPID_APPROACH_MOVING: {
-                    // Check Motor A (M0) sensor - stop if triggered and not already stopped
-                    if (!m_axisAStopped && isHomeSensorTriggered(0)) {
-                        stopAxis(0);
-                        m_axisAStopped = true;
-                        m_axisAHomeSensorTriggered = true;
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: M0 sensor triggered (rapid).");
-                    }
-                    
-                    // Check Motor B (M1) sensor - stop if triggered and not already stopped
-                    if (!m_axisBStopped && isHomeSensorTriggered(1)) {
-                        stopAxis(1);
-                        m_axisBStopped = true;
-                        m_axisBHomeSensorTriggered = true;
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: M1 sensor triggered (rapid).");
+                    // Stop each axis whose sensor triggered and that is not already stopped
+                    for (int i = 0; i < m_axisCount; i++) {
+                        if (!m_axisStopped[i] && isHomeSensorTriggered(i)) {
+                            stopAxis(i);
+                            m_axisStopped[i] = true;
+                            m_axisHomeSensorTriggered[i] = true;
+                            postEvent(STATUS_EVENT_HOMING_SENSOR_RAPID, eventArgI(i));
+                        }
                     }
                     
-                    // Check for torque limit as backup safety (stops both)
+                    // Check for torque limit as backup safety (stops all)
                     if (checkTorqueLimit()) {
                         abortMove();
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: Torque limit hit during rapid approach (backup safety).");
-                        m_axisAStopped = true;
-                        m_axisBStopped = true;
+                        postEvent(STATUS_EVENT_HOMING_RAPID_TORQUE);
+                        for (int i = 0; i < m_axisCount; i++) {
+                            m_axisStopped[i] = true;
+                        }
                     }
                     
-                    // Transition when both axes have stopped
-                    if (m_axisAStopped && m_axisBStopped) {
+                    // Transition when all axes have stopped
+                    if (allAxesSet(m_axisStopped)) {
                         // Verify at least one sensor triggered (not just torque limit)
-                        if (m_axisAHomeSensorTriggered || m_axisBHomeSensorTriggered) {
-                            reportEvent(STATUS_PREFIX_INFO, "Homing: Rapid approach complete, starting backoff.");
+                        if (countAxesSet(m_axisHomeSensorTriggered) > 0) {
+                            postEvent(STATUS_EVENT_HOMING_RAPID_COMPLETE);
                             m_homingPhase = BACKOFF_START;
                         } else {
-                            reportEvent(STATUS_PREFIX_ERROR, "Homing failed: No sensors triggered during rapid approach.");
+                            postEvent(STATUS_EVENT_HOMING_RAPID_NO_SENSOR);
                             m_state = STATE_STANDBY;
                             m_homingPhase = HOMING_PHASE_IDLE;
                         }
                     } else if (!isMoving()) {
                         // Motors stopped but not all sensors triggered - check if travel exceeded
                         abortMove();
-                        reportEvent(STATUS_PREFIX_ERROR, "Homing failed: Motion stopped before sensors triggered.");
+                        postEvent(STATUS_EVENT_HOMING_RAPID_STOPPED);
                         m_state = STATE_STANDBY;
                         m_homingPhase = HOMING_PHASE_IDLE;
                     }
@@ -489,25 +646,26 @@ void MotorController::updateState() {
                 // BACKOFF - Both axes back off together
                 //==============================================================================
                 case BACKOFF_START: {
-                    reportEvent(STATUS_PREFIX_INFO, "Homing: Starting backoff.");
+                    postEvent(STATUS_EVENT_HOMING_BACKOFF_START);
                     
                     // Reset axis flags for next phase
-                    m_axisAStopped = false;
-                    m_axisBStopped = false;
-                    m_axisAHomeSensorTriggered = false;
-                    m_axisBHomeSensorTriggered = false;
+                    for (int i = 0; i < m_axisCount; i++) {
+                        m_axisStopped[i] = false;
+                        m_axisHomeSensorTriggered[i] = false;
+                    }
                     
                     m_torqueLimit = HOMING_BACKOFF_TORQUE_PERCENT;
                     
                     // Backoff direction is opposite of approach
                     long backoff_steps = (m_homingState == HOMING) ? m_homingBackoffSteps : -m_homingBackoffSteps;
                     startMove(backoff_steps, m_homingBackoffSps, m_homingAccelSps2);
+                    m_homingPhaseStartTime = Milliseconds();
                     m_homingPhase = BACKOFF_WAIT_TO_START;
-                    break;
+                    // Fall through
                 }
                 
                 case BACKOFF_WAIT_TO_START: {
-                    if (isMoving()) {
+                    if (homingMoveStarted(false, "Homing failed: Backoff did not start.")) {
                         m_homingPhase = BACKOFF_MOVING;
                     }
                     break;
@@ -515,7 +673,7 @@ void MotorController::updateState() {
                 
                 case BACKOFF_MOVING: {
                     if (!isMoving()) {
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: Backoff complete, starting slow approach.");
+                        postEvent(STATUS_EVENT_HOMING_BACKOFF_COMPLETE);
                         m_homingPhase = SLOW_APPROACH_START;
                     }
                     break;
@@ -525,77 +683,75 @@ void MotorController::updateState() {
                 // SLOW APPROACH - Both axes approach slowly, stop individually on sensor
                 //==============================================================================
                 case SLOW_APPROACH_START: {
-                    reportEvent(STATUS_PREFIX_INFO, "Homing: Starting slow approach for precision.");
+                    postEvent(STATUS_EVENT_HOMING_SLOW_START);
                     
                     // Reset axis tracking flags
-                    m_axisAStopped = false;
-                    m_axisBStopped = false;
-                    m_axisAHomeSensorTriggered = false;
-                    m_axisBHomeSensorTriggered = false;
+                    for (int i = 0; i < m_axisCount; i++) {
+                        m_axisStopped[i] = false;
+                        m_axisHomeSensorTriggered[i] = false;
+                    }
                     
                     m_torqueLimit = HOMING_BACKOFF_TORQUE_PERCENT;
                     
                     // Slow approach in same direction as rapid, but only 2x backoff distance
                     long slow_approach_steps = (m_homingState == HOMING) ? -m_homingBackoffSteps * 2 : m_homingBackoffSteps * 2;
+                    for (int i = 0; i < m_axisCount; i++) {
+                        armHomeLatch(i);
+                    }
                     startMove(slow_approach_steps, m_homingTouchSps, m_homingAccelSps2);
+                    m_homingPhaseStartTime = Milliseconds();
                     m_homingPhase = SLOW_APPROACH_WAIT_TO_START;
-                    break;
+                    // Fall through
                 }
                 
                 case SLOW_APPROACH_WAIT_TO_START: {
-                    if (isMoving()) {
+                    if (homingMoveStarted(false, "Homing failed: Slow approach did not start.")) {
                         m_homingPhase = SLOW_APPROACH_MOVING;
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: Slow approach moving, monitoring sensors.");
+                        postEvent(STATUS_EVENT_HOMING_SLOW_MOVING);
                     }
                     break;
                 }
                 
                 case SLOW_APPROACH_MOVING: {
-                    // Check Motor A (M0) sensor - stop if triggered and not already stopped
-                    if (!m_axisAStopped && isHomeSensorTriggered(0)) {
-                        stopAxis(0);
-                        m_axisAStopped = true;
-                        m_axisAHomeSensorTriggered = true;
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: M0 sensor triggered (slow) - precise position found.");
-                    }
-                    
-                    // Check Motor B (M1) sensor - stop if triggered and not already stopped
-                    if (!m_axisBStopped && isHomeSensorTriggered(1)) {
-                        stopAxis(1);
-                        m_axisBStopped = true;
-                        m_axisBHomeSensorTriggered = true;
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: M1 sensor triggered (slow) - precise position found.");
+                    // Stop each axis whose sensor triggered and that is not already stopped
+                    for (int i = 0; i < m_axisCount; i++) {
+                        if (!m_axisStopped[i] && isHomeSensorTriggered(i)) {
+                            stopAxis(i);
+                            m_axisStopped[i] = true;
+                            m_axisHomeSensorTriggered[i] = true;
+                            m_homeTriggerSteps[i] = takeHomeLatch(i);
+                            postEvent(STATUS_EVENT_HOMING_SENSOR_SLOW, eventArgI(i));
+                        }
                     }
                     
                     // Check for torque limit as backup safety
                     if (checkTorqueLimit()) {
                         abortMove();
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: Torque limit hit during slow approach (backup safety).");
-                        m_axisAStopped = true;
-                        m_axisBStopped = true;
+                        postEvent(STATUS_EVENT_HOMING_SLOW_TORQUE);
+                        for (int i = 0; i < m_axisCount; i++) {
+                            m_axisStopped[i] = true;
+                        }
                     }
                     
-                    // Transition when both axes have stopped
-                    if (m_axisAStopped && m_axisBStopped) {
-                        if (m_axisAHomeSensorTriggered && m_axisBHomeSensorTriggered) {
-                            reportEvent(STATUS_PREFIX_INFO, "Homing: Both sensors triggered, gantry squared. Moving to offset.");
+                    // Transition when all axes have stopped
+                    if (allAxesSet(m_axisStopped)) {
+                        int triggered = countAxesSet(m_axisHomeSensorTriggered);
+                        if (triggered == m_axisCount) {
+                            postEvent(STATUS_EVENT_HOMING_SQUARED);
                             m_homingPhase = FINAL_BACKOFF_START;
-                        } else if (m_axisAHomeSensorTriggered || m_axisBHomeSensorTriggered) {
-                            // Only one sensor triggered - this is a partial success, continue anyway
-                            char warnMsg[128];
-                            snprintf(warnMsg, sizeof(warnMsg), "Homing: Warning - only %s sensor triggered during slow approach.",
-                                     m_axisAHomeSensorTriggered ? "M0" : "M1");
-                            reportEvent(STATUS_PREFIX_INFO, warnMsg);
+                        } else if (triggered > 0) {
+                            // Only some sensors triggered - this is a partial success, continue anyway
+                            postEvent(STATUS_EVENT_HOMING_PARTIAL_SENSORS, eventArgI(triggered), eventArgI(m_axisCount));
                             m_homingPhase = FINAL_BACKOFF_START;
                         } else {
-                            reportEvent(STATUS_PREFIX_ERROR, "Homing failed: No sensors triggered during slow approach.");
+                            postEvent(STATUS_EVENT_HOMING_SLOW_NO_SENSOR);
                             m_state = STATE_STANDBY;
                             m_homingPhase = HOMING_PHASE_IDLE;
                         }
                     } else if (!isMoving()) {
                         // Motors stopped but not all sensors triggered
                         abortMove();
-                        reportEvent(STATUS_PREFIX_ERROR, "Homing failed: Motion stopped before sensors triggered (slow).");
+                        postEvent(STATUS_EVENT_HOMING_SLOW_STOPPED);
                         m_state = STATE_STANDBY;
                         m_homingPhase = HOMING_PHASE_IDLE;
                     }
@@ -606,19 +762,26 @@ void MotorController::updateState() {
                 // FINAL BACKOFF - Move to offset position and set zero
                 //==============================================================================
                 case FINAL_BACKOFF_START: {
-                    reportEvent(STATUS_PREFIX_INFO, "Homing: Moving to final offset position.");
+                    postEvent(STATUS_EVENT_HOMING_OFFSET_START);
                     
                     m_torqueLimit = HOMING_BACKOFF_TORQUE_PERCENT;
                     
-                    // Move to final offset position (away from sensors)
+                    // Move to final offset position (away from sensors), measured from the trigger
+                    // point rather than from wherever each axis came to rest
                     long offset_steps = (m_homingState == HOMING) ? m_homingBackoffSteps : -m_homingBackoffSteps;
-                    startMove(offset_steps, m_homingBackoffSps, m_homingAccelSps2);
+                    m_tickTorqueReseed = true;
+                    for (int i = 0; i < m_axisCount; i++) {
+                        startMoveAxis(i, m_axisHomeSensorTriggered[i]
+                                      ? m_homeTriggerSteps[i] + offset_steps - m_motors[i]->PositionRefCommanded()
+                                      : offset_steps, m_homingBackoffSps, m_homingAccelSps2);
+                    }
+                    m_homingPhaseStartTime = Milliseconds();
                     m_homingPhase = FINAL_BACKOFF_WAIT_TO_START;
-                    break;
+                    // Fall through
                 }
                 
                 case FINAL_BACKOFF_WAIT_TO_START: {
-                    if (isMoving()) {
+                    if (homingMoveStarted(false, "Homing failed: Final backoff did not start.")) {
                         m_homingPhase = FINAL_BACKOFF_MOVING;
                     }
                     break;
@@ -626,12 +789,70 @@ void MotorController::updateState() {
                 
                 case FINAL_BACKOFF_MOVING: {
                     if (!isMoving()) {
-                        reportEvent(STATUS_PREFIX_INFO, "Homing: Final position reached.");
+                        postEvent(STATUS_EVENT_HOMING_OFFSET_REACHED);
                         m_homingPhase = SET_ZERO;
                     }
                     break;
                 }
                 
+                //==============================================================================
+                // PARALLEL HOMING - Each axis advances on its own (see advanceAxisHoming())
+                //==============================================================================
+                case PARALLEL_HOMING_START: {
+                    for (int i = 0; i < m_axisCount; i++) {
+                        m_axisHomeSensorTriggered[i] = false;
+                    }
+                    m_torqueLimit = HOMING_BACKOFF_TORQUE_PERCENT;
+                    m_tickTorqueReseed = true;
+                    m_homingSpikeTripped = false;
+
+                    for (int axis = 0; axis < m_axisCount; axis++) {
+                        if (!(m_homingHybrid && startAxisHybridApproach(axis))) {
+                            startAxisHomingApproach(axis);
+                        }
+                    }
+                    postEvent(m_axisHomingVerify[0] ? STATUS_EVENT_HOMING_VERIFY_START : STATUS_EVENT_HOMING_PARALLEL_START);
+                    m_homingPhase = PARALLEL_HOMING_MOVING;
+                    break;
+                }
+
+                case PARALLEL_HOMING_MOVING: {
+                    if (m_homingSpikeTripped) {
+                        m_homingSpikeTripped = false;
+                        abortMove();
+                        // Something stood between the axis and its learned home; do not run at it blind again
+                        m_homeLearned = false;
+                        postEvent(STATUS_EVENT_HOMING_HYBRID_TORQUE, eventArgI(m_homingSpikeAxis), eventArgF(m_homingSpikeRisePct));
+                        m_state = STATE_STANDBY;
+                        m_homingPhase = HOMING_PHASE_IDLE;
+                        break;
+                    }
+                    if (checkTorqueLimit()) {
+                        abortMove();
+                        postEvent(STATUS_EVENT_HOMING_PARALLEL_TORQUE);
+                        m_state = STATE_STANDBY;
+                        m_homingPhase = HOMING_PHASE_IDLE;
+                        break;
+                    }
+                    bool axes_ok = true;
+                    bool axes_done = true;
+                    for (int i = 0; i < m_axisCount && axes_ok; i++) {
+                        axes_ok = advanceAxisHoming(i);
+                        axes_done = axes_done && (m_axisHomingPhase[i] == AXIS_HOMING_DONE);
+                    }
+                    if (!axes_ok) {
+                        abortMove();
+                        m_state = STATE_STANDBY;
+                        m_homingPhase = HOMING_PHASE_IDLE;
+                        break;
+                    }
+                    if (axes_done) {
+                        postEvent(STATUS_EVENT_HOMING_PARALLEL_DONE);
+                        m_homingPhase = SET_ZERO;
+                    }
+                    break;
+                }
+
                 //==============================================================================
                 // SET ZERO - Set home reference position
                 //==============================================================================
@@ -639,28 +860,27 @@ void MotorController::updateState() {
                     const char* commandStr = (m_homingState == HOMING) ? "home" : "cartridge_home";
                     
                     if (m_homingState == HOMING) {
-                        m_machineHomeReferenceSteps = m_motorA->PositionRefCommanded();
+                        m_machineHomeReferenceSteps = m_motors[0]->PositionRefCommanded();
                         m_homingDone = true;
+                        // Only a home where every sensor was touched can be verified later
+                        m_homeTrusted = allAxesSet(m_axisHomeSensorTriggered);
+                        m_homeLearned = m_homeLearned || m_homeTrusted;
                         
                         // If a retract position was loaded from NVM or set manually, recalculate it
                         // based on the new home reference.
                         if (m_retract_position_mm != 0.0f) {
-                            m_retractReferenceSteps = m_machineHomeReferenceSteps + static_cast<long>(m_retract_position_mm * STEPS_PER_MM);
-                            
-                            char dbg[128];
-                            snprintf(dbg, sizeof(dbg), "Retract position recalculated after homing: %.2f mm (steps=%ld, home=%ld)", 
-                                     m_retract_position_mm, m_retractReferenceSteps, m_machineHomeReferenceSteps);
-                            reportEvent(STATUS_PREFIX_INFO, dbg);
+                            m_retractReferenceSteps = absoluteSteps(Millimeters(m_retract_position_mm));
+                            postEvent(STATUS_EVENT_HOMING_RETRACT_RECALCULATED, eventArgF(m_retract_position_mm),
+                                      eventArgI((int32_t)m_retractReferenceSteps), eventArgI((int32_t)m_machineHomeReferenceSteps));
                         }
                         
                         // Report sensor states at home position
-                        char sensorMsg[128];
-                        snprintf(sensorMsg, sizeof(sensorMsg), "Homing complete. Sensor states: M0=%d, M1=%d",
-                                 getHomeSensorState(0) ? 1 : 0, getHomeSensorState(1) ? 1 : 0);
+                        char sensorMsg[128] = "Homing complete. Sensor states:";
+                        appendHomeSensorStates(sensorMsg, sizeof(sensorMsg));
                         reportEvent(STATUS_PREFIX_INFO, sensorMsg);
                         
                     } else { // HOMING_CARTRIDGE
-                        m_retractReferenceSteps = m_motorA->PositionRefCommanded();
+                        m_retractReferenceSteps = m_motors[0]->PositionRefCommanded();
                         m_retractDone = true;
                     }
                     
@@ -673,7 +893,7 @@ void MotorController::updateState() {
                 }
                 
                 case HOMING_PHASE_ERROR: {
-                    reportEvent(STATUS_PREFIX_ERROR, "Homing sequence ended with error.");
+                    postEvent(STATUS_EVENT_HOMING_PHASE_ERROR);
                     m_state = STATE_STANDBY;
                     m_homingPhase = HOMING_PHASE_IDLE;
                     break;
@@ -681,7 +901,7 @@ void MotorController::updateState() {
                 
                 default: {
                     abortMove();
-                    reportEvent(STATUS_PREFIX_ERROR, "Unknown homing phase, aborting.");
+                    postEvent(STATUS_EVENT_HOMING_PHASE_UNKNOWN);
                     m_state = STATE_STANDBY;
                     m_homingPhase = HOMING_PHASE_IDLE;
                     break;
@@ -691,9 +911,63 @@ void MotorController::updateState() {
         }
 
         case STATE_MOVING: {
+#if STATION_IO_ENABLED
+            // The control tick stopped a recipe run whose station interlock opened
+            if (m_interlockTripped) {
+                m_interlockTripped = false;
+                m_motionQueueHead = 0;
+                m_motionQueueCount = 0;
+                m_motionQueueRunning = false;
+                postEvent(STATUS_EVENT_INTERLOCK_OPEN, eventArgI((int32_t)m_interlockInputs),
+                          eventArgI((int32_t)m_interlockFaults));
+                finalizeAndResetActiveMove(false);
+                m_state = STATE_STANDBY;
+                return;
+            }
+#endif
+            // Queued dwell: motors are stopped, just wait out the time
+            if (m_moveState == MOVE_DWELL) {
+                if (Milliseconds() - m_dwellStartTime >= m_dwellDurationMs && !handoffQueuedSegment(false)) {
+                    if (m_activeMoveCommand) {
+                        reportMoveDone(m_activeMoveCommand);
+                    }
+                    finalizeAndResetActiveMove(true);
+                    m_state = STATE_STANDBY;
+                }
+                break;
+            }
+#if PRESS_SYNC_ENABLED
+            // Held at a segment start: motors are stopped until press sync's start time
+            if (m_moveState == MOVE_SYNC_WAIT) {
+                if (m_syncReleasePending && (int32_t)(Microseconds() - m_syncReleaseUs) >= 0) {
+                    m_syncReleasePending = false;
+                    m_syncReleased = true;
+                    MoveStartResult result = startNextQueuedSegment(m_syncContinuing, false);
+                    if (result != MOVE_START_OK) {
+                        if (result == MOVE_START_NOOP) {
+                            m_motionQueueRunning = false;
+                            reportMoveDone(m_activeMoveCommand);
+                        }
+                        finalizeAndResetActiveMove(result == MOVE_START_NOOP);
+                        m_state = STATE_STANDBY;
+                    }
+                }
+                break;
+            }
+#endif
+            
+            // A recipe move that left its envelope was stopped in updateJoules(); the part is bad
+            if (m_envelopeTripped) {
+                postEvent(STATUS_EVENT_ENVELOPE_LEFT, eventArgF(m_envelopePositionMm), eventArgF(m_envelopeKg),
+                          eventArgF(m_envelopeBoundKg));
+                finalizeAndResetActiveMove(false);
+                m_state = STATE_STANDBY;
+                return;
+            }
+
             // Check limits based on mode
             if (m_moveState == MOVE_ACTIVE) {
-                if (strcmp(m_active_op_force_mode, "load_cell") == 0) {
+                if (m_active_op_force_mode == FORCE_MODE_LOAD_CELL) {
                     // Load cell mode - check force sensor status and force limit
                     const char* errorMsg = nullptr;
                     if (checkForceSensorStatus(&errorMsg)) {
@@ -705,37 +979,115 @@ void MotorController::updateState() {
                         return;
                     }
                     
-                    // Check force limit (if set)
-                    if (m_active_op_force_limit_kg > 0.1f) {
-                        float current_force = m_controller->m_forceSensor.getForce();
-                        if (current_force >= m_active_op_force_limit_kg) {
-                            char limit_desc[STATUS_MESSAGE_BUFFER_SIZE];
-                            snprintf(limit_desc, sizeof(limit_desc), "Force limit (%.1f kg, actual: %.1f kg)", 
-                                     m_active_op_force_limit_kg, current_force);
-                            handleLimitReached(limit_desc, current_force);
+                    if (m_seatDetected) {
+                        handleLimitReached(STATUS_EVENT_SEAT_REACHED, m_seatStiffnessKgMm, m_seatBaselineKgMm);
+                        return;
+                    }
+
+                    // Check force limit (if set); a regulated move targets this force instead of stopping at it
+                    if (m_active_op_force_limit_kg > 0.1f && !m_forceRegulate) {
+                        // Peak of all samples since the last pass, so short spikes are not missed
+                        // Compared in counts so the decision matches the receive-ISR trip exactly;
+                        // a sum of two differently calibrated cells can only be compared in kg
+                        float current_force = m_forceBatchPeakKg;
+                        bool reached = (m_forceChannel == FORCE_CHANNEL_SUM)
+                            ? (m_forceBatchPeakKg >= m_active_op_force_limit_kg)
+                            : (m_forceBatchPeakCounts >= m_active_op_force_limit_counts);
+#if FORCE_TRIP_PREDICT_ENABLED
+                        // The force at standstill if the axes stopped now, from the drained samples' rate
+                        if (!reached && m_tripLeadUs > 0 && m_forceRateKgPerUs > 0.0f &&
+                            m_forceBatchPeakKg >= m_active_op_force_limit_kg * FORCE_TRIP_PREDICT_FRACTION) {
+                            reached = (m_forceBatchPeakKg + m_forceRateKgPerUs * (float)m_tripLeadUs >= m_active_op_force_limit_kg);
+                        }
+#endif
+                        bool isr_tripped = false;
+                        ForceSensor* trip_sensors[2] = { &m_controller->m_forceSensor, &m_controller->m_forceSensorB };
+                        for (int s = 0; s < 2; s++) {
+                            if (trip_sensors[s]->tripFired()) {
+                                // Receive ISR already stopped the motors on this sample
+                                reached = true;
+                                isr_tripped = true;
+                                recordTripLatency(trip_sensors[s]->getTripLatencyUs());
+                                if (trip_sensors[s]->getTripForce() > current_force) {
+                                    current_force = trip_sensors[s]->getTripForce();
+                                }
+                            }
+                        }
+                        if (m_fusionTripped) {
+                            // Control tick already stopped the motors on the fused force
+                            reached = true;
+                            isr_tripped = true;
+                            recordTripLatency(m_fusionTripLatencyUs);
+                            if (m_fusionTripKg > current_force) {
+                                current_force = m_fusionTripKg;
+                            }
+                        }
+                        if (reached) {
+                            if (!isr_tripped) {
+                                // Crossing seen here, not in the receive ISR (fast trip off or summed channels)
+                                HIL_MARK(HIL_SIGNAL_FORCE_CROSS);
+                                recordTripLatency(Microseconds() - m_forceBatchPeakUs);
+                            }
+                            handleLimitReached(STATUS_EVENT_FORCE_LIMIT_REACHED, m_active_op_force_limit_kg, current_force);
                             return;
                         }
                     }
                 } else {
                     // Motor torque mode - check torque limit as primary stopping condition
-                    if (checkTorqueLimit()) {
-                        char limit_desc[STATUS_MESSAGE_BUFFER_SIZE];
-                        snprintf(limit_desc, sizeof(limit_desc), "Torque limit (%.1f%%)", m_torqueLimit);
-                        handleLimitReached(limit_desc, m_torqueLimit);
+                    // (the control tick has usually already stopped the axes)
+                    if (m_tickTorqueTripped || checkTorqueLimit(true)) {
+                        handleLimitReached(STATUS_EVENT_TORQUE_LIMIT_REACHED, m_torqueLimit);
                         return;
                     }
                 }
             }
 
+            // A rapid retract expects no load: force on the way is a collision, not a limit
+            if (m_rapidActive && m_moveState == MOVE_TO_HOME) {
+                const char* errorMsg = nullptr;
+                float force_kg = getSelectedForce();
+                if (checkForceSensorStatus(&errorMsg) || fabsf(force_kg) >= RAPID_FORCE_GATE_KG) {
+                    abortMove();
+                    if (errorMsg) {
+                        char fullMsg[STATUS_MESSAGE_BUFFER_SIZE];
+                        snprintf(fullMsg, sizeof(fullMsg), "Rapid retract stopped: %s", errorMsg);
+                        reportEvent(STATUS_PREFIX_ERROR, fullMsg);
+                    } else {
+                        postEvent(STATUS_EVENT_RAPID_RETRACT_COLLISION, eventArgF(force_kg));
+                    }
+                    // Ended rather than paused, so a resume cannot restart the stroke at rapid speed unsupervised
+                    finalizeAndResetActiveMove(false);
+                    m_state = STATE_STANDBY;
+                    return;
+                }
+            }
+
             // Transition from STARTING/RESUMING to ACTIVE when motor begins moving
             if ((m_moveState == MOVE_STARTING || m_moveState == MOVE_RESUMING) && isMoving()) {
                 m_moveState = MOVE_ACTIVE;
-                m_active_op_segment_initial_axis_steps = m_motorA->PositionRefCommanded();
+                m_active_op_segment_initial_axis_steps = m_motors[0]->PositionRefCommanded();
+                g_cycleTiming.motionStarted(Microseconds());
+            }
+            
+            // Learned approach: drop to press speed just short of the expected contact
+            if (m_approachRapid && m_moveState == MOVE_ACTIVE) {
+                serviceAdaptiveApproach();
+            }
+            
+            // Regulated moves: report settling, end the hold, or stop on a regulator fault
+            if (m_forceRegulate && m_moveState == MOVE_ACTIVE && serviceForceRegulation()) {
+                return;
+            }
+            
+            // Blend into the next queued segment while still at speed
+            if (m_moveState == MOVE_ACTIVE && isMoving()) {
+                tryBlendQueuedSegment();
             }
 
             // Only check for move completion when in ACTIVE or RESUMING state
             // Don't send DONE while still in STARTING state (motor hasn't begun moving yet)
-            if (!isMoving() && m_moveState != MOVE_PAUSED) {
+            // A regulator holding at zero speed is not a completed move
+            if (!isMoving() && m_moveState != MOVE_PAUSED && !(m_regulateArmed && m_moveState == MOVE_ACTIVE)) {
                 bool isStarting = (m_moveState == MOVE_STARTING || m_moveState == MOVE_RESUMING);
                 uint32_t elapsed = Milliseconds() - m_moveStartTime;
                 
@@ -753,13 +1105,14 @@ void MotorController::updateState() {
                     
                     // Record endpoint ONLY for press moves (move_abs/move_inc), NOT for retracts
                     if (m_activeMoveCommand && 
-                        (strcmp(m_activeMoveCommand, "move_abs") == 0 || strcmp(m_activeMoveCommand, "move_inc") == 0)) {
-                        long current_pos_steps = m_motorA->PositionRefCommanded();
-                        m_endpoint_mm = static_cast<float>(static_cast<double>(current_pos_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM);
+                        (strcmp(m_activeMoveCommand, "move_abs") == 0 || strcmp(m_activeMoveCommand, "move_inc") == 0 ||
+                         strcmp(m_activeMoveCommand, "queue_run") == 0 || strcmp(m_activeMoveCommand, "run_recipe") == 0)) {
+                        long current_pos_steps = m_motors[0]->PositionRefCommanded();
+                        m_endpoint_mm = homeRelative(current_pos_steps).value;
                     }
                     
                     // Check if retract action is configured (NOT abort - abort only retracts on force limit)
-                    if (strcmp(m_active_op_force_action, "retract") == 0) {
+                    if (m_active_op_force_action == FORCE_ACTION_RETRACT) {
                         // Move completed to target - start retract
                         // Send INFO instead of DONE - DONE comes after retract completes
                         reportEvent(STATUS_PREFIX_INFO, "Move complete, retracting...");
@@ -771,23 +1124,22 @@ void MotorController::updateState() {
                         long retract_target = (m_retractReferenceSteps == LONG_MIN) ? m_machineHomeReferenceSteps : m_retractReferenceSteps;
                         
                         // CRITICAL: Clear force_action to prevent infinite retract loop
-                        m_active_op_force_action[0] = '\0';
+                        m_active_op_force_action = FORCE_ACTION_NONE;
                         
                         // Start retract move
                         m_moveState = MOVE_TO_HOME;
+                        g_cycleTiming.retract(Microseconds());
                         m_activeMoveCommand = "retract";
                         m_active_op_target_position_steps = retract_target;
-                        long current_pos = m_motorA->PositionRefCommanded();
+                        long current_pos = m_motors[0]->PositionRefCommanded();
                         long steps_to_retract = retract_target - current_pos;
                         m_torqueLimit = DEFAULT_TORQUE_LIMIT;
                         float speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
-                        if (speed_mms > 100.0f) {
-                            speed_mms = 100.0f;
-                        }
-                        int velocity_sps = static_cast<int>(speed_mms * STEPS_PER_MM);
+                        int accel_sps2 = limitTraverse(&speed_mms);
+                        int velocity_sps = toStepsPerSec(MmPerSec(speed_mms)).value;
                         m_active_op_velocity_sps = velocity_sps;
-                        m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
-                        startMove(steps_to_retract, velocity_sps, m_moveDefaultAccelSPS2);
+                        m_active_op_accel_sps2 = accel_sps2;
+                        startMove(steps_to_retract, velocity_sps, accel_sps2);
                         reportEvent(STATUS_PREFIX_START, "retract");
                     } else {
                         // No retract - just complete normally (includes "abort" action when no force limit hit)
@@ -796,29 +1148,35 @@ void MotorController::updateState() {
                         // If we have an original move command, this is completing a retract sequence
                         // Send DONE for the original command, not for "retract"
                         if (m_originalMoveCommand != nullptr) {
-                            reportEvent(STATUS_PREFIX_DONE, m_originalMoveCommand);
+                            reportMoveDone(m_originalMoveCommand);
                             m_originalMoveCommand = nullptr; // Clear it
-                        } else if (m_activeMoveCommand) {
-                            // Normal completion of a single-step command
-                            reportEvent(STATUS_PREFIX_DONE, m_activeMoveCommand);
+                            finalizeAndResetActiveMove(true);
+                            m_state = STATE_STANDBY;
+                        } else if (handoffQueuedSegment(false)) {
+                            // Next queued segment is already moving (or the queue ended on an error)
+                        } else {
+                            if (m_activeMoveCommand) {
+                                // Normal completion of a single-step command
+                                reportMoveDone(m_activeMoveCommand);
+                            }
+                            finalizeAndResetActiveMove(true);
+                            m_state = STATE_STANDBY;
                         }
-                        finalizeAndResetActiveMove(true);
-                        m_state = STATE_STANDBY;
                     }
                 }
             }
 
             if (m_moveState == MOVE_ACTIVE) {
                 // Update distance traveled in mm
-                long current_pos = m_motorA->PositionRefCommanded();
+                long current_pos = m_motors[0]->PositionRefCommanded();
                 long steps_moved_since_start = current_pos - m_active_op_initial_axis_steps;
-                m_active_op_total_distance_mm = (float)std::abs(steps_moved_since_start) / STEPS_PER_MM;
+                m_active_op_total_distance_mm = toMillimeters(Steps(std::abs(steps_moved_since_start))).value;
             }
 
             if (m_moveState == MOVE_PAUSED && !isMoving()) {
                 // Calculate remaining steps based on distance traveled (only once when first entering paused state)
                 if (!m_pausedMessageSent) {
-                    long steps_moved = m_active_op_initial_axis_steps + (long)(m_active_op_total_distance_mm * STEPS_PER_MM) - m_active_op_initial_axis_steps;
+                    long steps_moved = toSteps(Millimeters(m_active_op_total_distance_mm)).value;
                     m_active_op_remaining_steps = m_active_op_total_target_steps - std::abs(steps_moved);
                     if (m_active_op_remaining_steps < 0) m_active_op_remaining_steps = 0;
                     reportEvent(STATUS_PREFIX_INFO, "Move: Operation Paused. Waiting for Resume/Cancel.");
@@ -836,29 +1194,48 @@ void MotorController::updateState() {
 /**
  * @brief Handles a command specifically for the motor system.
  */
-void MotorController::handleCommand(Command cmd, const char* args) {
+void MotorController::handleCommand(Command cmd, const CommandArgs* args) {
     if (!m_isEnabled) {
         reportEvent(STATUS_PREFIX_ERROR, "Motor command ignored: Motors are disabled.");
         return;
     }
 	
-	if (m_motorA->StatusReg().bit.MotorInFault || m_motorB->StatusReg().bit.MotorInFault) {
-        char errorMsg[200];
-        snprintf(errorMsg, sizeof(errorMsg), "Motor command ignored: Motor in fault. M0 Status=0x%04X, M1 Status=0x%04X",
-                 (unsigned int)m_motorA->StatusReg().reg, (unsigned int)m_motorB->StatusReg().reg);
+	if (isInFault()) {
+        char errorMsg[200] = "Motor command ignored: Motor in fault.";
+        appendAxisStatus(errorMsg, sizeof(errorMsg));
         reportEvent(STATUS_PREFIX_ERROR, errorMsg);
+        // A faulted servo may have lost position
+        m_homeTrusted = false;
+#if HOMING_RESTORE_ENABLED
+        m_homeRestored = false;
+#endif
         return;
     }
 	
     if (m_state != STATE_STANDBY &&
-    (cmd == CMD_HOME || cmd == CMD_MOVE_ABS || cmd == CMD_MOVE_INC || cmd == CMD_RETRACT)) {
+    (cmd == CMD_HOME || cmd == CMD_MOVE_ABS || cmd == CMD_MOVE_INC || cmd == CMD_RETRACT ||
+     cmd == CMD_QUEUE_RUN || cmd == CMD_RUN_RECIPE)) {
         reportEvent(STATUS_PREFIX_ERROR, "Motor command ignored: Another operation is in progress.");
         return;
     }
+    
+#if THERMAL_MODEL_ENABLED
+    // Home and retract still run, so the press can always be brought clear
+    if (m_thermalHold &&
+    (cmd == CMD_MOVE_ABS || cmd == CMD_MOVE_INC || cmd == CMD_QUEUE_RUN || cmd == CMD_RUN_RECIPE)) {
+        int axis = 0;
+        float load_pct = getThermalLoadPct(&axis);
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        snprintf(msg, sizeof(msg), "Motor command ignored: Motor thermal limit (M%d at %.0f%%, presses resume below %.0f%%).",
+                 axis, load_pct, THERMAL_RESUME_PCT);
+        reportEvent(STATUS_PREFIX_ERROR, msg);
+        return;
+    }
+#endif
 
     switch(cmd) {
         case CMD_HOME:
-            home();
+            home(args);
             break;
         case CMD_MOVE_ABS:
             moveAbsolute(args);
@@ -872,6 +1249,18 @@ void MotorController::handleCommand(Command cmd, const char* args) {
         case CMD_RETRACT:
             retract(args);
             break;
+        case CMD_QUEUE_MOVE:
+            queueMove(args);
+            break;
+        case CMD_QUEUE_RUN:
+            queueRun();
+            break;
+        case CMD_QUEUE_CLEAR:
+            queueClear();
+            break;
+        case CMD_RUN_RECIPE:
+            runRecipe(args);
+            break;
         default:
             break;
     }
@@ -883,19 +1272,20 @@ void MotorController::handleCommand(Command cmd, const char* args) {
  * The caller should use updateEnableState() to check for completion.
  */
 void MotorController::enable() {
-    // Clear any pending alerts before enabling
-    m_motorA->ClearAlerts();
-    m_motorB->ClearAlerts();
-    
-    m_motorA->EnableRequest(true);
-    m_motorB->EnableRequest(true);
+    // The axes may have been moved by hand while unpowered
+    m_homeTrusted = false;
+    // Re-aligned once the motors report enabled
+    m_encoderArmed = false;
 
-    // Always set motor parameters on enable to ensure a known good state after a fault,
-    // as the ClearCore driver may reset them to zero.
-    m_motorA->VelMax(MOTOR_DEFAULT_VEL_MAX_SPS);
-    m_motorA->AccelMax(MOTOR_DEFAULT_ACCEL_MAX_SPS2);
-    m_motorB->VelMax(MOTOR_DEFAULT_VEL_MAX_SPS);
-    m_motorB->AccelMax(MOTOR_DEFAULT_ACCEL_MAX_SPS2);
+    for (int i = 0; i < m_axisCount; i++) {
+        // Clear any pending alerts before enabling
+        m_motors[i]->ClearAlerts();
+        m_motors[i]->EnableRequest(true);
+        // Always set motor parameters on enable to ensure a known good state after a fault,
+        // as the ClearCore driver may reset them to zero.
+        m_motors[i]->VelMax(m_motorVelMaxSps);
+        m_motors[i]->AccelMax(m_motorAccelMaxSps2);
+    }
     
     // Start non-blocking enable wait state machine
     m_enableState = ENABLE_WAITING;
@@ -911,18 +1301,17 @@ void MotorController::enable() {
  */
 EnableState MotorController::updateEnableState() {
     if (m_enableState == ENABLE_WAITING) {
-        // Check if both motors report as enabled
-        if (m_motorA->StatusReg().bit.Enabled && m_motorB->StatusReg().bit.Enabled) {
+        // Check if all motors report as enabled
+        if (drivesEnabled()) {
             m_enableState = ENABLE_COMPLETE;
+            alignEncoder();
             reportEvent(STATUS_PREFIX_INFO, "Motors enabled.");
         } 
         // Check for timeout (2 seconds)
         else if (Milliseconds() - m_enableStartTime > 2000) {
             m_enableState = ENABLE_TIMEOUT;
-            char warnMsg[128];
-            snprintf(warnMsg, sizeof(warnMsg), "Motor enable timeout. M0=%d, M1=%d",
-                     m_motorA->StatusReg().bit.Enabled ? 1 : 0,
-                     m_motorB->StatusReg().bit.Enabled ? 1 : 0);
+            char warnMsg[200] = "Motor enable timeout.";
+            appendAxisStatus(warnMsg, sizeof(warnMsg));
             reportEvent(STATUS_PREFIX_INFO, warnMsg);
         }
     }
@@ -938,12 +1327,18 @@ bool MotorController::isEnableComplete() const {
 }
 
 /**
- * @brief Disables both motors.
+ * @brief Disables all motors.
  */
 void MotorController::disable() {
-    m_motorA->EnableRequest(false);
-    m_motorB->EnableRequest(false);
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->EnableRequest(false);
+    }
     m_isEnabled = false;
+    m_homeTrusted = false;
+    m_encoderArmed = false;
+#if RACKING_CORRECTION_ENABLED
+    m_rackingArmed = false;
+#endif
     m_enableState = ENABLE_IDLE;  // Reset enable state machine
     reportEvent(STATUS_PREFIX_INFO, "Motors disabled.");
 }
@@ -952,8 +1347,19 @@ void MotorController::disable() {
  * @brief Decelerates any ongoing motion to a stop and resets the state machines.
  */
 void MotorController::abortMove() {
-    m_motorA->MoveStopDecel();
-    m_motorB->MoveStopDecel();
+    TRACE(TRACE_MOVE_ABORT, m_state, 0);
+    // Disarm first so the control tick cannot issue another MoveVelocity() after the stop
+    m_regulateArmed = false;
+    m_tripRetractArmed = false;
+    // A stopped rapid approach must not have its press-speed remainder appended later
+    m_approachRapid = false;
+    m_profileActive = false;
+#if RACKING_CORRECTION_ENABLED
+    m_rackingArmed = false;
+#endif
+    m_homingSpikeAxes = 0;
+    stopAllAxes();
+    HIL_MARK(HIL_SIGNAL_STOP);
     // Don't block here - let motors decelerate naturally
     // The ClearCore library handles deceleration properly
 }
@@ -967,47 +1373,71 @@ void MotorController::reset() {
     m_homingPhase = HOMING_PHASE_IDLE;
     m_moveState = MOVE_STANDBY;
     m_enableState = ENABLE_IDLE;  // Reset enable state machine
+    m_motionQueueHead = 0;
+    m_motionQueueCount = 0;
+    m_motionQueueRunning = false;
     fullyResetActiveMove();
 }
 
 /**
  * @brief Handles the HOME command.
+ * @param args Optional mode: "full" runs the lockstep gantry-squaring sequence, "fast"
+ * runs the parallel sequence. Without a mode HOMING_PARALLEL_DEFAULT picks one. The
+ * parallel sequence only runs a short verification touch while the home is trusted.
+ * "hybrid" runs the parallel sequence, and each axis first covers the way to its learned
+ * trigger point at HOMING_HYBRID_VEL_MMS, with a torque spike check as the backstop.
  */
-void MotorController::home() {
+void MotorController::home(const CommandArgs* args) {
+    bool parallel = HOMING_PARALLEL_DEFAULT;
+    bool hybrid = false;
+    if (!args) {
+        reportEvent(STATUS_PREFIX_ERROR, "Invalid home mode. Use 'full', 'fast' or 'hybrid'.");
+        return;
+    }
+    if (args->count >= 1) {
+        const char* mode = args->home.mode;
+        if (strcmp(mode, "full") == 0) {
+            parallel = false;
+        } else if (strcmp(mode, "fast") == 0) {
+            parallel = true;
+        } else if (strcmp(mode, "hybrid") == 0) {
+            parallel = true;
+            hybrid = true;
+        } else {
+            char errorMsg[80];
+            snprintf(errorMsg, sizeof(errorMsg), "Invalid home mode '%s'. Use 'full', 'fast' or 'hybrid'.", mode);
+            reportEvent(STATUS_PREFIX_ERROR, errorMsg);
+            return;
+        }
+    }
+
     // Check if home sensors are initialized
     if (!m_homeSensorsInitialized) {
         setupHomeSensors();
     }
     
     // Log motor status before homing for diagnostics
-    char statusMsg[200];
-    snprintf(statusMsg, sizeof(statusMsg), 
-        "Home: Motor status before homing: M0(en=%d,fault=%d,status=0x%04X) M1(en=%d,fault=%d,status=0x%04X)",
-        m_motorA->StatusReg().bit.Enabled ? 1 : 0,
-        m_motorA->StatusReg().bit.MotorInFault ? 1 : 0,
-        (unsigned int)m_motorA->StatusReg().reg,
-        m_motorB->StatusReg().bit.Enabled ? 1 : 0,
-        m_motorB->StatusReg().bit.MotorInFault ? 1 : 0,
-        (unsigned int)m_motorB->StatusReg().reg);
+    char statusMsg[200] = "Home: Motor status before homing:";
+    appendAxisStatus(statusMsg, sizeof(statusMsg));
     reportEvent(STATUS_PREFIX_INFO, statusMsg);
     
-    // Verify both motors are enabled before starting homing
-    if (!m_motorA->StatusReg().bit.Enabled || !m_motorB->StatusReg().bit.Enabled) {
-        char errorMsg[128];
-        snprintf(errorMsg, sizeof(errorMsg), 
-            "Homing failed: Motors not enabled. M0=%d, M1=%d",
-            m_motorA->StatusReg().bit.Enabled ? 1 : 0,
-            m_motorB->StatusReg().bit.Enabled ? 1 : 0);
+    // Verify all motors are enabled before starting homing
+    if (!drivesEnabled()) {
+        char errorMsg[200] = "Homing failed: Motors not enabled.";
+        appendAxisStatus(errorMsg, sizeof(errorMsg));
         reportEvent(STATUS_PREFIX_ERROR, errorMsg);
         return;
     }
     
-    m_homingDistanceSteps = (long)(fabs(HOMING_STROKE_MM) * STEPS_PER_MM);
-    m_homingBackoffSteps = (long)(HOMING_BACKOFF_MM * STEPS_PER_MM);
-    m_homingRapidSps = (int)fabs(HOMING_RAPID_VEL_MMS * STEPS_PER_MM);
-    m_homingBackoffSps = (int)fabs(HOMING_BACKOFF_VEL_MMS * STEPS_PER_MM);
-    m_homingTouchSps = (int)fabs(HOMING_TOUCH_VEL_MMS * STEPS_PER_MM);
-    m_homingAccelSps2 = (int)fabs(HOMING_ACCEL_MMSS * STEPS_PER_MM);
+    m_homingDistanceSteps = toSteps(Millimeters(fabsf(HOMING_STROKE_MM))).value;
+    m_homingBackoffSteps = toSteps(Millimeters(HOMING_BACKOFF_MM)).value;
+    m_homingRapidSps = toStepsPerSec(MmPerSec(fabsf(HOMING_RAPID_VEL_MMS))).value;
+    m_homingBackoffSps = toStepsPerSec(MmPerSec(fabsf(HOMING_BACKOFF_VEL_MMS))).value;
+    // A latched edge does not depend on loop latency, so the touch can run faster
+    m_homingTouchSps = toStepsPerSec(MmPerSec(fabsf(m_homeLatchAvailable ? HOMING_LATCHED_TOUCH_VEL_MMS : HOMING_TOUCH_VEL_MMS))).value;
+    m_homingAccelSps2 = toStepsPerSec(MmPerSec(fabsf(HOMING_ACCEL_MMSS))).value;
+    m_homingHybridSps = toStepsPerSec(MmPerSec(fabsf(HOMING_HYBRID_VEL_MMS))).value;
+    m_homingHybridAccelSps2 = toStepsPerSec(MmPerSec(fabsf(HOMING_HYBRID_ACCEL_MMSS))).value;
     
     // Set target position to 0 (home position) for telemetry
     m_active_op_target_position_steps = 0;
@@ -1019,10 +1449,9 @@ void MotorController::home() {
     
     // Report current sensor states before starting
     char sensorMsg[128];
-    snprintf(sensorMsg, sizeof(sensorMsg), "Home sensors before homing: M0(DI7)=%d, M1(DI6)=%d (active=%s)",
-             getHomeSensorState(0) ? 1 : 0, 
-             getHomeSensorState(1) ? 1 : 0,
+    snprintf(sensorMsg, sizeof(sensorMsg), "Home sensors before homing (active=%s):",
              HOME_SENSOR_ACTIVE_STATE ? "HIGH" : "LOW");
+    appendHomeSensorStates(sensorMsg, sizeof(sensorMsg));
     reportEvent(STATUS_PREFIX_INFO, sensorMsg);
 
     if (m_homingDistanceSteps == 0) {
@@ -1031,76 +1460,100 @@ void MotorController::home() {
     }
 
     // Initialize state machine for gantry squaring homing
+    bool verify = parallel && m_homingDone && m_homeTrusted;
+#if HOMING_RESTORE_ENABLED
+    // A home kept across a reset is only worth verifying if the sensors still read as they did
+    if (m_homeRestored) {
+        m_homeRestored = false;
+        if (homeSensorMask() != m_homeRestoredSensors) {
+            m_homeLearned = false;
+            reportEvent(STATUS_PREFIX_INFO, "Home from before the reset discarded: home sensors changed.");
+        } else if (parallel) {
+            verify = true;
+        }
+    }
+#endif
     m_state = STATE_HOMING;
     m_homingState = HOMING;
-    m_homingPhase = RAPID_APPROACH_START;  // Start with rapid approach phase
+    m_homingPhase = parallel ? PARALLEL_HOMING_START : RAPID_APPROACH_START;
     m_homingStartTime = Milliseconds();
     m_homingDone = false;
-    
-    // Initialize gantry squaring tracking variables
-    m_axisAHomeSensorTriggered = false;
-    m_axisBHomeSensorTriggered = false;
-    m_axisAStopped = false;
-    m_axisBStopped = false;
+    m_homeTrusted = false;
+    m_homingHybrid = hybrid;
+#if RACKING_CORRECTION_ENABLED
+    // The axes move one by one from here; the new square is taken with the next move
+    g_controlTick.mask();
+    m_rackingArmed = false;
+    m_rackSquareSet = false;
+    g_controlTick.unmask();
+#endif
+    for (int i = 0; i < m_axisCount; i++) {
+        m_axisHomingPhase[i] = AXIS_HOMING_IDLE;
+        m_axisHomingVerify[i] = verify;
+        // Initialize gantry squaring tracking variables
+        m_axisHomeSensorTriggered[i] = false;
+        m_axisStopped[i] = false;
+    }
     
     // Reset joule tracking for new homing operation
-    m_joules = 0.0;
+    m_energy.resetTotal();
     m_press_startpoint_mm = 0.0f;
-    long current_pos_steps = m_motorA->PositionRefCommanded();
-    m_prev_position_mm = static_cast<double>(current_pos_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM;
-    m_prevForceValid = false;
+    long current_pos_steps = m_motors[0]->PositionRefCommanded();
+    m_energy.begin(current_pos_steps - m_machineHomeReferenceSteps);
+    m_energy.invalidate();
     m_forceLimitTriggered = false;
     m_jouleIntegrationActive = false; // Do not accumulate joules during homing
 
-    reportEvent(STATUS_PREFIX_START, "HOME initiated (gantry squaring mode).");
+    if (verify) {
+        reportEvent(STATUS_PREFIX_START, hybrid ? "HOME initiated (hybrid, verify trusted home)." : "HOME initiated (verify trusted home).");
+    } else if (hybrid) {
+        reportEvent(STATUS_PREFIX_START, m_homeLearned ? "HOME initiated (hybrid mode)." : "HOME initiated (hybrid mode, no learned home: full search).");
+    } else {
+        reportEvent(STATUS_PREFIX_START, parallel ? "HOME initiated (parallel mode)." : "HOME initiated (gantry squaring mode).");
+    }
 }
 
 /**
  * @brief Handles the SET_RETRACT command.
  */
-void MotorController::setRetract(const char* args) {
+void MotorController::setRetract(const CommandArgs* args) {
     if (!m_homingDone) {
         reportEvent(STATUS_PREFIX_ERROR, "Error: Must home before setting retract position.");
         return;
     }
     
-    float position_mm = 0.0f;
-    float speed_mms = m_retractSpeedMms;
-    int parsed = std::sscanf(args, "%f %f", &position_mm, &speed_mms);
-    if (parsed < 1) {
+    if (!args || args->count < 1) {
         reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid position for SET_RETRACT.");
         return;
     }
+    float position_mm = args->set_retract.position;
+    float speed_mms = args->set_retract.speed;
 
-    bool speedProvided = (parsed >= 2);
+    bool speedProvided = (args->count >= 2);
     if (speedProvided) {
         if (speed_mms <= 0.0f) {
             reportEvent(STATUS_PREFIX_ERROR, "Error: Retract speed must be > 0.");
             return;
         }
-        if (speed_mms > 100.0f) {
-            speed_mms = 100.0f;
-            reportEvent(STATUS_PREFIX_INFO, "Retract speed limited to 100 mm/s for safety.");
+        // Up to the rapid ceiling; each retract still falls back to 100 mm/s if it is not a rapid
+        float ceiling_mms = (m_rapidVelMms > MOVE_SPEED_MAX_MMS) ? (float)m_rapidVelMms : MOVE_SPEED_MAX_MMS;
+        if (speed_mms > ceiling_mms) {
+            speed_mms = ceiling_mms;
+            char limit_msg[STATUS_MESSAGE_BUFFER_SIZE];
+            snprintf(limit_msg, sizeof(limit_msg), "Retract speed limited to %.0f mm/s for safety.", ceiling_mms);
+            reportEvent(STATUS_PREFIX_INFO, limit_msg);
         }
         m_retractSpeedMms = speed_mms;
     } else if (m_retractSpeedMms <= 0.0f) {
         m_retractSpeedMms = RETRACT_DEFAULT_SPEED_MMS;
     }
-    // Ensure stored speed obeys ceiling even if default changed
-    if (m_retractSpeedMms > 100.0f) {
-        m_retractSpeedMms = 100.0f;
-    }
     
     // Store the retract position as an offset from home
-    long position_steps = (long)(position_mm * STEPS_PER_MM);
+    long position_steps = toSteps(Millimeters(position_mm)).value;
     m_retractReferenceSteps = m_machineHomeReferenceSteps + position_steps;
     m_retract_position_mm = position_mm;
     
-    // Save to NVM (location 14, byte 56)
-    NvmManager &nvmMgr = NvmManager::Instance();
-    int32_t retractBits;
-    memcpy(&retractBits, &m_retract_position_mm, sizeof(float));
-    nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(14 * 4), retractBits);
+    g_settings.setJournaled(NVM_JOURNAL_KEY_RETRACT, m_retract_position_mm);
     
     char msg[128];
     snprintf(msg, sizeof(msg), "Retract position set to %.2f mm (%ld steps from home) at %.2f mm/s and saved to NVM", position_mm, position_steps, m_retractSpeedMms);
@@ -1116,7 +1569,7 @@ void MotorController::setRetract(const char* args) {
 /**
  * @brief Handles the RETRACT command - move to preset retract position.
  */
-void MotorController::retract(const char* args) {
+void MotorController::retract(const CommandArgs* args) {
     if (!m_homingDone) {
         reportEvent(STATUS_PREFIX_ERROR, "Error: Must home before moving to retract position.");
         return;
@@ -1132,284 +1585,351 @@ void MotorController::retract(const char* args) {
     
     // Parse optional speed parameter
     float speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
-    if (args && args[0] != '\0') {
-        int parsed = std::sscanf(args, "%f", &speed_mms);
-        if (parsed < 1) {
-            reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid speed for RETRACT.");
-            return;
-        }
+    if (!args) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid speed for RETRACT.");
+        return;
     }
-    
-    // Limit speed to 100 mm/s for safety
-    if (speed_mms > 100.0f) {
-        speed_mms = 100.0f;
-        reportEvent(STATUS_PREFIX_INFO, "Speed limited to 100 mm/s for safety.");
+    if (args->count >= 1) {
+        speed_mms = args->retract.speed;
     }
     
     fullyResetActiveMove();
+    // A standalone retract is not a press cycle
+    g_cycleTiming.cancel();
+    
+    // Limit speed to 100 mm/s for safety, or the rapid ceiling if this retract may run as a rapid
+    float requested_mms = speed_mms;
+    int accel_sps2 = limitTraverse(&speed_mms);
+    if (speed_mms < requested_mms) {
+        char limit_msg[STATUS_MESSAGE_BUFFER_SIZE];
+        snprintf(limit_msg, sizeof(limit_msg), "Speed limited to %.0f mm/s for safety.", speed_mms);
+        reportEvent(STATUS_PREFIX_INFO, limit_msg);
+    }
+    
     m_state = STATE_MOVING;
     m_moveState = MOVE_TO_HOME;
     m_activeMoveCommand = "retract";
     
     m_active_op_target_position_steps = m_retractReferenceSteps;  // Store for telemetry
-    long current_pos = m_motorA->PositionRefCommanded();
+    long current_pos = m_motors[0]->PositionRefCommanded();
     long steps_to_retract = m_retractReferenceSteps - current_pos;
     
-    int velocity_sps = (int)(speed_mms * STEPS_PER_MM);
+    int velocity_sps = toStepsPerSec(MmPerSec(speed_mms)).value;
     m_torqueLimit = DEFAULT_TORQUE_LIMIT;  // Use default motor torque limit (80%)
     
     // Store move parameters for pause/resume
     m_active_op_initial_axis_steps = current_pos;
     m_active_op_total_target_steps = std::abs(steps_to_retract);
     m_active_op_velocity_sps = velocity_sps;
-    m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
+    m_active_op_accel_sps2 = accel_sps2;
     m_active_op_torque_percent = (int)m_torqueLimit;
     m_moveStartTime = Milliseconds();  // Set start time for timeout tracking
     
-    startMove(steps_to_retract, velocity_sps, m_moveDefaultAccelSPS2);
+    startMove(steps_to_retract, velocity_sps, accel_sps2);
     
     char msg[128];
     snprintf(msg, sizeof(msg), "retract to %.3f mm at %.2f mm/s initiated", 
-             (float)(m_retractReferenceSteps - m_machineHomeReferenceSteps) / STEPS_PER_MM, speed_mms);
+             homeRelative(m_retractReferenceSteps).value, speed_mms);
     reportEvent(STATUS_PREFIX_START, msg);
 }
 
+#if MOVE_CACHE_SIZE > 0
+/** @brief FNV-1a hash of a MOVE_ABS argument set (never 0, which marks an empty cache slot). */
+static uint32_t moveCacheKey(const CommandArgs& args) {
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ args.count) * 16777619u;
+    // The decoders zero the whole struct first, so the unused string bytes always match
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&args.move_abs);
+    for (size_t i = 0; i < sizeof(MoveAbsArgs); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return (hash != 0) ? hash : 1u;
+}
+#endif
+
 /**
  * @brief Handles the MOVE_ABS command - move to absolute position.
  */
-void MotorController::moveAbsolute(const char* args) {
+void MotorController::moveAbsolute(const CommandArgs* args) {
     if (!m_homingDone) {
         reportEvent(STATUS_PREFIX_ERROR, "Error: Must home before absolute moves.");
         return;
     }
     
-    float position_mm = 0.0f;
-    float speed_mms = MOVE_DEFAULT_VELOCITY_MMS;
-    float force_kg = 0.0f;
-    char force_action[32] = "hold";  // Default action
-    
-    // Parse: position, speed, force, [force_action]
-    int parsed = std::sscanf(args, "%f %f %f %31s", &position_mm, &speed_mms, &force_kg, force_action);
-    if (parsed < 1) {
+    // position, speed, force, [force_action], [dwell_ms for "regulate"]
+    if (!args || args->count < 1 || args->move_abs.dwell < 0) {
         reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid parameters for MOVE_ABS. Need at least position.");
         return;
     }
     
-    // Limit speed to 100 mm/s for safety
-    if (speed_mms > 100.0f) {
-        speed_mms = 100.0f;
-        reportEvent(STATUS_PREFIX_INFO, "Speed limited to 100 mm/s for safety.");
-    }
-    
-    // Only check force sensor if we're in "load_cell" mode
-    if (strcmp(m_force_mode, "load_cell") == 0) {
-        const char* errorMsg = nullptr;
-        if (checkForceSensorStatus(&errorMsg)) {
-            char fullMsg[STATUS_MESSAGE_BUFFER_SIZE];
-            snprintf(fullMsg, sizeof(fullMsg), "Move aborted: %s", errorMsg);
-            reportEvent(STATUS_PREFIX_ERROR, fullMsg);
-            return;
-        }
-        
-        // Check if current force already exceeds target (for "hold" action)
-        float current_force = m_controller->m_forceSensor.getForce();
-        if (strcmp(force_action, "hold") == 0 && current_force >= force_kg) {
-            char msg[STATUS_MESSAGE_BUFFER_SIZE];
-            snprintf(msg, sizeof(msg), "Force limit (%.2f kg) already reached. Current force: %.2f kg", 
-                     force_kg, current_force);
-            reportEvent(STATUS_PREFIX_ERROR, msg);  // ERROR message will auto-hold script
+    CompiledSegment move;
+    bool speed_limited = false;
+#if MOVE_CACHE_SIZE > 0
+    // A production script repeats the same few argument sets: reuse their compiled moves
+    uint32_t key = moveCacheKey(*args);
+    if (!findCachedMove(*args, key, &move)) {
+        if (!compileMoveAbs(*args, &move, &speed_limited)) {
             return;
         }
+        cacheMove(*args, key, move, speed_limited);
     }
+#else
+    if (!compileMoveAbs(*args, &move, &speed_limited)) {
+        return;
+    }
+#endif
     
-    long target_steps = m_machineHomeReferenceSteps + (long)(position_mm * STEPS_PER_MM);
-    long current_pos = m_motorA->PositionRefCommanded();
-    long steps_to_move = target_steps - current_pos;
-    
-    // Check if we're already at the target position
-    if (steps_to_move == 0) {
+    MoveStartResult result = startCompiledMove(move, "move_abs", false, false);
+    if (result == MOVE_START_NOOP) {
         reportEvent(STATUS_PREFIX_INFO, "Already at target position. Move complete.");
         reportEvent(STATUS_PREFIX_DONE, "move_abs");
-        return;
+    } else if (result == MOVE_START_OK) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "move_abs to %.2f mm initiated (mode: %s)", args->move_abs.position, getForceMode());
+        reportEvent(STATUS_PREFIX_START, msg);
     }
-    
-    int velocity_sps = (int)(speed_mms * STEPS_PER_MM);
-    
-    // Set torque limit based on mode
-    if (force_kg > 0.0f) {
-        // Validate kg range based on mode
-        if (strcmp(m_force_mode, "motor_torque") == 0) {
-            // Motor torque mode: 50-2000 kg range
+}
+
+/**
+ * @brief Validates MOVE_ABS arguments and compiles them like a queued segment.
+ * @details Applies the defaults of the optional arguments and looks up the force action, then
+ * compileSegment() checks the move against the force mode. Failures are reported as ERROR.
+ * A "regulate" move approaches at the given speed, holds the force for the dwell and never goes
+ * past the position; a "seat" move ends like "skip" as soon as the stiffness jumps, or at the
+ * force limit at the latest.
+ * @param args Decoded MOVE_ABS arguments (count >= 1)
+ * @param out Receives the compiled move
+ * @param speed_limited Set if the speed was capped at MOVE_SPEED_MAX_MMS
+ * @return false if the arguments are invalid or the move cannot run in the current force mode
+ */
+bool MotorController::compileMoveAbs(const CommandArgs& args, CompiledSegment* out, bool* speed_limited) {
+    const MoveAbsArgs& a = args.move_abs;
+    MotionSegment segment;
+    segment.type = SEGMENT_MOVE;
+    segment.position_mm = a.position;
+    segment.speed_mms = (args.count >= 2) ? a.speed : MOVE_DEFAULT_VELOCITY_MMS;
+    segment.force_kg = a.force;
+    segment.dwell_ms = (args.count >= 5) ? (uint32_t)a.dwell : FORCE_REGULATE_DWELL_MS_DEFAULT;
+    const char* force_action_name = (args.count >= 4) ? a.force_action : "hold";
+    if (!parseForceAction(force_action_name, &segment.force_action)) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Unknown force_action. Use hold, skip, retract, abort, regulate or seat.");
+        return false;
+    }
+    if (!compileSegment(segment, out)) {
+        return false;
+    }
+    *speed_limited = (out->speed_mms < segment.speed_mms);
+    return true;
+}
+
+#if MOVE_CACHE_SIZE > 0
+/**
+ * @brief Looks up a MOVE_ABS argument set compiled earlier.
+ * @details An entry is only used while the force mode, the home reference and the drive
+ * geometry it was compiled with are unchanged; anything else compileSegment() reads is a
+ * compile-time constant. The moment-to-moment checks stay in startCompiledMove().
+ * @param args Decoded MOVE_ABS arguments
+ * @param key moveCacheKey() of @p args
+ * @param out Receives the compiled move on a hit
+ * @return true on a hit
+ */
+bool MotorController::findCachedMove(const CommandArgs& args, uint32_t key, CompiledSegment* out) {
+    for (int i = 0; i < MOVE_CACHE_SIZE; i++) {
+        const MoveCacheEntry& entry = m_moveCache[i];
+        if (entry.key != key || entry.count != args.count ||
+            memcmp(&entry.args, &args.move_abs, sizeof(MoveAbsArgs)) != 0) {
+            continue;
+        }
+        if (entry.force_mode != m_force_mode || entry.home_reference_steps != m_machineHomeReferenceSteps ||
+            entry.steps_per_mm != g_driveGeometry.stepsPerMm()) {
+            // Stale: recompile into the same slot
+            return false;
+        }
+        if (entry.speed_limited) {
+            reportEvent(STATUS_PREFIX_INFO, "Speed limited to 100 mm/s for safety.");
+        }
+        *out = entry.move;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Keeps a compiled MOVE_ABS argument set for findCachedMove().
+ * @details A stale entry for the same arguments is overwritten in place; a new argument
+ * set replaces the slots round robin.
+ */
+void MotorController::cacheMove(const CommandArgs& args, uint32_t key, const CompiledSegment& move, bool speed_limited) {
+    int slot = -1;
+    for (int i = 0; i < MOVE_CACHE_SIZE; i++) {
+        if (m_moveCache[i].key == key && m_moveCache[i].count == args.count &&
+            memcmp(&m_moveCache[i].args, &args.move_abs, sizeof(MoveAbsArgs)) == 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        slot = m_moveCacheNext;
+        m_moveCacheNext = (uint8_t)((m_moveCacheNext + 1) % MOVE_CACHE_SIZE);
+    }
+    MoveCacheEntry& entry = m_moveCache[slot];
+    entry.key = key;
+    entry.count = args.count;
+    entry.args = args.move_abs;
+    entry.force_mode = m_force_mode;
+    entry.home_reference_steps = m_machineHomeReferenceSteps;
+    entry.steps_per_mm = g_driveGeometry.stepsPerMm();
+    entry.speed_limited = speed_limited;
+    entry.move = move;
+}
+#endif
+
+/**
+ * @brief Checks a segment against the force mode and converts it to step space.
+ * @details Everything about a segment that does not depend on the press's state when it
+ * starts: the mode checks of its action, the force range of the mode and the speed cap.
+ * Failures are reported as ERROR.
+ * @param segment Move, dwell or retract segment
+ * @param out Receives the compiled segment
+ * @return false if the segment cannot run in the current force mode
+ */
+bool MotorController::compileSegment(const MotionSegment& segment, CompiledSegment* out) {
+    out->type = segment.type;
+    out->dwell_ms = segment.dwell_ms;
+    out->force_action = segment.force_action;
+    out->force_kg = segment.force_kg;
+    out->speed_mms = segment.speed_mms;
+    out->target_steps = LONG_MIN;
+    out->velocity_sps = 0;
+    if (segment.type == SEGMENT_DWELL) {
+        return true;
+    }
+    if (segment.type == SEGMENT_RETRACT) {
+        // The retract position and speed are taken when the segment starts
+        out->force_action = FORCE_ACTION_HOLD;
+        out->force_kg = 0.0f;
+        if (segment.speed_mms > 0.0f) {
+            out->speed_mms = (segment.speed_mms > MOVE_SPEED_MAX_MMS) ? MOVE_SPEED_MAX_MMS : segment.speed_mms;
+            out->velocity_sps = toStepsPerSec(MmPerSec(out->speed_mms)).value;
+        }
+        return true;
+    }
+
+    float force_kg = segment.force_kg;
+    bool regulate = (segment.force_action == FORCE_ACTION_REGULATE);
+    if (segment.force_action == FORCE_ACTION_SEAT && m_force_mode != FORCE_MODE_LOAD_CELL) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: seat requires load_cell mode.");
+        return false;
+    }
+    if (regulate) {
+        if (m_force_mode != FORCE_MODE_LOAD_CELL) {
+            reportEvent(STATUS_PREFIX_ERROR, "Error: regulate requires load_cell mode.");
+            return false;
+        }
+        if (force_kg <= 0.0f) {
+            reportEvent(STATUS_PREFIX_ERROR, "Error: regulate requires a target force.");
+            return false;
+        }
+    }
+    if (force_kg > 0.0f) {
+        // Validate kg range based on mode
+        if (m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+            // Motor torque mode: 50-2000 kg range
             if (force_kg < 50.0f) {
                 reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be >= 50 kg in motor_torque mode.");
-                return;
+                return false;
             }
             if (force_kg > 2000.0f) {
                 reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be <= 2000 kg in motor_torque mode.");
-                return;
+                return false;
             }
-            // Calculate torque limit using calibrated equation: Torque% = scale * kg + offset
-            m_torqueLimit = m_motor_torque_scale * force_kg + m_motor_torque_offset;
-            char torque_msg[128];
-            snprintf(torque_msg, sizeof(torque_msg), "Torque limit set: %.1f%% (from %.0f kg) in %s mode", 
-                     m_torqueLimit, force_kg, m_force_mode);
-            reportEvent(STATUS_PREFIX_INFO, torque_msg);
         } else {
             // Load cell mode: just validate range and leave torque limit at default ceiling
             if (force_kg < 0.2f) {
                 reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be >= 0.2 kg in load_cell mode.");
-                return;
+                return false;
             }
             if (force_kg > 1000.0f) {
                 reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be <= 1000 kg in load_cell mode.");
-                return;
+                return false;
             }
-            m_torqueLimit = DEFAULT_TORQUE_LIMIT;
         }
-    } else {
-        // No kg parameter specified: use default torque limit
-        m_torqueLimit = DEFAULT_TORQUE_LIMIT;
     }
-    
-    // All validations passed - now update state
-    fullyResetActiveMove();
-    m_state = STATE_MOVING;
-    m_moveState = MOVE_STARTING;
-    m_activeMoveCommand = "move_abs";
-    m_active_op_target_position_steps = target_steps;  // Store for telemetry
-    
-    // Store move parameters for pause/resume
-    m_active_op_initial_axis_steps = current_pos;
-    m_active_op_total_target_steps = std::abs(steps_to_move);
-    m_active_op_velocity_sps = velocity_sps;
-    m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
-    m_active_op_torque_percent = (int)m_torqueLimit;
-    m_moveStartTime = Milliseconds();  // Set start time for timeout tracking
-    
-    // Store force limit, action, and mode for use during move
-    m_active_op_force_limit_kg = force_kg;
-    strncpy(m_active_op_force_action, force_action, sizeof(m_active_op_force_action) - 1);
-    m_active_op_force_action[sizeof(m_active_op_force_action) - 1] = '\0';
-    strncpy(m_active_op_force_mode, m_force_mode, sizeof(m_active_op_force_mode) - 1);
-    m_active_op_force_mode[sizeof(m_active_op_force_mode) - 1] = '\0';
-    
-    // Reset joule tracking for new move
-    m_joules = 0.0;
-    m_press_startpoint_mm = 0.0f;
-    long current_pos_steps = m_motorA->PositionRefCommanded();
-    m_prev_position_mm = static_cast<double>(current_pos_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM;
-    m_machineStrainBaselinePosMm = m_prev_position_mm;
-    m_prevMachineDeflectionMm = 0.0;
-    m_prevTotalDeflectionMm = 0.0;
-    m_machineEnergyJ = 0.0;
-    m_machineStrainContactActive = false;
-    m_forceLimitTriggered = false;
-    if (strcmp(m_active_op_force_mode, "motor_torque") == 0) {
-        m_jouleIntegrationActive = false;
-    } else {
-        m_jouleIntegrationActive = true;
+
+    // Limit speed to 100 mm/s for safety
+    if (out->speed_mms > MOVE_SPEED_MAX_MMS) {
+        out->speed_mms = MOVE_SPEED_MAX_MMS;
+        reportEvent(STATUS_PREFIX_INFO, "Speed limited to 100 mm/s for safety.");
     }
-    
-    startMove(steps_to_move, velocity_sps, m_moveDefaultAccelSPS2);
-    
-    char msg[128];
-    snprintf(msg, sizeof(msg), "move_abs to %.2f mm initiated (mode: %s)", position_mm, m_force_mode);
-    reportEvent(STATUS_PREFIX_START, msg);
+    out->target_steps = absoluteSteps(Millimeters(segment.position_mm));
+    out->velocity_sps = toStepsPerSec(MmPerSec(out->speed_mms)).value;
+    return true;
 }
 
 /**
- * @brief Handles the MOVE_INC command - move by incremental distance.
+ * @brief Starts a compiled move segment.
+ * @details Only checks what depends on the moment the move starts (the load cell's health,
+ * a force already past a "hold" limit, the distance left); the rest was checked by
+ * compileSegment(). Failures are reported as ERROR; the caller reports START or DONE.
+ * @param move Compiled SEGMENT_MOVE
+ * @param command_name Reported in DONE/ERROR when the move ends (string literal)
+ * @param continuing true for a queued segment after the first: keeps joules and startpoint
+ * @param blend true to append to the move still in progress (StepGenerator keeps its velocity)
+ * @return MOVE_START_OK if moving, MOVE_START_NOOP if already at target, MOVE_START_FAILED on error
  */
-void MotorController::moveIncremental(const char* args) {
-    if (!m_homingDone) {
-        reportEvent(STATUS_PREFIX_ERROR, "Error: Must home before incremental moves.");
-        return;
-    }
-    
-    float distance_mm = 0.0f;
-    float speed_mms = MOVE_DEFAULT_VELOCITY_MMS;
-    float force_kg = 0.0f;
-    char force_action[32] = "hold";  // Default action
-    
-    // Parse: distance, speed, force, [force_action]
-    int parsed = std::sscanf(args, "%f %f %f %31s", &distance_mm, &speed_mms, &force_kg, force_action);
-    if (parsed < 1) {
-        reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid parameters for MOVE_INC. Need at least distance.");
-        return;
-    }
-    
-    // Limit speed to 100 mm/s for safety
-    if (speed_mms > 100.0f) {
-        speed_mms = 100.0f;
-        reportEvent(STATUS_PREFIX_INFO, "Speed limited to 100 mm/s for safety.");
-    }
+MotorController::MoveStartResult MotorController::startCompiledMove(const CompiledSegment& move, const char* command_name,
+                                                                    bool continuing, bool blend) {
+    float force_kg = move.force_kg;
+    ForceAction force_action = move.force_action;
+    bool regulate = (force_action == FORCE_ACTION_REGULATE);
     
     // Only check force sensor if we're in "load_cell" mode
-    if (strcmp(m_force_mode, "load_cell") == 0) {
+    if (m_force_mode == FORCE_MODE_LOAD_CELL) {
         const char* errorMsg = nullptr;
         if (checkForceSensorStatus(&errorMsg)) {
             char fullMsg[STATUS_MESSAGE_BUFFER_SIZE];
             snprintf(fullMsg, sizeof(fullMsg), "Move aborted: %s", errorMsg);
             reportEvent(STATUS_PREFIX_ERROR, fullMsg);
-            return;
+            return MOVE_START_FAILED;
         }
         
         // Check if current force already exceeds target (for "hold" action)
-        float current_force = m_controller->m_forceSensor.getForce();
-        if (strcmp(force_action, "hold") == 0 && current_force >= force_kg) {
+        float current_force = getSelectedForce();
+        if (force_action == FORCE_ACTION_HOLD && force_kg > 0.0f && current_force >= force_kg) {
             char msg[STATUS_MESSAGE_BUFFER_SIZE];
             snprintf(msg, sizeof(msg), "Force limit (%.2f kg) already reached. Current force: %.2f kg", 
                      force_kg, current_force);
             reportEvent(STATUS_PREFIX_ERROR, msg);  // ERROR message will auto-hold script
-            return;
+            return MOVE_START_FAILED;
         }
     }
     
-    long steps_to_move = (long)(distance_mm * STEPS_PER_MM);
+    long target_steps = move.target_steps;
+    long current_pos = m_motors[0]->PositionRefCommanded();
+    // A blended segment extends the move still in progress, so it is measured from that move's end
+    long move_origin = blend ? m_active_op_target_position_steps : current_pos;
+    long steps_to_move = target_steps - move_origin;
     
-    // Check if the move distance is zero
+    // Check if we're already at the target position
     if (steps_to_move == 0) {
-        reportEvent(STATUS_PREFIX_INFO, "Move distance is zero. Move complete.");
-        reportEvent(STATUS_PREFIX_DONE, "move_inc");
-        return;
+        return MOVE_START_NOOP;
     }
     
-    long current_pos = m_motorA->PositionRefCommanded();
-    int velocity_sps = (int)(speed_mms * STEPS_PER_MM);
+    int velocity_sps = move.velocity_sps;
     
-    // Set torque limit based on mode
-    if (force_kg > 0.0f) {
-        // Validate kg range based on mode
-        if (strcmp(m_force_mode, "motor_torque") == 0) {
-            // Motor torque mode: 50-2000 kg range
-            if (force_kg < 50.0f) {
-                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be >= 50 kg in motor_torque mode.");
-                return;
-            }
-            if (force_kg > 2000.0f) {
-                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be <= 2000 kg in motor_torque mode.");
-                return;
-            }
-            // Calculate torque limit using calibrated equation: Torque% = scale * kg + offset
-            m_torqueLimit = m_motor_torque_scale * force_kg + m_motor_torque_offset;
+    // Set torque limit based on mode (the force range was checked by compileSegment())
+    if (force_kg > 0.0f && m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+        // Calculate torque limit using calibrated equation: Torque% = scale * kg + offset
+        m_torqueLimit = m_motor_torque_scale * force_kg + m_motor_torque_offset;
+        // Once per move or queue run, so segment handoff does no formatting
+        if (!continuing) {
             char torque_msg[128];
             snprintf(torque_msg, sizeof(torque_msg), "Torque limit set: %.1f%% (from %.0f kg) in %s mode", 
-                     m_torqueLimit, force_kg, m_force_mode);
+                     m_torqueLimit, force_kg, getForceMode());
             reportEvent(STATUS_PREFIX_INFO, torque_msg);
-        } else {
-            // Load cell mode: 0.2-1000 kg range
-            if (force_kg < 0.2f) {
-                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be >= 0.2 kg in load_cell mode.");
-                return;
-            }
-            if (force_kg > 1000.0f) {
-                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be <= 1000 kg in load_cell mode.");
-                return;
-            }
-            m_torqueLimit = DEFAULT_TORQUE_LIMIT;
         }
     } else {
-        // No kg parameter specified: use default torque limit
+        // Load cell mode or no kg parameter specified: use default torque limit
         m_torqueLimit = DEFAULT_TORQUE_LIMIT;
     }
     
@@ -1417,11 +1937,11 @@ void MotorController::moveIncremental(const char* args) {
     fullyResetActiveMove();
     m_state = STATE_MOVING;
     m_moveState = MOVE_STARTING;
-    m_activeMoveCommand = "move_inc";
-    m_active_op_target_position_steps = current_pos + steps_to_move;  // Store for telemetry
+    m_activeMoveCommand = command_name;
+    m_active_op_target_position_steps = target_steps;  // Store for telemetry
     
     // Store move parameters for pause/resume
-    m_active_op_initial_axis_steps = current_pos;
+    m_active_op_initial_axis_steps = move_origin;
     m_active_op_total_target_steps = std::abs(steps_to_move);
     m_active_op_velocity_sps = velocity_sps;
     m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
@@ -1430,488 +1950,2795 @@ void MotorController::moveIncremental(const char* args) {
     
     // Store force limit, action, and mode for use during move
     m_active_op_force_limit_kg = force_kg;
-    strncpy(m_active_op_force_action, force_action, sizeof(m_active_op_force_action) - 1);
-    m_active_op_force_action[sizeof(m_active_op_force_action) - 1] = '\0';
-    strncpy(m_active_op_force_mode, m_force_mode, sizeof(m_active_op_force_mode) - 1);
-    m_active_op_force_mode[sizeof(m_active_op_force_mode) - 1] = '\0';
+    m_active_op_force_limit_counts = primaryForceSensor().kgToCounts(force_kg);
+    m_active_op_force_action = force_action;
+    m_active_op_force_mode = m_force_mode;
+    m_forceRegulate = regulate;
+    m_regulateDir = (steps_to_move > 0) ? 1 : -1;
+    m_regulateLimitSteps = target_steps;
+    m_regulateMaxMms = move.speed_mms;
+    m_regulateDwellMs = move.dwell_ms;
     
-    // Reset joule tracking for new move
-    m_joules = 0.0;
-    m_press_startpoint_mm = 0.0f;
-    long current_pos_steps = m_motorA->PositionRefCommanded();
-    m_prev_position_mm = static_cast<double>(current_pos_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM;
-    m_machineStrainBaselinePosMm = m_prev_position_mm;
-    m_prevMachineDeflectionMm = 0.0;
-    m_prevTotalDeflectionMm = 0.0;
-    m_machineEnergyJ = 0.0;
-    m_machineStrainContactActive = false;
+    // Reset joule tracking for new move (a queued segment keeps the cycle's energy and startpoint)
+    if (!continuing) {
+        m_energy.resetTotal();
+        m_press_startpoint_mm = 0.0f;
+        beginCapture();
+        g_pressMetrics.begin(m_press_threshold_kg);
+        g_cycleTiming.begin(Microseconds());
+        beginMoveStats();
+    }
+    long current_pos_steps = m_motors[0]->PositionRefCommanded();
+    m_energy.begin(current_pos_steps - m_machineHomeReferenceSteps);
     m_forceLimitTriggered = false;
-    if (strcmp(m_active_op_force_mode, "motor_torque") == 0) {
-        m_jouleIntegrationActive = false;
+    // motor_torque energy comes from the control tick's torque-derived force
+    m_jouleIntegrationActive = (m_active_op_force_mode == FORCE_MODE_LOAD_CELL) || TORQUE_JOULES_ENABLED;
+    // Recipe press moves (retract steps have no force limit) are held to the recipe's envelope
+    bool recipe = (command_name == kRunRecipeCommand);
+    m_envelopeArmed = (m_active_op_force_mode == FORCE_MODE_LOAD_CELL) && force_kg > 0.0f &&
+                      recipe && g_recipeStore.hasEnvelope();
+    
+    // Recipe moves can learn their contact point and approach it at rapid speed
+    long first_steps = steps_to_move;
+    int first_sps = velocity_sps;
+    if (recipe && m_motionQueueSegment > 0 && !blend) {
+        planAdaptiveApproach((uint8_t)(m_motionQueueSegment - 1), force_kg, regulate, target_steps, move_origin,
+                             &first_steps, &first_sps);
+    }
+    
+    if (m_motionJerkMmss3 > 0.0f && !blend && !regulate && !m_approachRapid) {
+        startProfiledMove(first_steps, first_sps, m_moveDefaultAccelSPS2);
     } else {
-        m_jouleIntegrationActive = true;
+        startMove(first_steps, first_sps, m_moveDefaultAccelSPS2);
+    }
+    armForceTrip();
+    armZones(false);
+    return MOVE_START_OK;
+}
+
+/**
+ * @brief Handles the QUEUE_MOVE command - appends a segment to the motion queue.
+ * @details Segments can be appended while the queue is running. Range checks happen when
+ * the queue starts, or when the segment is appended to a running queue, against the force
+ * mode in effect at that time.
+ */
+void MotorController::queueMove(const CommandArgs* args) {
+    // position, speed, force, [force_action], [dwell_ms for "regulate"]
+    if (!args || args->count < 1 || args->queue_move.dwell < 0) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid parameters for QUEUE_MOVE. Need at least position.");
+        return;
+    }
+    const QueueMoveArgs& a = args->queue_move;
+    float position_mm = a.position;
+    float speed_mms = (args->count >= 2) ? a.speed : MOVE_DEFAULT_VELOCITY_MMS;
+    float force_kg = a.force;
+    const char* force_action_name = (args->count >= 4) ? a.force_action : "hold";
+    uint32_t dwell_ms = (args->count >= 5) ? (uint32_t)a.dwell : FORCE_REGULATE_DWELL_MS_DEFAULT;
+    ForceAction force_action;
+    if (!parseForceAction(force_action_name, &force_action)) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Unknown force_action. Use hold, skip, retract, abort, regulate or seat.");
+        return;
     }
     
-    startMove(steps_to_move, velocity_sps, m_moveDefaultAccelSPS2);
+    if (m_motionQueueCount >= MOTION_QUEUE_SIZE) {
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        snprintf(msg, sizeof(msg), "Error: Motion queue full (%d segments).", MOTION_QUEUE_SIZE);
+        reportEvent(STATUS_PREFIX_ERROR, msg);
+        return;
+    }
     
-    char msg[128];
-    snprintf(msg, sizeof(msg), "move_inc by %.2f mm initiated (mode: %s)", distance_mm, m_force_mode);
-    reportEvent(STATUS_PREFIX_START, msg);
+    uint8_t index = (uint8_t)((m_motionQueueHead + m_motionQueueCount) % MOTION_QUEUE_SIZE);
+    MotionSegment& segment = m_motionQueue[index];
+    segment.type = SEGMENT_MOVE;
+    segment.dwell_ms = dwell_ms;
+    segment.position_mm = position_mm;
+    segment.speed_mms = speed_mms;
+    segment.force_kg = force_kg;
+    segment.force_action = force_action;
+    // A running queue was compiled when it started; a segment joining it is compiled now
+    if (m_motionQueueRunning && !compileSegment(segment, &m_motionQueueCompiled[index])) {
+        return;
+    }
+    m_motionQueueCount++;
+    
+    char msg[STATUS_MESSAGE_BUFFER_SIZE];
+    snprintf(msg, sizeof(msg), "Segment queued: %.2f mm at %.2f mm/s, %.2f kg %s (%d pending)",
+             position_mm, speed_mms, force_kg, forceActionName(segment.force_action), m_motionQueueCount);
+    reportEvent(STATUS_PREFIX_INFO, msg);
+    reportEvent(STATUS_PREFIX_DONE, "queue_move");
 }
 
 /**
- * @brief Handles pause request from GUI (script hold event).
- * Works for any active move - homing or feeding.
+ * @brief Handles the QUEUE_RUN command - runs the queued segments back to back.
  */
-void MotorController::pauseOperation() {
-    if (m_state == STATE_HOMING) {
-        // Pause homing - stop motors and save current phase
-        abortMove();
-        reportEvent(STATUS_PREFIX_INFO, "Homing paused. Send resume to continue.");
-        reportEvent(STATUS_PREFIX_DONE, "pause");
-    } else if (m_state == STATE_MOVING) {
-        if (m_moveState == MOVE_ACTIVE || m_moveState == MOVE_STARTING || 
-            m_moveState == MOVE_TO_HOME || m_moveState == MOVE_TO_RETRACT) {
-            abortMove();
-            m_moveState = MOVE_PAUSED;
-            reportEvent(STATUS_PREFIX_INFO, "Move paused. Send resume to continue.");
-            reportEvent(STATUS_PREFIX_DONE, "pause");
-        } else {
-            reportEvent(STATUS_PREFIX_INFO, "No active move to pause.");
-            reportEvent(STATUS_PREFIX_DONE, "pause");
-        }
-    } else {
-        reportEvent(STATUS_PREFIX_INFO, "No active operation to pause.");
-        reportEvent(STATUS_PREFIX_DONE, "pause");
-    }
+void MotorController::queueRun() {
+    startMotionQueue("queue_run");
 }
 
 /**
- * @brief Handles resume request from GUI (script run event).
- * Resumes paused homing or feeding operations.
+ * @brief Handles the RUN_RECIPE command - runs the stored recipe through the motion queue.
+ * @details The recipe's steps replace anything pending in the queue.
  */
-void MotorController::resumeOperation() {
-    if (m_state == STATE_HOMING) {
-        // Resume homing from current phase
-        reportEvent(STATUS_PREFIX_INFO, "Homing resumed.");
-        reportEvent(STATUS_PREFIX_DONE, "resume");
-        // The homing state machine will automatically continue from its current phase
-        // No need to restart - it will pick up in the next updateState() call
-    } else if (m_state == STATE_MOVING) {
-        if (m_moveState == MOVE_PAUSED) {
-            // Calculate remaining steps NOW (at resume time) based on current position
-            long current_pos = m_motorA->PositionRefCommanded();
-            long steps_moved_so_far = current_pos - m_active_op_initial_axis_steps;
-            long remaining_steps = m_active_op_total_target_steps - std::abs(steps_moved_so_far);
-            
-            // Resume paused moves
-            if (remaining_steps > 0) {
-                m_active_op_remaining_steps = remaining_steps;
-                m_active_op_segment_initial_axis_steps = current_pos;
-                m_moveState = MOVE_RESUMING;
-                m_torqueLimit = (float)m_active_op_torque_percent;
-                m_moveStartTime = Milliseconds();  // Reset start time for timeout tracking
-                if (!m_forceLimitTriggered && strcmp(m_active_op_force_mode, "load_cell") == 0) {
-                    m_jouleIntegrationActive = true;
-                } else {
-                    m_jouleIntegrationActive = false;
-                }
-                m_prevForceValid = false;
-                m_prev_position_mm = static_cast<double>(current_pos - m_machineHomeReferenceSteps) / STEPS_PER_MM;
-                m_machineStrainBaselinePosMm = m_prev_position_mm;
-                m_prevMachineDeflectionMm = 0.0;
-                m_prevTotalDeflectionMm = 0.0;
-                m_machineEnergyJ = 0.0;
-                m_machineStrainContactActive = false;
-                startMove(m_active_op_remaining_steps, m_active_op_velocity_sps, m_active_op_accel_sps2);
-                reportEvent(STATUS_PREFIX_INFO, "Move resumed.");
-                reportEvent(STATUS_PREFIX_DONE, "resume");
-            } else {
-                // Move already complete
-                reportEvent(STATUS_PREFIX_INFO, "Move already complete.");
-                fullyResetActiveMove();
-                m_state = STATE_STANDBY;
-                reportEvent(STATUS_PREFIX_DONE, "resume");
-            }
-        } else {
-            reportEvent(STATUS_PREFIX_INFO, "No paused move to resume.");
-            reportEvent(STATUS_PREFIX_DONE, "resume");
-        }
-    } else {
-        reportEvent(STATUS_PREFIX_INFO, "No paused operation to resume.");
-        reportEvent(STATUS_PREFIX_DONE, "resume");
+void MotorController::runRecipe(const CommandArgs* args) {
+    if (!args || args->count < 1) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid parameters for RUN_RECIPE. Need a recipe name.");
+        return;
+    }
+    const char* name = args->run_recipe.name;
+    if (!g_recipeStore.matches(name) || g_recipeStore.getStepCount() == 0) {
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        snprintf(msg, sizeof(msg), "Error: Recipe '%s' not found.", name);
+        reportEvent(STATUS_PREFIX_ERROR, msg);
+        return;
     }
+    
+#if STATION_IO_ENABLED
+    uint32_t faults = g_stationIo.getInterlockFaults();
+    if (faults) {
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        snprintf(msg, sizeof(msg), "Error: Station interlock open (inputs 0x%06lX, 0x%06lX not in state)%s.",
+                 (unsigned long)g_stationIo.getInputs(), (unsigned long)faults,
+                 g_stationIo.isLinkUp() ? "" : ", CCIO-8 link down");
+        reportEvent(STATUS_PREFIX_ERROR, msg);
+        return;
+    }
+#endif
+    
+    // Compared with the measured phases when the run reports DONE
+    estimateRecipe(true);
+    m_motionQueueHead = 0;
+    m_motionQueueCount = g_recipeStore.getStepCount();
+    memcpy(m_motionQueue, g_recipeStore.getSteps(), m_motionQueueCount * sizeof(MotionSegment));
+    startMotionQueue(kRunRecipeCommand);
+#if STATION_IO_ENABLED
+    m_interlockTripped = false;
+    m_interlockArmed = m_motionQueueRunning;
+#endif
 }
 
 /**
- * @brief Handles cancel/reset request from GUI (script reset event).
- * Cancels any active operation and returns to standby.
+ * @details Takes the settings the run's moves are started with: the move acceleration and
+ * jerk, the retract position and speed, and the traverse limits of the moment (a rapid
+ * traverse is only allowed while the load cell reads ~0).
  */
-void MotorController::cancelOperation() {
-    if (m_state == STATE_HOMING) {
-        abortMove();
-        m_homingPhase = HOMING_PHASE_IDLE;
-        m_homingState = HOMING_NONE;
-        m_state = STATE_STANDBY;
-        reportEvent(STATUS_PREFIX_INFO, "Homing cancelled. Returning to standby.");
-        reportEvent(STATUS_PREFIX_DONE, "cancel");
-    } else if (m_state == STATE_MOVING) {
-        abortMove();
-        finalizeAndResetActiveMove(false);
-        m_state = STATE_STANDBY;
-        reportEvent(STATUS_PREFIX_INFO, "Move cancelled. Returning to standby.");
-        reportEvent(STATUS_PREFIX_DONE, "cancel");
-    } else {
-        reportEvent(STATUS_PREFIX_INFO, "No active operation to cancel.");
-        reportEvent(STATUS_PREFIX_DONE, "cancel");
-    }
+void MotorController::estimateRecipe(bool from_position) {
+    float steps_per_mm = g_driveGeometry.stepsPerMm();
+    CycleEstimateLimits limits;
+    limits.retract_mm = (m_retractReferenceSteps == LONG_MIN) ? 0.0f : homeRelative(m_retractReferenceSteps).value;
+    limits.start_mm = (from_position && m_homingDone) ? homeRelative(m_motors[0]->PositionRefCommanded()).value
+                                                       : limits.retract_mm;
+    limits.accel_mmss = m_moveDefaultAccelSPS2 / steps_per_mm;
+    limits.jerk_mmss3 = m_motionJerkMmss3;
+    limits.retract_speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
+    limits.traverse_ceiling_mms = traverseCeilingMms();
+    limits.traverse_accel_mmss = (rapidTraverseAllowed() ? m_rapidAccelSps2 : m_moveDefaultAccelSPS2) / steps_per_mm;
+    limits.adaptive = (m_force_mode == FORCE_MODE_LOAD_CELL);
+    g_cycleEstimate.plan(g_recipeStore, limits);
 }
 
 /**
- * @brief Sets the force sensing mode and saves to NVM.
+ * @brief Starts running the motion queue under the given command name.
+ * @details A single DONE for @p command_name is sent after the last segment. Every segment
+ * is compiled first, so a step the force mode rejects fails the run before anything moves.
+ * Segment handoff happens in updateState() when a segment completes, trips a "skip" limit
+ * or finishes its dwell, so there is no host round trip between segments.
+ * @param command_name "queue_run" or "run_recipe" (string literal)
  */
-bool MotorController::setForceMode(const char* mode) {
-    NvmManager &nvmMgr = NvmManager::Instance();
-    
-    if (strcmp(mode, "motor_torque") == 0) {
-        strcpy(m_force_mode, "motor_torque");
-        // Save to NVM (0 = motor_torque, byte offset 16)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(4 * 4), 0);
-        return true;
-    } else if (strcmp(mode, "load_cell") == 0) {
-        strcpy(m_force_mode, "load_cell");
-        // Save to NVM (1 = load_cell, byte offset 16)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(4 * 4), 1);
-        return true;
+void MotorController::startMotionQueue(const char* command_name) {
+    if (!m_homingDone) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Must home before absolute moves.");
+        return;
+    }
+    if (m_motionQueueCount == 0) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Motion queue is empty.");
+        return;
+    }
+    
+    if (!compileMotionQueue(command_name)) {
+        m_motionQueueCount = 0;
+        m_motionQueueHead = 0;
+        return;
+    }
+    
+    m_motionQueueCommand = command_name;
+    m_motionQueueRunning = true;
+    m_motionQueueSegment = 0;
+#if PRESS_SYNC_ENABLED
+    m_syncReleased = false;
+#endif
+    if (startNextQueuedSegment(false, false) == MOVE_START_NOOP) {
+        // Every segment was already at its target
+        m_motionQueueRunning = false;
+        reportEvent(STATUS_PREFIX_INFO, "Motion queue complete.");
+        reportEvent(STATUS_PREFIX_DONE, command_name);
+    }
+}
+
+/**
+ * @brief Compiles every pending segment of the motion queue (see compileSegment()).
+ * @param command_name Queue command, for the message naming a rejected segment
+ * @return false if a segment was rejected (its ERROR has been reported)
+ */
+bool MotorController::compileMotionQueue(const char* command_name) {
+    for (uint8_t i = 0; i < m_motionQueueCount; i++) {
+        uint8_t index = (uint8_t)((m_motionQueueHead + i) % MOTION_QUEUE_SIZE);
+        if (!compileSegment(m_motionQueue[index], &m_motionQueueCompiled[index])) {
+            // Before the run nothing has moved; during it, the segments before this one ran
+            char msg[STATUS_MESSAGE_BUFFER_SIZE];
+            int number = (m_motionQueueRunning ? m_motionQueueSegment : 0) + i + 1;
+            snprintf(msg, sizeof(msg), m_motionQueueRunning ? "%s segment %d rejected." : "%s segment %d rejected; nothing was moved.",
+                     command_name, number);
+            reportEvent(STATUS_PREFIX_INFO, msg);
+            return false;
+        }
+    }
+    m_motionQueueCompiledMode = m_force_mode;
+    return true;
+}
+
+/**
+ * @brief Handles the QUEUE_CLEAR command - discards all pending segments.
+ * @details A running segment is not stopped; the queue completes when it finishes.
+ */
+void MotorController::queueClear() {
+    m_motionQueueCount = 0;
+    m_motionQueueHead = 0;
+    if (m_motionQueueRunning) {
+        reportEvent(STATUS_PREFIX_INFO, "Motion queue cleared. Current segment will finish.");
+    } else {
+        reportEvent(STATUS_PREFIX_INFO, "Motion queue cleared.");
+    }
+    reportEvent(STATUS_PREFIX_DONE, "queue_clear");
+}
+
+/**
+ * @brief Pops segments off the motion queue until one starts moving (or dwelling).
+ * @details Segments were compiled when the queue started, so starting one does no unit
+ * conversion; the pending ones are compiled again only if the force mode changed since.
+ * Segments already at their target are skipped. A segment that fails validation ends the
+ * queue; its ERROR has already been reported. Retract segments move to the stored retract
+ * position with no force limit.
+ * @param continuing true when handing off from a previous segment
+ * @param blend true when the previous segment is still moving (see tryBlendQueuedSegment())
+ * @return MOVE_START_OK if a segment is moving, MOVE_START_NOOP if the queue ran dry,
+ * MOVE_START_FAILED if a segment was rejected
+ */
+MotorController::MoveStartResult MotorController::startNextQueuedSegment(bool continuing, bool blend) {
+    if (m_motionQueueCount > 0 && m_motionQueueCompiledMode != m_force_mode &&
+        !compileMotionQueue(m_motionQueueCommand)) {
+        m_motionQueueCount = 0;
+        m_motionQueueHead = 0;
+        m_motionQueueRunning = false;
+        return MOVE_START_FAILED;
+    }
+    while (m_motionQueueCount > 0) {
+#if PRESS_SYNC_ENABLED
+        if (m_syncGate && m_motionQueueCommand == kRunRecipeCommand && !m_syncReleased) {
+            // Held like a dwell; updateState() comes back here once the segment is released
+            fullyResetActiveMove();
+            m_state = STATE_MOVING;
+            m_moveState = MOVE_SYNC_WAIT;
+            m_activeMoveCommand = m_motionQueueCommand;
+            m_syncContinuing = continuing;
+            m_syncReleasePending = false;
+            return MOVE_START_OK;
+        }
+        m_syncReleased = false;
+#endif
+        CompiledSegment segment = m_motionQueueCompiled[m_motionQueueHead];
+        m_motionQueueHead = (m_motionQueueHead + 1) % MOTION_QUEUE_SIZE;
+        m_motionQueueCount--;
+        m_motionQueueSegment++;
+        
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        if (segment.type == SEGMENT_DWELL) {
+            fullyResetActiveMove();
+            m_state = STATE_MOVING;
+            m_moveState = MOVE_DWELL;
+            m_activeMoveCommand = m_motionQueueCommand;
+            m_dwellStartTime = Milliseconds();
+            m_dwellDurationMs = segment.dwell_ms;
+            if (!continuing) {
+                g_cycleTiming.begin(Microseconds());
+                beginMoveStats();
+            }
+            g_cycleTiming.dwell(Microseconds());
+            snprintf(msg, sizeof(msg), "%s segment %d: dwell %lu ms (%d pending)", m_motionQueueCommand,
+                     m_motionQueueSegment, (unsigned long)segment.dwell_ms, m_motionQueueCount);
+            reportEvent(continuing ? STATUS_PREFIX_INFO : STATUS_PREFIX_START, msg);
+            return MOVE_START_OK;
+        }
+        
+        if (segment.type == SEGMENT_RETRACT) {
+            // set_retract may have moved the retract position since the queue was compiled
+            segment.target_steps = (m_retractReferenceSteps == LONG_MIN) ? m_machineHomeReferenceSteps : m_retractReferenceSteps;
+            if (segment.velocity_sps <= 0) {
+                segment.speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
+                if (segment.speed_mms > MOVE_SPEED_MAX_MMS) {
+                    segment.speed_mms = MOVE_SPEED_MAX_MMS;
+                }
+                segment.velocity_sps = toStepsPerSec(MmPerSec(segment.speed_mms)).value;
+            }
+        }
+        
+        MoveStartResult result = startCompiledMove(segment, m_motionQueueCommand, continuing, blend);
+        if (result == MOVE_START_OK) {
+            g_cycleTiming.segmentStarted(Microseconds(), segment.type == SEGMENT_RETRACT);
+            snprintf(msg, sizeof(msg), "%s segment %d to %.2f mm %s (mode: %s, %d pending)", m_motionQueueCommand,
+                     m_motionQueueSegment, homeRelative(segment.target_steps).value, blend ? "blended" : "initiated",
+                     getForceMode(), m_motionQueueCount);
+            // START once for the whole queue; later segments are progress INFO
+            reportEvent(continuing ? STATUS_PREFIX_INFO : STATUS_PREFIX_START, msg);
+            return MOVE_START_OK;
+        }
+        if (result == MOVE_START_FAILED) {
+            m_motionQueueCount = 0;
+            m_motionQueueHead = 0;
+            m_motionQueueRunning = false;
+            return MOVE_START_FAILED;
+        }
+    }
+    return MOVE_START_NOOP;
+}
+
+/**
+ * @brief Finishes the current queued segment and starts the next one.
+ * @details Called where a completed move would send DONE. Does nothing for moves that
+ * are not part of a running queue, or once the queue has run dry, so the caller sends
+ * DONE for the queue command as usual.
+ * @param blend true when called ahead of the segment end by tryBlendQueuedSegment()
+ * @return true if the completion was handled here (next segment moving, or queue ended)
+ */
+bool MotorController::handoffQueuedSegment(bool blend) {
+    // The queue's moves carry its command pointer (see startNextQueuedSegment())
+    if (!m_motionQueueRunning || m_activeMoveCommand != m_motionQueueCommand) {
+        return false;
+    }
+    if (m_motionQueueCount == 0) {
+        m_motionQueueRunning = false;
+        return false;
+    }
+    
+    if (blend) {
+        // The axis will still cover the rest of this segment; count all of it here
+        m_active_op_total_distance_mm = toMillimeters(Steps(m_active_op_total_target_steps)).value;
+    }
+    finalizeAndResetActiveMove(true);
+    MoveStartResult result = startNextQueuedSegment(true, blend);
+    if (result == MOVE_START_OK) {
+        return true;
+    }
+    if (blend) {
+        // The previous segment is still running toward its target
+        abortMove();
+    }
+    if (result == MOVE_START_NOOP) {
+        m_motionQueueRunning = false;
+        reportMoveDone(m_motionQueueCommand);
+    }
+    m_state = STATE_STANDBY;
+    return true;
+}
+
+/**
+ * @brief Hands off to the next queued segment before the current one starts to decelerate.
+ * @details When the next segment continues in the same direction, its Move() is appended
+ * to the current one once the remaining distance drops to the stopping distance at the
+ * current segment's speed (plus MOTION_BLEND_LOOKAHEAD_MS of travel to cover the main-loop
+ * period). StepGenerator then ramps straight to the next segment's speed instead of
+ * stopping at the boundary. Segments that reverse, or that end with a retract, still stop.
+ */
+void MotorController::tryBlendQueuedSegment() {
+#if MOTION_BLEND_ENABLED
+#if PRESS_SYNC_ENABLED
+    if (m_syncGate) {
+        return;
+    }
+#endif
+    if (!m_motionQueueRunning || m_motionQueueCount == 0 || m_activeMoveCommand != m_motionQueueCommand ||
+        m_active_op_force_action == FORCE_ACTION_RETRACT || m_forceRegulate || m_approachRapid || m_profiledMove ||
+        m_motionQueueCompiledMode != m_force_mode) {
+        return;
+    }
+    
+    const CompiledSegment& next = m_motionQueueCompiled[m_motionQueueHead];
+    if (next.type != SEGMENT_MOVE || next.force_action == FORCE_ACTION_REGULATE) {
+        return;
+    }
+    long current_target = m_active_op_target_position_steps;
+    long current_dir = current_target - m_active_op_initial_axis_steps;
+    long next_dir = next.target_steps - current_target;
+    if (current_dir == 0 || next_dir == 0 || (current_dir > 0) != (next_dir > 0)) {
+        return;
+    }
+    
+    float vel = (float)m_active_op_velocity_sps;
+    float accel = (float)((m_active_op_accel_sps2 > 0) ? m_active_op_accel_sps2 : m_moveDefaultAccelSPS2);
+    long blend_steps = (long)(vel * vel / (2.0f * accel) + vel * MOTION_BLEND_LOOKAHEAD_MS / 1000.0f);
+    long remaining = std::abs(current_target - m_motors[0]->PositionRefCommanded());
+    if (remaining <= blend_steps) {
+        handoffQueuedSegment(true);
+    }
+#endif
+}
+
+/**
+ * @brief Sets up contact learning and the rapid approach for a run_recipe move.
+ * @details Only load_cell press moves (force limit set) take part, since contact is the
+ * press-threshold crossing seen by the load cell. Once the step has a learned contact,
+ * the move is started at the recipe's rapid speed toward the point one margin short of it;
+ * serviceAdaptiveApproach() appends the rest at the step's speed. Regulated moves and moves
+ * that start past the switch point only learn.
+ * @param step Recipe step index (0-based)
+ * @param force_kg Step force limit
+ * @param regulate true for a "regulate" step
+ * @param target_steps Absolute target of the move
+ * @param move_origin Absolute start of the move
+ * @param first_steps In: full move; out: steps of the first Move() to issue
+ * @param first_sps In: step speed; out: speed of the first Move()
+ */
+void MotorController::planAdaptiveApproach(uint8_t step, float force_kg, bool regulate, long target_steps,
+                                           long move_origin, long* first_steps, int* first_sps) {
+    if (!g_recipeStore.isLearning() || step >= g_recipeStore.getStepCount() || force_kg <= 0.0f ||
+        m_active_op_force_mode != FORCE_MODE_LOAD_CELL) {
+        return;
+    }
+    m_adaptiveStep = (int8_t)step;
+    m_adaptiveDir = (target_steps > move_origin) ? 1 : -1;
+    
+    float contact_mm = 0.0f;
+    // Above 100 mm/s only if the load cell reads ~0 now; contact seen before the switch
+    // point already drops to the press speed, so the move keeps its own acceleration
+    float rapid_mms = g_recipeStore.getLearnRapidMms();
+    float ceiling_mms = traverseCeilingMms();
+    if (rapid_mms > ceiling_mms) {
+        rapid_mms = ceiling_mms;
+    }
+    int rapid_sps = toStepsPerSec(MmPerSec(rapid_mms)).value;
+    if (regulate || rapid_sps <= *first_sps || !g_recipeStore.getContactEstimate(step, &contact_mm)) {
+        return;
+    }
+    float switch_mm = contact_mm - g_recipeStore.getLearnMarginMm() * m_adaptiveDir;
+    long switch_steps = absoluteSteps(Millimeters(switch_mm));
+    if ((switch_steps - move_origin) * m_adaptiveDir <= 0 || (target_steps - switch_steps) * m_adaptiveDir <= 0) {
+        return;
+    }
+    
+    m_approachRapid = true;
+    m_approachSwitchSteps = switch_steps;
+    m_approachRapidSps = rapid_sps;
+    *first_steps = switch_steps - move_origin;
+    *first_sps = rapid_sps;
+    
+    char msg[STATUS_MESSAGE_BUFFER_SIZE];
+    snprintf(msg, sizeof(msg), "Adaptive approach: %.1f mm/s to %.2f mm (learned contact %.2f mm)",
+             rapid_mms, switch_mm, contact_mm);
+    reportEvent(STATUS_PREFIX_INFO, msg);
+}
+
+/**
+ * @brief Ends the rapid approach of a learned recipe move.
+ * @details Appends the rest of the move at the step's speed once the remaining rapid
+ * distance drops to what it takes to slow down (the same lookahead as segment blending),
+ * or straight away if contact is seen before the switch point. The append is skipped if a
+ * limit trip has already stopped the axes.
+ */
+void MotorController::serviceAdaptiveApproach() {
+    float vr = (float)m_approachRapidSps;
+    float vs = (float)m_active_op_velocity_sps;
+    float accel = (float)((m_active_op_accel_sps2 > 0) ? m_active_op_accel_sps2 : m_moveDefaultAccelSPS2);
+    long slow_steps = (long)((vr * vr - vs * vs) / (2.0f * accel) + vr * MOTION_BLEND_LOOKAHEAD_MS / 1000.0f);
+    long to_switch = (m_approachSwitchSteps - m_motors[0]->PositionRefCommanded()) * m_adaptiveDir;
+    bool contact = m_energy.isContact();
+    if (!contact && to_switch > slow_steps && isMoving()) {
+        return;
+    }
+    
+    m_approachRapid = false;
+    // Keep the trip ISRs out between the check and the Move(), or a stop could be undone
+    g_controlTick.mask();
+    bool tripped = m_tickTorqueTripped || m_controller->m_forceSensor.tripFired() ||
+                   m_controller->m_forceSensorB.tripFired();
+    if (!tripped) {
+        long remaining = m_active_op_target_position_steps - m_approachSwitchSteps;
+        for (int i = 0; i < m_axisCount; i++) {
+            m_motors[i]->VelMax(m_active_op_velocity_sps);
+            m_motors[i]->Move(remaining);
+        }
+        // The recipe zones take over the speed from the next tick
+        m_zoneSpeedSps = -1;
+    }
+    g_controlTick.unmask();
+    
+    if (!tripped) {
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        float switch_mm = homeRelative(m_approachSwitchSteps).value;
+        if (contact) {
+            snprintf(msg, sizeof(msg), "Contact before %.2f mm, continuing at press speed", switch_mm);
+        } else {
+            snprintf(msg, sizeof(msg), "Adaptive approach: press speed from %.2f mm", switch_mm);
+        }
+        reportEvent(STATUS_PREFIX_INFO, msg);
+    }
+}
+
+/**
+ * @brief Compiles the recipe's limit map for the move just started, or re-arms it on resume.
+ * @details Runs once the move and its trips are armed. Each band folds in the move's own
+ * speed, torque limit and force limit, so the control tick only compares positions and
+ * copies limits. A band's force limit becomes a torque limit in motor_torque mode, and
+ * in load_cell mode applies to moves with a force limit. Band speeds apply to trapezoidal
+ * moves; s-curve and "regulate" moves keep their own speed.
+ * @param resuming true when a paused move restarts: the compiled bands are applied again
+ * from the current position
+ */
+void MotorController::armZones(bool resuming) {
+    if (!resuming) {
+        m_zoneCount = 0;
+        uint8_t count = g_recipeStore.getZoneCount();
+        if (m_activeMoveCommand != kRunRecipeCommand || count == 0) {
+            return;
+        }
+        m_zoneDir = (m_active_op_target_position_steps - m_active_op_initial_axis_steps > 0) ? 1 : -1;
+        m_zoneSpeedControl = !m_profiledMove && !m_forceRegulate;
+        m_zoneForceControl = (m_active_op_force_mode == FORCE_MODE_LOAD_CELL) && !m_forceRegulate &&
+                             m_active_op_force_limit_kg > 0.1f;
+        m_zoneBase.low_steps = 0;
+        m_zoneBase.high_steps = 0;
+        m_zoneBase.velocity_sps = m_active_op_velocity_sps;
+        m_zoneBase.torque_limit = m_torqueLimit;
+        m_zoneBase.force_kg = m_active_op_force_limit_kg;
+        if (m_zoneForceControl) {
+            compileZoneForce(&m_zoneBase);
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            const RecipeZone& band = g_recipeStore.getZone(i);
+            CompiledZone& zone = m_zones[i];
+            zone = m_zoneBase;
+            long start_steps = absoluteSteps(Millimeters(band.start_mm));
+            long end_steps = absoluteSteps(Millimeters(band.end_mm));
+            zone.low_steps = (start_steps < end_steps) ? start_steps : end_steps;
+            zone.high_steps = (start_steps < end_steps) ? end_steps : start_steps;
+            if (band.speed_mms > 0.0f) {
+                int32_t sps = toStepsPerSec(MmPerSec(band.speed_mms)).value;
+                if (sps < 1) {
+                    sps = 1;
+                }
+                if (sps < zone.velocity_sps) {
+                    zone.velocity_sps = sps;
+                }
+            }
+            if (band.torque_pct > 0.0f && band.torque_pct < zone.torque_limit) {
+                zone.torque_limit = band.torque_pct;
+            }
+            if (band.force_kg > 0.0f && m_active_op_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+                float torque = m_motor_torque_scale * band.force_kg + m_motor_torque_offset;
+                if (torque < zone.torque_limit) {
+                    zone.torque_limit = torque;
+                }
+            } else if (band.force_kg > 0.0f && m_zoneForceControl && band.force_kg < zone.force_kg) {
+                zone.force_kg = band.force_kg;
+                compileZoneForce(&zone);
+            }
+        }
+        m_zoneCount = count;
+    } else if (m_zoneCount == 0) {
+        return;
+    }
+    // Armed last: the tick applies the band the axis is in from its next pass
+    g_controlTick.mask();
+    m_zoneActive = -2;
+    m_zoneSpeedSps = -1;
+    m_zoneArmed = true;
+    g_controlTick.unmask();
+}
+
+/**
+ * @brief Converts a compiled band's force limit to the counts the main loop and the trips use.
+ * @param zone Band whose force_kg is set
+ */
+void MotorController::compileZoneForce(CompiledZone* zone) const {
+    ForceSensor& primary = primaryForceSensor();
+    float predict_kg = zone->force_kg * FORCE_TRIP_PREDICT_FRACTION;
+    zone->force_counts = primary.kgToCounts(zone->force_kg);
+    if (m_forceChannel == FORCE_CHANNEL_SUM) {
+        ForceSensor& a = m_controller->m_forceSensor;
+        ForceSensor& b = m_controller->m_forceSensorB;
+        zone->trip_counts[0] = a.kgToCounts(zone->force_kg);
+        zone->predict_counts[0] = a.kgToCounts(predict_kg);
+        zone->trip_counts[1] = b.kgToCounts(zone->force_kg);
+        zone->predict_counts[1] = b.kgToCounts(predict_kg);
+    } else {
+        zone->trip_counts[0] = zone->force_counts;
+        zone->predict_counts[0] = primary.kgToCounts(predict_kg);
+        zone->trip_counts[1] = INT32_MAX;
+        zone->predict_counts[1] = INT32_MAX;
+    }
+}
+
+/**
+ * @brief Applies the recipe's limit map to the active move.
+ * @details Runs in interrupt context. The band is found by comparing the commanded position
+ * with the compiled step boundaries. The speed is the lowest of the band the axis is in and
+ * of every slower band ahead within braking distance (the same lookahead as segment
+ * blending), so the axis has slowed by the time it enters one; a new speed re-plans the
+ * move to the same target (VelMax(), then Move(0)). Torque and force limits are copied on
+ * entering and leaving a band. Any stop or new move disarms the tick first.
+ */
+void MotorController::zoneTick() {
+    if (m_moveState != MOVE_ACTIVE) {
+        return;
+    }
+    long pos = m_tickAxis[0].position_steps;
+    int8_t active = -1;
+    for (uint8_t i = 0; i < m_zoneCount; i++) {
+        if (pos >= m_zones[i].low_steps && pos <= m_zones[i].high_steps) {
+            active = (int8_t)i;
+            break;
+        }
+    }
+    const CompiledZone& here = (active >= 0) ? m_zones[active] : m_zoneBase;
+
+    // The rapid approach runs at its own speed; serviceAdaptiveApproach() hands over
+    if (m_zoneSpeedControl && !m_approachRapid) {
+        int32_t sps = here.velocity_sps;
+        float v = fabsf((float)m_tickAxis[0].velocity_sps);
+        float accel = (float)((m_active_op_accel_sps2 > 0) ? m_active_op_accel_sps2 : m_moveDefaultAccelSPS2);
+        float lookahead = v * MOTION_BLEND_LOOKAHEAD_MS / 1000.0f;
+        for (uint8_t i = 0; i < m_zoneCount; i++) {
+            const CompiledZone& ahead = m_zones[i];
+            if (ahead.velocity_sps >= sps) {
+                continue;
+            }
+            long to_entry = (m_zoneDir > 0) ? ahead.low_steps - pos : pos - ahead.high_steps;
+            float va = (float)ahead.velocity_sps;
+            if (to_entry > 0 && (float)to_entry <= (v * v - va * va) / (2.0f * accel) + lookahead) {
+                sps = ahead.velocity_sps;
+            }
+        }
+        if (sps != m_zoneSpeedSps) {
+            m_zoneSpeedSps = sps;
+            for (int i = 0; i < m_axisCount; i++) {
+                m_motors[i]->VelMax(sps);
+                m_motors[i]->Move(0);
+            }
+        }
+    }
+
+    if (active == m_zoneActive) {
+        return;
+    }
+    m_zoneActive = active;
+    m_torqueLimit = here.torque_limit;
+    if (m_zoneForceControl) {
+        m_active_op_force_limit_kg = here.force_kg;
+        m_active_op_force_limit_counts = here.force_counts;
+#if FORCE_SENSOR_FAST_TRIP_ENABLED
+        if (m_forceChannel == FORCE_CHANNEL_SUM) {
+            m_controller->m_forceSensor.setTripLimit(here.trip_counts[0], here.predict_counts[0]);
+            m_controller->m_forceSensorB.setTripLimit(here.trip_counts[1], here.predict_counts[1]);
+        } else {
+            primaryForceSensor().setTripLimit(here.trip_counts[0], here.predict_counts[0]);
+        }
+#endif
+    }
+}
+
+/**
+ * @brief Handles the MOVE_INC command - move by incremental distance.
+ */
+void MotorController::moveIncremental(const CommandArgs* args) {
+    if (!m_homingDone) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Must home before incremental moves.");
+        return;
+    }
+    
+    // distance, speed, force, [force_action]
+    if (!args || args->count < 1) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Invalid parameters for MOVE_INC. Need at least distance.");
+        return;
+    }
+    const MoveIncArgs& a = args->move_inc;
+    float distance_mm = a.distance;
+    float speed_mms = (args->count >= 2) ? a.speed : MOVE_DEFAULT_VELOCITY_MMS;
+    float force_kg = a.force;
+    const char* force_action_name = (args->count >= 4) ? a.force_action : "hold";
+    ForceAction force_action;
+    if (!parseForceAction(force_action_name, &force_action)) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: Unknown force_action. Use hold, skip, retract, abort, regulate or seat.");
+        return;
+    }
+    if (force_action == FORCE_ACTION_REGULATE) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: regulate is only supported by move_abs and queued moves.");
+        return;
+    }
+    if (force_action == FORCE_ACTION_SEAT && m_force_mode != FORCE_MODE_LOAD_CELL) {
+        reportEvent(STATUS_PREFIX_ERROR, "Error: seat requires load_cell mode.");
+        return;
+    }
+    
+    // Limit speed to 100 mm/s for safety
+    if (speed_mms > MOVE_SPEED_MAX_MMS) {
+        speed_mms = MOVE_SPEED_MAX_MMS;
+        reportEvent(STATUS_PREFIX_INFO, "Speed limited to 100 mm/s for safety.");
+    }
+    
+    // Only check force sensor if we're in "load_cell" mode
+    if (m_force_mode == FORCE_MODE_LOAD_CELL) {
+        const char* errorMsg = nullptr;
+        if (checkForceSensorStatus(&errorMsg)) {
+            char fullMsg[STATUS_MESSAGE_BUFFER_SIZE];
+            snprintf(fullMsg, sizeof(fullMsg), "Move aborted: %s", errorMsg);
+            reportEvent(STATUS_PREFIX_ERROR, fullMsg);
+            return;
+        }
+        
+        // Check if current force already exceeds target (for "hold" action)
+        float current_force = getSelectedForce();
+        if (force_action == FORCE_ACTION_HOLD && force_kg > 0.0f && current_force >= force_kg) {
+            char msg[STATUS_MESSAGE_BUFFER_SIZE];
+            snprintf(msg, sizeof(msg), "Force limit (%.2f kg) already reached. Current force: %.2f kg", 
+                     force_kg, current_force);
+            reportEvent(STATUS_PREFIX_ERROR, msg);  // ERROR message will auto-hold script
+            return;
+        }
+    }
+    
+    long steps_to_move = toSteps(Millimeters(distance_mm)).value;
+    
+    // Check if the move distance is zero
+    if (steps_to_move == 0) {
+        reportEvent(STATUS_PREFIX_INFO, "Move distance is zero. Move complete.");
+        reportEvent(STATUS_PREFIX_DONE, "move_inc");
+        return;
+    }
+    
+    long current_pos = m_motors[0]->PositionRefCommanded();
+    int velocity_sps = toStepsPerSec(MmPerSec(speed_mms)).value;
+    
+    // Set torque limit based on mode
+    if (force_kg > 0.0f) {
+        // Validate kg range based on mode
+        if (m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+            // Motor torque mode: 50-2000 kg range
+            if (force_kg < 50.0f) {
+                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be >= 50 kg in motor_torque mode.");
+                return;
+            }
+            if (force_kg > 2000.0f) {
+                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be <= 2000 kg in motor_torque mode.");
+                return;
+            }
+            // Calculate torque limit using calibrated equation: Torque% = scale * kg + offset
+            m_torqueLimit = m_motor_torque_scale * force_kg + m_motor_torque_offset;
+            char torque_msg[128];
+            snprintf(torque_msg, sizeof(torque_msg), "Torque limit set: %.1f%% (from %.0f kg) in %s mode", 
+                     m_torqueLimit, force_kg, getForceMode());
+            reportEvent(STATUS_PREFIX_INFO, torque_msg);
+        } else {
+            // Load cell mode: 0.2-1000 kg range
+            if (force_kg < 0.2f) {
+                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be >= 0.2 kg in load_cell mode.");
+                return;
+            }
+            if (force_kg > 1000.0f) {
+                reportEvent(STATUS_PREFIX_ERROR, "Error: Force must be <= 1000 kg in load_cell mode.");
+                return;
+            }
+            m_torqueLimit = DEFAULT_TORQUE_LIMIT;
+        }
+    } else {
+        // No kg parameter specified: use default torque limit
+        m_torqueLimit = DEFAULT_TORQUE_LIMIT;
+    }
+    
+    // All validations passed - now update state
+    fullyResetActiveMove();
+    m_state = STATE_MOVING;
+    m_moveState = MOVE_STARTING;
+    m_activeMoveCommand = "move_inc";
+    m_active_op_target_position_steps = current_pos + steps_to_move;  // Store for telemetry
+    
+    // Store move parameters for pause/resume
+    m_active_op_initial_axis_steps = current_pos;
+    m_active_op_total_target_steps = std::abs(steps_to_move);
+    m_active_op_velocity_sps = velocity_sps;
+    m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
+    m_active_op_torque_percent = (int)m_torqueLimit;
+    m_moveStartTime = Milliseconds();  // Set start time for timeout tracking
+    
+    // Store force limit, action, and mode for use during move
+    m_active_op_force_limit_kg = force_kg;
+    m_active_op_force_limit_counts = primaryForceSensor().kgToCounts(force_kg);
+    m_active_op_force_action = force_action;
+    m_active_op_force_mode = m_force_mode;
+    
+    // Reset joule tracking for new move
+    m_energy.resetTotal();
+    m_press_startpoint_mm = 0.0f;
+    beginCapture();
+    g_pressMetrics.begin(m_press_threshold_kg);
+    g_cycleTiming.begin(Microseconds());
+    beginMoveStats();
+    long current_pos_steps = m_motors[0]->PositionRefCommanded();
+    m_energy.begin(current_pos_steps - m_machineHomeReferenceSteps);
+    m_forceLimitTriggered = false;
+    // motor_torque energy comes from the control tick's torque-derived force
+    m_jouleIntegrationActive = (m_active_op_force_mode == FORCE_MODE_LOAD_CELL) || TORQUE_JOULES_ENABLED;
+    
+    if (m_motionJerkMmss3 > 0.0f) {
+        startProfiledMove(steps_to_move, velocity_sps, m_moveDefaultAccelSPS2);
+    } else {
+        startMove(steps_to_move, velocity_sps, m_moveDefaultAccelSPS2);
+    }
+    armForceTrip();
+    
+    char msg[128];
+    snprintf(msg, sizeof(msg), "move_inc by %.2f mm initiated (mode: %s)", distance_mm, getForceMode());
+    reportEvent(STATUS_PREFIX_START, msg);
+}
+
+/**
+ * @brief Handles pause request from GUI (script hold event).
+ * Works for any active move - homing or feeding.
+ */
+void MotorController::pauseOperation() {
+    if (m_state == STATE_HOMING) {
+        // Pause homing - stop motors and save current phase
+        abortMove();
+        reportEvent(STATUS_PREFIX_INFO, "Homing paused. Send resume to continue.");
+        reportEvent(STATUS_PREFIX_DONE, "pause");
+    } else if (m_state == STATE_MOVING) {
+        if (m_moveState == MOVE_ACTIVE || m_moveState == MOVE_STARTING || 
+            m_moveState == MOVE_TO_HOME || m_moveState == MOVE_TO_RETRACT) {
+            // Decelerate to a hold at the move's own acceleration; resume carries on from there
+            m_pausedMoveState = m_moveState;
+            m_pausedApproachRapid = m_approachRapid;
+            abortMove();
+            m_moveState = MOVE_PAUSED;
+            reportEvent(STATUS_PREFIX_INFO, "Move paused. Send resume to continue.");
+            reportEvent(STATUS_PREFIX_DONE, "pause");
+        } else {
+            reportEvent(STATUS_PREFIX_INFO, "No active move to pause.");
+            reportEvent(STATUS_PREFIX_DONE, "pause");
+        }
+    } else {
+        reportEvent(STATUS_PREFIX_INFO, "No active operation to pause.");
+        reportEvent(STATUS_PREFIX_DONE, "pause");
+    }
+}
+
+/**
+ * @brief Handles resume request from GUI (script run event).
+ * Resumes paused homing or feeding operations.
+ */
+void MotorController::resumeOperation() {
+    if (m_state == STATE_HOMING) {
+        // Resume homing from current phase
+        reportEvent(STATUS_PREFIX_INFO, "Homing resumed.");
+        reportEvent(STATUS_PREFIX_DONE, "resume");
+        // The homing state machine will automatically continue from its current phase
+        // No need to restart - it will pick up in the next updateState() call
+    } else if (m_state == STATE_MOVING) {
+        if (m_moveState == MOVE_PAUSED) {
+            // Remaining distance to the target of whatever was paused (press move, retract or
+            // trip retract), signed so a move toward home resumes in its own direction
+            long current_pos = m_motors[0]->PositionRefCommanded();
+            long remaining_steps = m_active_op_target_position_steps - current_pos;
+            bool retracting = (m_pausedMoveState == MOVE_TO_HOME || m_pausedMoveState == MOVE_TO_RETRACT);
+            bool approach = m_pausedApproachRapid &&
+                            (m_approachSwitchSteps - current_pos) * m_adaptiveDir > 0;
+            m_pausedApproachRapid = false;
+            
+            // Resume paused moves
+            if (remaining_steps != 0) {
+                m_active_op_remaining_steps = std::abs(remaining_steps);
+                m_active_op_segment_initial_axis_steps = current_pos;
+                m_moveState = retracting ? m_pausedMoveState : MOVE_RESUMING;
+                m_torqueLimit = (float)m_active_op_torque_percent;
+                m_moveStartTime = Milliseconds();  // Reset start time for timeout tracking
+                m_jouleIntegrationActive = !m_forceLimitTriggered &&
+                    (m_active_op_force_mode == FORCE_MODE_LOAD_CELL || TORQUE_JOULES_ENABLED);
+                // Energy, machine strain and contact state carry on across the pause: samples
+                // kept being integrated while the axes decelerated and held, so the metrics
+                // of the whole press stroke stay one continuous integration
+                if (approach) {
+                    // Back onto the rapid approach; serviceAdaptiveApproach() appends the rest
+                    m_approachRapid = true;
+                    startMove(m_approachSwitchSteps - current_pos, m_approachRapidSps, m_active_op_accel_sps2);
+                } else if (m_profiledMove && m_motionJerkMmss3 > 0.0f && !retracting) {
+                    // Same jerk-limited profile the move started with, from standstill
+                    startProfiledMove(remaining_steps, m_active_op_velocity_sps, m_profileAccelSps2);
+                } else {
+                    startMove(remaining_steps, m_active_op_velocity_sps, m_active_op_accel_sps2);
+                }
+                if (!retracting) {
+                    // The limit trips again, without restarting seat detection
+                    armForceTrip(true);
+                    armZones(true);
+                }
+                reportEvent(STATUS_PREFIX_INFO, "Move resumed.");
+                reportEvent(STATUS_PREFIX_DONE, "resume");
+            } else {
+                // Move already complete
+                reportEvent(STATUS_PREFIX_INFO, "Move already complete.");
+                fullyResetActiveMove();
+                m_state = STATE_STANDBY;
+                reportEvent(STATUS_PREFIX_DONE, "resume");
+            }
+        } else {
+            reportEvent(STATUS_PREFIX_INFO, "No paused move to resume.");
+            reportEvent(STATUS_PREFIX_DONE, "resume");
+        }
+    } else {
+        reportEvent(STATUS_PREFIX_INFO, "No paused operation to resume.");
+        reportEvent(STATUS_PREFIX_DONE, "resume");
+    }
+}
+
+/**
+ * @brief Handles cancel/reset request from GUI (script reset event).
+ * Cancels any active operation and returns to standby.
+ */
+void MotorController::cancelOperation() {
+    if (m_state == STATE_HOMING) {
+        abortMove();
+        m_homingPhase = HOMING_PHASE_IDLE;
+        m_homingState = HOMING_NONE;
+        m_state = STATE_STANDBY;
+        reportEvent(STATUS_PREFIX_INFO, "Homing cancelled. Returning to standby.");
+        reportEvent(STATUS_PREFIX_DONE, "cancel");
+    } else if (m_state == STATE_MOVING) {
+        abortMove();
+        finalizeAndResetActiveMove(false);
+        m_state = STATE_STANDBY;
+        reportEvent(STATUS_PREFIX_INFO, "Move cancelled. Returning to standby.");
+        reportEvent(STATUS_PREFIX_DONE, "cancel");
+    } else {
+        reportEvent(STATUS_PREFIX_INFO, "No active operation to cancel.");
+        reportEvent(STATUS_PREFIX_DONE, "cancel");
+    }
+}
+
+/**
+ * @brief Sets the force sensing mode and saves to NVM.
+ */
+bool MotorController::setForceMode(const char* mode) {
+    if (strcmp(mode, "motor_torque") == 0) {
+        m_force_mode = FORCE_MODE_MOTOR_TORQUE;
+        g_settings.edit().force_mode = 0;
+        return true;
+    } else if (strcmp(mode, "load_cell") == 0) {
+        m_force_mode = FORCE_MODE_LOAD_CELL;
+        g_settings.edit().force_mode = 1;
+        return true;
+    }
+    return false; // Invalid mode
+}
+
+/**
+ * @brief Gets the current force sensing mode.
+ */
+const char* MotorController::getForceMode() const {
+    return (m_force_mode == FORCE_MODE_MOTOR_TORQUE) ? "motor_torque" : "load_cell";
+}
+
+bool MotorController::parseForceAction(const char* name, ForceAction* action) {
+    for (uint8_t a = 0; a < FORCE_ACTION_NONE; a++) {
+        if (strcmp(name, kForceActionNames[a]) == 0) {
+            *action = static_cast<ForceAction>(a);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* MotorController::forceActionName(ForceAction action) {
+    return (action < FORCE_ACTION_NONE) ? kForceActionNames[action] : "none";
+}
+
+/**
+ * @brief Sets the coordinate system polarity and saves to NVM.
+ */
+bool MotorController::setPolarity(const char* polarity) {
+    if (strcmp(polarity, "normal") == 0) {
+        m_polarity = POLARITY_NORMAL;
+        g_settings.edit().polarity_inverted = 0;
+        // Apply polarity to motors (false = not inverted)
+        for (int i = 0; i < m_axisCount; i++) {
+            m_motors[i]->PolarityInvertSDDirection(false);
+        }
+        return true;
+    } else if (strcmp(polarity, "inverted") == 0) {
+        m_polarity = POLARITY_INVERTED;
+        g_settings.edit().polarity_inverted = 1;
+        // Apply polarity to motors (true = inverted)
+        for (int i = 0; i < m_axisCount; i++) {
+            m_motors[i]->PolarityInvertSDDirection(true);
+        }
+        return true;
+    }
+    return false; // Invalid polarity
+}
+
+/**
+ * @brief Gets the current coordinate system polarity.
+ */
+const char* MotorController::getPolarity() const {
+    return (m_polarity == POLARITY_INVERTED) ? "inverted" : "normal";
+}
+
+/**
+ * @brief Sets the home on boot setting and saves to NVM.
+ */
+bool MotorController::setHomeOnBoot(const char* enabled) {
+    if (strcmp(enabled, "true") == 0) {
+        m_home_on_boot = true;
+        g_settings.edit().home_on_boot = 1;
+        return true;
+    } else if (strcmp(enabled, "false") == 0) {
+        m_home_on_boot = false;
+        g_settings.edit().home_on_boot = 0;
+        return true;
+    }
+    return false; // Invalid parameter
+}
+
+/**
+ * @brief Gets the current home on boot setting.
+ */
+bool MotorController::getHomeOnBoot() const {
+    return m_home_on_boot;
+}
+
+/**
+ * @brief Sets the press force threshold and saves to NVM.
+ */
+bool MotorController::setForceChannel(const char* channel) {
+    ForceChannelSelect select;
+    if (strcmp(channel, "a") == 0) {
+        select = FORCE_CHANNEL_A;
+    } else if (strcmp(channel, "b") == 0) {
+        select = FORCE_CHANNEL_B;
+    } else if (strcmp(channel, "sum") == 0) {
+        select = FORCE_CHANNEL_SUM;
+    } else {
+        return false;
+    }
+    
+    m_forceChannel = select;
+    g_settings.edit().force_channel = (uint8_t)select;
+    return true;
+}
+
+const char* MotorController::getForceChannel() const {
+    switch (m_forceChannel) {
+        case FORCE_CHANNEL_B:   return "b";
+        case FORCE_CHANNEL_SUM: return "sum";
+        default:                return "a";
+    }
+}
+
+float MotorController::getSummedForce() const {
+    return m_controller->m_forceSensor.getFilteredForce() + m_controller->m_forceSensorB.getFilteredForce();
+}
+
+float MotorController::getDifferentialForce() const {
+    return m_controller->m_forceSensor.getFilteredForce() - m_controller->m_forceSensorB.getFilteredForce();
+}
+
+bool MotorController::isForceChannelConnected(uint8_t channel) const {
+    return (channel == 0) ? m_controller->m_forceSensor.isConnected() : m_controller->m_forceSensorB.isConnected();
+}
+
+/**
+ * @brief Gets the load cell whose samples drive limits and joules (A for the sum).
+ */
+ForceSensor& MotorController::primaryForceSensor() const {
+    return (m_forceChannel == FORCE_CHANNEL_B) ? m_controller->m_forceSensorB : m_controller->m_forceSensor;
+}
+
+/**
+ * @brief Gets the latest fast-channel force for the selected channel(s).
+ */
+float MotorController::getSelectedForce() const {
+    if (m_forceChannel == FORCE_CHANNEL_SUM) {
+        return m_controller->m_forceSensor.getForce() + m_controller->m_forceSensorB.getForce();
+    }
+    return primaryForceSensor().getForce();
+}
+
+/**
+ * @brief Sets the S-curve jerk limit (0 = trapezoidal) and saves to NVM.
+ */
+bool MotorController::setEncoderFeedback(float counts_per_mm, float tolerance_mm) {
+    if (fabs(counts_per_mm) > ENCODER_COUNTS_PER_MM_MAX ||
+        tolerance_mm < ENCODER_TOLERANCE_MM_MIN || tolerance_mm > ENCODER_TOLERANCE_MM_MAX) {
+        return false;
+    }
+    
+    configureEncoder(counts_per_mm, tolerance_mm);
+    
+    PressSettings& settings = g_settings.edit();
+    settings.encoder_counts_per_mm = counts_per_mm;
+    settings.encoder_tolerance_mm = tolerance_mm;
+    return true;
+}
+
+bool MotorController::setMotionJerk(float jerk_mmss3) {
+    if (jerk_mmss3 != 0.0f &&
+        (jerk_mmss3 < MOTION_SCURVE_JERK_MIN_MMSS3 || jerk_mmss3 > MOTION_SCURVE_JERK_MAX_MMSS3)) {
+        return false;
+    }
+    
+    m_motionJerkMmss3 = jerk_mmss3;
+    g_settings.edit().motion_jerk = jerk_mmss3;
+    return true;
+}
+
+bool MotorController::setRapidTraverse(int vel_mms, int accel_mmss) {
+    if (vel_mms < 0 || vel_mms > RAPID_VEL_MAX_MMS ||
+        (vel_mms > 0 && (accel_mmss < RAPID_ACCEL_UNIT_MMSS || accel_mmss > RAPID_ACCEL_MAX_MMSS))) {
+        return false;
+    }
+    
+    uint8_t accel_units = (vel_mms > 0) ? (uint8_t)(accel_mmss / RAPID_ACCEL_UNIT_MMSS) : 0;
+    m_rapidVelMms = vel_mms;
+    m_rapidAccelMmss = accel_units * RAPID_ACCEL_UNIT_MMSS;
+    m_rapidAccelSps2 = toStepsPerSec(MmPerSec((float)m_rapidAccelMmss)).value;
+    
+    PressSettings& settings = g_settings.edit();
+    settings.rapid_vel_mms = (uint8_t)vel_mms;
+    settings.rapid_accel_5mmss = accel_units;
+    return true;
+}
+
+/**
+ * @brief Checks whether a non-working stroke starting now may run as a rapid traverse.
+ * @details Rapid traverse must be set, the press in load_cell mode and the selected load
+ * cell connected, in range and reading below RAPID_FORCE_GATE_KG; motor torque cannot
+ * tell a collision from the friction of a fast stroke.
+ */
+bool MotorController::rapidTraverseAllowed() {
+    const char* errorMsg = nullptr;
+    return m_rapidVelMms > 0 && m_force_mode == FORCE_MODE_LOAD_CELL &&
+           !checkForceSensorStatus(&errorMsg) && fabsf(getSelectedForce()) < RAPID_FORCE_GATE_KG;
+}
+
+/**
+ * @brief Speed ceiling of a non-working stroke starting now.
+ * @return The rapid ceiling if rapidTraverseAllowed() and above MOVE_SPEED_MAX_MMS, else MOVE_SPEED_MAX_MMS
+ */
+float MotorController::traverseCeilingMms() {
+    if (m_rapidVelMms > MOVE_SPEED_MAX_MMS && rapidTraverseAllowed()) {
+        return (float)m_rapidVelMms;
+    }
+    return MOVE_SPEED_MAX_MMS;
+}
+
+/**
+ * @brief Applies the traverse limits to a retract about to start.
+ * @details A retract allowed to run as a rapid gets the rapid ceiling and acceleration and
+ * is supervised for force until it ends (m_rapidActive); any other gets MOVE_SPEED_MAX_MMS
+ * and the move acceleration.
+ * @param speed_mms In: requested speed; out: speed clamped to the ceiling that applies
+ * @return Acceleration for the retract (steps/sec^2)
+ */
+int MotorController::limitTraverse(float* speed_mms) {
+    m_rapidActive = rapidTraverseAllowed();
+    float ceiling_mms = MOVE_SPEED_MAX_MMS;
+    if (m_rapidActive && m_rapidVelMms > MOVE_SPEED_MAX_MMS) {
+        ceiling_mms = (float)m_rapidVelMms;
+    }
+    if (*speed_mms > ceiling_mms) {
+        *speed_mms = ceiling_mms;
+    }
+    return m_rapidActive ? m_rapidAccelSps2 : m_moveDefaultAccelSPS2;
+}
+
+bool MotorController::applyTorqueFriction(const int32_t* sps, const float* torque_pct, uint8_t count) {
+    float slope[TORQUE_FRICTION_MAX_POINTS];
+    if (count > TORQUE_FRICTION_MAX_POINTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (sps[i] < 0 || sps[i] > TORQUE_FRICTION_SPS_MAX ||
+            torque_pct[i] < -TORQUE_FRICTION_PCT_MAX || torque_pct[i] > TORQUE_FRICTION_PCT_MAX) {
+            return false;
+        }
+        if (i > 0 && sps[i] <= sps[i - 1]) {
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i + 1 < count; i++) {
+        slope[i] = (torque_pct[i + 1] - torque_pct[i]) / (float)(sps[i + 1] - sps[i]);
+    }
+    if (count > 0) {
+        slope[count - 1] = 0.0f;
+    }
+    
+    // The control tick reads the table every tick
+    g_controlTick.mask();
+    for (uint8_t i = 0; i < count; i++) {
+        m_frictionSps[i] = sps[i];
+        m_frictionPct[i] = torque_pct[i];
+        m_frictionSlope[i] = slope[i];
+    }
+    m_frictionCount = count;
+    if (count == 0) {
+        m_tickFriction[0] = m_tickFriction[1] = 0.0f;
+    }
+    g_controlTick.unmask();
+    return true;
+}
+
+bool MotorController::setTorqueFriction(const float* speed_mms, const float* torque_pct, uint8_t count) {
+    int32_t sps[TORQUE_FRICTION_MAX_POINTS];
+    if (count > TORQUE_FRICTION_MAX_POINTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (speed_mms[i] < 0.0f || speed_mms[i] * g_driveGeometry.stepsPerMm() > (float)TORQUE_FRICTION_SPS_MAX) {
+            return false;
+        }
+        sps[i] = (int32_t)(speed_mms[i] * g_driveGeometry.stepsPerMm() + 0.5f);
+    }
+    if (!applyTorqueFriction(sps, torque_pct, count)) {
+        return false;
+    }
+    
+    // Staged for the idle flash job (locations 66-70); a write here would stall command dispatch
+    for (uint8_t i = 0; i < count; i++) {
+        int16_t centi = (int16_t)(torque_pct[i] * 100.0f + (torque_pct[i] >= 0.0f ? 0.5f : -0.5f));
+        m_frictionNvm[i] = (int32_t)(((uint32_t)(uint16_t)centi << 16) | (uint32_t)sps[i]);
+    }
+    m_frictionNvmCount = count;
+    m_frictionNvmPending = true;
+    return true;
+}
+
+bool MotorController::commitTorqueFriction() {
+    if (!m_frictionNvmPending) {
+        return true;
+    }
+    NvmManager &nvmMgr = NvmManager::Instance();
+    if (m_frictionNvmCount > 0 &&
+        !nvmMgr.BlockWrite(static_cast<NvmManager::NvmLocations>(NVM_SLOT_TORQUE_FRICTION_POINTS * 4),
+                           m_frictionNvmCount * sizeof(int32_t), reinterpret_cast<const uint8_t*>(m_frictionNvm))) {
+        return false;
+    }
+    // Count last, so an interrupted write never loads a partial table
+    if (!nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_TORQUE_FRICTION_COUNT * 4), m_frictionNvmCount)) {
+        return false;
+    }
+    m_frictionNvmPending = false;
+    return true;
+}
+
+void MotorController::eraseTorqueFriction() {
+    m_frictionNvmPending = false;
+    NvmManager::Instance().Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_TORQUE_FRICTION_COUNT * 4), -1);
+}
+
+bool MotorController::getTorqueFrictionPoint(uint8_t index, float* speed_mms, float* torque_pct) const {
+    if (index >= m_frictionCount) {
+        return false;
+    }
+    *speed_mms = toMmPerSec(StepsPerSec(m_frictionSps[index])).value;
+    *torque_pct = m_frictionPct[index];
+    return true;
+}
+
+/**
+ * @brief Interpolates the friction table.
+ * @details Safe to call from interrupt context; at most TORQUE_FRICTION_MAX_POINTS compares.
+ * @param sps Step rate magnitude (steps/s)
+ * @return Friction torque (%), held at the end values outside the table, 0 with no table
+ */
+float MotorController::frictionTorqueAt(int32_t sps) const {
+    if (m_frictionCount == 0) {
+        return 0.0f;
+    }
+    if (sps <= m_frictionSps[0]) {
+        return m_frictionPct[0];
+    }
+    uint8_t i = 0;
+    while (i + 1 < m_frictionCount && sps >= m_frictionSps[i + 1]) {
+        i++;
+    }
+    return m_frictionPct[i] + m_frictionSlope[i] * (float)(sps - m_frictionSps[i]);
+}
+
+bool MotorController::setPressThreshold(float threshold_kg) {
+    // Validate range
+    if (threshold_kg < 0.1f || threshold_kg > 50.0f) {
+        return false;
+    }
+    
+    m_press_threshold_kg = threshold_kg;
+    g_settings.setJournaled(NVM_JOURNAL_KEY_PRESS_THRESHOLD, threshold_kg);
+    return true;
+}
+
+/**
+ * @brief Sets the calibration offset for the current force mode.
+ */
+void MotorController::setForceCalibrationOffset(float offset) {
+    if (m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+        // Motor torque offset (intercept of Torque% = scale * kg + offset)
+        m_motor_torque_offset = offset;
+        g_settings.edit().torque_offset = offset;
+    } else {
+        // Load cell offset - delegate to force sensor
+        // (force sensor handles its own NVM storage)
+    }
+}
+
+/**
+ * @brief Sets the calibration scale for the current force mode.
+ */
+void MotorController::setForceCalibrationScale(float scale) {
+    if (m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+        // Motor torque scale (slope of Torque% = scale * kg + offset)
+        m_motor_torque_scale = scale;
+        g_settings.edit().torque_scale = scale;
+    } else {
+        // Load cell scale - delegate to force sensor
+        // (force sensor handles its own NVM storage)
+    }
+}
+
+void MotorController::setTorqueCalibration(float scale, float offset) {
+    m_motor_torque_scale = scale;
+    m_motor_torque_offset = offset;
+    PressSettings& settings = g_settings.edit();
+    settings.torque_scale = scale;
+    settings.torque_offset = offset;
+}
+
+#if PRESSBOI_BENCHMARK
+/**
+ * @details A 0.01 mm-per-sample ramp to 500 kg: the first samples are below the press
+ * threshold, the rest take the full strain-compensated path.
+ */
+uint32_t MotorController::benchmarkJoules(uint16_t samples, uint32_t* min_cycles) {
+    PressEnergy savedEnergy = m_energy;
+    float savedStartpoint = m_press_startpoint_mm;
+    float savedLimit = m_active_op_force_limit_kg;
+    int8_t savedAdaptiveStep = m_adaptiveStep;
+
+    m_energy.invalidate();
+    m_energy.clearContact();
+    m_active_op_force_limit_kg = 0.0f;
+    m_adaptiveStep = -1;
+    const long step = lroundf(0.01f * g_driveGeometry.stepsPerMm());
+    uint32_t total = 0;
+    *min_cycles = UINT32_MAX;
+    for (uint16_t i = 0; i < samples; i++) {
+        float force_kg = 500.0f * i / samples;
+        uint32_t start = DWT->CYCCNT;
+        integrateForceSample(force_kg, (long)i * step);
+        uint32_t cycles = DWT->CYCCNT - start;
+        total += cycles;
+        if (cycles < *min_cycles) {
+            *min_cycles = cycles;
+        }
+    }
+
+    m_energy = savedEnergy;
+    m_press_startpoint_mm = savedStartpoint;
+    m_active_op_force_limit_kg = savedLimit;
+    m_adaptiveStep = savedAdaptiveStep;
+    return total;
+}
+#endif
+
+/**
+ * @brief Gets the calibration offset for the current force mode.
+ */
+float MotorController::getForceCalibrationOffset() const {
+    if (m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+        return m_motor_torque_offset;
+    } else {
+        // Return load cell offset (would need to add getter to ForceSensor)
+        return 0.0f; // Placeholder
+    }
+}
+
+/**
+ * @brief Gets the calibration scale for the current force mode.
+ */
+float MotorController::getForceCalibrationScale() const {
+    if (m_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+        return m_motor_torque_scale;
+    } else {
+        // Return load cell scale (would need to add getter to ForceSensor)
+        return 1.0f; // Placeholder
+    }
+}
+
+/**
+ * @brief Commands a synchronized move on all motors.
+ */
+void MotorController::startMove(long steps, int velSps, int accelSps2) {
+    m_tickTorqueReseed = true;
+    // A new move replaces whatever the zone tick planned; armZones() re-arms it
+    m_zoneArmed = false;
+#if RACKING_CORRECTION_ENABLED
+    armRacking();
+#endif
+
+    char logMsg[128];
+    snprintf(logMsg, sizeof(logMsg), "startMove called: steps=%ld, vel=%d, accel=%d, torque=%.1f", steps, velSps, accelSps2, m_torqueLimit);
+    reportEvent(STATUS_PREFIX_INFO, logMsg);
+
+    if (steps == 0) {
+        reportEvent(STATUS_PREFIX_INFO, "startMove called with 0 steps. No move will occur.");
+        return;
     }
-    return false; // Invalid mode
+
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->VelMax(velSps);
+        m_motors[i]->AccelMax(accelSps2);
+    }
+
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->Move(steps);
+    }
+}
+
+/**
+ * @brief Applies encoder settings (already validated) without touching NVM.
+ * @param counts_per_mm Encoder resolution, negative if reversed, 0 = off
+ * @param tolerance_mm Allowed measured-vs-commanded difference
+ */
+void MotorController::configureEncoder(float counts_per_mm, float tolerance_mm) {
+    g_controlTick.mask();
+    m_encoderArmed = false;
+    m_encoderCountsPerMm = counts_per_mm;
+    m_encoderToleranceMm = tolerance_mm;
+    m_encoderCountsPerStep = fabsf(counts_per_mm) * g_driveGeometry.mmPerStep();
+    m_encoderToleranceCounts = tolerance_mm * (float)fabs(counts_per_mm);
+    g_controlTick.unmask();
+    
+    EncoderIn.Enable(counts_per_mm != 0.0f);
+    EncoderIn.SwapDirection(counts_per_mm < 0.0f);
+    alignEncoder();
+}
+
+/**
+ * @brief Re-references the encoder to the commanded position and arms the check.
+ * @details Neither count is absolute, so the check compares motion since the last
+ * alignment. Called whenever the two may legitimately have diverged: at enable, when
+ * the encoder is configured, and after a reported fault.
+ */
+void MotorController::alignEncoder() {
+    g_controlTick.mask();
+    m_encoderArmed = false;
+    if (m_encoderCountsPerMm != 0.0f && m_isEnabled) {
+        MotorDriver* motor = m_motors[ENCODER_FEEDBACK_AXIS];
+        EncoderIn.ClearQuadratureError();
+        m_encoderOffsetCounts = EncoderIn.Position() -
+                                (int32_t)lroundf(motor->PositionRefCommanded() * m_encoderCountsPerStep);
+        m_encoderArmed = true;
+    }
+    g_controlTick.unmask();
+}
+
+/**
+ * @brief Time-critical path: compares the encoder with the commanded position and stops
+ * both axes if they disagree by more than the tolerance or the encoder reports a
+ * quadrature error (lost steps, a stall, or a slipped coupling).
+ */
+void MotorController::encoderCheckTick() {
+    float error_counts = (float)(EncoderIn.Position() - m_encoderOffsetCounts) -
+                         m_tickAxis[ENCODER_FEEDBACK_AXIS].position_steps * m_encoderCountsPerStep;
+    bool quadrature = EncoderIn.QuadratureError();
+    if (!quadrature && std::abs(error_counts) <= m_encoderToleranceCounts) {
+        return;
+    }
+    m_encoderArmed = false;
+    m_encoderQuadratureFault = quadrature;
+    m_encoderErrorMm = error_counts / (float)fabs(m_encoderCountsPerMm);
+    m_encoderTripped = true;
+    m_profileActive = false;
+    m_regulateArmed = false;
+    stopAllAxes();
+    TRACE(TRACE_ENCODER_TRIP, quadrature ? 1 : 0, error_counts);
+}
+
+/**
+ * @brief Reports an encoder trip from the control tick and drops the home reference.
+ * @details The commanded position can no longer be trusted, so any operation ends in
+ * standby and a new home is required before absolute moves.
+ */
+void MotorController::serviceEncoderFault() {
+    if (!m_encoderTripped) {
+        return;
+    }
+    m_encoderTripped = false;
+    abortMove();
+    
+    char errorMsg[160];
+    if (m_encoderQuadratureFault) {
+        snprintf(errorMsg, sizeof(errorMsg), "Position fault: M%d encoder quadrature error. Home required.",
+                 ENCODER_FEEDBACK_AXIS);
+    } else {
+        snprintf(errorMsg, sizeof(errorMsg),
+                 "Position fault: M%d measured position differs from commanded by %.2f mm (tolerance %.2f). Home required.",
+                 ENCODER_FEEDBACK_AXIS, (float)m_encoderErrorMm, m_encoderToleranceMm);
+    }
+    reportEvent(STATUS_PREFIX_ERROR, errorMsg);
+    ERROR_LOG(LOG_ERROR, errorMsg);
+    
+    if (m_state == STATE_MOVING) {
+        finalizeAndResetActiveMove(false);
+    }
+    m_state = STATE_STANDBY;
+    m_homingPhase = HOMING_PHASE_IDLE;
+    m_homingDone = false;
+    m_homeTrusted = false;
+    m_homeLearned = false;
+#if HOMING_RESTORE_ENABLED
+    m_homeRestored = false;
+#endif
+    // Track from the new (unknown) position so the error is reported once
+    alignEncoder();
+}
+
+#if RACKING_CORRECTION_ENABLED
+/**
+ * @brief Starts comparing the followers with M0 for a new lockstep move.
+ * @details Called as each move is commanded. Homing squares the axes one by one, and an
+ * unhomed gantry has no known square, so neither is supervised. The first move after
+ * homing takes each follower's commanded offset from M0 as the square; every move after
+ * that is held to it, so no trim or drift can add up from one move to the next.
+ */
+void MotorController::armRacking() {
+    g_controlTick.mask();
+    m_rackingArmed = false;
+    if (m_axisCount > 1 && m_homingDone && m_state != STATE_HOMING) {
+        float steps_per_mm = g_driveGeometry.stepsPerMm();
+        m_rackGainSpsPerPct = RACKING_TRIM_GAIN_MMS_PER_PCT * steps_per_mm;
+        m_rackTrimMaxSps = RACKING_TRIM_MAX_MMS * steps_per_mm;
+        m_rackTrimSlewSps = RACKING_TRIM_SLEW_MMS * steps_per_mm;
+        m_rackLeadMaxSteps = toSteps(Millimeters(RACKING_TRIM_LEAD_MAX_MM)).value;
+        m_rackFaultSteps = toSteps(Millimeters(RACKING_FAULT_MM)).value;
+        long reference_steps = m_motors[0]->PositionRefCommanded();
+        for (int i = 1; i < m_axisCount; i++) {
+            if (!m_rackSquareSet) {
+                m_rackBaselineSteps[i] = (int32_t)(m_motors[i]->PositionRefCommanded() - reference_steps);
+            }
+            m_rackTrimSps[i] = 0.0f;
+            m_rackAppliedSps[i] = 0;
+        }
+        m_rackOverTicks = 0;
+        m_rackSquareSet = true;
+        m_rackingArmed = true;
+    }
+    g_controlTick.unmask();
+}
+
+/**
+ * @brief Trims each follower's step rate towards M0's load and stops the axes if the gantry racks.
+ * @details Runs in interrupt context. The follower pushing harder than M0 in the direction of
+ * travel is the one trailing it, so it is sped up, by RACKING_TRIM_GAIN_MMS_PER_PCT per % beyond
+ * the deadband and at most RACKING_TRIM_SLEW_MMS per tick; a follower pushing less is slowed,
+ * which leaves M0 (the press position) on its plan either way. The trim stops growing once
+ * the follower leads or trails by RACKING_TRIM_LEAD_MAX_MM. On a positional move it is given
+ * while M0 cruises, as a higher or lower VelMax re-planned onto the same target; on an S-curve
+ * move profileTick() adds it to the streamed speed. Either way the followers still end on
+ * their targets. A torque difference over RACKING_FAULT_TORQUE_PCT for RACKING_FAULT_MS, or a
+ * commanded difference over RACKING_FAULT_MM, stops the axes for serviceRackingFault().
+ */
+void MotorController::rackingTick() {
+    int32_t reference_sps = m_tickAxis[0].velocity_sps;
+    int dir = (reference_sps > 0) ? 1 : ((reference_sps < 0) ? -1 : 0);
+    MotorDriver::StatusRegMotor reference = tickStatus(0);
+    bool cruising = reference.bit.StepsActive && reference.bit.AtTargetVelocity && !m_profileActive;
+    bool over_torque = false;
+    for (int i = 1; i < m_axisCount; i++) {
+        int32_t imbalance = (m_tickAxis[i].position_steps - m_tickAxis[0].position_steps) - m_rackBaselineSteps[i];
+        bool torque_valid = m_tickTorqueSeeded[0] && m_tickTorqueSeeded[i];
+        float torque_diff = torque_valid
+            ? (m_tickTorque[i] - m_tickFriction[i]) - (m_tickTorque[0] - m_tickFriction[0]) : 0.0f;
+        bool fault = std::abs(imbalance) > m_rackFaultSteps;
+        if (std::fabs(torque_diff) > RACKING_FAULT_TORQUE_PCT) {
+            over_torque = true;
+            fault = fault || (m_rackOverTicks + 1u >= (uint32_t)RACKING_FAULT_MS * CONTROL_TICK_HZ / 1000u);
+        }
+        if (fault) {
+            m_rackingArmed = false;
+            m_rackingAxis = (uint8_t)i;
+            m_rackingTorqueDiff = torque_diff;
+            m_rackingImbalanceSteps = imbalance;
+            m_rackingTripped = true;
+            m_profileActive = false;
+            m_regulateArmed = false;
+            stopAllAxes();
+            TRACE(TRACE_RACKING_TRIP, i, imbalance);
+            return;
+        }
+
+        float target = 0.0f;
+        if (torque_valid && dir != 0 && reference.bit.StepsActive) {
+            float lag = dir * torque_diff;
+            float excess = std::fabs(lag) - RACKING_TORQUE_DEADBAND_PCT;
+            if (excess > 0.0f) {
+                target = (lag > 0.0f) ? excess * m_rackGainSpsPerPct : -excess * m_rackGainSpsPerPct;
+                if (target > m_rackTrimMaxSps) {
+                    target = m_rackTrimMaxSps;
+                } else if (target < -m_rackTrimMaxSps) {
+                    target = -m_rackTrimMaxSps;
+                }
+                // Hold the lead already gained rather than build more
+                long lead = dir * imbalance;
+                if ((target > 0.0f && lead >= m_rackLeadMaxSteps) || (target < 0.0f && -lead >= m_rackLeadMaxSteps)) {
+                    target = 0.0f;
+                }
+            }
+        }
+        float trim = m_rackTrimSps[i];
+        if (target > trim + m_rackTrimSlewSps) {
+            trim += m_rackTrimSlewSps;
+        } else if (target < trim - m_rackTrimSlewSps) {
+            trim -= m_rackTrimSlewSps;
+        } else {
+            trim = target;
+        }
+        m_rackTrimSps[i] = trim;
+
+        // Off cruise a new speed from the main loop or the zone tick has replaced any VelMax set here
+        if (!cruising) {
+            m_rackAppliedSps[i] = 0;
+            continue;
+        }
+        // A slowed follower keeps at least half of M0's speed
+        int32_t trim_sps = (int32_t)trim;
+        if (trim_sps < -std::abs(reference_sps) / 2) {
+            trim_sps = -std::abs(reference_sps) / 2;
+        }
+        if (trim_sps != m_rackAppliedSps[i] && tickStatus(i).bit.StepsActive) {
+            m_motors[i]->VelMax((uint32_t)(std::abs(reference_sps) + trim_sps));
+            m_motors[i]->Move(0);
+            m_rackAppliedSps[i] = trim_sps;
+        }
+    }
+    m_rackOverTicks = over_torque ? (uint16_t)(m_rackOverTicks + 1u) : 0;
+}
+
+/**
+ * @brief Reports a racking fault from the control tick and ends the operation.
+ * @details A commanded difference means the followers no longer hold the square homing set,
+ * so the home reference is dropped; a torque difference alone leaves it.
+ */
+void MotorController::serviceRackingFault() {
+    if (!m_rackingTripped) {
+        return;
+    }
+    m_rackingTripped = false;
+    abortMove();
+
+    bool position = std::abs(m_rackingImbalanceSteps) > m_rackFaultSteps;
+    char errorMsg[200];
+    snprintf(errorMsg, sizeof(errorMsg),
+             "Racking fault: M%u load torque differs from M0 by %.1f%% (limit %.1f%%), position by %.3f mm (limit %.2f)%s",
+             (unsigned)m_rackingAxis, (float)m_rackingTorqueDiff, RACKING_FAULT_TORQUE_PCT,
+             g_driveGeometry.mmPerStep() * (float)m_rackingImbalanceSteps, RACKING_FAULT_MM,
+             position ? ". Home required." : ".");
+    reportEvent(STATUS_PREFIX_ERROR, errorMsg);
+    ERROR_LOG(LOG_ERROR, errorMsg);
+
+    if (m_state == STATE_MOVING) {
+        finalizeAndResetActiveMove(false);
+    }
+    m_state = STATE_STANDBY;
+    if (position) {
+        m_homingDone = false;
+        m_homeTrusted = false;
+        m_homeLearned = false;
+#if HOMING_RESTORE_ENABLED
+        m_homeRestored = false;
+#endif
+    }
+}
+#endif // RACKING_CORRECTION_ENABLED
+
+/**
+ * @brief Starts a jerk-limited move on both axes.
+ * @details Plans an SCurveProfile with the current jerk limit and hands it to the control
+ * tick, which streams it with MoveVelocity() (see profileTick()). The step generators'
+ * own accel limit is raised by MOTION_SCURVE_TRACK_ACCEL_FACTOR so they follow the
+ * profile rather than reshaping it. Resume after a pause plans a new profile over the
+ * remaining distance.
+ * @param steps Signed move length
+ * @param velSps Velocity ceiling (steps/sec)
+ * @param accelSps2 Acceleration ceiling (steps/sec^2)
+ */
+void MotorController::startProfiledMove(long steps, int velSps, int accelSps2) {
+    m_tickTorqueReseed = true;
+    
+    float jerk_sps3 = m_motionJerkMmss3 * g_driveGeometry.stepsPerMm();
+    if (steps == 0 || !m_profile.plan((float)std::abs(steps), (float)velSps, (float)accelSps2, jerk_sps3)) {
+        startMove(steps, velSps, accelSps2);
+        return;
+    }
+    
+    char logMsg[128];
+    snprintf(logMsg, sizeof(logMsg), "startProfiledMove called: steps=%ld, vel=%d, accel=%d, jerk=%.0f, time=%.3f s",
+             steps, (int)m_profile.getPeakVelocity(), accelSps2, jerk_sps3, m_profile.getDuration());
+    reportEvent(STATUS_PREFIX_INFO, logMsg);
+    
+    int track_accel = (int)(accelSps2 * MOTION_SCURVE_TRACK_ACCEL_FACTOR);
+    g_controlTick.mask();
+    m_profileDir = (steps > 0) ? 1 : -1;
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->AccelMax(track_accel);
+        m_profileTarget[i] = m_motors[i]->PositionRefCommanded() + steps;
+    }
+    m_profileAccelSps2 = accelSps2;
+    m_profileTicks = 0;
+    m_profiledMove = true;
+    m_profileActive = true;
+    g_controlTick.unmask();
+#if RACKING_CORRECTION_ENABLED
+    armRacking();
+#endif
+}
+
+/**
+ * @brief Streams one control tick of the active S-curve move.
+ * @details Runs in interrupt context. Once the planned time has elapsed, a positional
+ * Move() per axis takes up whatever the generators lagged the plan by, so the axes stop
+ * exactly on target and the move completes through the normal !isMoving() path.
+ */
+void MotorController::profileTick() {
+    m_profileTicks++;
+    float t = (float)m_profileTicks / CONTROL_TICK_HZ;
+    if (t >= m_profile.getDuration()) {
+        m_profileActive = false;
+        int settle_sps = toStepsPerSec(MmPerSec(MOTION_SCURVE_SETTLE_MMS)).value;
+        for (int i = 0; i < m_axisCount; i++) {
+            m_motors[i]->VelMax(settle_sps);
+            m_motors[i]->AccelMax(m_profileAccelSps2);
+            m_motors[i]->Move(m_profileTarget[i] - m_motors[i]->PositionRefCommanded());
+        }
+        return;
+    }
+    
+    float vel = m_profile.velocityAt(t);
+    float min_vel = MOTION_SCURVE_MIN_MMS * g_driveGeometry.stepsPerMm();
+    if (vel < min_vel) {
+        vel = min_vel;
+    }
+    int velocity_sps = (int)(m_profileDir * vel);
+    m_motors[0]->MoveVelocity(velocity_sps);
+    for (int i = 1; i < m_axisCount; i++) {
+#if RACKING_CORRECTION_ENABLED
+        // The trim only shifts the followers along the plan; the final Move() lands them on target
+        float follower_vel = vel + m_rackTrimSps[i];
+        if (follower_vel < vel * 0.5f) {
+            follower_vel = vel * 0.5f;
+        }
+        m_motors[i]->MoveVelocity((int)(m_profileDir * follower_vel));
+#else
+        m_motors[i]->MoveVelocity(velocity_sps);
+#endif
+    }
+}
+
+/**
+ * @brief Checks if any of the motors are currently active.
+ * @details Reads the step generators' move state (see isAxisMoving()), so a move counts
+ * from the Move() call that commands it rather than from the next drive refresh.
+ */
+bool MotorController::isMoving() {
+    if (!m_isEnabled) return false;
+    for (int i = 0; i < m_axisCount; i++) {
+        if (isAxisMoving(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Confirms that the move of a lockstep homing phase has been taken up.
+ * @details Called from each *_START phase in the pass it issues the move, so a confirmed
+ * start goes on to the MOVING phase without waiting a pass. A move the step generators
+ * never took (drive fault, rejected Move()) fails homing once MOVE_START_TIMEOUT_MS has
+ * passed since m_homingPhaseStartTime.
+ * @param all_axes true if every axis must hold its move, false if any one will do
+ * @param failure ERROR message if the start times out (axis status is appended)
+ * @return true once started; false while waiting or after the failure was reported
+ */
+bool MotorController::homingMoveStarted(bool all_axes, const char* failure) {
+    bool started = all_axes;
+    for (int i = 0; i < m_axisCount; i++) {
+        started = all_axes ? (started && isAxisMoving(i)) : (started || isAxisMoving(i));
+    }
+    if (started) {
+        return true;
+    }
+    if (Milliseconds() - m_homingPhaseStartTime > MOVE_START_TIMEOUT_MS) {
+        abortMove();
+        char errorMsg[200];
+        snprintf(errorMsg, sizeof(errorMsg), "%s", failure);
+        appendAxisStatus(errorMsg, sizeof(errorMsg));
+        reportEvent(STATUS_PREFIX_ERROR, errorMsg);
+        m_state = STATE_STANDBY;
+        m_homingPhase = HOMING_PHASE_IDLE;
+    }
+    return false;
+}
+
+/**
+ * @brief Gets a motor's filtered torque as sampled by the control tick.
+ * @details Side-effect free: the filter advances once per tick in torqueSampleTick(), so
+ * every reader in the same loop pass sees the same value. During active moves the last
+ * value is held while HLFB briefly reads at-position; 0 when idle or not yet sampled.
+ * @param axis 0 = M0 .. m_axisCount - 1
+ */
+float MotorController::getSmoothedTorque(int axis) const {
+    if (!m_tickTorqueSeeded[axis]) {
+        return 0.0f;
+    }
+    return m_tickTorque[axis] + m_torqueOffset;
+}
+
+/**
+ * @brief Gets a motor's filtered torque with friction at its commanded speed removed.
+ * @details This is the part of the torque that is pushing on the load; it is what force-derived
+ * torque limits are compared with and what motor_torque force is computed from.
+ * @param axis 0 = M0 .. m_axisCount - 1
+ */
+float MotorController::getLoadTorque(int axis) const {
+    if (!m_tickTorqueSeeded[axis]) {
+        return 0.0f;
+    }
+    return m_tickTorque[axis] + m_torqueOffset - m_tickFriction[axis];
+}
+
+/**
+ * @brief Gets the force the motor torque model reads (force_motor_torque in telemetry).
+ * @details Averages the friction-compensated torque of every axis and applies the
+ * set_force_scale/set_force_offset equation. Safe to call from the control tick.
+ * @return Force in kg, clamped to 0 .. 2000
+ */
+float MotorController::torqueForceKg() const {
+    float load_torque_sum = 0.0f;
+    for (int i = 0; i < m_axisCount; i++) {
+        load_torque_sum += getLoadTorque(i);
+    }
+    float avg_load_torque = load_torque_sum / (float)m_axisCount;
+    float force_kg = (avg_load_torque - m_motor_torque_offset) / m_motor_torque_scale;
+    if (force_kg < 0.0f) force_kg = 0.0f;
+    if (force_kg > 2000.0f) force_kg = 2000.0f;
+    return force_kg;
+}
+
+bool MotorController::isRecipeRunning() const {
+    return m_motionQueueRunning && m_motionQueueCommand == kRunRecipeCommand;
+}
+
+#if PRESS_SYNC_ENABLED
+uint8_t MotorController::getSyncWaitSegment() const {
+    if (m_state != STATE_MOVING || m_moveState != MOVE_SYNC_WAIT) {
+        return 0;
+    }
+    return (uint8_t)(m_motionQueueSegment + 1);
+}
+
+void MotorController::releaseSyncSegment(uint32_t at_us) {
+    if (m_state == STATE_MOVING && m_moveState == MOVE_SYNC_WAIT) {
+        m_syncReleaseUs = at_us;
+        m_syncReleasePending = true;
+    }
+}
+#endif
+
+bool MotorController::isPressing() const {
+    if (m_state != STATE_MOVING) {
+        return false;
+    }
+    float force_kg = (m_force_mode == FORCE_MODE_LOAD_CELL) ? getSelectedForce() : torqueForceKg();
+    return force_kg >= m_press_threshold_kg;
+}
+
+/**
+ * @brief Checks if the torque on any motor has exceeded the current limit.
+ * @details Just checks and returns true/false. Does NOT abort move or report.
+ * The caller is responsible for handling the limit being reached.
+ */
+bool MotorController::checkTorqueLimit(bool friction_compensated) {
+    if (isMoving()) {
+        bool over_limit = false;
+        for (int i = 0; i < m_axisCount; i++) {
+            float torque = friction_compensated ? getLoadTorque(i) : getSmoothedTorque(i);
+            over_limit |= (torque != TORQUE_HLFB_AT_POSITION && std::abs(torque) > m_torqueLimit);
+        }
+        return over_limit;
+    }
+    return false;
+}
+
+/**
+ * @brief Handles the logic when a force or torque limit is reached during a move.
+ * @param limit_event Typed "... reached." event to report (force, torque or seat)
+ * @param arg0 First argument of the event (the limit)
+ * @param arg1 Second argument of the event (the actual force or the baseline), if it has one
+ */
+void MotorController::handleLimitReached(StatusEventId limit_event, float arg0, float arg1) {
+    // Retract and abort reverse straight into the retract (unless the trip ISR already has),
+    // so the host hears about the limit while the press is already moving away
+    bool retract = (m_active_op_force_action == FORCE_ACTION_RETRACT || m_active_op_force_action == FORCE_ACTION_ABORT);
+    if (retract) {
+        startTripRetract();
+    } else {
+        abortMove();
+    }
+    m_controller->m_forceSensor.disarmTrip();
+    m_controller->m_forceSensorB.disarmTrip();
+    m_fusionTripArmed = false;
+    m_fusionTripped = false;
+    m_tickTorqueArmed = false;
+    m_tickTorqueTripped = false;
+    m_jouleIntegrationActive = false;
+    m_forceLimitTriggered = true;
+    m_energy.invalidate();
+    m_seatArmed = false;
+    g_productionCounters.addTrip();
+    m_seatDetected = false;
+    m_envelopeArmed = false;
+    
+    // Record endpoint where force limit was reached (only for press moves, not retracts)
+    if (m_activeMoveCommand && 
+        (strcmp(m_activeMoveCommand, "move_abs") == 0 || strcmp(m_activeMoveCommand, "move_inc") == 0 ||
+         strcmp(m_activeMoveCommand, "queue_run") == 0 || strcmp(m_activeMoveCommand, "run_recipe") == 0)) {
+        long endpoint_steps = retract ? m_tripRetractFromSteps : m_motors[0]->PositionRefCommanded();
+        m_endpoint_mm = homeRelative(endpoint_steps).value;
+    }
+    
+    if (retract) {
+        // The retract is already under way; only the move bookkeeping changes to it
+        const char* original_command = m_activeMoveCommand;
+        bool abort_action = (m_active_op_force_action == FORCE_ACTION_ABORT);
+        
+        // CRITICAL: Clear force_action to prevent infinite retract loop
+        m_active_op_force_action = FORCE_ACTION_NONE;
+        
+        m_moveState = MOVE_TO_HOME;
+        m_activeMoveCommand = "retract";
+        m_active_op_target_position_steps = m_tripRetractTarget[0];
+        g_cycleTiming.retract(Microseconds());
+        m_torqueLimit = DEFAULT_TORQUE_LIMIT;
+        m_active_op_velocity_sps = m_tripRetractSps;
+        m_active_op_accel_sps2 = m_tripRetractAccelSps2;
+        m_rapidActive = false;
+        
+        postEvent(limit_event, eventArgF(arg0), eventArgF(arg1));
+        if (abort_action) {
+            // Send ERROR for the original command to halt script
+            if (original_command) {
+                char msg[STATUS_MESSAGE_BUFFER_SIZE];
+                snprintf(msg, sizeof(msg), "%s aborted due to force limit", original_command);
+                reportEvent(STATUS_PREFIX_ERROR, msg);
+            }
+        } else {
+            // Store the original command name, DONE is sent for it when the retract completes
+            m_originalMoveCommand = original_command;
+            reportEvent(STATUS_PREFIX_INFO, "Force limit reached, retracting...");
+        }
+        reportEvent(STATUS_PREFIX_START, "retract");
+        return;
+    }
+    
+    postEvent(limit_event, eventArgF(arg0), eventArgF(arg1));
+    
+    // Handle action based on force_action parameter
+    if (m_active_op_force_action == FORCE_ACTION_SKIP || m_active_op_force_action == FORCE_ACTION_SEAT) {
+        // Skip the rest of the move - complete at current position and send DONE
+        // ("seat" ends the same way on a stiffness jump, with the force limit as the backstop)
+        if (handoffQueuedSegment(false)) {
+            // A queued move carries on with its next segment instead
+            return;
+        }
+        if (m_activeMoveCommand) {
+            reportMoveDone(m_activeMoveCommand);
+        }
+        finalizeAndResetActiveMove(true);
+        m_state = STATE_STANDBY;
+    } else {
+        // "hold" action - pause and wait for user
+        m_moveState = MOVE_PAUSED;
+        g_cycleTiming.dwell(Microseconds());
+    }
+}
+
+/**
+ * @brief Arms the interrupt-driven limit trips for the active move.
+ * @details Load-cell moves arm the receive-path force trip; motor_torque moves arm the
+ * control tick torque check. Both are disarmed again by handleLimitReached() and
+ * fullyResetActiveMove(). Regulated moves arm the control tick force regulator instead of
+ * a trip at the target force. "seat" moves also restart the stiffness detector, and
+ * "retract"/"abort" moves prepare the retract the trip starts.
+ * @param resuming true when re-arming a resumed move: the seat detector keeps its window
+ */
+void MotorController::armForceTrip(bool resuming) {
+    armTripRetract();
+    if (!resuming) {
+        m_seatArmed = (m_active_op_force_action == FORCE_ACTION_SEAT);
+        m_seatDetected = false;
+        m_seatCount = 0;
+        m_seatHead = 0;
+        m_seatBaselineSamples = 0;
+        m_seatBaselineKgMm = 0.0f;
+        m_seatStiffnessKgMm = 0.0f;
+    }
+    if (m_forceRegulate) {
+        // Start in approach mode; the tick switches to velocity control near the target
+        g_controlTick.mask();
+        m_regulateFault = REGULATE_FAULT_NONE;
+        m_regulateVelocityMode = false;
+        m_regulateIntegral = 0.0f;
+        m_regulateErrorKg = m_active_op_force_limit_kg;
+        m_regulateLastSampleUs = primaryForceSensor().getLastSampleTimeUs();
+        m_regulateContactAt = 0;
+        m_regulateSettledAt = 0;
+        m_regulateArmed = true;
+        g_controlTick.unmask();
+        return;
+    }
+    if (m_active_op_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+        // The torque filter was restarted with the move and keeps running in the tick
+        m_tickTorqueTripped = false;
+        m_tickTorqueArmed = true;
+        return;
+    }
+    m_tripLeadUs = predictLeadUs();
+    m_forceRateKgPerUs = 0.0f;
+    m_forceRatePrevUs = 0;
+#if FORCE_FUSION_TRIP_ENABLED
+    // Fires from the control tick between load-cell samples; the sample trips stay armed too
+    m_fusionTripped = false;
+    m_fusionTripArmed = (m_active_op_force_mode == FORCE_MODE_LOAD_CELL && m_active_op_force_limit_kg > 0.1f);
+#endif
+#if FORCE_SENSOR_FAST_TRIP_ENABLED
+    if (m_active_op_force_mode == FORCE_MODE_LOAD_CELL && m_active_op_force_limit_kg > 0.1f) {
+        float predict_kg = m_active_op_force_limit_kg * FORCE_TRIP_PREDICT_FRACTION;
+        if (m_forceChannel == FORCE_CHANNEL_SUM) {
+            // Per-channel ISRs cannot see the sum; each cell alone reaching the full limit
+            // still trips, the main loop catches the summed crossing
+            ForceSensor& a = m_controller->m_forceSensor;
+            ForceSensor& b = m_controller->m_forceSensorB;
+            a.armTrip(a.kgToCounts(m_active_op_force_limit_kg), &MotorController::forceTripHook, this,
+                      m_tripLeadUs, a.kgToCounts(predict_kg));
+            b.armTrip(b.kgToCounts(m_active_op_force_limit_kg), &MotorController::forceTripHook, this,
+                      m_tripLeadUs, b.kgToCounts(predict_kg));
+        } else {
+            ForceSensor& sensor = primaryForceSensor();
+            sensor.armTrip(m_active_op_force_limit_counts, &MotorController::forceTripHook, this,
+                           m_tripLeadUs, sensor.kgToCounts(predict_kg));
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Feeds one load-cell sample to the "seat" stiffness detector.
+ * @details Keeps running sums over the last SEAT_DETECT_WINDOW in-contact samples, so each
+ * sample costs a constant few operations. The least-squares slope of force over position
+ * is compared with a slowly smoothed baseline of itself; a jump to SEAT_STIFFNESS_RATIO
+ * times the baseline (or the SEAT_MIN_STIFFNESS_KG_MM floor) marks the part as seated.
+ * @param position_steps Axis position at acquisition (steps from home)
+ * @param force_kg Calibrated force (kg)
+ */
+void MotorController::seatDetectSample(long position_steps, float force_kg) {
+    if (!m_seatArmed || m_seatDetected) {
+        return;
+    }
+    if (force_kg < m_press_threshold_kg) {
+        // Not in contact yet (or lost it): start over from the next contact
+        m_seatCount = 0;
+        m_seatHead = 0;
+        m_seatBaselineSamples = 0;
+        return;
+    }
+
+    if (m_seatCount == 0) {
+        m_seatOriginSteps = position_steps;
+        m_seatSumX = m_seatSumY = m_seatSumXX = m_seatSumXY = 0;
+    } else if (m_seatCount == SEAT_DETECT_WINDOW) {
+        // Drop the oldest sample from the sums
+        int64_t old_x = m_seatWindowPos[m_seatHead];
+        int64_t old_y = m_seatWindowForce[m_seatHead];
+        m_seatSumX -= old_x;
+        m_seatSumY -= old_y;
+        m_seatSumXX -= old_x * old_x;
+        m_seatSumXY -= old_x * old_y;
+        m_seatCount--;
+    }
+    // Integer steps and centi-kg keep the sliding sums exact however long the press runs
+    int32_t x = (int32_t)(position_steps - m_seatOriginSteps);
+    int32_t y = (int32_t)lroundf(force_kg * 100.0f);
+    m_seatWindowPos[m_seatHead] = x;
+    m_seatWindowForce[m_seatHead] = y;
+    m_seatHead = (m_seatHead + 1) % SEAT_DETECT_WINDOW;
+    m_seatCount++;
+    m_seatSumX += x;
+    m_seatSumY += y;
+    m_seatSumXX += (int64_t)x * x;
+    m_seatSumXY += (int64_t)x * y;
+    if (m_seatCount < SEAT_DETECT_WINDOW) {
+        return;
+    }
+
+    const int64_t n = SEAT_DETECT_WINDOW;
+    int64_t denom = n * m_seatSumXX - m_seatSumX * m_seatSumX;
+    if (denom <= 0) {
+        return;  // No travel across the window: slope undefined
+    }
+    // centi-kg per step -> kg per mm
+    float slope = fabsf((float)(n * m_seatSumXY - m_seatSumX * m_seatSumY) / (float)denom) * (g_driveGeometry.stepsPerMm() / 100.0f);
+
+    if (m_seatBaselineSamples < SEAT_DETECT_WINDOW) {
+        // Let the baseline settle on the part's own stiffness before comparing against it
+        m_seatBaselineKgMm = (m_seatBaselineSamples == 0) ? slope
+            : m_seatBaselineKgMm + SEAT_BASELINE_ALPHA * (slope - m_seatBaselineKgMm);
+        m_seatBaselineSamples++;
+        return;
+    }
+    float baseline = (m_seatBaselineKgMm > SEAT_MIN_STIFFNESS_KG_MM) ? m_seatBaselineKgMm : SEAT_MIN_STIFFNESS_KG_MM;
+    if (slope >= SEAT_STIFFNESS_RATIO * baseline) {
+        m_seatStiffnessKgMm = slope;
+        m_seatDetected = true;
+        return;
+    }
+    m_seatBaselineKgMm += SEAT_BASELINE_ALPHA * (slope - m_seatBaselineKgMm);
+}
+
+/**
+ * @brief Force trip callback, runs in the COM-0 receive interrupt.
+ * @details Stops the steppers, or for a "retract"/"abort" move reverses them into the
+ * retract; the rest of the limit handling (reporting, hold/skip) still runs from
+ * updateState() on the next pass.
+ */
+/**
+ * @brief Time over which the predictive trip extrapolates the force rate.
+ * @details A sample is the force latency old when it arrives, and after the stop the axes
+ * decelerate from the move's velocity at its acceleration. Force keeps rising with the
+ * distance covered, which at constant stiffness is what half the stopping time at the
+ * full rate adds.
+ * @return Microseconds, at most FORCE_TRIP_PREDICT_MAX_LEAD_US (0 when prediction is off)
+ */
+uint32_t MotorController::predictLeadUs() const {
+#if FORCE_TRIP_PREDICT_ENABLED
+    if (m_active_op_accel_sps2 <= 0) {
+        return 0;
+    }
+    float stop_half_us = 0.5e6f * (float)m_active_op_velocity_sps / (float)m_active_op_accel_sps2;
+    float lead_us = (float)primaryForceSensor().getLatencyUs() + stop_half_us;
+    return (lead_us > (float)FORCE_TRIP_PREDICT_MAX_LEAD_US) ? FORCE_TRIP_PREDICT_MAX_LEAD_US : (uint32_t)lead_us;
+#else
+    return 0;
+#endif
+}
+
+void MotorController::forceTripHook(void* context) {
+    MotorController* self = static_cast<MotorController*>(context);
+    self->m_profileActive = false;
+    if (self->m_tripRetractArmed) {
+        self->issueTripRetract();
+    } else if (!self->m_tripRetractIssued) {
+        // A second summed-channel trip must not stop a retract already under way
+        self->stopAllAxes();
+    }
+    HIL_MARK(HIL_SIGNAL_STOP);
 }
 
 /**
- * @brief Gets the current force sensing mode.
+ * @brief Prepares the retract a limit trip of a "retract"/"abort" move starts.
+ * @details The target is the retract position (home if none is set) in each axis' own
+ * frame. The speed is capped at MOVE_SPEED_MAX_MMS, as a stroke starting under load never
+ * runs as a rapid, and the acceleration is at least the move's own, so the reversal stops
+ * the press no later than MoveStopDecel() would have. Configured before arming, as the
+ * trip ISR may run between any two statements.
  */
-const char* MotorController::getForceMode() const {
-    return m_force_mode;
+void MotorController::armTripRetract() {
+    m_tripRetractArmed = false;
+    m_tripRetractIssued = false;
+    if (m_active_op_force_action != FORCE_ACTION_RETRACT && m_active_op_force_action != FORCE_ACTION_ABORT) {
+        return;
+    }
+    long target = (m_retractReferenceSteps == LONG_MIN) ? m_machineHomeReferenceSteps : m_retractReferenceSteps;
+    float speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
+    if (speed_mms > MOVE_SPEED_MAX_MMS) {
+        speed_mms = MOVE_SPEED_MAX_MMS;
+    }
+    long reference_steps = m_motors[0]->PositionRefCommanded();
+    for (int i = 0; i < m_axisCount; i++) {
+        m_tripRetractTarget[i] = target + (m_motors[i]->PositionRefCommanded() - reference_steps);
+    }
+    m_tripRetractSps = toStepsPerSec(MmPerSec(speed_mms)).value;
+    m_tripRetractAccelSps2 = (m_active_op_accel_sps2 > m_moveDefaultAccelSPS2) ? m_active_op_accel_sps2 : m_moveDefaultAccelSPS2;
+    m_tripRetractArmed = true;
 }
 
 /**
- * @brief Sets the coordinate system polarity and saves to NVM.
+ * @brief Reverses all axes into the prepared retract. ISR-safe; runs in the trip ISRs,
+ * or from startTripRetract() with the control tick masked.
+ * @details The absolute Move() is merged with the motion in progress, so the axes
+ * decelerate and head for the retract position without a stop in between.
  */
-bool MotorController::setPolarity(const char* polarity) {
-    NvmManager &nvmMgr = NvmManager::Instance();
-    
-    if (strcmp(polarity, "normal") == 0) {
-        strcpy(m_polarity, "normal");
-        // Save to NVM (0 = normal, byte offset 12)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(3 * 4), 0);
-        // Apply polarity to motors (false = not inverted)
-        m_motorA->PolarityInvertSDDirection(false);
-        m_motorB->PolarityInvertSDDirection(false);
-        return true;
-    } else if (strcmp(polarity, "inverted") == 0) {
-        strcpy(m_polarity, "inverted");
-        // Save to NVM (1 = inverted, byte offset 12)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(3 * 4), 1);
-        // Apply polarity to motors (true = inverted)
-        m_motorA->PolarityInvertSDDirection(true);
-        m_motorB->PolarityInvertSDDirection(true);
-        return true;
+void MotorController::issueTripRetract() {
+    m_tripRetractArmed = false;
+    m_zoneArmed = false;
+    m_tripRetractFromSteps = m_motors[0]->PositionRefCommanded();
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->VelMax(m_tripRetractSps);
+        m_motors[i]->AccelMax(m_tripRetractAccelSps2);
     }
-    return false; // Invalid polarity
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->Move(m_tripRetractTarget[i], StepGenerator::MOVE_TARGET_ABSOLUTE);
+    }
+    m_tripRetractIssued = true;
+    TRACE(TRACE_TRIP_RETRACT, m_state, m_tripRetractFromSteps);
 }
 
 /**
- * @brief Gets the current coordinate system polarity.
+ * @brief Starts the retract of a "retract"/"abort" limit that no trip ISR has started
+ * (summed channels, the fast trip off, or a limit seen only by the main loop).
  */
-const char* MotorController::getPolarity() const {
-    return m_polarity;
+void MotorController::startTripRetract() {
+    g_controlTick.mask();
+    m_regulateArmed = false;
+    m_approachRapid = false;
+    m_profileActive = false;
+    if (!m_tripRetractIssued) {
+        if (!m_tripRetractArmed) {
+            armTripRetract();
+        }
+        issueTripRetract();
+    }
+    g_controlTick.unmask();
 }
 
 /**
- * @brief Sets the home on boot setting and saves to NVM.
+ * @brief Control tick callback, runs in the TCC2 interrupt at CONTROL_TICK_HZ.
  */
-bool MotorController::setHomeOnBoot(const char* enabled) {
-    NvmManager &nvmMgr = NvmManager::Instance();
-    
-    if (strcmp(enabled, "true") == 0) {
-        m_home_on_boot = true;
-        // Save to NVM (1 = true, byte offset 52, location 13)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(13 * 4), 1);
-        return true;
-    } else if (strcmp(enabled, "false") == 0) {
-        m_home_on_boot = false;
-        // Save to NVM (0 = false, byte offset 52, location 13)
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(13 * 4), 0);
-        return true;
-    }
-    return false; // Invalid parameter
+void MotorController::controlTickHook(void* context) {
+    static_cast<MotorController*>(context)->controlTick();
 }
 
+#if FORCE_REPLAY_ENABLED
 /**
- * @brief Gets the current home on boot setting.
+ * @brief Force replay position source: commanded position relative to machine home, the
+ * frame PressCapture records positions in. Runs in the control tick.
  */
-bool MotorController::getHomeOnBoot() const {
-    return m_home_on_boot;
+int32_t MotorController::replayPositionHook(void* context) {
+    MotorController* self = static_cast<MotorController*>(context);
+    return (int32_t)(self->m_motors[0]->PositionRefCommanded() - self->m_machineHomeReferenceSteps);
 }
+#endif
 
 /**
- * @brief Sets the press force threshold and saves to NVM.
+ * @brief Time-critical path: samples HLFB and stops both axes on a torque-limit crossing.
+ * @details Runs in interrupt context. Only stops the steppers and latches the result;
+ * limit handling (retract/hold/abort, messages) runs from updateState().
  */
-bool MotorController::setPressThreshold(float threshold_kg) {
-    // Validate range
-    if (threshold_kg < 0.1f || threshold_kg > 50.0f) {
-        return false;
+void MotorController::controlTick() {
+    axisSnapshotTick();
+#if POSITION_CURVE_ENABLED
+    g_positionCurve.tick(Microseconds(), (int32_t)(m_tickAxis[0].position_steps - m_machineHomeReferenceSteps));
+#endif
+    torqueSampleTick();
+#if THERMAL_MODEL_ENABLED
+    thermalTick();
+#endif
+#if TORQUE_JOULES_ENABLED
+    if (m_active_op_force_mode == FORCE_MODE_MOTOR_TORQUE && m_moveState == MOVE_ACTIVE) {
+        torqueJoulesTick();
+    }
+#endif
+#if FORCE_FUSION_ENABLED
+    forceFusionTick();
+#endif
+#if STATION_IO_ENABLED
+    if (m_interlockArmed) {
+        interlockTick();
+    }
+#endif
+    telemetrySnapshotTick();
+    // First, so a trip also stops the streamed profile and the force loop this tick
+    if (m_encoderArmed) {
+        encoderCheckTick();
+    }
+    if (m_profileActive) {
+        profileTick();
+    }
+    if (m_regulateArmed) {
+        forceRegulateTick();
+    }
+    // Before the torque check, so it compares against this tick's band limit
+    if (m_zoneArmed) {
+        zoneTick();
+    }
+#if RACKING_CORRECTION_ENABLED
+    // After the zone tick, so a band's new speed is the base the trim is added to
+    if (m_rackingArmed) {
+        rackingTick();
+    }
+#endif
+    if (m_homingSpikeAxes) {
+        homingSpikeTick();
+    }
+    if (!m_tickTorqueArmed) {
+        return;
+    }
+    for (int i = 0; i < m_axisCount; i++) {
+        if (!m_tickTorqueSeeded[i] || !tickStatus(i).bit.StepsActive) {
+            continue;
+        }
+        float torque = m_tickTorque[i] + m_torqueOffset - m_tickFriction[i];
+        if (std::abs(torque) > m_torqueLimit) {
+            m_tickTorqueArmed = false;
+            m_tickTorqueTripped = true;
+            m_profileActive = false;
+            TRACE(TRACE_TORQUE_TRIP, i, torque * 10.0f);
+            if (m_tripRetractArmed) {
+                issueTripRetract();
+            } else {
+                stopAllAxes();
+            }
+            return;
+        }
     }
-    
-    m_press_threshold_kg = threshold_kg;
-    
-    // Save to NVM (byte offset 60, location 15)
-    NvmManager &nvmMgr = NvmManager::Instance();
-    int32_t bits;
-    memcpy(&bits, &threshold_kg, sizeof(float));
-    nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(15 * 4), bits);
-    
-    return true;
 }
 
 /**
- * @brief Sets the calibration offset for the current force mode.
+ * @brief Reads each motor's status register, commanded position and speed and HLFB once.
+ * @details First in controlTick(), so every check of the tick decides on the same reading,
+ * and the main loop's status checks read it rather than the drivers. Anything that turns
+ * a position into a Move() distance still reads the driver, since steps go out between ticks.
  */
-void MotorController::setForceCalibrationOffset(float offset) {
-    if (strcmp(m_force_mode, "motor_torque") == 0) {
-        // Motor torque offset (intercept of Torque% = scale * kg + offset)
-        m_motor_torque_offset = offset;
-        // Save to NVM location 6 (byte offset 24, scale by 10000 for fixed-point storage)
-        NvmManager &nvmMgr = NvmManager::Instance();
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(6 * 4), (int32_t)(offset * 10000.0f));
-    } else {
-        // Load cell offset - delegate to force sensor
-        // (force sensor handles its own NVM storage)
+void MotorController::axisSnapshotTick() {
+    for (int i = 0; i < m_axisCount; i++) {
+        MotorDriver* motor = m_motors[i];
+        volatile AxisState& axis = m_tickAxis[i];
+        axis.status_reg = motor->StatusReg().reg;
+        axis.position_steps = motor->PositionRefCommanded();
+        axis.velocity_sps = motor->VelocityRefCommanded();
+        float pct = motor->HlfbPercent();
+        axis.hlfb_pct = pct;
+#if HLFB_HIGH_RATE_ENABLED
+        // ClearCore does not count HLFB measurements: a changed duty is a new one, and a duty
+        // unchanged for HLFB_REPEAT_TICKS means the drive has measured the same duty again
+        bool fresh = (pct != m_tickHlfbLast[i]) || (++m_tickHlfbAge[i] >= HLFB_REPEAT_TICKS);
+        if (fresh) {
+            m_tickHlfbLast[i] = pct;
+            m_tickHlfbAge[i] = 0;
+        }
+        axis.hlfb_new = fresh;
+#else
+        axis.hlfb_new = true;
+#endif
     }
 }
 
 /**
- * @brief Sets the calibration scale for the current force mode.
+ * @brief Advances every motor's HLFB torque filter by one control tick.
+ * @details The only place the HLFB reading is used for torque, so the filter runs at exactly
+ * CONTROL_TICK_HZ regardless of loop rate or how many readers call getSmoothedTorque().
+ * With HLFB_HIGH_RATE_ENABLED it advances only in ticks that bring a new HLFB measurement,
+ * by the per-measurement factors, since the tick is faster than the carrier and would
+ * otherwise feed each measurement in two or three times.
+ * A motor that is idle outside an active move is unseeded; an at-position reading holds
+ * the last value. The friction torque at the commanded step rate is filtered alongside.
  */
-void MotorController::setForceCalibrationScale(float scale) {
-    if (strcmp(m_force_mode, "motor_torque") == 0) {
-        // Motor torque scale (slope of Torque% = scale * kg + offset)
-        m_motor_torque_scale = scale;
-        // Save to NVM location 5 (byte offset 20, scale by 100000 for more precision on small values)
-        NvmManager &nvmMgr = NvmManager::Instance();
-        nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(5 * 4), (int32_t)(scale * 100000.0f));
-    } else {
-        // Load cell scale - delegate to force sensor
-        // (force sensor handles its own NVM storage)
+void MotorController::torqueSampleTick() {
+    if (m_tickTorqueReseed) {
+        m_tickTorqueReseed = false;
+        for (int i = 0; i < m_axisCount; i++) {
+            m_tickTorqueSeeded[i] = false;
+        }
+    }
+    for (int i = 0; i < m_axisCount; i++) {
+        if (!tickStatus(i).bit.StepsActive && m_moveState != MOVE_ACTIVE) {
+            m_tickTorqueSeeded[i] = false;
+            continue;
+        }
+        float raw = m_tickAxis[i].hlfb_pct;
+        if (raw == TORQUE_HLFB_AT_POSITION) {
+            continue;
+        }
+#if HLFB_HIGH_RATE_ENABLED
+        if (m_tickTorqueSeeded[i] && !m_tickAxis[i].hlfb_new) {
+            continue;
+        }
+        const float alpha = HLFB_TORQUE_ALPHA;
+        const float fast_alpha = HLFB_FUSION_TORQUE_ALPHA;
+#else
+        const float alpha = CONTROL_TICK_TORQUE_ALPHA;
+        const float fast_alpha = FORCE_FUSION_TORQUE_ALPHA;
+#endif
+        float friction = frictionTorqueAt(std::abs(m_tickAxis[i].velocity_sps));
+        if (!m_tickTorqueSeeded[i]) {
+            m_tickTorque[i] = raw;
+            m_tickTorqueFast[i] = raw;
+            m_tickFriction[i] = friction;
+            m_tickTorqueSeeded[i] = true;
+        } else {
+            m_tickTorque[i] += alpha * (raw - m_tickTorque[i]);
+            m_tickTorqueFast[i] += fast_alpha * (raw - m_tickTorqueFast[i]);
+            // Same lag as the torque, so a speed change does not show up as a force step
+            m_tickFriction[i] += alpha * (friction - m_tickFriction[i]);
+        }
     }
 }
 
 /**
- * @brief Gets the calibration offset for the current force mode.
+ * @brief Queues a torque-derived force sample for updateJoules() every TORQUE_JOULES_TICK_DIVIDER ticks.
+ * @details Position is read in the same tick as the torque, so the sample needs no latency
+ * alignment. A full ring drops the sample; the integration then spans the gap as one step.
  */
-float MotorController::getForceCalibrationOffset() const {
-    if (strcmp(m_force_mode, "motor_torque") == 0) {
-        return m_motor_torque_offset;
-    } else {
-        // Return load cell offset (would need to add getter to ForceSensor)
-        return 0.0f; // Placeholder
+void MotorController::torqueJoulesTick() {
+    if (++m_torqueTickCount < TORQUE_JOULES_TICK_DIVIDER) {
+        return;
+    }
+    m_torqueTickCount = 0;
+    if (!m_tickTorqueSeeded[0]) {
+        return;
+    }
+    uint16_t next = (uint16_t)((m_torqueRingHead + 1) & (TORQUE_JOULES_RING_SIZE - 1));
+    if (next == m_torqueRingTail) {
+        return;
     }
+    TorqueForceSample& sample = m_torqueRing[m_torqueRingHead];
+    sample.time_us = Microseconds();
+    sample.position_steps = m_tickAxis[0].position_steps - m_machineHomeReferenceSteps;
+    sample.kg = torqueForceKg();
+    sample.torque_pct = m_tickTorque[0];
+    m_torqueRingHead = next;
 }
 
 /**
- * @brief Gets the calibration scale for the current force mode.
+ * @brief Advances the fused force estimate by one control tick.
+ * @details A complementary filter: the torque model (fast torque filter, friction removed)
+ * supplies every change faster than the bias follows, and each load-cell sample corrects
+ * the bias by FORCE_FUSION_BIAS_ALPHA of its residual against the torque-model force of
+ * the tick it was acquired in, so the cell's latency does not read as bias. The torque
+ * model's offset and friction error cancel in the bias; a wrong set_force_scale only
+ * shows in how far a fast change overshoots before the next samples pull it back.
+ * The estimate restarts whenever torque sampling does (each move).
  */
-float MotorController::getForceCalibrationScale() const {
-    if (strcmp(m_force_mode, "motor_torque") == 0) {
-        return m_motor_torque_scale;
-    } else {
-        // Return load cell scale (would need to add getter to ForceSensor)
-        return 1.0f; // Placeholder
+void MotorController::forceFusionTick() {
+    if (!m_tickTorqueSeeded[0]) {
+        m_fusionCount = 0;
+        m_fusionSamples = 0;
+        m_fusedKg = 0.0f;
+        return;
+    }
+    float torque_sum = 0.0f;
+    for (int i = 0; i < m_axisCount; i++) {
+        torque_sum += m_tickTorqueFast[i] + m_torqueOffset - m_tickFriction[i];
+    }
+    float torque_kg = (torque_sum / (float)m_axisCount - m_motor_torque_offset) / m_motor_torque_scale;
+    m_fusionHistory[m_fusionHead] = torque_kg;
+    m_fusionHead = (uint16_t)((m_fusionHead + 1) & (FORCE_FUSION_HISTORY - 1));
+    if (m_fusionCount < FORCE_FUSION_HISTORY) {
+        m_fusionCount++;
+    }
+
+    ForceSensor& primary = primaryForceSensor();
+    uint32_t sample_us = primary.getLastSampleTimeUs();
+    if (sample_us != m_fusionLastSampleUs) {
+        m_fusionLastSampleUs = sample_us;
+        uint32_t age_ticks = (Microseconds() - sample_us + primary.getLatencyUs()) / (1000000u / CONTROL_TICK_HZ);
+        if (age_ticks < m_fusionCount) {
+            float residual = getSelectedForce() - m_fusionHistory[(m_fusionHead + FORCE_FUSION_HISTORY - 1 - age_ticks) & (FORCE_FUSION_HISTORY - 1)];
+            m_fusionBias = (m_fusionSamples == 0) ? residual : m_fusionBias + FORCE_FUSION_BIAS_ALPHA * (residual - m_fusionBias);
+            if (m_fusionSamples < UINT16_MAX) {
+                m_fusionSamples++;
+            }
+        }
+    }
+    if (m_fusionSamples == 0) {
+        m_fusedKg = 0.0f;
+        return;
+    }
+    float fused_kg = torque_kg + m_fusionBias;
+    m_fusedKg = fused_kg;
+
+    if (m_fusionTripArmed && m_fusionSamples >= FORCE_FUSION_MIN_SAMPLES &&
+        fused_kg >= m_active_op_force_limit_kg &&
+        getSelectedForce() >= m_active_op_force_limit_kg * FORCE_FUSION_TRIP_FRACTION) {
+        m_fusionTripArmed = false;
+        m_fusionTripKg = fused_kg;
+        m_fusionTripped = true;
+        TRACE(TRACE_FUSION_TRIP, m_forceChannel, fused_kg * 10.0f);
+        HIL_MARK(HIL_SIGNAL_FORCE_CROSS);
+        uint32_t sample_us = primaryForceSensor().getLastSampleTimeUs();
+        forceTripHook(this);
+        m_fusionTripLatencyUs = Microseconds() - sample_us;
     }
 }
 
+#if THERMAL_MODEL_ENABLED
 /**
- * @brief Commands a synchronized move on both motors.
+ * @brief Feeds each motor's smoothed HLFB torque to its thermal model.
+ * @details Runs in interrupt context after torqueSampleTick(). A motor outside a move
+ * (filter unseeded) counts as unloaded; an at-position reading inside one keeps the last
+ * torque, so a held force keeps heating.
  */
-void MotorController::startMove(long steps, int velSps, int accelSps2) {
-    m_firstTorqueReading0 = true;
-    m_firstTorqueReading1 = true;
-
-    char logMsg[128];
-    snprintf(logMsg, sizeof(logMsg), "startMove called: steps=%ld, vel=%d, accel=%d, torque=%.1f", steps, velSps, accelSps2, m_torqueLimit);
-    reportEvent(STATUS_PREFIX_INFO, logMsg);
-
-    if (steps == 0) {
-        reportEvent(STATUS_PREFIX_INFO, "startMove called with 0 steps. No move will occur.");
-        return;
+void MotorController::thermalTick() {
+    for (int i = 0; i < m_axisCount; i++) {
+        m_thermal[i].tick(m_tickTorqueSeeded[i] ? std::abs(m_tickTorque[i]) : 0.0f);
     }
+}
 
-    m_motorA->VelMax(velSps);
-    m_motorA->AccelMax(accelSps2);
-    m_motorB->VelMax(velSps);
-    m_motorB->AccelMax(accelSps2);
-
-    m_motorA->Move(steps);
-    m_motorB->Move(steps);
+float MotorController::getThermalLoadPct(int* axis) const {
+    int hottest = 0;
+    float load_pct = m_thermal[0].getLoadPct();
+    for (int i = 1; i < m_axisCount; i++) {
+        if (m_thermal[i].getLoadPct() > load_pct) {
+            load_pct = m_thermal[i].getLoadPct();
+            hottest = i;
+        }
+    }
+    if (axis) {
+        *axis = hottest;
+    }
+    return load_pct;
 }
 
 /**
- * @brief Checks if either of the motors are currently active.
+ * @brief Reports thermal warnings and holds new presses while the hottest motor is over
+ * THERMAL_LIMIT_PCT, until it cools below THERMAL_RESUME_PCT.
+ * @details A press already running is never cut short; the limit sits below the drive's own
+ * foldback, so the margin covers the rest of a cycle.
  */
-bool MotorController::isMoving() {
-    if (!m_isEnabled) return false;
-    bool m0_moving = m_motorA->StatusReg().bit.StepsActive;
-    bool m1_moving = m_motorB->StatusReg().bit.StepsActive;
-    return (m0_moving || m1_moving);
+void MotorController::serviceThermal() {
+    int axis = 0;
+    float load_pct = getThermalLoadPct(&axis);
+    char msg[STATUS_MESSAGE_BUFFER_SIZE];
+    if (!m_thermalHold && load_pct >= THERMAL_LIMIT_PCT) {
+        m_thermalHold = true;
+        m_thermalWarned = true;
+        snprintf(msg, sizeof(msg), "Motor thermal limit: M%d at %.0f%%. New presses wait until it cools below %.0f%%.",
+                 axis, load_pct, THERMAL_RESUME_PCT);
+        reportEvent(STATUS_PREFIX_INFO, msg);
+    } else if (!m_thermalWarned && load_pct >= THERMAL_WARN_PCT) {
+        m_thermalWarned = true;
+        snprintf(msg, sizeof(msg), "Motor thermal load high: M%d at %.0f%% of its continuous rating.", axis, load_pct);
+        reportEvent(STATUS_PREFIX_INFO, msg);
+    } else if (load_pct < THERMAL_RESUME_PCT && (m_thermalHold || m_thermalWarned)) {
+        if (m_thermalHold) {
+            snprintf(msg, sizeof(msg), "Motors cooled to %.0f%%. Presses accepted again.", load_pct);
+            reportEvent(STATUS_PREFIX_INFO, msg);
+        }
+        m_thermalHold = false;
+        m_thermalWarned = false;
+    }
 }
+#endif
 
+#if STATION_IO_ENABLED
 /**
- * @brief Gets a smoothed torque value from a motor using an EWMA filter.
- * @details During active moves, holds the last non-zero value to prevent telemetry spikes when 
- * HLFB briefly reads at-position during slow moves.
+ * @brief Stops a running recipe in the tick its station interlock opens.
+ * @details Runs in interrupt context after the station I/O hook, so the check uses this
+ * tick's CCIO-8 snapshot. Disarms itself once the queue has ended; updateState() reports the
+ * trip and ends the run.
  */
-float MotorController::getSmoothedTorque(MotorDriver *motor, float *smoothedValue, bool *firstRead) {
-    // If motor not moving AND we're not in an active move state, reset
-    if (!motor->StatusReg().bit.StepsActive && m_moveState != MOVE_ACTIVE) {
-        *firstRead = true; // Reset for the next move
-        return 0.0f;
+void MotorController::interlockTick() {
+    if (!m_motionQueueRunning) {
+        m_interlockArmed = false;
+        return;
     }
+    uint32_t faults = g_stationIo.getInterlockFaults();
+    if (!faults) {
+        return;
+    }
+    m_interlockArmed = false;
+    m_interlockInputs = g_stationIo.getInputs();
+    m_interlockFaults = faults;
+    m_profileActive = false;
+    m_regulateArmed = false;
+    stopAllAxes();
+    m_interlockTripped = true;
+    HIL_MARK(HIL_SIGNAL_STOP);
+}
+#endif
 
-    float currentRawTorque = motor->HlfbPercent();
-
-    // The driver may return the sentinel value if a reading is not available yet
-    // During active moves, hold the last good value instead of returning 0
-    if (currentRawTorque == TORQUE_HLFB_AT_POSITION) {
-        // If we're in an active move, return last smoothed value (hold)
-        if (m_moveState == MOVE_ACTIVE && !*firstRead) {
-            return *smoothedValue + m_torqueOffset;
-        }
-        // Otherwise return 0 (no torque available yet)
-        return 0.0f;
+/**
+ * @brief Writes this tick's measured telemetry fields into the back snapshot and swaps it
+ * to the front.
+ * @details Runs after the load-cell receive hook and the torque and fusion filters, so the
+ * forces, torque and position are all of the same tick.
+ */
+void MotorController::telemetrySnapshotTick() {
+    uint8_t back = (uint8_t)(m_telemetryFront ^ 1u);
+    TelemetrySnapshot& snap = m_telemetrySnapshots[back];
+    snap.time_us = Microseconds();
+    snap.position_mm = homeRelative(m_tickAxis[0].position_steps).value;
+    float torque_sum = 0.0f;
+    for (int i = 0; i < m_axisCount; i++) {
+        torque_sum += getSmoothedTorque(i);
     }
+    snap.torque_avg = torque_sum / (float)m_axisCount;
+    snap.force_motor_torque = torqueForceKg();
+    snap.force_fused = getFusedForce();
 
-    if (*firstRead) {
-        *smoothedValue = currentRawTorque;
-        *firstRead = false;
+    ForceSensor& sensor_a = m_controller->m_forceSensor;
+    ForceSensor& sensor_b = m_controller->m_forceSensorB;
+    if (m_forceChannel == FORCE_CHANNEL_SUM && sensor_a.isConnected() && sensor_b.isConnected()) {
+        snap.force_load_cell = getSummedForce();
+        snap.force_adc_raw = (int32_t)sensor_a.getFilteredRawValue();
+    } else if (m_forceChannel == FORCE_CHANNEL_B && sensor_b.isConnected()) {
+        snap.force_load_cell = sensor_b.getFilteredForce();
+        snap.force_adc_raw = (int32_t)sensor_b.getFilteredRawValue();
+    } else if (m_forceChannel == FORCE_CHANNEL_A && sensor_a.isConnected()) {
+        // Telemetry shows the transducer-filtered channel; limits use the fast one
+        snap.force_load_cell = sensor_a.getFilteredForce();
+        snap.force_adc_raw = (int32_t)sensor_a.getFilteredRawValue();
     } else {
-        *smoothedValue = EWMA_ALPHA_TORQUE * currentRawTorque + (1.0f - EWMA_ALPHA_TORQUE) * (*smoothedValue);
+        snap.force_load_cell = 0.0f;
+        snap.force_adc_raw = 0;
     }
-    return *smoothedValue + m_torqueOffset;
+    snap.home_sensor_m0 = getHomeSensorActive(0) ? 1 : 0;
+    snap.home_sensor_m1 = (m_axisCount > 1 && getHomeSensorActive(1)) ? 1 : 0;
+
+    m_telemetrySeq = m_telemetrySeq + 1;
+    m_telemetryFront = back;
 }
 
 /**
- * @brief Checks if the torque on either motor has exceeded the current limit.
- * @details Just checks and returns true/false. Does NOT abort move or report.
- * The caller is responsible for handling the limit being reached.
+ * @brief Copies the latest completed telemetry snapshot. Main loop only.
+ * @details The tick only writes the back snapshot, so a copy of the front one is torn only
+ * if two ticks complete during it; the copy is then retried.
  */
-bool MotorController::checkTorqueLimit() {
-    if (isMoving()) {
-        float torque0 = getSmoothedTorque(m_motorA, &m_smoothedTorqueValue0, &m_firstTorqueReading0);
-        float torque1 = getSmoothedTorque(m_motorB, &m_smoothedTorqueValue1, &m_firstTorqueReading1);
-
-        bool m0_over_limit = (torque0 != TORQUE_HLFB_AT_POSITION && std::abs(torque0) > m_torqueLimit);
-        bool m1_over_limit = (torque1 != TORQUE_HLFB_AT_POSITION && std::abs(torque1) > m_torqueLimit);
+void MotorController::readTelemetrySnapshot(TelemetrySnapshot* out) const {
+    uint32_t seq;
+    do {
+        seq = m_telemetrySeq;
+        *out = m_telemetrySnapshots[m_telemetryFront];
+    } while (m_telemetrySeq - seq > 1u);
+}
 
-        if (m0_over_limit || m1_over_limit) {
-            return true;
+/**
+ * @brief Force regulator step, run from controlTick() once per new load-cell sample.
+ * @details The approach Move() runs unchanged until the PI output drops below the move's
+ * speed, i.e. the force is within v/Kp of the target. From then on the tick commands
+ * MoveVelocity() on both axes, backing off as well as advancing. The integral only
+ * accumulates while the output is not saturated. Faults stop the axes and are latched in
+ * m_regulateFault for serviceForceRegulation() to report.
+ */
+void MotorController::forceRegulateTick() {
+    uint32_t sample_us = primaryForceSensor().getLastSampleTimeUs();
+    if (sample_us == m_regulateLastSampleUs) {
+        return;
+    }
+    float dt = (float)(sample_us - m_regulateLastSampleUs) / 1000000.0f;
+    m_regulateLastSampleUs = sample_us;
+    if (dt > FORCE_REGULATE_MAX_DT_S) {
+        dt = FORCE_REGULATE_MAX_DT_S;
+    }
+    
+    float target = m_active_op_force_limit_kg;
+    float force = getSelectedForce();
+    if (force > target * FORCE_REGULATE_OVERFORCE_FACTOR) {
+        m_regulateArmed = false;
+        m_regulateFault = REGULATE_FAULT_OVERFORCE;
+        stopAllAxes();
+        return;
+    }
+    
+    float error = target - force;
+    m_regulateErrorKg = error;
+    float vmax = m_regulateMaxMms;
+    if (!m_regulateVelocityMode) {
+        // Stay on the approach move while far from the target, or once it has run out
+        if (FORCE_REGULATE_KP_MMS_PER_KG * error >= vmax || !tickStatus(0).bit.StepsActive) {
+            return;
         }
+        m_regulateVelocityMode = true;
+    }
+    
+    float integral = m_regulateIntegral + FORCE_REGULATE_KI_MMS_PER_KGS * error * dt;
+    float out = FORCE_REGULATE_KP_MMS_PER_KG * error + integral;
+    if (out > vmax) {
+        out = vmax;
+    } else if (out < -vmax) {
+        out = -vmax;
+    } else {
+        m_regulateIntegral = integral;
+    }
+    
+    long past_limit = (m_tickAxis[0].position_steps - m_regulateLimitSteps) * m_regulateDir;
+    if (past_limit >= 0 && out > 0.0f) {
+        m_regulateArmed = false;
+        m_regulateFault = REGULATE_FAULT_OVERTRAVEL;
+        stopAllAxes();
+        return;
+    }
+    
+    int velocity_sps = toStepsPerSec(MmPerSec(m_regulateDir * out)).value;
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->MoveVelocity(velocity_sps);
     }
-    return false;
 }
 
 /**
- * @brief Handles the logic when a force or torque limit is reached during a move.
- * @param limit_type Description of what limit was reached (e.g., "Force limit (100 kg)" or "Torque limit (3.9%)")
- * @param limit_value The actual limit value reached
+ * @brief Main-loop side of the force regulator for the active move.
+ * @details Reports when the force first settles inside the tolerance band and ends the
+ * hold after m_regulateDwellMs; the move then completes (DONE or next queued segment)
+ * through the normal completion path once the axes have stopped. Regulator faults end
+ * the move with an ERROR.
+ * @return true if the move was ended with an error (caller returns from updateState())
  */
-void MotorController::handleLimitReached(const char* limit_type, float limit_value) {
-    abortMove();
-    m_jouleIntegrationActive = false;
-    m_forceLimitTriggered = true;
-    m_prevForceValid = false;
-    
-    // Record endpoint where force limit was reached (only for press moves, not retracts)
-    if (m_activeMoveCommand && 
-        (strcmp(m_activeMoveCommand, "move_abs") == 0 || strcmp(m_activeMoveCommand, "move_inc") == 0)) {
-        long current_pos_steps = m_motorA->PositionRefCommanded();
-        m_endpoint_mm = static_cast<float>(static_cast<double>(current_pos_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM);
+bool MotorController::serviceForceRegulation() {
+    uint8_t fault = m_regulateFault;
+    if (fault == REGULATE_FAULT_NONE && !m_regulateArmed) {
+        // Hold finished; waiting for the axes to stop
+        return false;
+    }
+    if (fault == REGULATE_FAULT_NONE && !m_regulateVelocityMode && !isMoving()) {
+        // Approach move ran to its end position without getting near the target
+        abortMove();
+        fault = REGULATE_FAULT_OVERTRAVEL;
     }
     
-    char msg[STATUS_MESSAGE_BUFFER_SIZE];
-    snprintf(msg, sizeof(msg), "%s reached.", limit_type);
-    reportEvent(STATUS_PREFIX_INFO, msg);
-    
-    // Handle action based on force_action parameter
-    if (strcmp(m_active_op_force_action, "retract") == 0) {
-        // Force limit reached - send INFO, will send DONE when retract completes
-        reportEvent(STATUS_PREFIX_INFO, "Force limit reached, retracting...");
-        
-        // Store the original command name before we change to "retract"
-        m_originalMoveCommand = m_activeMoveCommand;
-        
-        // Use home position (0mm) as default if retract position not explicitly set
-        long retract_target = (m_retractReferenceSteps == LONG_MIN) ? m_machineHomeReferenceSteps : m_retractReferenceSteps;
-        
-        // CRITICAL: Clear force_action to prevent infinite retract loop
-        m_active_op_force_action[0] = '\0';
-        
-        // Start retract move
-        m_moveState = MOVE_TO_HOME;
-        m_activeMoveCommand = "retract";
-        m_active_op_target_position_steps = retract_target;
-        long current_pos = m_motorA->PositionRefCommanded();
-        long steps_to_retract = retract_target - current_pos;
-        m_torqueLimit = DEFAULT_TORQUE_LIMIT;
-        float speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
-        if (speed_mms > 100.0f) {
-            speed_mms = 100.0f;
-        }
-        int velocity_sps = static_cast<int>(speed_mms * STEPS_PER_MM);
-        m_active_op_velocity_sps = velocity_sps;
-        m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
-        startMove(steps_to_retract, velocity_sps, m_moveDefaultAccelSPS2);
-        reportEvent(STATUS_PREFIX_START, "retract");
-    } else if (strcmp(m_active_op_force_action, "abort") == 0) {
-        // Send ERROR for the original command to halt script, then start retract
-        if (m_activeMoveCommand) {
-            char error_msg[STATUS_MESSAGE_BUFFER_SIZE];
-            snprintf(error_msg, sizeof(error_msg), "%s aborted due to force limit", m_activeMoveCommand);
-            reportEvent(STATUS_PREFIX_ERROR, error_msg);
+    uint32_t now = Milliseconds();
+    if (fault == REGULATE_FAULT_NONE && m_regulateVelocityMode) {
+        if (m_regulateContactAt == 0) {
+            m_regulateContactAt = now ? now : 1;
         }
-        
-        // Use home position (0mm) as default if retract position not explicitly set
-        long retract_target = (m_retractReferenceSteps == LONG_MIN) ? m_machineHomeReferenceSteps : m_retractReferenceSteps;
-        
-        // CRITICAL: Clear force_action to prevent infinite retract loop
-        m_active_op_force_action[0] = '\0';
-        
-        // Start retract move
-        m_moveState = MOVE_TO_HOME;
-        m_activeMoveCommand = "retract";
-        m_active_op_target_position_steps = retract_target;
-        long current_pos = m_motorA->PositionRefCommanded();
-        long steps_to_retract = retract_target - current_pos;
-        m_torqueLimit = DEFAULT_TORQUE_LIMIT;
-        float speed_mms = (m_retractSpeedMms > 0.0f) ? m_retractSpeedMms : RETRACT_DEFAULT_SPEED_MMS;
-        if (speed_mms > 100.0f) {
-            speed_mms = 100.0f;
-        }
-        int velocity_sps = static_cast<int>(speed_mms * STEPS_PER_MM);
-        m_active_op_velocity_sps = velocity_sps;
-        m_active_op_accel_sps2 = m_moveDefaultAccelSPS2;
-        startMove(steps_to_retract, velocity_sps, m_moveDefaultAccelSPS2);
-        reportEvent(STATUS_PREFIX_START, "retract");
-    } else if (strcmp(m_active_op_force_action, "skip") == 0) {
-        // Skip the rest of the move - complete at current position and send DONE
-        if (m_activeMoveCommand) {
-            reportEvent(STATUS_PREFIX_DONE, m_activeMoveCommand);
+        float target = m_active_op_force_limit_kg;
+        float tolerance = target * FORCE_REGULATE_TOLERANCE_PCT / 100.0f;
+        if (tolerance < FORCE_REGULATE_TOLERANCE_KG) {
+            tolerance = FORCE_REGULATE_TOLERANCE_KG;
         }
-        finalizeAndResetActiveMove(true);
-        m_state = STATE_STANDBY;
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        if (m_regulateSettledAt == 0) {
+            if (std::abs(m_regulateErrorKg) <= tolerance) {
+                m_regulateSettledAt = now ? now : 1;
+                g_cycleTiming.dwell(Microseconds());
+                snprintf(msg, sizeof(msg), "Force regulated at %.1f kg (target %.1f kg), holding %lu ms",
+                         target - m_regulateErrorKg, target, (unsigned long)m_regulateDwellMs);
+                reportEvent(STATUS_PREFIX_INFO, msg);
+            } else if (now - m_regulateContactAt > FORCE_REGULATE_SETTLE_TIMEOUT_MS) {
+                abortMove();
+                snprintf(msg, sizeof(msg), "%s stopped: force did not settle at %.1f kg (actual: %.1f kg)",
+                         m_activeMoveCommand ? m_activeMoveCommand : "move", target, target - m_regulateErrorKg);
+                reportEvent(STATUS_PREFIX_ERROR, msg);
+                finalizeAndResetActiveMove(false);
+                m_state = STATE_STANDBY;
+                return true;
+            }
+        } else if (now - m_regulateSettledAt >= m_regulateDwellMs) {
+            abortMove();
+            snprintf(msg, sizeof(msg), "Force hold complete (%.1f kg for %lu ms)", target - m_regulateErrorKg,
+                     (unsigned long)m_regulateDwellMs);
+            reportEvent(STATUS_PREFIX_INFO, msg);
+        }
+        return false;
+    }
+    if (fault == REGULATE_FAULT_NONE) {
+        return false;
+    }
+    
+    char msg[STATUS_MESSAGE_BUFFER_SIZE];
+    if (fault == REGULATE_FAULT_OVERFORCE) {
+        snprintf(msg, sizeof(msg), "%s stopped: force overshoot above %.1f kg while regulating to %.1f kg",
+                 m_activeMoveCommand ? m_activeMoveCommand : "move",
+                 m_active_op_force_limit_kg * FORCE_REGULATE_OVERFORCE_FACTOR, m_active_op_force_limit_kg);
     } else {
-        // "hold" action - pause and wait for user
-        m_moveState = MOVE_PAUSED;
+        snprintf(msg, sizeof(msg), "%s stopped: end position reached before holding %.1f kg",
+                 m_activeMoveCommand ? m_activeMoveCommand : "move", m_active_op_force_limit_kg);
     }
+    reportEvent(STATUS_PREFIX_ERROR, msg);
+    finalizeAndResetActiveMove(false);
+    m_state = STATE_STANDBY;
+    return true;
 }
 
 /**
@@ -1920,14 +4747,18 @@ void MotorController::handleLimitReached(const char* limit_type, float limit_val
  * @return true if there's an error, false if force sensor is OK
  */
 bool MotorController::checkForceSensorStatus(const char** errorMsg) {
-    // Check if force sensor is connected
-    if (!m_controller->m_forceSensor.isConnected()) {
-        *errorMsg = "Force sensor disconnected";
+    // Check that every selected load cell is connected
+    if (m_forceChannel != FORCE_CHANNEL_B && !m_controller->m_forceSensor.isConnected()) {
+        *errorMsg = (m_forceChannel == FORCE_CHANNEL_SUM) ? "Force sensor A disconnected" : "Force sensor disconnected";
+        return true;
+    }
+    if (m_forceChannel != FORCE_CHANNEL_A && !m_controller->m_forceSensorB.isConnected()) {
+        *errorMsg = (m_forceChannel == FORCE_CHANNEL_SUM) ? "Force sensor B disconnected" : "Force sensor disconnected";
         return true;
     }
     
     // Check force reading validity
-    float force = m_controller->m_forceSensor.getForce();
+    float force = getSelectedForce();
     
     if (force < FORCE_SENSOR_MIN_KG) {
         *errorMsg = "Force sensor error: reading below minimum (-10 kg)";
@@ -1938,8 +4769,130 @@ bool MotorController::checkForceSensorStatus(const char** errorMsg) {
         *errorMsg = "Force sensor error: reading above maximum (1440 kg)";
         return true;
     }
-    
-    return false;
+    
+    return false;
+}
+
+/**
+ * @brief Reports DONE for a finished move, followed by the press metrics when load-cell
+ * samples were taken (e.g. "move_abs peak_kg=412.50 peak_mm=38.214 ..."), the phase
+ * times of the cycle (e.g. "... start_ms=3.2 approach_ms=812.5 ... cycle_ms=2210.4") and
+ * its runtime statistics (e.g. "... loop_max_us=1840 age_max_us=13020 samples=176 dropped=0").
+ * @param command Command name the DONE belongs to
+ */
+void MotorController::reportMoveDone(const char* command) {
+    if (command == kRunRecipeCommand) {
+        m_recipeDoneCount++;
+    }
+    bool timed = g_cycleTiming.finish(Microseconds());
+    // A timed cycle is a press; a standalone retract is not counted
+    if (timed) {
+        g_productionCounters.addCycle(m_energy.getJoules(), g_pressMetrics.getPeakKg(), g_pressMetrics.hasData());
+    }
+    if (!g_pressMetrics.hasData() && !timed) {
+        reportEvent(STATUS_PREFIX_DONE, command);
+        return;
+    }
+    // Metrics, phase times and runtime statistics together run past STATUS_MESSAGE_BUFFER_SIZE
+    char msg[384];
+    if (timed && command == kRunRecipeCommand && g_cycleEstimate.isValid()) {
+        // Ahead of DONE, which ends the host's request
+        int prefix = snprintf(msg, sizeof(msg), "%s ", command);
+        g_cycleEstimate.formatComparison(g_cycleTiming, msg + prefix, sizeof(msg) - prefix);
+        reportEvent(STATUS_PREFIX_INFO, msg);
+    }
+    int len = snprintf(msg, sizeof(msg), "%s", command);
+    if (g_pressMetrics.hasData() && len > 0 && (size_t)len + 1 < sizeof(msg)) {
+        msg[len++] = ' ';
+        len += g_pressMetrics.format(msg + len, sizeof(msg) - len);
+    }
+    if (timed && len > 0 && (size_t)len + 1 < sizeof(msg)) {
+        msg[len++] = ' ';
+        len += g_cycleTiming.format(msg + len, sizeof(msg) - len);
+    }
+    if (timed && len > 0 && (size_t)len + 1 < sizeof(msg)) {
+        msg[len++] = ' ';
+        formatMoveStats(msg + len, sizeof(msg) - len);
+    }
+    reportEvent(STATUS_PREFIX_DONE, msg);
+}
+
+/**
+ * @brief Starts the runtime statistics of a press cycle, alongside g_cycleTiming.begin().
+ */
+void MotorController::beginMoveStats() {
+    memset(&m_moveStats, 0, sizeof(m_moveStats));
+    m_moveStats.pass_us = Microseconds();
+    m_moveStats.dropped_base = droppedSampleCount();
+}
+
+/**
+ * @brief Folds this updateState() pass into the cycle's runtime statistics.
+ * @details Runs right after the drain, so the sample age is that of the newest sample the
+ * load-cell limit check of this pass sees. The sample time is read before the clock, as the
+ * receive ISR may deliver a newer one in between.
+ */
+void MotorController::updateMoveStats() {
+    if (!g_cycleTiming.isActive()) {
+        return;
+    }
+    uint32_t sample_us = primaryForceSensor().getLastSampleTimeUs();
+    uint32_t now_us = Microseconds();
+    uint32_t period_us = now_us - m_moveStats.pass_us;
+    m_moveStats.pass_us = now_us;
+    if (period_us > m_moveStats.loop_max_us) {
+        m_moveStats.loop_max_us = period_us;
+    }
+    m_moveStats.samples += m_forceBatchCount;
+    if (m_state == STATE_MOVING && m_moveState == MOVE_ACTIVE && m_active_op_force_mode == FORCE_MODE_LOAD_CELL &&
+        sample_us != 0 && now_us - sample_us > m_moveStats.age_max_us) {
+        m_moveStats.age_max_us = now_us - sample_us;
+    }
+}
+
+/**
+ * @brief Records the latency of the cycle's first force trip.
+ * @param latency_us Crossing sample's arrival until the stop was issued
+ */
+void MotorController::recordTripLatency(uint32_t latency_us) {
+    if (!m_moveStats.tripped && g_cycleTiming.isActive()) {
+        m_moveStats.trip_us = latency_us;
+        m_moveStats.tripped = true;
+    }
+}
+
+/**
+ * @brief Appends the cycle's runtime statistics as key=value pairs, for the DONE event.
+ * @details trip_us is only present when a force limit tripped in the cycle.
+ * @param buffer Output buffer
+ * @param size Size of @p buffer
+ * @return Characters written (as snprintf)
+ */
+int MotorController::formatMoveStats(char* buffer, size_t size) const {
+    int len = snprintf(buffer, size, "loop_max_us=%lu age_max_us=%lu samples=%lu dropped=%lu",
+                       (unsigned long)m_moveStats.loop_max_us, (unsigned long)m_moveStats.age_max_us,
+                       (unsigned long)m_moveStats.samples,
+                       (unsigned long)(droppedSampleCount() - m_moveStats.dropped_base));
+    if (m_moveStats.tripped && len > 0 && (size_t)len < size) {
+        len += snprintf(buffer + len, size - len, " trip_us=%lu", (unsigned long)m_moveStats.trip_us);
+    }
+    return len;
+}
+
+/**
+ * @brief Counts the load-cell samples lost so far on the selected channel: sequence gaps
+ * in the frames and samples dropped by a full ring (both cells on the summed channel).
+ * @return Lost samples since boot (wraps)
+ */
+uint32_t MotorController::droppedSampleCount() const {
+    const ForceSensor& primary = primaryForceSensor();
+    uint32_t dropped = primary.getDroppedSamples() + primary.getRingOverruns();
+    if (m_forceChannel == FORCE_CHANNEL_SUM) {
+        const ForceSensor& other = (&primary == &m_controller->m_forceSensor) ? m_controller->m_forceSensorB
+                                                                             : m_controller->m_forceSensor;
+        dropped += other.getDroppedSamples() + other.getRingOverruns();
+    }
+    return dropped;
 }
 
 /**
@@ -1950,6 +4903,9 @@ void MotorController::finalizeAndResetActiveMove(bool success) {
         // With the new polling logic in updateState, m_active_op_total_distance_mm should be up-to-date.
         m_last_completed_distance_mm = m_active_op_total_distance_mm;
         m_cumulative_distance_mm += m_active_op_total_distance_mm;
+        g_productionCounters.addTravel(m_active_op_total_distance_mm);
+    } else {
+        g_cycleTiming.cancel();
     }
     fullyResetActiveMove();
 }
@@ -1958,10 +4914,27 @@ void MotorController::finalizeAndResetActiveMove(bool success) {
  * @brief Resets all variables related to an active move operation.
  */
 void MotorController::fullyResetActiveMove() {
+    m_pausedMoveState = MOVE_NONE;
+    m_pausedApproachRapid = false;
+    m_controller->m_forceSensor.disarmTrip();
+    m_controller->m_forceSensorB.disarmTrip();
+    m_fusionTripArmed = false;
+    m_fusionTripped = false;
+    m_tickTorqueArmed = false;
+    m_tickTorqueTripped = false;
+    m_regulateArmed = false;
+    m_forceRegulate = false;
+    m_adaptiveStep = -1;
+    m_approachRapid = false;
+    m_rapidActive = false;
+    m_tripRetractArmed = false;
+    m_tripRetractIssued = false;
+    m_profileActive = false;
+    m_profiledMove = false;
     m_active_op_force_limit_kg = 0.0f;
-    m_active_op_force_action[0] = '\0';
-    strncpy(m_active_op_force_mode, "motor_torque", sizeof(m_active_op_force_mode) - 1);
-    m_active_op_force_mode[sizeof(m_active_op_force_mode) - 1] = '\0';
+    m_active_op_force_limit_counts = INT32_MAX;
+    m_active_op_force_action = FORCE_ACTION_NONE;
+    m_active_op_force_mode = FORCE_MODE_MOTOR_TORQUE;
     m_active_op_total_distance_mm = 0.0f;
     m_last_completed_distance_mm = 0.0f;
     m_active_op_total_target_steps = 0;
@@ -1973,17 +4946,71 @@ void MotorController::fullyResetActiveMove() {
     m_originalMoveCommand = nullptr;
     m_jouleIntegrationActive = false;
     m_forceLimitTriggered = false;
-    m_prevForceValid = false;
-    m_machineStrainBaselinePosMm = 0.0;
-    m_prevMachineDeflectionMm = 0.0;
-    m_prevTotalDeflectionMm = 0.0;
-    m_machineEnergyJ = 0.0;
-    m_machineStrainContactActive = false;
+    m_energy.invalidate();
+    m_seatArmed = false;
+    m_seatDetected = false;
+    m_envelopeArmed = false;
+    m_envelopeTripped = false;
+    m_zoneArmed = false;
+    m_zoneCount = 0;
+    m_energy.clearContact();
+}
+
+/**
+ * @brief Drains the load-cell sample FIFO into m_forceBatch for this pass.
+ * @details Always drains, even when not moving, so the FIFO never backs up.
+ */
+void MotorController::drainForceSamples() {
+    ForceSensor& primary = primaryForceSensor();
+    ForceSensor& secondary = (&primary == &m_controller->m_forceSensor) ? m_controller->m_forceSensorB
+                                                                       : m_controller->m_forceSensor;
+    m_forceBatchCount = primary.drainSamples(m_forceBatch, FORCE_SENSOR_RX_RING_SIZE);
+    
+    uint32_t peak_us = primary.getLastSampleTimeUs();
+    int32_t peak_counts = primary.getForceCounts();
+    float peak = primary.getForce();
+    if (m_forceChannel == FORCE_CHANNEL_SUM) {
+        // Channel B arrives asynchronously; pair each A sample with B's latest reading
+        float other_kg = secondary.getForce();
+        peak += other_kg;
+        for (uint16_t i = 0; i < m_forceBatchCount; i++) {
+            m_forceBatch[i].kg += other_kg;
+        }
+    }
+    // Unused channel FIFO is dropped so it never reports overruns
+    secondary.flushSamples();
+    for (uint16_t i = 0; i < m_forceBatchCount; i++) {
+        if (m_forceBatch[i].counts > peak_counts) {
+            peak_counts = m_forceBatch[i].counts;
+            peak = m_forceBatch[i].kg;
+            peak_us = (uint32_t)m_forceBatch[i].timestamp_us;
+        }
+    }
+    m_forceBatchPeakCounts = peak_counts;
+    m_forceBatchPeakKg = peak;
+    m_forceBatchPeakUs = peak_us;
+
+#if FORCE_TRIP_PREDICT_ENABLED
+    // Rate of the (summed) force for the main-loop predictive check
+    for (uint16_t i = 0; i < m_forceBatchCount; i++) {
+        const ForceSample& sample = m_forceBatch[i];
+        if (m_forceRatePrevUs != 0 && sample.timestamp_us > m_forceRatePrevUs) {
+            float rate = (sample.kg - m_forceRatePrevKg) / (float)(sample.timestamp_us - m_forceRatePrevUs);
+            m_forceRateKgPerUs += FORCE_TRIP_PREDICT_ALPHA * (rate - m_forceRateKgPerUs);
+        }
+        m_forceRatePrevKg = sample.kg;
+        m_forceRatePrevUs = sample.timestamp_us;
+    }
+#endif
 }
 
 /**
  * @brief Updates joule counter by integrating force × distance.
- * @details Integrates at 50Hz (called every time force sensor updates).
+ * @details Integrates once per load-cell sample drained this pass. Samples share one
+ * commanded-position read, so each is placed linearly between the previous sample's
+ * position and the current one. In motor_torque mode the samples are the control tick's
+ * torque-derived forces instead, each with the position read in its own tick; machine
+ * strain compensation and the press metrics treat them like load-cell samples.
  * Energy (Joules) = Force (N) × Distance (m)
  * Force in kg needs conversion: kg × 9.81 = Newtons
  * Distance in mm needs conversion: mm × 0.001 = meters
@@ -1991,158 +5018,264 @@ void MotorController::fullyResetActiveMove() {
  */
 void MotorController::updateJoules() {
     if (!m_jouleIntegrationActive || m_state != STATE_MOVING) {
-        m_prevForceValid = false;
+        m_energy.invalidate();
+        m_torqueRingTail = m_torqueRingHead;
+#if POSITION_CURVE_ENABLED
+        // The last crossings of a press wait for the load-cell samples acquired after them
+        if (g_positionCurve.isCapturing() && m_active_op_force_mode == FORCE_MODE_LOAD_CELL) {
+            uint32_t latency_us = primaryForceSensor().getLatencyUs();
+            for (uint16_t i = 0; i < m_forceBatchCount; i++) {
+                g_positionCurve.addSample((uint32_t)(m_forceBatch[i].timestamp_us - latency_us), m_forceBatch[i].kg);
+            }
+        }
+#endif
         return;
     }
 
-    if (strcmp(m_active_op_force_mode, "motor_torque") == 0) {
+    if (m_active_op_force_mode == FORCE_MODE_MOTOR_TORQUE) {
+#if TORQUE_JOULES_ENABLED
+        uint16_t tail = m_torqueRingTail;
+        uint16_t head = m_torqueRingHead;
+        while (tail != head && m_jouleIntegrationActive) {
+            const TorqueForceSample& sample = m_torqueRing[tail];
+            g_pressCapture.add(sample.time_us, (int32_t)sample.position_steps, 0, sample.torque_pct,
+                               captureDetail(sample.position_steps, sample.kg));
+#if POSITION_CURVE_ENABLED
+            g_positionCurve.addSample(sample.time_us, sample.kg);
+#endif
+            integrateForceSample(sample.kg, sample.position_steps);
+            g_pressMetrics.add(sample.time_us, toMillimeters(Steps(sample.position_steps)).value, sample.kg,
+                               m_energy.getJoules(), m_active_op_force_limit_kg);
+            tail = (uint16_t)((tail + 1) & (TORQUE_JOULES_RING_SIZE - 1));
+        }
+        // Samples after integration stopped are dropped rather than left for the next move
+        m_torqueRingTail = m_jouleIntegrationActive ? tail : head;
+#else
         m_jouleIntegrationActive = false;
-        m_prevForceValid = false;
+        m_energy.invalidate();
+#endif
         return;
     }
     
-    long current_pos_steps = m_motorA->PositionRefCommanded();
-    double current_pos_mm = static_cast<double>(current_pos_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM;
-    double distance_mm = current_pos_mm - m_prev_position_mm;
-    double abs_distance_mm = fabs(distance_mm);
+    // Pair each sample with where the axis was when it was acquired, not when it arrived
+    uint32_t latency_us = primaryForceSensor().getLatencyUs();
+    for (uint16_t i = 0; i < m_forceBatchCount && m_jouleIntegrationActive; i++) {
+        // Low word: the position history and capture count in wrap-safe Microseconds()
+        uint32_t acquired_us = (uint32_t)(m_forceBatch[i].timestamp_us - latency_us);
+        long position_steps = positionAtTimeSteps(acquired_us);
+        g_pressCapture.add(acquired_us, (int32_t)position_steps, m_forceBatch[i].raw, m_tickTorque[0],
+                           captureDetail(position_steps, m_forceBatch[i].kg));
+#if POSITION_CURVE_ENABLED
+        g_positionCurve.addSample(acquired_us, m_forceBatch[i].kg);
+#endif
+        integrateForceSample(m_forceBatch[i].kg, position_steps);
+        seatDetectSample(position_steps, m_forceBatch[i].kg);
+        envelopeSample(position_steps, m_forceBatch[i].kg);
+        g_pressMetrics.add(acquired_us, toMillimeters(Steps(position_steps)).value, m_forceBatch[i].kg, m_energy.getJoules(),
+                           m_active_op_force_limit_kg);
+    }
+}
 
-    float raw_force_sample = m_controller->m_forceSensor.getForce();
-    if (!m_prevForceValid) {
-        m_prevForceKg = raw_force_sample;
-        if (m_prevForceKg < 0.0f) {
-            m_prevForceKg = 0.0f;
-        }
-        m_prevMachineDeflectionMm = static_cast<double>(estimateMachineDeflectionFromForce(m_prevForceKg));
-        m_prevForceValid = true;
-        m_prev_position_mm = current_pos_mm;
+/**
+ * @brief Checks one load-cell sample of a recipe move against the recipe's envelope.
+ * @details The band is an indexed lookup by position, so every sample is checked. A
+ * sample outside it stops the axes here, in the same pass it was drained, and stops the
+ * integration so later samples of the deceleration do not count; updateState() reports it.
+ * Positions outside the envelope grid are not checked.
+ * @param position_steps Axis position at acquisition (steps from home)
+ * @param force_kg Calibrated force (kg)
+ */
+void MotorController::envelopeSample(long position_steps, float force_kg) {
+    if (!m_envelopeArmed || m_envelopeTripped) {
         return;
     }
-
-    float raw_force_kg = raw_force_sample;
-    if (raw_force_kg < 0.0f) {
-        raw_force_kg = 0.0f;
+    float position_mm = toMillimeters(Steps(position_steps)).value;
+    float lower_kg;
+    float upper_kg;
+    if (!g_recipeStore.getEnvelopeBand(position_mm, &lower_kg, &upper_kg) ||
+        (force_kg >= lower_kg && force_kg <= upper_kg)) {
+        return;
     }
+    abortMove();
+    m_controller->m_forceSensor.disarmTrip();
+    m_controller->m_forceSensorB.disarmTrip();
+    m_jouleIntegrationActive = false;
+    m_envelopeArmed = false;
+    m_envelopeTripped = true;
+    m_envelopePositionMm = position_mm;
+    m_envelopeKg = force_kg;
+    m_envelopeBoundKg = (force_kg > upper_kg) ? upper_kg : lower_kg;
+}
 
-    float clamped_force_kg = raw_force_kg;
-    if (m_active_op_force_limit_kg > 0.0f && clamped_force_kg > m_active_op_force_limit_kg) {
-        clamped_force_kg = m_active_op_force_limit_kg;
-    }
+/**
+ * @brief Restarts the press capture and its free-approach decimation, and the position curve.
+ */
+void MotorController::beginCapture() {
+    m_captureDetail = false;
+    m_captureRefValid = false;
+    g_pressCapture.begin();
+#if POSITION_CURVE_ENABLED
+    // Same frame as the control tick's snapshot: commanded position from machine home
+    g_positionCurve.begin((int32_t)(m_motors[0]->PositionRefCommanded() - m_machineHomeReferenceSteps),
+                          g_driveGeometry.stepsPerMm());
+#endif
+}
 
-    if (abs_distance_mm <= 0.0) {
-        m_prev_position_mm = current_pos_mm;
-        m_prevForceKg = clamped_force_kg;
-        if (m_machineStrainContactActive) {
-            m_prevMachineDeflectionMm = static_cast<double>(estimateMachineDeflectionFromForce(clamped_force_kg));
-        } else {
-            m_prevMachineDeflectionMm = 0.0;
-        }
-        return;
+/**
+ * @brief Decides whether a capture sample is detail (full rate) or free approach (coarse).
+ * @details Detail starts, and stays on for the press, once the force reaches
+ * PRESS_CAPTURE_DETAIL_FRACTION of the press threshold or rises by more than
+ * PRESS_CAPTURE_DETAIL_SLOPE_KG_MM over one PRESS_CAPTURE_COARSE_MM step of travel.
+ * @param position_steps Axis position at acquisition (steps from home)
+ * @param force_kg Calibrated force (kg)
+ * @return true to keep the sample at full rate
+ */
+bool MotorController::captureDetail(long position_steps, float force_kg) {
+    if (m_captureDetail) {
+        return true;
+    }
+    if (force_kg >= m_press_threshold_kg * PRESS_CAPTURE_DETAIL_FRACTION) {
+        m_captureDetail = true;
+        return true;
+    }
+    if (!m_captureRefValid) {
+        m_captureRefValid = true;
+        m_captureRefKg = force_kg;
+        m_captureRefSteps = position_steps;
+        return false;
+    }
+    float moved_mm = toMillimeters(Steps(labs(position_steps - m_captureRefSteps))).value;
+    if (moved_mm >= PRESS_CAPTURE_COARSE_MM) {
+        m_captureDetail = (force_kg - m_captureRefKg) / moved_mm >= PRESS_CAPTURE_DETAIL_SLOPE_KG_MM;
+        m_captureRefKg = force_kg;
+        m_captureRefSteps = position_steps;
     }
+    return m_captureDetail;
+}
 
-    if (!m_machineStrainContactActive) {
-        // Use configurable press threshold instead of hardcoded constant
-        if (clamped_force_kg >= m_press_threshold_kg) {
-            double contact_machine_def_mm = static_cast<double>(estimateMachineDeflectionFromForce(clamped_force_kg));
-            if (contact_machine_def_mm < 0.0) {
-                contact_machine_def_mm = 0.0;
-            }
-            m_machineStrainContactActive = true;
-            m_machineStrainBaselinePosMm = current_pos_mm - contact_machine_def_mm;
-            m_prevMachineDeflectionMm = contact_machine_def_mm;
-            m_prevTotalDeflectionMm = contact_machine_def_mm;
-            m_machineEnergyJ = 0.0;
-            m_prev_position_mm = current_pos_mm;
-            m_prevForceKg = clamped_force_kg;
-            
-            // Record the press startpoint (position where threshold was crossed)
-            m_press_startpoint_mm = static_cast<float>(current_pos_mm);
-            
-            return;
-        } else {
-            m_machineStrainBaselinePosMm = current_pos_mm;
-            m_prevMachineDeflectionMm = 0.0;
-            m_prevTotalDeflectionMm = 0.0;
-            m_machineEnergyJ = 0.0;
-            m_prev_position_mm = current_pos_mm;
-            m_prevForceKg = clamped_force_kg;
+/**
+ * @brief Appends the commanded position to the history used by positionAtTimeSteps().
+ * @details Entries are at least FORCE_POSITION_HISTORY_MIN_US apart so the history always
+ * covers more than FORCE_LATENCY_US_MAX regardless of loop rate.
+ */
+void MotorController::recordPositionHistory() {
+    uint32_t now_us = Microseconds();
+    if (m_posHistoryCount > 0) {
+        uint16_t newest = (m_posHistoryHead + FORCE_POSITION_HISTORY_SIZE - 1) & (FORCE_POSITION_HISTORY_SIZE - 1);
+        if (now_us - m_posHistoryTimeUs[newest] < FORCE_POSITION_HISTORY_MIN_US) {
             return;
         }
     }
-
-    double actual_force_avg = 0.5 * static_cast<double>(m_prevForceKg + clamped_force_kg);
-    double total_deflection_mm = current_pos_mm - m_machineStrainBaselinePosMm;
-    if (total_deflection_mm < 0.0) {
-        total_deflection_mm = 0.0;
+    m_posHistoryTimeUs[m_posHistoryHead] = now_us;
+    m_posHistorySteps[m_posHistoryHead] = m_motors[0]->PositionRefCommanded();
+    m_posHistoryHead = (m_posHistoryHead + 1) & (FORCE_POSITION_HISTORY_SIZE - 1);
+    if (m_posHistoryCount < FORCE_POSITION_HISTORY_SIZE) {
+        m_posHistoryCount++;
     }
+}
 
-    // Machine strain compensation - calculate what fraction of travel is machine deflection
-    // Get estimated machine deflection at current force
-    double machine_deflection_at_force = static_cast<double>(estimateMachineDeflectionFromForce(clamped_force_kg));
-    
-    // Calculate the ratio: how much of total travel is machine deflection vs part compression
-    // If we've traveled 1mm and model says machine should deflect 0.5mm at this force,
-    // then ~50% of energy goes to machine strain
-    double machine_ratio = 0.0;
-    if (total_deflection_mm > 0.001) {  // Avoid divide by zero
-        machine_ratio = machine_deflection_at_force / total_deflection_mm;
-        // Cap ratio at 1.0 (can't be more than 100% machine)
-        if (machine_ratio > 1.0) {
-            machine_ratio = 1.0;
+/**
+ * @brief Interpolates the commanded position at a past time.
+ * @param time_us Microseconds() timestamp
+ * @return Position in steps from home; clamps to the oldest entry, and uses the live
+ *         position for times after the newest entry
+ */
+long MotorController::positionAtTimeSteps(uint32_t time_us) const {
+    long steps = m_motors[0]->PositionRefCommanded();
+    uint16_t newer = FORCE_POSITION_HISTORY_SIZE;
+    for (uint16_t n = 0; n < m_posHistoryCount; n++) {
+        uint16_t idx = (m_posHistoryHead + FORCE_POSITION_HISTORY_SIZE - 1 - n) & (FORCE_POSITION_HISTORY_SIZE - 1);
+        int32_t age_us = (int32_t)(time_us - m_posHistoryTimeUs[idx]);
+        if (age_us < 0) {
+            newer = idx;
+            steps = m_posHistorySteps[idx];  // Oldest-so-far fallback
+            continue;
         }
-        if (machine_ratio < 0.0) {
-            machine_ratio = 0.0;
+        if (newer == FORCE_POSITION_HISTORY_SIZE) {
+            break;  // Newer than every entry: live position
         }
+        // Linear interpolation between the bracketing entries, in integer steps
+        uint32_t span_us = m_posHistoryTimeUs[newer] - m_posHistoryTimeUs[idx];
+        long delta = m_posHistorySteps[newer] - m_posHistorySteps[idx];
+        long interp = m_posHistorySteps[idx];
+        if (span_us > 0) {
+            interp += (long)(((int64_t)delta * age_us) / (int64_t)span_us);
+        }
+        return interp - m_machineHomeReferenceSteps;
     }
-    
-    // DEBUG: Log ratio values to understand calibration issue
-    static uint32_t ratioDbgCounter = 0;
-    if (++ratioDbgCounter % 50 == 0) {
-        char dbg[140];
-        snprintf(dbg, sizeof(dbg), "RATIO: force=%.0f est_defl=%.4f travel=%.4f ratio=%.4f joules=%.4f", 
-                 clamped_force_kg, machine_deflection_at_force, total_deflection_mm, machine_ratio, m_joules);
-        reportEvent(STATUS_PREFIX_INFO, dbg);
-    }
+    return steps - m_machineHomeReferenceSteps;
+}
 
-    // Energy calculations - split based on machine/part ratio
-    double gross_increment = actual_force_avg * abs_distance_mm * 0.00981;
-    double machine_increment = gross_increment * machine_ratio;
-    double net_increment = gross_increment - machine_increment;
-    
-    if (net_increment < 0.0) {
-        net_increment = 0.0;
+/**
+ * @brief Integrates a single load-cell sample taken at the given position.
+ * @details PressEnergy does the arithmetic; this acts on what the sample did: the first
+ * sample at the press threshold records the startpoint and triggers the captures, and one
+ * that reaches the force limit ends the integration for the move.
+ * @param force_kg Calibrated force sample (kg)
+ * @param current_pos_steps Commanded position (steps from home) attributed to the sample
+ */
+void MotorController::integrateForceSample(float force_kg, long current_pos_steps) {
+    PressEnergyDetail detail;
+    PressEnergyDetail* want = NULL;
+#if DEBUG_LOG_ENABLED
+    // Every sample when set_debug is on; one branch otherwise
+    if (g_debugLog.isEnabled()) {
+        want = &detail;
     }
-    
-    m_joules += net_increment;
-    m_machineEnergyJ += machine_increment;
-
-    m_prev_position_mm = current_pos_mm;
-    m_prevForceKg = clamped_force_kg;
-    // Note: m_prevMachineDeflectionMm and m_prevTotalDeflectionMm are no longer used
-    // in the new approach - we calculate delta directly from force change
+#endif
+    PressEnergyStep step = m_energy.add(force_kg, current_pos_steps, m_active_op_force_limit_kg, m_press_threshold_kg,
+                                        m_machineStrain, g_driveGeometry.mmPerStep(), want);
+    switch (step) {
+        case PRESS_ENERGY_CONTACT:
+            // Record the press startpoint (position where threshold was crossed)
+            m_press_startpoint_mm = toMillimeters(Steps(current_pos_steps)).value;
+            g_pressCapture.trigger();
+#if POSITION_CURVE_ENABLED
+            g_positionCurve.trigger();
+#endif
+            g_cycleTiming.contact(Microseconds());
 
-    if (m_active_op_force_limit_kg > 0.0f && raw_force_kg >= m_active_op_force_limit_kg) {
-        m_jouleIntegrationActive = false;
-        m_forceLimitTriggered = true;
-        m_prevForceValid = false;
+            if (m_adaptiveStep >= 0) {
+                float estimate = g_recipeStore.recordContact((uint8_t)m_adaptiveStep, m_press_startpoint_mm, m_adaptiveDir);
+                char msg[STATUS_MESSAGE_BUFFER_SIZE];
+                snprintf(msg, sizeof(msg), "Recipe step %d contact at %.2f mm (learned: %.2f mm)",
+                         m_adaptiveStep + 1, m_press_startpoint_mm, estimate);
+                reportEvent(STATUS_PREFIX_INFO, msg);
+                m_adaptiveStep = -1;
+            }
+            break;
+        case PRESS_ENERGY_LIMIT:
+            m_jouleIntegrationActive = false;
+            m_forceLimitTriggered = true;
+            break;
+        default:
+            break;
+    }
+#if DEBUG_LOG_ENABLED
+    if (want != NULL && (step == PRESS_ENERGY_ADDED || step == PRESS_ENERGY_LIMIT)) {
+        g_debugLog.record(DEBUG_RECORD_STRAIN_RATIO, detail.force_kg, detail.machine_deflection_mm,
+                          detail.total_deflection_mm, detail.machine_ratio, m_energy.getJoules());
     }
+#endif
 }
 
-void MotorController::reportEvent(const char* statusType, const char* message) {
+void MotorController::reportEvent(TextView statusType, TextView message) {
     // Send message directly without adding "Motor: " prefix
     m_controller->reportEvent(statusType, message);
 }
 
+void MotorController::postEvent(StatusEventId id, EventArg arg0, EventArg arg1, EventArg arg2) {
+    m_controller->postEvent(id, arg0, arg1, arg2);
+}
+
 /**
  * @brief Updates the telemetry data structure with current motor state.
  */
-void MotorController::updateTelemetry(TelemetryData* data, ForceSensor* forceSensor) {
+void MotorController::updateTelemetry(TelemetryData* data) {
     if (data == NULL) return;
-    
-    float displayTorque0 = getSmoothedTorque(m_motorA, &m_smoothedTorqueValue0, &m_firstTorqueReading0);
-    float displayTorque1 = getSmoothedTorque(m_motorB, &m_smoothedTorqueValue1, &m_firstTorqueReading1);
-    
-    long current_pos_steps_m0 = m_motorA->PositionRefCommanded();
-    double current_pos_mm = static_cast<double>(current_pos_steps_m0 - m_machineHomeReferenceSteps) / STEPS_PER_MM;
+
+    TelemetrySnapshot snap;
+    readTelemetrySnapshot(&snap);
 
     // Use the m_isEnabled flag for telemetry, not the hardware register
     // The hardware register may lag or not reflect our intended state
@@ -2150,25 +5283,15 @@ void MotorController::updateTelemetry(TelemetryData* data, ForceSensor* forceSen
     int enabled0 = m_isEnabled ? 1 : 0;
     int enabled1 = m_isEnabled ? 1 : 0;
 
-    // Always calculate and send BOTH force values for logging
-    float avg_torque = (displayTorque0 + displayTorque1) / 2.0f;
-    
-    // Calculate force from motor torque (always available)
-    data->force_motor_torque = (avg_torque - m_motor_torque_offset) / m_motor_torque_scale;
-    if (data->force_motor_torque < 0.0f) data->force_motor_torque = 0.0f;
-    if (data->force_motor_torque > 2000.0f) data->force_motor_torque = 2000.0f;
-    
-    // Get force from load cell (if available)
-    if (forceSensor && forceSensor->isConnected()) {
-        data->force_load_cell = forceSensor->getForce();
-        data->force_adc_raw = (int32_t)forceSensor->getRawValue();
-    } else {
-        data->force_load_cell = 0.0f;
-        data->force_adc_raw = 0;
-    }
-    
+    // Always send BOTH force values for logging; motor torque has friction at the speed removed
+    data->time_us = snap.time_us;
+    data->force_motor_torque = snap.force_motor_torque;
+    data->force_fused = snap.force_fused;
+    data->force_load_cell = snap.force_load_cell;
+    data->force_adc_raw = snap.force_adc_raw;
+
     // Set force_source based on persistent force mode setting
-    data->force_source = m_force_mode;
+    data->force_source = getForceMode();
 
     // Update telemetry structure
     // Force limit should be in kg, not torque%
@@ -2177,7 +5300,7 @@ void MotorController::updateTelemetry(TelemetryData* data, ForceSensor* forceSen
         data->force_limit = m_active_op_force_limit_kg;
     } else {
         // Not moving - show max based on current force mode
-        if (strcmp(m_force_mode, "load_cell") == 0) {
+        if (m_force_mode == FORCE_MODE_LOAD_CELL) {
             data->force_limit = 1000.0f;  // Load cell mode max
         } else {
             data->force_limit = 2000.0f;  // Motor torque mode max
@@ -2185,25 +5308,25 @@ void MotorController::updateTelemetry(TelemetryData* data, ForceSensor* forceSen
     }
     data->enabled0 = enabled0;
     data->enabled1 = enabled1;
-    data->current_pos = static_cast<float>(current_pos_mm);
+    data->current_pos = snap.position_mm;
 
     // Only report retract position if we've actually captured one.
     if (m_retractReferenceSteps == LONG_MIN) {
         data->retract_pos = 0.0f;
     } else {
-        const double retract_delta_steps =
-            static_cast<double>(m_retractReferenceSteps - m_machineHomeReferenceSteps);
-        data->retract_pos = static_cast<float>(retract_delta_steps / STEPS_PER_MM);
+        data->retract_pos = homeRelative(m_retractReferenceSteps).value;
     }
     // Calculate target position in mm from stored target steps (always show, don't reset)
-    double target_pos_mm = static_cast<double>(m_active_op_target_position_steps - m_machineHomeReferenceSteps) / STEPS_PER_MM;
-    data->target_pos = static_cast<float>(target_pos_mm);
-    // Calculate average torque of both motors
-    data->torque_avg = (displayTorque0 + displayTorque1) / 2.0f;
+    data->target_pos = homeRelative(m_active_op_target_position_steps).value;
+    // Calculate average torque of all motors
+    data->torque_avg = snap.torque_avg;
+#if THERMAL_MODEL_ENABLED
+    data->motor_thermal = getThermalLoadPct();
+#endif
     data->homed = m_homingDone ? 1 : 0;
     
     // Update joules (energy expended during move)
-    data->joules = static_cast<float>(m_joules);
+    data->joules = m_energy.getJoules();
     
     // Update endpoint (position where last move ended)
     data->endpoint = m_endpoint_mm;
@@ -2215,14 +5338,35 @@ void MotorController::updateTelemetry(TelemetryData* data, ForceSensor* forceSen
     data->press_threshold = m_press_threshold_kg;
     
     // Update home sensor states (for gantry squaring homing debugging)
-    data->home_sensor_m0 = getHomeSensorStateM0() ? 1 : 0;
-    data->home_sensor_m1 = getHomeSensorStateM1() ? 1 : 0;
+    data->home_sensor_m0 = snap.home_sensor_m0;
+    data->home_sensor_m1 = snap.home_sensor_m1;
 }
 
 bool MotorController::isBusy() const {
     return m_state != STATE_STANDBY;
 }
 
+bool MotorController::isRetractedIdle() const {
+    if (m_state != STATE_STANDBY || !m_homingDone || !m_isEnabled || isInFault()) {
+        return false;
+    }
+    // Anywhere from home to the retract position, whichever way the polarity counts
+    float retract_mm = (m_retractReferenceSteps == LONG_MIN) ? 0.0f : homeRelative(m_retractReferenceSteps).value;
+    float position_mm = homeRelative(m_tickAxis[0].position_steps).value;
+    float low = (retract_mm < 0.0f) ? retract_mm : 0.0f;
+    float high = (retract_mm > 0.0f) ? retract_mm : 0.0f;
+    return position_mm >= low - FORCE_ZERO_TRACK_RETRACT_TOL_MM && position_mm <= high + FORCE_ZERO_TRACK_RETRACT_TOL_MM;
+}
+
+bool MotorController::drivesEnabled() const {
+    for (int i = 0; i < m_axisCount; i++) {
+        if (!tickStatus(i).bit.Enabled) {
+            return false;
+        }
+    }
+    return true;
+}
+
 const char* MotorController::getState() const {
     switch (m_state) {
         case STATE_STANDBY:     return "Standby";
@@ -2234,7 +5378,12 @@ const char* MotorController::getState() const {
 }
 
 bool MotorController::isInFault() const {
-    return m_motorA->StatusReg().bit.MotorInFault || m_motorB->StatusReg().bit.MotorInFault;
+    for (int i = 0; i < m_axisCount; i++) {
+        if (tickStatus(i).bit.MotorInFault) {
+            return true;
+        }
+    }
+    return false;
 }
 
 //==================================================================================================
@@ -2243,30 +5392,63 @@ bool MotorController::isInFault() const {
 
 /**
  * @brief Configures the home sensors (hall effect) for gantry squaring homing.
- * @details Sets up DI6 and DI7 as digital inputs with debounce filtering.
- * M0 uses DI7, M1 uses DI6.
+ * @details Sets up each axis' sensor from the PressStation (by default M0 on DI7, M1 on
+ * DI6, M2 on DI8, M3 on A9) as a digital input with debounce filtering, and claims an edge
+ * interrupt slot for it.
  */
 void MotorController::setupHomeSensors() {
     // Configure home sensor inputs with filtering for debounce
     // Convert ms to samples (1 ms = 5 samples at 200µs sample rate)
     uint16_t filterSamples = HOME_SENSOR_FILTER_MS * 5;
     
-    // Set mode to digital input (this is the default but we set it explicitly)
-    HOME_SENSOR_M0.Mode(Connector::INPUT_DIGITAL);
-    HOME_SENSOR_M1.Mode(Connector::INPUT_DIGITAL);
-    
-    // Set filter length for debouncing
-    HOME_SENSOR_M0.FilterLength(filterSamples);
-    HOME_SENSOR_M1.FilterLength(filterSamples);
+    for (int i = 0; i < m_axisCount; i++) {
+        // Set mode to digital input (the default on DI pins, required on A9)
+        m_homeSensors[i]->Mode(Connector::INPUT_DIGITAL);
+        // Set filter length for debouncing
+        m_homeSensors[i]->FilterLength(filterSamples);
+    }
     
     m_homeSensorsInitialized = true;
+
+#if HOME_SENSOR_LATCH_ENABLED
+    // Edge interrupts see the raw pin, ahead of the filter and the main loop; the filtered
+    // state still decides when the sensor counts as triggered (see takeHomeLatch())
+    // Indexed by latch slot
+    static const voidFuncPtr isrs[MOTOR_AXIS_MAX] = {
+        &MotorController::homeSensorIsr<0>, &MotorController::homeSensorIsr<1>,
+        &MotorController::homeSensorIsr<2>, &MotorController::homeSensorIsr<3>
+    };
+    InputManager::InterruptTrigger edge = HOME_SENSOR_ACTIVE_STATE ? InputManager::RISING : InputManager::FALLING;
+    m_homeLatchAvailable = true;
+    for (int i = 0; i < m_axisCount; i++) {
+        if (m_homeLatchSlot[i] < 0) {
+            if (s_homeLatchSlotsUsed >= MOTOR_AXIS_MAX) {
+                m_homeLatchAvailable = false;
+                continue;
+            }
+            int slot = s_homeLatchSlotsUsed++;
+            s_homeLatchAxis[slot] = (int8_t)i;
+            s_homeLatchOwner[slot] = this;
+            m_homeLatchSlot[i] = (int8_t)slot;
+        }
+        m_homeLatchAvailable = m_homeSensors[i]->InterruptHandlerSet(isrs[m_homeLatchSlot[i]], edge) &&
+                               m_homeLatchAvailable;
+    }
+    if (m_homeLatchAvailable) {
+        InputMgr.InterruptsEnabled(true);
+    } else {
+        reportEvent(STATUS_PREFIX_INFO, "Home sensor edge interrupts unavailable; touch-off falls back to polling.");
+    }
+#endif
     
-    reportEvent(STATUS_PREFIX_INFO, "Home sensors initialized (DI6=M1, DI7=M0).");
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Home sensors initialized (%d axes).", m_axisCount);
+    reportEvent(STATUS_PREFIX_INFO, msg);
 }
 
 /**
  * @brief Checks if the home sensor for the specified axis is triggered.
- * @param axis 0 for Motor A (M0), 1 for Motor B (M1)
+ * @param axis 0 for M0 .. m_axisCount - 1
  * @return true if the sensor is in the triggered (active) state
  */
 bool MotorController::isHomeSensorTriggered(int axis) {
@@ -2278,65 +5460,189 @@ bool MotorController::isHomeSensorTriggered(int axis) {
 
 /**
  * @brief Gets the raw state of the home sensor for the specified axis.
- * @param axis 0 for Motor A (M0), 1 for Motor B (M1)
+ * @param axis 0 for M0 .. m_axisCount - 1
  * @return true if sensor input is HIGH, false if LOW
  */
 bool MotorController::getHomeSensorState(int axis) {
-    if (axis == 0) {
-        // Motor A (M0) uses DI7
-        return HOME_SENSOR_M0.State() != 0;
-    } else {
-        // Motor B (M1) uses DI6
-        return HOME_SENSOR_M1.State() != 0;
-    }
+    return m_homeSensors[axis]->State() != 0;
 }
 
 /**
- * @brief Public getter for Motor A (M0) home sensor state.
+ * @brief Public getter for one axis' home sensor state.
+ * @param axis 0 for M0 .. m_axisCount - 1
  * @return true if sensor is triggered (active), false otherwise
  */
-bool MotorController::getHomeSensorStateM0() const {
-    return HOME_SENSOR_M0.State() == (HOME_SENSOR_ACTIVE_STATE ? 1 : 0);
+bool MotorController::getHomeSensorActive(int axis) const {
+    return m_homeSensors[axis]->State() == (HOME_SENSOR_ACTIVE_STATE ? 1 : 0);
 }
 
 /**
- * @brief Public getter for Motor B (M1) home sensor state.
- * @return true if sensor is triggered (active), false otherwise
+ * @brief Appends " M<n>=<raw sensor state>" for every axis to a message.
+ * @param msg NUL-terminated message, extended in place (truncated at @p size)
+ * @param size Size of @p msg
+ */
+void MotorController::appendHomeSensorStates(char* msg, size_t size) {
+    size_t len = strlen(msg);
+    for (int i = 0; i < m_axisCount && len < size; i++) {
+        len += snprintf(msg + len, size - len, " M%d=%d", i, getHomeSensorState(i) ? 1 : 0);
+    }
+}
+
+#if HOMING_RESTORE_ENABLED
+/**
+ * @brief Gets the active home sensors as a bit mask.
+ * @return Bit n set if motor n's home sensor is active
+ */
+uint8_t MotorController::homeSensorMask() const {
+    uint8_t mask = 0;
+    for (int i = 0; i < m_axisCount; i++) {
+        if (getHomeSensorActive(i)) {
+            mask |= (uint8_t)(1u << i);
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Takes the home record the last reset left, if any. Call once from setup(), after
+ * setupHomeSensors().
+ * @details Puts each motor's commanded position back where the record left it, so the
+ * trusted trigger points line up again, but leaves the press unhomed: every reset drops the
+ * drive enables, and a disabled axis can be moved by hand or by gravity. The next home runs
+ * the verify touch instead of the full search if the sensors still read as recorded.
+ */
+void MotorController::loadHomeRecord() {
+    HomeRecord record = s_noinitHome;
+    // Restore once: a later reset without a fresh seal must not find it again
+    s_noinitHome.magic = 0;
+
+    // A power-up or brown-out also took the drives down, and no-init RAM with them
+    if (RSTC->RCAUSE.reg & (RSTC_RCAUSE_POR | RSTC_RCAUSE_BODCORE | RSTC_RCAUSE_BODVDD)) {
+        return;
+    }
+    if (record.magic != HOMING_RESTORE_MAGIC || record.checksum != homeRecordChecksum(record) ||
+        record.axis_count != m_axisCount) {
+        return;
+    }
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->PositionRefSet(record.position_steps[i]);
+        m_homeTriggerSteps[i] = record.trigger_steps[i];
+    }
+    m_homeLearned = true;
+    m_machineHomeReferenceSteps = record.home_reference_steps;
+    m_homeRestored = true;
+    m_homeRestoredSensors = record.sensors;
+    reportEvent(STATUS_PREFIX_INFO, "Home from before the reset restored; the next home verifies it with a short touch.");
+}
+
+/**
+ * @brief Keeps the no-init home record in step with a trusted home. Runs every updateState().
+ * @details Sealed only while the press is homed, trusted, idle and free of faults, and
+ * unsealed in the first pass it is not, so a reset during a move or a homing leaves nothing
+ * to restore. A reset between a move command and the next pass leaves the position from
+ * before the move; the verify touch then finds the sensor early or not at all and falls back
+ * to the full search, so a stale record costs time, never position.
+ */
+void MotorController::saveHomeRecord() {
+    bool idle = m_homingDone && m_homeTrusted && m_state == STATE_STANDBY && !isInFault();
+    for (int i = 0; i < m_axisCount && idle; i++) {
+        idle = m_motors[i]->StepsComplete();
+    }
+    if (!idle) {
+        s_noinitHome.magic = 0;
+        return;
+    }
+    // A reset part way through leaves a checksum that no longer matches
+    HomeRecord* record = &s_noinitHome;
+    record->home_reference_steps = (int32_t)m_machineHomeReferenceSteps;
+    for (int i = 0; i < MOTOR_AXIS_MAX; i++) {
+        record->position_steps[i] = (i < m_axisCount) ? (int32_t)m_motors[i]->PositionRefCommanded() : 0;
+        record->trigger_steps[i] = (i < m_axisCount) ? (int32_t)m_homeTriggerSteps[i] : 0;
+    }
+    record->axis_count = (uint8_t)m_axisCount;
+    record->sensors = homeSensorMask();
+    record->reserved[0] = 0;
+    record->reserved[1] = 0;
+    record->checksum = homeRecordChecksum(*record);
+    record->magic = HOMING_RESTORE_MAGIC;
+}
+#endif
+
+/**
+ * @brief Appends " M<n>(en=..,fault=..,moving=..,status=0x....)" for every axis to a message.
+ * @param msg NUL-terminated message, extended in place (truncated at @p size)
+ * @param size Size of @p msg
+ */
+void MotorController::appendAxisStatus(char* msg, size_t size) const {
+    size_t len = strlen(msg);
+    for (int i = 0; i < m_axisCount && len < size; i++) {
+        MotorDriver::StatusRegMotor status;
+        status.reg = m_motors[i]->StatusReg().reg;
+        len += snprintf(msg + len, size - len, " M%d(en=%d,fault=%d,moving=%d,status=0x%04X)", i,
+                        status.bit.Enabled ? 1 : 0, status.bit.MotorInFault ? 1 : 0,
+                        status.bit.StepsActive ? 1 : 0, (unsigned int)status.reg);
+    }
+}
+
+/**
+ * @brief Checks a per-axis flag on every axis.
+ * @param flags Per-axis array (m_axisStopped, m_axisHomeSensorTriggered)
+ * @return true if the flag is set on all m_axisCount axes
+ */
+bool MotorController::allAxesSet(const bool* flags) const {
+    return countAxesSet(flags) == m_axisCount;
+}
+
+/**
+ * @brief Counts the axes a per-axis flag is set on.
+ * @param flags Per-axis array (m_axisStopped, m_axisHomeSensorTriggered)
+ * @return Axes with the flag set
  */
-bool MotorController::getHomeSensorStateM1() const {
-    return HOME_SENSOR_M1.State() == (HOME_SENSOR_ACTIVE_STATE ? 1 : 0);
+int MotorController::countAxesSet(const bool* flags) const {
+    int count = 0;
+    for (int i = 0; i < m_axisCount; i++) {
+        count += flags[i] ? 1 : 0;
+    }
+    return count;
 }
 
 /**
  * @brief Stops a single motor axis using deceleration.
- * @param axis 0 for Motor A (M0), 1 for Motor B (M1)
+ * @param axis 0 for M0 .. m_axisCount - 1
  */
 void MotorController::stopAxis(int axis) {
-    if (axis == 0) {
-        m_motorA->MoveStopDecel();
-    } else {
-        m_motorB->MoveStopDecel();
+    m_zoneArmed = false;
+    m_motors[axis]->MoveStopDecel();
+}
+
+/**
+ * @brief Decelerates every axis to a stop. ISR-safe (trip ISRs and the control tick).
+ */
+void MotorController::stopAllAxes() {
+    // First, so the zone tick cannot re-plan (Move(0)) the stopped axes
+    m_zoneArmed = false;
+    for (int i = 0; i < m_axisCount; i++) {
+        m_motors[i]->MoveStopDecel();
     }
 }
 
 /**
  * @brief Checks if a specific motor axis is currently moving.
- * @param axis 0 for Motor A (M0), 1 for Motor B (M1)
- * @return true if the motor is actively stepping
+ * @details StatusReg().bit.StepsActive only follows the step generator at the next drive
+ * refresh, so right after Move() it still reads idle. The generator's own move state is
+ * set by Move() itself and stays set until the last step (and any deceleration) is out.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ * @return true if the motor holds a commanded move or is stepping
  */
 bool MotorController::isAxisMoving(int axis) {
     if (!m_isEnabled) return false;
     
-    if (axis == 0) {
-        return m_motorA->StatusReg().bit.StepsActive;
-    } else {
-        return m_motorB->StatusReg().bit.StepsActive;
-    }
+    return !m_motors[axis]->StepsComplete();
 }
 
 /**
  * @brief Commands a move on a single motor axis.
- * @param axis 0 for Motor A (M0), 1 for Motor B (M1)
+ * @param axis 0 for M0 .. m_axisCount - 1
  * @param steps Number of steps to move (positive or negative)
  * @param velSps Velocity in steps per second
  * @param accelSps2 Acceleration in steps per second squared
@@ -2346,13 +5652,295 @@ void MotorController::startMoveAxis(int axis, long steps, int velSps, int accelS
         return;
     }
     
-    if (axis == 0) {
-        m_motorA->VelMax(velSps);
-        m_motorA->AccelMax(accelSps2);
-        m_motorA->Move(steps);
+    m_motors[axis]->VelMax(velSps);
+    m_motors[axis]->AccelMax(accelSps2);
+    m_motors[axis]->Move(steps);
+}
+
+/**
+ * @brief Clears the sensor edge latch of one axis ahead of a touch-off.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ */
+void MotorController::armHomeLatch(int axis) {
+    m_homeLatchValid[axis] = false;
+}
+
+/**
+ * @brief Gets the position at which an axis' home sensor triggered.
+ * @details Called once the filtered sensor state reports the trigger. The latest latched
+ * edge is used, so contact bounce and earlier glitches are superseded by the edge that
+ * actually led to the trigger. Falls back to the current commanded position when nothing
+ * was latched (interrupts unavailable or disabled).
+ * @param axis 0 for M0 .. m_axisCount - 1
+ * @return Commanded step position at the trigger
+ */
+long MotorController::takeHomeLatch(int axis) {
+    if (m_homeLatchAvailable && m_homeLatchValid[axis]) {
+        return m_homeLatchSteps[axis];
+    }
+    return m_motors[axis]->PositionRefCommanded();
+}
+
+/**
+ * @brief Records the commanded position of one axis at a sensor edge (interrupt context).
+ * @param axis 0 for M0 .. m_axisCount - 1
+ */
+void MotorController::latchHomeSensor(int axis) {
+    m_homeLatchSteps[axis] = m_motors[axis]->PositionRefCommanded();
+    m_homeLatchValid[axis] = true;
+}
+
+/**
+ * @brief Home sensor edge interrupt of one latch slot.
+ */
+template <int SLOT>
+void MotorController::homeSensorIsr() {
+    MotorController* owner = s_homeLatchOwner[SLOT];
+    if (owner) {
+        owner->latchHomeSensor(s_homeLatchAxis[SLOT]);
+    }
+}
+
+/**
+ * @brief Starts a parallel homing move on one axis.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ * @param steps Relative distance (0 completes immediately)
+ * @param velSps Velocity (steps/sec)
+ */
+void MotorController::startAxisHomingMove(int axis, long steps, int velSps) {
+    // A zero-length move is never handed to the step generator, so treat it as already finished
+    m_axisHomingMoveSeen[axis] = (steps == 0);
+    startMoveAxis(axis, steps, velSps, m_homingAccelSps2);
+}
+
+/**
+ * @brief Starts the first sensor approach of one axis in parallel homing.
+ * @details A trusted home gets a positional approach to just short of its last trigger
+ * point; anything else the full-stroke rapid search.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ */
+void MotorController::startAxisHomingApproach(int axis) {
+    long toward = (m_homingState == HOMING) ? -1 : 1;
+    if (m_axisHomingVerify[axis]) {
+        long margin_steps = toSteps(Millimeters(HOMING_VERIFY_MARGIN_MM)).value;
+        int verify_sps = toStepsPerSec(MmPerSec(fabsf(HOMING_VERIFY_VEL_MMS))).value;
+        long target = m_homeTriggerSteps[axis] - toward * margin_steps;
+        startAxisHomingMove(axis, target - m_motors[axis]->PositionRefCommanded(), verify_sps);
+        m_axisHomingPhase[axis] = AXIS_HOMING_VERIFY_APPROACH;
     } else {
-        m_motorB->VelMax(velSps);
-        m_motorB->AccelMax(accelSps2);
-        m_motorB->Move(steps);
+        startAxisHomingMove(axis, toward * m_homingDistanceSteps, m_homingRapidSps);
+        m_axisHomingPhase[axis] = AXIS_HOMING_RAPID;
+    }
+}
+
+/**
+ * @brief Starts the hybrid approach of one axis: HOMING_HYBRID_VEL_MMS up to
+ * HOMING_HYBRID_SLOW_MM short of its learned trigger point.
+ * @details The learned point survives a disable or a fault, so the axis may have been moved
+ * since. The sensor is still watched on the way, and the control tick stops the axes on a
+ * torque spike (homingSpikeTick()) in case a hard stop or an obstruction comes first.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ * @return false if nothing is learned or the axis is already inside the slow zone
+ */
+bool MotorController::startAxisHybridApproach(int axis) {
+    if (!m_homeLearned || m_homingState != HOMING) {
+        return false;
+    }
+    long toward = -1;
+    long target = m_homeTriggerSteps[axis] - toward * toSteps(Millimeters(HOMING_HYBRID_SLOW_MM)).value;
+    long steps = target - m_motors[axis]->PositionRefCommanded();
+    if (steps * toward <= 0) {
+        return false;
+    }
+    uint8_t bit = (uint8_t)(1u << axis);
+    g_controlTick.mask();
+    m_homingSpikeBaselineSet &= (uint8_t)~bit;
+    m_homingSpikeSettleTicks[axis] = 0;
+    m_homingSpikeAxes |= bit;
+    g_controlTick.unmask();
+    m_axisHomingMoveSeen[axis] = false;
+    startMoveAxis(axis, steps, m_homingHybridSps, m_homingHybridAccelSps2);
+    m_axisHomingPhase[axis] = AXIS_HOMING_HYBRID_APPROACH;
+    postEvent(STATUS_EVENT_HOMING_HYBRID_START, eventArgI(axis), eventArgF(toMillimeters(Steps(std::abs(steps))).value));
+    return true;
+}
+
+/**
+ * @brief Stops watching one axis for a hybrid approach torque spike.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ */
+void MotorController::disarmHomingSpike(int axis) {
+    g_controlTick.mask();
+    m_homingSpikeAxes &= (uint8_t)~(1u << axis);
+    g_controlTick.unmask();
+}
+
+/**
+ * @brief Stops the axes when a hybrid homing approach runs into something.
+ * @details Runs in interrupt context. Only the cruise is judged: the accel and decel torque
+ * of the approach would pass for a hit. After HOMING_HYBRID_SETTLE_MS at speed the friction-
+ * compensated fast torque becomes the axis' baseline, and a rise over it of more than
+ * HOMING_SEARCH_TORQUE_PERCENT stops every axis in the same tick for the homing sequence.
+ * A hard stop holds the step rate (the steps still go out), so the check stays live
+ * through the hit.
+ */
+void MotorController::homingSpikeTick() {
+    for (int i = 0; i < m_axisCount; i++) {
+        uint8_t bit = (uint8_t)(1u << i);
+        if (!(m_homingSpikeAxes & bit) || !m_tickTorqueSeeded[i] || !tickStatus(i).bit.AtTargetVelocity) {
+            continue;
+        }
+        float load = m_tickTorqueFast[i] - m_tickFriction[i];
+        if (!(m_homingSpikeBaselineSet & bit)) {
+            if (++m_homingSpikeSettleTicks[i] >= HOMING_HYBRID_SETTLE_MS * CONTROL_TICK_HZ / 1000) {
+                m_homingSpikeBaseline[i] = load;
+                m_homingSpikeBaselineSet |= bit;
+            }
+            continue;
+        }
+        float rise = std::abs(load - m_homingSpikeBaseline[i]);
+        if (rise > HOMING_SEARCH_TORQUE_PERCENT) {
+            m_homingSpikeAxes = 0;
+            m_homingSpikeAxis = (uint8_t)i;
+            m_homingSpikeRisePct = rise;
+            m_homingSpikeTripped = true;
+            TRACE(TRACE_TORQUE_TRIP, i, rise * 10.0f);
+            stopAllAxes();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether the current parallel homing move of one axis has finished.
+ * @details A move counts as finished once it has been seen running and has stopped again,
+ * so a move that was never taken up does not pass as done.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ * @return true once the move has run and stopped
+ */
+bool MotorController::axisHomingMoveDone(int axis) {
+    if (isAxisMoving(axis)) {
+        m_axisHomingMoveSeen[axis] = true;
+        return false;
+    }
+    return m_axisHomingMoveSeen[axis];
+}
+
+/**
+ * @brief Advances one axis through its parallel homing phases.
+ * @details Mirrors the lockstep sequence (rapid, backoff, touch, offset) for a single axis.
+ * A trusted home replaces the rapid search and backoff with a positional approach to just
+ * short of the last trigger point; if the sensor shows up early or not at all, the axis
+ * falls back to the full search on its own. A hybrid approach hands over to either once it
+ * reaches the slow zone, or to the backoff if it finds the sensor on the way.
+ * @param axis 0 for M0 .. m_axisCount - 1
+ * @return false if the axis failed (ERROR already reported)
+ */
+bool MotorController::advanceAxisHoming(int axis) {
+    MotorDriver* motor = m_motors[axis];
+    long toward = (m_homingState == HOMING) ? -1 : 1;
+
+    switch (m_axisHomingPhase[axis]) {
+        case AXIS_HOMING_HYBRID_APPROACH:
+            if (isHomeSensorTriggered(axis)) {
+                disarmHomingSpike(axis);
+                stopAxis(axis);
+                m_axisHomingMoveSeen[axis] = true;
+                m_axisHomingVerify[axis] = false;
+                postEvent(STATUS_EVENT_HOMING_SENSOR_RAPID, eventArgI(axis));
+                m_axisHomingPhase[axis] = AXIS_HOMING_RAPID_STOPPING;
+            } else if (axisHomingMoveDone(axis)) {
+                disarmHomingSpike(axis);
+                startAxisHomingApproach(axis);
+            }
+            break;
+
+        case AXIS_HOMING_VERIFY_APPROACH:
+            if (isHomeSensorTriggered(axis)) {
+                stopAxis(axis);
+                m_axisHomingMoveSeen[axis] = true;
+                m_axisHomingVerify[axis] = false;
+                postEvent(STATUS_EVENT_HOMING_SENSOR_EARLY, eventArgI(axis));
+                m_axisHomingPhase[axis] = AXIS_HOMING_RAPID_STOPPING;
+            } else if (axisHomingMoveDone(axis)) {
+                armHomeLatch(axis);
+                startAxisHomingMove(axis, toward * m_homingBackoffSteps * 2, m_homingTouchSps);
+                m_axisHomingPhase[axis] = AXIS_HOMING_TOUCH;
+            }
+            break;
+
+        case AXIS_HOMING_RAPID:
+            if (isHomeSensorTriggered(axis)) {
+                stopAxis(axis);
+                m_axisHomingMoveSeen[axis] = true;
+                postEvent(STATUS_EVENT_HOMING_SENSOR_RAPID, eventArgI(axis));
+                m_axisHomingPhase[axis] = AXIS_HOMING_RAPID_STOPPING;
+            } else if (axisHomingMoveDone(axis)) {
+                postEvent(STATUS_EVENT_HOMING_AXIS_STOPPED, eventArgI(axis));
+                return false;
+            }
+            break;
+
+        case AXIS_HOMING_RAPID_STOPPING:
+            if (axisHomingMoveDone(axis)) {
+                startAxisHomingMove(axis, -toward * m_homingBackoffSteps, m_homingBackoffSps);
+                m_axisHomingPhase[axis] = AXIS_HOMING_BACKOFF;
+            }
+            break;
+
+        case AXIS_HOMING_BACKOFF:
+            if (axisHomingMoveDone(axis)) {
+                armHomeLatch(axis);
+                startAxisHomingMove(axis, toward * m_homingBackoffSteps * 2, m_homingTouchSps);
+                m_axisHomingPhase[axis] = AXIS_HOMING_TOUCH;
+            }
+            break;
+
+        case AXIS_HOMING_TOUCH:
+            if (isHomeSensorTriggered(axis)) {
+                stopAxis(axis);
+                m_axisHomingMoveSeen[axis] = true;
+                long trigger = takeHomeLatch(axis);
+                if (m_axisHomingVerify[axis]) {
+                    float shift_mm = toMillimeters(Steps(trigger - m_homeTriggerSteps[axis])).value;
+                    postEvent((fabsf(shift_mm) <= HOMING_VERIFY_TOLERANCE_MM)
+                              ? STATUS_EVENT_HOMING_HOME_VERIFIED : STATUS_EVENT_HOMING_HOME_MOVED,
+                              eventArgI(axis), eventArgF(shift_mm));
+                } else {
+                    postEvent(STATUS_EVENT_HOMING_SENSOR_SLOW, eventArgI(axis));
+                }
+                m_homeTriggerSteps[axis] = trigger;
+                m_axisHomeSensorTriggered[axis] = true;
+                m_axisHomingPhase[axis] = AXIS_HOMING_TOUCH_STOPPING;
+            } else if (axisHomingMoveDone(axis)) {
+                if (!m_axisHomingVerify[axis]) {
+                    postEvent(STATUS_EVENT_HOMING_AXIS_NO_SENSOR, eventArgI(axis));
+                    return false;
+                }
+                m_axisHomingVerify[axis] = false;
+                postEvent(STATUS_EVENT_HOMING_AXIS_FULL_SEARCH, eventArgI(axis));
+                startAxisHomingMove(axis, toward * m_homingDistanceSteps, m_homingRapidSps);
+                m_axisHomingPhase[axis] = AXIS_HOMING_RAPID;
+            }
+            break;
+
+        case AXIS_HOMING_TOUCH_STOPPING:
+            if (axisHomingMoveDone(axis)) {
+                // Offset from the trigger point, so the stopping distance drops out of the zero
+                long offset_target = m_homeTriggerSteps[axis] - toward * m_homingBackoffSteps;
+                startAxisHomingMove(axis, offset_target - motor->PositionRefCommanded(), m_homingBackoffSps);
+                m_axisHomingPhase[axis] = AXIS_HOMING_OFFSET;
+            }
+            break;
+
+        case AXIS_HOMING_OFFSET:
+            if (axisHomingMoveDone(axis)) {
+                m_axisHomingPhase[axis] = AXIS_HOMING_DONE;
+            }
+            break;
+
+        default:
+            break;
     }
+    return true;
 }
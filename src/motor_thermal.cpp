@@ -0,0 +1,35 @@
+/**
+ * @file motor_thermal.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the I2t thermal estimate of one press motor.
+ */
+
+#include "motor_thermal.h"
+#include <math.h>
+
+/// Filter step per block of THERMAL_UPDATE_TICKS ticks: 1 - e^(-block / tau)
+static const float kBlockAlpha =
+    1.0f - expf(-(float)THERMAL_UPDATE_TICKS / ((float)CONTROL_TICK_HZ * THERMAL_TIME_CONSTANT_S));
+
+MotorThermalModel::MotorThermalModel() {
+    reset();
+}
+
+void MotorThermalModel::reset() {
+    m_loadPct = 0.0f;
+    m_blockSum = 0.0f;
+    m_blockTicks = 0;
+}
+
+void MotorThermalModel::tick(float torque_pct) {
+    float load = torque_pct / THERMAL_CONTINUOUS_TORQUE_PCT;
+    m_blockSum += load * load;
+    if (++m_blockTicks < THERMAL_UPDATE_TICKS) {
+        return;
+    }
+    float target_pct = 100.0f * m_blockSum / (float)m_blockTicks;
+    m_loadPct = m_loadPct + (target_pct - m_loadPct) * kBlockAlpha;
+    m_blockSum = 0.0f;
+    m_blockTicks = 0;
+}
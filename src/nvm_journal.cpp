@@ -0,0 +1,281 @@
+/**
+ * @file nvm_journal.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the wear-leveled flash journal for frequently adjusted settings.
+ */
+
+#include "nvm_journal.h"
+#include "error_log.h"
+#include "main_flash.h"
+#include <stddef.h>
+#include <string.h>
+
+#define NVM_JOURNAL_RECORDS     (NVM_JOURNAL_BLOCK_SIZE / sizeof(NvmJournalRecord))
+
+// Compaction steps after the keys: write the header, then switch blocks
+#define COMPACT_HEADER          NVM_JOURNAL_KEY_COUNT
+#define COMPACT_DONE            (NVM_JOURNAL_KEY_COUNT + 1)
+
+static_assert(sizeof(NvmJournalRecord) == 16, "Journal record must be one flash quad-word");
+static_assert(NVM_JOURNAL_BLOCKS >= 2 && NVM_JOURNAL_BLOCKS <= 8, "Journal needs 2 to 8 blocks");
+static_assert(NVM_JOURNAL_KEY_COUNT <= 32, "Journal key masks are 32 bits");
+static_assert((NVM_JOURNAL_ADDR % NVM_JOURNAL_BLOCK_SIZE) == 0, "Journal must start on an erase block");
+
+// Global journal instance
+NvmJournal g_nvmJournal;
+
+NvmJournal::NvmJournal() {
+    memset(m_value, 0, sizeof(m_value));
+    m_have = 0;
+    m_pending = 0;
+    m_state = NVM_JOURNAL_STATE_IDLE;
+    m_active = NVM_JOURNAL_BLOCKS - 1;
+    m_next = NVM_JOURNAL_RECORDS;
+    m_seq = 0;
+    m_erased = 0;
+    m_stale = 0;
+    m_target = 0;
+    m_copyKey = 0;
+    m_copySlot = 0;
+    m_erases = 0;
+}
+
+/**
+ * @details Reads flash directly; the blocks are memory mapped. With no valid block the
+ * journal starts out "full", so the first put() compacts (nothing) into block 0 and writes
+ * its header.
+ */
+void NvmJournal::load() {
+    uint32_t newestHeader = 0;
+    bool found = false;
+    for (uint8_t b = 0; b < NVM_JOURNAL_BLOCKS; b++) {
+        const uint32_t* words = reinterpret_cast<const uint32_t*>(blockAddress(b));
+        bool erased = true;
+        for (uint32_t i = 0; i < NVM_JOURNAL_BLOCK_SIZE / 4 && erased; i++) {
+            erased = (words[i] == 0xFFFFFFFF);
+        }
+        if (erased) {
+            m_erased |= (uint8_t)(1 << b);
+            continue;
+        }
+        const NvmJournalRecord* header = reinterpret_cast<const NvmJournalRecord*>(blockAddress(b));
+        if (header->key == NVM_JOURNAL_KEY_HEADER && header->crc == recordCrc(*header) &&
+            (!found || header->seq > newestHeader)) {
+            newestHeader = header->seq;
+            m_active = b;
+            found = true;
+        }
+    }
+
+    for (uint8_t b = 0; b < NVM_JOURNAL_BLOCKS; b++) {
+        if (!(m_erased & (1 << b)) && (!found || b != m_active)) {
+            m_stale |= (uint8_t)(1 << b);
+        }
+    }
+    if (!found) {
+        return;
+    }
+
+    // Records after the header, oldest first; a torn or corrupt record is skipped
+    const NvmJournalRecord* records = reinterpret_cast<const NvmJournalRecord*>(blockAddress(m_active));
+    m_seq = records[0].seq + 1;
+    m_next = 1;
+    while (m_next < NVM_JOURNAL_RECORDS) {
+        const NvmJournalRecord& record = records[m_next];
+        const uint32_t* words = reinterpret_cast<const uint32_t*>(&record);
+        if ((words[0] & words[1] & words[2] & words[3]) == 0xFFFFFFFF) {
+            break;
+        }
+        m_next++;
+        if (record.crc != recordCrc(record) || record.key == NVM_JOURNAL_KEY_HEADER ||
+            record.key >= NVM_JOURNAL_KEY_COUNT) {
+            continue;
+        }
+        m_value[record.key] = record.value;
+        m_have |= (1UL << record.key);
+        if (record.seq >= m_seq) {
+            m_seq = record.seq + 1;
+        }
+    }
+}
+
+bool NvmJournal::get(NvmJournalKey key, uint32_t* value) const {
+    if (key == NVM_JOURNAL_KEY_HEADER || key >= NVM_JOURNAL_KEY_COUNT || !(m_have & (1UL << key))) {
+        return false;
+    }
+    *value = m_value[key];
+    return true;
+}
+
+bool NvmJournal::put(NvmJournalKey key, uint32_t value) {
+    if (m_state == NVM_JOURNAL_STATE_FAILED || key == NVM_JOURNAL_KEY_HEADER || key >= NVM_JOURNAL_KEY_COUNT) {
+        return false;
+    }
+    if ((m_have & (1UL << key)) && m_value[key] == value) {
+        return true;
+    }
+    m_value[key] = value;
+    m_have |= (1UL << key);
+    m_pending |= (1UL << key);
+    return true;
+}
+
+void NvmJournal::service() {
+    if (m_state == NVM_JOURNAL_STATE_FAILED || !main_flash_ready()) {
+        return;
+    }
+    if (m_state != NVM_JOURNAL_STATE_IDLE && checkFlashError()) {
+        return;
+    }
+
+    switch (m_state) {
+        case NVM_JOURNAL_STATE_WRITING:
+            m_state = NVM_JOURNAL_STATE_IDLE;
+            return;
+
+        case NVM_JOURNAL_STATE_ERASING:
+            m_erased |= (uint8_t)(1 << m_target);
+            m_stale &= (uint8_t)~(1 << m_target);
+            m_erases++;
+            m_state = NVM_JOURNAL_STATE_IDLE;
+            return;
+
+        case NVM_JOURNAL_STATE_COMPACTING:
+            stepCompaction();
+            return;
+
+        default:
+            break;
+    }
+
+    if (m_pending) {
+        if (m_next < NVM_JOURNAL_RECORDS) {
+            uint8_t key = 1;
+            while (!(m_pending & (1UL << key))) {
+                key++;
+            }
+            m_pending &= ~(1UL << key);
+            startWrite(m_active, m_next++, key, m_value[key]);
+            m_state = NVM_JOURNAL_STATE_WRITING;
+            return;
+        }
+        // Active block full: carry the newest values into the next block
+        uint8_t target = (uint8_t)((m_active + 1) % NVM_JOURNAL_BLOCKS);
+        if (!(m_erased & (1 << target))) {
+            startErase(target);
+            return;
+        }
+        m_target = target;
+        m_copyKey = 1;
+        m_copySlot = 1;
+        m_state = NVM_JOURNAL_STATE_COMPACTING;
+        stepCompaction();
+        return;
+    }
+
+    if (m_stale) {
+        uint8_t block = 0;
+        while (!(m_stale & (1 << block))) {
+            block++;
+        }
+        startErase(block);
+    }
+}
+
+bool NvmJournal::isIdle() const {
+    return (m_state == NVM_JOURNAL_STATE_IDLE && m_pending == 0 && m_stale == 0) ||
+           m_state == NVM_JOURNAL_STATE_FAILED;
+}
+
+const char* NvmJournal::stateName(uint8_t state) {
+    switch (state) {
+        case NVM_JOURNAL_STATE_IDLE:       return "idle";
+        case NVM_JOURNAL_STATE_WRITING:    return "writing";
+        case NVM_JOURNAL_STATE_COMPACTING: return "compacting";
+        case NVM_JOURNAL_STATE_ERASING:    return "erasing";
+        case NVM_JOURNAL_STATE_FAILED:     return "failed";
+        default:                           return "unknown";
+    }
+}
+
+uint32_t NvmJournal::blockAddress(uint8_t block) {
+    return NVM_JOURNAL_ADDR + (uint32_t)block * NVM_JOURNAL_BLOCK_SIZE;
+}
+
+// CRC-32 (IEEE, reflected) of key, reserved, seq and value
+uint32_t NvmJournal::recordCrc(const NvmJournalRecord& record) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&record);
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint8_t i = 0; i < offsetof(NvmJournalRecord, crc); i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool NvmJournal::checkFlashError() {
+    uint16_t flags = main_flash_errors();
+    if (flags == 0) {
+        return false;
+    }
+    ERROR_LOGF(LOG_ERROR, "NVM journal: flash error 0x%04X in %s, block %u", (unsigned)flags,
+               stateName(m_state), (unsigned)((m_state == NVM_JOURNAL_STATE_WRITING) ? m_active : m_target));
+    m_state = NVM_JOURNAL_STATE_FAILED;
+    return true;
+}
+
+/**
+ * @details Starts a quad-word write; service() sees it finish when NVMCTRL is ready again.
+ */
+void NvmJournal::startWrite(uint8_t block, uint16_t slot, uint8_t key, uint32_t value) {
+    NvmJournalRecord record;
+    memset(&record, 0xFF, sizeof(record));
+    record.key = key;
+    record.seq = m_seq++;
+    record.value = value;
+    record.crc = recordCrc(record);
+
+    uint32_t address = blockAddress(block) + (uint32_t)slot * sizeof(NvmJournalRecord);
+    main_flash_start_write(address, reinterpret_cast<const uint32_t*>(&record), MAIN_FLASH_QUAD_WORDS);
+    m_erased &= (uint8_t)~(1 << block);
+}
+
+void NvmJournal::startErase(uint8_t block) {
+    m_target = block;
+    main_flash_start_erase(blockAddress(block));
+    m_state = NVM_JOURNAL_STATE_ERASING;
+}
+
+/**
+ * @details One step per call: a key's newest value, then the header, then the switch to
+ * the new block. Keys put() again after being copied stay pending and follow as normal
+ * records.
+ * @return true while compaction still has steps
+ */
+bool NvmJournal::stepCompaction() {
+    while (m_copyKey < NVM_JOURNAL_KEY_COUNT && !(m_have & (1UL << m_copyKey))) {
+        m_copyKey++;
+    }
+    if (m_copyKey < NVM_JOURNAL_KEY_COUNT) {
+        m_pending &= ~(1UL << m_copyKey);
+        startWrite(m_target, m_copySlot++, m_copyKey, m_value[m_copyKey]);
+        m_copyKey++;
+        return true;
+    }
+    if (m_copyKey == COMPACT_HEADER) {
+        // Header last: the block only counts once everything above is in it
+        startWrite(m_target, 0, NVM_JOURNAL_KEY_HEADER, m_erases);
+        m_copyKey = COMPACT_DONE;
+        return true;
+    }
+    if (!(m_erased & (1 << m_active))) {
+        m_stale |= (uint8_t)(1 << m_active);
+    }
+    m_active = m_target;
+    m_next = m_copySlot;
+    m_state = NVM_JOURNAL_STATE_IDLE;
+    return false;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file position_curve.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the press curve sampled on a fixed position grid.
+ */
+
+#include "position_curve.h"
+
+#if POSITION_CURVE_ENABLED
+
+#include "base64.h"
+#include "ClearCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static_assert((POSITION_CURVE_RING_SIZE & (POSITION_CURVE_RING_SIZE - 1)) == 0, "Crossing ring size must be a power of 2");
+static_assert(POSITION_CURVE_MAX_POINTS <= 0xFFFF, "Curve index is 16 bits");
+static_assert(POSITION_CURVE_PRETRIGGER_POINTS <= POSITION_CURVE_MAX_POINTS, "Pretrigger ring lives in the curve");
+static_assert(POSITION_CURVE_SAMPLE_HISTORY >= 1 && POSITION_CURVE_SAMPLE_HISTORY <= 255, "Sample history count is 8 bits");
+static_assert(40 + (POSITION_CURVE_LINE_POINTS * 2 + 2) / 3 * 4 < MAX_MESSAGE_LENGTH,
+              "A DATA line must fit in one message");
+
+// Global position curve instance
+PositionCurve g_positionCurve;
+
+PositionCurve::PositionCurve() {
+    memset(m_points, 0, sizeof(m_points));
+    memset(m_ring, 0, sizeof(m_ring));
+    memset(m_samples, 0, sizeof(m_samples));
+    m_ringHead = 0;
+    m_ringTail = 0;
+    m_tickArmed = false;
+    m_dir = 0;
+    m_stepsPerPoint = 1.0f;
+    m_tickNext = 0;
+    m_tickPrevSteps = 0;
+    m_tickPrevUs = 0;
+    m_sampleHead = 0;
+    m_sampleCount = 0;
+    m_count = 0;
+    m_pretriggerHead = 0;
+    m_lastIndex = 0;
+    m_lastKg = 0.0f;
+    m_dropped = 0;
+    m_triggerIndex = -1;
+    m_triggered = false;
+    m_capturing = false;
+    m_endUs = 0;
+}
+
+void PositionCurve::begin(int32_t position_steps, float steps_per_mm) {
+    // Fully configure before arming - the control tick may run between any two statements
+    m_tickArmed = false;
+    m_ringHead = 0;
+    m_ringTail = 0;
+    m_dir = 0;
+    m_stepsPerPoint = POSITION_CURVE_STEP_MM * steps_per_mm;
+    m_tickPrevSteps = position_steps;
+    m_tickPrevUs = Microseconds();
+    m_sampleHead = 0;
+    m_sampleCount = 0;
+    m_count = 0;
+    m_pretriggerHead = 0;
+    m_dropped = 0;
+    m_triggerIndex = -1;
+    m_triggered = (POSITION_CURVE_PRETRIGGER_POINTS == 0);
+    m_capturing = true;
+    m_tickArmed = (m_stepsPerPoint >= 1.0f);
+}
+
+void PositionCurve::end(uint32_t now_us) {
+    if (!m_capturing) {
+        return;
+    }
+    if (m_tickArmed) {
+        m_tickArmed = false;
+        m_endUs = now_us;
+    }
+    uint16_t waiting = (uint16_t)((m_ringHead - m_ringTail) & (POSITION_CURVE_RING_SIZE - 1));
+    if (waiting > 0 && now_us - m_endUs < (uint32_t)POSITION_CURVE_CLOSE_MS * 1000u) {
+        return;
+    }
+    m_dropped += waiting;
+    m_capturing = false;
+    if (!m_triggered) {
+        flushPretrigger();
+    }
+}
+
+void PositionCurve::trigger() {
+    if (!m_capturing || m_triggerIndex >= 0) {
+        return;
+    }
+    if (!m_triggered) {
+        flushPretrigger();
+        m_triggered = true;
+    }
+    m_triggerIndex = m_count;
+}
+
+void PositionCurve::flushPretrigger() {
+#if POSITION_CURVE_PRETRIGGER_POINTS > 0
+    if (m_count < POSITION_CURVE_PRETRIGGER_POINTS || m_pretriggerHead == 0) {
+        // Not wrapped yet: already oldest first
+        return;
+    }
+    // Rotate the full ring left by its head, three reversals in place
+    int16_t* first = m_points;
+    int16_t* middle = m_points + m_pretriggerHead;
+    int16_t* last = m_points + POSITION_CURVE_PRETRIGGER_POINTS;
+    for (int16_t *a = first, *b = middle - 1; a < b; a++, b--) {
+        int16_t t = *a; *a = *b; *b = t;
+    }
+    for (int16_t *a = middle, *b = last - 1; a < b; a++, b--) {
+        int16_t t = *a; *a = *b; *b = t;
+    }
+    for (int16_t *a = first, *b = last - 1; a < b; a++, b--) {
+        int16_t t = *a; *a = *b; *b = t;
+    }
+    m_pretriggerHead = 0;
+#endif
+}
+
+void PositionCurve::tick(uint32_t now_us, int32_t position_steps) {
+    if (!m_tickArmed) {
+        return;
+    }
+    int32_t prev_steps = m_tickPrevSteps;
+    uint32_t prev_us = m_tickPrevUs;
+    m_tickPrevSteps = position_steps;
+    m_tickPrevUs = now_us;
+    if (position_steps == prev_steps) {
+        return;
+    }
+    if (m_dir == 0) {
+        // The first motion sets the direction; the next point is the first grid point past the start
+        float grid = (float)prev_steps / m_stepsPerPoint;
+        m_tickNext = (position_steps > prev_steps) ? (int32_t)floorf(grid) + 1 : (int32_t)ceilf(grid) - 1;
+        m_dir = (position_steps > prev_steps) ? 1 : -1;
+    }
+    float span = (float)(position_steps - prev_steps);
+    uint32_t dt_us = now_us - prev_us;
+    // Reversed (regulated hold, retract): the next point is still ahead, nothing is passed
+    for (;;) {
+        int32_t point_steps = (int32_t)lroundf((float)m_tickNext * m_stepsPerPoint);
+        if (m_dir > 0 ? position_steps < point_steps : position_steps > point_steps) {
+            break;
+        }
+        // A full queue loses the point; the main loop fills the gap from the next one
+        uint16_t next = (uint16_t)((m_ringHead + 1) & (POSITION_CURVE_RING_SIZE - 1));
+        if (next != m_ringTail) {
+            // Linear between the two ticks: the point lies past the previous position
+            float fraction = (float)(point_steps - prev_steps) / span;
+            Crossing& crossing = m_ring[m_ringHead];
+            crossing.time_us = prev_us + (uint32_t)(fraction * (float)dt_us);
+            crossing.index = m_tickNext;
+            m_ringHead = next;
+        }
+        m_tickNext += m_dir;
+    }
+}
+
+void PositionCurve::addSample(uint32_t acquired_us, float force_kg) {
+    if (!m_capturing) {
+        return;
+    }
+    uint16_t tail = m_ringTail;
+    uint16_t head = m_ringHead;
+    while (tail != head) {
+        const Crossing& crossing = m_ring[tail];
+        // Wait for a sample at or after the crossing
+        if ((int32_t)(crossing.time_us - acquired_us) > 0) {
+            break;
+        }
+        store(crossing.index, forceAt(crossing.time_us, acquired_us, force_kg));
+        tail = (uint16_t)((tail + 1) & (POSITION_CURVE_RING_SIZE - 1));
+    }
+    m_ringTail = tail;
+    Sample& sample = m_samples[m_sampleHead];
+    sample.time_us = acquired_us;
+    sample.kg = force_kg;
+    m_sampleHead = (uint8_t)((m_sampleHead + 1) % POSITION_CURVE_SAMPLE_HISTORY);
+    if (m_sampleCount < POSITION_CURVE_SAMPLE_HISTORY) {
+        m_sampleCount++;
+    }
+}
+
+float PositionCurve::forceAt(uint32_t time_us, uint32_t acquired_us, float force_kg) const {
+    // Walk back from the newest sample to the first one at or before the crossing
+    uint32_t newer_us = acquired_us;
+    float newer_kg = force_kg;
+    uint8_t slot = m_sampleHead;
+    for (uint8_t i = 0; i < m_sampleCount; i++) {
+        slot = (uint8_t)((slot + POSITION_CURVE_SAMPLE_HISTORY - 1) % POSITION_CURVE_SAMPLE_HISTORY);
+        const Sample& older = m_samples[slot];
+        if ((int32_t)(time_us - older.time_us) >= 0) {
+            if (newer_us == older.time_us) {
+                return newer_kg;
+            }
+            float t = (float)(time_us - older.time_us) / (float)(newer_us - older.time_us);
+            return older.kg + (newer_kg - older.kg) * t;
+        }
+        newer_us = older.time_us;
+        newer_kg = older.kg;
+    }
+    return newer_kg;
+}
+
+void PositionCurve::store(int32_t index, float force_kg) {
+    if (m_triggered && m_count >= POSITION_CURVE_MAX_POINTS) {
+        m_dropped++;
+        return;
+    }
+    // Points the tick had no slot for are filled in linearly by position, so the grid stays uniform
+    int32_t gap = (m_count > 0) ? (index - m_lastIndex) * m_dir - 1 : 0;
+    if (gap > 0) {
+        m_dropped += (uint32_t)gap;
+    } else {
+        gap = 0;
+    }
+    for (int32_t i = gap; i >= 0; i--) {
+        float kg = force_kg - (force_kg - m_lastKg) * (float)i / (float)(gap + 1);
+        float deci = kg * 10.0f;
+        int16_t value = (deci >= 32767.0f) ? 32767 : (deci <= -32767.0f) ? -32767 : (int16_t)lroundf(deci);
+        if (m_triggered) {
+            if (m_count >= POSITION_CURVE_MAX_POINTS) {
+                // The fill points are counted already
+                m_dropped++;
+                return;
+            }
+            m_points[m_count++] = value;
+        }
+#if POSITION_CURVE_PRETRIGGER_POINTS > 0
+        else {
+            m_points[m_pretriggerHead] = value;
+            m_pretriggerHead = (uint16_t)((m_pretriggerHead + 1) % POSITION_CURVE_PRETRIGGER_POINTS);
+            if (m_count < POSITION_CURVE_PRETRIGGER_POINTS) {
+                m_count++;
+            }
+        }
+#endif
+        // Only stored points move the end, so the first point follows from the count
+        m_lastIndex = index - i * m_dir;
+        m_lastKg = kg;
+    }
+}
+
+float PositionCurve::getStartMm() const {
+    if (m_count == 0) {
+        return 0.0f;
+    }
+    // m_lastIndex is the last point stored, m_count - 1 points after the first
+    int32_t first = m_lastIndex - m_dir * (int32_t)(m_count - 1);
+    return (float)first * POSITION_CURVE_STEP_MM;
+}
+
+uint16_t PositionCurve::formatLine(uint16_t first, char* buffer, size_t size) const {
+    if (first >= m_count) {
+        return 0;
+    }
+    uint16_t count = m_count - first;
+    if (count > POSITION_CURVE_LINE_POINTS) {
+        count = POSITION_CURVE_LINE_POINTS;
+    }
+    int len = snprintf(buffer, size, "CURVE:pressboi:DATA:%u:", (unsigned)first);
+    if (len < 0 || (size_t)len + (count * 2 + 2) / 3 * 4 >= size) {
+        return 0;
+    }
+    // Little-endian int16, as the SAME53 stores it
+    base64Encode(reinterpret_cast<const uint8_t*>(m_points + first), count * 2, buffer + len);
+    return count;
+}
+
+#endif // POSITION_CURVE_ENABLED
@@ -0,0 +1,257 @@
+/**
+ * @file press_capture.cpp
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Implements the per-sample force-displacement capture buffer.
+ */
+
+#include "press_capture.h"
+#include "base64.h"
+#include "drive_geometry.h"
+#include <math.h>
+#include <stdio.h>
+
+// dt and three zigzag fields, each at most five varint bytes (torque at most three)
+#define PRESS_CAPTURE_RECORD_MAX_BYTES  18
+
+static_assert(PRESS_CAPTURE_MAX_SAMPLES <= 0xFFFF, "Capture index is 16 bits");
+static_assert(PRESS_CAPTURE_BUFFER_BYTES <= 0xFFFF, "Capture offsets are 16 bits");
+static_assert(PRESS_CAPTURE_KEYFRAME_INTERVAL * PRESS_CAPTURE_RECORD_MAX_BYTES <= PRESS_CAPTURE_LINE_BYTES,
+              "A keyframe block must always fit in one DATA line");
+static_assert(40 + (PRESS_CAPTURE_LINE_BYTES + 2) / 3 * 4 < MAX_MESSAGE_LENGTH,
+              "A DATA line must fit in one message");
+
+// Global press capture instance
+PressCapture g_pressCapture;
+
+/** Maps signed deltas onto small unsigned values (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...). */
+static inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+PressCapture::PressCapture() {
+    m_length = 0;
+    m_count = 0;
+    m_dropped = 0;
+    m_lastTimeUs = 0;
+    m_firstTimeUs = 0;
+    m_lastPosition = 0;
+    m_lastRaw = 0;
+    m_lastTorque = 0;
+    m_full = false;
+    m_capturing = false;
+    m_triggered = false;
+    m_triggerIndex = -1;
+    m_coarseSteps = 0;
+    m_coarsePosition = 0;
+    m_coarseValid = false;
+#if PRESS_CAPTURE_PRETRIGGER_SAMPLES > 0
+    m_pretriggerHead = 0;
+    m_pretriggerCount = 0;
+#endif
+}
+
+void PressCapture::begin() {
+    m_length = 0;
+    m_count = 0;
+    m_dropped = 0;
+    m_full = false;
+    m_triggered = false;
+    m_triggerIndex = -1;
+    m_coarseSteps = (int32_t)lroundf(PRESS_CAPTURE_COARSE_MM * g_driveGeometry.stepsPerMm());
+    m_coarseValid = false;
+#if PRESS_CAPTURE_PRETRIGGER_SAMPLES > 0
+    m_pretriggerHead = 0;
+    m_pretriggerCount = 0;
+#endif
+    m_capturing = true;
+}
+
+void PressCapture::end() {
+    if (m_capturing && !m_triggered) {
+        flushPretrigger();
+    }
+    m_capturing = false;
+}
+
+void PressCapture::trigger() {
+    if (!m_capturing || m_triggered) {
+        return;
+    }
+    flushPretrigger();
+    m_triggered = true;
+    m_triggerIndex = (m_count > 0) ? (int32_t)m_count - 1 : 0;
+}
+
+void PressCapture::flushPretrigger() {
+#if PRESS_CAPTURE_PRETRIGGER_SAMPLES > 0
+    uint16_t index = (uint16_t)((m_pretriggerHead + PRESS_CAPTURE_PRETRIGGER_SAMPLES - m_pretriggerCount) % PRESS_CAPTURE_PRETRIGGER_SAMPLES);
+    for (uint16_t n = 0; n < m_pretriggerCount; n++) {
+        const PretriggerSample& sample = m_pretrigger[index];
+        store(sample.time_us, sample.position_steps, sample.raw, sample.torque_deci);
+        index = (uint16_t)((index + 1) % PRESS_CAPTURE_PRETRIGGER_SAMPLES);
+    }
+    m_pretriggerCount = 0;
+#endif
+}
+
+void PressCapture::putVarint(uint8_t* record, uint8_t& len, uint32_t value) {
+    while (value >= 0x80) {
+        record[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    record[len++] = (uint8_t)value;
+}
+
+void PressCapture::add(uint32_t time_us, int32_t position_steps, int32_t raw, float torque_pct, bool detail) {
+    if (!m_capturing) {
+        return;
+    }
+    if (!m_triggered && !detail && m_coarseValid) {
+        // Free approach: one sample per coarse step of travel
+        int32_t moved = position_steps - m_coarsePosition;
+        if (moved < m_coarseSteps && -moved < m_coarseSteps) {
+            return;
+        }
+    }
+    m_coarsePosition = position_steps;
+    m_coarseValid = true;
+
+    float torque_f = torque_pct * 10.0f;
+    if (torque_f > 32767.0f) {
+        torque_f = 32767.0f;
+    } else if (torque_f < -32767.0f) {
+        torque_f = -32767.0f;
+    }
+    int16_t torque_deci = (int16_t)torque_f;
+
+#if PRESS_CAPTURE_PRETRIGGER_SAMPLES > 0
+    if (!m_triggered) {
+        // Approach: keep only the latest samples until the threshold is crossed
+        PretriggerSample& slot = m_pretrigger[m_pretriggerHead];
+        slot.time_us = time_us;
+        slot.position_steps = position_steps;
+        slot.raw = raw;
+        slot.torque_deci = torque_deci;
+        m_pretriggerHead = (uint16_t)((m_pretriggerHead + 1) % PRESS_CAPTURE_PRETRIGGER_SAMPLES);
+        if (m_pretriggerCount < PRESS_CAPTURE_PRETRIGGER_SAMPLES) {
+            m_pretriggerCount++;
+        }
+        return;
+    }
+#endif
+    store(time_us, position_steps, raw, torque_deci);
+}
+
+void PressCapture::store(uint32_t time_us, int32_t position_steps, int32_t raw, int16_t torque_deci) {
+    if (m_full || m_count >= PRESS_CAPTURE_MAX_SAMPLES) {
+        m_dropped++;
+        return;
+    }
+
+    bool keyframe = (m_count % PRESS_CAPTURE_KEYFRAME_INTERVAL) == 0;
+    uint8_t record[PRESS_CAPTURE_RECORD_MAX_BYTES];
+    uint8_t len = 0;
+    putVarint(record, len, (m_count == 0) ? 0 : time_us - m_lastTimeUs);
+    if (keyframe) {
+        putVarint(record, len, zigzag(position_steps));
+        putVarint(record, len, zigzag(raw));
+        putVarint(record, len, zigzag(torque_deci));
+    } else {
+        putVarint(record, len, zigzag(position_steps - m_lastPosition));
+        putVarint(record, len, zigzag(raw - m_lastRaw));
+        putVarint(record, len, zigzag(torque_deci - m_lastTorque));
+    }
+    if (m_length + len > PRESS_CAPTURE_BUFFER_BYTES) {
+        // Keep the stored curve contiguous rather than leave gaps in it
+        m_full = true;
+        m_dropped++;
+        return;
+    }
+
+    if (keyframe) {
+        m_keyframeOffsets[m_count / PRESS_CAPTURE_KEYFRAME_INTERVAL] = m_length;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        m_buffer[m_length + i] = record[i];
+    }
+    m_length += len;
+    if (m_count == 0) {
+        m_firstTimeUs = time_us;
+    }
+    m_lastTimeUs = time_us;
+    m_lastPosition = position_steps;
+    m_lastRaw = raw;
+    m_lastTorque = torque_deci;
+    m_count++;
+}
+
+uint32_t PressCapture::getVarint(uint16_t& offset) const {
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    while (offset < m_length) {
+        uint8_t byte = m_buffer[offset++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80) || shift >= 28) {
+            break;
+        }
+        shift += 7;
+    }
+    return value;
+}
+
+uint16_t PressCapture::visit(PressCaptureVisitor visitor, void* context) const {
+    uint16_t offset = 0;
+    int32_t position = 0;
+    int32_t raw = 0;
+    for (uint16_t i = 0; i < m_count; i++) {
+        bool keyframe = (i % PRESS_CAPTURE_KEYFRAME_INTERVAL) == 0;
+        getVarint(offset);  // dt_us
+        int32_t position_field = unzigzag(getVarint(offset));
+        int32_t raw_field = unzigzag(getVarint(offset));
+        getVarint(offset);  // torque_deci
+        position = keyframe ? position_field : position + position_field;
+        raw = keyframe ? raw_field : raw + raw_field;
+        visitor(context, position, raw);
+    }
+    return m_count;
+}
+
+uint16_t PressCapture::blockEnd(uint16_t block) const {
+    uint16_t next = (uint16_t)((block + 1) * PRESS_CAPTURE_KEYFRAME_INTERVAL);
+    return (next < m_count) ? m_keyframeOffsets[block + 1] : m_length;
+}
+
+uint16_t PressCapture::formatLine(uint16_t first, char* buffer, size_t size) const {
+    if (first >= m_count || (first % PRESS_CAPTURE_KEYFRAME_INTERVAL) != 0) {
+        return 0;
+    }
+
+    // Take as many whole keyframe blocks as fit in one line
+    uint16_t block = first / PRESS_CAPTURE_KEYFRAME_INTERVAL;
+    uint16_t start = m_keyframeOffsets[block];
+    uint16_t end = blockEnd(block);
+    uint16_t last = first + PRESS_CAPTURE_KEYFRAME_INTERVAL;
+    while (last < m_count) {
+        uint16_t next_end = blockEnd(last / PRESS_CAPTURE_KEYFRAME_INTERVAL);
+        if (next_end - start > PRESS_CAPTURE_LINE_BYTES) {
+            break;
+        }
+        end = next_end;
+        last += PRESS_CAPTURE_KEYFRAME_INTERVAL;
+    }
+    if (last > m_count) {
+        last = m_count;
+    }
+
+    int len = snprintf(buffer, size, "CAPTURE:pressboi:DATA:%u:", (unsigned)first);
+    if (len < 0 || (size_t)len + (end - start + 2) / 3 * 4 >= size) {
+        return 0;
+    }
+    base64Encode(m_buffer + start, end - start, buffer + len);
+    return (uint16_t)(last - first);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file press_energy.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the per-sample joule integration of a press.
+ */
+
+#include "press_energy.h"
+#include <math.h>
+#include <stdlib.h>
+
+PressEnergy::PressEnergy() {
+    m_joules.reset();
+    m_machineJ.reset();
+    m_prevSteps = 0;
+    m_baselineSteps = 0;
+    m_prevKg = 0.0f;
+    m_prevValid = false;
+    m_contact = false;
+}
+
+void PressEnergy::begin(long position_steps) {
+    m_prevSteps = position_steps;
+    m_baselineSteps = position_steps;
+    m_machineJ.reset();
+    m_contact = false;
+}
+
+void PressEnergy::clearContact() {
+    m_machineJ.reset();
+    m_contact = false;
+}
+
+PressEnergyStep PressEnergy::add(float force_kg, long position_steps, float limit_kg, float threshold_kg,
+                                 const MachineStrainModel& strain, float mm_per_step, PressEnergyDetail* detail) {
+    float raw_kg = (force_kg < 0.0f) ? 0.0f : force_kg;
+    if (!m_prevValid) {
+        m_prevKg = raw_kg;
+        m_prevSteps = position_steps;
+        m_prevValid = true;
+        return PRESS_ENERGY_HELD;
+    }
+
+    float clamped_kg = raw_kg;
+    if (limit_kg > 0.0f && clamped_kg > limit_kg) {
+        clamped_kg = limit_kg;
+    }
+    long distance_steps = position_steps - m_prevSteps;
+    if (distance_steps == 0) {
+        m_prevKg = clamped_kg;
+        return PRESS_ENERGY_HELD;
+    }
+
+    if (!m_contact) {
+        m_prevSteps = position_steps;
+        m_prevKg = clamped_kg;
+        m_machineJ.reset();
+        if (clamped_kg < threshold_kg) {
+            m_baselineSteps = position_steps;
+            return PRESS_ENERGY_HELD;
+        }
+        // The frame has already given by the deflection at this force; travel counts from there
+        float contact_mm = strain.deflectionFromForce(clamped_kg);
+        if (contact_mm < 0.0f) {
+            contact_mm = 0.0f;
+        }
+        m_baselineSteps = position_steps - lroundf(contact_mm / mm_per_step);
+        m_contact = true;
+        return PRESS_ENERGY_CONTACT;
+    }
+
+    float avg_kg = 0.5f * (m_prevKg + clamped_kg);
+    float total_mm = (float)(position_steps - m_baselineSteps) * mm_per_step;
+    if (total_mm < 0.0f) {
+        total_mm = 0.0f;
+    }
+    // If the axis has travelled 1 mm since the baseline and the frame gives 0.5 mm at this
+    // force, half the increment went into the frame
+    float machine_mm = strain.deflectionFromForce(clamped_kg);
+    float machine_ratio = 0.0f;
+    if (total_mm > 0.001f) {
+        machine_ratio = machine_mm / total_mm;
+        if (machine_ratio > 1.0f) {
+            machine_ratio = 1.0f;
+        }
+        if (machine_ratio < 0.0f) {
+            machine_ratio = 0.0f;
+        }
+    }
+
+    float gross_j = avg_kg * (float)labs(distance_steps) * mm_per_step * 0.00981f;
+    float machine_j = gross_j * machine_ratio;
+    float net_j = gross_j - machine_j;
+    if (net_j < 0.0f) {
+        net_j = 0.0f;
+    }
+    m_joules.add(net_j);
+    m_machineJ.add(machine_j);
+    m_prevSteps = position_steps;
+    m_prevKg = clamped_kg;
+
+    if (detail != NULL) {
+        detail->force_kg = clamped_kg;
+        detail->machine_deflection_mm = machine_mm;
+        detail->total_deflection_mm = total_mm;
+        detail->machine_ratio = machine_ratio;
+    }
+    if (limit_kg > 0.0f && raw_kg >= limit_kg) {
+        // The move stops here; whatever follows is deceleration, not press work
+        m_prevValid = false;
+        return PRESS_ENERGY_LIMIT;
+    }
+    return PRESS_ENERGY_ADDED;
+}
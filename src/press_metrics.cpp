@@ -0,0 +1,87 @@
+/**
+ * @file press_metrics.cpp
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Implements the press metrics accumulated on the controller during a move.
+ */
+
+#include "press_metrics.h"
+#include "dsp_kernels.h"
+#include <math.h>
+#include <stdio.h>
+
+// Global press metrics instance
+PressMetrics g_pressMetrics;
+
+PressMetrics::PressMetrics() {
+    begin(0.0f);
+}
+
+void PressMetrics::begin(float threshold_kg) {
+    m_thresholdKg = threshold_kg;
+    m_peakKg = 0.0f;
+    m_peakPositionMm = 0.0f;
+    m_peakStiffnessKgMm = 0.0f;
+    m_energyJ = 0.0f;
+    m_limitReached = false;
+    m_aboveUs = 0;
+    m_lastTimeUs = 0;
+    m_lastAbove = false;
+    m_samples = 0;
+    m_windowHead = 0;
+    m_windowCount = 0;
+}
+
+void PressMetrics::add(uint32_t time_us, float position_mm, float force_kg, float energy_j, float limit_kg) {
+    // A sample interval counts as loaded when it started loaded
+    if (m_samples > 0 && m_lastAbove) {
+        m_aboveUs += time_us - m_lastTimeUs;
+    }
+    m_lastAbove = force_kg >= m_thresholdKg;
+    m_lastTimeUs = time_us;
+    m_samples++;
+
+    m_windowPos[m_windowHead] = position_mm;
+    m_windowKg[m_windowHead] = force_kg;
+    m_windowHead = (m_windowHead + 1) % PRESS_METRICS_STIFFNESS_WINDOW;
+    if (m_windowCount < PRESS_METRICS_STIFFNESS_WINDOW) {
+        m_windowCount++;
+    }
+
+    if (force_kg > m_peakKg) {
+        m_peakKg = force_kg;
+        m_peakPositionMm = position_mm;
+        m_peakStiffnessKgMm = windowSlope();
+    }
+    if (!m_limitReached) {
+        m_energyJ = energy_j;
+        m_limitReached = limit_kg > 0.0f && force_kg >= limit_kg;
+    }
+}
+
+float PressMetrics::windowSlope() const {
+    if (m_windowCount < PRESS_METRICS_STIFFNESS_WINDOW) {
+        return 0.0f;
+    }
+    // Centre on the first sample so the sums stay well inside float precision; the sums
+    // do not depend on sample order, so the ring is summed as it lies
+    float x[PRESS_METRICS_STIFFNESS_WINDOW];
+    dsp_offset(m_windowPos, -m_windowPos[m_windowHead], x, m_windowCount);
+    float sx = dsp_sum(x, m_windowCount);
+    float sy = dsp_sum(m_windowKg, m_windowCount);
+    float sxx = dsp_dot(x, x, m_windowCount);
+    float sxy = dsp_dot(x, m_windowKg, m_windowCount);
+    float n = (float)m_windowCount;
+    float denom = n * sxx - sx * sx;
+    // No travel across the window (dwell or hard stop): stiffness is undefined
+    if (denom <= 1e-9f * n * n) {
+        return 0.0f;
+    }
+    return fabsf((n * sxy - sx * sy) / denom);
+}
+
+int PressMetrics::format(char* buffer, size_t size) const {
+    return snprintf(buffer, size, "peak_kg=%.2f peak_mm=%.3f energy_j=%.3f stiffness_kg_mm=%.1f above_ms=%lu",
+                    m_peakKg, m_peakPositionMm, m_energyJ, m_peakStiffnessKgMm,
+                    (unsigned long)(m_aboveUs / 1000));
+}
@@ -0,0 +1,493 @@
+/**
+ * @file press_sync.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the leader/follower synchronization of several presses on PRESS_SYNC_PORT.
+ */
+
+#include "press_sync.h"
+
+#if PRESS_SYNC_ENABLED
+
+#include "ClearCore.h"
+#include "lwip/pbuf.h"
+#include <stdio.h>
+#include <string.h>
+
+static_assert(sizeof(PressSyncMessage) == 20, "PressSyncMessage layout is fixed by PRESS_SYNC_VERSION");
+
+// Global press sync instance
+PressSync g_pressSync;
+
+static const char* const kReasonNames[PRESS_SYNC_REASON_COUNT] = {
+    "none", "station stopped", "station paused", "barrier timeout", "link lost", "no clock sync", "run refused"
+};
+
+PressSync::PressSync() {
+    m_pcb = nullptr;
+    m_txRef = nullptr;
+    memset(&m_tx, 0, sizeof(m_tx));
+    m_role = PRESS_SYNC_OFF;
+    m_leaderIp = 0;
+    m_abortReason = PRESS_SYNC_REASON_NONE;
+    m_abortFrom = 0;
+    m_runs = 0;
+    m_aborts = 0;
+    m_dropped = 0;
+    configure(PRESS_SYNC_OFF, IpAddress(0, 0, 0, 0));
+}
+
+bool PressSync::open() {
+    if (m_pcb != nullptr) {
+        return true;
+    }
+    struct udp_pcb* pcb = udp_new();
+    if (pcb == nullptr) {
+        return false;
+    }
+    if (udp_bind(pcb, IP_ADDR_ANY, PRESS_SYNC_PORT) != ERR_OK) {
+        udp_remove(pcb);
+        return false;
+    }
+    m_txRef = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+    if (m_txRef == nullptr) {
+        udp_remove(pcb);
+        return false;
+    }
+    udp_recv(pcb, &PressSync::receive, this);
+    m_pcb = pcb;
+    return true;
+}
+
+void PressSync::configure(PressSyncRole role, const IpAddress& leader) {
+    m_role = role;
+    m_leaderIp = (role == PRESS_SYNC_FOLLOWER) ? uint32_t(leader) : 0;
+    memset(m_peers, 0, sizeof(m_peers));
+    m_inRun = false;
+    m_run = 0;
+    m_runDoneCount = 0;
+    m_released = 0;
+    m_goLeaderUs = 0;
+    m_goSegment = 0;
+    m_armPending = false;
+    m_armRun = 0;
+    m_expectRun = false;
+    m_waitSegment = 0;
+    m_waitSinceMs = 0;
+    m_lastSendMs = 0;
+    m_lastHeardMs = 0;
+    m_abortPending = false;
+    m_lastPingMs = 0;
+    memset(m_clockOffsetUs, 0, sizeof(m_clockOffsetUs));
+    memset(m_clockRttUs, 0, sizeof(m_clockRttUs));
+    m_clockHead = 0;
+    m_clockCount = 0;
+    m_offsetUs = 0;
+    m_bestRttUs = 0;
+}
+
+/**
+ * @details Runs inside EthernetMgr.Refresh() on the main loop, like RegisterMap::receive(),
+ * so the run state is never seen half-updated by service().
+ */
+void PressSync::receive(void* arg, struct udp_pcb* pcb, struct pbuf* p, const ip_addr_t* addr, u16_t port) {
+    (void)pcb;
+    PressSync* self = static_cast<PressSync*>(arg);
+    PressSyncMessage msg;
+    u16_t length = pbuf_copy_partial(p, &msg, sizeof(msg), 0);
+    pbuf_free(p);
+    if (length != sizeof(msg) || msg.magic != PRESS_SYNC_MAGIC || msg.version != PRESS_SYNC_VERSION ||
+        port != PRESS_SYNC_PORT) {
+        self->m_dropped++;
+        return;
+    }
+    self->accept(msg, ip4_addr_get_u32(ip_2_ip4(addr)));
+}
+
+void PressSync::accept(const PressSyncMessage& msg, uint32_t ip) {
+    uint32_t now_ms = Milliseconds();
+    if (m_role == PRESS_SYNC_LEADER) {
+        PressSyncPeer* peer = findPeer(ip, msg.type == PRESS_SYNC_PING);
+        if (peer == nullptr) {
+            m_dropped++;
+            return;
+        }
+        peer->last_ms = now_ms;
+        switch (msg.type) {
+            case PRESS_SYNC_PING:
+                send(ip, PRESS_SYNC_PONG, 0, 0, Microseconds(), msg.time_us);
+                break;
+            case PRESS_SYNC_READY:
+                if (msg.run == m_run && !m_inRun) {
+                    // Waiting on a run that ended here (aborted, or ran fewer segments)
+                    send(ip, PRESS_SYNC_ABORT, 0,
+                         (m_abortReason != PRESS_SYNC_REASON_NONE) ? m_abortReason : PRESS_SYNC_REASON_STOPPED, 0, 0);
+                    break;
+                }
+                peer->ready_run = msg.run;
+                peer->ready_segment = msg.segment;
+                break;
+            case PRESS_SYNC_ABORT:
+                if (m_inRun && msg.run == m_run) {
+                    m_abortPending = true;
+                    m_abortReason = (msg.reason < PRESS_SYNC_REASON_COUNT) ? (PressSyncReason)msg.reason : PRESS_SYNC_REASON_STOPPED;
+                    m_abortFrom = ip;
+                }
+                break;
+            default:
+                m_dropped++;
+                break;
+        }
+        return;
+    }
+
+    if (m_role != PRESS_SYNC_FOLLOWER || ip != m_leaderIp) {
+        m_dropped++;
+        return;
+    }
+    m_lastHeardMs = now_ms;
+    switch (msg.type) {
+        case PRESS_SYNC_PONG: {
+            uint32_t rtt_us = Microseconds() - msg.echo_us;
+            if (rtt_us > PRESS_SYNC_CLOCK_RTT_MAX_US) {
+                break;
+            }
+            // The leader read its clock halfway through the round trip
+            m_clockOffsetUs[m_clockHead] = (int32_t)(msg.time_us - (msg.echo_us + rtt_us / 2));
+            m_clockRttUs[m_clockHead] = rtt_us;
+            m_clockHead = (m_clockHead + 1) % PRESS_SYNC_CLOCK_WINDOW;
+            if (m_clockCount < PRESS_SYNC_CLOCK_WINDOW) {
+                m_clockCount++;
+            }
+            uint8_t best = 0;
+            for (uint8_t i = 1; i < m_clockCount; i++) {
+                if (m_clockRttUs[i] < m_clockRttUs[best]) {
+                    best = i;
+                }
+            }
+            m_offsetUs = m_clockOffsetUs[best];
+            m_bestRttUs = m_clockRttUs[best];
+            break;
+        }
+        case PRESS_SYNC_ARM:
+        case PRESS_SYNC_GO:
+            if (!m_inRun && msg.run == m_run && m_run != 0) {
+                // The leader waits on a run that ended here
+                send(ip, PRESS_SYNC_ABORT, 0,
+                     (m_abortReason != PRESS_SYNC_REASON_NONE) ? m_abortReason : PRESS_SYNC_REASON_STOPPED, 0, 0);
+            } else if (msg.type == PRESS_SYNC_ARM) {
+                if (!m_inRun && msg.segment == 1) {
+                    m_armPending = true;
+                    m_armRun = msg.run;
+                }
+            } else if (m_inRun && msg.run == m_run && msg.segment > m_released) {
+                m_goSegment = msg.segment;
+                m_goLeaderUs = msg.time_us;
+            }
+            break;
+        case PRESS_SYNC_ABORT:
+            if (m_inRun && msg.run == m_run) {
+                m_abortPending = true;
+                m_abortReason = (msg.reason < PRESS_SYNC_REASON_COUNT) ? (PressSyncReason)msg.reason : PRESS_SYNC_REASON_STOPPED;
+                m_abortFrom = ip;
+            }
+            break;
+        default:
+            m_dropped++;
+            break;
+    }
+}
+
+void PressSync::send(uint32_t ip, uint8_t type, uint8_t segment, uint8_t reason, uint32_t time_us, uint32_t echo_us) {
+    if (m_pcb == nullptr || ip == 0) {
+        return;
+    }
+    m_tx.magic = PRESS_SYNC_MAGIC;
+    m_tx.version = PRESS_SYNC_VERSION;
+    m_tx.type = type;
+    m_tx.run = m_run;
+    m_tx.segment = segment;
+    m_tx.reason = reason;
+    m_tx.reserved = 0;
+    m_tx.time_us = time_us;
+    m_tx.echo_us = echo_us;
+    ip_addr_t addr;
+    ip_addr_set_ip4_u32(&addr, ip);
+    m_txRef->payload = &m_tx;
+    m_txRef->len = m_txRef->tot_len = sizeof(m_tx);
+    udp_sendto(m_pcb, m_txRef, &addr, PRESS_SYNC_PORT);
+}
+
+void PressSync::sendFollowers(uint8_t type, uint8_t segment, uint8_t reason, uint32_t time_us) {
+    for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+        if (m_peers[i].ip != 0 && m_peers[i].in_run) {
+            send(m_peers[i].ip, type, segment, reason, time_us, 0);
+        }
+    }
+}
+
+PressSyncPeer* PressSync::findPeer(uint32_t ip, bool add) {
+    PressSyncPeer* free_slot = nullptr;
+    for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+        if (m_peers[i].ip == ip) {
+            return &m_peers[i];
+        }
+        if (m_peers[i].ip == 0 && free_slot == nullptr) {
+            free_slot = &m_peers[i];
+        }
+    }
+    if (!add || free_slot == nullptr) {
+        return nullptr;
+    }
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->ip = ip;
+    return free_slot;
+}
+
+PressSyncAction PressSync::raiseAbort(PressSyncReason reason) {
+    m_abortReason = reason;
+    m_abortFrom = 0;
+    m_aborts++;
+    if (m_inRun) {
+        if (m_role == PRESS_SYNC_LEADER) {
+            sendFollowers(PRESS_SYNC_ABORT, 0, reason, 0);
+        } else {
+            send(m_leaderIp, PRESS_SYNC_ABORT, 0, reason, 0, 0);
+        }
+    }
+    endRun();
+    return PRESS_SYNC_ACTION_ABORT;
+}
+
+void PressSync::endRun() {
+    m_inRun = false;
+    m_released = 0;
+    m_goSegment = 0;
+    m_armPending = false;
+    m_expectRun = false;
+    m_waitSegment = 0;
+    for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+        m_peers[i].in_run = false;
+    }
+}
+
+/**
+ * @details A lost ABORT is made up for by the other side: the leader and the followers
+ * answer any ARM, GO or READY of a run that already ended on their side with an ABORT,
+ * and a press left waiting at a barrier gives up after PRESS_SYNC_BARRIER_TIMEOUT_MS.
+ */
+PressSyncAction PressSync::service(const PressSyncStation& station, uint32_t* release_us) {
+    if (m_role == PRESS_SYNC_OFF) {
+        return PRESS_SYNC_ACTION_NONE;
+    }
+    uint32_t now_ms = Milliseconds();
+
+    if (m_abortPending) {
+        m_abortPending = false;
+        m_aborts++;
+        if (m_role == PRESS_SYNC_LEADER) {
+            sendFollowers(PRESS_SYNC_ABORT, 0, m_abortReason, 0);
+        }
+        endRun();
+        return PRESS_SYNC_ACTION_ABORT;
+    }
+    if (m_expectRun) {
+        m_expectRun = false;
+        if (!station.running) {
+            return raiseAbort(PRESS_SYNC_REASON_REFUSED);
+        }
+    }
+    if (m_inRun && !station.running) {
+        if (station.done_count == m_runDoneCount) {
+            return raiseAbort(PRESS_SYNC_REASON_STOPPED);
+        }
+        endRun();
+    }
+    if (m_inRun && station.paused) {
+        return raiseAbort(PRESS_SYNC_REASON_PAUSED);
+    }
+    if (station.running && station.waiting != 0) {
+        if (station.waiting != m_waitSegment) {
+            m_waitSegment = station.waiting;
+            m_waitSinceMs = now_ms;
+        } else if (now_ms - m_waitSinceMs > PRESS_SYNC_BARRIER_TIMEOUT_MS) {
+            return raiseAbort(PRESS_SYNC_REASON_BARRIER);
+        }
+    } else {
+        m_waitSegment = 0;
+    }
+
+    return (m_role == PRESS_SYNC_LEADER) ? serviceLeader(station, now_ms, release_us)
+                                         : serviceFollower(station, now_ms, release_us);
+}
+
+PressSyncAction PressSync::serviceLeader(const PressSyncStation& station, uint32_t now_ms, uint32_t* release_us) {
+    for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+        PressSyncPeer& peer = m_peers[i];
+        if (peer.ip != 0 && now_ms - peer.last_ms > PRESS_SYNC_LINK_TIMEOUT_MS) {
+            bool lost = m_inRun && peer.in_run;
+            peer.ip = 0;
+            peer.in_run = false;
+            if (lost) {
+                return raiseAbort(PRESS_SYNC_REASON_LINK);
+            }
+        }
+    }
+
+    if (!m_inRun && station.running) {
+        // The followers up now are the ones this run waits for
+        m_inRun = true;
+        m_run++;
+        if (m_run == 0) {
+            m_run = 1;
+        }
+        m_runDoneCount = station.done_count;
+        m_released = 0;
+        m_goSegment = 0;
+        m_abortReason = PRESS_SYNC_REASON_NONE;
+        m_runs++;
+        for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+            m_peers[i].in_run = (m_peers[i].ip != 0);
+        }
+    }
+    if (!m_inRun) {
+        return PRESS_SYNC_ACTION_NONE;
+    }
+
+    if (station.waiting != 0 && station.waiting > m_released) {
+        bool ready = true;
+        bool any = false;
+        for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+            const PressSyncPeer& peer = m_peers[i];
+            if (peer.ip != 0 && peer.in_run) {
+                any = true;
+                if (peer.ready_run != m_run || peer.ready_segment != station.waiting) {
+                    ready = false;
+                }
+            }
+        }
+        if (ready) {
+            m_released = station.waiting;
+            m_goSegment = station.waiting;
+            m_goLeaderUs = Microseconds() + (any ? PRESS_SYNC_LEAD_US : 0);
+            sendFollowers(PRESS_SYNC_GO, m_goSegment, 0, m_goLeaderUs);
+            m_lastSendMs = now_ms;
+            *release_us = m_goLeaderUs;
+            return PRESS_SYNC_ACTION_RELEASE;
+        }
+        if (now_ms - m_lastSendMs >= PRESS_SYNC_RESEND_MS) {
+            sendFollowers(PRESS_SYNC_ARM, station.waiting, 0, 0);
+            m_lastSendMs = now_ms;
+        }
+    } else if (m_goSegment != 0) {
+        // Repeat the GO until its start time, in case one was lost
+        if ((int32_t)(Microseconds() - m_goLeaderUs) >= 0) {
+            m_goSegment = 0;
+        } else if (now_ms - m_lastSendMs >= PRESS_SYNC_RESEND_MS) {
+            sendFollowers(PRESS_SYNC_GO, m_goSegment, 0, m_goLeaderUs);
+            m_lastSendMs = now_ms;
+        }
+    }
+    return PRESS_SYNC_ACTION_NONE;
+}
+
+PressSyncAction PressSync::serviceFollower(const PressSyncStation& station, uint32_t now_ms, uint32_t* release_us) {
+    if (now_ms - m_lastPingMs >= PRESS_SYNC_PING_MS) {
+        send(m_leaderIp, PRESS_SYNC_PING, 0, 0, Microseconds(), 0);
+        m_lastPingMs = now_ms;
+    }
+    if (now_ms - m_lastHeardMs > PRESS_SYNC_LINK_TIMEOUT_MS) {
+        if (m_inRun) {
+            return raiseAbort(PRESS_SYNC_REASON_LINK);
+        }
+        // A silent leader may come back rebooted, with its run numbers from 1 again
+        m_clockCount = 0;
+        m_clockHead = 0;
+        m_armPending = false;
+        m_run = 0;
+        return PRESS_SYNC_ACTION_NONE;
+    }
+
+    if (m_armPending) {
+        m_armPending = false;
+        if (!m_inRun && m_armRun != m_run) {
+            m_inRun = true;
+            m_run = m_armRun;
+            m_runDoneCount = station.done_count;
+            m_released = 0;
+            m_goSegment = 0;
+            m_abortReason = PRESS_SYNC_REASON_NONE;
+            if (!isClockSynced()) {
+                return raiseAbort(PRESS_SYNC_REASON_CLOCK);
+            }
+            m_expectRun = true;
+            m_runs++;
+            return PRESS_SYNC_ACTION_RUN;
+        }
+    }
+
+    if (m_inRun && station.waiting != 0 && station.waiting > m_released) {
+        if (m_goSegment == station.waiting) {
+            m_released = m_goSegment;
+            m_goSegment = 0;
+            *release_us = m_goLeaderUs - (uint32_t)m_offsetUs;
+            return PRESS_SYNC_ACTION_RELEASE;
+        }
+        if (now_ms - m_lastSendMs >= PRESS_SYNC_RESEND_MS) {
+            send(m_leaderIp, PRESS_SYNC_READY, station.waiting, 0, 0, 0);
+            m_lastSendMs = now_ms;
+        }
+    }
+    return PRESS_SYNC_ACTION_NONE;
+}
+
+bool PressSync::isClockSynced() const {
+    return m_clockCount >= PRESS_SYNC_CLOCK_MIN_SAMPLES;
+}
+
+int PressSync::formatStatus(char* buffer, size_t size) const {
+    int len;
+    if (m_role == PRESS_SYNC_FOLLOWER) {
+        IpAddress leader(m_leaderIp);
+        len = snprintf(buffer, size, "role=follower leader=%s clock=%s offset_us=%ld rtt_us=%lu",
+                       leader.StringValue(), isClockSynced() ? "synced" : "none",
+                       (long)m_offsetUs, (unsigned long)m_bestRttUs);
+    } else {
+        uint8_t peers = 0;
+        for (uint8_t i = 0; i < PRESS_SYNC_MAX_PEERS; i++) {
+            if (m_peers[i].ip != 0) {
+                peers++;
+            }
+        }
+        len = snprintf(buffer, size, "role=%s followers=%u", roleName(m_role), (unsigned)peers);
+    }
+    if (len < 0 || (size_t)len >= size) {
+        return len;
+    }
+    return len + snprintf(buffer + len, size - len, " in_run=%d run=%u released=%u runs=%lu aborts=%lu last_abort=%s dropped=%lu",
+                          m_inRun ? 1 : 0, (unsigned)m_run, (unsigned)m_released, (unsigned long)m_runs,
+                          (unsigned long)m_aborts, reasonName(m_abortReason), (unsigned long)m_dropped);
+}
+
+const char* PressSync::reasonName(PressSyncReason reason) {
+    return (reason < PRESS_SYNC_REASON_COUNT) ? kReasonNames[reason] : "unknown";
+}
+
+const char* PressSync::roleName(PressSyncRole role) {
+    switch (role) {
+        case PRESS_SYNC_LEADER:     return "leader";
+        case PRESS_SYNC_FOLLOWER:   return "follower";
+        default:                    return "off";
+    }
+}
+
+bool PressSync::parseAddress(const char* text, IpAddress* ip) {
+    ip4_addr_t addr;
+    if (!ip4addr_aton(text, &addr) || ip4_addr_get_u32(&addr) == 0) {
+        return false;
+    }
+    *ip = IpAddress(ip4_addr_get_u32(&addr));
+    return true;
+}
+
+#endif // PRESS_SYNC_ENABLED
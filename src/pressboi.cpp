@@ -18,6 +18,35 @@
 #include "variables.h"
 #include "events.h"
 #include "error_log.h"
+#include "recipe.h"
+#include "press_capture.h"
+#include "position_curve.h"
+#include "debug_log.h"
+#include "loop_profiler.h"
+#include "benchmark.h"
+#include "loop_scheduler.h"
+#include "trace_log.h"
+#include "hil_test.h"
+#include "cycle_io.h"
+#include "fw_update.h"
+#include "register_map.h"
+#include "press_sync.h"
+#include "force_replay.h"
+#include "sd_log.h"
+#include "crash_snapshot.h"
+#include "settings.h"
+#include "profiles.h"
+#include "units.h"
+#include "base64.h"
+#include "text_format.h"
+#include "control_tick.h"
+#include "memory_map.h"
+#include "cycle_timing.h"
+#include "cycle_estimate.h"
+#include "production_counters.h"
+#include "watchdog_supervisor.h"
+#include "station_io.h"
+#include "idle_work.h"
 #include "NvmManager.h"
 #include <cstring>
 #include <cstdlib>
@@ -40,6 +69,69 @@ static uint32_t g_crashTimeBreadcrumb = 0;
 // Breadcrumb codes are now defined in config.h
 #endif
 
+/**
+ * @brief Gets the name of a watchdog breadcrumb as shown in recovery and crash reports.
+ * @param breadcrumb WD_BREADCRUMB_* code
+ * @return Upper-case location name, or "UNKNOWN"
+ */
+static const char* breadcrumbName(uint32_t breadcrumb) {
+    switch (breadcrumb) {
+        case WD_BREADCRUMB_SAFETY_CHECK:       return "SAFETY_CHECK";
+        case WD_BREADCRUMB_COMMS_UPDATE:       return "COMMS_UPDATE";
+        case WD_BREADCRUMB_RX_DEQUEUE:         return "RX_DEQUEUE";
+        case WD_BREADCRUMB_UPDATE_STATE:       return "UPDATE_STATE";
+        case WD_BREADCRUMB_FORCE_UPDATE:       return "FORCE_UPDATE";
+        case WD_BREADCRUMB_MOTOR_UPDATE:       return "MOTOR_UPDATE";
+        case WD_BREADCRUMB_TELEMETRY:          return "TELEMETRY";
+        case WD_BREADCRUMB_UDP_PROCESS:        return "UDP_PROCESS";
+        case WD_BREADCRUMB_USB_PROCESS:        return "USB_PROCESS";
+        case WD_BREADCRUMB_TX_QUEUE:           return "TX_QUEUE";
+        case WD_BREADCRUMB_UDP_SEND:           return "UDP_SEND";
+        case WD_BREADCRUMB_NETWORK_REFRESH:    return "NETWORK_REFRESH";
+        case WD_BREADCRUMB_USB_SEND:           return "USB_SEND";
+        case WD_BREADCRUMB_USB_RECONNECT:      return "USB_RECONNECT";
+        case WD_BREADCRUMB_USB_RECOVERY:       return "USB_RECOVERY";
+        case WD_BREADCRUMB_REPORT_EVENT:       return "REPORT_EVENT";
+        case WD_BREADCRUMB_ENQUEUE_TX:         return "ENQUEUE_TX";
+        case WD_BREADCRUMB_MOTOR_IS_FAULT:     return "MOTOR_IS_FAULT";
+        case WD_BREADCRUMB_MOTOR_STATE_SWITCH: return "MOTOR_STATE_SWITCH";
+        case WD_BREADCRUMB_PROCESS_TX_QUEUE:   return "PROCESS_TX_QUEUE";
+        case WD_BREADCRUMB_TX_QUEUE_DEQUEUE:   return "TX_QUEUE_DEQUEUE";
+        case WD_BREADCRUMB_TX_QUEUE_UDP:       return "TX_QUEUE_UDP";
+        case WD_BREADCRUMB_TX_QUEUE_USB:       return "TX_QUEUE_USB";
+        case WD_BREADCRUMB_DISPATCH_CMD:       return "DISPATCH_CMD";
+        case WD_BREADCRUMB_PARSE_CMD:          return "PARSE_CMD";
+        case WD_BREADCRUMB_MOTOR_FAULT_REPORT: return "MOTOR_FAULT_REPORT";
+        case WD_BREADCRUMB_STATE_BUSY_CHECK:   return "STATE_BUSY_CHECK";
+        case WD_BREADCRUMB_UDP_PACKET_READ:    return "UDP_PACKET_READ";
+        case WD_BREADCRUMB_RX_ENQUEUE:         return "RX_ENQUEUE";
+        case WD_BREADCRUMB_USB_AVAILABLE:      return "USB_AVAILABLE";
+        case WD_BREADCRUMB_USB_READ:           return "USB_READ";
+        case WD_BREADCRUMB_NETWORK_INPUT:      return "NETWORK_INPUT";
+        case WD_BREADCRUMB_LWIP_INPUT:         return "LWIP_INPUT";
+        case WD_BREADCRUMB_LWIP_TIMEOUT:       return "LWIP_TIMEOUT";
+        case WD_BREADCRUMB_SETUP:              return "SETUP";
+        case WD_BREADCRUMB_SETUP_MOTOR_MODE:   return "SETUP_MOTOR_MODE";
+        case WD_BREADCRUMB_SETUP_COMMS:        return "SETUP_COMMS";
+        case WD_BREADCRUMB_SETUP_MOTOR:        return "SETUP_MOTOR";
+        case WD_BREADCRUMB_SETUP_FORCE:        return "SETUP_FORCE";
+        case WD_BREADCRUMB_SETUP_WD_RECOVERY:  return "SETUP_WD_RECOVERY";
+        case WD_BREADCRUMB_SETUP_WD_INIT:      return "SETUP_WD_INIT";
+        case WD_BREADCRUMB_SETUP_USB:          return "SETUP_USB";
+        case WD_BREADCRUMB_SETUP_ETHERNET:     return "SETUP_ETHERNET";
+        case WD_BREADCRUMB_SETUP_DHCP:         return "SETUP_DHCP";
+        case WD_BREADCRUMB_SETUP_LINK_WAIT:    return "SETUP_LINK_WAIT";
+        default:                               return "UNKNOWN";
+    }
+}
+
+// The press station: ganged motors (reference axis first) and their home sensors
+static const PressStation kPressStation = {
+    { &MOTOR_A, &MOTOR_B, &MOTOR_C, &MOTOR_D },
+    { &HOME_SENSOR_M0, &HOME_SENSOR_M1, &HOME_SENSOR_M2, &HOME_SENSOR_M3 },
+    MOTOR_AXIS_COUNT
+};
+
 //==================================================================================================
 // --- External sendMessage function for events and telemetry ---
 //==================================================================================================
@@ -71,8 +163,14 @@ extern "C" void WDT_Handler(void) {
     WDT->INTFLAG.reg = WDT_INTFLAG_EW;
     
     // Immediately disable all motors to prevent damage
-    MOTOR_A.EnableRequest(false);
-    MOTOR_B.EnableRequest(false);
+    for (int i = 0; i < MOTOR_AXIS_COUNT; i++) {
+        kPressStation.motors[i]->EnableRequest(false);
+    }
+    
+    #if CRASH_SNAPSHOT_ENABLED
+    // Record what the blocked loop was doing before the reset wipes it
+    pressboi.captureCrashSnapshot(CRASH_CAUSE_WATCHDOG, NULL);
+    #endif
     
     // Turn on the LED to indicate watchdog trigger (red/error state)
     ConnectorLed.Mode(Connector::OUTPUT_DIGITAL);
@@ -94,6 +192,35 @@ extern "C" void WDT_Handler(void) {
 }
 #endif
 
+//==================================================================================================
+// --- HardFault Handler ---
+//==================================================================================================
+#if CRASH_SNAPSHOT_ENABLED
+/**
+ * @brief Records a crash snapshot for a HardFault, then resets.
+ * @param frame Exception stack frame (r0-r3, r12, lr, pc, xpsr)
+ */
+extern "C" void hardFaultCapture(const uint32_t* frame) {
+    for (int i = 0; i < MOTOR_AXIS_COUNT; i++) {
+        kPressStation.motors[i]->EnableRequest(false);
+    }
+    pressboi.captureCrashSnapshot(CRASH_CAUSE_HARDFAULT, frame);
+    NVIC_SystemReset();
+}
+
+/**
+ * @brief HardFault handler: picks the stack the fault was taken on and passes its frame on.
+ */
+extern "C" __attribute__((naked)) void HardFault_Handler(void) {
+    __asm volatile(
+        "tst lr, #4      \n"
+        "ite eq          \n"
+        "mrseq r0, msp   \n"
+        "mrsne r0, psp   \n"
+        "b hardFaultCapture \n");
+}
+#endif
+
 //==================================================================================================
 // --- Pressboi Class Implementation ---
 //==================================================================================================
@@ -103,7 +230,9 @@ extern "C" void WDT_Handler(void) {
  */
 Pressboi::Pressboi() :
     m_comms(),
-    m_motor(&MOTOR_A, &MOTOR_B, this)
+    m_forceSensor(0),
+    m_forceSensorB(1),
+    m_motor(kPressStation, this)
 {
     m_mainState = STATE_STANDBY;
     m_lastTelemetryTime = 0;
@@ -111,9 +240,49 @@ Pressboi::Pressboi() :
     m_faultGracePeriodEnd = 0;
     m_homingPending = false;
     m_homingDelayStart = 0;
+    m_captureDumpNext = -1;
+    m_captureDumpCurve = false;
+    m_telemetryBinary = false;
+    m_eventBinary = false;
+    m_eventRequestId = 0;
+    m_operationRequestId = 0;
+    m_captureDumpRequestId = 0;
+    m_dumpJob = DUMP_JOB_NONE;
+    m_dumpLine = 0;
+    m_dumpErrorCount = 0;
+    m_dumpErrorStart = 0;
+    m_dumpHeartbeatCount = 0;
+    m_dumpRunStart = 0;
+    m_dumpRunEnd = 0;
+    m_dumpTraceStart = 0;
+    m_dumpTraceEnd = 0;
+    #if CYCLE_IO_ENABLED
+    m_cycleActive = false;
+    m_cycleDoneCount = 0;
+    #endif
+    #if FW_UPDATE_ENABLED
+    m_fwUpdateState = FW_UPDATE_STATE_IDLE;
+    m_fwUpdateRequestId = 0;
+    #endif
+    m_dumpRequestId = 0;
+    m_telemetrySeq = 0;
+    m_telemetryBusyIntervalMs = TELEMETRY_INTERVAL_MS;
+    m_telemetryIdleIntervalMs = TELEMETRY_INTERVAL_MS;
+    m_telemetryPressIntervalMs = (TELEMETRY_PRESS_RATE_HZ_DEFAULT > 0.0f) ? (uint32_t)(1000.0f / TELEMETRY_PRESS_RATE_HZ_DEFAULT + 0.5f) : 0;
+    m_telemetryPressHoldMs = TELEMETRY_PRESS_HOLD_MS_DEFAULT;
+    m_telemetryPressLastMs = 0;
+    m_telemetryBurst = false;
+    m_telemetryFields = TELEM_FIELDS_ALL;
+    m_telemetryKeyframeMs = 0;
+    m_telemetryLastKeyframe = 0;
+    m_telemetryQueuedFields = 0;
+    m_slowPassesLogged = 0;
+    m_forceDegraded = false;
+    m_slowPassLogTime = 0;
     
     // Initialize telemetry
     telemetry_init(&g_telemetry);
+    telemetry_init(&m_telemetrySent);
 }
 
 /**
@@ -123,10 +292,18 @@ void Pressboi::setup() {
     // IMPORTANT: Capture the crash-time breadcrumb BEFORE overwriting it!
     // This must happen at the very start of setup() to get the true crash location
     // from the previous boot (if it was a watchdog reset).
+    #if CRASH_SNAPSHOT_ENABLED
+    g_crashSnapshot.load();                        // Before anything can fault again
+    #endif
     #if WATCHDOG_ENABLED
     g_crashTimeBreadcrumb = g_watchdogBreadcrumb;  // Capture before overwrite
     g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP;    // Now mark as in setup phase
+    g_watchdogSupervisor.load();                   // Late client of the previous boot, if any
+    TRACE(TRACE_BOOT, RSTC->RCAUSE.reg, g_crashTimeBreadcrumb);
     #endif
+
+    // After the no-init reads above, and while the stack is still shallow
+    g_memoryMap.paintStack();
     
     // Configure all motors for step and direction control mode.
     #if WATCHDOG_ENABLED
@@ -135,29 +312,69 @@ void Pressboi::setup() {
     MotorMgr.MotorModeSet(MotorManager::MOTOR_ALL, Connector::CPM_MODE_STEP_AND_DIR);
 
     // Log firmware startup
-    g_errorLog.log(LOG_INFO, "=== FIRMWARE STARTUP ===");
-    g_errorLog.logf(LOG_INFO, "Firmware version: %s", FIRMWARE_VERSION);
+    ERROR_LOG(LOG_INFO, "=== FIRMWARE STARTUP ===");
+    ERROR_LOGF(LOG_INFO, "Firmware version: %s", FIRMWARE_VERSION);
     
-    // Initialize comms first (can take time for network setup)
-    #if WATCHDOG_ENABLED
-    g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_COMMS;
+    // One NVM read for every persisted setting, before the subsystems that use them
+    SettingsSource settingsSource = g_settings.load();
+    ERROR_LOGF((settingsSource == SETTINGS_SOURCE_BLOCK) ? LOG_INFO : LOG_WARNING,
+               "Settings loaded from %s", SettingsStore::sourceName(settingsSource));
+    g_profileStore.load();
+    g_productionCounters.load();
+    // Before anything converts between steps and mm
+    if (g_driveGeometry.load()) {
+        ERROR_LOGF(LOG_INFO, "Drive geometry %.3f mm/rev, %ld pulses/rev",
+                   g_driveGeometry.getPitchMmPerRev(), (long)g_driveGeometry.getPulsesPerRev());
+    }
+    #if HIL_TEST_ENABLED
+    hil_setup();                                   // Marker pins low before any move can run
     #endif
-    m_comms.setup();
     
+    // Request the motor enable first so the drives come up while everything else initializes.
+    // Nothing in setup() waits: the drive enable, force port settling, Ethernet link and DHCP
+    // all complete in the main loop, and home-on-boot starts as soon as the drives are ready.
     #if WATCHDOG_ENABLED
     g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_MOTOR;
     #endif
+    #if STATION_IO_ENABLED
+    g_stationIo.setup();                           // Tick hook ahead of the motor's interlock check
+    #endif
     m_motor.setup();
     
     #if WATCHDOG_ENABLED
     g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_FORCE;
     #endif
     m_forceSensor.setup();
+    #if !STATION_IO_ENABLED
+    m_forceSensorB.setup();                        // COM-1 carries the CCIO-8 chain otherwise
+    #endif
+    // Channel B shares channel A's persisted limit-path filter and latency
+    m_forceSensorB.setFilter(m_forceSensor.getFilterMedian(), m_forceSensor.getFilterAlpha());
+    m_forceSensorB.setLatencyUs(m_forceSensor.getLatencyUs());
+    
+    // USB, lwIP and the MAC; link-up and DHCP continue from the loop
+    #if WATCHDOG_ENABLED
+    g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_COMMS;
+    #endif
+    m_comms.setup();
+    
+    // Card init and the resume scan run from the sdlog task
+    g_sdLog.setup();
+    g_recipeStore.load();
+    #if CYCLE_IO_ENABLED
+    g_cycleIo.setup();
+    #endif
+    registerLoopTasks();
     
 #if WATCHDOG_ENABLED
-    // Initialize watchdog AFTER comms setup to avoid timeout during network initialization
+    // Initialize watchdog AFTER comms setup (USB and Ethernet init)
     g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_WD_RECOVERY;
     handleWatchdogRecovery();
+#endif
+#if CRASH_SNAPSHOT_ENABLED
+    reportCrashSnapshot();
+#endif
+#if WATCHDOG_ENABLED
     
     g_watchdogBreadcrumb = WD_BREADCRUMB_SETUP_WD_INIT;
     initializeWatchdog();
@@ -174,14 +391,13 @@ void Pressboi::setup() {
         feedWatchdog();  // Feed after each message during startup
         #endif
         
-        g_errorLog.log(LOG_INFO, "Setup complete - normal boot");
+        ERROR_LOG(LOG_INFO, "Setup complete - normal boot");
         
-        // Auto-home will be initiated after a short delay in the main loop
-        // This prevents watchdog timeout during the busy startup/reconnection period
+        // Auto-home starts from the main loop once the drives report enabled
         if (m_motor.getHomeOnBoot()) {
-            m_homingPending = true;  // Flag to initiate homing after delay
-            m_homingDelayStart = 0;  // Will be set in first loop iteration
-            m_comms.reportEvent(STATUS_PREFIX_INFO, "Auto-homing enabled. Will initiate after startup stabilization...");
+            m_homingPending = true;
+            m_homingDelayStart = Milliseconds();
+            m_comms.reportEvent(STATUS_PREFIX_INFO, "Auto-homing enabled. Will initiate once motors are enabled...");
         } else {
             m_comms.reportEvent(STATUS_PREFIX_INFO, "Auto-homing disabled. System ready in standby mode.");
         }
@@ -190,90 +406,507 @@ void Pressboi::setup() {
         feedWatchdog();  // Feed after startup messages
         #endif
     } else {
-        g_errorLog.log(LOG_ERROR, "Setup complete - RECOVERED from watchdog");
+        ERROR_LOG(LOG_ERROR, "Setup complete - RECOVERED from watchdog");
     }
+
+    #if WATCHDOG_ENABLED
+    // From here on the WDT is fed only while every task checks in on time
+    g_watchdogSupervisor.start(Milliseconds());
+    #endif
 }
 
 /**
  * @brief The main execution loop for the Pressboi system.
+ * @details Each subsystem is a LoopScheduler task (registered in registerLoopTasks()), so a
+ * slow TX drain or dump can no longer delay the force and state updates.
  */
 void Pressboi::loop() {
-    // 1. Perform safety checks and feed the watchdog timer.
+    #if LOOP_PROFILER_ENABLED
+    g_loopProfiler.begin();
+    #endif
+    g_loopScheduler.run();
+    #if LOOP_PROFILER_ENABLED
+    g_loopProfiler.end();
+    #endif
+    if (g_loopScheduler.getSlowPassCount() != m_slowPassesLogged) {
+        reportSlowPasses();
+    }
+}
+
+//==================================================================================================
+// --- Private Methods: Main Loop Tasks ---
+//==================================================================================================
+
+/**
+ * @details Critical tasks run every pass in this order: safety check (feeds the watchdog),
+ * force update, state machine. Command intake and press sync come next, then TX and telemetry, then the
+ * dump and debug-record drains and the SD card log, which are the first to wait when a
+ * pass runs long. Idle work (flash writes among it) runs last, and only in passes with
+ * room for its budget.
+ */
+void Pressboi::registerLoopTasks() {
+    g_loopScheduler.registerTask("safety", &Pressboi::safetyTask, this, LOOP_PRIORITY_CRITICAL, 0, 0, LOOP_STAGE_SAFETY);
+    g_loopScheduler.registerTask("force", &Pressboi::forceTask, this, LOOP_PRIORITY_CRITICAL, 0, 0, LOOP_STAGE_FORCE);
+    g_loopScheduler.registerTask("state", &Pressboi::stateTask, this, LOOP_PRIORITY_CRITICAL, 0, 0, LOOP_STAGE_STATE);
+    g_loopScheduler.registerTask("comms", &Pressboi::commsRxTask, this, LOOP_PRIORITY_HIGH, 0,
+                                 LOOP_TASK_COMMS_BUDGET_US, LOOP_STAGE_COMMS);
+    g_loopScheduler.registerTask("commands", &Pressboi::commandTask, this, LOOP_PRIORITY_HIGH, 0,
+                                 CMD_DISPATCH_BUDGET_US, LOOP_STAGE_RX);
+    #if PRESS_SYNC_ENABLED
+    g_loopScheduler.registerTask("sync", &Pressboi::syncTask, this, LOOP_PRIORITY_HIGH, 0,
+                                 LOOP_TASK_SYNC_BUDGET_US, LOOP_STAGE_COMMS);
+    #endif
+    g_loopScheduler.registerTask("tx", &Pressboi::commsTxTask, this, LOOP_PRIORITY_NORMAL, 0,
+                                 LOOP_TASK_TX_BUDGET_US, LOOP_STAGE_TX);
+    g_loopScheduler.registerTask("telemetry", &Pressboi::telemetryTask, this, LOOP_PRIORITY_NORMAL, 0,
+                                 LOOP_TASK_TELEMETRY_BUDGET_US, LOOP_STAGE_TELEMETRY);
+    g_loopScheduler.registerTask("logging", &Pressboi::loggingTask, this, LOOP_PRIORITY_LOW, 0,
+                                 LOOP_TASK_LOGGING_BUDGET_US, LOOP_STAGE_LOGGING);
+    #if SD_LOG_ENABLED
+    g_loopScheduler.registerTask("sdlog", &Pressboi::sdLogTask, this, LOOP_PRIORITY_LOW, 0,
+                                 LOOP_TASK_SD_LOG_BUDGET_US, LOOP_STAGE_LOGGING);
+    #endif
+    g_loopScheduler.registerTask("settings", &Pressboi::settingsTask, this, LOOP_PRIORITY_LOW,
+                                 LOOP_TASK_SETTINGS_PERIOD_US, 0, LOOP_STAGE_LOGGING);
+    #if FW_UPDATE_ENABLED
+    g_loopScheduler.registerTask("fwupdate", &Pressboi::fwUpdateTask, this, LOOP_PRIORITY_LOW, 0,
+                                 LOOP_TASK_FW_UPDATE_BUDGET_US, LOOP_STAGE_LOGGING);
+    #endif
+    g_loopScheduler.registerTask("idle", &Pressboi::idleTask, this, LOOP_PRIORITY_IDLE, 0,
+                                 LOOP_TASK_IDLE_BUDGET_US, LOOP_STAGE_LOGGING);
+
+    #if WATCHDOG_ENABLED
+    g_loopScheduler.setSlowPassDeadline(LOOP_SLOW_PASS_US, &g_watchdogBreadcrumb);
+    #else
+    g_loopScheduler.setSlowPassDeadline(LOOP_SLOW_PASS_US, nullptr);
+    #endif
+}
+
+/**
+ * @details Logs the latest slow pass with how many there have been, at most once per
+ * LOOP_SLOW_PASS_LOG_MS, so a unit drifting toward watchdog resets shows up in the error
+ * log without filling it. The count itself is in telemetry as slow_loops.
+ */
+void Pressboi::reportSlowPasses() {
+    uint32_t now = Milliseconds();
+    if (m_slowPassesLogged != 0 && now - m_slowPassLogTime < LOOP_SLOW_PASS_LOG_MS) {
+        return;
+    }
+    const LoopSlowPass& slow = g_loopScheduler.getLastSlowPass();
+    const char* taskName = (slow.task < g_loopScheduler.getTaskCount()) ? g_loopScheduler.getTask(slow.task).name : "none";
+    ERROR_LOGF(LOG_WARNING, "Slow loop: %lu us, %s %lu us in %s (%lu slow)",
+               (unsigned long)slow.pass_us, taskName, (unsigned long)slow.task_us,
+               breadcrumbName(slow.breadcrumb), (unsigned long)g_loopScheduler.getSlowPassCount());
+    m_slowPassesLogged = g_loopScheduler.getSlowPassCount();
+    m_slowPassLogTime = now;
+}
+
+/**
+ * @details With both cells selected the frame carries the slower rate, the larger jitter
+ * and the summed error count. A cell that is not connected is left to the force-sensor
+ * checks; degraded here means connected but below FORCE_HEALTH_MIN_RATE_HZ, or stuck.
+ */
+void Pressboi::updateForceHealth() {
+    ForceChannelSelect channel = m_motor.getForceChannelSelect();
+    ForceSensor* sensors[2] = { nullptr, nullptr };
+    if (channel != FORCE_CHANNEL_B) {
+        sensors[0] = &m_forceSensor;
+    }
+    if (channel != FORCE_CHANNEL_A) {
+        sensors[1] = &m_forceSensorB;
+    }
+
+    float rate = 0.0f;
+    uint32_t jitter = 0;
+    uint32_t errors = 0;
+    bool stuck = false;
+    bool degraded = false;
+    bool first = true;
+    int degradedIndex = 0;
+    ForceSensorHealth degradedHealth = {};
+    for (int i = 0; i < 2; i++) {
+        if (sensors[i] == nullptr) {
+            continue;
+        }
+        ForceSensorHealth health;
+        sensors[i]->getHealth(&health);
+        if (first || health.rate_hz < rate) {
+            rate = health.rate_hz;
+        }
+        first = false;
+        if (health.jitter_us > jitter) {
+            jitter = health.jitter_us;
+        }
+        errors += sensors[i]->getErrorCount();
+        stuck = stuck || health.stuck;
+        if (sensors[i]->isConnected() && (health.stuck || health.rate_hz < FORCE_HEALTH_MIN_RATE_HZ)) {
+            degraded = true;
+            degradedIndex = i;
+            degradedHealth = health;
+        }
+    }
+    g_telemetry.force_rate_hz = rate;
+    g_telemetry.force_jitter_us = (int32_t)jitter;
+    g_telemetry.force_errors = (int32_t)errors;
+    g_telemetry.force_stuck = stuck ? 1 : 0;
+
+    if (degraded && !m_forceDegraded) {
+        ERROR_LOGF(LOG_WARNING, "Load cell %s degraded: %.1f Hz, jitter %lu us, gap %lu us, %lu errors%s",
+                   (degradedIndex == 0) ? "a" : "b", degradedHealth.rate_hz,
+                   (unsigned long)degradedHealth.jitter_us, (unsigned long)degradedHealth.max_gap_us,
+                   (unsigned long)sensors[degradedIndex]->getErrorCount(),
+                   degradedHealth.stuck ? ", stuck" : "");
+    }
+    m_forceDegraded = degraded;
+}
+
+void Pressboi::safetyTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
     #if WATCHDOG_ENABLED
     g_watchdogBreadcrumb = WD_BREADCRUMB_SAFETY_CHECK;
     #endif
-    performSafetyCheck();
+    static_cast<Pressboi*>(context)->performSafetyCheck();
+}
 
-    // 2. Process all incoming/outgoing communication queues.
+void Pressboi::forceTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    Pressboi* self = static_cast<Pressboi*>(context);
     #if WATCHDOG_ENABLED
-    g_watchdogBreadcrumb = WD_BREADCRUMB_COMMS_UPDATE;
+    g_watchdogBreadcrumb = WD_BREADCRUMB_FORCE_UPDATE;
+    #endif
+    self->m_forceSensor.update();
+    self->m_forceSensorB.update();
+
+    #if FORCE_LINK_NEGOTIATE_ENABLED || FORCE_ZERO_TRACK_ENABLED
+    bool parked = self->m_mainState == STATE_STANDBY && self->m_motor.isRetractedIdle();
+    ForceSensor* sensors[2] = { &self->m_forceSensor, &self->m_forceSensorB };
+    #endif
+    #if FORCE_LINK_NEGOTIATE_ENABLED
+    // Baud switches pause the samples, so they wait for the same idle, retracted press
+    for (int i = 0; i < 2; i++) {
+        if (sensors[i]->serviceLink(parked)) {
+            ForceSensorHealth health;
+            sensors[i]->getHealth(&health);
+            ERROR_LOGF(LOG_INFO, "Load cell %s link: %lu baud, %u Hz", (i == 0) ? "A" : "B",
+                       (unsigned long)health.link_baud, (unsigned)health.link_rate_hz);
+        }
+    }
+    #endif
+
+    #if FORCE_ZERO_TRACK_ENABLED
+    for (int i = 0; i < 2; i++) {
+        if (sensors[i]->trackZero(parked)) {
+            ERROR_LOGF(LOG_WARNING, "Load cell %s zero drift reached %.2f kg; run set_force_zero",
+                       (i == 0) ? "A" : "B", sensors[i]->getZeroTrim());
+        }
+    }
     #endif
-    m_comms.update();
+}
+
+void Pressboi::stateTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    static_cast<Pressboi*>(context)->serviceState();
+}
 
-    // 3. Check for and handle one new command from the receive queue.
+void Pressboi::commsRxTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    Pressboi* self = static_cast<Pressboi*>(context);
     #if WATCHDOG_ENABLED
-    g_watchdogBreadcrumb = WD_BREADCRUMB_RX_DEQUEUE;
+    g_watchdogBreadcrumb = WD_BREADCRUMB_COMMS_UPDATE;
     #endif
-    Message msg;
-    if (m_comms.dequeueRx(msg)) {
-        dispatchCommand(msg);
+    #if REGISTER_MAP_ENABLED
+    self->refreshRegisterImage();
+    #endif
+    self->m_comms.updateRx();
+    #if REGISTER_MAP_ENABLED
+    self->serviceRegisterMailbox();
+    #endif
+}
+
+void Pressboi::commandTask(void* context, uint32_t budget_us) {
+    static_cast<Pressboi*>(context)->serviceCommands(budget_us);
+}
+
+void Pressboi::commsTxTask(void* context, uint32_t budget_us) {
+    Pressboi* self = static_cast<Pressboi*>(context);
+    self->serviceEvents();
+    self->m_comms.updateTx(budget_us);
+}
+
+void Pressboi::telemetryTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    static_cast<Pressboi*>(context)->serviceTelemetry();
+}
+
+void Pressboi::loggingTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    Pressboi* self = static_cast<Pressboi*>(context);
+    self->m_eventRequestId = self->m_captureDumpRequestId;
+    self->serviceCaptureDump();
+    self->m_eventRequestId = self->m_dumpRequestId;
+    self->serviceDumpJob();
+    self->m_eventRequestId = 0;
+    self->serviceDebugLog();
+}
+
+void Pressboi::sdLogTask(void* context, uint32_t budget_us) {
+    (void)context;
+    // Error log entries reach the card from here, so logging itself stays interrupt-safe
+    g_errorLog.serviceSdLog();
+    g_sdLog.service(budget_us);
+}
+
+void Pressboi::settingsTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    Pressboi* self = static_cast<Pressboi*>(context);
+    if (!g_nvmJournal.isIdle() || !g_profileStore.isIdle() || g_settings.isDirty() || self->nvmTablesPending()) {
+        g_idleWork.post("flash", &Pressboi::flashJob, context);
+    }
+}
+
+#if PRESS_SYNC_ENABLED
+void Pressboi::syncTask(void* context, uint32_t budget_us) {
+    (void)budget_us;
+    static_cast<Pressboi*>(context)->serviceSync();
+}
+
+/**
+ * @details Runs every pass while a role is set, network or not, so a link lost in a run
+ * still stops it here. A follower's run is started as the cycle input starts one; a stop
+ * asked for by sync goes through abort() like any other.
+ */
+void Pressboi::serviceSync() {
+    if (g_pressSync.getRole() == PRESS_SYNC_OFF) {
+        return;
+    }
+    if (m_comms.isNetworkReady()) {
+        g_pressSync.open();
+    }
+    PressSyncStation station;
+    station.running = m_motor.isRecipeRunning();
+    station.waiting = m_motor.getSyncWaitSegment();
+    station.paused = m_motor.isPaused();
+    station.done_count = m_motor.getRecipeDoneCount();
+    uint32_t release_us = 0;
+    char msg[STATUS_MESSAGE_BUFFER_SIZE];
+    switch (g_pressSync.service(station, &release_us)) {
+        case PRESS_SYNC_ACTION_RUN: {
+            if (m_mainState != STATE_STANDBY || m_motor.isBusy() || g_recipeStore.getStepCount() == 0) {
+                // Not running next pass, so the leader is told the run was refused
+                reportEvent(STATUS_PREFIX_ERROR, "Sync run refused: press not idle or no recipe stored.");
+                break;
+            }
+            CommandArgs args;
+            memset(&args, 0, sizeof(args));
+            args.count = 1;
+            strncpy(args.run_recipe.name, g_recipeStore.getName(), sizeof(args.run_recipe.name) - 1);
+            m_motor.handleCommand(CMD_RUN_RECIPE, &args);
+            snprintf(msg, sizeof(msg), "Sync run: running '%s' with the leader.", g_recipeStore.getName());
+            reportEvent(STATUS_PREFIX_INFO, msg);
+            break;
+        }
+        case PRESS_SYNC_ACTION_RELEASE:
+            m_motor.releaseSyncSegment(release_us);
+            break;
+        case PRESS_SYNC_ACTION_ABORT: {
+            const char* reason = PressSync::reasonName(g_pressSync.getAbortReason());
+            if (g_pressSync.getAbortFrom() != 0) {
+                IpAddress from(g_pressSync.getAbortFrom());
+                snprintf(msg, sizeof(msg), "Sync abort: %s (from %s).", reason, from.StringValue());
+            } else {
+                snprintf(msg, sizeof(msg), "Sync abort: %s (here).", reason);
+            }
+            reportEvent(STATUS_PREFIX_ERROR, msg);
+            if (m_motor.isBusy()) {
+                abort();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+#endif
+
+void Pressboi::idleTask(void* context, uint32_t budget_us) {
+    Pressboi* self = static_cast<Pressboi*>(context);
+    g_idleWork.service(self->m_mainState == STATE_STANDBY && !self->m_motor.isBusy(), budget_us);
+}
+
+/**
+ * @details Queued by settingsTask() and run as idle work, so no erase or write starts
+ * during a press; changes made meanwhile stay in RAM and coalesce. A settings commit or
+ * table write is one user-page erase/write and cannot be split, so that step may overrun
+ * the budget; at most one of them runs per call.
+ * @return true while a store still has work
+ */
+bool Pressboi::flashJob(void* context, uint32_t budget_us) {
+    Pressboi* self = static_cast<Pressboi*>(context);
+    (void)budget_us;
+    #if FW_UPDATE_ENABLED
+    // A firmware update owns NVMCTRL while it stages; the stores keep their changes pending
+    if (g_firmwareUpdate.ownsFlash()) {
+        return false;
+    }
+    #endif
+    // Journal and profile steps only start flash operations, and run from bank A while bank B
+    // is busy. NVMCTRL takes one operation at a time, so a profile rewrite runs to the end
+    // before the journal moves on.
+    if (!g_profileStore.isIdle()) {
+        g_profileStore.service();
+    } else {
+        g_nvmJournal.service();
+        if (g_nvmJournal.isIdle()) {
+            g_profileStore.service();
+        }
+    }
+    // The block write holds up the loop for a few ms; keep it out of journal and profile work
+    bool flashFree = g_nvmJournal.isIdle() && g_profileStore.isIdle();
+    uint32_t commits = g_settings.getCommitCount();
+    g_settings.service(flashFree);
+    if (flashFree && g_settings.getCommitCount() == commits) {
+        self->commitNvmTable();
+    }
+    return !g_nvmJournal.isIdle() || !g_profileStore.isIdle() || g_settings.isDirty() || self->nvmTablesPending();
+}
+
+bool Pressboi::nvmTablesPending() const {
+    return m_forceSensor.isLinearizationPending() || m_motor.isTorqueFrictionPending() ||
+           g_driveGeometry.isPending() || g_recipeStore.isPending();
+}
+
+bool Pressboi::commitNvmTable() {
+    if (m_forceSensor.isLinearizationPending()) {
+        return m_forceSensor.commitLinearization();
+    }
+    if (m_motor.isTorqueFrictionPending()) {
+        return m_motor.commitTorqueFriction();
+    }
+    if (g_driveGeometry.isPending()) {
+        return g_driveGeometry.commit();
+    }
+    return g_recipeStore.commit();
+}
+
+#if FW_UPDATE_ENABLED
+void Pressboi::fwUpdateTask(void* context, uint32_t budget_us) {
+    g_firmwareUpdate.service(budget_us);
+    static_cast<Pressboi*>(context)->serviceFirmwareUpdate();
+}
+
+/**
+ * @details The switch-over leaves nothing running: settings waiting for their commit
+ * delay are written first, the drives are disabled and the watchdog stopped (the copy
+ * takes longer than its timeout), then interrupts go off for good.
+ */
+void Pressboi::serviceFirmwareUpdate() {
+    uint8_t state = g_firmwareUpdate.getState();
+    if (state != m_fwUpdateState) {
+        m_fwUpdateState = state;
+        m_eventRequestId = m_fwUpdateRequestId;
+        char msg[STATUS_MESSAGE_BUFFER_SIZE];
+        if (state == FW_UPDATE_STATE_RECEIVING) {
+            snprintf(msg, sizeof(msg), "fw_update: staging area erased; send the %lu-byte image to TCP port %d.",
+                     (unsigned long)g_firmwareUpdate.getSize(), FW_UPDATE_PORT);
+            reportEvent(STATUS_PREFIX_INFO, msg);
+        } else if (state == FW_UPDATE_STATE_STAGED) {
+            snprintf(msg, sizeof(msg), "fw_update: %lu bytes staged, CRC %08lX verified. Send 'fw_update apply' to switch over.",
+                     (unsigned long)g_firmwareUpdate.getSize(), (unsigned long)g_firmwareUpdate.getCrc());
+            reportEvent(STATUS_PREFIX_INFO, msg);
+            reportEvent(STATUS_PREFIX_DONE, "fw_update");
+        } else if (state == FW_UPDATE_STATE_FAILED) {
+            snprintf(msg, sizeof(msg), "fw_update failed after %lu of %lu bytes: %s",
+                     (unsigned long)g_firmwareUpdate.getReceived(), (unsigned long)g_firmwareUpdate.getSize(),
+                     g_firmwareUpdate.getError());
+            reportEvent(STATUS_PREFIX_ERROR, msg);
+        }
+        m_eventRequestId = 0;
+    }
+    if (!g_firmwareUpdate.isApplyDue(Milliseconds())) {
+        return;
     }
+    g_settings.commit();
+    while (nvmTablesPending() && commitNvmTable()) {
+        // Tables saved since the last idle spell
+    }
+    m_motor.disable();
+    #if WATCHDOG_ENABLED
+    WDT->CTRLA.reg = 0;
+    while(WDT->SYNCBUSY.reg);
+    #endif
+    __disable_irq();
+    g_firmwareUpdate.switchOver();
+}
+#endif
 
-    // 4. Update force sensor readings.
+/**
+ * @details Handles queued commands until the dispatch budget is spent, so a burst of
+ * configuration commands applies in one pass. A command that starts an operation ends
+ * the burst: the state machine has to see it before the next command is checked. Each
+ * command is parsed in place in its RX slot and released once dispatched.
+ */
+void Pressboi::serviceCommands(uint32_t budget_us) {
     #if WATCHDOG_ENABLED
-    g_watchdogBreadcrumb = WD_BREADCRUMB_FORCE_UPDATE;
+    g_watchdogBreadcrumb = WD_BREADCRUMB_RX_DEQUEUE;
     #endif
-    m_forceSensor.update();
+    MessageView msg;
+    // Several commands per pass, so a datagram or queue burst does not wait a pass per line.
+    // CMD_DISPATCH_BUDGET_US drains RX_QUEUE_SIZE settings commands in a few passes and keeps
+    // a pass near LOOP_SCHEDULER_PASS_BUDGET_US, far from LOOP_SLOW_PASS_US and the watchdog
+    uint32_t dispatchStart = Microseconds();
+    while (m_comms.peekRx(msg)) {
+        MainState stateBefore = m_mainState;
+        bool busyBefore = m_motor.isBusy();
+        // Replies carry the command's request ID; an operation it starts keeps the ID for
+        // the events (and DONE) it reports later
+        m_eventRequestId = takeRequestId(msg);
+        dispatchCommand(msg);
+        m_comms.consumeRx();
+        bool busyAfter = m_motor.isBusy();
+        if (busyAfter && !busyBefore) {
+            m_operationRequestId = m_eventRequestId;
+        }
+        m_eventRequestId = 0;
+        // A command that changed the state or started/stopped a move ends the batch: the next
+        // one is checked after the state task has run in the new state, and the busy edge
+        // is what ties the operation's request ID to the command that started it
+        if (m_mainState != stateBefore || busyAfter != busyBefore ||
+            Microseconds() - dispatchStart >= budget_us) {
+            break;
+        }
+    }
+}
 
-    // 5. Update the main state machine and all sub-controllers.
+void Pressboi::serviceState() {
     #if WATCHDOG_ENABLED
     g_watchdogBreadcrumb = WD_BREADCRUMB_UPDATE_STATE;
     #endif
+    m_eventRequestId = m_operationRequestId;
     updateState();
+    if (!m_motor.isBusy()) {
+        m_operationRequestId = 0;
+    }
+    m_eventRequestId = 0;
+    #if CYCLE_IO_ENABLED
+    serviceCycleIo();
+    #endif
 
-    // 6. Handle time-based periodic tasks.
     uint32_t now = Milliseconds();
-	
-    // Always send telemetry (for both network and USB)
-    if (now - m_lastTelemetryTime >= TELEMETRY_INTERVAL_MS) {
-        // Skip telemetry if we're too close to discovery time (network may not be stable yet)
-        static uint32_t discoveryTime = 0;
-        static bool wasDiscovered = false;
-        if (!wasDiscovered && m_comms.isGuiDiscovered()) {
-            discoveryTime = now;
-            wasDiscovered = true;
-        }
-        if (!m_comms.isGuiDiscovered()) {
-            wasDiscovered = false;
-        }
-        
-        // Wait at least 500ms after GUI discovery before sending (only affects network, USB always works)
-        bool skipForNetworkStability = m_comms.isGuiDiscovered() && (now - discoveryTime < 500);
-        
-        if (!skipForNetworkStability) {
-            #if WATCHDOG_ENABLED
-            g_watchdogBreadcrumb = WD_BREADCRUMB_TELEMETRY;
-            #endif
-            m_lastTelemetryTime = now;
-            publishTelemetry();
-        } else {
-            m_lastTelemetryTime = now; // Reset timer so we don't immediately spam after 500ms
-        }
-    }
-    
-    // Handle delayed auto-homing on boot (prevents watchdog timeout during busy startup)
+    // Auto-home on boot as soon as both drives are enabled and the force ports have settled.
+    // Comms need not be up: homing runs from the loop while the network comes up alongside.
     if (m_homingPending && m_mainState == STATE_STANDBY) {
-        // Initialize delay timer on first iteration
-        if (m_homingDelayStart == 0) {
-            m_homingDelayStart = now;
-        }
-        
-        // Wait 2 seconds after startup before initiating homing
-        // This allows USB/network to stabilize and message queues to clear
-        if (now - m_homingDelayStart > 2000) {
+        bool ready = m_motor.drivesEnabled() && m_forceSensor.isSettled() && m_forceSensorB.isSettled();
+        bool timedOut = now - m_homingDelayStart > HOMING_BOOT_ENABLE_TIMEOUT_MS;
+        if (ready || timedOut) {
             m_homingPending = false;
-            m_comms.reportEvent(STATUS_PREFIX_INFO, "Initiating delayed auto-home sequence...");
-            m_motor.handleCommand(CMD_HOME, "");
+            if (!ready) {
+                // home() reports which motor is not enabled
+                ERROR_LOG(LOG_WARNING, "Motor enable timeout before auto-home");
+            }
+            m_comms.reportEvent(STATUS_PREFIX_INFO, "Initiating auto-home sequence...");
+            CommandArgs homeArgs;
+            parseCommandArgs(CMD_HOME, NULL, &homeArgs);
+            m_motor.handleCommand(CMD_HOME, &homeArgs);
         }
     }
     
@@ -284,56 +917,8 @@ void Pressboi::loop() {
         
         // Build recovery message with breadcrumb captured at boot time
         // (not g_watchdogBreadcrumb which changes during normal operation)
-        char recoveryMsg[128];
-        const char* breadcrumb_name = "UNKNOWN";
-        switch (g_crashTimeBreadcrumb) {
-            case WD_BREADCRUMB_SAFETY_CHECK: breadcrumb_name = "SAFETY_CHECK"; break;
-            case WD_BREADCRUMB_COMMS_UPDATE: breadcrumb_name = "COMMS_UPDATE"; break;
-            case WD_BREADCRUMB_RX_DEQUEUE: breadcrumb_name = "RX_DEQUEUE"; break;
-            case WD_BREADCRUMB_UPDATE_STATE: breadcrumb_name = "UPDATE_STATE"; break;
-            case WD_BREADCRUMB_FORCE_UPDATE: breadcrumb_name = "FORCE_UPDATE"; break;
-            case WD_BREADCRUMB_MOTOR_UPDATE: breadcrumb_name = "MOTOR_UPDATE"; break;
-            case WD_BREADCRUMB_TELEMETRY: breadcrumb_name = "TELEMETRY"; break;
-            case WD_BREADCRUMB_UDP_PROCESS: breadcrumb_name = "UDP_PROCESS"; break;
-            case WD_BREADCRUMB_USB_PROCESS: breadcrumb_name = "USB_PROCESS"; break;
-            case WD_BREADCRUMB_TX_QUEUE: breadcrumb_name = "TX_QUEUE"; break;
-            case WD_BREADCRUMB_UDP_SEND: breadcrumb_name = "UDP_SEND"; break;
-            case WD_BREADCRUMB_NETWORK_REFRESH: breadcrumb_name = "NETWORK_REFRESH"; break;
-            case WD_BREADCRUMB_USB_SEND: breadcrumb_name = "USB_SEND"; break;
-            case WD_BREADCRUMB_USB_RECONNECT: breadcrumb_name = "USB_RECONNECT"; break;
-            case WD_BREADCRUMB_USB_RECOVERY: breadcrumb_name = "USB_RECOVERY"; break;
-            case WD_BREADCRUMB_REPORT_EVENT: breadcrumb_name = "REPORT_EVENT"; break;
-            case WD_BREADCRUMB_ENQUEUE_TX: breadcrumb_name = "ENQUEUE_TX"; break;
-            case WD_BREADCRUMB_MOTOR_IS_FAULT: breadcrumb_name = "MOTOR_IS_FAULT"; break;
-            case WD_BREADCRUMB_MOTOR_STATE_SWITCH: breadcrumb_name = "MOTOR_STATE_SWITCH"; break;
-            case WD_BREADCRUMB_PROCESS_TX_QUEUE: breadcrumb_name = "PROCESS_TX_QUEUE"; break;
-            case WD_BREADCRUMB_TX_QUEUE_DEQUEUE: breadcrumb_name = "TX_QUEUE_DEQUEUE"; break;
-            case WD_BREADCRUMB_TX_QUEUE_UDP: breadcrumb_name = "TX_QUEUE_UDP"; break;
-            case WD_BREADCRUMB_TX_QUEUE_USB: breadcrumb_name = "TX_QUEUE_USB"; break;
-            case WD_BREADCRUMB_DISPATCH_CMD: breadcrumb_name = "DISPATCH_CMD"; break;
-            case WD_BREADCRUMB_PARSE_CMD: breadcrumb_name = "PARSE_CMD"; break;
-            case WD_BREADCRUMB_MOTOR_FAULT_REPORT: breadcrumb_name = "MOTOR_FAULT_REPORT"; break;
-            case WD_BREADCRUMB_STATE_BUSY_CHECK: breadcrumb_name = "STATE_BUSY_CHECK"; break;
-            case WD_BREADCRUMB_UDP_PACKET_READ: breadcrumb_name = "UDP_PACKET_READ"; break;
-            case WD_BREADCRUMB_RX_ENQUEUE: breadcrumb_name = "RX_ENQUEUE"; break;
-            case WD_BREADCRUMB_USB_AVAILABLE: breadcrumb_name = "USB_AVAILABLE"; break;
-            case WD_BREADCRUMB_USB_READ: breadcrumb_name = "USB_READ"; break;
-            case WD_BREADCRUMB_NETWORK_INPUT: breadcrumb_name = "NETWORK_INPUT"; break;
-            case WD_BREADCRUMB_LWIP_INPUT: breadcrumb_name = "LWIP_INPUT"; break;
-            case WD_BREADCRUMB_LWIP_TIMEOUT: breadcrumb_name = "LWIP_TIMEOUT"; break;
-            case WD_BREADCRUMB_SETUP: breadcrumb_name = "SETUP"; break;
-            case WD_BREADCRUMB_SETUP_MOTOR_MODE: breadcrumb_name = "SETUP_MOTOR_MODE"; break;
-            case WD_BREADCRUMB_SETUP_COMMS: breadcrumb_name = "SETUP_COMMS"; break;
-            case WD_BREADCRUMB_SETUP_MOTOR: breadcrumb_name = "SETUP_MOTOR"; break;
-            case WD_BREADCRUMB_SETUP_FORCE: breadcrumb_name = "SETUP_FORCE"; break;
-            case WD_BREADCRUMB_SETUP_WD_RECOVERY: breadcrumb_name = "SETUP_WD_RECOVERY"; break;
-            case WD_BREADCRUMB_SETUP_WD_INIT: breadcrumb_name = "SETUP_WD_INIT"; break;
-            case WD_BREADCRUMB_SETUP_USB: breadcrumb_name = "SETUP_USB"; break;
-            case WD_BREADCRUMB_SETUP_ETHERNET: breadcrumb_name = "SETUP_ETHERNET"; break;
-            case WD_BREADCRUMB_SETUP_DHCP: breadcrumb_name = "SETUP_DHCP"; break;
-            case WD_BREADCRUMB_SETUP_LINK_WAIT: breadcrumb_name = "SETUP_LINK_WAIT"; break;
-        }
-        snprintf(recoveryMsg, sizeof(recoveryMsg), "Watchdog timeout in %s - main loop blocked >256ms. Motors disabled. Send RESET to clear.", breadcrumb_name);
+        char recoveryMsg[160];
+        formatRecoveryMessage(recoveryMsg, sizeof(recoveryMsg));
         reportEvent(STATUS_PREFIX_RECOVERY, recoveryMsg);
     }
     
@@ -343,16 +928,92 @@ void Pressboi::loop() {
     }
 }
 
+#if CYCLE_IO_ENABLED
+/**
+ * @details Runs in the state task right after updateState(), so a cycle's end shows on the
+ * outputs in the pass the motor went idle. A cycle passes if run_recipe sent its DONE; a
+ * start while the press is busy, in error or has no recipe fails without moving.
+ */
+void Pressboi::serviceCycleIo() {
+    uint32_t edge_us = 0;
+    bool start = g_cycleIo.takeStart(&edge_us);
+    if (m_cycleActive) {
+        if (m_motor.isBusy()) {
+            if (start) {
+                reportEvent(STATUS_PREFIX_INFO, "Cycle start ignored: a cycle is running.");
+            }
+            return;
+        }
+        m_cycleActive = false;
+        g_cycleIo.show((m_motor.getRecipeDoneCount() != m_cycleDoneCount) ? CYCLE_OUTPUT_PASS : CYCLE_OUTPUT_FAIL);
+    }
+    if (!start) {
+        return;
+    }
+    if (m_mainState != STATE_STANDBY || m_motor.isBusy() || g_recipeStore.getStepCount() == 0) {
+        reportEvent(STATUS_PREFIX_ERROR, "Cycle start refused: press not idle or no recipe stored.");
+        g_cycleIo.show(CYCLE_OUTPUT_FAIL);
+        return;
+    }
+
+    CommandArgs args;
+    memset(&args, 0, sizeof(args));
+    args.count = 1;
+    strncpy(args.run_recipe.name, g_recipeStore.getName(), sizeof(args.run_recipe.name) - 1);
+    m_cycleDoneCount = m_motor.getRecipeDoneCount();
+    m_motor.handleCommand(CMD_RUN_RECIPE, &args);
+    if (!m_motor.isBusy()) {
+        // Refused (not homed, bad step) or already complete; run_recipe has reported which
+        g_cycleIo.show((m_motor.getRecipeDoneCount() != m_cycleDoneCount) ? CYCLE_OUTPUT_PASS : CYCLE_OUTPUT_FAIL);
+        return;
+    }
+    m_cycleActive = true;
+    g_cycleIo.show(CYCLE_OUTPUT_BUSY);
+    char msg[STATUS_MESSAGE_BUFFER_SIZE];
+    snprintf(msg, sizeof(msg), "Cycle start input: running '%s', %lu us after the edge (%s).", g_recipeStore.getName(),
+             (unsigned long)(Microseconds() - edge_us), g_cycleIo.isLatched() ? "latched" : "polled");
+    reportEvent(STATUS_PREFIX_INFO, msg);
+}
+#endif
+
+void Pressboi::serviceTelemetry() {
+    uint32_t now = Milliseconds();
+    // Always send telemetry (for both network and USB)
+    uint32_t telemetryInterval = (m_mainState == STATE_BUSY) ? m_telemetryBusyIntervalMs : m_telemetryIdleIntervalMs;
+    if (m_telemetryPressIntervalMs > 0) {
+        if (m_motor.isPressing()) {
+            m_telemetryPressLastMs = now;
+            m_telemetryBurst = true;
+        } else if (m_telemetryBurst && now - m_telemetryPressLastMs > m_telemetryPressHoldMs) {
+            m_telemetryBurst = false;
+        }
+        if (m_telemetryBurst && m_telemetryPressIntervalMs < telemetryInterval) {
+            telemetryInterval = m_telemetryPressIntervalMs;
+        }
+    }
+    if (now - m_lastTelemetryTime >= telemetryInterval) {
+        #if WATCHDOG_ENABLED
+        g_watchdogBreadcrumb = WD_BREADCRUMB_TELEMETRY;
+        #endif
+        m_lastTelemetryTime = now;
+        // Telemetry has its own TX lane, so even high rates never crowd out events. A newly
+        // discovered GUI gets frames as soon as its address resolves (see udpPathResolved())
+        publishTelemetry();
+    }
+}
+
 //==================================================================================================
 // --- Private Methods: State, Command, and Telemetry Handling ---
 //==================================================================================================
 
 /**
- * @brief Performs safety checks and feeds the watchdog timer.
+ * @brief Performs safety checks and feeds the watchdog timer while every supervised task is on time.
  */
 void Pressboi::performSafetyCheck() {
 #if WATCHDOG_ENABLED
-    feedWatchdog();
+    if (g_watchdogSupervisor.service(Milliseconds())) {
+        feedWatchdog();
+    }
     
     // Note: Motor fault detection is handled in updateState() as part of the normal state machine
     // This function focuses on feeding the watchdog and can be extended with additional
@@ -393,7 +1054,7 @@ void Pressboi::updateState() {
                 g_watchdogBreadcrumb = WD_BREADCRUMB_MOTOR_FAULT_REPORT;
                 #endif
                 m_mainState = STATE_ERROR;
-                g_errorLog.log(LOG_ERROR, "Motor fault detected -> ERROR state");
+                ERROR_LOG(LOG_ERROR, "Motor fault detected -> ERROR state");
                 reportEvent(STATUS_PREFIX_ERROR, "Motor fault detected. System entering ERROR state. Use CLEAR_ERRORS to reset.");
                 break;
             }
@@ -404,7 +1065,7 @@ void Pressboi::updateState() {
             #endif
             MainState newState = m_motor.isBusy() ? STATE_BUSY : STATE_STANDBY;
             if (newState != m_mainState) {
-                g_errorLog.logf(LOG_DEBUG, "State: %s -> %s", 
+                ERROR_LOGF(LOG_DEBUG, "State: %s -> %s", 
                     (m_mainState == STATE_STANDBY) ? "STANDBY" : "BUSY",
                     (newState == STATE_STANDBY) ? "STANDBY" : "BUSY");
             }
@@ -439,8 +1100,9 @@ void Pressboi::updateState() {
             // Phase 2: Start motor enable (only once, when enable state is IDLE)
             if (m_motor.getEnableState() == ENABLE_IDLE) {
                 // Clear any motor faults before re-enabling
-                MOTOR_A.ClearAlerts();
-                MOTOR_B.ClearAlerts();
+                for (int i = 0; i < MOTOR_AXIS_COUNT; i++) {
+                    kPressStation.motors[i]->ClearAlerts();
+                }
                 
                 // Start non-blocking motor enable
                 m_motor.enable();
@@ -478,50 +1140,69 @@ void Pressboi::updateState() {
  * @brief Master command handler; acts as a switchboard to delegate tasks.
  * @param msg The message object containing the command string and remote IP details.
  */
-void Pressboi::dispatchCommand(const Message& msg) {
+void Pressboi::dispatchCommand(const MessageView& msg) {
     #if WATCHDOG_ENABLED
     g_watchdogBreadcrumb = WD_BREADCRUMB_PARSE_CMD;
     #endif
     Command command_enum = parseCommand(msg.buffer);
+
+    // Isolate arguments by finding the first space in the command string.
+    const char* args = strchr(msg.buffer, ' ');
+    if (args) {
+        args++; // Move pointer past the space to the start of the arguments.
+    }
+
+    // Decode the arguments once, from text or from a "cmdb" binary frame
+    CommandArgs cmdArgs;
+    bool argsValid;
+    if (command_enum == CMD_CMDB) {
+        size_t frameLength = args ? base64Decode(args, m_commandFrame, sizeof(m_commandFrame) - 1) : 0;
+        argsValid = decodeCommandFrame(m_commandFrame, frameLength, sizeof(m_commandFrame), &command_enum, &cmdArgs);
+        if (!argsValid) {
+            reportEvent(STATUS_PREFIX_ERROR, "Invalid binary command frame for cmdb");
+            return;
+        }
+    } else {
+        argsValid = parseCommandArgs(command_enum, args, &cmdArgs);
+    }
     
     #if WATCHDOG_ENABLED
     g_watchdogBreadcrumb = WD_BREADCRUMB_DISPATCH_CMD;
     #endif
+    TRACE(TRACE_COMMAND, command_enum, m_eventRequestId);
     
     // Log incoming commands (except telemetry spam and discovery)
     if (command_enum != CMD_DISCOVER_DEVICE) {
-        g_errorLog.logf(LOG_DEBUG, "Dispatch cmd: %s", msg.buffer);
+        ERROR_LOGF(LOG_DEBUG, "Dispatch cmd: %s", msg.buffer);
     }
     
     // If the system is in RECOVERED state, block ALL commands except reset
     if (m_mainState == STATE_RECOVERED) {
-        if (command_enum != CMD_DISCOVER_DEVICE && command_enum != CMD_RESET && command_enum != CMD_DUMP_ERROR_LOG) {
-            m_comms.reportEvent(STATUS_PREFIX_ERROR, "Command ignored: System in RECOVERED state from watchdog timeout. Send RESET to clear.");
-            g_errorLog.logf(LOG_WARNING, "Cmd blocked (RECOVERED): %s", msg.buffer);
+        if (command_enum != CMD_DISCOVER_DEVICE && command_enum != CMD_RESET && command_enum != CMD_DUMP_ERROR_LOG &&
+            command_enum != CMD_DUMP_PERF && command_enum != CMD_DUMP_TRACE && command_enum != CMD_DUMP_CRASH &&
+            command_enum != CMD_DUMP_MEM && command_enum != CMD_DUMP_CYCLE_TIMES) {
+            reportEvent(STATUS_PREFIX_ERROR, "Command ignored: System in RECOVERED state from watchdog timeout. Send RESET to clear.");
+            ERROR_LOGF(LOG_WARNING, "Cmd blocked (RECOVERED): %s", msg.buffer);
             return;
         }
     }
     
     // If the system is in an error state, block most commands.
     if (m_mainState == STATE_ERROR) {
-        if (command_enum != CMD_DISCOVER_DEVICE && command_enum != CMD_RESET && command_enum != CMD_DUMP_ERROR_LOG) {
-            m_comms.reportEvent(STATUS_PREFIX_ERROR, "Command ignored: System is in ERROR state. Send reset to recover.");
-            g_errorLog.logf(LOG_WARNING, "Cmd blocked (ERROR): %s", msg.buffer);
+        if (command_enum != CMD_DISCOVER_DEVICE && command_enum != CMD_RESET && command_enum != CMD_DUMP_ERROR_LOG &&
+            command_enum != CMD_DUMP_PERF && command_enum != CMD_DUMP_TRACE && command_enum != CMD_DUMP_CRASH &&
+            command_enum != CMD_DUMP_MEM && command_enum != CMD_DUMP_CYCLE_TIMES) {
+            reportEvent(STATUS_PREFIX_ERROR, "Command ignored: System is in ERROR state. Send reset to recover.");
+            ERROR_LOGF(LOG_WARNING, "Cmd blocked (ERROR): %s", msg.buffer);
             return;
         }
     }
 
-    // Isolate arguments by finding the first space in the command string.
-    const char* args = strchr(msg.buffer, ' ');
-    if (args) {
-        args++; // Move pointer past the space to the start of the arguments.
-    }
-
     // --- Master Command Delegation Switchboard ---
     switch (command_enum) {
         // --- System-Level Commands (Handled by Pressboi) ---
         case CMD_DISCOVER_DEVICE: {
-            char* portStr = strstr(msg.buffer, "PORT=");
+            const char* portStr = strstr(msg.buffer, "PORT=");
             if (portStr) {
                 uint16_t guiPort = atoi(portStr + 5);
                 
@@ -535,13 +1216,55 @@ void Pressboi::dispatchCommand(const Message& msg) {
                     m_comms.setGuiIp(msg.remoteIp);
                     m_comms.setGuiPort(guiPort);
                     m_comms.setGuiDiscovered(true);
+                    m_comms.resolveHost(msg.remoteIp);
                 }
                 // USB discovery - don't update, keep previous GUI IP
                 
-                // Report device ID, port, and firmware version
-                char discoveryMsg[128];
-                snprintf(discoveryMsg, sizeof(discoveryMsg), "%sDEVICE_ID=pressboi PORT=%d FW=%s", 
-                        STATUS_PREFIX_DISCOVERY, LOCAL_PORT, FIRMWARE_VERSION);
+                // Telemetry encoding: hosts that can decode binary frames ask for them, others get text
+                m_telemetryBinary = (strstr(msg.buffer, "TELEM=BIN1") != NULL);
+                m_eventBinary = (strstr(msg.buffer, "EVENT=BIN1") != NULL);
+                
+                // USB framing: a USB host that can split on 0x00 asks for whole COBS frames
+                // instead of CHUNK_ lines; the reply below already uses the new framing
+                if (fromUsb) {
+                    m_comms.setUsbFraming((strstr(msg.buffer, "USB=COBS1") != NULL) ? USB_FRAMING_COBS : USB_FRAMING_LINES);
+                } else {
+                    // UDP batching: a network host that splits datagrams on newlines asks for
+                    // several messages per datagram
+                    m_comms.setUdpBatching(strstr(msg.buffer, "UDP=BATCH1") != NULL);
+                }
+                
+                // Report device ID, port, firmware version and the telemetry encoding now in use;
+                // the identity is cached, so the reply is copies rather than a format
+                char discoveryMsg[176];
+                size_t discoveryLen = append_view(discoveryMsg, sizeof(discoveryMsg), 0, TEXT_VIEW(STATUS_PREFIX_DISCOVERY));
+                discoveryLen = append_view(discoveryMsg, sizeof(discoveryMsg), discoveryLen, m_comms.getIdentity());
+                discoveryLen = append_str(discoveryMsg, sizeof(discoveryMsg), discoveryLen,
+                                          m_telemetryBinary ? " TELEM=BIN1" : " TELEM=TEXT");
+                discoveryLen = append_str(discoveryMsg, sizeof(discoveryMsg), discoveryLen,
+                                          m_eventBinary ? " EVENT=BIN1" : " EVENT=TEXT");
+                if (fromUsb) {
+                    discoveryLen = append_str(discoveryMsg, sizeof(discoveryMsg), discoveryLen,
+                                              (m_comms.getUsbFraming() == USB_FRAMING_COBS) ? " USB=COBS1" : " USB=LINES");
+                } else {
+                    discoveryLen = append_str(discoveryMsg, sizeof(discoveryMsg), discoveryLen,
+                                              m_comms.isUdpBatching() ? " UDP=BATCH1 BULK=" : " UDP=SINGLE BULK=");
+                    discoveryLen = append_uint(discoveryMsg, sizeof(discoveryMsg), discoveryLen, BULK_TCP_PORT);
+                }
+                
+                // Clock sync: a host that sends SYNC=<token> gets the token back with the device
+                // clock, and takes it as the midpoint of its own send and receive times (NTP style,
+                // the round trips with the shortest time being the ones it trusts)
+                const char* syncStr = strstr(msg.buffer, "SYNC=");
+                if (syncStr) {
+                    syncStr += 5;
+                    int syncLen = (int)strcspn(syncStr, " \r\n");
+                    if (syncLen > CLOCK_SYNC_TOKEN_MAX) syncLen = CLOCK_SYNC_TOKEN_MAX;
+                    discoveryLen = append_str(discoveryMsg, sizeof(discoveryMsg), discoveryLen, " SYNC=");
+                    discoveryLen = append_view(discoveryMsg, sizeof(discoveryMsg), discoveryLen, TextView{ syncStr, (uint16_t)syncLen });
+                    discoveryLen = append_str(discoveryMsg, sizeof(discoveryMsg), discoveryLen, " T_US=");
+                    append_uint(discoveryMsg, sizeof(discoveryMsg), discoveryLen, Microseconds());
+                }
                 
                 // Send response directly to the requester (not via reportEvent which uses stored GUI IP)
                 m_comms.enqueueTx(discoveryMsg, msg.remoteIp, guiPort);
@@ -555,20 +1278,30 @@ void Pressboi::dispatchCommand(const Message& msg) {
             while(WDT->SYNCBUSY.reg);
             #endif
             
+            g_settings.commit();  // Settings changed in the last SETTINGS_COMMIT_DELAY_MS
+            while (nvmTablesPending() && commitNvmTable()) {
+                // Tables saved since the last idle spell
+            }
             reportEvent(STATUS_PREFIX_INFO, "Rebooting to bootloader...");
             SysMgr.ResetBoard(SysManager::RESET_TO_BOOTLOADER);
             break; // The system will reset before reaching here
         }
-        case CMD_RESET:
-            clearErrors();
+        case CMD_RESET: {
+            const char* mode = (argsValid && cmdArgs.count >= 1) ? cmdArgs.reset.mode : "";
+            if (!argsValid || (mode[0] != '\0' && strcmp(mode, "soft") != 0 && strcmp(mode, "full") != 0)) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid reset mode. Use 'soft' or 'full'.");
+                break;
+            }
+            clearErrors(strcmp(mode, "full") == 0);
             break;
+        }
         case CMD_ENABLE:
             enable();
-            m_comms.reportEvent(STATUS_PREFIX_DONE, "enable");
+            reportEvent(STATUS_PREFIX_DONE, "enable");
             break;
         case CMD_DISABLE:
             disable();
-            m_comms.reportEvent(STATUS_PREFIX_DONE, "disable");
+            reportEvent(STATUS_PREFIX_DONE, "disable");
             break;
         case CMD_TEST_WATCHDOG:
             // Test command: block for 1 second to trigger watchdog
@@ -579,14 +1312,17 @@ void Pressboi::dispatchCommand(const Message& msg) {
             break;
         
         case CMD_SET_FORCE_OFFSET: {
-            float offset = 0.0f;
-            if (sscanf(args, "%f", &offset) == 1) {
-                const char* mode = m_motor.getForceMode();
-                if (strcmp(mode, "load_cell") == 0) {
-                    // Load cell mode: set load cell offset
-                    m_forceSensor.setOffset(offset);
+            const SetForceOffsetArgs& a = cmdArgs.set_force_offset;
+            float offset = a.offset;
+            const char* channel = (cmdArgs.count >= 2) ? a.channel : "a";
+            if (argsValid && cmdArgs.count >= 1) {
+                if (m_motor.isLoadCellMode()) {
+                    // Load cell mode: set load cell offset (optional channel a/b)
+                    ForceSensor& sensor = (strcmp(channel, "b") == 0) ? m_forceSensorB : m_forceSensor;
+                    sensor.setOffset(offset);
                     char msg_buf[128];
-                    snprintf(msg_buf, sizeof(msg_buf), "Load cell offset set to %.2f kg and saved to NVM", offset);
+                    snprintf(msg_buf, sizeof(msg_buf), "Load cell %s offset set to %.2f kg and saved to NVM",
+                             (sensor.getChannel() == 0) ? "A" : "B", offset);
                     reportEvent(STATUS_PREFIX_INFO, msg_buf);
                 } else {
                     // Motor torque mode: set motor torque offset
@@ -603,14 +1339,17 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
         
         case CMD_SET_FORCE_SCALE: {
-            float scale = 1.0f;
-            if (sscanf(args, "%f", &scale) == 1) {
-                const char* mode = m_motor.getForceMode();
-                if (strcmp(mode, "load_cell") == 0) {
-                    // Load cell mode: set load cell scale
-                    m_forceSensor.setScale(scale);
+            const SetForceScaleArgs& a = cmdArgs.set_force_scale;
+            float scale = a.scale;
+            const char* channel = (cmdArgs.count >= 2) ? a.channel : "a";
+            if (argsValid && cmdArgs.count >= 1) {
+                if (m_motor.isLoadCellMode()) {
+                    // Load cell mode: set load cell scale (optional channel a/b)
+                    ForceSensor& sensor = (strcmp(channel, "b") == 0) ? m_forceSensorB : m_forceSensor;
+                    sensor.setScale(scale);
                     char msg_buf[128];
-                    snprintf(msg_buf, sizeof(msg_buf), "Load cell scale set to %.6f and saved to NVM", scale);
+                    snprintf(msg_buf, sizeof(msg_buf), "Load cell %s scale set to %.6f and saved to NVM",
+                             (sensor.getChannel() == 0) ? "A" : "B", scale);
                     reportEvent(STATUS_PREFIX_INFO, msg_buf);
                 } else {
                     // Motor torque mode: set motor torque scale
@@ -627,12 +1366,13 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
         
         case CMD_SET_STRAIN_CAL: {
-            float coeff_x4 = MACHINE_STRAIN_COEFF_X4;
-            float coeff_x3 = MACHINE_STRAIN_COEFF_X3;
-            float coeff_x2 = MACHINE_STRAIN_COEFF_X2;
-            float coeff_x1 = MACHINE_STRAIN_COEFF_X1;
-            float coeff_c  = MACHINE_STRAIN_COEFF_C;
-            if (sscanf(args, "%f %f %f %f %f", &coeff_x4, &coeff_x3, &coeff_x2, &coeff_x1, &coeff_c) == 5) {
+            const SetStrainCalArgs& a = cmdArgs.set_strain_cal;
+            float coeff_x4 = a.x4;
+            float coeff_x3 = a.x3;
+            float coeff_x2 = a.x2;
+            float coeff_x1 = a.x1;
+            float coeff_c  = a.c;
+            if (argsValid && cmdArgs.count == 5) {
                 m_motor.setMachineStrainCoeffs(coeff_x4, coeff_x3, coeff_x2, coeff_x1, coeff_c);
                 char msg_buf[160];
                 snprintf(msg_buf, sizeof(msg_buf),
@@ -645,10 +1385,94 @@ void Pressboi::dispatchCommand(const Message& msg) {
             }
             break;
         }
-        
+
+        case CMD_FW_UPDATE: {
+            #if FW_UPDATE_ENABLED
+            const char* action = cmdArgs.fw_update.action;
+            if (!argsValid || cmdArgs.count < 1) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for fw_update. Use begin <size> <crc_hex>, apply or cancel");
+            } else if (strcmp(action, "cancel") == 0) {
+                g_firmwareUpdate.cancel();
+                reportEvent(STATUS_PREFIX_DONE, "fw_update");
+            } else if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "fw_update rejected: press is moving");
+            } else if (!g_nvmJournal.isIdle() || !g_profileStore.isIdle()) {
+                // Both take NVMCTRL for good once they start
+                reportEvent(STATUS_PREFIX_ERROR, "fw_update rejected: a settings write is in progress, retry");
+            } else if (strcmp(action, "begin") == 0) {
+                char* end = NULL;
+                unsigned long crc = (cmdArgs.count == 3) ? strtoul(cmdArgs.fw_update.crc, &end, 16) : 0;
+                if (cmdArgs.count != 3 || end == cmdArgs.fw_update.crc || *end != '\0' || cmdArgs.fw_update.size <= 0) {
+                    reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for fw_update begin. Use begin <size> <crc_hex>");
+                } else if (!m_comms.isNetworkReady()) {
+                    reportEvent(STATUS_PREFIX_ERROR, "fw_update rejected: network is not up");
+                } else if (!g_firmwareUpdate.begin((uint32_t)cmdArgs.fw_update.size, (uint32_t)crc, Milliseconds())) {
+                    char msg_buf[96];
+                    snprintf(msg_buf, sizeof(msg_buf), "fw_update rejected: the image must be 1 to %lu bytes",
+                             (unsigned long)FW_UPDATE_MAX_BYTES);
+                    reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+                } else {
+                    // Progress and DONE come from serviceFirmwareUpdate()
+                    m_fwUpdateRequestId = m_eventRequestId;
+                    reportEvent(STATUS_PREFIX_INFO, "fw_update: erasing the staging area...");
+                }
+            } else if (strcmp(action, "apply") == 0) {
+                if (!g_firmwareUpdate.apply(Milliseconds())) {
+                    reportEvent(STATUS_PREFIX_ERROR, "fw_update apply rejected: no verified image is staged");
+                } else {
+                    m_fwUpdateRequestId = m_eventRequestId;
+                    reportEvent(STATUS_PREFIX_INFO, "fw_update: applying the staged image and rebooting...");
+                }
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid fw_update action. Use begin, apply or cancel");
+            }
+            #else
+            reportEvent(STATUS_PREFIX_ERROR, "fw_update not available: firmware built without FW_UPDATE_ENABLED");
+            #endif
+            break;
+        }
+        case CMD_FIT_STRAIN_CAL: {
+            const char* mode = (argsValid && cmdArgs.count >= 1) ? cmdArgs.fit_strain_cal.mode : "apply";
+            bool apply = (strcmp(mode, "apply") == 0);
+            if (!argsValid || (!apply && strcmp(mode, "preview") != 0)) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for fit_strain_cal. Use 'apply' or 'preview'");
+                break;
+            }
+            if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "fit_strain_cal rejected: press is moving");
+                break;
+            }
+            MachineStrainFit fit;
+            float peak_kg = m_motor.collectStrainFit(&fit);
+            float coeffs[5];
+            float rms_kg = 0.0f;
+            char msg_buf[160];
+            if (fit.getCount() < MACHINE_STRAIN_FIT_MIN_SAMPLES || fit.getSpanMm() < MACHINE_STRAIN_FIT_MIN_SPAN_MM) {
+                snprintf(msg_buf, sizeof(msg_buf), "fit_strain_cal failed: the last press capture has %lu loading samples over %.3f mm (need %d over %.2f mm)",
+                         (unsigned long)fit.getCount(), fit.getSpanMm(), MACHINE_STRAIN_FIT_MIN_SAMPLES, MACHINE_STRAIN_FIT_MIN_SPAN_MM);
+                reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+                break;
+            }
+            if (!fit.solve(coeffs, &rms_kg) || !fit.risesOverSpan(coeffs)) {
+                reportEvent(STATUS_PREFIX_ERROR, "fit_strain_cal failed: no quartic rising with deflection fits the capture (press a rigid block)");
+                break;
+            }
+            snprintf(msg_buf, sizeof(msg_buf), "Strain fit of %lu samples, 0-%.3f mm, up to %.1f kg: RMS residual %.2f kg",
+                     (unsigned long)fit.getCount(), fit.getSpanMm(), peak_kg, rms_kg);
+            reportEvent(STATUS_PREFIX_INFO, msg_buf);
+            snprintf(msg_buf, sizeof(msg_buf), "Machine strain polynomial %s: f(x) = %.3f x^4 %+.3f x^3 %+.3f x^2 %+.3f x %+.3f",
+                     apply ? "updated" : "fitted (preview)", coeffs[0], coeffs[1], coeffs[2], coeffs[3], coeffs[4]);
+            reportEvent(STATUS_PREFIX_INFO, msg_buf);
+            if (apply) {
+                m_motor.setMachineStrainCoeffs(coeffs[0], coeffs[1], coeffs[2], coeffs[3], coeffs[4]);
+            }
+            reportEvent(STATUS_PREFIX_DONE, "fit_strain_cal");
+            break;
+        }
+        
         case CMD_SET_FORCE_MODE: {
-            char mode[32] = "";
-            if (sscanf(args, "%31s", mode) == 1) {
+            const char* mode = cmdArgs.set_force_mode.mode;
+            if (argsValid && cmdArgs.count == 1) {
                 if (m_motor.setForceMode(mode)) {
                     char msg_buf[128];
                     snprintf(msg_buf, sizeof(msg_buf), "Force mode set to '%s' and saved to NVM", mode);
@@ -664,8 +1488,8 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
 
         case CMD_SET_POLARITY: {
-            char polarity[32] = "";
-            if (sscanf(args, "%31s", polarity) == 1) {
+            const char* polarity = cmdArgs.set_polarity.polarity;
+            if (argsValid && cmdArgs.count == 1) {
                 if (m_motor.setPolarity(polarity)) {
                     char msg_buf[128];
                     snprintf(msg_buf, sizeof(msg_buf), "Coordinate system polarity set to '%s' and saved to NVM", polarity);
@@ -681,8 +1505,8 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
 
         case CMD_HOME_ON_BOOT: {
-            char enabled[32] = "";
-            if (sscanf(args, "%31s", enabled) == 1) {
+            const char* enabled = cmdArgs.home_on_boot.enabled;
+            if (argsValid && cmdArgs.count == 1) {
                 if (m_motor.setHomeOnBoot(enabled)) {
                     char msg_buf[128];
                     snprintf(msg_buf, sizeof(msg_buf), "Home on boot set to '%s' and saved to NVM", enabled);
@@ -698,8 +1522,8 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
 
         case CMD_SET_PRESS_THRESHOLD: {
-            float threshold_kg = 0.0f;
-            if (sscanf(args, "%f", &threshold_kg) == 1) {
+            float threshold_kg = cmdArgs.set_press_threshold.threshold;
+            if (argsValid && cmdArgs.count == 1) {
                 if (m_motor.setPressThreshold(threshold_kg)) {
                     char msg_buf[128];
                     snprintf(msg_buf, sizeof(msg_buf), "Press threshold set to %.2f kg and saved to NVM", threshold_kg);
@@ -714,24 +1538,488 @@ void Pressboi::dispatchCommand(const Message& msg) {
             break;
         }
 
-        case CMD_SET_FORCE_ZERO: {
-            const char* mode = m_motor.getForceMode();
-            if (strcmp(mode, "load_cell") == 0) {
-                // Load cell mode: capture current force reading and set as new offset
-                float old_offset = m_forceSensor.getOffset();
-                float current_force = m_forceSensor.getForce();
-                float new_offset = old_offset - current_force;
-                
-                m_forceSensor.setOffset(new_offset);
-                
+        case CMD_SET_FORCE_FILTER: {
+            int median = (int)cmdArgs.set_force_filter.median;
+            float alpha = (cmdArgs.count >= 2) ? cmdArgs.set_force_filter.alpha : 1.0f;
+            if (argsValid && cmdArgs.count >= 1 && median >= 0 && median <= 255 && m_forceSensor.setFilter((uint8_t)median, alpha)) {
+                m_forceSensorB.setFilter((uint8_t)median, alpha);
                 char msg_buf[128];
-                snprintf(msg_buf, sizeof(msg_buf), "Load cell offset: %.2f kg -> %.2f kg", 
-                         old_offset, new_offset);
+                snprintf(msg_buf, sizeof(msg_buf), "Force filter set to median=%d alpha=%.3f and saved to NVM", median, alpha);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_force_filter");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_force_filter. Median must be 1, 3 or 5; alpha 0.01-1.0");
+            }
+            break;
+        }
+
+        case CMD_SET_MOTION_PROFILE: {
+            const char* profile = cmdArgs.set_motion_profile.profile;
+            float jerk_mmss3 = (cmdArgs.count >= 2) ? cmdArgs.set_motion_profile.jerk : MOTION_SCURVE_JERK_DEFAULT_MMSS3;
+            bool parsed = argsValid && cmdArgs.count >= 1;
+            bool valid = false;
+            if (parsed && strcmp(profile, "trapezoid") == 0) {
+                jerk_mmss3 = 0.0f;
+                valid = m_motor.setMotionJerk(0.0f);
+            } else if (parsed && strcmp(profile, "scurve") == 0) {
+                valid = jerk_mmss3 > 0.0f && m_motor.setMotionJerk(jerk_mmss3);
+            }
+            if (valid) {
+                char msg_buf[128];
+                if (jerk_mmss3 > 0.0f) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Motion profile set to scurve (jerk %.0f mm/s^3) and saved to NVM", jerk_mmss3);
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Motion profile set to trapezoid and saved to NVM");
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_motion_profile");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_motion_profile. Use 'trapezoid' or 'scurve [jerk 100-100000 mm/s^3]'");
+            }
+            break;
+        }
+
+        case CMD_SET_ENCODER: {
+            float counts_per_mm = cmdArgs.set_encoder.counts_per_mm;
+            float tolerance_mm = (cmdArgs.count >= 2) ? cmdArgs.set_encoder.tolerance : ENCODER_TOLERANCE_MM_DEFAULT;
+            if (argsValid && cmdArgs.count >= 1 && m_motor.setEncoderFeedback(counts_per_mm, tolerance_mm)) {
+                char msg_buf[128];
+                if (counts_per_mm != 0.0f) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Encoder verification on (%.2f counts/mm, tolerance %.2f mm) and saved to NVM",
+                             counts_per_mm, tolerance_mm);
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Encoder verification off and saved to NVM");
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_encoder");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_encoder. Use '<counts/mm, 0 = off> [tolerance 0.05-20 mm]'");
+            }
+            break;
+        }
+
+        case CMD_SET_DRIVE_GEOMETRY: {
+            float pitch_mm = cmdArgs.set_drive_geometry.pitch;
+            int32_t pulses = cmdArgs.set_drive_geometry.pulses_per_rev;
+            if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "set_drive_geometry rejected: press is moving");
+            } else if (argsValid && cmdArgs.count >= 2 && g_driveGeometry.save(pitch_mm, pulses)) {
+                char msg_buf[160];
+                snprintf(msg_buf, sizeof(msg_buf),
+                         "Drive geometry %.3f mm/rev, %ld pulses/rev (%.3f steps/mm) saved to NVM. Reboot required for changes to take effect.",
+                         pitch_mm, (long)pulses, (float)pulses / pitch_mm);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_drive_geometry");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_drive_geometry. Use '<pitch 0.5-50 mm/rev> <pulses 200-51200 per rev>'");
+            }
+            break;
+        }
+
+        case CMD_SET_RAPID_TRAVERSE: {
+            int speed_mms = (int)cmdArgs.set_rapid_traverse.speed;
+            int accel_mmss = (cmdArgs.count >= 2) ? (int)cmdArgs.set_rapid_traverse.accel : RAPID_ACCEL_DEFAULT_MMSS;
+            if (argsValid && cmdArgs.count >= 1 && m_motor.setRapidTraverse(speed_mms, accel_mmss)) {
+                char msg_buf[128];
+                if (speed_mms > 0) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Rapid traverse set to %d mm/s at %d mm/s^2 (load cell below %.1f kg) and saved to NVM",
+                             m_motor.getRapidVelMms(), m_motor.getRapidAccelMmss(), RAPID_FORCE_GATE_KG);
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Rapid traverse off and saved to NVM");
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_rapid_traverse");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_rapid_traverse. Use '<speed 0-156 mm/s, 0 = off> [accel 5-625 mm/s^2]'");
+            }
+            break;
+        }
+
+        case CMD_SET_TORQUE_FRICTION: {
+            float speed_mms[TORQUE_FRICTION_MAX_POINTS];
+            float torque_pct[TORQUE_FRICTION_MAX_POINTS];
+            int count = 0;
+            const char* points = cmdArgs.set_torque_friction.points;
+            bool valid = argsValid && points != NULL;
+            
+            if (valid && strncmp(points, "clear", 5) != 0) {
+                // Variable-length list of "speed torque" pairs
+                const char* p = points;
+                char* end = NULL;
+                while (valid) {
+                    float speed_value = strtof(p, &end);
+                    if (end == p) {
+                        break;
+                    }
+                    p = end;
+                    float torque_value = strtof(p, &end);
+                    if (end == p || count >= TORQUE_FRICTION_MAX_POINTS) {
+                        valid = false;
+                        break;
+                    }
+                    p = end;
+                    speed_mms[count] = speed_value;
+                    torque_pct[count] = torque_value;
+                    count++;
+                }
+                if (count < 1) {
+                    valid = false;
+                }
+            }
+            
+            if (valid && m_motor.setTorqueFriction(speed_mms, torque_pct, (uint8_t)count)) {
+                char msg_buf[128];
+                if (count == 0) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Torque friction table cleared and saved to NVM");
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Torque friction table set: %d points (%.1f to %.1f mm/s) saved to NVM",
+                             count, speed_mms[0], speed_mms[count - 1]);
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_torque_friction");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_torque_friction. Use 1-4 'speed_mms torque_pct' pairs, speed increasing, or 'clear'");
+            }
+            break;
+        }
+
+        case CMD_SET_FORCE_CHANNEL: {
+            const char* channel = cmdArgs.set_force_channel.channel;
+            if (argsValid && cmdArgs.count == 1 && m_motor.setForceChannel(channel)) {
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Force channel set to %s and saved to NVM", channel);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_force_channel");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for set_force_channel. Use 'a', 'b' or 'sum'");
+            }
+            break;
+        }
+
+        case CMD_SET_FORCE_LATENCY: {
+            long latency_us = cmdArgs.set_force_latency.latency;
+            if (argsValid && cmdArgs.count == 1 && latency_us >= 0 &&
+                m_forceSensor.setLatencyUs((uint32_t)latency_us)) {
+                m_forceSensorB.setLatencyUs((uint32_t)latency_us);
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Force latency set to %ld us and saved to NVM", latency_us);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_force_latency");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for set_force_latency. Must be 0-100000 us");
+            }
+            break;
+        }
+
+        case CMD_RECIPE_NEW: {
+            const char* name = cmdArgs.recipe_new.name;
+            if (argsValid && cmdArgs.count == 1 && g_recipeStore.begin(name)) {
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' started. Add steps with recipe_add, then recipe_save", name);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "recipe_new");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for recipe_new. Name must be 1-11 characters");
+            }
+            break;
+        }
+
+        case CMD_RECIPE_ADD: {
+            // "move <pos> [speed] [force] [action] [hold_ms]", "dwell <ms>" or "retract [speed]"
+            MotionSegment step;
+            memset(&step, 0, sizeof(step));
+            step.force_action = FORCE_ACTION_HOLD;
+            const char* kind = cmdArgs.recipe_add.step;
+            const char* rest = cmdArgs.recipe_add.args;
+            // Move and retract steps take the params of the commands they replay
+            CommandArgs stepArgs;
+            bool valid = false;
+            if (argsValid && cmdArgs.count >= 1) {
+                if (strcmp(kind, "move") == 0) {
+                    const MoveAbsArgs& a = stepArgs.move_abs;
+                    step.type = SEGMENT_MOVE;
+                    valid = parseCommandArgs(CMD_MOVE_ABS, rest, &stepArgs) && stepArgs.count >= 1;
+                    step.position_mm = a.position;
+                    step.speed_mms = (stepArgs.count >= 2) ? a.speed : MOVE_DEFAULT_VELOCITY_MMS;
+                    step.force_kg = a.force;
+                    long hold_ms = (stepArgs.count >= 5) ? a.dwell : FORCE_REGULATE_DWELL_MS_DEFAULT;
+                    valid = valid && MotorController::parseForceAction((stepArgs.count >= 4) ? a.force_action : "hold",
+                                                                       &step.force_action);
+                    // Stored in 16 bits
+                    valid = valid && hold_ms >= 0 && hold_ms <= 65535;
+                    step.dwell_ms = (uint32_t)hold_ms;
+                } else if (strcmp(kind, "dwell") == 0) {
+                    char* end = NULL;
+                    long dwell_ms = rest ? strtol(rest, &end, 10) : -1;
+                    step.type = SEGMENT_DWELL;
+                    valid = rest && end != rest && end[strspn(end, " \t")] == '\0' && dwell_ms >= 0;
+                    step.dwell_ms = (uint32_t)dwell_ms;
+                } else if (strcmp(kind, "retract") == 0) {
+                    step.type = SEGMENT_RETRACT;
+                    valid = parseCommandArgs(CMD_RETRACT, rest, &stepArgs);
+                    step.speed_mms = stepArgs.retract.speed;
+                }
+            }
+            valid = valid && step.speed_mms >= 0.0f && step.speed_mms <= 100.0f &&
+                    step.force_kg >= 0.0f && step.force_kg <= 2000.0f;
+            
+            char msg_buf[128];
+            if (!valid) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for recipe_add. Use 'move <pos> [speed] [force] [action] [hold_ms]', 'dwell <ms>' or 'retract [speed]'");
+            } else if (!g_recipeStore.addStep(step)) {
+                snprintf(msg_buf, sizeof(msg_buf), "recipe_add failed: no recipe started or recipe full (%d steps)", RECIPE_MAX_STEPS);
+                reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+            } else {
+                snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' step %d: %s %s", g_recipeStore.getName(),
+                         (int)g_recipeStore.getStepCount(), kind, rest ? rest : "");
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "recipe_add");
+            }
+            break;
+        }
+
+        case CMD_RECIPE_LEARN: {
+            float margin_mm = cmdArgs.recipe_learn.margin;
+            float rapid_mms = (cmdArgs.count >= 2) ? cmdArgs.recipe_learn.rapid_speed : ADAPTIVE_APPROACH_RAPID_MMS_DEFAULT;
+            char msg_buf[128];
+            if (!argsValid || cmdArgs.count < 1 || margin_mm < 0.0f || margin_mm > 50.0f || rapid_mms <= 0.0f || rapid_mms > RAPID_VEL_MAX_MMS) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for recipe_learn. Use '<margin mm 0-50> [rapid mm/s 0-156]'");
+            } else if (!g_recipeStore.setLearning(margin_mm, rapid_mms)) {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_learn failed: no recipe started (use recipe_new)");
+            } else {
+                if (margin_mm > 0.0f) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' adaptive approach: %.1f mm/s to %.2f mm short of learned contact",
+                             g_recipeStore.getName(), rapid_mms, margin_mm);
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' adaptive approach off", g_recipeStore.getName());
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "recipe_learn");
+            }
+            break;
+        }
+
+        case CMD_RECIPE_SAVE: {
+            if (g_recipeStore.save()) {
+                char msg_buf[192];
+                snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' (%d steps) saved to NVM", g_recipeStore.getName(),
+                         (int)g_recipeStore.getStepCount());
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                // Predicted from the retract position with the settings of the moment
+                m_motor.estimateRecipe(false);
+                int len = snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' estimate: ", g_recipeStore.getName());
+                g_cycleEstimate.format(msg_buf + len, sizeof(msg_buf) - len);
                 reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                for (uint8_t i = 0; i < g_cycleEstimate.getCount(); i++) {
+                    len = snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' step %d estimate: ", g_recipeStore.getName(), (int)i + 1);
+                    g_cycleEstimate.formatSegment(i, msg_buf + len, sizeof(msg_buf) - len);
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                }
+                reportEvent(STATUS_PREFIX_DONE, "recipe_save");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_save failed: no recipe started (use recipe_new)");
+            }
+            break;
+        }
+
+        case CMD_RECIPE_ENVELOPE: {
+            const char* action = cmdArgs.recipe_envelope.action;
+            const char* p = cmdArgs.recipe_envelope.points;
+            char msg_buf[160];
+            if (!argsValid || cmdArgs.count < 1) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for recipe_envelope. Use begin <start_mm step_mm>, add <lower_kg upper_kg> ... or clear");
+            } else if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_envelope rejected: press is moving");
+            } else if (g_recipeStore.getName()[0] == '\0') {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_envelope failed: no recipe started (use recipe_new)");
+            } else if (strcmp(action, "clear") == 0) {
+                g_recipeStore.clearEnvelope();
+                snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' envelope cleared", g_recipeStore.getName());
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "recipe_envelope");
+            } else if (strcmp(action, "begin") == 0 && cmdArgs.count == 2) {
+                char* end = NULL;
+                float start_mm = strtof(p, &end);
+                bool valid = (end != p);
+                p = end;
+                float step_mm = valid ? strtof(p, &end) : 0.0f;
+                valid = valid && end != p && g_recipeStore.beginEnvelope(start_mm, step_mm);
+                if (valid) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' envelope started: bins every %.3f mm from %.3f mm",
+                             g_recipeStore.getName(), step_mm, start_mm);
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                    reportEvent(STATUS_PREFIX_DONE, "recipe_envelope");
+                } else {
+                    reportEvent(STATUS_PREFIX_ERROR, "Invalid points for recipe_envelope begin. Use '<first bin centre mm> <bin width mm>', width at least 0.05 mm");
+                }
+            } else if (strcmp(action, "add") == 0 && cmdArgs.count == 2 && g_recipeStore.getEnvelopeStepMm() > 0.0f) {
+                // Variable-length list of "lower_kg upper_kg" pairs, one per bin
+                char* end = NULL;
+                int pairs = 0;
+                bool valid = true;
+                while (valid) {
+                    float lower_kg = strtof(p, &end);
+                    if (end == p) {
+                        break;
+                    }
+                    p = end;
+                    float upper_kg = strtof(p, &end);
+                    if (end == p) {
+                        valid = false;
+                        break;
+                    }
+                    p = end;
+                    valid = g_recipeStore.addEnvelopeBand(lower_kg, upper_kg);
+                    pairs++;
+                }
+                if (valid && pairs > 0) {
+                    uint8_t bands = g_recipeStore.getEnvelopeCount();
+                    snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' envelope: %u bins, %.3f to %.3f mm",
+                             g_recipeStore.getName(), (unsigned)bands, g_recipeStore.getEnvelopeStartMm(),
+                             g_recipeStore.getEnvelopeStartMm() + (bands - 1) * g_recipeStore.getEnvelopeStepMm());
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                    reportEvent(STATUS_PREFIX_DONE, "recipe_envelope");
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Invalid points for recipe_envelope add. Use 'lower_kg upper_kg' pairs, lower <= upper, at most %d bins",
+                             RECIPE_ENVELOPE_MAX_BANDS);
+                    reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+                }
+            } else if (strcmp(action, "add") == 0) {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_envelope add failed: start the grid with recipe_envelope begin first");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for recipe_envelope. Use begin <start_mm step_mm>, add <lower_kg upper_kg> ... or clear");
+            }
+            break;
+        }
+
+        case CMD_RECIPE_ZONES: {
+            const char* action = cmdArgs.recipe_zones.action;
+            const char* p = cmdArgs.recipe_zones.band;
+            char msg_buf[160];
+            if (!argsValid || cmdArgs.count < 1) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for recipe_zones. Use add <start_mm end_mm speed_mms [torque_pct force_kg]> or clear");
+            } else if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_zones rejected: press is moving");
+            } else if (g_recipeStore.getName()[0] == '\0') {
+                reportEvent(STATUS_PREFIX_ERROR, "recipe_zones failed: no recipe started (use recipe_new)");
+            } else if (strcmp(action, "clear") == 0) {
+                g_recipeStore.clearZones();
+                snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' zones cleared", g_recipeStore.getName());
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "recipe_zones");
+            } else if (strcmp(action, "add") == 0 && cmdArgs.count == 2) {
+                // start, end and speed, then the optional torque and force ceilings
+                float values[5] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+                int parsed = 0;
+                char* end = NULL;
+                while (parsed < 5) {
+                    float value = strtof(p, &end);
+                    if (end == p) {
+                        break;
+                    }
+                    values[parsed++] = value;
+                    p = end;
+                }
+                while (*p == ' ') {
+                    p++;
+                }
+                RecipeZone zone = {values[0], values[1], values[2], values[3], values[4]};
+                if (parsed >= 3 && *p == '\0' && g_recipeStore.addZone(zone)) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Recipe '%s' zone %.3f to %.3f mm: speed %.2f mm/s, torque %.1f%%, force %.1f kg (0 = step's) (%u of %d)",
+                             g_recipeStore.getName(), zone.start_mm, zone.end_mm, zone.speed_mms, zone.torque_pct, zone.force_kg,
+                             (unsigned)g_recipeStore.getZoneCount(), RECIPE_ZONE_MAX);
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                    reportEvent(STATUS_PREFIX_DONE, "recipe_zones");
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Invalid band for recipe_zones add. Use '<start mm> <end mm> <speed mm/s> [torque %%] [force kg]', start < end, no overlap, at most %d bands",
+                             RECIPE_ZONE_MAX);
+                    reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+                }
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for recipe_zones. Use add <start_mm end_mm speed_mms [torque_pct force_kg]> or clear");
+            }
+            break;
+        }
+
+        case CMD_SET_FORCE_TABLE: {
+            int32_t raw[FORCE_TABLE_MAX_POINTS];
+            float kg[FORCE_TABLE_MAX_POINTS];
+            int count = 0;
+            const char* points = cmdArgs.set_force_table.points;
+            bool valid = argsValid && points != NULL;
+            
+            if (valid && strncmp(points, "clear", 5) != 0) {
+                // Variable-length list of "raw kg" pairs
+                const char* p = points;
+                char* end = NULL;
+                while (valid) {
+                    long raw_value = strtol(p, &end, 10);
+                    if (end == p) {
+                        break;
+                    }
+                    p = end;
+                    float kg_value = strtof(p, &end);
+                    if (end == p || count >= FORCE_TABLE_MAX_POINTS) {
+                        valid = false;
+                        break;
+                    }
+                    p = end;
+                    raw[count] = (int32_t)raw_value;
+                    kg[count] = kg_value;
+                    count++;
+                }
+                if (count < 2) {
+                    valid = false;
+                }
+            }
+            
+            if (valid && m_forceSensor.setLinearization(raw, kg, (uint8_t)count)) {
+                char msg_buf[128];
+                if (count == 0) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Force table cleared, using scale %.8f", m_forceSensor.getScale());
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Force table set: %d points (%ld to %ld raw) saved to NVM",
+                             count, (long)raw[0], (long)raw[count - 1]);
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_force_table");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_force_table. Use 2-16 'raw kg' pairs, raw increasing and kg monotonic, or 'clear'");
+            }
+            break;
+        }
+
+        case CMD_SET_FORCE_ZERO: {
+            if (m_motor.isLoadCellMode()) {
+                // Load cell mode: capture current force reading and set as new offset
+                // on every channel the force checks use
+                const char* channel = m_motor.getForceChannel();
+                ForceSensor* sensors[2] = { &m_forceSensor, &m_forceSensorB };
+                for (int i = 0; i < 2; i++) {
+                    bool selected = (strcmp(channel, "sum") == 0) || (strcmp(channel, (i == 0) ? "a" : "b") == 0);
+                    if (!selected) {
+                        continue;
+                    }
+                    // The reading includes the zero-tracking trim, which the new offset absorbs
+                    float old_offset = sensors[i]->getOffset();
+                    float current_force = sensors[i]->getFilteredForce();
+                    float new_offset = old_offset + sensors[i]->getZeroTrim() - current_force;
+                    
+                    sensors[i]->setOffset(new_offset);
+                    
+                    char msg_buf[128];
+                    snprintf(msg_buf, sizeof(msg_buf), "Load cell %s offset: %.2f kg -> %.2f kg", 
+                             (i == 0) ? "A" : "B", old_offset, new_offset);
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                }
             } else {
                 // Motor torque mode: set offset to current torque reading
                 float old_offset = m_motor.getForceCalibrationOffset();
-                float current_torque = (MOTOR_A.HlfbPercent() + MOTOR_B.HlfbPercent()) / 2.0f;
+                float current_torque = 0.0f;
+                for (int i = 0; i < MOTOR_AXIS_COUNT; i++) {
+                    current_torque += kPressStation.motors[i]->HlfbPercent();
+                }
+                current_torque /= (float)MOTOR_AXIS_COUNT;
                 float new_offset = -current_torque;
                 
                 m_motor.setForceCalibrationOffset(new_offset);
@@ -746,140 +2034,317 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
 
         case CMD_DUMP_NVM: {
+            if (!startDumpJob(DUMP_JOB_NVM)) {
+                break;
+            }
+            // Read all locations first to avoid hanging on NVM access while the lines go out
             ClearCore::NvmManager &nvmMgr = ClearCore::NvmManager::Instance();
-            char msg_buf[256];
-
-            // Read all 16 locations first to avoid hanging on NVM access in loop
-            int32_t nvm_values[16];
-            for (int i = 0; i < 16; ++i) {
+            for (int i = 0; i < NVM_SLOT_COUNT; ++i) {
                 int byte_offset = i * 4;
-                nvm_values[i] = nvmMgr.Int32(static_cast<ClearCore::NvmManager::NvmLocations>(byte_offset));
+                m_dumpNvmValues[i] = nvmMgr.Int32(static_cast<ClearCore::NvmManager::NvmLocations>(byte_offset));
             }
+            // The NVMDUMP lines and DONE follow from serviceDumpJob()
+            break;
+        }
 
-            // Now format and send all messages
-            for (int i = 0; i < 16; ++i) {
-                int byte_offset = i * 4;
-                int32_t value = nvm_values[i];
-                unsigned char* bytes = (unsigned char*)&value;
-                
-                // Format hex bytes
-                char hex_str[50];
-                char ascii_str[10];
-                snprintf(hex_str, sizeof(hex_str), "%02X %02X %02X %02X", 
-                         bytes[0], bytes[1], bytes[2], bytes[3]);
-                
-                // ASCII representation (printable chars only)
-                for (int j = 0; j < 4; j++) {
-                    ascii_str[j] = (bytes[j] >= 32 && bytes[j] <= 126) ? bytes[j] : '.';
-                }
-                ascii_str[4] = '\0';
-                
-                // Send with NVMDUMP prefix for GUI routing
-                snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:%04X:%s:%s", byte_offset, hex_str, ascii_str);
-                m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
+        case CMD_DUMP_CAPTURE: {
+            if (g_pressCapture.isCapturing()) {
+                reportEvent(STATUS_PREFIX_ERROR, "dump_capture ignored: a press is being captured.");
+                break;
+            }
+            if (m_captureDumpNext >= 0) {
+                reportEvent(STATUS_PREFIX_ERROR, "dump_capture ignored: a dump is already running.");
+                break;
             }
+            char msg_buf[192];
+            snprintf(msg_buf, sizeof(msg_buf),
+                     "CAPTURE:pressboi:HEADER: samples=%u bytes=%u dropped=%lu steps_per_mm=%.4f keyframe=%u start_us=%lu trigger=%ld format=varint1 fields=dt_us,pos_steps,raw,torque_deci",
+                     (unsigned)g_pressCapture.getCount(), (unsigned)g_pressCapture.getBytes(),
+                     (unsigned long)g_pressCapture.getDropped(), g_driveGeometry.stepsPerMm(), (unsigned)PRESS_CAPTURE_KEYFRAME_INTERVAL,
+                     (unsigned long)g_pressCapture.getFirstTimeUs(), (long)g_pressCapture.getTriggerIndex());
+            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort(), TX_LANE_BULK);
+            // The DATA lines and DONE follow from serviceCaptureDump()
+            m_captureDumpNext = 0;
+            m_captureDumpCurve = false;
+            m_captureDumpRequestId = m_eventRequestId;
+            break;
+        }
 
-            // Summary with interpreted calibration values (use cached values)
-            int32_t magic = nvm_values[7];        // Location 7 (byte offset 28)
-            int32_t force_mode = nvm_values[4];   // Location 4 (byte offset 16)
-            
-            const char* magic_status = (magic == 0x50425231) ? "OK" : "INVALID";
-            const char* mode_str = (force_mode == 0) ? "motor_torque" : "load_cell";
-            
-            // Show magic and mode
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: Magic=0x%08X(%s) CurrentMode=%s", 
-                     (unsigned int)magic, magic_status, mode_str);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
-            
-            // Load cell calibration (locations 0 & 1 - IEEE float as bits)
-            int32_t lc_offset_bits = nvm_values[0];   // Location 0
-            int32_t lc_scale_bits = nvm_values[1];    // Location 1
-            float lc_offset, lc_scale;
-            memcpy(&lc_offset, &lc_offset_bits, sizeof(float));
-            memcpy(&lc_scale, &lc_scale_bits, sizeof(float));
-            
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: LoadCell: Scale=%.6f Offset=%.4f kg", 
-                     lc_scale, lc_offset);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
-            
-            // Motor torque calibration (locations 5 & 6 - fixed-point)
-            int32_t mt_scale_raw = nvm_values[5];    // Location 5
-            int32_t mt_offset_raw = nvm_values[6];   // Location 6
-            float mt_scale = (float)mt_scale_raw / 100000.0f;
-            float mt_offset = (float)mt_offset_raw / 10000.0f;
-            
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: MotorTorque: Scale=%.6f Offset=%.4f %%", 
-                     mt_scale, mt_offset);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
-            
-            // Polarity (location 3 - byte offset 12)
-            int32_t polarity_value = nvm_values[3];   // Location 3
-            const char* polarity_str = (polarity_value == 1) ? "inverted" : "normal";
-            
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: Polarity=%s", 
-                     polarity_str);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
-            
-            // Home on boot (location 13 - byte offset 52)
-            int32_t home_on_boot_value = nvm_values[13];   // Location 13
-            const char* home_on_boot_str = (home_on_boot_value == 1) ? "true" : "false";
-            
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: HomeOnBoot=%s", 
-                     home_on_boot_str);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
-            
-            // Retract position (location 14 - byte offset 56)
-            int32_t retract_bits = nvm_values[14];   // Location 14
-            float retract_mm = 0.0f;
-            if (retract_bits != 0 && retract_bits != -1) {
-                memcpy(&retract_mm, &retract_bits, sizeof(float));
+        case CMD_DUMP_CURVE: {
+#if POSITION_CURVE_ENABLED
+            if (g_positionCurve.isCapturing()) {
+                reportEvent(STATUS_PREFIX_ERROR, "dump_curve ignored: a press is being captured.");
+                break;
             }
-            
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: RetractPosition=%.2f mm", 
-                     retract_mm);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
-            
-            // Press threshold (location 15 - byte offset 60)
-            int32_t threshold_bits = nvm_values[15];   // Location 15
-            float threshold_kg = 2.0f;  // Default
-            if (threshold_bits != 0 && threshold_bits != -1) {
-                memcpy(&threshold_kg, &threshold_bits, sizeof(float));
+            if (m_captureDumpNext >= 0) {
+                reportEvent(STATUS_PREFIX_ERROR, "dump_curve ignored: a dump is already running.");
+                break;
+            }
+            char msg_buf[192];
+            snprintf(msg_buf, sizeof(msg_buf),
+                     "CURVE:pressboi:HEADER: points=%u start_mm=%.3f step_mm=%.4f dropped=%lu trigger=%ld format=int16le fields=deci_kg",
+                     (unsigned)g_positionCurve.getCount(), g_positionCurve.getStartMm(), g_positionCurve.getStepMm(),
+                     (unsigned long)g_positionCurve.getDropped(), (long)g_positionCurve.getTriggerIndex());
+            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort(), TX_LANE_BULK);
+            // The DATA lines and DONE follow from serviceCaptureDump()
+            m_captureDumpNext = 0;
+            m_captureDumpCurve = true;
+            m_captureDumpRequestId = m_eventRequestId;
+#else
+            reportEvent(STATUS_PREFIX_ERROR, "dump_curve ignored: built without POSITION_CURVE_ENABLED.");
+#endif
+            break;
+        }
+
+        case CMD_SET_TELEMETRY: {
+            SetTelemetryArgs& a = cmdArgs.set_telemetry;
+            float busy_hz = a.busy_hz;
+            float idle_hz = (cmdArgs.count >= 2) ? a.idle_hz : busy_hz;
+            char* field_list = a.fields;
+            if (cmdArgs.count < 3) {
+                strcpy(field_list, "all");
             }
+            bool valid = argsValid && cmdArgs.count >= 1 &&
+                         busy_hz >= TELEMETRY_RATE_HZ_MIN && busy_hz <= TELEMETRY_RATE_HZ_MAX &&
+                         idle_hz >= TELEMETRY_RATE_HZ_MIN && idle_hz <= TELEMETRY_RATE_HZ_MAX;
             
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: PressThreshold=%.2f kg", 
-                     threshold_kg);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
+            uint32_t fields = TELEM_FIELDS_ALL;
+            if (valid && strcmp(field_list, "all") != 0) {
+                fields = 0;
+                for (char* key = strtok(field_list, ","); key != NULL; key = strtok(NULL, ",")) {
+                    int id = telemetry_field_id(key);
+                    if (id < 0) {
+                        valid = false;
+                        break;
+                    }
+                    fields |= TELEM_FIELD_BIT(id);
+                }
+            }
             
-            // Machine strain coefficients (locations 8-12 - byte offsets 32-52)
-            float strain_coeffs[5];
-            const float default_coeffs[5] = {MACHINE_STRAIN_COEFF_X4, MACHINE_STRAIN_COEFF_X3, 
-                                              MACHINE_STRAIN_COEFF_X2, MACHINE_STRAIN_COEFF_X1, 
-                                              MACHINE_STRAIN_COEFF_C};
-            for (int i = 0; i < 5; i++) {
-                int32_t coeff_bits = nvm_values[8 + i];  // Locations 8-12
-                if (coeff_bits != 0 && coeff_bits != -1) {
-                    memcpy(&strain_coeffs[i], &coeff_bits, sizeof(float));
+            if (valid && fields != 0) {
+                m_telemetryBusyIntervalMs = (uint32_t)(1000.0f / busy_hz + 0.5f);
+                m_telemetryIdleIntervalMs = (uint32_t)(1000.0f / idle_hz + 0.5f);
+                m_telemetryFields = fields;
+                int field_count = 0;
+                for (int i = 0; i < TELEM_FIELD_COUNT; i++) {
+                    if (fields & TELEM_FIELD_BIT(i)) {
+                        field_count++;
+                    }
+                }
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Telemetry every %lu ms busy, %lu ms idle, %d of %d fields",
+                         (unsigned long)m_telemetryBusyIntervalMs, (unsigned long)m_telemetryIdleIntervalMs,
+                         field_count, (int)TELEM_FIELD_COUNT);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_telemetry");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_telemetry. Use '<busy_hz> [idle_hz] [field,field,...|all]', 0.5-500 Hz");
+            }
+            break;
+        }
+
+        case CMD_SET_TELEMETRY_DELTA: {
+            long keyframe_ms = cmdArgs.set_telemetry_delta.keyframe_ms;
+            if (argsValid && cmdArgs.count == 1 && keyframe_ms >= 0 && keyframe_ms <= TELEMETRY_KEYFRAME_MS_MAX) {
+                m_telemetryKeyframeMs = (uint32_t)keyframe_ms;
+                // Start with a keyframe so the host has every field to apply deltas to
+                m_telemetryLastKeyframe = Milliseconds() - m_telemetryKeyframeMs;
+                char msg_buf[128];
+                if (keyframe_ms > 0) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Delta telemetry on, keyframe every %ld ms", keyframe_ms);
                 } else {
-                    strain_coeffs[i] = default_coeffs[i];
+                    snprintf(msg_buf, sizeof(msg_buf), "Delta telemetry off");
                 }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_telemetry_delta");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for set_telemetry_delta. Use '<keyframe_ms 1-60000>' or '0' (off)");
             }
-            
-            snprintf(msg_buf, sizeof(msg_buf), "NVMDUMP:pressboi:SUMMARY: StrainCoeffs x4=%.4f x3=%.4f x2=%.4f x1=%.4f c=%.4f", 
-                     strain_coeffs[0], strain_coeffs[1], strain_coeffs[2], strain_coeffs[3], strain_coeffs[4]);
-            m_comms.enqueueTx(msg_buf, m_comms.getGuiIp(), m_comms.getGuiPort());
+            break;
+        }
 
-            reportEvent(STATUS_PREFIX_DONE, "dump_nvm");
+        case CMD_SET_TELEMETRY_BURST: {
+            SetTelemetryBurstArgs& a = cmdArgs.set_telemetry_burst;
+            long hold_ms = (cmdArgs.count >= 2) ? a.hold_ms : (long)m_telemetryPressHoldMs;
+            bool valid = argsValid && cmdArgs.count >= 1 &&
+                         (a.press_hz == 0.0f || (a.press_hz >= TELEMETRY_RATE_HZ_MIN && a.press_hz <= TELEMETRY_RATE_HZ_MAX)) &&
+                         hold_ms >= 0 && hold_ms <= TELEMETRY_PRESS_HOLD_MS_MAX;
+            if (valid) {
+                m_telemetryPressIntervalMs = (a.press_hz > 0.0f) ? (uint32_t)(1000.0f / a.press_hz + 0.5f) : 0;
+                m_telemetryPressHoldMs = (uint32_t)hold_ms;
+                m_telemetryBurst = false;
+                char msg_buf[128];
+                if (m_telemetryPressIntervalMs > 0) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Telemetry every %lu ms while pressing, held %lu ms after",
+                             (unsigned long)m_telemetryPressIntervalMs, (unsigned long)m_telemetryPressHoldMs);
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Telemetry burst off");
+                }
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_telemetry_burst");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_telemetry_burst. Use '<press_hz 0.5-500|0> [hold_ms 0-10000]'");
+            }
             break;
         }
 
-        case CMD_RESET_NVM: {
-            ClearCore::NvmManager &nvmMgr = ClearCore::NvmManager::Instance();
+        case CMD_SET_SYNC: {
+            #if PRESS_SYNC_ENABLED
+            const SetSyncArgs& a = cmdArgs.set_sync;
+            char msg_buf[STATUS_MESSAGE_BUFFER_SIZE];
+            PressSyncRole role = PRESS_SYNC_OFF;
+            IpAddress leader(0, 0, 0, 0);
+            bool valid = argsValid;
+            if (valid && cmdArgs.count >= 1) {
+                if (strcmp(a.role, "leader") == 0) {
+                    role = PRESS_SYNC_LEADER;
+                } else if (strcmp(a.role, "follower") == 0) {
+                    role = PRESS_SYNC_FOLLOWER;
+                    valid = cmdArgs.count >= 2 && PressSync::parseAddress(a.leader_ip, &leader);
+                } else {
+                    valid = (strcmp(a.role, "off") == 0);
+                }
+            }
+            if (!valid) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for set_sync. Use 'off', 'leader' or 'follower <leader_ip>'");
+                break;
+            }
+            if (cmdArgs.count >= 1) {
+                if (m_motor.isBusy()) {
+                    reportEvent(STATUS_PREFIX_ERROR, "Error: set_sync refused while the press is busy.");
+                    break;
+                }
+                g_pressSync.configure(role, leader);
+                m_motor.setSyncGate(role != PRESS_SYNC_OFF);
+            }
+            g_pressSync.formatStatus(msg_buf, sizeof(msg_buf));
+            reportEvent(STATUS_PREFIX_INFO, msg_buf);
+            reportEvent(STATUS_PREFIX_DONE, "set_sync");
+            #else
+            reportEvent(STATUS_PREFIX_ERROR, "Press sync disabled (PRESS_SYNC_ENABLED 0)");
+            #endif
+            break;
+        }
 
-            // Reset all NVM locations to 0xFFFFFFFF (erased flash state)
-            // Each location is 4 bytes, so use proper byte offsets
-            for (int i = 0; i < 16; ++i) {
-                nvmMgr.Int32(static_cast<ClearCore::NvmManager::NvmLocations>(i * 4), -1);
+        case CMD_SUBSCRIBE_TELEMETRY: {
+            // The host names its listening port, like PORT= in discovery; the command's
+            // source port is usually an ephemeral one
+            const SubscribeTelemetryArgs& a = cmdArgs.subscribe_telemetry;
+            long port = a.port;
+            float rate_hz = a.rate_hz;
+            long lease_s = (cmdArgs.count >= 3) ? a.lease_s : TELEMETRY_LEASE_S_DEFAULT;
+            IpAddress localhost(127, 0, 0, 1);
+            if (msg.remoteIp == localhost) {
+                reportEvent(STATUS_PREFIX_ERROR, "subscribe_telemetry is for network hosts; USB already gets telemetry");
+                break;
+            }
+            // Replies go to the subscriber, which need not be the discovered GUI
+            char reply[160];
+            uint16_t replyPort = msg.remotePort;
+            if (!argsValid || cmdArgs.count < 2 || port < 1 || port > 65535 ||
+                rate_hz < TELEMETRY_RATE_HZ_MIN || rate_hz > TELEMETRY_RATE_HZ_MAX ||
+                lease_s < 1 || lease_s > TELEMETRY_LEASE_S_MAX) {
+                snprintf(reply, sizeof(reply), "%sInvalid parameters for subscribe_telemetry. Use '<port> <rate_hz 0.5-500> [lease_s 1-3600]'",
+                         STATUS_PREFIX_ERROR);
+            } else {
+                replyPort = (uint16_t)port;
+                uint32_t interval_ms = (uint32_t)(1000.0f / rate_hz + 0.5f);
+                if (!m_comms.subscribeTelemetry(msg.remoteIp, replyPort, interval_ms, (uint32_t)lease_s * 1000)) {
+                    snprintf(reply, sizeof(reply), "%sTelemetry subscriber table full", STATUS_PREFIX_ERROR);
+                } else {
+                    snprintf(reply, sizeof(reply), "%sTelemetry every %lu ms for %ld s (%d of %d subscribers)",
+                             STATUS_PREFIX_INFO, (unsigned long)interval_ms, lease_s,
+                             m_comms.getTelemetrySubscriberCount(), (int)TELEMETRY_SUBSCRIBER_COUNT);
+                    m_comms.enqueueTx(reply, msg.remoteIp, replyPort);
+                    snprintf(reply, sizeof(reply), "%ssubscribe_telemetry", STATUS_PREFIX_DONE);
+                }
             }
+            m_comms.enqueueTx(reply, msg.remoteIp, replyPort);
+            break;
+        }
+
+        case CMD_UNSUBSCRIBE_TELEMETRY: {
+            long port = cmdArgs.unsubscribe_telemetry.port;
+            char reply[128];
+            uint16_t replyPort = msg.remotePort;
+            if (argsValid && cmdArgs.count == 1 && port >= 1 && port <= 65535) {
+                replyPort = (uint16_t)port;
+                if (m_comms.unsubscribeTelemetry(msg.remoteIp, replyPort)) {
+                    snprintf(reply, sizeof(reply), "%sunsubscribe_telemetry", STATUS_PREFIX_DONE);
+                } else {
+                    snprintf(reply, sizeof(reply), "%sNot subscribed to telemetry", STATUS_PREFIX_ERROR);
+                }
+            } else {
+                snprintf(reply, sizeof(reply), "%sInvalid parameter for unsubscribe_telemetry. Use '<port>'", STATUS_PREFIX_ERROR);
+            }
+            m_comms.enqueueTx(reply, msg.remoteIp, replyPort);
+            break;
+        }
+
+        case CMD_SET_USB_ROUTE: {
+            // Indexed by UsbRoute
+            static const char* const kRouteNames[] = { "all", "events", "own" };
+            const char* route = cmdArgs.set_usb_route.route;
+            int selected = -1;
+            for (int i = 0; argsValid && cmdArgs.count == 1 && i < 3; i++) {
+                if (strcmp(route, kRouteNames[i]) == 0) {
+                    selected = i;
+                }
+            }
+            if (selected >= 0) {
+                m_comms.setUsbRoute((UsbRoute)selected);
+                char msg_buf[96];
+                snprintf(msg_buf, sizeof(msg_buf), "USB route set to '%s'", kRouteNames[selected]);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_usb_route");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for set_usb_route. Use 'all', 'events' or 'own'");
+            }
+            break;
+        }
+
+        case CMD_SET_DEBUG: {
+            long level = cmdArgs.set_debug.level;
+            if (argsValid && cmdArgs.count == 1 && level >= 0 && g_debugLog.setLevel((uint8_t)level)) {
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Debug records %s", g_debugLog.isEnabled() ? "on" : "off");
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_debug");
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for set_debug. Use '0' (off) or '1' (records)");
+            }
+            break;
+        }
+
+        case CMD_SET_LOG_LEVEL: {
+            LogLevel level = g_errorLog.getLevel();
+            if (!argsValid || (cmdArgs.count == 1 && !(ErrorLog::parseLevel(cmdArgs.set_log_level.level, &level) &&
+                                                      g_errorLog.setLevel(level)))) {
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Invalid parameter for set_log_level. Use debug, info, warn, error or crit (compiled minimum %s)",
+                         ErrorLog::levelName(ERROR_LOG_MIN_LEVEL));
+                reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+            } else {
+                char msg_buf[96];
+                snprintf(msg_buf, sizeof(msg_buf), "Log level %s (compiled minimum %s)",
+                         ErrorLog::levelName(g_errorLog.getLevel()), ErrorLog::levelName(ERROR_LOG_MIN_LEVEL));
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "set_log_level");
+            }
+            break;
+        }
+
+        case CMD_RESET_NVM: {
+            // Every scalar setting back to its default, written now rather than deferred
+            g_settings.resetDefaults();
+            g_settings.commit();
+            // Erasing a count or header is enough to drop its table; a staged one is dropped too
+            m_forceSensor.eraseLinearization();
+            m_motor.eraseTorqueFriction();
+            g_recipeStore.erase();
+            g_driveGeometry.erase();
+            // Calibration profiles are rewritten empty by the settings task
+            g_profileStore.clear();
 
             reportEvent(STATUS_PREFIX_INFO, "All NVM locations reset to erased state. Reboot required for changes to take effect.");
             reportEvent(STATUS_PREFIX_DONE, "reset_nvm");
@@ -887,94 +2352,473 @@ void Pressboi::dispatchCommand(const Message& msg) {
         }
 
         case CMD_DUMP_ERROR_LOG: {
-            // Feed watchdog periodically during log dump (don't disable it - causes reboot!)
-            // Log dumps can take >100ms for large logs, so we need to feed watchdog every few entries
-            
-            // Send error log entries over network/USB
-            int entryCount = g_errorLog.getEntryCount();
-            
-            char msg[256];
-            snprintf(msg, sizeof(msg), "=== ERROR LOG: %d entries ===", entryCount);
-            reportEvent(STATUS_PREFIX_INFO, msg);
-            
-            // Send each entry (with small delay to prevent TX queue overflow)
-            for (int i = 0; i < entryCount; i++) {
-                LogEntry entry;
-                if (g_errorLog.getEntry(i, &entry)) {
-                    const char* levelStr;
-                    switch (entry.level) {
-                        case LOG_DEBUG:    levelStr = "DEBUG"; break;
-                        case LOG_INFO:     levelStr = "INFO"; break;
-                        case LOG_WARNING:  levelStr = "WARN"; break;
-                        case LOG_ERROR:    levelStr = "ERROR"; break;
-                        case LOG_CRITICAL: levelStr = "CRIT"; break;
-                        default:           levelStr = "???"; break;
+            // Sent a few lines per loop pass from serviceDumpJob(), so even the full 24 h
+            // heartbeat log never holds up the control loop. The entry counts are taken now;
+            // entries logged while the dump runs are not included. "binary" sends the runs
+            // themselves rather than one line per heartbeat: ~50 lines instead of ~3000.
+            DumpJob job = DUMP_JOB_ERROR_LOG;
+            if (argsValid && cmdArgs.count == 1) {
+                if (strcmp(cmdArgs.dump_error_log.format, "binary") == 0) {
+                    job = DUMP_JOB_LOG_BINARY;
+                } else if (strcmp(cmdArgs.dump_error_log.format, "text") != 0) {
+                    reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for dump_error_log. Use text or binary");
+                    break;
+                }
+            }
+            if (startDumpJob(job)) {
+                m_dumpErrorStart = g_errorLog.getOldestSeq();
+                m_dumpErrorCount = (uint16_t)(g_errorLog.getSeq() - m_dumpErrorStart);
+                m_dumpHeartbeatCount = (uint16_t)g_heartbeatLog.getEntryCount();
+                m_dumpRunStart = g_heartbeatLog.getOldestRunSeq();
+                m_dumpRunEnd = g_heartbeatLog.getRunSeq();
+            }
+            break;
+        }
+
+        case CMD_DUMP_TRACE: {
+            // The records present now are sent from serviceDumpJob(); later ones wait for
+            // the next dump. Records overwritten meanwhile show up as a sequence gap.
+            if (startDumpJob(DUMP_JOB_TRACE)) {
+                m_dumpTraceStart = g_traceLog.getOldestSeq();
+                m_dumpTraceEnd = g_traceLog.getSeq();
+            }
+            break;
+        }
+
+        case CMD_DUMP_CRASH: {
+            #if CRASH_SNAPSHOT_ENABLED
+            // The snapshot loaded at boot stays until the next reset, so this can be repeated
+            startDumpJob(DUMP_JOB_CRASH);
+            #else
+            reportEvent(STATUS_PREFIX_ERROR, "Crash snapshot disabled (CRASH_SNAPSHOT_ENABLED 0)");
+            #endif
+            break;
+        }
+
+        case CMD_SAVE_PROFILE: {
+            const char* name = cmdArgs.profile.name;
+            int8_t slot = -1;
+            if (!argsValid || cmdArgs.count != 1) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for save_profile. Name must be 1-15 characters");
+            } else if (g_profileStore.getState() == PROFILE_STATE_FAILED) {
+                reportEvent(STATUS_PREFIX_ERROR, "save_profile failed: profile flash write error (see error log)");
+            } else if ((slot = g_profileStore.save(name, g_settings.get())) < 0) {
+                reportEvent(STATUS_PREFIX_ERROR, (g_profileStore.getCount() >= PROFILE_MAX_COUNT)
+                            ? "save_profile failed: all 8 profile slots in use (delete_profile one)"
+                            : "Invalid parameter for save_profile. Name must be 1-15 characters");
+            } else {
+                // The calibration in use now matches the profile
+                g_settings.edit().active_profile = (uint8_t)(slot + 1);
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "Calibration profile '%s' saved (slot %d, %d of %d in use)",
+                         name, (int)slot, (int)g_profileStore.getCount(), PROFILE_MAX_COUNT);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "save_profile");
+            }
+            break;
+        }
+
+        case CMD_SELECT_PROFILE: {
+            const char* name = cmdArgs.profile.name;
+            const CalibrationProfile* profile = g_profileStore.get(g_profileStore.find(name));
+            if (!argsValid || cmdArgs.count != 1) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for select_profile");
+            } else if (profile == nullptr) {
+                reportEvent(STATUS_PREFIX_ERROR, "select_profile failed: no such profile");
+            } else if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "select_profile rejected: press is moving");
+            } else {
+                // All in this one command, so no pass runs with half a calibration; the
+                // setters only change RAM and the settings task writes the result once
+                m_motor.setMachineStrainCoeffs(profile->strain_coeffs[0], profile->strain_coeffs[1],
+                                               profile->strain_coeffs[2], profile->strain_coeffs[3],
+                                               profile->strain_coeffs[4]);
+                m_motor.setTorqueCalibration(profile->torque_scale, profile->torque_offset);
+                m_motor.setPressThreshold(profile->press_threshold_kg);
+                m_forceSensor.setScale(profile->force_scale[0]);
+                m_forceSensor.setOffset(profile->force_offset_kg[0]);
+                m_forceSensorB.setScale(profile->force_scale[1]);
+                m_forceSensorB.setOffset(profile->force_offset_kg[1]);
+                g_settings.edit().active_profile = (uint8_t)(g_profileStore.find(name) + 1);
+
+                char msg_buf[192];
+                snprintf(msg_buf, sizeof(msg_buf),
+                         "Calibration profile '%s' applied: A %.6f/%.2f kg, B %.6f/%.2f kg, torque %.4f/%.2f %%, threshold %.2f kg",
+                         profile->name, profile->force_scale[0], profile->force_offset_kg[0],
+                         profile->force_scale[1], profile->force_offset_kg[1],
+                         profile->torque_scale, profile->torque_offset, profile->press_threshold_kg);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "select_profile");
+            }
+            break;
+        }
+
+        case CMD_BACKUP_NVM: {
+            // One line, so a fleet backup is one request and one reply per press
+            uint8_t image[NVM_IMAGE_BYTES];
+            g_settings.exportImage(image);
+            static const char prefix[] = "NVMIMAGE:pressboi:";
+            char* line = m_comms.reserveTx(sizeof(prefix) - 1 + (sizeof(image) + 2) / 3 * 4 + 1, TX_LANE_BULK);
+            if (line == NULL) {
+                reportEvent(STATUS_PREFIX_ERROR, "backup_nvm failed: TX queue full, retry");
+                break;
+            }
+            memcpy(line, prefix, sizeof(prefix) - 1);
+            size_t length = sizeof(prefix) - 1 + base64Encode(image, sizeof(image), line + sizeof(prefix) - 1);
+            m_comms.commitTx(length, m_comms.getGuiIp(), m_comms.getGuiPort());
+            reportEvent(STATUS_PREFIX_DONE, "backup_nvm", TX_LANE_BULK);
+            break;
+        }
+
+        case CMD_RESTORE_NVM: {
+            uint8_t image[NVM_IMAGE_BYTES];
+            size_t length = (argsValid && cmdArgs.count == 1) ? base64Decode(cmdArgs.restore_nvm.image, image, sizeof(image)) : 0;
+            if (length != sizeof(image)) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameter for restore_nvm. Need the base64 image from backup_nvm");
+            } else if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "restore_nvm rejected: press is moving");
+            } else if (!g_nvmJournal.isIdle() || !g_profileStore.isIdle()) {
+                reportEvent(STATUS_PREFIX_ERROR, "restore_nvm rejected: flash write in progress, retry");
+            } else if (!g_settings.importImage(image, length)) {
+                reportEvent(STATUS_PREFIX_ERROR, "restore_nvm failed: image header or CRC mismatch (nothing written)");
+            } else {
+                const NvmImageHeader* header = reinterpret_cast<const NvmImageHeader*>(image);
+                char msg_buf[128];
+                snprintf(msg_buf, sizeof(msg_buf), "NVM image restored (%u bytes, settings v%u). Reboot required for changes to take effect.",
+                         (unsigned)header->length, (unsigned)header->settings_version);
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "restore_nvm");
+            }
+            break;
+        }
+
+        case CMD_FORCE_REPLAY: {
+            #if FORCE_REPLAY_ENABLED
+            const char* action = cmdArgs.force_replay.action;
+            char msg_buf[160];
+            if (!argsValid || cmdArgs.count < 1) {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for force_replay. Use start, stop, capture, clear or add <position_mm raw> ...");
+            } else if (strcmp(action, "stop") == 0) {
+                // Always allowed, so a replay can be ended mid-press
+                g_forceReplay.stop();
+                snprintf(msg_buf, sizeof(msg_buf), "Force replay stopped after %lu samples; COM-0 feeds load cell A again",
+                         (unsigned long)g_forceReplay.getSamples());
+                reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                reportEvent(STATUS_PREFIX_DONE, "force_replay");
+            } else if (m_motor.isBusy()) {
+                reportEvent(STATUS_PREFIX_ERROR, "force_replay rejected: press is moving");
+            } else if (strcmp(action, "start") == 0) {
+                if (g_forceReplay.start(Microseconds())) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Force replay started: %u points, %.3f to %.3f mm, load cell A at %d Hz",
+                             (unsigned)g_forceReplay.getCount(),
+                             toMillimeters(Steps(g_forceReplay.getFirstPosition())).value,
+                             toMillimeters(Steps(g_forceReplay.getLastPosition())).value, FORCE_REPLAY_RATE_HZ);
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                    reportEvent(STATUS_PREFIX_DONE, "force_replay");
+                } else {
+                    reportEvent(STATUS_PREFIX_ERROR, "force_replay start failed: profile needs at least 2 points");
+                }
+            } else if (g_forceReplay.isActive()) {
+                reportEvent(STATUS_PREFIX_ERROR, "force_replay rejected: profile is in use, stop the replay first");
+            } else if (strcmp(action, "clear") == 0) {
+                g_forceReplay.clear();
+                reportEvent(STATUS_PREFIX_DONE, "force_replay");
+            } else if (strcmp(action, "capture") == 0) {
+                g_forceReplay.clear();
+                uint16_t samples = g_pressCapture.visit(&ForceReplay::captureVisitor, &g_forceReplay);
+                if (g_forceReplay.getCount() < 2) {
+                    reportEvent(STATUS_PREFIX_ERROR, "force_replay capture failed: the last press capture has no loading stroke");
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Force replay profile loaded from capture: %u points of %u samples (%lu skipped)",
+                             (unsigned)g_forceReplay.getCount(), (unsigned)samples, (unsigned long)g_forceReplay.getSkipped());
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                    reportEvent(STATUS_PREFIX_DONE, "force_replay");
+                }
+            } else if (strcmp(action, "add") == 0 && cmdArgs.count == 2) {
+                // Variable-length list of "position_mm raw" pairs
+                const char* p = cmdArgs.force_replay.points;
+                char* end = NULL;
+                int pairs = 0;
+                bool valid = true;
+                while (valid) {
+                    float position_mm = strtof(p, &end);
+                    if (end == p) {
+                        break;
                     }
-                    
-                    // Format: [timestamp_ms] LEVEL: message
-                    snprintf(msg, sizeof(msg), "[%lu] %s: %s", entry.timestamp, levelStr, entry.message);
-                    reportEvent(STATUS_PREFIX_INFO, msg);
-                    
-                    // Small delay to allow TX queue to drain (prevent overflow)
-                    Delay_ms(5);
-                    
-                    // Feed watchdog every 5 entries to prevent timeout
-                    if ((i + 1) % 5 == 0) {
-                        feedWatchdog();
+                    p = end;
+                    long raw_value = strtol(p, &end, 10);
+                    if (end == p) {
+                        valid = false;
+                        break;
                     }
+                    p = end;
+                    valid = g_forceReplay.append(toSteps(Millimeters(position_mm)).value, (int32_t)raw_value);
+                    pairs++;
                 }
+                if (valid && pairs > 0) {
+                    snprintf(msg_buf, sizeof(msg_buf), "Force replay profile: %u points (%lu skipped)",
+                             (unsigned)g_forceReplay.getCount(), (unsigned long)g_forceReplay.getSkipped());
+                    reportEvent(STATUS_PREFIX_INFO, msg_buf);
+                    reportEvent(STATUS_PREFIX_DONE, "force_replay");
+                } else {
+                    snprintf(msg_buf, sizeof(msg_buf), "Invalid points for force_replay add. Use 'position_mm raw' pairs, at most %d points",
+                             FORCE_REPLAY_MAX_POINTS);
+                    reportEvent(STATUS_PREFIX_ERROR, msg_buf);
+                }
+            } else {
+                reportEvent(STATUS_PREFIX_ERROR, "Invalid parameters for force_replay. Use start, stop, capture, clear or add <position_mm raw> ...");
             }
-            
-            // Feed watchdog after error log
-            feedWatchdog();
-            
-            snprintf(msg, sizeof(msg), "=== END ERROR LOG ===");
-            reportEvent(STATUS_PREFIX_INFO, msg);
-            
-            // Also dump heartbeat log (24 hours of data!)
-            int heartbeatCount = g_heartbeatLog.getEntryCount();
-            
-            // Calculate time span
-            if (heartbeatCount > 0) {
-                HeartbeatEntry firstEntry, lastEntry;
-                g_heartbeatLog.getEntry(0, &firstEntry);
-                g_heartbeatLog.getEntry(heartbeatCount - 1, &lastEntry);
-                uint32_t spanMs = lastEntry.timestamp - firstEntry.timestamp;
-                uint32_t spanHours = spanMs / 3600000;
-                uint32_t spanMins = (spanMs % 3600000) / 60000;
-                
-                snprintf(msg, sizeof(msg), "=== HEARTBEAT LOG: %d entries (%luh%lum span) ===", 
-                         heartbeatCount, (unsigned long)spanHours, (unsigned long)spanMins);
+            #else
+            reportEvent(STATUS_PREFIX_ERROR, "force_replay not available: firmware built without FORCE_REPLAY_ENABLED");
+            #endif
+            break;
+        }
+
+        case CMD_DELETE_PROFILE: {
+            int8_t slot = (argsValid && cmdArgs.count == 1) ? g_profileStore.remove(cmdArgs.profile.name) : -1;
+            if (slot >= 0) {
+                if (g_settings.get().active_profile == slot + 1) {
+                    g_settings.edit().active_profile = 0;
+                }
+                reportEvent(STATUS_PREFIX_DONE, "delete_profile");
             } else {
-                snprintf(msg, sizeof(msg), "=== HEARTBEAT LOG: 0 entries ===");
+                reportEvent(STATUS_PREFIX_ERROR, "delete_profile failed: no such profile");
+            }
+            break;
+        }
+
+        case CMD_DUMP_PERF: {
+            #if LOOP_PROFILER_ENABLED
+            char msg[256];
+            const LoopStageStats& total = g_loopProfiler.getStats(LOOP_STAGE_TOTAL);
+            snprintf(msg, sizeof(msg), "=== LOOP PERF: %lu passes in %lu ms ===",
+                     (unsigned long)total.count, (unsigned long)g_loopProfiler.getWindowMs());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: stage: n=<passes> min=<us> mean=<us> max=<us> hist=<b0>,<b1>,...
+            for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+                LoopStage stage = static_cast<LoopStage>(i);
+                const LoopStageStats& stats = g_loopProfiler.getStats(stage);
+                uint32_t minTenths = (stats.count > 0) ? LoopProfiler::cyclesToTenthsUs(stats.min_cycles) : 0;
+                uint32_t meanTenths = (stats.count > 0) ? LoopProfiler::cyclesToTenthsUs(stats.total_cycles / stats.count) : 0;
+                uint32_t maxTenths = LoopProfiler::cyclesToTenthsUs(stats.max_cycles);
+                int len = snprintf(msg, sizeof(msg), "%s: n=%lu min=%lu.%lu mean=%lu.%lu max=%lu.%lu us hist=",
+                                   LoopProfiler::stageName(stage), (unsigned long)stats.count,
+                                   (unsigned long)(minTenths / 10), (unsigned long)(minTenths % 10),
+                                   (unsigned long)(meanTenths / 10), (unsigned long)(meanTenths % 10),
+                                   (unsigned long)(maxTenths / 10), (unsigned long)(maxTenths % 10));
+                for (uint8_t b = 0; b < LOOP_PROFILER_BUCKETS && len > 0 && len < (int)sizeof(msg); b++) {
+                    len += snprintf(msg + len, sizeof(msg) - len, (b == 0) ? "%lu" : ",%lu",
+                                    (unsigned long)stats.histogram[b]);
+                }
+                reportBulkLine(STATUS_PREFIX_INFO, msg);
+            }
+
+            // Format: task <name>: prio=<p> budget=<us> runs=<n> deferred=<n> overruns=<n> [stack=<bytes> at=<breadcrumb>]
+            for (uint8_t i = 0; i < g_loopScheduler.getTaskCount(); i++) {
+                const LoopTask& task = g_loopScheduler.getTask(i);
+                int len = snprintf(msg, sizeof(msg), "task %s: prio=%u budget=%lu runs=%lu deferred=%lu overruns=%lu",
+                                   task.name, (unsigned)task.priority, (unsigned long)task.budget_us,
+                                   (unsigned long)task.runs, (unsigned long)task.deferred, (unsigned long)task.overruns);
+                #if MEMORY_STACK_TASK_PEAKS
+                if (len > 0 && len < (int)sizeof(msg)) {
+                    snprintf(msg + len, sizeof(msg) - len, " stack=%lu at=%s",
+                             (unsigned long)task.stack_peak_bytes, breadcrumbName(task.stack_breadcrumb));
+                }
+                #else
+                (void)len;
+                #endif
+                reportBulkLine(STATUS_PREFIX_INFO, msg);
+            }
+            #if MEMORY_STACK_TASK_PEAKS
+            // Format: stack: peak=<bytes> unused=<bytes>
+            snprintf(msg, sizeof(msg), "stack: peak=%lu unused=%lu",
+                     (unsigned long)g_memoryMap.getStackPeakBytes(), (unsigned long)g_memoryMap.getStackUnusedBytes());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+            #endif
+
+            // Format: idle work: queued=<n> steps=<n> preempted=<n> rejected=<n> worst=<us> us (<job>)
+            snprintf(msg, sizeof(msg), "idle work: queued=%u steps=%lu preempted=%lu rejected=%lu worst=%lu us (%s)",
+                     (unsigned)g_idleWork.getQueued(), (unsigned long)g_idleWork.getSteps(),
+                     (unsigned long)g_idleWork.getPreemptions(), (unsigned long)g_idleWork.getRejected(),
+                     (unsigned long)g_idleWork.getWorstStepUs(), g_idleWork.getWorstStepName());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: slow passes: n=<since boot> deadline=<us> worst=<us> us [last=<us> us task=<name> <us> us at=<breadcrumb> ago=<ms> ms]
+            const LoopSlowPass& slow = g_loopScheduler.getLastSlowPass();
+            int len = snprintf(msg, sizeof(msg), "slow passes: n=%lu deadline=%lu worst=%lu us",
+                               (unsigned long)g_loopScheduler.getSlowPassCount(), (unsigned long)LOOP_SLOW_PASS_US,
+                               (unsigned long)g_loopScheduler.getWorstPassUs());
+            if (g_loopScheduler.getSlowPassCount() > 0 && len > 0 && len < (int)sizeof(msg)) {
+                const char* taskName = (slow.task < g_loopScheduler.getTaskCount()) ? g_loopScheduler.getTask(slow.task).name : "none";
+                snprintf(msg + len, sizeof(msg) - len, " last=%lu us task=%s %lu us at=%s ago=%lu ms",
+                         (unsigned long)slow.pass_us, taskName, (unsigned long)slow.task_us,
+                         breadcrumbName(slow.breadcrumb), (unsigned long)(Milliseconds() - slow.time_ms));
+            }
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: control tick: n=<ticks> period=<us> max_gap=<us> us
+            snprintf(msg, sizeof(msg), "control tick: n=%lu period=%lu max_gap=%lu us",
+                     (unsigned long)g_controlTick.getTickCount(), (unsigned long)(1000000UL / CONTROL_TICK_HZ),
+                     (unsigned long)g_controlTick.getMaxTickGapUs());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            #if WATCHDOG_ENABLED
+            // Format: watchdog: late=<name|none> <name>=<worst>/<deadline> ... ms
+            uint8_t lateClient = g_watchdogSupervisor.getLateClient();
+            len = snprintf(msg, sizeof(msg), "watchdog: late=%s",
+                           (lateClient < g_watchdogSupervisor.getClientCount()) ? g_watchdogSupervisor.getClient(lateClient).name : "none");
+            for (uint8_t i = 0; i < g_watchdogSupervisor.getClientCount() && len > 0 && len < (int)sizeof(msg); i++) {
+                const WatchdogClient& client = g_watchdogSupervisor.getClient(i);
+                len += snprintf(msg + len, sizeof(msg) - len, " %s=%lu/%lu", client.name,
+                                (unsigned long)client.worst_ms, (unsigned long)client.deadline_ms);
+            }
+            if (len > 0 && len < (int)sizeof(msg)) {
+                snprintf(msg + len, sizeof(msg) - len, " ms");
+            }
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+            #endif
+
+            // Format: udp rx: datagrams=<since boot> dropped=<since boot> max_per_pass=<n>
+            snprintf(msg, sizeof(msg), "udp rx: datagrams=%lu dropped=%lu max_per_pass=%u",
+                     (unsigned long)m_comms.getUdpRxDatagrams(), (unsigned long)m_comms.getUdpRxDropped(),
+                     (unsigned)m_comms.getUdpRxMaxPerPass());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            #if PRESSBOI_BENCHMARK
+            // Format: bench <name>: calls=<n> min=<cycles> mean=<cycles> cycles
+            if (m_motor.isBusy()) {
+                reportBulkLine(STATUS_PREFIX_INFO, "bench: skipped while the press is busy");
+            } else {
+                g_benchmarks.run(m_comms, m_motor);
+                for (uint8_t i = 0; i < BENCH_COUNT; i++) {
+                    const BenchmarkResult& result = g_benchmarks.getResult(i);
+                    snprintf(msg, sizeof(msg), "bench %s: calls=%lu min=%lu mean=%lu cycles",
+                             BenchmarkSuite::name(i), (unsigned long)result.calls,
+                             (unsigned long)result.min_cycles, (unsigned long)result.mean_cycles);
+                    reportBulkLine(STATUS_PREFIX_INFO, msg);
+                }
+            }
+            #endif
+
+            reportBulkLine(STATUS_PREFIX_INFO, "=== END LOOP PERF ===");
+            // The dump itself runs inside this pass's rx stage; reset() keeps it out of the new window
+            g_loopProfiler.reset();
+            g_loopScheduler.resetStats();
+            reportEvent(STATUS_PREFIX_DONE, "dump_perf", TX_LANE_BULK);
+            #else
+            reportEvent(STATUS_PREFIX_ERROR, "Loop profiler disabled (LOOP_PROFILER_ENABLED 0)");
+            #endif
+            break;
+        }
+
+        case CMD_DUMP_MEM: {
+            char msg[160];
+            reportBulkLine(STATUS_PREFIX_INFO, "=== MEMORY ===");
+
+            // Format: ram: total=<bytes> data=<bytes> bss=<bytes> heap=<bytes>
+            snprintf(msg, sizeof(msg), "ram: total=%lu data=%lu bss=%lu heap=%lu",
+                     (unsigned long)MemoryMap::getRamBytes(), (unsigned long)MemoryMap::getDataBytes(),
+                     (unsigned long)MemoryMap::getBssBytes(), (unsigned long)MemoryMap::getHeapBytes());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: stack: now=<bytes> peak=<bytes> unused=<bytes> (peak since boot; unused = painted, never reached)
+            snprintf(msg, sizeof(msg), "stack: now=%lu peak=%lu unused=%lu",
+                     (unsigned long)MemoryMap::getStackNowBytes(), (unsigned long)g_memoryMap.getStackPeakBytes(),
+                     (unsigned long)g_memoryMap.getStackUnusedBytes());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: pool <name>: bytes=<n>
+            struct MemoryPool {
+                const char* name;
+                uint32_t bytes;
+            };
+            const MemoryPool pools[] = {
+                { "comms",              sizeof(m_comms) },
+                { "comms rx",           RX_ARENA_SIZE + RX_QUEUE_SIZE * sizeof(MessageSlot) },
+                { "comms tx control",   TX_ARENA_SIZE + TX_QUEUE_SIZE * sizeof(MessageSlot) },
+                { "comms tx telemetry", TX_TELEMETRY_ARENA_SIZE + TX_TELEMETRY_QUEUE_SIZE * sizeof(MessageSlot) },
+                { "comms tx bulk",      TX_BULK_ARENA_SIZE + TX_BULK_QUEUE_SIZE * sizeof(MessageSlot) },
+                { "comms usb tx ring",  USB_TX_RING_SIZE },
+                { "motor",              sizeof(m_motor) },
+                { "force sensors",      sizeof(m_forceSensor) + sizeof(m_forceSensorB) },
+                { "pressboi other",     sizeof(*this) - sizeof(m_comms) - sizeof(m_motor) - sizeof(m_forceSensor) - sizeof(m_forceSensorB) },
+                { "press capture",      sizeof(g_pressCapture) },
+                #if POSITION_CURVE_ENABLED
+                { "position curve",     sizeof(g_positionCurve) },
+                #endif
+                { "error log",          sizeof(g_errorLog) },
+                { "heartbeat log",      sizeof(g_heartbeatLog) },
+                { "debug log",          sizeof(g_debugLog) },
+                { "trace log",          sizeof(g_traceLog) },
+                { "sd log",             sizeof(g_sdLog) },
+                { "event queue",        sizeof(g_eventQueue) },
+                { "recipe",             sizeof(g_recipeStore) },
+                { "profiles",           sizeof(g_profileStore) },
+                { "settings",           sizeof(g_settings) },
+                { "nvm journal",        sizeof(g_nvmJournal) },
+                { "crash snapshot",     sizeof(g_crashSnapshot) },
+                { "loop profiler",      sizeof(g_loopProfiler) },
+                { "telemetry",          sizeof(g_telemetry) },
+                #if FORCE_REPLAY_ENABLED
+                { "force replay",       sizeof(g_forceReplay) },
+                #endif
+            };
+            for (size_t i = 0; i < sizeof(pools) / sizeof(pools[0]); i++) {
+                snprintf(msg, sizeof(msg), "pool %s: bytes=%lu", pools[i].name, (unsigned long)pools[i].bytes);
+                reportBulkLine(STATUS_PREFIX_INFO, msg);
             }
-            reportEvent(STATUS_PREFIX_INFO, msg);
-            
-            // Send entries in compact format: timestamp,U,N,A (USB,Network,Available)
-            for (int i = 0; i < heartbeatCount; i++) {
-                HeartbeatEntry entry;
-                if (g_heartbeatLog.getEntry(i, &entry)) {
-                    // Ultra-compact format: [timestamp] U:0/1 N:0/1 A:bytes
-                    snprintf(msg, sizeof(msg), "[%lu] U:%d N:%d A:%d", 
-                             entry.timestamp, entry.usbConnected, 
-                             entry.networkActive, entry.usbAvailable);
-                    reportEvent(STATUS_PREFIX_INFO, msg);
-                    
-                    // Every 10 entries, add delay to prevent TX queue overflow and feed watchdog
-                    if ((i + 1) % 10 == 0) {
-                        Delay_ms(50);
-                        feedWatchdog();
-                    }
-                }
+
+            reportBulkLine(STATUS_PREFIX_INFO, "=== END MEMORY ===");
+            reportEvent(STATUS_PREFIX_DONE, "dump_mem", TX_LANE_BULK);
+            break;
+        }
+
+        case CMD_DUMP_CYCLE_TIMES: {
+            char msg[128];
+            const CyclePhaseStats& total = g_cycleTiming.getStats(CYCLE_PHASE_TOTAL);
+            snprintf(msg, sizeof(msg), "=== CYCLE TIMES: %lu cycles ===", (unsigned long)total.count);
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: phase: n=<cycles> min=<ms> mean=<ms> max=<ms> ms (phases a cycle skipped are not counted)
+            for (uint8_t i = 0; i <= CYCLE_PHASE_COUNT; i++) {
+                const CyclePhaseStats& stats = g_cycleTiming.getStats(i);
+                float meanMs = (stats.count > 0) ? (float)(stats.total_us / stats.count) / 1000.0f : 0.0f;
+                snprintf(msg, sizeof(msg), "%s: n=%lu min=%.1f mean=%.1f max=%.1f ms",
+                         CycleTiming::phaseName(i), (unsigned long)stats.count,
+                         stats.min_us / 1000.0f, meanMs, stats.max_us / 1000.0f);
+                reportBulkLine(STATUS_PREFIX_INFO, msg);
             }
-            
-            // Feed watchdog one final time
-            feedWatchdog();
-            
-            snprintf(msg, sizeof(msg), "=== END HEARTBEAT LOG ===");
-            reportEvent(STATUS_PREFIX_INFO, msg);
-            
-            reportEvent(STATUS_PREFIX_DONE, "dump_error_log");
+
+            reportBulkLine(STATUS_PREFIX_INFO, "=== END CYCLE TIMES ===");
+            g_cycleTiming.resetStats();
+            reportEvent(STATUS_PREFIX_DONE, "dump_cycle_times", TX_LANE_BULK);
+            break;
+        }
+
+        case CMD_DUMP_PRODUCTION: {
+            char msg[STATUS_MESSAGE_BUFFER_SIZE];
+            // Format: production: cycles=<n> travel_m=<m> energy_kj=<kJ> trips=<n> checkpoint=<cycle>
+            snprintf(msg, sizeof(msg), "production: cycles=%lu travel_m=%.3f energy_kj=%.3f trips=%lu checkpoint=%lu",
+                     (unsigned long)g_productionCounters.getCycles(), g_productionCounters.getTravelMm() / 1000.0,
+                     g_productionCounters.getEnergyJ() / 1000.0, (unsigned long)g_productionCounters.getTrips(),
+                     (unsigned long)g_productionCounters.getCheckpointCycle());
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+
+            // Format: peak_kg: bucket=<kg> hist=<b0>,<b1>,... (bucket b from b * bucket kg, the last open-ended)
+            int len = snprintf(msg, sizeof(msg), "peak_kg: bucket=%.0f hist=", PRODUCTION_PEAK_BUCKET_KG);
+            for (uint8_t b = 0; b < PRODUCTION_PEAK_BUCKETS && len > 0 && len < (int)sizeof(msg); b++) {
+                len += snprintf(msg + len, sizeof(msg) - len, (b == 0) ? "%lu" : ",%lu",
+                                (unsigned long)g_productionCounters.getPeakBucket(b));
+            }
+            reportBulkLine(STATUS_PREFIX_INFO, msg);
+            reportEvent(STATUS_PREFIX_DONE, "dump_production", TX_LANE_BULK);
+            break;
+        }
+
+        case CMD_RESET_PRODUCTION: {
+            g_productionCounters.reset();
+            reportEvent(STATUS_PREFIX_DONE, "reset_production");
             break;
         }
 
@@ -984,7 +2828,11 @@ void Pressboi::dispatchCommand(const Message& msg) {
         case CMD_MOVE_INC:
         case CMD_SET_RETRACT:
         case CMD_RETRACT:
-            m_motor.handleCommand(command_enum, args);
+        case CMD_QUEUE_MOVE:
+        case CMD_QUEUE_RUN:
+        case CMD_QUEUE_CLEAR:
+        case CMD_RUN_RECIPE:
+            m_motor.handleCommand(command_enum, argsValid ? &cmdArgs : NULL);
             break;
 
         // --- Motion Control Commands ---
@@ -1003,8 +2851,501 @@ void Pressboi::dispatchCommand(const Message& msg) {
         // --- Default/Unknown ---
         case CMD_UNKNOWN:
         default:
-            m_comms.reportEvent(STATUS_PREFIX_ERROR, "Unknown command sent to Pressboi.");
+            reportEvent(STATUS_PREFIX_ERROR, "Unknown command sent to Pressboi.");
+            break;
+    }
+}
+
+/**
+ * @brief Sends the next dump_capture or dump_curve line if one is pending and the TX queue has room.
+ * @details One line per loop pass, leaving PRESS_CAPTURE_TX_RESERVE slots for telemetry
+ * and events, so a full capture streams out without blocking the main loop.
+ */
+void Pressboi::serviceCaptureDump() {
+    if (m_captureDumpNext < 0 || m_comms.getTxQueueFree(TX_LANE_BULK) <= PRESS_CAPTURE_TX_RESERVE) {
+        return;
+    }
+    char* line = m_comms.reserveTx(MAX_MESSAGE_LENGTH, TX_LANE_BULK);
+    if (line == NULL) {
+        return;
+    }
+    uint16_t sent;
+#if POSITION_CURVE_ENABLED
+    if (m_captureDumpCurve) {
+        sent = g_positionCurve.formatLine((uint16_t)m_captureDumpNext, line, MAX_MESSAGE_LENGTH);
+    } else
+#endif
+    {
+        sent = g_pressCapture.formatLine((uint16_t)m_captureDumpNext, line, MAX_MESSAGE_LENGTH);
+    }
+    if (sent == 0) {
+        m_captureDumpNext = -1;
+        reportEvent(STATUS_PREFIX_DONE, m_captureDumpCurve ? "dump_curve" : "dump_capture", TX_LANE_BULK);
+        return;
+    }
+    m_comms.commitTx(strlen(line), m_comms.getGuiIp(), m_comms.getGuiPort());
+    m_captureDumpNext += sent;
+}
+
+/**
+ * @details Only one of dump_nvm, dump_error_log, dump_trace and dump_crash runs at a time; dump_capture has its
+ * own cursor and can run alongside.
+ */
+bool Pressboi::startDumpJob(DumpJob job) {
+    if (m_dumpJob != DUMP_JOB_NONE) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s ignored: %s is already running.", dumpJobName(job), dumpJobName((DumpJob)m_dumpJob));
+        reportEvent(STATUS_PREFIX_ERROR, msg);
+        return false;
+    }
+    m_dumpJob = job;
+    m_dumpLine = 0;
+    m_dumpRequestId = m_eventRequestId;
+    return true;
+}
+
+const char* Pressboi::dumpJobName(DumpJob job) {
+    switch (job) {
+        case DUMP_JOB_NVM:       return "dump_nvm";
+        case DUMP_JOB_ERROR_LOG: return "dump_error_log";
+        case DUMP_JOB_TRACE:     return "dump_trace";
+        case DUMP_JOB_CRASH:     return "dump_crash";
+        case DUMP_JOB_LOG_BINARY: return "dump_error_log";
+        default:                 return "dump";
+    }
+}
+
+/**
+ * @details Sends up to DUMP_LINES_PER_PASS lines while the bulk lane has more than
+ * DUMP_TX_RESERVE free slots. A line that does not fit is formatted again next pass.
+ */
+void Pressboi::serviceDumpJob() {
+    if (m_dumpJob == DUMP_JOB_NONE) {
+        return;
+    }
+    char msg[384];
+    for (uint8_t n = 0; n < DUMP_LINES_PER_PASS; n++) {
+        if (m_comms.getTxQueueFree(TX_LANE_BULK) <= DUMP_TX_RESERVE) {
+            return;
+        }
+        bool more;
+        switch (m_dumpJob) {
+            case DUMP_JOB_NVM:   more = formatNvmDumpLine(m_dumpLine, msg, sizeof(msg)); break;
+            case DUMP_JOB_TRACE: more = formatTraceDumpLine(m_dumpLine, msg, sizeof(msg)); break;
+            case DUMP_JOB_LOG_BINARY: more = formatLogBinaryDumpLine(m_dumpLine, msg, sizeof(msg)); break;
+            #if CRASH_SNAPSHOT_ENABLED
+            case DUMP_JOB_CRASH: more = formatCrashDumpLine(m_dumpLine, msg, sizeof(msg)); break;
+            #endif
+            default:             more = formatErrorLogDumpLine(m_dumpLine, msg, sizeof(msg)); break;
+        }
+        if (!more) {
+            DumpJob job = (DumpJob)m_dumpJob;
+            m_dumpJob = DUMP_JOB_NONE;
+            reportEvent(STATUS_PREFIX_DONE, dumpJobName(job), TX_LANE_BULK);
+            return;
+        }
+        // NVMDUMP, TRACE and LOGDUMP lines are routed by their own prefix; error log and crash lines are INFO
+        bool prefixed = (m_dumpJob == DUMP_JOB_NVM || m_dumpJob == DUMP_JOB_TRACE ||
+                         m_dumpJob == DUMP_JOB_LOG_BINARY || strncmp(msg, "TRACE:", 6) == 0);
+        bool queued = !prefixed
+                          ? reportBulkLine(STATUS_PREFIX_INFO, msg)
+                          : m_comms.enqueueTx(msg, m_comms.getGuiIp(), m_comms.getGuiPort(), TX_LANE_BULK);
+        if (!queued) {
+            return;
+        }
+        m_dumpLine++;
+    }
+}
+
+/**
+ * @details Lines 0 .. NVM_SLOT_COUNT - 1 are the raw settings block slots read when the
+ * dump started; the SUMMARY lines follow, interpreted from the RAM settings, so they
+ * include changes not committed yet.
+ */
+bool Pressboi::formatNvmDumpLine(uint16_t line, char* buffer, size_t size) {
+    if (line < NVM_SLOT_COUNT) {
+        int byte_offset = line * 4;
+        int32_t value = m_dumpNvmValues[line];
+        unsigned char* bytes = (unsigned char*)&value;
+
+        // Format hex bytes
+        char hex_str[50];
+        char ascii_str[10];
+        snprintf(hex_str, sizeof(hex_str), "%02X %02X %02X %02X",
+                 bytes[0], bytes[1], bytes[2], bytes[3]);
+
+        // ASCII representation (printable chars only)
+        for (int j = 0; j < 4; j++) {
+            ascii_str[j] = (bytes[j] >= 32 && bytes[j] <= 126) ? bytes[j] : '.';
+        }
+        ascii_str[4] = '\0';
+
+        // Send with NVMDUMP prefix for GUI routing
+        snprintf(buffer, size, "NVMDUMP:pressboi:%04X:%s:%s", byte_offset, hex_str, ascii_str);
+        return true;
+    }
+
+    switch (line - NVM_SLOT_COUNT) {
+        case 0: {
+            // Settings block header and commit state
+            const PressSettings& settings = g_settings.get();
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Settings=v%u source=%s pending=%s commits=%lu CurrentMode=%s",
+                     (unsigned)SETTINGS_VERSION, SettingsStore::sourceName(g_settings.getSource()),
+                     g_settings.isDirty() ? "yes" : "no", (unsigned long)g_settings.getCommitCount(),
+                     (settings.force_mode == 0) ? "motor_torque" : "load_cell");
+            return true;
+        }
+
+        case 1: {
+            const PressSettings& settings = g_settings.get();
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: LoadCell: Scale=%.6f Offset=%.4f kg",
+                     settings.force_scale[0], settings.force_offset_kg[0]);
+            return true;
+        }
+
+        case 2: {
+            const PressSettings& settings = g_settings.get();
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: MotorTorque: Scale=%.6f Offset=%.4f %%",
+                     settings.torque_scale, settings.torque_offset);
+            return true;
+        }
+
+        case 3: {
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Polarity=%s",
+                     g_settings.get().polarity_inverted ? "inverted" : "normal");
+            return true;
+        }
+
+        case 4: {
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: HomeOnBoot=%s",
+                     g_settings.get().home_on_boot ? "true" : "false");
+            return true;
+        }
+
+        case 5: {
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: RetractPosition=%.2f mm",
+                     g_settings.get().retract_mm);
+            return true;
+        }
+
+        case 6: {
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: PressThreshold=%.2f kg",
+                     g_settings.get().press_threshold_kg);
+            return true;
+        }
+
+        case 7: {
+            const float* strain_coeffs = g_settings.get().strain_coeffs;
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: StrainCoeffs x4=%.4f x3=%.4f x2=%.4f x1=%.4f c=%.4f",
+                     strain_coeffs[0], strain_coeffs[1], strain_coeffs[2], strain_coeffs[3], strain_coeffs[4]);
+            return true;
+        }
+
+        case 8: {
+            const PressSettings& settings = g_settings.get();
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: ForceFilter median=%d alpha=%.3f",
+                     (int)settings.filter_median, settings.filter_alpha);
+            return true;
+        }
+
+        case 9: {
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: ForceLatency=%ld us", (long)g_settings.get().force_latency_us);
+            return true;
+        }
+
+        case 10: {
+            const PressSettings& settings = g_settings.get();
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: LoadCellB: Scale=%.6f Offset=%.4f kg ForceChannel=%s",
+                     settings.force_scale[1], settings.force_offset_kg[1], m_motor.getForceChannel());
+            return true;
+        }
+
+        case 11: {
+            // Force linearization table (slots 71-103) - one line, not a raw dump, to fit the TX queue
+            int table_len = snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: ForceTable points=%d",
+                                     (int)m_forceSensor.getLinearizationCount());
+            for (uint8_t i = 0; i < m_forceSensor.getLinearizationCount() && table_len < (int)size; i++) {
+                int32_t point_raw;
+                float point_kg;
+                m_forceSensor.getLinearizationPoint(i, &point_raw, &point_kg);
+                table_len += snprintf(buffer + table_len, size - table_len, " %ld:%.2f",
+                                      (long)point_raw, point_kg);
+            }
+            return true;
+        }
+
+        case 12: {
+            // Motion profile (settings block)
+            if (m_motor.getMotionJerk() > 0.0f) {
+                snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: MotionProfile=scurve jerk=%.0f mm/s^3", m_motor.getMotionJerk());
+            } else {
+                snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: MotionProfile=trapezoid");
+            }
+            return true;
+        }
+
+        case 13: {
+            // Encoder feedback (settings block)
+            if (m_motor.getEncoderCountsPerMm() != 0.0f) {
+                snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Encoder=%.2f counts/mm tolerance=%.2f mm",
+                         m_motor.getEncoderCountsPerMm(), m_motor.getEncoderToleranceMm());
+            } else {
+                snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Encoder=off");
+            }
+            return true;
+        }
+
+        case 14: {
+            // Torque friction table (slots 66-70)
+            int friction_len = snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: TorqueFriction points=%d",
+                                        (int)m_motor.getTorqueFrictionCount());
+            for (uint8_t i = 0; i < m_motor.getTorqueFrictionCount() && friction_len < (int)size; i++) {
+                float point_mms;
+                float point_pct;
+                m_motor.getTorqueFrictionPoint(i, &point_mms, &point_pct);
+                friction_len += snprintf(buffer + friction_len, size - friction_len, " %.1f:%.2f",
+                                         point_mms, point_pct);
+            }
+            return true;
+        }
+
+        case 15: {
+            // Stored recipe (slots 22-62)
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Recipe name=%s steps=%d learn_margin=%.2f learn_rapid=%.1f",
+                     g_recipeStore.getName()[0] ? g_recipeStore.getName() : "(none)", (int)g_recipeStore.getStepCount(),
+                     g_recipeStore.getLearnMarginMm(), g_recipeStore.getLearnRapidMms());
+            return true;
+        }
+
+        case 16: {
+            // Flash journal for retract, press threshold and force offsets
+            snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Journal block=%u records=%u/%u erases=%lu state=%s",
+                     (unsigned)g_nvmJournal.getActiveBlock(), (unsigned)g_nvmJournal.getUsedRecords(),
+                     (unsigned)(NVM_JOURNAL_BLOCK_SIZE / sizeof(NvmJournalRecord)),
+                     (unsigned long)g_nvmJournal.getErases(), NvmJournal::stateName(g_nvmJournal.getState()));
+            return true;
+        }
+
+        case 17: {
+            // Calibration profiles, in slot order
+            const PressSettings& settings = g_settings.get();
+            const CalibrationProfile* active = g_profileStore.get((int8_t)settings.active_profile - 1);
+            int len = snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: Profiles=%d/%d active=%s state=%s names=",
+                               (int)g_profileStore.getCount(), PROFILE_MAX_COUNT, active ? active->name : "(none)",
+                               ProfileStore::stateName(g_profileStore.getState()));
+            bool first = true;
+            for (int8_t i = 0; i < PROFILE_MAX_COUNT && len > 0 && len < (int)size; i++) {
+                const CalibrationProfile* profile = g_profileStore.get(i);
+                if (profile != nullptr) {
+                    len += snprintf(buffer + len, size - len, first ? "%s" : ",%s", profile->name);
+                    first = false;
+                }
+            }
+            return true;
+        }
+
+        case 18: {
+            // Rapid traverse (settings block)
+            if (m_motor.getRapidVelMms() > 0) {
+                snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: RapidTraverse=%d mm/s accel=%d mm/s^2",
+                         m_motor.getRapidVelMms(), m_motor.getRapidAccelMmss());
+            } else {
+                snprintf(buffer, size, "NVMDUMP:pressboi:SUMMARY: RapidTraverse=off");
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @details Lines: error log header, its entries, end marker, then the same for the
+ * heartbeat log, using the entry counts taken when the dump started.
+ */
+bool Pressboi::formatErrorLogDumpLine(uint16_t line, char* buffer, size_t size) {
+    uint16_t errorEnd = m_dumpErrorCount + 1;             // Line of "END ERROR LOG"
+    uint16_t heartbeatEnd = errorEnd + m_dumpHeartbeatCount + 2;  // Line of "END HEARTBEAT LOG"
+
+    if (line == 0) {
+        snprintf(buffer, size, "=== ERROR LOG: %d entries ===", (int)m_dumpErrorCount);
+        return true;
+    }
+    if (line < errorEnd) {
+        LogEntry entry;
+        if (!g_errorLog.getEntryAt(m_dumpErrorStart + line - 1, &entry)) {
+            snprintf(buffer, size, "[?] ???: (entry overwritten)");
+            return true;
+        }
+        // Format: [timestamp_ms] LEVEL: message
+        snprintf(buffer, size, "[%lu] %s: %s", entry.timestamp, ErrorLog::levelName(entry.level), entry.message);
+        return true;
+    }
+    if (line == errorEnd) {
+        snprintf(buffer, size, "=== END ERROR LOG ===");
+        return true;
+    }
+    if (line == errorEnd + 1) {
+        // Time span of the heartbeat log (24 hours of data!)
+        HeartbeatEntry firstEntry, lastEntry;
+        if (m_dumpHeartbeatCount > 0 && g_heartbeatLog.getEntry(0, &firstEntry) &&
+            g_heartbeatLog.getEntry(m_dumpHeartbeatCount - 1, &lastEntry)) {
+            uint32_t spanMs = lastEntry.timestamp - firstEntry.timestamp;
+            uint32_t spanHours = spanMs / 3600000;
+            uint32_t spanMins = (spanMs % 3600000) / 60000;
+            snprintf(buffer, size, "=== HEARTBEAT LOG: %d entries (%luh%lum span) ===",
+                     (int)m_dumpHeartbeatCount, (unsigned long)spanHours, (unsigned long)spanMins);
+        } else {
+            snprintf(buffer, size, "=== HEARTBEAT LOG: %d entries ===", (int)m_dumpHeartbeatCount);
+        }
+        return true;
+    }
+    if (line < heartbeatEnd) {
+        HeartbeatEntry entry;
+        if (!g_heartbeatLog.getEntry(line - errorEnd - 2, &entry)) {
+            snprintf(buffer, size, "[?] U:? N:? A:?");
+            return true;
+        }
+        // Ultra-compact format: [timestamp] U:0/1 N:0/1 A:bytes
+        snprintf(buffer, size, "[%lu] U:%d N:%d A:%d",
+                 entry.timestamp, entry.usbConnected,
+                 entry.networkActive, entry.usbAvailable);
+        return true;
+    }
+    if (line == heartbeatEnd) {
+        snprintf(buffer, size, "=== END HEARTBEAT LOG ===");
+        return true;
+    }
+    return false;
+}
+
+static_assert(sizeof(HeartbeatRun) == 12, "LOGDUMP HB records are the 12-byte HeartbeatRun as stored");
+static_assert(LOG_DUMP_ERRORS_PER_LINE * (6 + ERROR_LOG_MSG_LENGTH - 1) <= 255,
+              "A LOGDUMP ERR line must fit the dump line buffer");
+
+/**
+ * @details Line 0 is the header, with the counts taken when the dump started. Then
+ * LOG_DUMP_ERRORS_PER_LINE error entries per ERR line, consecutive from its sequence number,
+ * each packed as timestamp u32, level u8, length u8 and the message without its NUL; an entry
+ * overwritten since the dump started is sent as level 0xFF, length 0. Then the heartbeat
+ * runs, LOG_DUMP_RUNS_PER_LINE per HB line as stored; runs dropped since the start shorten
+ * the line, with first_seq at the first one that survived, as in dump_trace.
+ */
+bool Pressboi::formatLogBinaryDumpLine(uint16_t line, char* buffer, size_t size) {
+    uint16_t errorLines = (uint16_t)((m_dumpErrorCount + LOG_DUMP_ERRORS_PER_LINE - 1) / LOG_DUMP_ERRORS_PER_LINE);
+    uint32_t runCount = m_dumpRunEnd - m_dumpRunStart;
+    uint16_t runLines = (uint16_t)((runCount + LOG_DUMP_RUNS_PER_LINE - 1) / LOG_DUMP_RUNS_PER_LINE);
+
+    if (line == 0) {
+        snprintf(buffer, size, "LOGDUMP:pressboi:HEADER:%lu:%lu:%u:%lu:%lu:%u", (unsigned long)Milliseconds(),
+                 (unsigned long)m_dumpErrorStart, (unsigned)m_dumpErrorCount, (unsigned long)m_dumpRunStart,
+                 (unsigned long)runCount, (unsigned)m_dumpHeartbeatCount);
+        return true;
+    }
+    if (line <= errorLines) {
+        uint16_t index = (uint16_t)((line - 1) * LOG_DUMP_ERRORS_PER_LINE);
+        uint16_t n = m_dumpErrorCount - index;
+        if (n > LOG_DUMP_ERRORS_PER_LINE) {
+            n = LOG_DUMP_ERRORS_PER_LINE;
+        }
+        uint32_t first = m_dumpErrorStart + index;
+        uint8_t packed[LOG_DUMP_ERRORS_PER_LINE * (6 + ERROR_LOG_MSG_LENGTH - 1)];
+        size_t length = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            LogEntry entry;
+            uint8_t* record = packed + length;
+            if (!g_errorLog.getEntryAt(first + i, &entry)) {
+                memset(record, 0, 6);
+                record[4] = 0xFF;
+                length += 6;
+                continue;
+            }
+            size_t textLength = strnlen(entry.message, ERROR_LOG_MSG_LENGTH - 1);
+            memcpy(record, &entry.timestamp, 4);
+            record[4] = (uint8_t)entry.level;
+            record[5] = (uint8_t)textLength;
+            memcpy(record + 6, entry.message, textLength);
+            length += 6 + textLength;
+        }
+        int len = snprintf(buffer, size, "LOGDUMP:pressboi:ERR:%lu:", (unsigned long)first);
+        if (len < 0 || (size_t)len + (length + 2) / 3 * 4 >= size) {
+            return false;
+        }
+        base64Encode(packed, length, buffer + len);
+        return true;
+    }
+    if (line <= errorLines + runLines) {
+        uint32_t from = m_dumpRunStart + (uint32_t)(line - 1 - errorLines) * LOG_DUMP_RUNS_PER_LINE;
+        uint32_t to = from + LOG_DUMP_RUNS_PER_LINE;
+        if (to > m_dumpRunEnd) {
+            to = m_dumpRunEnd;
+        }
+        uint32_t first = g_heartbeatLog.getOldestRunSeq();
+        if (first < from) {
+            first = from;
+        } else if (first > to) {
+            first = to;
+        }
+        HeartbeatRun runs[LOG_DUMP_RUNS_PER_LINE];
+        uint16_t n = 0;
+        while (first + n < to && g_heartbeatLog.getRunAt(first + n, &runs[n])) {
+            n++;
+        }
+        int len = snprintf(buffer, size, "LOGDUMP:pressboi:HB:%lu:", (unsigned long)first);
+        if (len < 0 || (size_t)len + (n * sizeof(HeartbeatRun) + 2) / 3 * 4 >= size) {
+            return false;
+        }
+        base64Encode(reinterpret_cast<const uint8_t*>(runs), n * sizeof(HeartbeatRun), buffer + len);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @details Line n covers sequence numbers m_dumpTraceStart + n * TRACE_LOG_RECORDS_PER_LINE
+ * onwards. A line whose records were overwritten since the dump started is sent shortened
+ * (or empty), with first_seq at the first record that survived.
+ */
+bool Pressboi::formatTraceDumpLine(uint16_t line, char* buffer, size_t size) {
+    uint32_t from = m_dumpTraceStart + (uint32_t)line * TRACE_LOG_RECORDS_PER_LINE;
+    if (from >= m_dumpTraceEnd) {
+        return false;
+    }
+    uint32_t to = from + TRACE_LOG_RECORDS_PER_LINE;
+    if (to > m_dumpTraceEnd) {
+        to = m_dumpTraceEnd;
+    }
+    TraceRecord records[TRACE_LOG_RECORDS_PER_LINE];
+    uint32_t first;
+    uint16_t n = g_traceLog.read(from, records, (uint16_t)(to - from), &first);
+    if (first >= to) {
+        first = to;
+        n = 0;
+    } else if (first + n > to) {
+        n = (uint16_t)(to - first);
+    }
+    int len = snprintf(buffer, size, "TRACE:pressboi:DATA:%lu:", (unsigned long)first);
+    if (len < 0 || (size_t)len + (n * sizeof(TraceRecord) + 2) / 3 * 4 >= size) {
+        return false;
+    }
+    base64Encode(reinterpret_cast<const uint8_t*>(records), n * sizeof(TraceRecord), buffer + len);
+    return true;
+}
+
+/**
+ * @brief Sends pending debug records while the TX queue has room.
+ * @details Stops at DEBUG_LOG_TX_RESERVE free slots so telemetry and events are never
+ * crowded out; records that pile up past the ring are counted as dropped instead.
+ */
+void Pressboi::serviceDebugLog() {
+    while (g_debugLog.hasPending() && m_comms.getTxQueueFree(TX_LANE_BULK) > DEBUG_LOG_TX_RESERVE) {
+        // Reserve before formatting: formatLine() consumes the records it writes
+        char* line = m_comms.reserveTx(MAX_MESSAGE_LENGTH, TX_LANE_BULK);
+        if (line == NULL || g_debugLog.formatLine(line, MAX_MESSAGE_LENGTH) == 0) {
             break;
+        }
+        m_comms.commitTx(strlen(line), m_comms.getGuiIp(), m_comms.getGuiPort());
     }
 }
 
@@ -1015,8 +3356,8 @@ void Pressboi::publishTelemetry() {
     // Always publish telemetry - it will be sent to both network (if GUI discovered) and USB
     
     
-    // Update telemetry data from motor controller (includes force calculation)
-    m_motor.updateTelemetry(&g_telemetry, &m_forceSensor);
+    // Motor and force fields from the control tick's latest snapshot, time_us included
+    m_motor.updateTelemetry(&g_telemetry);
     
     // Set main state
     switch(m_mainState) {
@@ -1029,16 +3370,58 @@ void Pressboi::publishTelemetry() {
         case STATE_RECOVERED:      g_telemetry.MAIN_STATE = "RECOVERED"; break;
         default:                   g_telemetry.MAIN_STATE = "UNKNOWN"; break;
     }
+    g_telemetry.slow_loops = (int32_t)g_loopScheduler.getSlowPassCount();
+    #if STATION_IO_ENABLED
+    g_telemetry.station_inputs = (int32_t)g_stationIo.getInputs();
+    #endif
+    g_telemetry.loop_slack_ms = WATCHDOG_TIMEOUT_MS - (int32_t)((g_loopScheduler.takeWindowWorstPassUs() + 999) / 1000);
+    updateForceHealth();
+
+    // Delta mode: only what moved since it was last sent, everything at each keyframe
+    uint32_t fields = m_telemetryFields;
+    bool keyframe = true;
+    if (!m_telemetryBinary && m_telemetryKeyframeMs > 0) {
+        keyframe = (Milliseconds() - m_telemetryLastKeyframe >= m_telemetryKeyframeMs);
+        if (!keyframe) {
+            fields &= telemetry_changed_fields(&g_telemetry, &m_telemetrySent);
+            if (fields == 0) {
+                return;
+            }
+        }
+        // The unsent frame this one replaces must not lose its changes
+        if (m_comms.hasPendingTx(TX_LANE_TELEMETRY)) {
+            fields |= m_telemetryQueuedFields;
+        }
+    }
 
-    // Build and send telemetry message
-    char telemetryBuffer[1024];
-    telemetry_build_message(&g_telemetry, telemetryBuffer, sizeof(telemetryBuffer));
+    // Built straight into the telemetry TX slot, replacing any frame not sent yet
+    char* telemetryBuffer = m_comms.reserveTx(MAX_MESSAGE_LENGTH, TX_LANE_TELEMETRY);
+    if (telemetryBuffer == NULL) {
+        return;
+    }
+    size_t len;
+    if (m_telemetryBinary) {
+        TelemetryBinaryFrame frame;
+        telemetry_build_frame(&g_telemetry, m_telemetrySeq++, &frame);
+        len = sizeof(TELEM_BINARY_PREFIX) - 1;
+        memcpy(telemetryBuffer, TELEM_BINARY_PREFIX, len);
+        len += base64Encode(reinterpret_cast<const uint8_t*>(&frame), sizeof(frame), telemetryBuffer + len);
+    } else {
+        if (m_telemetryKeyframeMs > 0) {
+            if (keyframe) {
+                m_telemetryLastKeyframe = Milliseconds();
+            }
+            telemetry_copy_fields(&m_telemetrySent, &g_telemetry, fields);
+        }
+        len = telemetry_build_message_fields(&g_telemetry, fields, telemetryBuffer, MAX_MESSAGE_LENGTH);
+        m_telemetryQueuedFields = fields;
+    }
     
     // Always queue telemetry - use dummy IP if GUI not discovered yet
     IpAddress targetIp = m_comms.isGuiDiscovered() ? m_comms.getGuiIp() : IpAddress(0, 0, 0, 0);
     uint16_t targetPort = m_comms.isGuiDiscovered() ? m_comms.getGuiPort() : 0;
     
-    m_comms.enqueueTx(telemetryBuffer, targetIp, targetPort);
+    m_comms.commitTx(len, targetIp, targetPort);
 }
 
 /**
@@ -1050,7 +3433,7 @@ void Pressboi::enable() {
         m_motor.enable();
         // DONE message sent by dispatchCommand
     } else {
-        m_comms.reportEvent(STATUS_PREFIX_INFO, "System already enabled.");
+        reportEvent(STATUS_PREFIX_INFO, "System already enabled.");
     }
 }
 
@@ -1075,9 +3458,17 @@ void Pressboi::abort() {
 
 /**
  * @brief Resets any error states, clears motor faults, and returns the system to standby.
+ * @details Errors that leave the drives healthy (a force trip, a rejected part, a script
+ * hold) get the soft reset: motion stops and the controller state is cleared in this pass,
+ * with the drives kept enabled and their settings untouched. A motor fault, a drive that is
+ * not enabled, or the ERROR, DISABLED and RECOVERED states get the full disable / clear
+ * alerts / re-enable cycle.
+ * @param full true to run the full cycle even when the soft reset would do
  */
-void Pressboi::clearErrors() {
-    reportEvent(STATUS_PREFIX_INFO, "Reset received. Clearing errors and resetting system...");
+void Pressboi::clearErrors(bool full) {
+    bool soft = !full && m_motor.drivesEnabled() && !m_motor.isInFault() &&
+                m_mainState != STATE_ERROR && m_mainState != STATE_DISABLED && m_mainState != STATE_RECOVERED &&
+                m_mainState != STATE_RESETTING;
 
 #if WATCHDOG_ENABLED
     clearWatchdogRecovery();
@@ -1086,6 +3477,14 @@ void Pressboi::clearErrors() {
     // Abort any active motion first to ensure a clean state.
     m_motor.abortMove();
 
+    if (soft) {
+        standby();
+        reportEvent(STATUS_PREFIX_INFO, "Soft reset: controller state cleared, drives kept enabled.");
+        reportEvent(STATUS_PREFIX_DONE, "reset");
+        return;
+    }
+    reportEvent(STATUS_PREFIX_INFO, "Reset received. Clearing errors and resetting system...");
+
     // Disable motors and start non-blocking reset timer
     m_motor.disable();
     m_resetStartTime = Milliseconds();
@@ -1107,8 +3506,140 @@ void Pressboi::standby() {
 /**
  * @brief Public interface to send a status message.
  */
-void Pressboi::reportEvent(const char* statusType, const char* message) {
-    m_comms.reportEvent(statusType, message);
+void Pressboi::reportEvent(TextView statusType, TextView message, TxLane lane) {
+    serviceEvents();
+    m_comms.reportEvent(statusType, message, lane, m_eventRequestId);
+    #if REGISTER_MAP_ENABLED
+    noteRegisterResult(statusType);
+    #endif
+}
+
+void Pressboi::postEvent(StatusEventId id, EventArg arg0, EventArg arg1, EventArg arg2) {
+    g_eventQueue.post(id, m_eventRequestId, arg0, arg1, arg2);
+    #if REGISTER_MAP_ENABLED
+    noteRegisterResult(status_event_format(id)->prefix);
+    #endif
+}
+
+#if REGISTER_MAP_ENABLED
+void Pressboi::refreshRegisterImage() {
+    TelemetryData values;
+    m_motor.updateTelemetry(&values);
+    RegisterImage* image = g_registerMap.image();
+    image->time_us = values.time_us;
+    image->main_state = (uint8_t)m_mainState;
+    uint8_t flags = 0;
+    if (values.enabled0) flags |= REGISTER_FLAG_ENABLED;
+    if (values.homed) flags |= REGISTER_FLAG_HOMED;
+    if (m_motor.isBusy()) flags |= REGISTER_FLAG_BUSY;
+    if (m_mainState == STATE_ERROR || m_mainState == STATE_RECOVERED) flags |= REGISTER_FLAG_ERROR;
+    if (m_forceDegraded) flags |= REGISTER_FLAG_FORCE_DEGRADED;
+    image->flags = flags;
+    image->current_pos = values.current_pos;
+    image->target_pos = values.target_pos;
+    image->retract_pos = values.retract_pos;
+    image->force = m_motor.isLoadCellMode() ? values.force_load_cell : values.force_motor_torque;
+    image->force_load_cell = values.force_load_cell;
+    image->force_motor_torque = values.force_motor_torque;
+    image->force_limit = values.force_limit;
+    image->endpoint = values.endpoint;
+    image->startpoint = values.startpoint;
+    image->joules = values.joules;
+}
+
+/**
+ * @details The command goes through the RX queue like a network command, behind any
+ * already waiting, so it keeps its order and the dispatch budget; its replies still go to
+ * the GUI, and the image reports how it ended.
+ */
+void Pressboi::serviceRegisterMailbox() {
+    if (!m_comms.isNetworkReady() || !g_registerMap.open()) {
+        return;
+    }
+    uint16_t seq;
+    uint8_t frame[REGISTER_MAP_FRAME_BYTES];
+    uint8_t length;
+    IpAddress ip;
+    uint16_t port;
+    if (!g_registerMap.takeCommand(&seq, frame, &length, &ip, &port)) {
+        return;
+    }
+    char line[(REGISTER_MAP_FRAME_BYTES + 2) / 3 * 4 + 32];
+    size_t len = append_char(line, sizeof(line), 0, '#');
+    len = append_int(line, sizeof(line), len, (int32_t)(REGISTER_MAP_REQUEST_ID_BASE + seq));
+    len = append_char(line, sizeof(line), len, ' ');
+    len = append_str(line, sizeof(line), len, CMD_STR_CMDB);
+    base64Encode(frame, length, line + len);
+    if (!m_comms.enqueueRx(line, ip, port)) {
+        g_registerMap.finishCommand(seq, REGISTER_RESULT_REJECTED);
+    }
+}
+
+void Pressboi::noteRegisterResult(TextView statusType) {
+    uint8_t status;
+    if (statusType.len == sizeof(STATUS_PREFIX_DONE) - 1 && memcmp(statusType.text, STATUS_PREFIX_DONE, statusType.len) == 0) {
+        status = REGISTER_RESULT_DONE;
+    } else if (statusType.len == sizeof(STATUS_PREFIX_ERROR) - 1 && memcmp(statusType.text, STATUS_PREFIX_ERROR, statusType.len) == 0) {
+        status = REGISTER_RESULT_ERROR;
+    } else {
+        return;
+    }
+    RegisterImage* image = g_registerMap.image();
+    image->result_status = status;
+    image->result_count++;
+    if (m_eventRequestId > REGISTER_MAP_REQUEST_ID_BASE && m_eventRequestId - REGISTER_MAP_REQUEST_ID_BASE <= 0xFFFF) {
+        g_registerMap.finishCommand((uint16_t)(m_eventRequestId - REGISTER_MAP_REQUEST_ID_BASE), status);
+    }
+}
+#endif
+
+void Pressboi::serviceEvents() {
+    IpAddress targetIp = m_comms.isGuiDiscovered() ? m_comms.getGuiIp() : IpAddress(0, 0, 0, 0);
+    uint16_t targetPort = m_comms.isGuiDiscovered() ? m_comms.getGuiPort() : 0;
+    const EventRecord* rec;
+    while ((rec = g_eventQueue.peek()) != NULL) {
+        // A full control lane drops the event like any other control message (reserveTx reports it)
+        char* line = m_comms.reserveTx(STATUS_MESSAGE_BUFFER_SIZE, TX_LANE_CONTROL);
+        if (line == NULL) {
+            g_eventQueue.consume();
+            continue;
+        }
+        size_t len;
+        if (m_eventBinary) {
+            len = append_view(line, STATUS_MESSAGE_BUFFER_SIZE, 0, TEXT_VIEW(EVENT_BINARY_PREFIX));
+            len += base64Encode(reinterpret_cast<const uint8_t*>(rec), sizeof(*rec), line + len);
+        } else {
+            len = EventQueue::formatText(*rec, line, STATUS_MESSAGE_BUFFER_SIZE);
+        }
+        m_comms.commitTx(len, targetIp, targetPort);
+        g_eventQueue.consume();
+    }
+}
+
+uint32_t Pressboi::takeRequestId(MessageView& msg) {
+    const char* command;
+    uint32_t id = CommsController::parseRequestId(msg.buffer, &command);
+    if (id != 0) {
+        msg.buffer = command;
+    }
+    return id;
+}
+
+bool Pressboi::reportBulkLine(TextView statusType, TextView message) {
+    size_t capacity = statusType.len + message.len + 1;
+    if (capacity > MAX_MESSAGE_LENGTH) {
+        capacity = MAX_MESSAGE_LENGTH;
+    }
+    char* line = m_comms.reserveTx(capacity, TX_LANE_BULK);
+    if (line == NULL) {
+        return false;
+    }
+    size_t len = append_view(line, capacity, 0, statusType);
+    len = append_view(line, capacity, len, message);
+    IpAddress targetIp = m_comms.isGuiDiscovered() ? m_comms.getGuiIp() : IpAddress(0, 0, 0, 0);
+    uint16_t targetPort = m_comms.isGuiDiscovered() ? m_comms.getGuiPort() : 0;
+    m_comms.commitTx(len, targetIp, targetPort);
+    return true;
 }
 
 //==================================================================================================
@@ -1127,8 +3658,14 @@ void Pressboi::handleWatchdogRecovery() {
     uint8_t reset_cause = RSTC->RCAUSE.reg;
     bool is_watchdog_reset = (reset_cause & RSTC_RCAUSE_WDT) != 0;
     
+    // A HardFault resets through NVIC_SystemReset(); its snapshot is what marks it
+    bool is_fault_reset = false;
+    #if CRASH_SNAPSHOT_ENABLED
+    is_fault_reset = g_crashSnapshot.hasSaved() && g_crashSnapshot.getSaved().cause == CRASH_CAUSE_HARDFAULT;
+    #endif
+    
     // If watchdog reset detected, immediately disable motors and enter RECOVERED state
-    if (is_watchdog_reset) {
+    if (is_watchdog_reset || is_fault_reset) {
         m_motor.disable();
         m_mainState = STATE_RECOVERED;
         
@@ -1146,62 +3683,15 @@ void Pressboi::handleWatchdogRecovery() {
         m_comms.reportEvent(STATUS_PREFIX_INFO, debug_msg);
         
         // Clear any motor alerts
-        MOTOR_A.ClearAlerts();
-        MOTOR_B.ClearAlerts();
+        for (int i = 0; i < MOTOR_AXIS_COUNT; i++) {
+            kPressStation.motors[i]->ClearAlerts();
+        }
         
         // Send recovery message with breadcrumb
         // Use g_crashTimeBreadcrumb which was captured at the start of setup()
         // before g_watchdogBreadcrumb was overwritten
-        char recoveryMsg[128];
-        const char* breadcrumb_name = "UNKNOWN";
-        switch (g_crashTimeBreadcrumb) {
-            case WD_BREADCRUMB_SAFETY_CHECK: breadcrumb_name = "SAFETY_CHECK"; break;
-            case WD_BREADCRUMB_COMMS_UPDATE: breadcrumb_name = "COMMS_UPDATE"; break;
-            case WD_BREADCRUMB_RX_DEQUEUE: breadcrumb_name = "RX_DEQUEUE"; break;
-            case WD_BREADCRUMB_UPDATE_STATE: breadcrumb_name = "UPDATE_STATE"; break;
-            case WD_BREADCRUMB_FORCE_UPDATE: breadcrumb_name = "FORCE_UPDATE"; break;
-            case WD_BREADCRUMB_MOTOR_UPDATE: breadcrumb_name = "MOTOR_UPDATE"; break;
-            case WD_BREADCRUMB_TELEMETRY: breadcrumb_name = "TELEMETRY"; break;
-            case WD_BREADCRUMB_UDP_PROCESS: breadcrumb_name = "UDP_PROCESS"; break;
-            case WD_BREADCRUMB_USB_PROCESS: breadcrumb_name = "USB_PROCESS"; break;
-            case WD_BREADCRUMB_TX_QUEUE: breadcrumb_name = "TX_QUEUE"; break;
-            case WD_BREADCRUMB_UDP_SEND: breadcrumb_name = "UDP_SEND"; break;
-            case WD_BREADCRUMB_NETWORK_REFRESH: breadcrumb_name = "NETWORK_REFRESH"; break;
-            case WD_BREADCRUMB_USB_SEND: breadcrumb_name = "USB_SEND"; break;
-            case WD_BREADCRUMB_USB_RECONNECT: breadcrumb_name = "USB_RECONNECT"; break;
-            case WD_BREADCRUMB_USB_RECOVERY: breadcrumb_name = "USB_RECOVERY"; break;
-            case WD_BREADCRUMB_REPORT_EVENT: breadcrumb_name = "REPORT_EVENT"; break;
-            case WD_BREADCRUMB_ENQUEUE_TX: breadcrumb_name = "ENQUEUE_TX"; break;
-            case WD_BREADCRUMB_MOTOR_IS_FAULT: breadcrumb_name = "MOTOR_IS_FAULT"; break;
-            case WD_BREADCRUMB_MOTOR_STATE_SWITCH: breadcrumb_name = "MOTOR_STATE_SWITCH"; break;
-            case WD_BREADCRUMB_PROCESS_TX_QUEUE: breadcrumb_name = "PROCESS_TX_QUEUE"; break;
-            case WD_BREADCRUMB_TX_QUEUE_DEQUEUE: breadcrumb_name = "TX_QUEUE_DEQUEUE"; break;
-            case WD_BREADCRUMB_TX_QUEUE_UDP: breadcrumb_name = "TX_QUEUE_UDP"; break;
-            case WD_BREADCRUMB_TX_QUEUE_USB: breadcrumb_name = "TX_QUEUE_USB"; break;
-            case WD_BREADCRUMB_DISPATCH_CMD: breadcrumb_name = "DISPATCH_CMD"; break;
-            case WD_BREADCRUMB_PARSE_CMD: breadcrumb_name = "PARSE_CMD"; break;
-            case WD_BREADCRUMB_MOTOR_FAULT_REPORT: breadcrumb_name = "MOTOR_FAULT_REPORT"; break;
-            case WD_BREADCRUMB_STATE_BUSY_CHECK: breadcrumb_name = "STATE_BUSY_CHECK"; break;
-            case WD_BREADCRUMB_UDP_PACKET_READ: breadcrumb_name = "UDP_PACKET_READ"; break;
-            case WD_BREADCRUMB_RX_ENQUEUE: breadcrumb_name = "RX_ENQUEUE"; break;
-            case WD_BREADCRUMB_USB_AVAILABLE: breadcrumb_name = "USB_AVAILABLE"; break;
-            case WD_BREADCRUMB_USB_READ: breadcrumb_name = "USB_READ"; break;
-            case WD_BREADCRUMB_NETWORK_INPUT: breadcrumb_name = "NETWORK_INPUT"; break;
-            case WD_BREADCRUMB_LWIP_INPUT: breadcrumb_name = "LWIP_INPUT"; break;
-            case WD_BREADCRUMB_LWIP_TIMEOUT: breadcrumb_name = "LWIP_TIMEOUT"; break;
-            case WD_BREADCRUMB_SETUP: breadcrumb_name = "SETUP"; break;
-            case WD_BREADCRUMB_SETUP_MOTOR_MODE: breadcrumb_name = "SETUP_MOTOR_MODE"; break;
-            case WD_BREADCRUMB_SETUP_COMMS: breadcrumb_name = "SETUP_COMMS"; break;
-            case WD_BREADCRUMB_SETUP_MOTOR: breadcrumb_name = "SETUP_MOTOR"; break;
-            case WD_BREADCRUMB_SETUP_FORCE: breadcrumb_name = "SETUP_FORCE"; break;
-            case WD_BREADCRUMB_SETUP_WD_RECOVERY: breadcrumb_name = "SETUP_WD_RECOVERY"; break;
-            case WD_BREADCRUMB_SETUP_WD_INIT: breadcrumb_name = "SETUP_WD_INIT"; break;
-            case WD_BREADCRUMB_SETUP_USB: breadcrumb_name = "SETUP_USB"; break;
-            case WD_BREADCRUMB_SETUP_ETHERNET: breadcrumb_name = "SETUP_ETHERNET"; break;
-            case WD_BREADCRUMB_SETUP_DHCP: breadcrumb_name = "SETUP_DHCP"; break;
-            case WD_BREADCRUMB_SETUP_LINK_WAIT: breadcrumb_name = "SETUP_LINK_WAIT"; break;
-        }
-        snprintf(recoveryMsg, sizeof(recoveryMsg), "Watchdog timeout in %s - main loop blocked >256ms. Motors disabled. Send RESET to clear.", breadcrumb_name);
+        char recoveryMsg[160];
+        formatRecoveryMessage(recoveryMsg, sizeof(recoveryMsg));
         m_comms.reportEvent(STATUS_PREFIX_RECOVERY, recoveryMsg);
         
         // Keep LED on solid to indicate recovered state
@@ -1223,6 +3713,29 @@ void Pressboi::handleWatchdogRecovery() {
     }
 }
 
+/**
+ * @details A HardFault snapshot names the faulting PC; otherwise the message is the
+ * watchdog timeout at the breadcrumb captured at boot.
+ */
+void Pressboi::formatRecoveryMessage(char* buffer, size_t size) {
+    #if CRASH_SNAPSHOT_ENABLED
+    if (g_crashSnapshot.hasSaved() && g_crashSnapshot.getSaved().cause == CRASH_CAUSE_HARDFAULT) {
+        const CrashSnapshot& snapshot = g_crashSnapshot.getSaved();
+        snprintf(buffer, size, "HardFault at PC 0x%08lX in %s. Motors disabled. Send RESET to clear.",
+                 (unsigned long)snapshot.pc, breadcrumbName(snapshot.breadcrumb));
+        return;
+    }
+    #endif
+    const WatchdogLateRecord* late = g_watchdogSupervisor.getSavedLate();
+    if (late) {
+        snprintf(buffer, size, "Watchdog supervisor: %s missed its check-in (%lu ms silent, deadline %lu ms). Motors disabled. Send RESET to clear.",
+                 late->name, (unsigned long)late->silence_ms, (unsigned long)late->deadline_ms);
+        return;
+    }
+    snprintf(buffer, size, "Watchdog timeout in %s - main loop blocked >256ms. Motors disabled. Send RESET to clear.",
+             breadcrumbName(g_crashTimeBreadcrumb));
+}
+
 /**
  * @brief Initializes the watchdog timer with early warning interrupt.
  */
@@ -1281,6 +3794,147 @@ void Pressboi::clearWatchdogRecovery() {
 }
 #endif
 
+//==================================================================================================
+// --- Crash Snapshot ---
+//==================================================================================================
+
+#if CRASH_SNAPSHOT_ENABLED
+static_assert(sizeof(((CrashSnapshot*)0)->tx_depth) / sizeof(uint16_t) == TX_LANE_COUNT,
+              "CrashSnapshot::tx_depth needs one entry per TX lane");
+
+/**
+ * @details Runs in the watchdog early warning or the HardFault handler, so it only
+ * copies state: no reporting, no allocation, nothing that waits.
+ */
+void Pressboi::captureCrashSnapshot(uint8_t cause, const uint32_t* frame) {
+    uint8_t breadcrumb = WD_BREADCRUMB_UNKNOWN;
+    #if WATCHDOG_ENABLED
+    breadcrumb = (uint8_t)g_watchdogBreadcrumb;
+    #endif
+    CrashSnapshot* snapshot = g_crashSnapshot.begin(cause, breadcrumb);
+    snapshot->main_state = (uint8_t)m_mainState;
+    m_motor.getStateCodes(&snapshot->motor_state, &snapshot->homing_phase);
+    snapshot->rx_depth = (uint16_t)m_comms.getRxQueueCount();
+    for (uint8_t lane = 0; lane < TX_LANE_COUNT; lane++) {
+        snapshot->tx_depth[lane] = (uint16_t)m_comms.getTxQueueCount(static_cast<TxLane>(lane));
+    }
+    if (frame != NULL) {
+        // Stacked frame: r0, r1, r2, r3, r12, lr, pc, xpsr
+        snapshot->lr = frame[5];
+        snapshot->pc = frame[6];
+        snapshot->cfsr = SCB->CFSR;
+        snapshot->hfsr = SCB->HFSR;
+    }
+    g_crashSnapshot.commit();
+}
+
+/**
+ * @brief Gets the name of the scheduler task recorded in a snapshot.
+ * @details Tasks register in the same order every boot, so the index still names the same task.
+ */
+static const char* crashTaskName(const CrashSnapshot& snapshot) {
+    if (snapshot.running_task < g_loopScheduler.getTaskCount()) {
+        return g_loopScheduler.getTask(snapshot.running_task).name;
+    }
+    return "none";
+}
+
+/**
+ * @details One or two lines to the host and the error log; dump_crash has the rest.
+ */
+void Pressboi::reportCrashSnapshot() {
+    if (!g_crashSnapshot.hasSaved()) {
+        return;
+    }
+    const CrashSnapshot& snapshot = g_crashSnapshot.getSaved();
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "Crash snapshot: %s in %s at %lu ms, task %s running %lu us, state %u, motor %u/%u, rx %u, tx %u/%u/%u. Send dump_crash for details.",
+             CrashSnapshotStore::causeName(snapshot.cause), breadcrumbName(snapshot.breadcrumb),
+             (unsigned long)snapshot.uptime_ms, crashTaskName(snapshot), (unsigned long)snapshot.running_us,
+             snapshot.main_state, snapshot.motor_state, snapshot.homing_phase, snapshot.rx_depth,
+             snapshot.tx_depth[TX_LANE_CONTROL], snapshot.tx_depth[TX_LANE_TELEMETRY], snapshot.tx_depth[TX_LANE_BULK]);
+    m_comms.reportEvent(STATUS_PREFIX_INFO, msg);
+    ERROR_LOG(LOG_ERROR, msg);
+    if (snapshot.cause == CRASH_CAUSE_HARDFAULT) {
+        snprintf(msg, sizeof(msg), "HardFault: pc=0x%08lX lr=0x%08lX cfsr=0x%08lX hfsr=0x%08lX",
+                 (unsigned long)snapshot.pc, (unsigned long)snapshot.lr,
+                 (unsigned long)snapshot.cfsr, (unsigned long)snapshot.hfsr);
+        m_comms.reportEvent(STATUS_PREFIX_INFO, msg);
+        ERROR_LOG(LOG_ERROR, msg);
+    }
+}
+
+/**
+ * @details Lines: header, cause, task and states, queue depths, fault registers, one line
+ * per loop stage, the snapshot's trace records as TRACE DATA lines, end marker.
+ */
+bool Pressboi::formatCrashDumpLine(uint16_t line, char* buffer, size_t size) {
+    if (!g_crashSnapshot.hasSaved()) {
+        if (line == 0) {
+            snprintf(buffer, size, "=== CRASH SNAPSHOT: none ===");
+            return true;
+        }
+        return false;
+    }
+    const CrashSnapshot& snapshot = g_crashSnapshot.getSaved();
+    const uint16_t stageFirst = 5;
+    const uint16_t traceFirst = stageFirst + LOOP_STAGE_COUNT;
+    const uint16_t traceLines = (snapshot.trace_count + TRACE_LOG_RECORDS_PER_LINE - 1) / TRACE_LOG_RECORDS_PER_LINE;
+
+    switch (line) {
+        case 0:
+            snprintf(buffer, size, "=== CRASH SNAPSHOT: %s ===", CrashSnapshotStore::causeName(snapshot.cause));
+            return true;
+        case 1:
+            snprintf(buffer, size, "breadcrumb=%s uptime=%lu ms", breadcrumbName(snapshot.breadcrumb),
+                     (unsigned long)snapshot.uptime_ms);
+            return true;
+        case 2:
+            snprintf(buffer, size, "task=%s running=%lu us main_state=%u motor_state=%u homing_phase=%u",
+                     crashTaskName(snapshot), (unsigned long)snapshot.running_us,
+                     snapshot.main_state, snapshot.motor_state, snapshot.homing_phase);
+            return true;
+        case 3:
+            snprintf(buffer, size, "queues: rx=%u tx_control=%u tx_telemetry=%u tx_bulk=%u", snapshot.rx_depth,
+                     snapshot.tx_depth[TX_LANE_CONTROL], snapshot.tx_depth[TX_LANE_TELEMETRY], snapshot.tx_depth[TX_LANE_BULK]);
+            return true;
+        case 4:
+            snprintf(buffer, size, "fault: pc=0x%08lX lr=0x%08lX cfsr=0x%08lX hfsr=0x%08lX",
+                     (unsigned long)snapshot.pc, (unsigned long)snapshot.lr,
+                     (unsigned long)snapshot.cfsr, (unsigned long)snapshot.hfsr);
+            return true;
+        default:
+            break;
+    }
+    if (line < traceFirst) {
+        uint8_t stage = (uint8_t)(line - stageFirst);
+        snprintf(buffer, size, "%s: mean=%lu max=%lu us", LoopProfiler::stageName(static_cast<LoopStage>(stage)),
+                 (unsigned long)snapshot.stage_mean_us[stage], (unsigned long)snapshot.stage_max_us[stage]);
+        return true;
+    }
+    if (line < traceFirst + traceLines) {
+        // Same TRACE DATA format as dump_trace, so the same host decoder reads it
+        uint16_t first = (uint16_t)(line - traceFirst) * TRACE_LOG_RECORDS_PER_LINE;
+        uint16_t n = snapshot.trace_count - first;
+        if (n > TRACE_LOG_RECORDS_PER_LINE) {
+            n = TRACE_LOG_RECORDS_PER_LINE;
+        }
+        int len = snprintf(buffer, size, "TRACE:pressboi:DATA:%lu:", (unsigned long)(snapshot.trace_first_seq + first));
+        if (len < 0 || (size_t)len + (n * sizeof(TraceRecord) + 2) / 3 * 4 >= size) {
+            return false;
+        }
+        base64Encode(reinterpret_cast<const uint8_t*>(snapshot.trace + first), n * sizeof(TraceRecord), buffer + len);
+        return true;
+    }
+    if (line == traceFirst + traceLines) {
+        snprintf(buffer, size, "=== END CRASH SNAPSHOT ===");
+        return true;
+    }
+    return false;
+}
+#endif
+
 //==================================================================================================
 // --- Program Entry Point ---
 //==================================================================================================
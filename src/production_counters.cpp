@@ -0,0 +1,101 @@
+/**
+ * @file production_counters.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the lifetime production counters kept across reboots.
+ */
+
+#include "production_counters.h"
+#include <string.h>
+
+// Global production counters instance
+ProductionCounters g_productionCounters;
+
+ProductionCounters::ProductionCounters() {
+    m_cycles = 0;
+    m_travelMm = 0;
+    m_travelFractionMm = 0.0f;
+    m_energyJ = 0;
+    m_energyFractionJ = 0.0f;
+    m_trips = 0;
+    memset(m_peakHist, 0, sizeof(m_peakHist));
+    m_checkpointCycles = 0;
+}
+
+void ProductionCounters::load() {
+#if NVM_JOURNAL_ENABLED
+    g_nvmJournal.get(NVM_JOURNAL_KEY_PROD_CYCLES, &m_cycles);
+    g_nvmJournal.get(NVM_JOURNAL_KEY_PROD_TRAVEL, &m_travelMm);
+    g_nvmJournal.get(NVM_JOURNAL_KEY_PROD_ENERGY, &m_energyJ);
+    g_nvmJournal.get(NVM_JOURNAL_KEY_PROD_TRIPS, &m_trips);
+    for (uint8_t i = 0; i < PRODUCTION_PEAK_BUCKETS; i++) {
+        g_nvmJournal.get(static_cast<NvmJournalKey>(NVM_JOURNAL_KEY_PROD_PEAK_HIST + i), &m_peakHist[i]);
+    }
+#endif
+    m_checkpointCycles = m_cycles;
+}
+
+void ProductionCounters::addCycle(float energy_j, float peak_kg, bool has_peak) {
+    m_cycles++;
+    if (energy_j > 0.0f) {
+        m_energyFractionJ += energy_j;
+        uint32_t whole = (uint32_t)m_energyFractionJ;
+        m_energyJ += whole;
+        m_energyFractionJ -= (float)whole;
+    }
+    if (has_peak) {
+        int bucket = (peak_kg > 0.0f) ? (int)(peak_kg / PRODUCTION_PEAK_BUCKET_KG) : 0;
+        if (bucket >= PRODUCTION_PEAK_BUCKETS) {
+            bucket = PRODUCTION_PEAK_BUCKETS - 1;
+        }
+        m_peakHist[bucket]++;
+    }
+    if (m_cycles - m_checkpointCycles >= PRODUCTION_CHECKPOINT_CYCLES) {
+        checkpoint();
+    }
+}
+
+void ProductionCounters::addTravel(float distance_mm) {
+    if (distance_mm <= 0.0f) {
+        return;
+    }
+    m_travelFractionMm += distance_mm;
+    uint32_t whole = (uint32_t)m_travelFractionMm;
+    m_travelMm += whole;
+    m_travelFractionMm -= (float)whole;
+}
+
+/**
+ * @details put() skips values the journal already holds, so only counters that moved
+ * since the last checkpoint cost a record.
+ */
+void ProductionCounters::checkpoint() {
+    put(NVM_JOURNAL_KEY_PROD_CYCLES, m_cycles);
+    put(NVM_JOURNAL_KEY_PROD_TRAVEL, m_travelMm);
+    put(NVM_JOURNAL_KEY_PROD_ENERGY, m_energyJ);
+    put(NVM_JOURNAL_KEY_PROD_TRIPS, m_trips);
+    for (uint8_t i = 0; i < PRODUCTION_PEAK_BUCKETS; i++) {
+        put(static_cast<NvmJournalKey>(NVM_JOURNAL_KEY_PROD_PEAK_HIST + i), m_peakHist[i]);
+    }
+    m_checkpointCycles = m_cycles;
+}
+
+void ProductionCounters::reset() {
+    m_cycles = 0;
+    m_travelMm = 0;
+    m_travelFractionMm = 0.0f;
+    m_energyJ = 0;
+    m_energyFractionJ = 0.0f;
+    m_trips = 0;
+    memset(m_peakHist, 0, sizeof(m_peakHist));
+    checkpoint();
+}
+
+void ProductionCounters::put(NvmJournalKey key, uint32_t value) {
+#if NVM_JOURNAL_ENABLED
+    g_nvmJournal.put(key, value);
+#else
+    (void)key;
+    (void)value;
+#endif
+}
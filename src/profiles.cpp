@@ -0,0 +1,189 @@
+/**
+ * @file profiles.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the named calibration profiles kept in main flash.
+ */
+
+#include "profiles.h"
+#include "error_log.h"
+#include "main_flash.h"
+#include <string.h>
+
+#define PROFILE_IMAGE_WORDS     (sizeof(ProfileStore::Image) / 4)
+#define PROFILE_IMAGE_PAGES     ((PROFILE_IMAGE_WORDS + MAIN_FLASH_PAGE_WORDS - 1) / MAIN_FLASH_PAGE_WORDS)
+
+static_assert((PROFILE_FLASH_ADDR % 8192) == 0, "Profiles must start on an erase block");
+static_assert(PROFILE_FLASH_ADDR + 8192 <= NVM_JOURNAL_ADDR, "Profiles overlap the NVM journal");
+
+// Global profile store instance
+ProfileStore g_profileStore;
+
+ProfileStore::ProfileStore() {
+    memset(&m_image, 0, sizeof(m_image));
+    m_dirty = false;
+    m_state = PROFILE_STATE_IDLE;
+    m_page = 0;
+}
+
+void ProfileStore::load() {
+    static_assert(sizeof(Image) % 4 == 0, "Profile image must be whole words");
+    static_assert(sizeof(Image) <= 8192, "Profile image must fit one erase block");
+    static_assert(PROFILE_IMAGE_WORDS % MAIN_FLASH_PAGE_WORDS != MAIN_FLASH_QUAD_WORDS, "Last page would be written as a quad-word");
+    const Image* stored = reinterpret_cast<const Image*>(PROFILE_FLASH_ADDR);
+    if (stored->magic == PROFILE_MAGIC &&
+        stored->crc == SettingsStore::crc32(reinterpret_cast<const uint8_t*>(stored->profiles), sizeof(stored->profiles))) {
+        memcpy(&m_image, stored, sizeof(m_image));
+        // Names came from flash; never trust the terminator
+        for (uint8_t i = 0; i < PROFILE_MAX_COUNT; i++) {
+            m_image.profiles[i].name[PROFILE_NAME_LENGTH - 1] = '\0';
+        }
+        return;
+    }
+    memset(&m_image, 0, sizeof(m_image));
+    if (stored->magic != 0xFFFFFFFF) {
+        ERROR_LOGF(LOG_WARNING, "Calibration profile image invalid (magic 0x%08lX); starting empty",
+                   (unsigned long)stored->magic);
+    }
+}
+
+int8_t ProfileStore::save(const char* name, const PressSettings& settings) {
+    size_t length = strlen(name);
+    if (length == 0 || length >= PROFILE_NAME_LENGTH) {
+        return -1;
+    }
+    int8_t slot = find(name);
+    for (uint8_t i = 0; i < PROFILE_MAX_COUNT && slot < 0; i++) {
+        if (m_image.profiles[i].name[0] == '\0') {
+            slot = (int8_t)i;
+        }
+    }
+    if (slot < 0) {
+        return -1;
+    }
+
+    CalibrationProfile& profile = m_image.profiles[slot];
+    memset(&profile, 0, sizeof(profile));
+    memcpy(profile.name, name, length);
+    memcpy(profile.strain_coeffs, settings.strain_coeffs, sizeof(profile.strain_coeffs));
+    memcpy(profile.force_scale, settings.force_scale, sizeof(profile.force_scale));
+    memcpy(profile.force_offset_kg, settings.force_offset_kg, sizeof(profile.force_offset_kg));
+    profile.torque_scale = settings.torque_scale;
+    profile.torque_offset = settings.torque_offset;
+    profile.press_threshold_kg = settings.press_threshold_kg;
+    m_dirty = true;
+    return slot;
+}
+
+int8_t ProfileStore::remove(const char* name) {
+    int8_t slot = find(name);
+    if (slot >= 0) {
+        memset(&m_image.profiles[slot], 0, sizeof(CalibrationProfile));
+        m_dirty = true;
+    }
+    return slot;
+}
+
+int8_t ProfileStore::find(const char* name) const {
+    if (name[0] == '\0') {
+        return -1;
+    }
+    for (uint8_t i = 0; i < PROFILE_MAX_COUNT; i++) {
+        if (strncmp(m_image.profiles[i].name, name, PROFILE_NAME_LENGTH) == 0) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+const CalibrationProfile* ProfileStore::get(int8_t slot) const {
+    if (slot < 0 || slot >= PROFILE_MAX_COUNT || m_image.profiles[slot].name[0] == '\0') {
+        return nullptr;
+    }
+    return &m_image.profiles[slot];
+}
+
+uint8_t ProfileStore::getCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < PROFILE_MAX_COUNT; i++) {
+        if (m_image.profiles[i].name[0] != '\0') {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ProfileStore::clear() {
+    memset(m_image.profiles, 0, sizeof(m_image.profiles));
+    m_dirty = true;
+}
+
+/**
+ * @details Erase, then one page write per call. A change during the rewrite leaves the
+ * store dirty, so the block is rewritten again once this pass finishes.
+ */
+void ProfileStore::service() {
+    if (m_state == PROFILE_STATE_FAILED || !main_flash_ready()) {
+        return;
+    }
+    if (m_state != PROFILE_STATE_IDLE) {
+        uint16_t flags = main_flash_errors();
+        if (flags != 0) {
+            ERROR_LOGF(LOG_ERROR, "Calibration profiles: flash error 0x%04X in %s, page %u",
+                       (unsigned)flags, stateName(m_state), (unsigned)m_page);
+            m_state = PROFILE_STATE_FAILED;
+            return;
+        }
+    }
+
+    switch (m_state) {
+        case PROFILE_STATE_IDLE:
+            if (m_dirty) {
+                m_dirty = false;
+                m_image.magic = PROFILE_MAGIC;
+                m_image.crc = SettingsStore::crc32(reinterpret_cast<const uint8_t*>(m_image.profiles),
+                                                   sizeof(m_image.profiles));
+                main_flash_start_erase(PROFILE_FLASH_ADDR);
+                m_state = PROFILE_STATE_ERASING;
+                m_page = 0;
+            }
+            return;
+
+        case PROFILE_STATE_ERASING:
+        case PROFILE_STATE_WRITING: {
+            if (m_state == PROFILE_STATE_WRITING) {
+                m_page++;
+            }
+            if (m_page >= PROFILE_IMAGE_PAGES) {
+                m_state = PROFILE_STATE_IDLE;
+                return;
+            }
+            uint32_t first = (uint32_t)m_page * MAIN_FLASH_PAGE_WORDS;
+            uint32_t count = PROFILE_IMAGE_WORDS - first;
+            if (count > MAIN_FLASH_PAGE_WORDS) {
+                count = MAIN_FLASH_PAGE_WORDS;
+            }
+            main_flash_start_write(PROFILE_FLASH_ADDR + first * 4,
+                                   reinterpret_cast<const uint32_t*>(&m_image) + first, (uint16_t)count);
+            m_state = PROFILE_STATE_WRITING;
+            return;
+        }
+
+        default:
+            return;
+    }
+}
+
+bool ProfileStore::isIdle() const {
+    return (m_state == PROFILE_STATE_IDLE && !m_dirty) || m_state == PROFILE_STATE_FAILED;
+}
+
+const char* ProfileStore::stateName(uint8_t state) {
+    switch (state) {
+        case PROFILE_STATE_IDLE:    return "idle";
+        case PROFILE_STATE_ERASING: return "erasing";
+        case PROFILE_STATE_WRITING: return "writing";
+        case PROFILE_STATE_FAILED:  return "failed";
+        default:                    return "unknown";
+    }
+}
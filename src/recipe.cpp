@@ -0,0 +1,253 @@
+/**
+ * @file recipe.cpp
+ * @author Eldin Miller-Stead
+ * @date November 4, 2025
+ * @brief Implements the on-device press recipe store.
+ */
+
+#include "recipe.h"
+#include "NvmManager.h"
+#include <string.h>
+#include <math.h>
+
+using namespace ClearCore;
+
+static_assert(sizeof(RecipeNvmStep) == 12, "Recipe step must pack to 12 bytes");
+static_assert(NVM_SLOT_RECIPE * 4 + sizeof(RecipeNvmImage) <= NVM_SLOT_FORCE_TABLE_COUNT * 4,
+              "Recipe area overlaps the force table");
+static_assert(RECIPE_MAX_STEPS <= MOTION_QUEUE_SIZE, "A recipe must fit in the motion queue");
+
+// Global recipe store instance
+RecipeStore g_recipeStore;
+
+RecipeStore::RecipeStore() {
+    m_name[0] = '\0';
+    memset(m_steps, 0, sizeof(m_steps));
+    m_step_count = 0;
+    m_learn_margin_mm = 0.0f;
+    m_learn_rapid_mms = ADAPTIVE_APPROACH_RAPID_MMS_DEFAULT;
+    clearContacts();
+    clearEnvelope();
+    clearZones();
+    memset(&m_nvmImage, 0, sizeof(m_nvmImage));
+    m_nvmPending = false;
+}
+
+void RecipeStore::load() {
+    RecipeNvmImage image;
+    NvmManager::Instance().BlockRead(static_cast<NvmManager::NvmLocations>(NVM_SLOT_RECIPE * 4),
+                                     sizeof(image), reinterpret_cast<uint8_t*>(&image));
+
+    m_name[0] = '\0';
+    m_step_count = 0;
+    m_learn_margin_mm = 0.0f;
+    m_learn_rapid_mms = ADAPTIVE_APPROACH_RAPID_MMS_DEFAULT;
+    clearContacts();
+    clearEnvelope();
+    clearZones();
+    uint8_t count = (uint8_t)(image.header & 0xFF);
+    if ((image.header & RECIPE_NVM_MAGIC_MASK) != RECIPE_NVM_MAGIC || count > RECIPE_MAX_STEPS) {
+        return;
+    }
+
+    memcpy(m_name, image.name, RECIPE_NAME_LENGTH);
+    m_name[RECIPE_NAME_LENGTH - 1] = '\0';
+    for (uint8_t i = 0; i < count; i++) {
+        const RecipeNvmStep& packed = image.steps[i];
+        MotionSegment& step = m_steps[i];
+        memset(&step, 0, sizeof(step));
+        step.type = packed.type;
+        if (packed.type == SEGMENT_DWELL) {
+            step.dwell_ms = (uint32_t)packed.value;
+        } else {
+            memcpy(&step.position_mm, &packed.value, sizeof(float));
+            step.dwell_ms = packed.dwell_ms;
+        }
+        step.speed_mms = packed.speed_centi / 100.0f;
+        step.force_kg = packed.force_deci / 10.0f;
+        step.force_action = (packed.action < FORCE_ACTION_NONE) ? static_cast<ForceAction>(packed.action)
+                                                                : FORCE_ACTION_HOLD;
+    }
+    m_step_count = count;
+    // Erased flash (-1) or an image saved before these fields existed leaves learning off
+    if (image.learn_margin_centi > 0 && image.learn_rapid_centi > 0) {
+        m_learn_margin_mm = image.learn_margin_centi / 100.0f;
+        m_learn_rapid_mms = image.learn_rapid_centi / 100.0f;
+    }
+}
+
+bool RecipeStore::save() {
+    if (m_name[0] == '\0') {
+        return false;
+    }
+
+    // Staged in the image commit() writes from the idle flash job, so later edits to the
+    // RAM recipe do not change what was saved
+    RecipeNvmImage& image = m_nvmImage;
+    memset(&image, 0, sizeof(image));
+    image.header = RECIPE_NVM_MAGIC | m_step_count;
+    memcpy(image.name, m_name, RECIPE_NAME_LENGTH);
+    image.learn_margin_centi = (int16_t)(m_learn_margin_mm * 100.0f + 0.5f);
+    image.learn_rapid_centi = (int16_t)(m_learn_rapid_mms * 100.0f + 0.5f);
+    for (uint8_t i = 0; i < m_step_count; i++) {
+        const MotionSegment& step = m_steps[i];
+        RecipeNvmStep& packed = image.steps[i];
+        packed.type = step.type;
+        if (step.type == SEGMENT_DWELL) {
+            packed.value = (int32_t)step.dwell_ms;
+        } else {
+            memcpy(&packed.value, &step.position_mm, sizeof(float));
+            packed.dwell_ms = (uint16_t)((step.dwell_ms > 0xFFFF) ? 0xFFFF : step.dwell_ms);
+        }
+        packed.speed_centi = (int16_t)(step.speed_mms * 100.0f + 0.5f);
+        packed.force_deci = (int16_t)(step.force_kg * 10.0f + 0.5f);
+        packed.action = step.force_action;
+    }
+
+    m_nvmPending = true;
+    return true;
+}
+
+bool RecipeStore::commit() {
+    if (!m_nvmPending) {
+        return true;
+    }
+    if (!NvmManager::Instance().BlockWrite(static_cast<NvmManager::NvmLocations>(NVM_SLOT_RECIPE * 4),
+                                           sizeof(m_nvmImage), reinterpret_cast<const uint8_t*>(&m_nvmImage))) {
+        return false;
+    }
+    m_nvmPending = false;
+    return true;
+}
+
+void RecipeStore::erase() {
+    m_nvmPending = false;
+    NvmManager::Instance().Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_RECIPE * 4), -1);
+}
+
+bool RecipeStore::begin(const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len >= RECIPE_NAME_LENGTH) {
+        return false;
+    }
+    strcpy(m_name, name);
+    m_step_count = 0;
+    m_learn_margin_mm = 0.0f;
+    m_learn_rapid_mms = ADAPTIVE_APPROACH_RAPID_MMS_DEFAULT;
+    clearContacts();
+    clearEnvelope();
+    clearZones();
+    return true;
+}
+
+bool RecipeStore::addStep(const MotionSegment& step) {
+    if (m_name[0] == '\0' || m_step_count >= RECIPE_MAX_STEPS) {
+        return false;
+    }
+    m_steps[m_step_count++] = step;
+    return true;
+}
+
+bool RecipeStore::matches(const char* name) const {
+    return m_name[0] != '\0' && strcmp(m_name, name) == 0;
+}
+
+bool RecipeStore::setLearning(float margin_mm, float rapid_mms) {
+    if (m_name[0] == '\0') {
+        return false;
+    }
+    m_learn_margin_mm = margin_mm;
+    m_learn_rapid_mms = rapid_mms;
+    return true;
+}
+
+bool RecipeStore::getContactEstimate(uint8_t step, float* position_mm) const {
+    if (step >= RECIPE_MAX_STEPS || !m_contact_valid[step]) {
+        return false;
+    }
+    *position_mm = m_contact_mm[step];
+    return true;
+}
+
+float RecipeStore::recordContact(uint8_t step, float position_mm, int direction) {
+    if (step >= RECIPE_MAX_STEPS) {
+        return position_mm;
+    }
+    float& estimate = m_contact_mm[step];
+    if (!m_contact_valid[step] || (position_mm - estimate) * direction < 0.0f) {
+        estimate = position_mm;
+        m_contact_valid[step] = true;
+    } else {
+        estimate += ADAPTIVE_APPROACH_ALPHA * (position_mm - estimate);
+    }
+    return estimate;
+}
+
+bool RecipeStore::beginEnvelope(float start_mm, float step_mm) {
+    if (m_name[0] == '\0' || !(step_mm >= RECIPE_ENVELOPE_STEP_MIN_MM)) {
+        return false;
+    }
+    m_envelope_start_mm = start_mm;
+    m_envelope_step_mm = step_mm;
+    m_envelope_count = 0;
+    return true;
+}
+
+bool RecipeStore::addEnvelopeBand(float lower_kg, float upper_kg) {
+    if (m_envelope_step_mm <= 0.0f || m_envelope_count >= RECIPE_ENVELOPE_MAX_BANDS || !(lower_kg <= upper_kg)) {
+        return false;
+    }
+    m_envelope_lower_kg[m_envelope_count] = lower_kg;
+    m_envelope_upper_kg[m_envelope_count] = upper_kg;
+    m_envelope_count++;
+    return true;
+}
+
+void RecipeStore::clearEnvelope() {
+    m_envelope_start_mm = 0.0f;
+    m_envelope_step_mm = 0.0f;
+    m_envelope_count = 0;
+}
+
+/**
+ * @details One multiply and a bounds check, so it can run on every sample of a press.
+ */
+bool RecipeStore::getEnvelopeBand(float position_mm, float* lower_kg, float* upper_kg) const {
+    if (m_envelope_count == 0) {
+        return false;
+    }
+    float bin = floorf((position_mm - m_envelope_start_mm) / m_envelope_step_mm + 0.5f);
+    if (bin < 0.0f || bin >= (float)m_envelope_count) {
+        return false;
+    }
+    *lower_kg = m_envelope_lower_kg[(int)bin];
+    *upper_kg = m_envelope_upper_kg[(int)bin];
+    return true;
+}
+
+bool RecipeStore::addZone(const RecipeZone& zone) {
+    if (m_name[0] == '\0' || m_zone_count >= RECIPE_ZONE_MAX || !(zone.start_mm < zone.end_mm) ||
+        !(zone.speed_mms >= 0.0f && zone.speed_mms <= MOVE_SPEED_MAX_MMS) ||
+        !(zone.torque_pct >= 0.0f && zone.torque_pct <= 100.0f) || !(zone.force_kg >= 0.0f)) {
+        return false;
+    }
+    uint8_t slot = 0;
+    while (slot < m_zone_count && m_zones[slot].start_mm < zone.start_mm) {
+        slot++;
+    }
+    if ((slot > 0 && m_zones[slot - 1].end_mm > zone.start_mm) ||
+        (slot < m_zone_count && m_zones[slot].start_mm < zone.end_mm)) {
+        return false;
+    }
+    for (uint8_t i = m_zone_count; i > slot; i--) {
+        m_zones[i] = m_zones[i - 1];
+    }
+    m_zones[slot] = zone;
+    m_zone_count++;
+    return true;
+}
+
+void RecipeStore::clearContacts() {
+    memset(m_contact_mm, 0, sizeof(m_contact_mm));
+    memset(m_contact_valid, 0, sizeof(m_contact_valid));
+}
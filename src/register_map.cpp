@@ -0,0 +1,124 @@
+/**
+ * @file register_map.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the PLC register map on REGISTER_MAP_PORT.
+ */
+
+#include "register_map.h"
+
+#if REGISTER_MAP_ENABLED
+
+#include "ClearCore.h"
+#include "lwip/pbuf.h"
+#include <string.h>
+
+static_assert(sizeof(RegisterImage) == 64, "RegisterImage layout is fixed by REGISTER_MAP_VERSION");
+static_assert(sizeof(RegisterRequest) == REGISTER_REQUEST_HEADER_BYTES + REGISTER_MAP_FRAME_BYTES,
+              "RegisterRequest must not be padded");
+
+// Global register map instance
+RegisterMap g_registerMap;
+
+RegisterMap::RegisterMap() {
+    m_pcb = nullptr;
+    m_txRef = nullptr;
+    memset(&m_image, 0, sizeof(m_image));
+    m_image.magic = REGISTER_MAP_MAGIC;
+    m_image.version = REGISTER_MAP_VERSION;
+    memset(&m_request, 0, sizeof(m_request));
+    m_frameLength = 0;
+    m_framePort = 0;
+    m_polls = 0;
+    m_dropped = 0;
+}
+
+bool RegisterMap::open() {
+    if (m_pcb != nullptr) {
+        return true;
+    }
+    struct udp_pcb* pcb = udp_new();
+    if (pcb == nullptr) {
+        return false;
+    }
+    if (udp_bind(pcb, IP_ADDR_ANY, REGISTER_MAP_PORT) != ERR_OK) {
+        udp_remove(pcb);
+        return false;
+    }
+    m_txRef = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+    if (m_txRef == nullptr) {
+        udp_remove(pcb);
+        return false;
+    }
+    udp_recv(pcb, &RegisterMap::receive, this);
+    m_pcb = pcb;
+    return true;
+}
+
+/**
+ * @details Runs inside EthernetMgr.Refresh() on the main loop, so the image is never
+ * half-written while it is copied. The reply goes back to the sender from the same pcb;
+ * the ethernet driver copies the PBUF_REF payload before udp_sendto() returns.
+ */
+void RegisterMap::receive(void* arg, struct udp_pcb* pcb, struct pbuf* p, const ip_addr_t* addr, u16_t port) {
+    RegisterMap* self = static_cast<RegisterMap*>(arg);
+    u16_t length = pbuf_copy_partial(p, &self->m_request, sizeof(self->m_request), 0);
+    pbuf_free(p);
+    if (length < REGISTER_REQUEST_HEADER_BYTES || self->m_request.magic != REGISTER_MAP_MAGIC) {
+        self->m_dropped++;
+        return;
+    }
+
+    IpAddress ip(ip4_addr_get_u32(ip_2_ip4(addr)));
+    // A frame longer than the datagram brought is as bad as one too long for the mailbox
+    if (self->m_request.frame_length > length - REGISTER_REQUEST_HEADER_BYTES) {
+        self->m_request.frame_length = 0xFF;
+    }
+    self->accept(self->m_request, ip, port);
+
+    self->m_image.seq++;
+    self->m_txRef->payload = &self->m_image;
+    self->m_txRef->len = self->m_txRef->tot_len = sizeof(self->m_image);
+    udp_sendto(pcb, self->m_txRef, addr, port);
+    self->m_polls++;
+}
+
+void RegisterMap::accept(const RegisterRequest& request, const IpAddress& ip, uint16_t port) {
+    if (request.frame_length == 0 || request.mailbox_seq == 0 || request.mailbox_seq == m_image.mailbox_seq) {
+        return;
+    }
+    m_image.mailbox_seq = request.mailbox_seq;
+    if (request.frame_length > REGISTER_MAP_FRAME_BYTES) {
+        m_image.mailbox_status = REGISTER_RESULT_REJECTED;
+        m_image.mailbox_command = 0;
+        return;
+    }
+    // One poll per pass at most reaches here before takeCommand(); a later one replaces it
+    memcpy(m_frame, request.frame, request.frame_length);
+    m_frameLength = request.frame_length;
+    m_frameIp = ip;
+    m_framePort = port;
+    m_image.mailbox_status = REGISTER_RESULT_QUEUED;
+    m_image.mailbox_command = request.frame[0];
+}
+
+bool RegisterMap::takeCommand(uint16_t* seq, uint8_t* frame, uint8_t* length, IpAddress* ip, uint16_t* port) {
+    if (m_frameLength == 0) {
+        return false;
+    }
+    *seq = m_image.mailbox_seq;
+    memcpy(frame, m_frame, m_frameLength);
+    *length = m_frameLength;
+    *ip = m_frameIp;
+    *port = m_framePort;
+    m_frameLength = 0;
+    return true;
+}
+
+void RegisterMap::finishCommand(uint16_t seq, uint8_t status) {
+    if (seq == m_image.mailbox_seq && m_image.mailbox_status == REGISTER_RESULT_QUEUED) {
+        m_image.mailbox_status = status;
+    }
+}
+
+#endif // REGISTER_MAP_ENABLED
@@ -0,0 +1,488 @@
+/**
+ * @file sd_log.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the micro SD card sink for the error and heartbeat logs.
+ */
+
+#include "sd_log.h"
+#include "error_log.h"
+#include "ClearCore.h"
+#include <string.h>
+
+static_assert(sizeof(SdLogBlockHeader) == 16, "SD log block header must pack to 16 bytes");
+
+// Text bytes per block after the header
+static const uint16_t SD_LOG_TEXT_BYTES = SD_LOG_BLOCK_SIZE - sizeof(SdLogBlockHeader);
+
+// SD SPI-mode tokens and responses
+static const uint8_t SD_R1_IDLE = 0x01;
+static const uint8_t SD_R1_ILLEGAL_COMMAND = 0x04;
+static const uint8_t SD_TOKEN_START_BLOCK = 0xFE;
+static const uint8_t SD_DATA_ACCEPTED = 0x05;
+
+/**
+ * @enum SdLogTransfer
+ * @brief Phase of the block transfer in progress.
+ */
+enum SdLogTransfer : uint8_t {
+    SD_XFER_NONE = 0,       ///< No transfer
+    SD_XFER_READ_TOKEN,     ///< Waiting for the start token of a CMD17 read
+    SD_XFER_READ_DATA,      ///< Clocking in the block and its CRC
+    SD_XFER_WRITE_DATA,     ///< Clocking out the block and its CRC
+    SD_XFER_WRITE_BUSY      ///< Card programming the block (holds MISO low)
+};
+
+// Global SD log instance
+SdLog g_sdLog;
+
+SdLog::SdLog() {
+    memset(m_fill, 0, sizeof(m_fill));
+    memset(m_io, 0, sizeof(m_io));
+    m_fill_used = 0;
+    m_fill_dirty = false;
+    m_fill_placed = false;
+    m_flush_requested = false;
+    m_write_pending = false;
+    m_fill_block = 0;
+    m_fill_seq = 0;
+    m_write_block = 0;
+    m_next_block = 0;
+    m_next_seq = 0;
+    m_boot_seq = 0;
+    m_last_flush_ms = 0;
+    m_state = SD_LOG_STATE_IDLE;
+    m_xfer = SD_XFER_NONE;
+    m_attempts = 0;
+    m_block_addressing = false;
+    m_v2_card = false;
+    m_failure_reported = false;
+    m_state_start_ms = 0;
+    m_xfer_start_ms = 0;
+    m_xfer_pos = 0;
+    m_scan_block = 0;
+    m_scan_lo = 0;
+    m_scan_hi = 0;
+    m_scan_base_seq = 0;
+    m_blocks_written = 0;
+    m_dropped_lines = 0;
+    m_errors = 0;
+}
+
+void SdLog::setup() {
+#if SD_LOG_ENABLED
+    m_state = SD_LOG_STATE_POWER_UP;
+    m_state_start_ms = Milliseconds();
+#endif
+}
+
+void SdLog::append(const char* text, size_t length, bool urgent) {
+#if SD_LOG_ENABLED
+    if (length > SD_LOG_TEXT_BYTES - 1) {
+        length = SD_LOG_TEXT_BYTES - 1;
+    }
+    if (m_fill_used + length + 1 > SD_LOG_TEXT_BYTES) {
+        // Close the full block if the write buffer is free; otherwise there is nowhere to put the line
+        if (m_state != SD_LOG_STATE_READY || m_write_pending) {
+            m_dropped_lines++;
+            return;
+        }
+        handOff(true);
+    }
+    uint8_t* text_area = m_fill + sizeof(SdLogBlockHeader);
+    memcpy(text_area + m_fill_used, text, length);
+    text_area[m_fill_used + length] = '\n';
+    m_fill_used += (uint16_t)(length + 1);
+    m_fill_dirty = true;
+    if (urgent) {
+        m_flush_requested = true;
+    }
+#else
+    (void)text;
+    (void)length;
+    (void)urgent;
+#endif
+}
+
+void SdLog::service(uint32_t budget_us) {
+#if SD_LOG_ENABLED
+    uint32_t start = Microseconds();
+    do {
+        if (!step()) {
+            break;
+        }
+    } while (Microseconds() - start < budget_us);
+#else
+    (void)budget_us;
+#endif
+}
+
+/**
+ * @details Runs one bounded piece of work (an init command, a slice of a block transfer,
+ * one busy poll).
+ * @return false when the card has to be waited for, so the rest of the pass is left alone
+ */
+bool SdLog::step() {
+    if (m_xfer != SD_XFER_NONE) {
+        return stepTransfer();
+    }
+    uint32_t now = Milliseconds();
+    switch (m_state) {
+        case SD_LOG_STATE_IDLE:
+            if (now - m_state_start_ms < SD_LOG_RETRY_MS) {
+                return false;
+            }
+            m_state = SD_LOG_STATE_POWER_UP;
+            m_state_start_ms = now;
+            return true;
+
+        case SD_LOG_STATE_POWER_UP:
+            // At least 74 clocks with CS high put the card into SPI mode
+            SdCard.Speed(SD_LOG_INIT_SPI_HZ);
+            deselect();
+            for (uint8_t i = 0; i < 10; i++) {
+                transfer(0xFF);
+            }
+            m_attempts = 0;
+            m_state = SD_LOG_STATE_RESET;
+            return true;
+
+        case SD_LOG_STATE_RESET: {
+            uint8_t r1 = command(0, 0);
+            deselect();
+            if (r1 == SD_R1_IDLE) {
+                m_state = SD_LOG_STATE_IF_COND;
+            } else if (++m_attempts >= SD_LOG_INIT_ATTEMPTS) {
+                fail("no card");
+            }
+            return true;
+        }
+
+        case SD_LOG_STATE_IF_COND: {
+            uint8_t r1 = command(8, 0x1AA);
+            if (r1 & SD_R1_ILLEGAL_COMMAND) {
+                m_v2_card = false;
+            } else {
+                uint8_t r7[4];
+                for (uint8_t i = 0; i < 4; i++) {
+                    r7[i] = transfer(0xFF);
+                }
+                if ((r7[2] & 0x0F) != 0x01 || r7[3] != 0xAA) {
+                    fail("CMD8 echo mismatch");
+                    return true;
+                }
+                m_v2_card = true;
+            }
+            deselect();
+            m_state = SD_LOG_STATE_ACTIVATE;
+            m_state_start_ms = now;
+            return true;
+        }
+
+        case SD_LOG_STATE_ACTIVATE: {
+            command(55, 0);
+            deselect();
+            uint8_t r1 = command(41, m_v2_card ? 0x40000000UL : 0);
+            deselect();
+            if (r1 == 0) {
+                m_state = SD_LOG_STATE_OCR;
+                return true;
+            }
+            if (r1 != SD_R1_IDLE || now - m_state_start_ms > SD_LOG_INIT_TIMEOUT_MS) {
+                fail("ACMD41 timeout");
+                return true;
+            }
+            // The card takes tens of ms to leave idle; ask again next pass
+            return false;
+        }
+
+        case SD_LOG_STATE_OCR: {
+            m_block_addressing = false;
+            if (m_v2_card) {
+                uint8_t r1 = command(58, 0);
+                uint8_t ocr[4];
+                for (uint8_t i = 0; i < 4; i++) {
+                    ocr[i] = transfer(0xFF);
+                }
+                deselect();
+                if (r1 != 0) {
+                    fail("CMD58 rejected");
+                    return true;
+                }
+                m_block_addressing = (ocr[0] & 0x40) != 0;
+            }
+            if (!m_block_addressing) {
+                // Byte-addressed cards: make sure the block length is 512
+                uint8_t r1 = command(16, SD_LOG_BLOCK_SIZE);
+                deselect();
+                if (r1 != 0) {
+                    fail("CMD16 rejected");
+                    return true;
+                }
+            }
+            SdCard.Speed(SD_LOG_SPI_HZ);
+            m_state = SD_LOG_STATE_SCAN;
+            m_state_start_ms = now;
+            m_scan_lo = 1;
+            m_scan_hi = SD_LOG_BLOCK_COUNT;
+            startRead(0);
+            return true;
+        }
+
+        case SD_LOG_STATE_SCAN:
+            // Reads are started from onScanRead()
+            return false;
+
+        case SD_LOG_STATE_READY:
+            if (!m_write_pending && m_fill_dirty &&
+                (m_flush_requested || now - m_last_flush_ms >= SD_LOG_FLUSH_MS)) {
+                handOff(false);
+            }
+            if (m_write_pending) {
+                startWrite();
+                return true;
+            }
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+bool SdLog::stepTransfer() {
+    uint32_t now = Milliseconds();
+    switch (m_xfer) {
+        case SD_XFER_READ_TOKEN: {
+            uint8_t token = transfer(0xFF);
+            if (token == SD_TOKEN_START_BLOCK) {
+                m_xfer = SD_XFER_READ_DATA;
+                m_xfer_pos = 0;
+            } else if (token != 0xFF) {
+                fail("read error token");
+            } else if (now - m_xfer_start_ms > SD_LOG_IO_TIMEOUT_MS) {
+                fail("read timeout");
+            }
+            return true;
+        }
+
+        case SD_XFER_READ_DATA: {
+            // The block plus its two CRC bytes, a slice at a time
+            uint16_t end = m_xfer_pos + SD_LOG_SLICE_BYTES;
+            if (end > SD_LOG_BLOCK_SIZE + 2) {
+                end = SD_LOG_BLOCK_SIZE + 2;
+            }
+            for (; m_xfer_pos < end; m_xfer_pos++) {
+                uint8_t b = transfer(0xFF);
+                if (m_xfer_pos < SD_LOG_BLOCK_SIZE) {
+                    m_io[m_xfer_pos] = b;
+                }
+            }
+            if (m_xfer_pos == SD_LOG_BLOCK_SIZE + 2) {
+                deselect();
+                m_xfer = SD_XFER_NONE;
+                onScanRead();
+            }
+            return true;
+        }
+
+        case SD_XFER_WRITE_DATA: {
+            uint16_t end = m_xfer_pos + SD_LOG_SLICE_BYTES;
+            if (end > SD_LOG_BLOCK_SIZE) {
+                end = SD_LOG_BLOCK_SIZE;
+            }
+            for (; m_xfer_pos < end; m_xfer_pos++) {
+                transfer(m_io[m_xfer_pos]);
+            }
+            if (m_xfer_pos < SD_LOG_BLOCK_SIZE) {
+                return true;
+            }
+            // CRC is ignored in SPI mode
+            transfer(0xFF);
+            transfer(0xFF);
+            if ((transfer(0xFF) & 0x1F) != SD_DATA_ACCEPTED) {
+                fail("write rejected");
+                return true;
+            }
+            m_xfer = SD_XFER_WRITE_BUSY;
+            m_xfer_start_ms = now;
+            return true;
+        }
+
+        case SD_XFER_WRITE_BUSY:
+            if (transfer(0xFF) != 0xFF) {
+                if (now - m_xfer_start_ms > SD_LOG_IO_TIMEOUT_MS) {
+                    fail("write timeout");
+                    return true;
+                }
+                // Programming takes a few ms; poll again next pass
+                return false;
+            }
+            deselect();
+            m_xfer = SD_XFER_NONE;
+            m_write_pending = false;
+            m_blocks_written++;
+            return true;
+
+        default:
+            m_xfer = SD_XFER_NONE;
+            return true;
+    }
+}
+
+/**
+ * @details Gives m_fill a block and sequence number the first time it goes out, copies it
+ * into m_io and queues the write. A block that is not closed stays in m_fill and is
+ * written again, to the same block, once more lines arrive.
+ */
+void SdLog::handOff(bool close_block) {
+    if (!m_fill_placed) {
+        m_fill_block = m_next_block;
+        m_fill_seq = m_next_seq;
+        m_next_block = (m_next_block + 1) % SD_LOG_BLOCK_COUNT;
+        m_next_seq++;
+        m_fill_placed = true;
+    }
+    SdLogBlockHeader header;
+    header.magic = SD_LOG_MAGIC;
+    header.seq = m_fill_seq;
+    header.boot_seq = m_boot_seq;
+    header.used = m_fill_used;
+    header.reserved = 0;
+    memcpy(m_io, &header, sizeof(header));
+    memcpy(m_io + sizeof(header), m_fill + sizeof(header), m_fill_used);
+    memset(m_io + sizeof(header) + m_fill_used, 0, SD_LOG_TEXT_BYTES - m_fill_used);
+    m_write_block = m_fill_block;
+    m_write_pending = true;
+    m_fill_dirty = false;
+    m_flush_requested = false;
+    m_last_flush_ms = Milliseconds();
+    if (close_block) {
+        m_fill_used = 0;
+        m_fill_placed = false;
+    }
+}
+
+void SdLog::startRead(uint32_t block) {
+    m_scan_block = block;
+    if (command(17, cardAddress(block)) != 0) {
+        fail("read rejected");
+        return;
+    }
+    m_xfer = SD_XFER_READ_TOKEN;
+    m_xfer_start_ms = Milliseconds();
+}
+
+void SdLog::startWrite() {
+    if (command(24, cardAddress(m_write_block)) != 0) {
+        fail("write command rejected");
+        return;
+    }
+    transfer(0xFF);
+    transfer(SD_TOKEN_START_BLOCK);
+    m_xfer = SD_XFER_WRITE_DATA;
+    m_xfer_pos = 0;
+}
+
+/**
+ * @details The ring is written in order from index 0, so index i of the newest pass holds
+ * sequence number seq(0) + i, and every index from the end of that pass on holds an older
+ * pass or nothing. "Holds seq(0) + i" is therefore true up to some index and false after
+ * it, and a binary search finds that index in about log2(SD_LOG_BLOCK_COUNT) reads.
+ */
+void SdLog::onScanRead() {
+    SdLogBlockHeader header;
+    memcpy(&header, m_io, sizeof(header));
+    bool valid = header.magic == SD_LOG_MAGIC;
+    if (m_scan_block == 0) {
+        if (valid) {
+            m_scan_base_seq = header.seq;
+        } else {
+            // Blank card (or not a log card): start at the beginning
+            m_scan_base_seq = 0;
+            m_scan_lo = m_scan_hi = 0;
+        }
+    } else if (valid && header.seq == m_scan_base_seq + m_scan_block) {
+        m_scan_lo = m_scan_block + 1;
+    } else {
+        m_scan_hi = m_scan_block;
+    }
+    if (m_scan_lo < m_scan_hi) {
+        startRead(m_scan_lo + (m_scan_hi - m_scan_lo) / 2);
+        return;
+    }
+    m_next_seq = m_scan_base_seq + m_scan_lo;
+    m_next_block = m_scan_lo % SD_LOG_BLOCK_COUNT;
+    m_boot_seq = m_next_seq;
+    m_state = SD_LOG_STATE_READY;
+    m_failure_reported = false;
+    m_last_flush_ms = Milliseconds();
+    ERROR_LOGF(LOG_INFO, "SD log ready: block %lu, seq %lu",
+               (unsigned long)m_next_block, (unsigned long)m_next_seq);
+}
+
+/**
+ * @details Drops back to IDLE and retries the whole init after SD_LOG_RETRY_MS, so a card
+ * inserted later (or reseated) is picked up. The unwritten block stays in m_fill; a block
+ * that was being written is lost. Only the first failure after the card was last ready is
+ * logged, so an empty slot does not fill the error log.
+ */
+void SdLog::fail(const char* reason) {
+    deselect();
+    bool was_ready = m_state == SD_LOG_STATE_READY;
+    m_xfer = SD_XFER_NONE;
+    m_write_pending = false;
+    m_fill_placed = false;
+    m_state = SD_LOG_STATE_IDLE;
+    m_state_start_ms = Milliseconds();
+    m_errors++;
+    if (!m_failure_reported) {
+        m_failure_reported = true;
+        ERROR_LOGF(was_ready ? LOG_ERROR : LOG_WARNING, "SD log: %s", reason);
+    }
+}
+
+/**
+ * @details Sends a command frame with CS asserted and returns its R1 response, leaving CS
+ * asserted for any data that follows. The CRC only matters for CMD0 and CMD8.
+ */
+uint8_t SdLog::command(uint8_t cmd, uint32_t arg) {
+    select();
+    transfer(0xFF);
+    transfer(0x40 | cmd);
+    transfer((uint8_t)(arg >> 24));
+    transfer((uint8_t)(arg >> 16));
+    transfer((uint8_t)(arg >> 8));
+    transfer((uint8_t)arg);
+    uint8_t crc = 0xFF;
+    if (cmd == 0) {
+        crc = 0x95;
+    } else if (cmd == 8) {
+        crc = 0x87;
+    }
+    transfer(crc);
+    // R1 arrives within 8 bytes; its top bit is clear
+    uint8_t r1 = 0xFF;
+    for (uint8_t i = 0; i < 8 && (r1 & 0x80); i++) {
+        r1 = transfer(0xFF);
+    }
+    return r1;
+}
+
+uint8_t SdLog::transfer(uint8_t data) {
+    return SdCard.SpiTransferData(data);
+}
+
+void SdLog::select() {
+    SdCard.SpiSsMode(SerialBase::LINE_ON);
+}
+
+void SdLog::deselect() {
+    SdCard.SpiSsMode(SerialBase::LINE_OFF);
+    // One more byte so the card releases MISO
+    transfer(0xFF);
+}
+
+uint32_t SdLog::cardAddress(uint32_t block) const {
+    uint32_t card_block = SD_LOG_START_BLOCK + block;
+    return m_block_addressing ? card_block : card_block * SD_LOG_BLOCK_SIZE;
+}
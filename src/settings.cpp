@@ -0,0 +1,440 @@
+/**
+ * @file settings.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the versioned settings block persisted to the NVM user area.
+ */
+
+#include "settings.h"
+#include "force_sensor.h"
+#include "nvm_journal.h"
+#include "NvmManager.h"
+#include "ClearCore.h"
+#include <math.h>
+#include <string.h>
+
+using namespace ClearCore;
+
+static_assert(sizeof(PressSettings) <= NVM_SLOT_COUNT * 4, "Settings block overlaps the recipe area");
+static_assert(sizeof(NvmImageHeader) == 12, "NVM image header layout is part of the backup format");
+static_assert(sizeof(PressSettings) <= 0xFF, "Settings length must fit its header byte");
+static_assert(RAPID_VEL_MAX_MMS <= MOTOR_DEFAULT_VEL_MAX_MMS && RAPID_VEL_MAX_MMS <= 0xFF &&
+              RAPID_ACCEL_MAX_MMSS <= MOTOR_DEFAULT_ACCEL_MAX_MMSS &&
+              RAPID_ACCEL_MAX_MMSS / RAPID_ACCEL_UNIT_MMSS <= 0xFF,
+              "Rapid traverse limits must fit the drive limits and their settings bytes");
+
+// Slots of the layout before the settings block, read once by migrateLegacy()
+#define LEGACY_NVM_MAGIC                0x50425231  // "PBR1" in slot 7
+#define LEGACY_SLOT_FORCE_OFFSET        0
+#define LEGACY_SLOT_FORCE_SCALE         1
+#define LEGACY_SLOT_POLARITY            3
+#define LEGACY_SLOT_FORCE_MODE          4
+#define LEGACY_SLOT_TORQUE_SCALE        5           // value * 100000
+#define LEGACY_SLOT_TORQUE_OFFSET       6           // value * 10000
+#define LEGACY_SLOT_MAGIC               7
+#define LEGACY_SLOT_STRAIN_COEFFS       8           // 8-12
+#define LEGACY_SLOT_HOME_ON_BOOT        13
+#define LEGACY_SLOT_RETRACT             14
+#define LEGACY_SLOT_PRESS_THRESHOLD     15
+#define LEGACY_SLOT_FILTER_MEDIAN       16
+#define LEGACY_SLOT_FILTER_ALPHA        17
+#define LEGACY_SLOT_FORCE_LATENCY       18
+#define LEGACY_SLOT_FORCE_B_OFFSET      19
+#define LEGACY_SLOT_FORCE_B_SCALE       20
+#define LEGACY_SLOT_FORCE_CHANNEL       21
+#define LEGACY_SLOT_MOTION_JERK         63
+#define LEGACY_SLOT_ENCODER_SCALE       64
+#define LEGACY_SLOT_ENCODER_TOLERANCE   65
+
+// Header bytes not covered by the CRC (magic, version, length, crc)
+#define SETTINGS_HEADER_BYTES           8
+
+// Global settings store instance
+SettingsStore g_settings;
+
+SettingsStore::SettingsStore() {
+    setDefaults(m_settings);
+    m_dirty = false;
+    m_changedMs = 0;
+    m_commits = 0;
+    m_source = SETTINGS_SOURCE_DEFAULTS;
+}
+
+SettingsSource SettingsStore::load() {
+    readStored();
+
+#if NVM_JOURNAL_ENABLED
+    // Journaled values are newer than the block; a bad one is repaired by sanitize()
+    g_nvmJournal.load();
+    for (uint8_t key = NVM_JOURNAL_KEY_HEADER + 1; key <= NVM_JOURNAL_KEY_LAST_SETTING; key++) {
+        uint32_t bits;
+        if (g_nvmJournal.get(static_cast<NvmJournalKey>(key), &bits)) {
+            memcpy(journalField(m_settings, static_cast<NvmJournalKey>(key)), &bits, sizeof(bits));
+        }
+    }
+    sanitize(m_settings);
+#endif
+    m_changedMs = Milliseconds();
+    return m_source;
+}
+
+void SettingsStore::readStored() {
+    uint8_t image[NVM_SLOT_COUNT * 4];
+    NvmManager::Instance().BlockRead(static_cast<NvmManager::NvmLocations>(NVM_SLOT_SETTINGS * 4),
+                                     sizeof(image), image);
+
+    PressSettings stored;
+    memcpy(&stored, image, sizeof(stored));
+    setDefaults(m_settings);
+    if (stored.magic == SETTINGS_MAGIC && stored.length > SETTINGS_HEADER_BYTES &&
+        stored.length <= sizeof(image) &&
+        stored.crc == crc32(image + SETTINGS_HEADER_BYTES, stored.length - SETTINGS_HEADER_BYTES)) {
+        // An older, shorter block leaves the fields it predates at their defaults
+        uint8_t known = (stored.length < sizeof(m_settings)) ? stored.length : (uint8_t)sizeof(m_settings);
+        memcpy(reinterpret_cast<uint8_t*>(&m_settings) + SETTINGS_HEADER_BYTES,
+               image + SETTINGS_HEADER_BYTES, known - SETTINGS_HEADER_BYTES);
+        m_source = SETTINGS_SOURCE_BLOCK;
+        m_dirty = stored.version != SETTINGS_VERSION || stored.length != sizeof(m_settings);
+    } else if (NvmManager::Instance().Int32(static_cast<NvmManager::NvmLocations>(LEGACY_SLOT_MAGIC * 4)) == LEGACY_NVM_MAGIC) {
+        migrateLegacy(m_settings);
+        m_source = SETTINGS_SOURCE_LEGACY;
+        m_dirty = true;
+    } else {
+        m_source = SETTINGS_SOURCE_DEFAULTS;
+        m_dirty = true;
+    }
+    if (sanitize(m_settings)) {
+        m_dirty = true;
+    }
+}
+
+PressSettings& SettingsStore::edit() {
+    m_dirty = true;
+    m_changedMs = Milliseconds();
+    return m_settings;
+}
+
+/**
+ * @details The block copy is updated too but not marked dirty, so the next commit for
+ * another reason carries the newest value as well.
+ */
+void SettingsStore::setJournaled(NvmJournalKey key, float value) {
+#if NVM_JOURNAL_ENABLED
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (g_nvmJournal.put(key, bits)) {
+        *journalField(m_settings, key) = value;
+        return;
+    }
+#endif
+    *journalField(edit(), key) = value;
+}
+
+void SettingsStore::service(bool allowed) {
+    if (!m_dirty || !allowed || Milliseconds() - m_changedMs < SETTINGS_COMMIT_DELAY_MS) {
+        return;
+    }
+    commit();
+}
+
+/**
+ * @details One BlockWrite, so one erase and write of the user page however many settings
+ * changed. NvmManager skips the write when the block already matches NVM.
+ */
+bool SettingsStore::commit() {
+    if (!m_dirty) {
+        return true;
+    }
+    seal(m_settings);
+    if (!NvmManager::Instance().BlockWrite(static_cast<NvmManager::NvmLocations>(NVM_SLOT_SETTINGS * 4),
+                                           sizeof(m_settings), reinterpret_cast<const uint8_t*>(&m_settings))) {
+        return false;
+    }
+    m_dirty = false;
+    m_commits++;
+    return true;
+}
+
+void SettingsStore::resetDefaults() {
+    setDefaults(edit());
+#if NVM_JOURNAL_ENABLED
+    // Otherwise the next boot would replay the old journaled values over the defaults
+    for (uint8_t key = NVM_JOURNAL_KEY_HEADER + 1; key <= NVM_JOURNAL_KEY_LAST_SETTING; key++) {
+        setJournaled(static_cast<NvmJournalKey>(key), *journalField(m_settings, static_cast<NvmJournalKey>(key)));
+    }
+#endif
+}
+
+/**
+ * @details The settings block part comes from RAM rather than NVM, so the image carries
+ * uncommitted and journaled changes too; the rest of the user area is read as stored.
+ */
+void SettingsStore::exportImage(uint8_t* out) const {
+    NvmImageHeader header;
+    uint8_t* payload = out + sizeof(header);
+    NvmManager::Instance().BlockRead(static_cast<NvmManager::NvmLocations>(0), NVM_USER_AREA_BYTES, payload);
+    PressSettings current = m_settings;
+    seal(current);
+    memcpy(payload + NVM_SLOT_SETTINGS * 4, &current, sizeof(current));
+
+    header.magic = NVM_IMAGE_MAGIC;
+    header.format = NVM_IMAGE_FORMAT;
+    header.settings_version = SETTINGS_VERSION;
+    header.length = NVM_USER_AREA_BYTES;
+    header.crc = crc32(payload, NVM_USER_AREA_BYTES);
+    memcpy(out, &header, sizeof(header));
+}
+
+/**
+ * @details Checked in full before anything is written, then one BlockWrite. The journaled
+ * values of the image are put to the journal as well, or the next boot would replay this
+ * unit's older ones over them.
+ */
+bool SettingsStore::importImage(const uint8_t* data, size_t length) {
+    NvmImageHeader header;
+    if (length != NVM_IMAGE_BYTES) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    const uint8_t* payload = data + sizeof(header);
+    if (header.magic != NVM_IMAGE_MAGIC || header.format != NVM_IMAGE_FORMAT ||
+        header.length != NVM_USER_AREA_BYTES || header.crc != crc32(payload, NVM_USER_AREA_BYTES)) {
+        return false;
+    }
+    if (!NvmManager::Instance().BlockWrite(static_cast<NvmManager::NvmLocations>(0), NVM_USER_AREA_BYTES, payload)) {
+        return false;
+    }
+    readStored();
+    m_changedMs = Milliseconds();
+#if NVM_JOURNAL_ENABLED
+    for (uint8_t key = NVM_JOURNAL_KEY_HEADER + 1; key <= NVM_JOURNAL_KEY_LAST_SETTING; key++) {
+        setJournaled(static_cast<NvmJournalKey>(key), *journalField(m_settings, static_cast<NvmJournalKey>(key)));
+    }
+#endif
+    return true;
+}
+
+const char* SettingsStore::sourceName(SettingsSource source) {
+    switch (source) {
+        case SETTINGS_SOURCE_BLOCK:  return "block";
+        case SETTINGS_SOURCE_LEGACY: return "legacy";
+        default:                     return "defaults";
+    }
+}
+
+float* SettingsStore::journalField(PressSettings& settings, NvmJournalKey key) {
+    switch (key) {
+        case NVM_JOURNAL_KEY_RETRACT:           return &settings.retract_mm;
+        case NVM_JOURNAL_KEY_PRESS_THRESHOLD:   return &settings.press_threshold_kg;
+        case NVM_JOURNAL_KEY_FORCE_OFFSET_A:    return &settings.force_offset_kg[0];
+        default:                                return &settings.force_offset_kg[1];
+    }
+}
+
+void SettingsStore::seal(PressSettings& settings) {
+    settings.magic = SETTINGS_MAGIC;
+    settings.version = SETTINGS_VERSION;
+    settings.length = sizeof(settings);
+    settings.crc = crc32(reinterpret_cast<const uint8_t*>(&settings) + SETTINGS_HEADER_BYTES,
+                         sizeof(settings) - SETTINGS_HEADER_BYTES);
+}
+
+void SettingsStore::setDefaults(PressSettings& settings) {
+    memset(&settings, 0, sizeof(settings));
+    for (uint8_t i = 0; i < FORCE_SENSOR_MAX_CHANNELS; i++) {
+        settings.force_offset_kg[i] = FORCE_SENSOR_OFFSET_KG;
+        settings.force_scale[i] = FORCE_SENSOR_SCALE_FACTOR;
+    }
+    settings.torque_scale = MOTOR_TORQUE_SCALE_DEFAULT;
+    settings.torque_offset = MOTOR_TORQUE_OFFSET_DEFAULT;
+    settings.strain_coeffs[0] = MACHINE_STRAIN_COEFF_X4;
+    settings.strain_coeffs[1] = MACHINE_STRAIN_COEFF_X3;
+    settings.strain_coeffs[2] = MACHINE_STRAIN_COEFF_X2;
+    settings.strain_coeffs[3] = MACHINE_STRAIN_COEFF_X1;
+    settings.strain_coeffs[4] = MACHINE_STRAIN_COEFF_C;
+    settings.retract_mm = 0.0f;
+    settings.press_threshold_kg = PRESS_THRESHOLD_KG_DEFAULT;
+    settings.filter_alpha = FORCE_FILTER_ALPHA_DEFAULT;
+    settings.motion_jerk = 0.0f;
+    settings.encoder_counts_per_mm = 0.0f;
+    settings.encoder_tolerance_mm = 0.0f;
+    settings.force_latency_us = FORCE_LATENCY_US_DEFAULT;
+    settings.filter_median = FORCE_FILTER_MEDIAN_DEFAULT;
+    settings.force_channel = FORCE_CHANNEL_A;
+    settings.polarity_inverted = 0;
+    settings.force_mode = 1;
+    settings.home_on_boot = 1;
+}
+
+/**
+ * @details The same ranges the setters accept; NaN fails every comparison and is
+ * replaced too.
+ * @return true if anything was replaced
+ */
+bool SettingsStore::sanitize(PressSettings& settings) {
+    PressSettings defaults;
+    setDefaults(defaults);
+    bool fixed = false;
+
+    for (uint8_t i = 0; i < FORCE_SENSOR_MAX_CHANNELS; i++) {
+        if (!(settings.force_offset_kg[i] > -50.0f && settings.force_offset_kg[i] < 50.0f)) {
+            settings.force_offset_kg[i] = defaults.force_offset_kg[i];
+            fixed = true;
+        }
+        float scale = fabsf(settings.force_scale[i]);
+        if (!(scale > 0.00001f && scale < 0.01f)) {
+            settings.force_scale[i] = defaults.force_scale[i];
+            fixed = true;
+        }
+    }
+    if (!(settings.torque_scale > 0.0f && settings.torque_scale < 0.2f)) {
+        settings.torque_scale = defaults.torque_scale;
+        fixed = true;
+    }
+    if (!(settings.torque_offset > -10.0f && settings.torque_offset < 10.0f)) {
+        settings.torque_offset = defaults.torque_offset;
+        fixed = true;
+    }
+    for (uint8_t i = 0; i < 5; i++) {
+        if (!(fabsf(settings.strain_coeffs[i]) < 1e4f)) {
+            settings.strain_coeffs[i] = defaults.strain_coeffs[i];
+            fixed = true;
+        }
+    }
+    if (!(settings.retract_mm >= -100.0f && settings.retract_mm <= 100.0f)) {
+        settings.retract_mm = defaults.retract_mm;
+        fixed = true;
+    }
+    if (!(settings.press_threshold_kg >= 0.1f && settings.press_threshold_kg <= 50.0f)) {
+        settings.press_threshold_kg = defaults.press_threshold_kg;
+        fixed = true;
+    }
+    if (settings.filter_median != 1 && settings.filter_median != 3 && settings.filter_median != 5) {
+        settings.filter_median = defaults.filter_median;
+        fixed = true;
+    }
+    if (!(settings.filter_alpha >= FORCE_FILTER_ALPHA_MIN && settings.filter_alpha <= 1.0f)) {
+        settings.filter_alpha = defaults.filter_alpha;
+        fixed = true;
+    }
+    if (settings.force_latency_us > FORCE_LATENCY_US_MAX) {
+        settings.force_latency_us = defaults.force_latency_us;
+        fixed = true;
+    }
+    if (settings.force_channel > FORCE_CHANNEL_SUM) {
+        settings.force_channel = defaults.force_channel;
+        fixed = true;
+    }
+    if (settings.motion_jerk != 0.0f &&
+        !(settings.motion_jerk >= MOTION_SCURVE_JERK_MIN_MMSS3 && settings.motion_jerk <= MOTION_SCURVE_JERK_MAX_MMSS3)) {
+        settings.motion_jerk = defaults.motion_jerk;
+        fixed = true;
+    }
+    if (settings.encoder_counts_per_mm != 0.0f &&
+        !(fabsf(settings.encoder_counts_per_mm) <= ENCODER_COUNTS_PER_MM_MAX &&
+          settings.encoder_tolerance_mm >= ENCODER_TOLERANCE_MM_MIN &&
+          settings.encoder_tolerance_mm <= ENCODER_TOLERANCE_MM_MAX)) {
+        settings.encoder_counts_per_mm = defaults.encoder_counts_per_mm;
+        settings.encoder_tolerance_mm = defaults.encoder_tolerance_mm;
+        fixed = true;
+    }
+    if (settings.polarity_inverted > 1 || settings.force_mode > 1 || settings.home_on_boot > 1) {
+        settings.polarity_inverted = (settings.polarity_inverted == 1) ? 1 : 0;
+        settings.force_mode = (settings.force_mode == 0) ? 0 : 1;
+        settings.home_on_boot = (settings.home_on_boot == 0) ? 0 : 1;
+        fixed = true;
+    }
+    if (settings.active_profile > PROFILE_MAX_COUNT) {
+        settings.active_profile = 0;
+        fixed = true;
+    }
+    if (settings.rapid_vel_mms > RAPID_VEL_MAX_MMS ||
+        (settings.rapid_vel_mms != 0 && (settings.rapid_accel_5mmss == 0 ||
+                                         settings.rapid_accel_5mmss > RAPID_ACCEL_MAX_MMSS / RAPID_ACCEL_UNIT_MMSS))) {
+        settings.rapid_vel_mms = 0;
+        settings.rapid_accel_5mmss = 0;
+        fixed = true;
+    }
+    return fixed;
+}
+
+// CRC-32 (IEEE, reflected); the block is small and only checked at boot and on commit
+uint32_t SettingsStore::crc32(const uint8_t* data, uint32_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @details Decodes the individually addressed slots the way the firmware before the
+ * settings block read them: 0 and -1 (erased) mean not set, so the default stays.
+ * sanitize() then applies the range checks.
+ */
+void SettingsStore::migrateLegacy(PressSettings& settings) {
+    NvmManager& nvmMgr = NvmManager::Instance();
+    int32_t slots[NVM_SLOT_COUNT];
+    nvmMgr.BlockRead(static_cast<NvmManager::NvmLocations>(0), sizeof(slots), reinterpret_cast<uint8_t*>(slots));
+
+    struct LegacyFloat {
+        int32_t bits;
+        float* target;
+    };
+    LegacyFloat floats[] = {
+        { slots[LEGACY_SLOT_FORCE_OFFSET], &settings.force_offset_kg[0] },
+        { slots[LEGACY_SLOT_FORCE_SCALE], &settings.force_scale[0] },
+        { slots[LEGACY_SLOT_FORCE_B_OFFSET], &settings.force_offset_kg[1] },
+        { slots[LEGACY_SLOT_FORCE_B_SCALE], &settings.force_scale[1] },
+        { slots[LEGACY_SLOT_STRAIN_COEFFS + 0], &settings.strain_coeffs[0] },
+        { slots[LEGACY_SLOT_STRAIN_COEFFS + 1], &settings.strain_coeffs[1] },
+        { slots[LEGACY_SLOT_STRAIN_COEFFS + 2], &settings.strain_coeffs[2] },
+        { slots[LEGACY_SLOT_STRAIN_COEFFS + 3], &settings.strain_coeffs[3] },
+        { slots[LEGACY_SLOT_STRAIN_COEFFS + 4], &settings.strain_coeffs[4] },
+        { slots[LEGACY_SLOT_RETRACT], &settings.retract_mm },
+        { slots[LEGACY_SLOT_PRESS_THRESHOLD], &settings.press_threshold_kg },
+        { slots[LEGACY_SLOT_FILTER_ALPHA], &settings.filter_alpha },
+        { nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(LEGACY_SLOT_MOTION_JERK * 4)), &settings.motion_jerk },
+    };
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++) {
+        if (floats[i].bits != 0 && floats[i].bits != -1) {
+            memcpy(floats[i].target, &floats[i].bits, sizeof(float));
+        }
+    }
+
+    int32_t scale = slots[LEGACY_SLOT_TORQUE_SCALE];
+    if (scale > 0 && scale < 20000) {
+        settings.torque_scale = (float)scale / 100000.0f;
+    }
+    int32_t offset = slots[LEGACY_SLOT_TORQUE_OFFSET];
+    if (offset > -100000 && offset < 100000 && offset != 0 && offset != -1) {
+        settings.torque_offset = (float)offset / 10000.0f;
+    }
+
+    settings.polarity_inverted = (slots[LEGACY_SLOT_POLARITY] == 1) ? 1 : 0;
+    settings.force_mode = (slots[LEGACY_SLOT_FORCE_MODE] == 0) ? 0 : 1;
+    settings.home_on_boot = (slots[LEGACY_SLOT_HOME_ON_BOOT] == 0) ? 0 : 1;
+    int32_t median = slots[LEGACY_SLOT_FILTER_MEDIAN];
+    if (median == 1 || median == 3 || median == 5) {
+        settings.filter_median = (uint8_t)median;
+    }
+    int32_t latency = slots[LEGACY_SLOT_FORCE_LATENCY];
+    if (latency >= 0 && latency <= FORCE_LATENCY_US_MAX) {
+        settings.force_latency_us = (uint32_t)latency;
+    }
+    int32_t channel = slots[LEGACY_SLOT_FORCE_CHANNEL];
+    if (channel == FORCE_CHANNEL_B || channel == FORCE_CHANNEL_SUM) {
+        settings.force_channel = (uint8_t)channel;
+    }
+
+    // Encoder feedback only counted when both slots were set
+    int32_t encScaleBits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(LEGACY_SLOT_ENCODER_SCALE * 4));
+    int32_t encTolBits = nvmMgr.Int32(static_cast<NvmManager::NvmLocations>(LEGACY_SLOT_ENCODER_TOLERANCE * 4));
+    if (encScaleBits != 0 && encScaleBits != -1 && encTolBits != 0 && encTolBits != -1) {
+        memcpy(&settings.encoder_counts_per_mm, &encScaleBits, sizeof(float));
+        memcpy(&settings.encoder_tolerance_mm, &encTolBits, sizeof(float));
+    }
+}
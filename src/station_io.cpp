@@ -0,0 +1,64 @@
+/**
+ * @file station_io.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the fixture sensor inputs read from CCIO-8 expansion boards.
+ */
+
+#include "station_io.h"
+
+#if STATION_IO_ENABLED
+
+#include "control_tick.h"
+#include "error_log.h"
+#include "ClearCore.h"
+
+static_assert(STATION_IO_MAX_BOARDS >= 1 && STATION_IO_MAX_BOARDS * CCIO_PINS_PER_BOARD <= 24,
+              "station_inputs is a signed int telemetry field; keep it to 3 boards");
+static_assert((STATION_IO_INTERLOCK_STATE & ~STATION_IO_INTERLOCK_MASK) == 0,
+              "Interlock state bits must be inside the interlock mask");
+
+#define STATION_IO_INPUT_MASK   ((1UL << (STATION_IO_MAX_BOARDS * CCIO_PINS_PER_BOARD)) - 1)   ///< Inputs kept from the chain.
+
+// Global station I/O instance
+StationIo g_stationIo;
+
+StationIo::StationIo() {
+    m_inputs = 0;
+    m_faults = STATION_IO_INTERLOCK_MASK;
+    m_linkUp = false;
+    m_boards = 0;
+}
+
+void StationIo::setup() {
+    // Every CCIO-8 pin starts as a filtered input; discovery runs when the port opens
+    STATION_IO_PORT.Mode(Connector::CCIO);
+    STATION_IO_PORT.PortOpen();
+    m_boards = CcioMgr.CcioCount();
+    if (m_boards == 0) {
+        ERROR_LOG(LOG_WARNING, "Station I/O: no CCIO-8 board found");
+    } else {
+        ERROR_LOGF(LOG_INFO, "Station I/O: %u CCIO-8 board(s)", (unsigned)m_boards);
+    }
+    // Ahead of the motor controller's hook, so its interlock check sees this tick's inputs
+    g_controlTick.registerHook(&StationIo::tickHook, this);
+    g_controlTick.start();
+}
+
+void StationIo::tickHook(void* context) {
+    static_cast<StationIo*>(context)->tick();
+}
+
+/**
+ * @details Reads only the low word of the manager's 64-bit filtered state: one aligned load,
+ * so the refresh interrupt cannot tear it.
+ */
+void StationIo::tick() {
+    bool link = (CcioMgr.CcioCount() > 0) && !CcioMgr.LinkBroken();
+    uint32_t inputs = link ? (*reinterpret_cast<const volatile uint32_t*>(&CcioMgr.InputState()) & STATION_IO_INPUT_MASK) : 0;
+    m_inputs = inputs;
+    m_faults = link ? ((inputs ^ STATION_IO_INTERLOCK_STATE) & STATION_IO_INTERLOCK_MASK) : STATION_IO_INTERLOCK_MASK;
+    m_linkUp = link;
+}
+
+#endif // STATION_IO_ENABLED
@@ -0,0 +1,60 @@
+/**
+ * @file status_event_ids.cpp
+ * @brief Status event format table for the Pressboi controller.
+ * @details AUTO-GENERATED FILE - DO NOT EDIT MANUALLY
+ * Generated from status_events.json on 2026-10-14 17:10:12
+ */
+
+#include "status_event_ids.h"
+#include "events.h"
+#include <stddef.h>
+
+// Format table indexed by StatusEventId
+static constexpr StatusEventFormat STATUS_EVENT_TABLE[STATUS_EVENT_COUNT] = {
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "", 0, 0x0 },
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Force limit ({0:.1f} kg, actual: {1:.1f} kg) reached.", 2, 0x3 },  // STATUS_EVENT_FORCE_LIMIT_REACHED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Torque limit ({0:.1f}%) reached.", 1, 0x1 },  // STATUS_EVENT_TORQUE_LIMIT_REACHED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Seat stiffness ({0:.1f} kg/mm, baseline {1:.1f} kg/mm) reached.", 2, 0x3 },  // STATUS_EVENT_SEAT_REACHED
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Rapid retract stopped: {0:.1f} kg with no load expected", 1, 0x1 },  // STATUS_EVENT_RAPID_RETRACT_COLLISION
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: Timeout exceeded.", 0, 0x0 },  // STATUS_EVENT_HOMING_TIMEOUT
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Starting rapid approach (gantry squaring).", 0, 0x0 },  // STATUS_EVENT_HOMING_RAPID_START
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Rapid approach moving, monitoring sensors.", 0, 0x0 },  // STATUS_EVENT_HOMING_RAPID_MOVING
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} sensor triggered (rapid).", 1, 0x0 },  // STATUS_EVENT_HOMING_SENSOR_RAPID
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Torque limit hit during rapid approach (backup safety).", 0, 0x0 },  // STATUS_EVENT_HOMING_RAPID_TORQUE
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Rapid approach complete, starting backoff.", 0, 0x0 },  // STATUS_EVENT_HOMING_RAPID_COMPLETE
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: No sensors triggered during rapid approach.", 0, 0x0 },  // STATUS_EVENT_HOMING_RAPID_NO_SENSOR
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: Motion stopped before sensors triggered.", 0, 0x0 },  // STATUS_EVENT_HOMING_RAPID_STOPPED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Starting backoff.", 0, 0x0 },  // STATUS_EVENT_HOMING_BACKOFF_START
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Backoff complete, starting slow approach.", 0, 0x0 },  // STATUS_EVENT_HOMING_BACKOFF_COMPLETE
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Starting slow approach for precision.", 0, 0x0 },  // STATUS_EVENT_HOMING_SLOW_START
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Slow approach moving, monitoring sensors.", 0, 0x0 },  // STATUS_EVENT_HOMING_SLOW_MOVING
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} sensor triggered (slow) - precise position found.", 1, 0x0 },  // STATUS_EVENT_HOMING_SENSOR_SLOW
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Torque limit hit during slow approach (backup safety).", 0, 0x0 },  // STATUS_EVENT_HOMING_SLOW_TORQUE
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: All sensors triggered, gantry squared. Moving to offset.", 0, 0x0 },  // STATUS_EVENT_HOMING_SQUARED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Warning - only {0} of {1} sensors triggered during slow approach.", 2, 0x0 },  // STATUS_EVENT_HOMING_PARTIAL_SENSORS
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: No sensors triggered during slow approach.", 0, 0x0 },  // STATUS_EVENT_HOMING_SLOW_NO_SENSOR
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: Motion stopped before sensors triggered (slow).", 0, 0x0 },  // STATUS_EVENT_HOMING_SLOW_STOPPED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Moving to final offset position.", 0, 0x0 },  // STATUS_EVENT_HOMING_OFFSET_START
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Final position reached.", 0, 0x0 },  // STATUS_EVENT_HOMING_OFFSET_REACHED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Approaching trusted home for a verification touch.", 0, 0x0 },  // STATUS_EVENT_HOMING_VERIFY_START
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: Starting parallel rapid approach.", 0, 0x0 },  // STATUS_EVENT_HOMING_PARALLEL_START
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: Torque limit hit during parallel homing.", 0, 0x0 },  // STATUS_EVENT_HOMING_PARALLEL_TORQUE
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: All axes at offset, gantry squared.", 0, 0x0 },  // STATUS_EVENT_HOMING_PARALLEL_DONE
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Retract position recalculated after homing: {0:.2f} mm (steps={1}, home={2})", 3, 0x1 },  // STATUS_EVENT_HOMING_RETRACT_RECALCULATED
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing sequence ended with error.", 0, 0x0 },  // STATUS_EVENT_HOMING_PHASE_ERROR
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Unknown homing phase, aborting.", 0, 0x0 },  // STATUS_EVENT_HOMING_PHASE_UNKNOWN
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} sensor triggered before the trusted position, re-touching.", 1, 0x0 },  // STATUS_EVENT_HOMING_SENSOR_EARLY
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: M{0} stopped before its sensor triggered.", 1, 0x0 },  // STATUS_EVENT_HOMING_AXIS_STOPPED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} home verified (shift {1:.3f} mm).", 2, 0x2 },  // STATUS_EVENT_HOMING_HOME_VERIFIED
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} home moved (shift {1:.3f} mm).", 2, 0x2 },  // STATUS_EVENT_HOMING_HOME_MOVED
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: M{0} sensor not found during slow approach.", 1, 0x0 },  // STATUS_EVENT_HOMING_AXIS_NO_SENSOR
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} sensor not at the trusted position, running full search.", 1, 0x0 },  // STATUS_EVENT_HOMING_AXIS_FULL_SEARCH
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Part rejected: {1:.1f} kg at {0:.2f} mm is outside the envelope (limit {2:.1f} kg).", 3, 0x7 },  // STATUS_EVENT_ENVELOPE_LEFT
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Station interlock opened: recipe stopped (inputs {0}, out of state {1}).", 2, 0x0 },  // STATUS_EVENT_INTERLOCK_OPEN
+    { TEXT_VIEW(STATUS_PREFIX_INFO),  "Homing: M{0} fast approach, {1:.1f} mm to the slow zone.", 2, 0x2 },  // STATUS_EVENT_HOMING_HYBRID_START
+    { TEXT_VIEW(STATUS_PREFIX_ERROR), "Homing failed: M{0} torque rose {1:.1f}% in the fast approach.", 2, 0x2 },  // STATUS_EVENT_HOMING_HYBRID_TORQUE
+};
+
+const StatusEventFormat* status_event_format(uint8_t id) {
+    return &STATUS_EVENT_TABLE[(id < STATUS_EVENT_COUNT) ? id : STATUS_EVENT_NONE];
+}
@@ -0,0 +1,436 @@
+/**
+ * @file text_format.cpp
+ * @author Eldin Miller-Stead
+ * @date November 6, 2025
+ * @brief Implements the small fixed-precision text formatter used for telemetry and events.
+ */
+
+#include "text_format.h"
+#include <string.h>
+
+#define TEXT_FORMAT_MAX_DECIMALS    8
+
+static const uint32_t kPow10[TEXT_FORMAT_MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+/**
+ * @brief Appends the decimal digits of an unsigned value, optionally zero-padded.
+ * @param min_digits Pad with leading zeros to at least this many digits
+ */
+static size_t appendUnsigned(char* buffer, size_t size, size_t pos, uint64_t value, uint8_t min_digits) {
+    char digits[20];
+    uint8_t count = 0;
+    // 32-bit divides where possible; the 64-bit path is only taken for huge values
+    while (value > 0xFFFFFFFFu) {
+        digits[count++] = (char)('0' + (unsigned)(value % 10));
+        value /= 10;
+    }
+    uint32_t small = (uint32_t)value;
+    do {
+        digits[count++] = (char)('0' + small % 10);
+        small /= 10;
+    } while (small != 0);
+    while (count < min_digits) {
+        digits[count++] = '0';
+    }
+    while (count > 0 && pos + 1 < size) {
+        buffer[pos++] = digits[--count];
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+size_t append_str(char* buffer, size_t size, size_t pos, const char* str) {
+    if (buffer == NULL || size == 0 || pos >= size) {
+        return pos;
+    }
+    if (str != NULL) {
+        while (*str != '\0' && pos + 1 < size) {
+            buffer[pos++] = *str++;
+        }
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+size_t append_view(char* buffer, size_t size, size_t pos, TextView view) {
+    if (buffer == NULL || size == 0 || pos >= size) {
+        return pos;
+    }
+    size_t count = view.len;
+    if (count > size - 1 - pos) {
+        count = size - 1 - pos;
+    }
+    memcpy(buffer + pos, view.text, count);
+    pos += count;
+    buffer[pos] = '\0';
+    return pos;
+}
+
+size_t append_char(char* buffer, size_t size, size_t pos, char c) {
+    if (buffer == NULL || size == 0 || pos >= size) {
+        return pos;
+    }
+    if (pos + 1 < size) {
+        buffer[pos++] = c;
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+size_t append_int(char* buffer, size_t size, size_t pos, int32_t value) {
+    if (buffer == NULL || size == 0 || pos >= size) {
+        return pos;
+    }
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0) {
+        pos = append_char(buffer, size, pos, '-');
+        magnitude = 0u - magnitude;
+    }
+    return appendUnsigned(buffer, size, pos, magnitude, 1);
+}
+
+size_t append_uint(char* buffer, size_t size, size_t pos, uint32_t value) {
+    if (buffer == NULL || size == 0 || pos >= size) {
+        return pos;
+    }
+    return appendUnsigned(buffer, size, pos, value, 1);
+}
+
+size_t append_fixed(char* buffer, size_t size, size_t pos, float value, uint8_t decimals) {
+    if (buffer == NULL || size == 0 || pos >= size) {
+        return pos;
+    }
+    if (decimals > TEXT_FORMAT_MAX_DECIMALS) {
+        decimals = TEXT_FORMAT_MAX_DECIMALS;
+    }
+
+    // Work on the exact binary value (mantissa * 2^exponent) so rounding matches printf
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = (bits >> 31) != 0;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF);
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent == 0xFF) {
+        if (mantissa != 0) {
+            return append_str(buffer, size, pos, "nan");
+        }
+        return append_str(buffer, size, pos, negative ? "-inf" : "inf");
+    }
+    if (exponent == 0) {
+        exponent = 1;   // Subnormal: no implicit bit
+    } else {
+        mantissa |= 0x800000;
+    }
+    exponent -= 150;
+
+    if (negative) {
+        pos = append_char(buffer, size, pos, '-');
+    }
+
+    // mantissa < 2^24 and 10^8 < 2^27, so the scaled value always fits in 64 bits
+    uint64_t scaled = (uint64_t)mantissa * kPow10[decimals];
+    uint64_t units;
+    if (exponent >= 0) {
+        if (exponent >= 64 || (scaled >> (63 - exponent)) != 0) {
+            // Past 64 bits once shifted (about 8.8e12 at 6 decimals)
+            return append_str(buffer, size, pos, "inf");
+        }
+        units = scaled << exponent;
+    } else if (-exponent >= 64) {
+        units = 0;
+    } else {
+        uint32_t shift = (uint32_t)-exponent;
+        units = scaled >> shift;
+        uint64_t remainder = scaled & ((1ull << shift) - 1);
+        uint64_t half = 1ull << (shift - 1);
+        // Round half to even, as newlib and glibc do for exact ties
+        if (remainder > half || (remainder == half && (units & 1))) {
+            units++;
+        }
+    }
+
+    if (decimals == 0) {
+        return appendUnsigned(buffer, size, pos, units, 1);
+    }
+    pos = appendUnsigned(buffer, size, pos, units / kPow10[decimals], 1);
+    pos = append_char(buffer, size, pos, '.');
+    return appendUnsigned(buffer, size, pos, units % kPow10[decimals], decimals);
+}
+
+/**
+ * @struct FormatOutput
+ * @brief text_vsnprintf() destination: stores what fits and counts everything.
+ */
+struct FormatOutput {
+    char* buffer;
+    size_t size;
+    size_t length;      ///< Characters of the full text so far
+};
+
+static void emit(FormatOutput* out, char c) {
+    if (out->length + 1 < out->size) {
+        out->buffer[out->length] = c;
+    }
+    out->length++;
+}
+
+static void emitRepeat(FormatOutput* out, char c, int count) {
+    while (count-- > 0) {
+        emit(out, c);
+    }
+}
+
+/**
+ * @brief Writes one converted field: padding, sign or prefix, zero fill, then the digits.
+ * @param prefix Sign or "0x" (may be empty)
+ * @param zeros Zeros between the prefix and the body (integer precision)
+ */
+static void emitField(FormatOutput* out, const char* prefix, int zeros, const char* body, int body_len,
+                      int width, bool left, bool zero_pad) {
+    int prefix_len = (int)strlen(prefix);
+    int padding = width - prefix_len - zeros - body_len;
+    if (!left && !zero_pad) {
+        emitRepeat(out, ' ', padding);
+    }
+    while (*prefix != '\0') {
+        emit(out, *prefix++);
+    }
+    if (!left && zero_pad) {
+        emitRepeat(out, '0', padding);
+    }
+    emitRepeat(out, '0', zeros);
+    for (int i = 0; i < body_len; i++) {
+        emit(out, body[i]);
+    }
+    if (left) {
+        emitRepeat(out, ' ', padding);
+    }
+}
+
+/** @brief Digits of @p value in @p base, most significant first, into @p digits (no NUL). */
+static int formatDigits(char* digits, uint64_t value, unsigned base, bool upper) {
+    const char* symbols = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char reversed[24];
+    int count = 0;
+    while (value > 0xFFFFFFFFu) {
+        reversed[count++] = symbols[value % base];
+        value /= base;
+    }
+    uint32_t small = (uint32_t)value;
+    do {
+        reversed[count++] = symbols[small % base];
+        small /= base;
+    } while (small != 0);
+    for (int i = 0; i < count; i++) {
+        digits[i] = reversed[count - 1 - i];
+    }
+    return count;
+}
+
+int text_vsnprintf(char* buffer, size_t size, const char* format, va_list args) {
+    FormatOutput out = { buffer, (buffer != NULL) ? size : 0, 0 };
+    if (format == NULL) {
+        format = "";
+    }
+    while (*format != '\0') {
+        if (*format != '%') {
+            emit(&out, *format++);
+            continue;
+        }
+        const char* spec = format++;
+        bool left = false, plus = false, space = false, zero_pad = false, alternate = false;
+        for (;; format++) {
+            if (*format == '-') left = true;
+            else if (*format == '+') plus = true;
+            else if (*format == ' ') space = true;
+            else if (*format == '0') zero_pad = true;
+            else if (*format == '#') alternate = true;
+            else break;
+        }
+        int width = 0;
+        if (*format == '*') {
+            width = va_arg(args, int);
+            if (width < 0) {
+                left = true;
+                width = -width;
+            }
+            format++;
+        } else {
+            while (*format >= '0' && *format <= '9') {
+                width = width * 10 + (*format++ - '0');
+            }
+        }
+        int precision = -1;
+        if (*format == '.') {
+            format++;
+            precision = 0;
+            if (*format == '*') {
+                precision = va_arg(args, int);
+                format++;
+            } else {
+                while (*format >= '0' && *format <= '9') {
+                    precision = precision * 10 + (*format++ - '0');
+                }
+            }
+        }
+        int longs = 0;      // 1 = l or z, 2 = ll; h and hh read an int like any promoted argument
+        for (;; format++) {
+            if (*format == 'l') longs++;
+            else if (*format == 'z') longs = (sizeof(size_t) > sizeof(long)) ? 2 : 1;
+            else if (*format != 'h') break;
+        }
+
+        char body[40];
+        int body_len = 0;
+        char conversion = *format;
+        if (conversion != '\0') {
+            format++;
+        }
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                int64_t value = (longs >= 2) ? va_arg(args, long long)
+                              : (longs == 1) ? va_arg(args, long) : va_arg(args, int);
+                uint64_t magnitude = (value < 0) ? 0ull - (uint64_t)value : (uint64_t)value;
+                const char* sign = (value < 0) ? "-" : plus ? "+" : space ? " " : "";
+                if (!(precision == 0 && magnitude == 0)) {
+                    body_len = formatDigits(body, magnitude, 10, false);
+                }
+                int zeros = (precision > body_len) ? precision - body_len : 0;
+                emitField(&out, sign, zeros, body, body_len, width, left, zero_pad && precision < 0);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'p': {
+                uint64_t value;
+                if (conversion == 'p') {
+                    value = (uint64_t)(uintptr_t)va_arg(args, void*);
+                    alternate = true;
+                } else {
+                    value = (longs >= 2) ? va_arg(args, unsigned long long)
+                          : (longs == 1) ? va_arg(args, unsigned long) : va_arg(args, unsigned int);
+                }
+                unsigned base = (conversion == 'u') ? 10 : (conversion == 'o') ? 8 : 16;
+                if (!(precision == 0 && value == 0)) {
+                    body_len = formatDigits(body, value, base, conversion == 'X');
+                }
+                const char* prefix = "";
+                if (alternate && value != 0) {
+                    prefix = (conversion == 'X') ? "0X" : (conversion == 'o') ? "0" : (base == 16) ? "0x" : "";
+                }
+                int zeros = (precision > body_len) ? precision - body_len : 0;
+                emitField(&out, prefix, zeros, body, body_len, width, left, zero_pad && precision < 0);
+                break;
+            }
+            case 'f':
+            case 'F': {
+                // Promoted from float at every call site in the firmware
+                float value = (float)va_arg(args, double);
+                int decimals = (precision < 0) ? 6 : precision;
+                int fixed = (decimals > TEXT_FORMAT_MAX_DECIMALS) ? TEXT_FORMAT_MAX_DECIMALS : decimals;
+                body_len = (int)append_fixed(body, sizeof(body), 0, value, (uint8_t)fixed);
+                const char* sign = "";
+                const char* digits = body;
+                if (body[0] == '-') {
+                    sign = "-";
+                    digits++;
+                    body_len--;
+                } else if (plus) {
+                    sign = "+";
+                } else if (space) {
+                    sign = " ";
+                }
+                bool finite = (digits[0] >= '0' && digits[0] <= '9');
+                int trailing = finite ? decimals - fixed : 0;
+                int point = (finite && decimals == 0 && alternate) ? 1 : 0;
+                int padding = width - (int)strlen(sign) - body_len - trailing - point;
+                if (!left && !(zero_pad && finite)) {
+                    emitRepeat(&out, ' ', padding);
+                }
+                while (*sign != '\0') {
+                    emit(&out, *sign++);
+                }
+                if (!left && zero_pad && finite) {
+                    emitRepeat(&out, '0', padding);
+                }
+                for (int i = 0; i < body_len; i++) {
+                    emit(&out, digits[i]);
+                }
+                if (point) {
+                    emit(&out, '.');
+                }
+                emitRepeat(&out, '0', trailing);
+                if (left) {
+                    emitRepeat(&out, ' ', padding);
+                }
+                break;
+            }
+            case 'c':
+                body[0] = (char)va_arg(args, int);
+                emitField(&out, "", 0, body, 1, width, left, false);
+                break;
+            case 's': {
+                const char* str = va_arg(args, const char*);
+                if (str == NULL) {
+                    str = "(null)";
+                }
+                size_t len = 0;
+                while (str[len] != '\0' && (precision < 0 || len < (size_t)precision)) {
+                    len++;
+                }
+                int padding = width - (int)len;
+                if (!left) {
+                    emitRepeat(&out, ' ', padding);
+                }
+                for (size_t i = 0; i < len; i++) {
+                    emit(&out, str[i]);
+                }
+                if (left) {
+                    emitRepeat(&out, ' ', padding);
+                }
+                break;
+            }
+            case '%':
+                emit(&out, '%');
+                break;
+            default:
+                // Not supported: copy the specification as text
+                while (spec < format) {
+                    emit(&out, *spec++);
+                }
+                break;
+        }
+    }
+    if (out.size > 0) {
+        out.buffer[(out.length < out.size) ? out.length : out.size - 1] = '\0';
+    }
+    return (int)out.length;
+}
+
+int text_snprintf(char* buffer, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = text_vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return length;
+}
+
+#if TEXT_FORMAT_WRAP_SNPRINTF
+// Linked in place of newlib's with -Wl,--wrap=snprintf,--wrap=vsnprintf (Compact configuration)
+extern "C" int __wrap_vsnprintf(char* buffer, size_t size, const char* format, va_list args) {
+    return text_vsnprintf(buffer, size, format, args);
+}
+
+extern "C" int __wrap_snprintf(char* buffer, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = text_vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return length;
+}
+#endif
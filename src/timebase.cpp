@@ -0,0 +1,31 @@
+/**
+ * @file timebase.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the 64-bit microsecond monotonic clock.
+ */
+
+#include "timebase.h"
+#include "ClearCore.h"
+#include <sam.h>
+
+static uint32_t s_lastUs = 0;      ///< Microseconds() at the previous call
+static uint32_t s_wraps = 0;       ///< Times Microseconds() has wrapped
+
+/**
+ * @details The read and the wrap check run with interrupts masked, so a call from the
+ * control tick cannot count a wrap the interrupted main-loop call is about to count too.
+ */
+uint64_t MonotonicUs() {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t now = Microseconds();
+    // A wrap is a drop of more than half the range, never a reading a few us behind
+    if (now < s_lastUs && s_lastUs - now > 0x80000000u) {
+        s_wraps++;
+    }
+    s_lastUs = now;
+    uint64_t us = ((uint64_t)s_wraps << 32) | now;
+    __set_PRIMASK(primask);
+    return us;
+}
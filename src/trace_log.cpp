@@ -0,0 +1,59 @@
+/**
+ * @file trace_log.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the always-on binary event trace ring.
+ */
+
+#include "trace_log.h"
+#include "ClearCore.h"
+#include <sam.h>
+
+static_assert(sizeof(TraceRecord) == 12, "Trace record must pack to 12 bytes");
+static_assert((TRACE_LOG_RECORDS & (TRACE_LOG_RECORDS - 1)) == 0, "TRACE_LOG_RECORDS must be a power of 2");
+
+// Global trace log instance
+TraceLog g_traceLog;
+
+TraceLog::TraceLog() {
+    m_seq = 0;
+}
+
+/**
+ * @details Interrupts are masked only for the slot claim and the four stores, so a trace
+ * point in the control tick cannot tear a main-loop record or vice versa.
+ */
+void TraceLog::record(uint16_t id, int16_t arg0, int32_t arg1) {
+    uint32_t time_us = Microseconds();
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    TraceRecord& rec = m_records[m_seq & (TRACE_LOG_RECORDS - 1)];
+    rec.time_us = time_us;
+    rec.id = id;
+    rec.arg0 = arg0;
+    rec.arg1 = arg1;
+    m_seq = m_seq + 1;
+    __set_PRIMASK(primask);
+}
+
+uint32_t TraceLog::getOldestSeq() const {
+    uint32_t seq = m_seq;
+    return (seq > TRACE_LOG_RECORDS) ? seq - TRACE_LOG_RECORDS : 0;
+}
+
+uint16_t TraceLog::read(uint32_t from_seq, TraceRecord* out, uint16_t max_records, uint32_t* first_seq) const {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t oldest = getOldestSeq();
+    if (from_seq < oldest) {
+        from_seq = oldest;
+    }
+    uint16_t n = 0;
+    while (n < max_records && from_seq + n < m_seq) {
+        out[n] = m_records[(from_seq + n) & (TRACE_LOG_RECORDS - 1)];
+        n++;
+    }
+    __set_PRIMASK(primask);
+    *first_seq = from_seq;
+    return n;
+}
@@ -8,8 +8,10 @@
 #include "variables.h"
 #include "commands.h"
 #include "events.h"
+#include "text_format.h"
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 
 // Forward declaration - implemented in comms_controller
 extern void sendMessage(const char* msg);
@@ -40,116 +42,205 @@ void telemetry_init(TelemetryData* data) {
     data->homed = 0;
     data->home_sensor_m0 = 0;
     data->home_sensor_m1 = 0;
+    data->slow_loops = 0;
+    data->loop_slack_ms = 256;
+    data->force_rate_hz = 0.0f;
+    data->force_jitter_us = 0;
+    data->force_errors = 0;
+    data->force_stuck = 0;
+    data->force_fused = 0.0f;
+    data->station_inputs = 0;
+    data->motor_thermal = 0.0f;
+    data->time_us = 0;
 }
 
 //==================================================================================================
 // Telemetry Message Construction
 //==================================================================================================
 
-int telemetry_build_message(const TelemetryData* data, char* buffer, size_t buffer_size) {
+// Value lists of the string fields, in telemetry.json order (binary frame indexes)
+static const char* const TELEM_VALUES_MAIN_STATE[] = { "STANDBY", "BUSY", "ERROR", "DISABLED", "CLEARING_ERRORS", "RESETTING", "RECOVERED", "UNKNOWN" };
+static const char* const TELEM_VALUES_FORCE_SOURCE[] = { "motor_torque", "load_cell" };
+
+#define TELEM_VALUE_LIST(list)  list, (uint8_t)(sizeof(list) / sizeof(list[0]))
+
+// Field table indexed by TelemetryFieldId, in telemetry.json order
+static constexpr TelemetryFieldInfo TELEM_FIELD_TABLE[] = {
+    { TEXT_VIEW(TELEM_KEY_MAIN_STATE),         TELEM_TYPE_STRING, 0, offsetof(TelemetryData, MAIN_STATE),         offsetof(TelemetryBinaryFrame, MAIN_STATE),         1, 0.0f,                               TELEM_VALUE_LIST(TELEM_VALUES_MAIN_STATE) },
+    { TEXT_VIEW(TELEM_KEY_FORCE_LOAD_CELL),    TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, force_load_cell),    offsetof(TelemetryBinaryFrame, force_load_cell),    4, TELEM_DEADBAND_FORCE_LOAD_CELL,     NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_MOTOR_TORQUE), TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, force_motor_torque), offsetof(TelemetryBinaryFrame, force_motor_torque), 4, TELEM_DEADBAND_FORCE_MOTOR_TORQUE,  NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_LIMIT),        TELEM_TYPE_FLOAT,  1, offsetof(TelemetryData, force_limit),        offsetof(TelemetryBinaryFrame, force_limit),        4, TELEM_DEADBAND_FORCE_LIMIT,         NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_SOURCE),       TELEM_TYPE_STRING, 0, offsetof(TelemetryData, force_source),       offsetof(TelemetryBinaryFrame, force_source),       1, 0.0f,                               TELEM_VALUE_LIST(TELEM_VALUES_FORCE_SOURCE) },
+    { TEXT_VIEW(TELEM_KEY_FORCE_ADC_RAW),      TELEM_TYPE_INT,    0, offsetof(TelemetryData, force_adc_raw),      offsetof(TelemetryBinaryFrame, force_adc_raw),      4, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_JOULES),             TELEM_TYPE_FLOAT,  3, offsetof(TelemetryData, joules),             offsetof(TelemetryBinaryFrame, joules),             4, TELEM_DEADBAND_JOULES,              NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_ENABLED0),           TELEM_TYPE_INT,    0, offsetof(TelemetryData, enabled0),           offsetof(TelemetryBinaryFrame, enabled0),           1, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_ENABLED1),           TELEM_TYPE_INT,    0, offsetof(TelemetryData, enabled1),           offsetof(TelemetryBinaryFrame, enabled1),           1, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_CURRENT_POS),        TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, current_pos),        offsetof(TelemetryBinaryFrame, current_pos),        4, TELEM_DEADBAND_CURRENT_POS,         NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_RETRACT_POS),        TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, retract_pos),        offsetof(TelemetryBinaryFrame, retract_pos),        4, TELEM_DEADBAND_RETRACT_POS,         NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_TARGET_POS),         TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, target_pos),         offsetof(TelemetryBinaryFrame, target_pos),         4, TELEM_DEADBAND_TARGET_POS,          NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_ENDPOINT),           TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, endpoint),           offsetof(TelemetryBinaryFrame, endpoint),           4, TELEM_DEADBAND_ENDPOINT,            NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_STARTPOINT),         TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, startpoint),         offsetof(TelemetryBinaryFrame, startpoint),         4, TELEM_DEADBAND_STARTPOINT,          NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_PRESS_THRESHOLD),    TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, press_threshold),    offsetof(TelemetryBinaryFrame, press_threshold),    4, TELEM_DEADBAND_PRESS_THRESHOLD,     NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_TORQUE_AVG),         TELEM_TYPE_FLOAT,  1, offsetof(TelemetryData, torque_avg),         offsetof(TelemetryBinaryFrame, torque_avg),         4, TELEM_DEADBAND_TORQUE_AVG,          NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_HOMED),              TELEM_TYPE_INT,    0, offsetof(TelemetryData, homed),              offsetof(TelemetryBinaryFrame, homed),              1, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_HOME_SENSOR_M0),     TELEM_TYPE_INT,    0, offsetof(TelemetryData, home_sensor_m0),     offsetof(TelemetryBinaryFrame, home_sensor_m0),     1, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_HOME_SENSOR_M1),     TELEM_TYPE_INT,    0, offsetof(TelemetryData, home_sensor_m1),     offsetof(TelemetryBinaryFrame, home_sensor_m1),     1, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_SLOW_LOOPS),         TELEM_TYPE_INT,    0, offsetof(TelemetryData, slow_loops),         offsetof(TelemetryBinaryFrame, slow_loops),         4, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_LOOP_SLACK_MS),      TELEM_TYPE_INT,    0, offsetof(TelemetryData, loop_slack_ms),      offsetof(TelemetryBinaryFrame, loop_slack_ms),      4, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_RATE_HZ),      TELEM_TYPE_FLOAT,  1, offsetof(TelemetryData, force_rate_hz),      offsetof(TelemetryBinaryFrame, force_rate_hz),      4, TELEM_DEADBAND_FORCE_RATE_HZ,       NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_JITTER_US),    TELEM_TYPE_INT,    0, offsetof(TelemetryData, force_jitter_us),    offsetof(TelemetryBinaryFrame, force_jitter_us),    4, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_ERRORS),       TELEM_TYPE_INT,    0, offsetof(TelemetryData, force_errors),       offsetof(TelemetryBinaryFrame, force_errors),       4, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_STUCK),        TELEM_TYPE_INT,    0, offsetof(TelemetryData, force_stuck),        offsetof(TelemetryBinaryFrame, force_stuck),        1, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_FORCE_FUSED),        TELEM_TYPE_FLOAT,  2, offsetof(TelemetryData, force_fused),        offsetof(TelemetryBinaryFrame, force_fused),        4, TELEM_DEADBAND_FORCE_FUSED,         NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_STATION_INPUTS),     TELEM_TYPE_INT,    0, offsetof(TelemetryData, station_inputs),     offsetof(TelemetryBinaryFrame, station_inputs),     4, 0.0f,                               NULL, 0 },
+    { TEXT_VIEW(TELEM_KEY_MOTOR_THERMAL),      TELEM_TYPE_FLOAT,  1, offsetof(TelemetryData, motor_thermal),      offsetof(TelemetryBinaryFrame, motor_thermal),      4, TELEM_DEADBAND_MOTOR_THERMAL,       NULL, 0 },
+};
+
+static_assert(sizeof(TELEM_FIELD_TABLE) / sizeof(TELEM_FIELD_TABLE[0]) == TELEM_FIELD_COUNT, "Telemetry field table must cover every TelemetryFieldId");
+static_assert(sizeof(TelemetryBinaryFrame) == TELEM_BINARY_FRAME_SIZE, "Binary telemetry frame must not be padded");
+
+const TelemetryFieldInfo* telemetry_field_info(int id) {
+    return (id >= 0 && id < TELEM_FIELD_COUNT) ? &TELEM_FIELD_TABLE[id] : NULL;
+}
+
+// Typed views of one field of a TelemetryData
+static inline const char* telemetry_string(const TelemetryData* data, const TelemetryFieldInfo& field) {
+    const char* value;
+    memcpy(&value, reinterpret_cast<const uint8_t*>(data) + field.offset, sizeof(value));
+    return value;
+}
+
+static inline float telemetry_float(const TelemetryData* data, const TelemetryFieldInfo& field) {
+    float value;
+    memcpy(&value, reinterpret_cast<const uint8_t*>(data) + field.offset, sizeof(value));
+    return value;
+}
+
+static inline int32_t telemetry_int(const TelemetryData* data, const TelemetryFieldInfo& field) {
+    int32_t value;
+    memcpy(&value, reinterpret_cast<const uint8_t*>(data) + field.offset, sizeof(value));
+    return value;
+}
+
+static inline size_t telemetry_field_size(const TelemetryFieldInfo& field) {
+    return (field.type == TELEM_TYPE_STRING) ? sizeof(const char*) : sizeof(int32_t);
+}
+
+int telemetry_build_message_fields(const TelemetryData* data, uint32_t fields, char* buffer, size_t buffer_size) {
     if (data == NULL || buffer == NULL || buffer_size == 0) return 0;
     
     size_t pos = 0;
     
-    // Write prefix
-    pos += snprintf(buffer + pos, buffer_size - pos, "%s", TELEM_PREFIX);
-    
-    // MAIN_STATE
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%s,", TELEM_KEY_MAIN_STATE, data->MAIN_STATE);
-    }
-    
-    // force_load_cell
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_FORCE_LOAD_CELL, data->force_load_cell);
-    }
-    
-    // force_motor_torque
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_FORCE_MOTOR_TORQUE, data->force_motor_torque);
-    }
-    
-    // force_limit
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.1f,", TELEM_KEY_FORCE_LIMIT, data->force_limit);
-    }
-    
-    // force_source
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%s,", TELEM_KEY_FORCE_SOURCE, data->force_source);
-    }
-    
-    // force_adc_raw
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%ld,", TELEM_KEY_FORCE_ADC_RAW, (long)data->force_adc_raw);
-    }
-    
-    // joules
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.3f,", TELEM_KEY_JOULES, data->joules);
-    }
-    
-    // enabled0
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%ld,", TELEM_KEY_ENABLED0, (long)data->enabled0);
-    }
-    
-    // enabled1
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%ld,", TELEM_KEY_ENABLED1, (long)data->enabled1);
-    }
-    
-    // current_pos
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_CURRENT_POS, data->current_pos);
-    }
-    
-    // retract_pos
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_RETRACT_POS, data->retract_pos);
-    }
+    // Write prefix and the frame timestamp
+    pos = append_view(buffer, buffer_size, pos, TEXT_VIEW(TELEM_PREFIX));
+    pos = append_view(buffer, buffer_size, pos, TEXT_VIEW(TELEM_KEY_TIME_US ":"));
+    pos = append_uint(buffer, buffer_size, pos, data->time_us);
     
-    // target_pos
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_TARGET_POS, data->target_pos);
+    for (int i = 0; i < TELEM_FIELD_COUNT && pos < buffer_size; i++) {
+        if (!(fields & TELEM_FIELD_BIT(i))) continue;
+        const TelemetryFieldInfo& field = TELEM_FIELD_TABLE[i];
+        pos = append_char(buffer, buffer_size, pos, ',');
+        pos = append_view(buffer, buffer_size, pos, field.key);
+        pos = append_char(buffer, buffer_size, pos, ':');
+        switch (field.type) {
+            case TELEM_TYPE_STRING:
+                pos = append_str(buffer, buffer_size, pos, telemetry_string(data, field));
+                break;
+            case TELEM_TYPE_FLOAT:
+                pos = append_fixed(buffer, buffer_size, pos, telemetry_float(data, field), field.precision);
+                break;
+            default:
+                pos = append_int(buffer, buffer_size, pos, telemetry_int(data, field));
+                break;
+        }
     }
     
-    // endpoint
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_ENDPOINT, data->endpoint);
-    }
+    return (int)pos;
+}
+
+int telemetry_build_message(const TelemetryData* data, char* buffer, size_t buffer_size) {
+    return telemetry_build_message_fields(data, TELEM_FIELDS_ALL, buffer, buffer_size);
+}
+
+uint32_t telemetry_changed_fields(const TelemetryData* current, const TelemetryData* last) {
+    if (current == NULL || last == NULL) return TELEM_FIELDS_ALL;
     
-    // startpoint
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_STARTPOINT, data->startpoint);
+    uint32_t changed = 0;
+    for (int i = 0; i < TELEM_FIELD_COUNT; i++) {
+        const TelemetryFieldInfo& field = TELEM_FIELD_TABLE[i];
+        bool differs;
+        switch (field.type) {
+            case TELEM_TYPE_STRING: {
+                const char* a = telemetry_string(current, field);
+                const char* b = telemetry_string(last, field);
+                differs = a != b && (a == NULL || b == NULL || strcmp(a, b) != 0);
+                break;
+            }
+            case TELEM_TYPE_FLOAT:
+                differs = fabsf(telemetry_float(current, field) - telemetry_float(last, field)) >= field.deadband;
+                break;
+            default:
+                differs = telemetry_int(current, field) != telemetry_int(last, field);
+                break;
+        }
+        if (differs) changed |= TELEM_FIELD_BIT(i);
     }
     
-    // press_threshold
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.2f,", TELEM_KEY_PRESS_THRESHOLD, data->press_threshold);
-    }
+    return changed;
+}
+
+void telemetry_copy_fields(TelemetryData* dst, const TelemetryData* src, uint32_t fields) {
+    if (dst == NULL || src == NULL) return;
     
-    // torque_avg
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%.1f,", TELEM_KEY_TORQUE_AVG, data->torque_avg);
+    for (int i = 0; i < TELEM_FIELD_COUNT; i++) {
+        if (!(fields & TELEM_FIELD_BIT(i))) continue;
+        const TelemetryFieldInfo& field = TELEM_FIELD_TABLE[i];
+        memcpy(reinterpret_cast<uint8_t*>(dst) + field.offset, reinterpret_cast<const uint8_t*>(src) + field.offset,
+               telemetry_field_size(field));
     }
-    
-    // homed
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%ld,", TELEM_KEY_HOMED, (long)data->homed);
+}
+
+int telemetry_field_id(const char* key) {
+    if (key == NULL) return -1;
+    size_t len = strlen(key);
+    for (int i = 0; i < TELEM_FIELD_COUNT; i++) {
+        const TextView& name = TELEM_FIELD_TABLE[i].key;
+        if (name.len == len && memcmp(key, name.text, len) == 0) return i;
     }
-    
-    // home_sensor_m0
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%ld,", TELEM_KEY_HOME_SENSOR_M0, (long)data->home_sensor_m0);
+    return -1;
+}
+
+//==================================================================================================
+// Binary Telemetry Construction
+//==================================================================================================
+
+static uint8_t telemetry_value_index(const char* value, const char* const* values, uint8_t count) {
+    if (value == NULL) return TELEM_BINARY_VALUE_UNKNOWN;
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp(value, values[i]) == 0) return i;
     }
+    return TELEM_BINARY_VALUE_UNKNOWN;
+}
+
+void telemetry_build_frame(const TelemetryData* data, uint16_t seq, TelemetryBinaryFrame* frame) {
+    if (data == NULL || frame == NULL) return;
     
-    // home_sensor_m1
-    if (pos < buffer_size) {
-        pos += snprintf(buffer + pos, buffer_size - pos, "%s:%ld", TELEM_KEY_HOME_SENSOR_M1, (long)data->home_sensor_m1);
+    frame->version = TELEM_BINARY_VERSION;
+    frame->reserved = 0;
+    frame->seq = seq;
+    frame->time_us = data->time_us;
+    uint8_t* out = reinterpret_cast<uint8_t*>(frame);
+    for (int i = 0; i < TELEM_FIELD_COUNT; i++) {
+        const TelemetryFieldInfo& field = TELEM_FIELD_TABLE[i];
+        if (field.type == TELEM_TYPE_STRING) {
+            out[field.frame_offset] = telemetry_value_index(telemetry_string(data, field), field.values, field.value_count);
+        } else if (field.frame_size == 1) {
+            out[field.frame_offset] = (uint8_t)telemetry_int(data, field);
+        } else {
+            // Floats and wide ints keep their 4 bytes (little endian on both ends)
+            memcpy(out + field.frame_offset, reinterpret_cast<const uint8_t*>(data) + field.offset, 4);
+        }
     }
-    
-    return (int)pos;
 }
 
 //==================================================================================================
@@ -0,0 +1,105 @@
+/**
+ * @file watchdog_supervisor.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the watchdog supervisor.
+ */
+
+#include "watchdog_supervisor.h"
+
+#if WATCHDOG_ENABLED
+
+#include "error_log.h"
+#include "trace_log.h"
+#include "ClearCore.h"
+#include <string.h>
+
+#define WATCHDOG_LATE_MAGIC     0x4C445757  ///< WatchdogLateRecord.magic ("WWDL").
+
+// Survives the reset the late client causes; garbage after power-up until the magic says otherwise
+__attribute__((section(".noinit"))) static WatchdogLateRecord s_noinitLate;
+
+// Global watchdog supervisor instance
+WatchdogSupervisor g_watchdogSupervisor;
+
+WatchdogSupervisor::WatchdogSupervisor() {
+    memset(m_clients, 0, sizeof(m_clients));
+    m_count = 0;
+    m_armed = false;
+    m_lastServiceMs = 0;
+    m_late = WATCHDOG_CLIENT_NONE;
+    memset(&m_saved, 0, sizeof(m_saved));
+    m_hasSaved = false;
+}
+
+void WatchdogSupervisor::load() {
+    m_hasSaved = (s_noinitLate.magic == WATCHDOG_LATE_MAGIC);
+    if (m_hasSaved) {
+        m_saved = s_noinitLate;
+        m_saved.name[WATCHDOG_CLIENT_NAME_LENGTH - 1] = '\0';
+    }
+    s_noinitLate.magic = 0;
+}
+
+uint8_t WatchdogSupervisor::registerClient(const char* name, uint32_t deadline_ms) {
+    if (m_count >= WATCHDOG_SUPERVISOR_MAX_CLIENTS) {
+        return WATCHDOG_CLIENT_NONE;
+    }
+    WatchdogClient& client = m_clients[m_count];
+    client.name = name;
+    client.deadline_ms = deadline_ms;
+    client.last_ms = Milliseconds();
+    client.worst_ms = 0;
+    // Entry first, count last - checkIn() from an interrupt only touches entries below m_count
+    m_count = m_count + 1;
+    return m_count - 1;
+}
+
+void WatchdogSupervisor::checkIn(uint8_t client) {
+    if (client < m_count) {
+        m_clients[client].last_ms = Milliseconds();
+    }
+}
+
+void WatchdogSupervisor::start(uint32_t now_ms) {
+    for (uint8_t i = 0; i < m_count; i++) {
+        m_clients[i].last_ms = now_ms;
+    }
+    m_lastServiceMs = now_ms;
+    m_armed = true;
+}
+
+bool WatchdogSupervisor::service(uint32_t now_ms) {
+    if (!m_armed) {
+        return true;
+    }
+    if (m_late != WATCHDOG_CLIENT_NONE) {
+        return false;
+    }
+    for (uint8_t i = 0; i < m_count; i++) {
+        WatchdogClient& client = m_clients[i];
+        uint32_t last = client.last_ms;
+        uint32_t silence = now_ms - last;
+        if (silence > client.worst_ms) {
+            client.worst_ms = silence;
+        }
+        // Checking in after the previous service() means it ran in the pass that just ended
+        if (silence <= client.deadline_ms || (int32_t)(m_lastServiceMs - last) <= 0) {
+            continue;
+        }
+        m_late = i;
+        s_noinitLate.silence_ms = silence;
+        s_noinitLate.deadline_ms = client.deadline_ms;
+        strncpy(s_noinitLate.name, client.name, WATCHDOG_CLIENT_NAME_LENGTH - 1);
+        s_noinitLate.name[WATCHDOG_CLIENT_NAME_LENGTH - 1] = '\0';
+        s_noinitLate.magic = WATCHDOG_LATE_MAGIC;
+        TRACE(TRACE_WATCHDOG_LATE, i, silence);
+        ERROR_LOGF(LOG_ERROR, "Watchdog: %s silent %lu ms (deadline %lu ms), feeding stopped", client.name,
+                   (unsigned long)silence, (unsigned long)client.deadline_ms);
+        return false;
+    }
+    m_lastServiceMs = now_ms;
+    return true;
+}
+
+#endif // WATCHDOG_ENABLED
@@ -0,0 +1,196 @@
+/**
+ * @file ClearCore.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host stand-in for the ClearCore library: a settable clock, digital inputs, motors and
+ * COM ports.
+ *
+ * @details Only on the include path of the host build (test/host). Modules that include
+ * ClearCore.h directly (position_curve, idle_work, ...) compile against these instead of
+ * libClearCore; the hardware-independent modules never see this file, because config.h
+ * leaves out ClearCore.h under PRESSBOI_HOST. The classes keep the library's names and
+ * signatures for the calls the firmware makes, and expose their state as public members
+ * so a test can set inputs and read back what was commanded.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace ClearCore {
+
+/**
+ * @class Connector
+ * @brief The connector modes the firmware selects.
+ */
+class Connector {
+public:
+    enum ConnectorModes {
+        INVALID_NONE,
+        INPUT_ANALOG,
+        INPUT_DIGITAL,
+        OUTPUT_ANALOG,
+        OUTPUT_DIGITAL,
+        OUTPUT_H_BRIDGE,
+        OUTPUT_PWM,
+        OUTPUT_TONE,
+        OUTPUT_WAVE,
+        CPM_MODE_A_DIRECT_B_DIRECT,
+        CPM_MODE_STEP_AND_DIR,
+        CPM_MODE_A_DIRECT_B_PWM,
+        CPM_MODE_A_PWM_B_PWM,
+        TTL,
+        RS232,
+        SPI,
+        CCIO,
+        USB_CDC
+    };
+
+    Connector() : mode(INPUT_DIGITAL) {}
+    virtual ~Connector() {}
+
+    virtual bool Mode(ConnectorModes newMode) { mode = newMode; return true; }
+    ConnectorModes Mode() const { return mode; }
+
+    ConnectorModes mode;           ///< Last mode set
+};
+
+/**
+ * @class DigitalIn
+ * @brief Digital input whose state the test sets.
+ */
+class DigitalIn : public Connector {
+public:
+    enum FilterUnits {
+        FILTER_UNIT_MS,
+        FILTER_UNIT_SAMPLES
+    };
+
+    DigitalIn() : state(0), filter_samples(3) {}
+
+    void FilterLength(uint16_t length, FilterUnits units = FILTER_UNIT_SAMPLES) {
+        filter_samples = (units == FILTER_UNIT_MS) ? 5 * length : length;
+    }
+    int16_t State() { return state; }
+
+    int16_t state;                 ///< Filtered input state (set by the test)
+    uint16_t filter_samples;       ///< Last filter length, in 200 us samples
+};
+
+/**
+ * @class MotorDriver
+ * @brief Step-and-direction motor that completes every move at once.
+ */
+class MotorDriver : public Connector {
+public:
+    enum MoveTarget {
+        MOVE_TARGET_ABSOLUTE,
+        MOVE_TARGET_REL_END_POSN
+    };
+
+    MotorDriver() : enable_request(false), alerts_cleared(0), hlfb_percent(0.0f),
+                    position(0), vel_max(0), accel_max(0), moves(0) {}
+
+    void EnableRequest(bool value) { enable_request = value; }
+    bool EnableRequest() const { return enable_request; }
+    void ClearAlerts() { alerts_cleared++; }
+    volatile const float& HlfbPercent() { return hlfb_percent; }
+
+    bool Move(int32_t dist, MoveTarget moveTarget = MOVE_TARGET_REL_END_POSN) {
+        position = (moveTarget == MOVE_TARGET_ABSOLUTE) ? dist : position + dist;
+        moves++;
+        return true;
+    }
+    void MoveStopAbrupt() {}
+    volatile const int32_t& PositionRefCommanded() { return position; }
+    void PositionRefSet(int32_t newPosn) { position = newPosn; }
+    bool StepsComplete() { return true; }
+    void VelMax(uint32_t velMax) { vel_max = velMax; }
+    void AccelMax(uint32_t accelMax) { accel_max = accelMax; }
+
+    bool enable_request;           ///< Last EnableRequest() value
+    uint32_t alerts_cleared;       ///< ClearAlerts() calls
+    volatile float hlfb_percent;   ///< HLFB duty (set by the test)
+    volatile int32_t position;     ///< Commanded position (steps)
+    uint32_t vel_max;              ///< Last VelMax() (steps/s)
+    uint32_t accel_max;            ///< Last AccelMax() (steps/s^2)
+    uint32_t moves;                ///< Move() calls
+};
+
+/**
+ * @class SerialDriver
+ * @brief COM port that hands out the bytes a test queued and keeps what was sent.
+ */
+class SerialDriver : public Connector {
+public:
+    SerialDriver() : speed(0), open(false), rx_length(0), rx_index(0), tx_length(0), error_status(0) {}
+
+    bool Speed(uint32_t bitsPerSecond) { speed = bitsPerSecond; return true; }
+    void PortOpen() { open = true; }
+    int16_t CharGet() { return (rx_index < rx_length) ? rx[rx_index++] : -1; }
+    bool SendChar(uint8_t charToSend) {
+        if (tx_length < sizeof(tx)) {
+            tx[tx_length++] = charToSend;
+        }
+        return true;
+    }
+    uint32_t ErrorStatusAccum() {
+        uint32_t status = error_status;
+        error_status = 0;
+        return status;
+    }
+
+    /**
+     * @brief Queues bytes for CharGet(), after any not read yet.
+     * @param data Bytes the port receives
+     * @param length Number of bytes (what does not fit is dropped)
+     */
+    void FakeReceive(const uint8_t* data, size_t length) {
+        if (rx_index == rx_length) {
+            rx_index = 0;
+            rx_length = 0;
+        }
+        for (size_t i = 0; i < length && rx_length < sizeof(rx); i++) {
+            rx[rx_length++] = data[i];
+        }
+    }
+
+    uint32_t speed;                ///< Last Speed() (baud)
+    bool open;                     ///< PortOpen() called
+    uint8_t rx[256];               ///< Bytes queued by FakeReceive()
+    size_t rx_length;              ///< Valid bytes in rx
+    size_t rx_index;               ///< Next byte CharGet() returns
+    uint8_t tx[64];                ///< Bytes passed to SendChar()
+    size_t tx_length;              ///< Valid bytes in tx
+    uint32_t error_status;         ///< Error bits the next ErrorStatusAccum() returns (set by the test)
+};
+
+} // namespace ClearCore
+
+using namespace ClearCore;
+
+extern MotorDriver ConnectorM0;
+extern MotorDriver ConnectorM1;
+extern MotorDriver ConnectorM2;
+extern MotorDriver ConnectorM3;
+extern DigitalIn ConnectorDI6;
+extern DigitalIn ConnectorDI7;
+extern DigitalIn ConnectorDI8;
+extern DigitalIn ConnectorA9;
+extern SerialDriver ConnectorCOM0;
+extern SerialDriver ConnectorCOM1;
+
+uint32_t Milliseconds();
+uint32_t Microseconds();
+
+/**
+ * @brief Sets the time Microseconds() and Milliseconds() report.
+ * @param us Microseconds since boot
+ */
+void FakeSetMicroseconds(uint32_t us);
+
+/**
+ * @brief Moves the fake clock forward.
+ * @param us Microseconds to add
+ */
+void FakeAdvanceMicroseconds(uint32_t us);
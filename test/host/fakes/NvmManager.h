@@ -0,0 +1,74 @@
+/**
+ * @file NvmManager.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host stand-in for the NVM user page: a RAM page that counts its writes.
+ *
+ * @details Starts erased (0xFF) like a new board. A test reads the page back through the
+ * same calls the firmware uses, or checks @c writes to see whether a path touched NVM
+ * at all. Setting @c refuse_writes makes every write return false, as the library does
+ * while NVMCTRL is busy.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace ClearCore {
+
+/**
+ * @class NvmManager
+ * @brief User page of NVM_PAGE_BYTES, addressed by byte offset.
+ */
+class NvmManager {
+public:
+    enum NvmLocations : int32_t {
+        NVM_LOC_USER_START = 0,
+        NVM_LOC_USER_MAX = 480
+    };
+
+    static const int NVM_PAGE_BYTES = 512;
+
+    static NvmManager& Instance();
+
+    NvmManager() : writes(0), refuse_writes(false) { Erase(); }
+
+    int32_t Int32(NvmLocations nvmLocation) {
+        int32_t value = -1;
+        BlockRead(nvmLocation, sizeof(value), reinterpret_cast<uint8_t*>(&value));
+        return value;
+    }
+    bool Int32(NvmLocations nvmLocation, int32_t newValue) {
+        return BlockWrite(nvmLocation, sizeof(newValue), reinterpret_cast<const uint8_t*>(&newValue));
+    }
+    void BlockRead(NvmLocations nvmLocationStart, int lengthInBytes, uint8_t* const p_data) {
+        if (inPage(nvmLocationStart, lengthInBytes)) {
+            memcpy(p_data, &page[nvmLocationStart], lengthInBytes);
+        }
+    }
+    bool BlockWrite(NvmLocations nvmLocationStart, int lengthInBytes, uint8_t const* const p_data) {
+        writes++;
+        if (refuse_writes || !inPage(nvmLocationStart, lengthInBytes)) {
+            return false;
+        }
+        memcpy(&page[nvmLocationStart], p_data, lengthInBytes);
+        return true;
+    }
+
+    /** @brief Returns the page to 0xFF and clears the write count. */
+    void Erase() {
+        memset(page, 0xFF, sizeof(page));
+        writes = 0;
+    }
+
+    uint8_t page[NVM_PAGE_BYTES];  ///< Page contents
+    uint32_t writes;               ///< Int32() and BlockWrite() calls that wrote (or tried to)
+    bool refuse_writes;            ///< Every write fails (set by the test)
+
+private:
+    static bool inPage(int start, int length) {
+        return start >= 0 && length >= 0 && start + length <= NVM_PAGE_BYTES;
+    }
+};
+
+} // namespace ClearCore
@@ -0,0 +1,9 @@
+/**
+ * @file SerialDriver.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host stand-in for the library's SerialDriver.h; the fake class lives in ClearCore.h.
+ */
+#pragma once
+
+#include "ClearCore.h"
@@ -0,0 +1,44 @@
+/**
+ * @file clearcore_fakes.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Implements the host ClearCore stand-in: the connector objects, the user page and
+ * the fake clock.
+ */
+
+#include "ClearCore.h"
+#include "NvmManager.h"
+
+MotorDriver ConnectorM0;
+MotorDriver ConnectorM1;
+MotorDriver ConnectorM2;
+MotorDriver ConnectorM3;
+DigitalIn ConnectorDI6;
+DigitalIn ConnectorDI7;
+DigitalIn ConnectorDI8;
+DigitalIn ConnectorA9;
+SerialDriver ConnectorCOM0;
+SerialDriver ConnectorCOM1;
+
+NvmManager& NvmManager::Instance() {
+    static NvmManager s_nvm;
+    return s_nvm;
+}
+
+static uint32_t s_fakeUs = 0;
+
+uint32_t Milliseconds() {
+    return s_fakeUs / 1000u;
+}
+
+uint32_t Microseconds() {
+    return s_fakeUs;
+}
+
+void FakeSetMicroseconds(uint32_t us) {
+    s_fakeUs = us;
+}
+
+void FakeAdvanceMicroseconds(uint32_t us) {
+    s_fakeUs += us;
+}
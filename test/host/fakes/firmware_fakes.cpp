@@ -0,0 +1,115 @@
+/**
+ * @file firmware_fakes.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host stand-ins for the firmware modules that drive hardware directly.
+ *
+ * @details The control tick (TCC2), the timebase, the trace log and the NVM journal
+ * (main flash) program SAME53 peripherals, so the host build links these instead. Each
+ * keeps the real header: the tick runs its hooks when a test calls service(), the
+ * timebase follows the fake clock, the trace log only counts, and the journal keeps its
+ * values in RAM.
+ */
+
+#include "ClearCore.h"
+#include "control_tick.h"
+#include "timebase.h"
+#include "trace_log.h"
+#include "nvm_journal.h"
+#include <string.h>
+
+ControlTick g_controlTick;
+TraceLog g_traceLog;
+NvmJournal g_nvmJournal;
+
+ControlTick::ControlTick() {
+    memset(m_hooks, 0, sizeof(m_hooks));
+    memset(m_contexts, 0, sizeof(m_contexts));
+    m_hook_count = 0;
+    m_running = false;
+    m_tick_count = 0;
+    m_tick_time_us = 0;
+    m_max_tick_gap_us = 0;
+    m_watchdog = 0;
+}
+
+void ControlTick::start() {
+    m_running = true;
+}
+
+bool ControlTick::registerHook(ControlTickHook hook, void* context) {
+    for (uint8_t i = 0; i < m_hook_count; i++) {
+        if (m_hooks[i] == hook && m_contexts[i] == context) {
+            return true;
+        }
+    }
+    if (m_hook_count >= CONTROL_TICK_MAX_HOOKS) {
+        return false;
+    }
+    m_hooks[m_hook_count] = hook;
+    m_contexts[m_hook_count] = context;
+    m_hook_count++;
+    return true;
+}
+
+void ControlTick::mask() {
+}
+
+void ControlTick::unmask() {
+}
+
+void ControlTick::service() {
+    m_tick_time_us = MonotonicUs();
+    m_tick_count++;
+    for (uint8_t i = 0; i < m_hook_count; i++) {
+        m_hooks[i](m_contexts[i]);
+    }
+}
+
+uint64_t MonotonicUs() {
+    return Microseconds();
+}
+
+TraceLog::TraceLog() {
+    m_seq = 0;
+}
+
+void TraceLog::record(uint16_t id, int16_t arg0, int32_t arg1) {
+    (void)id;
+    (void)arg0;
+    (void)arg1;
+    m_seq = m_seq + 1;
+}
+
+NvmJournal::NvmJournal() {
+    memset(m_value, 0, sizeof(m_value));
+    m_have = 0;
+    m_pending = 0;
+    m_state = 0;
+    m_active = 0;
+    m_next = 0;
+    m_seq = 0;
+    m_erased = 0;
+    m_stale = 0;
+    m_target = 0;
+    m_copyKey = 0;
+    m_copySlot = 0;
+    m_erases = 0;
+}
+
+void NvmJournal::load() {
+}
+
+bool NvmJournal::get(NvmJournalKey key, uint32_t* value) const {
+    if ((m_have & (1u << key)) == 0) {
+        return false;
+    }
+    *value = m_value[key];
+    return true;
+}
+
+bool NvmJournal::put(NvmJournalKey key, uint32_t value) {
+    m_value[key] = value;
+    m_have |= 1u << key;
+    return true;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file host_test.h
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Minimal test registry and checks for the host build.
+ *
+ * @details TEST(name) defines a test and registers it before main(); host_test_main.cpp
+ * runs them all and exits non-zero if any CHECK failed. A failed check reports its file
+ * and line and lets the test go on, so one run shows every mismatch.
+ */
+#pragma once
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+typedef void (*HostTestFn)();
+
+/**
+ * @brief Adds a test to the registry. Called by TEST() at static initialization.
+ * @param name Test name
+ * @param fn Test body
+ * @return Always 0 (used to initialize a static)
+ */
+int hostTestRegister(const char* name, HostTestFn fn);
+
+/**
+ * @brief Records a failed check of the running test.
+ * @param file Source file
+ * @param line Source line
+ * @param text Failed expression or description
+ */
+void hostTestFail(const char* file, int line, const char* text);
+
+#define TEST(name)                                                             \
+    static void name();                                                        \
+    static int name##_registered = hostTestRegister(#name, &name);             \
+    static void name()
+
+#define CHECK(cond)                                                            \
+    do { if (!(cond)) hostTestFail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+    do { if (!((a) == (b))) hostTestFail(__FILE__, __LINE__, #a " == " #b); } while (0)
+
+#define CHECK_STR(a, b)                                                        \
+    do { if (strcmp((a), (b)) != 0) {                                          \
+        printf("    \"%s\"\n != \"%s\"\n", (a), (b));                         \
+        hostTestFail(__FILE__, __LINE__, #a " == " #b); } } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                  \
+    do { if (!(fabs((double)(a) - (double)(b)) <= (double)(tol))) {            \
+        printf("    %g vs %g\n", (double)(a), (double)(b));                   \
+        hostTestFail(__FILE__, __LINE__, #a " ~ " #b); } } while (0)
@@ -0,0 +1,53 @@
+/**
+ * @file host_test_main.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Runs the registered host tests and provides the firmware symbols they link against.
+ */
+
+#include "host_test.h"
+
+#define HOST_TEST_MAX 128
+
+struct HostTest {
+    const char* name;
+    HostTestFn fn;
+};
+
+static HostTest s_tests[HOST_TEST_MAX];
+static int s_testCount = 0;
+static int s_failures = 0;
+static const char* s_current = "";
+
+int hostTestRegister(const char* name, HostTestFn fn) {
+    if (s_testCount < HOST_TEST_MAX) {
+        s_tests[s_testCount].name = name;
+        s_tests[s_testCount].fn = fn;
+        s_testCount++;
+    }
+    return 0;
+}
+
+void hostTestFail(const char* file, int line, const char* text) {
+    printf("FAIL %s: %s:%d: %s\n", s_current, file, line, text);
+    s_failures++;
+}
+
+// variables.cpp sends telemetry through the comms controller on the device
+void sendMessage(const char* msg) {
+    (void)msg;
+}
+
+int main() {
+    int failedTests = 0;
+    for (int i = 0; i < s_testCount; i++) {
+        int before = s_failures;
+        s_current = s_tests[i].name;
+        s_tests[i].fn();
+        if (s_failures != before) {
+            failedTests++;
+        }
+    }
+    printf("%d tests, %d failed\n", s_testCount, failedTests);
+    return (failedTests == 0) ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_commands.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host tests of parseCommand() and getCommandParams().
+ */
+
+#include "host_test.h"
+#include "commands.h"
+
+struct CommandName {
+    const char* text;
+    Command cmd;
+};
+
+// Every CMD_STR_* of commands.h, so a regenerated parser that loses a name fails here
+static const CommandName kCommandNames[] = {
+    { CMD_STR_DISCOVER_DEVICE, CMD_DISCOVER_DEVICE },
+    { CMD_STR_RESET, CMD_RESET },
+    { CMD_STR_SET_FORCE_MODE, CMD_SET_FORCE_MODE },
+    { CMD_STR_SET_RETRACT, CMD_SET_RETRACT },
+    { CMD_STR_RETRACT, CMD_RETRACT },
+    { CMD_STR_PAUSE, CMD_PAUSE },
+    { CMD_STR_RESUME, CMD_RESUME },
+    { CMD_STR_CANCEL, CMD_CANCEL },
+    { CMD_STR_ENABLE, CMD_ENABLE },
+    { CMD_STR_DISABLE, CMD_DISABLE },
+    { CMD_STR_TEST_WATCHDOG, CMD_TEST_WATCHDOG },
+    { CMD_STR_SET_FORCE_OFFSET, CMD_SET_FORCE_OFFSET },
+    { CMD_STR_SET_FORCE_ZERO, CMD_SET_FORCE_ZERO },
+    { CMD_STR_SET_FORCE_SCALE, CMD_SET_FORCE_SCALE },
+    { CMD_STR_SET_STRAIN_CAL, CMD_SET_STRAIN_CAL },
+    { CMD_STR_REBOOT_BOOTLOADER, CMD_REBOOT_BOOTLOADER },
+    { CMD_STR_DUMP_NVM, CMD_DUMP_NVM },
+    { CMD_STR_DUMP_CAPTURE, CMD_DUMP_CAPTURE },
+    { CMD_STR_DUMP_CURVE, CMD_DUMP_CURVE },
+    { CMD_STR_SET_DEBUG, CMD_SET_DEBUG },
+    { CMD_STR_SET_LOG_LEVEL, CMD_SET_LOG_LEVEL },
+    { CMD_STR_SET_TELEMETRY, CMD_SET_TELEMETRY },
+    { CMD_STR_SET_TELEMETRY_DELTA, CMD_SET_TELEMETRY_DELTA },
+    { CMD_STR_SET_TELEMETRY_BURST, CMD_SET_TELEMETRY_BURST },
+    { CMD_STR_SET_SYNC, CMD_SET_SYNC },
+    { CMD_STR_SUBSCRIBE_TELEMETRY, CMD_SUBSCRIBE_TELEMETRY },
+    { CMD_STR_UNSUBSCRIBE_TELEMETRY, CMD_UNSUBSCRIBE_TELEMETRY },
+    { CMD_STR_SET_USB_ROUTE, CMD_SET_USB_ROUTE },
+    { CMD_STR_RESET_NVM, CMD_RESET_NVM },
+    { CMD_STR_DUMP_ERROR_LOG, CMD_DUMP_ERROR_LOG },
+    { CMD_STR_CMDB, CMD_CMDB },
+    { CMD_STR_SET_POLARITY, CMD_SET_POLARITY },
+    { CMD_STR_HOME_ON_BOOT, CMD_HOME_ON_BOOT },
+    { CMD_STR_SET_PRESS_THRESHOLD, CMD_SET_PRESS_THRESHOLD },
+    { CMD_STR_SET_FORCE_FILTER, CMD_SET_FORCE_FILTER },
+    { CMD_STR_SET_FORCE_CHANNEL, CMD_SET_FORCE_CHANNEL },
+    { CMD_STR_SET_FORCE_LATENCY, CMD_SET_FORCE_LATENCY },
+    { CMD_STR_SET_FORCE_TABLE, CMD_SET_FORCE_TABLE },
+    { CMD_STR_SET_MOTION_PROFILE, CMD_SET_MOTION_PROFILE },
+    { CMD_STR_SET_ENCODER, CMD_SET_ENCODER },
+    { CMD_STR_SET_DRIVE_GEOMETRY, CMD_SET_DRIVE_GEOMETRY },
+    { CMD_STR_SET_RAPID_TRAVERSE, CMD_SET_RAPID_TRAVERSE },
+    { CMD_STR_SET_TORQUE_FRICTION, CMD_SET_TORQUE_FRICTION },
+    { CMD_STR_DUMP_PERF, CMD_DUMP_PERF },
+    { CMD_STR_DUMP_TRACE, CMD_DUMP_TRACE },
+    { CMD_STR_DUMP_CRASH, CMD_DUMP_CRASH },
+    { CMD_STR_SAVE_PROFILE, CMD_SAVE_PROFILE },
+    { CMD_STR_SELECT_PROFILE, CMD_SELECT_PROFILE },
+    { CMD_STR_DELETE_PROFILE, CMD_DELETE_PROFILE },
+    { CMD_STR_BACKUP_NVM, CMD_BACKUP_NVM },
+    { CMD_STR_RESTORE_NVM, CMD_RESTORE_NVM },
+    { CMD_STR_FORCE_REPLAY, CMD_FORCE_REPLAY },
+    { CMD_STR_DUMP_MEM, CMD_DUMP_MEM },
+    { CMD_STR_FIT_STRAIN_CAL, CMD_FIT_STRAIN_CAL },
+    { CMD_STR_FW_UPDATE, CMD_FW_UPDATE },
+    { CMD_STR_DUMP_CYCLE_TIMES, CMD_DUMP_CYCLE_TIMES },
+    { CMD_STR_DUMP_PRODUCTION, CMD_DUMP_PRODUCTION },
+    { CMD_STR_RESET_PRODUCTION, CMD_RESET_PRODUCTION },
+    { CMD_STR_HOME, CMD_HOME },
+    { CMD_STR_MOVE_ABS, CMD_MOVE_ABS },
+    { CMD_STR_MOVE_INC, CMD_MOVE_INC },
+    { CMD_STR_QUEUE_MOVE, CMD_QUEUE_MOVE },
+    { CMD_STR_QUEUE_RUN, CMD_QUEUE_RUN },
+    { CMD_STR_QUEUE_CLEAR, CMD_QUEUE_CLEAR },
+    { CMD_STR_RECIPE_NEW, CMD_RECIPE_NEW },
+    { CMD_STR_RECIPE_ADD, CMD_RECIPE_ADD },
+    { CMD_STR_RECIPE_LEARN, CMD_RECIPE_LEARN },
+    { CMD_STR_RECIPE_SAVE, CMD_RECIPE_SAVE },
+    { CMD_STR_RUN_RECIPE, CMD_RUN_RECIPE },
+    { CMD_STR_RECIPE_ENVELOPE, CMD_RECIPE_ENVELOPE },
+    { CMD_STR_RECIPE_ZONES, CMD_RECIPE_ZONES },
+};
+
+TEST(parse_every_command_name) {
+    for (size_t i = 0; i < sizeof(kCommandNames) / sizeof(kCommandNames[0]); i++) {
+        char line[64];
+        // Names of commands with arguments end in a space; parse them with one
+        snprintf(line, sizeof(line), "%s1", kCommandNames[i].text);
+        const char* text = (kCommandNames[i].text[strlen(kCommandNames[i].text) - 1] == ' ') ? line : kCommandNames[i].text;
+        if (parseCommand(text) != kCommandNames[i].cmd) {
+            hostTestFail(__FILE__, __LINE__, kCommandNames[i].text);
+        }
+    }
+}
+
+TEST(parse_matches_whole_token_only) {
+    CHECK_EQ(parseCommand("home"), CMD_HOME);
+    CHECK_EQ(parseCommand("homed"), CMD_UNKNOWN);
+    CHECK_EQ(parseCommand("hom"), CMD_UNKNOWN);
+    CHECK_EQ(parseCommand("dump_curve"), CMD_DUMP_CURVE);
+    CHECK_EQ(parseCommand("dump_curves"), CMD_UNKNOWN);
+    CHECK_EQ(parseCommand("dump_capture"), CMD_DUMP_CAPTURE);
+    CHECK_EQ(parseCommand("reset full"), CMD_RESET);
+    CHECK_EQ(parseCommand("reset_nvm"), CMD_RESET_NVM);
+    CHECK_EQ(parseCommand("HOME"), CMD_UNKNOWN);
+    CHECK_EQ(parseCommand(""), CMD_UNKNOWN);
+    CHECK_EQ(parseCommand(" home"), CMD_UNKNOWN);
+}
+
+TEST(params_follow_the_command_name) {
+    const char* line = "move_abs 12.5 10 500";
+    CHECK_EQ(parseCommand(line), CMD_MOVE_ABS);
+    const char* params = getCommandParams(line, CMD_MOVE_ABS);
+    CHECK(params != NULL);
+    if (params != NULL) {
+        CHECK_STR(params, "12.5 10 500");
+    }
+    CHECK(getCommandParams("pause", CMD_PAUSE) == NULL);
+}
+
+TEST(urgent_and_flushing_commands) {
+    CHECK(isUrgentCommand(CMD_PAUSE));
+    CHECK(isUrgentCommand(CMD_CANCEL));
+    CHECK(isUrgentCommand(CMD_RESET));
+    CHECK(!isUrgentCommand(CMD_MOVE_ABS));
+    CHECK(!isFlushingCommand(CMD_PAUSE));
+    CHECK(isFlushingCommand(CMD_CANCEL));
+    CHECK(isFlushingCommand(CMD_RESET));
+}
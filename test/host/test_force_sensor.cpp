@@ -0,0 +1,222 @@
+/**
+ * @file test_force_sensor.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host tests of ForceSensor: frame decoding, calibration and the sample-exact trip.
+ */
+
+#include "host_test.h"
+#include "ClearCore.h"
+#include "NvmManager.h"
+#include "force_sensor.h"
+
+// 1 count = 1 g, no offset
+static void calibrate(ForceSensor& sensor) {
+    sensor.setScale(0.001f);
+    sensor.setOffset(0.0f);
+}
+
+// CRC-8 as hx711_arduino.ino computes it
+static uint8_t crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ FORCE_SENSOR_FRAME_CRC_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void makeFrame(uint8_t frame[FORCE_SENSOR_FRAME_LENGTH], uint8_t seq, int32_t raw) {
+    frame[0] = FORCE_SENSOR_FRAME_SYNC;
+    frame[1] = seq;
+    frame[2] = (uint8_t)(raw >> 16);
+    frame[3] = (uint8_t)(raw >> 8);
+    frame[4] = (uint8_t)raw;
+    frame[5] = crc8(&frame[1], FORCE_SENSOR_FRAME_LENGTH - 2);
+}
+
+// Decodes one frame 12.5 ms (80 Hz) after the last
+static void sendSample(ForceSensor& sensor, uint8_t seq, int32_t raw) {
+    uint8_t frame[FORCE_SENSOR_FRAME_LENGTH];
+    makeFrame(frame, seq, raw);
+    FakeAdvanceMicroseconds(12500);
+    sensor.decodeBytes(frame, sizeof(frame));
+}
+
+static float kgAt(ForceSensor& sensor, int32_t raw) {
+    sendSample(sensor, 0, raw);
+    sensor.flushSamples();
+    return sensor.getForce();
+}
+
+static int s_trips = 0;
+
+static void countTrip(void* context) {
+    (void)context;
+    s_trips++;
+}
+
+TEST(force_frames_decode_and_bad_crc_is_rejected) {
+    static ForceSensor sensor;
+    calibrate(sensor);
+    FakeSetMicroseconds(1000000);
+    uint8_t frame[FORCE_SENSOR_FRAME_LENGTH];
+    makeFrame(frame, 1, 12345);
+    sensor.decodeBytes(frame, sizeof(frame));
+    makeFrame(frame, 2, -1);
+    sensor.decodeBytes(frame, sizeof(frame));
+    makeFrame(frame, 3, 500);
+    frame[4] ^= 0x01;
+    sensor.decodeBytes(frame, sizeof(frame));
+
+    ForceSample samples[4];
+    CHECK_EQ(sensor.drainSamples(samples, 4), 2);
+    CHECK_EQ(samples[0].raw, 12345);
+    CHECK_NEAR(samples[0].kg, 12.345, 1e-4);
+    CHECK_EQ(samples[1].raw, -1);
+    CHECK_EQ(sensor.getCrcErrors(), 1u);
+    CHECK_EQ(sensor.getDroppedSamples(), 0u);
+
+    // Sequence 3 was lost to the CRC, 4 and 5 never arrived
+    makeFrame(frame, 6, 0);
+    sensor.decodeBytes(frame, sizeof(frame));
+    CHECK_EQ(sensor.getDroppedSamples(), 3u);
+}
+
+TEST(force_frames_arrive_through_the_port) {
+    static ForceSensor sensor;
+    calibrate(sensor);
+    uint8_t frame[FORCE_SENSOR_FRAME_LENGTH];
+    makeFrame(frame, 7, 2000);
+    // Bytes of the settling time after PortOpen() are dropped
+    FakeSetMicroseconds(0);
+    ConnectorCOM0.FakeReceive(frame, sizeof(frame));
+    sensor.serviceRx();
+    CHECK(!sensor.isSettled());
+    FakeSetMicroseconds((FORCE_SENSOR_SETTLE_MS + 1) * 1000);
+    sensor.serviceRx();
+    CHECK(sensor.isSettled());
+    // An ASCII line and a frame share the port
+    const uint8_t line[] = { '-', '4', '2', '\n' };
+    ConnectorCOM0.FakeReceive(line, sizeof(line));
+    ConnectorCOM0.FakeReceive(frame, sizeof(frame));
+    sensor.serviceRx();
+    ForceSample samples[4];
+    CHECK_EQ(sensor.drainSamples(samples, 4), 2);
+    CHECK_EQ(samples[0].raw, -42);
+    CHECK_EQ(samples[1].raw, 2000);
+    CHECK_NEAR(samples[1].kg, 2.0, 1e-4);
+}
+
+TEST(force_counts_round_trip_to_kg) {
+    static ForceSensor sensor;
+    FakeSetMicroseconds(1000000);
+    // The default calibration has a negative scale: counts grow as raw falls
+    const float kgs[] = { 0.5f, 6.5f, 12.0f, 150.0f, 900.0f };
+    for (unsigned i = 0; i < sizeof(kgs) / sizeof(kgs[0]); i++) {
+        int32_t counts = sensor.kgToCounts(kgs[i]);
+        int32_t raw = -counts;
+        // The smallest count reaching the force: one count less falls short
+        CHECK_NEAR(kgAt(sensor, raw), kgs[i], 0.00024);
+        CHECK(kgAt(sensor, raw + 1) < kgs[i]);
+    }
+
+    calibrate(sensor);
+    CHECK_EQ(sensor.kgToCounts(1.0f), 1000);
+    CHECK_EQ(sensor.kgToCounts(-0.25f), -250);
+    CHECK_NEAR(kgAt(sensor, 1000), 1.0, 1e-6);
+}
+
+TEST(force_table_round_trips_and_waits_for_the_flash_job) {
+    static ForceSensor sensor;
+    calibrate(sensor);
+    FakeSetMicroseconds(1000000);
+    NvmManager& nvm = NvmManager::Instance();
+    nvm.Erase();
+    const int32_t raw[3] = { 0, 10000, 20000 };
+    const float kg[3] = { 0.0f, 8.0f, 20.0f };
+    CHECK(sensor.setLinearization(raw, kg, 3));
+    CHECK_EQ(sensor.getLinearizationCount(), 3);
+    // Staged in RAM: the page is written by the idle flash job only
+    CHECK_EQ(nvm.writes, 0u);
+    CHECK(sensor.isLinearizationPending());
+
+    CHECK_NEAR(kgAt(sensor, 5000), 4.0, 1e-5);
+    CHECK_NEAR(kgAt(sensor, 15000), 14.0, 1e-5);
+    // The end segments extrapolate
+    CHECK_NEAR(kgAt(sensor, 25000), 26.0, 1e-5);
+    const float targets[] = { 1.0f, 8.0f, 13.3f, 19.9f };
+    for (unsigned i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        int32_t counts = sensor.kgToCounts(targets[i]);
+        CHECK(kgAt(sensor, counts) >= targets[i]);
+        CHECK(kgAt(sensor, counts - 1) < targets[i]);
+    }
+
+    nvm.refuse_writes = true;
+    CHECK(!sensor.commitLinearization());
+    CHECK(sensor.isLinearizationPending());
+    nvm.refuse_writes = false;
+    CHECK(sensor.commitLinearization());
+    CHECK(!sensor.isLinearizationPending());
+    CHECK_EQ(nvm.Int32(static_cast<NvmManager::NvmLocations>(NVM_SLOT_FORCE_TABLE_COUNT * 4)), 3);
+    CHECK_EQ(nvm.Int32(static_cast<NvmManager::NvmLocations>((NVM_SLOT_FORCE_TABLE_POINTS + 2) * 4)), 10000);
+}
+
+#if FORCE_SENSOR_FAST_TRIP_ENABLED
+TEST(force_trip_fires_on_the_crossing_sample) {
+    static ForceSensor sensor;
+    calibrate(sensor);
+    FakeSetMicroseconds(1000000);
+    s_trips = 0;
+    sensor.armTrip(sensor.kgToCounts(10.0f), &countTrip, NULL);
+    for (int32_t raw = 0; raw < 10000; raw += 1000) {
+        sendSample(sensor, 0, raw);
+    }
+    CHECK(!sensor.tripFired());
+    sendSample(sensor, 0, 10000);
+    CHECK(sensor.tripFired());
+    CHECK(!sensor.tripPredicted());
+    CHECK_EQ(s_trips, 1);
+    CHECK_NEAR(sensor.getTripForce(), 10.0, 1e-4);
+    // Disarmed by the trip: later samples do not call the hook again
+    sendSample(sensor, 0, 11000);
+    CHECK_EQ(s_trips, 1);
+    sensor.disarmTrip();
+    CHECK(!sensor.tripFired());
+}
+
+#if FORCE_TRIP_PREDICT_ENABLED
+TEST(force_trip_predicts_a_fast_rise) {
+    static ForceSensor sensor;
+    calibrate(sensor);
+    FakeSetMicroseconds(1000000);
+    s_trips = 0;
+    int32_t limit = sensor.kgToCounts(50.0f);
+    int32_t predictFrom = sensor.kgToCounts(25.0f);
+    // 4 kg per 12.5 ms sample, extrapolated 40 ms: 12.8 kg ahead
+    sensor.armTrip(limit, &countTrip, NULL, 40000, predictFrom);
+    int32_t raw = 0;
+    while (!sensor.tripFired() && raw < 60000) {
+        raw += 4000;
+        sendSample(sensor, 0, raw);
+    }
+    CHECK(sensor.tripFired());
+    CHECK(sensor.tripPredicted());
+    CHECK(raw < limit);
+    CHECK(raw + 12800 >= limit);
+    CHECK_EQ(s_trips, 1);
+
+    // With no lead time the same rise trips on the sample past the limit
+    sensor.armTrip(limit, &countTrip, NULL, 0, predictFrom);
+    raw = 0;
+    while (!sensor.tripFired() && raw < 60000) {
+        raw += 4000;
+        sendSample(sensor, 0, raw);
+    }
+    CHECK(!sensor.tripPredicted());
+    CHECK(raw >= limit);
+}
+#endif // FORCE_TRIP_PREDICT_ENABLED
+#endif // FORCE_SENSOR_FAST_TRIP_ENABLED
@@ -0,0 +1,65 @@
+/**
+ * @file test_machine_strain.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host tests of MachineStrainModel and MachineStrainFit.
+ */
+
+#include "host_test.h"
+#include "machine_strain.h"
+
+TEST(strain_linear_fit_inverts_exactly) {
+    MachineStrainModel model;
+    const float coeffs[5] = { 0.0f, 0.0f, 0.0f, 200.0f, 0.0f };
+    model.setCoefficients(coeffs);
+    CHECK_NEAR(model.forceFromDeflection(0.5f), 100.0f, 1e-4);
+    CHECK_NEAR(model.deflectionFromForce(100.0f), 0.5f, 1e-4);
+    CHECK_NEAR(model.deflectionFromForce(1.0f), 0.005f, 1e-4);
+    CHECK_EQ(model.deflectionFromForce(-5.0f), 0.0f);
+    CHECK_EQ(model.forceFromDeflection(-1.0f), 0.0f);
+    // Past MACHINE_STRAIN_MAX_DEFLECTION_MM the lookup holds the top of the table
+    CHECK_NEAR(model.deflectionFromForce(5000.0f), MACHINE_STRAIN_MAX_DEFLECTION_MM, 1e-3);
+}
+
+TEST(strain_default_fit_round_trips) {
+    MachineStrainModel model;
+    // The default quartic rises up to about 0.96 mm
+    for (int i = 1; i <= 18; i++) {
+        float mm = 0.05f * (float)i;
+        float kg = model.forceFromDeflection(mm);
+        CHECK_NEAR(model.deflectionFromForce(kg), mm, 2e-3);
+    }
+}
+
+TEST(strain_fit_recovers_a_quartic) {
+    const float truth[5] = { -40.0f, 80.0f, -20.0f, 300.0f, 0.5f };
+    MachineStrainModel model;
+    model.setCoefficients(truth);
+    MachineStrainFit fit;
+    for (int i = 0; i <= 200; i++) {
+        float mm = 0.005f * (float)i;
+        fit.add(mm, model.forceFromDeflection(mm));
+    }
+    CHECK_EQ(fit.getCount(), 201u);
+    CHECK_NEAR(fit.getSpanMm(), 1.0f, 1e-6);
+    float coeffs[5];
+    float rms = -1.0f;
+    CHECK(fit.solve(coeffs, &rms));
+    CHECK(rms < 0.01f);
+    for (int i = 0; i < 5; i++) {
+        CHECK_NEAR(coeffs[i], truth[i], 0.05);
+    }
+    CHECK(fit.risesOverSpan(coeffs));
+}
+
+TEST(strain_fit_needs_five_samples) {
+    MachineStrainFit fit;
+    float coeffs[5];
+    float rms;
+    for (int i = 0; i < 4; i++) {
+        fit.add(0.1f * (float)i, 10.0f * (float)i);
+    }
+    CHECK(!fit.solve(coeffs, &rms));
+    fit.reset();
+    CHECK_EQ(fit.getCount(), 0u);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file test_position_curve.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host tests of PositionCurve against the fake ClearCore clock.
+ */
+
+#include "host_test.h"
+#include "ClearCore.h"
+#include "position_curve.h"
+#include "base64.h"
+#include <stdlib.h>
+
+#if POSITION_CURVE_ENABLED
+
+static const float kStepsPerMm = 800.0f;
+
+// Drives one press: a 1 kHz tick moving at speed_mms, a load-cell sample every 1.25 ms
+// reporting force = slope * mm, stopping at stroke_mm
+static void runPress(PositionCurve& curve, float speed_mms, float stroke_mm, float slope_kg_per_mm,
+                     float trigger_mm) {
+    FakeSetMicroseconds(1000000);
+    curve.begin(0, kStepsPerMm);
+    uint32_t start = Microseconds();
+    uint32_t nextSample = start + 1250;
+    bool triggered = false;
+    for (uint32_t t = start + 25; ; t += 25) {
+        FakeSetMicroseconds(t);
+        float mm = speed_mms * (float)(t - start) * 1e-6f;
+        if (mm > stroke_mm) {
+            mm = stroke_mm;
+        }
+        if ((t - start) % 1000 == 0) {
+            curve.tick(t, (int32_t)(mm * kStepsPerMm));
+        }
+        if (t == nextSample) {
+            curve.addSample(t, slope_kg_per_mm * mm);
+            nextSample += 1250;
+            if (!triggered && mm >= trigger_mm) {
+                curve.trigger();
+                triggered = true;
+            }
+        }
+        if (mm >= stroke_mm) {
+            curve.end(t);
+            if (!curve.isCapturing()) {
+                break;
+            }
+        }
+    }
+}
+
+TEST(curve_is_uniform_in_position) {
+    static PositionCurve curve;
+    runPress(curve, 5.0f, 10.0f, 30.0f, 0.0f);
+    CHECK(!curve.isCapturing());
+    CHECK_EQ(curve.getDropped(), 0u);
+    CHECK_NEAR(curve.getStepMm(), POSITION_CURVE_STEP_MM, 1e-7);
+    CHECK_NEAR(curve.getStartMm(), POSITION_CURVE_STEP_MM, 1e-5);
+    CHECK_EQ(curve.getCount(), (uint16_t)(10.0f / POSITION_CURVE_STEP_MM + 0.5f));
+    CHECK_EQ(curve.getTriggerIndex(), 0);
+}
+
+TEST(curve_lines_carry_every_point) {
+    static PositionCurve curve;
+    runPress(curve, 5.0f, 10.0f, 30.0f, 0.0f);
+    char line[MAX_MESSAGE_LENGTH];
+    uint16_t total = 0;
+    int lines = 0;
+    for (;;) {
+        uint16_t n = curve.formatLine(total, line, sizeof(line));
+        if (n == 0) {
+            break;
+        }
+        CHECK(strncmp(line, "CURVE:pressboi:DATA:", 20) == 0);
+        CHECK_EQ((uint16_t)atoi(line + 20), total);
+        // A linear force in position comes back exactly, point by point (0.1 kg units)
+        const char* data = strchr(line + 20, ':') + 1;
+        int16_t points[POSITION_CURVE_LINE_POINTS];
+        CHECK_EQ(base64Decode(data, reinterpret_cast<uint8_t*>(points), sizeof(points)), (size_t)n * 2);
+        for (uint16_t i = 0; i < n; i++) {
+            float mm = curve.getStartMm() + (float)(total + i) * curve.getStepMm();
+            CHECK_NEAR(points[i], 300.0f * mm, 1.0);
+        }
+        total += n;
+        lines++;
+    }
+    CHECK_EQ(total, curve.getCount());
+    CHECK_EQ(lines, (curve.getCount() + POSITION_CURVE_LINE_POINTS - 1) / POSITION_CURVE_LINE_POINTS);
+}
+
+TEST(curve_keeps_the_pretrigger_ring) {
+    static PositionCurve curve;
+    runPress(curve, 5.0f, 10.0f, 30.0f, 5.0f);
+    CHECK_EQ(curve.getDropped(), 0u);
+    // The approach keeps its last PRETRIGGER_POINTS points ahead of the threshold
+    CHECK_EQ(curve.getTriggerIndex(), POSITION_CURVE_PRETRIGGER_POINTS);
+    float expectedStart = 5.0f - POSITION_CURVE_PRETRIGGER_POINTS * POSITION_CURVE_STEP_MM;
+    CHECK_NEAR(curve.getStartMm(), expectedStart, 0.02);
+}
+
+#endif // POSITION_CURVE_ENABLED
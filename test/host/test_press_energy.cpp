@@ -0,0 +1,119 @@
+/**
+ * @file test_press_energy.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host tests of PressEnergy over known force/position traces.
+ */
+
+#include "host_test.h"
+#include "press_energy.h"
+
+static const float kMmPerStep = 0.00125f;  // 800 steps/mm
+static const long kStepsPerSample = 8;     // 0.01 mm between samples
+static const float kThresholdKg = 2.0f;
+
+// Joules of a force rising linearly at kg_per_mm from a to b mm
+static double rampJoules(double kg_per_mm, double a_mm, double b_mm) {
+    return 0.5 * kg_per_mm * (b_mm * b_mm - a_mm * a_mm) * 0.00981;
+}
+
+// Runs force = kg_per_mm * travel from 0 to stroke_mm; returns the travel at contact
+static double runRamp(PressEnergy& energy, const MachineStrainModel& strain, float kg_per_mm, float stroke_mm) {
+    double contact_mm = -1.0;
+    energy.begin(0);
+    for (long steps = 0; (float)steps * kMmPerStep <= stroke_mm + 1e-6f; steps += kStepsPerSample) {
+        float mm = (float)steps * kMmPerStep;
+        PressEnergyStep step = energy.add(kg_per_mm * mm, steps, 0.0f, kThresholdKg, strain, kMmPerStep);
+        if (step == PRESS_ENERGY_CONTACT) {
+            contact_mm = mm;
+        }
+    }
+    return contact_mm;
+}
+
+TEST(energy_of_a_ramp_on_a_rigid_frame) {
+    MachineStrainModel rigid;
+    const float coeffs[5] = { 0.0f, 0.0f, 0.0f, 1.0e7f, 0.0f };
+    rigid.setCoefficients(coeffs);
+    static PressEnergy energy;
+    energy.resetTotal();
+    energy.invalidate();
+    double contact_mm = runRamp(energy, rigid, 100.0f, 2.0f);
+    // 2 kg at 100 kg/mm: the sample at 0.02 mm
+    CHECK_NEAR(contact_mm, 0.02, 1e-6);
+    CHECK(energy.isContact());
+    // Trapezoids are exact on a linear force; the stiff frame still takes a few ppm
+    CHECK_NEAR(energy.getJoules(), rampJoules(100.0, 0.02, 2.0), 1e-4);
+    CHECK_NEAR(energy.getMachineJoules(), 0.0, 1e-4);
+}
+
+TEST(energy_of_frame_flex_alone_is_not_part_work) {
+    // Pressing a rigid block: all travel after contact is the frame's 200 kg/mm
+    MachineStrainModel frame;
+    const float coeffs[5] = { 0.0f, 0.0f, 0.0f, 200.0f, 0.0f };
+    frame.setCoefficients(coeffs);
+    static PressEnergy energy;
+    energy.resetTotal();
+    energy.invalidate();
+    runRamp(energy, frame, 200.0f, 0.8f);
+    double gross = rampJoules(200.0, 0.01, 0.8);
+    CHECK(energy.getJoules() < 0.01 * gross);
+    CHECK_NEAR(energy.getMachineJoules(), gross, 0.01 * gross);
+}
+
+TEST(energy_splits_a_part_in_series_with_the_frame) {
+    // Part and frame both 200 kg/mm: the axis sees 100 kg/mm and half the work is the part's
+    MachineStrainModel frame;
+    const float coeffs[5] = { 0.0f, 0.0f, 0.0f, 200.0f, 0.0f };
+    frame.setCoefficients(coeffs);
+    static PressEnergy energy;
+    energy.resetTotal();
+    energy.invalidate();
+    double contact_mm = runRamp(energy, frame, 100.0f, 1.5f);
+    double gross = rampJoules(100.0, contact_mm, 1.5);
+    CHECK_NEAR(energy.getJoules(), 0.5 * gross, 0.02 * gross);
+    CHECK_NEAR(energy.getJoules() + energy.getMachineJoules(), gross, 1e-4);
+}
+
+TEST(energy_stops_at_the_force_limit) {
+    MachineStrainModel rigid;
+    const float coeffs[5] = { 0.0f, 0.0f, 0.0f, 1.0e7f, 0.0f };
+    rigid.setCoefficients(coeffs);
+    static PressEnergy energy;
+    energy.resetTotal();
+    energy.invalidate();
+    energy.begin(0);
+    PressEnergyStep last = PRESS_ENERGY_HELD;
+    long steps = 0;
+    for (; last != PRESS_ENERGY_LIMIT && steps < 10000; steps += kStepsPerSample) {
+        last = energy.add(100.0f * (float)steps * kMmPerStep, steps, 50.0f, kThresholdKg, rigid, kMmPerStep);
+    }
+    // 50 kg at 100 kg/mm is 0.5 mm
+    CHECK_EQ(last, PRESS_ENERGY_LIMIT);
+    CHECK_NEAR((float)(steps - kStepsPerSample) * kMmPerStep, 0.5, 1e-6);
+    float joules = energy.getJoules();
+    CHECK_NEAR(joules, rampJoules(100.0, 0.02, 0.5), 1e-5);
+    // The reference is dropped: the next sample only restarts it
+    CHECK_EQ(energy.add(80.0f, steps + 80, 50.0f, kThresholdKg, rigid, kMmPerStep), PRESS_ENERGY_HELD);
+    CHECK_EQ(energy.getJoules(), joules);
+}
+
+TEST(energy_carries_over_a_queued_segment) {
+    MachineStrainModel rigid;
+    const float coeffs[5] = { 0.0f, 0.0f, 0.0f, 1.0e7f, 0.0f };
+    rigid.setCoefficients(coeffs);
+    static PressEnergy energy;
+    energy.resetTotal();
+    energy.invalidate();
+    runRamp(energy, rigid, 10.0f, 1.0f);
+    float first = energy.getJoules();
+    CHECK(first > 0.0f);
+    // A segment queued behind the first: the total goes on, the contact starts again
+    energy.begin(800);
+    CHECK(!energy.isContact());
+    CHECK_EQ(energy.add(10.0f, 808, 0.0f, kThresholdKg, rigid, kMmPerStep), PRESS_ENERGY_CONTACT);
+    CHECK_EQ(energy.add(10.0f, 816, 0.0f, kThresholdKg, rigid, kMmPerStep), PRESS_ENERGY_ADDED);
+    CHECK_NEAR(energy.getJoules(), first + 10.0 * 0.01 * 0.00981, 1e-6);
+    energy.resetTotal();
+    CHECK_EQ(energy.getJoules(), 0.0f);
+}
@@ -0,0 +1,58 @@
+/**
+ * @file test_telemetry.cpp
+ * @author Eldin Miller-Stead
+ * @date November 21, 2025
+ * @brief Host tests of telemetry_build_message() and the field-subset builder.
+ */
+
+#include "host_test.h"
+#include "variables.h"
+#include "events.h"
+
+TEST(telemetry_full_message_has_every_field) {
+    TelemetryData data;
+    telemetry_init(&data);
+    data.time_us = 123456;
+    data.force_load_cell = 12.345f;
+    data.current_pos = -3.5f;
+    data.force_adc_raw = -42;
+    char buffer[1024];
+    int len = telemetry_build_message(&data, buffer, sizeof(buffer));
+    CHECK_EQ((size_t)len, strlen(buffer));
+    CHECK(strncmp(buffer, TELEM_PREFIX "t_us:123456,MAIN_STATE:standby,", strlen(TELEM_PREFIX) + 31) == 0);
+    CHECK(strstr(buffer, ",force_load_cell:12.35,") != NULL);
+    CHECK(strstr(buffer, ",current_pos:-3.50,") != NULL);
+    CHECK(strstr(buffer, ",force_adc_raw:-42,") != NULL);
+    // One ':' per field, plus those of the prefix and the timestamp
+    int colons = 0;
+    for (const char* p = buffer; *p; p++) {
+        colons += (*p == ':');
+    }
+    CHECK_EQ(colons, TELEM_FIELD_COUNT + 2);
+}
+
+TEST(telemetry_subset_is_exact) {
+    TelemetryData data;
+    telemetry_init(&data);
+    data.time_us = 7;
+    data.force_load_cell = 1.005f;
+    data.homed = 1;
+    char buffer[256];
+    uint32_t fields = TELEM_FIELD_BIT(TELEM_FIELD_FORCE_LOAD_CELL) | TELEM_FIELD_BIT(TELEM_FIELD_HOMED);
+    int len = telemetry_build_message_fields(&data, fields, buffer, sizeof(buffer));
+    CHECK_STR(buffer, TELEM_PREFIX "t_us:7,force_load_cell:1.00,homed:1");
+    CHECK_EQ((size_t)len, strlen(buffer));
+}
+
+TEST(telemetry_truncates_inside_the_buffer) {
+    TelemetryData data;
+    telemetry_init(&data);
+    char buffer[40];
+    memset(buffer, 'x', sizeof(buffer));
+    int len = telemetry_build_message(&data, buffer, 24);
+    CHECK_EQ(len, 23);
+    CHECK_EQ(buffer[23], '\0');
+    CHECK_EQ(buffer[24], 'x');
+    CHECK_EQ(telemetry_build_message(NULL, buffer, sizeof(buffer)), 0);
+    CHECK_EQ(telemetry_build_message(&data, buffer, 0), 0);
+}
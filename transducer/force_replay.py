@@ -0,0 +1,169 @@
+"""Replays a recorded force profile into the Pressboi COM-0 port.
+
+Stands in for the HX711 transducer on a hardware-in-the-loop bench: the recorded raw ADC
+samples are sent in the transducer's own framing (see hx711_arduino.ino), paced to a fixed
+sample rate, so the same profile can be replayed into the press again and again. With the
+firmware built with HIL_TEST_ENABLED 1, a scope on the COM-0 RX line and the
+HIL_PIN_FORCE_CROSS / HIL_PIN_STOP outputs measures the trip latency end to end.
+
+Profiles are CSV files. The last column of each row is the raw ADC value; other columns
+(a timestamp, a kg column) are ignored, as is a header row. `--ramp START END SECONDS`
+replays a linear ramp instead of a file.
+
+Examples:
+    python force_replay.py COM7 profile.csv --rate 320
+    python force_replay.py /dev/ttyUSB0 --ramp 0 400000 2.0 --rate 160 --format single
+"""
+
+import argparse
+import csv
+import sys
+import time
+
+FRAME_SYNC = 0xA5
+FRAME_SYNC_DUAL = 0xA6
+FRAME_CRC_POLY = 0x07
+FILTER_TAPS = 8
+MIN_RATE_HZ = 80
+MAX_RATE_HZ = 320
+BAUD = 115200
+
+
+def crc8(data):
+    """CRC-8 (poly 0x07, init 0), as in hx711_arduino.ino and force_sensor.cpp."""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ FRAME_CRC_POLY) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def put24(value):
+    """Signed 24-bit big-endian, clamped to the HX711 range."""
+    value = max(-0x800000, min(0x7FFFFF, int(value)))
+    return (value & 0xFFFFFF).to_bytes(3, "big")
+
+
+class FrameEncoder:
+    """Builds transducer frames with the sketch's sequence counter and moving average."""
+
+    def __init__(self, fmt):
+        self.fmt = fmt
+        self.seq = 0
+        self.taps = [0] * FILTER_TAPS
+        self.tap_index = 0
+        self.tap_count = 0
+
+    def _filtered(self, value):
+        self.taps[self.tap_index] = value
+        self.tap_index = (self.tap_index + 1) % FILTER_TAPS
+        if self.tap_count < FILTER_TAPS:
+            self.tap_count += 1
+            return value
+        return int(sum(self.taps) / FILTER_TAPS)
+
+    def encode(self, value):
+        value = int(value)
+        if self.fmt == "ascii":
+            return b"%d\r\n" % value
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        if self.fmt == "single":
+            body = bytes([seq]) + put24(value)
+            return bytes([FRAME_SYNC]) + body + bytes([crc8(body)])
+        body = bytes([seq]) + put24(value) + put24(self._filtered(value))
+        return bytes([FRAME_SYNC_DUAL]) + body + bytes([crc8(body)])
+
+
+def load_profile(path):
+    """Reads the raw ADC column (last column) of a CSV profile."""
+    samples = []
+    with open(path, newline="") as handle:
+        for row in csv.reader(handle):
+            if not row or row[0].lstrip().startswith("#"):
+                continue
+            try:
+                samples.append(int(float(row[-1])))
+            except ValueError:
+                if samples:
+                    raise ValueError("%s: bad sample %r" % (path, row[-1]))
+                # Header row
+    if not samples:
+        raise ValueError("%s: no samples" % path)
+    return samples
+
+
+def ramp_profile(start, end, seconds, rate):
+    count = max(2, int(round(seconds * rate)))
+    return [start + (end - start) * i / (count - 1) for i in range(count)]
+
+
+def replay(port, samples, rate, fmt, preroll, loops):
+    """Sends the samples at a fixed rate; returns (frames, late frames, worst lateness in s)."""
+    encoder = FrameEncoder(fmt)
+    period = 1.0 / rate
+    frames = late = 0
+    worst = 0.0
+    sequence = [samples[0]] * int(round(preroll * rate))
+    for _ in range(loops):
+        sequence.extend(samples)
+
+    # Absolute deadlines, so a late frame does not push every later frame back
+    deadline = time.perf_counter()
+    for value in sequence:
+        now = time.perf_counter()
+        while now < deadline:
+            if deadline - now > 0.002:
+                time.sleep(deadline - now - 0.001)
+            now = time.perf_counter()
+        lateness = now - deadline
+        if lateness > period / 2:
+            late += 1
+        worst = max(worst, lateness)
+        port.write(encoder.encode(value))
+        frames += 1
+        deadline += period
+    port.flush()
+    return frames, late, worst
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Replay a force profile into Pressboi COM-0.")
+    parser.add_argument("port", help="Serial port wired to COM-0 (TTL, %d baud)" % BAUD)
+    parser.add_argument("profile", nargs="?", help="CSV profile; last column is the raw ADC value")
+    parser.add_argument("--ramp", nargs=3, type=float, metavar=("START", "END", "SECONDS"),
+                        help="Replay a linear raw ADC ramp instead of a file")
+    parser.add_argument("--rate", type=float, default=MIN_RATE_HZ,
+                        help="Samples per second, %d-%d (default %d)" % (MIN_RATE_HZ, MAX_RATE_HZ, MIN_RATE_HZ))
+    parser.add_argument("--format", choices=("dual", "single", "ascii"), default="dual",
+                        help="Frame format (default dual, as the shipped sketch)")
+    parser.add_argument("--preroll", type=float, default=1.0,
+                        help="Seconds of the first sample before the profile, so the ForceSensor settles")
+    parser.add_argument("--loops", type=int, default=1, help="Times to replay the profile")
+    args = parser.parse_args(argv)
+
+    if not MIN_RATE_HZ <= args.rate <= MAX_RATE_HZ:
+        parser.error("--rate must be %d-%d Hz" % (MIN_RATE_HZ, MAX_RATE_HZ))
+    if (args.profile is None) == (args.ramp is None):
+        parser.error("give a profile file or --ramp")
+    try:
+        import serial
+    except ImportError:
+        print("force_replay.py needs pyserial (pip install pyserial)", file=sys.stderr)
+        return 2
+
+    if args.ramp:
+        samples = ramp_profile(args.ramp[0], args.ramp[1], args.ramp[2], args.rate)
+    else:
+        samples = load_profile(args.profile)
+
+    with serial.Serial(args.port, BAUD, write_timeout=1.0) as port:
+        frames, late, worst = replay(port, samples, args.rate, args.format, args.preroll, args.loops)
+    print("sent %d frames at %.0f Hz (%s), %d late, worst %.2f ms late"
+          % (frames, args.rate, args.format, late, worst * 1000.0))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,17 +1,194 @@
 // HX711 -> Ruggeduino: VCC->5V, GND->GND, DOUT->D3, SCK->D2, RATE->5V
 // Ruggeduino -> ClearCore COM-0: TX->Pin8, RX->Pin5, GND->Pin4, 5V->Pin6
-// Sends raw ADC at 115200 baud, 80Hz
+// Sends raw ADC at 115200 baud, one frame per conversion (80Hz with RATE->5V)
+// BINARY_FRAMING 1: 6-byte frames [0xA5][seq][s2][s1][s0][crc8], 0: ASCII lines
+// DUAL_CHANNEL 1: 9-byte frames [0xA6][seq][fast x3][filtered x3][crc8]
+//   fast     = every conversion, unfiltered (lowest latency, used for force limits)
+//   filtered = FILTER_TAPS-sample moving average (quiet, used for telemetry/calibration)
+// LINK_CONTROL 1: answers the ClearCore's 8-byte link frames [0xA7][type][p0..p4][crc8]
+//   so it can raise the baud (and, with RATE_PIN wired, the HX711 rate); without a
+//   keepalive for LINK_REVERT_MS the sketch returns to 115200 baud on its own
 
 #include "HX711.h"
 
+#define BINARY_FRAMING 1
+#define DUAL_CHANNEL   1
+#define LINK_CONTROL   1
+#define FILTER_TAPS    8   // moving-average decimator length (power of 2)
+#define FRAME_SYNC     0xA5
+#define FRAME_SYNC_DUAL 0xA6
+#define FRAME_SYNC_LINK 0xA7
+#define FRAME_CRC_POLY 0x07
+#define LINK_FRAME_LENGTH 8
+#define LINK_REVERT_MS 3000  // must match FORCE_LINK_REVERT_MS on the ClearCore
+#define RATE_PIN       -1    // pin driving HX711 RATE, or -1 when RATE is wired to 5V/GND
+#define RATE_WIRED     1     // rate index RATE is wired to when RATE_PIN is -1 (1 = 80Hz)
+
+// Link frame types and tables - must match force_sensor.cpp
+#define LINK_QUERY     0x01
+#define LINK_SET       0x02
+#define LINK_KEEPALIVE 0x03
+#define LINK_CAPS      0x81
+#define LINK_ACK       0x82
+const unsigned long linkBauds[] = { 115200, 250000, 500000, 1000000 };  // exact at 16 MHz except 115200 (2%)
+const uint8_t linkBaudCount = 4;
+const uint8_t linkRateCount = 2;   // 10Hz (RATE low), 80Hz (RATE high)
+
 HX711 scale;
+uint8_t seq = 0;
+long taps[FILTER_TAPS];
+long tapSum = 0;
+uint8_t tapIndex = 0;
+uint8_t tapCount = 0;
+uint8_t linkFrame[LINK_FRAME_LENGTH];
+uint8_t linkIndex = 0;
+uint8_t linkBaud = 0;
+#if RATE_PIN >= 0
+#define RATE_DEFAULT   1     // 80Hz until the ClearCore asks otherwise
+#else
+#define RATE_DEFAULT   RATE_WIRED
+#endif
+uint8_t linkRate = RATE_DEFAULT;
+unsigned long linkLastMs = 0;
+
+// CRC-8 (poly 0x07, init 0) - must match ForceSensor on the ClearCore
+uint8_t crc8(const uint8_t* data, uint8_t len) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ FRAME_CRC_POLY) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+void put24(uint8_t* p, long value) {
+  p[0] = (uint8_t)(value >> 16);
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)value;
+}
+
+// Running moving average; output starts once the window is full, raw sample before that
+long filterSample(long value) {
+  tapSum += value - taps[tapIndex];
+  taps[tapIndex] = value;
+  tapIndex = (tapIndex + 1) & (FILTER_TAPS - 1);
+  if (tapCount < FILTER_TAPS) {
+    tapCount++;
+    return value;
+  }
+  return tapSum / FILTER_TAPS;
+}
+
+void sendFrame(long value) {
+  uint8_t frame[6];
+  frame[0] = FRAME_SYNC;
+  frame[1] = seq++;
+  put24(&frame[2], value);
+  frame[5] = crc8(&frame[1], 4);
+  Serial.write(frame, sizeof(frame));
+}
+
+void sendDualFrame(long fast, long filtered) {
+  uint8_t frame[9];
+  frame[0] = FRAME_SYNC_DUAL;
+  frame[1] = seq++;
+  put24(&frame[2], fast);
+  put24(&frame[5], filtered);
+  frame[8] = crc8(&frame[1], 7);
+  Serial.write(frame, sizeof(frame));
+}
+
+#if LINK_CONTROL
+void sendLinkFrame(uint8_t type, uint8_t p0, uint8_t p1, uint8_t p2, uint8_t p3, uint8_t p4) {
+  uint8_t frame[LINK_FRAME_LENGTH] = { FRAME_SYNC_LINK, type, p0, p1, p2, p3, p4, 0 };
+  frame[LINK_FRAME_LENGTH - 1] = crc8(&frame[1], LINK_FRAME_LENGTH - 2);
+  Serial.write(frame, sizeof(frame));
+}
+
+uint8_t rateMask() {
+#if RATE_PIN >= 0
+  return 0x03;
+#else
+  return (uint8_t)(1 << RATE_WIRED);
+#endif
+}
+
+// Switch only once the acknowledgement is out, at the old baud
+void applyLink(uint8_t baud, uint8_t rate) {
+  Serial.flush();
+  if (baud != linkBaud) {
+    Serial.end();
+    Serial.begin(linkBauds[baud]);
+    linkBaud = baud;
+  }
+#if RATE_PIN >= 0
+  digitalWrite(RATE_PIN, rate ? HIGH : LOW);
+  linkRate = rate;
+#else
+  (void)rate;
+#endif
+}
+
+void handleLinkFrame() {
+  if (crc8(&linkFrame[1], LINK_FRAME_LENGTH - 2) != linkFrame[LINK_FRAME_LENGTH - 1]) {
+    return;
+  }
+  linkLastMs = millis();
+  if (linkFrame[1] == LINK_QUERY) {
+    sendLinkFrame(LINK_CAPS, 1, (uint8_t)((1 << linkBaudCount) - 1), rateMask(), linkBaud, linkRate);
+  } else if (linkFrame[1] == LINK_SET) {
+    uint8_t baud = linkFrame[2];
+    uint8_t rate = linkFrame[3];
+    if (baud < linkBaudCount && rate < linkRateCount && (rateMask() & (1 << rate))) {
+      sendLinkFrame(LINK_ACK, baud, rate, 0, 0, 0);
+      applyLink(baud, rate);
+    }
+  }
+  // LINK_KEEPALIVE only refreshes linkLastMs
+}
+
+void serviceLink() {
+  while (Serial.available() > 0) {
+    uint8_t c = (uint8_t)Serial.read();
+    if (linkIndex == 0 && c != FRAME_SYNC_LINK) {
+      continue;
+    }
+    linkFrame[linkIndex++] = c;
+    if (linkIndex == LINK_FRAME_LENGTH) {
+      linkIndex = 0;
+      handleLinkFrame();
+    }
+  }
+  // The ClearCore stopped talking (restarted, or lost the last switch): meet it at the default
+  if ((linkBaud != 0 || linkRate != RATE_DEFAULT) && millis() - linkLastMs > LINK_REVERT_MS) {
+    applyLink(0, RATE_DEFAULT);
+    linkIndex = 0;
+  }
+}
+#endif
 
 void setup() {
   Serial.begin(115200);
+#if RATE_PIN >= 0
+  pinMode(RATE_PIN, OUTPUT);
+  digitalWrite(RATE_PIN, RATE_DEFAULT ? HIGH : LOW);
+#endif
   scale.begin(3, 2); // DOUT, SCK
   delay(500);
 }
 
 void loop() {
-  if (scale.is_ready()) Serial.println(scale.get_value()); 
-}
\ No newline at end of file
+#if LINK_CONTROL
+  serviceLink();
+#endif
+  if (scale.is_ready()) {
+    long value = scale.get_value();
+#if BINARY_FRAMING && DUAL_CHANNEL
+    sendDualFrame(value, filterSample(value));
+#elif BINARY_FRAMING
+    sendFrame(value);
+#else
+    Serial.println(value);
+#endif
+  }
+}